@@ -0,0 +1,40 @@
+import inspect
+import itertools
+import subprocess
+import sys
+
+import gmpy2
+
+
+def has(*names):
+    """Return True if gmpy2 provides all names. The benchmarks are run
+    against older revisions, so newer functions must be optional."""
+    return all(hasattr(gmpy2, name) for name in names)
+
+
+def run_module(namespace):
+    """Run each benchmark in a module once, for every parameter set."""
+    for name, cls in sorted(namespace.items()):
+        if (not inspect.isclass(cls) or name.startswith('_') or
+                cls.__module__ != namespace['__name__']):
+            continue
+        params = getattr(cls, 'params', [])
+        if params and not isinstance(params[0], (list, tuple)):
+            params = [params]
+        for args in itertools.product(*params) if params else [()]:
+            obj = cls()
+            try:
+                if hasattr(obj, 'setup'):
+                    obj.setup(*args)
+            except NotImplementedError:
+                print('skip %s%s' % (name, args))
+                continue
+            for attr in sorted(dir(obj)):
+                if attr.startswith(('time_', 'peakmem_', 'mem_')):
+                    getattr(obj, attr)(*args)
+                elif attr.startswith('timeraw_'):
+                    code = getattr(obj, attr)(*args)
+                    subprocess.run([sys.executable, '-c', code], check=True)
+            if hasattr(obj, 'teardown'):
+                obj.teardown(*args)
+            print('ok   %s%s' % (name, args))
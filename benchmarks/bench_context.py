@@ -0,0 +1,63 @@
+"""Context switching and pickling."""
+
+import pickle
+
+import gmpy2
+from gmpy2 import mpz, mpq, mpfr, mpc
+
+
+class Context:
+    def setup(self):
+        self.ctx = gmpy2.context(precision=100)
+        self.a = mpfr('1.5')
+
+    def time_get_context(self):
+        for _ in range(1000):
+            gmpy2.get_context()
+
+    def time_local_context(self):
+        ctx = self.ctx
+        for _ in range(1000):
+            with gmpy2.local_context(ctx):
+                pass
+
+    def time_local_context_kwargs(self):
+        for _ in range(1000):
+            with gmpy2.local_context(precision=100):
+                pass
+
+    def time_set_context(self):
+        old = gmpy2.get_context()
+        ctx = self.ctx
+        for _ in range(1000):
+            gmpy2.set_context(ctx)
+            gmpy2.set_context(old)
+
+    def time_context_method(self):
+        ctx, a = self.ctx, self.a
+        for _ in range(1000):
+            ctx.add(a, a)
+
+
+class Pickle:
+    params = [['mpz', 'mpq', 'mpfr', 'mpc']]
+    param_names = ['kind']
+
+    def setup(self, kind):
+        values = {'mpz': lambda i: mpz(i) ** 10,
+                  'mpq': lambda i: mpq(i, 7919),
+                  'mpfr': lambda i: mpfr(i) / 3,
+                  'mpc': lambda i: mpc(i, -i) / 3}[kind]
+        self.values = [values(i) for i in range(1, 1001)]
+        self.data = pickle.dumps(self.values)
+
+    def time_dumps(self, kind):
+        pickle.dumps(self.values)
+
+    def time_loads(self, kind):
+        pickle.loads(self.data)
+
+
+if __name__ == '__main__':
+    from _common import run_module
+    run_module(globals())
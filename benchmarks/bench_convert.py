@@ -0,0 +1,78 @@
+"""Conversions from and to int and str."""
+
+import gmpy2
+from gmpy2 import mpz, mpq, mpfr
+
+
+class FromInt:
+    params = [[30, 64, 1000, 100000]]
+    param_names = ['bits']
+
+    def setup(self, bits):
+        self.ints = [(1 << bits) - i for i in range(100)]
+        self.mpzs = [mpz(i) for i in self.ints]
+
+    def time_mpz_from_int(self, bits):
+        for i in self.ints:
+            mpz(i)
+
+    def time_int_from_mpz(self, bits):
+        for z in self.mpzs:
+            int(z)
+
+    def time_mpfr_from_int(self, bits):
+        for i in self.ints:
+            mpfr(i)
+
+
+class FromStr:
+    params = [[10, 100, 10000]]
+    param_names = ['digits']
+
+    def setup(self, digits):
+        self.dec = '7' * digits
+        self.hex = 'f' * digits
+        self.z = mpz(self.dec)
+        self.frac = '12345/' + '9' * digits
+        self.real = '1.' + '3' * digits
+
+    def time_mpz_from_str(self, digits):
+        mpz(self.dec)
+
+    def time_mpz_from_hex(self, digits):
+        mpz(self.hex, 16)
+
+    def time_mpz_to_str(self, digits):
+        str(self.z)
+
+    def time_mpz_digits_hex(self, digits):
+        self.z.digits(16)
+
+    def time_mpq_from_str(self, digits):
+        mpq(self.frac)
+
+    def time_mpfr_from_str(self, digits):
+        mpfr(self.real)
+
+
+class Binary:
+    params = [[64, 4096, 1 << 20]]
+    param_names = ['bits']
+
+    def setup(self, bits):
+        self.z = mpz(1) << bits
+        self.b = gmpy2.to_binary(self.z)
+
+    def time_to_binary(self, bits):
+        gmpy2.to_binary(self.z)
+
+    def time_from_binary(self, bits):
+        gmpy2.from_binary(self.b)
+
+    def time_to_bytes(self, bits):
+        self.z.to_bytes((bits + 8) // 8, 'little')
+
+
+if __name__ == '__main__':
+    from _common import run_module
+    run_module(globals())
@@ -0,0 +1,57 @@
+"""Modular exponentiation and primality testing at cryptographic sizes."""
+
+import gmpy2
+from gmpy2 import mpz
+
+
+class Powmod:
+    params = [[256, 1024, 2048, 4096]]
+    param_names = ['bits']
+
+    def setup(self, bits):
+        rs = gmpy2.random_state(42)
+        self.m = gmpy2.mpz_urandomb(rs, bits) | (mpz(1) << (bits - 1)) | 1
+        self.b = gmpy2.mpz_urandomb(rs, bits)
+        self.e = gmpy2.mpz_urandomb(rs, bits)
+        self.prime = gmpy2.next_prime(self.m)
+
+    def time_powmod(self, bits):
+        gmpy2.powmod(self.b, self.e, self.m)
+
+    def time_pow3(self, bits):
+        pow(self.b, self.e, self.m)
+
+    def time_invert(self, bits):
+        gmpy2.invert(self.b, self.prime)
+
+    def time_is_prime(self, bits):
+        gmpy2.is_prime(self.prime)
+
+    def time_is_strong_bpsw_prp(self, bits):
+        gmpy2.is_strong_bpsw_prp(self.prime)
+
+    def time_is_prime_composite(self, bits):
+        gmpy2.is_prime(self.m * 3)
+
+
+class PowmodList:
+    params = [[1024, 2048]]
+    param_names = ['bits']
+
+    def setup(self, bits):
+        rs = gmpy2.random_state(42)
+        self.m = gmpy2.mpz_urandomb(rs, bits) | 1
+        self.e = gmpy2.mpz_urandomb(rs, bits)
+        self.values = [gmpy2.mpz_urandomb(rs, bits) for _ in range(64)]
+
+    def time_powmod_base_list(self, bits):
+        gmpy2.powmod_base_list(self.values, self.e, self.m)
+
+    def time_powmod_loop(self, bits):
+        for b in self.values:
+            gmpy2.powmod(b, self.e, self.m)
+
+
+if __name__ == '__main__':
+    from _common import run_module
+    run_module(globals())
@@ -0,0 +1,21 @@
+"""Import time, measured in a fresh interpreter."""
+
+
+class Import:
+    def timeraw_import(self):
+        return "import gmpy2"
+
+    def timeraw_import_numbers_first(self):
+        return "import numbers, gmpy2"
+
+    def timeraw_import_and_use(self):
+        return "\n".join([
+            "import gmpy2",
+            "gmpy2.mpz(2)**100 + 1",
+            "gmpy2.next_prime(1000)",
+        ])
+
+
+if __name__ == '__main__':
+    from _common import run_module
+    run_module(globals())
@@ -0,0 +1,65 @@
+"""Real arithmetic at double, quad and high precision."""
+
+import gmpy2
+from gmpy2 import mpfr
+
+
+class Arithmetic:
+    params = [[53, 113, 1000]]
+    param_names = ['precision']
+
+    def setup(self, precision):
+        self.ctx = gmpy2.context(precision=precision)
+        with gmpy2.local_context(self.ctx):
+            self.a = gmpy2.sqrt(mpfr(2))
+            self.b = gmpy2.const_pi()
+            self.values = [mpfr(i) / 7 for i in range(1, 1001)]
+
+    def time_add(self, precision):
+        a, b = self.a, self.b
+        with gmpy2.local_context(self.ctx):
+            for _ in range(1000):
+                a + b
+
+    def time_mul(self, precision):
+        a, b = self.a, self.b
+        with gmpy2.local_context(self.ctx):
+            for _ in range(1000):
+                a * b
+
+    def time_div(self, precision):
+        a, b = self.a, self.b
+        with gmpy2.local_context(self.ctx):
+            for _ in range(1000):
+                a / b
+
+    def time_sqrt(self, precision):
+        a = self.a
+        with gmpy2.local_context(self.ctx):
+            for _ in range(1000):
+                gmpy2.sqrt(a)
+
+    def time_exp(self, precision):
+        with gmpy2.local_context(self.ctx):
+            for x in self.values[:100]:
+                gmpy2.exp(x)
+
+    def time_sin(self, precision):
+        with gmpy2.local_context(self.ctx):
+            for x in self.values[:100]:
+                gmpy2.sin(x)
+
+    def time_fsum(self, precision):
+        with gmpy2.local_context(self.ctx):
+            gmpy2.fsum(self.values)
+
+    def time_mixed_float(self, precision):
+        a = self.a
+        with gmpy2.local_context(self.ctx):
+            for _ in range(1000):
+                a * 1.5
+
+
+if __name__ == '__main__':
+    from _common import run_module
+    run_module(globals())
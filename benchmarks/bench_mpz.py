@@ -0,0 +1,83 @@
+"""Small integer arithmetic, compared with Python's int."""
+
+import gmpy2
+from gmpy2 import mpz
+
+KINDS = ['int', 'mpz']
+
+
+def _make(kind, value):
+    return mpz(value) if kind == 'mpz' else int(value)
+
+
+class SmallArithmetic:
+    params = [KINDS, [30, 64, 256]]
+    param_names = ['kind', 'bits']
+
+    def setup(self, kind, bits):
+        self.a = _make(kind, (1 << bits) - 12345)
+        self.b = _make(kind, (1 << (bits - 1)) + 6789)
+        self.values = [_make(kind, i * 7919 + 1) for i in range(1000)]
+
+    def time_add(self, kind, bits):
+        a, b = self.a, self.b
+        for _ in range(1000):
+            a + b
+
+    def time_mul(self, kind, bits):
+        a, b = self.a, self.b
+        for _ in range(1000):
+            a * b
+
+    def time_floordiv(self, kind, bits):
+        a, b = self.a, self.b
+        for _ in range(1000):
+            a // b
+
+    def time_mod(self, kind, bits):
+        a, b = self.a, self.b
+        for _ in range(1000):
+            a % b
+
+    def time_compare(self, kind, bits):
+        a, b = self.a, self.b
+        for _ in range(1000):
+            a < b
+
+    def time_mixed_int(self, kind, bits):
+        a = self.a
+        for _ in range(1000):
+            a + 1
+
+    def time_sum(self, kind, bits):
+        sum(self.values)
+
+    def time_hash(self, kind, bits):
+        for x in self.values:
+            hash(x)
+
+
+class LargeArithmetic:
+    params = [[4096, 65536, 1 << 20]]
+    param_names = ['bits']
+
+    def setup(self, bits):
+        self.a = mpz(3) ** (bits * 10 // 16)
+        self.b = mpz(7) ** (bits * 10 // 29)
+
+    def time_mul(self, bits):
+        self.a * self.b
+
+    def time_divmod(self, bits):
+        divmod(self.a, self.b)
+
+    def time_gcd(self, bits):
+        gmpy2.gcd(self.a, self.b)
+
+    def time_isqrt(self, bits):
+        gmpy2.isqrt(self.a)
+
+
+if __name__ == '__main__':
+    from _common import run_module
+    run_module(globals())
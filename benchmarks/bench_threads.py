@@ -0,0 +1,80 @@
+"""Scaling of the functions that release the GIL with the number of
+threads."""
+
+from concurrent.futures import ThreadPoolExecutor
+
+import gmpy2
+from gmpy2 import mpz
+
+try:
+    from ._common import has
+except ImportError:
+    from _common import has
+
+THREADS = [1, 2, 4]
+
+
+class PythonThreads:
+    """powmod() called from a pool of Python threads. Each call releases
+    the GIL, so the time should fall as threads are added."""
+
+    params = [THREADS]
+    param_names = ['threads']
+    timeout = 120
+
+    def setup(self, threads):
+        rs = gmpy2.random_state(42)
+        self.m = gmpy2.mpz_urandomb(rs, 2048) | 1
+        self.e = gmpy2.mpz_urandomb(rs, 2048)
+        self.values = [gmpy2.mpz_urandomb(rs, 2048) for _ in range(64)]
+        self.pool = ThreadPoolExecutor(threads)
+        self.chunks = [self.values[i::threads] for i in range(threads)]
+
+    def teardown(self, threads):
+        self.pool.shutdown()
+
+    def _work(self, chunk):
+        with gmpy2.local_context(allow_release_gil=True):
+            for b in chunk:
+                gmpy2.powmod(b, self.e, self.m)
+
+    def time_powmod(self, threads):
+        list(self.pool.map(self._work, self.chunks))
+
+
+class ContextThreads:
+    """Functions that split their work over context.threads."""
+
+    params = [THREADS]
+    param_names = ['threads']
+    timeout = 120
+
+    def setup(self, threads):
+        if not has('vmul', 'isum'):
+            raise NotImplementedError
+        rs = gmpy2.random_state(42)
+        try:
+            self.ctx = gmpy2.context(threads=threads, release_gil_min_bits=0)
+        except (TypeError, ValueError):
+            raise NotImplementedError
+        self.m = gmpy2.mpz_urandomb(rs, 2048) | 1
+        self.e = gmpy2.mpz_urandomb(rs, 2048)
+        self.values = [gmpy2.mpz_urandomb(rs, 2048) for _ in range(64)]
+        self.big = [gmpy2.mpz_urandomb(rs, 1 << 16) for _ in range(64)]
+
+    def time_powmod_base_list(self, threads):
+        with gmpy2.local_context(self.ctx):
+            gmpy2.powmod_base_list(self.values, self.e, self.m)
+
+    def time_vmul(self, threads):
+        with gmpy2.local_context(self.ctx):
+            gmpy2.vmul(self.big, self.big)
+
+    def time_isum(self, threads):
+        with gmpy2.local_context(self.ctx):
+            gmpy2.isum(self.big)
+
+
+if __name__ == '__main__':
+    from _common import run_module
+    run_module(globals())
@@ -4,6 +4,62 @@ from .gmpy2 import *
 # at the top level.
 # Use try...except to for static builds were _C_API is not available.
 try:
-    from .gmpy2 import _C_API, _mpmath_normalize, _mpmath_create
+    from .gmpy2 import (_C_API, _mpmath_normalize, _mpmath_normalize_list,
+                        _mpmath_create, _mpmath_add, _mpmath_mul,
+                        _mpmath_div, _mpmath_sqrt)
 except ImportError:
-    from .gmpy2 import _mpmath_normalize, _mpmath_create
+    from .gmpy2 import (_mpmath_normalize, _mpmath_normalize_list,
+                        _mpmath_create, _mpmath_add, _mpmath_mul,
+                        _mpmath_div, _mpmath_sqrt)
+
+# Importing numbers takes a large part of the import time of gmpy2, so the
+# types are only registered with the numeric tower when it is first
+# imported. If it already was, gmpy2 registered them at import.
+def _install_numbers_hook():
+    import sys
+
+    if 'numbers' in sys.modules:
+        return
+
+    class NumbersLoader:
+        """Run the loader of numbers, then register the gmpy2 types."""
+
+        def __init__(self, loader):
+            self._loader = loader
+
+        def __getattr__(self, name):
+            return getattr(self._loader, name)
+
+        def create_module(self, spec):
+            return self._loader.create_module(spec)
+
+        def exec_module(self, module):
+            self._loader.exec_module(module)
+            from .gmpy2 import _register_numbers
+            _register_numbers(module)
+
+    class NumbersFinder:
+        """Find numbers with the other finders and wrap its loader."""
+
+        @classmethod
+        def find_spec(cls, name, path=None, target=None):
+            if name != 'numbers':
+                return None
+            try:
+                sys.meta_path.remove(cls)
+            except ValueError:
+                pass
+            for finder in sys.meta_path:
+                find_spec = getattr(finder, 'find_spec', None)
+                spec = find_spec and find_spec(name, path, target)
+                if spec is not None:
+                    if hasattr(spec.loader, 'exec_module'):
+                        spec.loader = NumbersLoader(spec.loader)
+                    return spec
+            return None
+
+    sys.meta_path.insert(0, NumbersFinder)
+
+
+_install_numbers_hook()
+del _install_numbers_hook
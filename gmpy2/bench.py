@@ -0,0 +1,333 @@
+"""Benchmarks for tuning gmpy2 on a given machine.
+
+``python -m gmpy2.bench threads`` measures the `mpz` and `xmpz` operations
+that can release the GIL: addition, multiplication, the in-place operations
+of `xmpz` and three-argument `pow`. Each operation is run at a range of
+operand sizes, once with the GIL kept (``allow_release_gil=False``) and
+once with it released for every size (``release_gil_min_bits=0``). For each
+size it reports the p50 and p99 latency of a single call on one thread and
+the throughput of several Python threads calling it at the same time.
+
+The break-even size of an operation is the smallest size from which on
+releasing the GIL gives at least the throughput of keeping it, with the
+largest number of threads measured. The largest break-even size over the
+operations is suggested for `context.release_gil_min_bits`.
+"""
+
+import argparse
+import json
+import os
+import sys
+import threading
+import time
+
+from .gmpy2 import local_context, mpz_urandomb, random_state, xmpz
+
+__all__ = ['threads', 'main']
+
+_BITS = [64, 256, 1024, 4096, 16384, 65536]
+
+# Bits of the exponent used by the powmod benchmark. The size of the modulus
+# decides whether the GIL is released, so the exponent is kept fixed.
+_POWMOD_EXP_BITS = 256
+
+
+def _op_add(x, y, m):
+    return lambda: x + y
+
+
+def _op_mul(x, y, m):
+    return lambda: x * y
+
+
+def _op_iadd(x, y, m):
+    z = xmpz(x)
+    def op():
+        nonlocal z
+        z += y
+        z -= y
+    return op
+
+
+def _op_imul(x, y, m):
+    z = xmpz(x)
+    def op():
+        nonlocal z
+        z *= y
+        z //= y
+    return op
+
+
+def _op_powmod(x, y, m):
+    e = y >> max(y.bit_length() - _POWMOD_EXP_BITS, 0)
+    return lambda: pow(x, e, m)
+
+
+# name: (description, factory)
+_OPS = {
+    'add': ('x + y', _op_add),
+    'mul': ('x * y', _op_mul),
+    'iadd': ('z += y; z -= y (xmpz)', _op_iadd),
+    'imul': ('z *= y; z //= y (xmpz)', _op_imul),
+    'powmod': ('pow(x, e, m), %d-bit e' % _POWMOD_EXP_BITS, _op_powmod),
+}
+
+
+def _context(release):
+    # threads=1 keeps a large product from being split over native threads.
+    if release:
+        return local_context(allow_release_gil=True, release_gil_min_bits=0,
+                             threads=1)
+    return local_context(allow_release_gil=False, threads=1)
+
+
+def _operands(bits, state):
+    x = mpz_urandomb(state, bits) | (1 << (bits - 1))
+    y = mpz_urandomb(state, bits) | (1 << (bits - 1))
+    m = mpz_urandomb(state, bits) | (1 << (bits - 1)) | 1
+    return x, y, m
+
+
+def _estimate(op):
+    """Return a rough time in seconds of one call of op."""
+    count = 0
+    start = time.perf_counter()
+    while True:
+        op()
+        count += 1
+        elapsed = time.perf_counter() - start
+        if elapsed >= 0.001:
+            return elapsed / count
+
+
+def _latency(op, samples):
+    """Return the p50 and p99 time in seconds of one call of op, including
+    the cost of the call and of reading the clock."""
+    clock = time.perf_counter_ns
+    times = [0] * samples
+    for i in range(samples):
+        start = clock()
+        op()
+        times[i] = clock() - start
+    times.sort()
+    p50 = times[samples // 2]
+    p99 = times[min(samples - 1, (samples * 99) // 100)]
+    return p50 * 1e-9, p99 * 1e-9
+
+
+def _throughput(factory, args, nthreads, count, release):
+    """Return the calls per second of nthreads threads that each call a
+    new op count times."""
+    barrier = threading.Barrier(nthreads + 1)
+    errors = []
+
+    def worker():
+        try:
+            op = factory(*args)
+            with _context(release):
+                barrier.wait()
+                for _ in range(count):
+                    op()
+        except BaseException as exc:
+            errors.append(exc)
+            barrier.abort()
+
+    workers = [threading.Thread(target=worker) for _ in range(nthreads)]
+    for t in workers:
+        t.start()
+    try:
+        barrier.wait()
+    except threading.BrokenBarrierError:
+        pass
+    start = time.perf_counter()
+    for t in workers:
+        t.join()
+    elapsed = time.perf_counter() - start
+    if errors:
+        raise errors[0]
+    return nthreads * count / max(elapsed, 1e-9)
+
+
+def _break_even(sizes):
+    """Return the smallest size from which on releasing the GIL is not
+    slower with the largest number of threads, or None."""
+    result = None
+    for size in reversed(sizes):
+        if size['gain'] < 1.0:
+            break
+        result = size['bits']
+    return result
+
+
+def _default_threads():
+    n = os.cpu_count() or 1
+    result = [1]
+    while result[-1] * 2 <= n:
+        result.append(result[-1] * 2)
+    if result[-1] != n:
+        result.append(n)
+    return result
+
+
+def threads(ops=None, bits=None, threads=None, duration=0.1, report=None):
+    """Measure the GIL-releasing operations and return the results.
+
+    ops lists the operations to measure (``'add'``, ``'mul'``, ``'iadd'``,
+    ``'imul'`` and ``'powmod'``; all by default), bits the operand sizes
+    and threads the numbers of Python threads. Each measurement runs for
+    about duration seconds. If report is given, it is called with the
+    results of each operation as they become available.
+
+    The result is a dictionary with the key ``'ops'``, which maps each
+    operation to a dictionary with its ``'sizes'`` and ``'break_even'``
+    size, and the key ``'suggested'`` with the largest break-even size, or
+    None if releasing the GIL did not pay off for some operation.
+    """
+    if ops is None:
+        ops = list(_OPS)
+    for name in ops:
+        if name not in _OPS:
+            raise ValueError('unknown operation %r' % (name,))
+    bits = sorted(set(bits or _BITS))
+    if bits[0] < 1:
+        raise ValueError('operand sizes must be positive')
+    threads = sorted(set(threads or _default_threads()))
+    if threads[0] < 1:
+        raise ValueError('thread counts must be positive')
+    if duration <= 0:
+        raise ValueError('duration must be positive')
+
+    state = random_state(42)
+    result = {'ops': {}, 'suggested': None}
+    suggested = 0
+    for name in ops:
+        factory = _OPS[name][1]
+        sizes = []
+        for b in bits:
+            args = _operands(b, state)
+            size = {'bits': b, 'latency': {}, 'throughput': {}}
+            count = 1
+            for release in (False, True):
+                mode = 'nogil' if release else 'gil'
+                with _context(release):
+                    op = factory(*args)
+                    estimate = _estimate(op)
+                    samples = min(max(int(duration / estimate), 100), 100000)
+                    size['latency'][mode] = _latency(op, samples)
+                count = max(count, int(duration / estimate))
+                size['throughput'][mode] = {
+                    t: _throughput(factory, args, t, max(count // t, 1),
+                                   release)
+                    for t in threads}
+            top = threads[-1]
+            size['gain'] = (size['throughput']['nogil'][top] /
+                            size['throughput']['gil'][top])
+            sizes.append(size)
+        entry = {'sizes': sizes, 'break_even': _break_even(sizes)}
+        result['ops'][name] = entry
+        if suggested is not None:
+            if entry['break_even'] is None:
+                suggested = None
+            else:
+                suggested = max(suggested, entry['break_even'])
+        if report is not None:
+            report(name, entry, threads)
+    result['suggested'] = suggested
+    return result
+
+
+def _format_time(t):
+    for unit, scale in (('s', 1.0), ('ms', 1e-3), ('us', 1e-6)):
+        if t >= scale:
+            return '%.3g%s' % (t / scale, unit)
+    return '%.3gns' % (t * 1e9)
+
+
+def _format_rate(r):
+    for unit, scale in (('G', 1e9), ('M', 1e6), ('k', 1e3)):
+        if r >= scale:
+            return '%.3g%s' % (r / scale, unit)
+    return '%.3g' % r
+
+
+def _print_op(name, entry, threads, out=None):
+    out = out or sys.stdout
+    print('%s: %s' % (name, _OPS[name][0]), file=out)
+    header = ['bits', 'p50 gil', 'p50', 'p99']
+    header += ['%d thr' % t for t in threads]
+    header.append('gain')
+    rows = [header]
+    for size in entry['sizes']:
+        row = [str(size['bits']),
+               _format_time(size['latency']['gil'][0]),
+               _format_time(size['latency']['nogil'][0]),
+               _format_time(size['latency']['nogil'][1])]
+        row += [_format_rate(size['throughput']['nogil'][t]) + '/s'
+                for t in threads]
+        row.append('%.2fx' % size['gain'])
+        rows.append(row)
+    widths = [max(len(row[i]) for row in rows) for i in range(len(header))]
+    for row in rows:
+        print('  ' + '  '.join(c.rjust(w) for c, w in zip(row, widths)),
+              file=out)
+    if entry['break_even'] is None:
+        print('  break-even: not reached', file=out)
+    else:
+        print('  break-even: %d bits' % entry['break_even'], file=out)
+    print(file=out)
+
+
+def _int_list(text):
+    return [int(s) for s in text.split(',') if s]
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(prog='python -m gmpy2.bench',
+                                     description=__doc__.splitlines()[0])
+    commands = parser.add_subparsers(dest='command')
+    p = commands.add_parser(
+        'threads', help='latency and thread scaling of the GIL release')
+    p.add_argument('--ops', default=','.join(_OPS),
+                   help='operations to measure (default: %(default)s)')
+    p.add_argument('--bits', type=_int_list,
+                   default=','.join(str(b) for b in _BITS),
+                   help='operand sizes in bits (default: %(default)s)')
+    p.add_argument('--threads', type=_int_list, default=None,
+                   help='numbers of threads (default: powers of two up to '
+                        'the number of CPUs)')
+    p.add_argument('--time', type=float, default=0.1,
+                   help='seconds per measurement (default: %(default)s)')
+    p.add_argument('--json', action='store_true',
+                   help='print the results as JSON')
+    args = parser.parse_args(argv)
+    if args.command != 'threads':
+        parser.print_help()
+        return 2
+
+    ops = [s for s in args.ops.split(',') if s]
+    report = None
+    started = []
+    if not args.json:
+        def report(name, entry, threads):
+            if not started:
+                print('Latency is for one thread; throughput is with the GIL '
+                      'released, and gain\ncompares it with keeping the GIL '
+                      'on the most threads.\n')
+                started.append(True)
+            _print_op(name, entry, threads)
+    try:
+        result = threads(ops, args.bits, args.threads, args.time, report)
+    except ValueError as exc:
+        parser.error(str(exc))
+    if args.json:
+        print(json.dumps(result, indent=2))
+    elif result['suggested'] is None:
+        print('Releasing the GIL did not pay off for some operation at the '
+              'sizes measured.')
+    else:
+        print('Suggested release_gil_min_bits: %d' % result['suggested'])
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
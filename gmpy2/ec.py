@@ -0,0 +1,57 @@
+"""Elliptic curves over prime fields.
+
+`Curve` computes with the points of a curve y**2 = x**3 + a*x + b modulo a
+prime p. The points are kept in Jacobian coordinates during a computation
+and the scalars are recoded in wNAF form; `Curve.mul_many()` multiplies a
+batch of points on the context's threads with a single modular inversion
+for all the results.
+
+The arithmetic is not constant-time. It is meant for public values, for
+example to verify signatures or to count and test points, and not for
+computations with secret keys.
+"""
+
+from .gmpy2 import _ec_curve as Curve, mpz
+
+__all__ = ['Curve', 'named_curve']
+
+# name: (p, a, b, Gx, Gy, n)
+_CURVES = {
+    'secp256k1': (
+        0xfffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f,
+        0,
+        7,
+        0x79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798,
+        0x483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8,
+        0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141),
+    'P-256': (
+        0xffffffff00000001000000000000000000000000ffffffffffffffffffffffff,
+        -3,
+        0x5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b,
+        0x6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296,
+        0x4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5,
+        0xffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551),
+    'P-384': (
+        int('fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffe'
+            'ffffffff0000000000000000ffffffff', 16),
+        -3,
+        int('b3312fa7e23ee7e4988e056be3f82d19181d9c6efe8141120314088f5013875a'
+            'c656398d8a2ed19d2a85c8edd3ec2aef', 16),
+        int('aa87ca22be8b05378eb1c71ef320ad746e1d3b628ba79b9859f741e082542a38'
+            '5502f25dbf55296c3a545e3872760ab7', 16),
+        int('3617de4a96262c6f5d9e98bf9292dc29f8f41dbd289a147ce9da3113b5f0b8c0'
+            '0a60b1ce1d7e819d7a431d7c90ea0e5f', 16),
+        int('ffffffffffffffffffffffffffffffffffffffffffffffffc7634d81f4372ddf'
+            '581a0db248b0a77aecec196accc52973', 16)),
+}
+
+
+def named_curve(name):
+    """Return (curve, G, n) for the curve 'secp256k1', 'P-256' or 'P-384',
+    where G is the standard base point and n its prime order."""
+    try:
+        p, a, b, gx, gy, n = _CURVES[name]
+    except KeyError:
+        raise ValueError('unknown curve %r' % (name,)) from None
+    curve = Curve(p, a, b)
+    return curve, (mpz(gx), mpz(gy)), mpz(n)
@@ -0,0 +1,10 @@
+"""Side channel resistant modular arithmetic.
+
+The arithmetic of `Modulus` uses the mpn_sec functions of GMP. The time
+taken and the memory accessed depend on the sizes of the modulus and of the
+largest exponent, but not on the values of the operands.
+"""
+
+from .gmpy2 import _sec_modulus as Modulus
+
+__all__ = ['Modulus']
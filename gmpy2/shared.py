@@ -0,0 +1,114 @@
+"""Arrays in shared memory.
+
+`share()` writes an `mpz_array`, `mpfr_array` or `mpc_array` to a block of
+`multiprocessing.shared_memory.SharedMemory` and `attach()` opens it by name
+in another process. The attached array is a read-only view of the shared
+block: the values are not copied until they are accessed (`mpz_array`) or
+the significands are used in place (`mpfr_array` and `mpc_array` with
+64-bit limbs on a little-endian platform). Call copy() on the array to get
+one that can be changed.
+
+A `SharedArray` can be pickled; it is sent as its name and attached again
+when it is unpickled, so it can be passed to the workers of a
+`multiprocessing.Pool`.
+"""
+
+from multiprocessing import shared_memory
+
+from .gmpy2 import load_mpz_array, mpc_array, mpfr_array, mpz_array
+
+__all__ = ['SharedArray', 'share', 'attach']
+
+_MPZ_MAGIC = b'GMPYZA'
+
+
+class SharedArray:
+    """An array in a block of shared memory.
+
+    The array is available as the attribute ``array``. Delete all
+    references to it, and to slices of a mapped `mpz_array`, before
+    calling close().
+    """
+
+    def __init__(self, shm, owner=False):
+        self._shm = shm
+        self._owner = owner
+        buf = shm.buf
+        if bytes(buf[:6]) == _MPZ_MAGIC:
+            self.array = load_mpz_array(buf)
+        elif buf[0] == 0x09:
+            self.array = mpc_array.from_buffer(buf)
+        else:
+            self.array = mpfr_array.from_buffer(buf)
+
+    @property
+    def name(self):
+        """The name of the block of shared memory."""
+        return self._shm.name
+
+    def close(self):
+        """Release the array and close the shared memory in this process."""
+        self.array = None
+        self._shm.close()
+
+    def unlink(self):
+        """Free the shared memory once all processes have closed it."""
+        self._shm.unlink()
+
+    def __del__(self):
+        # The view must be released before SharedMemory closes the block.
+        self.array = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+        if self._owner:
+            self.unlink()
+
+    def __reduce__(self):
+        return (attach, (self.name,))
+
+    def __repr__(self):
+        return '<SharedArray %r of %d elements>' % (self.name, len(self.array))
+
+
+def share(array, name=None):
+    """Copy array to a new block of shared memory and return a SharedArray.
+
+    The creating process owns the block: leaving a ``with`` block of the
+    result also unlinks it.
+    """
+    if isinstance(array, mpz_array):
+        shm = shared_memory.SharedMemory(name, create=True,
+                                         size=max(array.saved_size(), 1))
+        array.save(shm.buf)
+    elif isinstance(array, (mpfr_array, mpc_array)):
+        data = array.to_binary()
+        shm = shared_memory.SharedMemory(name, create=True, size=len(data))
+        shm.buf[:len(data)] = data
+        del data
+    else:
+        raise TypeError('share() requires an mpz_array, mpfr_array or mpc_array')
+    try:
+        return SharedArray(shm, owner=True)
+    except BaseException:
+        shm.close()
+        shm.unlink()
+        raise
+
+
+def attach(name):
+    """Return a SharedArray for the block of shared memory created by
+    `share()` with the given name."""
+    try:
+        shm = shared_memory.SharedMemory(name, track=False)
+    except TypeError:
+        # Python < 3.13 has no track argument.
+        shm = shared_memory.SharedMemory(name)
+    try:
+        return SharedArray(shm)
+    except BaseException:
+        shm.close()
+        raise
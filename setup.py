@@ -16,6 +16,8 @@ class Gmpy2Build(build_ext):
         ('gcov', None, "Enable GCC code coverage collection"),
         ('vector', None, "Include the vector_XXX() functions;"
          "they are unstable and under active development"),
+        ('usdt', None, "Include USDT probes for perf, bpftrace, or dtrace;"
+         "requires sys/sdt.h (see set_trace())"),
         ('static', None, "Enable static linking compile time options."),
         ('static-dir=', None, "Enable static linking and specify location."),
         ('gdb', None, "Build with debug symbols."),
@@ -26,6 +28,7 @@ class Gmpy2Build(build_ext):
         self.fast = False
         self.gcov = False
         self.vector = False
+        self.usdt = False
         self.static = False
         self.static_dir = False
         self.gdb = False
@@ -43,6 +46,8 @@ class Gmpy2Build(build_ext):
             self.libraries.append('gcov')
         if self.vector:
             _comp_args.append('DVECTOR=1')
+        if self.usdt:
+            _comp_args.append('DGMPY_USDT=1')
         if self.static:
             _comp_args.remove('DSHARED=1')
             _comp_args.append('DSTATIC=1')
@@ -511,6 +511,7 @@
  */
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
+#include <structmember.h>
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -554,31 +555,239 @@ LGPL 3 or later.";
 #define MAX_CACHE_MPZ_LIMBS (64)
 #define MAX_CACHE_MPFR_BITS (1024)
 
+/* Cached mpfr objects keep their mantissa. They are grouped by the number of
+ * limbs used by the mantissa so a cached object can be reused for any
+ * precision that fits in the same storage.
+ */
+
+#define MPFR_CACHE_BUCKETS (MAX_CACHE_MPFR_BITS / GMP_NUMB_BITS)
+#define MPFR_CACHE_BUCKET(bits) (((bits) - 1) / GMP_NUMB_BITS)
+
+/* Cached mpz, xmpz, and mpq objects are grouped into size classes. An object
+ * whose limb allocation is in [2**n, 2**(n+1)) is kept in class n so a
+ * request for a given number of limbs only reuses an object of about the
+ * right size. An mpq is classified by the smaller of the allocations of its
+ * numerator and denominator.
+ */
+
+#define MPZ_CACHE_CLASSES (15)
+#define MPZ_CACHE_SEARCH (2)
+
+/* Like CPython's small int cache, gmpy2 keeps one preallocated mpz for every
+ * value from GMPY_MPZ_SMALL_MIN to GMPY_MPZ_SMALL_MAX. They are created when
+ * the module is initialized and are never freed.
+ */
+
+#define GMPY_MPZ_SMALL_MIN (-5)
+#define GMPY_MPZ_SMALL_MAX (256)
+#define GMPY_MPZ_SMALL_COUNT (GMPY_MPZ_SMALL_MAX - GMPY_MPZ_SMALL_MIN + 1)
+
+/* Index of each cache in the settings and statistics arrays. */
+
+enum {
+    GMPY_CACHE_MPZ,
+    GMPY_CACHE_XMPZ,
+    GMPY_CACHE_MPQ,
+    GMPY_CACHE_MPFR,
+    GMPY_CACHE_MPC,
+    GMPY_CACHE_TYPES
+};
+
 typedef struct {
-    mpz_t tempz;             /* Temporary variable used for integer conversions */
+    unsigned long long hits;        /* Objects taken from the cache */
+    unsigned long long misses;      /* Objects that had to be allocated */
+    unsigned long long evictions;   /* Objects freed instead of cached */
+    Py_ssize_t live;                /* Objects created less objects freed */
+    Py_ssize_t peak;                /* Largest value of live */
+} gmpy_cache_stats;
+
+/* The arrays are allocated for MAX_CACHE objects; the number of objects that
+ * are actually kept is set at runtime by set_cache().
+ */
 
-    MPZ_Object *gmpympzcache[CACHE_SIZE];
-    int in_gmpympzcache;
+typedef struct {
+    MPZ_Object *gmpympzcache[MPZ_CACHE_CLASSES][MAX_CACHE];
+    int in_gmpympzcache[MPZ_CACHE_CLASSES];
 
-    XMPZ_Object *gmpyxmpzcache[CACHE_SIZE];
-    int in_gmpyxmpzcache;
+    XMPZ_Object *gmpyxmpzcache[MPZ_CACHE_CLASSES][MAX_CACHE];
+    int in_gmpyxmpzcache[MPZ_CACHE_CLASSES];
 
-    MPQ_Object *gmpympqcache[CACHE_SIZE];
-    int in_gmpympqcache;
+    MPQ_Object *gmpympqcache[MPZ_CACHE_CLASSES][MAX_CACHE];
+    int in_gmpympqcache[MPZ_CACHE_CLASSES];
 
-    MPFR_Object *gmpympfrcache[CACHE_SIZE];
-    int in_gmpympfrcache;
+    MPFR_Object *gmpympfrcache[MPFR_CACHE_BUCKETS][MAX_CACHE];
+    int in_gmpympfrcache[MPFR_CACHE_BUCKETS];
 
-    MPC_Object *gmpympccache[CACHE_SIZE];
+    MPC_Object *gmpympccache[MAX_CACHE];
     int in_gmpympccache;
+
+    gmpy_cache_stats stats[GMPY_CACHE_TYPES];
+} gmpy_cache;
+
+/* The memoized results of const_pi(), const_euler(), const_log2(), and
+ * const_catalan(). The number of entries that are kept is set at runtime
+ * by set_const_cache().
+ */
+
+#define GMPY_CONST_PI 0
+#define GMPY_CONST_EULER 1
+#define GMPY_CONST_LOG2 2
+#define GMPY_CONST_CATALAN 3
+#define GMPY_CONST_TYPES 4
+
+#define GMPY_CONST_CACHE_MAX 256
+#define GMPY_CONST_CACHE_SIZE 32
+
+typedef struct {
+    int which;
+    mpfr_prec_t prec;
+    mpfr_rnd_t round;
+    unsigned long long last_used;
+    MPFR_Object *value;
+} gmpy_const_entry;
+
+typedef struct {
+    gmpy_const_entry entries[GMPY_CONST_CACHE_MAX];
+    int count;
+    int size;
+    unsigned long long clock;
+    unsigned long long hits;
+    unsigned long long misses;
+} gmpy_const_cache;
+
+/* The factorials and primorials memoized by fac() and primorial(). The
+ * cache is disabled until set_fac_cache() gives it a size.
+ */
+
+#define GMPY_FAC_CACHE_MAX 256
+
+typedef struct {
+    int which;
+    unsigned long n;
+    unsigned long long last_used;
+    MPZ_Object *value;
+} gmpy_fac_entry;
+
+typedef struct {
+    gmpy_fac_entry entries[GMPY_FAC_CACHE_MAX];
+    int count;
+    int size;
+    unsigned long long clock;
+    unsigned long long hits;
+    unsigned long long misses;
+} gmpy_fac_cache;
+
+/* The tables returned by roots_of_unity() and used by fft() and ifft().
+ * Tables with more than GMPY_ROOTS_CACHE_MAXN entries are not kept.
+ */
+
+#define GMPY_ROOTS_CACHE_SIZE 8
+#define GMPY_ROOTS_CACHE_MAXN 65536
+
+typedef struct {
+    unsigned long n;
+    mpfr_prec_t rprec;
+    mpfr_prec_t iprec;
+    unsigned long long last_used;
+    PyObject *table;
+} gmpy_roots_entry;
+
+/* The powers of each base used to convert large mpz values to and from
+ * strings. The cache is disabled until set_radix_cache() gives it a size.
+ */
+
+#define GMPY_RADIX_CACHE_MAX 64
+
+typedef struct {
+    int base;
+    unsigned long long last_used;
+    PyObject *table;        /* tuple of base**(leaf * 2**i) for each level i */
+} gmpy_radix_entry;
+
+typedef struct {
+    gmpy_radix_entry entries[GMPY_RADIX_CACHE_MAX];
+    int count;
+    int size;
+    unsigned long long clock;
+    unsigned long long hits;
+    unsigned long long misses;
+} gmpy_radix_cache;
+
+/* The powers used by num_digits() and ilog(). Powers with more than
+ * GMPY_POW_CACHE_MAXBITS bits are not kept.
+ */
+
+#define GMPY_POW_CACHE_SIZE 64
+#define GMPY_POW_CACHE_MAXBITS 1048576
+
+typedef struct {
+    unsigned long base;
+    unsigned long exp;
+    unsigned long long last_used;
+    MPZ_Object *value;
+} gmpy_pow_entry;
+
+typedef struct {
+    mpz_t tempz;             /* Temporary variable used for integer conversions */
+
+    /* With the GIL, this is the only cache. In a free-threaded build, it is
+     * the shared pool behind the per-thread caches and is protected by
+     * cache_lock.
+     */
+    gmpy_cache cache;
+#ifdef Py_GIL_DISABLED
+    PyMutex cache_lock;
+#endif
+
+    /* Shared by all threads; protected by const_lock in a free-threaded
+     * build.
+     */
+    gmpy_const_cache const_cache;
+    gmpy_fac_cache fac_cache;
+    gmpy_roots_entry roots_cache[GMPY_ROOTS_CACHE_SIZE];
+    int roots_count;
+    unsigned long long roots_clock;
+    gmpy_pow_entry pow_cache[GMPY_POW_CACHE_SIZE];
+    int pow_count;
+    unsigned long long pow_clock;
+    gmpy_radix_cache radix_cache;
+#ifdef Py_GIL_DISABLED
+    PyMutex const_lock;
+#endif
+
+    /* Maximum number of cached objects and the largest object, in limbs,
+     * that is cached. The mpz limit applies to each of the numerator and
+     * denominator of an mpq and the mpfr limit applies to each of the real
+     * and imaginary parts of an mpc.
+     */
+    int cache_size[GMPY_CACHE_TYPES];
+    int cache_limbs[GMPY_CACHE_TYPES];
+
+    /* The preallocated small integers. */
+    MPZ_Object *small_mpz[GMPY_MPZ_SMALL_COUNT];
+
+    /* gmpy2.from_binary, returned by the __reduce__ methods. */
+    PyObject *from_binary;
+
+    /* fractions.Fraction and the offsets of its _numerator and _denominator
+     * slots, looked up when the first Fraction is converted.
+     */
+    PyTypeObject *fraction_type;
+    Py_ssize_t fraction_num_offset;
+    Py_ssize_t fraction_den_offset;
+    int fraction_lookup_done;
 } gmpy_global;
 
 static gmpy_global global = {
-    .in_gmpympzcache = 0,
-    .in_gmpyxmpzcache = 0,
-    .in_gmpympqcache = 0,
-    .in_gmpympfrcache = 0,
-    .in_gmpympccache = 0,
+    .cache.in_gmpympzcache = {0},
+    .cache.in_gmpyxmpzcache = {0},
+    .cache.in_gmpympqcache = {0},
+    .cache.in_gmpympfrcache = {0},
+    .cache.in_gmpympccache = 0,
+    .cache_size = {CACHE_SIZE, CACHE_SIZE, CACHE_SIZE, CACHE_SIZE, CACHE_SIZE},
+    .cache_limbs = {MAX_CACHE_MPZ_LIMBS, MAX_CACHE_MPZ_LIMBS, MAX_CACHE_MPZ_LIMBS,
+                    MPFR_CACHE_BUCKETS, MPFR_CACHE_BUCKETS},
+    .const_cache.size = GMPY_CONST_CACHE_SIZE,
 };
 
 /* Support for context manager using context vars.
@@ -586,6 +795,13 @@ static gmpy_global global = {
  */
 
 static PyObject *current_context_var = NULL;
+static PyObject *context_stack_var = NULL;
+
+/* Sticky flags raised while a frozen context is in use. Frozen contexts are
+ * shared between threads, so their flags are kept per thread instead.
+ */
+
+static GMPY_THREAD_LOCAL gmpy_context gmpy_frozen_flags;
 
 /* Define gmpy2 specific errors for mpfr and mpc data types. No change will
  * be made the exceptions raised by mpz, xmpz, and mpq.
@@ -608,10 +824,38 @@ static PyObject *GMPyExc_Erange = NULL;
 
 #include "gmpy2_cache.c"
 
+/* Memory functions for GMP, MPFR, and MPC are in gmpy2_alloc.c. */
+
+#include "gmpy2_alloc.c"
+
+/* Statistics collected by context.profile are in gmpy2_profile.c. */
+
+#include "gmpy2_profile.c"
+
+/* Tracing enabled by set_trace() is in gmpy2_trace.c. */
+
+#include "gmpy2_trace.c"
+
 /* Miscellaneous helper functions and simple methods are in gmpy_misc.c. */
 
 #include "gmpy2_misc.c"
 
+/* Interrupting long computations is in gmpy2_interrupt.c. */
+
+#include "gmpy2_interrupt.c"
+
+/* Splitting loops over native threads is in gmpy2_parallel.c. */
+
+#include "gmpy2_parallel.c"
+
+/* Per-thread scratch integers are in gmpy2_scratch.c. */
+
+#include "gmpy2_scratch.c"
+
+/* Montgomery arithmetic for the context-free cores is in gmpy2_mont.c. */
+
+#include "gmpy2_mont.c"
+
 /* Support for conversion to/from binary representation. */
 
 #include "gmpy2_binary.c"
@@ -676,15 +920,38 @@ static PyObject *GMPyExc_Erange = NULL;
 #include "gmpy2_mpz_misc.c"
 #include "gmpy2_xmpz_misc.c"
 #include "gmpy2_xmpz_limbs.c"
+#include "gmpy2_mpz_array.c"
+#include "gmpy2_mpfr_array.c"
+#include "gmpy2_buffer.c"
+#include "gmpy2_sieve.c"
+#include "gmpy2_special.c"
+#include "gmpy2_series.c"
+#include "gmpy2_fixedbase.c"
 
-#ifdef VECTOR
 #include "gmpy2_vector.c"
-#endif
+#include "gmpy2_matrix.c"
+#include "gmpy2_tree.c"
+#include "gmpy2_fft.c"
+#include "gmpy2_modulus.c"
+#include "gmpy2_sec.c"
+#include "gmpy2_divisor.c"
+#include "gmpy2_crt.c"
+#include "gmpy2_rns.c"
+#include "gmpy2_nmod_poly.c"
+#include "gmpy2_ec.c"
+#include "gmpy2_sqrtmod.c"
+#include "gmpy2_factor.c"
+#include "gmpy2_dlog.c"
+#include "gmpy2_accumulator.c"
+#include "gmpy2_expr.c"
+#include "gmpy2_submit.c"
+#include "gmpy2_capi.c"
 
 /* Include gmpy_context last to avoid adding doc names to .h files. */
 
 #include "gmpy2_mpz.c"
 #include "gmpy2_xmpz.c"
+#include "gmpy2_mpz_view.c"
 #include "gmpy2_mpq.c"
 #include "gmpy2_mpfr.c"
 #include "gmpy2_mpc.c"
@@ -693,7 +960,12 @@ static PyObject *GMPyExc_Erange = NULL;
 
 static PyMethodDef Pygmpy_methods [] =
 {
-    { "add", GMPy_Context_Add, METH_VARARGS, GMPy_doc_function_add },
+    { "add", (PyCFunction)GMPy_Context_Add, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_function_add },
+    { "allocation_guard", GMPy_Allocation_Guard, METH_NOARGS, GMPy_doc_allocation_guard },
+    { "allocator_info", (PyCFunction)GMPy_Allocator_Info, METH_VARARGS | METH_KEYWORDS, GMPy_doc_allocator_info },
+    { "arena", (PyCFunction)GMPy_Arena_Factory, METH_VARARGS | METH_KEYWORDS, GMPy_doc_arena_factory },
+    { "argsort", (PyCFunction)GMPy_MPZ_Function_Argsort, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_argsort },
+    { "bisect", (PyCFunction)GMPy_MPZ_Function_Bisect, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_bisect },
     { "bit_clear", GMPy_MPZ_bit_clear_function, METH_VARARGS, doc_bit_clear_function },
     { "bit_count", GMPy_MPZ_bit_count, METH_O, doc_bit_count },
     { "bit_flip", GMPy_MPZ_bit_flip_function, METH_VARARGS, doc_bit_flip_function },
@@ -703,10 +975,19 @@ static PyMethodDef Pygmpy_methods [] =
     { "bit_scan1", GMPy_MPZ_bit_scan1_function, METH_VARARGS, doc_bit_scan1_function },
     { "bit_set", GMPy_MPZ_bit_set_function, METH_VARARGS, doc_bit_set_function },
     { "bit_test", GMPy_MPZ_bit_test_function, METH_VARARGS, doc_bit_test_function },
+    { "bit_test_many", (PyCFunction)GMPy_MPZ_Function_Bit_Test_Many, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_bit_test_many },
+    { "batch_gcd", GMPy_MPZ_Function_Batch_GCD, METH_O, GMPy_doc_mpz_function_batch_gcd },
+    { "binary_splitting", (PyCFunction)(void(*)(void))GMPy_MPZ_Function_Binary_Splitting, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_binary_splitting },
     { "bincoef", GMPy_MPZ_Function_Bincoef, METH_VARARGS, GMPy_doc_mpz_function_bincoef },
+    { "bincoef_row", GMPy_MPZ_Function_Bincoef_Row, METH_O, GMPy_doc_mpz_function_bincoef_row },
+    { "cache_info", GMPy_Cache_Info, METH_NOARGS, GMPy_doc_cache_info },
     { "cmp", GMPy_MPANY_cmp, METH_VARARGS, GMPy_doc_mpany_cmp },
     { "cmp_abs", GMPy_MPANY_cmp_abs, METH_VARARGS, GMPy_doc_mpany_cmp_abs },
+    { "cornacchia", GMPy_MPZ_Function_Cornacchia, METH_VARARGS, GMPy_doc_mpz_function_cornacchia },
+    { "crt", GMPy_MPZ_Function_CRT, METH_VARARGS, GMPy_doc_mpz_function_crt },
     { "comb", GMPy_MPZ_Function_Bincoef, METH_VARARGS, GMPy_doc_mpz_function_comb },
+    { "cont_frac", (PyCFunction)(void(*)(void))GMPy_MPQ_Function_Cont_Frac, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_cont_frac },
+    { "convergents", (PyCFunction)(void(*)(void))GMPy_MPQ_Function_Convergents, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_convergents },
     { "c_div", GMPy_MPZ_c_div, METH_VARARGS, doc_c_div },
     { "c_div_2exp", GMPy_MPZ_c_div_2exp, METH_VARARGS, doc_c_div_2exp },
     { "c_divmod", GMPy_MPZ_c_divmod, METH_VARARGS, doc_c_divmod },
@@ -714,31 +995,50 @@ static PyMethodDef Pygmpy_methods [] =
     { "c_mod", GMPy_MPZ_c_mod, METH_VARARGS, doc_c_mod },
     { "c_mod_2exp", GMPy_MPZ_c_mod_2exp, METH_VARARGS, doc_c_mod_2exp },
     { "denom", GMPy_MPQ_Function_Denom, METH_O, GMPy_doc_mpq_function_denom },
+    { "det", GMPy_Context_Det, METH_O, GMPy_doc_function_det },
     { "digits", GMPy_Context_Digits, METH_VARARGS, GMPy_doc_context_digits },
+    { "discrete_log", (PyCFunction)GMPy_MPZ_Function_Discrete_Log, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_discrete_log },
     { "div", GMPy_Context_TrueDiv, METH_VARARGS, GMPy_doc_truediv },
     { "divexact", GMPy_MPZ_Function_Divexact, METH_VARARGS, GMPy_doc_mpz_function_divexact },
     { "divm", GMPy_MPZ_Function_Divm, METH_VARARGS, GMPy_doc_mpz_function_divm },
+    { "dot", GMPy_Context_Dot, METH_VARARGS, GMPy_doc_function_dot },
     { "double_fac", GMPy_MPZ_Function_DoubleFac, METH_O, GMPy_doc_mpz_function_double_fac },
     { "fac", GMPy_MPZ_Function_Fac, METH_O, GMPy_doc_mpz_function_fac },
+    { "fac_mod", GMPy_MPZ_Function_Fac_Mod, METH_VARARGS, GMPy_doc_mpz_function_fac_mod },
+    { "fac_cache_info", GMPy_Fac_Cache_Info, METH_NOARGS, GMPy_doc_fac_cache_info },
+    { "factor", (PyCFunction)GMPy_MPZ_Function_Factor, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_factor },
     { "fib", GMPy_MPZ_Function_Fib, METH_O, GMPy_doc_mpz_function_fib },
+    { "fib_mod", GMPY_mpz_fib_mod, METH_VARARGS, doc_mpz_fib_mod },
     { "fib2", GMPy_MPZ_Function_Fib2, METH_O, GMPy_doc_mpz_function_fib2 },
+    { "fib2_mod", GMPY_mpz_fib2_mod, METH_VARARGS, doc_mpz_fib2_mod },
     { "floor_div", GMPy_Context_FloorDiv, METH_VARARGS, GMPy_doc_floordiv },
+    { "from_array", (PyCFunction)GMPy_Function_From_Array, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_from_array },
     { "from_binary", GMPy_MPANY_From_Binary, METH_O, doc_from_binary },
+    { "from_binary_at", GMPy_MPANY_From_Binary_At, METH_VARARGS, doc_from_binary_at },
+    { "from_binary_many", (PyCFunction)GMPy_MPANY_From_Binary_Many, METH_VARARGS | METH_KEYWORDS, doc_from_binary_many },
     { "f_div", GMPy_MPZ_f_div, METH_VARARGS, doc_f_div },
     { "f_div_2exp", GMPy_MPZ_f_div_2exp, METH_VARARGS, doc_f_div_2exp },
     { "f_divmod", GMPy_MPZ_f_divmod, METH_VARARGS, doc_f_divmod },
     { "f_divmod_2exp", GMPy_MPZ_f_divmod_2exp, METH_VARARGS, doc_f_divmod_2exp },
     { "f_mod", GMPy_MPZ_f_mod, METH_VARARGS, doc_f_mod },
     { "f_mod_2exp", GMPy_MPZ_f_mod_2exp, METH_VARARGS, doc_f_mod_2exp },
-    { "gcd", (PyCFunction)GMPy_MPZ_Function_GCD, METH_FASTCALL, GMPy_doc_mpz_function_gcd },
+    { "gcd", (PyCFunction)GMPy_MPZ_Function_GCD, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_mpz_function_gcd },
     { "gcdext", GMPy_MPZ_Function_GCDext, METH_VARARGS, GMPy_doc_mpz_function_gcdext },
     { "hamdist", GMPy_MPZ_hamdist, METH_VARARGS, doc_hamdist },
+    { "hamdist_many", (PyCFunction)GMPy_MPZ_Function_Hamdist_Many, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_hamdist_many },
+    { "hash_many", GMPy_Function_Hash_Many, METH_O, GMPy_doc_function_hash_many },
+    { "ilog", GMPy_MPZ_Function_ILog, METH_VARARGS, GMPy_doc_mpz_function_ilog },
     { "invert", GMPy_MPZ_Function_Invert, METH_VARARGS, GMPy_doc_mpz_function_invert },
+    { "invert_many", GMPy_MPZ_Function_Invert_Many, METH_VARARGS, GMPy_doc_mpz_function_invert_many },
     { "iroot", GMPy_MPZ_Function_Iroot, METH_VARARGS, GMPy_doc_mpz_function_iroot },
+    { "iroot_list", GMPy_MPZ_Function_IrootList, METH_VARARGS, GMPy_doc_mpz_function_iroot_list },
     { "iroot_rem", GMPy_MPZ_Function_IrootRem, METH_VARARGS, GMPy_doc_mpz_function_iroot_rem },
-    { "isqrt", GMPy_MPZ_Function_Isqrt, METH_O, GMPy_doc_mpz_function_isqrt },
+    { "isum", GMPy_Context_Isum, METH_O, GMPy_doc_function_isum },
+    { "isqrt", (PyCFunction)GMPy_MPZ_Function_Isqrt, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_mpz_function_isqrt },
+    { "isqrt_list", GMPy_MPZ_Function_IsqrtList, METH_O, GMPy_doc_mpz_function_isqrt_list },
     { "isqrt_rem", GMPy_MPZ_Function_IsqrtRem, METH_O, GMPy_doc_mpz_function_isqrt_rem },
     { "is_bpsw_prp", GMPY_mpz_is_bpsw_prp, METH_VARARGS, doc_mpz_is_bpsw_prp },
+    { "is_bpsw_prp_list", GMPy_MPZ_Function_IsBPSWPrpList, METH_O, GMPy_doc_mpz_function_is_bpsw_prp_list },
     { "is_congruent", GMPy_MPZ_Function_IsCongruent, METH_VARARGS, GMPy_doc_mpz_function_is_congruent },
     { "is_divisible", GMPy_MPZ_Function_IsDivisible, METH_VARARGS, GMPy_doc_mpz_function_is_divisible },
     { "is_even", GMPy_MPZ_Function_IsEven, METH_O, GMPy_doc_mpz_function_is_even },
@@ -746,60 +1046,110 @@ static PyMethodDef Pygmpy_methods [] =
     { "is_extra_strong_lucas_prp", GMPY_mpz_is_extrastronglucas_prp, METH_VARARGS, doc_mpz_is_extrastronglucas_prp },
     { "is_fermat_prp", GMPY_mpz_is_fermat_prp, METH_VARARGS, doc_mpz_is_fermat_prp },
     { "is_fibonacci_prp", GMPY_mpz_is_fibonacci_prp, METH_VARARGS, doc_mpz_is_fibonacci_prp },
+    { "is_llr_prime", (PyCFunction)GMPy_MPZ_Function_IsLLRPrime, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_is_llr_prime },
     { "is_lucas_prp", GMPY_mpz_is_lucas_prp, METH_VARARGS, doc_mpz_is_lucas_prp },
+    { "is_mersenne_prime", (PyCFunction)GMPy_MPZ_Function_IsMersennePrime, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_is_mersenne_prime },
     { "is_odd", GMPy_MPZ_Function_IsOdd, METH_O, GMPy_doc_mpz_function_is_odd },
     { "is_power", GMPy_MPZ_Function_IsPower, METH_O, GMPy_doc_mpz_function_is_power },
+    { "is_power_list", GMPy_MPZ_Function_IsPowerList, METH_O, GMPy_doc_mpz_function_is_power_list },
     { "is_prime", GMPy_MPZ_Function_IsPrime, METH_VARARGS, GMPy_doc_mpz_function_is_prime },
+    { "is_prime_list", GMPy_MPZ_Function_IsPrimeList, METH_VARARGS, GMPy_doc_mpz_function_is_prime_list },
     { "is_probab_prime", (PyCFunction)GMPy_MPZ_Function_IsProbabPrime, METH_FASTCALL, GMPy_doc_mpz_function_is_probab_prime },
+    { "is_proth_prime", (PyCFunction)GMPy_MPZ_Function_IsProthPrime, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_is_proth_prime },
     { "is_selfridge_prp", GMPY_mpz_is_selfridge_prp, METH_VARARGS, doc_mpz_is_selfridge_prp },
     { "is_square", GMPy_MPZ_Function_IsSquare, METH_O, GMPy_doc_mpz_function_is_square },
+    { "is_square_list", GMPy_MPZ_Function_IsSquareList, METH_O, GMPy_doc_mpz_function_is_square_list },
     { "is_strong_prp", GMPY_mpz_is_strong_prp, METH_VARARGS, doc_mpz_is_strong_prp },
     { "is_strong_bpsw_prp", GMPY_mpz_is_strongbpsw_prp, METH_VARARGS, doc_mpz_is_strongbpsw_prp },
     { "is_strong_lucas_prp", GMPY_mpz_is_stronglucas_prp, METH_VARARGS, doc_mpz_is_stronglucas_prp },
     { "is_strong_selfridge_prp", GMPY_mpz_is_strongselfridge_prp, METH_VARARGS, doc_mpz_is_strongselfridge_prp },
     { "jacobi", GMPy_MPZ_Function_Jacobi, METH_VARARGS, GMPy_doc_mpz_function_jacobi },
+    { "jacobi_list", GMPy_MPZ_Function_Jacobi_List, METH_VARARGS, GMPy_doc_mpz_function_jacobi_list },
     { "kronecker", GMPy_MPZ_Function_Kronecker, METH_VARARGS, GMPy_doc_mpz_function_kronecker },
-    { "lcm", (PyCFunction)GMPy_MPZ_Function_LCM, METH_FASTCALL, GMPy_doc_mpz_function_lcm },
+    { "kronecker_list", GMPy_MPZ_Function_Kronecker_List, METH_VARARGS, GMPy_doc_mpz_function_kronecker_list },
+    { "lcm", (PyCFunction)GMPy_MPZ_Function_LCM, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_mpz_function_lcm },
     { "legendre", GMPy_MPZ_Function_Legendre, METH_VARARGS, GMPy_doc_mpz_function_legendre },
+    { "legendre_list", GMPy_MPZ_Function_Legendre_List, METH_VARARGS, GMPy_doc_mpz_function_legendre_list },
     { "license", GMPy_get_license, METH_NOARGS, GMPy_doc_license },
+    { "limit_denominator", GMPy_MPQ_Function_Limit_Denominator, METH_VARARGS, GMPy_doc_function_limit_denominator },
+    { "lll", (PyCFunction)GMPy_Context_LLL, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_lll },
+    { "load_mpz_array", (PyCFunction)GMPy_MPZ_Array_Load, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_array_load },
     { "lucas", GMPy_MPZ_Function_Lucas, METH_O, GMPy_doc_mpz_function_lucas },
+    { "lucas_mod", GMPY_mpz_lucas_mod, METH_VARARGS, doc_mpz_lucas_mod },
     { "lucasu", GMPY_mpz_lucasu, METH_VARARGS, doc_mpz_lucasu },
     { "lucasu_mod", GMPY_mpz_lucasu_mod, METH_VARARGS, doc_mpz_lucasu_mod },
+    { "lucasu_mod_list", GMPY_mpz_lucasu_mod_list, METH_VARARGS, doc_mpz_lucasu_mod_list },
     { "lucasv", GMPY_mpz_lucasv, METH_VARARGS, doc_mpz_lucasv },
     { "lucasv_mod", GMPY_mpz_lucasv_mod, METH_VARARGS, doc_mpz_lucasv_mod },
+    { "lucasv_mod_list", GMPY_mpz_lucasv_mod_list, METH_VARARGS, doc_mpz_lucasv_mod_list },
     { "lucas2", GMPy_MPZ_Function_Lucas2, METH_O, GMPy_doc_mpz_function_lucas2 },
+    { "matmul", GMPy_Context_Matmul, METH_VARARGS, GMPy_doc_function_matmul },
+    { "memory_info", (PyCFunction)GMPy_Memory_Info, METH_VARARGS | METH_KEYWORDS, GMPy_doc_memory_info },
     { "mod", GMPy_Context_Mod, METH_VARARGS, GMPy_doc_mod },
     { "mp_version", GMPy_get_mp_version, METH_NOARGS, GMPy_doc_mp_version },
     { "mp_limbsize", GMPy_get_mp_limbsize, METH_NOARGS, GMPy_doc_mp_limbsize },
     { "mpc_version", GMPy_get_mpc_version, METH_NOARGS, GMPy_doc_mpc_version },
     { "mpfr_version", GMPy_get_mpfr_version, METH_NOARGS, GMPy_doc_mpfr_version },
     { "mpq_from_old_binary", GMPy_MPQ_From_Old_Binary, METH_O, doc_mpq_from_old_binary },
+    { "mpq_list", GMPy_MPQ_Function_MPQ_List, METH_O, GMPy_doc_mpq_function_mpq_list },
+    { "mpq_many", (PyCFunction)GMPy_MPQ_Function_Many, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_mpq_many },
     { "mpz_from_old_binary", GMPy_MPZ_From_Old_Binary, METH_O, doc_mpz_from_old_binary },
-    { "mpz_random", GMPy_MPZ_random_Function, METH_VARARGS, GMPy_doc_mpz_random_function },
-    { "mpz_rrandomb", GMPy_MPZ_rrandomb_Function, METH_VARARGS, GMPy_doc_mpz_rrandomb_function },
-    { "mpz_urandomb", GMPy_MPZ_urandomb_Function, METH_VARARGS, GMPy_doc_mpz_urandomb_function },
-    { "mul", GMPy_Context_Mul, METH_VARARGS, GMPy_doc_function_mul },
+    { "mpz_from_strings", (PyCFunction)GMPy_MPZ_Function_From_Strings, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_from_strings },
+    { "mpz_random", (PyCFunction)GMPy_MPZ_random_Function, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_random_function },
+    { "mpz_rrandomb", (PyCFunction)GMPy_MPZ_rrandomb_Function, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_rrandomb_function },
+    { "mpz_urandomb", (PyCFunction)GMPy_MPZ_urandomb_Function, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_urandomb_function },
+    { "mul", (PyCFunction)GMPy_Context_Mul, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_function_mul },
     { "multi_fac", GMPy_MPZ_Function_MultiFac, METH_VARARGS, GMPy_doc_mpz_function_multi_fac },
     { "next_prime", GMPy_MPZ_Function_NextPrime, METH_O, GMPy_doc_mpz_function_next_prime },
+    { "nth_prime", GMPy_MPZ_Function_NthPrime, METH_O, GMPy_doc_mpz_function_nth_prime },
 #if (__GNU_MP_VERSION > 6) || (__GNU_MP_VERSION == 6 &&  __GNU_MP_VERSION_MINOR >= 3)
     { "prev_prime", GMPy_MPZ_Function_PrevPrime, METH_O, GMPy_doc_mpz_function_prev_prime },
 #endif
     { "numer", GMPy_MPQ_Function_Numer, METH_O, GMPy_doc_mpq_function_numer },
-    { "num_digits", GMPy_MPZ_Function_NumDigits, METH_VARARGS, GMPy_doc_mpz_function_num_digits },
+    { "num_digits", (PyCFunction)GMPy_MPZ_Function_NumDigits, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_num_digits },
     { "pack", GMPy_MPZ_pack, METH_VARARGS, doc_pack },
+    { "pack_buffer", GMPy_MPZ_pack_buffer, METH_VARARGS, doc_pack_buffer },
+    { "poly_mul", GMPy_MPZ_poly_mul, METH_VARARGS, doc_poly_mul },
     { "popcount", GMPy_MPZ_popcount, METH_O, doc_popcount },
-    { "powmod", GMPy_Integer_PowMod, METH_VARARGS, GMPy_doc_integer_powmod },
+    { "popcount_many", (PyCFunction)GMPy_MPZ_Function_Popcount_Many, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_popcount_many },
+    { "powmod", (PyCFunction)GMPy_Integer_PowMod, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_integer_powmod },
     { "powmod_base_list", GMPy_Integer_PowMod_Base_List, METH_VARARGS, GMPy_doc_integer_powmod_base_list },
     { "powmod_exp_list", GMPy_Integer_PowMod_Exp_List, METH_VARARGS, GMPy_doc_integer_powmod_exp_list },
+    { "powmod_multi", GMPy_Integer_PowMod_Multi, METH_VARARGS, GMPy_doc_integer_powmod_multi },
     { "powmod_sec", GMPy_Integer_PowMod_Sec, METH_VARARGS, GMPy_doc_integer_powmod_sec },
+    { "prod", GMPy_Context_Prod, METH_O, GMPy_doc_function_prod },
+    { "primerange", GMPy_MPZ_Function_PrimeRange, METH_VARARGS, GMPy_doc_mpz_function_primerange },
+    { "prime_pi", GMPy_MPZ_Function_PrimePi, METH_O, GMPy_doc_mpz_function_prime_pi },
     { "primorial", GMPy_MPZ_Function_Primorial, METH_O, GMPy_doc_mpz_function_primorial },
     { "qdiv", GMPy_MPQ_Function_Qdiv, METH_VARARGS, GMPy_doc_function_qdiv },
+    { "radix_cache_info", GMPy_Radix_Cache_Info, METH_NOARGS, GMPy_doc_radix_cache_info },
+    { "rational_reconstruct", (PyCFunction)(void(*)(void))GMPy_MPZ_Function_Rational_Reconstruct, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_rational_reconstruct },
+    { "rational_reconstruct_list", (PyCFunction)(void(*)(void))GMPy_MPZ_Function_Rational_Reconstruct_List, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_rational_reconstruct_list },
+    { "remainder_tree", GMPy_MPZ_Function_Remainder_Tree, METH_VARARGS, GMPy_doc_mpz_function_remainder_tree },
     { "remove", GMPy_MPZ_Function_Remove, METH_VARARGS, GMPy_doc_mpz_function_remove },
     { "random_state", GMPy_RandomState_Factory, METH_VARARGS, GMPy_doc_random_state_factory },
+    { "random_prime", (PyCFunction)(void(*)(void))GMPy_MPZ_Function_RandomPrime, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_random_prime },
+    { "set_allocator", GMPy_Set_Allocator, METH_VARARGS, GMPy_doc_set_allocator },
+    { "set_cache", (PyCFunction)GMPy_Set_Cache, METH_VARARGS | METH_KEYWORDS, GMPy_doc_set_cache },
+    { "set_fac_cache", GMPy_Set_Fac_Cache, METH_O, GMPy_doc_set_fac_cache },
+    { "set_num_threads", (PyCFunction)GMPy_Set_Num_Threads, METH_VARARGS | METH_KEYWORDS, GMPy_doc_set_num_threads },
+    { "set_radix_cache", GMPy_Set_Radix_Cache, METH_O, GMPy_doc_set_radix_cache },
+    { "set_trace", (PyCFunction)GMPy_Set_Trace, METH_VARARGS | METH_KEYWORDS, GMPy_doc_set_trace },
     { "sign", GMPy_Context_Sign, METH_O, GMPy_doc_function_sign },
-    { "square", GMPy_Context_Square, METH_O, GMPy_doc_function_square },
-    { "sub", GMPy_Context_Sub, METH_VARARGS, GMPy_doc_sub },
-    { "to_binary", GMPy_MPANY_To_Binary, METH_O, doc_to_binary },
+    { "smooth_part", GMPy_MPZ_Function_Smooth_Part, METH_VARARGS, GMPy_doc_mpz_function_smooth_part },
+    { "solve", GMPy_Context_Solve, METH_VARARGS, GMPy_doc_function_solve },
+    { "sort", (PyCFunction)GMPy_MPZ_Function_Sort, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_sort },
+    { "sqrt_mod", GMPy_MPZ_Function_SqrtMod, METH_VARARGS, GMPy_doc_mpz_function_sqrt_mod },
+    { "sqrt_mod_many", GMPy_MPZ_Function_SqrtMod_Many, METH_VARARGS, GMPy_doc_mpz_function_sqrt_mod_many },
+    { "square", (PyCFunction)GMPy_Context_Square, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_function_square },
+    { "sub", (PyCFunction)GMPy_Context_Sub, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_sub },
+    { "submit", GMPy_Function_Submit, METH_VARARGS, GMPy_doc_function_submit },
+    { "thread_pool_info", GMPy_Thread_Pool_Info, METH_NOARGS, GMPy_doc_thread_pool_info },
+    { "to_array", (PyCFunction)GMPy_Function_To_Array, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_to_array },
+    { "to_binary", (PyCFunction)GMPy_MPANY_To_Binary_Function, METH_VARARGS | METH_KEYWORDS, doc_to_binary },
+    { "to_binary_many", (PyCFunction)GMPy_MPANY_To_Binary_Many, METH_VARARGS | METH_KEYWORDS, doc_to_binary_many },
+    { "trace_info", GMPy_Trace_Info, METH_NOARGS, GMPy_doc_trace_info },
+    { "trial_factor", GMPy_MPZ_Function_Trial_Factor, METH_VARARGS, GMPy_doc_mpz_function_trial_factor },
     { "t_div", GMPy_MPZ_t_div, METH_VARARGS, doc_t_div },
     { "t_div_2exp", GMPy_MPZ_t_div_2exp, METH_VARARGS, doc_t_div_2exp },
     { "t_divmod", GMPy_MPZ_t_divmod, METH_VARARGS, doc_t_divmod },
@@ -807,10 +1157,17 @@ static PyMethodDef Pygmpy_methods [] =
     { "t_mod", GMPy_MPZ_t_mod, METH_VARARGS, doc_t_mod },
     { "t_mod_2exp", GMPy_MPZ_t_mod_2exp, METH_VARARGS, doc_t_mod_2exp },
     { "unpack", GMPy_MPZ_unpack, METH_VARARGS, doc_unpack },
+    { "unpack_buffer", GMPy_MPZ_unpack_buffer, METH_VARARGS, doc_unpack_buffer },
     { "version", GMPy_get_version, METH_NOARGS, GMPy_doc_version },
     { "xbit_mask", GMPy_XMPZ_Function_XbitMask, METH_O, GMPy_doc_xmpz_function_xbit_mask },
     { "_mpmath_normalize", (PyCFunction)(void(*)(void))Pympz_mpmath_normalize_fast, METH_FASTCALL, doc_mpmath_normalizeg },
     { "_mpmath_create", (PyCFunction)(void(*)(void))Pympz_mpmath_create_fast, METH_FASTCALL, doc_mpmath_create },
+    { "_mpmath_add", (PyCFunction)(void(*)(void))Pympz_mpmath_add, METH_FASTCALL, doc_mpmath_add },
+    { "_mpmath_mul", (PyCFunction)(void(*)(void))Pympz_mpmath_mul, METH_FASTCALL, doc_mpmath_mul },
+    { "_mpmath_div", (PyCFunction)(void(*)(void))Pympz_mpmath_div, METH_FASTCALL, doc_mpmath_div },
+    { "_mpmath_sqrt", (PyCFunction)(void(*)(void))Pympz_mpmath_sqrt, METH_FASTCALL, doc_mpmath_sqrt },
+    { "_mpmath_normalize_list", (PyCFunction)(void(*)(void))Pympz_mpmath_normalize_list, METH_FASTCALL, doc_mpmath_normalize_list },
+    { "_register_numbers", GMPy_Register_Numbers, METH_O, GMPy_doc_register_numbers },
 
     { "acos", GMPy_Context_Acos, METH_O, GMPy_doc_function_acos },
     { "acosh", GMPy_Context_Acosh, METH_O, GMPy_doc_function_acosh },
@@ -825,10 +1182,13 @@ static PyMethodDef Pygmpy_methods [] =
     { "cbrt", GMPy_Context_Cbrt, METH_O, GMPy_doc_function_cbrt },
     { "ceil", GMPy_Context_Ceil, METH_O, GMPy_doc_function_ceil },
     { "check_range", GMPy_Context_CheckRange, METH_O, GMPy_doc_function_check_range },
+    { "clear_const_cache", (PyCFunction)GMPy_Clear_Const_Cache, METH_VARARGS | METH_KEYWORDS, GMPy_doc_clear_const_cache },
+    { "const_cache_info", GMPy_Const_Cache_Info, METH_NOARGS, GMPy_doc_const_cache_info },
     { "const_catalan", (PyCFunction)GMPy_Function_Const_Catalan, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_const_catalan },
     { "const_euler", (PyCFunction)GMPy_Function_Const_Euler, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_const_euler },
     { "const_log2", (PyCFunction)GMPy_Function_Const_Log2, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_const_log2 },
     { "const_pi", (PyCFunction)GMPy_Function_Const_Pi, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_const_pi },
+    { "context_template", (PyCFunction)GMPy_CTXT_Template, METH_VARARGS | METH_KEYWORDS, GMPy_doc_context_template },
     { "copy_sign", GMPy_MPFR_copy_sign, METH_VARARGS, GMPy_doc_mpfr_copy_sign },
     { "cos", GMPy_Context_Cos, METH_O, GMPy_doc_function_cos },
     { "cosh", GMPy_Context_Cosh, METH_O, GMPy_doc_function_cosh },
@@ -842,6 +1202,7 @@ static PyMethodDef Pygmpy_methods [] =
     { "eint", GMPy_Context_Eint, METH_O, GMPy_doc_function_eint },
     { "erf", GMPy_Context_Erf, METH_O, GMPy_doc_function_erf },
     { "erfc", GMPy_Context_Erfc, METH_O, GMPy_doc_function_erfc },
+    { "evaluate", (PyCFunction)GMPy_CTXT_Evaluate, METH_VARARGS | METH_KEYWORDS, GMPy_doc_evaluate },
     { "exp", GMPy_Context_Exp, METH_O, GMPy_doc_function_exp },
     { "expm1", GMPy_Context_Expm1, METH_O, GMPy_doc_function_expm1 },
     { "exp10", GMPy_Context_Exp10, METH_O, GMPy_doc_function_exp10 },
@@ -865,6 +1226,7 @@ static PyMethodDef Pygmpy_methods [] =
     { "get_emin_min", GMPy_MPFR_get_emin_min, METH_NOARGS, GMPy_doc_mpfr_get_emin_min },
     { "get_exp", GMPy_MPFR_get_exp, METH_O, GMPy_doc_mpfr_get_exp },
     { "get_max_precision", GMPy_MPFR_get_max_precision, METH_NOARGS, GMPy_doc_mpfr_get_max_precision },
+    { "get_num_threads", GMPy_Get_Num_Threads, METH_NOARGS, GMPy_doc_get_num_threads },
     { "hypot", GMPy_Context_Hypot, METH_VARARGS, GMPy_doc_function_hypot },
     { "ieee", (PyCFunction)GMPy_CTXT_ieee, METH_VARARGS | METH_KEYWORDS, GMPy_doc_context_ieee },
     { "inf", GMPy_MPFR_set_inf, METH_VARARGS, GMPy_doc_mpfr_set_inf },
@@ -892,8 +1254,9 @@ static PyMethodDef Pygmpy_methods [] =
     { "minnum", GMPy_Context_Minnum, METH_VARARGS, GMPy_doc_function_minnum },
     { "modf", GMPy_Context_Modf, METH_O, GMPy_doc_function_modf },
     { "mpfr_from_old_binary", GMPy_MPFR_From_Old_Binary, METH_O, doc_mpfr_from_old_binary },
-    { "mpfr_random", GMPy_MPFR_random_Function, METH_VARARGS, GMPy_doc_mpfr_random_function },
+    { "mpfr_random", (PyCFunction)GMPy_MPFR_random_Function, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpfr_random_function },
     { "mpfr_grandom", GMPy_MPFR_grandom_Function, METH_VARARGS, GMPy_doc_mpfr_grandom_function },
+    { "mpfr_list", (PyCFunction)GMPy_MPFR_Function_MPFR_List, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpfr_function_mpfr_list },
     { "mpfr_nrandom", GMPy_MPFR_nrandom_Function, METH_VARARGS, GMPy_doc_mpfr_nrandom_function },
     { "mul_2exp", GMPy_Context_Mul_2exp, METH_VARARGS, GMPy_doc_function_mul_2exp },
     { "nan", GMPy_MPFR_set_nan, METH_NOARGS, GMPy_doc_mpfr_set_nan },
@@ -916,6 +1279,7 @@ static PyMethodDef Pygmpy_methods [] =
     { "round2", GMPy_Context_Round2, METH_VARARGS, GMPy_doc_function_round2 },
     { "sec", GMPy_Context_Sec, METH_O, GMPy_doc_function_sec },
     { "sech", GMPy_Context_Sech, METH_O, GMPy_doc_function_sech },
+    { "set_const_cache", GMPy_Set_Const_Cache, METH_O, GMPy_doc_set_const_cache },
     { "set_context", GMPy_CTXT_Set, METH_O, GMPy_doc_set_context },
     { "set_exp", GMPy_MPFR_set_exp, METH_VARARGS, GMPy_doc_mpfr_set_exp },
     { "set_sign", GMPy_MPFR_set_sign, METH_VARARGS, GMPy_doc_mpfr_set_sign },
@@ -927,22 +1291,35 @@ static PyMethodDef Pygmpy_methods [] =
     { "tan", GMPy_Context_Tan, METH_O, GMPy_doc_function_tan },
     { "tanh", GMPy_Context_Tanh, METH_O, GMPy_doc_function_tanh },
     { "trunc", GMPy_Context_Trunc, METH_O, GMPy_doc_function_trunc},
+    { "vadd", (PyCFunction)GMPy_Context_VAdd, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_vadd },
+    { "vcmp", (PyCFunction)GMPy_Context_VCmp, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_vcmp },
+    { "vdiv", GMPy_Context_VDiv, METH_VARARGS, GMPy_doc_function_vdiv },
+    { "visqrt", (PyCFunction)GMPy_Context_VIsqrt, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_visqrt },
 #ifdef VECTOR
-    { "vector", GMPy_Context_Vector, METH_O, GMPy_doc_function_vector},
     { "vector2", GMPy_Context_Vector2, METH_VARARGS, GMPy_doc_function_vector2},
 #endif
+    { "vmap", GMPy_Context_Vector, METH_VARARGS, GMPy_doc_function_vmap },
+    { "vmod", (PyCFunction)GMPy_Context_VMod, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_vmod },
+    { "vmul", (PyCFunction)GMPy_Context_VMul, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_vmul },
+    { "vpowmod", (PyCFunction)GMPy_Context_VPowMod, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_vpowmod },
+    { "vsub", (PyCFunction)GMPy_Context_VSub, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_vsub },
     { "yn", GMPy_Context_Yn, METH_VARARGS, GMPy_doc_function_yn },
     { "y0", GMPy_Context_Y0, METH_O, GMPy_doc_function_y0 },
     { "y1", GMPy_Context_Y1, METH_O, GMPy_doc_function_y1 },
     { "zero", GMPy_MPFR_set_zero, METH_VARARGS, GMPy_doc_mpfr_set_zero },
     { "zeta", GMPy_Context_Zeta, METH_O, GMPy_doc_function_zeta },
 
+    { "fft", (PyCFunction)GMPy_Function_FFT, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_fft },
+    { "ifft", (PyCFunction)GMPy_Function_IFFT, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_ifft },
     { "mpc_random", GMPy_MPC_random_Function, METH_VARARGS, GMPy_doc_mpc_random_function },
     { "norm", GMPy_Context_Norm, METH_O, GMPy_doc_function_norm },
     { "polar", GMPy_Context_Polar, METH_O, GMPy_doc_function_polar },
+    { "polyval", GMPy_Context_Polyval, METH_VARARGS, GMPy_doc_function_polyval },
+    { "polyval_many", GMPy_Context_Polyval_Many, METH_VARARGS, GMPy_doc_function_polyval_many },
     { "phase", GMPy_Context_Phase, METH_O, GMPy_doc_function_phase },
     { "proj", GMPy_Context_Proj, METH_O, GMPy_doc_function_proj },
     { "root_of_unity", GMPy_Context_Root_Of_Unity, METH_VARARGS, GMPy_doc_function_root_of_unity },
+    { "roots_of_unity", (PyCFunction)GMPy_Function_Roots_Of_Unity, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_roots_of_unity },
     { "rect", GMPy_Context_Rect, METH_VARARGS, GMPy_doc_function_rect },
     { NULL, NULL, 1}
 };
@@ -973,99 +1350,214 @@ static char _gmpy_docs[] =
 "MPFR and MPC libraries are available.\n\
 ";
 
-/* Notes on Python 3.x support: Full support for PEP-3121 has not been
- * implemented. No per-module state has been defined.
+/* gmpy2 uses multi-phase initialization (PEP 489). The types, caches,
+ * exceptions and the GMP memory functions are shared by the whole process,
+ * so they are set up once by GMPy_Process_Init() and every interpreter that
+ * imports gmpy2 gets a module that refers to them. Interpreters that share
+ * the main GIL are supported; an interpreter with its own GIL (PEP 684)
+ * cannot import gmpy2.
  */
 
-static struct PyModuleDef moduledef = {
-        PyModuleDef_HEAD_INIT,
-        "gmpy2",
-        _gmpy_docs,
-        -1, /*sizeof(struct module_state) */
-        Pygmpy_methods,
-        NULL,
-        NULL, /* gmpy_traverse */
-        NULL, /* gmpy_clear */
-        NULL
-};
+static int gmpy_process_init_done = 0;
 
-PyMODINIT_FUNC PyInit_gmpy2(void)
+static int
+GMPy_Process_Init(void)
 {
-    PyObject *result = NULL;
-    PyObject *namespace = NULL;
-    PyObject *gmpy_module = NULL;
-    PyObject *copy_reg_module = NULL;
     PyObject *temp = NULL;
-    PyObject *numbers_module = NULL;
-    PyObject* xmpz = NULL;
-    PyObject* limb_size = NULL;
-
-
-#ifndef STATIC
-    static void *GMPy_C_API[GMPy_API_pointers];
-    PyObject *c_api_object;
-#endif
 
     /* Validate the sizes of the various typedef'ed integer types. */
 
     if (sizeof(mpfr_prec_t) != sizeof(long)) {
         /* LCOV_EXCL_START */
         SYSTEM_ERROR("Size of mpfr_prec_t and long not compatible");
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
     if (sizeof(mpfr_exp_t) != sizeof(long)) {
         /* LCOV_EXCL_START */
         SYSTEM_ERROR("Size of mpfr_exp_t and long not compatible");
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
     /* Initialize the types. */
     if (PyType_Ready(&MPZ_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&MPQ_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&XMPZ_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&GMPy_Iter_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&MPFR_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&CTXT_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&CTXT_Manager_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&CTXT_Template_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&MPC_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&RandomState_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&Arena_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&AllocGuard_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&MPZ_Array_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&Mapped_MPZ_Array_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&MPZ_View_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&MPFR_Array_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&MPC_Array_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&FixedBase_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&Modulus_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&SecModulus_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&EC_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&Divisor_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&CRTPlan_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&RNS_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&RNSInt_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+#ifdef GMPY_MONT_INT128
+    if (PyType_Ready(&NmodPoly_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+#endif
+    if (PyType_Ready(&Accumulator_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&MPFR_Accumulator_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&Expr_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyType_Ready(&PrimeIter_Type) < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (GMPy_Alloc_Init() < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (GMPy_Trace_Init() < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (GMPy_MPZ_Small_Init() < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+
+    GMPy_Hash_Init();
+
+    if (GMPy_Pool_Init() < 0) {
+        /* LCOV_EXCL_START */
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
@@ -1073,75 +1565,94 @@ PyMODINIT_FUNC PyInit_gmpy2(void)
     GMPyExc_GmpyError = PyErr_NewException("gmpy2.gmpy2Error", PyExc_ArithmeticError, NULL);
     if (!GMPyExc_GmpyError) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
     GMPyExc_Erange = PyErr_NewException("gmpy2.RangeError", GMPyExc_GmpyError, NULL);
     if (!GMPyExc_Erange) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
     GMPyExc_Inexact = PyErr_NewException("gmpy2.InexactResultError", GMPyExc_GmpyError, NULL);
     if (!GMPyExc_Inexact) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
     GMPyExc_Overflow = PyErr_NewException("gmpy2.OverflowResultError", GMPyExc_Inexact, NULL);
     if (!GMPyExc_Overflow) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
     GMPyExc_Underflow = PyErr_NewException("gmpy2.UnderflowResultError", GMPyExc_Inexact, NULL);
     if (!GMPyExc_Underflow) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
     temp = PyTuple_Pack(2, GMPyExc_GmpyError, PyExc_ValueError);
     if (!temp) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     GMPyExc_Invalid = PyErr_NewException("gmpy2.InvalidOperationError", temp, NULL);
     Py_DECREF(temp);
     if (!GMPyExc_Invalid) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
     temp = PyTuple_Pack(2, GMPyExc_GmpyError, PyExc_ZeroDivisionError);
     if (!temp) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     GMPyExc_DivZero = PyErr_NewException("gmpy2.DivisionByZeroError", temp, NULL);
     Py_DECREF(temp);
     if (!GMPyExc_DivZero) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
+    /* Initialize context var. */
+    if (!(current_context_var = PyContextVar_New("gmpy2_context", NULL))) {
+        return -1;
+    }
+    if (!(context_stack_var = PyContextVar_New("gmpy2_context_stack", NULL))) {
+        return -1;
+    }
 
-    gmpy_module = PyModule_Create(&moduledef);
+    gmpy_process_init_done = 1;
+    return 0;
+}
 
-    if (gmpy_module == NULL) {
-        /* LCOV_EXCL_START */
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
+static int
+GMPy_Module_Exec(PyObject *gmpy_module)
+{
+    PyObject *result = NULL;
+    PyObject *numbers_module = NULL;
+    PyObject* xmpz = NULL;
+    PyObject* limb_size = NULL;
+
+#ifndef STATIC
+    static void *GMPy_C_API[GMPy_API_pointers];
+    PyObject *c_api_object;
+#endif
 
+    if (!gmpy_process_init_done && GMPy_Process_Init() < 0) {
+        return -1;
+    }
 
     /* Add the context type to the module namespace. */
 
@@ -1163,6 +1674,87 @@ PyMODINIT_FUNC PyInit_gmpy2(void)
     PyDict_SetItemString(xmpz, "limb_size", limb_size);
     Py_DECREF(limb_size);
 
+    /* Add the mpz_array type to the module namespace. */
+
+    Py_INCREF(&MPZ_Array_Type);
+    PyModule_AddObject(gmpy_module, "mpz_array", (PyObject*)&MPZ_Array_Type);
+
+    /* Add the mpz_view type to the module namespace. */
+
+    Py_INCREF(&MPZ_View_Type);
+    PyModule_AddObject(gmpy_module, "mpz_view", (PyObject*)&MPZ_View_Type);
+
+    /* Add the mpfr_array and mpc_array types to the module namespace. */
+
+    Py_INCREF(&MPFR_Array_Type);
+    PyModule_AddObject(gmpy_module, "mpfr_array", (PyObject*)&MPFR_Array_Type);
+    Py_INCREF(&MPC_Array_Type);
+    PyModule_AddObject(gmpy_module, "mpc_array", (PyObject*)&MPC_Array_Type);
+
+    /* Add the FixedBasePowMod type to the module namespace. */
+
+    Py_INCREF(&FixedBase_Type);
+    PyModule_AddObject(gmpy_module, "FixedBasePowMod", (PyObject*)&FixedBase_Type);
+
+    /* Add the Modulus type to the module namespace. */
+
+    Py_INCREF(&Modulus_Type);
+    PyModule_AddObject(gmpy_module, "Modulus", (PyObject*)&Modulus_Type);
+
+    /* The side channel resistant Modulus is exported by gmpy2.sec. */
+
+    Py_INCREF(&SecModulus_Type);
+    PyModule_AddObject(gmpy_module, "_sec_modulus", (PyObject*)&SecModulus_Type);
+
+    /* The elliptic curve type is exported by gmpy2.ec. */
+
+    Py_INCREF(&EC_Type);
+    PyModule_AddObject(gmpy_module, "_ec_curve", (PyObject*)&EC_Type);
+
+    /* Add the Divisor type to the module namespace. */
+
+    Py_INCREF(&Divisor_Type);
+    PyModule_AddObject(gmpy_module, "Divisor", (PyObject*)&Divisor_Type);
+
+    /* Add the CRTPlan type to the module namespace. */
+
+    Py_INCREF(&CRTPlan_Type);
+    PyModule_AddObject(gmpy_module, "CRTPlan", (PyObject*)&CRTPlan_Type);
+
+    /* Add the RNS and rns types to the module namespace. */
+
+    Py_INCREF(&RNS_Type);
+    PyModule_AddObject(gmpy_module, "RNS", (PyObject*)&RNS_Type);
+    Py_INCREF(&RNSInt_Type);
+    PyModule_AddObject(gmpy_module, "rns", (PyObject*)&RNSInt_Type);
+
+#ifdef GMPY_MONT_INT128
+    /* Add the nmod_poly type to the module namespace. */
+
+    Py_INCREF(&NmodPoly_Type);
+    PyModule_AddObject(gmpy_module, "nmod_poly", (PyObject*)&NmodPoly_Type);
+#endif
+
+    /* Add the RationalAccumulator type to the module namespace. */
+
+    Py_INCREF(&Accumulator_Type);
+    PyModule_AddObject(gmpy_module, "RationalAccumulator", (PyObject*)&Accumulator_Type);
+
+    /* Add the mpfr_accumulator type to the module namespace. */
+
+    Py_INCREF(&MPFR_Accumulator_Type);
+    PyModule_AddObject(gmpy_module, "mpfr_accumulator", (PyObject*)&MPFR_Accumulator_Type);
+
+    /* Add the expr type to the module namespace. */
+
+    Py_INCREF(&Expr_Type);
+    PyModule_AddObject(gmpy_module, "expr", (PyObject*)&Expr_Type);
+
+    /* Add the iter_primes type to the module namespace. */
+
+    Py_INCREF(&PrimeIter_Type);
+    PyModule_AddObject(gmpy_module, "iter_primes", (PyObject*)&PrimeIter_Type);
+
     /* Add the MPQ type to the module namespace. */
 
     Py_INCREF(&MPQ_Type);
@@ -1178,40 +1770,35 @@ PyMODINIT_FUNC PyInit_gmpy2(void)
     Py_INCREF(&MPC_Type);
     PyModule_AddObject(gmpy_module, "mpc", (PyObject*)&MPC_Type);
 
-    /* Initialize context var. */
-    if (!(current_context_var = PyContextVar_New("gmpy2_context", NULL))) {
-        return NULL;
-    }
-
     /* Add the constants for defining rounding modes. */
     if (PyModule_AddIntConstant(gmpy_module, "RoundToNearest", MPFR_RNDN) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyModule_AddIntConstant(gmpy_module, "RoundToZero", MPFR_RNDZ) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyModule_AddIntConstant(gmpy_module, "RoundUp", MPFR_RNDU) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyModule_AddIntConstant(gmpy_module, "RoundDown", MPFR_RNDD) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyModule_AddIntConstant(gmpy_module, "RoundAwayZero", MPFR_RNDA) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyModule_AddIntConstant(gmpy_module, "Default", GMPY_DEFAULT) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
@@ -1220,42 +1807,42 @@ PyMODINIT_FUNC PyInit_gmpy2(void)
     if (PyModule_AddObject(gmpy_module, "DivisionByZeroError", GMPyExc_DivZero) < 0) {
         /* LCOV_EXCL_START */
         Py_DECREF(GMPyExc_DivZero);
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     Py_INCREF(GMPyExc_Inexact);
     if (PyModule_AddObject(gmpy_module, "InexactResultError", GMPyExc_Inexact) < 0) {
         /* LCOV_EXCL_START */
         Py_DECREF(GMPyExc_Inexact);
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     Py_INCREF(GMPyExc_Invalid);
     if (PyModule_AddObject(gmpy_module, "InvalidOperationError", GMPyExc_Invalid) < 0 ) {
         /* LCOV_EXCL_START */
         Py_DECREF(GMPyExc_Invalid);
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     Py_INCREF(GMPyExc_Overflow);
     if (PyModule_AddObject(gmpy_module, "OverflowResultError", GMPyExc_Overflow) < 0) {
         /* LCOV_EXCL_START */
         Py_DECREF(GMPyExc_Overflow);
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     Py_INCREF(GMPyExc_Underflow);
     if (PyModule_AddObject(gmpy_module, "UnderflowResultError", GMPyExc_Underflow) < 0) {
         /* LCOV_EXCL_START */
         Py_DECREF(GMPyExc_Underflow);
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     Py_INCREF(GMPyExc_Erange);
     if (PyModule_AddObject(gmpy_module, "RangeError", GMPyExc_Erange) < 0) {
         /* LCOV_EXCL_START */
         Py_DECREF(GMPyExc_Erange);
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
@@ -1298,77 +1885,99 @@ PyMODINIT_FUNC PyInit_gmpy2(void)
     GMPy_C_API[GMPy_MPC_Dealloc_NUM] = (void*)GMPy_MPC_Dealloc;
     GMPy_C_API[GMPy_MPC_ConvertArg_NUM] = (void*)GMPy_MPC_ConvertArg;
 
+    GMPy_C_API[GMPy_MPZ_NewSize_NUM] = (void*)GMPy_MPZ_NewSize;
+    GMPy_C_API[GMPy_MPZ_From_PyLong_NUM] = (void*)GMPy_MPZ_From_PyLong;
+    GMPy_C_API[GMPy_PyLong_From_MPZ_NUM] = (void*)GMPy_PyLong_From_MPZ;
+    GMPy_C_API[mpz_set_PyLong_NUM] = (void*)mpz_set_PyLong;
+
+    GMPy_C_API[GMPy_Scratch_Mark_NUM] = (void*)GMPy_CAPI_Scratch_Mark;
+    GMPy_C_API[GMPy_Scratch_Get_NUM] = (void*)_GMPy_Scratch_Get;
+    GMPy_C_API[GMPy_Scratch_Release_NUM] = (void*)_GMPy_Scratch_Release;
+
+    GMPy_C_API[GMPy_Add_NUM] = (void*)GMPy_Add;
+    GMPy_C_API[GMPy_Sub_NUM] = (void*)GMPy_Sub;
+    GMPy_C_API[GMPy_Mul_NUM] = (void*)GMPy_Mul;
+    GMPy_C_API[GMPy_PowMod_NUM] = (void*)GMPy_PowMod;
+    GMPy_C_API[GMPy_IsPrime_NUM] = (void*)GMPy_IsPrime;
+
+    GMPy_C_API[GMPy_Isum_NUM] = (void*)GMPy_Isum;
+    GMPy_C_API[GMPy_Prod_NUM] = (void*)GMPy_Prod;
+    GMPy_C_API[GMPy_Dot_NUM] = (void*)GMPy_Dot;
+    GMPy_C_API[GMPy_PowMod_Base_List_NUM] = (void*)GMPy_PowMod_Base_List;
+    GMPy_C_API[GMPy_PowMod_Exp_List_NUM] = (void*)GMPy_PowMod_Exp_List;
+
     c_api_object = PyCapsule_New((void *)GMPy_C_API, "gmpy2._C_API", NULL);
 
     if (c_api_object != NULL) {
+        PyCapsule_SetContext(c_api_object, (void*)(Py_intptr_t)GMPy_API_VERSION);
         PyModule_AddObject(gmpy_module, "_C_API", c_api_object);
     }
 #endif
 
-    /* Add support for pickling. */
-    copy_reg_module = PyImport_ImportModule("copyreg");
-    if (copy_reg_module) {
-        char* enable_pickle =
-            "def gmpy2_reducer(x): return (gmpy2.from_binary, (gmpy2.to_binary(x),))\n"
-            "copyreg.pickle(gmpy2.mpz, gmpy2_reducer)\n"
-            "copyreg.pickle(gmpy2.xmpz, gmpy2_reducer)\n"
-            "copyreg.pickle(gmpy2.mpq, gmpy2_reducer)\n"
-            "copyreg.pickle(gmpy2.mpfr, gmpy2_reducer)\n"
-            "copyreg.pickle(gmpy2.mpc, gmpy2_reducer)\n";
-
-        namespace = PyDict_New();
-        result = NULL;
-
-        PyDict_SetItemString(namespace, "copyreg", copy_reg_module);
-        PyDict_SetItemString(namespace, "gmpy2", gmpy_module);
-        result = PyRun_String(enable_pickle, Py_file_input, namespace, namespace);
-        if (!result) {
+    /* Objects are unpickled by gmpy2.from_binary(). The function of the
+     * first interpreter that imports gmpy2 is returned by the __reduce__
+     * methods, so the modules of later interpreters refer to it as well.
+     */
+    if (!global.from_binary) {
+        if (!(global.from_binary = PyObject_GetAttrString(gmpy_module, "from_binary"))) {
             /* LCOV_EXCL_START */
-            PyErr_Clear();
+            return -1;
             /* LCOV_EXCL_STOP */
         }
-        Py_DECREF(namespace);
-        Py_DECREF(copy_reg_module);
-        Py_XDECREF(result);
     }
     else {
-        /* LCOV_EXCL_START */
-        PyErr_Clear();
-        /* LCOV_EXCL_STOP */
+        Py_INCREF(global.from_binary);
+        if (PyModule_AddObject(gmpy_module, "from_binary", global.from_binary) < 0) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(global.from_binary);
+            return -1;
+            /* LCOV_EXCL_STOP */
+        }
     }
 
-    /* Register the gmpy2 types with the numeric tower. */
+    /* Register the gmpy2 types with the numeric tower. Importing numbers
+     * is a large part of the import time of gmpy2, so if it has not been
+     * imported yet, the registration is left to gmpy2/__init__.py, which
+     * does it when numbers is first imported.
+     */
 
-    numbers_module = PyImport_ImportModule("numbers");
+    numbers_module = PyDict_GetItemString(PyImport_GetModuleDict(), "numbers");
     if (numbers_module) {
-        char* register_numbers =
-            "numbers.Integral.register(gmpy2.mpz)\n"
-            "numbers.Rational.register(gmpy2.mpq)\n"
-            "numbers.Real.register(gmpy2.mpfr)\n"
-            "numbers.Complex.register(gmpy2.mpc)\n"
-        ;
-        namespace = PyDict_New();
-        result = NULL;
-
-        PyDict_SetItemString(namespace, "numbers", numbers_module);
-        PyDict_SetItemString(namespace, "gmpy2", gmpy_module);
-        result = PyRun_String(register_numbers, Py_file_input,
-                              namespace, namespace);
-        if (!result) {
+        if (!(result = GMPy_Register_Numbers(NULL, numbers_module))) {
             /* LCOV_EXCL_START */
-            PyErr_Clear();
+            return -1;
             /* LCOV_EXCL_STOP */
         }
-
-        Py_DECREF(namespace);
-        Py_DECREF(numbers_module);
-        Py_XDECREF(result);
-    }
-    else {
-        /* LCOV_EXCL_START */
-        PyErr_Clear();
-        /* LCOV_EXCL_STOP */
+        Py_DECREF(result);
     }
 
-    return gmpy_module;
+    return 0;
+}
+
+static PyModuleDef_Slot gmpy_slots[] = {
+    {Py_mod_exec, (void*)GMPy_Module_Exec},
+#if PY_VERSION_HEX >= 0x030C0000
+    {Py_mod_multiple_interpreters, Py_MOD_MULTIPLE_INTERPRETERS_SUPPORTED},
+#endif
+#ifdef Py_GIL_DISABLED
+    {Py_mod_gil, Py_MOD_GIL_NOT_USED},
+#endif
+    {0, NULL}
+};
+
+static struct PyModuleDef moduledef = {
+        PyModuleDef_HEAD_INIT,
+        "gmpy2",
+        _gmpy_docs,
+        0,
+        Pygmpy_methods,
+        gmpy_slots,
+        NULL,
+        NULL,
+        NULL
+};
+
+PyMODINIT_FUNC PyInit_gmpy2(void)
+{
+    return PyModuleDef_Init(&moduledef);
 }
@@ -133,6 +133,11 @@ typedef struct {
 typedef struct {
     PyObject_HEAD
     mpz_t z;
+    Py_ssize_t exports;     /* number of buffers exporting the limbs */
+    MPZ_Object *owner;      /* mpz whose limbs z reads until it changes */
+#ifdef Py_GIL_DISABLED
+    PyMutex mutex;          /* held while the value is changed */
+#endif
 } XMPZ_Object;
 
 typedef struct {
@@ -158,6 +163,9 @@ typedef struct {
 typedef struct {
     PyObject_HEAD
     gmp_randstate_t state;
+    mpz_t entropy;           /* seed that spawn() derives child seeds from */
+    PyObject *spawn_key;     /* tuple of child indices from the root state */
+    unsigned long children;  /* number of states spawned so far */
 } RandomState_Object;
 
 typedef struct {
@@ -181,11 +189,21 @@ typedef struct {
     int allow_complex;       /* if 1, allow mpfr functions to return an mpc */
     int rational_division;   /* if 1, mpz/mpz returns an mpq result */
     int allow_release_gil;   /* if 1, allow mpz functions to release the GIL */
+    long release_gil_min_bits; /* only release the GIL for larger operands */
+    int threads;             /* threads used by the list functions */
+    long mul_threads_min_bits; /* split larger products over the threads */
+    int profile;             /* if 1, collect statistics in CTXT_Object */
+    int fast_float;          /* if 1, use C doubles for 53 and 24 bit mpfr */
+    int track_flags;         /* if 0, flags are only set if a trap is enabled */
+    double max_time;         /* seconds allowed for one computation, 0 for no limit */
+    double deadline;         /* time.monotonic() value to stop at, 0 for none */
 } gmpy_context;
 
 typedef struct {
     PyObject_HEAD
     gmpy_context ctx;
+    struct gmpy_profile *profile; /* allocated when first needed */
+    int frozen;                   /* if 1, settings are read-only */
 } CTXT_Object;
 
 typedef struct {
@@ -309,9 +327,92 @@ typedef struct {
 #define GMPy_MPC_ConvertArg_RETURN  int
 #define GMPy_MPC_ConvertArg_PROTO   (PyObject *arg, PyObject **ptr)
 
+/* The following functions are found in gmpy2_cache, gmpy2_convert_gmp
+ * and gmpy2_scratch. They were added in version 2 of the C-API.
+ */
+
+#define GMPy_MPZ_NewSize_NUM        30
+#define GMPy_MPZ_NewSize_RETURN     MPZ_Object *
+#define GMPy_MPZ_NewSize_PROTO      (mp_size_t size, CTXT_Object *context)
+
+#define GMPy_MPZ_From_PyLong_NUM    31
+#define GMPy_MPZ_From_PyLong_RETURN MPZ_Object *
+#define GMPy_MPZ_From_PyLong_PROTO  (PyObject *obj, CTXT_Object *context)
+
+#define GMPy_PyLong_From_MPZ_NUM    32
+#define GMPy_PyLong_From_MPZ_RETURN PyObject *
+#define GMPy_PyLong_From_MPZ_PROTO  (MPZ_Object *obj, CTXT_Object *context)
+
+#define mpz_set_PyLong_NUM          33
+#define mpz_set_PyLong_RETURN       void
+#define mpz_set_PyLong_PROTO        (mpz_t z, PyObject *obj)
+
+#define GMPy_Scratch_Mark_NUM       34
+#define GMPy_Scratch_Mark_RETURN    int
+#define GMPy_Scratch_Mark_PROTO     (void)
+
+#define GMPy_Scratch_Get_NUM        35
+#define GMPy_Scratch_Get_RETURN     mpz_ptr
+#define GMPy_Scratch_Get_PROTO      (size_t bits)
+
+#define GMPy_Scratch_Release_NUM    36
+#define GMPy_Scratch_Release_RETURN void
+#define GMPy_Scratch_Release_PROTO  (int mark)
+
+/* The following functions are found in gmpy2_capi. They were added in
+ * version 2 of the C-API.
+ */
+
+#define GMPy_Add_NUM                37
+#define GMPy_Add_RETURN             PyObject *
+#define GMPy_Add_PROTO              (PyObject *x, PyObject *y, CTXT_Object *context)
+
+#define GMPy_Sub_NUM                38
+#define GMPy_Sub_RETURN             PyObject *
+#define GMPy_Sub_PROTO              (PyObject *x, PyObject *y, CTXT_Object *context)
+
+#define GMPy_Mul_NUM                39
+#define GMPy_Mul_RETURN             PyObject *
+#define GMPy_Mul_PROTO              (PyObject *x, PyObject *y, CTXT_Object *context)
+
+#define GMPy_PowMod_NUM             40
+#define GMPy_PowMod_RETURN          PyObject *
+#define GMPy_PowMod_PROTO           (PyObject *x, PyObject *y, PyObject *m, CTXT_Object *context)
+
+#define GMPy_IsPrime_NUM            41
+#define GMPy_IsPrime_RETURN         int
+#define GMPy_IsPrime_PROTO          (PyObject *x, unsigned long reps, CTXT_Object *context)
+
+#define GMPy_Isum_NUM               42
+#define GMPy_Isum_RETURN            PyObject *
+#define GMPy_Isum_PROTO             (PyObject *seq, CTXT_Object *context)
+
+#define GMPy_Prod_NUM               43
+#define GMPy_Prod_RETURN            PyObject *
+#define GMPy_Prod_PROTO             (PyObject *seq, CTXT_Object *context)
+
+#define GMPy_Dot_NUM                44
+#define GMPy_Dot_RETURN             PyObject *
+#define GMPy_Dot_PROTO              (PyObject *x, PyObject *y, CTXT_Object *context)
+
+#define GMPy_PowMod_Base_List_NUM    45
+#define GMPy_PowMod_Base_List_RETURN PyObject *
+#define GMPy_PowMod_Base_List_PROTO  (PyObject *bases, PyObject *y, PyObject *m)
+
+#define GMPy_PowMod_Exp_List_NUM     46
+#define GMPy_PowMod_Exp_List_RETURN  PyObject *
+#define GMPy_PowMod_Exp_List_PROTO   (PyObject *x, PyObject *exps, PyObject *m)
+
 /* Total number of C-API pointers. */
 
-#define GMPy_API_pointers 30
+#define GMPy_API_pointers 47
+
+/* Version of the C-API. It is stored as the context of the capsule and is
+ * increased whenever entries are added to the table; existing entries keep
+ * their index. import_gmpy2() refuses a gmpy2 with an older table.
+ */
+
+#define GMPy_API_VERSION 2
 
 /* End of C-API definitions. */
 
@@ -352,6 +453,14 @@ typedef struct {
 # endif
 #endif
 
+/* Storage class for thread-local variables. */
+
+#if defined(_MSC_VER)
+#  define GMPY_THREAD_LOCAL __declspec(thread)
+#else
+#  define GMPY_THREAD_LOCAL _Thread_local
+#endif
+
 #define ALLOC_THRESHOLD 8192
 
 #define INDEX_ERROR(msg)    PyErr_SetString(PyExc_IndexError, msg)
@@ -365,9 +474,8 @@ typedef struct {
 #define GMPY_DEFAULT -1
 
 /* To prevent excessive memory usage, we don't want to save very large
- * numbers in the cache. The default value specified in the options
- * structure is 128 words (512 bytes on 32-bit platforms, 1024 bytes on
- * 64-bit platforms).
+ * numbers in the cache. MAX_CACHE_LIMBS is the largest object size, in limbs,
+ * that can be given to set_cache(). The default is set in gmpy2.c.
  */
 #define MAX_CACHE_LIMBS 16384
 
@@ -423,10 +531,38 @@ typedef struct {
 
 #include "gmpy2_cache.h"
 
+/* Support for the memory functions used by GMP. */
+
+#include "gmpy2_alloc.h"
+
+/* Support for collecting statistics on a context. */
+
+#include "gmpy2_profile.h"
+
+/* Support for tracing allocations and releases of the GIL. */
+
+#include "gmpy2_trace.h"
+
 /* Suport for miscellaneous functions (ie. version, license, etc.). */
 
 #include "gmpy2_misc.h"
 
+/* Support for interrupting long computations. */
+
+#include "gmpy2_interrupt.h"
+
+/* Support for splitting loops over native threads. */
+
+#include "gmpy2_parallel.h"
+
+/* Support for per-thread scratch integers. */
+
+#include "gmpy2_scratch.h"
+
+/* Support for Montgomery arithmetic. */
+
+#include "gmpy2_mont.h"
+
 /* Support conversion to/from binary format. */
 
 #include "gmpy2_binary.h"
@@ -448,10 +584,24 @@ typedef struct {
 #include "gmpy2_xmpz_inplace.h"
 #include "gmpy2_xmpz_misc.h"
 #include "gmpy2_xmpz_limbs.h"
+#include "gmpy2_mpz_array.h"
+#include "gmpy2_mpz_view.h"
+#include "gmpy2_mpfr_array.h"
+#include "gmpy2_buffer.h"
+#include "gmpy2_sieve.h"
+#include "gmpy2_special.h"
+#include "gmpy2_series.h"
+#include "gmpy2_fixedbase.h"
+#include "gmpy2_modulus.h"
+#include "gmpy2_sec.h"
+#include "gmpy2_ec.h"
+#include "gmpy2_divisor.h"
+#include "gmpy2_expr.h"
 
 /* Support for mpq specific functions. */
 
 #include "gmpy2_mpq_misc.h"
+#include "gmpy2_accumulator.h"
 
 /* Support for mpfr specific functions. */
 
@@ -496,9 +646,18 @@ typedef struct {
 #include "gmpy2_richcompare.h"
 #include "gmpy2_cmp.h"
 
-#ifdef VECTOR
-#  include "gmpy2_vector.h"
-#endif /* defined(VECTOR) */
+#include "gmpy2_vector.h"
+#include "gmpy2_matrix.h"
+#include "gmpy2_tree.h"
+#include "gmpy2_crt.h"
+#include "gmpy2_rns.h"
+#include "gmpy2_nmod_poly.h"
+#include "gmpy2_sqrtmod.h"
+#include "gmpy2_factor.h"
+#include "gmpy2_dlog.h"
+#include "gmpy2_submit.h"
+#include "gmpy2_fft.h"
+#include "gmpy2_capi.h"
 
 #else /* defined(GMPY2_MODULE) */
 
@@ -539,11 +698,58 @@ static void **GMPy_C_API;
 #define GMPy_MPC_Dealloc     (*(GMPy_MPC_Dealloc_RETURN     (*)GMPy_MPC_Dealloc_PROTO)     GMPy_C_API[GMPy_MPC_Dealloc_NUM])
 #define GMPy_MPC_ConvertArg  (*(GMPy_MPC_ConvertArg_RETURN  (*)GMPy_MPC_ConvertArg_PROTO)  GMPy_C_API[GMPy_MPC_ConvertArg_NUM])
 
+#define GMPy_MPZ_NewSize     (*(GMPy_MPZ_NewSize_RETURN     (*)GMPy_MPZ_NewSize_PROTO)     GMPy_C_API[GMPy_MPZ_NewSize_NUM])
+#define GMPy_MPZ_From_PyLong (*(GMPy_MPZ_From_PyLong_RETURN (*)GMPy_MPZ_From_PyLong_PROTO) GMPy_C_API[GMPy_MPZ_From_PyLong_NUM])
+#define GMPy_PyLong_From_MPZ (*(GMPy_PyLong_From_MPZ_RETURN (*)GMPy_PyLong_From_MPZ_PROTO) GMPy_C_API[GMPy_PyLong_From_MPZ_NUM])
+#define mpz_set_PyLong       (*(mpz_set_PyLong_RETURN       (*)mpz_set_PyLong_PROTO)       GMPy_C_API[mpz_set_PyLong_NUM])
+
+#define GMPy_Scratch_Mark    (*(GMPy_Scratch_Mark_RETURN    (*)GMPy_Scratch_Mark_PROTO)    GMPy_C_API[GMPy_Scratch_Mark_NUM])
+#define GMPy_Scratch_Get     (*(GMPy_Scratch_Get_RETURN     (*)GMPy_Scratch_Get_PROTO)     GMPy_C_API[GMPy_Scratch_Get_NUM])
+#define GMPy_Scratch_Release (*(GMPy_Scratch_Release_RETURN (*)GMPy_Scratch_Release_PROTO) GMPy_C_API[GMPy_Scratch_Release_NUM])
+
+#define GMPy_Add             (*(GMPy_Add_RETURN             (*)GMPy_Add_PROTO)             GMPy_C_API[GMPy_Add_NUM])
+#define GMPy_Sub             (*(GMPy_Sub_RETURN             (*)GMPy_Sub_PROTO)             GMPy_C_API[GMPy_Sub_NUM])
+#define GMPy_Mul             (*(GMPy_Mul_RETURN             (*)GMPy_Mul_PROTO)             GMPy_C_API[GMPy_Mul_NUM])
+#define GMPy_PowMod          (*(GMPy_PowMod_RETURN          (*)GMPy_PowMod_PROTO)          GMPy_C_API[GMPy_PowMod_NUM])
+#define GMPy_IsPrime         (*(GMPy_IsPrime_RETURN         (*)GMPy_IsPrime_PROTO)         GMPy_C_API[GMPy_IsPrime_NUM])
+
+#define GMPy_Isum            (*(GMPy_Isum_RETURN            (*)GMPy_Isum_PROTO)            GMPy_C_API[GMPy_Isum_NUM])
+#define GMPy_Prod            (*(GMPy_Prod_RETURN            (*)GMPy_Prod_PROTO)            GMPy_C_API[GMPy_Prod_NUM])
+#define GMPy_Dot             (*(GMPy_Dot_RETURN             (*)GMPy_Dot_PROTO)             GMPy_C_API[GMPy_Dot_NUM])
+#define GMPy_PowMod_Base_List (*(GMPy_PowMod_Base_List_RETURN (*)GMPy_PowMod_Base_List_PROTO) GMPy_C_API[GMPy_PowMod_Base_List_NUM])
+#define GMPy_PowMod_Exp_List (*(GMPy_PowMod_Exp_List_RETURN (*)GMPy_PowMod_Exp_List_PROTO) GMPy_C_API[GMPy_PowMod_Exp_List_NUM])
+
 static int
 import_gmpy2(void)
 {
-    GMPy_C_API = (void **)PyCapsule_Import("gmpy2._C_API", 0);
-    return (GMPy_C_API != NULL) ? 0 : -1;
+    PyObject *module, *capsule;
+    Py_intptr_t version;
+
+    if (!(module = PyImport_ImportModule("gmpy2"))) {
+        return -1;
+    }
+    capsule = PyObject_GetAttrString(module, "_C_API");
+    Py_DECREF(module);
+    if (!capsule) {
+        return -1;
+    }
+    GMPy_C_API = (void **)PyCapsule_GetPointer(capsule, "gmpy2._C_API");
+    version = (Py_intptr_t)PyCapsule_GetContext(capsule);
+    Py_DECREF(capsule);
+    if (!GMPy_C_API) {
+        return -1;
+    }
+
+    /* Releases before version 2 of the C-API left the context unset. */
+    if (version < GMPy_API_VERSION) {
+        GMPy_C_API = NULL;
+        PyErr_Format(PyExc_ImportError,
+                     "gmpy2 C-API version %d is older than version %d "
+                     "required by this module",
+                     version ? (int)version : 1, GMPy_API_VERSION);
+        return -1;
+    }
+    return 0;
 }
 
 #endif /* defined(GMPY2_MODULE) */
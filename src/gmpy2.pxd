@@ -1,6 +1,7 @@
 cdef extern from "gmp.h":
     # gmp integers
     ctypedef long mp_limb_t
+    ctypedef long mp_size_t
 
     ctypedef struct __mpz_struct:
         int _mp_alloc
@@ -124,6 +125,35 @@ cdef extern from "gmpy2.h":
     cdef bint MPFR_Check(object)
     cdef bint MPC_Check(object)
 
+    # The declarations below need version 2 of the C-API; import_gmpy2()
+    # raises ImportError if the installed gmpy2 is older.
+
+    # Conversion between Python integers and mpz
+    cdef mpz GMPy_MPZ_From_PyLong(object, void *)
+    cdef object GMPy_PyLong_From_MPZ(mpz, void *)
+    cdef void mpz_set_PyLong(mpz_t, object)
+
+    # Temporaries: an mpz from the object cache with room for the given
+    # number of limbs, and the per-thread scratch pool
+    cdef mpz GMPy_MPZ_NewSize(mp_size_t, void *)
+    cdef int GMPy_Scratch_Mark() nogil
+    cdef mpz_ptr GMPy_Scratch_Get(size_t) nogil
+    cdef void GMPy_Scratch_Release(int) nogil
+
+    # Arithmetic using the given context, or the current one for NULL
+    cdef object GMPy_Add(object, object, void *)
+    cdef object GMPy_Sub(object, object, void *)
+    cdef object GMPy_Mul(object, object, void *)
+    cdef object GMPy_PowMod(object, object, object, void *)
+    cdef int GMPy_IsPrime(object, unsigned long, void *) except -1
+
+    # Batch kernels
+    cdef object GMPy_Isum(object, void *)
+    cdef object GMPy_Prod(object, void *)
+    cdef object GMPy_Dot(object, object, void *)
+    cdef object GMPy_PowMod_Base_List(object, object, object)
+    cdef object GMPy_PowMod_Exp_List(object, object, object)
+
 
 # Build a gmpy2 mpz from a gmp mpz
 cdef inline mpz GMPy_MPZ_From_mpz(mpz_srcptr z):
@@ -0,0 +1,948 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_accumulator.c                                                     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Lazy rational accumulation.
+ *
+ * mpq arithmetic keeps every result in lowest terms, which costs a gcd per
+ * operation. A RationalAccumulator only multiplies numerators and
+ * denominators and reduces the fraction when the denominator has grown
+ * past a limit. After a reduction the limit is raised to twice the size of
+ * the reduced denominator so a value whose lowest terms are large is not
+ * reduced again after every operation.
+ */
+
+#define ACCUMULATOR_REDUCE_BITS 4096
+
+PyDoc_STRVAR(GMPy_doc_accumulator,
+"RationalAccumulator(value=0, /, reduce_bits=4096) -> RationalAccumulator\n\n"
+"Return a mutable rational that accumulates sums and products of\n"
+"integers and rationals without reducing them to lowest terms after\n"
+"every operation. The fraction is reduced when its denominator exceeds\n"
+"reduce_bits bits, or twice the size of the denominator after the last\n"
+"reduction, and when the value is read. If reduce_bits is 0 the fraction\n"
+"is only reduced when it is read. The operators +=, -=, *=, and /= are\n"
+"supported and mpq(x) returns the value.");
+
+/* Set *num and *den to the numerator and denominator of x; *den is set to
+ * NULL for an integer. Returns a new reference to the object that holds
+ * them, or NULL if x is not an integer or a rational.
+ */
+
+static PyObject *
+_GMPy_Accumulator_Operand(PyObject *x, mpz_srcptr *num, mpz_srcptr *den,
+                          CTXT_Object *context)
+{
+    int xtype;
+
+    if (Accumulator_Check(x)) {
+        *num = ((Accumulator_Object*)x)->num;
+        *den = ((Accumulator_Object*)x)->den;
+        Py_INCREF(x);
+        return x;
+    }
+
+    xtype = GMPy_ObjectType(x);
+    if (IS_TYPE_INTEGER(xtype)) {
+        MPZ_Object *tempz;
+
+        if (!(tempz = GMPy_MPZ_From_IntegerWithType(x, xtype, context)))
+            return NULL;
+        *num = tempz->z;
+        *den = NULL;
+        return (PyObject*)tempz;
+    }
+    if (IS_TYPE_RATIONAL(xtype)) {
+        MPQ_Object *tempq;
+
+        if (!(tempq = GMPy_MPQ_From_RationalWithType(x, xtype, context)))
+            return NULL;
+        *num = mpq_numref(tempq->q);
+        *den = mpq_denref(tempq->q);
+        return (PyObject*)tempq;
+    }
+    return NULL;
+}
+
+/* Reduce num/den to lowest terms and raise the limit. */
+
+static void
+_GMPy_Accumulator_Reduce(Accumulator_Object *self)
+{
+    size_t bits;
+
+    mpz_gcd(self->temp, self->num, self->den);
+    if (mpz_cmp_ui(self->temp, 1) > 0) {
+        mpz_divexact(self->num, self->num, self->temp);
+        mpz_divexact(self->den, self->den, self->temp);
+    }
+    bits = mpz_sizeinbase(self->den, 2);
+    if (self->reduce_bits)
+        self->limit = Py_MAX(self->reduce_bits, 2 * bits);
+}
+
+static void
+_GMPy_Accumulator_Check_Limit(Accumulator_Object *self)
+{
+    if (self->limit && mpz_sizeinbase(self->den, 2) > self->limit)
+        _GMPy_Accumulator_Reduce(self);
+}
+
+/* Add a/b to num/den, or subtract it if negate is set. b is NULL for 1. */
+
+static void
+_GMPy_Accumulator_Add(Accumulator_Object *self, mpz_srcptr a, mpz_srcptr b,
+                      int negate)
+{
+    if (!b) {
+        if (negate)
+            mpz_submul(self->num, a, self->den);
+        else
+            mpz_addmul(self->num, a, self->den);
+        return;
+    }
+    if (mpz_cmp(b, self->den) == 0) {
+        if (negate)
+            mpz_sub(self->num, self->num, a);
+        else
+            mpz_add(self->num, self->num, a);
+        return;
+    }
+    mpz_mul(self->num, self->num, b);
+    if (negate)
+        mpz_submul(self->num, a, self->den);
+    else
+        mpz_addmul(self->num, a, self->den);
+    mpz_mul(self->den, self->den, b);
+    _GMPy_Accumulator_Check_Limit(self);
+}
+
+/* Multiply num/den by a/b, or divide it if invert is set. a must not be 0
+ * when dividing.
+ */
+
+static void
+_GMPy_Accumulator_Mul(Accumulator_Object *self, mpz_srcptr a, mpz_srcptr b,
+                      int invert)
+{
+    if (invert) {
+        /* a and b may be num and den of self. */
+        if (b)
+            mpz_mul(self->temp, self->num, b);
+        else
+            mpz_set(self->temp, self->num);
+        mpz_mul(self->den, self->den, a);
+        mpz_swap(self->num, self->temp);
+        if (mpz_sgn(self->den) < 0) {
+            mpz_neg(self->num, self->num);
+            mpz_neg(self->den, self->den);
+        }
+    }
+    else {
+        mpz_mul(self->num, self->num, a);
+        if (b)
+            mpz_mul(self->den, self->den, b);
+    }
+    _GMPy_Accumulator_Check_Limit(self);
+}
+
+enum {
+    ACCUMULATOR_ADD,
+    ACCUMULATOR_SUB,
+    ACCUMULATOR_MUL,
+    ACCUMULATOR_DIV
+};
+
+/* Apply op with x to self. Returns 0, or -1 with TypeError set if x is
+ * not an integer or a rational.
+ */
+
+static int
+_GMPy_Accumulator_Apply(Accumulator_Object *self, PyObject *x, int op,
+                        CTXT_Object *context)
+{
+    PyObject *holder;
+    mpz_srcptr a, b;
+
+    if (!(holder = _GMPy_Accumulator_Operand(x, &a, &b, context))) {
+        if (!PyErr_Occurred())
+            TYPE_ERROR("RationalAccumulator requires integer or rational arguments");
+        return -1;
+    }
+    if (op == ACCUMULATOR_DIV && mpz_sgn(a) == 0) {
+        ZERO_ERROR("division or modulo by zero");
+        Py_DECREF(holder);
+        return -1;
+    }
+
+    GMPY_PROFILE_OP(context, op < ACCUMULATOR_MUL ? GMPY_OP_ADD : GMPY_OP_MUL,
+                    mpz_sizeinbase(self->den, 2));
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(self->num, self->den) +
+                                            GMPY_MPZ_BITS(a));
+    if (op < ACCUMULATOR_MUL)
+        _GMPy_Accumulator_Add(self, a, b, op == ACCUMULATOR_SUB);
+    else
+        _GMPy_Accumulator_Mul(self, a, b, op == ACCUMULATOR_DIV);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    Py_DECREF(holder);
+    return 0;
+}
+
+static PyObject *
+GMPy_Accumulator_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "reduce_bits", NULL};
+    Accumulator_Object *result;
+    PyObject *value = NULL;
+    Py_ssize_t reduce_bits = ACCUMULATOR_REDUCE_BITS;
+    CTXT_Object *context = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|On", kwlist, &value, &reduce_bits))
+        return NULL;
+
+    if (reduce_bits < 0) {
+        VALUE_ERROR("RationalAccumulator() 'reduce_bits' must be >= 0");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!(result = PyObject_New(Accumulator_Object, &Accumulator_Type)))
+        return NULL;
+    mpz_init(result->num);
+    mpz_init_set_ui(result->den, 1);
+    mpz_init(result->temp);
+    result->reduce_bits = result->limit = (size_t)reduce_bits;
+
+    if (value && _GMPy_Accumulator_Apply(result, value, ACCUMULATOR_ADD, context) < 0) {
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    return (PyObject*)result;
+}
+
+static void
+GMPy_Accumulator_Dealloc(Accumulator_Object *self)
+{
+    mpz_clear(self->num);
+    mpz_clear(self->den);
+    mpz_clear(self->temp);
+    PyObject_Free(self);
+}
+
+static PyObject *
+_GMPy_Accumulator_Method(Accumulator_Object *self, PyObject *other, int op)
+{
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_Accumulator_Apply(self, other, op, context) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+_GMPy_Accumulator_Inplace(PyObject *self, PyObject *other, int op)
+{
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!Accumulator_Check(other) && !IS_RATIONAL(other))
+        Py_RETURN_NOTIMPLEMENTED;
+    if (_GMPy_Accumulator_Apply((Accumulator_Object*)self, other, op, context) < 0)
+        return NULL;
+    Py_INCREF(self);
+    return self;
+}
+
+PyDoc_STRVAR(GMPy_doc_accumulator_add,
+"x.add(a, /) -> None\n\n"
+"Add a to x.");
+
+static PyObject *
+GMPy_Accumulator_Add(PyObject *self, PyObject *other)
+{
+    return _GMPy_Accumulator_Method((Accumulator_Object*)self, other, ACCUMULATOR_ADD);
+}
+
+PyDoc_STRVAR(GMPy_doc_accumulator_sub,
+"x.sub(a, /) -> None\n\n"
+"Subtract a from x.");
+
+static PyObject *
+GMPy_Accumulator_Sub(PyObject *self, PyObject *other)
+{
+    return _GMPy_Accumulator_Method((Accumulator_Object*)self, other, ACCUMULATOR_SUB);
+}
+
+PyDoc_STRVAR(GMPy_doc_accumulator_mul,
+"x.mul(a, /) -> None\n\n"
+"Multiply x by a.");
+
+static PyObject *
+GMPy_Accumulator_Mul(PyObject *self, PyObject *other)
+{
+    return _GMPy_Accumulator_Method((Accumulator_Object*)self, other, ACCUMULATOR_MUL);
+}
+
+PyDoc_STRVAR(GMPy_doc_accumulator_div,
+"x.div(a, /) -> None\n\n"
+"Divide x by a.");
+
+static PyObject *
+GMPy_Accumulator_Div(PyObject *self, PyObject *other)
+{
+    return _GMPy_Accumulator_Method((Accumulator_Object*)self, other, ACCUMULATOR_DIV);
+}
+
+/* Add or subtract the product a*b without reducing it first. */
+
+static PyObject *
+_GMPy_Accumulator_AddMul(Accumulator_Object *self, PyObject *const *args,
+                         Py_ssize_t nargs, int negate, const char *name)
+{
+    PyObject *holder1, *holder2 = NULL;
+    mpz_srcptr a1, b1, a2 = NULL, b2 = NULL;
+    mpz_t num, den;
+    CTXT_Object *context = NULL;
+
+    if (nargs != 2) {
+        PyErr_Format(PyExc_TypeError, "%s() requires 2 arguments", name);
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!(holder1 = _GMPy_Accumulator_Operand(args[0], &a1, &b1, context)) ||
+        !(holder2 = _GMPy_Accumulator_Operand(args[1], &a2, &b2, context))) {
+        Py_XDECREF(holder1);
+        if (!PyErr_Occurred())
+            PyErr_Format(PyExc_TypeError, "%s() requires integer or rational arguments", name);
+        return NULL;
+    }
+
+    GMPY_PROFILE_OP(context, GMPY_OP_MUL, mpz_sizeinbase(self->den, 2));
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(self->num, self->den) +
+                                            GMPY_MPZ_BITS2(a1, a2));
+    mpz_init(num);
+    mpz_mul(num, a1, a2);
+    if (b1 || b2) {
+        mpz_init(den);
+        if (b1 && b2)
+            mpz_mul(den, b1, b2);
+        else
+            mpz_set(den, b1 ? b1 : b2);
+        _GMPy_Accumulator_Add(self, num, den, negate);
+        mpz_clear(den);
+    }
+    else {
+        _GMPy_Accumulator_Add(self, num, NULL, negate);
+    }
+    mpz_clear(num);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    Py_DECREF(holder1);
+    Py_DECREF(holder2);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_accumulator_addmul,
+"x.addmul(a, b, /) -> None\n\n"
+"Add a*b to x.");
+
+static PyObject *
+GMPy_Accumulator_AddMul_Method(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    return _GMPy_Accumulator_AddMul((Accumulator_Object*)self, args, nargs, 0, "addmul");
+}
+
+PyDoc_STRVAR(GMPy_doc_accumulator_submul,
+"x.submul(a, b, /) -> None\n\n"
+"Subtract a*b from x.");
+
+static PyObject *
+GMPy_Accumulator_SubMul_Method(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    return _GMPy_Accumulator_AddMul((Accumulator_Object*)self, args, nargs, 1, "submul");
+}
+
+/* Reduce the fraction, releasing the GIL if it is large. */
+
+static void
+_GMPy_Accumulator_Reduce_Threads(Accumulator_Object *self, CTXT_Object *context)
+{
+    GMPY_PROFILE_OP(context, GMPY_OP_GCD, mpz_sizeinbase(self->den, 2));
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(self->num, self->den));
+    _GMPy_Accumulator_Reduce(self);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+}
+
+PyDoc_STRVAR(GMPy_doc_accumulator_reduce,
+"x.reduce() -> None\n\n"
+"Reduce the stored fraction to lowest terms.");
+
+static PyObject *
+GMPy_Accumulator_Reduce_Method(PyObject *self, PyObject *other)
+{
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    _GMPy_Accumulator_Reduce_Threads((Accumulator_Object*)self, context);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_accumulator_value,
+"x.__mpq__() -> mpq\n\n"
+"Return the value of x as an mpq.");
+
+static PyObject *
+GMPy_Accumulator_Value(PyObject *self, PyObject *other)
+{
+    Accumulator_Object *acc = (Accumulator_Object*)self;
+    MPQ_Object *result;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    _GMPy_Accumulator_Reduce_Threads(acc, context);
+    if ((result = GMPy_MPQ_New(context))) {
+        mpz_set(mpq_numref(result->q), acc->num);
+        mpz_set(mpq_denref(result->q), acc->den);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_Accumulator_GetValue(PyObject *self, void *closure)
+{
+    return GMPy_Accumulator_Value(self, NULL);
+}
+
+static PyObject *
+GMPy_Accumulator_GetReduceBits(Accumulator_Object *self, void *closure)
+{
+    return PyLong_FromSize_t(self->reduce_bits);
+}
+
+static int
+GMPy_Accumulator_SetReduceBits(Accumulator_Object *self, PyObject *value, void *closure)
+{
+    Py_ssize_t bits;
+
+    if (!value) {
+        TYPE_ERROR("deleting 'reduce_bits' is not supported");
+        return -1;
+    }
+    bits = PyNumber_AsSsize_t(value, PyExc_OverflowError);
+    if (bits == -1 && PyErr_Occurred())
+        return -1;
+    if (bits < 0) {
+        VALUE_ERROR("'reduce_bits' must be >= 0");
+        return -1;
+    }
+    self->reduce_bits = self->limit = (size_t)bits;
+    return 0;
+}
+
+static PyObject *
+GMPy_Accumulator_Repr_Slot(PyObject *self)
+{
+    PyObject *value, *result = NULL;
+
+    if ((value = GMPy_Accumulator_Value(self, NULL))) {
+        result = PyUnicode_FromFormat("RationalAccumulator(%R)", value);
+        Py_DECREF(value);
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_Accumulator_IAdd_Slot(PyObject *self, PyObject *other)
+{
+    return _GMPy_Accumulator_Inplace(self, other, ACCUMULATOR_ADD);
+}
+
+static PyObject *
+GMPy_Accumulator_ISub_Slot(PyObject *self, PyObject *other)
+{
+    return _GMPy_Accumulator_Inplace(self, other, ACCUMULATOR_SUB);
+}
+
+static PyObject *
+GMPy_Accumulator_IMul_Slot(PyObject *self, PyObject *other)
+{
+    return _GMPy_Accumulator_Inplace(self, other, ACCUMULATOR_MUL);
+}
+
+static PyObject *
+GMPy_Accumulator_IDiv_Slot(PyObject *self, PyObject *other)
+{
+    return _GMPy_Accumulator_Inplace(self, other, ACCUMULATOR_DIV);
+}
+
+static PyNumberMethods GMPy_Accumulator_number_methods =
+{
+    .nb_inplace_add = (binaryfunc) GMPy_Accumulator_IAdd_Slot,
+    .nb_inplace_subtract = (binaryfunc) GMPy_Accumulator_ISub_Slot,
+    .nb_inplace_multiply = (binaryfunc) GMPy_Accumulator_IMul_Slot,
+    .nb_inplace_true_divide = (binaryfunc) GMPy_Accumulator_IDiv_Slot,
+};
+
+static PyMethodDef GMPy_Accumulator_methods[] =
+{
+    { "__mpq__", GMPy_Accumulator_Value, METH_NOARGS, GMPy_doc_accumulator_value },
+    { "add", GMPy_Accumulator_Add, METH_O, GMPy_doc_accumulator_add },
+    { "addmul", (PyCFunction)(void(*)(void))GMPy_Accumulator_AddMul_Method, METH_FASTCALL, GMPy_doc_accumulator_addmul },
+    { "div", GMPy_Accumulator_Div, METH_O, GMPy_doc_accumulator_div },
+    { "mul", GMPy_Accumulator_Mul, METH_O, GMPy_doc_accumulator_mul },
+    { "reduce", GMPy_Accumulator_Reduce_Method, METH_NOARGS, GMPy_doc_accumulator_reduce },
+    { "sub", GMPy_Accumulator_Sub, METH_O, GMPy_doc_accumulator_sub },
+    { "submul", (PyCFunction)(void(*)(void))GMPy_Accumulator_SubMul_Method, METH_FASTCALL, GMPy_doc_accumulator_submul },
+    { NULL }
+};
+
+static PyGetSetDef GMPy_Accumulator_getseters[] =
+{
+    { "value", (getter)GMPy_Accumulator_GetValue, NULL,
+      "value as an mpq in lowest terms", NULL },
+    { "reduce_bits", (getter)GMPy_Accumulator_GetReduceBits,
+      (setter)GMPy_Accumulator_SetReduceBits,
+      "denominator size, in bits, that triggers a reduction; 0 for never", NULL },
+    { NULL }
+};
+
+static PyTypeObject Accumulator_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.RationalAccumulator",
+    .tp_basicsize = sizeof(Accumulator_Object),
+    .tp_dealloc = (destructor) GMPy_Accumulator_Dealloc,
+    .tp_repr = (reprfunc) GMPy_Accumulator_Repr_Slot,
+    .tp_as_number = &GMPy_Accumulator_number_methods,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_accumulator,
+    .tp_methods = GMPy_Accumulator_methods,
+    .tp_getset = GMPy_Accumulator_getseters,
+    .tp_new = GMPy_Accumulator_NewInit,
+};
+
+/* Exact mpfr summation.
+ *
+ * fsum() needs all the values at once. An mpfr_accumulator adds each value
+ * exactly to an integer scaled by a power of two, which only grows when a
+ * value with a smaller exponent or a larger magnitude arrives, and rounds
+ * once when the result is read.
+ */
+
+PyDoc_STRVAR(GMPy_doc_mpfr_accumulator,
+"mpfr_accumulator(prec=0) -> mpfr_accumulator\n\n"
+"Return an exact accumulator for sums of real numbers. Values are added\n"
+"one at a time with add() or +=, or in bulk with extend(). The sum is\n"
+"kept exactly, using memory that depends on the range of the exponents\n"
+"of the values but not on their number, and is rounded once by result()\n"
+"to prec bits, or to the precision of the current context if prec is 0.");
+
+/* Add m*2**e, where m is nonzero and may be changed. */
+
+static void
+_GMPy_MPFR_Accumulator_Add_Z(MPFR_Accumulator_Object *self, mpz_ptr m, mpfr_exp_t e)
+{
+    mp_bitcnt_t shift = mpz_scan1(m, 0);
+
+    if (shift) {
+        mpz_tdiv_q_2exp(m, m, shift);
+        e += (mpfr_exp_t)shift;
+    }
+
+    if (mpz_sgn(self->acc) == 0) {
+        mpz_swap(self->acc, m);
+        self->exp = e;
+    }
+    else if (e >= self->exp) {
+        mpz_mul_2exp(m, m, (mp_bitcnt_t)(e - self->exp));
+        mpz_add(self->acc, self->acc, m);
+    }
+    else {
+        mpz_mul_2exp(self->acc, self->acc, (mp_bitcnt_t)(self->exp - e));
+        mpz_add(self->acc, self->acc, m);
+        self->exp = e;
+    }
+}
+
+static void
+_GMPy_MPFR_Accumulator_Add_MPFR(MPFR_Accumulator_Object *self, mpfr_srcptr f)
+{
+    mpfr_exp_t e;
+
+    if (!mpfr_number_p(f)) {
+        if (mpfr_nan_p(f))
+            self->flags |= MPFR_ACC_NAN;
+        else
+            self->flags |= mpfr_signbit(f) ? MPFR_ACC_NEG_INF : MPFR_ACC_POS_INF;
+        return;
+    }
+    if (mpfr_zero_p(f)) {
+        self->flags |= mpfr_signbit(f) ? MPFR_ACC_NOT_POS_ZERO : MPFR_ACC_NOT_NEG_ZERO;
+        return;
+    }
+    self->flags |= MPFR_ACC_NOT_POS_ZERO | MPFR_ACC_NOT_NEG_ZERO;
+    e = mpfr_get_z_2exp(self->temp, f);
+    _GMPy_MPFR_Accumulator_Add_Z(self, self->temp, e);
+}
+
+static void
+_GMPy_MPFR_Accumulator_Add_Double(MPFR_Accumulator_Object *self, double d)
+{
+    MPFR_DECL_INIT(f, 53);
+
+    /* Exact, since f has the precision of a double. */
+    mpfr_set_d(f, d, MPFR_RNDN);
+    _GMPy_MPFR_Accumulator_Add_MPFR(self, f);
+}
+
+static void
+_GMPy_MPFR_Accumulator_Add_Integer(MPFR_Accumulator_Object *self, mpz_srcptr z)
+{
+    if (mpz_sgn(z) == 0) {
+        self->flags |= MPFR_ACC_NOT_NEG_ZERO;
+        return;
+    }
+    self->flags |= MPFR_ACC_NOT_POS_ZERO | MPFR_ACC_NOT_NEG_ZERO;
+    mpz_set(self->temp, z);
+    _GMPy_MPFR_Accumulator_Add_Z(self, self->temp, 0);
+}
+
+/* Add the real number x. Integers, floats, and mpfr values are added
+ * exactly; other values are first converted to mpfr in the current context.
+ */
+
+static int
+_GMPy_MPFR_Accumulator_Add_Object(MPFR_Accumulator_Object *self, PyObject *x,
+                                  CTXT_Object *context)
+{
+    int xtype = GMPy_ObjectType(x);
+
+    if (IS_TYPE_MPFR(xtype)) {
+        _GMPy_MPFR_Accumulator_Add_MPFR(self, MPFR(x));
+    }
+    else if (IS_TYPE_PyFloat(xtype)) {
+        _GMPy_MPFR_Accumulator_Add_Double(self, PyFloat_AS_DOUBLE(x));
+    }
+    else if (IS_TYPE_INTEGER(xtype)) {
+        MPZ_Object *tempz;
+
+        if (!(tempz = GMPy_MPZ_From_IntegerWithType(x, xtype, context)))
+            return -1;
+        _GMPy_MPFR_Accumulator_Add_Integer(self, tempz->z);
+        Py_DECREF((PyObject*)tempz);
+    }
+    else if (IS_TYPE_REAL(xtype)) {
+        MPFR_Object *tempf;
+
+        if (!(tempf = GMPy_MPFR_From_RealWithType(x, xtype, 1, context)))
+            return -1;
+        _GMPy_MPFR_Accumulator_Add_MPFR(self, tempf->f);
+        Py_DECREF((PyObject*)tempf);
+    }
+    else {
+        TYPE_ERROR("mpfr_accumulator requires real arguments");
+        return -1;
+    }
+    return 0;
+}
+
+/* Add every element of a buffer of machine integers or floats. */
+
+static int
+_GMPy_MPFR_Accumulator_Add_Buffer(MPFR_Accumulator_Object *self, PyObject *x)
+{
+    Py_buffer view;
+    Py_ssize_t i, n, stride;
+    const char *p;
+    char kind;
+
+    if (PyObject_GetBuffer(x, &view, PyBUF_FORMAT | PyBUF_STRIDES) < 0)
+        return -1;
+
+    if (!(kind = _GMPy_Buffer_Kind(view.format, view.itemsize))) {
+        PyErr_Format(PyExc_TypeError, "extend() does not support the format '%s'",
+                     view.format ? view.format : "B");
+        PyBuffer_Release(&view);
+        return -1;
+    }
+
+    n = view.len / view.itemsize;
+    if (view.ndim == 1) {
+        stride = view.strides[0];
+    }
+    else if (view.ndim == 0 || PyBuffer_IsContiguous(&view, 'C')) {
+        stride = view.itemsize;
+    }
+    else {
+        VALUE_ERROR("extend() requires a C-contiguous array");
+        PyBuffer_Release(&view);
+        return -1;
+    }
+
+    for (i = 0; i < n; i++) {
+        p = (const char*)view.buf + i * stride;
+        if (kind == 'f') {
+            _GMPy_MPFR_Accumulator_Add_Double(self, _GMPy_Buffer_Get_Double(p, view.itemsize));
+            continue;
+        }
+        if (kind == 'i')
+            _GMPy_MPZ_Set_Int64(self->temp, _GMPy_Buffer_Get_Int(p, view.itemsize));
+        else
+            _GMPy_MPZ_Set_UInt64(self->temp, _GMPy_Buffer_Get_UInt(p, view.itemsize));
+        if (mpz_sgn(self->temp) == 0) {
+            self->flags |= MPFR_ACC_NOT_NEG_ZERO;
+            continue;
+        }
+        self->flags |= MPFR_ACC_NOT_POS_ZERO | MPFR_ACC_NOT_NEG_ZERO;
+        _GMPy_MPFR_Accumulator_Add_Z(self, self->temp, 0);
+    }
+    PyBuffer_Release(&view);
+    return 0;
+}
+
+static PyObject *
+GMPy_MPFR_Accumulator_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"prec", NULL};
+    MPFR_Accumulator_Object *result;
+    long prec = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|l", kwlist, &prec))
+        return NULL;
+
+    if (prec && (prec < MPFR_PREC_MIN || prec > MPFR_PREC_MAX)) {
+        VALUE_ERROR("invalid value for precision");
+        return NULL;
+    }
+
+    if (!(result = PyObject_New(MPFR_Accumulator_Object, &MPFR_Accumulator_Type)))
+        return NULL;
+    mpz_init(result->acc);
+    mpz_init(result->temp);
+    result->exp = 0;
+    result->prec = (mpfr_prec_t)prec;
+    result->flags = 0;
+    return (PyObject*)result;
+}
+
+static void
+GMPy_MPFR_Accumulator_Dealloc(MPFR_Accumulator_Object *self)
+{
+    mpz_clear(self->acc);
+    mpz_clear(self->temp);
+    PyObject_Free(self);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_accumulator_add,
+"x.add(a, /) -> None\n\n"
+"Add the real number a to x.");
+
+static PyObject *
+GMPy_MPFR_Accumulator_Add(PyObject *self, PyObject *other)
+{
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_MPFR_Accumulator_Add_Object((MPFR_Accumulator_Object*)self, other, context) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_accumulator_extend,
+"x.extend(iterable, /) -> None\n\n"
+"Add every element of iterable to x. An object that supports the buffer\n"
+"protocol, such as a NumPy array of float64, is read without creating a\n"
+"Python object for each element.");
+
+static PyObject *
+GMPy_MPFR_Accumulator_Extend(PyObject *self, PyObject *other)
+{
+    MPFR_Accumulator_Object *acc = (MPFR_Accumulator_Object*)self;
+    PyObject *iter, *item;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    /* mpz and xmpz export their limbs, which are not a sequence of values. */
+    if (PyObject_CheckBuffer(other) && !IS_REAL(other)) {
+        if (_GMPy_MPFR_Accumulator_Add_Buffer(acc, other) < 0)
+            return NULL;
+        Py_RETURN_NONE;
+    }
+
+    if (!(iter = PyObject_GetIter(other)))
+        return NULL;
+    while ((item = PyIter_Next(iter))) {
+        if (_GMPy_MPFR_Accumulator_Add_Object(acc, item, context) < 0) {
+            Py_DECREF(item);
+            Py_DECREF(iter);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+    Py_DECREF(iter);
+    if (PyErr_Occurred())
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_accumulator_result,
+"x.result() -> mpfr\n\n"
+"Return the sum, correctly rounded using the rounding mode of the current\n"
+"context.");
+
+static PyObject *
+GMPy_MPFR_Accumulator_Result(PyObject *self, PyObject *other)
+{
+    MPFR_Accumulator_Object *acc = (MPFR_Accumulator_Object*)self;
+    MPFR_Object *result;
+    int flags = acc->flags;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(result = GMPy_MPFR_New(acc->prec, context)))
+        return NULL;
+
+    mpfr_clear_flags();
+
+    if ((flags & MPFR_ACC_NAN) ||
+        ((flags & MPFR_ACC_POS_INF) && (flags & MPFR_ACC_NEG_INF))) {
+        mpfr_set_nan(result->f);
+    }
+    else if (flags & (MPFR_ACC_POS_INF | MPFR_ACC_NEG_INF)) {
+        mpfr_set_inf(result->f, (flags & MPFR_ACC_POS_INF) ? 1 : -1);
+    }
+    else if (mpz_sgn(acc->acc) == 0) {
+        /* An exact zero is -0 if every value was -0, or if rounding toward
+         * -Inf and some value was not +0, as for IEEE addition.
+         */
+        if ((flags & MPFR_ACC_NOT_POS_ZERO) &&
+            (!(flags & MPFR_ACC_NOT_NEG_ZERO) || GET_MPFR_ROUND(context) == MPFR_RNDD))
+            mpfr_set_zero(result->f, -1);
+        else
+            mpfr_set_zero(result->f, 1);
+    }
+    else {
+        result->rc = mpfr_set_z_2exp(result->f, acc->acc, acc->exp,
+                                     GET_MPFR_ROUND(context));
+    }
+
+    _GMPy_MPFR_Cleanup(&result, context);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_accumulator_clear,
+"x.clear() -> None\n\n"
+"Reset the sum to 0.");
+
+static PyObject *
+GMPy_MPFR_Accumulator_Clear(PyObject *self, PyObject *other)
+{
+    MPFR_Accumulator_Object *acc = (MPFR_Accumulator_Object*)self;
+
+    mpz_set_ui(acc->acc, 0);
+    acc->exp = 0;
+    acc->flags = 0;
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+GMPy_MPFR_Accumulator_GetPrec(MPFR_Accumulator_Object *self, void *closure)
+{
+    return PyLong_FromLong((long)self->prec);
+}
+
+static PyObject *
+GMPy_MPFR_Accumulator_Repr_Slot(PyObject *self)
+{
+    PyObject *value, *result = NULL;
+
+    if ((value = GMPy_MPFR_Accumulator_Result(self, NULL))) {
+        result = PyUnicode_FromFormat("mpfr_accumulator(%R)", value);
+        Py_DECREF(value);
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_MPFR_Accumulator_IAdd_Slot(PyObject *self, PyObject *other)
+{
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_REAL(other))
+        Py_RETURN_NOTIMPLEMENTED;
+    if (_GMPy_MPFR_Accumulator_Add_Object((MPFR_Accumulator_Object*)self, other, context) < 0)
+        return NULL;
+    Py_INCREF(self);
+    return self;
+}
+
+static PyNumberMethods GMPy_MPFR_Accumulator_number_methods =
+{
+    .nb_inplace_add = (binaryfunc) GMPy_MPFR_Accumulator_IAdd_Slot,
+};
+
+static PyMethodDef GMPy_MPFR_Accumulator_methods[] =
+{
+    { "__mpfr__", GMPy_MPFR_Accumulator_Result, METH_NOARGS, GMPy_doc_mpfr_accumulator_result },
+    { "add", GMPy_MPFR_Accumulator_Add, METH_O, GMPy_doc_mpfr_accumulator_add },
+    { "clear", GMPy_MPFR_Accumulator_Clear, METH_NOARGS, GMPy_doc_mpfr_accumulator_clear },
+    { "extend", GMPy_MPFR_Accumulator_Extend, METH_O, GMPy_doc_mpfr_accumulator_extend },
+    { "result", GMPy_MPFR_Accumulator_Result, METH_NOARGS, GMPy_doc_mpfr_accumulator_result },
+    { NULL }
+};
+
+static PyGetSetDef GMPy_MPFR_Accumulator_getseters[] =
+{
+    { "prec", (getter)GMPy_MPFR_Accumulator_GetPrec, NULL,
+      "precision of the result; 0 for the precision of the context", NULL },
+    { NULL }
+};
+
+static PyTypeObject MPFR_Accumulator_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.mpfr_accumulator",
+    .tp_basicsize = sizeof(MPFR_Accumulator_Object),
+    .tp_dealloc = (destructor) GMPy_MPFR_Accumulator_Dealloc,
+    .tp_repr = (reprfunc) GMPy_MPFR_Accumulator_Repr_Slot,
+    .tp_as_number = &GMPy_MPFR_Accumulator_number_methods,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_mpfr_accumulator,
+    .tp_methods = GMPy_MPFR_Accumulator_methods,
+    .tp_getset = GMPy_MPFR_Accumulator_getseters,
+    .tp_new = GMPy_MPFR_Accumulator_NewInit,
+};
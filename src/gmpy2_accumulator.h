@@ -0,0 +1,78 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_accumulator.h                                                     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_ACCUMULATOR_H
+#define GMPY_ACCUMULATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A RationalAccumulator holds num/den with den > 0 but does not keep the
+ * fraction in lowest terms. It is reduced when den grows beyond limit bits
+ * and whenever the value is read.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    mpz_t num;
+    mpz_t den;
+    mpz_t temp;             /* scratch space */
+    size_t reduce_bits;     /* 0 if only reduced when read */
+    size_t limit;           /* reduce when den has more bits */
+} Accumulator_Object;
+
+static PyTypeObject Accumulator_Type;
+#define Accumulator_Check(v) (((PyObject*)v)->ob_type == &Accumulator_Type)
+
+/* An mpfr_accumulator holds the exact sum of the finite values added to it
+ * as acc * 2**exp. Its size depends on the range of the exponents of the
+ * values, not on how many were added. Infinities, NaNs, and the signs of
+ * zeros are recorded in flags.
+ */
+
+#define MPFR_ACC_POS_INF      1
+#define MPFR_ACC_NEG_INF      2
+#define MPFR_ACC_NAN          4
+#define MPFR_ACC_NOT_NEG_ZERO 8     /* a value other than -0 was added */
+#define MPFR_ACC_NOT_POS_ZERO 16    /* a value other than +0 was added */
+
+typedef struct {
+    PyObject_HEAD
+    mpz_t acc;
+    mpz_t temp;             /* scratch space */
+    mpfr_exp_t exp;
+    mpfr_prec_t prec;       /* precision of the result; 0 for the context */
+    int flags;
+} MPFR_Accumulator_Object;
+
+static PyTypeObject MPFR_Accumulator_Type;
+#define MPFR_Accumulator_Check(v) (((PyObject*)v)->ob_type == &MPFR_Accumulator_Type)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -37,8 +37,15 @@ GMPy_Integer_AddWithType(PyObject *x, int xtype, PyObject *y, int ytype,
                          CTXT_Object *context)
 {
     MPZ_Object *result = NULL;
+    mp_size_t size = 1;
 
-    if (!(result = GMPy_MPZ_New(context))) {
+    /* Pick a cached object that is large enough for the result. */
+    if (IS_TYPE_MPZANY(xtype) && IS_TYPE_MPZANY(ytype))
+        size = Py_MAX(mpz_size(MPZ(x)), mpz_size(MPZ(y))) + 1;
+
+    if (!(result = GMPy_MPZ_Reuse(x, xtype, y, ytype)) &&
+        !(result = GMPy_MPZ_Reuse(y, ytype, x, xtype)) &&
+        !(result = GMPy_MPZ_NewSize(size, context))) {
         /* LCOV_EXCL_START */
         return NULL;
         /* LCOV_EXCL_STOP */
@@ -46,17 +53,16 @@ GMPy_Integer_AddWithType(PyObject *x, int xtype, PyObject *y, int ytype,
 
     if (IS_TYPE_MPZANY(xtype)) {
         if (IS_TYPE_MPZANY(ytype)) {
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), MPZ(y)));
             mpz_add(result->z, MPZ(x), MPZ(y));
             GMPY_MAYBE_END_ALLOW_THREADS(context);
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
 
         if (IS_TYPE_PyInteger(ytype)) {
-            int error;
-            long temp = PyLong_AsLongAndOverflow(y, &error);
+            long temp;
 
-            if (!error) {
+            if (GMPy_PyLong_AsSmall(y, &temp)) {
                 if (temp >= 0) {
                     mpz_add_ui(result->z, MPZ(x), temp);
                 }
@@ -66,20 +72,19 @@ GMPy_Integer_AddWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             }
             else {
                 mpz_set_PyLong(result->z, y);
-                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), result->z));
                 mpz_add(result->z, MPZ(x), result->z);
                 GMPY_MAYBE_END_ALLOW_THREADS(context);
             }
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
     }
 
     if (IS_TYPE_MPZANY(ytype)) {
         if (IS_TYPE_PyInteger(xtype)) {
-            int error;
-            long temp = PyLong_AsLongAndOverflow(x, &error);
+            long temp;
 
-            if (!error) {
+            if (GMPy_PyLong_AsSmall(x, &temp)) {
                 if (temp >= 0) {
                     mpz_add_ui(result->z, MPZ(y), temp);
                 }
@@ -89,11 +94,11 @@ GMPy_Integer_AddWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             }
             else {
                 mpz_set_PyLong(result->z, x);
-                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(result->z, MPZ(y)));
                 mpz_add(result->z, result->z, MPZ(y));
                 GMPY_MAYBE_END_ALLOW_THREADS(context);
             }
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
     }
 
@@ -110,12 +115,12 @@ GMPy_Integer_AddWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             /* LCOV_EXCL_STOP */
         }
 
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(tempx->z, tempy->z));
         mpz_add(result->z, tempx->z, tempy->z);
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_DECREF((PyObject*)tempx);
         Py_DECREF((PyObject*)tempy);
-        return (PyObject*)result;
+        return GMPy_MPZ_Small_Result(result);
     }
 
     /* LCOV_EXCL_START */
@@ -130,20 +135,48 @@ GMPy_Rational_AddWithType(PyObject *x, int xtype, PyObject *y, int ytype,
                           CTXT_Object *context)
 {
     MPQ_Object *result = NULL;
+    mp_size_t size = 1;
 
-    if (!(result = GMPy_MPQ_New(context))) {
+    /* Pick a cached object that is large enough for the result. */
+    if (IS_TYPE_MPQ(xtype) && IS_TYPE_MPQ(ytype))
+        size = MPQ_SIZE(MPQ(x)) + MPQ_SIZE(MPQ(y));
+
+    if (!(result = GMPy_MPQ_NewSize(size, context))) {
         /* LCOV_EXCL_START */
         return NULL;
         /* LCOV_EXCL_STOP */
     }
 
     if (IS_TYPE_MPQ(xtype) && IS_TYPE_MPQ(ytype)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(MPQ(x), MPQ(y)));
         mpq_add(result->q, MPQ(x), MPQ(y));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         return (PyObject*)result;
     }
 
+    /* Adding an integer n to a canonical p/q gives (p+n*q)/q, which is also
+     * canonical.
+     */
+
+    if (IS_TYPE_MPQ(xtype) || IS_TYPE_MPQ(ytype)) {
+        PyObject *q = IS_TYPE_MPQ(xtype) ? x : y;
+        PyObject *n = IS_TYPE_MPQ(xtype) ? y : x;
+        int ntype = IS_TYPE_MPQ(xtype) ? ytype : xtype;
+        long temp;
+
+        if (IS_TYPE_PyInteger(ntype) && GMPy_PyLong_AsSmall(n, &temp)) {
+            mpq_set(result->q, MPQ(q));
+            if (temp >= 0) {
+                mpz_addmul_ui(mpq_numref(result->q), mpq_denref(result->q), temp);
+            }
+            else {
+                mpz_submul_ui(mpq_numref(result->q), mpq_denref(result->q),
+                              -(unsigned long)temp);
+            }
+            return (PyObject*)result;
+        }
+    }
+
     if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype)) {
         MPQ_Object *tempx = NULL, *tempy = NULL;
 
@@ -157,7 +190,7 @@ GMPy_Rational_AddWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             /* LCOV_EXCL_STOP */
         }
 
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(tempx->q, tempy->q));
         mpq_add(result->q, tempx->q, tempy->q);
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_DECREF((PyObject*)tempx);
@@ -193,19 +226,38 @@ GMPy_Real_AddWithType(PyObject *x, int xtype, PyObject *y, int ytype,
 {
     MPFR_Object *result = NULL;
 
-    if (!(result = GMPy_MPFR_New(0, context))) {
+    if (!(result = GMPy_MPFR_Reuse(x, xtype, context)) &&
+        !(result = GMPy_MPFR_Reuse(y, ytype, context)) &&
+        !(result = GMPy_MPFR_New(0, context))) {
         /* LCOV_EXCL_START */
         return NULL;
         /* LCOV_EXCL_STOP */
     }
 
     if (IS_TYPE_MPFR(xtype) && IS_TYPE_MPFR(ytype)) {
+        if (_GMPy_MPFR_Fast(GMPY_FAST_ADD, &result, MPFR(x), MPFR(y), context))
+            return (PyObject*)result;
+
         mpfr_clear_flags();
         result->rc = mpfr_add(result->f, MPFR(x), MPFR(y), GET_MPFR_ROUND(context));
         _GMPy_MPFR_Cleanup(&result, context);
         return (PyObject*)result;
     }
 
+    if (IS_TYPE_MPFR(xtype) || IS_TYPE_MPFR(ytype)) {
+        PyObject *f = IS_TYPE_MPFR(xtype) ? x : y;
+        PyObject *n = IS_TYPE_MPFR(xtype) ? y : x;
+        int ntype = IS_TYPE_MPFR(xtype) ? ytype : xtype;
+        long temp;
+
+        if (IS_TYPE_PyInteger(ntype) && GMPy_PyLong_AsSmall(n, &temp)) {
+            mpfr_clear_flags();
+            result->rc = mpfr_add_si(result->f, MPFR(f), temp, GET_MPFR_ROUND(context));
+            _GMPy_MPFR_Cleanup(&result, context);
+            return (PyObject*)result;
+        }
+    }
+
     if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype)) {
         MPFR_Object *tempx = NULL, *tempy = NULL;
 
@@ -253,6 +305,9 @@ GMPy_Complex_AddWithType(PyObject *x, int xtype, PyObject *y, int ytype,
     }
 
     if (IS_TYPE_MPC(xtype) && IS_TYPE_MPC(ytype)) {
+        if (_GMPy_MPC_Fast(GMPY_FAST_ADD, &result, MPC(x), MPC(y), context))
+            return (PyObject*)result;
+
         result->rc = mpc_add(result->c, MPC(x), MPC(y), GET_MPC_ROUND(context));
         _GMPy_MPC_Cleanup(&result, context);
         return (PyObject*)result;
@@ -270,6 +325,11 @@ GMPy_Complex_AddWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             return NULL;
             /* LCOV_EXCL_STOP */
         }
+        if (_GMPy_MPC_Fast(GMPY_FAST_ADD, &result, tempx->c, tempy->c, context)) {
+            Py_DECREF((PyObject*)tempx);
+            Py_DECREF((PyObject*)tempy);
+            return (PyObject*)result;
+        }
         result->rc = mpc_add(result->c, tempx->c, tempy->c, GET_MPC_ROUND(context));
         Py_DECREF((PyObject*)tempx);
         Py_DECREF((PyObject*)tempy);
@@ -284,6 +344,15 @@ GMPy_Complex_AddWithType(PyObject *x, int xtype, PyObject *y, int ytype,
     /* LCOV_EXCL_STOP */
 }
 
+/* Indexed by GMPY_TYPE_CLASS2(xtype, ytype). */
+
+static gmpy_binary_withtype const GMPy_Add_Table[OBJ_CLASS_COUNT] = {
+    GMPy_Integer_AddWithType,
+    GMPy_Rational_AddWithType,
+    GMPy_Real_AddWithType,
+    GMPy_Complex_AddWithType,
+};
+
 /* Implement all the slot methods here. */
 
 static PyObject *
@@ -295,17 +364,10 @@ GMPy_Number_Add_Slot(PyObject *x, PyObject *y)
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_AddWithType(x, xtype, y, ytype, context);
-
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_AddWithType(x, xtype, y, ytype, context);
-
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_AddWithType(x, xtype, y, ytype, context);
+    GMPY_PROFILE_OP2(context, GMPY_OP_ADD, x, xtype, y, ytype);
 
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_AddWithType(x, xtype, y, ytype, context);
+    if (xtype && ytype)
+        return GMPy_Add_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, context);
 
     Py_RETURN_NOTIMPLEMENTED;
 }
@@ -313,8 +375,9 @@ GMPy_Number_Add_Slot(PyObject *x, PyObject *y)
 /* Implement context.add() and gmpy2.add(). */
 
 PyDoc_STRVAR(GMPy_doc_function_add,
-"add(x, y, /) -> mpz | mpq | mpfr | mpc\n\n"
-"Return x + y.");
+"add(x, y, /, *, out=None) -> mpz | mpq | mpfr | mpc | xmpz\n\n"
+"Return x + y. If out is an `xmpz`, x and y must be integers and the\n"
+"result is stored in out, which is returned.");
 
 static PyObject *
 GMPy_Number_Add(PyObject *x, PyObject *y, CTXT_Object *context)
@@ -322,32 +385,28 @@ GMPy_Number_Add(PyObject *x, PyObject *y, CTXT_Object *context)
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_AddWithType(x, xtype, y, ytype, context);
+    GMPY_PROFILE_OP2(context, GMPY_OP_ADD, x, xtype, y, ytype);
 
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_AddWithType(x, xtype, y, ytype, context);
-
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_AddWithType(x, xtype, y, ytype, context);
-
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_AddWithType(x, xtype, y, ytype, context);
+    if (xtype && ytype)
+        return GMPy_Add_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, context);
 
     TYPE_ERROR("add() argument type not supported");
     return NULL;
 }
 
 PyDoc_STRVAR(GMPy_doc_context_add,
-"context.add(x, y, /) -> mpz | mpq | mpfr | mpc\n\n"
-"Return x + y.");
+"context.add(x, y, /, *, out=None) -> mpz | mpq | mpfr | mpc | xmpz\n\n"
+"Return x + y. If out is an `xmpz`, x and y must be integers and the\n"
+"result is stored in out, which is returned.");
 
 static PyObject *
-GMPy_Context_Add(PyObject *self, PyObject *args)
+GMPy_Context_Add(PyObject *self, PyObject *const *args, Py_ssize_t nargs,
+                 PyObject *kwnames)
 {
     CTXT_Object *context = NULL;
+    XMPZ_Object *out;
 
-    if (PyTuple_GET_SIZE(args) != 2) {
+    if (nargs != 2) {
         TYPE_ERROR("add() requires 2 arguments");
         return NULL;
     }
@@ -359,7 +418,11 @@ GMPy_Context_Add(PyObject *self, PyObject *args)
         CHECK_CONTEXT(context);
     }
 
-    return GMPy_Number_Add(PyTuple_GET_ITEM(args, 0),
-                           PyTuple_GET_ITEM(args, 1),
-                           context);
+    if (GMPy_XMPZ_Out_Kwnames(args, nargs, kwnames, &out, "add") < 0)
+        return NULL;
+    if (out)
+        return GMPy_XMPZ_Out_Binop(out, args[0], args[1],
+                                   GMPY_OP_ADD, "add", context);
+
+    return GMPy_Number_Add(args[0], args[1], context);
 }
@@ -0,0 +1,826 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_alloc.c                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Memory functions for GMP, MPFR, and MPC. See gmpy2_alloc.h.
+ *
+ * The memory functions are called without the GIL (for example, during a
+ * long multiplication) so the counters and the arena chunks are protected
+ * by alloc_state.lock. tracemalloc acquires the GIL so it is only called
+ * when the lock is not held.
+ */
+
+#define ARENA_ALIGN 16
+#define ARENA_ROUND(n) (((n) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+#define ARENA_HEADER ARENA_ROUND(sizeof(gmpy_arena_chunk))
+#define ARENA_DATA(c) ((char*)(c) + ARENA_HEADER)
+#define ARENA_DEFAULT_CHUNK (1 << 20)
+
+/* PyMutex is much cheaper than a PyThread lock but requires Python 3.13. */
+
+#if PY_VERSION_HEX >= 0x030D0000
+#  define ALLOC_LOCK()   PyMutex_Lock(&alloc_state.lock)
+#  define ALLOC_UNLOCK() PyMutex_Unlock(&alloc_state.lock)
+#else
+#  define ALLOC_LOCK()   PyThread_acquire_lock(alloc_state.lock, WAIT_LOCK)
+#  define ALLOC_UNLOCK() PyThread_release_lock(alloc_state.lock)
+#endif
+
+static struct {
+    void *(*orig_alloc)(size_t);
+    void *(*orig_realloc)(void *, size_t, size_t);
+    void (*orig_free)(void *, size_t);
+    int tracked;                /* The gmpy2 memory functions are installed */
+#if PY_VERSION_HEX >= 0x030D0000
+    PyMutex lock;
+#else
+    PyThread_type_lock lock;
+#endif
+    size_t live;                /* Bytes currently allocated */
+    size_t peak;                /* Largest value of live */
+    Py_ssize_t allocations;     /* Allocations that have not been freed */
+    size_t arena;               /* Bytes reserved by arena chunks */
+    gmpy_arena_chunk *chunks;   /* All arena chunks that are in use */
+} alloc_state;
+
+/* The arena used by the running thread, if any. */
+
+static GMPY_THREAD_LOCAL Arena_Object *gmpy_current_arena = NULL;
+
+/* The following functions require alloc_state.lock. */
+
+static void
+_GMPy_Alloc_Count(size_t added, size_t removed)
+{
+    alloc_state.live += added;
+    alloc_state.live -= (removed < alloc_state.live) ? removed : alloc_state.live;
+    if (alloc_state.live > alloc_state.peak)
+        alloc_state.peak = alloc_state.live;
+}
+
+static gmpy_arena_chunk *
+_GMPy_Arena_Find(void *ptr)
+{
+    gmpy_arena_chunk *c;
+
+    for (c = alloc_state.chunks; c; c = c->next) {
+        if ((char*)ptr >= ARENA_DATA(c) && (char*)ptr < c->end)
+            return c;
+    }
+    return NULL;
+}
+
+/* Unlink a chunk and return it so it can be freed without the lock. */
+
+static gmpy_arena_chunk *
+_GMPy_Arena_Unlink(gmpy_arena_chunk *chunk)
+{
+    gmpy_arena_chunk **p;
+
+    for (p = &alloc_state.chunks; *p; p = &(*p)->next) {
+        if (*p == chunk) {
+            *p = chunk->next;
+            alloc_state.arena -= chunk->end - (char*)chunk;
+            return chunk;
+        }
+    }
+    return NULL;
+}
+
+/* The arena no longer allocates from chunk. Returns the chunk if it can be
+ * freed.
+ */
+
+static gmpy_arena_chunk *
+_GMPy_Arena_Retire(gmpy_arena_chunk *chunk)
+{
+    if (!chunk)
+        return NULL;
+    chunk->retired = 1;
+    return chunk->live ? NULL : _GMPy_Arena_Unlink(chunk);
+}
+
+/* Allocate size bytes from the arena. A new chunk is returned in *fresh and
+ * a chunk that can be freed is returned in *stale.
+ */
+
+static void *
+_GMPy_Arena_Alloc(Arena_Object *arena, size_t size, gmpy_arena_chunk *fresh,
+                  gmpy_arena_chunk **stale)
+{
+    gmpy_arena_chunk *c = arena->chunk;
+    size_t need = ARENA_ROUND(size ? size : 1);
+    char *ptr;
+
+    if (!c || (size_t)(c->end - c->top) < need) {
+        if (!fresh)
+            return NULL;
+        *stale = _GMPy_Arena_Retire(c);
+        c = fresh;
+        c->next = alloc_state.chunks;
+        alloc_state.chunks = c;
+        alloc_state.arena += c->end - (char*)c;
+        arena->chunk = c;
+    }
+    ptr = c->top;
+    c->top += need;
+    c->live++;
+    return ptr;
+}
+
+/* Release one allocation from an arena chunk. Returns the chunk if it can be
+ * freed.
+ */
+
+static gmpy_arena_chunk *
+_GMPy_Arena_Free(gmpy_arena_chunk *chunk)
+{
+    if (--(chunk->live))
+        return NULL;
+    if (chunk->retired)
+        return _GMPy_Arena_Unlink(chunk);
+    /* The chunk is still used by its arena so start again at the beginning. */
+    chunk->top = ARENA_DATA(chunk);
+    return NULL;
+}
+
+/* The following functions do not hold the lock. */
+
+static gmpy_arena_chunk *
+_GMPy_Arena_New_Chunk(Arena_Object *arena, size_t size)
+{
+    size_t total = ARENA_HEADER + Py_MAX(arena->chunk_size, ARENA_ROUND(size));
+    gmpy_arena_chunk *c = alloc_state.orig_alloc(total);
+
+    c->next = NULL;
+    c->owner = arena;
+    c->top = ARENA_DATA(c);
+    c->end = (char*)c + total;
+    c->live = 0;
+    c->retired = 0;
+    PyTraceMalloc_Track(GMPY_TRACEMALLOC_DOMAIN, (uintptr_t)c, total);
+    return c;
+}
+
+static void
+_GMPy_Arena_Free_Chunk(gmpy_arena_chunk *chunk)
+{
+    if (chunk) {
+        PyTraceMalloc_Untrack(GMPY_TRACEMALLOC_DOMAIN, (uintptr_t)chunk);
+        alloc_state.orig_free(chunk, chunk->end - (char*)chunk);
+    }
+}
+
+static void *
+_GMPy_Alloc_Allocate(size_t size)
+{
+    Arena_Object *arena = gmpy_current_arena;
+    gmpy_arena_chunk *fresh = NULL, *stale = NULL;
+    void *ptr;
+
+    if (arena) {
+        ALLOC_LOCK();
+        ptr = _GMPy_Arena_Alloc(arena, size, NULL, NULL);
+        if (!ptr) {
+            /* Allocate a new chunk without the lock. */
+            ALLOC_UNLOCK();
+            fresh = _GMPy_Arena_New_Chunk(arena, size);
+            ALLOC_LOCK();
+            ptr = _GMPy_Arena_Alloc(arena, size, fresh, &stale);
+            if (arena->chunk == fresh)
+                fresh = NULL;
+        }
+        alloc_state.allocations++;
+        _GMPy_Alloc_Count(size, 0);
+        ALLOC_UNLOCK();
+        _GMPy_Arena_Free_Chunk(stale);
+        /* A new chunk that was not needed. */
+        _GMPy_Arena_Free_Chunk(fresh);
+        return ptr;
+    }
+
+    ptr = alloc_state.orig_alloc(size);
+    PyTraceMalloc_Track(GMPY_TRACEMALLOC_DOMAIN, (uintptr_t)ptr, size);
+    ALLOC_LOCK();
+    alloc_state.allocations++;
+    _GMPy_Alloc_Count(size, 0);
+    ALLOC_UNLOCK();
+    return ptr;
+}
+
+static void
+_GMPy_Alloc_Free(void *ptr, size_t size)
+{
+    gmpy_arena_chunk *chunk = NULL, *stale = NULL;
+
+    ALLOC_LOCK();
+    if (alloc_state.chunks && (chunk = _GMPy_Arena_Find(ptr)))
+        stale = _GMPy_Arena_Free(chunk);
+    alloc_state.allocations--;
+    _GMPy_Alloc_Count(0, size);
+    ALLOC_UNLOCK();
+
+    if (chunk) {
+        _GMPy_Arena_Free_Chunk(stale);
+    }
+    else {
+        PyTraceMalloc_Untrack(GMPY_TRACEMALLOC_DOMAIN, (uintptr_t)ptr);
+        alloc_state.orig_free(ptr, size);
+    }
+}
+
+/* The memory functions installed in GMP. */
+
+static void *
+GMPy_Alloc_Allocate(size_t size)
+{
+    GMPY_GUARD_COUNT(allocations);
+    return _GMPy_Alloc_Allocate(size);
+}
+
+static void
+GMPy_Alloc_Free(void *ptr, size_t size)
+{
+    GMPY_GUARD_COUNT(frees);
+    _GMPy_Alloc_Free(ptr, size);
+}
+
+static void *
+GMPy_Alloc_Reallocate(void *ptr, size_t old_size, size_t new_size)
+{
+    Arena_Object *arena = gmpy_current_arena;
+    gmpy_arena_chunk *chunk = NULL;
+    void *result;
+
+    GMPY_GUARD_COUNT(reallocations);
+    if (trace_state.enabled)
+        _GMPy_Trace_Realloc(old_size, new_size);
+
+    ALLOC_LOCK();
+    if (alloc_state.chunks && (chunk = _GMPy_Arena_Find(ptr))) {
+        /* Grow or shrink the most recent allocation of the arena in place. */
+        if (arena && arena->chunk == chunk &&
+            (char*)ptr + ARENA_ROUND(old_size) == chunk->top &&
+            (size_t)(chunk->end - (char*)ptr) >= ARENA_ROUND(new_size)) {
+            chunk->top = (char*)ptr + ARENA_ROUND(new_size ? new_size : 1);
+            _GMPy_Alloc_Count(new_size, old_size);
+            ALLOC_UNLOCK();
+            return ptr;
+        }
+        if (new_size <= ARENA_ROUND(old_size)) {
+            _GMPy_Alloc_Count(new_size, old_size);
+            ALLOC_UNLOCK();
+            return ptr;
+        }
+    }
+    ALLOC_UNLOCK();
+
+    if (chunk) {
+        /* Move the allocation out of the chunk. */
+        result = _GMPy_Alloc_Allocate(new_size);
+        memcpy(result, ptr, old_size);
+        _GMPy_Alloc_Free(ptr, old_size);
+        return result;
+    }
+
+    PyTraceMalloc_Untrack(GMPY_TRACEMALLOC_DOMAIN, (uintptr_t)ptr);
+    result = alloc_state.orig_realloc(ptr, old_size, new_size);
+    PyTraceMalloc_Track(GMPY_TRACEMALLOC_DOMAIN, (uintptr_t)result, new_size);
+    ALLOC_LOCK();
+    _GMPy_Alloc_Count(new_size, old_size);
+    ALLOC_UNLOCK();
+    return result;
+}
+
+static void
+_GMPy_Alloc_Install(void)
+{
+    if (alloc_state.tracked)
+        return;
+
+    mp_get_memory_functions(&alloc_state.orig_alloc, &alloc_state.orig_realloc,
+                            &alloc_state.orig_free);
+    mp_set_memory_functions(GMPy_Alloc_Allocate, GMPy_Alloc_Reallocate,
+                            GMPy_Alloc_Free);
+    alloc_state.tracked = 1;
+}
+
+/* Called when the module is initialized. The memory functions are installed
+ * at once if the environment variable GMPY2_ALLOCATOR is set to "tracked".
+ */
+
+static int
+GMPy_Alloc_Init(void)
+{
+    const char *mode;
+
+#if PY_VERSION_HEX < 0x030D0000
+    if (!alloc_state.lock && !(alloc_state.lock = PyThread_allocate_lock())) {
+        PyErr_NoMemory();
+        return -1;
+    }
+#endif
+
+    mode = getenv("GMPY2_ALLOCATOR");
+    if (mode && !strcmp(mode, "tracked"))
+        _GMPy_Alloc_Install();
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_set_allocator,
+"set_allocator(mode, /) -> None\n\n"
+"Select the memory functions used by GMP, MPFR, and MPC. If mode is\n"
+"'default', the memory functions provided by GMP are used. If mode is\n"
+"'tracked', each allocation is passed on to the default functions, the\n"
+"live and peak bytes are counted (see allocator_info()), and the\n"
+"allocations are reported to tracemalloc. 'tracked' can also be selected\n"
+"at import by setting the environment variable GMPY2_ALLOCATOR=tracked.\n"
+"Memory allocated before tracking started is not counted.");
+
+static PyObject *
+GMPy_Set_Allocator(PyObject *self, PyObject *args)
+{
+    const char *mode;
+    void *(*alloc_func)(size_t);
+    void *(*realloc_func)(void *, size_t, size_t);
+    void (*free_func)(void *, size_t);
+
+    if (!PyArg_ParseTuple(args, "s", &mode))
+        return NULL;
+
+    if (!strcmp(mode, "tracked")) {
+        _GMPy_Alloc_Install();
+        Py_RETURN_NONE;
+    }
+
+    if (strcmp(mode, "default")) {
+        VALUE_ERROR("mode must be 'default' or 'tracked'");
+        return NULL;
+    }
+
+    if (!alloc_state.tracked)
+        Py_RETURN_NONE;
+
+    if (alloc_state.chunks || gmpy_current_arena) {
+        RUNTIME_ERROR("memory allocated by an arena is still in use");
+        return NULL;
+    }
+
+    if (gmpy_current_guard) {
+        RUNTIME_ERROR("an allocation_guard is active");
+        return NULL;
+    }
+
+    mp_get_memory_functions(&alloc_func, &realloc_func, &free_func);
+    if (alloc_func != GMPy_Alloc_Allocate) {
+        RUNTIME_ERROR("the memory functions were changed by another module");
+        return NULL;
+    }
+
+    mp_set_memory_functions(alloc_state.orig_alloc, alloc_state.orig_realloc,
+                            alloc_state.orig_free);
+    ALLOC_LOCK();
+    alloc_state.tracked = 0;
+    alloc_state.live = alloc_state.peak = 0;
+    alloc_state.allocations = 0;
+    ALLOC_UNLOCK();
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_allocator_info,
+"allocator_info(reset_peak=False) -> dict\n\n"
+"Return a dictionary describing the memory used by GMP, MPFR, and MPC.\n"
+"The counts are only maintained when the mode is 'tracked'.\n\n"
+"    mode:        'default' or 'tracked' (see set_allocator())\n"
+"    live:        bytes currently allocated\n"
+"    peak:        largest number of bytes allocated at one time\n"
+"    allocations: number of allocations that have not been freed\n"
+"    arena:       bytes reserved by arena chunks\n"
+"    domain:      tracemalloc domain used for the allocations\n\n"
+"If reset_peak is True, the peak is set to the current live bytes\n"
+"after the dictionary is created.");
+
+static PyObject *
+GMPy_Allocator_Info(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    int reset_peak = 0;
+    size_t live, peak, arena;
+    Py_ssize_t allocations;
+    static char *kwlist[] = {"reset_peak", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|p", kwlist, &reset_peak))
+        return NULL;
+
+    ALLOC_LOCK();
+    live = alloc_state.live;
+    peak = alloc_state.peak;
+    arena = alloc_state.arena;
+    allocations = alloc_state.allocations;
+    if (reset_peak)
+        alloc_state.peak = alloc_state.live;
+    ALLOC_UNLOCK();
+
+    return Py_BuildValue("{s:s,s:n,s:n,s:n,s:n,s:I}",
+                         "mode", alloc_state.tracked ? "tracked" : "default",
+                         "live", (Py_ssize_t)live,
+                         "peak", (Py_ssize_t)peak,
+                         "allocations", allocations,
+                         "arena", (Py_ssize_t)arena,
+                         "domain", (unsigned int)GMPY_TRACEMALLOC_DOMAIN);
+}
+
+PyDoc_STRVAR(GMPy_doc_memory_info,
+"memory_info(reset_peak=False) -> dict\n\n"
+"Return a dictionary describing the memory held by gmpy2 objects. For\n"
+"each of 'mpz', 'xmpz', 'mpq', 'mpfr', and 'mpc', a dictionary is\n"
+"returned with the following keys:\n\n"
+"    live:         number of objects in use\n"
+"    peak:         largest number of objects in use at one time\n"
+"    cached:       number of objects kept in the cache\n"
+"    cached_bytes: bytes of limb storage held by the cached objects\n\n"
+"The key 'gmp' gives the bytes allocated by GMP, MPFR, and MPC for all\n"
+"objects and temporaries, as 'live' and 'peak'; these are None unless\n"
+"the allocator mode is 'tracked' (see set_allocator()). If reset_peak\n"
+"is True, the peaks are set to the current values after the dictionary\n"
+"is created. If the GIL is disabled, the counts cover the shared pool,\n"
+"the current thread, and threads that have exited.");
+
+static PyObject *
+GMPy_Memory_Info(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *result, *info;
+    gmpy_cache *cache = GMPY_CACHE;
+    Py_ssize_t live, peak, cached;
+    size_t bytes, gmp_live, gmp_peak;
+    int i, reset_peak = 0;
+    static char *kwlist[] = {"reset_peak", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|p", kwlist, &reset_peak))
+        return NULL;
+
+    if (!(result = PyDict_New()))
+        return NULL;
+
+    for (i = 0; i < GMPY_CACHE_TYPES; i++) {
+#ifdef Py_GIL_DISABLED
+        PyMutex_Lock(&global.cache_lock);
+        live = global.cache.stats[i].live;
+        peak = global.cache.stats[i].peak;
+        cached = _GMPy_Cache_Count(&global.cache, i);
+        bytes = _GMPy_Cache_Bytes(&global.cache, i);
+        if (reset_peak)
+            global.cache.stats[i].peak = global.cache.stats[i].live;
+        PyMutex_Unlock(&global.cache_lock);
+        if (cache) {
+            live += cache->stats[i].live;
+            peak += cache->stats[i].peak;
+            cached += _GMPy_Cache_Count(cache, i);
+            bytes += _GMPy_Cache_Bytes(cache, i);
+            if (reset_peak)
+                cache->stats[i].peak = cache->stats[i].live;
+        }
+#else
+        live = cache->stats[i].live;
+        peak = cache->stats[i].peak;
+        cached = _GMPy_Cache_Count(cache, i);
+        bytes = _GMPy_Cache_Bytes(cache, i);
+        if (reset_peak)
+            cache->stats[i].peak = cache->stats[i].live;
+#endif
+        info = Py_BuildValue("{s:n,s:n,s:n,s:n}",
+                             "live", live,
+                             "peak", peak,
+                             "cached", cached,
+                             "cached_bytes", (Py_ssize_t)bytes);
+        if (!info || PyDict_SetItemString(result, gmpy_cache_names[i], info) < 0) {
+            Py_XDECREF(info);
+            Py_DECREF(result);
+            return NULL;
+        }
+        Py_DECREF(info);
+    }
+
+    if (alloc_state.tracked) {
+        ALLOC_LOCK();
+        gmp_live = alloc_state.live;
+        gmp_peak = alloc_state.peak;
+        if (reset_peak)
+            alloc_state.peak = alloc_state.live;
+        ALLOC_UNLOCK();
+        info = Py_BuildValue("{s:n,s:n}", "live", (Py_ssize_t)gmp_live,
+                             "peak", (Py_ssize_t)gmp_peak);
+    }
+    else {
+        info = Py_BuildValue("{s:O,s:O}", "live", Py_None, "peak", Py_None);
+    }
+    if (!info || PyDict_SetItemString(result, "gmp", info) < 0) {
+        Py_XDECREF(info);
+        Py_DECREF(result);
+        return NULL;
+    }
+    Py_DECREF(info);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_arena_factory,
+"arena(chunk_size=1048576) -> arena\n\n"
+"Return a context manager that serves the memory allocated by GMP, MPFR,\n"
+"and MPC in the current thread from chunks of chunk_size bytes. Memory is\n"
+"reserved by moving a pointer, so many short-lived results can be\n"
+"computed quickly. A chunk is freed as soon as the arena has been exited\n"
+"and every allocation it holds has been freed; results that outlive the\n"
+"arena remain valid. Objects freed after the arena has been exited may be\n"
+"kept by the object caches (see set_cache()) and keep their chunk alive\n"
+"until they are reused. The allocator mode is set to 'tracked' if\n"
+"necessary.");
+
+static PyObject *
+GMPy_Arena_Factory(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    Arena_Object *result;
+    Py_ssize_t chunk_size = ARENA_DEFAULT_CHUNK;
+    static char *kwlist[] = {"chunk_size", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|n", kwlist, &chunk_size))
+        return NULL;
+
+    if (chunk_size < 1024) {
+        VALUE_ERROR("chunk_size must be at least 1024");
+        return NULL;
+    }
+
+    if ((result = PyObject_New(Arena_Object, &Arena_Type))) {
+        result->chunk_size = (size_t)chunk_size;
+        result->chunk = NULL;
+        result->prev = NULL;
+        result->active = 0;
+        result->thread = 0;
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_Arena_Enter(PyObject *self, PyObject *args)
+{
+    Arena_Object *arena = (Arena_Object*)self;
+
+    if (arena->active) {
+        RUNTIME_ERROR("arena is already active");
+        return NULL;
+    }
+
+    _GMPy_Alloc_Install();
+    arena->prev = gmpy_current_arena;
+    arena->thread = PyThread_get_thread_ident();
+    arena->active = 1;
+    /* The thread holds a reference while the arena is active. */
+    Py_INCREF(self);
+    gmpy_current_arena = arena;
+    Py_INCREF(self);
+    return self;
+}
+
+typedef struct {
+    char *start;
+    char *end;
+} gmpy_arena_range;
+
+typedef struct {
+    Py_ssize_t count;
+    gmpy_arena_range *ranges;
+} gmpy_arena_used;
+
+static int
+_GMPy_Arena_Outside(void *ptr, void *arg)
+{
+    gmpy_arena_used *used = (gmpy_arena_used*)arg;
+
+    for (Py_ssize_t i = 0; i < used->count; i++) {
+        if ((char*)ptr >= used->ranges[i].start && (char*)ptr < used->ranges[i].end)
+            return 0;
+    }
+    return 1;
+}
+
+static PyObject *
+GMPy_Arena_Exit(PyObject *self, PyObject *args)
+{
+    Arena_Object *arena = (Arena_Object*)self;
+    gmpy_arena_chunk *stale, *c;
+    gmpy_arena_used used = {0, NULL};
+
+    if (!arena->active || gmpy_current_arena != arena ||
+        arena->thread != PyThread_get_thread_ident()) {
+        RUNTIME_ERROR("arena must be exited by the thread that entered it, "
+                      "in the reverse order");
+        return NULL;
+    }
+
+    ALLOC_LOCK();
+    stale = _GMPy_Arena_Retire(arena->chunk);
+    arena->chunk = NULL;
+    /* Find the chunks of the arena that are still in use. */
+    for (c = alloc_state.chunks; c; c = c->next) {
+        if (c->owner == arena)
+            used.count++;
+    }
+    if (used.count &&
+        (used.ranges = PyMem_RawMalloc(used.count * sizeof(gmpy_arena_range)))) {
+        used.count = 0;
+        for (c = alloc_state.chunks; c; c = c->next) {
+            if (c->owner == arena) {
+                used.ranges[used.count].start = ARENA_DATA(c);
+                used.ranges[used.count++].end = c->end;
+                c->owner = NULL;
+            }
+        }
+    }
+    ALLOC_UNLOCK();
+    _GMPy_Arena_Free_Chunk(stale);
+
+    /* Objects in the caches and the scratch pool would keep the chunks
+     * alive. The chunks can't be freed while they are used by the caches so
+     * the ranges remain valid. */
+    if (used.ranges) {
+        _GMPy_Cache_Drop(_GMPy_Arena_Outside, &used);
+        _GMPy_Scratch_Drop(_GMPy_Arena_Outside, &used);
+        PyMem_RawFree(used.ranges);
+    }
+
+    gmpy_current_arena = arena->prev;
+    arena->prev = NULL;
+    arena->active = 0;
+    Py_DECREF(self);
+    Py_RETURN_FALSE;
+}
+
+static void
+GMPy_Arena_Dealloc(Arena_Object *self)
+{
+    PyObject_Del(self);
+}
+
+static PyMethodDef GMPy_Arena_methods[] =
+{
+    { "__enter__", GMPy_Arena_Enter, METH_NOARGS, NULL },
+    { "__exit__", GMPy_Arena_Exit, METH_VARARGS, NULL },
+    { NULL, NULL, 1 }
+};
+
+static PyTypeObject Arena_Type =
+{
+    PyVarObject_HEAD_INIT(0, 0)
+    .tp_name = "gmpy2.arena",
+    .tp_basicsize = sizeof(Arena_Object),
+    .tp_dealloc = (destructor) GMPy_Arena_Dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "GMPY2 memory arena",
+    .tp_methods = GMPy_Arena_methods,
+};
+
+PyDoc_STRVAR(GMPy_doc_allocation_guard,
+"allocation_guard() -> allocation_guard\n\n"
+"Return a context manager that counts, in the current thread, the calls\n"
+"to the memory functions of GMP, MPFR, and MPC and the gmpy2 objects that\n"
+"could not be taken from the object caches. The counts are available as\n"
+"the attributes allocations, reallocations, frees, and cache_misses, both\n"
+"inside the block and after it has been exited, so a test can assert\n"
+"that a loop runs without allocating. Calls made by helper threads (see\n"
+"set_num_threads()) are not counted. The counts of a nested guard are\n"
+"added to the enclosing guard when it is exited. The allocator mode is\n"
+"set to 'tracked' if necessary.");
+
+static PyObject *
+GMPy_Allocation_Guard(PyObject *self, PyObject *args)
+{
+    AllocGuard_Object *result;
+
+    if ((result = PyObject_New(AllocGuard_Object, &AllocGuard_Type))) {
+        result->allocations = 0;
+        result->reallocations = 0;
+        result->frees = 0;
+        result->cache_misses = 0;
+        result->prev = NULL;
+        result->active = 0;
+        result->thread = 0;
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_AllocGuard_Enter(PyObject *self, PyObject *args)
+{
+    AllocGuard_Object *guard = (AllocGuard_Object*)self;
+
+    if (guard->active) {
+        RUNTIME_ERROR("allocation_guard is already active");
+        return NULL;
+    }
+
+    _GMPy_Alloc_Install();
+    guard->allocations = guard->reallocations = guard->frees = 0;
+    guard->cache_misses = 0;
+    guard->prev = gmpy_current_guard;
+    guard->thread = PyThread_get_thread_ident();
+    guard->active = 1;
+    /* The thread holds a reference while the guard is active. */
+    Py_INCREF(self);
+    gmpy_current_guard = guard;
+    Py_INCREF(self);
+    return self;
+}
+
+static PyObject *
+GMPy_AllocGuard_Exit(PyObject *self, PyObject *args)
+{
+    AllocGuard_Object *guard = (AllocGuard_Object*)self, *prev;
+
+    if (!guard->active || gmpy_current_guard != guard ||
+        guard->thread != PyThread_get_thread_ident()) {
+        RUNTIME_ERROR("allocation_guard must be exited by the thread that "
+                      "entered it, in the reverse order");
+        return NULL;
+    }
+
+    gmpy_current_guard = prev = guard->prev;
+    if (prev) {
+        prev->allocations += guard->allocations;
+        prev->reallocations += guard->reallocations;
+        prev->frees += guard->frees;
+        prev->cache_misses += guard->cache_misses;
+    }
+    guard->prev = NULL;
+    guard->active = 0;
+    Py_DECREF(self);
+    Py_RETURN_FALSE;
+}
+
+static PyObject *
+GMPy_AllocGuard_Repr(AllocGuard_Object *self)
+{
+    return PyUnicode_FromFormat("<allocation_guard allocations=%zd "
+                                "reallocations=%zd frees=%zd cache_misses=%zd>",
+                                self->allocations, self->reallocations,
+                                self->frees, self->cache_misses);
+}
+
+static void
+GMPy_AllocGuard_Dealloc(AllocGuard_Object *self)
+{
+    PyObject_Del(self);
+}
+
+static PyMemberDef GMPy_AllocGuard_members[] =
+{
+    { "allocations", T_PYSSIZET, offsetof(AllocGuard_Object, allocations), READONLY,
+      "number of calls to the allocate function" },
+    { "reallocations", T_PYSSIZET, offsetof(AllocGuard_Object, reallocations), READONLY,
+      "number of calls to the reallocate function" },
+    { "frees", T_PYSSIZET, offsetof(AllocGuard_Object, frees), READONLY,
+      "number of calls to the free function" },
+    { "cache_misses", T_PYSSIZET, offsetof(AllocGuard_Object, cache_misses), READONLY,
+      "number of objects that were not taken from a cache" },
+    { NULL }
+};
+
+static PyMethodDef GMPy_AllocGuard_methods[] =
+{
+    { "__enter__", GMPy_AllocGuard_Enter, METH_NOARGS, NULL },
+    { "__exit__", GMPy_AllocGuard_Exit, METH_VARARGS, NULL },
+    { NULL, NULL, 1 }
+};
+
+static PyTypeObject AllocGuard_Type =
+{
+    PyVarObject_HEAD_INIT(0, 0)
+    .tp_name = "gmpy2.allocation_guard",
+    .tp_basicsize = sizeof(AllocGuard_Object),
+    .tp_dealloc = (destructor) GMPy_AllocGuard_Dealloc,
+    .tp_repr = (reprfunc) GMPy_AllocGuard_Repr,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "GMPY2 allocation guard",
+    .tp_methods = GMPy_AllocGuard_methods,
+    .tp_members = GMPy_AllocGuard_members,
+};
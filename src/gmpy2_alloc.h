@@ -0,0 +1,111 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_alloc.h                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_ALLOC_H
+#define GMPY_ALLOC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Memory functions used by GMP, MPFR, and MPC.
+ *
+ * By default gmpy2 leaves the memory functions of GMP unchanged. In
+ * "tracked" mode, gmpy2 installs memory functions that pass each request
+ * on to the functions that were previously installed while counting the
+ * live and peak bytes, and reporting the allocations to tracemalloc. An
+ * arena can then be used to serve the allocations made by a thread from
+ * large chunks of memory.
+ */
+
+/* tracemalloc domain used for the allocations made by GMP. */
+
+#define GMPY_TRACEMALLOC_DOMAIN 0x676d70
+
+struct Arena_Object;
+
+typedef struct gmpy_arena_chunk {
+    struct gmpy_arena_chunk *next;
+    struct Arena_Object *owner; /* Arena that allocated the chunk */
+    char *top;                  /* Next free byte */
+    char *end;                  /* End of the chunk */
+    Py_ssize_t live;            /* Allocations that have not been freed */
+    int retired;                /* No longer used for new allocations */
+    /* Followed by the storage for the allocations. */
+} gmpy_arena_chunk;
+
+typedef struct Arena_Object {
+    PyObject_HEAD
+    size_t chunk_size;          /* Size of each chunk */
+    gmpy_arena_chunk *chunk;    /* Chunk used for new allocations */
+    struct Arena_Object *prev;  /* Arena active when this one was entered */
+    int active;
+    unsigned long thread;       /* Thread that entered the arena */
+} Arena_Object;
+
+static PyTypeObject Arena_Type;
+#define Arena_Check(v) (((PyObject*)v)->ob_type == &Arena_Type)
+
+/* An allocation guard counts the calls to the memory functions and the
+ * objects that could not be taken from the caches while it is active in a
+ * thread. It is meant for tests that check that a loop doesn't allocate.
+ */
+
+typedef struct AllocGuard_Object {
+    PyObject_HEAD
+    Py_ssize_t allocations;     /* Calls to the allocate function */
+    Py_ssize_t reallocations;   /* Calls to the reallocate function */
+    Py_ssize_t frees;           /* Calls to the free function */
+    Py_ssize_t cache_misses;    /* Objects not taken from a cache */
+    struct AllocGuard_Object *prev; /* Guard active when this one was entered */
+    int active;
+    unsigned long thread;       /* Thread that entered the guard */
+} AllocGuard_Object;
+
+static PyTypeObject AllocGuard_Type;
+
+/* The guard used by the running thread, if any. */
+
+static GMPY_THREAD_LOCAL AllocGuard_Object *gmpy_current_guard = NULL;
+
+#define GMPY_GUARD_COUNT(FIELD) \
+    do { \
+        if (gmpy_current_guard) \
+            gmpy_current_guard->FIELD++; \
+    } while (0)
+
+static int        GMPy_Alloc_Init(void);
+
+static PyObject * GMPy_Set_Allocator(PyObject *self, PyObject *args);
+static PyObject * GMPy_Allocator_Info(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Memory_Info(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Arena_Factory(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Allocation_Guard(PyObject *self, PyObject *args);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -237,6 +237,8 @@ GMPy_MPFR_From_Old_Binary(PyObject *self, PyObject *other)
  *              3 => mpq  (see Pympq_To_Binary)
  *              4 => mpfr (see Pympfr_To_Binary)
  *              5 => mpc  (see Pympc_To_Binary)
+ *              6 => mpz_array (see gmpy2_mpz_array.c)
+ *              7 => compact mpz (see below)
  * byte[1:0-1]: 0 => value is 0
  *              1 => value is > 0
  *              2 => value is < 0
@@ -244,68 +246,125 @@ GMPy_MPFR_From_Old_Binary(PyObject *self, PyObject *other)
  * byte[2]+: value
  */
 
-static PyObject *
-GMPy_MPZ_To_Binary(MPZ_Object *self)
+/* Return the length of the binary representation of an mpz/xmpz value. */
+
+static size_t
+_GMPy_Binary_MPZ_Size(mpz_srcptr z)
 {
-    size_t size = 2;
-    int sgn;
-    char *buffer;
-    PyObject *result;
+    if (mpz_sgn(z) == 0)
+        return 2;
+    return ((mpz_sizeinbase(z, 2) + 7) / 8) + 2;
+}
 
-    sgn = mpz_sgn(self->z);
+/* Write the binary representation of z, with type code 0x01 (mpz) or 0x02
+ * (xmpz), to buffer. buffer must hold _GMPy_Binary_MPZ_Size(z) bytes. The
+ * Python API is not used.
+ */
+
+static void
+_GMPy_Binary_MPZ_Put(char *buffer, mpz_srcptr z, char code)
+{
+    int sgn = mpz_sgn(z);
+
+    buffer[0] = code;
     if (sgn == 0) {
-        TEMP_ALLOC(buffer, size);
-        buffer[0] = 0x01;
         buffer[1] = 0x00;
-        goto done;
+        return;
     }
+    buffer[1] = sgn > 0 ? 0x01 : 0x02;
+    mpz_export(buffer+2, NULL, -1, sizeof(char), 0, 0, z);
+}
 
-    size = ((mpz_sizeinbase(self->z, 2) + 7) / 8) + 2;
-
-    TEMP_ALLOC(buffer, size);
-    buffer[0] = 0x01;
-    if (sgn > 0)
-        buffer[1] = 0x01;
-    else
-        buffer[1] = 0x02;
-    mpz_export(buffer+2, NULL, -1, sizeof(char), 0, 0, self->z);
+static PyObject *
+GMPy_MPZ_To_Binary(MPZ_Object *self)
+{
+    PyObject *result;
 
-  done:
-    result = PyBytes_FromStringAndSize(buffer, size);
-    TEMP_FREE(buffer, size);
+    if ((result = PyBytes_FromStringAndSize(NULL, _GMPy_Binary_MPZ_Size(self->z))))
+        _GMPy_Binary_MPZ_Put(PyBytes_AS_STRING(result), self->z, 0x01);
     return result;
 }
 
 static PyObject *
 GMPy_XMPZ_To_Binary(XMPZ_Object *self)
 {
-    size_t size = 2;
-    int sgn;
-    char *buffer;
     PyObject *result;
 
-    sgn = mpz_sgn(self->z);
-    if (sgn == 0) {
-        TEMP_ALLOC(buffer, size);
-        buffer[0] = 0x02;
-        buffer[1] = 0x00;
-        goto done;
-    }
+    if ((result = PyBytes_FromStringAndSize(NULL, _GMPy_Binary_MPZ_Size(self->z))))
+        _GMPy_Binary_MPZ_Put(PyBytes_AS_STRING(result), self->z, 0x02);
+    return result;
+}
 
-    size = ((mpz_sizeinbase(self->z, 2) + 7) / 8) + 2;
+/* Format of the compact binary representation of an mpz.
+ *
+ * byte[0]:     7 => compact mpz
+ * byte[1]+:    value as a zig-zag encoded varint: n >= 0 is stored as 2*n
+ *              and n < 0 as 2*|n| - 1, 7 bits per byte starting with the
+ *              least significant bits. The high bit of each byte is set
+ *              if another byte follows.
+ *
+ * Only values with |n| < 2**63 are stored this way; larger values use the
+ * layout above.
+ */
 
-    TEMP_ALLOC(buffer, size);
-    buffer[0] = 0x02;
-    if (sgn > 0)
-        buffer[1] = 0x01;
-    else
-        buffer[1] = 0x02;
-    mpz_export(buffer+2, NULL, -1, sizeof(char), 0, 0, self->z);
+#define GMPY_COMPACT_MAX 11
 
-  done:
-    result = PyBytes_FromStringAndSize(buffer, size);
-    TEMP_FREE(buffer, size);
-    return result;
+static int
+_GMPy_Binary_MPZ_Compact_Fits(mpz_srcptr z)
+{
+    return mpz_sgn(z) == 0 || mpz_sizeinbase(z, 2) < 64;
+}
+
+/* Write the compact representation of z to buffer, which must hold
+ * GMPY_COMPACT_MAX bytes, and return its length.
+ */
+
+static size_t
+_GMPy_Binary_MPZ_Compact_Put(unsigned char *buffer, mpz_srcptr z)
+{
+    uint64_t u = 0;
+    size_t len = 1;
+
+    if (mpz_sgn(z) != 0) {
+        mpz_export(&u, NULL, -1, sizeof(uint64_t), 0, 0, z);
+        u = mpz_sgn(z) > 0 ? u << 1 : (u << 1) - 1;
+    }
+    buffer[0] = 0x07;
+    while (u >= 0x80) {
+        buffer[len++] = (unsigned char)(u | 0x80);
+        u >>= 7;
+    }
+    buffer[len++] = (unsigned char)u;
+    return len;
+}
+
+/* Decode the compact representation in buffer into z, or only validate it
+ * if z is NULL. Return -1 if buffer does not hold exactly one valid varint.
+ * The Python API is not used.
+ */
+
+static int
+_GMPy_Binary_MPZ_Compact_Get(mpz_ptr z, const unsigned char *buffer, size_t len)
+{
+    uint64_t u = 0, mag;
+    size_t i;
+
+    if (len < 2 || len > GMPY_COMPACT_MAX)
+        return -1;
+    for (i = 1; i < len; i++) {
+        if ((buffer[i] & 0x80) != (i < len - 1 ? 0x80 : 0x00))
+            return -1;
+        if (i == GMPY_COMPACT_MAX - 1 && buffer[i] > 0x01)
+            return -1;
+        u |= (uint64_t)(buffer[i] & 0x7f) << (7 * (i - 1));
+    }
+    if (!z)
+        return 0;
+    mag = (u >> 1) + (u & 1);
+    mpz_import(z, 1, -1, sizeof(uint64_t), 0, 0, &mag);
+    if (u & 1)
+        mpz_neg(z, z);
+    return 0;
 }
 
 /* Format of the binary representation of an mpq.
@@ -315,6 +374,7 @@ GMPy_XMPZ_To_Binary(XMPZ_Object *self)
  *              3 => mpq
  *              4 => mpfr (see Pympfr_To_Binary)
  *              5 => mpc  (see Pympc_To_Binary)
+ *              6 => mpz_array (see gmpy2_mpz_array.c)
  * byte[1:0-1]: 0 => value is 0
  *              1 => value is > 0
  *              2 => value is < 0
@@ -407,6 +467,7 @@ GMPy_MPQ_To_Binary(MPQ_Object *self)
  *               3 => mpq  (see Pympq_To_Binary)
  *               4 => mpfr
  *               5 => mpc  (see Pympc_To_Binary)
+ *               6 => mpz_array (see gmpy2_mpz_array.c)
  * byte[1:0]:    0 => value is "special"
  *               1 => value is an actual number
  * byte[1:1]:    0 => signbit is clear
@@ -658,23 +719,42 @@ PyDoc_STRVAR(doc_from_binary,
 static PyObject *
 GMPy_MPANY_From_Binary(PyObject *self, PyObject *other)
 {
-    unsigned char *buffer, *cp;
-    Py_ssize_t len;
+    PyObject *result;
+    Py_buffer view;
     CTXT_Object *context = NULL;
 
     CHECK_CONTEXT(context);
 
-    if (!(PyBytes_Check(other))) {
+    if (PyBytes_Check(other)) {
+        return _GMPy_MPANY_From_Buffer((unsigned char*)PyBytes_AS_STRING(other),
+                                       PyBytes_GET_SIZE(other), context);
+    }
+
+    /* Other bytes-like objects are accepted so that an unpickler can pass
+     * an out-of-band buffer (pickle protocol 5) without copying it.
+     */
+
+    if (!PyObject_CheckBuffer(other) ||
+        PyObject_GetBuffer(other, &view, PyBUF_SIMPLE) < 0) {
+        PyErr_Clear();
         TYPE_ERROR("from_binary() requires bytes argument");
         return NULL;
     }
+    result = _GMPy_MPANY_From_Buffer((unsigned char*)view.buf, view.len, context);
+    PyBuffer_Release(&view);
+    return result;
+}
+
+static PyObject *
+_GMPy_MPANY_From_Buffer(unsigned char *buffer, Py_ssize_t len,
+                        CTXT_Object *context)
+{
+    unsigned char *cp;
 
-    len = PyBytes_Size(other);
     if (len < 2) {
         VALUE_ERROR("byte sequence too short for from_binary()");
         return NULL;
     }
-    buffer = (unsigned char*)PyBytes_AsString(other);
     cp = buffer;
 
     switch (cp[0]) {
@@ -1200,6 +1280,28 @@ GMPy_MPANY_From_Binary(PyObject *self, PyObject *other)
             Py_DECREF((PyObject*)imag);
             return (PyObject*)result;
         }
+        case 0x06: {
+            return GMPy_MPZ_Array_From_Binary(cp, len);
+        }
+        case 0x08:
+        case 0x09: {
+            return GMPy_MPFR_Array_From_Binary(cp, len);
+        }
+        case 0x07: {
+            MPZ_Object *result;
+
+            if (!(result = GMPy_MPZ_New(NULL))) {
+                /* LCOV_EXCL_START */
+                return NULL;
+                /* LCOV_EXCL_STOP */
+            }
+            if (_GMPy_Binary_MPZ_Compact_Get(result->z, cp, (size_t)len) < 0) {
+                Py_DECREF((PyObject*)result);
+                VALUE_ERROR("byte sequence invalid for from_binary()");
+                return NULL;
+            }
+            return (PyObject*)result;
+        }
         default: {
             TYPE_ERROR("from_binary() argument type not supported");
             return NULL;
@@ -1208,16 +1310,37 @@ GMPy_MPANY_From_Binary(PyObject *self, PyObject *other)
 }
 
 PyDoc_STRVAR(doc_to_binary,
-"to_binary(x, /) -> bytes\n\n"
+"to_binary(x, /, *, compact=False) -> bytes\n\n"
 "Return a Python byte sequence that is a portable binary\n"
 "representation of a gmpy2 object x. The byte sequence can\n"
 "be passed to `from_binary()` to obtain an exact copy of\n"
-"x's value.  Raises a `TypeError` if x is not a gmpy2 object.");
+"x's value.  Raises a `TypeError` if x is not a gmpy2 object.\n"
+"If compact is True, an `mpz` with an absolute value less\n"
+"than 2**63 is stored as a variable-length integer that needs\n"
+"fewer bytes; `from_binary()` recognizes either format.");
+
+static PyObject *
+GMPy_MPANY_To_Binary_Function(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "compact", NULL};
+    PyObject *other;
+    unsigned char buffer[GMPY_COMPACT_MAX];
+    int compact = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|$p", kwlist, &other, &compact))
+        return NULL;
+
+    if (compact && MPZ_Check(other) && _GMPy_Binary_MPZ_Compact_Fits(MPZ(other))) {
+        return PyBytes_FromStringAndSize((char*)buffer,
+                   (Py_ssize_t)_GMPy_Binary_MPZ_Compact_Put(buffer, MPZ(other)));
+    }
+    return GMPy_MPANY_To_Binary(self, other);
+}
 
 static PyObject *
 GMPy_MPANY_To_Binary(PyObject *self, PyObject *other)
 {
-    if(MPZ_Check(other))
+    if(MPZ_Check(other) || MPZ_View_Check(other))
         return GMPy_MPZ_To_Binary((MPZ_Object*)other);
     else if(XMPZ_Check(other))
         return GMPy_XMPZ_To_Binary((XMPZ_Object*)other);
@@ -1227,6 +1350,414 @@ GMPy_MPANY_To_Binary(PyObject *self, PyObject *other)
         return GMPy_MPFR_To_Binary((MPFR_Object*)other);
     else if(MPC_Check(other))
         return GMPy_MPC_To_Binary((MPC_Object*)other);
+    else if(MPZ_Array_Check(other))
+        return GMPy_MPZ_Array_To_Binary((MPZ_Array_Object*)other);
+    else if(MPFR_Array_Check(other) || MPC_Array_Check(other))
+        return GMPy_MPFR_Array_To_Binary((MPFR_Array_Object*)other);
     TYPE_ERROR("to_binary() argument type not supported");
     return NULL;
 }
+
+/* Objects are pickled as from_binary(to_binary(x)). With protocol 5, the
+ * bytes of a large value are wrapped in a PickleBuffer so they can be sent
+ * out-of-band.
+ */
+
+#define GMPY_PICKLE_BUFFER_MIN 4096
+
+PyDoc_STRVAR(GMPy_doc_method_reduce,
+"x.__reduce__() -> tuple\n\n"
+"Return the arguments used to pickle x.");
+
+static PyObject *
+GMPy_MPANY_Reduce_Method(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *bytes;
+
+    if (!(bytes = GMPy_MPANY_To_Binary(NULL, self))) {
+        return NULL;
+    }
+    return Py_BuildValue("(O(N))", global.from_binary, bytes);
+}
+
+PyDoc_STRVAR(GMPy_doc_method_reduce_ex,
+"x.__reduce_ex__(protocol, /) -> tuple\n\n"
+"Return the arguments used to pickle x with the given protocol.");
+
+static PyObject *
+GMPy_MPANY_Reduce_Ex_Method(PyObject *self, PyObject *other)
+{
+    PyObject *bytes;
+    long protocol;
+
+    protocol = PyLong_AsLong(other);
+    if (protocol == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+
+    if (!(bytes = GMPy_MPANY_To_Binary(NULL, self))) {
+        return NULL;
+    }
+
+#if PY_VERSION_HEX >= 0x03080000
+    if (protocol >= 5 && PyBytes_GET_SIZE(bytes) >= GMPY_PICKLE_BUFFER_MIN) {
+        PyObject *temp = PyPickleBuffer_FromObject(bytes);
+
+        Py_DECREF(bytes);
+        if (!(bytes = temp)) {
+            return NULL;
+        }
+    }
+#endif
+
+    return Py_BuildValue("(O(N))", global.from_binary, bytes);
+}
+
+/* to_binary_many() and from_binary_many() use a stream of records. Each
+ * record is the length of a value's binary representation, as 8 bytes in
+ * little-endian order, followed by the representation itself.
+ */
+
+#define GMPY_RECORD_HEADER 8
+
+typedef struct {
+    PyObject **items;     /* mpz, xmpz, or bytes from to_binary() */
+    size_t *offsets;      /* start of each record in buffer */
+    char *buffer;
+} gmpy_binary_many;
+
+static void
+_GMPy_To_Binary_Many_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_binary_many *work = (gmpy_binary_many*)arg;
+    PyObject *obj;
+    char *cp;
+    size_t size;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        obj = work->items[i];
+        cp = work->buffer + work->offsets[i];
+        size = work->offsets[i + 1] - work->offsets[i] - GMPY_RECORD_HEADER;
+        _GMPy_Binary_Put_Size(cp, size, GMPY_RECORD_HEADER);
+        cp += GMPY_RECORD_HEADER;
+        if (PyBytes_Check(obj))
+            memcpy(cp, PyBytes_AS_STRING(obj), size);
+        else
+            _GMPy_Binary_MPZ_Put(cp, MPZ(obj), XMPZ_Check(obj) ? 0x02 : 0x01);
+    }
+}
+
+PyDoc_STRVAR(doc_to_binary_many,
+"to_binary_many(values, /, out=None) -> bytes | int\n\n"
+"Return the binary representations of all gmpy2 objects or integers in\n"
+"values as one byte sequence. Each value is stored as its length in 8\n"
+"bytes (little-endian) followed by the bytes returned by `to_binary()`.\n"
+"Python integers are stored as `mpz`. If out is a writable buffer, the\n"
+"records are written to the start of out and the number of bytes\n"
+"written is returned.");
+
+static PyObject *
+GMPy_MPANY_To_Binary_Many(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "out", NULL};
+    PyObject *values, *out = Py_None, *seq = NULL, *obj, *result = NULL;
+    PyObject **items = NULL;
+    Py_buffer view;
+    Py_ssize_t n = 0, i;
+    size_t total = 0, size, bits;
+    gmpy_binary_many work;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    view.obj = NULL;
+    work.offsets = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|O", kwlist, &values, &out))
+        return NULL;
+
+    if (!(seq = PySequence_Fast(values, "to_binary_many() requires an iterable")))
+        return NULL;
+    n = PySequence_Fast_GET_SIZE(seq);
+
+    /* items[i] is the value itself for an integer and the result of
+     * to_binary() otherwise.
+     */
+
+    if (!(items = PyMem_New(PyObject*, n ? n : 1)) ||
+        !(work.offsets = PyMem_New(size_t, n + 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (i = 0; i < n; i++)
+        items[i] = NULL;
+
+    for (i = 0; i < n; i++) {
+        obj = PySequence_Fast_GET_ITEM(seq, i);
+        if (MPZ_Check(obj) || XMPZ_Check(obj) || MPZ_View_Check(obj)) {
+            Py_INCREF(obj);
+            items[i] = obj;
+            size = _GMPy_Binary_MPZ_Size(MPZ(obj));
+        }
+        else if (PyLong_Check(obj)) {
+            if (!(items[i] = (PyObject*)GMPy_MPZ_From_PyLong(obj, context)))
+                goto done;
+            size = _GMPy_Binary_MPZ_Size(MPZ(items[i]));
+        }
+        else {
+            if (!(items[i] = GMPy_MPANY_To_Binary(NULL, obj)))
+                goto done;
+            size = (size_t)PyBytes_GET_SIZE(items[i]);
+        }
+        work.offsets[i] = total;
+        total += GMPY_RECORD_HEADER + size;
+    }
+    work.offsets[n] = total;
+
+    if (out == Py_None) {
+        if (total > PY_SSIZE_T_MAX) {
+            OVERFLOW_ERROR("to_binary_many() result is too large");
+            goto done;
+        }
+        if (!(result = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)total)))
+            goto done;
+        work.buffer = PyBytes_AS_STRING(result);
+    }
+    else {
+        if (PyObject_GetBuffer(out, &view, PyBUF_WRITABLE) < 0)
+            goto done;
+        if ((size_t)view.len < total) {
+            VALUE_ERROR("buffer is too small for to_binary_many()");
+            goto done;
+        }
+        work.buffer = (char*)view.buf;
+    }
+
+    work.items = items;
+    bits = total > ((size_t)-1 >> 3) ? (size_t)-1 : total * 8;
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    GMPy_Parallel_Run(_GMPy_To_Binary_Many_Range, &work, n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (out != Py_None)
+        result = PyLong_FromSize_t(total);
+
+  done:
+    if (PyErr_Occurred())
+        Py_CLEAR(result);
+    if (view.obj)
+        PyBuffer_Release(&view);
+    if (items) {
+        for (i = 0; i < n; i++)
+            Py_XDECREF(items[i]);
+        PyMem_Free(items);
+    }
+    PyMem_Free(work.offsets);
+    Py_DECREF(seq);
+    return result;
+}
+
+/* Find the records in buffer. On success, offsets must be freed by the
+ * caller; offsets[i] is the start of record i after its length.
+ */
+
+static Py_ssize_t
+_GMPy_Binary_Many_Scan(unsigned char *buffer, size_t len, size_t **offsets)
+{
+    size_t pos = 0, size, count = 0, alloc = 16, *temp;
+
+    if (!(*offsets = PyMem_New(size_t, alloc + 1))) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    while (pos < len) {
+        if (len - pos < GMPY_RECORD_HEADER)
+            goto error;
+        size = _GMPy_Binary_Get_Size(buffer + pos, GMPY_RECORD_HEADER);
+        pos += GMPY_RECORD_HEADER;
+        if (size < 2 || size > len - pos)
+            goto error;
+        if (count == alloc) {
+            alloc *= 2;
+            if (!(temp = PyMem_Resize(*offsets, size_t, alloc + 1))) {
+                PyMem_Free(*offsets);
+                *offsets = NULL;
+                PyErr_NoMemory();
+                return -1;
+            }
+            *offsets = temp;
+        }
+        (*offsets)[count++] = pos;
+        pos += size;
+    }
+    (*offsets)[count] = len + GMPY_RECORD_HEADER;
+    return (Py_ssize_t)count;
+
+  error:
+    PyMem_Free(*offsets);
+    *offsets = NULL;
+    VALUE_ERROR("byte sequence invalid for from_binary_many()");
+    return -1;
+}
+
+typedef struct {
+    unsigned char *buffer;
+    size_t *offsets;
+    MPZ_Array_Object *array;
+} gmpy_binary_many_array;
+
+static void
+_GMPy_From_Binary_Many_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_binary_many_array *work = (gmpy_binary_many_array*)arg;
+    unsigned char *cp;
+    size_t size;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        cp = work->buffer + work->offsets[i];
+        size = work->offsets[i + 1] - work->offsets[i] - GMPY_RECORD_HEADER;
+        if (cp[0] == 0x07) {
+            _GMPy_Binary_MPZ_Compact_Get(work->array->z[i], cp, size);
+            continue;
+        }
+        if (cp[1] == 0x00) {
+            mpz_set_ui(work->array->z[i], 0);
+            continue;
+        }
+        mpz_import(work->array->z[i], size - 2, -1, sizeof(char), 0, 0, cp + 2);
+        if (cp[1] == 0x02)
+            mpz_neg(work->array->z[i], work->array->z[i]);
+    }
+}
+
+PyDoc_STRVAR(doc_from_binary_many,
+"from_binary_many(buffer, /, array=False) -> list | mpz_array\n\n"
+"Return the values stored by `to_binary_many()` in a bytes-like object.\n"
+"If array is True, all values must be integers and an `mpz_array` is\n"
+"returned instead of a list.");
+
+static PyObject *
+GMPy_MPANY_From_Binary_Many(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "array", NULL};
+    PyObject *other, *result = NULL, *item;
+    Py_buffer view;
+    Py_ssize_t n, i;
+    size_t *offsets = NULL, bits;
+    unsigned char *cp;
+    int array = 0;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|p", kwlist, &other, &array))
+        return NULL;
+
+    if (PyObject_GetBuffer(other, &view, PyBUF_SIMPLE) < 0)
+        return NULL;
+
+    if ((n = _GMPy_Binary_Many_Scan((unsigned char*)view.buf, (size_t)view.len,
+                                    &offsets)) < 0)
+        goto done;
+
+    if (array) {
+        gmpy_binary_many_array work;
+
+        for (i = 0; i < n; i++) {
+            cp = (unsigned char*)view.buf + offsets[i];
+            if (cp[0] == 0x07) {
+                if (_GMPy_Binary_MPZ_Compact_Get(NULL, cp, offsets[i + 1] - offsets[i] - GMPY_RECORD_HEADER) < 0) {
+                    VALUE_ERROR("byte sequence invalid for from_binary_many()");
+                    goto done;
+                }
+                continue;
+            }
+            if ((cp[0] != 0x01 && cp[0] != 0x02) || cp[1] > 0x02) {
+                VALUE_ERROR("from_binary_many() with array=True requires integer records");
+                goto done;
+            }
+        }
+        if (!(work.array = GMPy_MPZ_Array_New(n)))
+            goto done;
+        work.buffer = (unsigned char*)view.buf;
+        work.offsets = offsets;
+
+        bits = (size_t)view.len > ((size_t)-1 >> 3) ? (size_t)-1 : (size_t)view.len * 8;
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+        GMPy_Parallel_Run(_GMPy_From_Binary_Many_Range, &work, n,
+                          GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+        result = (PyObject*)work.array;
+        goto done;
+    }
+
+    if (!(result = PyList_New(n)))
+        goto done;
+    for (i = 0; i < n; i++) {
+        cp = (unsigned char*)view.buf + offsets[i];
+        if (!(item = _GMPy_MPANY_From_Buffer(cp, (Py_ssize_t)(offsets[i + 1] - offsets[i] - GMPY_RECORD_HEADER),
+                                             context))) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, item);
+    }
+
+  done:
+    PyMem_Free(offsets);
+    PyBuffer_Release(&view);
+    return result;
+}
+
+PyDoc_STRVAR(doc_from_binary_at,
+"from_binary_at(buffer, offset=0, /) -> tuple[mpz | xmpz | mpq | mpfr | mpc, int]\n\n"
+"Decode the record written by `to_binary_many()` that starts at offset in\n"
+"a bytes-like object, such as a memoryview or an mmap, without copying it.\n"
+"Return the value and the number of bytes the record occupies, so the\n"
+"next record starts at offset plus that number.");
+
+static PyObject *
+GMPy_MPANY_From_Binary_At(PyObject *self, PyObject *args)
+{
+    PyObject *other, *value, *result = NULL;
+    Py_buffer view;
+    Py_ssize_t offset = 0;
+    size_t size, avail;
+    unsigned char *cp;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTuple(args, "O|n", &other, &offset))
+        return NULL;
+
+    if (PyObject_GetBuffer(other, &view, PyBUF_SIMPLE) < 0)
+        return NULL;
+
+    if (offset < 0 || offset > view.len) {
+        VALUE_ERROR("offset is outside the buffer");
+        goto done;
+    }
+    avail = (size_t)(view.len - offset);
+    cp = (unsigned char*)view.buf + offset;
+    if (avail < GMPY_RECORD_HEADER ||
+        (size = _GMPy_Binary_Get_Size(cp, GMPY_RECORD_HEADER)) >
+                avail - GMPY_RECORD_HEADER) {
+        VALUE_ERROR("byte sequence invalid for from_binary_at()");
+        goto done;
+    }
+
+    if ((value = _GMPy_MPANY_From_Buffer(cp + GMPY_RECORD_HEADER,
+                                         (Py_ssize_t)size, context))) {
+        result = Py_BuildValue("(Nn)", value,
+                               (Py_ssize_t)(size + GMPY_RECORD_HEADER));
+    }
+
+  done:
+    PyBuffer_Release(&view);
+    return result;
+}
@@ -41,7 +41,17 @@ static PyObject * GMPy_MPQ_From_Old_Binary(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPFR_From_Old_Binary(PyObject *self, PyObject *other);
 
 static PyObject * GMPy_MPANY_From_Binary(PyObject *self, PyObject *other);
+static PyObject * _GMPy_MPANY_From_Buffer(unsigned char *buffer, Py_ssize_t len, CTXT_Object *context);
 static PyObject * GMPy_MPANY_To_Binary(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPANY_To_Binary_Function(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPANY_To_Binary_Many(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPANY_From_Binary_Many(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPANY_From_Binary_At(PyObject *self, PyObject *args);
+
+/* __reduce__ and __reduce_ex__ for every gmpy2 type. */
+
+static PyObject * GMPy_MPANY_Reduce_Method(PyObject *self, PyObject *Py_UNUSED(ignored));
+static PyObject * GMPy_MPANY_Reduce_Ex_Method(PyObject *self, PyObject *other);
 
 static PyObject * GMPy_MPZ_To_Binary(MPZ_Object *self);
 static PyObject * GMPy_XMPZ_To_Binary(XMPZ_Object *self);
@@ -0,0 +1,545 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_buffer.c                                                          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+static const gmpy_buffer_type buffer_types[] = {
+    { "int8", 'b', 'i', 1 },
+    { "uint8", 'B', 'u', 1 },
+    { "int16", 'h', 'i', 2 },
+    { "uint16", 'H', 'u', 2 },
+    { "int32", 'i', 'i', 4 },
+    { "uint32", 'I', 'u', 4 },
+    { "int64", 'q', 'i', 8 },
+    { "uint64", 'Q', 'u', 8 },
+    { "float32", 'f', 'f', 4 },
+    { "float64", 'd', 'f', 8 },
+    { NULL, 0, 0, 0 }
+};
+
+/* Return the kind of the elements of a buffer with the struct module
+ * format fmt, or 0 if it is not supported. Only native byte order is
+ * accepted.
+ */
+
+static char
+_GMPy_Buffer_Kind(const char *fmt, Py_ssize_t itemsize)
+{
+    if (!fmt)
+        return itemsize == 1 ? 'u' : 0;
+
+    switch (*fmt) {
+    case '@':
+    case '=':
+        fmt++;
+        break;
+#if PY_LITTLE_ENDIAN
+    case '<':
+#else
+    case '>':
+    case '!':
+#endif
+        fmt++;
+        break;
+    }
+    if (!fmt[0] || fmt[1])
+        return 0;
+
+    if (strchr("bhilqn", *fmt) && itemsize <= 8)
+        return 'i';
+    if (strchr("BHILQN?", *fmt) && itemsize <= 8)
+        return 'u';
+    if ((*fmt == 'f' && itemsize == 4) || (*fmt == 'd' && itemsize == 8))
+        return 'f';
+    return 0;
+}
+
+static int64_t
+_GMPy_Buffer_Get_Int(const char *p, Py_ssize_t size)
+{
+    int8_t i8;
+    int16_t i16;
+    int32_t i32;
+    int64_t i64;
+
+    switch (size) {
+    case 1:
+        memcpy(&i8, p, 1);
+        return i8;
+    case 2:
+        memcpy(&i16, p, 2);
+        return i16;
+    case 4:
+        memcpy(&i32, p, 4);
+        return i32;
+    default:
+        memcpy(&i64, p, 8);
+        return i64;
+    }
+}
+
+static uint64_t
+_GMPy_Buffer_Get_UInt(const char *p, Py_ssize_t size)
+{
+    uint8_t u8;
+    uint16_t u16;
+    uint32_t u32;
+    uint64_t u64;
+
+    switch (size) {
+    case 1:
+        memcpy(&u8, p, 1);
+        return u8;
+    case 2:
+        memcpy(&u16, p, 2);
+        return u16;
+    case 4:
+        memcpy(&u32, p, 4);
+        return u32;
+    default:
+        memcpy(&u64, p, 8);
+        return u64;
+    }
+}
+
+static double
+_GMPy_Buffer_Get_Double(const char *p, Py_ssize_t size)
+{
+    float f;
+    double d;
+
+    if (size == 4) {
+        memcpy(&f, p, 4);
+        return f;
+    }
+    memcpy(&d, p, 8);
+    return d;
+}
+
+/* Store the low size bytes of value at p. */
+
+static void
+_GMPy_Buffer_Put_UInt(char *p, uint64_t value, Py_ssize_t size)
+{
+    uint8_t u8 = (uint8_t)value;
+    uint16_t u16 = (uint16_t)value;
+    uint32_t u32 = (uint32_t)value;
+
+    switch (size) {
+    case 1:
+        memcpy(p, &u8, 1);
+        break;
+    case 2:
+        memcpy(p, &u16, 2);
+        break;
+    case 4:
+        memcpy(p, &u32, 4);
+        break;
+    default:
+        memcpy(p, &value, 8);
+        break;
+    }
+}
+
+/* Conversions between mpz_t and 64-bit integers. The export is only
+ * called for |z| < 2**64.
+ */
+
+static void
+_GMPy_MPZ_Set_UInt64(mpz_ptr z, uint64_t value)
+{
+#if ULONG_MAX >= 0xFFFFFFFFFFFFFFFFULL
+    mpz_set_ui(z, (unsigned long)value);
+#else
+    mpz_import(z, 1, 1, sizeof(value), 0, 0, &value);
+#endif
+}
+
+static void
+_GMPy_MPZ_Set_Int64(mpz_ptr z, int64_t value)
+{
+#if LONG_MAX >= 0x7FFFFFFFFFFFFFFFLL
+    mpz_set_si(z, (long)value);
+#else
+    _GMPy_MPZ_Set_UInt64(z, value < 0 ? 0 - (uint64_t)value : (uint64_t)value);
+    if (value < 0)
+        mpz_neg(z, z);
+#endif
+}
+
+static uint64_t
+_GMPy_MPZ_Get_UInt64(mpz_srcptr z)
+{
+    uint64_t value = 0;
+
+#if ULONG_MAX >= 0xFFFFFFFFFFFFFFFFULL
+    value = mpz_getlimbn(z, 0);
+#else
+    mpz_export(&value, NULL, 1, sizeof(value), 0, 0, z);
+#endif
+    return mpz_sgn(z) < 0 ? 0 - value : value;
+}
+
+/* Return 1 if z fits in an integer of the given kind and size in bytes. */
+
+static int
+_GMPy_MPZ_Fits(mpz_srcptr z, char kind, Py_ssize_t size)
+{
+    size_t bits = (size_t)size * 8, zbits;
+
+    if (mpz_sgn(z) == 0)
+        return 1;
+    zbits = mpz_sizeinbase(z, 2);
+    if (kind == 'u')
+        return mpz_sgn(z) > 0 && zbits <= bits;
+    if (zbits < bits)
+        return 1;
+    /* -2**(bits-1) */
+    return mpz_sgn(z) < 0 && zbits == bits && mpz_scan1(z, 0) == bits - 1;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_from_array,
+"from_array(arr, /, type=mpz) -> list | mpz_array\n\n"
+"Convert the elements of arr, an object that supports the buffer\n"
+"protocol such as a NumPy array, array.array, or bytes, to type. arr\n"
+"must hold signed or unsigned integers of up to 64 bits, or 32 or 64 bit\n"
+"floats, in native byte order; an array with more than one dimension\n"
+"must be C-contiguous and is flattened. type is mpz or mpfr for a list,\n"
+"or mpz_array. Floats are truncated when converted to mpz; NaN raises\n"
+"ValueError and infinity raises OverflowError. mpfr values are rounded\n"
+"to the precision of the current context.");
+
+static PyObject *
+GMPy_Function_From_Array(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"arr", "type", NULL};
+    PyObject *arr, *type = (PyObject*)&MPZ_Type, *result = NULL;
+    MPZ_Object *tempz;
+    MPFR_Object *tempf;
+    CTXT_Object *context = NULL;
+    Py_buffer view;
+    Py_ssize_t i, n, stride;
+    const char *p;
+    char kind;
+    mpz_t z;
+    mpz_ptr target;
+    double d;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|O", kwlist, &arr, &type))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (type != (PyObject*)&MPZ_Type && type != (PyObject*)&MPFR_Type &&
+        type != (PyObject*)&MPZ_Array_Type) {
+        TYPE_ERROR("from_array() type must be mpz, mpfr, or mpz_array");
+        return NULL;
+    }
+
+    if (PyObject_GetBuffer(arr, &view, PyBUF_FORMAT | PyBUF_STRIDES) < 0)
+        return NULL;
+
+    if (!(kind = _GMPy_Buffer_Kind(view.format, view.itemsize))) {
+        PyErr_Format(PyExc_TypeError, "from_array() does not support the format '%s'",
+                     view.format ? view.format : "B");
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    n = view.len / view.itemsize;
+    if (view.ndim == 1) {
+        stride = view.strides[0];
+    }
+    else if (view.ndim == 0 || PyBuffer_IsContiguous(&view, 'C')) {
+        stride = view.itemsize;
+    }
+    else {
+        VALUE_ERROR("from_array() requires a C-contiguous array");
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    if (type == (PyObject*)&MPZ_Array_Type)
+        result = (PyObject*)GMPy_MPZ_Array_New(n);
+    else
+        result = PyList_New(n);
+    if (!result) {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    mpz_init(z);
+    for (i = 0; i < n; i++) {
+        p = (const char*)view.buf + i * stride;
+
+        if (type == (PyObject*)&MPFR_Type) {
+            if (!(tempf = GMPy_MPFR_New(0, context)))
+                goto err;
+            mpfr_clear_flags();
+            if (kind == 'f') {
+                d = _GMPy_Buffer_Get_Double(p, view.itemsize);
+                tempf->rc = mpfr_set_d(tempf->f, d, GET_MPFR_ROUND(context));
+            }
+            else {
+                if (kind == 'i')
+                    _GMPy_MPZ_Set_Int64(z, _GMPy_Buffer_Get_Int(p, view.itemsize));
+                else
+                    _GMPy_MPZ_Set_UInt64(z, _GMPy_Buffer_Get_UInt(p, view.itemsize));
+                tempf->rc = mpfr_set_z(tempf->f, z, GET_MPFR_ROUND(context));
+            }
+            _GMPy_MPFR_Cleanup(&tempf, context);
+            if (!tempf)
+                goto err;
+            PyList_SET_ITEM(result, i, (PyObject*)tempf);
+            continue;
+        }
+
+        if (type == (PyObject*)&MPZ_Type) {
+            if (!(tempz = GMPy_MPZ_New(context)))
+                goto err;
+            PyList_SET_ITEM(result, i, (PyObject*)tempz);
+            target = tempz->z;
+        }
+        else {
+            target = ((MPZ_Array_Object*)result)->z[i];
+        }
+
+        if (kind == 'i') {
+            _GMPy_MPZ_Set_Int64(target, _GMPy_Buffer_Get_Int(p, view.itemsize));
+        }
+        else if (kind == 'u') {
+            _GMPy_MPZ_Set_UInt64(target, _GMPy_Buffer_Get_UInt(p, view.itemsize));
+        }
+        else {
+            d = _GMPy_Buffer_Get_Double(p, view.itemsize);
+            if (Py_IS_NAN(d)) {
+                VALUE_ERROR("'mpz' does not support NaN");
+                goto err;
+            }
+            if (Py_IS_INFINITY(d)) {
+                OVERFLOW_ERROR("'mpz' does not support Infinity");
+                goto err;
+            }
+            mpz_set_d(target, d);
+        }
+    }
+    mpz_clear(z);
+    PyBuffer_Release(&view);
+    return result;
+
+  err:
+    mpz_clear(z);
+    PyBuffer_Release(&view);
+    Py_DECREF(result);
+    return NULL;
+}
+
+static const gmpy_buffer_type *
+_GMPy_Buffer_Find(const char *name)
+{
+    const gmpy_buffer_type *t;
+
+    for (t = buffer_types; t->name; t++) {
+        if (strcmp(name, t->name) == 0)
+            return t;
+    }
+    return NULL;
+}
+
+/* Return the entry of buffer_types for dtype, which is a name such as
+ * 'int64', or a NumPy dtype or scalar type with that name.
+ */
+
+static const gmpy_buffer_type *
+_GMPy_Buffer_Type(PyObject *dtype)
+{
+    const gmpy_buffer_type *t;
+    PyObject *name;
+    const char *s;
+
+    if (PyUnicode_Check(dtype)) {
+        Py_INCREF(dtype);
+        name = dtype;
+    }
+    else if (PyType_Check(dtype)) {
+        name = PyObject_GetAttrString(dtype, "__name__");
+    }
+    else {
+        name = PyObject_Str(dtype);
+    }
+    if (!name)
+        return NULL;
+
+    t = NULL;
+    if ((s = PyUnicode_AsUTF8(name)) && !(t = _GMPy_Buffer_Find(s)))
+        PyErr_Format(PyExc_ValueError, "to_array() does not support dtype '%s'", s);
+    Py_DECREF(name);
+    return t;
+}
+
+/* Store the element obj, or z if obj is NULL, at p. */
+
+static int
+_GMPy_Buffer_Put(char *p, const gmpy_buffer_type *t, PyObject *obj,
+                 mpz_srcptr z, mpz_ptr temp, CTXT_Object *context)
+{
+    MPZ_Object *tempz;
+    double d;
+    float f;
+
+    if (t->kind == 'f') {
+        if (!obj) {
+            d = mpz_get_d(z);
+            if (Py_IS_INFINITY(d))
+                goto overflow;
+        }
+        else if (CHECK_MPZANY(obj)) {
+            d = mpz_get_d(MPZ(obj));
+            if (Py_IS_INFINITY(d))
+                goto overflow;
+        }
+        else if (MPFR_Check(obj)) {
+            d = mpfr_get_d(MPFR(obj), GET_MPFR_ROUND(context));
+            if (Py_IS_INFINITY(d) && !mpfr_inf_p(MPFR(obj)))
+                goto overflow;
+        }
+        else {
+            d = PyFloat_AsDouble(obj);
+            if (d == -1.0 && PyErr_Occurred())
+                return -1;
+        }
+        if (t->size == 4) {
+            if (Py_IS_FINITE(d) && fabs(d) > FLT_MAX)
+                goto overflow;
+            f = (float)d;
+            memcpy(p, &f, 4);
+        }
+        else {
+            memcpy(p, &d, 8);
+        }
+        return 0;
+    }
+
+    if (!obj) {
+        /* z is set */
+    }
+    else if (CHECK_MPZANY(obj)) {
+        z = MPZ(obj);
+    }
+    else if (PyLong_Check(obj)) {
+        mpz_set_PyLong(temp, obj);
+        z = temp;
+    }
+    else if (IS_INTEGER(obj)) {
+        if (!(tempz = GMPy_MPZ_From_Integer(obj, context)))
+            return -1;
+        mpz_set(temp, tempz->z);
+        Py_DECREF((PyObject*)tempz);
+        z = temp;
+    }
+    else {
+        PyErr_Format(PyExc_TypeError, "to_array() requires integers for dtype '%s'",
+                     t->name);
+        return -1;
+    }
+
+    if (!_GMPy_MPZ_Fits(z, t->kind, t->size))
+        goto overflow;
+    _GMPy_Buffer_Put_UInt(p, _GMPy_MPZ_Get_UInt64(z), t->size);
+    return 0;
+
+  overflow:
+    PyErr_Format(PyExc_OverflowError, "to_array() value does not fit in %s", t->name);
+    return -1;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_to_array,
+"to_array(seq, /, dtype='int64') -> array.array\n\n"
+"Return an array.array that holds the numbers in seq, which is a\n"
+"sequence or an mpz_array, as dtype. dtype is one of 'int8', 'uint8',\n"
+"'int16', 'uint16', 'int32', 'uint32', 'int64', 'uint64', 'float32', or\n"
+"'float64', or a NumPy dtype with one of these names. A value that does\n"
+"not fit in dtype raises OverflowError. Integer dtypes require integers;\n"
+"conversions to float round like float(). numpy.asarray() of the result\n"
+"does not copy it.");
+
+static PyObject *
+GMPy_Function_To_Array(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"seq", "dtype", NULL};
+    PyObject *seq, *dtype = NULL, *fast = NULL, *bytes = NULL, *module, *result = NULL;
+    const gmpy_buffer_type *t = _GMPy_Buffer_Find("int64");
+    CTXT_Object *context = NULL;
+    MPZ_Array_Object *zarr = NULL;
+    Py_ssize_t i, n;
+    char *buf;
+    mpz_t temp;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|O", kwlist, &seq, &dtype))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (dtype && !(t = _GMPy_Buffer_Type(dtype)))
+        return NULL;
+
+    if (MPZ_Array_Check(seq)) {
+        zarr = (MPZ_Array_Object*)seq;
+        n = zarr->size;
+    }
+    else {
+        if (!(fast = PySequence_Fast(seq, "to_array() requires a sequence")))
+            return NULL;
+        n = PySequence_Fast_GET_SIZE(fast);
+    }
+
+    if (n > PY_SSIZE_T_MAX / t->size) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    if (!(bytes = PyBytes_FromStringAndSize(NULL, n * t->size)))
+        goto done;
+    buf = PyBytes_AS_STRING(bytes);
+
+    mpz_init(temp);
+    for (i = 0; i < n; i++) {
+        if (_GMPy_Buffer_Put(buf + i * t->size, t,
+                             zarr ? NULL : PySequence_Fast_GET_ITEM(fast, i),
+                             zarr ? zarr->z[i] : NULL, temp, context) < 0) {
+            mpz_clear(temp);
+            goto done;
+        }
+    }
+    mpz_clear(temp);
+
+    if ((module = PyImport_ImportModule("array"))) {
+        result = PyObject_CallMethod(module, "array", "CO", t->code, bytes);
+        Py_DECREF(module);
+    }
+
+  done:
+    Py_XDECREF(fast);
+    Py_XDECREF(bytes);
+    return result;
+}
@@ -0,0 +1,53 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_buffer.h                                                          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY2_BUFFER_H
+#define GMPY2_BUFFER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bulk conversion between gmpy2 types and buffers of machine integers or
+ * floats, such as NumPy arrays. from_array() reads any object that
+ * supports the buffer protocol; to_array() returns an array.array, which
+ * NumPy can wrap without a copy.
+ */
+
+typedef struct {
+    const char *name;           /* NumPy name of the type */
+    char code;                  /* array module typecode */
+    char kind;                  /* 'i', 'u', or 'f' */
+    Py_ssize_t size;
+} gmpy_buffer_type;
+
+static PyObject * GMPy_Function_From_Array(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Function_To_Array(PyObject *self, PyObject *args, PyObject *keywds);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -27,133 +27,499 @@
 
 /* gmpy2 caches objects so they can be reused quickly without involving a new
  * memory allocation or object construction.
+ *
+ * With the GIL, all threads share the caches in global.cache and the GIL
+ * serializes access to them. When the GIL is disabled (Py_GIL_DISABLED), each
+ * thread uses its own private cache. The caches in global.cache become a
+ * shared pool, protected by global.cache_lock: a private cache that is empty
+ * is refilled from the pool and a private cache that is full spills half of
+ * its entries to the pool. The private cache is linked to the thread state
+ * so the cached objects are returned to the pool when the thread exits.
+ *
+ * GMPY_CACHE returns the cache to use for the running thread; it may return
+ * NULL in a free-threaded build if a private cache could not be created.
  */
 
+#ifdef Py_GIL_DISABLED
+
+static GMPY_THREAD_LOCAL gmpy_cache *gmpy_thread_cache = NULL;
+static GMPY_THREAD_LOCAL PyThreadState *gmpy_thread_cache_done = NULL;
+
+/* Move objects from the shared pool into a private cache until the private
+ * cache is half full.
+ */
+
+static void
+_GMPy_Cache_Refill(void **local, int *in_local, void **shared, int *in_shared,
+                   int size)
+{
+    PyMutex_Lock(&global.cache_lock);
+    while (*in_shared && *in_local < size / 2) {
+        local[(*in_local)++] = shared[--(*in_shared)];
+    }
+    PyMutex_Unlock(&global.cache_lock);
+}
+
+/* Move objects from a private cache into the shared pool until either the
+ * private cache is half empty or the pool is full.
+ */
+
+static void
+_GMPy_Cache_Spill(void **local, int *in_local, void **shared, int *in_shared,
+                  int size)
+{
+    PyMutex_Lock(&global.cache_lock);
+    while (*in_shared < size && *in_local > size / 2) {
+        shared[(*in_shared)++] = local[--(*in_local)];
+    }
+    PyMutex_Unlock(&global.cache_lock);
+}
+
+#define GMPY_CACHE_REFILL(cache, NAME, COUNT, TYPE) \
+    if (cache && !cache->COUNT && global.cache_size[TYPE]) \
+        _GMPy_Cache_Refill((void**)cache->NAME, &cache->COUNT, \
+                           (void**)global.cache.NAME, &global.cache.COUNT, \
+                           global.cache_size[TYPE]);
+
+#define GMPY_CACHE_SPILL(cache, NAME, COUNT, TYPE) \
+    if (cache && global.cache_size[TYPE] && \
+        cache->COUNT >= global.cache_size[TYPE]) \
+        _GMPy_Cache_Spill((void**)cache->NAME, &cache->COUNT, \
+                          (void**)global.cache.NAME, &global.cache.COUNT, \
+                          global.cache_size[TYPE]);
+
+static void _GMPy_Cache_Release(gmpy_cache *cache);
+
+/* Called when the capsule stored in the thread state dictionary is
+ * destroyed, i.e. when the thread state is cleared.
+ */
+
+static void
+_GMPy_Thread_Cache_Destructor(PyObject *capsule)
+{
+    gmpy_cache *cache = (gmpy_cache*)PyCapsule_GetPointer(capsule, "gmpy2.cache");
+
+    if (!cache)
+        return;
+
+    if (cache == gmpy_thread_cache) {
+        gmpy_thread_cache = NULL;
+        /* Objects released while the rest of the thread state is cleared
+         * must not create a new private cache.
+         */
+        gmpy_thread_cache_done = PyThreadState_Get();
+    }
+    _GMPy_Cache_Release(cache);
+    PyMem_RawFree(cache);
+}
+
+static gmpy_cache *
+_GMPy_Thread_Cache_Init(void)
+{
+    PyObject *dict, *capsule;
+    gmpy_cache *cache;
+
+    if (gmpy_thread_cache_done &&
+        gmpy_thread_cache_done == PyThreadState_GetUnchecked()) {
+        return NULL;
+    }
+
+    if (!(dict = PyThreadState_GetDict()))
+        return NULL;
+
+    if (!(cache = PyMem_RawCalloc(1, sizeof(gmpy_cache))))
+        return NULL;
+
+    if (!(capsule = PyCapsule_New(cache, "gmpy2.cache",
+                                  _GMPy_Thread_Cache_Destructor))) {
+        PyMem_RawFree(cache);
+        PyErr_Clear();
+        return NULL;
+    }
+
+    if (PyDict_SetItemString(dict, "gmpy2.cache", capsule) < 0) {
+        /* The destructor frees the cache. */
+        Py_DECREF(capsule);
+        PyErr_Clear();
+        return NULL;
+    }
+    Py_DECREF(capsule);
+
+    gmpy_thread_cache_done = NULL;
+    gmpy_thread_cache = cache;
+    return cache;
+}
+
+static inline gmpy_cache *
+_GMPy_Thread_Cache(void)
+{
+    if (gmpy_thread_cache)
+        return gmpy_thread_cache;
+    return _GMPy_Thread_Cache_Init();
+}
+
+#define GMPY_CACHE (_GMPy_Thread_Cache())
+
+#else
+
+#define GMPY_CACHE_REFILL(cache, NAME, COUNT, TYPE)
+#define GMPY_CACHE_SPILL(cache, NAME, COUNT, TYPE)
+#define GMPY_CACHE (&global.cache)
+
+#endif
+
+/* The size limits set by set_cache(). An mpfr object is cached by the number
+ * of limbs used by its mantissa.
+ */
+
+#define MPZ_CACHEABLE(obj, TYPE) \
+    ((obj)->z->_mp_alloc <= global.cache_limbs[TYPE])
+
+#define MPQ_CACHEABLE(obj) \
+    (mpq_numref((obj)->q)->_mp_alloc <= global.cache_limbs[GMPY_CACHE_MPQ] && \
+     mpq_denref((obj)->q)->_mp_alloc <= global.cache_limbs[GMPY_CACHE_MPQ])
+
+#define MPFR_CACHEABLE(bits) \
+    (MPFR_CACHE_BUCKET(bits) < global.cache_limbs[GMPY_CACHE_MPFR])
+
+#define MPC_CACHEABLE(obj) \
+    (MPFR_CACHE_BUCKET(mpfr_get_prec(mpc_realref((obj)->c))) < global.cache_limbs[GMPY_CACHE_MPC] && \
+     MPFR_CACHE_BUCKET(mpfr_get_prec(mpc_imagref((obj)->c))) < global.cache_limbs[GMPY_CACHE_MPC])
+
+/* The number of objects in use, reported by memory_info(), is counted when
+ * an object is returned by a constructor and when it is deallocated.
+ */
+
+#define CACHE_LIVE(cache, TYPE) \
+    do { \
+        if (++(cache)->stats[TYPE].live > (cache)->stats[TYPE].peak) \
+            (cache)->stats[TYPE].peak = (cache)->stats[TYPE].live; \
+    } while (0)
+#define CACHE_HIT(cache, TYPE, context) \
+    do { \
+        (cache)->stats[TYPE].hits++; \
+        CACHE_LIVE(cache, TYPE); \
+        GMPY_PROFILE_CACHE(context, 1); \
+    } while (0)
+#define CACHE_MISS(cache, TYPE, context) \
+    do { \
+        if (cache) { \
+            (cache)->stats[TYPE].misses++; \
+            CACHE_LIVE(cache, TYPE); \
+        } \
+        GMPY_PROFILE_CACHE(context, 0); \
+        GMPY_TRACE_CACHE(TYPE); \
+        GMPY_GUARD_COUNT(cache_misses); \
+    } while (0)
+#define CACHE_DEALLOC(cache, TYPE) if (cache) (cache)->stats[TYPE].live--
+#define CACHE_EVICT(cache, TYPE) if (cache) (cache)->stats[TYPE].evictions++
+
 /* Caching logic for Pympz. */
 
+/* Return 1 if the storage of z can be kept by the cache of TYPE. Storage
+ * that is too large is reduced to the size of the value if that fits, so
+ * an object that once held a large intermediate is cached rather than
+ * freed and doesn't keep its unused limbs.
+ */
+
+static inline int
+_GMPy_MPZ_Cache_Fit(mpz_ptr z, int type)
+{
+    mp_size_t size;
+
+    if (z->_mp_alloc <= global.cache_limbs[type])
+        return 1;
+    size = Py_MAX((mp_size_t)mpz_size(z), 1);
+    if (size > global.cache_limbs[type] || !global.cache_size[type])
+        return 0;
+    mpz_realloc2(z, (mp_bitcnt_t)size * GMP_NUMB_BITS);
+    return 1;
+}
+
+/* Return the size class of an object with alloc limbs, i.e. the largest n
+ * with 2**n <= alloc.
+ */
+
+static inline int
+_GMPy_MPZ_Cache_Class(mp_size_t alloc)
+{
+    int n = 0;
+
+    while (n < MPZ_CACHE_CLASSES - 1 && ((mp_size_t)2 << n) <= alloc)
+        n++;
+    return n;
+}
+
+/* Return the first size class whose objects have at least size limbs. */
+
+static inline int
+_GMPy_MPZ_Cache_Start(mp_size_t size)
+{
+    int n = 0;
+
+    while (((mp_size_t)1 << n) < size)
+        n++;
+    return n;
+}
+
+/* Take an object from the cache that has room for at least size limbs.
+ * Only MPZ_CACHE_SEARCH classes are searched so a small request is not
+ * given a much larger object.
+ */
+
+#define GMPY_MPZ_CACHE_GET(result, cache, NAME, COUNT, TYPE, size) \
+    { \
+        int n = _GMPy_MPZ_Cache_Start(size); \
+        int last = n + MPZ_CACHE_SEARCH; \
+        for (; n < last && n < MPZ_CACHE_CLASSES; n++) { \
+            GMPY_CACHE_REFILL(cache, NAME[n], COUNT[n], TYPE); \
+            if (cache && cache->COUNT[n]) { \
+                result = cache->NAME[n][--(cache->COUNT[n])]; \
+                break; \
+            } \
+        } \
+    }
+
 /* GMPy_MPZ_New returns a reference to a new MPZ_Object. Its value
  * is initialized to 0.
  */
 
 static MPZ_Object *
 GMPy_MPZ_New(CTXT_Object *context)
+{
+    return GMPy_MPZ_NewSize(1, context);
+}
+
+/* GMPy_MPZ_NewSize returns a reference to a new MPZ_Object with room for
+ * at least size limbs. size is only a hint; the value is initialized to 0
+ * and will be reallocated as needed.
+ */
+
+static MPZ_Object *
+GMPy_MPZ_NewSize(mp_size_t size, CTXT_Object *context)
 {
     MPZ_Object *result = NULL;
+    gmpy_cache *cache = GMPY_CACHE;
 
-    if (global.in_gmpympzcache) {
-        result = global.gmpympzcache[--(global.in_gmpympzcache)];
+    GMPY_MPZ_CACHE_GET(result, cache, gmpympzcache, in_gmpympzcache,
+                       GMPY_CACHE_MPZ, size);
+    if (result) {
+        CACHE_HIT(cache, GMPY_CACHE_MPZ, context);
         Py_INCREF((PyObject*)result);
         mpz_set_ui(result->z, 0);
     }
     else {
+        CACHE_MISS(cache, GMPY_CACHE_MPZ, context);
         result = PyObject_New(MPZ_Object, &MPZ_Type);
         if (result == NULL) {
             return NULL;
         }
-        mpz_init(result->z);
+        if (size > 1)
+            mpz_init2(result->z, (mp_bitcnt_t)size * GMP_NUMB_BITS);
+        else
+            mpz_init(result->z);
     }
     result->hash_cache = -1;
     return result;
 }
 
-/* GMPy_MPZ_NewInit returns a reference to an initialized MPZ_Object. It is
- * used by mpz.__new__ to replace the old mpz() factory function.
+/* Return a new reference to x if the result of an operation between x and
+ * other can be written into x. x must be an mpz that is only referenced by
+ * the interpreter's value stack, like the product in a*b + c. other must
+ * not need x's storage as scratch space: it must be an mpz or an int of at
+ * most one digit. Otherwise return NULL.
+ */
+
+static MPZ_Object *
+GMPy_MPZ_Reuse(PyObject *x, int xtype, PyObject *other, int othertype)
+{
+#ifdef GMPY_TEMP_ELISION
+    if (IS_TYPE_MPZ(xtype) &&
+        (IS_TYPE_MPZANY(othertype) ||
+         (IS_TYPE_PyInteger(othertype) &&
+          _PyLong_DigitCount((PyLongObject*)other) <= 1)) &&
+        GMPY_IS_TEMPORARY(x)) {
+
+        Py_INCREF(x);
+        ((MPZ_Object*)x)->hash_cache = -1;
+        return (MPZ_Object*)x;
+    }
+#endif
+    return NULL;
+}
+
+/* The small integers are made immortal where the running Python supports
+ * it so that threads sharing them don't contend for the reference count.
+ * Otherwise global.small_mpz holds a reference that is never released.
  */
 
+#if defined(_Py_IMMORTAL_INITIAL_REFCNT)
+#  define GMPY_SET_IMMORTAL(obj) Py_SET_REFCNT(obj, _Py_IMMORTAL_INITIAL_REFCNT)
+#elif defined(_Py_IMMORTAL_REFCNT)
+#  define GMPY_SET_IMMORTAL(obj) Py_SET_REFCNT(obj, _Py_IMMORTAL_REFCNT)
+#else
+#  define GMPY_SET_IMMORTAL(obj)
+#endif
+
+static int
+GMPy_MPZ_Small_Init(void)
+{
+    MPZ_Object *obj;
+    long i;
+
+    for (i = GMPY_MPZ_SMALL_MIN; i <= GMPY_MPZ_SMALL_MAX; i++) {
+        if (global.small_mpz[i - GMPY_MPZ_SMALL_MIN])
+            continue;
+        /* Not taken from the cache so the value can't be aliased. */
+        if (!(obj = PyObject_New(MPZ_Object, &MPZ_Type))) {
+            /* LCOV_EXCL_START */
+            return -1;
+            /* LCOV_EXCL_STOP */
+        }
+        mpz_init_set_si(obj->z, i);
+        obj->hash_cache = -1;
+        GMPY_SET_IMMORTAL((PyObject*)obj);
+        global.small_mpz[i - GMPY_MPZ_SMALL_MIN] = obj;
+    }
+    return 0;
+}
+
+static inline MPZ_Object *
+GMPy_MPZ_Small(long value)
+{
+    MPZ_Object *result = global.small_mpz[value - GMPY_MPZ_SMALL_MIN];
+
+    Py_INCREF((PyObject*)result);
+    return result;
+}
+
+static inline PyObject *
+GMPy_MPZ_Small_Result(MPZ_Object *result)
+{
+    int size = result->z->_mp_size;
+    mp_limb_t limb;
+
+    if (size > 1 || size < -1)
+        return (PyObject*)result;
+
+    limb = mpz_getlimbn(result->z, 0);
+    if (size >= 0 ? limb > GMPY_MPZ_SMALL_MAX : limb > -GMPY_MPZ_SMALL_MIN)
+        return (PyObject*)result;
+
+    Py_DECREF((PyObject*)result);
+    return (PyObject*)GMPy_MPZ_Small(size >= 0 ? (long)limb : -(long)limb);
+}
+
+/* Convert the single argument of mpz(n). */
+
 static PyObject *
-GMPy_MPZ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+_GMPy_MPZ_NewInit_One(PyObject *n, CTXT_Object *context)
 {
     MPZ_Object *result = NULL;
-    PyObject *n = NULL;
     PyObject *temp = NULL;
     PyObject *out = NULL;
-    int base = 0;
-    Py_ssize_t argc;
-    static char *kwlist[] = {"s", "base", NULL };
-    CTXT_Object *context = NULL;
 
-    if (type != &MPZ_Type) {
-        TYPE_ERROR("mpz.__new__() requires mpz type");
-        return NULL;
+    if (MPZ_Check(n)) {
+        Py_INCREF(n);
+        return n;
     }
 
-    /* Optimize the most common use cases first; either 0 or 1 argument */
-
-    argc = PyTuple_GET_SIZE(args);
+    if (PyLong_Check(n)) {
+        return (PyObject*)GMPy_MPZ_Result_From_PyLong(n, context);
+    }
 
-    if (argc == 0) {
-        return (PyObject*)GMPy_MPZ_New(context);
+    if (MPQ_Check(n)) {
+        return (PyObject*)GMPy_MPZ_From_MPQ((MPQ_Object*)n, context);
     }
 
-    if (argc == 1 && !keywds) {
-        n = PyTuple_GET_ITEM(args, 0);
+    if (MPFR_Check(n)) {
+        return (PyObject*)GMPy_MPZ_From_MPFR((MPFR_Object*)n, context);
+    }
 
-        if (MPZ_Check(n)) {
-            Py_INCREF(n);
-            return n;
-        }
+    if (PyFloat_Check(n)) {
+        return (PyObject*)GMPy_MPZ_From_PyFloat(n, context);
+    }
 
-        if (PyLong_Check(n)) {
-            return (PyObject*)GMPy_MPZ_From_PyLong(n, context);
-        }
+    if (XMPZ_Check(n)) {
+        return (PyObject*)_GMPy_XMPZ_Freeze((XMPZ_Object*)n, context);
+    }
 
-        if (MPQ_Check(n)) {
-            return (PyObject*)GMPy_MPZ_From_MPQ((MPQ_Object*)n, context);
-        }
+    if (Expr_Check(n)) {
+        CHECK_CONTEXT(context);
+        return (PyObject*)GMPy_Expr_Eval((Expr_Object*)n, context);
+    }
 
-        if (MPFR_Check(n)) {
-            return (PyObject*)GMPy_MPZ_From_MPFR((MPFR_Object*)n, context);
-        }
+    if (IS_FRACTION(n)) {
+        MPQ_Object *temp = GMPy_MPQ_From_Fraction(n, context);
 
-        if (PyFloat_Check(n)) {
-            return (PyObject*)GMPy_MPZ_From_PyFloat(n, context);
+        if (temp) {
+            result = GMPy_MPZ_From_MPQ(temp, context);
+            Py_DECREF((PyObject*)temp);
         }
+        return (PyObject*)result;
+    }
 
-        if (XMPZ_Check(n)) {
-            return (PyObject*)GMPy_MPZ_From_XMPZ((XMPZ_Object*)n, context);
-        }
+    if (PyStrOrUnicode_Check(n)) {
+        return (PyObject*)GMPy_MPZ_From_PyStr(n, 0, context);
+    }
 
-        if (IS_FRACTION(n)) {
-            MPQ_Object *temp = GMPy_MPQ_From_Fraction(n, context);
+    if (HAS_MPZ_CONVERSION(n)) {
+        out = (PyObject *) PyObject_CallMethod(n, "__mpz__", NULL);
 
-            if (temp) {
-                result = GMPy_MPZ_From_MPQ(temp, context);
-                Py_DECREF((PyObject*)temp);
-            }
-            return (PyObject*)result;
+        if (out == NULL)
+            return out;
+        if (!MPZ_Check(out)) {
+            PyErr_Format(PyExc_TypeError,
+                         "object of type '%.200s' can not be interpreted as mpz",
+                         out->ob_type->tp_name);
+            Py_DECREF(out);
+            return NULL;
         }
+        return out;
+    }
 
-        if (PyStrOrUnicode_Check(n)) {
-            return (PyObject*)GMPy_MPZ_From_PyStr(n, base, context);
-        }
+    /* Try converting to integer. */
+    temp = PyNumber_Long(n);
+    if (temp) {
+        result = GMPy_MPZ_Result_From_PyLong(temp, context);
+        Py_DECREF(temp);
+        return (PyObject*)result;
+    }
 
-        if (HAS_MPZ_CONVERSION(n)) {
-            out = (PyObject *) PyObject_CallMethod(n, "__mpz__", NULL);
+    TYPE_ERROR("mpz() requires numeric or string argument");
+    return NULL;
+}
 
-            if (out == NULL)
-                return out;
-            if (!MPZ_Check(out)) {
-                PyErr_Format(PyExc_TypeError,
-                             "object of type '%.200s' can not be interpreted as mpz",
-                             out->ob_type->tp_name);
-                Py_DECREF(out);
-                return NULL;
-            }
-            return out;
-        }
+/* GMPy_MPZ_NewInit returns a reference to an initialized MPZ_Object. It is
+ * used by mpz.__new__ to replace the old mpz() factory function.
+ */
 
-        /* Try converting to integer. */
-        temp = PyNumber_Long(n);
-        if (temp) {
-            result = GMPy_MPZ_From_PyLong(temp, context);
-            Py_DECREF(temp);
-            return (PyObject*)result;
-        }
+static PyObject *
+GMPy_MPZ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    PyObject *n = NULL;
+    int base = 0;
+    Py_ssize_t argc;
+    static char *kwlist[] = {"s", "base", NULL };
+    CTXT_Object *context = NULL;
 
-        TYPE_ERROR("mpz() requires numeric or string argument");
+    if (type != &MPZ_Type) {
+        TYPE_ERROR("mpz.__new__() requires mpz type");
         return NULL;
     }
 
+    /* Optimize the most common use cases first; either 0 or 1 argument */
+
+    argc = PyTuple_GET_SIZE(args);
+
+    if (argc == 0 && !keywds) {
+        return (PyObject*)GMPy_MPZ_Small(0);
+    }
+
+    if (argc == 1 && !keywds) {
+        return _GMPy_MPZ_NewInit_One(PyTuple_GET_ITEM(args, 0), context);
+    }
+
     if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|i", kwlist, &n, &base)) {
         return NULL;
     }
@@ -176,18 +542,86 @@ GMPy_MPZ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
     return NULL;
 }
 
+#ifdef GMPY_TYPE_VECTORCALL
+/* The vectorcall constructors handle the common positional calls without
+ * creating an argument tuple. Calls with keywords use tp_new.
+ */
+
+static PyObject *
+GMPy_Vectorcall_NewInit(PyTypeObject *type, PyObject *const *args,
+                        Py_ssize_t nargs, PyObject *kwnames)
+{
+    PyObject *tuple, *keywds = NULL, *result = NULL;
+    Py_ssize_t i, nkw = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+
+    if (!(tuple = PyTuple_New(nargs))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < nargs; i++) {
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(tuple, i, args[i]);
+    }
+
+    if (nkw) {
+        if (!(keywds = PyDict_New())) {
+            /* LCOV_EXCL_START */
+            goto done;
+            /* LCOV_EXCL_STOP */
+        }
+        for (i = 0; i < nkw; i++) {
+            if (PyDict_SetItem(keywds, PyTuple_GET_ITEM(kwnames, i), args[nargs + i]) < 0) {
+                /* LCOV_EXCL_START */
+                goto done;
+                /* LCOV_EXCL_STOP */
+            }
+        }
+    }
+
+    result = type->tp_new(type, tuple, keywds);
+
+  done:
+    Py_DECREF(tuple);
+    Py_XDECREF(keywds);
+    return result;
+}
+
+static PyObject *
+GMPy_MPZ_Vectorcall(PyObject *type, PyObject *const *args, size_t nargsf,
+                    PyObject *kwnames)
+{
+    Py_ssize_t nargs = PyVectorcall_NARGS(nargsf);
+    CTXT_Object *context = NULL;
+
+    if (!kwnames) {
+        if (nargs == 0)
+            return (PyObject*)GMPy_MPZ_Small(0);
+        if (nargs == 1)
+            return _GMPy_MPZ_NewInit_One(args[0], context);
+    }
+    return GMPy_Vectorcall_NewInit((PyTypeObject*)type, args, nargs, kwnames);
+}
+#endif
+
 static void
 GMPy_MPZ_Dealloc(MPZ_Object *self)
 {
-   if (global.in_gmpympzcache < CACHE_SIZE &&
-       self->z->_mp_alloc <= MAX_CACHE_MPZ_LIMBS) {
-        
-        global.gmpympzcache[(global.in_gmpympzcache)++] = self;
-    }
-    else {
-        mpz_clear(self->z);
-        PyObject_Del(self);
+    gmpy_cache *cache = GMPY_CACHE;
+
+    CACHE_DEALLOC(cache, GMPY_CACHE_MPZ);
+    if (cache && _GMPy_MPZ_Cache_Fit(self->z, GMPY_CACHE_MPZ)) {
+        int n = _GMPy_MPZ_Cache_Class(self->z->_mp_alloc);
+
+        GMPY_CACHE_SPILL(cache, gmpympzcache[n], in_gmpympzcache[n], GMPY_CACHE_MPZ);
+        if (cache->in_gmpympzcache[n] < global.cache_size[GMPY_CACHE_MPZ]) {
+            cache->gmpympzcache[n][(cache->in_gmpympzcache[n])++] = self;
+            return;
+        }
     }
+    CACHE_EVICT(cache, GMPY_CACHE_MPZ);
+    mpz_clear(self->z);
+    PyObject_Del(self);
 }
 
 /* Caching logic for Pyxmpz. */
@@ -196,19 +630,28 @@ static XMPZ_Object *
 GMPy_XMPZ_New(CTXT_Object *context)
 {
     XMPZ_Object *result = NULL;
+    gmpy_cache *cache = GMPY_CACHE;
 
-    if (global.in_gmpyxmpzcache) {
-        result = global.gmpyxmpzcache[--(global.in_gmpyxmpzcache)];
+    GMPY_MPZ_CACHE_GET(result, cache, gmpyxmpzcache, in_gmpyxmpzcache,
+                       GMPY_CACHE_XMPZ, 1);
+    if (result) {
+        CACHE_HIT(cache, GMPY_CACHE_XMPZ, context);
         Py_INCREF((PyObject*)result);
         mpz_set_ui(result->z, 0);
     }
     else {
+        CACHE_MISS(cache, GMPY_CACHE_XMPZ, context);
         result = PyObject_New(XMPZ_Object, &XMPZ_Type);
         if (result == NULL) {
             return NULL;
         }
        mpz_init(result->z);
     }
+    result->exports = 0;
+    result->owner = NULL;
+#ifdef Py_GIL_DISABLED
+    result->mutex = (PyMutex){0};
+#endif
     return result;
 }
 
@@ -232,7 +675,7 @@ GMPy_XMPZ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
 
     argc = PyTuple_GET_SIZE(args);
 
-    if (argc == 0) {
+    if (argc == 0 && !keywds) {
         return (PyObject*)GMPy_XMPZ_New(context);
     }
 
@@ -315,46 +758,191 @@ GMPy_XMPZ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
 static void
 GMPy_XMPZ_Dealloc(XMPZ_Object *self)
 {
-   if (global.in_gmpyxmpzcache < CACHE_SIZE &&
-       self->z->_mp_alloc <= MAX_CACHE_MPZ_LIMBS) {
-        
-        global.gmpyxmpzcache[(global.in_gmpyxmpzcache)++] = self;
-    }
-    else {
-        mpz_clear(self->z);
-        PyObject_Del((PyObject*)self);
+    gmpy_cache *cache = GMPY_CACHE;
+
+    CACHE_DEALLOC(cache, GMPY_CACHE_XMPZ);
+    if (self->owner) {
+        if (self->z->_mp_alloc == 0)
+            mpz_init(self->z);
+        Py_CLEAR(self->owner);
+    }
+    if (cache && _GMPy_MPZ_Cache_Fit(self->z, GMPY_CACHE_XMPZ)) {
+        int n = _GMPy_MPZ_Cache_Class(self->z->_mp_alloc);
+
+        GMPY_CACHE_SPILL(cache, gmpyxmpzcache[n], in_gmpyxmpzcache[n], GMPY_CACHE_XMPZ);
+        if (cache->in_gmpyxmpzcache[n] < global.cache_size[GMPY_CACHE_XMPZ]) {
+            cache->gmpyxmpzcache[n][(cache->in_gmpyxmpzcache[n])++] = self;
+            return;
+        }
+    }
+    CACHE_EVICT(cache, GMPY_CACHE_XMPZ);
+    mpz_clear(self->z);
+    PyObject_Del((PyObject*)self);
+}
+
+/* Caching logic for Pympq. */
+
+static MPQ_Object *
+GMPy_MPQ_New(CTXT_Object *context)
+{
+    return GMPy_MPQ_NewSize(1, context);
+}
+
+/* GMPy_MPQ_NewSize returns a reference to a new MPQ_Object whose numerator
+ * and denominator both have room for at least size limbs. The value is
+ * initialized to 0. The numerator and denominator of a cached object keep
+ * their storage.
+ */
+
+static MPQ_Object *
+GMPy_MPQ_NewSize(mp_size_t size, CTXT_Object *context)
+{
+    MPQ_Object *result = NULL;
+    gmpy_cache *cache = GMPY_CACHE;
+
+    GMPY_MPZ_CACHE_GET(result, cache, gmpympqcache, in_gmpympqcache,
+                       GMPY_CACHE_MPQ, size);
+    if (result) {
+        CACHE_HIT(cache, GMPY_CACHE_MPQ, context);
+        Py_INCREF((PyObject*)result);
+        mpq_set_ui(result->q, 0, 1);
+    }
+    else {
+        CACHE_MISS(cache, GMPY_CACHE_MPQ, context);
+        result = PyObject_New(MPQ_Object, &MPQ_Type);
+        if (result == NULL) {
+            return NULL;
+        }
+        if (size > 1) {
+            mpz_init2(mpq_numref(result->q), (mp_bitcnt_t)size * GMP_NUMB_BITS);
+            mpz_init2(mpq_denref(result->q), (mp_bitcnt_t)size * GMP_NUMB_BITS);
+            mpz_set_ui(mpq_denref(result->q), 1);
+        }
+        else {
+            mpq_init(result->q);
+        }
+    }
+    result->hash_cache = -1;
+    return result;
+}
+
+/* Return mpq(n, m) for integer or rational n and m. */
+
+static PyObject *
+_GMPy_MPQ_NewInit_Div(PyObject *n, PyObject *m, CTXT_Object *context)
+{
+    MPQ_Object *result = NULL, *temp = NULL;
+
+    result = GMPy_MPQ_From_RationalAndCopy(n, context);
+    temp = GMPy_MPQ_From_Rational(m, context);
+    if (!result || !temp) {
+        Py_XDECREF((PyObject*)result);
+        Py_XDECREF((PyObject*)temp);
+        return NULL;
+    }
+
+    if (mpq_sgn(temp->q) == 0) {
+        ZERO_ERROR("zero denominator in mpq()");
+        Py_DECREF((PyObject*)result);
+        Py_DECREF((PyObject*)temp);
+        return NULL;
+    }
+
+    mpq_div(result->q, result->q, temp->q);
+    Py_DECREF((PyObject*)temp);
+    return (PyObject*)result;
+}
+
+/* Set z to the integer x. Returns -1 with an exception set if x is not an
+ * integer.
+ */
+
+static int
+_GMPy_MPQ_Set_Part(mpz_ptr z, PyObject *x, CTXT_Object *context)
+{
+    MPZ_Object *temp;
+
+    if (MPZ_Check(x) || XMPZ_Check(x)) {
+        mpz_set(z, MPZ(x));
+    }
+    else if (PyLong_Check(x)) {
+        mpz_set_PyLong(z, x);
+    }
+    else {
+        if (!(temp = GMPy_MPZ_From_Integer(x, context)))
+            return -1;
+        mpz_set(z, temp->z);
+        Py_DECREF((PyObject*)temp);
+    }
+    return 0;
+}
+
+/* Make the denominator of q positive. The caller promises that numerator
+ * and denominator are coprime, so mpq_canonicalize() is not needed; debug
+ * builds of Python still check it. Returns -1 with an exception set if q
+ * is not canonical.
+ */
+
+static int
+_GMPy_MPQ_Finish_Canonical(mpq_ptr q, const char *name)
+{
+    if (mpz_sgn(mpq_denref(q)) == 0) {
+        PyErr_Format(PyExc_ZeroDivisionError, "zero denominator in %s()", name);
+        return -1;
+    }
+    if (mpz_sgn(mpq_denref(q)) < 0) {
+        mpz_neg(mpq_numref(q), mpq_numref(q));
+        mpz_neg(mpq_denref(q), mpq_denref(q));
+    }
+#ifdef Py_DEBUG
+    {
+        mpz_t g;
+        int coprime;
+
+        mpz_init(g);
+        mpz_gcd(g, mpq_numref(q), mpq_denref(q));
+        coprime = mpz_sgn(mpq_numref(q)) ? mpz_cmp_ui(g, 1) == 0 : mpz_cmp_ui(mpq_denref(q), 1) == 0;
+        mpz_clear(g);
+        if (!coprime) {
+            PyErr_Format(PyExc_ValueError,
+                         "%s() with canonical=True requires a reduced fraction", name);
+            return -1;
+        }
     }
+#endif
+    return 0;
 }
 
-/* Caching logic for Pympq. */
+/* Return mpq(n, m, canonical=True) for integer n and m. */
 
-static MPQ_Object *
-GMPy_MPQ_New(CTXT_Object *context)
+static PyObject *
+_GMPy_MPQ_NewInit_Canonical(PyObject *n, PyObject *m, CTXT_Object *context)
 {
-    MPQ_Object *result = NULL;
+    MPQ_Object *result;
 
-    if (global.in_gmpympqcache) {
-        result = global.gmpympqcache[--(global.in_gmpympqcache)];
-        Py_INCREF((PyObject*)result);
-        mpq_set_ui(result->q, 0, 1);
+    if (!IS_INTEGER(n) || !IS_INTEGER(m)) {
+        TYPE_ERROR("mpq() with canonical=True requires integer arguments");
+        return NULL;
     }
-    else {
-        result = PyObject_New(MPQ_Object, &MPQ_Type);
-        if (result == NULL) {
-            return NULL;
-        }
-        mpq_init(result->q);
+
+    if (!(result = GMPy_MPQ_New(context)))
+        return NULL;
+
+    if (_GMPy_MPQ_Set_Part(mpq_numref(result->q), n, context) < 0 ||
+        _GMPy_MPQ_Set_Part(mpq_denref(result->q), m, context) < 0 ||
+        _GMPy_MPQ_Finish_Canonical(result->q, "mpq") < 0) {
+        Py_DECREF((PyObject*)result);
+        return NULL;
     }
-    result->hash_cache = -1;
-    return result;
+    return (PyObject*)result;
 }
 
 static PyObject *
 GMPy_MPQ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
 {
-    MPQ_Object *result = NULL, *temp = NULL;
-    PyObject *n = NULL, *m = NULL;
-    int base = 10;
+    MPQ_Object *result = NULL;
+    PyObject *n = NULL, *m = NULL, *temp;
+    int base = 10, canonical;
     Py_ssize_t argc, keywdc = 0;
     static char *kwlist[] = {"s", "base", NULL };
     CTXT_Object *context = NULL;
@@ -369,6 +957,23 @@ GMPy_MPQ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
         keywdc = PyDict_Size(keywds);
     }
 
+    if (keywdc && (temp = PyDict_GetItemString(keywds, "canonical"))) {
+        if (argc != 2 || keywdc != 1) {
+            TYPE_ERROR("mpq() with canonical requires 2 integer arguments");
+            return NULL;
+        }
+        if ((canonical = PyObject_IsTrue(temp)) < 0)
+            return NULL;
+        n = PyTuple_GetItem(args, 0);
+        m = PyTuple_GetItem(args, 1);
+        if (canonical)
+            return _GMPy_MPQ_NewInit_Canonical(n, m, context);
+        if (IS_RATIONAL(n) && IS_RATIONAL(m))
+            return _GMPy_MPQ_NewInit_Div(n, m, context);
+        TYPE_ERROR("mpq() requires numeric or string argument");
+        return NULL;
+    }
+
     if (argc + keywdc > 2) {
         TYPE_ERROR("mpq() takes at most 2 arguments");
         return NULL;
@@ -417,24 +1022,7 @@ GMPy_MPQ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
         m = PyTuple_GetItem(args, 1);
 
         if (IS_RATIONAL(n) && IS_RATIONAL(m)) {
-           result = GMPy_MPQ_From_RationalAndCopy(n, context);
-           temp = GMPy_MPQ_From_Rational(m, context);
-           if (!result || !temp) {
-               Py_XDECREF((PyObject*)result);
-               Py_XDECREF((PyObject*)temp);
-               return NULL;
-            }
-
-            if (mpq_sgn(temp->q) == 0) {
-                ZERO_ERROR("zero denominator in mpq()");
-                Py_DECREF((PyObject*)result);
-                Py_DECREF((PyObject*)temp);
-                return NULL;
-            }
-
-            mpq_div(result->q, result->q, temp->q);
-            Py_DECREF((PyObject*)temp);
-            return (PyObject*)result;
+            return _GMPy_MPQ_NewInit_Div(n, m, context);
         }
     }
 
@@ -442,19 +1030,60 @@ GMPy_MPQ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
     return NULL;
 }
 
+#ifdef GMPY_TYPE_VECTORCALL
+static PyObject *
+GMPy_MPQ_Vectorcall(PyObject *type, PyObject *const *args, size_t nargsf,
+                    PyObject *kwnames)
+{
+    MPQ_Object *result;
+    Py_ssize_t nargs = PyVectorcall_NARGS(nargsf);
+    CTXT_Object *context = NULL;
+
+    if (!kwnames) {
+        if (nargs == 0) {
+            if ((result = GMPy_MPQ_New(context))) {
+                mpq_set_ui(result->q, 0, 1);
+            }
+            return (PyObject*)result;
+        }
+        if (nargs == 1 && PyStrOrUnicode_Check(args[0])) {
+            return (PyObject*)GMPy_MPQ_From_PyStr(args[0], 10, context);
+        }
+        if (nargs == 1 && IS_REAL(args[0])) {
+            return (PyObject*)GMPy_MPQ_From_Number(args[0], context);
+        }
+        if (nargs == 2 && IS_RATIONAL(args[0]) && IS_RATIONAL(args[1])) {
+            return _GMPy_MPQ_NewInit_Div(args[0], args[1], context);
+        }
+    }
+    else if (nargs == 2 && PyTuple_GET_SIZE(kwnames) == 1 &&
+             PyUnicode_CompareWithASCIIString(PyTuple_GET_ITEM(kwnames, 0), "canonical") == 0 &&
+             args[2] == Py_True) {
+        return _GMPy_MPQ_NewInit_Canonical(args[0], args[1], context);
+    }
+    return GMPy_Vectorcall_NewInit((PyTypeObject*)type, args, nargs, kwnames);
+}
+#endif
+
 static void
 GMPy_MPQ_Dealloc(MPQ_Object *self)
 {
-    if (global.in_gmpympqcache < CACHE_SIZE &&
-        mpq_numref(self->q)->_mp_alloc <= MAX_CACHE_MPZ_LIMBS &&
-        mpq_denref(self->q)->_mp_alloc <= MAX_CACHE_MPZ_LIMBS) {
+    gmpy_cache *cache = GMPY_CACHE;
 
-        global.gmpympqcache[(global.in_gmpympqcache)++] = self;
-    }
-    else {
-        mpq_clear(self->q);
-        PyObject_Del(self);
+    CACHE_DEALLOC(cache, GMPY_CACHE_MPQ);
+    if (cache && MPQ_CACHEABLE(self)) {
+        int n = _GMPy_MPZ_Cache_Class(Py_MIN(mpq_numref(self->q)->_mp_alloc,
+                                             mpq_denref(self->q)->_mp_alloc));
+
+        GMPY_CACHE_SPILL(cache, gmpympqcache[n], in_gmpympqcache[n], GMPY_CACHE_MPQ);
+        if (cache->in_gmpympqcache[n] < global.cache_size[GMPY_CACHE_MPQ]) {
+            cache->gmpympqcache[n][(cache->in_gmpympqcache[n])++] = self;
+            return;
+        }
     }
+    CACHE_EVICT(cache, GMPY_CACHE_MPQ);
+    mpq_clear(self->q);
+    PyObject_Del(self);
 }
 
 /* Caching logic for Pympfr. */
@@ -463,6 +1092,7 @@ static MPFR_Object *
 GMPy_MPFR_New(mpfr_prec_t bits, CTXT_Object *context)
 {
     MPFR_Object *result;
+    gmpy_cache *cache;
 
     if (bits < 2) {
         CHECK_CONTEXT(context);
@@ -474,22 +1104,64 @@ GMPy_MPFR_New(mpfr_prec_t bits, CTXT_Object *context)
         return NULL;
     }
 
-    if (global.in_gmpympfrcache) {
-        result = global.gmpympfrcache[--(global.in_gmpympfrcache)];
-        Py_INCREF((PyObject*)result);
-    }
-    else {
-        result = PyObject_New(MPFR_Object, &MPFR_Type);
-        if (result == NULL) {
-            return NULL;
+    cache = GMPY_CACHE;
+    if (MPFR_CACHEABLE(bits)) {
+        int bucket = (int)MPFR_CACHE_BUCKET(bits);
+
+        GMPY_CACHE_REFILL(cache, gmpympfrcache[bucket], in_gmpympfrcache[bucket],
+                          GMPY_CACHE_MPFR);
+        if (cache && cache->in_gmpympfrcache[bucket]) {
+            CACHE_HIT(cache, GMPY_CACHE_MPFR, context);
+            result = cache->gmpympfrcache[bucket][--(cache->in_gmpympfrcache[bucket])];
+            Py_INCREF((PyObject*)result);
+            /* The mantissa is already large enough so neither call
+             * allocates memory. */
+            if (mpfr_get_prec(result->f) != bits) {
+                mpfr_set_prec(result->f, bits);
+            }
+            else {
+                mpfr_set_nan(result->f);
+            }
+            result->hash_cache = -1;
+            result->rc = 0;
+            return result;
         }
     }
+
+    CACHE_MISS(cache, GMPY_CACHE_MPFR, context);
+    result = PyObject_New(MPFR_Object, &MPFR_Type);
+    if (result == NULL) {
+        return NULL;
+    }
     mpfr_init2(result->f, bits);
     result->hash_cache = -1;
     result->rc = 0;
     return result;
 }
 
+/* Like GMPy_MPZ_Reuse(), but for an mpfr x whose precision matches the
+ * context.
+ */
+
+static MPFR_Object *
+GMPy_MPFR_Reuse(PyObject *x, int xtype, CTXT_Object *context)
+{
+#ifdef GMPY_TEMP_ELISION
+    CHECK_CONTEXT(context);
+
+    if (IS_TYPE_MPFR(xtype) &&
+        mpfr_get_prec(MPFR(x)) == GET_MPFR_PREC(context) &&
+        GMPY_IS_TEMPORARY(x)) {
+
+        Py_INCREF(x);
+        ((MPFR_Object*)x)->hash_cache = -1;
+        ((MPFR_Object*)x)->rc = 0;
+        return (MPFR_Object*)x;
+    }
+#endif
+    return NULL;
+}
+
 static PyObject *
 GMPy_MPFR_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
 {
@@ -604,24 +1276,79 @@ GMPy_MPFR_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
     return NULL;
 }
 
-static void
-GMPy_MPFR_Dealloc(MPFR_Object *self)
+#ifdef GMPY_TYPE_VECTORCALL
+static PyObject *
+GMPy_MPFR_Vectorcall(PyObject *type, PyObject *const *args, size_t nargsf,
+                     PyObject *kwnames)
 {
-    if (global.in_gmpympfrcache < CACHE_SIZE &&
-        self->f->_mpfr_prec <= MAX_CACHE_MPFR_BITS) {
+    MPFR_Object *result;
+    Py_ssize_t nargs = PyVectorcall_NARGS(nargsf);
+    mpfr_prec_t prec = 0;
+    CTXT_Object *context = NULL;
+
+    if (kwnames || nargs > 2)
+        return GMPy_Vectorcall_NewInit((PyTypeObject*)type, args, nargs, kwnames);
 
-        global.gmpympfrcache[(global.in_gmpympfrcache)++] = self;
+    CHECK_CONTEXT(context);
+
+    if (nargs == 0) {
+        if ((result = GMPy_MPFR_New(0, context))) {
+            mpfr_set_ui(result->f, 0, MPFR_RNDN);
+        }
+        return (PyObject*)result;
     }
-    else {
-        mpfr_clear(self->f);
-        PyObject_Del(self);
+
+    if (nargs == 1 && PyStrOrUnicode_Check(args[0])) {
+        return (PyObject*)GMPy_MPFR_From_PyStr(args[0], 0, 0, context);
+    }
+
+    /* mpfr(x) and mpfr(x, precision) for a number x. */
+    if (!PyStrOrUnicode_Check(args[0]) && !HAS_MPFR_CONVERSION(args[0]) &&
+        IS_REAL(args[0]) && (nargs == 1 || PyLong_Check(args[1]))) {
+        if (nargs == 2) {
+            prec = PyLong_AsLong(args[1]);
+            if (prec == -1 && PyErr_Occurred()) {
+                return NULL;
+            }
+            if (prec < 0) {
+                VALUE_ERROR("precision for mpfr() must be >= 0");
+                return NULL;
+            }
+        }
+        return (PyObject*)GMPy_MPFR_From_Real(args[0], prec, context);
+    }
+
+    return GMPy_Vectorcall_NewInit((PyTypeObject*)type, args, nargs, kwnames);
+}
+#endif
+
+static void
+GMPy_MPFR_Dealloc(MPFR_Object *self)
+{
+    gmpy_cache *cache = GMPY_CACHE;
+    mpfr_prec_t bits = mpfr_get_prec(self->f);
+
+    CACHE_DEALLOC(cache, GMPY_CACHE_MPFR);
+    if (MPFR_CACHEABLE(bits)) {
+        int bucket = (int)MPFR_CACHE_BUCKET(bits);
+
+        GMPY_CACHE_SPILL(cache, gmpympfrcache[bucket], in_gmpympfrcache[bucket],
+                         GMPY_CACHE_MPFR);
+        if (cache && cache->in_gmpympfrcache[bucket] < global.cache_size[GMPY_CACHE_MPFR]) {
+            cache->gmpympfrcache[bucket][(cache->in_gmpympfrcache[bucket])++] = self;
+            return;
+        }
     }
+    CACHE_EVICT(cache, GMPY_CACHE_MPFR);
+    mpfr_clear(self->f);
+    PyObject_Del(self);
 }
 
 static MPC_Object *
 GMPy_MPC_New(mpfr_prec_t rprec, mpfr_prec_t iprec, CTXT_Object *context)
 {
     MPC_Object *result;
+    gmpy_cache *cache;
 
     if (rprec < 2) {
         CHECK_CONTEXT(context);
@@ -638,27 +1365,80 @@ GMPy_MPC_New(mpfr_prec_t rprec, mpfr_prec_t iprec, CTXT_Object *context)
         VALUE_ERROR("invalid value for precision");
         return NULL;
     }
-    if (global.in_gmpympccache) {
-        result = global.gmpympccache[--(global.in_gmpympccache)];
+
+    cache = GMPY_CACHE;
+    GMPY_CACHE_REFILL(cache, gmpympccache, in_gmpympccache, GMPY_CACHE_MPC);
+    if (cache && cache->in_gmpympccache) {
+        CACHE_HIT(cache, GMPY_CACHE_MPC, context);
+        result = cache->gmpympccache[--(cache->in_gmpympccache)];
         Py_INCREF((PyObject*)result);
+        /* Cached objects keep their storage. mpfr_set_prec() only
+         * reallocates if the new precision requires more limbs. */
+        if (mpfr_get_prec(mpc_realref(result->c)) != rprec)
+            mpfr_set_prec(mpc_realref(result->c), rprec);
+        else
+            mpfr_set_nan(mpc_realref(result->c));
+        if (mpfr_get_prec(mpc_imagref(result->c)) != iprec)
+            mpfr_set_prec(mpc_imagref(result->c), iprec);
+        else
+            mpfr_set_nan(mpc_imagref(result->c));
     }
     else {
+        CACHE_MISS(cache, GMPY_CACHE_MPC, context);
         result = PyObject_New(MPC_Object, &MPC_Type);
         if (result == NULL) {
             return NULL;
         }
+        mpc_init3(result->c, rprec, iprec);
     }
-    mpc_init3(result->c, rprec, iprec);
     result->hash_cache = -1;
     result->rc = 0;
     return result;
 }
 
+/* Return mpc(real, imag) for real numbers; imag may be NULL. */
+
 static PyObject *
-GMPy_MPC_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+_GMPy_MPC_NewInit_Real(PyObject *real, PyObject *imag, mpfr_prec_t rprec,
+                       mpfr_prec_t iprec, CTXT_Object *context)
 {
     MPC_Object *result = NULL;
     MPFR_Object *tempreal = NULL, *tempimag = NULL;
+
+    if (imag && !IS_REAL(imag)) {
+        TYPE_ERROR("invalid type for imaginary component in mpc()");
+        return NULL;
+    }
+
+    tempreal = GMPy_MPFR_From_Real(real, rprec, context);
+    if (imag) {
+        tempimag = GMPy_MPFR_From_Real(imag, iprec, context);
+    }
+    else {
+        if ((tempimag = GMPy_MPFR_New(iprec, context))) {
+            mpfr_set_ui(tempimag->f, 0, MPFR_RNDN);
+        }
+    }
+
+    result = GMPy_MPC_New(rprec, iprec, context);
+    if (!tempreal || !tempimag || !result) {
+        Py_XDECREF(tempreal);
+        Py_XDECREF(tempimag);
+        Py_XDECREF(result);
+        TYPE_ERROR("mpc() requires string or numeric argument.");
+        return NULL;
+    }
+
+    mpc_set_fr_fr(result->c, tempreal->f, tempimag->f, GET_MPC_ROUND(context));
+    Py_DECREF(tempreal);
+    Py_DECREF(tempimag);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_MPC_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    MPC_Object *result = NULL;
     PyObject *arg0 = NULL, *arg1 = NULL, *prec = NULL, *out = NULL;
     int base = 10;
     Py_ssize_t argc = 0, keywdc = 0;
@@ -803,34 +1583,7 @@ GMPy_MPC_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
             }
         }
 
-        if (arg1 && !IS_REAL(arg1)) {
-            TYPE_ERROR("invalid type for imaginary component in mpc()");
-            return NULL;
-        }
-
-        tempreal = GMPy_MPFR_From_Real(arg0, rprec, context);
-        if (arg1) {
-            tempimag = GMPy_MPFR_From_Real(arg1, iprec, context);
-        }
-        else {
-            if ((tempimag = GMPy_MPFR_New(iprec, context))) {
-                mpfr_set_ui(tempimag->f, 0, MPFR_RNDN);
-            }
-        }
-
-        result = GMPy_MPC_New(rprec, iprec, context);
-        if (!tempreal || !tempimag || !result) {
-            Py_XDECREF(tempreal);
-            Py_XDECREF(tempimag);
-            Py_XDECREF(result);
-            TYPE_ERROR("mpc() requires string or numeric argument.");
-            return NULL;
-        }
-
-        mpc_set_fr_fr(result->c, tempreal->f, tempimag->f, GET_MPC_ROUND(context));
-        Py_DECREF(tempreal);
-        Py_DECREF(tempimag);
-        return (PyObject*)result;
+        return _GMPy_MPC_NewInit_Real(arg0, arg1, rprec, iprec, context);
     }
 
     if (IS_COMPLEX_ONLY(arg0)) {
@@ -878,18 +1631,437 @@ GMPy_MPC_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
     return NULL;
 }
 
+#ifdef GMPY_TYPE_VECTORCALL
+static PyObject *
+GMPy_MPC_Vectorcall(PyObject *type, PyObject *const *args, size_t nargsf,
+                    PyObject *kwnames)
+{
+    MPC_Object *result;
+    Py_ssize_t nargs = PyVectorcall_NARGS(nargsf);
+    CTXT_Object *context = NULL;
+
+    if (kwnames || nargs > 2)
+        return GMPy_Vectorcall_NewInit((PyTypeObject*)type, args, nargs, kwnames);
+
+    CHECK_CONTEXT(context);
+
+    if (nargs == 0) {
+        if ((result = GMPy_MPC_New(0, 0, context))) {
+            mpc_set_ui(result->c, 0, GET_MPC_ROUND(context));
+        }
+        return (PyObject*)result;
+    }
+
+    if (PyStrOrUnicode_Check(args[0]) || HAS_MPC_CONVERSION(args[0]))
+        return GMPy_Vectorcall_NewInit((PyTypeObject*)type, args, nargs, kwnames);
+
+    /* mpc(x) and mpc(real, imag). */
+    if (IS_REAL(args[0])) {
+        return _GMPy_MPC_NewInit_Real(args[0], nargs == 2 ? args[1] : NULL,
+                                      0, 0, context);
+    }
+
+    if (nargs == 1 && IS_COMPLEX_ONLY(args[0])) {
+        if (PyComplex_Check(args[0])) {
+            return (PyObject*)GMPy_MPC_From_PyComplex(args[0], 0, 0, context);
+        }
+        return (PyObject*)GMPy_MPC_From_MPC((MPC_Object*)args[0], 0, 0, context);
+    }
+
+    return GMPy_Vectorcall_NewInit((PyTypeObject*)type, args, nargs, kwnames);
+}
+#endif
+
 static void
 GMPy_MPC_Dealloc(MPC_Object *self)
 {
-    if (global.in_gmpympccache < CACHE_SIZE &&
-        mpc_realref(self->c)->_mpfr_prec <= MAX_CACHE_MPFR_BITS &&
-        mpc_imagref(self->c)->_mpfr_prec <= MAX_CACHE_MPFR_BITS) {
+    gmpy_cache *cache = GMPY_CACHE;
+
+    CACHE_DEALLOC(cache, GMPY_CACHE_MPC);
+    GMPY_CACHE_SPILL(cache, gmpympccache, in_gmpympccache, GMPY_CACHE_MPC);
+    if (cache && cache->in_gmpympccache < global.cache_size[GMPY_CACHE_MPC] &&
+        MPC_CACHEABLE(self)) {
 
-        global.gmpympccache[(global.in_gmpympccache)++] = self;
+        cache->gmpympccache[(cache->in_gmpympccache)++] = self;
     }
     else {
+        CACHE_EVICT(cache, GMPY_CACHE_MPC);
         mpc_clear(self->c);
         PyObject_Del(self);
     }
 }
 
+
+#ifdef Py_GIL_DISABLED
+
+/* Return the objects held by a private cache to the shared pool. Objects
+ * that do not fit in the pool are freed.
+ */
+
+#define GMPY_CACHE_RELEASE(NAME, COUNT, TYPE, CLEAR, FIELD) \
+    while (cache->COUNT && global.cache.COUNT < global.cache_size[TYPE]) { \
+        global.cache.NAME[(global.cache.COUNT)++] = cache->NAME[--(cache->COUNT)]; \
+    } \
+    while (cache->COUNT) { \
+        CLEAR(cache->NAME[--(cache->COUNT)]->FIELD); \
+        PyObject_Del(cache->NAME[cache->COUNT]); \
+        global.cache.stats[TYPE].evictions++; \
+    }
+
+static void
+_GMPy_Cache_Release(gmpy_cache *cache)
+{
+    PyMutex_Lock(&global.cache_lock);
+    for (int n = 0; n < MPZ_CACHE_CLASSES; n++) {
+        GMPY_CACHE_RELEASE(gmpympzcache[n], in_gmpympzcache[n],
+                           GMPY_CACHE_MPZ, mpz_clear, z);
+        GMPY_CACHE_RELEASE(gmpyxmpzcache[n], in_gmpyxmpzcache[n],
+                           GMPY_CACHE_XMPZ, mpz_clear, z);
+    }
+    for (int n = 0; n < MPZ_CACHE_CLASSES; n++) {
+        GMPY_CACHE_RELEASE(gmpympqcache[n], in_gmpympqcache[n],
+                           GMPY_CACHE_MPQ, mpq_clear, q);
+    }
+    for (int bucket = 0; bucket < MPFR_CACHE_BUCKETS; bucket++) {
+        GMPY_CACHE_RELEASE(gmpympfrcache[bucket], in_gmpympfrcache[bucket],
+                           GMPY_CACHE_MPFR, mpfr_clear, f);
+    }
+    GMPY_CACHE_RELEASE(gmpympccache, in_gmpympccache, GMPY_CACHE_MPC, mpc_clear, c);
+
+    /* Keep the statistics of threads that have exited. */
+    for (int i = 0; i < GMPY_CACHE_TYPES; i++) {
+        global.cache.stats[i].hits += cache->stats[i].hits;
+        global.cache.stats[i].misses += cache->stats[i].misses;
+        global.cache.stats[i].evictions += cache->stats[i].evictions;
+        global.cache.stats[i].live += cache->stats[i].live;
+        global.cache.stats[i].peak += cache->stats[i].peak;
+    }
+    PyMutex_Unlock(&global.cache_lock);
+}
+
+#endif
+
+/* Free the cached objects that no longer fit the limits set by set_cache().
+ * If keep is not NULL, objects are also freed if keep() returns 0 for the
+ * storage of any of their components.
+ */
+
+#define GMPY_CACHE_TRIM(NAME, COUNT, TYPE, FITS, CLEAR, FIELD) \
+    { \
+        int i, kept = 0; \
+        for (i = 0; i < cache->COUNT; i++) { \
+            if (kept < global.cache_size[TYPE] && FITS) { \
+                cache->NAME[kept++] = cache->NAME[i]; \
+            } \
+            else { \
+                CLEAR(cache->NAME[i]->FIELD); \
+                PyObject_Del(cache->NAME[i]); \
+                cache->stats[TYPE].evictions++; \
+            } \
+        } \
+        cache->COUNT = kept; \
+    }
+
+#define KEEP(ptr) (!keep || keep((ptr), arg))
+
+static void
+_GMPy_Cache_Trim(gmpy_cache *cache, int type, int (*keep)(void *, void *),
+                 void *arg)
+{
+    switch (type) {
+    case GMPY_CACHE_MPZ:
+        for (int n = 0; n < MPZ_CACHE_CLASSES; n++) {
+            GMPY_CACHE_TRIM(gmpympzcache[n], in_gmpympzcache[n], GMPY_CACHE_MPZ,
+                            MPZ_CACHEABLE(cache->gmpympzcache[n][i], GMPY_CACHE_MPZ) &&
+                            KEEP(cache->gmpympzcache[n][i]->z->_mp_d),
+                            mpz_clear, z);
+        }
+        break;
+    case GMPY_CACHE_XMPZ:
+        for (int n = 0; n < MPZ_CACHE_CLASSES; n++) {
+            GMPY_CACHE_TRIM(gmpyxmpzcache[n], in_gmpyxmpzcache[n], GMPY_CACHE_XMPZ,
+                            MPZ_CACHEABLE(cache->gmpyxmpzcache[n][i], GMPY_CACHE_XMPZ) &&
+                            KEEP(cache->gmpyxmpzcache[n][i]->z->_mp_d),
+                            mpz_clear, z);
+        }
+        break;
+    case GMPY_CACHE_MPQ:
+        for (int n = 0; n < MPZ_CACHE_CLASSES; n++) {
+            GMPY_CACHE_TRIM(gmpympqcache[n], in_gmpympqcache[n], GMPY_CACHE_MPQ,
+                            MPQ_CACHEABLE(cache->gmpympqcache[n][i]) &&
+                            KEEP(mpq_numref(cache->gmpympqcache[n][i]->q)->_mp_d) &&
+                            KEEP(mpq_denref(cache->gmpympqcache[n][i]->q)->_mp_d),
+                            mpq_clear, q);
+        }
+        break;
+    case GMPY_CACHE_MPFR:
+        for (int bucket = 0; bucket < MPFR_CACHE_BUCKETS; bucket++) {
+            GMPY_CACHE_TRIM(gmpympfrcache[bucket], in_gmpympfrcache[bucket],
+                            GMPY_CACHE_MPFR,
+                            bucket < global.cache_limbs[GMPY_CACHE_MPFR] &&
+                            KEEP(cache->gmpympfrcache[bucket][i]->f->_mpfr_d),
+                            mpfr_clear, f);
+        }
+        break;
+    case GMPY_CACHE_MPC:
+        GMPY_CACHE_TRIM(gmpympccache, in_gmpympccache, GMPY_CACHE_MPC,
+                        MPC_CACHEABLE(cache->gmpympccache[i]) &&
+                        KEEP(mpc_realref(cache->gmpympccache[i]->c)->_mpfr_d) &&
+                        KEEP(mpc_imagref(cache->gmpympccache[i]->c)->_mpfr_d),
+                        mpc_clear, c);
+        break;
+    }
+}
+
+#undef KEEP
+
+/* Free the cached objects for which keep() returns 0. Used to release the
+ * storage of an arena (see gmpy2_alloc.c).
+ */
+
+static void
+_GMPy_Cache_Drop(int (*keep)(void *, void *), void *arg)
+{
+    gmpy_cache *cache = GMPY_CACHE;
+
+    for (int type = 0; type < GMPY_CACHE_TYPES; type++) {
+#ifdef Py_GIL_DISABLED
+        PyMutex_Lock(&global.cache_lock);
+        _GMPy_Cache_Trim(&global.cache, type, keep, arg);
+        PyMutex_Unlock(&global.cache_lock);
+        if (cache)
+            _GMPy_Cache_Trim(cache, type, keep, arg);
+#else
+        _GMPy_Cache_Trim(cache, type, keep, arg);
+#endif
+    }
+}
+
+static int
+_GMPy_Cache_Count(gmpy_cache *cache, int type)
+{
+    int count = 0;
+
+    switch (type) {
+    case GMPY_CACHE_MPZ:
+        for (int n = 0; n < MPZ_CACHE_CLASSES; n++) {
+            count += cache->in_gmpympzcache[n];
+        }
+        return count;
+    case GMPY_CACHE_XMPZ:
+        for (int n = 0; n < MPZ_CACHE_CLASSES; n++) {
+            count += cache->in_gmpyxmpzcache[n];
+        }
+        return count;
+    case GMPY_CACHE_MPQ:
+        for (int n = 0; n < MPZ_CACHE_CLASSES; n++) {
+            count += cache->in_gmpympqcache[n];
+        }
+        return count;
+    case GMPY_CACHE_MPFR:
+        for (int bucket = 0; bucket < MPFR_CACHE_BUCKETS; bucket++) {
+            count += cache->in_gmpympfrcache[bucket];
+        }
+        return count;
+    case GMPY_CACHE_MPC:
+        return cache->in_gmpympccache;
+    }
+    return 0;
+}
+
+/* The bytes of limb storage held by the objects in a cache. */
+
+#define MPZ_BYTES(z) ((size_t)(z)->_mp_alloc * sizeof(mp_limb_t))
+
+static size_t
+_GMPy_Cache_Bytes(gmpy_cache *cache, int type)
+{
+    size_t bytes = 0;
+    int i;
+
+    switch (type) {
+    case GMPY_CACHE_MPZ:
+        for (int n = 0; n < MPZ_CACHE_CLASSES; n++) {
+            for (i = 0; i < cache->in_gmpympzcache[n]; i++)
+                bytes += MPZ_BYTES(cache->gmpympzcache[n][i]->z);
+        }
+        break;
+    case GMPY_CACHE_XMPZ:
+        for (int n = 0; n < MPZ_CACHE_CLASSES; n++) {
+            for (i = 0; i < cache->in_gmpyxmpzcache[n]; i++)
+                bytes += MPZ_BYTES(cache->gmpyxmpzcache[n][i]->z);
+        }
+        break;
+    case GMPY_CACHE_MPQ:
+        for (int n = 0; n < MPZ_CACHE_CLASSES; n++) {
+            for (i = 0; i < cache->in_gmpympqcache[n]; i++)
+                bytes += MPZ_BYTES(mpq_numref(cache->gmpympqcache[n][i]->q)) +
+                         MPZ_BYTES(mpq_denref(cache->gmpympqcache[n][i]->q));
+        }
+        break;
+    case GMPY_CACHE_MPFR:
+        for (int bucket = 0; bucket < MPFR_CACHE_BUCKETS; bucket++) {
+            for (i = 0; i < cache->in_gmpympfrcache[bucket]; i++)
+                bytes += mpfr_custom_get_size(mpfr_get_prec(cache->gmpympfrcache[bucket][i]->f));
+        }
+        break;
+    case GMPY_CACHE_MPC:
+        for (i = 0; i < cache->in_gmpympccache; i++)
+            bytes += mpfr_custom_get_size(mpfr_get_prec(mpc_realref(cache->gmpympccache[i]->c))) +
+                     mpfr_custom_get_size(mpfr_get_prec(mpc_imagref(cache->gmpympccache[i]->c)));
+        break;
+    }
+    return bytes;
+}
+
+#undef MPZ_BYTES
+
+static const char *gmpy_cache_names[GMPY_CACHE_TYPES] = {
+    "mpz", "xmpz", "mpq", "mpfr", "mpc"
+};
+
+/* The largest limb limit accepted by set_cache(). mpfr objects are grouped
+ * by size so the limit for mpfr is fixed at compile time.
+ */
+
+static const int gmpy_cache_max_limbs[GMPY_CACHE_TYPES] = {
+    MAX_CACHE_LIMBS, MAX_CACHE_LIMBS, MAX_CACHE_LIMBS,
+    MPFR_CACHE_BUCKETS, MAX_CACHE_LIMBS
+};
+
+PyDoc_STRVAR(GMPy_doc_cache_info,
+"cache_info() -> dict\n\n"
+"Return a dictionary describing the object caches. For each of 'mpz',\n"
+"'xmpz', 'mpq', 'mpfr', and 'mpc', a dictionary is returned with the\n"
+"following keys:\n\n"
+"    size:      maximum number of objects kept for each size class\n"
+"    limbs:     largest object, in limbs, that will be cached\n"
+"    cached:    number of objects currently in the cache\n"
+"    hits:      number of objects reused from the cache\n"
+"    misses:    number of objects that had to be allocated\n"
+"    evictions: number of objects freed instead of cached\n\n"
+"If the GIL is disabled, each thread has its own cache. The counts are\n"
+"for the shared pool, the current thread, and threads that have exited.");
+
+static PyObject *
+GMPy_Cache_Info(PyObject *self, PyObject *args)
+{
+    PyObject *result, *info;
+    gmpy_cache *cache = GMPY_CACHE;
+    gmpy_cache_stats stats;
+    int i, cached;
+
+    if (!(result = PyDict_New()))
+        return NULL;
+
+    for (i = 0; i < GMPY_CACHE_TYPES; i++) {
+#ifdef Py_GIL_DISABLED
+        PyMutex_Lock(&global.cache_lock);
+        stats = global.cache.stats[i];
+        cached = _GMPy_Cache_Count(&global.cache, i);
+        PyMutex_Unlock(&global.cache_lock);
+        if (cache) {
+            stats.hits += cache->stats[i].hits;
+            stats.misses += cache->stats[i].misses;
+            stats.evictions += cache->stats[i].evictions;
+            cached += _GMPy_Cache_Count(cache, i);
+        }
+#else
+        stats = cache->stats[i];
+        cached = _GMPy_Cache_Count(cache, i);
+#endif
+        info = Py_BuildValue("{s:i,s:i,s:i,s:K,s:K,s:K}",
+                             "size", global.cache_size[i],
+                             "limbs", global.cache_limbs[i],
+                             "cached", cached,
+                             "hits", stats.hits,
+                             "misses", stats.misses,
+                             "evictions", stats.evictions);
+        if (!info || PyDict_SetItemString(result, gmpy_cache_names[i], info) < 0) {
+            Py_XDECREF(info);
+            Py_DECREF(result);
+            return NULL;
+        }
+        Py_DECREF(info);
+    }
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_set_cache,
+"set_cache(type, size=None, limbs=None) -> None\n\n"
+"Change the object cache for type, which must be one of 'mpz', 'xmpz',\n"
+"'mpq', 'mpfr', or 'mpc'. size is the maximum number of objects kept\n"
+"in the cache and must be in the interval [0, 1000]; 0 disables the\n"
+"cache. mpz, xmpz, mpq, and mpfr objects are grouped by the size of\n"
+"their storage and size applies to each group. limbs is the largest object, in limbs, that will be cached;\n"
+"for mpq and mpc the limit applies to each component. The limit for\n"
+"mpfr can not exceed the size of the mantissa of a 1024-bit mpfr.\n"
+"Objects that no longer fit in the cache are freed.");
+
+static PyObject *
+GMPy_Set_Cache(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    const char *name;
+    PyObject *size_obj = Py_None, *limbs_obj = Py_None;
+    long size = GMPY_DEFAULT, limbs = GMPY_DEFAULT;
+    int type;
+    gmpy_cache *cache;
+    static char *kwlist[] = {"type", "size", "limbs", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "s|OO", kwlist,
+                                     &name, &size_obj, &limbs_obj))
+        return NULL;
+
+    for (type = 0; type < GMPY_CACHE_TYPES; type++) {
+        if (!strcmp(name, gmpy_cache_names[type]))
+            break;
+    }
+    if (type == GMPY_CACHE_TYPES) {
+        VALUE_ERROR("type must be 'mpz', 'xmpz', 'mpq', 'mpfr', or 'mpc'");
+        return NULL;
+    }
+
+    if (size_obj != Py_None) {
+        size = PyLong_AsLong(size_obj);
+        if (size == -1 && PyErr_Occurred())
+            return NULL;
+        if (size < 0 || size > MAX_CACHE) {
+            VALUE_ERROR("cache size must be in the interval [0, 1000]");
+            return NULL;
+        }
+    }
+
+    if (limbs_obj != Py_None) {
+        limbs = PyLong_AsLong(limbs_obj);
+        if (limbs == -1 && PyErr_Occurred())
+            return NULL;
+        if (limbs < 0 || limbs > gmpy_cache_max_limbs[type]) {
+            PyErr_Format(PyExc_ValueError,
+                         "limbs for %s must be in the interval [0, %d]",
+                         name, gmpy_cache_max_limbs[type]);
+            return NULL;
+        }
+    }
+
+    cache = GMPY_CACHE;
+
+#ifdef Py_GIL_DISABLED
+    PyMutex_Lock(&global.cache_lock);
+#endif
+    if (size != GMPY_DEFAULT)
+        global.cache_size[type] = (int)size;
+    if (limbs != GMPY_DEFAULT)
+        global.cache_limbs[type] = (int)limbs;
+#ifdef Py_GIL_DISABLED
+    _GMPy_Cache_Trim(&global.cache, type, NULL, NULL);
+    PyMutex_Unlock(&global.cache_lock);
+
+    /* The private caches of other threads are not trimmed; they drain as
+     * their objects are reused. */
+    if (cache)
+        _GMPy_Cache_Trim(cache, type, NULL, NULL);
+#else
+    _GMPy_Cache_Trim(cache, type, NULL, NULL);
+#endif
+    Py_RETURN_NONE;
+}
@@ -38,6 +38,12 @@ extern "C" {
 
 /* Private functions */
 
+/* The number of limbs used by the larger of the numerator and denominator. */
+#define MPQ_SIZE(q) Py_MAX(mpz_size(mpq_numref(q)), mpz_size(mpq_denref(q)))
+
+static PyObject *    GMPy_Cache_Info(PyObject *self, PyObject *args);
+static PyObject *    GMPy_Set_Cache(PyObject *self, PyObject *args, PyObject *keywds);
+
 /* C-API functions */
 
 /* static MPZ_Object *  GMPy_MPZ_New(CTXT_Object *context); */
@@ -46,6 +52,32 @@ extern "C" {
 static GMPy_MPZ_New_RETURN     GMPy_MPZ_New     GMPy_MPZ_New_PROTO;
 static GMPy_MPZ_NewInit_RETURN GMPy_MPZ_NewInit GMPy_MPZ_NewInit_PROTO;
 static GMPy_MPZ_Dealloc_RETURN GMPy_MPZ_Dealloc GMPy_MPZ_Dealloc_PROTO;
+static MPZ_Object *            GMPy_MPZ_NewSize(mp_size_t size, CTXT_Object *context);
+static MPZ_Object *            GMPy_MPZ_Reuse(PyObject *x, int xtype, PyObject *other, int othertype);
+
+/* Python 3.14 can tell whether an object is a temporary that only the
+ * interpreter's value stack refers to. The arithmetic operations write their
+ * result into such an operand instead of allocating a new object. A plain
+ * reference count of one is not enough on older versions since C code may
+ * hold the only reference and still use it after the call.
+ */
+
+#if PY_VERSION_HEX >= 0x030E0000
+#  define GMPY_TEMP_ELISION 1
+#  define GMPY_IS_TEMPORARY(obj) PyUnstable_Object_IsUniqueReferencedTemporary(obj)
+#endif
+
+/* GMPy_MPZ_Small() returns a new reference to the preallocated mpz for a
+ * value that satisfies GMPY_MPZ_IS_SMALL(). GMPy_MPZ_Small_Result() takes a
+ * new, unshared result and replaces it by the preallocated mpz if its value
+ * is in that range. The preallocated objects must never be modified.
+ */
+
+#define GMPY_MPZ_IS_SMALL(v) ((v) >= GMPY_MPZ_SMALL_MIN && (v) <= GMPY_MPZ_SMALL_MAX)
+
+static int                     GMPy_MPZ_Small_Init(void);
+static inline MPZ_Object *     GMPy_MPZ_Small(long value);
+static inline PyObject *       GMPy_MPZ_Small_Result(MPZ_Object *result);
 
 /* static XMPZ_Object *  GMPy_XMPZ_New(CTXT_Object *context); */
 /* static PyObject *     GMPy_XMPZ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds); */
@@ -60,17 +92,31 @@ static GMPy_XMPZ_Dealloc_RETURN GMPy_XMPZ_Dealloc GMPy_XMPZ_Dealloc_PROTO;
 static GMPy_MPQ_New_RETURN     GMPy_MPQ_New     GMPy_MPQ_New_PROTO;
 static GMPy_MPQ_NewInit_RETURN GMPy_MPQ_NewInit GMPy_MPQ_NewInit_PROTO;
 static GMPy_MPQ_Dealloc_RETURN GMPy_MPQ_Dealloc GMPy_MPQ_Dealloc_PROTO;
+static MPQ_Object *            GMPy_MPQ_NewSize(mp_size_t size, CTXT_Object *context);
 
 /* static MPFR_Object * GMPy_MPFR_New(CTXT_Object *context); */
 /* static PyObject *    GMPy_MPFR_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds); */
 /* static void          GMPy_MPFR_Dealloc(MPFR_Object *self); */
 static GMPy_MPFR_New_RETURN     GMPy_MPFR_New     GMPy_MPFR_New_PROTO;
+static MPFR_Object *            GMPy_MPFR_Reuse(PyObject *x, int xtype, CTXT_Object *context);
 static GMPy_MPFR_NewInit_RETURN GMPy_MPFR_NewInit GMPy_MPFR_NewInit_PROTO;
 static GMPy_MPFR_Dealloc_RETURN GMPy_MPFR_Dealloc GMPy_MPFR_Dealloc_PROTO;
 
 static MPC_Object *  GMPy_MPC_New(mpfr_prec_t rprec, mpfr_prec_t iprec, CTXT_Object *context);
 static void          GMPy_MPC_Dealloc(MPC_Object *self);
 
+/* Vectorcall constructors for the number types. Type objects use
+ * tp_vectorcall starting with Python 3.9.
+ */
+
+#if PY_VERSION_HEX >= 0x03090000
+#  define GMPY_TYPE_VECTORCALL 1
+static PyObject *    GMPy_MPZ_Vectorcall(PyObject *type, PyObject *const *args, size_t nargsf, PyObject *kwnames);
+static PyObject *    GMPy_MPQ_Vectorcall(PyObject *type, PyObject *const *args, size_t nargsf, PyObject *kwnames);
+static PyObject *    GMPy_MPFR_Vectorcall(PyObject *type, PyObject *const *args, size_t nargsf, PyObject *kwnames);
+static PyObject *    GMPy_MPC_Vectorcall(PyObject *type, PyObject *const *args, size_t nargsf, PyObject *kwnames);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
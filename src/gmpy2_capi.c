@@ -0,0 +1,174 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_capi.c                                                            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Thin wrappers exported through the C-API capsule; see gmpy2_capi.h.
+ * Each one fills in the context and then calls the code used by the
+ * corresponding Python function, so results and exceptions match.
+ */
+
+#ifdef SHARED
+
+static PyObject *
+GMPy_Add(PyObject *x, PyObject *y, CTXT_Object *context)
+{
+    CHECK_CONTEXT(context);
+    return GMPy_Number_Add(x, y, context);
+}
+
+static PyObject *
+GMPy_Sub(PyObject *x, PyObject *y, CTXT_Object *context)
+{
+    CHECK_CONTEXT(context);
+    return GMPy_Number_Sub(x, y, context);
+}
+
+static PyObject *
+GMPy_Mul(PyObject *x, PyObject *y, CTXT_Object *context)
+{
+    CHECK_CONTEXT(context);
+    return GMPy_Number_Mul(x, y, context);
+}
+
+static PyObject *
+GMPy_PowMod(PyObject *x, PyObject *y, PyObject *m, CTXT_Object *context)
+{
+    int xtype, ytype, mtype;
+
+    CHECK_CONTEXT(context);
+
+    xtype = GMPy_ObjectType(x);
+    ytype = GMPy_ObjectType(y);
+    mtype = GMPy_ObjectType(m);
+
+    if (IS_TYPE_INTEGER(xtype) &&
+        IS_TYPE_INTEGER(ytype) &&
+        IS_TYPE_INTEGER(mtype)) {
+        GMPY_PROFILE_OP(context, GMPY_OP_POWMOD, _GMPy_Profile_Bits(m, mtype));
+        return GMPy_Integer_PowWithType(x, xtype, y, ytype, m, context);
+    }
+
+    TYPE_ERROR("powmod() argument types not supported");
+    return NULL;
+}
+
+/* Return 1 if x is probably prime, 0 if it is composite or negative and
+ * -1 with an exception set on error.
+ */
+
+static int
+GMPy_IsPrime(PyObject *x, unsigned long reps, CTXT_Object *context)
+{
+    MPZ_Object *tempx;
+    int i;
+
+    CHECK_CONTEXT_M1(context);
+
+    if (!(tempx = GMPy_MPZ_From_Integer(x, NULL))) {
+        return -1;
+    }
+
+    if (mpz_sgn(tempx->z) == -1) {
+        Py_DECREF((PyObject*)tempx);
+        return 0;
+    }
+
+    if (reps > 1000) {
+        reps = 1000;
+    }
+
+    GMPY_PROFILE_MPZ(context, GMPY_OP_PRP, tempx->z);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(tempx->z));
+    i = _GMPy_MPZ_IsPrime(tempx->z, (int)reps);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    Py_DECREF((PyObject*)tempx);
+    return i ? 1 : 0;
+}
+
+static PyObject *
+GMPy_Isum(PyObject *seq, CTXT_Object *context)
+{
+    return GMPy_Context_Isum((PyObject*)context, seq);
+}
+
+static PyObject *
+GMPy_Prod(PyObject *seq, CTXT_Object *context)
+{
+    return GMPy_Context_Prod((PyObject*)context, seq);
+}
+
+static PyObject *
+GMPy_Dot(PyObject *x, PyObject *y, CTXT_Object *context)
+{
+    PyObject *args, *result;
+
+    if (!(args = PyTuple_Pack(2, x, y))) {
+        return NULL;
+    }
+    result = GMPy_Context_Dot((PyObject*)context, args);
+    Py_DECREF(args);
+    return result;
+}
+
+static PyObject *
+GMPy_PowMod_Base_List(PyObject *bases, PyObject *y, PyObject *m)
+{
+    PyObject *args, *result;
+
+    if (!(args = PyTuple_Pack(3, bases, y, m))) {
+        return NULL;
+    }
+    result = GMPy_Integer_PowMod_Base_List(NULL, args);
+    Py_DECREF(args);
+    return result;
+}
+
+static PyObject *
+GMPy_PowMod_Exp_List(PyObject *x, PyObject *exps, PyObject *m)
+{
+    PyObject *args, *result;
+
+    if (!(args = PyTuple_Pack(3, x, exps, m))) {
+        return NULL;
+    }
+    result = GMPy_Integer_PowMod_Exp_List(NULL, args);
+    Py_DECREF(args);
+    return result;
+}
+
+/* The first mark taken in a thread that holds the GIL ties the pool to the
+ * thread state, so it is freed when the thread exits.
+ */
+
+static int
+GMPy_CAPI_Scratch_Mark(void)
+{
+    if (!gmpy_thread_scratch.attached && PyGILState_Check()) {
+        GMPy_Scratch_Attach();
+    }
+    return _GMPy_Scratch_Mark();
+}
+
+#endif
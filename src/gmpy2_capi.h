@@ -0,0 +1,58 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_capi.h                                                            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY2_CAPI_H
+#define GMPY2_CAPI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Entry points that are only exported through the C-API capsule. They
+ * accept a NULL context, which selects the current context, so extension
+ * modules can use them without access to the context internals.
+ */
+
+#ifdef SHARED
+static PyObject * GMPy_Add(PyObject *x, PyObject *y, CTXT_Object *context);
+static PyObject * GMPy_Sub(PyObject *x, PyObject *y, CTXT_Object *context);
+static PyObject * GMPy_Mul(PyObject *x, PyObject *y, CTXT_Object *context);
+static PyObject * GMPy_PowMod(PyObject *x, PyObject *y, PyObject *m, CTXT_Object *context);
+static int        GMPy_IsPrime(PyObject *x, unsigned long reps, CTXT_Object *context);
+
+static PyObject * GMPy_Isum(PyObject *seq, CTXT_Object *context);
+static PyObject * GMPy_Prod(PyObject *seq, CTXT_Object *context);
+static PyObject * GMPy_Dot(PyObject *x, PyObject *y, CTXT_Object *context);
+static PyObject * GMPy_PowMod_Base_List(PyObject *bases, PyObject *y, PyObject *m);
+static PyObject * GMPy_PowMod_Exp_List(PyObject *x, PyObject *exps, PyObject *m);
+
+static int        GMPy_CAPI_Scratch_Mark(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -24,6 +24,152 @@
  * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+/* The constants are memoized per precision and rounding mode. mpfr objects
+ * are immutable, so the same object is returned to every caller and to
+ * every thread. A value is only kept if the exponent range and
+ * subnormalization of the context do not change it, and it is only reused
+ * under the same condition; the flags and traps of the context are applied
+ * as if the constant had been computed again.
+ */
+
+static const char *gmpy_const_names[GMPY_CONST_TYPES] = {
+    "pi", "euler", "log2", "catalan"
+};
+
+#ifdef Py_GIL_DISABLED
+#  define CONST_LOCK()   PyMutex_Lock(&global.const_lock)
+#  define CONST_UNLOCK() PyMutex_Unlock(&global.const_lock)
+#else
+#  define CONST_LOCK()
+#  define CONST_UNLOCK()
+#endif
+
+static int
+_GMPy_Const_Compute(int which, mpfr_ptr f, mpfr_rnd_t round)
+{
+    switch (which) {
+        case GMPY_CONST_PI:
+            return mpfr_const_pi(f, round);
+        case GMPY_CONST_EULER:
+            return mpfr_const_euler(f, round);
+        case GMPY_CONST_LOG2:
+            return mpfr_const_log2(f, round);
+        default:
+            return mpfr_const_catalan(f, round);
+    }
+}
+
+/* Return 1 if the exponent range and subnormalization of context leave v
+ * unchanged.
+ */
+
+static int
+_GMPy_Const_In_Range(MPFR_Object *v, CTXT_Object *context)
+{
+    mpfr_exp_t exp = mpfr_get_exp(v->f);
+
+    if (exp < context->ctx.emin || exp > context->ctx.emax)
+        return 0;
+    if (context->ctx.subnormalize &&
+        exp <= context->ctx.emin + mpfr_get_prec(v->f) - 2)
+        return 0;
+    return 1;
+}
+
+/* Remove entry i of the cache and return its value. */
+
+static MPFR_Object *
+_GMPy_Const_Cache_Remove(int i)
+{
+    gmpy_const_cache *cache = &global.const_cache;
+    MPFR_Object *value = cache->entries[i].value;
+
+    cache->entries[i] = cache->entries[--(cache->count)];
+    return value;
+}
+
+static PyObject *
+_GMPy_Const(int which, mpfr_prec_t bits, CTXT_Object *context)
+{
+    gmpy_const_cache *cache = &global.const_cache;
+    MPFR_Object *result = NULL, *old = NULL;
+    mpfr_rnd_t round = GET_MPFR_ROUND(context);
+    int i, oldest = 0;
+
+    if (bits < 2)
+        bits = GET_MPFR_PREC(context);
+
+    CONST_LOCK();
+    for (i = 0; i < cache->count; i++) {
+        gmpy_const_entry *entry = &cache->entries[i];
+
+        if (entry->which == which && entry->prec == bits && entry->round == round) {
+            if (_GMPy_Const_In_Range(entry->value, context)) {
+                entry->last_used = ++(cache->clock);
+                cache->hits++;
+                result = entry->value;
+                Py_INCREF((PyObject*)result);
+            }
+            break;
+        }
+    }
+    CONST_UNLOCK();
+
+    if (result) {
+        mpfr_clear_flags();
+        if (result->rc)
+            mpfr_set_inexflag();
+        if (_GMPy_MPFR_Exceptions(context) < 0) {
+            Py_DECREF((PyObject*)result);
+            return NULL;
+        }
+        return (PyObject*)result;
+    }
+
+    if (!(result = GMPy_MPFR_New(bits, context)))
+        return NULL;
+    mpfr_clear_flags();
+    result->rc = _GMPy_Const_Compute(which, result->f, round);
+    if (mpfr_underflow_p() || mpfr_overflow_p() || mpfr_nanflag_p() ||
+        !_GMPy_Const_In_Range(result, context)) {
+        _GMPy_MPFR_Cleanup(&result, context);
+        return (PyObject*)result;
+    }
+    _GMPy_MPFR_Cleanup(&result, context);
+    if (!result || cache->size == 0)
+        return (PyObject*)result;
+
+    /* Replace the least recently used entry if the cache is full. Another
+     * thread may have added the same constant meanwhile; then the new value
+     * is simply not kept.
+     */
+
+    CONST_LOCK();
+    cache->misses++;
+    for (i = 0; i < cache->count; i++) {
+        gmpy_const_entry *entry = &cache->entries[i];
+
+        if (entry->which == which && entry->prec == bits && entry->round == round)
+            break;
+        if (entry->last_used < cache->entries[oldest].last_used)
+            oldest = i;
+    }
+    if (i == cache->count) {
+        if (cache->count >= cache->size)
+            old = _GMPy_Const_Cache_Remove(oldest);
+        cache->entries[cache->count].which = which;
+        cache->entries[cache->count].prec = bits;
+        cache->entries[cache->count].round = round;
+        cache->entries[cache->count].last_used = ++(cache->clock);
+        cache->entries[cache->count].value = result;
+        cache->count++;
+        Py_INCREF((PyObject*)result);
+    }
+    CONST_UNLOCK();
+    Py_XDECREF((PyObject*)old);
+    return (PyObject*)result;
+}
+
 PyDoc_STRVAR(GMPy_doc_function_const_pi,
 "const_pi(precision=0) -> mpfr\n\n"
 "Return the constant pi using the specified precision. If no\n"
@@ -32,7 +178,6 @@ PyDoc_STRVAR(GMPy_doc_function_const_pi,
 static PyObject *
 GMPy_Function_Const_Pi(PyObject *self, PyObject *args, PyObject *keywds)
 {
-    MPFR_Object *result = NULL;
     mpfr_prec_t bits = 0;
     static char *kwlist[] = {"precision", NULL};
     CTXT_Object *context = NULL;
@@ -43,13 +188,7 @@ GMPy_Function_Const_Pi(PyObject *self, PyObject *args, PyObject *keywds)
         return NULL;
     }
 
-    if ((result = GMPy_MPFR_New(bits, context))) {
-        mpfr_clear_flags();
-        result->rc = mpfr_const_pi(result->f, GET_MPFR_ROUND(context));
-        _GMPy_MPFR_Cleanup(&result, context);
-    }
-
-    return (PyObject*)result;
+    return _GMPy_Const(GMPY_CONST_PI, bits, context);
 }
 
 PyDoc_STRVAR(GMPy_doc_context_const_pi,
@@ -59,16 +198,7 @@ PyDoc_STRVAR(GMPy_doc_context_const_pi,
 static PyObject *
 GMPy_Context_Const_Pi(PyObject *self, PyObject *args)
 {
-    MPFR_Object *result = NULL;
-    CTXT_Object *context = (CTXT_Object*)self;
-
-    if ((result = GMPy_MPFR_New(0, context))) {
-        mpfr_clear_flags();
-        result->rc = mpfr_const_pi(result->f, GET_MPFR_ROUND(context));
-        _GMPy_MPFR_Cleanup(&result, context);
-    }
-
-    return (PyObject*)result;
+    return _GMPy_Const(GMPY_CONST_PI, 0, (CTXT_Object*)self);
 }
 
 PyDoc_STRVAR(GMPy_doc_function_const_euler,
@@ -79,7 +209,6 @@ PyDoc_STRVAR(GMPy_doc_function_const_euler,
 static PyObject *
 GMPy_Function_Const_Euler(PyObject *self, PyObject *args, PyObject *keywds)
 {
-    MPFR_Object *result = NULL;
     mpfr_prec_t bits = 0;
     static char *kwlist[] = {"precision", NULL};
     CTXT_Object *context = NULL;
@@ -90,13 +219,7 @@ GMPy_Function_Const_Euler(PyObject *self, PyObject *args, PyObject *keywds)
         return NULL;
     }
 
-    if ((result = GMPy_MPFR_New(bits, context))) {
-        mpfr_clear_flags();
-        result->rc = mpfr_const_euler(result->f, GET_MPFR_ROUND(context));
-        _GMPy_MPFR_Cleanup(&result, context);
-    }
-
-    return (PyObject*)result;
+    return _GMPy_Const(GMPY_CONST_EULER, bits, context);
 }
 
 PyDoc_STRVAR(GMPy_doc_context_const_euler,
@@ -106,16 +229,7 @@ PyDoc_STRVAR(GMPy_doc_context_const_euler,
 static PyObject *
 GMPy_Context_Const_Euler(PyObject *self, PyObject *args)
 {
-    MPFR_Object *result = NULL;
-    CTXT_Object *context = (CTXT_Object*)self;
-
-    if ((result = GMPy_MPFR_New(0, context))) {
-        mpfr_clear_flags();
-        result->rc = mpfr_const_euler(result->f, GET_MPFR_ROUND(context));
-        _GMPy_MPFR_Cleanup(&result, context);
-    }
-
-    return (PyObject*)result;
+    return _GMPy_Const(GMPY_CONST_EULER, 0, (CTXT_Object*)self);
 }
 
 PyDoc_STRVAR(GMPy_doc_function_const_log2,
@@ -126,7 +240,6 @@ PyDoc_STRVAR(GMPy_doc_function_const_log2,
 static PyObject *
 GMPy_Function_Const_Log2(PyObject *self, PyObject *args, PyObject *keywds)
 {
-    MPFR_Object *result = NULL;
     mpfr_prec_t bits = 0;
     static char *kwlist[] = {"precision", NULL};
     CTXT_Object *context = NULL;
@@ -137,13 +250,7 @@ GMPy_Function_Const_Log2(PyObject *self, PyObject *args, PyObject *keywds)
         return NULL;
     }
 
-    if ((result = GMPy_MPFR_New(bits, context))) {
-        mpfr_clear_flags();
-        result->rc = mpfr_const_log2(result->f, GET_MPFR_ROUND(context));
-        _GMPy_MPFR_Cleanup(&result, context);
-    }
-
-    return (PyObject*)result;
+    return _GMPy_Const(GMPY_CONST_LOG2, bits, context);
 }
 
 PyDoc_STRVAR(GMPy_doc_context_const_log2,
@@ -153,16 +260,7 @@ PyDoc_STRVAR(GMPy_doc_context_const_log2,
 static PyObject *
 GMPy_Context_Const_Log2(PyObject *self, PyObject *args)
 {
-    MPFR_Object *result = NULL;
-    CTXT_Object *context = (CTXT_Object*)self;
-
-    if ((result = GMPy_MPFR_New(0, context))) {
-        mpfr_clear_flags();
-        result->rc = mpfr_const_log2(result->f, GET_MPFR_ROUND(context));
-        _GMPy_MPFR_Cleanup(&result, context);
-    }
-
-    return (PyObject*)result;
+    return _GMPy_Const(GMPY_CONST_LOG2, 0, (CTXT_Object*)self);
 }
 
 PyDoc_STRVAR(GMPy_doc_function_const_catalan,
@@ -173,7 +271,6 @@ PyDoc_STRVAR(GMPy_doc_function_const_catalan,
 static PyObject *
 GMPy_Function_Const_Catalan(PyObject *self, PyObject *args, PyObject *keywds)
 {
-    MPFR_Object *result = NULL;
     mpfr_prec_t bits = 0;
     static char *kwlist[] = {"precision", NULL};
     CTXT_Object *context = NULL;
@@ -184,13 +281,7 @@ GMPy_Function_Const_Catalan(PyObject *self, PyObject *args, PyObject *keywds)
         return NULL;
     }
 
-    if ((result = GMPy_MPFR_New(bits, context))) {
-        mpfr_clear_flags();
-        result->rc = mpfr_const_catalan(result->f, GET_MPFR_ROUND(context));
-        _GMPy_MPFR_Cleanup(&result, context);
-    }
-
-    return (PyObject*)result;
+    return _GMPy_Const(GMPY_CONST_CATALAN, bits, context);
 }
 
 PyDoc_STRVAR(GMPy_doc_context_const_catalan,
@@ -200,14 +291,144 @@ PyDoc_STRVAR(GMPy_doc_context_const_catalan,
 static PyObject *
 GMPy_Context_Const_Catalan(PyObject *self, PyObject *args)
 {
-    MPFR_Object *result = NULL;
-    CTXT_Object *context = (CTXT_Object*)self;
+    return _GMPy_Const(GMPY_CONST_CATALAN, 0, (CTXT_Object*)self);
+}
 
-    if ((result = GMPy_MPFR_New(0, context))) {
-        mpfr_clear_flags();
-        result->rc = mpfr_const_catalan(result->f, GET_MPFR_ROUND(context));
-        _GMPy_MPFR_Cleanup(&result, context);
+/* Remove the entries for which name and precision match; NULL and 0 match
+ * every constant and precision. The removed objects are released after the
+ * lock is dropped.
+ */
+
+static int
+_GMPy_Const_Cache_Clear(int which, mpfr_prec_t prec, int keep)
+{
+    gmpy_const_cache *cache = &global.const_cache;
+    MPFR_Object *removed[GMPY_CONST_CACHE_MAX];
+    int i, n = 0;
+
+    CONST_LOCK();
+    for (i = cache->count - 1; i >= 0; i--) {
+        gmpy_const_entry *entry = &cache->entries[i];
+
+        if ((which < 0 || entry->which == which) && (prec == 0 || entry->prec == prec))
+            removed[n++] = _GMPy_Const_Cache_Remove(i);
     }
 
-    return (PyObject*)result;
+    /* Shrinking the cache drops the least recently used entries. */
+
+    while (cache->count > keep) {
+        int oldest = 0;
+
+        for (i = 1; i < cache->count; i++) {
+            if (cache->entries[i].last_used < cache->entries[oldest].last_used)
+                oldest = i;
+        }
+        removed[n++] = _GMPy_Const_Cache_Remove(oldest);
+    }
+    CONST_UNLOCK();
+
+    for (i = 0; i < n; i++)
+        Py_DECREF((PyObject*)removed[i]);
+    return n;
+}
+
+PyDoc_STRVAR(GMPy_doc_const_cache_info,
+"const_cache_info() -> dict\n\n"
+"Return a dictionary describing the cache used by `const_pi()`,\n"
+"`const_euler()`, `const_log2()`, and `const_catalan()`:\n\n"
+"    size:    maximum number of constants kept\n"
+"    hits:    number of constants returned from the cache\n"
+"    misses:  number of constants computed and added to the cache\n"
+"    entries: list of (name, precision, rounding mode) tuples\n\n"
+"The cache is shared by all threads.");
+
+static PyObject *
+GMPy_Const_Cache_Info(PyObject *self, PyObject *args)
+{
+    gmpy_const_cache *cache = &global.const_cache;
+    gmpy_const_entry entries[GMPY_CONST_CACHE_MAX];
+    unsigned long long hits, misses;
+    PyObject *list, *item;
+    int i, count, size;
+
+    CONST_LOCK();
+    count = cache->count;
+    size = cache->size;
+    hits = cache->hits;
+    misses = cache->misses;
+    memcpy(entries, cache->entries, count * sizeof(gmpy_const_entry));
+    CONST_UNLOCK();
+
+    if (!(list = PyList_New(count)))
+        return NULL;
+    for (i = 0; i < count; i++) {
+        if (!(item = Py_BuildValue("(sli)", gmpy_const_names[entries[i].which],
+                                   (long)entries[i].prec, (int)entries[i].round))) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return Py_BuildValue("{s:i,s:K,s:K,s:N}", "size", size, "hits", hits,
+                         "misses", misses, "entries", list);
+}
+
+PyDoc_STRVAR(GMPy_doc_set_const_cache,
+"set_const_cache(size, /) -> None\n\n"
+"Set the maximum number of constants kept by `const_pi()` and the\n"
+"other constant functions. size must be in the interval [0, "
+Py_STRINGIFY(GMPY_CONST_CACHE_MAX) "];\n"
+"0 disables the cache. The least recently used constants are removed\n"
+"if the cache shrinks.");
+
+static PyObject *
+GMPy_Set_Const_Cache(PyObject *self, PyObject *other)
+{
+    long size;
+
+    size = PyLong_AsLong(other);
+    if (size == -1 && PyErr_Occurred())
+        return NULL;
+    if (size < 0 || size > GMPY_CONST_CACHE_MAX) {
+        VALUE_ERROR("size must be in the interval [0, " Py_STRINGIFY(GMPY_CONST_CACHE_MAX) "]");
+        return NULL;
+    }
+    CONST_LOCK();
+    global.const_cache.size = (int)size;
+    CONST_UNLOCK();
+    _GMPy_Const_Cache_Clear(-1, -1, (int)size);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_clear_const_cache,
+"clear_const_cache(name=None, precision=0) -> int\n\n"
+"Remove constants from the cache used by `const_pi()` and the other\n"
+"constant functions. If name is one of 'pi', 'euler', 'log2', or\n"
+"'catalan', only that constant is removed. If precision is not 0,\n"
+"only constants with that precision are removed. Return the number\n"
+"of constants removed.");
+
+static PyObject *
+GMPy_Clear_Const_Cache(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    const char *name = NULL;
+    long prec = 0;
+    int which = -1;
+    static char *kwlist[] = {"name", "precision", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|zl", kwlist, &name, &prec))
+        return NULL;
+
+    if (name) {
+        for (which = 0; which < GMPY_CONST_TYPES; which++) {
+            if (!strcmp(name, gmpy_const_names[which]))
+                break;
+        }
+        if (which == GMPY_CONST_TYPES) {
+            VALUE_ERROR("name must be 'pi', 'euler', 'log2', or 'catalan'");
+            return NULL;
+        }
+    }
+    return PyLong_FromLong(_GMPy_Const_Cache_Clear(which, (mpfr_prec_t)prec,
+                                                   GMPY_CONST_CACHE_MAX));
 }
@@ -44,6 +44,11 @@ static PyObject * GMPy_Context_Const_Log2(PyObject *self, PyObject *args);
 static PyObject * GMPy_Function_Const_Catalan(PyObject *self, PyObject *args, PyObject *keywds);
 static PyObject * GMPy_Context_Const_Catalan(PyObject *self, PyObject *args);
 
+static int        _GMPy_Const_Cache_Clear(int which, mpfr_prec_t prec, int keep);
+static PyObject * GMPy_Const_Cache_Info(PyObject *self, PyObject *args);
+static PyObject * GMPy_Set_Const_Cache(PyObject *self, PyObject *other);
+static PyObject * GMPy_Clear_Const_Cache(PyObject *self, PyObject *args, PyObject *keywds);
+
 #ifdef __cplusplus
 }
 #endif
@@ -43,6 +43,10 @@
  *   GMPy_CTXT_Repr_Slot
  *   GMPy_CTXT_Enter
  *   GMPy_CTXT_Exit
+ *   GMPy_CTXT_Push
+ *   GMPy_CTXT_Pop
+ *   GMPy_CTXT_Template
+ *   GMPy_CTXT_Evaluate
  *   GMPy_CTXT_Clear_Flags
  *   GMPy_CTXT_Manager_New
  *   GMPy_CTXT_Manager_Dealloc
@@ -83,6 +87,16 @@ GMPy_CTXT_New(void)
         result->ctx.allow_complex = 0;
         result->ctx.rational_division = 0;
         result->ctx.allow_release_gil = 0;
+        result->ctx.release_gil_min_bits = GMPY_RELEASE_GIL_MIN_BITS;
+        result->ctx.profile = 0;
+        result->ctx.threads = 0;
+        result->ctx.mul_threads_min_bits = GMPY_MUL_THREADS_MIN_BITS;
+        result->ctx.fast_float = 0;
+        result->ctx.track_flags = 1;
+        result->ctx.max_time = 0.0;
+        result->ctx.deadline = 0.0;
+        result->profile = NULL;
+        result->frozen = 0;
     }
     return (PyObject*)result;
 };
@@ -90,6 +104,7 @@ GMPy_CTXT_New(void)
 static void
 GMPy_CTXT_Dealloc(CTXT_Object *self)
 {
+    PyMem_Free(self->profile);
     PyObject_Del(self);
 };
 
@@ -99,6 +114,33 @@ PyDoc_STRVAR(GMPy_doc_set_context,
 
 /* Begin support for context vars. */
 
+/* Remember the context found by the last lookup in this thread. CPython
+ * bumps tstate->context_ver whenever the active contextvars.Context is
+ * entered or exited in this thread, so the cached (borrowed) pointer is
+ * valid as long as the thread state, its unique id, and the version number
+ * all match. The id guards against a thread state being freed and a new
+ * one allocated at the same address. Setting current_context_var does not
+ * change the version; every place that sets it must call
+ * GMPY_CONTEXT_CACHE_CLEAR().
+ */
+
+#if !defined(PYPY_VERSION)
+#  define GMPY_CONTEXT_CACHE 1
+static GMPY_THREAD_LOCAL PyThreadState *gmpy_context_cache_ts = NULL;
+static GMPY_THREAD_LOCAL uint64_t gmpy_context_cache_id = 0;
+static GMPY_THREAD_LOCAL uint64_t gmpy_context_cache_ver = 0;
+static GMPY_THREAD_LOCAL PyObject *gmpy_context_cache_obj = NULL;
+#  define GMPY_CONTEXT_CACHE_CLEAR() (gmpy_context_cache_obj = NULL)
+#else
+#  define GMPY_CONTEXT_CACHE_CLEAR()
+#endif
+
+/* Each thread has its own contextvars.Context, so a context created here is
+ * only visible to the running thread and needs no lock, also when the GIL
+ * is disabled. A thread that inherits a Context from its parent shares the
+ * parent's gmpy2 context until it sets its own.
+ */
+
 static PyObject *
 GMPy_init_current_context(void)
 {
@@ -107,6 +149,7 @@ GMPy_init_current_context(void)
         return NULL;
     }
 
+    GMPY_CONTEXT_CACHE_CLEAR();
     PyObject *tok = PyContextVar_Set(current_context_var, tl_context);
     if (tok == NULL) {
         Py_DECREF(tl_context);
@@ -121,15 +164,39 @@ static inline PyObject *
 GMPy_current_context(void)
 {
     PyObject *tl_context;
+
+#ifdef GMPY_CONTEXT_CACHE
+    PyThreadState *ts = PyThreadState_GET();
+
+    if (gmpy_context_cache_obj != NULL &&
+        gmpy_context_cache_ts == ts &&
+        gmpy_context_cache_id == ts->id &&
+        gmpy_context_cache_ver == ts->context_ver) {
+        Py_INCREF(gmpy_context_cache_obj);
+        return gmpy_context_cache_obj;
+    }
+#endif
+
     if (PyContextVar_Get(current_context_var, NULL, &tl_context) < 0) {
         return NULL;
     }
 
+    if (tl_context == NULL) {
+        tl_context = GMPy_init_current_context();
+    }
+
+#ifdef GMPY_CONTEXT_CACHE
+    /* Read the version after the lookup; initializing the variable above
+     * changes it. */
     if (tl_context != NULL) {
-        return tl_context;
+        gmpy_context_cache_ts = ts;
+        gmpy_context_cache_id = ts->id;
+        gmpy_context_cache_ver = ts->context_ver;
+        gmpy_context_cache_obj = tl_context;
     }
+#endif
 
-    return GMPy_init_current_context();
+    return tl_context;
 }
 
 /* Set the thread local context to a new context, decrement old reference */
@@ -142,6 +209,7 @@ GMPy_CTXT_Set(PyObject *self, PyObject *v)
     }
 
     Py_INCREF(v);
+    GMPY_CONTEXT_CACHE_CLEAR();
     PyObject *tok = PyContextVar_Set(current_context_var, v);
     Py_DECREF(v);
 
@@ -154,20 +222,21 @@ GMPy_CTXT_Set(PyObject *self, PyObject *v)
 }
 
 PyDoc_STRVAR(GMPy_doc_context_ieee,
-"ieee(size, /, subnormalize=True) -> context\n\n"
+"ieee(size, /, subnormalize=True, fast_float=False) -> context\n\n"
 "Return a new context corresponding to a standard IEEE floating point\n"
 "format. The supported sizes are 16, 32, 64, 128, and multiples of\n"
-"32 greater than 128.");
+"32 greater than 128. For sizes 32 and 64, fast_float=True enables\n"
+"`context.fast_float`; for size 64 it also applies to `mpc`.");
 
 static PyObject *
 GMPy_CTXT_ieee(PyObject *self, PyObject *args, PyObject *kwargs)
 {
     long bitwidth;
     double bitlog2;
-    int sub_mode=1;
+    int sub_mode=1, fast_float=0;
     PyObject *temp;
     CTXT_Object *result;
-    static char *kwlist[] = {"subnormalize", NULL};
+    static char *kwlist[] = {"subnormalize", "fast_float", NULL};
 
     if (PyTuple_GET_SIZE(args) != 1) {
         TYPE_ERROR("ieee() requires 'int' argument");
@@ -192,7 +261,7 @@ GMPy_CTXT_ieee(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 
     if (!(PyArg_ParseTupleAndKeywords(temp, kwargs,
-            "|ii", kwlist, &sub_mode))) {
+            "|ii", kwlist, &sub_mode, &fast_float))) {
         VALUE_ERROR("invalid keyword arguments for ieee()");
         Py_DECREF(temp);
         return NULL;
@@ -234,6 +303,7 @@ GMPy_CTXT_ieee(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 
     result->ctx.subnormalize = sub_mode;
+    result->ctx.fast_float = fast_float ? 1 : 0;
     result->ctx.emin = 4 - result->ctx.emax - result->ctx.mpfr_prec;
     return (PyObject*)result;
 }
@@ -279,9 +349,10 @@ GMPy_CTXT_Repr_Slot(CTXT_Object *self)
     PyObject *format;
     PyObject *tuple;
     PyObject *result = NULL;
+    gmpy_context *flags = GMPY_CTXT_FLAGS(self);
     int i = 0;
 
-    tuple = PyTuple_New(24);
+    tuple = PyTuple_New(32);
     if (!tuple)
         return NULL;
 
@@ -298,7 +369,14 @@ GMPy_CTXT_Repr_Slot(CTXT_Object *self)
             "        trap_divzero=%s, divzero=%s,\n"
             "        allow_complex=%s,\n"
             "        rational_division=%s,\n"
-            "        allow_release_gil=%s)"
+            "        allow_release_gil=%s,\n"
+            "        release_gil_min_bits=%s,\n"
+            "        threads=%s,\n"
+            "        mul_threads_min_bits=%s,\n"
+            "        profile=%s,\n"
+            "        fast_float=%s,\n"
+            "        track_flags=%s,\n"
+            "        max_time=%s, deadline=%s)"
             );
     if (!format) {
         Py_DECREF(tuple);
@@ -322,20 +400,28 @@ GMPy_CTXT_Repr_Slot(CTXT_Object *self)
     PyTuple_SET_ITEM(tuple, i++, PyLong_FromLong(self->ctx.emin));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.subnormalize));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.traps & TRAP_UNDERFLOW));
-    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.underflow));
+    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(flags->underflow));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.traps & TRAP_OVERFLOW));
-    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.overflow));
+    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(flags->overflow));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.traps & TRAP_INEXACT));
-    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.inexact));
+    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(flags->inexact));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.traps & TRAP_INVALID));
-    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.invalid));
+    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(flags->invalid));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.traps & TRAP_ERANGE));
-    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.erange));
+    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(flags->erange));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.traps & TRAP_DIVZERO));
-    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.divzero));
+    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(flags->divzero));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.allow_complex));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.rational_division));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.allow_release_gil));
+    PyTuple_SET_ITEM(tuple, i++, PyLong_FromLong(self->ctx.release_gil_min_bits));
+    PyTuple_SET_ITEM(tuple, i++, PyLong_FromLong(self->ctx.threads));
+    PyTuple_SET_ITEM(tuple, i++, PyLong_FromLong(self->ctx.mul_threads_min_bits));
+    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.profile));
+    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.fast_float));
+    PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.track_flags));
+    PyTuple_SET_ITEM(tuple, i++, PyFloat_FromDouble(self->ctx.max_time));
+    PyTuple_SET_ITEM(tuple, i++, PyFloat_FromDouble(self->ctx.deadline));
 
     if (!PyErr_Occurred())
         result = PyUnicode_Format(format, tuple);
@@ -370,18 +456,75 @@ GMPy_CTXT_Get(PyObject *self, PyObject *args)
 
 PyDoc_STRVAR(GMPy_doc_context_copy,
 "context.copy() -> context\n\n"
-"Return a copy of a context.");
+"Return a copy of a context. The copy of a frozen context is not frozen.");
 
 static PyObject *
 GMPy_CTXT_Copy(PyObject *self, PyObject *other)
 {
     CTXT_Object *result;
+    gmpy_context *flags;
 
-    result = (CTXT_Object*)GMPy_CTXT_New();
+    if (!(result = (CTXT_Object*)GMPy_CTXT_New()))
+        return NULL;
     result->ctx = ((CTXT_Object*)self)->ctx;
+    flags = GMPY_CTXT_FLAGS((CTXT_Object*)self);
+    result->ctx.underflow = flags->underflow;
+    result->ctx.overflow = flags->overflow;
+    result->ctx.inexact = flags->inexact;
+    result->ctx.invalid = flags->invalid;
+    result->ctx.erange = flags->erange;
+    result->ctx.divzero = flags->divzero;
     return (PyObject*)result;
 }
 
+PyDoc_STRVAR(GMPy_doc_context_freeze,
+"context.freeze() -> context\n\n"
+"Return a frozen copy of a context. The settings of a frozen context\n"
+"can not be changed, so it can be shared by several threads without\n"
+"copying it. Entering a frozen context with a 'with ...' block does not\n"
+"copy it. The flags (underflow, inexact, etc.) set by operations that\n"
+"use a frozen context are kept per thread; all frozen contexts used by\n"
+"a thread share the same flags.");
+
+static PyObject *
+GMPy_CTXT_Freeze(PyObject *self, PyObject *other)
+{
+    CTXT_Object *result;
+
+    if (((CTXT_Object*)self)->frozen) {
+        Py_INCREF(self);
+        return self;
+    }
+
+    if (!(result = (CTXT_Object*)GMPy_CTXT_New()))
+        return NULL;
+    result->ctx = ((CTXT_Object*)self)->ctx;
+    result->ctx.underflow = 0;
+    result->ctx.overflow = 0;
+    result->ctx.inexact = 0;
+    result->ctx.invalid = 0;
+    result->ctx.erange = 0;
+    result->ctx.divzero = 0;
+    result->frozen = 1;
+
+    /* Allocate the statistics now; they are shared by all threads. */
+    if (result->ctx.profile && !_GMPy_Profile_Get(result)) {
+        Py_DECREF((PyObject*)result);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_CTXT_frozen,
+"`True` if the settings of this context can not be changed. See\n"
+"`context.freeze()`.");
+
+static PyObject *
+GMPy_CTXT_Get_frozen(CTXT_Object *self, void *closure)
+{
+    return PyBool_FromLong(self->frozen);
+}
+
 /* Parse the keyword arguments available to a context. Returns 1 if no
  * error occurred; returns 0 is an error occurred.
  */
@@ -398,7 +541,9 @@ _parse_context_args(CTXT_Object *ctxt, PyObject *kwargs)
         "real_round", "imag_round", "emax", "emin", "subnormalize",
         "trap_underflow", "trap_overflow", "trap_inexact",
         "trap_invalid", "trap_erange", "trap_divzero", "allow_complex",
-        "rational_division", "allow_release_gil", NULL };
+        "rational_division", "allow_release_gil", "release_gil_min_bits",
+        "profile", "threads", "mul_threads_min_bits", "fast_float",
+        "track_flags", "max_time", "deadline", NULL };
 
     /* Create an empty dummy tuple to use for args. */
 
@@ -417,7 +562,7 @@ _parse_context_args(CTXT_Object *ctxt, PyObject *kwargs)
     x_trap_divzero = ctxt->ctx.traps & TRAP_DIVZERO;
 
     if (!(PyArg_ParseTupleAndKeywords(args, kwargs,
-            "|llliiilliiiiiiiiii", kwlist,
+            "|llliiilliiiiiiiiiiliiliidd", kwlist,
             &ctxt->ctx.mpfr_prec,
             &ctxt->ctx.real_prec,
             &ctxt->ctx.imag_prec,
@@ -435,7 +580,15 @@ _parse_context_args(CTXT_Object *ctxt, PyObject *kwargs)
             &x_trap_divzero,
             &ctxt->ctx.allow_complex,
             &ctxt->ctx.rational_division,
-            &ctxt->ctx.allow_release_gil))) {
+            &ctxt->ctx.allow_release_gil,
+            &ctxt->ctx.release_gil_min_bits,
+            &ctxt->ctx.profile,
+            &ctxt->ctx.threads,
+            &ctxt->ctx.mul_threads_min_bits,
+            &ctxt->ctx.fast_float,
+            &ctxt->ctx.track_flags,
+            &ctxt->ctx.max_time,
+            &ctxt->ctx.deadline))) {
         VALUE_ERROR("invalid keyword arguments for context");
         Py_DECREF(args);
         return 0;
@@ -459,6 +612,15 @@ _parse_context_args(CTXT_Object *ctxt, PyObject *kwargs)
     if (ctxt->ctx.subnormalize)
         ctxt->ctx.subnormalize = 1;
 
+    if (ctxt->ctx.profile)
+        ctxt->ctx.profile = 1;
+
+    if (ctxt->ctx.fast_float)
+        ctxt->ctx.fast_float = 1;
+
+    if (ctxt->ctx.track_flags)
+        ctxt->ctx.track_flags = 1;
+
     /* Sanity check for values. */
     if (ctxt->ctx.mpfr_prec < MPFR_PREC_MIN ||
         ctxt->ctx.mpfr_prec > MPFR_PREC_MAX) {
@@ -466,6 +628,31 @@ _parse_context_args(CTXT_Object *ctxt, PyObject *kwargs)
         return 0;
     }
 
+    if (ctxt->ctx.release_gil_min_bits < 0) {
+        VALUE_ERROR("invalid value for release_gil_min_bits");
+        return 0;
+    }
+
+    if (ctxt->ctx.threads < 0) {
+        VALUE_ERROR("invalid value for threads");
+        return 0;
+    }
+
+    if (ctxt->ctx.mul_threads_min_bits < 0) {
+        VALUE_ERROR("invalid value for mul_threads_min_bits");
+        return 0;
+    }
+
+    if (!(ctxt->ctx.max_time >= 0.0)) {
+        VALUE_ERROR("invalid value for max_time");
+        return 0;
+    }
+
+    if (!(ctxt->ctx.deadline >= 0.0)) {
+        VALUE_ERROR("invalid value for deadline");
+        return 0;
+    }
+
     if (!(ctxt->ctx.real_prec == GMPY_DEFAULT ||
         (ctxt->ctx.real_prec >= MPFR_PREC_MIN &&
         ctxt->ctx.real_prec <= MPFR_PREC_MAX))) {
@@ -561,15 +748,31 @@ GMPy_CTXT_Local(PyObject *self, PyObject *args, PyObject *kwargs)
 
     if (arg_context) {
         temp = (CTXT_Object*)PyTuple_GET_ITEM(args, 0);
-        result->new_context = temp;
-        Py_INCREF((PyObject*)(result->new_context));
     }
     else {
-        result->new_context = context;
+        temp = context;
+    }
+
+    /* Keyword arguments modify a copy of a frozen context. */
+    if (temp->frozen && kwargs && PyDict_GET_SIZE(kwargs)) {
+        result->new_context = (CTXT_Object*)GMPy_CTXT_Copy((PyObject*)temp, NULL);
+        if (!(result->new_context)) {
+            Py_DECREF((PyObject*)result);
+            return NULL;
+        }
+    }
+    else {
+        result->new_context = temp;
         Py_INCREF((PyObject*)(result->new_context));
     }
 
-    result->old_context = (CTXT_Object*)GMPy_CTXT_Copy((PyObject*)context, NULL);
+    if (context->frozen) {
+        result->old_context = context;
+        Py_INCREF((PyObject*)(result->old_context));
+    }
+    else {
+        result->old_context = (CTXT_Object*)GMPy_CTXT_Copy((PyObject*)context, NULL);
+    }
     if (!(result->old_context)) {
         Py_DECREF((PyObject*)result);
         return NULL;
@@ -609,7 +812,16 @@ PyDoc_STRVAR(GMPy_doc_context,
 " * trap_divzero:      if True, raise exception for division by zero; if False, set divzero flag and return Inf or -Inf\n"
 " * allow_complex:     if True, allow mpfr functions to return mpc; if False, mpfr functions cannot return an mpc\n"
 " * rational_division: if True, mpz/mpz returns an mpq; if False, mpz/mpz follows default behavior\n"
-" * allow_release_gil: if True, mpq operations may release the GIL; if False, mpq operations may not release the GIL\n");
+" * allow_release_gil: if True, mpq operations may release the GIL; if False, mpq operations may not release the GIL\n"
+" * release_gil_min_bits: only release the GIL if an operand has at least this many bits\n"
+" * profile:           if True, collect statistics, see profile_info()\n"
+" * threads:           number of threads used by powmod_base_list(), batch_gcd(), etc.; 0 uses get_num_threads()\n"
+" * mul_threads_min_bits: only split an mpz product over the threads if both operands have at least this many bits\n"
+" * fast_float:        if True, use hardware doubles for mpfr +, -, *, / at 53 or 24 bits\n"
+"                      and for mpc +, -, * at 53 bits\n"
+" * track_flags:       if False, mpfr operations only update the flags when a trap is enabled\n"
+" * max_time:          if not 0, long computations raise TimeoutError after this many seconds\n"
+" * deadline:          if not 0, long computations raise TimeoutError once time.monotonic() reaches it\n");
 #if 0
 "\nMethods\n"
 "    abs(x)          return absolute value of x\n"
@@ -772,7 +984,14 @@ GMPy_CTXT_Enter(PyObject *self, PyObject *args)
     PyObject *temp;
     PyObject *result;
 
-    result = GMPy_CTXT_Copy(self, NULL);
+    /* A frozen context can not change, so it does not need to be copied. */
+    if (((CTXT_Object*)self)->frozen) {
+        Py_INCREF(self);
+        result = self;
+    }
+    else {
+        result = GMPy_CTXT_Copy(self, NULL);
+    }
     if (!result)
         return NULL;
 
@@ -797,6 +1016,292 @@ GMPy_CTXT_Exit(PyObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
+/* Make context the current context without copying it. Returns a token
+ * that GMPy_CTXT_Pop() uses to restore the previous context, or NULL.
+ */
+
+static PyObject *
+GMPy_CTXT_Push(CTXT_Object *context)
+{
+    GMPY_CONTEXT_CACHE_CLEAR();
+    return PyContextVar_Set(current_context_var, (PyObject*)context);
+}
+
+/* Restore the context that was current before the matching push. The
+ * reference to token is always released.
+ */
+
+static int
+GMPy_CTXT_Pop(PyObject *token)
+{
+    int result;
+
+    GMPY_CONTEXT_CACHE_CLEAR();
+    result = PyContextVar_Reset(current_context_var, token);
+    Py_DECREF(token);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_context_template,
+"context_template(**kwargs) -> ContextTemplate\n"
+"context_template(context, /, **kwargs) -> ContextTemplate\n\n"
+"Return a reusable context manager. Its context is a frozen copy of\n"
+"context, or of the current context, modified by the keyword arguments,\n"
+"which are the same as for `local_context()`. Each 'with ...' block makes\n"
+"that context current without copying it or parsing arguments again, and\n"
+"restores the previous context when it ends. The same template can be\n"
+"used in nested blocks and by several threads.");
+
+static PyObject *
+GMPy_CTXT_Template(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    CTXT_Template_Object *result;
+    CTXT_Object *context = NULL, *temp;
+
+    if (PyTuple_GET_SIZE(args) == 1 && CTXT_Check(PyTuple_GET_ITEM(args, 0))) {
+        context = (CTXT_Object*)PyTuple_GET_ITEM(args, 0);
+    }
+    else if (PyTuple_GET_SIZE(args)) {
+        VALUE_ERROR("context_template() only supports [context[,keyword]] arguments");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!(temp = (CTXT_Object*)GMPy_CTXT_Copy((PyObject*)context, NULL)))
+        return NULL;
+    if (!_parse_context_args(temp, kwargs)) {
+        Py_DECREF((PyObject*)temp);
+        return NULL;
+    }
+
+    if (!(result = PyObject_New(CTXT_Template_Object, &CTXT_Template_Type))) {
+        Py_DECREF((PyObject*)temp);
+        return NULL;
+    }
+    result->context = (CTXT_Object*)GMPy_CTXT_Freeze((PyObject*)temp, NULL);
+    Py_DECREF((PyObject*)temp);
+    if (!result->context) {
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    return (PyObject*)result;
+}
+
+static void
+GMPy_CTXT_Template_Dealloc(CTXT_Template_Object *self)
+{
+    Py_XDECREF((PyObject*)self->context);
+    PyObject_Free(self);
+}
+
+/* The stack of tokens is a chain of (token, next) tuples held by
+ * context_stack_var, so every thread and asyncio task has its own.
+ */
+
+static PyObject *
+GMPy_CTXT_Template_Enter(PyObject *self, PyObject *args)
+{
+    CTXT_Object *context = ((CTXT_Template_Object*)self)->context;
+    PyObject *stack, *token, *entry, *temp;
+
+    if (PyContextVar_Get(context_stack_var, Py_None, &stack) < 0)
+        return NULL;
+    if (!(token = GMPy_CTXT_Push(context))) {
+        Py_DECREF(stack);
+        return NULL;
+    }
+    entry = PyTuple_Pack(2, token, stack);
+    Py_DECREF(stack);
+    if (!entry || !(temp = PyContextVar_Set(context_stack_var, entry))) {
+        Py_XDECREF(entry);
+        GMPy_CTXT_Pop(token);
+        return NULL;
+    }
+    Py_DECREF(temp);
+    Py_DECREF(entry);
+    Py_DECREF(token);
+
+    Py_INCREF((PyObject*)context);
+    return (PyObject*)context;
+}
+
+static PyObject *
+GMPy_CTXT_Template_Exit(PyObject *self, PyObject *args)
+{
+    PyObject *stack, *token, *temp;
+
+    if (PyContextVar_Get(context_stack_var, Py_None, &stack) < 0)
+        return NULL;
+    if (!PyTuple_Check(stack)) {
+        Py_DECREF(stack);
+        RUNTIME_ERROR("context template exited without being entered");
+        return NULL;
+    }
+    token = PyTuple_GET_ITEM(stack, 0);
+    Py_INCREF(token);
+    temp = PyContextVar_Set(context_stack_var, PyTuple_GET_ITEM(stack, 1));
+    Py_DECREF(stack);
+    if (!temp) {
+        Py_DECREF(token);
+        return NULL;
+    }
+    Py_DECREF(temp);
+    if (GMPy_CTXT_Pop(token) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+GMPy_CTXT_Template_Get_context(CTXT_Template_Object *self, void *closure)
+{
+    Py_INCREF((PyObject*)self->context);
+    return (PyObject*)self->context;
+}
+
+static PyObject *
+GMPy_CTXT_Template_Repr_Slot(CTXT_Template_Object *self)
+{
+    return Py_BuildValue("s", "<gmpy2.ContextTemplate>");
+}
+
+/* Precision, in bits, added to the target precision for the first attempt
+ * of evaluate().
+ */
+
+#define EVALUATE_GUARD_BITS 32
+
+PyDoc_STRVAR(GMPy_doc_evaluate,
+"evaluate(func, digits, /, max_prec=0) -> mpfr\n\n"
+"Call func() in a copy of the current context whose precision is doubled\n"
+"after each call, until two successive results show that the value is\n"
+"known to digits significant decimal digits. Return the value rounded to\n"
+"the precision needed for that many digits, using the rounding mode of\n"
+"the current context. func takes no arguments and must return a real\n"
+"number computed at the precision of `get_context()`. ValueError is\n"
+"raised if the results do not agree at max_prec bits. If max_prec is 0,\n"
+"the limit is 64 times the precision of the first call.");
+
+/* Return 1 if y, computed at a higher precision than prev, can be
+ * rounded correctly to prec bits with rnd. The difference between the two
+ * results is used as the bound on the error of y.
+ */
+
+static int
+_GMPy_Evaluate_Converged(mpfr_srcptr y, mpfr_srcptr prev, mpfr_prec_t prec,
+                         mpfr_rnd_t rnd)
+{
+    mpfr_t diff;
+    mpfr_exp_t err;
+    int result;
+
+    if (mpfr_equal_p(y, prev) || (mpfr_nan_p(y) && mpfr_nan_p(prev)))
+        return 1;
+    if (!mpfr_regular_p(y) || !mpfr_regular_p(prev))
+        return 0;
+
+    mpfr_init2(diff, mpfr_get_prec(y));
+    mpfr_sub(diff, y, prev, MPFR_RNDN);
+    err = mpfr_get_exp(y) - mpfr_get_exp(diff) - 1;
+    result = err > 0 &&
+             mpfr_can_round(y, err, MPFR_RNDN, MPFR_RNDZ, prec + (rnd == MPFR_RNDN));
+    mpfr_clear(diff);
+    return result;
+}
+
+static PyObject *
+GMPy_CTXT_Evaluate(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"", "", "max_prec", NULL};
+    PyObject *func, *value, *token;
+    MPFR_Object *y = NULL, *prev = NULL, *result = NULL;
+    CTXT_Object *context = NULL, *work = NULL;
+    long digits, max_prec = 0;
+    mpfr_prec_t target, prec;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Ol|l", kwlist,
+                                     &func, &digits, &max_prec))
+        return NULL;
+
+    if (!PyCallable_Check(func)) {
+        TYPE_ERROR("evaluate() func must be callable");
+        return NULL;
+    }
+    if (digits < 1 || digits > (MPFR_PREC_MAX - EVALUATE_GUARD_BITS) / 4) {
+        VALUE_ERROR("evaluate() digits is out of range");
+        return NULL;
+    }
+
+    /* log2(10) < 3.33 */
+    target = (mpfr_prec_t)(digits * 3.3219280948873623) + 2;
+    prec = target + EVALUATE_GUARD_BITS;
+    if (max_prec == 0)
+        max_prec = prec > MPFR_PREC_MAX / 64 ? MPFR_PREC_MAX : 64 * prec;
+    if (max_prec < prec || max_prec > MPFR_PREC_MAX) {
+        VALUE_ERROR("evaluate() max_prec is too small for digits or invalid");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    /* The same copy of the context is used for every call. The current
+     * context is only referenced by the context variable, which is changed
+     * below.
+     */
+    if (!(work = (CTXT_Object*)GMPy_CTXT_Copy((PyObject*)context, NULL)))
+        return NULL;
+    Py_INCREF((PyObject*)context);
+    if (!(token = GMPy_CTXT_Push(work))) {
+        Py_DECREF((PyObject*)work);
+        Py_DECREF((PyObject*)context);
+        return NULL;
+    }
+
+    while (1) {
+        work->ctx.mpfr_prec = prec;
+        if (!(value = PyObject_CallObject(func, NULL)))
+            goto done;
+        if (!IS_REAL(value)) {
+            TYPE_ERROR("evaluate() func must return a real number");
+            Py_DECREF(value);
+            goto done;
+        }
+        y = GMPy_MPFR_From_Real(value, 1, work);
+        Py_DECREF(value);
+        if (!y)
+            goto done;
+
+        if (prev && _GMPy_Evaluate_Converged(y->f, prev->f, target,
+                                             GET_MPFR_ROUND(context)))
+            break;
+
+        Py_XDECREF((PyObject*)prev);
+        prev = y;
+        y = NULL;
+        if (prec >= max_prec) {
+            VALUE_ERROR("evaluate() did not converge within max_prec bits");
+            goto done;
+        }
+        prec = prec > max_prec / 2 ? (mpfr_prec_t)max_prec : 2 * prec;
+    }
+
+    if ((result = GMPy_MPFR_New(target, context))) {
+        mpfr_clear_flags();
+        result->rc = mpfr_set(result->f, y->f, GET_MPFR_ROUND(context));
+    }
+
+  done:
+    if (GMPy_CTXT_Pop(token) < 0)
+        Py_CLEAR(result);
+    if (result)
+        _GMPy_MPFR_Cleanup(&result, context);
+    Py_XDECREF((PyObject*)y);
+    Py_XDECREF((PyObject*)prev);
+    Py_DECREF((PyObject*)work);
+    Py_DECREF((PyObject*)context);
+    return (PyObject*)result;
+}
+
 PyDoc_STRVAR(GMPy_doc_context_clear_flags,
 "clear_flags() -> None\n\n"
 "Clear all MPFR exception flags.");
@@ -804,15 +1309,25 @@ PyDoc_STRVAR(GMPy_doc_context_clear_flags,
 static PyObject *
 GMPy_CTXT_Clear_Flags(PyObject *self, PyObject *args)
 {
-    ((CTXT_Object*)self)->ctx.underflow = 0;
-    ((CTXT_Object*)self)->ctx.overflow = 0;
-    ((CTXT_Object*)self)->ctx.inexact = 0;
-    ((CTXT_Object*)self)->ctx.invalid = 0;
-    ((CTXT_Object*)self)->ctx.erange = 0;
-    ((CTXT_Object*)self)->ctx.divzero = 0;
+    gmpy_context *flags = GMPY_CTXT_FLAGS((CTXT_Object*)self);
+
+    flags->underflow = 0;
+    flags->overflow = 0;
+    flags->inexact = 0;
+    flags->invalid = 0;
+    flags->erange = 0;
+    flags->divzero = 0;
     Py_RETURN_NONE;
 }
 
+/* The settings of a frozen context can not be changed. */
+
+#define CHECK_FROZEN(self) \
+    if ((self)->frozen) { \
+        PyErr_SetString(PyExc_AttributeError, "frozen context is read-only"); \
+        return -1; \
+    }
+
 /* Define the get/set functions. */
 
 #define GETSET_BOOLEAN(NAME) \
@@ -824,6 +1339,7 @@ GMPy_CTXT_Get_##NAME(CTXT_Object *self, void *closure) \
 static int \
 GMPy_CTXT_Set_##NAME(CTXT_Object *self, PyObject *value, void *closure) \
 { \
+    CHECK_FROZEN(self); \
     if (!(PyBool_Check(value))) { \
         TYPE_ERROR(#NAME " must be True or False"); \
         return -1; \
@@ -832,6 +1348,27 @@ GMPy_CTXT_Set_##NAME(CTXT_Object *self, PyObject *value, void *closure) \
     return 0; \
 }
 
+/* Define the get/set functions for the sticky flags. The flags of a frozen
+ * context are kept per thread and can always be changed.
+ */
+
+#define GETSET_FLAG(NAME) \
+static PyObject * \
+GMPy_CTXT_Get_##NAME(CTXT_Object *self, void *closure) \
+{ \
+    return PyBool_FromLong(GMPY_CTXT_FLAGS(self)->NAME); \
+}; \
+static int \
+GMPy_CTXT_Set_##NAME(CTXT_Object *self, PyObject *value, void *closure) \
+{ \
+    if (!(PyBool_Check(value))) { \
+        TYPE_ERROR(#NAME " must be True or False"); \
+        return -1; \
+    } \
+    GMPY_CTXT_FLAGS(self)->NAME = (value == Py_True) ? 1 : 0; \
+    return 0; \
+}
+
 /* Define the get/set functions. This version works with the individual
  * bits in the traps field.
  */
@@ -845,6 +1382,7 @@ GMPy_CTXT_Get_##NAME(CTXT_Object *self, void *closure) \
 static int \
 GMPy_CTXT_Set_##NAME(CTXT_Object *self, PyObject *value, void *closure) \
 { \
+    CHECK_FROZEN(self); \
     if (!(PyBool_Check(value))) { \
         TYPE_ERROR(#NAME " must be True or False"); \
         return -1; \
@@ -857,12 +1395,12 @@ GMPy_CTXT_Set_##NAME(CTXT_Object *self, PyObject *value, void *closure) \
 }
 
 GETSET_BOOLEAN(subnormalize);
-GETSET_BOOLEAN(underflow);
-GETSET_BOOLEAN(overflow);
-GETSET_BOOLEAN(inexact);
-GETSET_BOOLEAN(invalid);
-GETSET_BOOLEAN(erange);
-GETSET_BOOLEAN(divzero);
+GETSET_FLAG(underflow);
+GETSET_FLAG(overflow);
+GETSET_FLAG(inexact);
+GETSET_FLAG(invalid);
+GETSET_FLAG(erange);
+GETSET_FLAG(divzero);
 GETSET_BOOLEAN_BIT(trap_underflow, TRAP_UNDERFLOW);
 GETSET_BOOLEAN_BIT(trap_overflow, TRAP_OVERFLOW);
 GETSET_BOOLEAN_BIT(trap_inexact, TRAP_INEXACT);
@@ -872,6 +1410,9 @@ GETSET_BOOLEAN_BIT(trap_divzero, TRAP_DIVZERO);
 GETSET_BOOLEAN(allow_complex)
 GETSET_BOOLEAN(rational_division)
 GETSET_BOOLEAN(allow_release_gil)
+GETSET_BOOLEAN(profile)
+GETSET_BOOLEAN(fast_float)
+GETSET_BOOLEAN(track_flags)
 
 PyDoc_STRVAR(GMPy_doc_CTXT_subnormalize,
 "The usual IEEE-754 floating point representation supports gradual\n"
@@ -947,9 +1488,215 @@ PyDoc_STRVAR(GMPy_doc_CTXT_rational_division,
 "If set to `True`, `mpz` / `mpz` will return an `mpq` instead of an `mpfr`.");
 
 PyDoc_STRVAR(GMPy_doc_CTXT_allow_release_gil,
-"If set to `True`, many `mpz` and `mpq` computations will release the GIL.\n\n"
+"If set to `True`, many `mpz` and `mpq` computations will release the GIL\n"
+"when the operands are at least `release_gil_min_bits` long.\n\n"
 "This is considered an experimental feature.");
 
+PyDoc_STRVAR(GMPy_doc_CTXT_profile,
+"If set to `True`, the number and size of the operations performed with\n"
+"this context, the time spent with the GIL released, and the use of the\n"
+"object caches are recorded. See `context.profile_info()`.");
+
+PyDoc_STRVAR(GMPy_doc_CTXT_fast_float,
+"If set to `True` and the precision is 53 (binary64) or 24 (binary32)\n"
+"with rounding mode `RoundToNearest`, `mpfr` addition, subtraction,\n"
+"multiplication, and division are done with hardware floating point.\n"
+"The results, including the inexact flag and `mpfr.rc`, are the same as\n"
+"with MPFR; operands or results that the hardware format can not\n"
+"represent exactly (zeros, infinities, values near the limits of the\n"
+"exponent range) are still handled by MPFR. If the real and imaginary\n"
+"precisions are 53, `mpc` addition, subtraction, and multiplication are\n"
+"done the same way, with the same results as MPC.");
+
+PyDoc_STRVAR(GMPy_doc_CTXT_track_flags,
+"If set to `False` and no trap is enabled, `mpfr` operations do not\n"
+"update the underflow, overflow, inexact, invalid, and divzero flags\n"
+"of the context. The results, including `mpfr.rc`, are not affected.\n"
+"Enabling any trap restores the normal behavior.");
+
+PyDoc_STRVAR(GMPy_doc_CTXT_release_gil_min_bits,
+"When `allow_release_gil` is `True`, the GIL is only released if the\n"
+"largest operand (or, for functions like `fac()`, the expected result)\n"
+"has at least this many bits. Releasing the GIL for small operands costs\n"
+"more than the computation. The default is 4096; 0 releases it for every\n"
+"operation.");
+
+static PyObject *
+GMPy_CTXT_Get_release_gil_min_bits(CTXT_Object *self, void *closure)
+{
+    return PyLong_FromLong(self->ctx.release_gil_min_bits);
+}
+
+static int
+GMPy_CTXT_Set_release_gil_min_bits(CTXT_Object *self, PyObject *value, void *closure)
+{
+    long temp;
+
+    CHECK_FROZEN(self);
+
+    if (!(PyLong_Check(value))) {
+        TYPE_ERROR("release_gil_min_bits must be Python integer");
+        return -1;
+    }
+    temp = PyLong_AsLong(value);
+    if (temp < 0) {
+        if (!PyErr_Occurred() || PyErr_ExceptionMatches(PyExc_OverflowError)) {
+            PyErr_Clear();
+            VALUE_ERROR("invalid value for release_gil_min_bits");
+        }
+        return -1;
+    }
+    self->ctx.release_gil_min_bits = temp;
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_CTXT_threads,
+"The number of native threads used by `powmod_base_list()`,\n"
+"`powmod_exp_list()`, `remainder_tree()`, and `batch_gcd()`. The work is\n"
+"split into this many parts that are computed in parallel when the GIL\n"
+"is released. `fac()`, `primorial()`, and `bincoef()` of arguments of\n"
+"at least 2**20 always release the GIL and split the product over the\n"
+"threads, as do products of `mpz` with at least `mul_threads_min_bits`\n"
+"bits. The default, 0, uses `get_num_threads()`.");
+
+static PyObject *
+GMPy_CTXT_Get_threads(CTXT_Object *self, void *closure)
+{
+    return PyLong_FromLong(self->ctx.threads);
+}
+
+static int
+GMPy_CTXT_Set_threads(CTXT_Object *self, PyObject *value, void *closure)
+{
+    long temp;
+
+    CHECK_FROZEN(self);
+
+    if (!(PyLong_Check(value))) {
+        TYPE_ERROR("threads must be Python integer");
+        return -1;
+    }
+    temp = PyLong_AsLong(value);
+    if (temp < 0 || temp > INT_MAX) {
+        if (!PyErr_Occurred() || PyErr_ExceptionMatches(PyExc_OverflowError)) {
+            PyErr_Clear();
+            VALUE_ERROR("invalid value for threads");
+        }
+        return -1;
+    }
+    self->ctx.threads = (int)temp;
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_CTXT_mul_threads_min_bits,
+"When `threads` is greater than 1, the product of two `mpz` with at\n"
+"least this many bits each is split into parts that are multiplied in\n"
+"parallel without the GIL. The default is 2**23 (8388608); smaller\n"
+"products finish before the threads are started.");
+
+static PyObject *
+GMPy_CTXT_Get_mul_threads_min_bits(CTXT_Object *self, void *closure)
+{
+    return PyLong_FromLong(self->ctx.mul_threads_min_bits);
+}
+
+static int
+GMPy_CTXT_Set_mul_threads_min_bits(CTXT_Object *self, PyObject *value, void *closure)
+{
+    long temp;
+
+    CHECK_FROZEN(self);
+
+    if (!(PyLong_Check(value))) {
+        TYPE_ERROR("mul_threads_min_bits must be Python integer");
+        return -1;
+    }
+    temp = PyLong_AsLong(value);
+    if (temp < 0) {
+        if (!PyErr_Occurred() || PyErr_ExceptionMatches(PyExc_OverflowError)) {
+            PyErr_Clear();
+            VALUE_ERROR("invalid value for mul_threads_min_bits");
+        }
+        return -1;
+    }
+    self->ctx.mul_threads_min_bits = temp;
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_CTXT_max_time,
+"The number of seconds that one long computation may take, or 0.0 (the\n"
+"default) for no limit. `fac()`, `primorial()`, `bincoef()`, `factor()`,\n"
+"`prod()`, the PRP tests, and the list functions check the time between\n"
+"steps and raise `TimeoutError` once it has passed; the same checks let\n"
+"Ctrl-C interrupt them even while the GIL is released. A single GMP\n"
+"call, such as one large multiplication or `isqrt()`, is not\n"
+"interrupted.");
+
+PyDoc_STRVAR(GMPy_doc_CTXT_deadline,
+"A value of `time.monotonic()` at which long computations raise\n"
+"`TimeoutError`, or 0.0 (the default) for none. It is checked like\n"
+"`max_time`; if both are set, the earlier limit applies. Setting it once\n"
+"per request bounds the total time of all the computations made with\n"
+"the context.");
+
+static PyObject *
+GMPy_CTXT_Get_max_time(CTXT_Object *self, void *closure)
+{
+    return PyFloat_FromDouble(self->ctx.max_time);
+}
+
+static int
+GMPy_CTXT_Set_max_time(CTXT_Object *self, PyObject *value, void *closure)
+{
+    double temp;
+
+    CHECK_FROZEN(self);
+
+    if (!(PyFloat_Check(value) || PyLong_Check(value))) {
+        TYPE_ERROR("max_time must be Python float or integer");
+        return -1;
+    }
+    temp = PyFloat_AsDouble(value);
+    if (!(temp >= 0.0)) {
+        if (!PyErr_Occurred() || PyErr_ExceptionMatches(PyExc_OverflowError)) {
+            PyErr_Clear();
+            VALUE_ERROR("invalid value for max_time");
+        }
+        return -1;
+    }
+    self->ctx.max_time = temp;
+    return 0;
+}
+
+static PyObject *
+GMPy_CTXT_Get_deadline(CTXT_Object *self, void *closure)
+{
+    return PyFloat_FromDouble(self->ctx.deadline);
+}
+
+static int
+GMPy_CTXT_Set_deadline(CTXT_Object *self, PyObject *value, void *closure)
+{
+    double temp;
+
+    CHECK_FROZEN(self);
+
+    if (!(PyFloat_Check(value) || PyLong_Check(value))) {
+        TYPE_ERROR("deadline must be Python float or integer");
+        return -1;
+    }
+    temp = PyFloat_AsDouble(value);
+    if (!(temp >= 0.0)) {
+        if (!PyErr_Occurred() || PyErr_ExceptionMatches(PyExc_OverflowError)) {
+            PyErr_Clear();
+            VALUE_ERROR("invalid value for deadline");
+        }
+        return -1;
+    }
+    self->ctx.deadline = temp;
+    return 0;
+}
+
 PyDoc_STRVAR(GMPy_doc_CTXT_precision,
 "This attribute controls the precision of an `mpfr` result.  The\n"
 "precision is specified in bits, not decimal digits.  The maximum\n"
@@ -969,6 +1716,8 @@ GMPy_CTXT_Set_precision(CTXT_Object *self, PyObject *value, void *closure)
 {
     Py_ssize_t temp;
 
+    CHECK_FROZEN(self);
+
     if (!(PyLong_Check(value))) {
         TYPE_ERROR("precision must be Python integer");
         return -1;
@@ -1001,6 +1750,8 @@ GMPy_CTXT_Set_real_prec(CTXT_Object *self, PyObject *value, void *closure)
 {
     Py_ssize_t temp;
 
+    CHECK_FROZEN(self);
+
     if (!(PyLong_Check(value))) {
         TYPE_ERROR("real_prec must be Python integer");
         return -1;
@@ -1032,6 +1783,8 @@ GMPy_CTXT_Set_imag_prec(CTXT_Object *self, PyObject *value, void *closure)
 {
     Py_ssize_t temp;
 
+    CHECK_FROZEN(self);
+
     if (!(PyLong_Check(value))) {
         TYPE_ERROR("imag_prec must be Python integer");
         return -1;
@@ -1067,6 +1820,8 @@ GMPy_CTXT_Set_round(CTXT_Object *self, PyObject *value, void *closure)
 {
     long temp;
 
+    CHECK_FROZEN(self);
+
     if (!(PyLong_Check(value))) {
         TYPE_ERROR("round mode must be Python integer");
         return -1;
@@ -1114,6 +1869,8 @@ GMPy_CTXT_Set_real_round(CTXT_Object *self, PyObject *value, void *closure)
 {
     long temp;
 
+    CHECK_FROZEN(self);
+
     if (!(PyLong_Check(value))) {
         TYPE_ERROR("round mode must be Python integer");
         return -1;
@@ -1150,6 +1907,8 @@ GMPy_CTXT_Set_imag_round(CTXT_Object *self, PyObject *value, void *closure)
 {
     long temp;
 
+    CHECK_FROZEN(self);
+
     if (!(PyLong_Check(value))) {
         TYPE_ERROR("round mode must be Python integer");
         return -1;
@@ -1186,6 +1945,8 @@ GMPy_CTXT_Set_emin(CTXT_Object *self, PyObject *value, void *closure)
 {
     long exp;
 
+    CHECK_FROZEN(self);
+
     if (!(PyLong_Check(value))) {
         TYPE_ERROR("emin must be Python integer");
         return -1;
@@ -1219,6 +1980,8 @@ GMPy_CTXT_Set_emax(CTXT_Object *self, PyObject *value, void *closure)
 {
     long exp;
 
+    CHECK_FROZEN(self);
+
     if (!(PyLong_Check(value))) {
         TYPE_ERROR("emax must be Python integer");
         return -1;
@@ -1266,6 +2029,15 @@ static PyGetSetDef GMPyContext_getseters[] = {
     ADD_GETSET(allow_complex),
     ADD_GETSET(rational_division),
     ADD_GETSET(allow_release_gil),
+    ADD_GETSET(release_gil_min_bits),
+    ADD_GETSET(profile),
+    ADD_GETSET(threads),
+    ADD_GETSET(mul_threads_min_bits),
+    ADD_GETSET(fast_float),
+    ADD_GETSET(track_flags),
+    ADD_GETSET(max_time),
+    ADD_GETSET(deadline),
+    {"frozen", (getter)GMPy_CTXT_Get_frozen, NULL, GMPy_doc_CTXT_frozen, NULL},
     {NULL}
 };
 
@@ -1274,7 +2046,7 @@ static PyMethodDef GMPyContext_methods[] =
     { "abs", GMPy_Context_Abs, METH_O, GMPy_doc_context_abs },
     { "acos", GMPy_Context_Acos, METH_O, GMPy_doc_context_acos },
     { "acosh", GMPy_Context_Acosh, METH_O, GMPy_doc_context_acosh },
-    { "add", GMPy_Context_Add, METH_VARARGS, GMPy_doc_context_add },
+    { "add", (PyCFunction)GMPy_Context_Add, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_context_add },
     { "agm", GMPy_Context_AGM, METH_VARARGS, GMPy_doc_context_agm },
     { "ai", GMPy_Context_Ai, METH_O, GMPy_doc_context_ai },
     { "asin", GMPy_Context_Asin, METH_O, GMPy_doc_context_asin },
@@ -1320,6 +2092,7 @@ static PyMethodDef GMPyContext_methods[] =
 #endif
     { "fmod", GMPy_Context_Fmod, METH_VARARGS, GMPy_doc_context_fmod },
     { "frac", GMPy_Context_Frac, METH_O, GMPy_doc_context_frac },
+    { "freeze", GMPy_CTXT_Freeze, METH_NOARGS, GMPy_doc_context_freeze },
     { "frexp", GMPy_Context_Frexp, METH_O, GMPy_doc_context_frexp },
     { "fsum", GMPy_Context_Fsum, METH_O, GMPy_doc_context_fsum },
     { "gamma", GMPy_Context_Gamma, METH_O, GMPy_doc_context_gamma },
@@ -1347,7 +2120,7 @@ static PyMethodDef GMPyContext_methods[] =
     { "minus", GMPy_Context_Minus, METH_VARARGS, GMPy_doc_context_minus },
     { "mod", GMPy_Context_Mod, METH_VARARGS, GMPy_doc_context_mod },
     { "modf", GMPy_Context_Modf, METH_O, GMPy_doc_context_modf },
-    { "mul", GMPy_Context_Mul, METH_VARARGS, GMPy_doc_context_mul },
+    { "mul", (PyCFunction)GMPy_Context_Mul, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_context_mul },
     { "mul_2exp", GMPy_Context_Mul_2exp, METH_VARARGS, GMPy_doc_context_mul_2exp },
     { "next_above", GMPy_Context_NextAbove, METH_O, GMPy_doc_context_next_above },
     { "next_below", GMPy_Context_NextBelow, METH_O, GMPy_doc_context_next_below },
@@ -1356,8 +2129,11 @@ static PyMethodDef GMPyContext_methods[] =
     { "phase", GMPy_Context_Phase, METH_O, GMPy_doc_context_phase },
     { "plus", GMPy_Context_Plus, METH_VARARGS, GMPy_doc_context_plus },
     { "polar", GMPy_Context_Polar, METH_O, GMPy_doc_context_polar },
+    { "polyval", GMPy_Context_Polyval, METH_VARARGS, GMPy_doc_context_polyval },
+    { "polyval_many", GMPy_Context_Polyval_Many, METH_VARARGS, GMPy_doc_context_polyval_many },
     { "proj", GMPy_Context_Proj, METH_O, GMPy_doc_context_proj },
     { "pow", GMPy_Context_Pow, METH_VARARGS, GMPy_doc_context_pow },
+    { "profile_info", (PyCFunction)GMPy_CTXT_Profile_Info, METH_VARARGS | METH_KEYWORDS, GMPy_doc_context_profile_info },
     { "radians", GMPy_Context_Radians, METH_O, GMPy_doc_context_radians },
     { "rect", GMPy_Context_Rect, METH_VARARGS, GMPy_doc_context_rect },
     { "rec_sqrt", GMPy_Context_RecSqrt, METH_O, GMPy_doc_context_rec_sqrt },
@@ -1381,15 +2157,23 @@ static PyMethodDef GMPyContext_methods[] =
     { "sinh", GMPy_Context_Sinh, METH_O, GMPy_doc_context_sinh },
     { "sinh_cosh", GMPy_Context_Sinh_Cosh, METH_O, GMPy_doc_context_sinh_cosh },
     { "sqrt", GMPy_Context_Sqrt, METH_O, GMPy_doc_context_sqrt },
-    { "square", GMPy_Context_Square, METH_O, GMPy_doc_context_square },
-    { "sub", GMPy_Context_Sub, METH_VARARGS, GMPy_doc_context_sub },
+    { "square", (PyCFunction)GMPy_Context_Square, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_context_square },
+    { "sub", (PyCFunction)GMPy_Context_Sub, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_context_sub },
     { "tan", GMPy_Context_Tan, METH_O, GMPy_doc_context_tan },
     { "tanh", GMPy_Context_Tanh, METH_O, GMPy_doc_context_tanh },
     { "trunc", GMPy_Context_Trunc, METH_O, GMPy_doc_context_trunc },
+    { "vadd", (PyCFunction)GMPy_Context_VAdd, METH_VARARGS | METH_KEYWORDS, GMPy_doc_context_vadd },
+    { "vcmp", (PyCFunction)GMPy_Context_VCmp, METH_VARARGS | METH_KEYWORDS, GMPy_doc_context_vcmp },
+    { "vdiv", GMPy_Context_VDiv, METH_VARARGS, GMPy_doc_context_vdiv },
+    { "visqrt", (PyCFunction)GMPy_Context_VIsqrt, METH_VARARGS | METH_KEYWORDS, GMPy_doc_context_visqrt },
+    { "vector", GMPy_Context_Vector, METH_VARARGS, GMPy_doc_context_vector },
 #ifdef VECTOR
-    { "vector", GMPy_Context_Vector, METH_O, GMPy_doc_context_vector },
     { "vector2", GMPy_Context_Vector2, METH_VARARGS, GMPy_doc_context_vector2 },
 #endif
+    { "vmod", (PyCFunction)GMPy_Context_VMod, METH_VARARGS | METH_KEYWORDS, GMPy_doc_context_vmod },
+    { "vmul", (PyCFunction)GMPy_Context_VMul, METH_VARARGS | METH_KEYWORDS, GMPy_doc_context_vmul },
+    { "vpowmod", (PyCFunction)GMPy_Context_VPowMod, METH_VARARGS | METH_KEYWORDS, GMPy_doc_context_vpowmod },
+    { "vsub", (PyCFunction)GMPy_Context_VSub, METH_VARARGS | METH_KEYWORDS, GMPy_doc_context_vsub },
     { "yn", GMPy_Context_Yn, METH_VARARGS, GMPy_doc_context_yn },
     { "y0", GMPy_Context_Y0, METH_O, GMPy_doc_context_y0 },
     { "y1", GMPy_Context_Y1, METH_O, GMPy_doc_context_y1 },
@@ -1420,6 +2204,33 @@ static PyMethodDef GMPyContextManager_methods[] =
     { NULL, NULL, 1 }
 };
 
+static PyMethodDef GMPyContextTemplate_methods[] =
+{
+    { "__enter__", GMPy_CTXT_Template_Enter, METH_NOARGS, NULL },
+    { "__exit__", GMPy_CTXT_Template_Exit, METH_VARARGS, NULL },
+    { NULL, NULL, 1 }
+};
+
+static PyGetSetDef GMPyContextTemplate_getseters[] =
+{
+    { "context", (getter)GMPy_CTXT_Template_Get_context, NULL,
+      "the frozen context used by the template", NULL },
+    { NULL }
+};
+
+static PyTypeObject CTXT_Template_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.ContextTemplate",
+    .tp_basicsize = sizeof(CTXT_Template_Object),
+    .tp_dealloc = (destructor) GMPy_CTXT_Template_Dealloc,
+    .tp_repr = (reprfunc) GMPy_CTXT_Template_Repr_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_context_template,
+    .tp_methods = GMPyContextTemplate_methods,
+    .tp_getset = GMPyContextTemplate_getseters,
+};
+
 static PyTypeObject CTXT_Manager_Type =
 {
     PyVarObject_HEAD_INIT(NULL, 0)
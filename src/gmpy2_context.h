@@ -43,6 +43,11 @@ extern "C" {
 
 static PyTypeObject CTXT_Type;
 static PyTypeObject CTXT_Manager_Type;
+static PyTypeObject CTXT_Template_Type;
+
+/* Return the gmpy_context that records the sticky flags for CTX. */
+#define GMPY_CTXT_FLAGS(CTX) \
+    ((CTX)->frozen ? &gmpy_frozen_flags : &(CTX)->ctx)
 
 /* CHECK_CONTEXT returns a borrowed reference. */
 #define CHECK_CONTEXT(context)                          \
@@ -63,16 +68,68 @@ static PyTypeObject CTXT_Manager_Type;
         Py_DECREF(context);                                \
     }
 
-#define GMPY_MAYBE_BEGIN_ALLOW_THREADS(context) { \
+/* Release the GIL around a GMP call if the context allows it and the
+ * operands are at least release_gil_min_bits long. The size is given in
+ * bits; the GMPY_*_BITS macros below estimate it cheaply from the limb
+ * counts. If context.profile is set, the time spent without the GIL is
+ * recorded once the GIL has been reacquired; if tracing is enabled (see
+ * set_trace()), long sections are reported.
+ */
+
+#define GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, bits) { \
         PyThreadState *_save; \
-        _save = GET_THREAD_MODE(context) ? PyEval_SaveThread() : NULL;
+        unsigned long long _start = 0; \
+        size_t _bits = (size_t)(bits); \
+        _save = GET_THREAD_MODE(context, _bits) ? PyEval_SaveThread() : NULL; \
+        if (_save && (context->ctx.profile || trace_state.enabled)) \
+            _start = _GMPy_Profile_Clock();
 #define GMPY_MAYBE_END_ALLOW_THREADS(context) \
-        if (_save) PyEval_RestoreThread(_save); \
-    } \
+        if (_save) { \
+            unsigned long long _elapsed = 0; \
+            if (_start) _elapsed = _GMPy_Profile_Clock() - _start; \
+            PyEval_RestoreThread(_save); \
+            if (_start && context->ctx.profile) \
+                _GMPy_Profile_NoGIL(context, _elapsed); \
+            if (_start && trace_state.enabled) \
+                _GMPy_Trace_NoGIL(_bits, _elapsed); \
+        } \
+    }
+
+/* Functions that are documented to always release the GIL ignore
+ * allow_release_gil but still keep the GIL for small amounts of work.
+ */
+
+#define GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits) { \
+        PyThreadState *_save; \
+        unsigned long long _start = 0; \
+        size_t _bits = (size_t)(bits); \
+        _save = (_bits >= (size_t)context->ctx.release_gil_min_bits) ? \
+                PyEval_SaveThread() : NULL; \
+        if (_save && (context->ctx.profile || trace_state.enabled)) \
+            _start = _GMPy_Profile_Clock();
+#define GMPY_END_ALLOW_THREADS_MIN(context) \
+        GMPY_MAYBE_END_ALLOW_THREADS(context)
+
+/* True between GMPY_BEGIN_ALLOW_THREADS_MIN and GMPY_END_ALLOW_THREADS_MIN
+ * if the GIL was released.
+ */
+
+#define GMPY_THREADS_RELEASED() (_save != NULL)
 
 #define CTXT_Check(v) (((PyObject*)v)->ob_type == &CTXT_Type)
 #define CTXT_Manager_Check(v) (((PyObject*)v)->ob_type == &CTXT_Manager_Type)
 
+/* A context template holds a frozen context. Entering it pushes that
+ * context without copying it; the tokens needed to restore the previous
+ * contexts are kept in a per-thread stack, so a template can be entered
+ * again while it is active and by several threads.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    CTXT_Object *context;
+} CTXT_Template_Object;
+
 #define GET_MPFR_PREC(c) (c->ctx.mpfr_prec)
 #define GET_REAL_PREC(c) ((c->ctx.real_prec==GMPY_DEFAULT)?GET_MPFR_PREC(c):c->ctx.real_prec)
 #define GET_IMAG_PREC(c) ((c->ctx.imag_prec==GMPY_DEFAULT)?GET_REAL_PREC(c):c->ctx.imag_prec)
@@ -83,7 +140,33 @@ static PyTypeObject CTXT_Manager_Type;
 
 #define GET_DIV_MODE(c) (c->ctx.rational_division)
 
-#define GET_THREAD_MODE(c) (c->ctx.allow_release_gil)
+#define GET_THREAD_MODE(c, bits) (c->ctx.allow_release_gil && \
+        (size_t)(bits) >= (size_t)c->ctx.release_gil_min_bits)
+
+#define GMPY_MPZ_BITS(z) ((size_t)mpz_size(z) * GMP_NUMB_BITS)
+#define GMPY_MPZ_BITS2(x, y) \
+        ((size_t)Py_MAX(mpz_size(x), mpz_size(y)) * GMP_NUMB_BITS)
+#define GMPY_MPQ_BITS(q) ((size_t)MPQ_SIZE(q) * GMP_NUMB_BITS)
+#define GMPY_MPQ_BITS2(x, y) \
+        ((size_t)Py_MAX(MPQ_SIZE(x), MPQ_SIZE(y)) * GMP_NUMB_BITS)
+
+/* Default for context.release_gil_min_bits. Below this size saving and
+ * restoring the thread state costs more than the GMP call itself.
+ */
+
+#define GMPY_RELEASE_GIL_MIN_BITS 4096
+
+/* Default for context.mul_threads_min_bits. Products of smaller integers
+ * are not worth splitting over several threads.
+ */
+
+#define GMPY_MUL_THREADS_MIN_BITS (1L << 23)
+
+/* True if x*y should be split over the context's threads. */
+
+#define GMPY_MUL_THREADS(c, x, y) (GMPY_THREADS(c) > 1 && \
+        (size_t)Py_MIN(mpz_size(x), mpz_size(y)) * GMP_NUMB_BITS >= \
+        (size_t)(c)->ctx.mul_threads_min_bits)
 
 
 static PyObject *    GMPy_CTXT_Manager_New(void);
@@ -101,9 +184,14 @@ static PyObject *    GMPy_CTXT_Context(PyTypeObject *type, PyObject *args, PyObj
 static PyObject *    GMPy_CTXT_Set(PyObject *self, PyObject *other);
 static PyObject *    GMPy_CTXT_Clear_Flags(PyObject *self, PyObject *args);
 static PyObject *    GMPy_CTXT_Copy(PyObject *self, PyObject *other);
+static PyObject *    GMPy_CTXT_Freeze(PyObject *self, PyObject *other);
 static PyObject *    GMPy_CTXT_ieee(PyObject *self, PyObject *args, PyObject *kwargs);
 static PyObject *    GMPy_CTXT_Enter(PyObject *self, PyObject *args);
 static PyObject *    GMPy_CTXT_Exit(PyObject *self, PyObject *args);
+static PyObject *    GMPy_CTXT_Evaluate(PyObject *self, PyObject *args, PyObject *kwargs);
+static PyObject *    GMPy_CTXT_Push(CTXT_Object *context);
+static int           GMPy_CTXT_Pop(PyObject *token);
+static PyObject *    GMPy_CTXT_Template(PyObject *self, PyObject *args, PyObject *kwargs);
 
 static PyObject *    GMPy_current_context(void);
 
@@ -70,6 +70,73 @@ static int GMPy_isComplex(PyObject *obj)
 }
 #endif
 
+/* The conversion methods found for recently seen types. An entry is valid
+ * while the version tag of its type is unchanged: CPython assigns a new tag
+ * whenever a type or one of its bases is modified, so a method that is
+ * added or removed later is seen. Each thread has its own cache, which
+ * needs no lock.
+ */
+
+#define GMPY_CONV_CACHE_SIZE 32
+
+typedef struct {
+    PyTypeObject *type;
+    unsigned int tag;
+    int mask;
+} gmpy_conv_entry;
+
+static GMPY_THREAD_LOCAL gmpy_conv_entry gmpy_conv_cache[GMPY_CONV_CACHE_SIZE];
+
+/* Return the current version tag of type, or 0 if it has none. */
+
+static unsigned int
+_GMPy_Type_Version(PyTypeObject *type)
+{
+#if PY_VERSION_HEX >= 0x030C0000
+    if (!PyUnstable_Type_AssignVersionTag(type))
+        return 0;
+#endif
+#if PY_VERSION_HEX < 0x030D0000
+    if (!PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG))
+        return 0;
+#endif
+    return type->tp_version_tag;
+}
+
+static int
+GMPy_Conversions(PyObject *obj)
+{
+    PyTypeObject *type = Py_TYPE(obj);
+    gmpy_conv_entry *entry;
+    unsigned int tag;
+    int mask = 0;
+
+    entry = &gmpy_conv_cache[((uintptr_t)type >> 4) % GMPY_CONV_CACHE_SIZE];
+    if (entry->type == type && entry->tag &&
+        entry->tag == _GMPy_Type_Version(type))
+        return entry->mask;
+
+    /* Like other special methods, the conversions are looked up on the
+     * type, which also gives the type a version tag.
+     */
+
+    if (PyObject_HasAttrString((PyObject*)type, "__mpz__"))
+        mask |= GMPY_CONV_MPZ;
+    if (PyObject_HasAttrString((PyObject*)type, "__mpq__"))
+        mask |= GMPY_CONV_MPQ;
+    if (PyObject_HasAttrString((PyObject*)type, "__mpfr__"))
+        mask |= GMPY_CONV_MPFR;
+    if (PyObject_HasAttrString((PyObject*)type, "__mpc__"))
+        mask |= GMPY_CONV_MPC;
+
+    if ((tag = _GMPy_Type_Version(type))) {
+        entry->type = type;
+        entry->tag = tag;
+        entry->mask = mask;
+    }
+    return mask;
+}
+
 /* GMPy_ObjectType(PyObject *obj) returns an integer that identifies the
  * object's type. See gmpy2_convert.h for details.
  * 
@@ -79,18 +146,26 @@ static int GMPy_isComplex(PyObject *obj)
 static inline int GMPy_ObjectType(PyObject *obj)
 {
     /* Tests are sorted by order by (best guess of) most common argument type.
-     * Tests that require attribute lookups are done last.
+     * Exact types are compared first, so mpz and int need one load of the
+     * type pointer. Tests that require attribute lookups are done last.
      */
 
-    if (MPZ_Check(obj)) return OBJ_TYPE_MPZ;
+    PyTypeObject *type = Py_TYPE(obj);
+    int conv;
+
+    if (type == &MPZ_Type) return OBJ_TYPE_MPZ;
+
+    if (type == &PyLong_Type) return OBJ_TYPE_PyInteger;
+
+    if (type == &MPFR_Type) return OBJ_TYPE_MPFR;
 
-    if (MPFR_Check(obj)) return OBJ_TYPE_MPFR;
+    if (type == &MPC_Type)  return OBJ_TYPE_MPC;
 
-    if (MPC_Check(obj))  return OBJ_TYPE_MPC;
-    
-    if (MPQ_Check(obj))  return OBJ_TYPE_MPQ;
+    if (type == &MPQ_Type)  return OBJ_TYPE_MPQ;
 
-    if (XMPZ_Check(obj)) return OBJ_TYPE_XMPZ;
+    if (type == &XMPZ_Type) return OBJ_TYPE_XMPZ;
+
+    if (type == &MPZ_View_Type) return OBJ_TYPE_MPZ_VIEW;
 
     if (PyLong_Check(obj)) return OBJ_TYPE_PyInteger;
 
@@ -102,35 +177,59 @@ static inline int GMPy_ObjectType(PyObject *obj)
 
     /* Now we look for the presence of __mpz__, __mpq__, __mpfr__, and __mpc__.
      * Since a type may define more than one of the special methods, we perform
-     * the checks in reverse order.
+     * the checks in reverse order. The lookups are cached per type.
      */
 
-    if (HAS_MPC_CONVERSION(obj)) return OBJ_TYPE_HAS_MPC;
+    conv = GMPy_Conversions(obj);
+
+    if (conv & GMPY_CONV_MPC) return OBJ_TYPE_HAS_MPC;
 
-    if (HAS_MPFR_CONVERSION(obj)) return OBJ_TYPE_HAS_MPFR;
+    if (conv & GMPY_CONV_MPFR) return OBJ_TYPE_HAS_MPFR;
 
-    if (HAS_MPQ_CONVERSION(obj)) return OBJ_TYPE_HAS_MPQ;
+    if (conv & GMPY_CONV_MPQ) return OBJ_TYPE_HAS_MPQ;
 
-    if (HAS_MPZ_CONVERSION(obj)) return OBJ_TYPE_HAS_MPZ;
+    if (conv & GMPY_CONV_MPZ) return OBJ_TYPE_HAS_MPZ;
 
     return OBJ_TYPE_UNKNOWN;
 }
 
-static PyObject *
-GMPy_RemoveIgnoredASCII(PyObject *s)
+/* Return a pointer to the characters of s, which must be an exact bytes
+ * object or a str, and store their number in *len. The characters are
+ * followed by a NUL and are only valid while s is alive. Raises ValueError
+ * if s contains a non-ASCII character.
+ */
+
+static const char *
+_GMPy_ASCII_Data(PyObject *s, Py_ssize_t *len)
 {
-    PyObject *ascii_str = NULL, *temp = NULL, *filtered = NULL, *symbol = NULL, *blank = NULL;
+    const char *data;
+    Py_ssize_t i;
 
     if (PyBytes_CheckExact(s)) {
-        temp = PyUnicode_DecodeASCII(PyBytes_AS_STRING(s), PyBytes_GET_SIZE(s), "strict");
-        if (!temp) {
-            VALUE_ERROR("string contains non-ASCII characters");
-            return NULL;
+        data = PyBytes_AS_STRING(s);
+        *len = PyBytes_GET_SIZE(s);
+        for (i = 0; i < *len; i++) {
+            if ((unsigned char)data[i] > 127) {
+                VALUE_ERROR("string contains non-ASCII characters");
+                return NULL;
+            }
         }
+        return data;
     }
     else if (PyUnicode_Check(s)) {
-        Py_INCREF(s);
-        temp = s;
+#if PY_VERSION_HEX < 0x030C0000
+        if (PyUnicode_READY(s) == -1) {
+            /* LCOV_EXCL_START */
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+#endif
+        if (!PyUnicode_IS_ASCII(s)) {
+            VALUE_ERROR("string contains non-ASCII characters");
+            return NULL;
+        }
+        *len = PyUnicode_GET_LENGTH(s);
+        return (const char*)PyUnicode_1BYTE_DATA(s);
     }
     else {
         /* LCOV_EXCL_START */
@@ -138,98 +237,595 @@ GMPy_RemoveIgnoredASCII(PyObject *s)
         return NULL;
         /* LCOV_EXCL_STOP */
     }
+}
 
-    blank = PyUnicode_FromString("");
-
-    symbol = PyUnicode_FromString(" ");
-    filtered = PyUnicode_Replace(temp, symbol, blank, -1);
-    Py_XDECREF(symbol);
-    Py_XDECREF(temp);
-
-    temp = filtered;
-
-    symbol = PyUnicode_FromString("_");
-    filtered = PyUnicode_Replace(temp, symbol, blank, -1);
-    Py_XDECREF(symbol);
-    Py_XDECREF(temp);
+/* Return a new bytes object with the characters of s, less any spaces and
+ * underscores. The callers may modify the result in place.
+ */
 
-    Py_XDECREF(blank);
+static PyObject *
+GMPy_RemoveIgnoredASCII(PyObject *s)
+{
+    PyObject *ascii_str;
+    const char *data;
+    char *cp;
+    Py_ssize_t i, len, kept;
 
-    if (!filtered) {
+    if (!(data = _GMPy_ASCII_Data(s, &len)))
         return NULL;
+
+    for (i = 0, kept = 0; i < len; i++) {
+        if (data[i] != ' ' && data[i] != '_')
+            kept++;
     }
 
-    ascii_str = PyUnicode_AsASCIIString(filtered);
-    Py_DECREF(filtered);
-    if (!ascii_str) {
-        VALUE_ERROR("string contains non-ASCII characters");
+    if (!(ascii_str = PyBytes_FromStringAndSize(NULL, kept))) {
+        /* LCOV_EXCL_START */
         return NULL;
+        /* LCOV_EXCL_STOP */
     }
 
+    cp = PyBytes_AS_STRING(ascii_str);
+    for (i = 0; i < len; i++) {
+        if (data[i] != ' ' && data[i] != '_')
+            *cp++ = data[i];
+    }
     return ascii_str;
 }
 
-/* mpz_set_PyStr converts a Python "string" into a mpz_t structure. It accepts
- * a sequence of bytes (i.e. str in Python 2, bytes in Python 3) or a Unicode
- * string (i.e. unicode in Python 3, str in Python 3). Returns -1 on error,
- * 1 if successful.
+/* Parse the NUL-terminated digits in cp into z. Numbers that fit in an
+ * unsigned long are accumulated directly; anything else, including the
+ * whitespace that mpz_set_str() skips, is left to GMP. Returns 0 if
+ * successful and -1 if the digits are invalid. Does not touch any Python
+ * object, so it may be called with the GIL released.
  */
 
 static int
-mpz_set_PyStr(mpz_t z, PyObject *s, int base)
+_GMPy_MPZ_Set_ASCII(mpz_t z, const char *cp, int base)
 {
-    char *cp, negative = 0;
-    PyObject *ascii_str;
-
-    ascii_str = GMPy_RemoveIgnoredASCII(s);
-
-    if (!ascii_str) return -1;
+    unsigned long acc = 0, limit;
+    const char *p;
+    int digit;
+
+    if (base >= 2 && base <= 36 && *cp) {
+        limit = ULONG_MAX / (unsigned long)base;
+        for (p = cp; *p; p++) {
+            if (*p >= '0' && *p <= '9')
+                digit = *p - '0';
+            else if (*p >= 'a' && *p <= 'z')
+                digit = *p - 'a' + 10;
+            else if (*p >= 'A' && *p <= 'Z')
+                digit = *p - 'A' + 10;
+            else
+                break;
+            if (digit >= base || acc > limit)
+                break;
+            acc *= (unsigned long)base;
+            if (acc > ULONG_MAX - (unsigned long)digit)
+                break;
+            acc += (unsigned long)digit;
+        }
+        if (!*p) {
+            mpz_set_ui(z, acc);
+            return 0;
+        }
+    }
+    return mpz_set_str(z, cp, base);
+}
 
-    cp = PyBytes_AsString(ascii_str);
+/* Skip the sign and any base prefix of the ASCII string cp, setting
+ * *negative and adjusting *base so that the rest can be passed to
+ * _GMPy_MPZ_Set_ASCII(). Returns a pointer to the first digit.
+ */
 
+static const char *
+_GMPy_MPZ_Prefix(const char *cp, int *base, int *negative)
+{
+    *negative = 0;
     if (cp[0] == '+') cp++;
     if (cp[0] == '-') {
         cp++;
-        negative = 1;
+        *negative = 1;
     }
 
     /* Check for leading base indicators. */
     if (cp[0] == '0' && cp[1] != '\0') {
-        if (base == 0) {
+        if (*base == 0) {
             /* GMP uses prefix '0' for octal, so set base here. */
             if (tolower(cp[1]) == 'o') {
-                base = 8;
+                *base = 8;
                 cp += 2;
             }
             else if (tolower(cp[1]) != 'b' && tolower(cp[1]) != 'x') {
-                base = 10;
+                *base = 10;
             }
         }
         else {
             /* If the specified base matches the leading base indicators,
              * then we need to skip the base indicators.
              */
-            if ((tolower(cp[1]) == 'b' && base ==  2) ||
-                (tolower(cp[1]) == 'o' && base ==  8) ||
-                (tolower(cp[1]) == 'x' && base == 16))
+            if ((tolower(cp[1]) == 'b' && *base ==  2) ||
+                (tolower(cp[1]) == 'o' && *base ==  8) ||
+                (tolower(cp[1]) == 'x' && *base == 16))
             {
                 cp += 2;
             }
         }
     }
 
-    while (cp[0] == '0' && cp[1] != '\0' && base != 0) cp++;
+    while (cp[0] == '0' && cp[1] != '\0' && *base != 0) cp++;
+
+    /* Without a prefix, base 0 means decimal. */
+    if (*base == 0 && cp[0] != '0')
+        *base = 10;
+
+    return cp;
+}
+
+/* Divide-and-conquer conversion of large mpz values to and from strings.
+ *
+ * GMP recomputes the powers of the base on every call to mpz_get_str()
+ * and mpz_set_str(). Once set_radix_cache() has enabled the cache, values
+ * of at least GMPY_RADIX_MIN_BITS bits in a base that is not a power of 2
+ * are converted here instead, using the powers base**(leaf * 2**i) kept
+ * in global.radix_cache. leaf is the number of digits converted by GMP
+ * directly. Each base has a single table that grows as larger values are
+ * converted; tables whose largest power exceeds GMPY_RADIX_CACHE_MAXBITS
+ * bits are used but not kept. The cache is shared by all threads and
+ * protected by const_lock in a free-threaded build.
+ */
+
+#define GMPY_RADIX_LEAF_BITS 1024
+#define GMPY_RADIX_MIN_BITS 65536
+#define GMPY_RADIX_CACHE_MAXBITS 67108864
+
+#ifdef Py_GIL_DISABLED
+#  define RADIX_LOCK()   PyMutex_Lock(&global.const_lock)
+#  define RADIX_UNLOCK() PyMutex_Unlock(&global.const_lock)
+#else
+#  define RADIX_LOCK()
+#  define RADIX_UNLOCK()
+#endif
+
+/* A base is split into 2**twos * odd; only the powers of odd are kept and
+ * the powers of 2 are applied as shifts, which keeps the divisors small.
+ */
+
+typedef struct {
+    int base;               /* negative for capital letters */
+    int twos;
+    int levels;             /* levels needed; table may have more */
+    size_t leaf;
+    PyObject *table;
+} gmpy_radix;
+
+#define RADIX_POWER(table, i) MPZ(PyTuple_GET_ITEM(table, i))
+
+static int
+_GMPy_Radix_Twos(int base)
+{
+    int twos = 0;
+
+    while (!(base & 1)) {
+        base >>= 1;
+        twos++;
+    }
+    return twos;
+}
+
+static size_t
+_GMPy_Radix_Leaf(int base)
+{
+    return (size_t)(GMPY_RADIX_LEAF_BITS / log2((double)base));
+}
+
+/* Return the number of levels needed for ndigits digits, or 0 if the
+ * divide-and-conquer conversion is not used for them.
+ */
+
+static int
+_GMPy_Radix_Levels(int base, size_t ndigits)
+{
+    size_t leaf;
+    int levels = 0;
+
+    if (base < 3 || (base & (base - 1)) == 0 ||
+        (double)ndigits * log2((double)base) < GMPY_RADIX_MIN_BITS) {
+        return 0;
+    }
+    leaf = _GMPy_Radix_Leaf(base);
+    while ((leaf << levels) < ndigits)
+        levels++;
+    return levels;
+}
+
+/* Return a new reference to a table with at least levels powers
+ * odd**(leaf << i) for base. Returns NULL without an exception if the
+ * cache is disabled.
+ */
+
+static PyObject *
+_GMPy_Radix_Table(int base, int levels, CTXT_Object *context)
+{
+    gmpy_radix_cache *cache = &global.radix_cache;
+    gmpy_radix_entry *entry;
+    PyObject *table = NULL, *prefix = NULL, *old = NULL;
+    MPZ_Object *power;
+    Py_ssize_t have = 0;
+    int i, enabled, oldest = 0;
+
+    RADIX_LOCK();
+    enabled = cache->size > 0;
+    for (i = 0; i < cache->count; i++) {
+        entry = &cache->entries[i];
+        if (entry->base == base) {
+            entry->last_used = ++(cache->clock);
+            prefix = entry->table;
+            Py_INCREF(prefix);
+            break;
+        }
+    }
+    if (prefix && PyTuple_GET_SIZE(prefix) >= levels)
+        cache->hits++;
+    else if (enabled)
+        cache->misses++;
+    RADIX_UNLOCK();
+
+    if (!enabled || (prefix && PyTuple_GET_SIZE(prefix) >= levels))
+        return prefix;
+
+    /* Reuse the powers already known and compute the others. */
 
-    /* delegate rest to GMP's function */
-    if (-1 == mpz_set_str(z, cp, base)) {
+    if (!(table = PyTuple_New(levels))) {
+        Py_XDECREF(prefix);
+        return NULL;
+    }
+    if (prefix)
+        have = PyTuple_GET_SIZE(prefix);
+    for (i = 0; i < levels; i++) {
+        if (i < have) {
+            power = (MPZ_Object*)PyTuple_GET_ITEM(prefix, i);
+            Py_INCREF((PyObject*)power);
+        }
+        else if (!(power = GMPy_MPZ_New(NULL))) {
+            Py_DECREF(table);
+            Py_XDECREF(prefix);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(table, i, (PyObject*)power);
+    }
+    Py_XDECREF(prefix);
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, (mp_bitcnt_t)GMPY_RADIX_LEAF_BITS << (levels - 1));
+    for (i = (int)have; i < levels; i++) {
+        if (i == 0)
+            mpz_ui_pow_ui(RADIX_POWER(table, 0), base >> _GMPy_Radix_Twos(base),
+                          _GMPy_Radix_Leaf(base));
+        else
+            mpz_mul(RADIX_POWER(table, i), RADIX_POWER(table, i - 1),
+                    RADIX_POWER(table, i - 1));
+    }
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+
+    if (mpz_sizeinbase(RADIX_POWER(table, levels - 1), 2) > GMPY_RADIX_CACHE_MAXBITS)
+        return table;
+
+    /* Replace the table for base, or the least recently used table if the
+     * cache is full. Another thread may have stored a larger table for base
+     * meanwhile; then it is kept.
+     */
+
+    RADIX_LOCK();
+    for (i = 0; i < cache->count; i++) {
+        if (cache->entries[i].base == base)
+            break;
+        if (cache->entries[i].last_used < cache->entries[oldest].last_used)
+            oldest = i;
+    }
+    if (i == cache->count && cache->count >= cache->size)
+        i = oldest;
+    if (i == cache->count) {
+        cache->count++;
+        cache->entries[i].table = NULL;
+    }
+    entry = &cache->entries[i];
+    if (entry->base != base || !entry->table ||
+        PyTuple_GET_SIZE(entry->table) < levels) {
+
+        old = entry->table;
+        entry->base = base;
+        entry->table = table;
+        Py_INCREF(table);
+    }
+    entry->last_used = ++(cache->clock);
+    RADIX_UNLOCK();
+    Py_XDECREF(old);
+    return table;
+}
+
+/* Fill in rdx for base and ndigits digits. Returns 1 if the
+ * divide-and-conquer conversion is used, 0 if not, and -1 if an exception
+ * is set.
+ */
+
+static int
+_GMPy_Radix_Init(gmpy_radix *rdx, int base, size_t ndigits, CTXT_Object *context)
+{
+    int levels, abase = base < 0 ? -base : base;
+
+    rdx->table = NULL;
+    if (!(levels = _GMPy_Radix_Levels(abase, ndigits)))
+        return 0;
+    if (!(rdx->table = _GMPy_Radix_Table(abase, levels, context)))
+        return PyErr_Occurred() ? -1 : 0;
+    rdx->base = base;
+    rdx->twos = _GMPy_Radix_Twos(abase);
+    rdx->levels = levels;
+    rdx->leaf = _GMPy_Radix_Leaf(abase);
+    return 1;
+}
+
+/* Write the digits of 0 <= x < |base|**(leaf << level) to out. If pad is
+ * set, exactly leaf << level digits are written, with leading zeros.
+ * Returns the number of digits written; a NUL byte follows them. Does not
+ * touch any Python object, so it may be called with the GIL released.
+ */
+
+static size_t
+_GMPy_Radix_Get(char *out, mpz_srcptr x, const gmpy_radix *rdx, int level, int pad)
+{
+    mp_bitcnt_t shift;
+    mpz_t q, r, low;
+    size_t n;
+
+    if (level == 0) {
+        mpz_get_str(out, rdx->base, x);
+        n = strlen(out);
+        if (pad && n < rdx->leaf) {
+            memmove(out + rdx->leaf - n, out, n + 1);
+            memset(out, '0', rdx->leaf - n);
+            n = rdx->leaf;
+        }
+        return n;
+    }
+
+    /* x = q * odd**k * 2**shift + r with k = leaf << (level - 1). */
+
+    shift = (mp_bitcnt_t)rdx->twos * (rdx->leaf << (level - 1));
+    mpz_init(q);
+    mpz_init(r);
+    mpz_init(low);
+    mpz_tdiv_r_2exp(low, x, shift);
+    mpz_tdiv_q_2exp(q, x, shift);
+    mpz_tdiv_qr(q, r, q, RADIX_POWER(rdx->table, level - 1));
+    mpz_mul_2exp(r, r, shift);
+    mpz_add(r, r, low);
+    mpz_clear(low);
+
+    if (!pad && mpz_sgn(q) == 0) {
+        mpz_clear(q);
+        n = _GMPy_Radix_Get(out, r, rdx, level - 1, 0);
+    }
+    else {
+        n = _GMPy_Radix_Get(out, q, rdx, level - 1, pad);
+        mpz_clear(q);
+        n += _GMPy_Radix_Get(out + n, r, rdx, level - 1, 1);
+    }
+    mpz_clear(r);
+    return n;
+}
+
+/* Set z to the value of the n digits at cp, which must all be valid for
+ * base. buf must have room for leaf + 1 bytes. Does not touch any Python
+ * object, so it may be called with the GIL released.
+ */
+
+static void
+_GMPy_Radix_Set(mpz_ptr z, const char *cp, size_t n, const gmpy_radix *rdx,
+                char *buf)
+{
+    mpz_t low;
+    size_t k;
+    int level = 0;
+
+    if (n <= rdx->leaf) {
+        memcpy(buf, cp, n);
+        buf[n] = '\0';
+        mpz_set_str(z, buf, rdx->base);
+        return;
+    }
+
+    /* Split off the largest block of k = leaf << level digits shorter
+     * than the string; the high part is then no longer than the low part.
+     */
+
+    while ((rdx->leaf << (level + 1)) < n)
+        level++;
+    k = rdx->leaf << level;
+    mpz_init(low);
+    _GMPy_Radix_Set(z, cp, n - k, rdx, buf);
+    _GMPy_Radix_Set(low, cp + n - k, k, rdx, buf);
+    mpz_mul(z, z, RADIX_POWER(rdx->table, level));
+    mpz_mul_2exp(z, z, (mp_bitcnt_t)rdx->twos * k);
+    mpz_add(z, z, low);
+    mpz_clear(low);
+}
+
+/* Return 1 if the n characters at cp are all digits that mpz_set_str()
+ * accepts for base, and 0 otherwise.
+ */
+
+static int
+_GMPy_Radix_Valid(const char *cp, size_t n, int base)
+{
+    size_t i;
+    int digit;
+
+    for (i = 0; i < n; i++) {
+        if (cp[i] >= '0' && cp[i] <= '9')
+            digit = cp[i] - '0';
+        else if (cp[i] >= 'A' && cp[i] <= 'Z')
+            digit = cp[i] - 'A' + 10;
+        else if (cp[i] >= 'a' && cp[i] <= 'z')
+            digit = cp[i] - 'a' + (base <= 36 ? 10 : 36);
+        else
+            return 0;
+        if (digit >= base)
+            return 0;
+    }
+    return 1;
+}
+
+PyDoc_STRVAR(GMPy_doc_radix_cache_info,
+"radix_cache_info() -> dict\n\n"
+"Return a dictionary describing the cache of powers used to convert\n"
+"large integers to and from strings:\n\n"
+"    size:    maximum number of bases kept\n"
+"    hits:    number of conversions that found their powers in the cache\n"
+"    misses:  number of conversions that computed powers\n"
+"    entries: list of (base, levels) tuples");
+
+static PyObject *
+GMPy_Radix_Cache_Info(PyObject *self, PyObject *args)
+{
+    gmpy_radix_cache *cache = &global.radix_cache;
+    int bases[GMPY_RADIX_CACHE_MAX];
+    Py_ssize_t levels[GMPY_RADIX_CACHE_MAX];
+    unsigned long long hits, misses;
+    PyObject *list, *item;
+    int i, count, size;
+
+    RADIX_LOCK();
+    count = cache->count;
+    size = cache->size;
+    hits = cache->hits;
+    misses = cache->misses;
+    for (i = 0; i < count; i++) {
+        bases[i] = cache->entries[i].base;
+        levels[i] = PyTuple_GET_SIZE(cache->entries[i].table);
+    }
+    RADIX_UNLOCK();
+
+    if (!(list = PyList_New(count)))
+        return NULL;
+    for (i = 0; i < count; i++) {
+        if (!(item = Py_BuildValue("(in)", bases[i], levels[i]))) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return Py_BuildValue("{s:i,s:K,s:K,s:N}", "size", size, "hits", hits,
+                         "misses", misses, "entries", list);
+}
+
+PyDoc_STRVAR(GMPy_doc_set_radix_cache,
+"set_radix_cache(size, /) -> None\n\n"
+"Set the maximum number of bases whose powers are kept for converting\n"
+"integers of at least " Py_STRINGIFY(GMPY_RADIX_MIN_BITS) " bits to and from strings. size must be\n"
+"in the interval [0, " Py_STRINGIFY(GMPY_RADIX_CACHE_MAX) "]; 0, the default, disables the cache and\n"
+"leaves the conversions to GMP. The least recently used bases are\n"
+"removed if the cache shrinks.");
+
+static PyObject *
+GMPy_Set_Radix_Cache(PyObject *self, PyObject *other)
+{
+    gmpy_radix_cache *cache = &global.radix_cache;
+    PyObject *removed[GMPY_RADIX_CACHE_MAX];
+    long size;
+    int i, n = 0;
+
+    size = PyLong_AsLong(other);
+    if (size == -1 && PyErr_Occurred())
+        return NULL;
+    if (size < 0 || size > GMPY_RADIX_CACHE_MAX) {
+        VALUE_ERROR("size must be in the interval [0, " Py_STRINGIFY(GMPY_RADIX_CACHE_MAX) "]");
+        return NULL;
+    }
+
+    RADIX_LOCK();
+    cache->size = (int)size;
+    while (cache->count > size) {
+        int oldest = 0;
+
+        for (i = 1; i < cache->count; i++) {
+            if (cache->entries[i].last_used < cache->entries[oldest].last_used)
+                oldest = i;
+        }
+        removed[n++] = cache->entries[oldest].table;
+        cache->entries[oldest] = cache->entries[--(cache->count)];
+    }
+    RADIX_UNLOCK();
+
+    for (i = 0; i < n; i++)
+        Py_DECREF(removed[i]);
+    Py_RETURN_NONE;
+}
+
+/* mpz_set_PyStr converts a Python "string" into a mpz_t structure. It accepts
+ * a sequence of bytes (i.e. str in Python 2, bytes in Python 3) or a Unicode
+ * string (i.e. unicode in Python 3, str in Python 3). Returns -1 on error,
+ * 1 if successful.
+ *
+ * The characters are read in place; a copy is only made when the string
+ * contains spaces or underscores.
+ */
+
+static int
+mpz_set_PyStr(mpz_t z, PyObject *s, int base)
+{
+    const char *cp;
+    int res, negative, use_radix = 0;
+    size_t len;
+    Py_ssize_t size;
+    PyObject *ascii_str = NULL;
+    gmpy_radix rdx;
+    char leafbuf[GMPY_RADIX_LEAF_BITS + 1];
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT_M1(context);
+
+    if (!(cp = _GMPy_ASCII_Data(s, &size)))
+        return -1;
+
+    if (memchr(cp, ' ', size) || memchr(cp, '_', size)) {
+        if (!(ascii_str = GMPy_RemoveIgnoredASCII(s)))
+            return -1;
+        cp = PyBytes_AS_STRING(ascii_str);
+    }
+
+    cp = _GMPy_MPZ_Prefix(cp, &base, &negative);
+
+    /* delegate long strings to GMP's subquadratic mpz_set_str(); each
+     * digit is at least 3 bits unless base is 2 to 7 */
+    len = strlen(cp);
+    if (base >= 2 && _GMPy_Radix_Levels(base, len) && _GMPy_Radix_Valid(cp, len, base) &&
+        (use_radix = _GMPy_Radix_Init(&rdx, base, len, context)) < 0) {
+
+        Py_XDECREF(ascii_str);
+        return -1;
+    }
+
+    GMPY_PROFILE_OP(context, GMPY_OP_STR, len * 3);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, len * 3);
+    if (use_radix) {
+        _GMPy_Radix_Set(z, cp, len, &rdx, leafbuf);
+        res = 0;
+    }
+    else {
+        res = _GMPy_MPZ_Set_ASCII(z, cp, base);
+    }
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    if (use_radix)
+        Py_DECREF(rdx.table);
+    Py_XDECREF(ascii_str);
+    if (-1 == res) {
         VALUE_ERROR("invalid digits");
-        Py_DECREF(ascii_str);
         return -1;
     }
     if (negative) {
         mpz_neg(z, z);
     }
-    Py_DECREF(ascii_str);
     return 1;
 }
 
@@ -253,6 +849,40 @@ mpz_set_PyStr(mpz_t z, PyObject *s, int base)
 static char* _ztag = "mpz(";
 static char* _xztag = "xmpz(";
 
+/* Write the digits of abs(z) in base to out, which must have room for
+ * mpz_sizeinbase(z, |base|) + 1 bytes, and return their number, or -1 if
+ * an exception is set. Large values are converted without the GIL.
+ */
+
+static Py_ssize_t
+_GMPy_MPZ_Get_Digits(char *out, mpz_srcptr z, int base, CTXT_Object *context)
+{
+    gmpy_radix rdx;
+    mpz_t absz;
+    int use_radix;
+
+    use_radix = _GMPy_Radix_Init(&rdx, base,
+                                 mpz_sizeinbase(z, (base < 0 ? -base : base)),
+                                 context);
+    if (use_radix < 0)
+        return -1;
+
+    /* Format the absolute value through a read-only alias so z is never
+     * modified, even temporarily, while the GIL may be released. */
+    mpz_roinit_n(absz, mpz_limbs_read(z), mpz_size(z));
+
+    GMPY_PROFILE_MPZ(context, GMPY_OP_STR, z);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(z));
+    if (use_radix)
+        _GMPy_Radix_Get(out, absz, &rdx, rdx.levels, 0);
+    else
+        mpz_get_str(out, base, absz);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    if (use_radix)
+        Py_DECREF(rdx.table);
+    return (Py_ssize_t)strlen(out);
+}
+
 static PyObject *
 mpz_ascii(mpz_t z, int base, int option, int which)
 {
@@ -260,6 +890,9 @@ mpz_ascii(mpz_t z, int base, int option, int which)
     char *buffer, *p;
     int negative = 0;
     size_t size;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
 
     if (
         !(
@@ -287,7 +920,6 @@ mpz_ascii(mpz_t z, int base, int option, int which)
 
     if (mpz_sgn(z) < 0) {
         negative = 1;
-        mpz_neg(z, z);
     }
 
     p = buffer;
@@ -322,8 +954,10 @@ mpz_ascii(mpz_t z, int base, int option, int which)
         else if (base == -16) { *(p++) = '0'; *(p++) = 'X'; }
     }
 
-    /* Call GMP. */
-    mpz_get_str(p, base, z);
+    if (_GMPy_MPZ_Get_Digits(p, z, base, context) < 0) {
+        TEMP_FREE(buffer, size);
+        return NULL;
+    }
     p = buffer + strlen(buffer);
 
     if (option & 1)
@@ -331,9 +965,6 @@ mpz_ascii(mpz_t z, int base, int option, int which)
     *(p++) = '\00';
 
     result = Py_BuildValue("s", buffer);
-    if (negative == 1) {
-        mpz_neg(z, z);
-    }
     TEMP_FREE(buffer, size);
     return result;
 }
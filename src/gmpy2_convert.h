@@ -31,13 +31,24 @@
 extern "C" {
 #endif
 
+/* GMPy_Conversions(x) returns the conversion methods that the type of x
+ * defines, as a mask of GMPY_CONV_* bits. The result is cached for each
+ * type until the type is modified.
+ */
+#define GMPY_CONV_MPZ  1
+#define GMPY_CONV_MPQ  2
+#define GMPY_CONV_MPFR 4
+#define GMPY_CONV_MPC  8
+
+static int GMPy_Conversions(PyObject *obj);
+
 /* The following macros classify the numeric types that are supported by
  * gmpy2.
  */
-#define HAS_MPZ_CONVERSION(x) (PyObject_HasAttrString(x, "__mpz__"))
-#define HAS_MPQ_CONVERSION(x) (PyObject_HasAttrString(x, "__mpq__"))
-#define HAS_MPFR_CONVERSION(x) (PyObject_HasAttrString(x, "__mpfr__"))
-#define HAS_MPC_CONVERSION(x) (PyObject_HasAttrString(x, "__mpc__"))
+#define HAS_MPZ_CONVERSION(x) (GMPy_Conversions(x) & GMPY_CONV_MPZ)
+#define HAS_MPQ_CONVERSION(x) (GMPy_Conversions(x) & GMPY_CONV_MPQ)
+#define HAS_MPFR_CONVERSION(x) (GMPy_Conversions(x) & GMPY_CONV_MPFR)
+#define HAS_MPC_CONVERSION(x) (GMPy_Conversions(x) & GMPY_CONV_MPC)
 
 #define HAS_STRICT_MPZ_CONVERSION(x) (HAS_MPZ_CONVERSION(x) && \
                                      !HAS_MPQ_CONVERSION(x))
@@ -50,10 +61,12 @@ extern "C" {
                              HAS_MPQ_CONVERSION(x))
 
 #define IS_INTEGER(x) (MPZ_Check(x) || PyLong_Check(x) || \
-                       XMPZ_Check(x) || HAS_STRICT_MPZ_CONVERSION(x))
+                       XMPZ_Check(x) || MPZ_View_Check(x) || \
+                       HAS_STRICT_MPZ_CONVERSION(x))
 #define IS_RATIONAL(x) (MPQ_Check(x) || IS_FRACTION(x) || \
                         MPZ_Check(x) || PyLong_Check(x) || \
-                        XMPZ_Check(x) || HAS_MPQ_CONVERSION(x) || \
+                        XMPZ_Check(x) || MPZ_View_Check(x) || \
+                        HAS_MPQ_CONVERSION(x) || \
                         HAS_MPZ_CONVERSION(x))
 #define IS_DECIMAL(x) (!strcmp(Py_TYPE(x)->tp_name, "decimal.Decimal"))
 #define IS_REAL_ONLY(x) (MPFR_Check(x) || PyFloat_Check(x) || \
@@ -71,7 +84,8 @@ extern "C" {
 #define OBJ_TYPE_XMPZ           2
 #define OBJ_TYPE_PyInteger      3
 #define OBJ_TYPE_HAS_MPZ        4
-/* 5 TO 14 reserved for additional integer types. */
+#define OBJ_TYPE_MPZ_VIEW       5
+/* 6 TO 14 reserved for additional integer types. */
 #define OBJ_TYPE_INTEGER        15
 
 #define OBJ_TYPE_MPQ            16
@@ -101,8 +115,10 @@ extern "C" {
 #define IS_TYPE_UNKNOWN(x)          (!OBJ_TYPE_UNKNOWN)
 #define IS_TYPE_MPZ(x)              (x == OBJ_TYPE_MPZ)
 #define IS_TYPE_XMPZ(x)             (x == OBJ_TYPE_XMPZ)
+#define IS_TYPE_MPZ_VIEW(x)         (x == OBJ_TYPE_MPZ_VIEW)
 #define IS_TYPE_MPZANY(x)           ((x == OBJ_TYPE_MPZ) || \
-                                     (x == OBJ_TYPE_XMPZ))
+                                     (x == OBJ_TYPE_XMPZ) || \
+                                     (x == OBJ_TYPE_MPZ_VIEW))
 #define IS_TYPE_PyInteger(x)        (x == OBJ_TYPE_PyInteger)
 #define IS_TYPE_HAS_MPZ(x)          (x == OBJ_TYPE_HAS_MPZ)
 #define IS_TYPE_INTEGER(x)          ((x > OBJ_TYPE_UNKNOWN) &&  \
@@ -132,6 +148,22 @@ extern "C" {
 #define IS_TYPE_COMPLEX_ONLY(x)     ((x > OBJ_TYPE_REAL) && \
                                      (x < OBJ_TYPE_COMPLEX))
 
+/* Each group of 16 type codes is one numeric class: 0 for integers, 1 for
+ * rationals, 2 for reals, and 3 for complex numbers. For two known types,
+ * GMPY_TYPE_CLASS2() is the class both operands must be converted to. It
+ * indexes the tables of *WithType functions used by the arithmetic
+ * operations.
+ */
+
+#define OBJ_CLASS_COUNT             4
+#define GMPY_TYPE_CLASS(x)          ((x) >> 4)
+#define GMPY_TYPE_CLASS2(x, y)      (Py_MAX(x, y) >> 4)
+
+typedef PyObject *(*gmpy_binary_withtype)(PyObject *, int, PyObject *, int,
+                                          CTXT_Object *);
+typedef PyObject *(*gmpy_ternary_withtype)(PyObject *, int, PyObject *, int,
+                                           PyObject *, CTXT_Object *);
+
 /* Compatibility macros (to work with PyLongObject internals).
  */
 
@@ -154,6 +186,12 @@ extern "C" {
 #  define _PyLong_DigitCount(obj) (_PyLong_IsNegative(obj)? -Py_SIZE(obj):Py_SIZE(obj))
 #endif
 
+/* Python 3.14 added the PyLong_Export() and PyLongWriter API (PEP 757). */
+
+#if PY_VERSION_HEX >= 0x030E0000
+#  define GMPY_PYLONG_EXPORT 1
+#endif
+
 /* Since the macros are used in gmpy2's codebase, these functions are skipped
  * until they are needed for the C API in the future.
  */
@@ -177,8 +215,12 @@ static int GMPy_isComplex(PyObject *obj);
 
 /* ======== C helper routines ======== */
 static int             mpz_set_PyStr(mpz_t z, PyObject *s, int base);
+static Py_ssize_t      _GMPy_MPZ_Get_Digits(char *out, mpz_srcptr z, int base, CTXT_Object *context);
 static PyObject *      mpz_ascii(mpz_t z, int base, int option, int which);
 
+static PyObject *      GMPy_Radix_Cache_Info(PyObject *self, PyObject *args);
+static PyObject *      GMPy_Set_Radix_Cache(PyObject *self, PyObject *other);
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,70 +38,192 @@
  * Conversion between native Python objects and MPZ.                        *
  * ======================================================================== */
 
-static MPZ_Object *
-GMPy_MPZ_From_PyLong(PyObject *obj, CTXT_Object *context)
+/* Conversion between PyLong digits and GMP limbs.
+ *
+ * A PyLong stores its magnitude as little-endian digits of PyLong_SHIFT
+ * bits. The digits are packed into limbs (and unpacked from them) one word
+ * at a time, which is much faster than mpz_import() and mpz_export() with
+ * nails. The loops are based on mpn_set_pylong() and mpn_get_pylong() in
+ * mpz_pylong.c but run from the least significant end. Values that fit in
+ * a C long take the mpz_set_si() and PyLong_FromLong() paths instead.
+ *
+ * On Python 3.14 and later the digits are read with PyLong_Export() and
+ * written with PyLongWriter_Create(). If the native layout ever differs
+ * from PyLong_SHIFT bit digits, mpz_import() and mpz_export() are used.
+ */
+
+#if GMP_NAIL_BITS == 0
+
+static void
+_GMPy_Digits_To_Limbs(mp_ptr up, const digit *digits, size_t size)
 {
-    MPZ_Object *result;
-    int negative;
-    Py_ssize_t len;
-    PyLongObject *templong = (PyLongObject*)obj;
+    mp_limb_t acc = 0, d;
+    unsigned int bits = 0;
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        d = (mp_limb_t)digits[i];
+        acc |= d << bits;
+        bits += PyLong_SHIFT;
+        if (bits >= GMP_NUMB_BITS) {
+            *up++ = acc;
+            bits -= GMP_NUMB_BITS;
+            acc = d >> (PyLong_SHIFT - bits);
+        }
+    }
+    if (bits)
+        *up = acc;
+}
 
-    if(!(result = GMPy_MPZ_New(context))) {
-        /* LCOV_EXCL_START */
-        return NULL;
-        /* LCOV_EXCL_STOP */
+static void
+_GMPy_Limbs_To_Digits(digit *digits, size_t size, mp_srcptr up, size_t un)
+{
+    mp_limb_t acc = 0, w;
+    unsigned int bits = 0;
+    size_t i, j = 0;
+
+    for (i = 0; i < size; i++) {
+        if (bits >= PyLong_SHIFT) {
+            digits[i] = (digit)(acc & PyLong_MASK);
+            acc >>= PyLong_SHIFT;
+            bits -= PyLong_SHIFT;
+        }
+        else {
+            w = j < un ? up[j++] : 0;
+            digits[i] = (digit)((acc | (w << bits)) & PyLong_MASK);
+            acc = w >> (PyLong_SHIFT - bits);
+            bits += GMP_NUMB_BITS - PyLong_SHIFT;
+        }
     }
+}
 
-    len = _PyLong_DigitCount(templong);
-    negative = _PyLong_IsNegative(templong);
+#endif
 
-    switch (len) {
-    case 1:
-        mpz_set_si(result->z, (sdigit)GET_OB_DIGIT(templong)[0]);
-        break;
-    case 0:
-        mpz_set_si(result->z, 0);
-        break;
-    default:
-        mpz_import(result->z, len, -1, sizeof(GET_OB_DIGIT(templong)[0]), 0,
-                   sizeof(GET_OB_DIGIT(templong)[0])*8 - PyLong_SHIFT,
-                   GET_OB_DIGIT(templong));
-    }
+/* Set z from size digits of PyLong_SHIFT bits. */
 
-    if (negative) {
-        mpz_neg(result->z, result->z);
+static void
+_GMPy_MPZ_Set_Digits(mpz_ptr z, const digit *digits, size_t size, int negative)
+{
+    if (size <= 1) {
+        mpz_set_ui(z, size ? (unsigned long)digits[0] : 0);
     }
-    return result;
+    else {
+#if GMP_NAIL_BITS == 0
+        size_t un = (size * PyLong_SHIFT + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+
+        _GMPy_Digits_To_Limbs(mpz_limbs_write(z, un), digits, size);
+        mpz_limbs_finish(z, un);
+#else
+        mpz_import(z, size, -1, sizeof(digit), 0,
+                   sizeof(digit) * 8 - PyLong_SHIFT, digits);
+#endif
+    }
+    if (negative)
+        mpz_neg(z, z);
 }
 
+/* Return 1 if the native PyLong layout uses the digit type of this build. */
+
+#ifdef GMPY_PYLONG_EXPORT
+static int
+_GMPy_PyLong_Native_Digits(const PyLongLayout *layout)
+{
+    return layout->bits_per_digit == PyLong_SHIFT &&
+           layout->digit_size == sizeof(digit) &&
+           layout->digits_order == -1 &&
+           layout->digit_endianness == (PY_LITTLE_ENDIAN ? -1 : 1);
+}
+#endif
+
 /* To support creation of temporary mpz objects. */
 static void
 mpz_set_PyLong(mpz_t z, PyObject *obj)
 {
-    int negative;
-    Py_ssize_t len;
+#ifdef GMPY_PYLONG_EXPORT
+    PyLongExport export;
+    const PyLongLayout *layout;
+
+    if (PyLong_Export(obj, &export) < 0) {
+        /* LCOV_EXCL_START */
+        /* Only fails if obj is not an int. */
+        PyErr_Clear();
+        mpz_set_ui(z, 0);
+        return;
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (!export.digits) {
+#if LONG_MAX >= INT64_MAX
+        mpz_set_si(z, (long)export.value);
+#else
+        uint64_t value = export.value < 0 ? -(uint64_t)export.value : (uint64_t)export.value;
+
+        mpz_import(z, 1, -1, sizeof(value), 0, 0, &value);
+        if (export.value < 0)
+            mpz_neg(z, z);
+#endif
+        return;
+    }
+
+    layout = PyLong_GetNativeLayout();
+    if (_GMPy_PyLong_Native_Digits(layout)) {
+        _GMPy_MPZ_Set_Digits(z, (const digit*)export.digits, (size_t)export.ndigits,
+                             export.negative);
+    }
+    else {
+        mpz_import(z, (size_t)export.ndigits, layout->digits_order,
+                   layout->digit_size, layout->digit_endianness,
+                   layout->digit_size * 8 - layout->bits_per_digit,
+                   export.digits);
+        if (export.negative)
+            mpz_neg(z, z);
+    }
+    PyLong_FreeExport(&export);
+#else
     PyLongObject *templong = (PyLongObject*)obj;
 
-    len = _PyLong_DigitCount(templong);
-    negative = _PyLong_IsNegative(templong);
+    _GMPy_MPZ_Set_Digits(z, GET_OB_DIGIT(templong),
+                         (size_t)_PyLong_DigitCount(templong),
+                         _PyLong_IsNegative(templong));
+#endif
+}
 
-    switch (len) {
-    case 1:
-        mpz_set_si(z, (sdigit)GET_OB_DIGIT(templong)[0]);
-        break;
-    case 0:
-        mpz_set_si(z, 0);
-        break;
-    default:
-        mpz_import(z, len, -1, sizeof(GET_OB_DIGIT(templong)[0]), 0,
-                   sizeof(GET_OB_DIGIT(templong)[0])*8 - PyLong_SHIFT,
-                   GET_OB_DIGIT(templong));
+/* Return a new mpz that no other object refers to, so the caller may
+ * compute in it. GMPy_MPZ_Result_From_PyLong() is for results, such as that
+ * of mpz(), and returns the shared mpz for a value from -5 to 256.
+ */
+
+static MPZ_Object *
+GMPy_MPZ_From_PyLong(PyObject *obj, CTXT_Object *context)
+{
+    MPZ_Object *result;
+    Py_ssize_t len = _PyLong_DigitCount((PyLongObject*)obj);
+
+    if(!(result = GMPy_MPZ_NewSize((len * PyLong_SHIFT) / GMP_NUMB_BITS + 1, context))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
     }
 
-    if (negative) {
-        mpz_neg(z, z);
+    mpz_set_PyLong(result->z, obj);
+    return result;
+}
+
+static MPZ_Object *
+GMPy_MPZ_Result_From_PyLong(PyObject *obj, CTXT_Object *context)
+{
+    PyLongObject *templong = (PyLongObject*)obj;
+    Py_ssize_t len = _PyLong_DigitCount(templong);
+
+    if (len <= 1) {
+        long value = len ? (long)GET_OB_DIGIT(templong)[0] : 0;
+
+        if (_PyLong_IsNegative(templong))
+            value = -value;
+        if (GMPY_MPZ_IS_SMALL(value))
+            return GMPy_MPZ_Small(value);
     }
-    return;
+    return GMPy_MPZ_From_PyLong(obj, context);
 }
 
 static MPZ_Object *
@@ -149,35 +271,62 @@ static PyObject *
 GMPy_PyLong_From_MPZ(MPZ_Object *obj, CTXT_Object *context)
 {
     int negative;
-    size_t count, size;
+    size_t size;
+#ifdef GMPY_PYLONG_EXPORT
+    const PyLongLayout *layout;
+    PyLongWriter *writer;
+    void *digits;
+#else
     PyLongObject *result;
+#endif
 
-    /* Assume gmp uses limbs as least as large as the builtin longs do */
+    if (mpz_fits_slong_p(obj->z))
+        return PyLong_FromLong(mpz_get_si(obj->z));
 
     negative = mpz_sgn(obj->z) < 0;
-    size = (mpz_sizeinbase(obj->z, 2) + PyLong_SHIFT - 1) / PyLong_SHIFT;
 
-    if (!(result = _PyLong_New(size))) {
+#ifdef GMPY_PYLONG_EXPORT
+    layout = PyLong_GetNativeLayout();
+    size = (mpz_sizeinbase(obj->z, 2) + layout->bits_per_digit - 1) / layout->bits_per_digit;
+
+    if (!(writer = PyLongWriter_Create(negative, (Py_ssize_t)size, &digits))) {
         /* LCOV_EXCL_START */
         return NULL;
         /* LCOV_EXCL_STOP */
     }
 
-    mpz_export(GET_OB_DIGIT(result), &count, -1, sizeof(GET_OB_DIGIT(result)[0]), 0,
-               sizeof(GET_OB_DIGIT(result)[0])*8 - PyLong_SHIFT, obj->z);
+#if GMP_NAIL_BITS == 0
+    if (_GMPy_PyLong_Native_Digits(layout))
+        _GMPy_Limbs_To_Digits((digit*)digits, size, mpz_limbs_read(obj->z), mpz_size(obj->z));
+    else
+#endif
+        mpz_export(digits, NULL, layout->digits_order, layout->digit_size,
+                   layout->digit_endianness,
+                   layout->digit_size * 8 - layout->bits_per_digit, obj->z);
+
+    return PyLongWriter_Finish(writer);
+#else
+    size = (mpz_sizeinbase(obj->z, 2) + PyLong_SHIFT - 1) / PyLong_SHIFT;
 
-    if (count == 0) {
-        GET_OB_DIGIT(result)[0] = 0;
+    if (!(result = _PyLong_New(size))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
     }
 
-    /* long_normalize() is file-static so we must reimplement it */
-    /* longobjp = long_normalize(longobjp); */
-    while ((size>0) && (GET_OB_DIGIT(result)[size-1] == 0)) {
-        size--;
-    }
+    /* The most significant digit is not zero so no normalization is
+     * needed.
+     */
+#if GMP_NAIL_BITS == 0
+    _GMPy_Limbs_To_Digits(GET_OB_DIGIT(result), size, mpz_limbs_read(obj->z), mpz_size(obj->z));
+#else
+    mpz_export(GET_OB_DIGIT(result), NULL, -1, sizeof(digit), 0,
+               sizeof(digit) * 8 - PyLong_SHIFT, obj->z);
+#endif
 
     _PyLong_SetSignAndDigitCount(result, negative, size);
     return (PyObject*)result;
+#endif
 }
 
 static PyObject *
@@ -213,6 +362,13 @@ GMPy_PyStr_From_MPZ(MPZ_Object *obj, int base, int option, CTXT_Object *context)
     return mpz_ascii(obj->z, base, option, 0);
 }
 
+/* Convert an integer to an mpz. An mpz argument, and the result of
+ * __mpz__(), are returned as they are, and either may be a shared small
+ * mpz: never modify the result. A function that computes in the converted
+ * value must use GMPy_MPZ_From_IntegerAndCopy(), which always returns a new
+ * object. The same holds for the WithType variants.
+ */
+
 static MPZ_Object *
 GMPy_MPZ_From_Integer(PyObject *obj, CTXT_Object *context)
 {
@@ -226,7 +382,7 @@ GMPy_MPZ_From_Integer(PyObject *obj, CTXT_Object *context)
     if (PyLong_Check(obj))
         return GMPy_MPZ_From_PyLong(obj, context);
 
-    if (XMPZ_Check(obj))
+    if (XMPZ_Check(obj) || MPZ_View_Check(obj))
         return GMPy_MPZ_From_XMPZ((XMPZ_Object*)obj, context);
 
     if (HAS_STRICT_MPZ_CONVERSION(obj)) {
@@ -246,6 +402,45 @@ GMPy_MPZ_From_Integer(PyObject *obj, CTXT_Object *context)
     return NULL;
 }
 
+/* Return the value of the integer obj without creating an object. An mpz
+ * is used in place; any other integer is set in a slot of the scratch
+ * pool, which the caller returns with _GMPy_Scratch_Release() after taking
+ * a mark. Must be called with the GIL held. Returns NULL and raises
+ * TypeError if obj is not an integer.
+ */
+
+static mpz_srcptr
+GMPy_MPZ_Scratch_From_Integer(PyObject *obj)
+{
+    MPZ_Object *temp;
+    mpz_ptr z;
+
+    if (MPZ_Check(obj) || MPZ_View_Check(obj))
+        return MPZ(obj);
+
+    GMPy_Scratch_Attach();
+
+    if (PyLong_Check(obj)) {
+        z = _GMPy_Scratch_Get(0);
+        mpz_set_PyLong(z, obj);
+        return z;
+    }
+
+    /* An xmpz is copied since it may change while the GIL is released. */
+    if (XMPZ_Check(obj)) {
+        z = _GMPy_Scratch_Get(mpz_sizeinbase(MPZ(obj), 2));
+        mpz_set(z, MPZ(obj));
+        return z;
+    }
+
+    if (!(temp = GMPy_MPZ_From_Integer(obj, NULL)))
+        return NULL;
+    z = _GMPy_Scratch_Get(mpz_sizeinbase(temp->z, 2));
+    mpz_set(z, temp->z);
+    Py_DECREF((PyObject*)temp);
+    return z;
+}
+
 static MPZ_Object *
 GMPy_MPZ_From_IntegerAndCopy(PyObject *obj, CTXT_Object *context)
 {
@@ -264,13 +459,21 @@ GMPy_MPZ_From_IntegerAndCopy(PyObject *obj, CTXT_Object *context)
     if (PyLong_Check(obj))
         return GMPy_MPZ_From_PyLong(obj, context);
 
-    if (XMPZ_Check(obj))
+    if (XMPZ_Check(obj) || MPZ_View_Check(obj))
         return GMPy_MPZ_From_XMPZ((XMPZ_Object*)obj, context);
 
     if (HAS_STRICT_MPZ_CONVERSION(obj)) {
         result = (MPZ_Object *) PyObject_CallMethod(obj, "__mpz__", NULL);
 
         if (result != NULL && MPZ_Check(result)) {
+            /* __mpz__ may return a shared object. */
+            if (Py_REFCNT(result) > 1) {
+                MPZ_Object *temp = result;
+
+                if ((result = GMPy_MPZ_New(context)))
+                    mpz_set(result->z, temp->z);
+                Py_DECREF((PyObject*)temp);
+            }
             return result;
         }
         else {
@@ -297,7 +500,7 @@ GMPy_MPZ_From_IntegerWithType(PyObject *obj, int xtype, CTXT_Object *context)
     if (IS_TYPE_PyInteger(xtype))
         return GMPy_MPZ_From_PyLong(obj, context);
 
-    if (IS_TYPE_XMPZ(xtype))
+    if (IS_TYPE_XMPZ(xtype) || IS_TYPE_MPZ_VIEW(xtype))
         return GMPy_MPZ_From_XMPZ((XMPZ_Object*)obj, context);
 
     if (IS_TYPE_HAS_MPZ(xtype)) {
@@ -458,7 +661,13 @@ GMPy_XMPZ_From_MPZ(MPZ_Object *obj, CTXT_Object *context)
 {
     XMPZ_Object *result;
 
-    if ((result = GMPy_XMPZ_New(context)))
+    if (!(result = GMPy_XMPZ_New(context)))
+        return NULL;
+
+    /* A large value is shared until result is changed. */
+    if (mpz_size(obj->z) >= GMPY_XMPZ_SHARE_LIMBS)
+        _GMPy_XMPZ_Share(result, obj);
+    else
         mpz_set(result->z, obj->z);
 
     return result;
@@ -468,10 +677,20 @@ static XMPZ_Object *
 GMPy_XMPZ_From_XMPZ(XMPZ_Object *obj, CTXT_Object *context)
 {
     XMPZ_Object *result;
+    MPZ_Object *owner;
 
-    if ((result = GMPy_XMPZ_New(context)))
-        mpz_set(result->z, obj->z);
+    if (mpz_size(obj->z) < GMPY_XMPZ_SHARE_LIMBS) {
+        if ((result = GMPy_XMPZ_New(context)))
+            mpz_set(result->z, obj->z);
+        return result;
+    }
 
+    /* Both share the limbs of an mpz until either is changed. */
+    if (!(owner = _GMPy_XMPZ_Freeze(obj, context)))
+        return NULL;
+    if ((result = GMPy_XMPZ_New(context)))
+        _GMPy_XMPZ_Share(result, owner);
+    Py_DECREF((PyObject*)owner);
     return result;
 }
 
@@ -486,7 +705,7 @@ GMPy_MPZ_From_XMPZ(XMPZ_Object *obj, CTXT_Object *context)
 {
     MPZ_Object *result;
 
-    if ((result = GMPy_MPZ_New(context)))
+    if ((result = GMPy_MPZ_NewSize(mpz_size(obj->z), context)))
         mpz_set(result->z, obj->z);
 
     return result;
@@ -852,35 +1071,182 @@ GMPy_MPQ_Float_Slot(MPQ_Object *self)
     return GMPy_PyFloat_From_MPQ(self, NULL);
 }
 
+/* Return the offset of the __slots__ member name of type, or -1. */
+
+static Py_ssize_t
+_GMPy_Slot_Offset(PyTypeObject *type, const char *name)
+{
+    PyObject *descr;
+    Py_ssize_t offset = -1;
+
+    if (!(descr = PyObject_GetAttrString((PyObject*)type, name))) {
+        PyErr_Clear();
+        return -1;
+    }
+    if (Py_IS_TYPE(descr, &PyMemberDescr_Type) &&
+        ((PyMemberDescrObject*)descr)->d_member->type == T_OBJECT_EX) {
+        offset = ((PyMemberDescrObject*)descr)->d_member->offset;
+    }
+    Py_DECREF(descr);
+    return offset;
+}
+
+/* Find fractions.Fraction and the slots that hold its numerator and
+ * denominator. If that fails, Fractions are converted through their
+ * numerator and denominator properties.
+ */
+
+static void
+_GMPy_Fraction_Lookup(void)
+{
+    PyObject *module, *type = NULL;
+
+    global.fraction_lookup_done = 1;
+    if ((module = PyImport_ImportModule("fractions"))) {
+        type = PyObject_GetAttrString(module, "Fraction");
+        Py_DECREF(module);
+    }
+    if (!type || !PyType_Check(type)) {
+        PyErr_Clear();
+        Py_XDECREF(type);
+        return;
+    }
+    global.fraction_num_offset = _GMPy_Slot_Offset((PyTypeObject*)type, "_numerator");
+    global.fraction_den_offset = _GMPy_Slot_Offset((PyTypeObject*)type, "_denominator");
+    if (global.fraction_num_offset < 0 || global.fraction_den_offset < 0) {
+        Py_DECREF(type);
+        return;
+    }
+    global.fraction_type = (PyTypeObject*)type;
+}
+
+/* Set num and den from a Fraction. An exact fractions.Fraction is read
+ * from its slots; other types use the numerator and denominator
+ * attributes.
+ */
+
+static int
+_GMPy_Fraction_Parts(PyObject *obj, mpz_t num, mpz_t den)
+{
+    PyObject *pnum, *pden;
+
+    if (!global.fraction_lookup_done)
+        _GMPy_Fraction_Lookup();
+
+    if (Py_TYPE(obj) == global.fraction_type) {
+        pnum = *(PyObject**)((char*)obj + global.fraction_num_offset);
+        pden = *(PyObject**)((char*)obj + global.fraction_den_offset);
+        if (pnum && PyLong_Check(pnum) && pden && PyLong_Check(pden)) {
+            mpz_set_PyLong(num, pnum);
+            mpz_set_PyLong(den, pden);
+            return 0;
+        }
+    }
+
+    pnum = PyObject_GetAttrString(obj, "numerator");
+    pden = PyObject_GetAttrString(obj, "denominator");
+    if (!pnum || !PyLong_Check(pnum) || !pden || !PyLong_Check(pden)) {
+        SYSTEM_ERROR("Object does not appear to be Fraction");
+        Py_XDECREF(pnum);
+        Py_XDECREF(pden);
+        return -1;
+    }
+    mpz_set_PyLong(num, pnum);
+    mpz_set_PyLong(den, pden);
+    Py_DECREF(pnum);
+    Py_DECREF(pden);
+    return 0;
+}
+
 static MPQ_Object*
 GMPy_MPQ_From_Fraction(PyObject* obj, CTXT_Object *context)
 {
     MPQ_Object *result;
-    PyObject *num, *den;
 
     if (!(result = GMPy_MPQ_New(context))) {
         /* LCOV_EXCL_START */
         return NULL;
         /* LCOV_EXCL_STOP */
     }
-    mpq_set_si(result->q, 0, 1);
-
-    num = PyObject_GetAttrString(obj, "numerator");
-    den = PyObject_GetAttrString(obj, "denominator");
-    if (!num || !PyLong_Check(num) || !den || !PyLong_Check(den)) {
-        SYSTEM_ERROR("Object does not appear to be Fraction");
-        Py_XDECREF(num);
-        Py_XDECREF(den);
+    if (_GMPy_Fraction_Parts(obj, mpq_numref(result->q), mpq_denref(result->q)) < 0) {
         Py_DECREF((PyObject*)result);
         return NULL;
     }
-    mpz_set_PyLong(mpq_numref(result->q), num);
-    mpz_set_PyLong(mpq_denref(result->q), den);
-    Py_DECREF(num);
-    Py_DECREF(den);
     return result;
 }
 
+/* Set num and den to the ratio of a finite Decimal, read from
+ * as_integer_ratio(). Returns 1 if obj is NaN or an infinity, with *kind
+ * set to 0 for NaN or to the sign of the infinity, 0 on success, and -1
+ * with an exception set on error.
+ */
+
+static int
+_GMPy_Decimal_Parts(PyObject *obj, mpz_t num, mpz_t den, int *kind)
+{
+    PyObject *pair, *flag;
+    int is_nan, is_signed;
+
+    if ((pair = PyObject_CallMethod(obj, "as_integer_ratio", NULL))) {
+        if (!PyTuple_Check(pair) || PyTuple_GET_SIZE(pair) != 2 ||
+            !PyLong_Check(PyTuple_GET_ITEM(pair, 0)) ||
+            !PyLong_Check(PyTuple_GET_ITEM(pair, 1))) {
+            Py_DECREF(pair);
+            TYPE_ERROR("as_integer_ratio() must return a pair of integers");
+            return -1;
+        }
+        mpz_set_PyLong(num, PyTuple_GET_ITEM(pair, 0));
+        mpz_set_PyLong(den, PyTuple_GET_ITEM(pair, 1));
+        Py_DECREF(pair);
+        return 0;
+    }
+
+    /* as_integer_ratio() fails for NaN and infinities. */
+
+    if (!PyErr_ExceptionMatches(PyExc_ValueError) &&
+        !PyErr_ExceptionMatches(PyExc_OverflowError))
+        return -1;
+    PyErr_Clear();
+
+    if (!(flag = PyObject_CallMethod(obj, "is_nan", NULL)))
+        return -1;
+    is_nan = PyObject_IsTrue(flag);
+    Py_DECREF(flag);
+    if (!(flag = PyObject_CallMethod(obj, "is_signed", NULL)))
+        return -1;
+    is_signed = PyObject_IsTrue(flag);
+    Py_DECREF(flag);
+    if (is_nan < 0 || is_signed < 0)
+        return -1;
+    *kind = is_nan ? 0 : (is_signed ? -1 : 1);
+    return 1;
+}
+
+static MPQ_Object*
+GMPy_MPQ_From_Decimal(PyObject* obj, CTXT_Object *context)
+{
+    MPQ_Object *result;
+    int kind, res;
+
+    if (!(result = GMPy_MPQ_New(context))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    res = _GMPy_Decimal_Parts(obj, mpq_numref(result->q), mpq_denref(result->q), &kind);
+    if (res == 0)
+        return result;
+
+    Py_DECREF((PyObject*)result);
+    if (res > 0) {
+        if (kind)
+            OVERFLOW_ERROR("'mpq' does not support Infinity");
+        else
+            VALUE_ERROR("'mpq' does not support NaN");
+    }
+    return NULL;
+}
+
 static MPQ_Object*
 GMPy_MPQ_From_Number(PyObject *obj, CTXT_Object *context)
 {
@@ -901,12 +1267,15 @@ GMPy_MPQ_From_Number(PyObject *obj, CTXT_Object *context)
     if (PyLong_Check(obj))
         return GMPy_MPQ_From_PyLong(obj, context);
 
-    if (XMPZ_Check(obj))
+    if (XMPZ_Check(obj) || MPZ_View_Check(obj))
         return GMPy_MPQ_From_XMPZ((XMPZ_Object*)obj, context);
 
     if (IS_FRACTION(obj))
         return GMPy_MPQ_From_Fraction(obj, context);
 
+    if (IS_DECIMAL(obj))
+        return GMPy_MPQ_From_Decimal(obj, context);
+
     PyObject *pair = PyObject_CallMethod(obj, "as_integer_ratio", NULL);
     if (pair != NULL) {
          MPQ_Object *res = (MPQ_Object*)GMPy_MPQ_NewInit(&MPQ_Type, pair, NULL);
@@ -954,7 +1323,7 @@ GMPy_MPQ_From_NumberWithType(PyObject *obj, int xtype, CTXT_Object *context)
         return (MPQ_Object*)obj;
     }
 
-    if (IS_TYPE_MPZ(xtype))
+    if (IS_TYPE_MPZ(xtype) || IS_TYPE_MPZ_VIEW(xtype))
         return GMPy_MPQ_From_MPZ((MPZ_Object*)obj, context);
 
     if (IS_TYPE_MPFR(xtype))
@@ -1041,7 +1410,7 @@ GMPy_MPQ_From_Rational(PyObject *obj, CTXT_Object *context)
     if (PyLong_Check(obj))
         return GMPy_MPQ_From_PyLong(obj, context);
 
-    if (XMPZ_Check(obj))
+    if (XMPZ_Check(obj) || MPZ_View_Check(obj))
         return GMPy_MPQ_From_XMPZ((XMPZ_Object*)obj, context);
 
     if (IS_FRACTION(obj))
@@ -1111,7 +1480,7 @@ GMPy_MPQ_From_RationalWithType(PyObject *obj, int xtype, CTXT_Object *context)
         return (MPQ_Object*)obj;
     }
 
-    if (IS_TYPE_MPZ(xtype))
+    if (IS_TYPE_MPZ(xtype) || IS_TYPE_MPZ_VIEW(xtype))
         return GMPy_MPQ_From_MPZ((MPZ_Object*)obj, context);
 
     if (IS_TYPE_PyInteger(xtype))
@@ -35,11 +35,14 @@ extern "C" {
  * Conversion between native Python objects and MPZ.                        *
  * ======================================================================== */
 
+static void            mpz_set_PyLong(mpz_t z, PyObject *obj);
 static MPZ_Object *    GMPy_MPZ_From_PyLong(PyObject *obj, CTXT_Object *context);
+static MPZ_Object *    GMPy_MPZ_Result_From_PyLong(PyObject *obj, CTXT_Object *context);
 static MPZ_Object *    GMPy_MPZ_From_PyStr(PyObject *s, int base, CTXT_Object *context);
 static MPZ_Object *    GMPy_MPZ_From_PyFloat(PyObject *obj, CTXT_Object *context);
 
 static MPZ_Object *    GMPy_MPZ_From_Integer(PyObject *obj, CTXT_Object *context);
+static mpz_srcptr      GMPy_MPZ_Scratch_From_Integer(PyObject *obj);
 static MPZ_Object *    GMPy_MPZ_From_IntegerAndCopy(PyObject *obj, CTXT_Object *context);
 static MPZ_Object *    GMPy_MPZ_From_IntegerWithType(PyObject *obj, int xtype, CTXT_Object *context);
 static MPZ_Object *    GMPy_MPZ_From_IntegerWithTypeAndCopy(PyObject *obj, int xtype, CTXT_Object *context);
@@ -81,6 +84,7 @@ static MPQ_Object *    GMPy_MPQ_From_PyLong(PyObject *obj, CTXT_Object *context)
 static MPQ_Object *    GMPy_MPQ_From_PyStr(PyObject *s, int base, CTXT_Object *context);
 static MPQ_Object *    GMPy_MPQ_From_PyFloat(PyObject *obj, CTXT_Object *context);
 static MPQ_Object *    GMPy_MPQ_From_Fraction(PyObject *obj, CTXT_Object *context);
+static MPQ_Object *    GMPy_MPQ_From_Decimal(PyObject *obj, CTXT_Object *context);
 static MPQ_Object *    GMPy_MPQ_From_MPZ(MPZ_Object *obj, CTXT_Object *context);
 static MPQ_Object *    GMPy_MPQ_From_XMPZ(XMPZ_Object *obj, CTXT_Object *context);
 
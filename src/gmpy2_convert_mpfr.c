@@ -286,6 +286,56 @@ GMPy_MPFR_From_Fraction(PyObject *obj, mpfr_prec_t prec, CTXT_Object *context)
     return result;
 }
 
+/* A finite Decimal is converted exactly to an mpq and then rounded once,
+ * so the result is correctly rounded. NaN and infinities map to their
+ * mpfr counterparts.
+ */
+
+static MPFR_Object *
+GMPy_MPFR_From_Decimal(PyObject *obj, mpfr_prec_t prec, CTXT_Object *context)
+{
+    MPFR_Object *result = NULL;
+    MPQ_Object *tempq;
+    int kind, res;
+
+    CHECK_CONTEXT(context);
+
+    if (!(tempq = GMPy_MPQ_New(context))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    res = _GMPy_Decimal_Parts(obj, mpq_numref(tempq->q), mpq_denref(tempq->q), &kind);
+    if (res == 0) {
+        result = GMPy_MPFR_From_MPQ(tempq, prec, context);
+
+        /* as_integer_ratio() drops the sign of a zero. */
+
+        if (result && mpfr_zero_p(result->f)) {
+            PyObject *flag = PyObject_CallMethod(obj, "is_signed", NULL);
+            int is_signed = flag ? PyObject_IsTrue(flag) : -1;
+
+            Py_XDECREF(flag);
+            if (is_signed < 0)
+                Py_CLEAR(result);
+            else if (is_signed)
+                mpfr_neg(result->f, result->f, MPFR_RNDN);
+        }
+    }
+    else if (res > 0) {
+        if (prec < 2)
+            prec = GET_MPFR_PREC(context);
+        if ((result = GMPy_MPFR_New(prec, context))) {
+            if (kind)
+                mpfr_set_inf(result->f, kind);
+            else
+                mpfr_set_nan(result->f);
+        }
+    }
+    Py_DECREF((PyObject*)tempq);
+    return result;
+}
+
 static MPFR_Object *
 GMPy_MPFR_From_PyStr(PyObject *s, int base, mpfr_prec_t prec, CTXT_Object *context)
 {
@@ -452,6 +502,9 @@ GMPy_MPFR_From_RealWithType(PyObject *obj, int xtype, mp_prec_t prec, CTXT_Objec
         }
     }
 
+    if (IS_DECIMAL(obj))
+        return GMPy_MPFR_From_Decimal(obj, prec, context);
+
   error:
     TYPE_ERROR("object could not be converted to 'mpfr'");
     return NULL;
@@ -876,46 +929,254 @@ GMPy_MPFR_ConvertArg(PyObject *arg, PyObject **ptr)
 }
 #endif
 
+/* Return the shortest decimal digits that read back as x in the precision
+ * of x with round to nearest. The digits d1 d2 ... dn (without trailing
+ * zeros) represent 0.d1d2...dn * 10**(*decpt); the result must be freed
+ * with mpfr_free_str(). x must be a regular number.
+ *
+ * If subnormal is set, the digits are read back like mpfr() does in a
+ * context with subnormalize=True and the given emin, so a subnormal x
+ * needs only the digits of its reduced precision.
+ *
+ * The nearest n-digit decimal is also a candidate with n+1 digits, so if n
+ * digits round-trip then so do n+1 digits and the shortest length can be
+ * found with a binary search over mpfr_get_str().
+ */
+
+static char *
+_GMPy_MPFR_Shortest_Digits(mpfr_srcptr x, mpfr_exp_t *decpt, int subnormal,
+                           mpfr_exp_t emin)
+{
+    mpfr_prec_t prec = mpfr_get_prec(x);
+    size_t lo = 1, hi = mpfr_get_str_ndigits(10, prec), mid, len;
+    char *best = NULL, *digits, *text;
+    mpfr_exp_t exp, oldemin = 0;
+    mpfr_t temp;
+    int inex;
+
+    if (!(text = PyMem_Malloc(hi + 32))) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    mpfr_init2(temp, prec);
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        digits = mpfr_get_str(NULL, &exp, 10, mid, x, MPFR_RNDN);
+        sprintf(text, "%s@%ld", digits, (long)(exp - (mpfr_exp_t)mid));
+        inex = mpfr_strtofr(temp, text, NULL, 10, MPFR_RNDN);
+        if (subnormal) {
+            oldemin = mpfr_get_emin();
+            mpfr_set_emin(emin);
+            inex = mpfr_check_range(temp, inex, MPFR_RNDN);
+            mpfr_subnormalize(temp, inex, MPFR_RNDN);
+            mpfr_set_emin(oldemin);
+        }
+        if (mpfr_equal_p(temp, x)) {
+            if (best)
+                mpfr_free_str(best);
+            best = digits;
+            *decpt = exp;
+            hi = mid;
+        }
+        else {
+            mpfr_free_str(digits);
+            lo = mid + 1;
+        }
+    }
+    mpfr_clear(temp);
+    PyMem_Free(text);
+
+    if (!best)
+        best = mpfr_get_str(NULL, decpt, 10, hi, x, MPFR_RNDN);
+
+    len = strlen(best);
+    while (len > 1 && best[len - 1] == '0')
+        best[--len] = '\0';
+    return best;
+}
+
+/* Return the shortest string that reads back as self in the context,
+ * laid out like the repr() of a Python float: scientific notation is used
+ * if the decimal point is more than 16 digits to the right or more than 4
+ * to the left of the first digit. For 53 bits, the result is the repr() of
+ * the double; for a subnormal double that holds in ieee(64).
+ */
+
+static PyObject *
+GMPy_PyStr_Shortest_From_MPFR(MPFR_Object *self, CTXT_Object *context)
+{
+    PyObject *result;
+    Py_UCS1 *out;
+    char *digits, *d, expbuf[32];
+    mpfr_exp_t decpt, exp;
+    Py_ssize_t n, len, i;
+    int negative, use_exp, subnormal;
+
+    CHECK_CONTEXT(context);
+
+    if (!mpfr_regular_p(self->f)) {
+        if (mpfr_nan_p(self->f))
+            return PyUnicode_FromString("nan");
+        if (mpfr_inf_p(self->f))
+            return PyUnicode_FromString(mpfr_signbit(self->f) ? "-inf" : "inf");
+        return PyUnicode_FromString(mpfr_signbit(self->f) ? "-0.0" : "0.0");
+    }
+
+    if (mpfr_get_prec(self->f) == DBL_MANT_DIG &&
+        mpfr_get_exp(self->f) >= DBL_MIN_EXP &&
+        mpfr_get_exp(self->f) <= DBL_MAX_EXP) {
+        char *buffer;
+
+        buffer = PyOS_double_to_string(mpfr_get_d(self->f, MPFR_RNDN), 'r', 0,
+                                       Py_DTSF_ADD_DOT_0, NULL);
+        if (!buffer)
+            return NULL;
+        result = PyUnicode_FromString(buffer);
+        PyMem_Free(buffer);
+        return result;
+    }
+
+    /* Like GMPY_MPFR_SUBNORMALIZE(), and only if self is on the grid of
+     * the subnormal numbers, so that it can be read back.
+     */
+    exp = mpfr_get_exp(self->f);
+    subnormal = context->ctx.subnormalize &&
+                exp >= context->ctx.emin &&
+                exp <= context->ctx.emin + mpfr_get_prec(self->f) - 2 &&
+                mpfr_min_prec(self->f) <= exp - context->ctx.emin + 1;
+
+    if (!(digits = _GMPy_MPFR_Shortest_Digits(self->f, &decpt, subnormal,
+                                              context->ctx.emin)))
+        return NULL;
+
+    negative = (digits[0] == '-');
+    d = digits + negative;
+    n = (Py_ssize_t)strlen(d);
+    use_exp = (decpt <= -4 || decpt > 16);
+
+    if (use_exp) {
+        sprintf(expbuf, "e%c%02ld", decpt - 1 < 0 ? '-' : '+',
+                (long)(decpt - 1 < 0 ? 1 - decpt : decpt - 1));
+        len = n + (n > 1) + (Py_ssize_t)strlen(expbuf);
+    }
+    else if (decpt <= 0) {
+        len = 2 - decpt + n;
+    }
+    else if (decpt < n) {
+        len = n + 1;
+    }
+    else {
+        len = decpt + 2;
+    }
+    len += negative;
+
+    if (!(result = PyUnicode_New(len, 127))) {
+        mpfr_free_str(digits);
+        return NULL;
+    }
+    out = PyUnicode_1BYTE_DATA(result);
+
+    if (negative)
+        *(out++) = '-';
+    if (use_exp) {
+        *(out++) = d[0];
+        if (n > 1) {
+            *(out++) = '.';
+            memcpy(out, d + 1, n - 1);
+            out += n - 1;
+        }
+        memcpy(out, expbuf, strlen(expbuf));
+    }
+    else if (decpt <= 0) {
+        *(out++) = '0';
+        *(out++) = '.';
+        for (i = 0; i < -decpt; i++)
+            *(out++) = '0';
+        memcpy(out, d, n);
+    }
+    else if (decpt < n) {
+        memcpy(out, d, decpt);
+        out += decpt;
+        *(out++) = '.';
+        memcpy(out, d + decpt, n - decpt);
+    }
+    else {
+        memcpy(out, d, n);
+        out += n;
+        for (i = n; i < decpt; i++)
+            *(out++) = '0';
+        *(out++) = '.';
+        *(out++) = '0';
+    }
+
+    mpfr_free_str(digits);
+    return result;
+}
+
+/* Return x formatted like '{0:.{digits}g}'.format(x), as done by
+ * mpfr.__format__(), but without going through the format parser.
+ */
+
+static char *
+_GMPy_MPFR_Format_G(MPFR_Object *self, long digits)
+{
+    char *buffer, *result;
+    int buflen;
+
+    buflen = mpfr_asprintf(&buffer, "%.*Rg", (int)digits, self->f);
+    if (buflen < 0) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    if (!(result = PyMem_Malloc(buflen + 3))) {
+        mpfr_free_str(buffer);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    memcpy(result, buffer, buflen + 1);
+    mpfr_free_str(buffer);
+
+    /* If there isn't a decimal point in the output and the output
+     * only consists of digits, then append .0 */
+    if ((size_t)buflen == strspn(result, "+- 0123456789"))
+        strcat(result, ".0");
+    return result;
+}
+
 /* str and repr implementations for mpfr */
 static PyObject *
 GMPy_MPFR_Str_Slot(MPFR_Object *self)
 {
-    PyObject *result, *temp;
+    PyObject *result;
     long precision;
-    char fmtstr[60];
+    char *buffer;
 
     precision = (long)(log10(2) * (double)mpfr_get_prec(MPFR(self))) + 2;
 
-    sprintf(fmtstr, "{0:.%ldg}", precision);
-
-    temp = Py_BuildValue("s", fmtstr);
-    if (!temp)
+    if (!(buffer = _GMPy_MPFR_Format_G(self, precision)))
         return NULL;
-    result = PyObject_CallMethod(temp, "format", "O", self);
-    Py_DECREF(temp);
+    result = PyUnicode_FromString(buffer);
+    PyMem_Free(buffer);
     return result;
 }
 
 static PyObject *
 GMPy_MPFR_Repr_Slot(MPFR_Object *self)
 {
-    PyObject *result, *temp;
+    PyObject *result;
     long precision, bits;
-    char fmtstr[60];
+    char *buffer;
 
     bits = mpfr_get_prec(MPFR(self));
     precision = (long)(log10(2) * (double)bits) + 2;
 
+    if (!(buffer = _GMPy_MPFR_Format_G(self, precision)))
+        return NULL;
     if (mpfr_number_p(MPFR(self)) && bits != DBL_MANT_DIG)
-        sprintf(fmtstr, "mpfr('{0:.%ldg}',%ld)", precision, bits);
+        result = PyUnicode_FromFormat("mpfr('%s',%ld)", buffer, bits);
     else
-        sprintf(fmtstr, "mpfr('{0:.%ldg}')", precision);
-
-    temp = Py_BuildValue("s", fmtstr);
-    if (!temp)
-        return NULL;
-    result = PyObject_CallMethod(temp, "format", "O", self);
-    Py_DECREF(temp);
+        result = PyUnicode_FromFormat("mpfr('%s')", buffer);
+    PyMem_Free(buffer);
     return result;
 }
 
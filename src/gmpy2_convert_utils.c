@@ -32,6 +32,28 @@
  * type(s), mpz, plus types defining __mpz__) to various C types.
  */
 
+/* If the Python integer x fits in a C long, store it in *value and return 1.
+ * Otherwise return 0. An integer of at most one digit is read directly, so
+ * the common case does not call into the PyLong API. Exceptions are never
+ * raised.
+ */
+
+static inline int
+GMPy_PyLong_AsSmall(PyObject *x, long *value)
+{
+    PyLongObject *v = (PyLongObject*)x;
+    int error;
+
+    if (_PyLong_DigitCount(v) <= 1) {
+        long digit = _PyLong_DigitCount(v) ? (long)GET_OB_DIGIT(v)[0] : 0;
+
+        *value = _PyLong_IsNegative(v) ? -digit : digit;
+        return 1;
+    }
+
+    *value = PyLong_AsLongAndOverflow(x, &error);
+    return !error;
+}
 
 static long
 GMPy_Integer_AsLongWithType(PyObject *x, int xtype)
@@ -35,6 +35,7 @@ extern "C" {
  * Conversion between Integer objects and C types.                          *
  * ======================================================================== */
 
+static inline int      GMPy_PyLong_AsSmall(PyObject *x, long *value);
 static long            GMPy_Integer_AsLongWithType(PyObject *x, int xtype);
 static long            GMPy_Integer_AsLong(PyObject *x);
 static unsigned long   GMPy_Integer_AsUnsignedLongWithType(PyObject *x, int xtype);
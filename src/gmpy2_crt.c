@@ -0,0 +1,825 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_crt.c                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Chinese remaindering.
+ *
+ * For residues r[i] the solution is x = sum(s[i] * M / m[i]) mod M where
+ * s[i] = r[i] * inv[i] mod m[i]. The sum is formed up the product tree of
+ * the moduli: a node combines its children as s_left * M_right + s_right *
+ * M_left, so every level costs a few balanced multiplications. A CRTPlan
+ * builds the tree and the inverses once and reuses them for every vector
+ * of residues.
+ */
+
+PyDoc_STRVAR(GMPy_doc_crtplan,
+"CRTPlan(moduli, /) -> CRTPlan\n\n"
+"Return an object that solves x = r[i] mod moduli[i] for many vectors of\n"
+"residues r. The moduli must be > 0 and pairwise coprime; ValueError is\n"
+"raised otherwise. Their product tree and the inverses needed by the\n"
+"Chinese remainder theorem are computed once. crt() solves for one\n"
+"vector of residues and vcrt() for a sequence of vectors. The GIL is\n"
+"released and the work is split over the context's threads.");
+
+typedef struct {
+    CRTPlan_Object *plan;
+    mpz_srcptr *r;
+    mpz_t *src;
+    mpz_t *dst;
+    int level;
+} gmpy_crt_level;
+
+/* Set src[i] to r[i] * inv[i] mod m[i]. */
+
+static void
+_GMPy_CRT_Leaf_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_crt_level *work = (gmpy_crt_level*)arg;
+    gmpy_product_tree *tree = &work->plan->tree;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        mpz_mod(work->src[i], work->r[i], TREE_NODE(tree, 0, i));
+        mpz_mul(work->src[i], work->src[i], work->plan->inv[i]);
+        mpz_tdiv_r(work->src[i], work->src[i], TREE_NODE(tree, 0, i));
+    }
+}
+
+/* Combine the pairs of level - 1 in src into level in dst. */
+
+static void
+_GMPy_CRT_Level_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_crt_level *work = (gmpy_crt_level*)arg;
+    gmpy_product_tree *tree = &work->plan->tree;
+    int k = work->level;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        if (2 * i + 1 < tree->size[k - 1]) {
+            mpz_mul(work->dst[i], work->src[2 * i], TREE_NODE(tree, k - 1, 2 * i + 1));
+            mpz_addmul(work->dst[i], work->src[2 * i + 1], TREE_NODE(tree, k - 1, 2 * i));
+        }
+        else {
+            mpz_swap(work->dst[i], work->src[2 * i]);
+        }
+    }
+}
+
+/* Set x to the solution for the residues r. a and b are scratch arrays of
+ * plan->n initialized values. Does not use the Python API.
+ */
+
+static void
+_GMPy_CRT_Solve(CRTPlan_Object *plan, mpz_ptr x, mpz_srcptr *r,
+                mpz_t *a, mpz_t *b, int threads)
+{
+    gmpy_product_tree *tree = &plan->tree;
+    gmpy_crt_level work;
+    mpz_t *temp;
+
+    work.plan = plan;
+    work.r = r;
+    work.src = a;
+    work.dst = b;
+    GMPy_Parallel_Run(_GMPy_CRT_Leaf_Range, &work, plan->n, threads);
+
+    /* Levels alternate between a and b since the threads of one level
+     * must not overwrite nodes that another thread still reads.
+     */
+
+    for (work.level = 1; work.level < tree->depth; work.level++) {
+        GMPy_Parallel_Run(_GMPy_CRT_Level_Range, &work,
+                          tree->size[work.level], threads);
+        temp = work.src;
+        work.src = work.dst;
+        work.dst = temp;
+    }
+    mpz_mod(x, work.src[0], TREE_NODE(tree, tree->depth - 1, 0));
+}
+
+typedef struct {
+    CRTPlan_Object *plan;
+    mpz_srcptr **rows;
+    mpz_ptr *out;
+    int nomem;
+} gmpy_crt_batch;
+
+static void
+_GMPy_CRT_Batch_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_crt_batch *work = (gmpy_crt_batch*)arg;
+    Py_ssize_t i, n = work->plan->n;
+    mpz_t *scratch;
+
+    if (!(scratch = PyMem_RawMalloc(2 * n * sizeof(mpz_t)))) {
+        work->nomem = 1;
+        return;
+    }
+    for (i = 0; i < 2 * n; i++)
+        mpz_init(scratch[i]);
+    for (i = start; i < stop; i++)
+        _GMPy_CRT_Solve(work->plan, work->out[i], work->rows[i],
+                        scratch, scratch + n, 1);
+    for (i = 0; i < 2 * n; i++)
+        mpz_clear(scratch[i]);
+    PyMem_RawFree(scratch);
+}
+
+/* Set inv[i] to (M / m[i])**-1 mod m[i], or to -1 if it does not exist.
+ * The leaves of the remainder tree hold M mod m[i]**2.
+ */
+
+typedef struct {
+    CRTPlan_Object *plan;
+    gmpy_product_tree *rem;
+} gmpy_crt_inverse;
+
+static void
+_GMPy_CRT_Inverse_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_crt_inverse *work = (gmpy_crt_inverse*)arg;
+    mpz_ptr m;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        m = TREE_NODE(&work->plan->tree, 0, i);
+        mpz_divexact(work->plan->inv[i], TREE_NODE(work->rem, 0, i), m);
+        if (mpz_cmp_ui(m, 1) == 0)
+            mpz_set_ui(work->plan->inv[i], 0);
+        else if (!mpz_invert(work->plan->inv[i], work->plan->inv[i], m))
+            mpz_set_si(work->plan->inv[i], -1);
+    }
+}
+
+static void
+GMPy_CRTPlan_Dealloc(CRTPlan_Object *self)
+{
+    Py_ssize_t i;
+
+    if (self->inv) {
+        for (i = 0; i < self->n; i++)
+            mpz_clear(self->inv[i]);
+        PyMem_Free(self->inv);
+    }
+    if (self->tree.node)
+        _GMPy_Tree_Free(&self->tree);
+    PyObject_Free(self);
+}
+
+static CRTPlan_Object *
+_GMPy_CRTPlan_New(PyObject *moduli, const char *name, CTXT_Object *context)
+{
+    gmpy_rational_view view;
+    gmpy_product_tree rem;
+    gmpy_crt_inverse work;
+    CRTPlan_Object *result = NULL;
+    Py_ssize_t i, n, total;
+    size_t bits;
+    int threads;
+
+    if (_GMPy_View_Init(&view, moduli, name, context) < 0)
+        return NULL;
+
+    if (view.rational) {
+        PyErr_Format(PyExc_TypeError, "%s() requires integer moduli", name);
+        goto done;
+    }
+
+    if ((n = view.n) == 0) {
+        PyErr_Format(PyExc_ValueError, "%s() requires at least one modulus", name);
+        goto done;
+    }
+    for (i = 0; i < n; i++) {
+        if (mpz_sgn(view.num[i]) <= 0) {
+            PyErr_Format(PyExc_ValueError, "%s() moduli must be > 0", name);
+            goto done;
+        }
+    }
+
+    if (!(result = PyObject_New(CRTPlan_Object, &CRTPlan_Type)))
+        goto done;
+    result->tree.node = NULL;
+    result->n = n;
+    if (!(result->inv = PyMem_New(mpz_t, n))) {
+        PyErr_NoMemory();
+        result->n = 0;
+        Py_CLEAR(result);
+        goto done;
+    }
+    for (i = 0; i < n; i++)
+        mpz_init(result->inv[i]);
+
+    if (_GMPy_Tree_Alloc(&result->tree, n) < 0) {
+        result->tree.node = NULL;
+        Py_CLEAR(result);
+        goto done;
+    }
+    if (_GMPy_Tree_Alloc(&rem, n) < 0) {
+        Py_CLEAR(result);
+        goto done;
+    }
+
+    bits = _GMPy_View_Bits(&view);
+    total = rem.offset[rem.depth - 1] + 1;
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+    for (i = 0; i < n; i++)
+        mpz_set(TREE_NODE(&result->tree, 0, i), view.num[i]);
+    _GMPy_Tree_Build(&result->tree, threads);
+
+    /* As in batch_gcd(), reduce M down a copy of the tree modulo the
+     * squares of the nodes; then (M mod m**2) / m == (M / m) mod m.
+     */
+
+    for (i = 0; i < total; i++)
+        mpz_set(rem.node[i], result->tree.node[i]);
+    _GMPy_Tree_Reduce(&rem, _GMPy_Tree_Mod_Square_Range, threads);
+
+    work.plan = result;
+    work.rem = &rem;
+    GMPy_Parallel_Run(_GMPy_CRT_Inverse_Range, &work, n, threads);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    _GMPy_Tree_Free(&rem);
+
+    for (i = 0; i < n; i++) {
+        if (mpz_sgn(result->inv[i]) < 0) {
+            PyErr_Format(PyExc_ValueError, "%s() moduli must be pairwise coprime", name);
+            Py_CLEAR(result);
+            break;
+        }
+    }
+
+  done:
+    _GMPy_View_Clear(&view);
+    return result;
+}
+
+static PyObject *
+GMPy_CRTPlan_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    CTXT_Object *context = NULL;
+
+    if (keywds && PyDict_Size(keywds)) {
+        TYPE_ERROR("CRTPlan() takes no keyword arguments");
+        return NULL;
+    }
+
+    if (PyTuple_GET_SIZE(args) != 1) {
+        TYPE_ERROR("CRTPlan() requires 1 argument");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    return (PyObject*)_GMPy_CRTPlan_New(PyTuple_GET_ITEM(args, 0), "CRTPlan", context);
+}
+
+/* Convert residues to a view of plan->n integers. */
+
+static int
+_GMPy_CRT_Residues(CRTPlan_Object *self, gmpy_rational_view *view,
+                   PyObject *residues, const char *name, CTXT_Object *context)
+{
+    if (_GMPy_View_Init(view, residues, name, context) < 0)
+        return -1;
+
+    if (view->rational) {
+        PyErr_Format(PyExc_TypeError, "%s() requires integer residues", name);
+        _GMPy_View_Clear(view);
+        return -1;
+    }
+
+    if (view->n != self->n) {
+        PyErr_Format(PyExc_ValueError, "%s() requires %zd residues", name, self->n);
+        _GMPy_View_Clear(view);
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject *
+_GMPy_CRTPlan_Solve(CRTPlan_Object *self, PyObject *residues, const char *name,
+                    CTXT_Object *context)
+{
+    gmpy_rational_view view;
+    MPZ_Object *result = NULL;
+    gmpy_product_tree *tree = &self->tree;
+    mpz_t *scratch;
+    Py_ssize_t i, n = self->n;
+    size_t bits;
+
+    if (_GMPy_CRT_Residues(self, &view, residues, name, context) < 0)
+        return NULL;
+
+    if (!(scratch = PyMem_New(mpz_t, 2 * n))) {
+        PyErr_NoMemory();
+        _GMPy_View_Clear(&view);
+        return NULL;
+    }
+
+    if ((result = GMPy_MPZ_New(context))) {
+        for (i = 0; i < 2 * n; i++)
+            mpz_init(scratch[i]);
+
+        bits = GMPY_MPZ_BITS(TREE_NODE(tree, tree->depth - 1, 0));
+        GMPY_PROFILE_OPN(context, GMPY_OP_MUL, bits / n, n);
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+        _GMPy_CRT_Solve(self, result->z, view.num, scratch, scratch + n,
+                        GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+
+        for (i = 0; i < 2 * n; i++)
+            mpz_clear(scratch[i]);
+    }
+
+    PyMem_Free(scratch);
+    _GMPy_View_Clear(&view);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_crtplan_crt,
+"x.crt(residues, /) -> mpz\n\n"
+"Return the integer 0 <= x < M, M the product of the moduli, with\n"
+"x = residues[i] mod moduli[i] for every i.");
+
+static PyObject *
+GMPy_CRTPlan_CRT(CRTPlan_Object *self, PyObject *other)
+{
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    return _GMPy_CRTPlan_Solve(self, other, "crt", context);
+}
+
+PyDoc_STRVAR(GMPy_doc_crtplan_vcrt,
+"x.vcrt(rows, /) -> list[mpz, ...]\n\n"
+"Return [x.crt(r) for r in rows]. The rows are split over the context's\n"
+"threads.");
+
+static PyObject *
+GMPy_CRTPlan_VCRT(CRTPlan_Object *self, PyObject *other)
+{
+    gmpy_rational_view *views = NULL;
+    gmpy_product_tree *tree = &self->tree;
+    gmpy_crt_batch work;
+    PyObject *seq, *result = NULL, *temp;
+    CTXT_Object *context = NULL;
+    Py_ssize_t i, k, nviews = 0;
+    size_t bits;
+
+    CHECK_CONTEXT(context);
+
+    memset(&work, 0, sizeof(gmpy_crt_batch));
+
+    if (!(seq = PySequence_Tuple(other)))
+        return NULL;
+    k = PyTuple_GET_SIZE(seq);
+
+    if (!(views = PyMem_New(gmpy_rational_view, k ? k : 1)) ||
+        !(work.rows = PyMem_New(mpz_srcptr*, k ? k : 1)) ||
+        !(work.out = PyMem_New(mpz_ptr, k ? k : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    for (nviews = 0; nviews < k; nviews++) {
+        if (_GMPy_CRT_Residues(self, &views[nviews], PyTuple_GET_ITEM(seq, nviews),
+                               "vcrt", context) < 0)
+            goto done;
+        work.rows[nviews] = views[nviews].num;
+    }
+
+    if (!(result = PyList_New(k)))
+        goto done;
+    for (i = 0; i < k; i++) {
+        if (!(temp = (PyObject*)GMPy_MPZ_New(context))) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, temp);
+        work.out[i] = MPZ(temp);
+    }
+
+    work.plan = self;
+    bits = GMPY_MPZ_BITS(TREE_NODE(tree, tree->depth - 1, 0));
+    GMPY_PROFILE_OPN(context, GMPY_OP_MUL, bits / self->n, self->n * k);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits * k);
+    GMPy_Parallel_Run(_GMPy_CRT_Batch_Range, &work, k,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (work.nomem) {
+        PyErr_NoMemory();
+        Py_CLEAR(result);
+    }
+
+  done:
+    for (i = 0; i < nviews; i++)
+        _GMPy_View_Clear(&views[i]);
+    PyMem_Free(views);
+    PyMem_Free(work.rows);
+    PyMem_Free(work.out);
+    Py_DECREF(seq);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_crt,
+"crt(residues, moduli, /) -> mpz\n\n"
+"Return the integer 0 <= x < M, M the product of the moduli, with\n"
+"x = residues[i] mod moduli[i] for every i. The moduli must be > 0 and\n"
+"pairwise coprime. Use CRTPlan to solve for many vectors of residues\n"
+"with the same moduli.");
+
+static PyObject *
+GMPy_MPZ_Function_CRT(PyObject *self, PyObject *args)
+{
+    CRTPlan_Object *plan;
+    PyObject *result;
+    CTXT_Object *context = NULL;
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("crt() requires 2 arguments");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!(plan = _GMPy_CRTPlan_New(PyTuple_GET_ITEM(args, 1), "crt", context)))
+        return NULL;
+    result = _GMPy_CRTPlan_Solve(plan, PyTuple_GET_ITEM(args, 0), "crt", context);
+    Py_DECREF((PyObject*)plan);
+    return result;
+}
+
+/* Rational reconstruction.
+ *
+ * For a residue a mod M, find r/t with r = a*t mod M, |r| <= N and
+ * 0 < t <= D. The extended Euclidean algorithm on (M, a) is stopped at
+ * the first remainder r <= N; r/t is then the only candidate with t <= D
+ * when 2*N*D < M. While the remainders are more than a word longer than
+ * N, Lehmer's algorithm replaces a run of multiprecision divisions by a
+ * few multiplications by a word.
+ */
+
+/* Return 1 and set result to the reconstruction of a mod m with numerator
+ * bound nb and denominator bound db, or return 0 if there is none. a is
+ * reduced mod m > 0. Does not use the Python API.
+ */
+
+static int
+_GMPy_Rational_Reconstruct(mpq_ptr result, mpz_srcptr a, mpz_srcptr m,
+                           mpz_srcptr nb, mpz_srcptr db)
+{
+    mpz_t r0, r1, t0, t1, u, v;
+    size_t nbits;
+    long mat[4];
+    int found = 0;
+
+    mpz_init_set(r0, m);
+    mpz_init(r1);
+    mpz_mod(r1, a, m);
+    mpz_init_set_ui(t0, 0);
+    mpz_init_set_ui(t1, 1);
+    mpz_init(u);
+    mpz_init(v);
+
+    nbits = mpz_sgn(nb) ? mpz_sizeinbase(nb, 2) : 0;
+    while (mpz_cmp(r1, nb) > 0) {
+
+        /* The remainder r0 after the Lehmer steps is more than N, so no
+         * remainder <= N is passed over.
+         */
+
+        if (mpz_sizeinbase(r0, 2) > nbits + GMPY_LEHMER_BITS + 2 &&
+            _GMPy_Lehmer_Matrix(r0, r1, mat, NULL, u) > 0) {
+            _GMPy_Lehmer_Apply(r0, r1, mat, u, v);
+            _GMPy_Lehmer_Apply(t0, t1, mat, u, v);
+            continue;
+        }
+        mpz_fdiv_qr(u, r0, r0, r1);
+        mpz_swap(r0, r1);
+        mpz_submul(t0, u, t1);
+        mpz_swap(t0, t1);
+    }
+
+    if (mpz_sgn(t1) && mpz_cmpabs(t1, db) <= 0) {
+        mpz_gcd(u, r1, t1);
+        if (mpz_cmp_ui(u, 1) == 0) {
+            if (mpz_sgn(t1) < 0) {
+                mpz_neg(r1, r1);
+                mpz_neg(t1, t1);
+            }
+            mpz_swap(mpq_numref(result), r1);
+            mpz_swap(mpq_denref(result), t1);
+            found = 1;
+        }
+    }
+
+    mpz_clear(r0);
+    mpz_clear(r1);
+    mpz_clear(t0);
+    mpz_clear(t1);
+    mpz_clear(u);
+    mpz_clear(v);
+    return found;
+}
+
+/* Parse the modulus and the optional bounds. The default bounds are
+ * N = D = isqrt((M - 1) // 2), the largest with 2*N*D < M.
+ */
+
+static int
+_GMPy_Rational_Bounds(PyObject *mobj, PyObject *nobj, PyObject *dobj,
+                      MPZ_Object **m, MPZ_Object **nb, MPZ_Object **db,
+                      const char *name, CTXT_Object *context)
+{
+    *m = *nb = *db = NULL;
+
+    if (!(*m = GMPy_MPZ_From_Integer(mobj, context)))
+        goto error;
+    if (mpz_sgn((*m)->z) <= 0) {
+        PyErr_Format(PyExc_ValueError, "%s() requires a modulus > 0", name);
+        goto error;
+    }
+    if (nobj == Py_None || dobj == Py_None) {
+        if (!(*nb = GMPy_MPZ_New(context)))
+            goto error;
+        mpz_sub_ui((*nb)->z, (*m)->z, 1);
+        mpz_fdiv_q_2exp((*nb)->z, (*nb)->z, 1);
+        mpz_sqrt((*nb)->z, (*nb)->z);
+        if (nobj == Py_None && dobj == Py_None) {
+            Py_INCREF((PyObject*)*nb);
+            *db = *nb;
+            return 0;
+        }
+        if (nobj == Py_None) {
+            if (!(*db = GMPy_MPZ_From_Integer(dobj, context)))
+                goto error;
+        }
+        else {
+            *db = *nb;
+            if (!(*nb = GMPy_MPZ_From_Integer(nobj, context)))
+                goto error;
+        }
+    }
+    else if (!(*nb = GMPy_MPZ_From_Integer(nobj, context)) ||
+             !(*db = GMPy_MPZ_From_Integer(dobj, context))) {
+        goto error;
+    }
+    if (mpz_sgn((*nb)->z) < 0 || mpz_sgn((*db)->z) < 0) {
+        PyErr_Format(PyExc_ValueError, "%s() requires bounds >= 0", name);
+        goto error;
+    }
+    return 0;
+
+  error:
+    Py_XDECREF((PyObject*)*m);
+    Py_XDECREF((PyObject*)*nb);
+    Py_XDECREF((PyObject*)*db);
+    return -1;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_rational_reconstruct,
+"rational_reconstruct(a, m, /, num_bound=None, den_bound=None) -> mpq | None\n\n"
+"Return the fraction n/d with n = a*d mod m, abs(n) <= num_bound and\n"
+"0 < d <= den_bound, or None if there is none. Both bounds default to\n"
+"isqrt((m-1)//2), so the result is unique whenever it exists. This\n"
+"recovers a rational result from its residue mod the product of the\n"
+"moduli of a multi-modular computation, see `crt()`.");
+
+static PyObject *
+GMPy_MPZ_Function_Rational_Reconstruct(PyObject *self, PyObject *args,
+                                       PyObject *keywds)
+{
+    static char *kwlist[] = {"", "", "num_bound", "den_bound", NULL};
+    PyObject *aobj, *mobj, *nobj = Py_None, *dobj = Py_None;
+    MPZ_Object *a = NULL, *m, *nb, *db;
+    MPQ_Object *result = NULL;
+    int found = 0;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO|OO", kwlist, &aobj,
+                                     &mobj, &nobj, &dobj))
+        return NULL;
+
+    if (_GMPy_Rational_Bounds(mobj, nobj, dobj, &m, &nb, &db,
+                              "rational_reconstruct", context) < 0)
+        return NULL;
+
+    if ((a = GMPy_MPZ_From_Integer(aobj, context)) &&
+        (result = GMPy_MPQ_New(context))) {
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(m->z));
+        found = _GMPy_Rational_Reconstruct(result->q, a->z, m->z, nb->z, db->z);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+    }
+
+    Py_XDECREF((PyObject*)a);
+    Py_DECREF((PyObject*)m);
+    Py_DECREF((PyObject*)nb);
+    Py_DECREF((PyObject*)db);
+    if (result && !found) {
+        Py_DECREF((PyObject*)result);
+        Py_RETURN_NONE;
+    }
+    return (PyObject*)result;
+}
+
+typedef struct {
+    mpz_srcptr *a;
+    mpz_srcptr m, nb, db;
+    mpq_ptr *out;
+    char *found;
+} gmpy_rational_batch;
+
+static void
+_GMPy_Rational_Reconstruct_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_rational_batch *work = (gmpy_rational_batch*)arg;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++)
+        work->found[i] = (char)_GMPy_Rational_Reconstruct(work->out[i], work->a[i],
+                                                          work->m, work->nb, work->db);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_rational_reconstruct_list,
+"rational_reconstruct_list(values, m, /, num_bound=None,\n"
+"                          den_bound=None) -> list[mpq | None]\n\n"
+"Return [rational_reconstruct(a, m, num_bound, den_bound) for a in\n"
+"values] for a sequence of integers or an `mpz_array`. The values are\n"
+"split over the context's threads.");
+
+static PyObject *
+GMPy_MPZ_Function_Rational_Reconstruct_List(PyObject *self, PyObject *args,
+                                            PyObject *keywds)
+{
+    static char *kwlist[] = {"", "", "num_bound", "den_bound", NULL};
+    PyObject *values, *mobj, *nobj = Py_None, *dobj = Py_None;
+    PyObject *result = NULL, *temp;
+    MPZ_Object *m, *nb, *db;
+    gmpy_rational_view view;
+    gmpy_rational_batch work;
+    Py_ssize_t i;
+    size_t bits;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO|OO", kwlist, &values,
+                                     &mobj, &nobj, &dobj))
+        return NULL;
+
+    if (_GMPy_Rational_Bounds(mobj, nobj, dobj, &m, &nb, &db,
+                              "rational_reconstruct_list", context) < 0)
+        return NULL;
+
+    memset(&work, 0, sizeof(gmpy_rational_batch));
+    if (_GMPy_View_Init(&view, values, "rational_reconstruct_list", context) < 0)
+        goto done;
+
+    if (view.rational) {
+        TYPE_ERROR("rational_reconstruct_list() requires integer values");
+        goto done_view;
+    }
+
+    if (!(work.out = PyMem_New(mpq_ptr, view.n ? view.n : 1)) ||
+        !(work.found = PyMem_New(char, view.n ? view.n : 1))) {
+        PyErr_NoMemory();
+        goto done_view;
+    }
+
+    if (!(result = PyList_New(view.n)))
+        goto done_view;
+    for (i = 0; i < view.n; i++) {
+        if (!(temp = (PyObject*)GMPy_MPQ_New(context))) {
+            Py_CLEAR(result);
+            goto done_view;
+        }
+        PyList_SET_ITEM(result, i, temp);
+        work.out[i] = MPQ(temp);
+    }
+
+    work.a = view.num;
+    work.m = m->z;
+    work.nb = nb->z;
+    work.db = db->z;
+    bits = GMPY_MPZ_BITS(m->z);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits * view.n);
+    GMPy_Parallel_Run(_GMPy_Rational_Reconstruct_Range, &work, view.n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    for (i = 0; i < view.n; i++) {
+        if (!work.found[i]) {
+            Py_INCREF(Py_None);
+            PyList_SetItem(result, i, Py_None);
+        }
+    }
+
+  done_view:
+    _GMPy_View_Clear(&view);
+  done:
+    PyMem_Free(work.out);
+    PyMem_Free(work.found);
+    Py_DECREF((PyObject*)m);
+    Py_DECREF((PyObject*)nb);
+    Py_DECREF((PyObject*)db);
+    return result;
+}
+
+static PyObject *
+GMPy_CRTPlan_GetModulus(CRTPlan_Object *self, void *closure)
+{
+    MPZ_Object *result;
+
+    if ((result = GMPy_MPZ_New(NULL)))
+        mpz_set(result->z, TREE_NODE(&self->tree, self->tree.depth - 1, 0));
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_CRTPlan_GetModuli(CRTPlan_Object *self, void *closure)
+{
+    PyObject *result, *temp;
+    Py_ssize_t i;
+
+    if (!(result = PyList_New(self->n)))
+        return NULL;
+    for (i = 0; i < self->n; i++) {
+        if (!(temp = (PyObject*)GMPy_MPZ_New(NULL))) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        mpz_set(MPZ(temp), TREE_NODE(&self->tree, 0, i));
+        PyList_SET_ITEM(result, i, temp);
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_CRTPlan_Repr_Slot(CRTPlan_Object *self)
+{
+    PyObject *moduli, *result;
+
+    if (!(moduli = GMPy_CRTPlan_GetModuli(self, NULL)))
+        return NULL;
+    result = PyUnicode_FromFormat("CRTPlan(%R)", moduli);
+    Py_DECREF(moduli);
+    return result;
+}
+
+static PyMethodDef GMPy_CRTPlan_methods[] =
+{
+    { "crt", (PyCFunction)GMPy_CRTPlan_CRT, METH_O, GMPy_doc_crtplan_crt },
+    { "vcrt", (PyCFunction)GMPy_CRTPlan_VCRT, METH_O, GMPy_doc_crtplan_vcrt },
+    { NULL }
+};
+
+static PyGetSetDef GMPy_CRTPlan_getseters[] =
+{
+    { "moduli", (getter)GMPy_CRTPlan_GetModuli, NULL, "moduli", NULL },
+    { "modulus", (getter)GMPy_CRTPlan_GetModulus, NULL, "product of the moduli", NULL },
+    { NULL }
+};
+
+static PyTypeObject CRTPlan_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.CRTPlan",
+    .tp_basicsize = sizeof(CRTPlan_Object),
+    .tp_dealloc = (destructor) GMPy_CRTPlan_Dealloc,
+    .tp_repr = (reprfunc) GMPy_CRTPlan_Repr_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_crtplan,
+    .tp_methods = GMPy_CRTPlan_methods,
+    .tp_getset = GMPy_CRTPlan_getseters,
+    .tp_new = GMPy_CRTPlan_NewInit,
+};
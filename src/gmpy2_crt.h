@@ -0,0 +1,55 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_crt.h                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_CRT_H
+#define GMPY_CRT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A CRTPlan keeps the product tree of n pairwise coprime moduli m[i] and
+ * inv[i] = (M / m[i])**-1 mod m[i], where M is the product of the moduli.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    gmpy_product_tree tree;
+    mpz_t *inv;
+    Py_ssize_t n;
+} CRTPlan_Object;
+
+static PyTypeObject CRTPlan_Type;
+#define CRTPlan_Check(v) (((PyObject*)v)->ob_type == &CRTPlan_Type)
+
+static PyObject * GMPy_MPZ_Function_CRT(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_Rational_Reconstruct(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_Function_Rational_Reconstruct_List(PyObject *self, PyObject *args, PyObject *keywds);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
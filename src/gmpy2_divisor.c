@@ -0,0 +1,521 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_divisor.c                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Division by a fixed d.
+ *
+ * GMP does not export its precomputed inverses, so a Divisor keeps its own
+ * Barrett reciprocal inv = floor(B**(2*n) / |d|) when |d| is large enough
+ * for that to pay off. A dividend of at most 2*n limbs is then reduced
+ * with two multiplications and no division. Smaller divisors and longer
+ * dividends use the GMP functions directly.
+ */
+
+enum {
+    DIVISOR_DIVMOD,
+    DIVISOR_FLOORDIV,
+    DIVISOR_MOD,
+    DIVISOR_DIVEXACT
+};
+
+PyDoc_STRVAR(GMPy_doc_divisor,
+"Divisor(d, /) -> Divisor\n\n"
+"Return an object that divides integers by a fixed d != 0. The methods\n"
+"divmod(), floordiv(), and mod() round like the // and % operators;\n"
+"divexact() requires the division to be exact. For a large d the\n"
+"reciprocal is computed once and reused by every call. The methods\n"
+"vdivmod(), vfloordiv(), vmod(), and vdivexact() work on sequences and\n"
+"return an mpz_array if the argument is an mpz_array and a list\n"
+"otherwise.");
+
+/* Set q and r to the truncated quotient and remainder of |a| / |d| using
+ * the Barrett reciprocal. q may be NULL; q and r must not be a. Does not
+ * use the Python API.
+ */
+
+static void
+_GMPy_Divisor_QR_Abs(Divisor_Object *self, mpz_ptr q, mpz_ptr r,
+                     mpz_srcptr a, mpz_ptr t, mpz_ptr u)
+{
+    mp_size_t n = mpz_size(self->d), len = mpz_size(a), chunks, i, qn;
+    const mp_limb_t *ap = mpz_limbs_read(a);
+    mp_limb_t *qp = NULL;
+    mpz_t chunk, dabs;
+
+    mpz_roinit_n(dabs, mpz_limbs_read(self->d), n);
+
+    if (mpz_cmpabs(a, dabs) < 0) {
+        mpz_roinit_n(chunk, ap, len);
+        mpz_set(r, chunk);
+        if (q)
+            mpz_set_ui(q, 0);
+        return;
+    }
+
+    chunks = (len + n - 1) / n;
+    if (q) {
+        qp = mpz_limbs_write(q, chunks * n);
+        memset(qp, 0, chunks * n * sizeof(mp_limb_t));
+    }
+
+    mpz_set_ui(r, 0);
+    for (i = chunks - 1; i >= 0; i--) {
+        /* t = r * B**n + chunk < |d| * B**n */
+        mpz_roinit_n(chunk, ap + i * n, (i + 1) * n > len ? len - i * n : n);
+        mpz_mul_2exp(t, r, n * GMP_NUMB_BITS);
+        mpz_add(t, t, chunk);
+
+        /* The estimate is at most 2 below the true quotient. */
+        mpz_tdiv_q_2exp(u, t, (n - 1) * GMP_NUMB_BITS);
+        mpz_mul(u, u, self->inv);
+        mpz_tdiv_q_2exp(u, u, (n + 1) * GMP_NUMB_BITS);
+        mpz_submul(t, u, dabs);
+        while (mpz_cmp(t, dabs) >= 0) {
+            mpz_sub(t, t, dabs);
+            mpz_add_ui(u, u, 1);
+        }
+        mpz_swap(r, t);
+
+        if (qp && (qn = mpz_size(u)))
+            memcpy(qp + i * n, mpz_limbs_read(u), qn * sizeof(mp_limb_t));
+    }
+    if (q)
+        mpz_limbs_finish(q, chunks * n);
+}
+
+/* Set q and r to the floored quotient and remainder of a / d. Either q or
+ * r may be NULL but not both; q and r must not be a. t and u are scratch
+ * space.
+ */
+
+static void
+_GMPy_Divisor_Op(Divisor_Object *self, int op, mpz_ptr q, mpz_ptr r,
+                 mpz_srcptr a, mpz_ptr t, mpz_ptr u)
+{
+    mpz_t v;
+
+    if (op == DIVISOR_DIVEXACT) {
+        mpz_divexact(q, a, self->d);
+        return;
+    }
+
+    /* GMP amortizes its own inverse over long dividends. */
+    if (!self->barrett || mpz_size(a) > 2 * mpz_size(self->d)) {
+        if (q && r)
+            mpz_fdiv_qr(q, r, a, self->d);
+        else if (q)
+            mpz_fdiv_q(q, a, self->d);
+        else
+            mpz_fdiv_r(r, a, self->d);
+        return;
+    }
+
+    if (!r) {
+        mpz_init(v);
+        r = v;
+    }
+
+    _GMPy_Divisor_QR_Abs(self, q, r, a, t, u);
+
+    /* Truncated division of a by d, then round toward -Inf. */
+    if (q && mpz_sgn(a) * mpz_sgn(self->d) < 0)
+        mpz_neg(q, q);
+    if (mpz_sgn(a) < 0)
+        mpz_neg(r, r);
+    if (mpz_sgn(r) && mpz_sgn(r) != mpz_sgn(self->d)) {
+        if (q)
+            mpz_sub_ui(q, q, 1);
+        mpz_add(r, r, self->d);
+    }
+
+    if (r == v)
+        mpz_clear(v);
+}
+
+typedef struct {
+    Divisor_Object *self;
+    int op;
+    mpz_srcptr *x;
+    mpz_ptr *q;           /* NULL for DIVISOR_MOD */
+    mpz_ptr *r;           /* NULL unless DIVISOR_DIVMOD or DIVISOR_MOD */
+} gmpy_divisor_batch;
+
+static void
+_GMPy_Divisor_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_divisor_batch *work = (gmpy_divisor_batch*)arg;
+    Py_ssize_t i;
+    mpz_t t, u;
+
+    mpz_init(t);
+    mpz_init(u);
+    for (i = start; i < stop; i++) {
+        _GMPy_Divisor_Op(work->self, work->op,
+                         work->q ? work->q[i] : NULL,
+                         work->r ? work->r[i] : NULL,
+                         work->x[i], t, u);
+    }
+    mpz_clear(t);
+    mpz_clear(u);
+}
+
+static PyObject *
+GMPy_Divisor_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    Divisor_Object *result;
+    MPZ_Object *tempd;
+    CTXT_Object *context = NULL;
+    mp_size_t n;
+
+    if (keywds && PyDict_Size(keywds)) {
+        TYPE_ERROR("Divisor() takes no keyword arguments");
+        return NULL;
+    }
+
+    if (PyTuple_GET_SIZE(args) != 1) {
+        TYPE_ERROR("Divisor() requires 1 argument");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_INTEGER(PyTuple_GET_ITEM(args, 0))) {
+        TYPE_ERROR("Divisor() requires an integer argument");
+        return NULL;
+    }
+
+    if (!(tempd = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), context)))
+        return NULL;
+
+    if (mpz_sgn(tempd->z) == 0) {
+        ZERO_ERROR("Divisor() division by zero");
+        Py_DECREF((PyObject*)tempd);
+        return NULL;
+    }
+
+    if (!(result = PyObject_New(Divisor_Object, &Divisor_Type))) {
+        Py_DECREF((PyObject*)tempd);
+        return NULL;
+    }
+
+    mpz_init_set(result->d, tempd->z);
+    mpz_init(result->inv);
+    n = mpz_size(tempd->z);
+    result->barrett = n >= GMPY_DIVISOR_BARRETT_LIMBS;
+    if (result->barrett) {
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(tempd->z));
+        mpz_setbit(result->inv, 2 * n * GMP_NUMB_BITS);
+        mpz_tdiv_q(result->inv, result->inv, tempd->z);
+        mpz_abs(result->inv, result->inv);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+    }
+    Py_DECREF((PyObject*)tempd);
+    return (PyObject*)result;
+}
+
+static void
+GMPy_Divisor_Dealloc(Divisor_Object *self)
+{
+    mpz_clear(self->d);
+    mpz_clear(self->inv);
+    PyObject_Free(self);
+}
+
+static PyObject *
+GMPy_Divisor_GetDivisor(Divisor_Object *self, void *closure)
+{
+    MPZ_Object *result;
+
+    if ((result = GMPy_MPZ_New(NULL)))
+        mpz_set(result->z, self->d);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_Divisor_Repr_Slot(Divisor_Object *self)
+{
+    PyObject *d, *result;
+
+    if (!(d = GMPy_Divisor_GetDivisor(self, NULL)))
+        return NULL;
+    result = PyUnicode_FromFormat("Divisor(%S)", d);
+    Py_DECREF(d);
+    return result;
+}
+
+static int
+_GMPy_Divisor_Profile_Op(int op)
+{
+    switch (op) {
+    case DIVISOR_DIVMOD:
+        return GMPY_OP_DIVMOD;
+    case DIVISOR_MOD:
+        return GMPY_OP_MOD;
+    default:
+        return GMPY_OP_FLOORDIV;
+    }
+}
+
+static PyObject *
+_GMPy_Divisor_Scalar(Divisor_Object *self, int op, PyObject *a, const char *name)
+{
+    MPZ_Object *tempa, *q = NULL, *r = NULL;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+    mpz_t t, u;
+
+    CHECK_CONTEXT(context);
+
+    if (MPZ_Check(a)) {
+        Py_INCREF(a);
+        tempa = (MPZ_Object*)a;
+    }
+    else if (!IS_INTEGER(a)) {
+        PyErr_Format(PyExc_TypeError, "Divisor.%s() requires an integer argument", name);
+        return NULL;
+    }
+    else if (!(tempa = GMPy_MPZ_From_Integer(a, context))) {
+        return NULL;
+    }
+
+    if ((op != DIVISOR_MOD && !(q = GMPy_MPZ_New(context))) ||
+        ((op == DIVISOR_DIVMOD || op == DIVISOR_MOD) && !(r = GMPy_MPZ_New(context)))) {
+        goto done;
+    }
+
+    GMPY_PROFILE_OP(context, _GMPy_Divisor_Profile_Op(op), mpz_sizeinbase(tempa->z, 2));
+    mpz_init(t);
+    mpz_init(u);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(tempa->z));
+    _GMPy_Divisor_Op(self, op, q ? q->z : NULL, r ? r->z : NULL, tempa->z, t, u);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    mpz_clear(t);
+    mpz_clear(u);
+
+    switch (op) {
+    case DIVISOR_DIVMOD:
+        result = PyTuple_Pack(2, (PyObject*)q, (PyObject*)r);
+        break;
+    case DIVISOR_MOD:
+        Py_INCREF((PyObject*)r);
+        result = (PyObject*)r;
+        break;
+    default:
+        Py_INCREF((PyObject*)q);
+        result = (PyObject*)q;
+    }
+
+  done:
+    Py_DECREF((PyObject*)tempa);
+    Py_XDECREF((PyObject*)q);
+    Py_XDECREF((PyObject*)r);
+    return result;
+}
+
+/* Return a new list or mpz_array of n fresh mpz and store their pointers in
+ * out.
+ */
+
+static PyObject *
+_GMPy_Divisor_Outputs(Py_ssize_t n, int array, mpz_ptr *out, CTXT_Object *context)
+{
+    PyObject *result, *temp;
+    Py_ssize_t i;
+
+    if (array) {
+        if ((result = (PyObject*)GMPy_MPZ_Array_New(n))) {
+            for (i = 0; i < n; i++)
+                out[i] = ((MPZ_Array_Object*)result)->z[i];
+        }
+        return result;
+    }
+
+    if (!(result = PyList_New(n)))
+        return NULL;
+    for (i = 0; i < n; i++) {
+        if (!(temp = (PyObject*)GMPy_MPZ_New(context))) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, i, temp);
+        out[i] = MPZ(temp);
+    }
+    return result;
+}
+
+static PyObject *
+_GMPy_Divisor_Batch(Divisor_Object *self, int op, PyObject *x, const char *name)
+{
+    gmpy_rational_view view;
+    gmpy_divisor_batch work;
+    PyObject *qs = NULL, *rs = NULL, *result = NULL;
+    CTXT_Object *context = NULL;
+    Py_ssize_t n;
+    int array = MPZ_Array_Check(x);
+
+    CHECK_CONTEXT(context);
+
+    memset(&view, 0, sizeof(gmpy_rational_view));
+    memset(&work, 0, sizeof(gmpy_divisor_batch));
+
+    if (_GMPy_View_Init(&view, x, name, context) < 0)
+        return NULL;
+    n = view.n;
+
+    if (view.rational) {
+        PyErr_Format(PyExc_TypeError, "Divisor.%s() requires integer arguments", name);
+        goto done;
+    }
+
+    if (op != DIVISOR_MOD) {
+        if (!(work.q = PyMem_New(mpz_ptr, n ? n : 1))) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        if (!(qs = _GMPy_Divisor_Outputs(n, array, work.q, context)))
+            goto done;
+    }
+    if (op == DIVISOR_DIVMOD || op == DIVISOR_MOD) {
+        if (!(work.r = PyMem_New(mpz_ptr, n ? n : 1))) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        if (!(rs = _GMPy_Divisor_Outputs(n, array, work.r, context)))
+            goto done;
+    }
+
+    work.self = self;
+    work.op = op;
+    work.x = view.num;
+    GMPY_PROFILE_OPN(context, _GMPy_Divisor_Profile_Op(op),
+                     mpz_sizeinbase(self->d, 2), n);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(self->d) * n);
+    GMPy_Parallel_Run(_GMPy_Divisor_Range, &work, n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    switch (op) {
+    case DIVISOR_DIVMOD:
+        result = PyTuple_Pack(2, qs, rs);
+        break;
+    case DIVISOR_MOD:
+        Py_INCREF(rs);
+        result = rs;
+        break;
+    default:
+        Py_INCREF(qs);
+        result = qs;
+    }
+
+  done:
+    PyMem_Free(work.q);
+    PyMem_Free(work.r);
+    _GMPy_View_Clear(&view);
+    Py_XDECREF(qs);
+    Py_XDECREF(rs);
+    return result;
+}
+
+#define GMPY_DIVISOR_METHOD(NAME, OP, FUNC, BATCH) \
+static PyObject * \
+GMPy_Divisor_##NAME(Divisor_Object *self, PyObject *other) \
+{ \
+    return _GMPy_Divisor_Scalar(self, OP, other, #FUNC); \
+} \
+static PyObject * \
+GMPy_Divisor_V##NAME(Divisor_Object *self, PyObject *other) \
+{ \
+    return _GMPy_Divisor_Batch(self, OP, other, #BATCH); \
+}
+
+GMPY_DIVISOR_METHOD(Divmod, DIVISOR_DIVMOD, divmod, vdivmod)
+GMPY_DIVISOR_METHOD(Floordiv, DIVISOR_FLOORDIV, floordiv, vfloordiv)
+GMPY_DIVISOR_METHOD(Mod, DIVISOR_MOD, mod, vmod)
+GMPY_DIVISOR_METHOD(Divexact, DIVISOR_DIVEXACT, divexact, vdivexact)
+
+PyDoc_STRVAR(GMPy_doc_divisor_divmod,
+"x.divmod(a, /) -> tuple[mpz, mpz]\n\n"
+"Return (a // d, a % d).");
+
+PyDoc_STRVAR(GMPy_doc_divisor_floordiv,
+"x.floordiv(a, /) -> mpz\n\n"
+"Return a // d.");
+
+PyDoc_STRVAR(GMPy_doc_divisor_mod,
+"x.mod(a, /) -> mpz\n\n"
+"Return a % d.");
+
+PyDoc_STRVAR(GMPy_doc_divisor_divexact,
+"x.divexact(a, /) -> mpz\n\n"
+"Return a // d. The result is only correct if d divides a.");
+
+PyDoc_STRVAR(GMPy_doc_divisor_vdivmod,
+"x.vdivmod(a, /) -> tuple[list | mpz_array, list | mpz_array]\n\n"
+"Return the quotients and the remainders of the elements of a.");
+
+PyDoc_STRVAR(GMPy_doc_divisor_vfloordiv,
+"x.vfloordiv(a, /) -> list | mpz_array\n\n"
+"Return [x.floordiv(i) for i in a].");
+
+PyDoc_STRVAR(GMPy_doc_divisor_vmod,
+"x.vmod(a, /) -> list | mpz_array\n\n"
+"Return [x.mod(i) for i in a].");
+
+PyDoc_STRVAR(GMPy_doc_divisor_vdivexact,
+"x.vdivexact(a, /) -> list | mpz_array\n\n"
+"Return [x.divexact(i) for i in a].");
+
+static PyMethodDef GMPy_Divisor_methods[] =
+{
+    { "divexact", (PyCFunction)GMPy_Divisor_Divexact, METH_O, GMPy_doc_divisor_divexact },
+    { "divmod", (PyCFunction)GMPy_Divisor_Divmod, METH_O, GMPy_doc_divisor_divmod },
+    { "floordiv", (PyCFunction)GMPy_Divisor_Floordiv, METH_O, GMPy_doc_divisor_floordiv },
+    { "mod", (PyCFunction)GMPy_Divisor_Mod, METH_O, GMPy_doc_divisor_mod },
+    { "vdivexact", (PyCFunction)GMPy_Divisor_VDivexact, METH_O, GMPy_doc_divisor_vdivexact },
+    { "vdivmod", (PyCFunction)GMPy_Divisor_VDivmod, METH_O, GMPy_doc_divisor_vdivmod },
+    { "vfloordiv", (PyCFunction)GMPy_Divisor_VFloordiv, METH_O, GMPy_doc_divisor_vfloordiv },
+    { "vmod", (PyCFunction)GMPy_Divisor_VMod, METH_O, GMPy_doc_divisor_vmod },
+    { NULL }
+};
+
+static PyGetSetDef GMPy_Divisor_getseters[] =
+{
+    { "divisor", (getter)GMPy_Divisor_GetDivisor, NULL, "divisor", NULL },
+    { NULL }
+};
+
+static PyTypeObject Divisor_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.Divisor",
+    .tp_basicsize = sizeof(Divisor_Object),
+    .tp_dealloc = (destructor) GMPy_Divisor_Dealloc,
+    .tp_repr = (reprfunc) GMPy_Divisor_Repr_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_divisor,
+    .tp_methods = GMPy_Divisor_methods,
+    .tp_getset = GMPy_Divisor_getseters,
+    .tp_new = GMPy_Divisor_NewInit,
+};
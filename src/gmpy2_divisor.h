@@ -0,0 +1,55 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_divisor.h                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_DIVISOR_H
+#define GMPY_DIVISOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A Divisor divides by a fixed d != 0. If |d| has at least
+ * GMPY_DIVISOR_BARRETT_LIMBS limbs, inv is floor(B**(2*n) / |d|) where
+ * B = 2**GMP_NUMB_BITS and n is the number of limbs of |d|. Below that
+ * size mpz_fdiv_qr() is faster.
+ */
+
+#define GMPY_DIVISOR_BARRETT_LIMBS 384
+
+typedef struct {
+    PyObject_HEAD
+    mpz_t d;
+    mpz_t inv;
+    int barrett;
+} Divisor_Object;
+
+static PyTypeObject Divisor_Type;
+#define Divisor_Check(v) (((PyObject*)v)->ob_type == &Divisor_Type)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
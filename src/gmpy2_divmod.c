@@ -51,7 +51,7 @@ GMPy_Integer_DivModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
                 ZERO_ERROR("division or modulo by zero");
                 goto error;
             }
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), MPZ(y)));
             mpz_fdiv_qr(quo->z, rem->z, MPZ(x), MPZ(y));
             GMPY_MAYBE_END_ALLOW_THREADS(context);
             PyTuple_SET_ITEM(result, 0, (PyObject*)quo);
@@ -60,13 +60,12 @@ GMPy_Integer_DivModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
         }
 
         if (IS_TYPE_PyInteger(ytype)) {
-            int error;
-            long temp = PyLong_AsLongAndOverflow(y, &error);
+            long temp;
 
-            if (error) {
+            if (!GMPy_PyLong_AsSmall(y, &temp)) {
                 /* Use quo->z as a temporary variable. */
                 mpz_set_PyLong(quo->z, y);
-                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), quo->z));
                 mpz_fdiv_qr(quo->z, rem->z, MPZ(x), quo->z);
                 GMPY_MAYBE_END_ALLOW_THREADS(context);
             }
@@ -95,7 +94,7 @@ GMPy_Integer_DivModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             }
             else {
                 mpz_set_PyLong(quo->z, x);
-                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(quo->z, MPZ(y)));
                 mpz_fdiv_qr(quo->z, rem->z, quo->z, MPZ(y));
                 GMPY_MAYBE_END_ALLOW_THREADS(context);
                 PyTuple_SET_ITEM(result, 0, (PyObject*)quo);
@@ -118,7 +117,7 @@ GMPy_Integer_DivModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             ZERO_ERROR("division or modulo by zero");
             goto error;
         }
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(tempx->z, tempy->z));
         mpz_fdiv_qr(quo->z, rem->z, tempx->z, tempy->z);
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_DECREF((PyObject*)tempx);
@@ -173,7 +172,7 @@ GMPy_Rational_DivModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             goto error;
         }
 
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(tempx->q, tempy->q));
         mpq_div(rem->q, tempx->q, tempy->q);
         mpz_fdiv_q(quo->z, mpq_numref(rem->q), mpq_denref(rem->q));
         /* Need to calculate x - quo * y. */
@@ -228,7 +227,7 @@ GMPy_Real_DivModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             /* LCOV_EXCL_STOP */
         }
         if (mpfr_zero_p(tempy->f)) {
-            context->ctx.divzero = 1;
+            GMPY_CTXT_FLAGS(context)->divzero = 1;
             if (context->ctx.traps & TRAP_DIVZERO) {
                 GMPY_DIVZERO("divmod() division by zero");
                 goto error;
@@ -239,7 +238,7 @@ GMPy_Real_DivModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
         }
 
         if (mpfr_nan_p(tempx->f) || mpfr_nan_p(tempy->f) || mpfr_inf_p(tempx->f)) {
-            context->ctx.invalid = 1;
+            GMPY_CTXT_FLAGS(context)->invalid = 1;
             if (context->ctx.traps & TRAP_INVALID) {
                 GMPY_INVALID("divmod() invalid operation");
                 goto error;
@@ -250,7 +249,7 @@ GMPy_Real_DivModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
         }
 
         if (mpfr_inf_p(tempy->f)) {
-            context->ctx.invalid = 1;
+            GMPY_CTXT_FLAGS(context)->invalid = 1;
             if (context->ctx.traps & TRAP_INVALID) {
                 GMPY_INVALID("divmod() invalid operation");
                 goto error;
@@ -329,23 +328,28 @@ GMPy_Complex_DivModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
     return NULL;
 }
 
+/* Indexed by GMPY_TYPE_CLASS2(xtype, ytype). */
+
+static gmpy_binary_withtype const GMPy_DivMod_Table[OBJ_CLASS_COUNT] = {
+    GMPy_Integer_DivModWithType,
+    GMPy_Rational_DivModWithType,
+    GMPy_Real_DivModWithType,
+    GMPy_Complex_DivModWithType,
+};
+
 static PyObject *
 GMPy_Number_DivMod_Slot(PyObject *x, PyObject *y)
 {
+    CTXT_Object *context = NULL;
+    CHECK_CONTEXT(context);
+
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_DivModWithType(x, xtype, y, ytype, NULL);
+    GMPY_PROFILE_OP2(context, GMPY_OP_DIVMOD, x, xtype, y, ytype);
 
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_DivModWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_DivModWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_DivModWithType(x, xtype, y, ytype, NULL);
+    if (xtype && ytype)
+        return GMPy_DivMod_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, context);
 
     Py_RETURN_NOTIMPLEMENTED;
 }
@@ -356,17 +360,10 @@ GMPy_Number_DivMod(PyObject *x, PyObject *y, CTXT_Object *context)
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_DivModWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_DivModWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_DivModWithType(x, xtype, y, ytype, NULL);
+    GMPY_PROFILE_OP2(context, GMPY_OP_DIVMOD, x, xtype, y, ytype);
 
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_DivModWithType(x, xtype, y, ytype, NULL);
+    if (xtype && ytype)
+        return GMPy_DivMod_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, NULL);
 
     TYPE_ERROR("divmod() argument type not supported");
     return NULL;
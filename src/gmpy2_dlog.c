@@ -0,0 +1,725 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_dlog.c                                                            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/* Discrete logarithms modulo p.
+ *
+ * The order of g is found from the factorization of a multiple of it, and
+ * the Pohlig-Hellman method reduces the logarithm to one digit at a time
+ * in subgroups of prime order q. Small subgroups are searched with
+ * baby-step giant-step: the baby steps are kept in an open addressing
+ * table of the low limbs of the residues and the giant steps are split
+ * over the threads. Larger subgroups use Pollard's rho with r-adding walks
+ * and distinguished points (van Oorschot and Wiener), so every thread runs
+ * its own walks and collisions between the walks of all threads are found
+ * in one table. The residues are reduced through the form of p used by
+ * Modulus. Every logarithm is checked before it is returned.
+ */
+
+enum {
+    DLOG_FOUND = 0,
+    DLOG_NONE = -1,         /* there is no logarithm */
+    DLOG_NOMEM = -2,
+    DLOG_INTERRUPTED = -3,
+    DLOG_COMPOSITE = -4     /* a factor of the order is not prime */
+};
+
+#if GMP_NUMB_BITS >= 64
+#  define GMPY_DLOG_MIX ((mp_limb_t)0x9E3779B97F4A7C15ULL)
+#else
+#  define GMPY_DLOG_MIX ((mp_limb_t)0x9E3779B9UL)
+#endif
+
+/* The hash of a residue depends only on its low limb. The slot in a table
+ * uses both halves of the hash since distinguished points have zero low
+ * bits.
+ */
+
+#define DLOG_HASH(x) (mpz_getlimbn(x, 0) * GMPY_DLOG_MIX)
+#define DLOG_SLOT(h, mask) ((size_t)((h) ^ ((h) >> (GMP_NUMB_BITS / 2))) & (mask))
+
+/* Set r to a * b mod p; r may be a or b. */
+
+static void
+_GMPy_DLog_Mul(mpz_ptr r, mpz_srcptr a, mpz_srcptr b,
+               const gmpy_modulus_form *f, mpz_ptr t, mpz_ptr u)
+{
+    mpz_mul(t, a, b);
+    _GMPy_Modulus_Mod(f, r, t, u);
+}
+
+static int
+_GMPy_DLog_Poll(unsigned long *work)
+{
+    if (++*work < GMPY_DLOG_POLL_STEPS)
+        return 0;
+    *work = 0;
+    return GMPy_Interrupt_Poll();
+}
+
+/* Return 1 if gamma**x == t. */
+
+static int
+_GMPy_DLog_Check(gmpy_dlog_search *s, mpz_srcptr x, mpz_ptr t)
+{
+    mpz_powm(t, s->gamma, x, s->form->m);
+    return mpz_cmp(t, s->t) == 0;
+}
+
+static void
+_GMPy_DLog_Found(gmpy_dlog_search *s, mpz_srcptr x)
+{
+    PyThread_acquire_lock(s->lock, WAIT_LOCK);
+    if (!s->done) {
+        mpz_set(s->x, x);
+        s->done = 1;
+    }
+    PyThread_release_lock(s->lock);
+}
+
+/* Store the baby steps gamma**j for 0 <= j < m = ceil(sqrt(q)). */
+
+static int
+_GMPy_DLog_BSGS_Init(gmpy_dlog_search *s)
+{
+    mpz_t x, t, u;
+    size_t size = 4, slot;
+    unsigned long j, work = 0;
+    mp_limb_t h;
+    int result = DLOG_FOUND;
+
+    mpz_init(x);
+    mpz_init(t);
+    mpz_init(u);
+    mpz_sqrtrem(x, t, s->q);
+    s->m = mpz_get_ui(x) + (mpz_sgn(t) != 0);
+    while (size < 2 * (size_t)s->m)
+        size *= 2;
+    s->mask = size - 1;
+    if (!(s->keys = PyMem_RawMalloc(size * sizeof(mp_limb_t))) ||
+        !(s->index = PyMem_RawCalloc(size, sizeof(unsigned int)))) {
+        result = DLOG_NOMEM;
+        goto done;
+    }
+
+    mpz_set_ui(x, 1);
+    for (j = 0; j < s->m; j++) {
+        h = DLOG_HASH(x);
+        for (slot = DLOG_SLOT(h, s->mask); s->index[slot]; slot = (slot + 1) & s->mask);
+        s->keys[slot] = h;
+        s->index[slot] = (unsigned int)(j + 1);
+        _GMPy_DLog_Mul(x, x, s->gamma, s->form, t, u);
+        if (_GMPy_DLog_Poll(&work)) {
+            result = DLOG_INTERRUPTED;
+            goto done;
+        }
+    }
+    mpz_invert(s->giant, x, s->form->m);
+
+  done:
+    mpz_clear(x);
+    mpz_clear(t);
+    mpz_clear(u);
+    return result;
+}
+
+/* Thread k takes the giant steps t * gamma**(-m*i) for i in the k-th part
+ * of the range 0 <= i < m.
+ */
+
+static void
+_GMPy_DLog_BSGS_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_dlog_search *s = (gmpy_dlog_search*)arg;
+    mpz_t y, x, t, u;
+    unsigned long i, first, last, work = 0;
+    size_t slot;
+    mp_limb_t h;
+    Py_ssize_t k;
+
+    mpz_init(y);
+    mpz_init(x);
+    mpz_init(t);
+    mpz_init(u);
+    for (k = start; k < stop && !s->done; k++) {
+        first = (unsigned long)((unsigned long long)s->m * k / s->threads);
+        last = (unsigned long)((unsigned long long)s->m * (k + 1) / s->threads);
+        mpz_powm_ui(y, s->giant, first, s->form->m);
+        _GMPy_DLog_Mul(y, y, s->t, s->form, t, u);
+        for (i = first; i < last && !s->done; i++) {
+            h = DLOG_HASH(y);
+            for (slot = DLOG_SLOT(h, s->mask); s->index[slot]; slot = (slot + 1) & s->mask) {
+                if (s->keys[slot] != h)
+                    continue;
+                mpz_set_ui(x, i);
+                mpz_mul_ui(x, x, s->m);
+                mpz_add_ui(x, x, s->index[slot] - 1);
+                if (_GMPy_DLog_Check(s, x, t)) {
+                    _GMPy_DLog_Found(s, x);
+                    break;
+                }
+            }
+            _GMPy_DLog_Mul(y, y, s->giant, s->form, t, u);
+            if (_GMPy_DLog_Poll(&work))
+                goto done;
+        }
+    }
+
+  done:
+    mpz_clear(y);
+    mpz_clear(x);
+    mpz_clear(t);
+    mpz_clear(u);
+}
+
+/* Choose the multipliers of the walks and the distinguished points. About
+ * 2**10 distinguished points are expected before a collision.
+ */
+
+static int
+_GMPy_DLog_Rho_Init(gmpy_dlog_search *s)
+{
+    gmp_randstate_t state;
+    mpz_t t, u;
+    size_t half = (mpz_sizeinbase(s->q, 2) + 1) / 2, d, size = 4096;
+    int i;
+
+    d = half > 10 ? half - 10 : 0;
+    if (d > GMP_NUMB_BITS / 2 - 4)
+        d = GMP_NUMB_BITS / 2 - 4;
+    s->dpmask = ((mp_limb_t)1 << d) - 1;
+    s->walk = 20ULL << d;
+
+    /* A rho walk needs about 1.25 * sqrt(q) steps in all. For a composite p
+     * t can lie outside the group generated by gamma, so the threads give
+     * up after 32 times as many. */
+    s->limit = half < 58 ? (32ULL << half) / s->threads : (unsigned long long)-1;
+
+    if (!(s->points = PyMem_RawCalloc(size, sizeof(gmpy_dlog_point))))
+        return DLOG_NOMEM;
+    s->pmask = size - 1;
+
+    mpz_init(t);
+    mpz_init(u);
+    gmp_randinit_default(state);
+    for (i = 0; i < GMPY_DLOG_ADDERS; i++) {
+        mpz_init(s->mult[i]);
+        mpz_init(s->adda[i]);
+        mpz_init(s->addb[i]);
+        mpz_urandomm(s->adda[i], state, s->q);
+        mpz_urandomm(s->addb[i], state, s->q);
+        mpz_powm(s->mult[i], s->gamma, s->adda[i], s->form->m);
+        mpz_powm(t, s->t, s->addb[i], s->form->m);
+        _GMPy_DLog_Mul(s->mult[i], s->mult[i], t, s->form, t, u);
+    }
+    gmp_randclear(state);
+    mpz_clear(t);
+    mpz_clear(u);
+    return DLOG_FOUND;
+}
+
+/* Double the table of distinguished points. Keeps the old table if there
+ * is no memory; it is then filled up to one empty slot.
+ */
+
+static void
+_GMPy_DLog_Rho_Grow(gmpy_dlog_search *s)
+{
+    gmpy_dlog_point *points;
+    size_t i, slot, mask = 2 * s->pmask + 1;
+
+    if (!(points = PyMem_RawCalloc(mask + 1, sizeof(gmpy_dlog_point))))
+        return;
+    for (i = 0; i <= s->pmask; i++) {
+        if (!s->points[i].used)
+            continue;
+        for (slot = DLOG_SLOT(s->points[i].key, mask); points[slot].used;
+             slot = (slot + 1) & mask);
+        points[slot] = s->points[i];
+    }
+    PyMem_RawFree(s->points);
+    s->points = points;
+    s->pmask = mask;
+}
+
+/* Compare the distinguished point gamma**a * t**b with hash h to the stored
+ * ones and store it. A collision with b != b' gives the logarithm
+ * (a' - a) / (b - b') mod q.
+ */
+
+static void
+_GMPy_DLog_Rho_Point(gmpy_dlog_search *s, mp_limb_t h, mpz_srcptr a,
+                     mpz_srcptr b, mpz_ptr x, mpz_ptr t)
+{
+    gmpy_dlog_point *point;
+    size_t slot;
+
+    PyThread_acquire_lock(s->lock, WAIT_LOCK);
+    for (slot = DLOG_SLOT(h, s->pmask); s->points[slot].used;
+         slot = (slot + 1) & s->pmask) {
+        point = &s->points[slot];
+        if (point->key != h || mpz_cmp(point->b, b) == 0)
+            continue;
+        mpz_sub(t, b, point->b);
+        mpz_mod(t, t, s->q);
+        if (!mpz_invert(t, t, s->q))
+            continue;
+        mpz_sub(x, point->a, a);
+        mpz_mul(x, x, t);
+        mpz_mod(x, x, s->q);
+        if (_GMPy_DLog_Check(s, x, t)) {
+            if (!s->done) {
+                mpz_set(s->x, x);
+                s->done = 1;
+            }
+            PyThread_release_lock(s->lock);
+            return;
+        }
+    }
+    if (s->npoints < s->pmask) {
+        point = &s->points[slot];
+        point->key = h;
+        point->used = 1;
+        mpz_init_set(point->a, a);
+        mpz_init_set(point->b, b);
+        if (2 * ++s->npoints > s->pmask)
+            _GMPy_DLog_Rho_Grow(s);
+    }
+    PyThread_release_lock(s->lock);
+}
+
+/* Thread k starts walks at random points gamma**a * t**b until one of them
+ * reaches a distinguished point that was already found.
+ */
+
+static void
+_GMPy_DLog_Rho_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_dlog_search *s = (gmpy_dlog_search*)arg;
+    gmp_randstate_t state;
+    mpz_t y, a, b, x, t, u;
+    unsigned long long steps, len;
+    unsigned long work = 0;
+    mp_limb_t h;
+    size_t i;
+    Py_ssize_t k;
+
+    mpz_init(y);
+    mpz_init(a);
+    mpz_init(b);
+    mpz_init(x);
+    mpz_init(t);
+    mpz_init(u);
+    for (k = start; k < stop && !s->done; k++) {
+        gmp_randinit_default(state);
+        gmp_randseed_ui(state, (unsigned long)k + 1);
+        for (steps = 0; steps < s->limit && !s->done; ) {
+            mpz_urandomm(a, state, s->q);
+            mpz_urandomm(b, state, s->q);
+            mpz_powm(y, s->gamma, a, s->form->m);
+            mpz_powm(t, s->t, b, s->form->m);
+            _GMPy_DLog_Mul(y, y, t, s->form, t, u);
+            for (len = 0; len < s->walk && !s->done; len++, steps++) {
+                h = DLOG_HASH(y);
+                if (!(h & s->dpmask)) {
+                    _GMPy_DLog_Rho_Point(s, h, a, b, x, t);
+                    break;
+                }
+                i = (size_t)(h >> (GMP_NUMB_BITS - GMPY_DLOG_ADDER_BITS));
+                _GMPy_DLog_Mul(y, y, s->mult[i], s->form, t, u);
+                mpz_add(a, a, s->adda[i]);
+                if (mpz_cmp(a, s->q) >= 0)
+                    mpz_sub(a, a, s->q);
+                mpz_add(b, b, s->addb[i]);
+                if (mpz_cmp(b, s->q) >= 0)
+                    mpz_sub(b, b, s->q);
+                if (_GMPy_DLog_Poll(&work)) {
+                    gmp_randclear(state);
+                    goto done;
+                }
+            }
+        }
+        gmp_randclear(state);
+    }
+
+  done:
+    mpz_clear(y);
+    mpz_clear(a);
+    mpz_clear(b);
+    mpz_clear(x);
+    mpz_clear(t);
+    mpz_clear(u);
+}
+
+/* Compare the powers of gamma to t != 1 one by one. */
+
+static int
+_GMPy_DLog_Linear(mpz_ptr r, mpz_srcptr gamma, mpz_srcptr t, unsigned long q,
+                  const gmpy_modulus_form *f)
+{
+    mpz_t x, u, v;
+    unsigned long j;
+
+    mpz_init_set(x, gamma);
+    mpz_init(u);
+    mpz_init(v);
+    for (j = 1; j < q && mpz_cmp(x, t) != 0; j++)
+        _GMPy_DLog_Mul(x, x, gamma, f, u, v);
+    mpz_set_ui(r, j);
+    mpz_clear(x);
+    mpz_clear(u);
+    mpz_clear(v);
+    return j < q ? DLOG_FOUND : DLOG_NONE;
+}
+
+/* Set r to the logarithm of t to the base gamma of prime order q. Does not
+ * use the Python API except through GMPy_Interrupt_Poll().
+ */
+
+static int
+_GMPy_DLog_Prime(mpz_ptr r, mpz_srcptr gamma, mpz_srcptr t, mpz_srcptr q,
+                 const gmpy_modulus_form *f, int threads)
+{
+    gmpy_dlog_search s;
+    size_t i;
+    int result;
+
+    if (mpz_cmp_ui(t, 1) == 0) {
+        mpz_set_ui(r, 0);
+        return DLOG_FOUND;
+    }
+    if (mpz_cmp_ui(q, GMPY_DLOG_LINEAR) < 0)
+        return _GMPy_DLog_Linear(r, gamma, t, mpz_get_ui(q), f);
+
+    memset(&s, 0, sizeof(gmpy_dlog_search));
+    s.form = f;
+    s.gamma = gamma;
+    s.t = t;
+    s.q = q;
+    s.threads = threads;
+    mpz_init(s.x);
+    mpz_init(s.giant);
+
+    /* t must lie in the subgroup of order q. */
+
+    mpz_powm(s.x, t, q, f->m);
+    if (mpz_cmp_ui(s.x, 1) != 0) {
+        result = DLOG_NONE;
+        goto done;
+    }
+    if (!(s.lock = PyThread_allocate_lock())) {
+        result = DLOG_NOMEM;
+        goto done;
+    }
+
+    if (mpz_sizeinbase(q, 2) < GMPY_DLOG_BSGS_BITS) {
+        if (mpz_sizeinbase(q, 2) < 24)
+            s.threads = 1;
+        if ((result = _GMPy_DLog_BSGS_Init(&s)) == DLOG_FOUND)
+            GMPy_Parallel_Run(_GMPy_DLog_BSGS_Range, &s, s.threads, s.threads);
+    }
+    else {
+        if ((result = _GMPy_DLog_Rho_Init(&s)) == DLOG_FOUND)
+            GMPy_Parallel_Run(_GMPy_DLog_Rho_Range, &s, s.threads, s.threads);
+    }
+    if (result == DLOG_FOUND) {
+        if (s.done)
+            mpz_mod(r, s.x, q);
+        else
+            result = GMPy_Interrupt_Poll() ? DLOG_INTERRUPTED : DLOG_NONE;
+    }
+
+  done:
+    if (s.lock)
+        PyThread_free_lock(s.lock);
+    PyMem_RawFree(s.keys);
+    PyMem_RawFree(s.index);
+    if (s.points) {
+        for (i = 0; i <= s.pmask; i++) {
+            if (s.points[i].used) {
+                mpz_clear(s.points[i].a);
+                mpz_clear(s.points[i].b);
+            }
+        }
+        PyMem_RawFree(s.points);
+        for (i = 0; i < GMPY_DLOG_ADDERS; i++) {
+            mpz_clear(s.mult[i]);
+            mpz_clear(s.adda[i]);
+            mpz_clear(s.addb[i]);
+        }
+    }
+    mpz_clear(s.x);
+    mpz_clear(s.giant);
+    return result;
+}
+
+/* Set r to the least x >= 0 with g**x == h mod p, where g is invertible and
+ * g**n == 1. factors is the factorization of n. Does not use the Python API
+ * except through GMPy_Interrupt_Poll().
+ */
+
+static int
+_GMPy_DLog(mpz_ptr r, mpz_srcptr g, mpz_srcptr h, mpz_srcptr n,
+           gmpy_factor_item *factors, Py_ssize_t nfactors,
+           const gmpy_modulus_form *f, int threads)
+{
+    mpz_t order, qe, qk, g0, h0, ginv, gamma, y, d, x, mod, t, u;
+    mpz_srcptr p = f->m, q;
+    unsigned long e, k, j;
+    Py_ssize_t i;
+    int result = DLOG_FOUND;
+
+    for (i = 0; i < nfactors; i++) {
+        if (_GMPy_MPZ_BPSW_PRP(factors[i].value) != 1)
+            return DLOG_COMPOSITE;
+    }
+
+    mpz_init(order);
+    mpz_init(qe);
+    mpz_init(qk);
+    mpz_init(g0);
+    mpz_init(h0);
+    mpz_init(ginv);
+    mpz_init(gamma);
+    mpz_init(y);
+    mpz_init(d);
+    mpz_init(x);
+    mpz_init(mod);
+    mpz_init(t);
+    mpz_init(u);
+
+    /* Remove the primes from n that the order of g does not need. */
+
+    mpz_set(order, n);
+    for (i = 0; i < nfactors; i++) {
+        for (j = 0; j < factors[i].exp; j++) {
+            mpz_divexact(t, order, factors[i].value);
+            mpz_powm(u, g, t, p);
+            if (mpz_cmp_ui(u, 1) != 0)
+                break;
+            mpz_swap(order, t);
+        }
+    }
+
+    /* Find the logarithm modulo every q**e dividing the order, one base q
+     * digit at a time, and combine them. */
+
+    mpz_set_ui(x, 0);
+    mpz_set_ui(mod, 1);
+    for (i = 0; i < nfactors; i++) {
+        q = factors[i].value;
+        if (!(e = (unsigned long)mpz_remove(t, order, q)))
+            continue;
+        mpz_pow_ui(qe, q, e);
+        mpz_divexact(t, order, qe);
+        mpz_powm(g0, g, t, p);
+        mpz_powm(h0, h, t, p);
+        mpz_invert(ginv, g0, p);
+        mpz_divexact(t, qe, q);
+        mpz_powm(gamma, g0, t, p);
+
+        mpz_set_ui(y, 0);
+        mpz_set_ui(qk, 1);
+        for (k = 0; k < e; k++) {
+            mpz_powm(t, ginv, y, p);
+            _GMPy_DLog_Mul(t, t, h0, f, d, u);
+            mpz_pow_ui(u, q, e - 1 - k);
+            mpz_powm(t, t, u, p);
+            if ((result = _GMPy_DLog_Prime(d, gamma, t, q, f, threads)) != DLOG_FOUND)
+                goto done;
+            mpz_addmul(y, d, qk);
+            mpz_mul(qk, qk, q);
+        }
+
+        mpz_sub(t, y, x);
+        mpz_invert(u, mod, qe);
+        mpz_mul(t, t, u);
+        mpz_mod(t, t, qe);
+        mpz_addmul(x, mod, t);
+        mpz_mul(mod, mod, qe);
+    }
+
+    mpz_powm(t, g, x, p);
+    if (mpz_cmp(t, h) != 0)
+        result = DLOG_NONE;
+    else
+        mpz_set(r, x);
+
+  done:
+    mpz_clear(order);
+    mpz_clear(qe);
+    mpz_clear(qk);
+    mpz_clear(g0);
+    mpz_clear(h0);
+    mpz_clear(ginv);
+    mpz_clear(gamma);
+    mpz_clear(y);
+    mpz_clear(d);
+    mpz_clear(x);
+    mpz_clear(mod);
+    mpz_clear(t);
+    mpz_clear(u);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_discrete_log,
+"discrete_log(g, h, p, /, order=None) -> mpz\n\n"
+"Return the least x >= 0 with g**x == h (mod p). p is an integer or a\n"
+"Modulus. order must be a multiple of the order of g modulo p and\n"
+"defaults to p - 1, which is correct if p is prime. The order is\n"
+"factored like factor() does and the logarithm is found with the\n"
+"Pohlig-Hellman method: subgroups of prime order below 2**36 are\n"
+"searched with baby-step giant-step and larger ones with Pollard's rho,\n"
+"both split over the context's threads. Raises ValueError if g is not\n"
+"invertible modulo p, if g**order != 1 (mod p), if the order could not\n"
+"be factored, or if no logarithm was found. The GIL is released during\n"
+"the search, which can be interrupted and is stopped by the context's\n"
+"max_time and deadline.");
+
+static PyObject *
+GMPy_MPZ_Function_Discrete_Log(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"g", "h", "p", "order", NULL};
+    gmpy_factor_job job;
+    gmpy_interrupt intr;
+    gmpy_modulus_form form;
+    const gmpy_modulus_form *f = &form;
+    MPZ_Object *tempp = NULL, *temp, *result = NULL;
+    PyObject *g, *h, *p, *order = Py_None;
+    CTXT_Object *context = NULL;
+    mpz_t gr, hr, n;
+    int status, threads;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OOO|O", kwlist, &g, &h, &p, &order))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_INTEGER(g) || !IS_INTEGER(h) ||
+        !(Modulus_Check(p) || IS_INTEGER(p)) ||
+        !(order == Py_None || IS_INTEGER(order))) {
+        TYPE_ERROR("discrete_log() requires integer arguments");
+        return NULL;
+    }
+
+    memset(&job, 0, sizeof(gmpy_factor_job));
+    mpz_init(gr);
+    mpz_init(hr);
+    mpz_init(n);
+
+    if (Modulus_Check(p)) {
+        f = &((Modulus_Object*)p)->form;
+    }
+    else {
+        if (!(tempp = GMPy_MPZ_From_Integer(p, context)))
+            goto done;
+        if (mpz_sgn(tempp->z) <= 0) {
+            VALUE_ERROR("discrete_log() requires p > 0");
+            goto done;
+        }
+        _GMPy_Modulus_Form_Init(&form, tempp->z);
+    }
+
+    if (!(temp = GMPy_MPZ_From_Integer(g, context)))
+        goto done;
+    mpz_mod(gr, temp->z, f->m);
+    Py_DECREF((PyObject*)temp);
+    if (!(temp = GMPy_MPZ_From_Integer(h, context)))
+        goto done;
+    mpz_mod(hr, temp->z, f->m);
+    Py_DECREF((PyObject*)temp);
+    if (order == Py_None) {
+        mpz_sub_ui(n, f->m, 1);
+    }
+    else {
+        if (!(temp = GMPy_MPZ_From_Integer(order, context)))
+            goto done;
+        mpz_set(n, temp->z);
+        Py_DECREF((PyObject*)temp);
+    }
+
+    if (!(result = GMPy_MPZ_New(context)))
+        goto done;
+    if (mpz_cmp_ui(f->m, 1) == 0) {
+        mpz_set_ui(result->z, 0);
+        goto done;
+    }
+    if (mpz_sgn(n) <= 0) {
+        VALUE_ERROR("discrete_log() requires order > 0");
+        goto error;
+    }
+    mpz_gcd(result->z, gr, f->m);
+    if (mpz_cmp_ui(result->z, 1) != 0) {
+        VALUE_ERROR("discrete_log() requires g to be invertible modulo p");
+        goto error;
+    }
+    mpz_powm(result->z, gr, n, f->m);
+    if (mpz_cmp_ui(result->z, 1) != 0) {
+        VALUE_ERROR("discrete_log() requires g**order == 1 (mod p)");
+        goto error;
+    }
+
+    if (_GMPy_Factor_Job_Init(&job, n, GMPY_FACTOR_DEFAULT_EFFORT) < 0)
+        goto error;
+
+    GMPY_PROFILE_MPZ(context, GMPY_OP_POWMOD, f->m);
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(f->m) * GMPY_MPZ_BITS(n));
+    intr.save = &_save;
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+    if (_GMPy_Factor_Job_Run(&job, n) < 0)
+        status = DLOG_INTERRUPTED;
+    else
+        status = _GMPy_DLog(result->z, gr, hr, n, job.found, job.nfound, f, threads);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (GMPy_Interrupt_End(&intr) < 0)
+        goto error;
+    switch (status) {
+    case DLOG_FOUND:
+        goto done;
+    case DLOG_NONE:
+        VALUE_ERROR("discrete_log() no logarithm was found");
+        break;
+    case DLOG_COMPOSITE:
+        VALUE_ERROR("discrete_log() could not factor the order");
+        break;
+    case DLOG_NOMEM:
+        PyErr_NoMemory();
+        break;
+    }
+
+  error:
+    Py_CLEAR(result);
+  done:
+    _GMPy_Factor_Job_Clear(&job);
+    Py_XDECREF((PyObject*)tempp);
+    mpz_clear(gr);
+    mpz_clear(hr);
+    mpz_clear(n);
+    return (PyObject*)result;
+}
@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_dlog.h                                                            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef GMPY_DLOG_H
+#define GMPY_DLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Subgroups of prime order q < 2**GMPY_DLOG_BSGS_BITS are searched with
+ * baby-step giant-step, which keeps sqrt(q) baby steps in a table; larger
+ * ones use Pollard's rho.
+ */
+
+#define GMPY_DLOG_BSGS_BITS 36
+
+/* The powers of gamma are compared one by one if q < GMPY_DLOG_LINEAR. */
+
+#define GMPY_DLOG_LINEAR 64
+
+/* The number of multipliers of the rho walks. */
+
+#define GMPY_DLOG_ADDER_BITS 5
+#define GMPY_DLOG_ADDERS (1 << GMPY_DLOG_ADDER_BITS)
+
+/* Modular multiplications between two calls of GMPy_Interrupt_Poll(). */
+
+#define GMPY_DLOG_POLL_STEPS (1UL << 12)
+
+/* A distinguished point reached by a rho walk: the residue with low limb
+ * key equals gamma**a * t**b.
+ */
+
+typedef struct {
+    mp_limb_t key;
+    int used;
+    mpz_t a;
+    mpz_t b;
+} gmpy_dlog_point;
+
+/* The search for the logarithm of t to the base gamma, of prime order q,
+ * shared by the threads. lock protects the table of distinguished points
+ * and the result x.
+ */
+
+typedef struct {
+    const gmpy_modulus_form *form;
+    mpz_srcptr gamma;
+    mpz_srcptr t;
+    mpz_srcptr q;
+    int threads;
+    volatile int done;
+    PyThread_type_lock lock;
+    mpz_t x;
+
+    /* Baby-step giant-step: keys[i] is the low limb of gamma**(index[i] - 1)
+     * and index[i] is 0 for an empty slot. giant is gamma**-m. */
+    unsigned long m;
+    size_t mask;
+    mp_limb_t *keys;
+    unsigned int *index;
+    mpz_t giant;
+
+    /* Pollard's rho: a step multiplies by mult[s] = gamma**adda[s] *
+     * t**addb[s]. */
+    mpz_t mult[GMPY_DLOG_ADDERS];
+    mpz_t adda[GMPY_DLOG_ADDERS];
+    mpz_t addb[GMPY_DLOG_ADDERS];
+    mp_limb_t dpmask;
+    unsigned long long walk;    /* steps before a walk is abandoned */
+    unsigned long long limit;   /* steps of each thread before giving up */
+    gmpy_dlog_point *points;
+    size_t npoints;
+    size_t pmask;
+} gmpy_dlog_search;
+
+static PyObject * GMPy_MPZ_Function_Discrete_Log(PyObject *self, PyObject *args, PyObject *keywds);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
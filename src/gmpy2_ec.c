@@ -0,0 +1,1135 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_ec.c                                                              *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/* Elliptic curve arithmetic.
+ *
+ * The formulas are those of the Explicit-Formulas Database for Jacobian
+ * coordinates ("dbl-2007-bl" and "add-2007-bl", with the usual shortcuts
+ * for a = 0, a = -3, and an addend with Z = 1). A scalar k is recoded
+ * in width-w NAF form, whose nonzero digits are odd, below 2**(w-1) in
+ * absolute value, and at least w positions apart; the odd multiples
+ * P, 3P, ..., (2**(w-1)-1)P are computed once and converted to Z = 1 with
+ * a single inversion. Results are converted back to affine coordinates
+ * the same way, one inversion for a whole batch.
+ *
+ * None of this is constant-time.
+ */
+
+static void
+_GMPy_EC_Ctx_Init(gmpy_ec_ctx *c, const EC_Object *E)
+{
+    int i;
+
+    c->E = E;
+    for (i = 0; i < GMPY_EC_TEMPS; i++)
+        mpz_init(c->t[i]);
+}
+
+static void
+_GMPy_EC_Ctx_Clear(gmpy_ec_ctx *c)
+{
+    int i;
+
+    for (i = 0; i < GMPY_EC_TEMPS; i++)
+        mpz_clear(c->t[i]);
+}
+
+static void
+_GMPy_EC_Point_Init(gmpy_ec_point *P)
+{
+    mpz_init(P->X);
+    mpz_init(P->Y);
+    mpz_init(P->Z);
+}
+
+static void
+_GMPy_EC_Point_Clear(gmpy_ec_point *P)
+{
+    mpz_clear(P->X);
+    mpz_clear(P->Y);
+    mpz_clear(P->Z);
+}
+
+static void
+_GMPy_EC_Point_Set(gmpy_ec_point *R, const gmpy_ec_point *P)
+{
+    mpz_set(R->X, P->X);
+    mpz_set(R->Y, P->Y);
+    mpz_set(R->Z, P->Z);
+}
+
+/* Field arithmetic. Operands are in [0, p); t[10] and t[11] are used by
+ * _GMPy_EC_FMul() only.
+ */
+
+static void
+_GMPy_EC_FMul(gmpy_ec_ctx *c, mpz_ptr r, mpz_srcptr x, mpz_srcptr y)
+{
+    mpz_mul(c->t[10], x, y);
+    _GMPy_Modulus_Mod(&c->E->form, r, c->t[10], c->t[11]);
+}
+
+/* Reduce r, a small multiple of p away from [0, p). */
+
+static void
+_GMPy_EC_FNorm(gmpy_ec_ctx *c, mpz_ptr r)
+{
+    while (mpz_sgn(r) < 0)
+        mpz_add(r, r, c->E->p);
+    while (mpz_cmp(r, c->E->p) >= 0)
+        mpz_sub(r, r, c->E->p);
+}
+
+static void
+_GMPy_EC_FSub(gmpy_ec_ctx *c, mpz_ptr r, mpz_srcptr x, mpz_srcptr y)
+{
+    mpz_sub(r, x, y);
+    if (mpz_sgn(r) < 0)
+        mpz_add(r, r, c->E->p);
+}
+
+static void
+_GMPy_EC_FAdd(gmpy_ec_ctx *c, mpz_ptr r, mpz_srcptr x, mpz_srcptr y)
+{
+    mpz_add(r, x, y);
+    if (mpz_cmp(r, c->E->p) >= 0)
+        mpz_sub(r, r, c->E->p);
+}
+
+static void
+_GMPy_EC_FNeg(gmpy_ec_ctx *c, mpz_ptr r)
+{
+    if (mpz_sgn(r))
+        mpz_sub(r, c->E->p, r);
+}
+
+/* Set R to 2*P. R may be P. Uses t[0] to t[7]. */
+
+static void
+_GMPy_EC_Double(gmpy_ec_ctx *c, gmpy_ec_point *R, const gmpy_ec_point *P)
+{
+    mpz_ptr XX = c->t[0], YY = c->t[1], YYYY = c->t[2], S = c->t[3];
+    mpz_ptr M = c->t[4], ZZ = c->t[5], X3 = c->t[6], Z3 = c->t[7];
+
+    if (!mpz_sgn(P->Z) || !mpz_sgn(P->Y)) {
+        mpz_set_ui(R->Z, 0);
+        return;
+    }
+
+    _GMPy_EC_FMul(c, XX, P->X, P->X);
+    _GMPy_EC_FMul(c, YY, P->Y, P->Y);
+    _GMPy_EC_FMul(c, YYYY, YY, YY);
+    _GMPy_EC_FMul(c, S, P->X, YY);
+    mpz_mul_2exp(S, S, 2);
+    _GMPy_EC_FNorm(c, S);
+
+    /* M = 3*X**2 + a*Z**4 */
+
+    switch (c->E->a_kind) {
+    case GMPY_EC_A_ZERO:
+        mpz_mul_ui(M, XX, 3);
+        break;
+    case GMPY_EC_A_MINUS3:
+        _GMPy_EC_FMul(c, ZZ, P->Z, P->Z);
+        _GMPy_EC_FSub(c, M, P->X, ZZ);
+        _GMPy_EC_FAdd(c, ZZ, P->X, ZZ);
+        _GMPy_EC_FMul(c, M, M, ZZ);
+        mpz_mul_ui(M, M, 3);
+        break;
+    default:
+        _GMPy_EC_FMul(c, ZZ, P->Z, P->Z);
+        _GMPy_EC_FMul(c, ZZ, ZZ, ZZ);
+        _GMPy_EC_FMul(c, ZZ, ZZ, c->E->a);
+        mpz_mul_ui(M, XX, 3);
+        mpz_add(M, M, ZZ);
+        break;
+    }
+    _GMPy_EC_FNorm(c, M);
+
+    _GMPy_EC_FMul(c, Z3, P->Y, P->Z);
+    _GMPy_EC_FAdd(c, Z3, Z3, Z3);
+    _GMPy_EC_FMul(c, X3, M, M);
+    _GMPy_EC_FSub(c, X3, X3, S);
+    _GMPy_EC_FSub(c, X3, X3, S);
+    _GMPy_EC_FSub(c, S, S, X3);
+    _GMPy_EC_FMul(c, S, M, S);
+    mpz_mul_2exp(YYYY, YYYY, 3);
+    _GMPy_EC_FNorm(c, YYYY);
+    _GMPy_EC_FSub(c, R->Y, S, YYYY);
+    mpz_swap(R->X, X3);
+    mpz_swap(R->Z, Z3);
+}
+
+/* Set R to P + Q, or to P - Q if negq is set. R may be P or Q. Uses t[0]
+ * to t[9].
+ */
+
+static void
+_GMPy_EC_Add(gmpy_ec_ctx *c, gmpy_ec_point *R, const gmpy_ec_point *P,
+             const gmpy_ec_point *Q, int negq)
+{
+    mpz_ptr Z1Z1 = c->t[0], H = c->t[1], r = c->t[2], Z2Z2 = c->t[3];
+    mpz_ptr U1t = c->t[4], S1t = c->t[5], V = c->t[6], X3 = c->t[7];
+    mpz_ptr Y3 = c->t[8], Z3 = c->t[9];
+    mpz_srcptr U1, S1;
+    int affine = mpz_cmp_ui(Q->Z, 1) == 0;
+
+    if (!mpz_sgn(P->Z)) {
+        if (R != Q)
+            _GMPy_EC_Point_Set(R, Q);
+        if (negq)
+            _GMPy_EC_FNeg(c, R->Y);
+        return;
+    }
+    if (!mpz_sgn(Q->Z)) {
+        if (R != P)
+            _GMPy_EC_Point_Set(R, P);
+        return;
+    }
+
+    _GMPy_EC_FMul(c, Z1Z1, P->Z, P->Z);
+    _GMPy_EC_FMul(c, H, Q->X, Z1Z1);
+    _GMPy_EC_FMul(c, r, Q->Y, P->Z);
+    _GMPy_EC_FMul(c, r, r, Z1Z1);
+    if (negq)
+        _GMPy_EC_FNeg(c, r);
+    if (affine) {
+        U1 = P->X;
+        S1 = P->Y;
+    }
+    else {
+        _GMPy_EC_FMul(c, Z2Z2, Q->Z, Q->Z);
+        _GMPy_EC_FMul(c, U1t, P->X, Z2Z2);
+        _GMPy_EC_FMul(c, S1t, P->Y, Q->Z);
+        _GMPy_EC_FMul(c, S1t, S1t, Z2Z2);
+        U1 = U1t;
+        S1 = S1t;
+    }
+    _GMPy_EC_FSub(c, H, H, U1);
+    _GMPy_EC_FSub(c, r, r, S1);
+
+    if (!mpz_sgn(H)) {
+        if (!mpz_sgn(r))
+            _GMPy_EC_Double(c, R, P);
+        else
+            mpz_set_ui(R->Z, 0);
+        return;
+    }
+
+    if (affine) {
+        _GMPy_EC_FMul(c, Z3, P->Z, H);
+    }
+    else {
+        _GMPy_EC_FMul(c, Z3, P->Z, Q->Z);
+        _GMPy_EC_FMul(c, Z3, Z3, H);
+    }
+    _GMPy_EC_FMul(c, Z1Z1, H, H);
+    _GMPy_EC_FMul(c, Z2Z2, H, Z1Z1);
+    _GMPy_EC_FMul(c, V, U1, Z1Z1);
+    _GMPy_EC_FMul(c, X3, r, r);
+    _GMPy_EC_FSub(c, X3, X3, Z2Z2);
+    _GMPy_EC_FSub(c, X3, X3, V);
+    _GMPy_EC_FSub(c, X3, X3, V);
+    _GMPy_EC_FSub(c, V, V, X3);
+    _GMPy_EC_FMul(c, Y3, r, V);
+    _GMPy_EC_FMul(c, V, S1, Z2Z2);
+    _GMPy_EC_FSub(c, Y3, Y3, V);
+    mpz_swap(R->X, X3);
+    mpz_swap(R->Y, Y3);
+    mpz_swap(R->Z, Z3);
+}
+
+/* Convert the n points P to Z = 1, leaving the points at infinity, with
+ * one inversion. acc holds n initialized values. Uses t[0] to t[2].
+ */
+
+static void
+_GMPy_EC_Normalize(gmpy_ec_ctx *c, gmpy_ec_point *P, Py_ssize_t n, mpz_t *acc)
+{
+    mpz_ptr inv = c->t[0], zi = c->t[1], zz = c->t[2];
+    Py_ssize_t i;
+
+    mpz_set_ui(inv, 1);
+    for (i = 0; i < n; i++) {
+        if (mpz_sgn(P[i].Z))
+            _GMPy_EC_FMul(c, inv, inv, P[i].Z);
+        mpz_set(acc[i], inv);
+    }
+    if (mpz_cmp_ui(inv, 1) != 0)
+        mpz_invert(inv, inv, c->E->p);
+
+    for (i = n - 1; i >= 0; i--) {
+        if (!mpz_sgn(P[i].Z) || !mpz_cmp_ui(P[i].Z, 1))
+            continue;
+        if (i > 0)
+            _GMPy_EC_FMul(c, zi, inv, acc[i - 1]);
+        else
+            mpz_set(zi, inv);
+        _GMPy_EC_FMul(c, inv, inv, P[i].Z);
+        _GMPy_EC_FMul(c, zz, zi, zi);
+        _GMPy_EC_FMul(c, P[i].X, P[i].X, zz);
+        _GMPy_EC_FMul(c, zz, zz, zi);
+        _GMPy_EC_FMul(c, P[i].Y, P[i].Y, zz);
+        mpz_set_ui(P[i].Z, 1);
+    }
+}
+
+/* Width of the NAF for a scalar of the given size. The table of odd
+ * multiples has 2**(w-2) points.
+ */
+
+#define GMPY_EC_MAX_WINDOW 6
+
+static int
+_GMPy_EC_Window(size_t bits)
+{
+    if (bits <= 24)
+        return 2;
+    if (bits <= 64)
+        return 3;
+    if (bits <= 160)
+        return 4;
+    if (bits <= 512)
+        return 5;
+    return GMPY_EC_MAX_WINDOW;
+}
+
+/* Set d to the width-w NAF of abs(k), least significant digit first, and
+ * return the number of digits. d holds bits(k) + 1 digits.
+ */
+
+static size_t
+_GMPy_EC_WNAF(signed char *d, mpz_srcptr k, int w, mpz_ptr t)
+{
+    unsigned long mask = (1UL << w) - 1;
+    long digit;
+    size_t n = 0;
+
+    mpz_abs(t, k);
+    while (mpz_sgn(t)) {
+        digit = 0;
+        if (mpz_odd_p(t)) {
+            digit = (long)(mpz_get_ui(t) & mask);
+            if (digit >= (1L << (w - 1)))
+                digit -= 1L << w;
+            if (digit > 0)
+                mpz_sub_ui(t, t, (unsigned long)digit);
+            else
+                mpz_add_ui(t, t, (unsigned long)-digit);
+        }
+        d[n++] = (signed char)digit;
+        mpz_tdiv_q_2exp(t, t, 1);
+    }
+    return n;
+}
+
+/* Set T to P, 3P, ..., (2**(w-1)-1)P with Z = 1. T and acc hold
+ * 2**(w-2) values. Uses R as scratch.
+ */
+
+static void
+_GMPy_EC_Table(gmpy_ec_ctx *c, gmpy_ec_point *T, int w, const gmpy_ec_point *P,
+               gmpy_ec_point *R, mpz_t *acc)
+{
+    Py_ssize_t i, size = (Py_ssize_t)1 << (w - 2);
+
+    _GMPy_EC_Point_Set(&T[0], P);
+    if (size > 1) {
+        _GMPy_EC_Double(c, R, P);
+        for (i = 1; i < size; i++)
+            _GMPy_EC_Add(c, &T[i], &T[i - 1], R, 0);
+    }
+    _GMPy_EC_Normalize(c, T, size, acc);
+}
+
+/* Set R to sum(k[i] * P[i]) for n <= 2 scalars, with T[i] the table of
+ * P[i] for window w[i] and d[i] space for the digits. R must not be in
+ * the tables.
+ */
+
+static void
+_GMPy_EC_Mul_Tables(gmpy_ec_ctx *c, gmpy_ec_point *R, int n, mpz_srcptr *k,
+                    gmpy_ec_point **T, const int *w, signed char **d,
+                    mpz_ptr t)
+{
+    size_t len[2], top = 0, j;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        len[i] = _GMPy_EC_WNAF(d[i], k[i], w[i], t);
+        if (len[i] > top)
+            top = len[i];
+    }
+
+    mpz_set_ui(R->Z, 0);
+    for (j = top; j-- > 0; ) {
+        _GMPy_EC_Double(c, R, R);
+        for (i = 0; i < n; i++) {
+            if (j >= len[i] || !d[i][j])
+                continue;
+
+            /* -P is added as P with a negated sign if k < 0. */
+
+            if ((d[i][j] > 0) != (mpz_sgn(k[i]) < 0))
+                _GMPy_EC_Add(c, R, R, &T[i][abs(d[i][j]) >> 1], 0);
+            else
+                _GMPy_EC_Add(c, R, R, &T[i][abs(d[i][j]) >> 1], 1);
+        }
+    }
+}
+
+/* Per-thread space for scalar multiplications: the tables of up to two
+ * points, a result, and the wNAF digits.
+ */
+
+#define GMPY_EC_TABLE (1 << (GMPY_EC_MAX_WINDOW - 2))
+
+typedef struct {
+    gmpy_ec_ctx c;
+    gmpy_ec_point T[2][GMPY_EC_TABLE];
+    gmpy_ec_point R;
+    mpz_t acc[GMPY_EC_TABLE];
+    signed char *d[2];
+    size_t dsize;
+} gmpy_ec_scratch;
+
+static void
+_GMPy_EC_Scratch_Init(gmpy_ec_scratch *s, const EC_Object *E)
+{
+    int i, j;
+
+    _GMPy_EC_Ctx_Init(&s->c, E);
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < GMPY_EC_TABLE; j++)
+            _GMPy_EC_Point_Init(&s->T[i][j]);
+        s->d[i] = NULL;
+    }
+    for (j = 0; j < GMPY_EC_TABLE; j++)
+        mpz_init(s->acc[j]);
+    _GMPy_EC_Point_Init(&s->R);
+    s->dsize = 0;
+}
+
+static void
+_GMPy_EC_Scratch_Clear(gmpy_ec_scratch *s)
+{
+    int i, j;
+
+    _GMPy_EC_Ctx_Clear(&s->c);
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < GMPY_EC_TABLE; j++)
+            _GMPy_EC_Point_Clear(&s->T[i][j]);
+        PyMem_RawFree(s->d[i]);
+    }
+    for (j = 0; j < GMPY_EC_TABLE; j++)
+        mpz_clear(s->acc[j]);
+    _GMPy_EC_Point_Clear(&s->R);
+}
+
+/* Make room for the digits of a scalar of the given size. Returns -1 if
+ * out of memory. Does not use the Python API.
+ */
+
+static int
+_GMPy_EC_Scratch_Digits(gmpy_ec_scratch *s, size_t bits)
+{
+    signed char *d;
+    int i;
+
+    if (bits + 1 <= s->dsize)
+        return 0;
+    for (i = 0; i < 2; i++) {
+        if (!(d = PyMem_RawRealloc(s->d[i], bits + 1)))
+            return -1;
+        s->d[i] = d;
+    }
+    s->dsize = bits + 1;
+    return 0;
+}
+
+/* Set R to k*P + l*Q, or to k*P if Q is NULL. P and Q have Z = 0 or 1.
+ * R is not normalized. Returns -1 if out of memory.
+ */
+
+static int
+_GMPy_EC_Mul(gmpy_ec_scratch *s, gmpy_ec_point *R, mpz_srcptr k,
+             const gmpy_ec_point *P, mpz_srcptr l, const gmpy_ec_point *Q)
+{
+    mpz_srcptr ks[2];
+    gmpy_ec_point *T[2];
+    int w[2], n = 0;
+    size_t bits;
+
+    if (mpz_sgn(k) && mpz_sgn(P->Z)) {
+        ks[n] = k;
+        w[n] = _GMPy_EC_Window(mpz_sizeinbase(k, 2));
+        _GMPy_EC_Table(&s->c, s->T[n], w[n], P, &s->R, s->acc);
+        n++;
+    }
+    if (Q && mpz_sgn(l) && mpz_sgn(Q->Z)) {
+        ks[n] = l;
+        w[n] = _GMPy_EC_Window(mpz_sizeinbase(l, 2));
+        _GMPy_EC_Table(&s->c, s->T[n], w[n], Q, &s->R, s->acc);
+        n++;
+    }
+
+    bits = mpz_sizeinbase(k, 2);
+    if (Q && mpz_sizeinbase(l, 2) > bits)
+        bits = mpz_sizeinbase(l, 2);
+    if (_GMPy_EC_Scratch_Digits(s, bits) < 0)
+        return -1;
+
+    T[0] = s->T[0];
+    T[1] = s->T[1];
+    _GMPy_EC_Mul_Tables(&s->c, R, n, ks, T, w, s->d, s->c.t[0]);
+    return 0;
+}
+
+/* Multiply a batch of points. Each range uses its own scratch space; the
+ * results are normalized together afterwards.
+ */
+
+typedef struct {
+    const EC_Object *E;
+    mpz_srcptr *k;
+    const gmpy_ec_point *P;     /* one point per scalar, or NULL */
+    gmpy_ec_point *T;           /* table of the common point, or NULL */
+    int w;                      /* window of T */
+    gmpy_ec_point *out;
+    volatile int failed;        /* out of memory */
+} gmpy_ec_batch;
+
+static void
+_GMPy_EC_Mul_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_ec_batch *work = (gmpy_ec_batch*)arg;
+    gmpy_ec_scratch s;
+    Py_ssize_t i;
+
+    _GMPy_EC_Scratch_Init(&s, work->E);
+    for (i = start; i < stop && !work->failed; i++) {
+        if (GMPy_Interrupt_Poll())
+            break;
+        if (work->T) {
+            if (_GMPy_EC_Scratch_Digits(&s, mpz_sizeinbase(work->k[i], 2)) < 0) {
+                work->failed = 1;
+                break;
+            }
+            _GMPy_EC_Mul_Tables(&s.c, &work->out[i], 1, &work->k[i], &work->T,
+                                &work->w, s.d, s.c.t[0]);
+        }
+        else if (_GMPy_EC_Mul(&s, &work->out[i], work->k[i], &work->P[i],
+                              NULL, NULL) < 0) {
+            work->failed = 1;
+            break;
+        }
+    }
+    _GMPy_EC_Scratch_Clear(&s);
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_curve,
+"Curve(p, a, b, /)\n\n"
+"The elliptic curve y**2 = x**3 + a*x + b over the integers modulo the\n"
+"prime p > 3. Points are pairs (x, y) of integers, whose coordinates are\n"
+"reduced modulo p, and None is the point at infinity. Results are tuples\n"
+"of two mpz.\n\n"
+"The arithmetic is not constant-time: the running time depends on the\n"
+"scalars, so it must not be used with secret keys.");
+
+static PyObject *
+GMPy_EC_Curve_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "", "", NULL};
+    PyObject *pobj, *aobj, *bobj;
+    MPZ_Object *p = NULL, *a = NULL, *b = NULL;
+    EC_Object *result = NULL;
+    mpz_t t, u;
+    CTXT_Object *context = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OOO", kwlist, &pobj,
+                                     &aobj, &bobj))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_INTEGER(pobj) || !IS_INTEGER(aobj) || !IS_INTEGER(bobj)) {
+        TYPE_ERROR("Curve() requires integer arguments");
+        return NULL;
+    }
+
+    if (!(p = GMPy_MPZ_From_Integer(pobj, context)) ||
+        !(a = GMPy_MPZ_From_Integer(aobj, context)) ||
+        !(b = GMPy_MPZ_From_Integer(bobj, context)))
+        goto done;
+
+    if (mpz_cmp_ui(p->z, 3) <= 0 || !_GMPy_MPZ_IsPrime(p->z, 25)) {
+        VALUE_ERROR("Curve() 'p' must be a prime > 3");
+        goto done;
+    }
+
+    if (!(result = PyObject_New(EC_Object, &EC_Type)))
+        goto done;
+    mpz_init_set(result->p, p->z);
+    mpz_init(result->a);
+    mpz_init(result->b);
+    mpz_mod(result->a, a->z, result->p);
+    mpz_mod(result->b, b->z, result->p);
+    _GMPy_Modulus_Form_Init(&result->form, result->p);
+
+    result->a_kind = GMPY_EC_A_ANY;
+    if (!mpz_sgn(result->a)) {
+        result->a_kind = GMPY_EC_A_ZERO;
+    }
+    else {
+        mpz_init(t);
+        mpz_add_ui(t, result->a, 3);
+        if (!mpz_cmp(t, result->p))
+            result->a_kind = GMPY_EC_A_MINUS3;
+        mpz_clear(t);
+    }
+
+    /* The curve is singular if 4*a**3 + 27*b**2 = 0 (mod p). */
+
+    mpz_init(t);
+    mpz_init(u);
+    mpz_powm_ui(t, result->a, 3, result->p);
+    mpz_mul_ui(t, t, 4);
+    mpz_mul(u, result->b, result->b);
+    mpz_addmul_ui(t, u, 27);
+    mpz_mod(t, t, result->p);
+    if (!mpz_sgn(t)) {
+        VALUE_ERROR("Curve() is singular: 4*a**3 + 27*b**2 = 0 (mod p)");
+        Py_CLEAR(result);
+    }
+    mpz_clear(t);
+    mpz_clear(u);
+
+  done:
+    Py_XDECREF((PyObject*)p);
+    Py_XDECREF((PyObject*)a);
+    Py_XDECREF((PyObject*)b);
+    return (PyObject*)result;
+}
+
+static void
+GMPy_EC_Curve_Dealloc(EC_Object *self)
+{
+    mpz_clear(self->p);
+    mpz_clear(self->a);
+    mpz_clear(self->b);
+    PyObject_Free(self);
+}
+
+static PyObject *
+_GMPy_EC_Get(mpz_srcptr x)
+{
+    MPZ_Object *result;
+
+    if ((result = GMPy_MPZ_New(NULL)))
+        mpz_set(result->z, x);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_EC_Curve_GetP(EC_Object *self, void *closure)
+{
+    return _GMPy_EC_Get(self->p);
+}
+
+static PyObject *
+GMPy_EC_Curve_GetA(EC_Object *self, void *closure)
+{
+    return _GMPy_EC_Get(self->a);
+}
+
+static PyObject *
+GMPy_EC_Curve_GetB(EC_Object *self, void *closure)
+{
+    return _GMPy_EC_Get(self->b);
+}
+
+static PyObject *
+GMPy_EC_Curve_Repr_Slot(EC_Object *self)
+{
+    PyObject *p = NULL, *a = NULL, *b = NULL, *result = NULL;
+
+    if ((p = GMPy_EC_Curve_GetP(self, NULL)) &&
+        (a = GMPy_EC_Curve_GetA(self, NULL)) &&
+        (b = GMPy_EC_Curve_GetB(self, NULL)))
+        result = PyUnicode_FromFormat("gmpy2.ec.Curve(%S, %S, %S)", p, a, b);
+    Py_XDECREF(p);
+    Py_XDECREF(a);
+    Py_XDECREF(b);
+    return result;
+}
+
+/* Return 1 if obj has the form of a point other than None: a tuple or list
+ * of two integers.
+ */
+
+static int
+_GMPy_EC_Is_Pair(PyObject *obj)
+{
+    PyObject **items;
+
+    if (PyTuple_Check(obj) && PyTuple_GET_SIZE(obj) == 2)
+        items = &PyTuple_GET_ITEM(obj, 0);
+    else if (PyList_Check(obj) && PyList_GET_SIZE(obj) == 2)
+        items = &PyList_GET_ITEM(obj, 0);
+    else
+        return 0;
+    return IS_INTEGER(items[0]) && IS_INTEGER(items[1]);
+}
+
+static int
+_GMPy_EC_On_Curve(gmpy_ec_ctx *c, mpz_srcptr x, mpz_srcptr y)
+{
+    mpz_ptr u = c->t[0], v = c->t[1];
+
+    _GMPy_EC_FMul(c, u, x, x);
+    _GMPy_EC_FAdd(c, u, u, c->E->a);
+    _GMPy_EC_FMul(c, u, u, x);
+    _GMPy_EC_FAdd(c, u, u, c->E->b);
+    _GMPy_EC_FMul(c, v, y, y);
+    return mpz_cmp(u, v) == 0;
+}
+
+/* Set P to the point obj with Z = 1, or Z = 0 for None. Returns -1 with an
+ * exception set if obj is not a point or not on the curve.
+ */
+
+static int
+_GMPy_EC_Point_From(gmpy_ec_ctx *c, gmpy_ec_point *P, PyObject *obj,
+                    const char *name, CTXT_Object *context)
+{
+    MPZ_Object *x, *y;
+
+    if (obj == Py_None) {
+        mpz_set_ui(P->Z, 0);
+        return 0;
+    }
+    if (!_GMPy_EC_Is_Pair(obj)) {
+        PyErr_Format(PyExc_TypeError,
+                     "Curve.%s() points must be None or pairs of integers", name);
+        return -1;
+    }
+    if (!(x = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(obj, 0), context)))
+        return -1;
+    if (!(y = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(obj, 1), context))) {
+        Py_DECREF((PyObject*)x);
+        return -1;
+    }
+    mpz_mod(P->X, x->z, c->E->p);
+    mpz_mod(P->Y, y->z, c->E->p);
+    mpz_set_ui(P->Z, 1);
+    Py_DECREF((PyObject*)x);
+    Py_DECREF((PyObject*)y);
+
+    if (!_GMPy_EC_On_Curve(c, P->X, P->Y)) {
+        PyErr_Format(PyExc_ValueError, "Curve.%s() point is not on the curve", name);
+        return -1;
+    }
+    return 0;
+}
+
+/* Return the point P, which has Z = 0 or 1. */
+
+static PyObject *
+_GMPy_EC_Point_To(const gmpy_ec_point *P)
+{
+    PyObject *result;
+    MPZ_Object *x = NULL, *y = NULL;
+
+    if (!mpz_sgn(P->Z))
+        Py_RETURN_NONE;
+
+    if (!(result = PyTuple_New(2)) ||
+        !(x = GMPy_MPZ_New(NULL)) ||
+        !(y = GMPy_MPZ_New(NULL))) {
+
+        /* LCOV_EXCL_START */
+        Py_XDECREF(result);
+        Py_XDECREF((PyObject*)x);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    mpz_set(x->z, P->X);
+    mpz_set(y->z, P->Y);
+    PyTuple_SET_ITEM(result, 0, (PyObject*)x);
+    PyTuple_SET_ITEM(result, 1, (PyObject*)y);
+    return result;
+}
+
+static MPZ_Object *
+_GMPy_EC_Scalar(PyObject *obj, const char *name, CTXT_Object *context)
+{
+    if (!IS_INTEGER(obj)) {
+        PyErr_Format(PyExc_TypeError, "Curve.%s() scalars must be integers", name);
+        return NULL;
+    }
+    return GMPy_MPZ_From_Integer(obj, context);
+}
+
+static int
+_GMPy_EC_Args(Py_ssize_t nargs, Py_ssize_t expected, const char *name)
+{
+    if (nargs != expected) {
+        PyErr_Format(PyExc_TypeError, "Curve.%s() requires %zd arguments",
+                     name, expected);
+        return -1;
+    }
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_curve_is_on_curve,
+"E.is_on_curve(P, /) -> bool\n\n"
+"Return True if P is None or a pair (x, y) with\n"
+"y**2 = x**3 + a*x + b (mod p).");
+
+static PyObject *
+GMPy_EC_Curve_Is_On_Curve(EC_Object *self, PyObject *other)
+{
+    gmpy_ec_scratch s;
+    PyObject *result;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (other == Py_None)
+        Py_RETURN_TRUE;
+    if (!_GMPy_EC_Is_Pair(other)) {
+        TYPE_ERROR("Curve.is_on_curve() requires None or a pair of integers");
+        return NULL;
+    }
+
+    _GMPy_EC_Scratch_Init(&s, self);
+    result = Py_False;
+    if (_GMPy_EC_Point_From(&s.c, &s.R, other, "is_on_curve", context) < 0) {
+        if (!PyErr_ExceptionMatches(PyExc_ValueError))
+            result = NULL;
+        else
+            PyErr_Clear();
+    }
+    else {
+        result = Py_True;
+    }
+    _GMPy_EC_Scratch_Clear(&s);
+    Py_XINCREF(result);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_curve_neg,
+"E.neg(P, /) -> tuple[mpz, mpz] | None\n\n"
+"Return -P.");
+
+static PyObject *
+GMPy_EC_Curve_Neg(EC_Object *self, PyObject *other)
+{
+    gmpy_ec_scratch s;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    _GMPy_EC_Scratch_Init(&s, self);
+    if (_GMPy_EC_Point_From(&s.c, &s.R, other, "neg", context) == 0) {
+        _GMPy_EC_FNeg(&s.c, s.R.Y);
+        result = _GMPy_EC_Point_To(&s.R);
+    }
+    _GMPy_EC_Scratch_Clear(&s);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_curve_add,
+"E.add(P, Q, /) -> tuple[mpz, mpz] | None\n\n"
+"Return P + Q.");
+
+static PyObject *
+GMPy_EC_Curve_Add(EC_Object *self, PyObject * const *args, Py_ssize_t nargs)
+{
+    gmpy_ec_scratch s;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_EC_Args(nargs, 2, "add") < 0)
+        return NULL;
+
+    _GMPy_EC_Scratch_Init(&s, self);
+    if (_GMPy_EC_Point_From(&s.c, &s.T[0][0], args[0], "add", context) == 0 &&
+        _GMPy_EC_Point_From(&s.c, &s.T[1][0], args[1], "add", context) == 0) {
+        _GMPy_EC_Add(&s.c, &s.R, &s.T[0][0], &s.T[1][0], 0);
+        _GMPy_EC_Normalize(&s.c, &s.R, 1, s.acc);
+        result = _GMPy_EC_Point_To(&s.R);
+    }
+    _GMPy_EC_Scratch_Clear(&s);
+    return result;
+}
+
+/* Return k*P + l*Q; lobj and Qobj are NULL for k*P. */
+
+static PyObject *
+_GMPy_EC_Mul_Call(EC_Object *self, PyObject *kobj, PyObject *Pobj,
+                  PyObject *lobj, PyObject *Qobj, const char *name)
+{
+    gmpy_ec_scratch s;
+    MPZ_Object *k = NULL, *l = NULL;
+    PyObject *result = NULL;
+    size_t bits;
+    int ret;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(k = _GMPy_EC_Scalar(kobj, name, context)) ||
+        (lobj && !(l = _GMPy_EC_Scalar(lobj, name, context)))) {
+        Py_XDECREF((PyObject*)k);
+        return NULL;
+    }
+
+    _GMPy_EC_Scratch_Init(&s, self);
+    if (_GMPy_EC_Point_From(&s.c, &s.T[0][0], Pobj, name, context) < 0 ||
+        (Qobj && _GMPy_EC_Point_From(&s.c, &s.T[1][0], Qobj, name, context) < 0))
+        goto done;
+
+    /* The tables are built in s.T, so the points are moved out of it. */
+
+    _GMPy_EC_Point_Set(&s.T[0][GMPY_EC_TABLE - 1], &s.T[0][0]);
+    if (Qobj)
+        _GMPy_EC_Point_Set(&s.T[1][GMPY_EC_TABLE - 1], &s.T[1][0]);
+
+    bits = mpz_sizeinbase(k->z, 2);
+    if (l && mpz_sizeinbase(l->z, 2) > bits)
+        bits = mpz_sizeinbase(l->z, 2);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits * GMPY_MPZ_BITS(self->p));
+    ret = _GMPy_EC_Mul(&s, &s.R, k->z, &s.T[0][GMPY_EC_TABLE - 1],
+                       l ? l->z : NULL, Qobj ? &s.T[1][GMPY_EC_TABLE - 1] : NULL);
+    if (ret == 0)
+        _GMPy_EC_Normalize(&s.c, &s.R, 1, s.acc);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (ret < 0)
+        PyErr_NoMemory();
+    else
+        result = _GMPy_EC_Point_To(&s.R);
+
+  done:
+    _GMPy_EC_Scratch_Clear(&s);
+    Py_DECREF((PyObject*)k);
+    Py_XDECREF((PyObject*)l);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_curve_mul,
+"E.mul(k, P, /) -> tuple[mpz, mpz] | None\n\n"
+"Return k*P for an integer k, which may be negative.");
+
+static PyObject *
+GMPy_EC_Curve_Mul(EC_Object *self, PyObject * const *args, Py_ssize_t nargs)
+{
+    if (_GMPy_EC_Args(nargs, 2, "mul") < 0)
+        return NULL;
+    return _GMPy_EC_Mul_Call(self, args[0], args[1], NULL, NULL, "mul");
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_curve_mul_add,
+"E.mul_add(k, P, l, Q, /) -> tuple[mpz, mpz] | None\n\n"
+"Return k*P + l*Q. The two multiplications share their doublings, which\n"
+"makes this faster than two calls to mul(), for example to verify a\n"
+"signature.");
+
+static PyObject *
+GMPy_EC_Curve_Mul_Add(EC_Object *self, PyObject * const *args, Py_ssize_t nargs)
+{
+    if (_GMPy_EC_Args(nargs, 4, "mul_add") < 0)
+        return NULL;
+    return _GMPy_EC_Mul_Call(self, args[0], args[1], args[2], args[3], "mul_add");
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_curve_mul_many,
+"E.mul_many(scalars, points, /) -> list[tuple[mpz, mpz] | None]\n\n"
+"Return [k*P for k, P in zip(scalars, points)]. scalars is a sequence of\n"
+"integers or an `mpz_array`; points is a sequence of points of the same\n"
+"length, or a single point that is multiplied by every scalar. The\n"
+"multiplications are split over the context's threads and the results\n"
+"share a single modular inversion.");
+
+static PyObject *
+GMPy_EC_Curve_Mul_Many(EC_Object *self, PyObject * const *args, Py_ssize_t nargs)
+{
+    gmpy_ec_scratch s;
+    gmpy_rational_view view;
+    gmpy_ec_batch work;
+    gmpy_interrupt intr;
+    gmpy_ec_point *pts = NULL, *out = NULL;
+    mpz_t *acc = NULL;
+    PyObject *seq = NULL, *result = NULL, *temp;
+    Py_ssize_t i, npts = 0, nout = 0, nacc = 0;
+    size_t bits = 0;
+    int single;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_EC_Args(nargs, 2, "mul_many") < 0)
+        return NULL;
+
+    if (_GMPy_View_Init(&view, args[0], "Curve.mul_many", context) < 0)
+        return NULL;
+    _GMPy_EC_Scratch_Init(&s, self);
+
+    if (view.rational) {
+        TYPE_ERROR("Curve.mul_many() scalars must be integers");
+        goto done;
+    }
+
+    single = args[1] == Py_None || _GMPy_EC_Is_Pair(args[1]);
+    if (!single) {
+        if (!(seq = PySequence_Fast(args[1], "Curve.mul_many() requires a point or a sequence of points")))
+            goto done;
+        if (PySequence_Fast_GET_SIZE(seq) != view.n) {
+            VALUE_ERROR("Curve.mul_many() requires as many points as scalars");
+            goto done;
+        }
+    }
+
+    if (!(out = PyMem_New(gmpy_ec_point, view.n ? view.n : 1)) ||
+        !(acc = PyMem_New(mpz_t, view.n ? view.n : 1)) ||
+        (!single && !(pts = PyMem_New(gmpy_ec_point, view.n ? view.n : 1)))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (; nout < view.n; nout++)
+        _GMPy_EC_Point_Init(&out[nout]);
+    for (; nacc < view.n; nacc++)
+        mpz_init(acc[nacc]);
+
+    for (i = 0; i < view.n; i++) {
+        if (mpz_sizeinbase(view.num[i], 2) > bits)
+            bits = mpz_sizeinbase(view.num[i], 2);
+    }
+
+    memset(&work, 0, sizeof(gmpy_ec_batch));
+    work.E = self;
+    work.k = view.num;
+    work.out = out;
+    if (single) {
+        if (_GMPy_EC_Point_From(&s.c, &s.R, args[1], "mul_many", context) < 0)
+            goto done;
+
+        /* The table is shared, so it is worth a wider window. */
+
+        work.w = view.n > 1 ? GMPY_EC_MAX_WINDOW : _GMPy_EC_Window(bits);
+        work.T = s.T[0];
+        _GMPy_EC_Table(&s.c, s.T[0], work.w, &s.R, &s.T[1][0], s.acc);
+    }
+    else {
+        for (; npts < view.n; npts++) {
+            _GMPy_EC_Point_Init(&pts[npts]);
+            if (_GMPy_EC_Point_From(&s.c, &pts[npts], PySequence_Fast_GET_ITEM(seq, npts),
+                                    "mul_many", context) < 0) {
+                npts++;
+                goto done;
+            }
+        }
+        work.P = pts;
+    }
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits * GMPY_MPZ_BITS(self->p) * view.n);
+    intr.save = &_save;
+    GMPy_Parallel_Run(_GMPy_EC_Mul_Range, &work, view.n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    if (!work.failed && !intr.stop)
+        _GMPy_EC_Normalize(&s.c, out, view.n, acc);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    if (GMPy_Interrupt_End(&intr) < 0)
+        goto done;
+    if (work.failed) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    if (!(result = PyList_New(view.n)))
+        goto done;
+    for (i = 0; i < view.n; i++) {
+        if (!(temp = _GMPy_EC_Point_To(&out[i]))) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, temp);
+    }
+
+  done:
+    for (i = 0; i < nout; i++)
+        _GMPy_EC_Point_Clear(&out[i]);
+    for (i = 0; i < npts; i++)
+        _GMPy_EC_Point_Clear(&pts[i]);
+    for (i = 0; i < nacc; i++)
+        mpz_clear(acc[i]);
+    PyMem_Free(out);
+    PyMem_Free(pts);
+    PyMem_Free(acc);
+    Py_XDECREF(seq);
+    _GMPy_EC_Scratch_Clear(&s);
+    _GMPy_View_Clear(&view);
+    return result;
+}
+
+static PyMethodDef GMPy_EC_Curve_methods[] =
+{
+    { "add", (PyCFunction)(void(*)(void))GMPy_EC_Curve_Add, METH_FASTCALL, GMPy_doc_ec_curve_add },
+    { "is_on_curve", (PyCFunction)GMPy_EC_Curve_Is_On_Curve, METH_O, GMPy_doc_ec_curve_is_on_curve },
+    { "mul", (PyCFunction)(void(*)(void))GMPy_EC_Curve_Mul, METH_FASTCALL, GMPy_doc_ec_curve_mul },
+    { "mul_add", (PyCFunction)(void(*)(void))GMPy_EC_Curve_Mul_Add, METH_FASTCALL, GMPy_doc_ec_curve_mul_add },
+    { "mul_many", (PyCFunction)(void(*)(void))GMPy_EC_Curve_Mul_Many, METH_FASTCALL, GMPy_doc_ec_curve_mul_many },
+    { "neg", (PyCFunction)GMPy_EC_Curve_Neg, METH_O, GMPy_doc_ec_curve_neg },
+    { NULL }
+};
+
+static PyGetSetDef GMPy_EC_Curve_getseters[] =
+{
+    { "a", (getter)GMPy_EC_Curve_GetA, NULL, "coefficient a", NULL },
+    { "b", (getter)GMPy_EC_Curve_GetB, NULL, "coefficient b", NULL },
+    { "p", (getter)GMPy_EC_Curve_GetP, NULL, "prime modulus", NULL },
+    { NULL }
+};
+
+static PyTypeObject EC_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.ec.Curve",
+    .tp_basicsize = sizeof(EC_Object),
+    .tp_dealloc = (destructor) GMPy_EC_Curve_Dealloc,
+    .tp_repr = (reprfunc) GMPy_EC_Curve_Repr_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_ec_curve,
+    .tp_methods = GMPy_EC_Curve_methods,
+    .tp_getset = GMPy_EC_Curve_getseters,
+    .tp_new = GMPy_EC_Curve_NewInit,
+};
@@ -0,0 +1,72 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_ec.h                                                              *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef GMPY_EC_H
+#define GMPY_EC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An EC_Object is the elliptic curve y**2 = x**3 + a*x + b over the
+ * integers modulo a prime p > 3. Points are computed in Jacobian
+ * coordinates (X, Y, Z), x = X/Z**2 and y = Y/Z**3, so that additions and
+ * doublings need no inversion; Z = 0 is the point at infinity. Products
+ * are reduced modulo p with the gmpy_modulus_form of p.
+ */
+
+#define GMPY_EC_A_ANY 0
+#define GMPY_EC_A_ZERO 1
+#define GMPY_EC_A_MINUS3 2
+
+typedef struct {
+    PyObject_HEAD
+    mpz_t p, a, b;
+    gmpy_modulus_form form;
+    int a_kind;                 /* GMPY_EC_A_* */
+} EC_Object;
+
+typedef struct {
+    mpz_t X, Y, Z;
+} gmpy_ec_point;
+
+/* Scratch space for the arithmetic of one thread. */
+
+#define GMPY_EC_TEMPS 12
+
+typedef struct {
+    const EC_Object *E;
+    mpz_t t[GMPY_EC_TEMPS];
+} gmpy_ec_ctx;
+
+static PyTypeObject EC_Type;
+#define EC_Check(v) (((PyObject*)v)->ob_type == &EC_Type)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,564 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_expr.c                                                            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Lazy integer expressions.
+ *
+ * Evaluating a*b + c*d - e with the mpz operators creates an mpz for every
+ * product and every partial sum. An expr only records the operations. Its
+ * value is computed by one walk over the tree that adds each product to
+ * the result with mpz_addmul() or mpz_submul(). Factors that are not
+ * leaves are evaluated into temporaries from a pool whose size is known
+ * when the expression is built.
+ *
+ * An expression has at most EXPR_MAX_NODES nodes, counting a shared
+ * subexpression every time it is used, which bounds the recursion and the
+ * work done by a walk. When an operation would create a larger tree, its
+ * larger operand is evaluated and replaced by a leaf first.
+ */
+
+#define EXPR_MAX_NODES 256
+
+PyDoc_STRVAR(GMPy_doc_expr,
+"expr(x, /) -> expr\n\n"
+"Return a lazy integer expression for the integer x. The operators +,\n"
+"-, and * on an expr and an integer or another expr record the operation\n"
+"instead of performing it. x.eval() or mpz(x) computes the value in one\n"
+"pass with fused multiply-add and multiply-subtract, without creating an\n"
+"mpz for each intermediate result. Integer operands are captured when the\n"
+"expression is built.");
+
+static Expr_Object *
+_GMPy_Expr_Leaf(MPZ_Object *value)
+{
+    Expr_Object *result;
+
+    if (!(result = PyObject_New(Expr_Object, &Expr_Type)))
+        return NULL;
+    result->op = EXPR_LEAF;
+    result->left = result->right = NULL;
+    Py_INCREF((PyObject*)value);
+    result->value = value;
+    result->nodes = 1;
+    result->scratch = 0;
+    result->bits = GMPY_MPZ_BITS(value->z);
+    return result;
+}
+
+/* Return a new reference to x as an expr. Returns NULL without an
+ * exception set if x is not an integer or an expr.
+ */
+
+static Expr_Object *
+_GMPy_Expr_Operand(PyObject *x, CTXT_Object *context)
+{
+    Expr_Object *result;
+    MPZ_Object *tempz;
+    int xtype;
+
+    if (Expr_Check(x)) {
+        Py_INCREF(x);
+        return (Expr_Object*)x;
+    }
+
+    xtype = GMPy_ObjectType(x);
+    if (!IS_TYPE_INTEGER(xtype))
+        return NULL;
+    if (!(tempz = GMPy_MPZ_From_IntegerWithType(x, xtype, context)))
+        return NULL;
+    result = _GMPy_Expr_Leaf(tempz);
+    Py_DECREF((PyObject*)tempz);
+    return result;
+}
+
+/* Temporaries needed to use x as a factor. A leaf, possibly negated, is
+ * used directly; anything else is evaluated into one more temporary.
+ */
+
+static Py_ssize_t
+_GMPy_Expr_Factor_Scratch(Expr_Object *x)
+{
+    while (x->op == EXPR_NEG)
+        x = x->left;
+    return x->op == EXPR_LEAF ? 0 : 1 + x->scratch;
+}
+
+/* Replace *x by a leaf holding its value. */
+
+static int
+_GMPy_Expr_Collapse(Expr_Object **x, CTXT_Object *context)
+{
+    MPZ_Object *value;
+    Expr_Object *leaf;
+
+    if (!(value = GMPy_Expr_Eval(*x, context)))
+        return -1;
+    leaf = _GMPy_Expr_Leaf(value);
+    Py_DECREF((PyObject*)value);
+    if (!leaf)
+        return -1;
+    Py_DECREF((PyObject*)*x);
+    *x = leaf;
+    return 0;
+}
+
+/* Return a new node for left op right; right is NULL for EXPR_NEG. */
+
+static Expr_Object *
+_GMPy_Expr_Node(int op, Expr_Object *left, Expr_Object *right,
+                CTXT_Object *context)
+{
+    Expr_Object *result;
+    Py_ssize_t a, b;
+
+    Py_INCREF((PyObject*)left);
+    Py_XINCREF((PyObject*)right);
+
+    while (1 + left->nodes + (right ? right->nodes : 0) > EXPR_MAX_NODES) {
+        if (_GMPy_Expr_Collapse(right && right->nodes > left->nodes ? &right : &left,
+                                context) < 0)
+            goto error;
+    }
+
+    if (!(result = PyObject_New(Expr_Object, &Expr_Type)))
+        goto error;
+    result->op = op;
+    result->left = left;
+    result->right = right;
+    result->value = NULL;
+    result->nodes = 1 + left->nodes + (right ? right->nodes : 0);
+
+    switch (op) {
+    case EXPR_NEG:
+        result->scratch = left->scratch;
+        result->bits = left->bits;
+        break;
+    case EXPR_MUL:
+        /* The left factor is held while the right one is evaluated. */
+        a = _GMPy_Expr_Factor_Scratch(left);
+        b = _GMPy_Expr_Factor_Scratch(right);
+        result->scratch = Py_MAX(a, (a ? 1 : 0) + b);
+        result->bits = left->bits + right->bits;
+        break;
+    default:
+        result->scratch = Py_MAX(left->scratch, right->scratch);
+        result->bits = Py_MAX(left->bits, right->bits) + 1;
+    }
+    return result;
+
+  error:
+    Py_DECREF((PyObject*)left);
+    Py_XDECREF((PyObject*)right);
+    return NULL;
+}
+
+/* The evaluation functions below run without the GIL. scratch points to
+ * the first free temporary; the ones before it are in use by the callers.
+ */
+
+static void _GMPy_Expr_Set(mpz_ptr dest, Expr_Object *x, int negate, mpz_t *scratch);
+
+/* Return the value of x as a factor, flipping *negate for each negation.
+ * A leaf is returned directly, anything else is evaluated into scratch[0].
+ */
+
+static mpz_srcptr
+_GMPy_Expr_Factor(Expr_Object *x, int *negate, mpz_t *scratch)
+{
+    while (x->op == EXPR_NEG) {
+        x = x->left;
+        *negate = !*negate;
+    }
+    if (x->op == EXPR_LEAF)
+        return x->value->z;
+    _GMPy_Expr_Set(scratch[0], x, 0, scratch + 1);
+    return scratch[0];
+}
+
+/* Set dest to the product x, or add it to dest if add is set. */
+
+static void
+_GMPy_Expr_Product(mpz_ptr dest, Expr_Object *x, int negate, int add,
+                   mpz_t *scratch)
+{
+    mpz_srcptr a, b;
+
+    a = _GMPy_Expr_Factor(x->left, &negate, scratch);
+    if (_GMPy_Expr_Factor_Scratch(x->left))
+        scratch++;
+    b = _GMPy_Expr_Factor(x->right, &negate, scratch);
+    if (!add) {
+        mpz_mul(dest, a, b);
+        if (negate)
+            mpz_neg(dest, dest);
+    }
+    else if (negate) {
+        mpz_submul(dest, a, b);
+    }
+    else {
+        mpz_addmul(dest, a, b);
+    }
+}
+
+/* Add x to dest, or subtract it if negate is set. */
+
+static void
+_GMPy_Expr_Accumulate(mpz_ptr dest, Expr_Object *x, int negate, mpz_t *scratch)
+{
+    switch (x->op) {
+    case EXPR_LEAF:
+        if (negate)
+            mpz_sub(dest, dest, x->value->z);
+        else
+            mpz_add(dest, dest, x->value->z);
+        break;
+    case EXPR_NEG:
+        _GMPy_Expr_Accumulate(dest, x->left, !negate, scratch);
+        break;
+    case EXPR_MUL:
+        _GMPy_Expr_Product(dest, x, negate, 1, scratch);
+        break;
+    default:
+        _GMPy_Expr_Accumulate(dest, x->left, negate, scratch);
+        _GMPy_Expr_Accumulate(dest, x->right, negate ^ (x->op == EXPR_SUB), scratch);
+    }
+}
+
+/* Set dest to x, or to -x if negate is set. */
+
+static void
+_GMPy_Expr_Set(mpz_ptr dest, Expr_Object *x, int negate, mpz_t *scratch)
+{
+    switch (x->op) {
+    case EXPR_LEAF:
+        if (negate)
+            mpz_neg(dest, x->value->z);
+        else
+            mpz_set(dest, x->value->z);
+        break;
+    case EXPR_NEG:
+        _GMPy_Expr_Set(dest, x->left, !negate, scratch);
+        break;
+    case EXPR_MUL:
+        _GMPy_Expr_Product(dest, x, negate, 0, scratch);
+        break;
+    default:
+        _GMPy_Expr_Set(dest, x->left, negate, scratch);
+        _GMPy_Expr_Accumulate(dest, x->right, negate ^ (x->op == EXPR_SUB), scratch);
+    }
+}
+
+/* Store the value of self in dest, which must not be referenced by the
+ * expression. Returns -1 if the temporaries cannot be allocated.
+ */
+
+static int
+_GMPy_Expr_Eval_Into(mpz_ptr dest, Expr_Object *self, CTXT_Object *context)
+{
+    mpz_t *scratch = NULL;
+    Py_ssize_t i;
+
+    if (self->scratch && !(scratch = PyMem_New(mpz_t, self->scratch))) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    GMPY_PROFILE_OP(context, GMPY_OP_MUL, self->bits);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, self->bits);
+    for (i = 0; i < self->scratch; i++)
+        mpz_init(scratch[i]);
+    _GMPy_Expr_Set(dest, self, 0, scratch);
+    for (i = 0; i < self->scratch; i++)
+        mpz_clear(scratch[i]);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    PyMem_Free(scratch);
+    return 0;
+}
+
+static MPZ_Object *
+GMPy_Expr_Eval(Expr_Object *self, CTXT_Object *context)
+{
+    MPZ_Object *result;
+
+    if (self->op == EXPR_LEAF) {
+        Py_INCREF((PyObject*)self->value);
+        return self->value;
+    }
+
+    if (!(result = GMPy_MPZ_New(context)))
+        return NULL;
+    if (_GMPy_Expr_Eval_Into(result->z, self, context) < 0) {
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_Expr_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", NULL};
+    PyObject *x;
+    Expr_Object *result;
+    CTXT_Object *context = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O", kwlist, &x))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(result = _GMPy_Expr_Operand(x, context)) && !PyErr_Occurred())
+        TYPE_ERROR("expr() requires an integer argument");
+    return (PyObject*)result;
+}
+
+static void
+GMPy_Expr_Dealloc(Expr_Object *self)
+{
+    Py_XDECREF((PyObject*)self->left);
+    Py_XDECREF((PyObject*)self->right);
+    Py_XDECREF((PyObject*)self->value);
+    PyObject_Free(self);
+}
+
+/* Evaluate self into the xmpz out, which must be locked. */
+
+static int
+_GMPy_Expr_Eval_XMPZ(PyObject *out, Expr_Object *self, CTXT_Object *context)
+{
+    XMPZ_PREPARE_CHANGE(out, -1);
+    return _GMPy_Expr_Eval_Into(MPZ(out), self, context);
+}
+
+PyDoc_STRVAR(GMPy_doc_expr_eval,
+"x.eval(out=None) -> mpz | xmpz\n\n"
+"Return the value of x as an mpz. If out is an xmpz, the value is stored\n"
+"in out, which is returned.");
+
+static PyObject *
+GMPy_Expr_Eval_Method(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"out", NULL};
+    PyObject *out = Py_None;
+    int status;
+    CTXT_Object *context = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|O", kwlist, &out))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (out == Py_None)
+        return (PyObject*)GMPy_Expr_Eval((Expr_Object*)self, context);
+
+    if (!XMPZ_Check(out)) {
+        TYPE_ERROR("eval() out must be an xmpz");
+        return NULL;
+    }
+
+    /* The leaves are mpz values, so out cannot be part of the expression. */
+    XMPZ_LOCK(out);
+    status = _GMPy_Expr_Eval_XMPZ(out, (Expr_Object*)self, context);
+    XMPZ_UNLOCK(out);
+    if (status < 0)
+        return NULL;
+    Py_INCREF(out);
+    return out;
+}
+
+static PyObject *
+GMPy_Expr_Int_Slot(PyObject *self)
+{
+    MPZ_Object *value;
+    PyObject *result;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(value = GMPy_Expr_Eval((Expr_Object*)self, context)))
+        return NULL;
+    result = GMPy_PyLong_From_MPZ(value, context);
+    Py_DECREF((PyObject*)value);
+    return result;
+}
+
+static PyObject *
+_GMPy_Expr_Binop(PyObject *x, PyObject *y, int op)
+{
+    Expr_Object *left = NULL, *right = NULL, *result;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(left = _GMPy_Expr_Operand(x, context)) ||
+        !(right = _GMPy_Expr_Operand(y, context))) {
+        Py_XDECREF((PyObject*)left);
+        if (PyErr_Occurred())
+            return NULL;
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    result = _GMPy_Expr_Node(op, left, right, context);
+    Py_DECREF((PyObject*)left);
+    Py_DECREF((PyObject*)right);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_Expr_Add_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_Expr_Binop(x, y, EXPR_ADD);
+}
+
+static PyObject *
+GMPy_Expr_Sub_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_Expr_Binop(x, y, EXPR_SUB);
+}
+
+static PyObject *
+GMPy_Expr_Mul_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_Expr_Binop(x, y, EXPR_MUL);
+}
+
+static PyObject *
+GMPy_Expr_Minus_Slot(PyObject *self)
+{
+    Expr_Object *x = (Expr_Object*)self;
+    CTXT_Object *context = NULL;
+
+    if (x->op == EXPR_NEG) {
+        Py_INCREF((PyObject*)x->left);
+        return (PyObject*)x->left;
+    }
+
+    CHECK_CONTEXT(context);
+
+    return (PyObject*)_GMPy_Expr_Node(EXPR_NEG, x, NULL, context);
+}
+
+static PyObject *
+GMPy_Expr_Plus_Slot(PyObject *self)
+{
+    Py_INCREF(self);
+    return self;
+}
+
+/* Operator precedence used to decide where parentheses are needed. */
+
+static int
+_GMPy_Expr_Prec(Expr_Object *x)
+{
+    switch (x->op) {
+    case EXPR_ADD:
+    case EXPR_SUB:
+        return 1;
+    case EXPR_MUL:
+        return 2;
+    case EXPR_NEG:
+        return 3;
+    default:
+        return mpz_sgn(x->value->z) < 0 ? 3 : 4;
+    }
+}
+
+/* Return the formula for x, in parentheses if it binds less tightly than
+ * prec.
+ */
+
+static PyObject *
+_GMPy_Expr_Format(Expr_Object *x, int prec)
+{
+    PyObject *left = NULL, *right = NULL, *result = NULL, *temp;
+    int xprec = _GMPy_Expr_Prec(x);
+
+    switch (x->op) {
+    case EXPR_LEAF:
+        result = PyObject_Str((PyObject*)x->value);
+        break;
+    case EXPR_NEG:
+        if ((left = _GMPy_Expr_Format(x->left, 4)))
+            result = PyUnicode_FromFormat("-%U", left);
+        break;
+    default:
+        /* Subtraction is not associative: a - (b - c) keeps its parentheses. */
+        if ((left = _GMPy_Expr_Format(x->left, xprec)) &&
+            (right = _GMPy_Expr_Format(x->right, xprec + (x->op == EXPR_SUB))))
+            result = PyUnicode_FromFormat(x->op == EXPR_MUL ? "%U*%U" :
+                                          x->op == EXPR_ADD ? "%U + %U" : "%U - %U",
+                                          left, right);
+    }
+    Py_XDECREF(left);
+    Py_XDECREF(right);
+
+    if (result && xprec < prec) {
+        temp = PyUnicode_FromFormat("(%U)", result);
+        Py_DECREF(result);
+        result = temp;
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_Expr_Repr_Slot(PyObject *self)
+{
+    PyObject *formula, *result;
+
+    if (!(formula = _GMPy_Expr_Format((Expr_Object*)self, 0)))
+        return NULL;
+    result = PyUnicode_FromFormat("expr(%U)", formula);
+    Py_DECREF(formula);
+    return result;
+}
+
+static PyNumberMethods GMPy_Expr_number_methods =
+{
+    .nb_add = (binaryfunc) GMPy_Expr_Add_Slot,
+    .nb_subtract = (binaryfunc) GMPy_Expr_Sub_Slot,
+    .nb_multiply = (binaryfunc) GMPy_Expr_Mul_Slot,
+    .nb_negative = (unaryfunc) GMPy_Expr_Minus_Slot,
+    .nb_positive = (unaryfunc) GMPy_Expr_Plus_Slot,
+    .nb_int = (unaryfunc) GMPy_Expr_Int_Slot,
+};
+
+static PyMethodDef GMPy_Expr_methods[] =
+{
+    { "eval", (PyCFunction)GMPy_Expr_Eval_Method, METH_VARARGS | METH_KEYWORDS, GMPy_doc_expr_eval },
+    { NULL }
+};
+
+static PyTypeObject Expr_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.expr",
+    .tp_basicsize = sizeof(Expr_Object),
+    .tp_dealloc = (destructor) GMPy_Expr_Dealloc,
+    .tp_repr = (reprfunc) GMPy_Expr_Repr_Slot,
+    .tp_as_number = &GMPy_Expr_number_methods,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_expr,
+    .tp_methods = GMPy_Expr_methods,
+    .tp_new = GMPy_Expr_NewInit,
+};
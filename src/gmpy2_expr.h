@@ -0,0 +1,66 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_expr.h                                                            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_EXPR_H
+#define GMPY_EXPR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An expr records a sum of products of integers as an immutable tree. The
+ * leaves hold mpz values captured when the expression is built; the tree
+ * is evaluated in one pass into a single destination.
+ */
+
+enum {
+    EXPR_LEAF,
+    EXPR_NEG,
+    EXPR_ADD,
+    EXPR_SUB,
+    EXPR_MUL
+};
+
+typedef struct Expr_Object {
+    PyObject_HEAD
+    int op;
+    struct Expr_Object *left;   /* NULL for a leaf */
+    struct Expr_Object *right;  /* NULL for a leaf or EXPR_NEG */
+    MPZ_Object *value;          /* value of a leaf */
+    Py_ssize_t nodes;           /* number of nodes, counting shared ones */
+    Py_ssize_t scratch;         /* temporaries needed to evaluate */
+    size_t bits;                /* bound on the size of the result */
+} Expr_Object;
+
+static PyTypeObject Expr_Type;
+#define Expr_Check(v) (((PyObject*)v)->ob_type == &Expr_Type)
+
+static MPZ_Object *       GMPy_Expr_Eval(Expr_Object *self, CTXT_Object *context);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,753 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_factor.c                                                          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Integer factorization.
+ *
+ * factor() removes the primes below GMPY_SIEVE_PRIMES_LIMIT by trial
+ * division. Each remaining cofactor is checked with the BPSW test and for
+ * perfect powers, and otherwise split with Pollard-Brent rho, Pollard's
+ * p-1, and stage 1 of the elliptic curve method on Montgomery curves with
+ * Suyama's parametrization. The search runs without the GIL; after every
+ * GMPY_FACTOR_POLL_WORK multiplications it calls GMPy_Interrupt_Poll() so
+ * a long search can be interrupted or stopped by the context's deadline.
+ */
+
+/* B1 and number of curves for each ECM level, as used by GMP-ECM for
+ * factors of 15, 20, 25, 30, and 35 digits.
+ */
+
+static const struct {
+    unsigned long B1;
+    int curves;
+} ecm_levels[GMPY_FACTOR_MAX_EFFORT] = {
+    { 2000, 25 },
+    { 11000, 90 },
+    { 50000, 300 },
+    { 250000, 700 },
+    { 1000000, 1800 }
+};
+
+/* Count units multiplications and poll once enough work has been done.
+ * Returns -1 if the search should stop.
+ */
+
+static int
+_GMPy_Factor_Poll(gmpy_factor_state *st, unsigned long units)
+{
+    if ((st->work += units) < GMPY_FACTOR_POLL_WORK)
+        return 0;
+    st->work = 0;
+    return GMPy_Interrupt_Poll() ? -1 : 0;
+}
+
+/* Return 1 if 1 < f < n. */
+
+static int
+_GMPy_Factor_Proper(mpz_srcptr f, mpz_srcptr n)
+{
+    return mpz_cmp_ui(f, 1) > 0 && mpz_cmp(f, n) < 0;
+}
+
+/* Pollard-Brent rho with x -> x**2 + c. The differences are multiplied
+ * together and one gcd is taken for every GMPY_FACTOR_RHO_BATCH steps.
+ * Returns 1 if a factor was stored in f, 0 if none was found within limit
+ * iterations, and -1 if interrupted.
+ */
+
+#define GMPY_FACTOR_RHO_BATCH 128
+
+static int
+_GMPy_Factor_Rho(mpz_ptr f, mpz_srcptr n, unsigned long c, long limit,
+                 gmpy_factor_state *st)
+{
+    mpz_t x, y, ys, q, t;
+    long r = 1, k, i, iters = 0;
+    int result = 0;
+
+    mpz_init(x);
+    mpz_init_set_ui(y, 2);
+    mpz_init(ys);
+    mpz_init_set_ui(q, 1);
+    mpz_init(t);
+    mpz_set_ui(f, 1);
+
+#define RHO_STEP(v) do { \
+        mpz_mul(v, v, v); \
+        mpz_add_ui(v, v, c); \
+        mpz_tdiv_r(v, v, n); \
+    } while (0)
+
+    while (mpz_cmp_ui(f, 1) == 0 && iters < limit) {
+        mpz_set(x, y);
+        for (i = 0; i < r; i++)
+            RHO_STEP(y);
+        for (k = 0; k < r && mpz_cmp_ui(f, 1) == 0; k += GMPY_FACTOR_RHO_BATCH) {
+            mpz_set(ys, y);
+            for (i = 0; i < GMPY_FACTOR_RHO_BATCH && i < r - k; i++) {
+                RHO_STEP(y);
+                mpz_sub(t, x, y);
+                mpz_mul(q, q, t);
+                mpz_tdiv_r(q, q, n);
+            }
+            mpz_gcd(f, q, n);
+            if (_GMPy_Factor_Poll(st, 2 * i) < 0) {
+                result = -1;
+                goto done;
+            }
+        }
+        iters += 2 * r;
+        r *= 2;
+    }
+
+    /* The batch contained a multiple of n; repeat it one step at a time. */
+
+    if (mpz_cmp(f, n) == 0) {
+        for (i = 0; i < GMPY_FACTOR_RHO_BATCH; i++) {
+            RHO_STEP(ys);
+            mpz_sub(t, x, ys);
+            mpz_gcd(f, t, n);
+            if (mpz_cmp_ui(f, 1) > 0)
+                break;
+        }
+    }
+#undef RHO_STEP
+
+    result = _GMPy_Factor_Proper(f, n);
+
+  done:
+    mpz_clear(x);
+    mpz_clear(y);
+    mpz_clear(ys);
+    mpz_clear(q);
+    mpz_clear(t);
+    return result;
+}
+
+/* Bits of an unsigned long, which is what a prime power costs in p-1 and
+ * ECM.
+ */
+
+static unsigned long
+_GMPy_Factor_Bits(unsigned long q)
+{
+    unsigned long bits = 0;
+
+    while (q) {
+        bits++;
+        q >>= 1;
+    }
+    return bits;
+}
+
+/* Return the largest power of p that is <= B1. */
+
+static unsigned long
+_GMPy_Factor_Prime_Power(unsigned long p, unsigned long B1)
+{
+    unsigned long q = p;
+
+    while (q <= B1 / p)
+        q *= p;
+    return q;
+}
+
+/* Stage 1 of Pollard's p-1 with base 3. The gcd is taken after every block
+ * of primes; if it is n, the block is repeated one prime at a time.
+ */
+
+#define GMPY_FACTOR_PM1_BLOCK 64
+
+static int
+_GMPy_Factor_PM1(mpz_ptr f, mpz_srcptr n, unsigned long B1, gmpy_factor_state *st)
+{
+    mpz_t a, saved;
+    Py_ssize_t i, j, stop;
+    unsigned long q;
+    int result = 0;
+
+    mpz_init_set_ui(a, 3);
+    mpz_init(saved);
+
+    for (i = 0; i < st->nprimes && st->primes[i] <= B1; i = stop) {
+        stop = i;
+        while (stop < st->nprimes && stop < i + GMPY_FACTOR_PM1_BLOCK &&
+               st->primes[stop] <= B1) {
+            stop++;
+        }
+
+        mpz_set(saved, a);
+        for (j = i; j < stop; j++)
+            mpz_powm_ui(a, a, _GMPy_Factor_Prime_Power(st->primes[j], B1), n);
+        mpz_sub_ui(f, a, 1);
+        mpz_gcd(f, f, n);
+
+        if (mpz_cmp(f, n) == 0) {
+            mpz_set(a, saved);
+            for (j = i; j < stop; j++) {
+                q = _GMPy_Factor_Prime_Power(st->primes[j], B1);
+                mpz_powm_ui(a, a, q, n);
+                mpz_sub_ui(f, a, 1);
+                mpz_gcd(f, f, n);
+                if (mpz_cmp_ui(f, 1) > 0)
+                    break;
+            }
+        }
+        if (mpz_cmp_ui(f, 1) > 0) {
+            result = _GMPy_Factor_Proper(f, n);
+            break;
+        }
+        if (_GMPy_Factor_Poll(st, (stop - i) * _GMPy_Factor_Bits(B1)) < 0) {
+            result = -1;
+            break;
+        }
+    }
+
+    mpz_clear(a);
+    mpz_clear(saved);
+    return result;
+}
+
+/* Points on a Montgomery curve are kept as (X : Z). a24 is (A + 2) / 4. */
+
+typedef struct {
+    mpz_srcptr n;
+    mpz_t a24;
+    mpz_t x0, z0, x1, z1;
+    mpz_t t1, t2, t3;
+} gmpy_ecm;
+
+/* (xo : zo) = 2 * (xi : zi). xo and zo may be xi and zi. */
+
+static void
+_GMPy_ECM_Double(gmpy_ecm *e, mpz_ptr xo, mpz_ptr zo, mpz_srcptr xi, mpz_srcptr zi)
+{
+    mpz_add(e->t1, xi, zi);
+    mpz_mul(e->t1, e->t1, e->t1);
+    mpz_mod(e->t1, e->t1, e->n);
+    mpz_sub(e->t2, xi, zi);
+    mpz_mul(e->t2, e->t2, e->t2);
+    mpz_mod(e->t2, e->t2, e->n);
+    mpz_sub(e->t3, e->t1, e->t2);
+    mpz_mul(xo, e->t1, e->t2);
+    mpz_mod(xo, xo, e->n);
+    mpz_mul(zo, e->a24, e->t3);
+    mpz_add(zo, zo, e->t2);
+    mpz_mul(zo, zo, e->t3);
+    mpz_mod(zo, zo, e->n);
+}
+
+/* (xo : zo) = P + Q where (xd : zd) = P - Q. xo and zo may be xp and zp. */
+
+static void
+_GMPy_ECM_Add(gmpy_ecm *e, mpz_ptr xo, mpz_ptr zo, mpz_srcptr xp, mpz_srcptr zp,
+              mpz_srcptr xq, mpz_srcptr zq, mpz_srcptr xd, mpz_srcptr zd)
+{
+    mpz_sub(e->t1, xp, zp);
+    mpz_add(e->t2, xq, zq);
+    mpz_mul(e->t1, e->t1, e->t2);
+    mpz_mod(e->t1, e->t1, e->n);
+    mpz_add(e->t2, xp, zp);
+    mpz_sub(e->t3, xq, zq);
+    mpz_mul(e->t2, e->t2, e->t3);
+    mpz_mod(e->t2, e->t2, e->n);
+    mpz_add(e->t3, e->t1, e->t2);
+    mpz_mul(e->t3, e->t3, e->t3);
+    mpz_sub(e->t1, e->t1, e->t2);
+    mpz_mul(e->t1, e->t1, e->t1);
+    mpz_mul(xo, e->t3, zd);
+    mpz_mod(xo, xo, e->n);
+    mpz_mul(zo, e->t1, xd);
+    mpz_mod(zo, zo, e->n);
+}
+
+/* (x : z) = k * (x : z) with the Montgomery ladder. */
+
+static void
+_GMPy_ECM_Mul(gmpy_ecm *e, mpz_ptr x, mpz_ptr z, unsigned long k)
+{
+    unsigned long bit = 1;
+
+    if (k < 2)
+        return;
+
+    while (bit <= k / 2)
+        bit <<= 1;
+
+    /* (x0 : z0) = j * P and (x1 : z1) = (j + 1) * P for the leading bits j
+     * of k, so their difference is always P.
+     */
+
+    mpz_set(e->x0, x);
+    mpz_set(e->z0, z);
+    _GMPy_ECM_Double(e, e->x1, e->z1, x, z);
+    for (bit >>= 1; bit; bit >>= 1) {
+        if (k & bit) {
+            _GMPy_ECM_Add(e, e->x0, e->z0, e->x0, e->z0, e->x1, e->z1, x, z);
+            _GMPy_ECM_Double(e, e->x1, e->z1, e->x1, e->z1);
+        }
+        else {
+            _GMPy_ECM_Add(e, e->x1, e->z1, e->x0, e->z0, e->x1, e->z1, x, z);
+            _GMPy_ECM_Double(e, e->x0, e->z0, e->x0, e->z0);
+        }
+    }
+    mpz_swap(x, e->x0);
+    mpz_swap(z, e->z0);
+}
+
+/* Run stage 1 of ECM with B1 on the curve given by sigma. */
+
+static int
+_GMPy_Factor_ECM_Curve(mpz_ptr f, mpz_srcptr n, unsigned long sigma,
+                       unsigned long B1, gmpy_factor_state *st)
+{
+    gmpy_ecm e;
+    mpz_t x, z, u, v;
+    Py_ssize_t i;
+    unsigned long q;
+    int result = 0;
+
+    e.n = n;
+    mpz_init(e.a24);
+    mpz_init(e.x0);
+    mpz_init(e.z0);
+    mpz_init(e.x1);
+    mpz_init(e.z1);
+    mpz_init(e.t1);
+    mpz_init(e.t2);
+    mpz_init(e.t3);
+    mpz_init(x);
+    mpz_init(z);
+    mpz_init(u);
+    mpz_init(v);
+
+    /* u = sigma**2 - 5, v = 4 * sigma, P = (u**3 : v**3), and
+     * a24 = (v - u)**3 * (3 * u + v) / (16 * u**3 * v).
+     */
+
+    mpz_set_ui(u, sigma);
+    mpz_mul_ui(u, u, sigma);
+    mpz_sub_ui(u, u, 5);
+    mpz_set_ui(v, sigma);
+    mpz_mul_ui(v, v, 4);
+    mpz_pow_ui(x, u, 3);
+    mpz_mod(x, x, n);
+    mpz_pow_ui(z, v, 3);
+    mpz_mod(z, z, n);
+
+    mpz_mul_ui(e.t1, x, 16);
+    mpz_mul(e.t1, e.t1, v);
+    if (!mpz_invert(e.t1, e.t1, n)) {
+        /* The inverse fails only if the denominator shares a factor. */
+        mpz_mul_ui(e.t1, x, 16);
+        mpz_mul(e.t1, e.t1, v);
+        mpz_gcd(f, e.t1, n);
+        result = _GMPy_Factor_Proper(f, n);
+        goto done;
+    }
+    mpz_sub(e.t2, v, u);
+    mpz_pow_ui(e.a24, e.t2, 3);
+    mpz_mul_ui(e.t2, u, 3);
+    mpz_add(e.t2, e.t2, v);
+    mpz_mul(e.a24, e.a24, e.t2);
+    mpz_mul(e.a24, e.a24, e.t1);
+    mpz_mod(e.a24, e.a24, n);
+
+    for (i = 0; i < st->nprimes && st->primes[i] <= B1; i++) {
+        q = _GMPy_Factor_Prime_Power(st->primes[i], B1);
+        _GMPy_ECM_Mul(&e, x, z, q);
+        /* Each bit of q costs a doubling and an addition. */
+        if (_GMPy_Factor_Poll(st, 11 * _GMPy_Factor_Bits(q)) < 0) {
+            result = -1;
+            goto done;
+        }
+    }
+
+    mpz_gcd(f, z, n);
+    result = _GMPy_Factor_Proper(f, n);
+
+  done:
+    mpz_clear(e.a24);
+    mpz_clear(e.x0);
+    mpz_clear(e.z0);
+    mpz_clear(e.x1);
+    mpz_clear(e.z1);
+    mpz_clear(e.t1);
+    mpz_clear(e.t2);
+    mpz_clear(e.t3);
+    mpz_clear(x);
+    mpz_clear(z);
+    mpz_clear(u);
+    mpz_clear(v);
+    return result;
+}
+
+/* Try to split the composite n, which has no factor below
+ * GMPY_SIEVE_PRIMES_LIMIT. Returns 1 if a proper factor was stored in f, 0
+ * if none was found with the given effort, and -1 if interrupted.
+ */
+
+static int
+_GMPy_Factor_Split(mpz_ptr f, mpz_srcptr n, gmpy_factor_state *st)
+{
+    unsigned long sigma = 6;
+    int level, curve, result;
+
+    if ((result = _GMPy_Factor_Rho(f, n, 1, GMPY_FACTOR_RHO_ITERS, st)))
+        return result;
+    if ((result = _GMPy_Factor_PM1(f, n, 100000UL * (st->effort + 1), st)))
+        return result;
+    for (level = 0; level < st->effort; level++) {
+        for (curve = 0; curve < ecm_levels[level].curves; curve++) {
+            if ((result = _GMPy_Factor_ECM_Curve(f, n, sigma++, ecm_levels[level].B1, st)))
+                return result;
+        }
+    }
+    return 0;
+}
+
+/* Fill st->primes with the primes up to st->bound. The GIL is required. */
+
+static int
+_GMPy_Factor_Primes(gmpy_factor_state *st)
+{
+    unsigned char *composite;
+    unsigned long i, j, bound = st->bound;
+
+    if (!(composite = PyMem_Calloc(bound + 1, 1)) ||
+        !(st->primes = PyMem_New(unsigned int, bound / 2 + 2))) {
+        PyMem_Free(composite);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    st->nprimes = 0;
+    st->primes[st->nprimes++] = 2;
+    for (i = 3; i <= bound; i += 2) {
+        if (composite[i])
+            continue;
+        st->primes[st->nprimes++] = (unsigned int)i;
+        for (j = i * i; j <= bound; j += 2 * i)
+            composite[j] = 1;
+    }
+    PyMem_Free(composite);
+    return 0;
+}
+
+/* Append (value, exp) to items. */
+
+static void
+_GMPy_Factor_Push(gmpy_factor_item *items, Py_ssize_t *n, mpz_srcptr value,
+                  unsigned long exp)
+{
+    mpz_set(items[*n].value, value);
+    items[*n].exp = exp;
+    (*n)++;
+}
+
+/* Factor n > 1 into found, which must have room for one entry per bit of
+ * n. stack needs the same room. Cofactors that cannot be split are stored
+ * as they are. Returns -1 if interrupted. Does not use the Python API
+ * except through GMPy_Interrupt_Poll().
+ */
+
+static int
+_GMPy_Factor(mpz_srcptr n, gmpy_factor_item *found, Py_ssize_t *nfound,
+             gmpy_factor_item *stack, gmpy_factor_state *st)
+{
+    Py_ssize_t i, start, nstack = 0;
+    unsigned long p, r, e, product, k, bits;
+    mpz_t c, f, limit;
+    int result = 0;
+
+    mpz_init_set(c, n);
+    mpz_init(f);
+    mpz_init(limit);
+
+    if ((e = mpz_scan1(c, 0))) {
+        mpz_set_ui(f, 2);
+        _GMPy_Factor_Push(found, nfound, f, e);
+        mpz_tdiv_q_2exp(c, c, e);
+    }
+
+    /* Trial division by groups of primes whose product fits in a limb. */
+
+    for (i = 0; i < sieve_nprimes && mpz_cmp_ui(c, 1) > 0; ) {
+        start = i;
+        product = sieve_primes[i++];
+        while (i < sieve_nprimes && product <= ULONG_MAX / sieve_primes[i])
+            product *= sieve_primes[i++];
+
+        r = mpz_fdiv_ui(c, product);
+        for (; start < i; start++) {
+            p = sieve_primes[start];
+            if (r % p)
+                continue;
+            for (e = 0; mpz_divisible_ui_p(c, p); e++)
+                mpz_divexact_ui(c, c, p);
+            mpz_set_ui(f, p);
+            _GMPy_Factor_Push(found, nfound, f, e);
+        }
+
+        /* Every composite has a prime factor <= its square root. */
+        p = sieve_primes[i - 1];
+        if (mpz_cmp_ui(c, p) <= 0 || (mpz_fits_ulong_p(c) && mpz_get_ui(c) / p < p))
+            break;
+    }
+
+    if (mpz_cmp_ui(c, 1) > 0)
+        _GMPy_Factor_Push(stack, &nstack, c, 1);
+
+    /* The cofactors have no factor below GMPY_SIEVE_PRIMES_LIMIT. */
+
+    mpz_set_ui(limit, GMPY_SIEVE_PRIMES_LIMIT);
+    mpz_mul(limit, limit, limit);
+
+    while (nstack) {
+        nstack--;
+        mpz_swap(c, stack[nstack].value);
+        e = stack[nstack].exp;
+
+        if (mpz_cmp(c, limit) < 0 || _GMPy_MPZ_BPSW_PRP(c) == 1) {
+            _GMPy_Factor_Push(found, nfound, c, e);
+            continue;
+        }
+
+        if (mpz_perfect_power_p(c)) {
+            bits = mpz_sizeinbase(c, 2);
+            for (k = 2; k <= bits; k++) {
+                if (mpz_root(f, c, k)) {
+                    _GMPy_Factor_Push(stack, &nstack, f, e * k);
+                    break;
+                }
+            }
+            continue;
+        }
+
+        if ((result = _GMPy_Factor_Split(f, c, st)) < 0)
+            break;
+        if (result == 0) {
+            _GMPy_Factor_Push(found, nfound, c, e);
+            continue;
+        }
+        _GMPy_Factor_Push(stack, &nstack, f, e);
+        mpz_divexact(c, c, f);
+        _GMPy_Factor_Push(stack, &nstack, c, e);
+    }
+
+    mpz_clear(c);
+    mpz_clear(f);
+    mpz_clear(limit);
+    return result < 0 ? -1 : 0;
+}
+
+static int
+_GMPy_Factor_Compare(const void *a, const void *b)
+{
+    return mpz_cmp(((const gmpy_factor_item*)a)->value,
+                   ((const gmpy_factor_item*)b)->value);
+}
+
+/* A factorization is prepared and collected with the GIL held and run
+ * without it, so factor() and submit() share the following steps.
+ *
+ * Prepare job to factor n > 0. Returns -1 with an exception set on error;
+ * the job must be cleared with _GMPy_Factor_Job_Clear() in both cases.
+ */
+
+static int
+_GMPy_Factor_Job_Init(gmpy_factor_job *job, mpz_srcptr n, int effort)
+{
+    Py_ssize_t i;
+
+    memset(job, 0, sizeof(gmpy_factor_job));
+    if (GMPy_Sieve_Init() < 0)
+        return -1;
+    job->st.effort = effort;
+    job->st.bound = 100000UL * (effort + 1);
+    if (effort && ecm_levels[effort - 1].B1 > job->st.bound)
+        job->st.bound = ecm_levels[effort - 1].B1;
+
+    job->cap = mpz_sizeinbase(n, 2) + 1;
+    if (!(job->found = PyMem_New(gmpy_factor_item, job->cap)) ||
+        !(job->stack = PyMem_New(gmpy_factor_item, job->cap))) {
+        PyMem_Free(job->found);
+        job->found = NULL;
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (i = 0; i < job->cap; i++) {
+        mpz_init(job->found[i].value);
+        mpz_init(job->stack[i].value);
+    }
+
+    /* Trial division by the sieve's table alone factors n below the square
+     * of its limit, so the primes for p-1 and ECM are not needed. */
+
+    if (mpz_cmp_d(n, (double)GMPY_SIEVE_PRIMES_LIMIT * GMPY_SIEVE_PRIMES_LIMIT) < 0)
+        return 0;
+    return _GMPy_Factor_Primes(&job->st);
+}
+
+/* Factor n and sort the factors, merging equal ones. Returns -1 if
+ * interrupted. Does not use the Python API except through
+ * GMPy_Interrupt_Poll().
+ */
+
+static int
+_GMPy_Factor_Job_Run(gmpy_factor_job *job, mpz_srcptr n)
+{
+    gmpy_factor_item *found = job->found;
+    Py_ssize_t i, j;
+
+    job->nfound = 0;
+    if (_GMPy_Factor(n, found, &job->nfound, job->stack, &job->st) < 0)
+        return -1;
+
+    /* Equal factors can come from different cofactors. */
+
+    qsort(found, job->nfound, sizeof(gmpy_factor_item), _GMPy_Factor_Compare);
+    for (i = 0, j = 0; i < job->nfound; i++) {
+        if (j && mpz_cmp(found[j - 1].value, found[i].value) == 0) {
+            found[j - 1].exp += found[i].exp;
+        }
+        else {
+            mpz_swap(found[j].value, found[i].value);
+            found[j++].exp = found[i].exp;
+        }
+    }
+    job->nfound = j;
+    return 0;
+}
+
+/* Return the list of (p, e) pairs of a finished job. */
+
+static PyObject *
+_GMPy_Factor_Job_Result(gmpy_factor_job *job, CTXT_Object *context)
+{
+    MPZ_Object *p;
+    PyObject *result, *temp;
+    Py_ssize_t i;
+
+    if (!(result = PyList_New(job->nfound)))
+        return NULL;
+    for (i = 0; i < job->nfound; i++) {
+        if (!(p = GMPy_MPZ_New(context))) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        mpz_swap(p->z, job->found[i].value);
+        if (!(temp = Py_BuildValue("(Nk)", (PyObject*)p, job->found[i].exp))) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, i, temp);
+    }
+    return result;
+}
+
+static void
+_GMPy_Factor_Job_Clear(gmpy_factor_job *job)
+{
+    Py_ssize_t i;
+
+    if (job->found) {
+        for (i = 0; i < job->cap; i++) {
+            mpz_clear(job->found[i].value);
+            mpz_clear(job->stack[i].value);
+        }
+    }
+    PyMem_Free(job->found);
+    PyMem_Free(job->stack);
+    PyMem_Free(job->st.primes);
+    job->found = NULL;
+    job->stack = NULL;
+    job->st.primes = NULL;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_factor,
+"factor(n, /, effort=2) -> list[tuple[mpz, int], ...]\n\n"
+"Return the factorization of n > 0 as a sorted list of (p, e) pairs with\n"
+"n == prod(p**e). Trial division, Pollard-Brent rho, Pollard's p-1, and\n"
+"stage 1 of the elliptic curve method are used; effort, from 0 to 5,\n"
+"selects how many levels of ECM are run, aimed at factors of 15, 20, 25,\n"
+"30, and 35 digits. A factor that could not be split is returned as it\n"
+"is and can be recognized with is_prime(). The primes p are BPSW\n"
+"probable primes. The GIL is released during the search, which can be\n"
+"interrupted and is stopped by the context's max_time and deadline.");
+
+static PyObject *
+GMPy_MPZ_Function_Factor(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"n", "effort", NULL};
+    gmpy_factor_job job;
+    gmpy_interrupt intr;
+    MPZ_Object *tempn = NULL;
+    PyObject *arg, *result = NULL;
+    CTXT_Object *context = NULL;
+    int effort = GMPY_FACTOR_DEFAULT_EFFORT, status;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|i", kwlist, &arg, &effort))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_INTEGER(arg)) {
+        TYPE_ERROR("factor() requires an integer argument");
+        return NULL;
+    }
+    if (effort < 0 || effort > GMPY_FACTOR_MAX_EFFORT) {
+        VALUE_ERROR("factor() effort must be in the range 0 to 5");
+        return NULL;
+    }
+    if (!(tempn = GMPy_MPZ_From_Integer(arg, context)))
+        return NULL;
+    if (mpz_sgn(tempn->z) <= 0) {
+        VALUE_ERROR("factor() requires n > 0");
+        Py_DECREF((PyObject*)tempn);
+        return NULL;
+    }
+
+    if (_GMPy_Factor_Job_Init(&job, tempn->z, effort) < 0)
+        goto done;
+
+    GMPY_PROFILE_OP(context, GMPY_OP_PRP, mpz_sizeinbase(tempn->z, 2));
+
+    /* Splitting needs at least thousands of multiplications. */
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(tempn->z) * GMPY_FACTOR_RHO_ITERS);
+    intr.save = &_save;
+    status = _GMPy_Factor_Job_Run(&job, tempn->z);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (GMPy_Interrupt_End(&intr) == 0 && status == 0)
+        result = _GMPy_Factor_Job_Result(&job, context);
+
+  done:
+    _GMPy_Factor_Job_Clear(&job);
+    Py_DECREF((PyObject*)tempn);
+    return result;
+}
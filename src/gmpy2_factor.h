@@ -0,0 +1,75 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_factor.h                                                          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_FACTOR_H
+#define GMPY_FACTOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* factor() runs ECM levels 1 to effort; see gmpy2_factor.c. */
+
+#define GMPY_FACTOR_MAX_EFFORT 5
+#define GMPY_FACTOR_DEFAULT_EFFORT 2
+
+/* Iterations of Pollard-Brent rho before p-1 and ECM are tried. */
+
+#define GMPY_FACTOR_RHO_ITERS (1L << 16)
+
+/* Modular multiplications between two calls of GMPy_Interrupt_Poll(). */
+
+#define GMPY_FACTOR_POLL_WORK (1UL << 14)
+
+typedef struct {
+    mpz_t value;
+    unsigned long exp;
+} gmpy_factor_item;
+
+typedef struct {
+    unsigned long work;     /* multiplications since the last check */
+    int effort;
+    unsigned int *primes;   /* all primes up to bound */
+    Py_ssize_t nprimes;
+    unsigned long bound;
+} gmpy_factor_state;
+
+/* A factorization; see _GMPy_Factor_Job_Init(). */
+
+typedef struct {
+    gmpy_factor_item *found;    /* the factors, one entry per bit of n */
+    gmpy_factor_item *stack;    /* cofactors still to be split */
+    Py_ssize_t cap;
+    Py_ssize_t nfound;
+    gmpy_factor_state st;
+} gmpy_factor_job;
+
+static PyObject * GMPy_MPZ_Function_Factor(PyObject *self, PyObject *args, PyObject *keywds);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
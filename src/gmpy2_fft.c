@@ -0,0 +1,375 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_fft.c                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Roots of unity and the discrete Fourier transform over mpc.
+ *
+ * The table for n holds exp(2*pi*i*k/n) for 0 <= k < n. Only the roots up
+ * to n/4 (or n/2 if n is not a multiple of 4 or the real and imaginary
+ * precisions differ) are computed with mpc_rootofunity(); the others
+ * follow exactly by multiplying by i or by conjugating. The most recently used tables are kept in global.roots_cache,
+ * which is protected by const_lock in a free-threaded build.
+ *
+ * fft() and ifft() copy their argument into a C array of mpc_t with guard
+ * bits, run the transform without the GIL, and round each result once.
+ * Power-of-two lengths use an iterative radix-2 transform; other lengths
+ * use the direct O(n**2) sum.
+ */
+
+static PyObject *
+_GMPy_Roots_Table(unsigned long n, mpfr_prec_t rprec, mpfr_prec_t iprec,
+                  CTXT_Object *context)
+{
+    gmpy_roots_entry *entry;
+    PyObject *table = NULL, *old = NULL;
+    MPC_Object *root;
+    unsigned long k, half = n / 2, quarter = (n % 4) ? 0 : n / 4;
+    int i, oldest = 0;
+
+    /* Multiplying by i swaps the parts, so it is only exact if they have
+     * the same precision.
+     */
+
+    if (rprec != iprec)
+        quarter = 0;
+
+    CONST_LOCK();
+    for (i = 0; i < global.roots_count; i++) {
+        entry = &global.roots_cache[i];
+        if (entry->n == n && entry->rprec == rprec && entry->iprec == iprec) {
+            entry->last_used = ++(global.roots_clock);
+            table = entry->table;
+            Py_INCREF(table);
+            break;
+        }
+    }
+    CONST_UNLOCK();
+
+    if (table)
+        return table;
+
+    if (!(table = PyTuple_New((Py_ssize_t)n)))
+        return NULL;
+
+    for (k = 0; k < n; k++) {
+        if (!(root = GMPy_MPC_New(rprec, iprec, context))) {
+            Py_DECREF(table);
+            return NULL;
+        }
+        if (k > half) {
+            mpc_conj(root->c, MPC(PyTuple_GET_ITEM(table, n - k)), MPC_RNDNN);
+        }
+        else if (quarter && k >= quarter) {
+            mpc_mul_i(root->c, MPC(PyTuple_GET_ITEM(table, k - quarter)), 1, MPC_RNDNN);
+            if (mpfr_zero_p(mpc_realref(root->c)))
+                mpfr_set_zero(mpc_realref(root->c), 1);
+        }
+        else {
+            mpc_rootofunity(root->c, n, k, MPC_RNDNN);
+        }
+        PyTuple_SET_ITEM(table, k, (PyObject*)root);
+    }
+
+    if (n > GMPY_ROOTS_CACHE_MAXN)
+        return table;
+
+    /* Replace the least recently used table if the cache is full. */
+
+    CONST_LOCK();
+    for (i = 0; i < global.roots_count; i++) {
+        entry = &global.roots_cache[i];
+        if (entry->n == n && entry->rprec == rprec && entry->iprec == iprec)
+            break;
+        if (entry->last_used < global.roots_cache[oldest].last_used)
+            oldest = i;
+    }
+    if (i == global.roots_count) {
+        if (global.roots_count == GMPY_ROOTS_CACHE_SIZE) {
+            i = oldest;
+            old = global.roots_cache[i].table;
+        }
+        else {
+            global.roots_count++;
+        }
+        entry = &global.roots_cache[i];
+        entry->n = n;
+        entry->rprec = rprec;
+        entry->iprec = iprec;
+        entry->last_used = ++(global.roots_clock);
+        entry->table = table;
+        Py_INCREF(table);
+    }
+    CONST_UNLOCK();
+    Py_XDECREF(old);
+    return table;
+}
+
+/* Return the root w**e of the table, or w**-e if sign < 0. */
+
+#define FFT_ROOT(roots, n, e, sign) \
+    MPC((roots)[((sign) < 0 && (e)) ? (n) - (e) : (e)])
+
+/* In-place radix-2 transform of a; n must be a power of two. */
+
+static void
+_GMPy_FFT_Radix2(mpc_t *a, unsigned long n, PyObject **roots, int sign,
+                 mpc_ptr t)
+{
+    unsigned long i, j, k, e, bit, len, half, step;
+
+    for (i = 1, j = 0; i < n; i++) {
+        for (bit = n >> 1; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            mpc_swap(a[i], a[j]);
+    }
+
+    for (len = 2; len <= n; len <<= 1) {
+        half = len >> 1;
+        step = n / len;
+        for (i = 0; i < n; i += len) {
+            for (k = 0, e = 0; k < half; k++, e += step) {
+                mpc_mul(t, a[i + k + half], FFT_ROOT(roots, n, e, sign), MPC_RNDNN);
+                mpc_sub(a[i + k + half], a[i + k], t, MPC_RNDNN);
+                mpc_add(a[i + k], a[i + k], t, MPC_RNDNN);
+            }
+        }
+    }
+}
+
+/* out[k] = sum(a[j] * w**(sign*j*k)) for any n. */
+
+static void
+_GMPy_FFT_Direct(mpc_t *out, mpc_t *a, unsigned long n, PyObject **roots,
+                 int sign, mpc_ptr t)
+{
+    unsigned long j, k, e;
+
+    for (k = 0; k < n; k++) {
+        mpc_set_ui(out[k], 0, MPC_RNDNN);
+        for (j = 0, e = 0; j < n; j++) {
+            mpc_mul(t, a[j], FFT_ROOT(roots, n, e, sign), MPC_RNDNN);
+            mpc_add(out[k], out[k], t, MPC_RNDNN);
+            e += k;
+            if (e >= n)
+                e -= n;
+        }
+    }
+}
+
+static int
+_GMPy_FFT_Precision(long prec)
+{
+    if (prec != 0 && (prec < MPFR_PREC_MIN || prec > MPFR_PREC_MAX)) {
+        VALUE_ERROR("invalid value for precision");
+        return -1;
+    }
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_roots_of_unity,
+"roots_of_unity(n, /, precision=0) -> tuple[mpc, ...]\n\n"
+"Return the n-th roots of unity, exp(2*pi*i*k/n) for 0 <= k < n, as\n"
+"`mpc` values whose parts have the given precision. If precision is 0,\n"
+"the context's real and imaginary precisions are used. Each root is\n"
+"rounded to nearest. The most recently used tables are cached.");
+
+static PyObject *
+GMPy_Function_Roots_Of_Unity(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *n_obj;
+    unsigned long n;
+    long prec = 0;
+    static char *kwlist[] = {"", "precision", NULL};
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|l:roots_of_unity",
+                                     kwlist, &n_obj, &prec)) {
+        return NULL;
+    }
+    if (!IS_INTEGER(n_obj)) {
+        TYPE_ERROR("roots_of_unity() requires an integer argument");
+        return NULL;
+    }
+    n = GMPy_Integer_AsUnsignedLong(n_obj);
+    if ((n == (unsigned long)(-1) && PyErr_Occurred()) || n == 0 ||
+        n > PY_SSIZE_T_MAX) {
+        PyErr_Clear();
+        VALUE_ERROR("roots_of_unity() requires a positive integer argument");
+        return NULL;
+    }
+    if (_GMPy_FFT_Precision(prec) < 0)
+        return NULL;
+
+    return _GMPy_Roots_Table(n, prec ? (mpfr_prec_t)prec : GET_REAL_PREC(context),
+                             prec ? (mpfr_prec_t)prec : GET_IMAG_PREC(context),
+                             context);
+}
+
+static PyObject *
+_GMPy_FFT(PyObject *args, PyObject *keywds, int sign, const char *name)
+{
+    PyObject *values, *seq, *table = NULL, *result = NULL, **items, **roots;
+    MPC_Object *temp;
+    mpc_t *a = NULL, *out = NULL, t;
+    mpfr_prec_t rprec, iprec, wprec;
+    Py_ssize_t i, n, inited = 0;
+    long prec = 0;
+    int pow2;
+    static char *kwlist[] = {"", "precision", NULL};
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|l", kwlist, &values, &prec))
+        return NULL;
+    if (_GMPy_FFT_Precision(prec) < 0)
+        return NULL;
+
+    rprec = prec ? (mpfr_prec_t)prec : GET_REAL_PREC(context);
+    iprec = prec ? (mpfr_prec_t)prec : GET_IMAG_PREC(context);
+
+    if (!(seq = PySequence_Fast(values, sign < 0 ? "fft() requires an iterable" :
+                                                   "ifft() requires an iterable")))
+        return NULL;
+    n = PySequence_Fast_GET_SIZE(seq);
+    items = PySequence_Fast_ITEMS(seq);
+    pow2 = (n & (n - 1)) == 0;
+
+    /* Each stage adds at most a few ulps, so log2(n) + 10 guard bits keep
+     * the result accurate to the target precision relative to the largest
+     * input.
+     */
+
+    wprec = (rprec > iprec ? rprec : iprec) + 10;
+    for (i = n; i > 0; i >>= 1)
+        wprec++;
+
+    if (n == 0) {
+        result = PyList_New(0);
+        goto done;
+    }
+
+    if (!(table = _GMPy_Roots_Table((unsigned long)n, wprec, wprec, context)))
+        goto done;
+    roots = PySequence_Fast_ITEMS(table);
+
+    if (!(a = PyMem_New(mpc_t, n)) ||
+        (!pow2 && !(out = PyMem_New(mpc_t, n)))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    for (inited = 0; inited < n; inited++) {
+        mpc_init2(a[inited], wprec);
+        if (out)
+            mpc_init2(out[inited], wprec);
+    }
+
+    for (i = 0; i < n; i++) {
+        if (!IS_COMPLEX(items[i])) {
+            PyErr_Format(PyExc_TypeError, "%s() requires complex values", name);
+            goto done;
+        }
+        if (!(temp = GMPy_MPC_From_Complex(items[i], 1, 1, context)))
+            goto done;
+        mpc_set(a[i], temp->c, MPC_RNDNN);
+        Py_DECREF((PyObject*)temp);
+    }
+
+    mpc_init2(t, wprec);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)n * (size_t)wprec);
+    if (pow2) {
+        _GMPy_FFT_Radix2(a, (unsigned long)n, roots, sign, t);
+    }
+    else {
+        _GMPy_FFT_Direct(out, a, (unsigned long)n, roots, sign, t);
+        for (i = 0; i < n; i++)
+            mpc_swap(a[i], out[i]);
+    }
+    if (sign > 0) {
+        for (i = 0; i < n; i++)
+            mpc_div_ui(a[i], a[i], (unsigned long)n, MPC_RNDNN);
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    mpc_clear(t);
+
+    if (!(result = PyList_New(n)))
+        goto done;
+    for (i = 0; i < n; i++) {
+        if (!(temp = GMPy_MPC_New(rprec, iprec, context))) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        temp->rc = mpc_set(temp->c, a[i], GET_MPC_ROUND(context));
+        _GMPy_MPC_Cleanup(&temp, context);
+        if (!temp) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, (PyObject*)temp);
+    }
+
+  done:
+    for (i = 0; i < inited; i++) {
+        mpc_clear(a[i]);
+        if (out)
+            mpc_clear(out[i]);
+    }
+    PyMem_Free(a);
+    PyMem_Free(out);
+    Py_XDECREF(table);
+    Py_DECREF(seq);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_fft,
+"fft(x, /, precision=0) -> list[mpc]\n\n"
+"Return the discrete Fourier transform of the sequence x,\n"
+"sum(x[j] * exp(-2*pi*i*j*k/n) for j in range(n)) for 0 <= k < n. The\n"
+"results have the given precision, or the context's real and imaginary\n"
+"precisions if it is 0. The transform runs in C without the GIL, using a\n"
+"radix-2 FFT if n is a power of two and the direct sum otherwise.");
+
+static PyObject *
+GMPy_Function_FFT(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_FFT(args, keywds, -1, "fft");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_ifft,
+"ifft(x, /, precision=0) -> list[mpc]\n\n"
+"Return the inverse discrete Fourier transform of the sequence x,\n"
+"sum(x[j] * exp(2*pi*i*j*k/n) for j in range(n)) / n for 0 <= k < n.\n"
+"ifft(fft(x)) returns x up to rounding.");
+
+static PyObject *
+GMPy_Function_IFFT(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_FFT(args, keywds, 1, "ifft");
+}
@@ -0,0 +1,435 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_fixedbase.c                                                       *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Fixed-base exponentiation.
+ *
+ * The exponent is split into digits of width bits, e = sum(d[i] * 2**(width*i)),
+ * and table[i] holds g**(2**(width*i)). Yao's method then evaluates
+ *
+ *     g**e = prod(B[d] for d in 1 .. 2**width - 1)
+ *
+ * where B[d] is the product of the table entries whose digit is >= d. Each
+ * evaluation needs at most size + 2**width - 1 multiplications and no
+ * squarings, compared to roughly max_bits squarings for powmod().
+ */
+
+PyDoc_STRVAR(GMPy_doc_fixedbase,
+"FixedBasePowMod(g, m, max_bits, /) -> FixedBasePowMod\n\n"
+"Return an object that computes powmod(g, e, m) for many exponents e.\n"
+"A table of powers of g is computed once; calling the object with an\n"
+"integer e returns powmod(g, e, m) and calling it with an iterable of\n"
+"integers returns a list. Exponents up to max_bits bits use the table,\n"
+"larger exponents fall back to powmod(). The GIL is released unless the\n"
+"work is less than the context's release_gil_min_bits and a list of\n"
+"exponents is split over the context's threads.");
+
+/* Choose the digit width that minimizes the number of multiplications. */
+
+static int
+_GMPy_FixedBase_Width(mp_bitcnt_t max_bits)
+{
+    int w, best = 1;
+    mp_bitcnt_t cost, best_cost = max_bits + 2;
+
+    for (w = 2; w <= 16; w++) {
+        cost = (max_bits + w - 1) / w + ((mp_bitcnt_t)1 << w);
+        if (cost <= best_cost) {
+            best = w;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+/* Return bits start .. start+w-1 of |e|. */
+
+static unsigned long
+_GMPy_FixedBase_Digit(mpz_srcptr e, mp_bitcnt_t start, int w)
+{
+    mp_size_t limb = start / GMP_NUMB_BITS;
+    unsigned int shift = start % GMP_NUMB_BITS;
+    mp_limb_t value = mpz_getlimbn(e, limb) >> shift;
+
+    if (shift + w > GMP_NUMB_BITS) {
+        value |= mpz_getlimbn(e, limb + 1) << (GMP_NUMB_BITS - shift);
+    }
+    return (unsigned long)(value & (((mp_limb_t)1 << w) - 1));
+}
+
+/* Set r to g**|e| mod m. Does not use the Python API, only the
+ * underlying memory allocator, so it can run without the GIL.
+ */
+
+static void
+_GMPy_FixedBase_Eval(mpz_t r, FixedBase_Object *self, mpz_srcptr e)
+{
+    Py_ssize_t *head, *next, i, n;
+    unsigned long d, ndigits = 1UL << self->width;
+    int have_r = 0, have_b = 0;
+    mpz_t b;
+
+    n = (Py_ssize_t)((mpz_sizeinbase(e, 2) + self->width - 1) / self->width);
+    if (mpz_sgn(e) == 0) {
+        mpz_set_ui(r, 1);
+        mpz_mod(r, r, self->m);
+        return;
+    }
+    if (n > self->size ||
+        !(head = (Py_ssize_t*)PyMem_RawMalloc((ndigits + n) * sizeof(Py_ssize_t)))) {
+        mpz_init_set(b, e);
+        mpz_abs(b, b);
+        mpz_powm(r, self->g, b, self->m);
+        mpz_clear(b);
+        return;
+    }
+
+    /* Bucket the digit positions by value. */
+
+    next = head + ndigits;
+    for (d = 0; d < ndigits; d++) {
+        head[d] = -1;
+    }
+    for (i = 0; i < n; i++) {
+        d = _GMPy_FixedBase_Digit(e, (mp_bitcnt_t)i * self->width, self->width);
+        if (d) {
+            next[i] = head[d];
+            head[d] = i;
+        }
+    }
+
+    mpz_init(b);
+    for (d = ndigits - 1; d > 0; d--) {
+        for (i = head[d]; i >= 0; i = next[i]) {
+            if (have_b) {
+                mpz_mul(b, b, self->table[i]);
+                mpz_mod(b, b, self->m);
+            }
+            else {
+                mpz_set(b, self->table[i]);
+                have_b = 1;
+            }
+        }
+        if (have_b) {
+            if (have_r) {
+                mpz_mul(r, r, b);
+                mpz_mod(r, r, self->m);
+            }
+            else {
+                mpz_set(r, b);
+                have_r = 1;
+            }
+        }
+    }
+    mpz_clear(b);
+    PyMem_RawFree(head);
+}
+
+/* Set r to g**e mod m; a negative e requires self->invertible. r and e
+ * may be the same variable.
+ */
+
+static void
+_GMPy_FixedBase_Pow(mpz_t r, FixedBase_Object *self, mpz_srcptr e)
+{
+    int sign = mpz_sgn(e);
+
+    _GMPy_FixedBase_Eval(r, self, e);
+    if (sign < 0) {
+        mpz_invert(r, r, self->m);
+    }
+}
+
+typedef struct {
+    FixedBase_Object *self;
+    PyObject **items;
+} gmpy_fixedbase_list;
+
+static void
+_GMPy_FixedBase_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_fixedbase_list *work = (gmpy_fixedbase_list*)arg;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++)
+        _GMPy_FixedBase_Pow(MPZ(work->items[i]), work->self, MPZ(work->items[i]));
+}
+
+static PyObject *
+GMPy_FixedBase_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    FixedBase_Object *result;
+    MPZ_Object *tempg = NULL, *tempm = NULL;
+    Py_ssize_t i, bits;
+    int j;
+    CTXT_Object *context = NULL;
+
+    if (keywds && PyDict_Size(keywds)) {
+        TYPE_ERROR("FixedBasePowMod() takes no keyword arguments");
+        return NULL;
+    }
+
+    if (PyTuple_GET_SIZE(args) != 3) {
+        TYPE_ERROR("FixedBasePowMod() requires 3 arguments");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_INTEGER(PyTuple_GET_ITEM(args, 0)) ||
+        !IS_INTEGER(PyTuple_GET_ITEM(args, 1)) ||
+        !PyIndex_Check(PyTuple_GET_ITEM(args, 2))) {
+        TYPE_ERROR("FixedBasePowMod() requires integer arguments");
+        return NULL;
+    }
+
+    bits = PyNumber_AsSsize_t(PyTuple_GET_ITEM(args, 2), PyExc_OverflowError);
+    if (bits == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (bits < 1) {
+        VALUE_ERROR("FixedBasePowMod() 'max_bits' must be > 0");
+        return NULL;
+    }
+
+    if (!(tempg = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), context)) ||
+        !(tempm = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), context))) {
+        Py_XDECREF((PyObject*)tempg);
+        return NULL;
+    }
+
+    if (mpz_sgn(tempm->z) < 1) {
+        VALUE_ERROR("FixedBasePowMod() 'mod' must be > 0");
+        Py_DECREF((PyObject*)tempg);
+        Py_DECREF((PyObject*)tempm);
+        return NULL;
+    }
+
+    if (!(result = PyObject_New(FixedBase_Object, &FixedBase_Type))) {
+        Py_DECREF((PyObject*)tempg);
+        Py_DECREF((PyObject*)tempm);
+        return NULL;
+    }
+
+    mpz_init(result->g);
+    mpz_init_set(result->m, tempm->z);
+    mpz_mod(result->g, tempg->z, tempm->z);
+    Py_DECREF((PyObject*)tempg);
+    Py_DECREF((PyObject*)tempm);
+
+    result->max_bits = (mp_bitcnt_t)bits;
+    result->width = _GMPy_FixedBase_Width(result->max_bits);
+    result->size = (Py_ssize_t)((result->max_bits + result->width - 1) / result->width);
+    if (!(result->table = PyMem_New(mpz_t, result->size))) {
+        result->size = 0;
+        Py_DECREF((PyObject*)result);
+        return PyErr_NoMemory();
+    }
+    for (i = 0; i < result->size; i++) {
+        mpz_init(result->table[i]);
+    }
+
+    {
+        mpz_t temp;
+
+        mpz_init(temp);
+        result->invertible = mpz_invert(temp, result->g, result->m) != 0;
+        mpz_clear(temp);
+    }
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(result->m) * (result->size / 64 + 1));
+    mpz_set(result->table[0], result->g);
+    for (i = 1; i < result->size; i++) {
+        mpz_set(result->table[i], result->table[i-1]);
+        for (j = 0; j < result->width; j++) {
+            mpz_mul(result->table[i], result->table[i], result->table[i]);
+            mpz_mod(result->table[i], result->table[i], result->m);
+        }
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    return (PyObject*)result;
+}
+
+static void
+GMPy_FixedBase_Dealloc(FixedBase_Object *self)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < self->size; i++)
+        mpz_clear(self->table[i]);
+    PyMem_Free(self->table);
+    mpz_clear(self->g);
+    mpz_clear(self->m);
+    PyObject_Free(self);
+}
+
+static PyObject *
+GMPy_FixedBase_Call_Slot(FixedBase_Object *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *arg, *seq, *result;
+    MPZ_Object *tempe, *tempres;
+    Py_ssize_t i, n;
+    gmpy_fixedbase_list work;
+    CTXT_Object *context = NULL;
+
+    if ((keywds && PyDict_Size(keywds)) || PyTuple_GET_SIZE(args) != 1) {
+        TYPE_ERROR("FixedBasePowMod() requires 1 argument");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    arg = PyTuple_GET_ITEM(args, 0);
+    if (IS_INTEGER(arg)) {
+        if (!(tempe = GMPy_MPZ_From_Integer(arg, context)))
+            return NULL;
+
+        if (mpz_sgn(tempe->z) < 0 && !self->invertible) {
+            VALUE_ERROR("FixedBasePowMod() base not invertible");
+            Py_DECREF((PyObject*)tempe);
+            return NULL;
+        }
+
+        if (!(tempres = GMPy_MPZ_New(context))) {
+            Py_DECREF((PyObject*)tempe);
+            return NULL;
+        }
+
+        GMPY_PROFILE_OP(context, GMPY_OP_POWMOD, mpz_sizeinbase(self->m, 2));
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(self->m));
+        _GMPy_FixedBase_Pow(tempres->z, self, tempe->z);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+        Py_DECREF((PyObject*)tempe);
+        return (PyObject*)tempres;
+    }
+
+    /* Note: MUST USE GMPy_MPZ_From_IntegerAndCopy() since the value is
+     * changed in-place.
+     */
+
+    if (!(seq = PySequence_Fast(arg, "FixedBasePowMod() requires an integer or an iterable")))
+        return NULL;
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    if (!(result = PyList_New(n))) {
+        Py_DECREF(seq);
+        return NULL;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (!(tempres = GMPy_MPZ_From_IntegerAndCopy(PySequence_Fast_GET_ITEM(seq, i), context))) {
+            TYPE_ERROR("all items in iterable must be integers");
+            Py_DECREF(seq);
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, i, (PyObject*)tempres);
+
+        if (mpz_sgn(tempres->z) < 0 && !self->invertible) {
+            VALUE_ERROR("FixedBasePowMod() base not invertible");
+            Py_DECREF(seq);
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+    Py_DECREF(seq);
+
+    GMPY_PROFILE_OPN(context, GMPY_OP_POWMOD, mpz_sizeinbase(self->m, 2), n);
+    work.self = self;
+    work.items = PySequence_Fast_ITEMS(result);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(self->m) * n);
+    GMPy_Parallel_Run(_GMPy_FixedBase_Range, &work, n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    return result;
+}
+
+static PyObject *
+GMPy_FixedBase_GetBase(FixedBase_Object *self, void *closure)
+{
+    MPZ_Object *result;
+
+    if ((result = GMPy_MPZ_New(NULL)))
+        mpz_set(result->z, self->g);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_FixedBase_GetModulus(FixedBase_Object *self, void *closure)
+{
+    MPZ_Object *result;
+
+    if ((result = GMPy_MPZ_New(NULL)))
+        mpz_set(result->z, self->m);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_FixedBase_Repr_Slot(FixedBase_Object *self)
+{
+    PyObject *g, *m, *result = NULL;
+
+    if ((g = GMPy_FixedBase_GetBase(self, NULL))) {
+        if ((m = GMPy_FixedBase_GetModulus(self, NULL))) {
+            result = PyUnicode_FromFormat("FixedBasePowMod(%S, %S, %zd)", g, m,
+                                          (Py_ssize_t)self->max_bits);
+            Py_DECREF(m);
+        }
+        Py_DECREF(g);
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_FixedBase_GetMaxBits(FixedBase_Object *self, void *closure)
+{
+    return PyLong_FromSize_t((size_t)self->max_bits);
+}
+
+static PyGetSetDef GMPy_FixedBase_getseters[] =
+{
+    { "base", (getter)GMPy_FixedBase_GetBase, NULL,
+      "base reduced modulo the modulus", NULL },
+    { "modulus", (getter)GMPy_FixedBase_GetModulus, NULL,
+      "modulus", NULL },
+    { "max_bits", (getter)GMPy_FixedBase_GetMaxBits, NULL,
+      "largest exponent size, in bits, that uses the table", NULL },
+    { NULL }
+};
+
+static PyTypeObject FixedBase_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.FixedBasePowMod",
+    .tp_basicsize = sizeof(FixedBase_Object),
+    .tp_dealloc = (destructor) GMPy_FixedBase_Dealloc,
+    .tp_repr = (reprfunc) GMPy_FixedBase_Repr_Slot,
+    .tp_call = (ternaryfunc) GMPy_FixedBase_Call_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_fixedbase,
+    .tp_getset = GMPy_FixedBase_getseters,
+    .tp_new = GMPy_FixedBase_NewInit,
+};
@@ -0,0 +1,55 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_fixedbase.h                                                       *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_FIXEDBASE_H
+#define GMPY_FIXEDBASE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A FixedBasePowMod holds the powers g**(2**(width*i)) mod m so that
+ * g**e mod m can be computed without any squarings.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    mpz_t g;                /* base, reduced mod m */
+    mpz_t m;
+    mp_bitcnt_t max_bits;   /* largest exponent that uses the table */
+    int width;              /* bits per exponent digit */
+    int invertible;         /* gcd(g, m) == 1 */
+    Py_ssize_t size;        /* ceil(max_bits / width) */
+    mpz_t *table;
+} FixedBase_Object;
+
+static PyTypeObject FixedBase_Type;
+#define FixedBase_Check(v) (((PyObject*)v)->ob_type == &FixedBase_Type)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -36,7 +36,8 @@ GMPy_Integer_FloorDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
 
     CHECK_CONTEXT(context);
 
-    if (!(result = GMPy_MPZ_New(context))) {
+    if (!(result = GMPy_MPZ_Reuse(x, xtype, y, ytype)) &&
+        !(result = GMPy_MPZ_New(context))) {
         /* LCOV_EXCL_START */
         return NULL;
         /* LCOV_EXCL_STOP */
@@ -49,17 +50,16 @@ GMPy_Integer_FloorDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
                 Py_DECREF((PyObject*)result);
                 return NULL;
             }
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), MPZ(y)));
             mpz_fdiv_q(result->z, MPZ(x), MPZ(y));
             GMPY_MAYBE_END_ALLOW_THREADS(context);
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
 
         if (IS_TYPE_PyInteger(ytype)) {
-            int error;
-            long temp = PyLong_AsLongAndOverflow(y, &error);
+            long temp;
 
-            if (!error) {
+            if (GMPy_PyLong_AsSmall(y, &temp)) {
                 if (temp > 0) {
                     mpz_fdiv_q_ui(result->z, MPZ(x), temp);
                 }
@@ -75,11 +75,11 @@ GMPy_Integer_FloorDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             }
             else {
                 mpz_set_PyLong(result->z, y);
-                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), result->z));
                 mpz_fdiv_q(result->z, MPZ(x), result->z);
                 GMPY_MAYBE_END_ALLOW_THREADS(context);
             }
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
     }
 
@@ -92,10 +92,10 @@ GMPy_Integer_FloorDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
 
         if (IS_TYPE_PyInteger(xtype)) {
             mpz_set_PyLong(result->z, x);
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(result->z, MPZ(y)));
             mpz_fdiv_q(result->z, result->z, MPZ(y));
             GMPY_MAYBE_END_ALLOW_THREADS(context);
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
     }
 
@@ -120,12 +120,12 @@ GMPy_Integer_FloorDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             return NULL;
         }
 
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(tempx->z, tempy->z));
         mpz_fdiv_q(result->z, tempx->z, tempy->z);
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_DECREF((PyObject*)tempx);
         Py_DECREF((PyObject*)tempy);
-        return (PyObject*)result;
+        return GMPy_MPZ_Small_Result(result);
     }
 
     /* LCOV_EXCL_START */
@@ -160,7 +160,7 @@ GMPy_Rational_FloorDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             Py_DECREF((PyObject*)tempq);
             return NULL;
         }
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(MPQ(x), MPQ(y)));
         mpq_div(tempq->q, MPQ(x), MPQ(y));
         mpz_fdiv_q(result->z, mpq_numref(tempq->q), mpq_denref(tempq->q));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
@@ -191,7 +191,7 @@ GMPy_Rational_FloorDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             return NULL;
         }
 
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(tempx->q, tempy->q));
         mpq_div(tempq->q, tempx->q, tempy->q);
         mpz_fdiv_q(result->z, mpq_numref(tempq->q), mpq_denref(tempq->q));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
@@ -276,25 +276,30 @@ GMPy_Complex_FloorDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
     return NULL;
 }
 
+/* Indexed by GMPY_TYPE_CLASS2(xtype, ytype). */
+
+static gmpy_binary_withtype const GMPy_FloorDiv_Table[OBJ_CLASS_COUNT] = {
+    GMPy_Integer_FloorDivWithType,
+    GMPy_Rational_FloorDivWithType,
+    GMPy_Real_FloorDivWithType,
+    GMPy_Complex_FloorDivWithType,
+};
+
 /* Implement all the slot methods here. */
 
 static PyObject *
 GMPy_Number_FloorDiv_Slot(PyObject *x, PyObject *y)
 {
+    CTXT_Object *context = NULL;
+    CHECK_CONTEXT(context);
+
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_FloorDivWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_FloorDivWithType(x, xtype, y, ytype, NULL);
+    GMPY_PROFILE_OP2(context, GMPY_OP_FLOORDIV, x, xtype, y, ytype);
 
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_FloorDivWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_FloorDivWithType(x, xtype, y, ytype, NULL);
+    if (xtype && ytype)
+        return GMPy_FloorDiv_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, context);
 
     Py_RETURN_NOTIMPLEMENTED;
 }
@@ -309,17 +314,10 @@ GMPy_Number_FloorDiv(PyObject *x, PyObject *y, CTXT_Object *context)
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_FloorDivWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_FloorDivWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_FloorDivWithType(x, xtype, y, ytype, NULL);
+    GMPY_PROFILE_OP2(context, GMPY_OP_FLOORDIV, x, xtype, y, ytype);
 
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_FloorDivWithType(x, xtype, y, ytype, NULL);
+    if (xtype && ytype)
+        return GMPy_FloorDiv_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, NULL);
 
     TYPE_ERROR("floor_div() argument type not supported");
     return NULL;
@@ -38,7 +38,11 @@ PyDoc_STRVAR(GMPy_doc_mpz_format,
 "        ' ' -> minus for negative values, space for positive values\n\n"
 "     optional base indicator\n\n"
 "        '#' -> precede binary, octal, or hex with 0b, 0o or 0x\n\n"
-"     optional width\n\n"
+"     optional width; a leading 0 pads with zeros instead of spaces\n\n"
+"     optional grouping:\n\n"
+"        ',' -> separate groups of three decimal digits with commas\n"
+"        '_' -> separate groups of three decimal digits, or four\n"
+"               binary, octal or hex digits, with underscores\n\n"
 "     optional conversion code:\n\n"
 "        'd' -> decimal format\n"
 "        'b' -> binary format\n"
@@ -47,126 +51,342 @@ PyDoc_STRVAR(GMPy_doc_mpz_format,
 "        'X' -> upper-case hex format\n\n"
 "The default format is 'd'.");
 
-/* Formatting occurs in two phases. Pympz_ascii() is used to create a string
- * with the appropriate binary/octal/decimal/hex formatting, including the
- * leading sign character (+ , -, or space) and base encoding (0b, 0o, or 0x).
- * Left/right/centering using the specified width is done by creating a
- * format string and calling the __format__() method of the string object
- * returned by Pympz_ascii().
+/* Formatting occurs in two phases. The format string is parsed into a
+ * gmpy_format_spec, which is kept in a small per-thread cache since the
+ * same few format strings are usually used over and over. The sign, base
+ * prefix, digits, group separators and padding are then written directly
+ * into the result string.
  */
 
-static PyObject *
-GMPy_MPZ_Format(PyObject *self, PyObject *args)
-{
-    PyObject *result = NULL, *mpzstr = NULL;
-    char *fmtcode = 0, *p1, *p2;
-    char fmt[30];
-    int base = 10, option = 16;
-    int seensign = 0, seenindicator = 0, seenalign = 0, seendigits = 0;
+static GMPY_THREAD_LOCAL gmpy_format_entry gmpy_format_cache[GMPY_FORMAT_CACHE_SIZE];
 
-    if (!CHECK_MPZANY(self)) {
-        TYPE_ERROR("requires mpz type");
-        return NULL;
+static int
+_GMPy_Format_Width(Py_ssize_t *width, char digit)
+{
+    if (*width > (PY_SSIZE_T_MAX - 9) / 10) {
+        VALUE_ERROR("Too many decimal digits in format string");
+        return -1;
     }
+    *width = *width * 10 + (digit - '0');
+    return 0;
+}
 
-    if (!PyArg_ParseTuple(args, "s", &fmtcode))
-        return NULL;
+static int
+_GMPy_Format_Parse_MPZ(const char *fmtcode, gmpy_format_spec *spec)
+{
+    const char *p1;
+    int seensign = 0, seenindicator = 0, seenalign = 0, seendigits = 0;
+
+    spec->base = 10;
+    spec->option = 16;
 
-    p2 = fmt;
     for (p1 = fmtcode; *p1 != '\00'; p1++) {
         if (*p1 == '<' || *p1 == '>' || *p1 == '^') {
-            if (seenalign || seensign || seenindicator || seendigits) {
-                VALUE_ERROR("Invalid conversion specification");
-                return NULL;
-            }
-            else {
-                *(p2++) = *p1;
-                seenalign = 1;
-                continue;
-            }
-        }
-        if (*p1 == '+') {
-            if (seensign || seenindicator || seendigits) {
-                VALUE_ERROR("Invalid conversion specification");
-                return NULL;
-            }
-            else {
-                option |= 2;
-                seensign = 1;
-                continue;
-            }
-        }
-        if (*p1 == '-') {
-            if (seensign || seenindicator || seendigits) {
-                VALUE_ERROR("Invalid conversion specification");
-                return NULL;
-            }
-            else {
-                seensign = 1;
-                continue;
-            }
+            if (seenalign || seensign || seenindicator || seendigits || spec->sep)
+                goto invalid;
+            spec->align = *p1;
+            seenalign = 1;
+            continue;
         }
-        if (*p1 == ' ') {
-            if (seensign || seenindicator || seendigits) {
-                VALUE_ERROR("Invalid conversion specification");
-                return NULL;
-            }
-            else {
-                option |= 4;
-                seensign = 1;
-                continue;
-            }
+        if (*p1 == '+' || *p1 == '-' || *p1 == ' ') {
+            if (seensign || seenindicator || seendigits || spec->sep)
+                goto invalid;
+            if (*p1 == '+')
+                spec->option |= 2;
+            else if (*p1 == ' ')
+                spec->option |= 4;
+            seensign = 1;
+            continue;
         }
         if (*p1 == '#') {
-            if (seenindicator || seendigits) {
-                VALUE_ERROR("Invalid conversion specification");
-                return NULL;
-            }
-            else {
-                option |= 8;
-                seenindicator = 1;
-                continue;
-            }
+            if (seenindicator || seendigits || spec->sep)
+                goto invalid;
+            spec->option |= 8;
+            seenindicator = 1;
+            continue;
         }
         if (isdigit(*p1)) {
-            if (!seenalign) {
-                *(p2++) = '>';
-                seenalign = 1;
-            }
-            *(p2++) = *p1;
+            if (spec->sep)
+                goto invalid;
+            if (!seendigits && *p1 == '0')
+                spec->fill = '0';
+            if (_GMPy_Format_Width(&spec->width, *p1) < 0)
+                return -1;
             seendigits = 1;
             continue;
         }
+        if (*p1 == ',' || *p1 == '_') {
+            if (spec->sep)
+                goto invalid;
+            spec->sep = *p1;
+            continue;
+        }
         if (*p1 == 'b') {
-            base = 2;
+            spec->base = 2;
             break;
         }
         if (*p1 == 'o') {
-            base = 8;
+            spec->base = 8;
             break;
         }
         if (*p1 == 'x') {
-            base = 16;
+            spec->base = 16;
             break;
         }
         if (*p1 == 'd') {
-            base = 10;
+            spec->base = 10;
             break;
         }
         if (*p1 == 'X') {
-            base = -16;
+            spec->base = -16;
             break;
         }
-        VALUE_ERROR("Invalid conversion specification");
+        goto invalid;
+    }
+
+    if (spec->sep) {
+        if (spec->base != 10 && spec->sep == ',')
+            goto invalid;
+        spec->group = spec->base == 10 ? 3 : 4;
+    }
+    return 0;
+
+  invalid:
+    VALUE_ERROR("Invalid conversion specification");
+    return -1;
+}
+
+static int
+_GMPy_Format_Parse_MPFR(const char *fmtcode, gmpy_format_spec *spec)
+{
+    const char *p1;
+    char *p2, round = 0, conv = 'f';
+    int seensign = 0, seenalign = 0, seendecimal = 0, seendigits = 0;
+    int seenround = 0, seenwidth = 0, ndecimal = 0;
+    long prec = 0;
+
+    for (p1 = fmtcode; *p1 != '\00'; p1++) {
+        if (*p1 == '<' || *p1 == '>' || *p1 == '^') {
+            if (seenalign || seensign || seendecimal || seendigits || seenround)
+                goto invalid;
+            spec->align = *p1;
+            seenalign = 1;
+            continue;
+        }
+        if (*p1 == '+' || *p1 == ' ' || *p1 == '-') {
+            if (seensign || seendecimal || seendigits || seenround || spec->sep)
+                goto invalid;
+            if (*p1 != '-')
+                spec->signchar = *p1;
+            seensign = 1;
+            continue;
+        }
+        if (*p1 == '.') {
+            if (seendecimal || seendigits || seenround)
+                goto invalid;
+            seendecimal = 1;
+            continue;
+        }
+        if (isdigit(*p1)) {
+            if (seendigits || seenround)
+                goto invalid;
+            if (seendecimal) {
+                /* Leading zeros do not count toward the limit. */
+                if ((prec || *p1 != '0') && ++ndecimal > 9)
+                    goto invalid;
+                prec = prec * 10 + (*p1 - '0');
+                continue;
+            }
+            if (spec->sep)
+                goto invalid;
+            if (!seenwidth && *p1 == '0')
+                spec->fill = '0';
+            if (_GMPy_Format_Width(&spec->width, *p1) < 0)
+                return -1;
+            seenwidth = seenalign = 1;
+            continue;
+        }
+        if (*p1 == ',' || *p1 == '_') {
+            if (spec->sep || seendecimal || seendigits || seenround)
+                goto invalid;
+            spec->sep = *p1;
+            spec->group = 3;
+            continue;
+        }
+        seendigits = 1;
+        if (*p1 == 'U' || *p1 == 'D' || *p1 == 'Y' || *p1 == 'Z' ||
+            *p1 == 'N' ) {
+            if (seenround)
+                goto invalid;
+            round = *p1;
+            seenround = 1;
+            continue;
+        }
+        if (*p1 == 'a' || *p1 == 'A' || *p1 == 'b' || *p1 == 'e' ||
+            *p1 == 'E' || *p1 == 'f' || *p1 == 'F' || *p1 == 'g' ||
+            *p1 == 'G' ) {
+            conv = *p1;
+            break;
+        }
+        if (*p1 == 'r' && !seendecimal && !seenround) {
+            spec->shortest = 1;
+            break;
+        }
+        goto invalid;
+    }
+
+    /* Hex and binary output has no decimal digits to group. */
+
+    if (spec->sep && (conv == 'a' || conv == 'A' || conv == 'b'))
+        goto invalid;
+
+    p2 = spec->mpfrfmt;
+    *(p2++) = '%';
+    if (spec->signchar)
+        *(p2++) = spec->signchar;
+    if (seendecimal)
+        p2 += sprintf(p2, ".%ld", prec);
+    *(p2++) = 'R';
+    if (round)
+        *(p2++) = round;
+    *(p2++) = conv;
+    *(p2) = '\00';
+    return 0;
+
+  invalid:
+    VALUE_ERROR("Invalid conversion specification");
+    return -1;
+}
+
+/* Return the parsed format string fmtcode of kind 'z' (mpz) or 'f' (mpfr),
+ * from the cache or parsed into temp, or NULL if an exception is set.
+ */
+
+static const gmpy_format_spec *
+_GMPy_Format_Spec(const char *fmtcode, char kind, gmpy_format_spec *temp)
+{
+    gmpy_format_entry *entry = NULL;
+    size_t len = strlen(fmtcode), i;
+    unsigned int hash = (unsigned char)kind;
+    int ret;
+
+    if (len <= GMPY_FORMAT_KEY_MAX) {
+        for (i = 0; i < len; i++)
+            hash = hash * 31 + (unsigned char)fmtcode[i];
+        entry = &gmpy_format_cache[hash % GMPY_FORMAT_CACHE_SIZE];
+        if (entry->kind == kind && !memcmp(entry->key, fmtcode, len + 1))
+            return &entry->spec;
+    }
+
+    memset(temp, 0, sizeof(gmpy_format_spec));
+    temp->align = '>';
+    temp->fill = ' ';
+    if (kind == 'z')
+        ret = _GMPy_Format_Parse_MPZ(fmtcode, temp);
+    else
+        ret = _GMPy_Format_Parse_MPFR(fmtcode, temp);
+    if (ret < 0)
         return NULL;
+
+    if (entry) {
+        entry->kind = kind;
+        memcpy(entry->key, fmtcode, len + 1);
+        entry->spec = *temp;
+    }
+    return temp;
+}
+
+/* Return the string head + digits + tail padded as given by spec, with the
+ * separator of spec between the groups of digits. All parts are ASCII.
+ */
+
+static PyObject *
+_GMPy_Format_Write(const gmpy_format_spec *spec, const char *head, Py_ssize_t nhead,
+                   const char *digits, Py_ssize_t ndigits, const char *tail,
+                   Py_ssize_t ntail)
+{
+    PyObject *result;
+    Py_ssize_t nsep = 0, len, left = 0, right = 0, first;
+    char *out;
+
+    if (spec->sep && ndigits > 0)
+        nsep = (ndigits - 1) / spec->group;
+    len = nhead + ndigits + nsep + ntail;
+    if (spec->width > len) {
+        if (spec->align == '<')
+            right = spec->width - len;
+        else if (spec->align == '^') {
+            left = (spec->width - len) / 2;
+            right = spec->width - len - left;
+        }
+        else
+            left = spec->width - len;
     }
-    *(p2++) = '\00';
 
-    if (!(mpzstr = mpz_ascii(MPZ(self), base, option, 0)))
+    if (!(result = PyUnicode_New(left + len + right, 127)))
         return NULL;
+    out = (char*)PyUnicode_1BYTE_DATA(result);
+
+    memset(out, spec->fill, left);
+    out += left;
+    memcpy(out, head, nhead);
+    out += nhead;
+    first = ndigits - nsep * spec->group;
+    memcpy(out, digits, first);
+    out += first;
+    for (digits += first; nsep > 0; nsep--, digits += spec->group) {
+        *(out++) = spec->sep;
+        memcpy(out, digits, spec->group);
+        out += spec->group;
+    }
+    memcpy(out, tail, ntail);
+    out += ntail;
+    memset(out, spec->fill, right);
+    return result;
+}
 
-    result = PyObject_CallMethod(mpzstr, "__format__", "(s)", fmt);
-    Py_DECREF(mpzstr);
+static PyObject *
+GMPy_MPZ_Format(PyObject *self, PyObject *args)
+{
+    PyObject *result = NULL;
+    const gmpy_format_spec *spec;
+    gmpy_format_spec temp;
+    char *fmtcode = 0, *buffer, head[3];
+    Py_ssize_t nhead = 0, ndigits;
+    size_t size;
+    int base;
+    CTXT_Object *context = NULL;
+
+    if (!CHECK_MPZANY(self)) {
+        TYPE_ERROR("requires mpz type");
+        return NULL;
+    }
+
+    if (!PyArg_ParseTuple(args, "s", &fmtcode))
+        return NULL;
+
+    if (!(spec = _GMPy_Format_Spec(fmtcode, 'z', &temp)))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    base = spec->base;
+    if (mpz_sgn(MPZ(self)) < 0)
+        head[nhead++] = '-';
+    else if (spec->option & 2)
+        head[nhead++] = '+';
+    else if (spec->option & 4)
+        head[nhead++] = ' ';
+    if ((spec->option & 8) && base != 10) {
+        head[nhead++] = '0';
+        head[nhead++] = base == 2 ? 'b' : base == 8 ? 'o' : base == 16 ? 'x' : 'X';
+    }
+
+    size = mpz_sizeinbase(MPZ(self), (base < 0 ? -base : base)) + 1;
+    TEMP_ALLOC(buffer, size);
+    if ((ndigits = _GMPy_MPZ_Get_Digits(buffer, MPZ(self), base, context)) >= 0)
+        result = _GMPy_Format_Write(spec, head, nhead, buffer, ndigits, "", 0);
+    TEMP_FREE(buffer, size);
     return result;
 }
 
@@ -182,7 +402,9 @@ PyDoc_STRVAR(GMPy_doc_mpfr_format,
 "        '+' -> always display leading sign\n"
 "        '-' -> only display minus for negative values\n"
 "        ' ' -> minus for negative values, space for positive values\n\n"
-"     optional width.precision\n\n"
+"     optional width; a leading 0 pads with zeros instead of spaces\n\n"
+"     optional grouping of the integer digits by three, with ',' or '_'\n\n"
+"     optional .precision\n\n"
 "     optional rounding mode:\n\n"
 "        'U' -> round toward plus Infinity\n"
 "        'D' -> round toward minus Infinity\n"
@@ -194,18 +416,22 @@ PyDoc_STRVAR(GMPy_doc_mpfr_format,
 "        'b'     -> binary format\n"
 "        'e','E' -> scientific format\n"
 "        'f','F' -> fixed point format\n"
-"        'g','G' -> fixed or float format\n\n"
+"        'g','G' -> fixed or float format\n"
+"        'r'     -> shortest string that converts back to x at the\n"
+"                   precision of x; like repr() for a float, also\n"
+"                   for a subnormal float in the context ieee(64)\n\n"
 "The default format is '.6f'.");
 
 static PyObject *
 GMPy_MPFR_Format(PyObject *self, PyObject *args)
 {
     PyObject *result = NULL, *mpfrstr = NULL;
-    char *buffer = 0, *newbuf = 0, *fmtcode = 0, *p1, *p2, *p3;
-    char mpfrfmt[100], fmt[30];
+    const gmpy_format_spec *spec;
+    gmpy_format_spec temp;
+    char *buffer = 0, *fmtcode = 0;
+    const char *text, *head;
+    Py_ssize_t len, nhead = 0, ndigits;
     int buflen;
-    int seensign = 0, seenalign = 0, seendecimal = 0, seendigits = 0;
-    int seenround = 0, seenconv = 0;
 
     if (!MPFR_Check(self)) {
         TYPE_ERROR("requires mpfr type");
@@ -215,134 +441,51 @@ GMPy_MPFR_Format(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "s", &fmtcode))
         return NULL;
 
-    p2 = mpfrfmt;
-    p3 = fmt;
-    *(p2++) = '%';
+    if (!(spec = _GMPy_Format_Spec(fmtcode, 'f', &temp)))
+        return NULL;
 
-    for (p1 = fmtcode; *p1 != '\00'; p1++) {
-        if (*p1 == '<' || *p1 == '>' || *p1 == '^') {
-            if (seenalign || seensign || seendecimal || seendigits || seenround) {
-                VALUE_ERROR("Invalid conversion specification");
-                return NULL;
-            }
-            else {
-                *(p3++) = *p1;
-                seenalign = 1;
-                continue;
-            }
-        }
-        if (*p1 == '+' || *p1 == ' ') {
-            if (seensign || seendecimal || seendigits || seenround) {
-                VALUE_ERROR("Invalid conversion specification");
-                return NULL;
-            }
-            else {
-                *(p2++) = *p1;
-                seensign = 1;
-                continue;
-            }
-        }
-        if (*p1 == '-') {
-            if (seensign || seendecimal || seendigits || seenround) {
-                VALUE_ERROR("Invalid conversion specification");
-                return NULL;
-            }
-            else {
-                seensign = 1;
-                continue;
-            }
-        }
-        if (*p1 == '.') {
-            if (seendecimal || seendigits || seenround) {
-                VALUE_ERROR("Invalid conversion specification");
-                return NULL;
-            }
-            else {
-                *(p2++) = *p1;
-                seendecimal = 1;
-                continue;
-            }
-        }
-        if (isdigit(*p1)) {
-            if (seendigits || seenround) {
-                VALUE_ERROR("Invalid conversion specification");
-                return NULL;
-            }
-            else if (seendecimal) {
-                *(p2++) = *p1;
-                continue;
-            }
-            else {
-                if (p3 == fmt) {
-                    *(p3++) = '>';
-                    seenalign = 1;
-                }
-                *(p3++) = *p1;
-                continue;
-            }
-        }
-        if (!seendigits) {
-            seendigits = 1;
-            *(p2++) = 'R';
+    /* 'r' gives the shortest string that reads back as the same value. */
+
+    if (spec->shortest) {
+        if (!(mpfrstr = GMPy_PyStr_Shortest_From_MPFR((MPFR_Object*)self, NULL)))
+            return NULL;
+        if (!(text = PyUnicode_AsUTF8AndSize(mpfrstr, &len))) {
+            Py_DECREF(mpfrstr);
+            return NULL;
         }
-        if (*p1 == 'U' || *p1 == 'D' || *p1 == 'Y' || *p1 == 'Z' ||
-            *p1 == 'N' ) {
-            if (seenround) {
-                VALUE_ERROR("Invalid conversion specification");
-                return NULL;
-            }
-            else {
-                *(p2++) = *p1;
-                seenround = 1;
-                continue;
-            }
+        if (*text == '-') {
+            head = text++;
+            nhead = 1;
+            len--;
         }
-        if (*p1 == 'a' || *p1 == 'A' || *p1 == 'b' || *p1 == 'e' ||
-            *p1 == 'E' || *p1 == 'f' || *p1 == 'F' || *p1 == 'g' ||
-            *p1 == 'G' ) {
-            *(p2++) = *p1;
-            seenconv = 1;
-            break;
+        else {
+            head = &spec->signchar;
+            nhead = spec->signchar && !mpfr_signbit(MPFR(self));
         }
-        VALUE_ERROR("Invalid conversion specification");
-        return NULL;
+        ndigits = strspn(text, "0123456789");
+        result = _GMPy_Format_Write(spec, head, nhead, text, ndigits,
+                                    text + ndigits, len - ndigits);
+        Py_DECREF(mpfrstr);
+        return result;
     }
 
-    if (!seendigits)
-        *(p2++) = 'R';
-    if (!seenconv)
-        *(p2++) = 'f';
-
-    *(p2) = '\00';
-    *(p3) = '\00';
+    if ((buflen = mpfr_asprintf(&buffer, spec->mpfrfmt, MPFR(self))) < 0)
+        return PyErr_NoMemory();
 
-    buflen = mpfr_asprintf(&buffer, mpfrfmt, MPFR(self));
+    if (*buffer == '+' || *buffer == '-' || *buffer == ' ')
+        nhead = 1;
+    ndigits = strspn(buffer + nhead, "0123456789");
 
     /* If there isn't a decimal point in the output and the output
      * only consists of digits, then append .0 */
-    if (strlen(buffer) == strspn(buffer, "+- 0123456789")) {
-        newbuf = malloc(buflen + 3);
-        if (!newbuf) {
-            mpfr_free_str(buffer);
-            return PyErr_NoMemory();
-        }
-        *newbuf = '\0';
-        strcat(newbuf, buffer);
-        strcat(newbuf, ".0");
-        mpfr_free_str(buffer);
-        mpfrstr = Py_BuildValue("s", newbuf);
-        free(newbuf);
-    }
-    else {
-        mpfrstr = Py_BuildValue("s", buffer);
-        mpfr_free_str(buffer);
-    }
-    if (!mpfrstr) {
-        return NULL;
-    }
-
-    result = PyObject_CallMethod(mpfrstr, "__format__", "(s)", fmt);
-    Py_DECREF(mpfrstr);
+    if (nhead + ndigits == buflen)
+        result = _GMPy_Format_Write(spec, buffer, nhead, buffer + nhead,
+                                    ndigits, ".0", 2);
+    else
+        result = _GMPy_Format_Write(spec, buffer, nhead, buffer + nhead,
+                                    ndigits, buffer + nhead + ndigits,
+                                    buflen - nhead - ndigits);
+    mpfr_free_str(buffer);
     return result;
 }
 
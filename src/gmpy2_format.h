@@ -31,6 +31,33 @@
 extern "C" {
 #endif
 
+/* A parsed format specification of mpz.__format__() or mpfr.__format__().
+ * Recently used specifications are kept in a small cache for each thread,
+ * indexed by a hash of the format string.
+ */
+
+typedef struct {
+    Py_ssize_t width;
+    char align;                 /* '<', '>' or '^' */
+    char fill;                  /* ' ', or '0' if the width starts with 0 */
+    char sep;                   /* ',' or '_' between groups, or 0 */
+    char group;                 /* digits in a group */
+    int base;                   /* mpz: base as for mpz_ascii() */
+    int option;                 /* mpz: option as for mpz_ascii() */
+    char signchar;              /* mpfr: '+', ' ' or 0 */
+    char shortest;              /* mpfr: 'r' conversion */
+    char mpfrfmt[24];           /* mpfr: format for mpfr_asprintf() */
+} gmpy_format_spec;
+
+#define GMPY_FORMAT_CACHE_SIZE 16
+#define GMPY_FORMAT_KEY_MAX 23
+
+typedef struct {
+    char kind;                  /* 'z' or 'f', 0 if unused */
+    char key[GMPY_FORMAT_KEY_MAX + 1];
+    gmpy_format_spec spec;
+} gmpy_format_entry;
+
 
 static PyObject * GMPy_MPZ_Digits_Method(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Format(PyObject *self, PyObject *args);
@@ -35,7 +35,7 @@ _GMPy_MPZ_FMA(PyObject *x, PyObject *y, PyObject *z, CTXT_Object *context)
         /* LCOV_EXCL_STOP */
     }
 
-    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), MPZ(y)));
     mpz_mul(result->z, MPZ(x), MPZ(y));
     mpz_add(result->z, result->z, MPZ(z));
     GMPY_MAYBE_END_ALLOW_THREADS(context);
@@ -76,7 +76,7 @@ _GMPy_MPQ_FMA(PyObject *x, PyObject *y, PyObject *z, CTXT_Object *context)
         /* LCOV_EXCL_STOP */
     }
 
-    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(MPQ(x), MPQ(y)));
     mpq_mul(result->q, MPQ(x), MPQ(y));
     mpq_add(result->q, result->q, MPQ(z));
     GMPY_MAYBE_END_ALLOW_THREADS(context);
@@ -207,7 +207,7 @@ _GMPy_MPZ_FMS(PyObject *x, PyObject *y, PyObject *z, CTXT_Object *context)
         /* LCOV_EXCL_STOP */
     }
 
-    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), MPZ(y)));
     mpz_mul(result->z, MPZ(x), MPZ(y));
     mpz_sub(result->z, result->z, MPZ(z));
     GMPY_MAYBE_END_ALLOW_THREADS(context);
@@ -248,7 +248,7 @@ _GMPy_MPQ_FMS(PyObject *x, PyObject *y, PyObject *z, CTXT_Object *context)
         /* LCOV_EXCL_STOP */
     }
 
-    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(MPQ(x), MPQ(y)));
     mpq_mul(result->q, MPQ(x), MPQ(y));
     mpq_sub(result->q, result->q, MPQ(z));
     GMPY_MAYBE_END_ALLOW_THREADS(context);
@@ -389,7 +389,7 @@ _GMPy_MPZ_FMMA(PyObject *x, PyObject *y, PyObject *z, PyObject *t, CTXT_Object *
         /* LCOV_EXCL_STOP */
     }
 
-    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), MPZ(y)));
     mpz_mul(result->z, MPZ(x), MPZ(y));
     mpz_mul(temp->z, MPZ(z), MPZ(t));
     mpz_add(result->z, result->z, temp->z);
@@ -439,7 +439,7 @@ _GMPy_MPQ_FMMA(PyObject *x, PyObject *y, PyObject *z, PyObject *t, CTXT_Object *
         /* LCOV_EXCL_STOP */
     }
 
-    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(MPQ(x), MPQ(y)));
     mpq_mul(result->q, MPQ(x), MPQ(y));
     mpq_mul(temp->q, MPQ(z), MPQ(t));
     mpq_add(result->q, result->q, temp->q);
@@ -544,7 +544,7 @@ _GMPy_MPZ_FMMS(PyObject *x, PyObject *y, PyObject *z, PyObject *t, CTXT_Object *
         /* LCOV_EXCL_STOP */
     }
 
-    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), MPZ(y)));
     mpz_mul(result->z, MPZ(x), MPZ(y));
     mpz_mul(temp->z, MPZ(z), MPZ(t));
     mpz_sub(result->z, result->z, temp->z);
@@ -594,7 +594,7 @@ _GMPy_MPQ_FMMS(PyObject *x, PyObject *y, PyObject *z, PyObject *t, CTXT_Object *
         /* LCOV_EXCL_STOP */
     }
 
-    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(MPQ(x), MPQ(y)));
     mpq_mul(result->q, MPQ(x), MPQ(y));
     mpq_mul(temp->q, MPQ(z), MPQ(t));
     mpq_sub(result->q, result->q, temp->q);
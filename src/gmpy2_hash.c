@@ -24,29 +24,129 @@
  * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+/* The hash of an object is computed when it is first needed and kept in
+ * hash_cache. In a free-threaded build it is read and published with
+ * relaxed atomics; threads that race compute and store the same value.
+ */
+
+#ifdef Py_GIL_DISABLED
+#  define HASH_CACHE_GET(obj)    _Py_atomic_load_ssize_relaxed(&(obj)->hash_cache)
+#  define HASH_CACHE_SET(obj, h) _Py_atomic_store_ssize_relaxed(&(obj)->hash_cache, (h))
+#else
+#  define HASH_CACHE_GET(obj)    ((obj)->hash_cache)
+#  define HASH_CACHE_SET(obj, h) ((obj)->hash_cache = (h))
+#endif
+
+#ifdef _PyHASH_MODULUS
+
+/* The hashes of integers, rationals and floats are residues modulo the
+ * Mersenne prime P = 2**_PyHASH_BITS - 1. Since a limb has more bits than
+ * P, 2**GMP_NUMB_BITS == 2**(GMP_NUMB_BITS - _PyHASH_BITS) (mod P), and a
+ * number is reduced limb by limb with shifts and adds instead of
+ * mpn_mod_1().
+ */
+
+#define HASH_FOLD(v) (((v) & _PyHASH_MODULUS) + ((v) >> _PyHASH_BITS))
+
+static mp_limb_t
+_GMPy_Hash_Limbs(const mp_limb_t *d, size_t n)
+{
+    mp_limb_t h = 0;
+
+    while (n--) {
+        h = HASH_FOLD(h << (GMP_NUMB_BITS - _PyHASH_BITS)) + HASH_FOLD(d[n]);
+        h = HASH_FOLD(h);
+        if (h >= _PyHASH_MODULUS)
+            h -= _PyHASH_MODULUS;
+    }
+    return h;
+}
+
+/* Return a*b mod P for a, b < P. */
+
+static mp_limb_t
+_GMPy_Hash_MulMod(mp_limb_t a, mp_limb_t b)
+{
+    mp_limb_t prod[2];
+
+    prod[1] = mpn_mul_1(prod, &a, 1, b);
+    return _GMPy_Hash_Limbs(prod, 2);
+}
+
+/* Return the inverse of d mod P for 0 < d < P, by the extended Euclidean
+ * algorithm. The inverses of small denominators are kept in a table.
+ */
+
+#define GMPY_HASH_SMALL_DEN 256
+
+static mp_limb_t hash_inverse_small[GMPY_HASH_SMALL_DEN];
+
+static mp_limb_t
+_GMPy_Hash_Inverse(mp_limb_t d)
+{
+    long long t = 0, newt = 1, q, temp;
+    unsigned long long r = _PyHASH_MODULUS, newr = d, tempr;
+
+    if (d < GMPY_HASH_SMALL_DEN && hash_inverse_small[d])
+        return hash_inverse_small[d];
+
+    while (newr) {
+        q = (long long)(r / newr);
+        temp = t - q * newt;
+        t = newt;
+        newt = temp;
+        tempr = r - (unsigned long long)q * newr;
+        r = newr;
+        newr = tempr;
+    }
+    if (t < 0)
+        t += _PyHASH_MODULUS;
+    return (mp_limb_t)t;
+}
+
+static void
+GMPy_Hash_Init(void)
+{
+    mp_limb_t d;
+
+    for (d = 1; d < GMPY_HASH_SMALL_DEN; d++)
+        hash_inverse_small[d] = _GMPy_Hash_Inverse(d);
+}
+
+#else
+
+static void
+GMPy_Hash_Init(void)
+{
+}
+
+#endif
+
 static Py_hash_t
 GMPy_MPZ_Hash_Slot(MPZ_Object *self)
 {
 #ifdef _PyHASH_MODULUS
     Py_hash_t hash;
 
-    if (self->hash_cache != -1) {
-        return self->hash_cache;
+    if ((hash = HASH_CACHE_GET(self)) != -1) {
+        return hash;
     }
 
-    hash = (Py_hash_t)mpn_mod_1(self->z->_mp_d, mpz_size(self->z), _PyHASH_MODULUS);
+    hash = (Py_hash_t)_GMPy_Hash_Limbs(self->z->_mp_d, mpz_size(self->z));
     if (mpz_sgn(self->z) < 0) {
         hash = -hash;
     }
     if (hash == -1) {
         hash = -2;
     }
-    return (self->hash_cache = hash);
+    HASH_CACHE_SET(self, hash);
+    return hash;
 #else
+    Py_hash_t hash;
     unsigned long x;
 
-    if (self->hash_cache != -1) {
-        return self->hash_cache;
+    if ((hash = HASH_CACHE_GET(self)) != -1) {
+        return hash;
     }
 
     x = (unsigned long)mpn_mod_1(self->z->_mp_d, mpz_size(self->z), ULONG_MAX);
@@ -56,7 +156,8 @@ GMPy_MPZ_Hash_Slot(MPZ_Object *self)
     if (x == (unsigned long)-1) {
         x = (unsigned long)-2;
     }
-    return (self->hash_cache = (long)x);
+    HASH_CACHE_SET(self, (Py_hash_t)x);
+    return (Py_hash_t)x;
 #endif
 }
 
@@ -64,38 +165,24 @@ static Py_hash_t
 GMPy_MPQ_Hash_Slot(MPQ_Object *self)
 {
 #ifdef _PyHASH_MODULUS
-    Py_hash_t hash = 0;
-    mpz_t temp, temp1, mask;
+    Py_hash_t hash;
+    mp_limb_t num, den;
 
-    if (self->hash_cache != -1) {
-        return self->hash_cache;
+    if ((hash = HASH_CACHE_GET(self)) != -1) {
+        return hash;
     }
 
-    mpz_init(temp);
-    mpz_init(temp1);
-    mpz_init(mask);
-    mpz_set_si(mask, 1);
-    mpz_mul_2exp(mask, mask, _PyHASH_BITS);
-    mpz_sub_ui(mask, mask, 1);
-
-    if (!mpz_invert(temp, mpq_denref(self->q), mask)) {
-        mpz_clear(temp);
-        mpz_clear(temp1);
-        mpz_clear(mask);
+    /* As for fractions.Fraction, the hash is |num| * den**-1 mod P, or
+     * inf if P divides den.
+     */
+    num = _GMPy_Hash_Limbs(mpq_numref(self->q)->_mp_d, mpz_size(mpq_numref(self->q)));
+    den = _GMPy_Hash_Limbs(mpq_denref(self->q)->_mp_d, mpz_size(mpq_denref(self->q)));
+    if (den == 0) {
         hash = _PyHASH_INF;
-        if (mpz_sgn(mpq_numref(self->q)) < 0) {
-            hash = -hash;
-        }
-        self->hash_cache = hash;
-        return hash;
     }
-    mpz_set(temp1, mask);
-    mpz_sub_ui(temp1, temp1, 2);
-    mpz_powm(temp, mpq_denref(self->q), temp1, mask);
-
-    mpz_tdiv_r(temp1, mpq_numref(self->q), mask);
-    mpz_mul(temp, temp, temp1);
-    hash = (Py_hash_t)mpn_mod_1(temp->_mp_d, mpz_size(temp), _PyHASH_MODULUS);
+    else {
+        hash = (Py_hash_t)_GMPy_Hash_MulMod(num, _GMPy_Hash_Inverse(den));
+    }
 
     if (mpz_sgn(mpq_numref(self->q)) < 0) {
         hash = -hash;
@@ -103,25 +190,26 @@ GMPy_MPQ_Hash_Slot(MPQ_Object *self)
     if (hash == -1) {
         hash = -2;
     }
-    mpz_clear(temp);
-    mpz_clear(temp1);
-    mpz_clear(mask);
-    self->hash_cache = hash;
+    HASH_CACHE_SET(self, hash);
     return hash;
 #else
+    Py_hash_t hash;
     PyObject *temp;
 
-    if (self->hash_cache != -1) {
-        return self->hash_cache;
+    if ((hash = HASH_CACHE_GET(self)) != -1) {
+        return hash;
     }
 
     if (!(temp = GMPy_PyFloat_From_MPQ(self, NULL))) {
         SYSTEM_ERROR("Could not convert 'mpq' to float.");
         return -1;
     }
-    self->hash_cache = PyObject_Hash(temp);
+    hash = PyObject_Hash(temp);
     Py_DECREF(temp);
-    return self->hash_cache;
+    if (hash != -1) {
+        HASH_CACHE_SET(self, hash);
+    }
+    return hash;
 #endif
 }
 
@@ -131,7 +219,7 @@ _mpfr_hash(mpfr_t f)
 #ifdef _PyHASH_MODULUS
     Py_uhash_t hash = 0;
     Py_ssize_t exp;
-    size_t msize;
+    size_t msize, low;
     int sign;
 
     /* Handle special cases first */
@@ -154,24 +242,23 @@ _mpfr_hash(mpfr_t f)
         }
     }
 
-    /* Calculate the number of limbs in the mantissa. */
+    if (mpfr_zero_p(f)) {
+        return 0;
+    }
+    sign = mpfr_sgn(f) > 0 ? 1 : -1;
+
+    /* Calculate the number of limbs in the mantissa, less the low limbs
+     * that are zero, which is most of them for a short value stored at a
+     * high precision.
+     */
     msize = (f->_mpfr_prec + mp_bits_per_limb - 1) / mp_bits_per_limb;
+    for (low = 0; f->_mpfr_d[low] == 0; low++);
 
     /* Calculate the hash of the mantissa. */
-    if (mpfr_sgn(f) > 0) {
-        hash = mpn_mod_1(f->_mpfr_d, msize, _PyHASH_MODULUS);
-        sign = 1;
-    }
-    else if (mpfr_sgn(f) < 0) {
-        hash = mpn_mod_1(f->_mpfr_d, msize, _PyHASH_MODULUS);
-        sign = -1;
-    }
-    else {
-        return 0;
-    }
+    hash = _GMPy_Hash_Limbs(f->_mpfr_d + low, msize - low);
 
     /* Calculate the final hash. */
-    exp = f->_mpfr_exp - (msize * mp_bits_per_limb);
+    exp = f->_mpfr_exp - ((msize - low) * mp_bits_per_limb);
     exp = exp >= 0 ? exp % _PyHASH_BITS : _PyHASH_BITS-1-((-1-exp) % _PyHASH_BITS);
     hash = ((hash << exp) & _PyHASH_MODULUS) | hash >> (_PyHASH_BITS - exp);
 
@@ -193,19 +280,23 @@ _mpfr_hash(mpfr_t f)
 static Py_hash_t
 GMPy_MPFR_Hash_Slot(MPFR_Object *self)
 {
-    if (self->hash_cache == -1) {
-        self->hash_cache = _mpfr_hash(self->f);
+    Py_hash_t hash;
+
+    if ((hash = HASH_CACHE_GET(self)) == -1) {
+        hash = _mpfr_hash(self->f);
+        HASH_CACHE_SET(self, hash);
     }
-    return self->hash_cache;
+    return hash;
 }
 
 static Py_hash_t
 GMPy_MPC_Hash_Slot(MPC_Object *self)
 {
+    Py_hash_t hash;
     Py_uhash_t hashreal, hashimag, combined;
 
-    if (self->hash_cache != -1) {
-        return self->hash_cache;
+    if ((hash = HASH_CACHE_GET(self)) != -1) {
+        return hash;
     }
 
     hashreal = (Py_uhash_t)_mpfr_hash(mpc_realref(self->c));
@@ -220,7 +311,55 @@ GMPy_MPC_Hash_Slot(MPC_Object *self)
     if (combined == (Py_uhash_t)(-1)) {
         combined = (Py_uhash_t)(-2);
     }
-    self->hash_cache = combined;
+    HASH_CACHE_SET(self, (Py_hash_t)combined);
     return (Py_hash_t)combined;
 }
 
+
+PyDoc_STRVAR(GMPy_doc_function_hash_many,
+"hash_many(values, /) -> list[int]\n\n"
+"Return the hashes of the values in the iterable values, as\n"
+"[hash(v) for v in values] does. The hashes of mpz, mpq, mpfr, and mpc\n"
+"values are computed directly and kept in the objects, so a dict or set\n"
+"built from them afterwards does not compute them again.");
+
+static PyObject *
+GMPy_Function_Hash_Many(PyObject *self, PyObject *other)
+{
+    PyObject *seq, *item, *result, *temp;
+    Py_ssize_t i, n;
+    Py_hash_t hash;
+
+    if (!(seq = PySequence_Fast(other, "hash_many() requires an iterable")))
+        return NULL;
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    if (!(result = PyList_New(n))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(seq);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    for (i = 0; i < n; i++) {
+        item = PySequence_Fast_GET_ITEM(seq, i);
+        if (MPZ_Check(item))
+            hash = GMPy_MPZ_Hash_Slot((MPZ_Object*)item);
+        else if (MPQ_Check(item))
+            hash = GMPy_MPQ_Hash_Slot((MPQ_Object*)item);
+        else if (MPFR_Check(item))
+            hash = GMPy_MPFR_Hash_Slot((MPFR_Object*)item);
+        else if (MPC_Check(item))
+            hash = GMPy_MPC_Hash_Slot((MPC_Object*)item);
+        else
+            hash = PyObject_Hash(item);
+        if (hash == -1 || !(temp = PyLong_FromSsize_t(hash))) {
+            Py_DECREF(result);
+            Py_DECREF(seq);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, i, temp);
+    }
+    Py_DECREF(seq);
+    return result;
+}
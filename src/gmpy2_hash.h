@@ -35,6 +35,8 @@ static Py_hash_t GMPy_MPZ_Hash_Slot(MPZ_Object *self);
 static Py_hash_t GMPy_MPQ_Hash_Slot(MPQ_Object *self);
 static Py_hash_t GMPy_MPFR_Hash_Slot(MPFR_Object *self);
 static Py_hash_t GMPy_MPC_Hash_Slot(MPC_Object *self);
+static PyObject * GMPy_Function_Hash_Many(PyObject *self, PyObject *other);
+static void GMPy_Hash_Init(void);
 
 
 #ifdef __cplusplus
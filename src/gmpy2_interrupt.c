@@ -0,0 +1,147 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_interrupt.c                                                       *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* The computation that the current thread polls for, or NULL. The threads
+ * of GMPy_Parallel_Run() inherit it from the calling thread.
+ */
+
+static GMPY_THREAD_LOCAL gmpy_interrupt *interrupt_current = NULL;
+
+/* Nanoseconds on the clock of time.monotonic(). It is read while the GIL
+ * is released.
+ */
+
+static long long
+GMPy_Monotonic(void)
+{
+#if PY_VERSION_HEX >= 0x030D0000
+    PyTime_t t;
+
+    if (PyTime_MonotonicRaw(&t) < 0) {
+        return 0;
+    }
+    return (long long)t;
+#else
+    return (long long)_PyTime_GetMonotonicClock();
+#endif
+}
+
+/* Set up intr for a computation under context that is nested in prev,
+ * which may be NULL.
+ */
+
+static void
+GMPy_Interrupt_Init(gmpy_interrupt *intr, CTXT_Object *context,
+                    gmpy_interrupt *prev)
+{
+    long long now = GMPy_Monotonic(), limit;
+
+    intr->save = NULL;
+    intr->prev = prev;
+    intr->owner = PyThread_get_thread_ident();
+    intr->next_signals = now + GMPY_INTERRUPT_SIGNAL_NS;
+    intr->stop = 0;
+
+    /* The earliest of the context's deadline, now + max_time, and the
+     * deadline of an enclosing computation applies. Values of 1e9 seconds
+     * or more, including infinity, mean no limit.
+     */
+    intr->deadline = intr->prev ? intr->prev->deadline : 0;
+    if (context->ctx.deadline > 0.0 && context->ctx.deadline < 1e9) {
+        limit = (long long)(context->ctx.deadline * 1e9);
+        if (!intr->deadline || limit < intr->deadline)
+            intr->deadline = limit;
+    }
+    if (context->ctx.max_time > 0.0 && context->ctx.max_time < 1e9) {
+        limit = now + (long long)(context->ctx.max_time * 1e9);
+        if (!intr->deadline || limit < intr->deadline)
+            intr->deadline = limit;
+    }
+}
+
+static void
+GMPy_Interrupt_Begin(gmpy_interrupt *intr, CTXT_Object *context)
+{
+    GMPy_Interrupt_Init(intr, context, interrupt_current);
+    interrupt_current = intr;
+}
+
+static int
+GMPy_Interrupt_End(gmpy_interrupt *intr)
+{
+    interrupt_current = intr->prev;
+    if (!intr->stop)
+        return 0;
+
+    /* An enclosing computation stops as well. */
+    if (intr->prev)
+        intr->prev->stop = intr->stop;
+    if (intr->stop == GMPY_INTERRUPT_TIMEOUT)
+        PyErr_SetString(PyExc_TimeoutError,
+                        "computation did not finish before the context's deadline");
+    return -1;
+}
+
+static int
+GMPy_Interrupt_Poll(void)
+{
+    gmpy_interrupt *intr = interrupt_current;
+    long long now;
+    int result;
+
+    if (!intr)
+        return 0;
+    if (intr->stop)
+        return 1;
+
+    now = GMPy_Monotonic();
+    if (intr->deadline && now >= intr->deadline) {
+        intr->stop = GMPY_INTERRUPT_TIMEOUT;
+        return 1;
+    }
+
+    /* Python runs signal handlers in the main thread only, so only the
+     * thread that began the computation checks for them.
+     */
+    if (now < intr->next_signals ||
+        intr->owner != PyThread_get_thread_ident())
+        return 0;
+    intr->next_signals = now + GMPY_INTERRUPT_SIGNAL_NS;
+
+    if (intr->save && *intr->save) {
+        PyEval_RestoreThread(*intr->save);
+        result = PyErr_CheckSignals();
+        *intr->save = PyEval_SaveThread();
+    }
+    else {
+        result = PyErr_CheckSignals();
+    }
+    if (result < 0) {
+        intr->stop = GMPY_INTERRUPT_SIGNAL;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_interrupt.h                                                       *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_INTERRUPT_H
+#define GMPY_INTERRUPT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Cooperative interruption of long computations.
+ *
+ * A computation is bracketed by GMPy_Interrupt_Begin() and
+ * GMPy_Interrupt_End(), both called with the GIL held. In between, its
+ * loops call GMPy_Interrupt_Poll() between units of work. The poll does
+ * not need the GIL and also works in the threads of GMPy_Parallel_Run().
+ * It returns 1 once the context's deadline or max_time has passed, or
+ * once a signal handler raised an exception in the calling thread; the
+ * loops then stop early and GMPy_Interrupt_End() returns -1 with
+ * TimeoutError or the exception (usually KeyboardInterrupt) set.
+ */
+
+typedef struct gmpy_interrupt {
+    PyThreadState **save;       /* GIL state of the caller; NULL if held */
+    struct gmpy_interrupt *prev;
+    unsigned long owner;        /* thread that checks for signals */
+    long long deadline;         /* GMPy_Monotonic() time, 0 for none */
+    long long next_signals;     /* time of the next check for signals */
+    volatile int stop;          /* GMPY_INTERRUPT_TIMEOUT or _SIGNAL */
+} gmpy_interrupt;
+
+#define GMPY_INTERRUPT_TIMEOUT 1
+#define GMPY_INTERRUPT_SIGNAL 2
+
+/* Nanoseconds between two checks for signals; taking the GIL back is much
+ * more expensive than reading the clock.
+ */
+
+#define GMPY_INTERRUPT_SIGNAL_NS 10000000LL
+
+static long long GMPy_Monotonic(void);
+static void GMPy_Interrupt_Init(gmpy_interrupt *intr, CTXT_Object *context,
+                                gmpy_interrupt *prev);
+static void GMPy_Interrupt_Begin(gmpy_interrupt *intr, CTXT_Object *context);
+static int GMPy_Interrupt_End(gmpy_interrupt *intr);
+static int GMPy_Interrupt_Poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1801,7 +1801,6 @@ GMPy_Context_NextToward(PyObject *self, PyObject *args)
     MPFR_Object *result, *tempx, *tempy;
     CTXT_Object *context = NULL;
     int direction;
-    mpfr_rnd_t temp_round;
 
     if (self && CTXT_Check(self)) {
         context = (CTXT_Object*)self;
@@ -1838,13 +1837,7 @@ GMPy_Context_NextToward(PyObject *self, PyObject *args)
     direction = mpfr_signbit(tempy->f);
     Py_DECREF((PyObject*)tempx);
     Py_DECREF((PyObject*)tempy);
-    temp_round = GET_MPFR_ROUND(context);
-    if (direction)
-        context->ctx.mpfr_round = MPFR_RNDD;
-    else
-         context->ctx.mpfr_round = MPFR_RNDU;
-    _GMPy_MPFR_Cleanup(&result, context);
-    context->ctx.mpfr_round = temp_round;
+    _GMPy_MPFR_Cleanup_Round(&result, context, direction ? MPFR_RNDD : MPFR_RNDU);
     return (PyObject*)result;
 }
 
@@ -1861,7 +1854,6 @@ GMPy_Context_NextAbove(PyObject *self, PyObject *other)
 {
     MPFR_Object *result, *tempx;
     CTXT_Object *context = NULL;
-    mpfr_rnd_t temp_round;
 
     if (self && CTXT_Check(self)) {
         context = (CTXT_Object*)self;
@@ -1886,10 +1878,7 @@ GMPy_Context_NextAbove(PyObject *self, PyObject *other)
     Py_DECREF((PyObject*)tempx);
     mpfr_nextabove(result->f);
     result->rc = 0;
-    temp_round = GET_MPFR_ROUND(context);
-    context->ctx.mpfr_round = MPFR_RNDU;
-    _GMPy_MPFR_Cleanup(&result, context);
-    context->ctx.mpfr_round = temp_round;
+    _GMPy_MPFR_Cleanup_Round(&result, context, MPFR_RNDU);
     return (PyObject*)result;
 }
 
@@ -1906,7 +1895,6 @@ GMPy_Context_NextBelow(PyObject *self, PyObject *other)
 {
     MPFR_Object *result, *tempx;
     CTXT_Object *context = NULL;
-    mpfr_rnd_t temp_round;
 
     if (self && CTXT_Check(self)) {
         context = (CTXT_Object*)self;
@@ -1931,10 +1919,7 @@ GMPy_Context_NextBelow(PyObject *self, PyObject *other)
     Py_DECREF((PyObject*)tempx);
     mpfr_nextbelow(result->f);
     result->rc = 0;
-    temp_round = GET_MPFR_ROUND(context);
-    context->ctx.mpfr_round = MPFR_RNDD;
-    _GMPy_MPFR_Cleanup(&result, context);
-    context->ctx.mpfr_round = temp_round;
+    _GMPy_MPFR_Cleanup_Round(&result, context, MPFR_RNDD);
     return (PyObject*)result;
 }
 
@@ -1993,11 +1978,13 @@ GMPy_Context_Factorial(PyObject *self, PyObject *other)
 
 PyDoc_STRVAR(GMPy_doc_function_fsum,
 "fsum(iterable, /) -> mpfr\n\n"
-"Return an accurate sum of the values in the iterable.");
+"Return an accurate sum of the values in the iterable. The elements of\n"
+"an mpfr_array are summed without converting them.");
 
 PyDoc_STRVAR(GMPy_doc_context_fsum,
 "fsum(iterable, /) -> mpfr\n\n"
-"Return an accurate sum of the values in the iterable.");
+"Return an accurate sum of the values in the iterable. The elements of\n"
+"an mpfr_array are summed without converting them.");
 
 static PyObject *
 GMPy_Context_Fsum(PyObject *self, PyObject *other)
@@ -2015,6 +2002,10 @@ GMPy_Context_Fsum(PyObject *self, PyObject *other)
         CHECK_CONTEXT(context);
     }
 
+    if (MPFR_Array_Check(other)) {
+        return GMPy_MPFR_Array_Sum((MPFR_Array_Object*)other, context);
+    }
+
     if (!(result = GMPy_MPFR_New(0, context))) {
         return NULL;
     }
@@ -0,0 +1,1499 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_matrix.c                                                          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Small dense matrices of integers, rationals, or reals.
+ *
+ * A matrix argument is a sequence of rows or an mpz_array with a square
+ * number of elements that is read in row-major order. The entries are
+ * converted once to the common kind, using the VECTOR_* kinds of
+ * gmpy2_vector.c, and a gmpy_matrix stores row-major pointers to their
+ * mpz_t, mpq_t, or mpfr_t values. The results are allocated before the GIL
+ * is released and the kernels write to them directly.
+ *
+ * Integer and rational determinants and solutions are exact. Rational rows
+ * are first scaled to integers so the elimination can use the fraction-free
+ * Bareiss algorithm, where every division is exact. Real matrices use
+ * Gaussian elimination with partial pivoting at the precision of the
+ * context.
+ */
+
+#define MATRIX_BLOCK 16
+
+typedef struct {
+    Py_ssize_t rows, cols;
+    int kind;
+    PyObject *flat;             /* list of the entries, or NULL */
+    int *types;
+    PyObject *keep;             /* tuple of converted entries, or mpz_array */
+    void **e;                   /* row-major pointers to the values */
+} gmpy_matrix;
+
+#define MAT_Z(m, i, j) ((mpz_ptr)(m)->e[(i) * (m)->cols + (j)])
+#define MAT_Q(m, i, j) ((mpq_ptr)(m)->e[(i) * (m)->cols + (j)])
+#define MAT_F(m, i, j) ((mpfr_ptr)(m)->e[(i) * (m)->cols + (j)])
+
+static void
+_GMPy_Matrix_Clear(gmpy_matrix *m)
+{
+    PyMem_Free(m->e);
+    PyMem_Free(m->types);
+    Py_XDECREF(m->flat);
+    Py_XDECREF(m->keep);
+}
+
+/* Read the shape and the kind of a matrix, or of a column vector if vector
+ * is 1.
+ */
+
+static int
+_GMPy_Matrix_Parse(gmpy_matrix *m, PyObject *obj, int vector, const char *name)
+{
+    PyObject *seq, *row;
+    Py_ssize_t i, n, size;
+
+    memset(m, 0, sizeof(gmpy_matrix));
+    m->kind = VECTOR_INTEGER;
+
+    if (MPZ_Array_Check(obj)) {
+        size = ((MPZ_Array_Object*)obj)->size;
+        if (vector) {
+            m->rows = size;
+            m->cols = 1;
+        }
+        else {
+            n = (Py_ssize_t)sqrt((double)size);
+            while (n * n > size)
+                n--;
+            while ((n + 1) * (n + 1) <= size)
+                n++;
+            if (n * n != size) {
+                PyErr_Format(PyExc_ValueError,
+                             "%s() requires an mpz_array with a square number of elements",
+                             name);
+                return -1;
+            }
+            m->rows = m->cols = n;
+        }
+        Py_INCREF(obj);
+        m->keep = obj;
+        return 0;
+    }
+
+    if (vector) {
+        if (!(m->flat = PySequence_List(obj)))
+            return -1;
+        m->rows = PyList_GET_SIZE(m->flat);
+        m->cols = 1;
+    }
+    else {
+        if (!(seq = PySequence_Fast(obj, "matrix must be a sequence of rows")))
+            return -1;
+        if (!(m->flat = PyList_New(0))) {
+            Py_DECREF(seq);
+            return -1;
+        }
+        m->rows = PySequence_Fast_GET_SIZE(seq);
+        for (i = 0; i < m->rows; i++) {
+            if (!(row = PySequence_Fast(PySequence_Fast_GET_ITEM(seq, i),
+                                        "matrix rows must be sequences"))) {
+                Py_DECREF(seq);
+                return -1;
+            }
+            if (i == 0) {
+                m->cols = PySequence_Fast_GET_SIZE(row);
+            }
+            else if (PySequence_Fast_GET_SIZE(row) != m->cols) {
+                PyErr_Format(PyExc_ValueError,
+                             "%s() requires rows of the same length", name);
+                Py_DECREF(row);
+                Py_DECREF(seq);
+                return -1;
+            }
+            size = PyList_GET_SIZE(m->flat);
+            if (PyList_SetSlice(m->flat, size, size, row) < 0) {
+                Py_DECREF(row);
+                Py_DECREF(seq);
+                return -1;
+            }
+            Py_DECREF(row);
+        }
+        Py_DECREF(seq);
+    }
+
+    size = PyList_GET_SIZE(m->flat);
+    if (!(m->types = PyMem_New(int, size ? size : 1))) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (i = 0; i < size; i++) {
+        m->types[i] = GMPy_ObjectType(PyList_GET_ITEM(m->flat, i));
+        if (IS_TYPE_INTEGER(m->types[i]))
+            continue;
+        if (IS_TYPE_RATIONAL(m->types[i])) {
+            if (m->kind < VECTOR_RATIONAL)
+                m->kind = VECTOR_RATIONAL;
+        }
+        else if (IS_TYPE_REAL(m->types[i])) {
+            m->kind = VECTOR_REAL;
+        }
+        else {
+            PyErr_Format(PyExc_TypeError,
+                         "%s() requires integer, rational, or real values", name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void *
+_GMPy_Matrix_Value(PyObject *obj, int kind)
+{
+    switch (kind) {
+        case VECTOR_INTEGER:
+            return MPZ(obj);
+        case VECTOR_RATIONAL:
+            return MPQ(obj);
+        default:
+            return MPFR(obj);
+    }
+}
+
+/* Convert the entries to the given kind and fill in m->e. */
+
+static int
+_GMPy_Matrix_Convert(gmpy_matrix *m, int kind, CTXT_Object *context)
+{
+    PyObject *keep, *temp;
+    Py_ssize_t i, size = m->rows * m->cols;
+    mpz_t *z = NULL;
+
+    if (!(m->e = PyMem_New(void*, size ? size : 1))) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    if (!m->flat) {
+        z = ((MPZ_Array_Object*)m->keep)->z;
+        if (kind == VECTOR_INTEGER) {
+            for (i = 0; i < size; i++)
+                m->e[i] = z[i];
+            return 0;
+        }
+    }
+
+    if (!(keep = PyTuple_New(size)))
+        return -1;
+
+    for (i = 0; i < size; i++) {
+        if (z && kind == VECTOR_RATIONAL) {
+            if ((temp = (PyObject*)GMPy_MPQ_New(context)))
+                mpq_set_z(MPQ(temp), z[i]);
+        }
+        else if (z) {
+            if ((temp = (PyObject*)GMPy_MPFR_New(0, context)))
+                ((MPFR_Object*)temp)->rc = mpfr_set_z(MPFR(temp), z[i],
+                                                      GET_MPFR_ROUND(context));
+        }
+        else {
+            temp = _GMPy_Vector_Convert(PyList_GET_ITEM(m->flat, i),
+                                        m->types[i], kind, context);
+        }
+        if (!temp) {
+            Py_DECREF(keep);
+            return -1;
+        }
+        PyTuple_SET_ITEM(keep, i, temp);
+        m->e[i] = _GMPy_Matrix_Value(temp, kind);
+    }
+
+    Py_XDECREF(m->keep);
+    m->keep = keep;
+    return 0;
+}
+
+/* Allocate a rows x cols result of the given kind. The values are 0. If
+ * array is 1, the result is an mpz_array.
+ */
+
+static int
+_GMPy_Matrix_Output(gmpy_matrix *m, Py_ssize_t rows, Py_ssize_t cols,
+                    int kind, int array, CTXT_Object *context)
+{
+    PyObject *temp;
+    Py_ssize_t i, size = rows * cols;
+
+    memset(m, 0, sizeof(gmpy_matrix));
+    m->rows = rows;
+    m->cols = cols;
+    m->kind = kind;
+
+    if (!(m->e = PyMem_New(void*, size ? size : 1))) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    if (array) {
+        if (!(m->keep = (PyObject*)GMPy_MPZ_Array_New(size)))
+            return -1;
+        for (i = 0; i < size; i++)
+            m->e[i] = ((MPZ_Array_Object*)m->keep)->z[i];
+        return 0;
+    }
+
+    if (!(m->keep = PyTuple_New(size)))
+        return -1;
+
+    for (i = 0; i < size; i++) {
+        if (kind == VECTOR_INTEGER) {
+            if ((temp = (PyObject*)GMPy_MPZ_New(context)))
+                mpz_set_ui(MPZ(temp), 0);
+        }
+        else if (kind == VECTOR_RATIONAL) {
+            if ((temp = (PyObject*)GMPy_MPQ_New(context)))
+                mpq_set_ui(MPQ(temp), 0, 1);
+        }
+        else {
+            if ((temp = (PyObject*)GMPy_MPFR_New(0, context)))
+                mpfr_set_zero(MPFR(temp), 1);
+        }
+        if (!temp)
+            return -1;
+        PyTuple_SET_ITEM(m->keep, i, temp);
+        m->e[i] = _GMPy_Matrix_Value(temp, kind);
+    }
+    return 0;
+}
+
+/* Apply the exponent range of the context to real results and raise any
+ * trapped exception. Then return the result as an mpz_array, a list, or a
+ * list of rows.
+ */
+
+static int
+_GMPy_Matrix_Check(gmpy_matrix *m, CTXT_Object *context)
+{
+    Py_ssize_t i;
+
+    if (m->kind != VECTOR_REAL)
+        return 0;
+
+    for (i = 0; i < m->rows * m->cols; i++)
+        _GMPy_MPFR_Check_Range((MPFR_Object*)PyTuple_GET_ITEM(m->keep, i),
+                               context, GET_MPFR_ROUND(context));
+    return _GMPy_MPFR_Exceptions(context);
+}
+
+static PyObject *
+_GMPy_Matrix_Result(gmpy_matrix *m, int vector, CTXT_Object *context)
+{
+    PyObject *result, *row, *temp;
+    Py_ssize_t i;
+
+    if (MPZ_Array_Check(m->keep)) {
+        Py_INCREF(m->keep);
+        return m->keep;
+    }
+
+    if (_GMPy_Matrix_Check(m, context) < 0)
+        return NULL;
+
+    if (vector)
+        return PySequence_List(m->keep);
+
+    if (!(result = PyList_New(m->rows)))
+        return NULL;
+    for (i = 0; i < m->rows; i++) {
+        if (!(temp = PyTuple_GetSlice(m->keep, i * m->cols, (i + 1) * m->cols))) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        row = PySequence_List(temp);
+        Py_DECREF(temp);
+        if (!row) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, i, row);
+    }
+    return result;
+}
+
+static size_t
+_GMPy_Matrix_Bits(gmpy_matrix *m, CTXT_Object *context)
+{
+    Py_ssize_t i, size = m->rows * m->cols;
+    size_t bits = 0;
+
+    if (m->kind == VECTOR_REAL)
+        return (size_t)GET_MPFR_PREC(context) * size;
+
+    for (i = 0; i < size; i++) {
+        if (m->kind == VECTOR_INTEGER)
+            bits += GMPY_MPZ_BITS((mpz_ptr)m->e[i]);
+        else
+            bits += GMPY_MPQ_BITS((mpq_ptr)m->e[i]);
+    }
+    return bits;
+}
+
+/* The matrix products are computed in blocks of MATRIX_BLOCK rows and
+ * columns so the rows of b that are used stay in the cache.
+ */
+
+static void
+_GMPy_Matmul_Integer(gmpy_matrix *c, gmpy_matrix *a, gmpy_matrix *b)
+{
+    Py_ssize_t ii, kk, jj, i, k, j, iend, kend, jend;
+    mpz_srcptr x;
+
+    for (ii = 0; ii < a->rows; ii += MATRIX_BLOCK) {
+        iend = ii + MATRIX_BLOCK < a->rows ? ii + MATRIX_BLOCK : a->rows;
+        for (kk = 0; kk < a->cols; kk += MATRIX_BLOCK) {
+            kend = kk + MATRIX_BLOCK < a->cols ? kk + MATRIX_BLOCK : a->cols;
+            for (jj = 0; jj < b->cols; jj += MATRIX_BLOCK) {
+                jend = jj + MATRIX_BLOCK < b->cols ? jj + MATRIX_BLOCK : b->cols;
+                for (i = ii; i < iend; i++) {
+                    for (k = kk; k < kend; k++) {
+                        x = MAT_Z(a, i, k);
+                        if (mpz_sgn(x) == 0)
+                            continue;
+                        for (j = jj; j < jend; j++)
+                            mpz_addmul(MAT_Z(c, i, j), x, MAT_Z(b, k, j));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Rational sums are accumulated over a common denominator, as in dot(),
+ * and reduced once at the end.
+ */
+
+static void
+_GMPy_Matmul_Rational(gmpy_matrix *c, gmpy_matrix *a, gmpy_matrix *b)
+{
+    Py_ssize_t ii, kk, jj, i, k, j, iend, kend, jend;
+    mpq_srcptr x, y;
+    mpq_ptr r;
+    mpz_t num, den, g, t;
+
+    mpz_init(num);
+    mpz_init(den);
+    mpz_init(g);
+    mpz_init(t);
+    for (ii = 0; ii < a->rows; ii += MATRIX_BLOCK) {
+        iend = ii + MATRIX_BLOCK < a->rows ? ii + MATRIX_BLOCK : a->rows;
+        for (kk = 0; kk < a->cols; kk += MATRIX_BLOCK) {
+            kend = kk + MATRIX_BLOCK < a->cols ? kk + MATRIX_BLOCK : a->cols;
+            for (jj = 0; jj < b->cols; jj += MATRIX_BLOCK) {
+                jend = jj + MATRIX_BLOCK < b->cols ? jj + MATRIX_BLOCK : b->cols;
+                for (i = ii; i < iend; i++) {
+                    for (k = kk; k < kend; k++) {
+                        x = MAT_Q(a, i, k);
+                        if (mpq_sgn(x) == 0)
+                            continue;
+                        for (j = jj; j < jend; j++) {
+                            y = MAT_Q(b, k, j);
+                            r = MAT_Q(c, i, j);
+                            mpz_mul(num, mpq_numref(x), mpq_numref(y));
+                            mpz_mul(den, mpq_denref(x), mpq_denref(y));
+                            _GMPy_Rational_Accumulate(mpq_numref(r), mpq_denref(r),
+                                                      num, den, g, t);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    for (i = 0; i < c->rows * c->cols; i++)
+        mpq_canonicalize((mpq_ptr)c->e[i]);
+    mpz_clear(num);
+    mpz_clear(den);
+    mpz_clear(g);
+    mpz_clear(t);
+}
+
+/* Each real entry is the correctly rounded sum of the exact products. t
+ * and tab provide a->cols temporaries.
+ */
+
+static void
+_GMPy_Matmul_Real(gmpy_matrix *c, gmpy_matrix *a, gmpy_matrix *b, mpfr_t *t,
+                  mpfr_ptr *tab, mpfr_rnd_t round)
+{
+    Py_ssize_t i, k, j;
+    mpfr_srcptr x, y;
+    MPFR_Object *r;
+
+    for (i = 0; i < a->rows; i++) {
+        for (j = 0; j < b->cols; j++) {
+            for (k = 0; k < a->cols; k++) {
+                x = MAT_F(a, i, k);
+                y = MAT_F(b, k, j);
+                mpfr_set_prec(t[k], mpfr_get_prec(x) + mpfr_get_prec(y));
+                mpfr_mul(t[k], x, y, MPFR_RNDN);
+                tab[k] = t[k];
+            }
+            r = (MPFR_Object*)PyTuple_GET_ITEM(c->keep, i * c->cols + j);
+            r->rc = mpfr_sum(r->f, tab, (unsigned long)a->cols, round);
+        }
+    }
+}
+
+/* Store the entries of a, followed by the column b if it is not NULL, as
+ * integers in w. Rational rows are multiplied by the least common multiple
+ * of their denominators; scale is set to the product of the multipliers.
+ */
+
+static void
+_GMPy_Matrix_To_Integer(mpz_t *w, gmpy_matrix *a, gmpy_matrix *b, mpz_ptr scale)
+{
+    Py_ssize_t i, j, cols = a->cols + (b ? 1 : 0);
+    mpq_srcptr q;
+    mpz_t l;
+
+    mpz_set_ui(scale, 1);
+    if (a->kind == VECTOR_INTEGER) {
+        for (i = 0; i < a->rows; i++) {
+            for (j = 0; j < cols; j++)
+                mpz_set(w[i * cols + j], j < a->cols ? MAT_Z(a, i, j) : MAT_Z(b, i, 0));
+        }
+        return;
+    }
+
+    mpz_init(l);
+    for (i = 0; i < a->rows; i++) {
+        mpz_set_ui(l, 1);
+        for (j = 0; j < cols; j++) {
+            q = j < a->cols ? MAT_Q(a, i, j) : MAT_Q(b, i, 0);
+            mpz_lcm(l, l, mpq_denref(q));
+        }
+        for (j = 0; j < cols; j++) {
+            q = j < a->cols ? MAT_Q(a, i, j) : MAT_Q(b, i, 0);
+            mpz_divexact(w[i * cols + j], l, mpq_denref(q));
+            mpz_mul(w[i * cols + j], w[i * cols + j], mpq_numref(q));
+        }
+        mpz_mul(scale, scale, l);
+    }
+    mpz_clear(l);
+}
+
+/* Fraction-free elimination of the n x cols integer matrix w to upper
+ * triangular form. After step k every entry below row k is divisible by
+ * the previous pivot, and the last pivot is the determinant of the leading
+ * n x n matrix. sign is negated for every row exchange. Return -1 if the
+ * leading matrix is singular.
+ */
+
+static int
+_GMPy_Matrix_Bareiss(mpz_t *w, Py_ssize_t n, Py_ssize_t cols, int *sign)
+{
+    Py_ssize_t i, j, k, r;
+    mpz_srcptr prev = NULL;
+    mpz_t t;
+
+    mpz_init(t);
+    for (k = 0; k < n; k++) {
+        for (r = k; r < n && mpz_sgn(w[r * cols + k]) == 0; r++);
+        if (r == n) {
+            mpz_clear(t);
+            return -1;
+        }
+        if (r != k) {
+            for (j = k; j < cols; j++)
+                mpz_swap(w[r * cols + j], w[k * cols + j]);
+            *sign = -*sign;
+        }
+        for (i = k + 1; i < n; i++) {
+            for (j = k + 1; j < cols; j++) {
+                mpz_mul(t, w[i * cols + j], w[k * cols + k]);
+                mpz_submul(t, w[i * cols + k], w[k * cols + j]);
+                if (prev)
+                    mpz_divexact(w[i * cols + j], t, prev);
+                else
+                    mpz_swap(w[i * cols + j], t);
+            }
+            mpz_set_ui(w[i * cols + k], 0);
+        }
+        prev = w[k * cols + k];
+    }
+    mpz_clear(t);
+    return 0;
+}
+
+/* Gaussian elimination with partial pivoting of the n x cols real matrix
+ * w. Each update is one fused multiply-add. Return -1 if a pivot is 0.
+ */
+
+static int
+_GMPy_Matrix_Gauss(mpfr_t *w, Py_ssize_t n, Py_ssize_t cols, int *sign,
+                   mpfr_prec_t prec, mpfr_rnd_t round)
+{
+    Py_ssize_t i, j, k, r;
+    mpfr_t f;
+
+    mpfr_init2(f, prec);
+    for (k = 0; k < n; k++) {
+        r = k;
+        for (i = k + 1; i < n; i++) {
+            if (mpfr_cmpabs(w[i * cols + k], w[r * cols + k]) > 0)
+                r = i;
+        }
+        if (mpfr_zero_p(w[r * cols + k])) {
+            mpfr_clear(f);
+            return -1;
+        }
+        if (r != k) {
+            for (j = k; j < cols; j++)
+                mpfr_swap(w[r * cols + j], w[k * cols + j]);
+            *sign = -*sign;
+        }
+        for (i = k + 1; i < n; i++) {
+            mpfr_div(f, w[i * cols + k], w[k * cols + k], round);
+            mpfr_neg(f, f, round);
+            for (j = k + 1; j < cols; j++)
+                mpfr_fma(w[i * cols + j], f, w[k * cols + j], w[i * cols + j], round);
+            mpfr_set_zero(w[i * cols + k], 1);
+        }
+    }
+    mpfr_clear(f);
+    return 0;
+}
+
+static void *
+_GMPy_Matrix_Work(Py_ssize_t size, int kind, CTXT_Object *context)
+{
+    Py_ssize_t i;
+    void *w;
+
+    if (kind == VECTOR_REAL) {
+        if ((w = PyMem_New(mpfr_t, size ? size : 1))) {
+            for (i = 0; i < size; i++)
+                mpfr_init2(((mpfr_t*)w)[i], GET_MPFR_PREC(context));
+        }
+    }
+    else {
+        if ((w = PyMem_New(mpz_t, size ? size : 1))) {
+            for (i = 0; i < size; i++)
+                mpz_init(((mpz_t*)w)[i]);
+        }
+    }
+    if (!w)
+        PyErr_NoMemory();
+    return w;
+}
+
+static void
+_GMPy_Matrix_Work_Free(void *w, Py_ssize_t size, int kind)
+{
+    Py_ssize_t i;
+
+    if (!w)
+        return;
+    for (i = 0; i < size; i++) {
+        if (kind == VECTOR_REAL)
+            mpfr_clear(((mpfr_t*)w)[i]);
+        else
+            mpz_clear(((mpz_t*)w)[i]);
+    }
+    PyMem_Free(w);
+}
+
+/* Copy a, followed by the column b if it is not NULL, to the real matrix w
+ * with the precision of the context.
+ */
+
+static void
+_GMPy_Matrix_To_Real(mpfr_t *w, gmpy_matrix *a, gmpy_matrix *b, mpfr_rnd_t round)
+{
+    Py_ssize_t i, j, cols = a->cols + (b ? 1 : 0);
+
+    for (i = 0; i < a->rows; i++) {
+        for (j = 0; j < cols; j++)
+            mpfr_set(w[i * cols + j], j < a->cols ? MAT_F(a, i, j) : MAT_F(b, i, 0), round);
+    }
+}
+
+PyDoc_STRVAR(GMPy_doc_function_matmul,
+"matmul(x, y, /) -> list | mpz_array\n\n"
+"Return the matrix product of x and y. A matrix is a sequence of rows or\n"
+"an mpz_array with a square number of elements in row-major order. The\n"
+"entries can be integers, rationals, or reals. Integer and rational\n"
+"products are exact; each real entry is the correctly rounded sum of the\n"
+"exact products. The result is a list of rows, or an mpz_array if both\n"
+"x and y are mpz_arrays.");
+
+static PyObject *
+GMPy_Context_Matmul(PyObject *self, PyObject *args)
+{
+    gmpy_matrix a, b, c;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+    mpfr_t *t = NULL;
+    mpfr_ptr *tab = NULL;
+    size_t bits;
+    Py_ssize_t i, n;
+    int kind;
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("matmul() requires 2 arguments");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_Matrix_Parse(&a, PyTuple_GET_ITEM(args, 0), 0, "matmul") < 0) {
+        _GMPy_Matrix_Clear(&a);
+        return NULL;
+    }
+    if (_GMPy_Matrix_Parse(&b, PyTuple_GET_ITEM(args, 1), 0, "matmul") < 0) {
+        _GMPy_Matrix_Clear(&a);
+        _GMPy_Matrix_Clear(&b);
+        return NULL;
+    }
+    memset(&c, 0, sizeof(gmpy_matrix));
+
+    if (a.rows && a.cols != b.rows) {
+        VALUE_ERROR("matmul() requires len(y) to equal the length of the rows of x");
+        goto done;
+    }
+
+    kind = a.kind > b.kind ? a.kind : b.kind;
+    if (_GMPy_Matrix_Convert(&a, kind, context) < 0 ||
+        _GMPy_Matrix_Convert(&b, kind, context) < 0 ||
+        _GMPy_Matrix_Output(&c, a.rows, b.cols, kind,
+                            MPZ_Array_Check(a.keep) && MPZ_Array_Check(b.keep),
+                            context) < 0) {
+        goto done;
+    }
+
+    if (kind == VECTOR_REAL) {
+        if (!(t = PyMem_New(mpfr_t, a.cols ? a.cols : 1)) ||
+            !(tab = PyMem_New(mpfr_ptr, a.cols ? a.cols : 1))) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        for (i = 0; i < a.cols; i++)
+            mpfr_init2(t[i], MPFR_PREC_MIN);
+        mpfr_clear_flags();
+    }
+
+    n = a.rows * a.cols * b.cols;
+    bits = _GMPy_Matrix_Bits(&a, context) * b.cols +
+           _GMPy_Matrix_Bits(&b, context) * a.rows;
+    if (n)
+        GMPY_PROFILE_OPN(context, GMPY_OP_MUL, bits / n, n);
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    if (kind == VECTOR_INTEGER)
+        _GMPy_Matmul_Integer(&c, &a, &b);
+    else if (kind == VECTOR_RATIONAL)
+        _GMPy_Matmul_Rational(&c, &a, &b);
+    else
+        _GMPy_Matmul_Real(&c, &a, &b, t, tab, GET_MPFR_ROUND(context));
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    result = _GMPy_Matrix_Result(&c, 0, context);
+
+  done:
+    if (t) {
+        for (i = 0; i < a.cols; i++)
+            mpfr_clear(t[i]);
+        PyMem_Free(t);
+    }
+    PyMem_Free(tab);
+    _GMPy_Matrix_Clear(&a);
+    _GMPy_Matrix_Clear(&b);
+    _GMPy_Matrix_Clear(&c);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_det,
+"det(x, /) -> mpz | mpq | mpfr\n\n"
+"Return the determinant of the square matrix x, given as for matmul().\n"
+"Integer and rational determinants are computed exactly with the\n"
+"fraction-free Bareiss algorithm. Real determinants use Gaussian\n"
+"elimination with partial pivoting at the precision of the context.");
+
+static PyObject *
+GMPy_Context_Det(PyObject *self, PyObject *other)
+{
+    gmpy_matrix a, c;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+    mpfr_rnd_t round;
+    MPFR_Object *r;
+    void *w = NULL;
+    mpz_t scale;
+    size_t bits;
+    Py_ssize_t i, n = 0;
+    int sign = 1, singular;
+
+    CHECK_CONTEXT(context);
+    round = GET_MPFR_ROUND(context);
+
+    memset(&c, 0, sizeof(gmpy_matrix));
+    if (_GMPy_Matrix_Parse(&a, other, 0, "det") < 0)
+        goto done;
+
+    if (a.rows != a.cols) {
+        VALUE_ERROR("det() requires a square matrix");
+        goto done;
+    }
+    n = a.rows;
+
+    if (_GMPy_Matrix_Convert(&a, a.kind, context) < 0 ||
+        _GMPy_Matrix_Output(&c, 1, 1, a.kind, 0, context) < 0 ||
+        !(w = _GMPy_Matrix_Work(n * n, a.kind, context))) {
+        goto done;
+    }
+
+    bits = _GMPy_Matrix_Bits(&a, context) * n;
+    if (n)
+        GMPY_PROFILE_OPN(context, GMPY_OP_MUL, bits / (n * n), n * n * n);
+
+    if (a.kind == VECTOR_REAL) {
+        r = (MPFR_Object*)PyTuple_GET_ITEM(c.keep, 0);
+        mpfr_clear_flags();
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+        _GMPy_Matrix_To_Real((mpfr_t*)w, &a, NULL, round);
+        singular = _GMPy_Matrix_Gauss((mpfr_t*)w, n, n, &sign,
+                                      GET_MPFR_PREC(context), round);
+        r->rc = mpfr_set_si(r->f, singular ? 0 : sign, round);
+        for (i = 0; i < n && !singular; i++)
+            r->rc = mpfr_mul(r->f, r->f, ((mpfr_t*)w)[i * n + i], round);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+    }
+    else {
+        /* A rational determinant is the integer determinant divided by the
+         * product of the row multipliers.
+         */
+        mpz_ptr d;
+
+        if (a.kind == VECTOR_INTEGER)
+            d = MAT_Z(&c, 0, 0);
+        else
+            d = mpq_numref(MAT_Q(&c, 0, 0));
+
+        mpz_init(scale);
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+        _GMPy_Matrix_To_Integer((mpz_t*)w, &a, NULL, scale);
+        if (n == 0)
+            mpz_set_ui(d, 1);
+        else if (_GMPy_Matrix_Bareiss((mpz_t*)w, n, n, &sign) < 0)
+            mpz_set_ui(d, 0);
+        else if (sign < 0)
+            mpz_neg(d, ((mpz_t*)w)[n * n - 1]);
+        else
+            mpz_set(d, ((mpz_t*)w)[n * n - 1]);
+        if (a.kind == VECTOR_RATIONAL) {
+            mpz_set(mpq_denref(MAT_Q(&c, 0, 0)), scale);
+            mpq_canonicalize(MAT_Q(&c, 0, 0));
+        }
+        GMPY_END_ALLOW_THREADS_MIN(context);
+        mpz_clear(scale);
+    }
+
+    if (_GMPy_Matrix_Check(&c, context) == 0) {
+        result = PyTuple_GET_ITEM(c.keep, 0);
+        Py_INCREF(result);
+    }
+
+  done:
+    _GMPy_Matrix_Work_Free(w, n * n, a.kind);
+    _GMPy_Matrix_Clear(&a);
+    _GMPy_Matrix_Clear(&c);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_solve,
+"solve(x, y, /) -> list\n\n"
+"Return the solution v of x * v = y for the square matrix x, given as\n"
+"for matmul(), and the sequence y. For integer and rational values the\n"
+"solution is exact and is returned as a list of mpq. Real values use\n"
+"Gaussian elimination with partial pivoting at the precision of the\n"
+"context. Raises ZeroDivisionError if x is singular.");
+
+static PyObject *
+GMPy_Context_Solve(PyObject *self, PyObject *args)
+{
+    gmpy_matrix a, b, c;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+    mpfr_rnd_t round;
+    void *w = NULL;
+    mpz_t scale;
+    mpq_t s, t;
+    mpfr_t f;
+    size_t bits;
+    Py_ssize_t i, j, n = 0, cols = 1;
+    int kind = VECTOR_INTEGER, sign = 1, singular;
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("solve() requires 2 arguments");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+    round = GET_MPFR_ROUND(context);
+
+    if (_GMPy_Matrix_Parse(&a, PyTuple_GET_ITEM(args, 0), 0, "solve") < 0) {
+        _GMPy_Matrix_Clear(&a);
+        return NULL;
+    }
+    if (_GMPy_Matrix_Parse(&b, PyTuple_GET_ITEM(args, 1), 1, "solve") < 0) {
+        _GMPy_Matrix_Clear(&a);
+        _GMPy_Matrix_Clear(&b);
+        return NULL;
+    }
+    memset(&c, 0, sizeof(gmpy_matrix));
+
+    if (a.rows != a.cols || b.rows != a.rows) {
+        VALUE_ERROR("solve() requires a square matrix and a vector of the same length");
+        goto done;
+    }
+    n = a.rows;
+    cols = n + 1;
+
+    kind = a.kind > b.kind ? a.kind : b.kind;
+    if (_GMPy_Matrix_Convert(&a, kind, context) < 0 ||
+        _GMPy_Matrix_Convert(&b, kind, context) < 0 ||
+        _GMPy_Matrix_Output(&c, n, 1, kind == VECTOR_REAL ? VECTOR_REAL : VECTOR_RATIONAL,
+                            0, context) < 0 ||
+        !(w = _GMPy_Matrix_Work(n * cols, kind, context))) {
+        goto done;
+    }
+
+    bits = (_GMPy_Matrix_Bits(&a, context) + _GMPy_Matrix_Bits(&b, context)) * n;
+    if (n)
+        GMPY_PROFILE_OPN(context, GMPY_OP_MUL, bits / (n * cols), n * n * cols);
+
+    if (kind == VECTOR_REAL) {
+        mpfr_t *v = (mpfr_t*)w;
+
+        mpfr_init2(f, GET_MPFR_PREC(context));
+        mpfr_clear_flags();
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+        _GMPy_Matrix_To_Real(v, &a, &b, round);
+        singular = _GMPy_Matrix_Gauss(v, n, cols, &sign, GET_MPFR_PREC(context), round);
+        for (i = n - 1; i >= 0 && !singular; i--) {
+            MPFR_Object *r = (MPFR_Object*)PyTuple_GET_ITEM(c.keep, i);
+
+            mpfr_set(f, v[i * cols + n], round);
+            for (j = i + 1; j < n; j++) {
+                /* f = f - v[i][j] * x[j] */
+                mpfr_fms(f, v[i * cols + j], MAT_F(&c, j, 0), f, round);
+                mpfr_neg(f, f, round);
+            }
+            r->rc = mpfr_div(r->f, f, v[i * cols + i], round);
+        }
+        GMPY_END_ALLOW_THREADS_MIN(context);
+        mpfr_clear(f);
+    }
+    else {
+        mpz_t *v = (mpz_t*)w;
+
+        mpz_init(scale);
+        mpq_init(s);
+        mpq_init(t);
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+        _GMPy_Matrix_To_Integer(v, &a, &b, scale);
+        singular = _GMPy_Matrix_Bareiss(v, n, cols, &sign);
+        for (i = n - 1; i >= 0 && !singular; i--) {
+            mpq_set_z(s, v[i * cols + n]);
+            for (j = i + 1; j < n; j++) {
+                mpq_set_z(t, v[i * cols + j]);
+                mpq_mul(t, t, MAT_Q(&c, j, 0));
+                mpq_sub(s, s, t);
+            }
+            mpq_set_z(t, v[i * cols + i]);
+            mpq_div(MAT_Q(&c, i, 0), s, t);
+        }
+        GMPY_END_ALLOW_THREADS_MIN(context);
+        mpz_clear(scale);
+        mpq_clear(s);
+        mpq_clear(t);
+    }
+
+    if (singular)
+        ZERO_ERROR("solve() requires a nonsingular matrix");
+    else
+        result = _GMPy_Matrix_Result(&c, 1, context);
+
+  done:
+    _GMPy_Matrix_Work_Free(w, n * cols, kind);
+    _GMPy_Matrix_Clear(&a);
+    _GMPy_Matrix_Clear(&b);
+    _GMPy_Matrix_Clear(&c);
+    return result;
+}
+
+/* LLL reduction of the rows b[0], ..., b[n-1] of length m, stored
+ * row-major in b.
+ *
+ * The exact variant is de Weger's fraction-free algorithm as given by
+ * Cohen (Algorithm 2.6.7): d[i + 1] is the Gram determinant of the first
+ * i + 1 rows and lam[k][j] = d[j + 1] * mu[k][j] is an integer, so every
+ * division is exact. The other variant keeps mu and the squared lengths of
+ * the Gram-Schmidt vectors as mpfr values, recomputed from the exact Gram
+ * matrix of the rows whenever a row changes, and repeats the size
+ * reduction of a row until no coefficient exceeds LLL_ETA. The basis
+ * itself is always exact, as is the Gram matrix of the rows, which is
+ * updated with every change. Both return LLL_DEPENDENT if the rows are
+ * linearly dependent.
+ */
+
+enum {
+    LLL_DONE = 0,
+    LLL_DEPENDENT = -1,
+    LLL_INTERRUPTED = -2,
+    LLL_PRECISION = -3,     /* the size reduction did not converge */
+    LLL_NOMEM = -4
+};
+
+#define LLL_ETA 0.51
+#define LLL_REDUCE_LIMIT 64
+
+#define LLL_ROW(k) (b + (k) * m)
+
+/* Set r to the dot product of the rows x and y of length m. */
+
+static void
+_GMPy_LLL_Dot(mpz_ptr r, mpz_t *x, mpz_t *y, Py_ssize_t m, mpz_ptr t)
+{
+    Py_ssize_t i;
+
+    mpz_set_ui(r, 0);
+    for (i = 0; i < m; i++) {
+        /* mpz_addmul() does not detect squares. */
+        if (x == y) {
+            mpz_mul(t, x[i], x[i]);
+            mpz_add(r, r, t);
+        }
+        else {
+            mpz_addmul(r, x[i], y[i]);
+        }
+    }
+}
+
+/* Subtract q times the row y from the row x. */
+
+static void
+_GMPy_LLL_Sub(mpz_t *x, mpz_t *y, mpz_srcptr q, Py_ssize_t m)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < m; i++) {
+        if (mpz_cmp_ui(q, 1) == 0)
+            mpz_sub(x[i], x[i], y[i]);
+        else if (mpz_cmp_si(q, -1) == 0)
+            mpz_add(x[i], x[i], y[i]);
+        else
+            mpz_submul(x[i], q, y[i]);
+    }
+}
+
+#define LAM(i, j) lam[(i) * n + (j)]
+#define D(i) d[(i) + 1]
+
+/* Size-reduce row k against row l < k. */
+
+static void
+_GMPy_LLL_Red(mpz_t *b, mpz_t *lam, mpz_t *d, Py_ssize_t n, Py_ssize_t m,
+              Py_ssize_t k, Py_ssize_t l, mpz_ptr q, mpz_ptr t)
+{
+    Py_ssize_t i;
+
+    mpz_mul_2exp(t, LAM(k, l), 1);
+    if (mpz_cmpabs(t, D(l)) <= 0)
+        return;
+
+    /* q is the integer nearest to lam[k][l] / d[l + 1]. */
+    mpz_add(t, t, D(l));
+    mpz_mul_2exp(q, D(l), 1);
+    mpz_fdiv_q(q, t, q);
+
+    _GMPy_LLL_Sub(LLL_ROW(k), LLL_ROW(l), q, m);
+    mpz_submul(LAM(k, l), q, D(l));
+    for (i = 0; i < l; i++)
+        mpz_submul(LAM(k, i), q, LAM(l, i));
+}
+
+/* Exchange the rows k - 1 and k and update lam and d. */
+
+static void
+_GMPy_LLL_Swap(mpz_t *b, mpz_t *lam, mpz_t *d, Py_ssize_t n, Py_ssize_t m,
+               Py_ssize_t k, Py_ssize_t kmax, mpz_ptr u, mpz_ptr t)
+{
+    mpz_srcptr l = LAM(k, k - 1);
+    Py_ssize_t i, j;
+
+    for (j = 0; j < m; j++)
+        mpz_swap(LLL_ROW(k)[j], LLL_ROW(k - 1)[j]);
+    for (j = 0; j < k - 1; j++)
+        mpz_swap(LAM(k, j), LAM(k - 1, j));
+
+    /* u is the new d[k]. */
+    mpz_mul(u, D(k - 2), D(k));
+    mpz_addmul(u, l, l);
+    mpz_divexact(u, u, D(k - 1));
+
+    for (i = k + 1; i <= kmax; i++) {
+        mpz_set(t, LAM(i, k));
+        mpz_mul(LAM(i, k), D(k), LAM(i, k - 1));
+        mpz_submul(LAM(i, k), l, t);
+        mpz_divexact(LAM(i, k), LAM(i, k), D(k - 1));
+        mpz_mul(LAM(i, k - 1), u, t);
+        mpz_addmul(LAM(i, k - 1), l, LAM(i, k));
+        mpz_divexact(LAM(i, k - 1), LAM(i, k - 1), D(k));
+    }
+    mpz_swap(D(k - 1), u);
+}
+
+/* Reduce with delta = p / q. Does not use the Python API except through
+ * GMPy_Interrupt_Poll().
+ */
+
+static int
+_GMPy_LLL_Exact(mpz_t *b, Py_ssize_t n, Py_ssize_t m, mpz_srcptr p,
+                mpz_srcptr q)
+{
+    mpz_t *lam, *d;
+    mpz_ptr u, t, s;
+    Py_ssize_t i, j, k, kmax = 0;
+    int mark, result = LLL_DONE;
+
+    if (n == 0)
+        return LLL_DONE;
+    if (!(lam = PyMem_RawMalloc(n * n * sizeof(mpz_t))) ||
+        !(d = PyMem_RawMalloc((n + 1) * sizeof(mpz_t)))) {
+        PyMem_RawFree(lam);
+        return LLL_NOMEM;
+    }
+    for (i = 0; i < n * n; i++)
+        mpz_init(lam[i]);
+    for (i = 0; i <= n; i++)
+        mpz_init(d[i]);
+
+    mark = _GMPy_Scratch_Mark();
+    u = _GMPy_Scratch_Get(GMP_NUMB_BITS);
+    t = _GMPy_Scratch_Get(GMP_NUMB_BITS);
+    s = _GMPy_Scratch_Get(GMP_NUMB_BITS);
+
+    mpz_set_ui(D(-1), 1);
+    _GMPy_LLL_Dot(D(0), LLL_ROW(0), LLL_ROW(0), m, t);
+    if (mpz_sgn(D(0)) == 0) {
+        result = LLL_DEPENDENT;
+        goto done;
+    }
+
+    for (k = 1; k < n; ) {
+        if (GMPy_Interrupt_Poll()) {
+            result = LLL_INTERRUPTED;
+            goto done;
+        }
+
+        /* Incremental Gram-Schmidt. */
+        if (k > kmax) {
+            kmax = k;
+            for (j = 0; j <= k; j++) {
+                _GMPy_LLL_Dot(u, LLL_ROW(k), LLL_ROW(j), m, t);
+                for (i = 0; i < j; i++) {
+                    mpz_mul(u, u, D(i));
+                    mpz_submul(u, LAM(k, i), LAM(j, i));
+                    mpz_divexact(u, u, D(i - 1));
+                }
+                mpz_set(j < k ? LAM(k, j) : D(k), u);
+            }
+            if (mpz_sgn(D(k)) == 0) {
+                result = LLL_DEPENDENT;
+                goto done;
+            }
+        }
+
+        /* Swap unless q * (d[k + 1] * d[k - 1] + lam[k][k-1]**2) >=
+         * p * d[k]**2, which is the Lovasz condition. */
+        _GMPy_LLL_Red(b, lam, d, n, m, k, k - 1, u, t);
+        mpz_mul(u, D(k), D(k - 2));
+        mpz_addmul(u, LAM(k, k - 1), LAM(k, k - 1));
+        mpz_mul(u, u, q);
+        mpz_mul(t, D(k - 1), D(k - 1));
+        mpz_mul(t, t, p);
+        if (mpz_cmp(u, t) < 0) {
+            _GMPy_LLL_Swap(b, lam, d, n, m, k, kmax, u, t);
+            if (k > 1)
+                k--;
+        }
+        else {
+            for (j = k - 2; j >= 0; j--)
+                _GMPy_LLL_Red(b, lam, d, n, m, k, j, u, s);
+            k++;
+        }
+    }
+
+  done:
+    _GMPy_Scratch_Release(mark);
+    for (i = 0; i < n * n; i++)
+        mpz_clear(lam[i]);
+    for (i = 0; i <= n; i++)
+        mpz_clear(d[i]);
+    PyMem_RawFree(lam);
+    PyMem_RawFree(d);
+    return result;
+}
+
+#undef LAM
+#undef D
+
+#define MU(i, j) mu[(i) * n + (j)]
+#define R(i, j) r[(i) * n + (j)]
+#define G(i, j) ((i) >= (j) ? gram[(i) * n + (j)] : gram[(j) * n + (i)])
+
+/* Compute row k of mu and r from the Gram matrix, where r[k][j] is the
+ * dot product of row k with the j-th Gram-Schmidt vector and r[k][k] is
+ * its squared length.
+ */
+
+static void
+_GMPy_LLL_GSO(mpz_t *gram, mpfr_t *mu, mpfr_t *r, Py_ssize_t n, Py_ssize_t k,
+              mpfr_ptr f)
+{
+    Py_ssize_t i, j;
+
+    for (j = 0; j <= k; j++) {
+        mpfr_set_z(R(k, j), G(k, j), MPFR_RNDN);
+        for (i = 0; i < j; i++) {
+            mpfr_mul(f, MU(j, i), R(k, i), MPFR_RNDN);
+            mpfr_sub(R(k, j), R(k, j), f, MPFR_RNDN);
+        }
+        if (j < k)
+            mpfr_div(MU(k, j), R(k, j), R(j, j), MPFR_RNDN);
+    }
+}
+
+/* Subtract x times row j from row k > j and update the Gram matrix. */
+
+static void
+_GMPy_LLL_Real_Sub(mpz_t *b, mpz_t *gram, Py_ssize_t n, Py_ssize_t m,
+                   Py_ssize_t k, Py_ssize_t j, mpz_srcptr x, mpz_ptr t)
+{
+    Py_ssize_t i;
+
+    /* |b[k] - x*b[j]|**2 = |b[k]|**2 - 2*x*<b[k], b[j]> + x**2 * |b[j]|**2 */
+    mpz_mul(t, x, G(j, j));
+    mpz_submul_ui(t, G(k, j), 2);
+    mpz_addmul(G(k, k), t, x);
+    for (i = 0; i < n; i++) {
+        if (i != k)
+            mpz_submul(G(k, i), x, G(j, i));
+    }
+    _GMPy_LLL_Sub(LLL_ROW(k), LLL_ROW(j), x, m);
+}
+
+/* Reduce with delta at the precision prec. Does not use the Python API
+ * except through GMPy_Interrupt_Poll().
+ */
+
+static int
+_GMPy_LLL_Real(mpz_t *b, Py_ssize_t n, Py_ssize_t m, mpq_srcptr delta,
+               mpfr_prec_t prec)
+{
+    mpfr_t *mu, *r, f, d;
+    mpz_t *gram;
+    mpz_ptr x, t;
+    Py_ssize_t i, j, k, size = n * n;
+    int mark, iter, reduced, result = LLL_DONE;
+
+    if (n == 0)
+        return LLL_DONE;
+    mu = r = NULL;
+    if (!(gram = PyMem_RawMalloc(size * sizeof(mpz_t))) ||
+        !(mu = PyMem_RawMalloc(size * sizeof(mpfr_t))) ||
+        !(r = PyMem_RawMalloc(size * sizeof(mpfr_t)))) {
+        PyMem_RawFree(gram);
+        PyMem_RawFree(mu);
+        return LLL_NOMEM;
+    }
+    for (i = 0; i < size; i++) {
+        mpz_init(gram[i]);
+        mpfr_init2(mu[i], prec);
+        mpfr_init2(r[i], prec);
+    }
+    mpfr_init2(f, prec);
+    mpfr_init2(d, prec);
+    mpfr_set_q(d, delta, MPFR_RNDN);
+
+    mark = _GMPy_Scratch_Mark();
+    x = _GMPy_Scratch_Get(GMP_NUMB_BITS);
+    t = _GMPy_Scratch_Get(GMP_NUMB_BITS);
+
+    for (i = 0; i < n; i++) {
+        for (j = 0; j <= i; j++)
+            _GMPy_LLL_Dot(G(i, j), LLL_ROW(i), LLL_ROW(j), m, t);
+    }
+    _GMPy_LLL_GSO(gram, mu, r, n, 0, f);
+    if (mpz_sgn(G(0, 0)) == 0) {
+        result = LLL_DEPENDENT;
+        goto done;
+    }
+
+    for (k = 1; k < n; ) {
+        if (GMPy_Interrupt_Poll()) {
+            result = LLL_INTERRUPTED;
+            goto done;
+        }
+
+        /* Size reduction. The coefficients are recomputed after every
+         * pass since the rounding errors grow with the changes. */
+        for (iter = 0; ; iter++) {
+            if (iter == LLL_REDUCE_LIMIT) {
+                result = LLL_PRECISION;
+                goto done;
+            }
+            _GMPy_LLL_GSO(gram, mu, r, n, k, f);
+            reduced = 0;
+            for (j = k - 1; j >= 0; j--) {
+                mpfr_abs(f, MU(k, j), MPFR_RNDN);
+                if (mpfr_cmp_d(f, LLL_ETA) <= 0)
+                    continue;
+                mpfr_get_z(x, MU(k, j), MPFR_RNDN);
+                _GMPy_LLL_Real_Sub(b, gram, n, m, k, j, x, t);
+                for (i = 0; i < j; i++) {
+                    mpfr_mul_z(f, MU(j, i), x, MPFR_RNDN);
+                    mpfr_sub(MU(k, i), MU(k, i), f, MPFR_RNDN);
+                }
+                mpfr_sub_z(MU(k, j), MU(k, j), x, MPFR_RNDN);
+                reduced = 1;
+            }
+            if (!reduced)
+                break;
+        }
+
+        /* Dependent rows lead to a zero row. Cancellation can make r[k][k]
+         * 0 or negative for other rows too, but it is then far below
+         * r[k-1][k-1] and the rows are swapped. */
+        if (mpz_sgn(G(k, k)) == 0) {
+            result = LLL_DEPENDENT;
+            goto done;
+        }
+
+        /* The Lovasz condition r[k][k] >= (delta - mu[k][k-1]**2) *
+         * r[k-1][k-1]. */
+        mpfr_sqr(f, MU(k, k - 1), MPFR_RNDN);
+        mpfr_sub(f, d, f, MPFR_RNDN);
+        mpfr_mul(f, f, R(k - 1, k - 1), MPFR_RNDN);
+        if (mpfr_cmp(R(k, k), f) >= 0) {
+            k++;
+            continue;
+        }
+
+        for (j = 0; j < m; j++)
+            mpz_swap(LLL_ROW(k)[j], LLL_ROW(k - 1)[j]);
+        for (i = 0; i < n; i++) {
+            if (i != k && i != k - 1)
+                mpz_swap(G(k, i), G(k - 1, i));
+        }
+        mpz_swap(G(k, k), G(k - 1, k - 1));
+        if (k > 1)
+            k--;
+        else
+            _GMPy_LLL_GSO(gram, mu, r, n, 0, f);
+    }
+
+  done:
+    _GMPy_Scratch_Release(mark);
+    for (i = 0; i < size; i++) {
+        mpz_clear(gram[i]);
+        mpfr_clear(mu[i]);
+        mpfr_clear(r[i]);
+    }
+    mpfr_clear(f);
+    mpfr_clear(d);
+    PyMem_RawFree(gram);
+    PyMem_RawFree(mu);
+    PyMem_RawFree(r);
+    return result;
+}
+
+#undef MU
+#undef R
+#undef G
+
+PyDoc_STRVAR(GMPy_doc_function_lll,
+"lll(basis, /, delta=0.99, exact=True) -> list | mpz_array\n\n"
+"Return the LLL reduction of the lattice spanned by the rows of basis,\n"
+"given as for matmul(). The rows must be linearly independent vectors of\n"
+"integers or rationals and 1/4 < delta <= 1. The result has the shape and\n"
+"the kind of basis. By default the Gram-Schmidt coefficients are kept as\n"
+"integers with de Weger's fraction-free algorithm, so the result is\n"
+"size-reduced and satisfies the Lovasz condition exactly. With\n"
+"exact=False they are mpfr values at the precision of the context,\n"
+"computed from the exact Gram matrix, and the coefficients are reduced\n"
+"to at most 0.51 in absolute value; a ValueError is raised if the\n"
+"precision is not enough for the size reduction to converge. The basis is\n"
+"always transformed exactly. The GIL is released.");
+
+static PyObject *
+GMPy_Context_LLL(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"basis", "delta", "exact", NULL};
+    gmpy_matrix a, c;
+    gmpy_interrupt intr;
+    PyObject *basis, *dobj = NULL, *result = NULL;
+    CTXT_Object *context = NULL;
+    MPQ_Object *delta = NULL;
+    mpz_t *w = NULL;
+    mpz_t scale, p, q;
+    size_t bits;
+    Py_ssize_t i, j, n = 0, m, size = 0;
+    int exact = 1, status;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|Op", kwlist,
+                                     &basis, &dobj, &exact))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    memset(&c, 0, sizeof(gmpy_matrix));
+    mpz_init(scale);
+    mpz_init(p);
+    mpz_init(q);
+
+    if (_GMPy_Matrix_Parse(&a, basis, 0, "lll") < 0)
+        goto done;
+    if (a.kind == VECTOR_REAL) {
+        TYPE_ERROR("lll() requires integer or rational values");
+        goto done;
+    }
+
+    if (dobj) {
+        if (!IS_REAL(dobj)) {
+            TYPE_ERROR("lll() delta must be a real number");
+            goto done;
+        }
+        delta = GMPy_MPQ_From_Number(dobj, context);
+    }
+    else {
+        if ((delta = GMPy_MPQ_New(context)))
+            mpq_set_ui(delta->q, 99, 100);
+    }
+    if (!delta)
+        goto done;
+    mpz_mul_2exp(p, mpq_numref(delta->q), 2);
+    if (mpz_cmp(p, mpq_denref(delta->q)) <= 0 || mpq_cmp_ui(delta->q, 1, 1) > 0) {
+        VALUE_ERROR("lll() requires 1/4 < delta <= 1");
+        goto done;
+    }
+    mpz_set(p, mpq_numref(delta->q));
+    mpz_set(q, mpq_denref(delta->q));
+
+    n = a.rows;
+    m = a.cols;
+    size = n * m;
+    if (_GMPy_Matrix_Convert(&a, a.kind, context) < 0 ||
+        _GMPy_Matrix_Output(&c, n, m, a.kind, MPZ_Array_Check(a.keep), context) < 0) {
+        goto done;
+    }
+    if (!(w = PyMem_New(mpz_t, size ? size : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (i = 0; i < size; i++)
+        mpz_init(w[i]);
+
+    /* Rational rows are scaled by the same factor, which scales the
+     * lattice. */
+    mpz_set_ui(scale, 1);
+    if (a.kind == VECTOR_RATIONAL) {
+        for (i = 0; i < size; i++)
+            mpz_lcm(scale, scale, mpq_denref((mpq_ptr)a.e[i]));
+        for (i = 0; i < size; i++) {
+            mpz_divexact(w[i], scale, mpq_denref((mpq_ptr)a.e[i]));
+            mpz_mul(w[i], w[i], mpq_numref((mpq_ptr)a.e[i]));
+        }
+    }
+    else {
+        for (i = 0; i < size; i++)
+            mpz_set(w[i], (mpz_ptr)a.e[i]);
+    }
+
+    bits = _GMPy_Matrix_Bits(&a, context) * n;
+    if (size)
+        GMPY_PROFILE_OPN(context, GMPY_OP_MUL, bits / size, size * n);
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    intr.save = &_save;
+    if (exact)
+        status = _GMPy_LLL_Exact(w, n, m, p, q);
+    else
+        status = _GMPy_LLL_Real(w, n, m, delta->q, GET_MPFR_PREC(context));
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (GMPy_Interrupt_End(&intr) < 0)
+        goto done;
+    if (status == LLL_DEPENDENT) {
+        VALUE_ERROR("lll() requires linearly independent rows");
+        goto done;
+    }
+    if (status == LLL_PRECISION) {
+        VALUE_ERROR("lll() needs a higher precision or exact=True");
+        goto done;
+    }
+    if (status == LLL_NOMEM) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < m; j++) {
+            if (a.kind == VECTOR_RATIONAL) {
+                mpz_set(mpq_numref(MAT_Q(&c, i, j)), w[i * m + j]);
+                mpz_set(mpq_denref(MAT_Q(&c, i, j)), scale);
+                mpq_canonicalize(MAT_Q(&c, i, j));
+            }
+            else {
+                mpz_set(MAT_Z(&c, i, j), w[i * m + j]);
+            }
+        }
+    }
+    result = _GMPy_Matrix_Result(&c, 0, context);
+
+  done:
+    if (w) {
+        for (i = 0; i < size; i++)
+            mpz_clear(w[i]);
+        PyMem_Free(w);
+    }
+    Py_XDECREF((PyObject*)delta);
+    mpz_clear(scale);
+    mpz_clear(p);
+    mpz_clear(q);
+    _GMPy_Matrix_Clear(&a);
+    _GMPy_Matrix_Clear(&c);
+    return result;
+}
@@ -85,3 +85,33 @@ GMPy_get_mp_limbsize(PyObject *self, PyObject *args)
 {
     return Py_BuildValue("i", mp_bits_per_limb);
 }
+
+/* Register the gmpy2 types with the numeric tower. It is called at import
+ * if the numbers module has already been imported, and otherwise by the
+ * hook in gmpy2/__init__.py once it is.
+ */
+
+PyDoc_STRVAR(GMPy_doc_register_numbers,
+"_register_numbers(numbers, /) -> None\n\n\
+Register mpz, mpq, mpfr, and mpc with the abstract base classes of the\n\
+numbers module.");
+
+static PyObject *
+GMPy_Register_Numbers(PyObject *self, PyObject *numbers)
+{
+    static const char *names[] = {"Integral", "Rational", "Real", "Complex"};
+    PyTypeObject *types[] = {&MPZ_Type, &MPQ_Type, &MPFR_Type, &MPC_Type};
+    PyObject *abc, *result;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        if (!(abc = PyObject_GetAttrString(numbers, names[i])))
+            return NULL;
+        result = PyObject_CallMethod(abc, "register", "O", (PyObject*)types[i]);
+        Py_DECREF(abc);
+        if (!result)
+            return NULL;
+        Py_DECREF(result);
+    }
+    Py_RETURN_NONE;
+}
@@ -37,6 +37,7 @@ static PyObject * GMPy_get_mp_version(PyObject *self, PyObject *args);
 static PyObject * GMPy_get_mpfr_version(PyObject *self, PyObject *args);
 static PyObject * GMPy_get_mpc_version(PyObject *self, PyObject *args);
 static PyObject * GMPy_get_mp_limbsize(PyObject *self, PyObject *args);
+static PyObject * GMPy_Register_Numbers(PyObject *self, PyObject *numbers);
 
 #ifdef __cplusplus
 }
@@ -35,7 +35,8 @@ GMPy_Integer_ModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
 
     CHECK_CONTEXT(context);
 
-    if (!(result = GMPy_MPZ_New(context))) {
+    if (!(result = GMPy_MPZ_Reuse(x, xtype, y, ytype)) &&
+        !(result = GMPy_MPZ_New(context))) {
         /* LCOV_EXCL_START */
         return NULL;
         /* LCOV_EXCL_STOP */
@@ -48,17 +49,16 @@ GMPy_Integer_ModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
                 Py_DECREF((PyObject*)result);
                 return NULL;
             }
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), MPZ(y)));
             mpz_fdiv_r(result->z, MPZ(x), MPZ(y));
             GMPY_MAYBE_END_ALLOW_THREADS(context);
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
 
         if (IS_TYPE_PyInteger(ytype)) {
-            int error;
-            long temp = PyLong_AsLongAndOverflow(y, &error);
+            long temp;
 
-            if (!error) {
+            if (GMPy_PyLong_AsSmall(y, &temp)) {
                 if (temp > 0) {
                     mpz_fdiv_r_ui(result->z, MPZ(x), temp);
                 }
@@ -73,11 +73,11 @@ GMPy_Integer_ModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             }
             else {
                 mpz_set_PyLong(result->z, y);
-                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), result->z));
                 mpz_fdiv_r(result->z, MPZ(x), result->z);
                 GMPY_MAYBE_END_ALLOW_THREADS(context);
             }
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
 
     }
@@ -92,7 +92,7 @@ GMPy_Integer_ModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
         if (PyLong_Check(x)) {
             mpz_set_PyLong(result->z, x);
             mpz_fdiv_r(result->z, result->z, MPZ(y));
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
     }
 
@@ -116,12 +116,12 @@ GMPy_Integer_ModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             Py_DECREF((PyObject*)result);
             return NULL;
         }
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(tempx->z, tempy->z));
         mpz_fdiv_r(result->z, tempx->z, tempy->z);
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_DECREF((PyObject*)tempx);
         Py_DECREF((PyObject*)tempy);
-        return (PyObject*)result;
+        return GMPy_MPZ_Small_Result(result);
     }
 
     /* LCOV_EXCL_START */
@@ -170,7 +170,7 @@ GMPy_Rational_ModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             return NULL;
         }
 
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(tempx->q, tempy->q));
         mpq_div(result->q, tempx->q, tempy->q);
         mpz_fdiv_q(tempz->z, mpq_numref(result->q), mpq_denref(result->q));
         /* Need to calculate x - tempz * y. */
@@ -214,7 +214,7 @@ GMPy_Real_ModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
         }
 
         if (mpfr_zero_p(tempy->f)) {
-            context->ctx.divzero = 1;
+            GMPY_CTXT_FLAGS(context)->divzero = 1;
             if (context->ctx.traps & TRAP_DIVZERO) {
                 GMPY_DIVZERO("mod() modulo by zero");
                 goto error;
@@ -224,7 +224,7 @@ GMPy_Real_ModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
         mpfr_clear_flags();
 
         if (mpfr_nan_p(tempx->f) || mpfr_nan_p(tempy->f) || mpfr_inf_p(tempx->f)) {
-            context->ctx.invalid = 1;
+            GMPY_CTXT_FLAGS(context)->invalid = 1;
             if (context->ctx.traps & TRAP_INVALID) {
                 GMPY_INVALID("mod() invalid operation");
                 goto error;
@@ -232,7 +232,7 @@ GMPy_Real_ModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             mpfr_set_nan(result->f);
         }
         else if (mpfr_inf_p(tempy->f)) {
-            context->ctx.invalid = 1;
+            GMPY_CTXT_FLAGS(context)->invalid = 1;
             if (context->ctx.traps & TRAP_INVALID) {
                 GMPY_INVALID("mod() invalid operation");
                 goto error;
@@ -285,23 +285,28 @@ GMPy_Complex_ModWithType(PyObject *x, int xtype, PyObject *y, int ytype,
     return NULL;
 }
 
+/* Indexed by GMPY_TYPE_CLASS2(xtype, ytype). */
+
+static gmpy_binary_withtype const GMPy_Mod_Table[OBJ_CLASS_COUNT] = {
+    GMPy_Integer_ModWithType,
+    GMPy_Rational_ModWithType,
+    GMPy_Real_ModWithType,
+    GMPy_Complex_ModWithType,
+};
+
 static PyObject *
 GMPy_Number_Mod_Slot(PyObject *x, PyObject *y)
 {
+    CTXT_Object *context = NULL;
+    CHECK_CONTEXT(context);
+
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_ModWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_ModWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_ModWithType(x, xtype, y, ytype, NULL);
+    GMPY_PROFILE_OP2(context, GMPY_OP_MOD, x, xtype, y, ytype);
 
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_ModWithType(x, xtype, y, ytype, NULL);
+    if (xtype && ytype)
+        return GMPy_Mod_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, context);
 
     Py_RETURN_NOTIMPLEMENTED;
 }
@@ -318,17 +323,10 @@ GMPy_Number_Mod(PyObject *x, PyObject *y, CTXT_Object *context)
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_ModWithType(x, xtype, y, ytype, context);
-
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_ModWithType(x, xtype, y, ytype, context);
-
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_ModWithType(x, xtype, y, ytype, context);
+    GMPY_PROFILE_OP2(context, GMPY_OP_MOD, x, xtype, y, ytype);
 
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_ModWithType(x, xtype, y, ytype, context);
+    if (xtype && ytype)
+        return GMPy_Mod_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, context);
 
     TYPE_ERROR("mod() argument type not supported");
     return NULL;
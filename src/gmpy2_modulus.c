@@ -0,0 +1,825 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_modulus.c                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Arithmetic modulo a fixed m.
+ *
+ * Every method returns a residue 0 <= r < m. Operands that are already
+ * reduced are used as is, so add() and sub() never divide and mul() needs
+ * a single remainder of the double length product. The v*() methods apply
+ * the same operation to whole sequences without the GIL.
+ */
+
+enum {
+    MODULUS_REDUCE,
+    MODULUS_ADD,
+    MODULUS_SUB,
+    MODULUS_MUL,
+    MODULUS_SQR,
+    MODULUS_POW,
+    MODULUS_INV
+};
+
+PyDoc_STRVAR(GMPy_doc_modulus,
+"Modulus(m, /) -> Modulus\n\n"
+"Return an object that performs arithmetic modulo m, m > 0. All methods\n"
+"accept integers and return an mpz in the range 0 <= r < m. Arguments\n"
+"already in that range are not reduced again. The methods vadd(), vsub(),\n"
+"vmul(), vsqr(), vpow(), and vinv() work on sequences; either argument of\n"
+"a binary method can be a single integer that is combined with every\n"
+"element of the other. They return an mpz_array if an argument is an\n"
+"mpz_array and a list otherwise.");
+
+/* Find the form of m. */
+
+static void
+_GMPy_Modulus_Form_Init(gmpy_modulus_form *f, mpz_srcptr m)
+{
+    mp_bitcnt_t bits = mpz_sizeinbase(m, 2);
+    mpz_t t;
+
+    f->m = m;
+    f->k = 0;
+    f->c = 0;
+    f->neg = 0;
+    if (mpz_sgn(m) < 0 || mpz_size(m) < GMPY_MODULUS_FORM_MIN_LIMBS)
+        return;
+
+    mpz_init_set(t, m);
+    mpz_clrbit(t, bits - 1);
+    if (mpz_sgn(t) > 0 && mpz_fits_ulong_p(t)) {
+        f->k = bits - 1;
+        f->c = mpz_get_ui(t);
+        f->neg = 1;
+    }
+    else {
+        mpz_set_ui(t, 0);
+        mpz_setbit(t, bits);
+        mpz_sub(t, t, m);
+        if (mpz_fits_ulong_p(t)) {
+            f->k = bits;
+            f->c = mpz_get_ui(t);
+        }
+    }
+    mpz_clear(t);
+}
+
+/* Set r to a mod m; h is scratch space and must not be r. Values with at
+ * most about twice the bits of m, such as products of residues, are
+ * reduced through the form of m: with a = h*2**k + l, a - h*m = l + h*c.
+ * Does not use the Python API.
+ */
+
+static void
+_GMPy_Modulus_Mod(const gmpy_modulus_form *f, mpz_ptr r, mpz_srcptr a,
+                  mpz_ptr h)
+{
+    if (!f->k || mpz_sizeinbase(a, 2) > 2 * f->k + 1) {
+        mpz_mod(r, a, f->m);
+        return;
+    }
+
+    while (mpz_sizeinbase(a, 2) > f->k) {
+        mpz_fdiv_q_2exp(h, a, f->k);
+        mpz_fdiv_r_2exp(r, a, f->k);
+        if (f->neg)
+            mpz_submul_ui(r, h, f->c);
+        else
+            mpz_addmul_ui(r, h, f->c);
+        a = r;
+    }
+    if (a != r)
+        mpz_set(r, a);
+    while (mpz_sgn(r) < 0)
+        mpz_add(r, r, f->m);
+    while (mpz_cmp(r, f->m) >= 0)
+        mpz_sub(r, r, f->m);
+}
+
+/* Set r to op(a, b) mod m. r must not be a or b; t and u are scratch
+ * space. Returns -1 if the inverse of a does not exist. Does not use the
+ * Python API.
+ */
+
+static int
+_GMPy_Modulus_Op(int op, mpz_ptr r, mpz_srcptr a, mpz_srcptr b,
+                 const gmpy_modulus_form *f, mpz_ptr t, mpz_ptr u)
+{
+    mpz_srcptr m = f->m;
+
+    if (mpz_sgn(a) < 0 || mpz_cmp(a, m) >= 0) {
+        _GMPy_Modulus_Mod(f, t, a, u);
+        a = t;
+    }
+    if (op != MODULUS_POW && b && (mpz_sgn(b) < 0 || mpz_cmp(b, m) >= 0)) {
+        _GMPy_Modulus_Mod(f, u, b, r);
+        b = u;
+    }
+
+    switch (op) {
+    case MODULUS_REDUCE:
+        mpz_set(r, a);
+        break;
+    case MODULUS_ADD:
+        mpz_add(r, a, b);
+        if (mpz_cmp(r, m) >= 0)
+            mpz_sub(r, r, m);
+        break;
+    case MODULUS_SUB:
+        mpz_sub(r, a, b);
+        if (mpz_sgn(r) < 0)
+            mpz_add(r, r, m);
+        break;
+    case MODULUS_MUL:
+        mpz_mul(r, a, b);
+        _GMPy_Modulus_Mod(f, r, r, u);
+        break;
+    case MODULUS_SQR:
+        mpz_mul(r, a, a);
+        _GMPy_Modulus_Mod(f, r, r, u);
+        break;
+    case MODULUS_POW:
+        if (mpz_sgn(b) < 0) {
+            if (!mpz_invert(r, a, m))
+                return -1;
+            mpz_neg(u, b);
+            mpz_powm(r, r, u, m);
+        }
+        else {
+            mpz_powm(r, a, b, m);
+        }
+        break;
+    case MODULUS_INV:
+        if (!mpz_invert(r, a, m))
+            return -1;
+        /* Keep the result reduced if m == 1. */
+        mpz_tdiv_r(r, r, m);
+        break;
+    }
+    return 0;
+}
+
+typedef struct {
+    int op;
+    const gmpy_modulus_form *form;
+    mpz_srcptr *x;        /* NULL if xs is used for every element */
+    mpz_srcptr *y;        /* NULL if ys is used for every element */
+    mpz_srcptr xs;
+    mpz_srcptr ys;
+    mpz_ptr *out;
+    int nomem;
+} gmpy_modulus_batch;
+
+/* A failed inverse is marked by setting the result to -1 so the threads
+ * never write to shared state.
+ */
+
+static void
+_GMPy_Modulus_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_modulus_batch *work = (gmpy_modulus_batch*)arg;
+    Py_ssize_t i;
+    mpz_t t, u;
+
+    mpz_init(t);
+    mpz_init(u);
+    for (i = start; i < stop; i++) {
+        if (_GMPy_Modulus_Op(work->op, work->out[i],
+                             work->x ? work->x[i] : work->xs,
+                             work->y ? work->y[i] : work->ys,
+                             work->form, t, u) < 0) {
+            mpz_set_si(work->out[i], -1);
+        }
+    }
+    mpz_clear(t);
+    mpz_clear(u);
+}
+
+/* Invert a range of x with Montgomery's trick: one inversion of the
+ * product of the range and three multiplications per element. If the
+ * product is not invertible, only the first element without an inverse is
+ * set to -1. work->op is ignored and work->x must not be NULL.
+ */
+
+static void
+_GMPy_Modulus_Inv_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_modulus_batch *work = (gmpy_modulus_batch*)arg;
+    const gmpy_modulus_form *f = work->form;
+    mpz_srcptr m = f->m;
+    mpz_t *prefix, inv, t, u;
+    Py_ssize_t i, len = stop - start;
+
+    if (len <= 0)
+        return;
+    if (!(prefix = PyMem_RawMalloc(len * sizeof(mpz_t)))) {
+        work->nomem = 1;
+        return;
+    }
+
+    /* prefix[j] is the product of the first j + 1 reduced values. */
+
+    mpz_init(inv);
+    mpz_init(t);
+    mpz_init(u);
+    for (i = 0; i < len; i++) {
+        mpz_init(prefix[i]);
+        _GMPy_Modulus_Mod(f, work->out[start + i], work->x[start + i], u);
+        if (i == 0) {
+            mpz_set(prefix[0], work->out[start]);
+        }
+        else {
+            mpz_mul(prefix[i], prefix[i - 1], work->out[start + i]);
+            _GMPy_Modulus_Mod(f, prefix[i], prefix[i], u);
+        }
+    }
+
+    if (!mpz_invert(inv, prefix[len - 1], m)) {
+        for (i = start; i < stop; i++) {
+            if (!mpz_invert(t, work->out[i], m)) {
+                mpz_set_si(work->out[i], -1);
+                break;
+            }
+        }
+    }
+    else {
+        /* inv is the inverse of prefix[i]; peel off one value per step. */
+        for (i = len - 1; i > 0; i--) {
+            mpz_mul(t, inv, work->out[start + i]);
+            _GMPy_Modulus_Mod(f, t, t, u);
+            mpz_mul(work->out[start + i], inv, prefix[i - 1]);
+            _GMPy_Modulus_Mod(f, work->out[start + i], work->out[start + i], u);
+            mpz_swap(inv, t);
+        }
+        /* Keep the result reduced if m == 1. */
+        mpz_tdiv_r(work->out[start], inv, m);
+    }
+    mpz_clear(inv);
+    mpz_clear(t);
+    mpz_clear(u);
+    for (i = 0; i < len; i++)
+        mpz_clear(prefix[i]);
+    PyMem_RawFree(prefix);
+}
+
+static PyObject *
+GMPy_Modulus_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    Modulus_Object *result;
+    MPZ_Object *tempm;
+    CTXT_Object *context = NULL;
+
+    if (keywds && PyDict_Size(keywds)) {
+        TYPE_ERROR("Modulus() takes no keyword arguments");
+        return NULL;
+    }
+
+    if (PyTuple_GET_SIZE(args) != 1) {
+        TYPE_ERROR("Modulus() requires 1 argument");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_INTEGER(PyTuple_GET_ITEM(args, 0))) {
+        TYPE_ERROR("Modulus() requires an integer argument");
+        return NULL;
+    }
+
+    if (!(tempm = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), context)))
+        return NULL;
+
+    if (mpz_sgn(tempm->z) < 1) {
+        VALUE_ERROR("Modulus() 'mod' must be > 0");
+        Py_DECREF((PyObject*)tempm);
+        return NULL;
+    }
+
+    if ((result = PyObject_New(Modulus_Object, &Modulus_Type))) {
+        mpz_init_set(result->m, tempm->z);
+        _GMPy_Modulus_Form_Init(&result->form, result->m);
+    }
+    Py_DECREF((PyObject*)tempm);
+    return (PyObject*)result;
+}
+
+static void
+GMPy_Modulus_Dealloc(Modulus_Object *self)
+{
+    mpz_clear(self->m);
+    PyObject_Free(self);
+}
+
+static PyObject *
+GMPy_Modulus_GetModulus(Modulus_Object *self, void *closure)
+{
+    MPZ_Object *result;
+
+    if ((result = GMPy_MPZ_New(NULL)))
+        mpz_set(result->z, self->m);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_Modulus_GetForm(Modulus_Object *self, void *closure)
+{
+    PyObject *c, *result;
+
+    if (!self->form.k)
+        Py_RETURN_NONE;
+
+    if (!(c = PyLong_FromUnsignedLong(self->form.c)))
+        return NULL;
+    if (self->form.neg)
+        Py_SETREF(c, PyNumber_Negative(c));
+    if (!c)
+        return NULL;
+    result = Py_BuildValue("(KN)", (unsigned long long)self->form.k, c);
+    return result;
+}
+
+static PyObject *
+GMPy_Modulus_Repr_Slot(Modulus_Object *self)
+{
+    PyObject *m, *result;
+
+    if (!(m = GMPy_Modulus_GetModulus(self, NULL)))
+        return NULL;
+    result = PyUnicode_FromFormat("Modulus(%S)", m);
+    Py_DECREF(m);
+    return result;
+}
+
+static int
+_GMPy_Modulus_Profile_Op(int op)
+{
+    switch (op) {
+    case MODULUS_SUB:
+        return GMPY_OP_SUB;
+    case MODULUS_MUL:
+    case MODULUS_SQR:
+        return GMPY_OP_MUL;
+    case MODULUS_POW:
+        return GMPY_OP_POWMOD;
+    case MODULUS_INV:
+        return GMPY_OP_INVERT;
+    default:
+        return GMPY_OP_ADD;
+    }
+}
+
+/* Return a new reference to obj as an mpz. */
+
+static MPZ_Object *
+_GMPy_Modulus_Arg(PyObject *obj, const char *name, CTXT_Object *context)
+{
+    if (MPZ_Check(obj)) {
+        Py_INCREF(obj);
+        return (MPZ_Object*)obj;
+    }
+    if (!IS_INTEGER(obj)) {
+        PyErr_Format(PyExc_TypeError, "Modulus.%s() requires integer arguments", name);
+        return NULL;
+    }
+    return GMPy_MPZ_From_Integer(obj, context);
+}
+
+/* Single operation. b is NULL for unary operations. */
+
+static PyObject *
+_GMPy_Modulus_Scalar(Modulus_Object *self, int op, PyObject *a, PyObject *b,
+                     const char *name)
+{
+    MPZ_Object *tempa = NULL, *tempb = NULL, *result = NULL;
+    CTXT_Object *context = NULL;
+    mpz_t t, u;
+    int res;
+
+    CHECK_CONTEXT(context);
+
+    if (!(tempa = _GMPy_Modulus_Arg(a, name, context)) ||
+        (b && !(tempb = _GMPy_Modulus_Arg(b, name, context))) ||
+        !(result = GMPy_MPZ_New(context))) {
+        Py_XDECREF((PyObject*)tempa);
+        Py_XDECREF((PyObject*)tempb);
+        return NULL;
+    }
+
+    GMPY_PROFILE_OP(context, _GMPy_Modulus_Profile_Op(op), mpz_sizeinbase(self->m, 2));
+    mpz_init(t);
+    mpz_init(u);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(self->m) *
+                                 (op == MODULUS_POW ? GMPY_MPZ_BITS(tempb->z) : 1));
+    res = _GMPy_Modulus_Op(op, result->z, tempa->z, tempb ? tempb->z : NULL,
+                           &self->form, t, u);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    mpz_clear(t);
+    mpz_clear(u);
+
+    Py_DECREF((PyObject*)tempa);
+    Py_XDECREF((PyObject*)tempb);
+    if (res < 0) {
+        PyErr_Format(PyExc_ValueError, "Modulus.%s() base not invertible", name);
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    return (PyObject*)result;
+}
+
+/* Batch operation. Either argument may be a single integer; y is NULL for
+ * unary operations.
+ */
+
+static PyObject *
+_GMPy_Modulus_Batch(Modulus_Object *self, int op, PyObject *x, PyObject *y,
+                    const char *name)
+{
+    gmpy_rational_view xview, yview;
+    gmpy_modulus_batch work;
+    MPZ_Object *xs = NULL, *ys = NULL;
+    PyObject *result = NULL, *temp;
+    CTXT_Object *context = NULL;
+    Py_ssize_t i, n = 0;
+    int xseq, yseq, array;
+
+    CHECK_CONTEXT(context);
+
+    memset(&xview, 0, sizeof(gmpy_rational_view));
+    memset(&yview, 0, sizeof(gmpy_rational_view));
+    memset(&work, 0, sizeof(gmpy_modulus_batch));
+
+    xseq = !IS_INTEGER(x);
+    yseq = y && !IS_INTEGER(y);
+    array = MPZ_Array_Check(x) || (y && MPZ_Array_Check(y));
+
+    if (!xseq && !yseq) {
+        PyErr_Format(PyExc_TypeError,
+                     "Modulus.%s() requires at least one sequence argument", name);
+        return NULL;
+    }
+
+    if (xseq) {
+        if (_GMPy_View_Init(&xview, x, name, context) < 0)
+            return NULL;
+        work.x = xview.num;
+        n = xview.n;
+    }
+    else if (!(xs = GMPy_MPZ_From_Integer(x, context))) {
+        return NULL;
+    }
+    else {
+        work.xs = xs->z;
+    }
+
+    if (yseq) {
+        if (_GMPy_View_Init(&yview, y, name, context) < 0)
+            goto done;
+        if (xseq && yview.n != n) {
+            PyErr_Format(PyExc_ValueError,
+                         "Modulus.%s() requires sequences of the same length", name);
+            goto done;
+        }
+        work.y = yview.num;
+        n = yview.n;
+    }
+    else if (y) {
+        if (!(ys = GMPy_MPZ_From_Integer(y, context)))
+            goto done;
+        work.ys = ys->z;
+    }
+
+    if (xview.rational || yview.rational) {
+        PyErr_Format(PyExc_TypeError, "Modulus.%s() requires integer arguments", name);
+        goto done;
+    }
+
+    if (!(work.out = PyMem_New(mpz_ptr, n ? n : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    if (array) {
+        if (!(result = (PyObject*)GMPy_MPZ_Array_New(n)))
+            goto done;
+        for (i = 0; i < n; i++)
+            work.out[i] = ((MPZ_Array_Object*)result)->z[i];
+    }
+    else {
+        if (!(result = PyList_New(n)))
+            goto done;
+        for (i = 0; i < n; i++) {
+            if (!(temp = (PyObject*)GMPy_MPZ_New(context))) {
+                Py_CLEAR(result);
+                goto done;
+            }
+            PyList_SET_ITEM(result, i, temp);
+            work.out[i] = MPZ(temp);
+        }
+    }
+
+    work.op = op;
+    work.form = &self->form;
+    GMPY_PROFILE_OPN(context, _GMPy_Modulus_Profile_Op(op),
+                     mpz_sizeinbase(self->m, 2), n);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(self->m) * n);
+    GMPy_Parallel_Run(op == MODULUS_INV ? _GMPy_Modulus_Inv_Range : _GMPy_Modulus_Range,
+                      &work, n, GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (work.nomem) {
+        PyErr_NoMemory();
+        Py_CLEAR(result);
+        goto done;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (mpz_sgn(work.out[i]) < 0) {
+            PyErr_Format(PyExc_ValueError, "Modulus.%s() base not invertible", name);
+            Py_CLEAR(result);
+            break;
+        }
+    }
+
+  done:
+    PyMem_Free(work.out);
+    _GMPy_View_Clear(&xview);
+    _GMPy_View_Clear(&yview);
+    Py_XDECREF((PyObject*)xs);
+    Py_XDECREF((PyObject*)ys);
+    return result;
+}
+
+static int
+_GMPy_Modulus_Args(Py_ssize_t nargs, const char *name)
+{
+    if (nargs != 2) {
+        PyErr_Format(PyExc_TypeError, "Modulus.%s() requires 2 arguments", name);
+        return -1;
+    }
+    return 0;
+}
+
+#define GMPY_MODULUS_BINARY(NAME, OP, FUNC, BATCH) \
+static PyObject * \
+GMPy_Modulus_##NAME(Modulus_Object *self, PyObject * const *args, Py_ssize_t nargs) \
+{ \
+    if (_GMPy_Modulus_Args(nargs, #FUNC) < 0) \
+        return NULL; \
+    return _GMPy_Modulus_Scalar(self, OP, args[0], args[1], #FUNC); \
+} \
+static PyObject * \
+GMPy_Modulus_V##NAME(Modulus_Object *self, PyObject * const *args, Py_ssize_t nargs) \
+{ \
+    if (_GMPy_Modulus_Args(nargs, #BATCH) < 0) \
+        return NULL; \
+    return _GMPy_Modulus_Batch(self, OP, args[0], args[1], #BATCH); \
+}
+
+#define GMPY_MODULUS_UNARY(NAME, OP, FUNC, BATCH) \
+static PyObject * \
+GMPy_Modulus_##NAME(Modulus_Object *self, PyObject *other) \
+{ \
+    return _GMPy_Modulus_Scalar(self, OP, other, NULL, #FUNC); \
+} \
+static PyObject * \
+GMPy_Modulus_V##NAME(Modulus_Object *self, PyObject *other) \
+{ \
+    return _GMPy_Modulus_Batch(self, OP, other, NULL, #BATCH); \
+}
+
+GMPY_MODULUS_BINARY(Add, MODULUS_ADD, add, vadd)
+GMPY_MODULUS_BINARY(Sub, MODULUS_SUB, sub, vsub)
+GMPY_MODULUS_BINARY(Mul, MODULUS_MUL, mul, vmul)
+GMPY_MODULUS_BINARY(Pow, MODULUS_POW, pow, vpow)
+GMPY_MODULUS_UNARY(Sqr, MODULUS_SQR, sqr, vsqr)
+GMPY_MODULUS_UNARY(Inv, MODULUS_INV, inv, vinv)
+GMPY_MODULUS_UNARY(Reduce, MODULUS_REDUCE, reduce, vreduce)
+
+PyDoc_STRVAR(GMPy_doc_modulus_reduce,
+"x.reduce(a, /) -> mpz\n\n"
+"Return a mod m.");
+
+PyDoc_STRVAR(GMPy_doc_modulus_add,
+"x.add(a, b, /) -> mpz\n\n"
+"Return (a + b) mod m.");
+
+PyDoc_STRVAR(GMPy_doc_modulus_sub,
+"x.sub(a, b, /) -> mpz\n\n"
+"Return (a - b) mod m.");
+
+PyDoc_STRVAR(GMPy_doc_modulus_mul,
+"x.mul(a, b, /) -> mpz\n\n"
+"Return (a * b) mod m.");
+
+PyDoc_STRVAR(GMPy_doc_modulus_sqr,
+"x.sqr(a, /) -> mpz\n\n"
+"Return (a * a) mod m.");
+
+PyDoc_STRVAR(GMPy_doc_modulus_pow,
+"x.pow(a, e, /) -> mpz\n\n"
+"Return powmod(a, e, m). A negative e requires a to be invertible.");
+
+PyDoc_STRVAR(GMPy_doc_modulus_inv,
+"x.inv(a, /) -> mpz\n\n"
+"Return the inverse of a mod m. Raises ValueError if it does not exist.");
+
+PyDoc_STRVAR(GMPy_doc_modulus_vreduce,
+"x.vreduce(a, /) -> list | mpz_array\n\n"
+"Return [x.reduce(i) for i in a].");
+
+PyDoc_STRVAR(GMPy_doc_modulus_vadd,
+"x.vadd(a, b, /) -> list | mpz_array\n\n"
+"Return [x.add(i, j) for i, j in zip(a, b)].");
+
+PyDoc_STRVAR(GMPy_doc_modulus_vsub,
+"x.vsub(a, b, /) -> list | mpz_array\n\n"
+"Return [x.sub(i, j) for i, j in zip(a, b)].");
+
+PyDoc_STRVAR(GMPy_doc_modulus_vmul,
+"x.vmul(a, b, /) -> list | mpz_array\n\n"
+"Return [x.mul(i, j) for i, j in zip(a, b)].");
+
+PyDoc_STRVAR(GMPy_doc_modulus_vsqr,
+"x.vsqr(a, /) -> list | mpz_array\n\n"
+"Return [x.sqr(i) for i in a].");
+
+PyDoc_STRVAR(GMPy_doc_modulus_vpow,
+"x.vpow(a, e, /) -> list | mpz_array\n\n"
+"Return [x.pow(i, j) for i, j in zip(a, e)].");
+
+PyDoc_STRVAR(GMPy_doc_modulus_vinv,
+"x.vinv(a, /) -> list | mpz_array\n\n"
+"Return [x.inv(i) for i in a]. Uses one inversion per thread and three\n"
+"multiplications per element.");
+
+static PyMethodDef GMPy_Modulus_methods[] =
+{
+    { "add", (PyCFunction)(void(*)(void))GMPy_Modulus_Add, METH_FASTCALL, GMPy_doc_modulus_add },
+    { "inv", (PyCFunction)GMPy_Modulus_Inv, METH_O, GMPy_doc_modulus_inv },
+    { "mul", (PyCFunction)(void(*)(void))GMPy_Modulus_Mul, METH_FASTCALL, GMPy_doc_modulus_mul },
+    { "pow", (PyCFunction)(void(*)(void))GMPy_Modulus_Pow, METH_FASTCALL, GMPy_doc_modulus_pow },
+    { "reduce", (PyCFunction)GMPy_Modulus_Reduce, METH_O, GMPy_doc_modulus_reduce },
+    { "sqr", (PyCFunction)GMPy_Modulus_Sqr, METH_O, GMPy_doc_modulus_sqr },
+    { "sub", (PyCFunction)(void(*)(void))GMPy_Modulus_Sub, METH_FASTCALL, GMPy_doc_modulus_sub },
+    { "vadd", (PyCFunction)(void(*)(void))GMPy_Modulus_VAdd, METH_FASTCALL, GMPy_doc_modulus_vadd },
+    { "vinv", (PyCFunction)GMPy_Modulus_VInv, METH_O, GMPy_doc_modulus_vinv },
+    { "vmul", (PyCFunction)(void(*)(void))GMPy_Modulus_VMul, METH_FASTCALL, GMPy_doc_modulus_vmul },
+    { "vpow", (PyCFunction)(void(*)(void))GMPy_Modulus_VPow, METH_FASTCALL, GMPy_doc_modulus_vpow },
+    { "vreduce", (PyCFunction)GMPy_Modulus_VReduce, METH_O, GMPy_doc_modulus_vreduce },
+    { "vsqr", (PyCFunction)GMPy_Modulus_VSqr, METH_O, GMPy_doc_modulus_vsqr },
+    { "vsub", (PyCFunction)(void(*)(void))GMPy_Modulus_VSub, METH_FASTCALL, GMPy_doc_modulus_vsub },
+    { NULL }
+};
+
+static PyGetSetDef GMPy_Modulus_getseters[] =
+{
+    { "form", (getter)GMPy_Modulus_GetForm, NULL,
+      "(k, c) if the modulus is 2**k - c with a word-size c != 0 that is used\n"
+      "for a faster reduction, else None", NULL },
+    { "modulus", (getter)GMPy_Modulus_GetModulus, NULL, "modulus", NULL },
+    { NULL }
+};
+
+static PyTypeObject Modulus_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.Modulus",
+    .tp_basicsize = sizeof(Modulus_Object),
+    .tp_dealloc = (destructor) GMPy_Modulus_Dealloc,
+    .tp_repr = (reprfunc) GMPy_Modulus_Repr_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_modulus,
+    .tp_methods = GMPy_Modulus_methods,
+    .tp_getset = GMPy_Modulus_getseters,
+    .tp_new = GMPy_Modulus_NewInit,
+};
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_invert_many,
+"invert_many(values, m, /) -> list | mpz_array\n\n"
+"Return [invert(x, m) for x in values]. Montgomery's trick replaces the\n"
+"inversions by a single one and three multiplications per value. Raises\n"
+"ZeroDivisionError if a value has no inverse; the message gives its\n"
+"index. Returns an mpz_array if values is an mpz_array and a list\n"
+"otherwise. The GIL is released and the values are split over the\n"
+"context's threads.");
+
+static PyObject *
+GMPy_MPZ_Function_Invert_Many(PyObject *self, PyObject *args)
+{
+    gmpy_rational_view view;
+    gmpy_modulus_batch work;
+    gmpy_modulus_form form;
+    MPZ_Object *tempm = NULL;
+    PyObject *values, *result = NULL, *temp;
+    CTXT_Object *context = NULL;
+    Py_ssize_t i, n;
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("invert_many() requires 2 arguments");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    values = PyTuple_GET_ITEM(args, 0);
+    if (!IS_INTEGER(PyTuple_GET_ITEM(args, 1))) {
+        TYPE_ERROR("invert_many() requires an integer modulus");
+        return NULL;
+    }
+    if (!(tempm = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), context)))
+        return NULL;
+    if (mpz_sgn(tempm->z) == 0) {
+        ZERO_ERROR("invert_many() division by 0");
+        Py_DECREF((PyObject*)tempm);
+        return NULL;
+    }
+
+    memset(&work, 0, sizeof(gmpy_modulus_batch));
+    if (_GMPy_View_Init(&view, values, "invert_many", context) < 0) {
+        Py_DECREF((PyObject*)tempm);
+        return NULL;
+    }
+    n = view.n;
+
+    if (view.rational) {
+        TYPE_ERROR("invert_many() requires integer arguments");
+        goto done;
+    }
+
+    if (!(work.out = PyMem_New(mpz_ptr, n ? n : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    if (MPZ_Array_Check(values)) {
+        if (!(result = (PyObject*)GMPy_MPZ_Array_New(n)))
+            goto done;
+        for (i = 0; i < n; i++)
+            work.out[i] = ((MPZ_Array_Object*)result)->z[i];
+    }
+    else {
+        if (!(result = PyList_New(n)))
+            goto done;
+        for (i = 0; i < n; i++) {
+            if (!(temp = (PyObject*)GMPy_MPZ_New(context))) {
+                Py_CLEAR(result);
+                goto done;
+            }
+            PyList_SET_ITEM(result, i, temp);
+            work.out[i] = MPZ(temp);
+        }
+    }
+
+    _GMPy_Modulus_Form_Init(&form, tempm->z);
+    work.op = MODULUS_INV;
+    work.form = &form;
+    work.x = view.num;
+    GMPY_PROFILE_OPN(context, GMPY_OP_INVERT, mpz_sizeinbase(tempm->z, 2), n);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(tempm->z) * n);
+    GMPy_Parallel_Run(_GMPy_Modulus_Inv_Range, &work, n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (work.nomem) {
+        PyErr_NoMemory();
+        Py_CLEAR(result);
+        goto done;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (mpz_sgn(work.out[i]) < 0) {
+            PyErr_Format(PyExc_ZeroDivisionError,
+                         "invert_many() no inverse exists for values[%zd]", i);
+            Py_CLEAR(result);
+            break;
+        }
+    }
+
+  done:
+    PyMem_Free(work.out);
+    _GMPy_View_Clear(&view);
+    Py_DECREF((PyObject*)tempm);
+    return result;
+}
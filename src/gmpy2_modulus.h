@@ -0,0 +1,65 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_modulus.h                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_MODULUS_H
+#define GMPY_MODULUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A modulus m = 2**k - c, where c is a nonzero word of either sign, is
+ * reduced with shifts, a multiplication by c, and additions instead of a
+ * division. k is 0 for other moduli and for moduli with fewer than
+ * GMPY_MODULUS_FORM_MIN_LIMBS limbs, for which a division is as fast.
+ */
+
+#define GMPY_MODULUS_FORM_MIN_LIMBS 4
+
+typedef struct {
+    mpz_srcptr m;
+    mp_bitcnt_t k;
+    unsigned long c;        /* |c| */
+    int neg;                /* c < 0, so m = 2**k + |c| */
+} gmpy_modulus_form;
+
+/* A Modulus performs arithmetic on residues 0 <= x < m. */
+
+typedef struct {
+    PyObject_HEAD
+    mpz_t m;
+    gmpy_modulus_form form;
+} Modulus_Object;
+
+static PyTypeObject Modulus_Type;
+#define Modulus_Check(v) (((PyObject*)v)->ob_type == &Modulus_Type)
+
+static PyObject * GMPy_MPZ_Function_Invert_Many(PyObject *self, PyObject *args);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,216 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mont.c                                                            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* See gmpy2_mont.h. */
+
+static void
+_GMPy_Mont_Init(gmpy_mont *mont, mpz_srcptr m, mpz_ptr r2)
+{
+    mp_size_t i, n = mpz_size(m);
+    mp_limb_t m0, inv;
+    mp_ptr p;
+
+    /* Newton iteration for 1/m0 mod B; m0 is its own inverse mod 8 and
+     * every step doubles the number of correct bits.
+     */
+    m0 = mpz_getlimbn(m, 0);
+    inv = m0;
+    for (i = 3; i < GMP_NUMB_BITS; i *= 2)
+        inv *= 2 - m0 * inv;
+
+    mpz_set_ui(r2, 0);
+    mpz_setbit(r2, 2 * n * GMP_NUMB_BITS);
+    mpz_mod(r2, r2, m);
+
+    /* Pad r2 to n limbs; the value of r2 is not changed. */
+    i = mpz_size(r2);
+    p = mpz_limbs_modify(r2, n);
+    for (; i < n; i++)
+        p[i] = 0;
+
+    mont->n = n;
+    mont->minv = -inv;
+    mont->m = mpz_limbs_read(m);
+    mont->r2 = p;
+}
+
+/* Set r = t/R mod m for t < m*R and clobber t. */
+
+static void
+_GMPy_Mont_Redc(const gmpy_mont *mont, mp_ptr r, mp_ptr t)
+{
+    mp_size_t i, n = mont->n;
+
+    /* Each step clears t[i]; the carry out is kept in its place. */
+    for (i = 0; i < n; i++)
+        t[i] = mpn_addmul_1(t + i, mont->m, n, t[i] * mont->minv);
+
+    if (mpn_add_n(r, t + n, t, n) || mpn_cmp(r, mont->m, n) >= 0)
+        mpn_sub_n(r, r, mont->m, n);
+}
+
+static void
+_GMPy_Mont_Mul(const gmpy_mont *mont, mp_ptr r, mp_srcptr a, mp_srcptr b,
+               mp_ptr t)
+{
+#ifdef GMPY_MONT_INT128
+    if (mont->n == 1) {
+        unsigned __int128 x = (unsigned __int128)a[0] * b[0];
+        mp_limb_t lo = (mp_limb_t)x, m = mont->m[0];
+
+        /* x + (lo*minv)*m is divisible by B and less than 2*m*B. */
+        x = (x >> 64) + (((unsigned __int128)(lo * mont->minv) * m) >> 64) + (lo != 0);
+        r[0] = (mp_limb_t)(x >= m ? x - m : x);
+        return;
+    }
+#endif
+    if (a == b)
+        mpn_sqr(t, a, mont->n);
+    else
+        mpn_mul_n(t, a, b, mont->n);
+    _GMPy_Mont_Redc(mont, r, t);
+}
+
+static void
+_GMPy_Mont_Add(const gmpy_mont *mont, mp_ptr r, mp_srcptr a, mp_srcptr b)
+{
+    mp_size_t n = mont->n;
+
+    if (n == 1) {
+        mp_limb_t x = a[0] + b[0], m = mont->m[0];
+
+        r[0] = (x < a[0] || x >= m) ? x - m : x;
+        return;
+    }
+    if (mpn_add_n(r, a, b, n) || mpn_cmp(r, mont->m, n) >= 0)
+        mpn_sub_n(r, r, mont->m, n);
+}
+
+static void
+_GMPy_Mont_Sub(const gmpy_mont *mont, mp_ptr r, mp_srcptr a, mp_srcptr b)
+{
+    if (mont->n == 1) {
+        r[0] = a[0] - b[0] + (a[0] < b[0] ? mont->m[0] : 0);
+        return;
+    }
+    if (mpn_sub_n(r, a, b, mont->n))
+        mpn_add_n(r, r, mont->m, mont->n);
+}
+
+/* Set r to the residue of 1, which is R mod m = r2/R. */
+
+static void
+_GMPy_Mont_One(const gmpy_mont *mont, mp_ptr r, mp_ptr t)
+{
+    mp_size_t i, n = mont->n;
+
+    for (i = 0; i < n; i++) {
+        t[i] = mont->r2[i];
+        t[n + i] = 0;
+    }
+    _GMPy_Mont_Redc(mont, r, t);
+}
+
+/* Set r to the residue of any integer x. */
+
+static void
+_GMPy_Mont_To(const gmpy_mont *mont, mp_ptr r, mpz_srcptr x, mp_ptr t)
+{
+    int mark = _GMPy_Scratch_Mark();
+    mpz_ptr temp = _GMPy_Scratch_Get(mont->n * GMP_NUMB_BITS);
+    mpz_t m;
+    mp_size_t i, size;
+
+    mpz_roinit_n(m, mont->m, mont->n);
+    mpz_mod(temp, x, m);
+    size = mpz_size(temp);
+    for (i = 0; i < size; i++)
+        r[i] = mpz_getlimbn(temp, i);
+    for (; i < mont->n; i++)
+        r[i] = 0;
+    _GMPy_Scratch_Release(mark);
+
+    _GMPy_Mont_Mul(mont, r, r, mont->r2, t);
+}
+
+/* Set z to the integer 0 <= z < m with the residue a. */
+
+static void
+_GMPy_Mont_From(const gmpy_mont *mont, mpz_ptr z, mp_srcptr a, mp_ptr t)
+{
+    mp_size_t i, n = mont->n;
+
+    for (i = 0; i < n; i++) {
+        t[i] = a[i];
+        t[n + i] = 0;
+    }
+    _GMPy_Mont_Redc(mont, mpz_limbs_write(z, n), t);
+    mpz_limbs_finish(z, n);
+}
+
+#ifdef GMPY_MONT_INT128
+
+static void
+_GMPy_U64_Mont_Init(gmpy_u64_mont *m, mp_limb_t n)
+{
+    int s;
+
+    /* Newton iteration for 1/n mod 2**64, as in _GMPy_Mont_Init(). */
+
+    m->n = n;
+    m->minv = n;
+    for (s = 3; s < 64; s *= 2)
+        m->minv *= 2 - n * m->minv;
+    m->minv = 0 - m->minv;
+    m->one = (0 - n) % n;
+    m->r2 = (mp_limb_t)(((unsigned __int128)m->one << 64) % n);
+}
+
+static mp_limb_t
+_GMPy_U64_Mul(const gmpy_u64_mont *m, mp_limb_t a, mp_limb_t b)
+{
+    unsigned __int128 x = (unsigned __int128)a * b;
+    mp_limb_t lo = (mp_limb_t)x;
+
+    x = (x >> 64) + (((unsigned __int128)(lo * m->minv) * m->n) >> 64) + (lo != 0);
+    return (mp_limb_t)(x >= m->n ? x - m->n : x);
+}
+
+static mp_limb_t
+_GMPy_U64_Add(const gmpy_u64_mont *m, mp_limb_t a, mp_limb_t b)
+{
+    mp_limb_t x = a + b;
+
+    return (x < a || x >= m->n) ? x - m->n : x;
+}
+
+static mp_limb_t
+_GMPy_U64_Sub(const gmpy_u64_mont *m, mp_limb_t a, mp_limb_t b)
+{
+    return a - b + (a < b ? m->n : 0);
+}
+
+#endif
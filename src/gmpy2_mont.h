@@ -0,0 +1,104 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mont.h                                                            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY2_MONT_H
+#define GMPY2_MONT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Montgomery arithmetic modulo a fixed odd m > 1 with n limbs.
+ *
+ * A residue x is stored as x*R mod m, where R = B^n, in exactly n limbs.
+ * Every function returns fully reduced residues so two residues can be
+ * compared with mpn_cmp(). The workspace t must have room for 2*n limbs
+ * and must not overlap the other arguments; r may equal a or b. None of
+ * these use the Python API so they may be called without the GIL.
+ *
+ * The reduction is quadratic, so mpz_mod() is used instead for moduli with
+ * more than GMPY_MONT_MAX_LIMBS limbs.
+ */
+
+#define GMPY_MONT_MAX_LIMBS 8
+
+/* Single limb moduli use double-width arithmetic when it is available. */
+
+#if defined(__SIZEOF_INT128__) && GMP_NUMB_BITS == 64 && GMP_NAIL_BITS == 0
+#  define GMPY_MONT_INT128 1
+#endif
+
+#define GMPY_MONT_OK(m) (GMP_NAIL_BITS == 0 && mpz_odd_p(m) && \
+                         mpz_cmp_ui(m, 1) > 0 && \
+                         mpz_size(m) <= GMPY_MONT_MAX_LIMBS)
+
+typedef struct {
+    mp_size_t n;                /* limbs in m */
+    mp_limb_t minv;             /* -1/m mod B */
+    mp_srcptr m;
+    mp_srcptr r2;               /* R^2 mod m */
+} gmpy_mont;
+
+/* The limbs of m and r2 must stay unchanged while mont is used. */
+
+static void _GMPy_Mont_Init(gmpy_mont *mont, mpz_srcptr m, mpz_ptr r2);
+
+static void _GMPy_Mont_Mul(const gmpy_mont *mont, mp_ptr r, mp_srcptr a,
+                           mp_srcptr b, mp_ptr t);
+static void _GMPy_Mont_Add(const gmpy_mont *mont, mp_ptr r, mp_srcptr a,
+                           mp_srcptr b);
+static void _GMPy_Mont_Sub(const gmpy_mont *mont, mp_ptr r, mp_srcptr a,
+                           mp_srcptr b);
+static void _GMPy_Mont_One(const gmpy_mont *mont, mp_ptr r, mp_ptr t);
+static void _GMPy_Mont_To(const gmpy_mont *mont, mp_ptr r, mpz_srcptr x,
+                          mp_ptr t);
+static void _GMPy_Mont_From(const gmpy_mont *mont, mpz_ptr z, mp_srcptr a,
+                            mp_ptr t);
+
+#ifdef GMPY_MONT_INT128
+
+/* Montgomery arithmetic modulo an odd n < 2**64 in one machine word, with
+ * R = 2**64. Used by the word-size primality tests and by RNS.
+ */
+
+typedef struct {
+    mp_limb_t n;
+    mp_limb_t minv;             /* -1/n mod 2**64 */
+    mp_limb_t one;              /* 2**64 mod n, the residue of 1 */
+    mp_limb_t r2;               /* 2**128 mod n */
+} gmpy_u64_mont;
+
+static void      _GMPy_U64_Mont_Init(gmpy_u64_mont *m, mp_limb_t n);
+static mp_limb_t _GMPy_U64_Mul(const gmpy_u64_mont *m, mp_limb_t a, mp_limb_t b);
+static mp_limb_t _GMPy_U64_Add(const gmpy_u64_mont *m, mp_limb_t a, mp_limb_t b);
+static mp_limb_t _GMPy_U64_Sub(const gmpy_u64_mont *m, mp_limb_t a, mp_limb_t b);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif
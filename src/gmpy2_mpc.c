@@ -98,19 +98,19 @@ _GMPy_MPC_Cleanup(MPC_Object **v, CTXT_Object *ctext)
         rcr = MPC_INEX_RE((*v)->rc);
         rci = MPC_INEX_IM((*v)->rc);
         if (MPC_IS_NAN_P(*v)) {
-            ctext->ctx.invalid = 1;
+            GMPY_CTXT_FLAGS(ctext)->invalid = 1;
             _invalid = 1;
         }
         if ((*v)->rc) {
-            ctext->ctx.inexact = 1;
+            GMPY_CTXT_FLAGS(ctext)->inexact = 1;
             _inexact = 1;
         }
         if ((rcr && mpfr_zero_p(mpc_realref((*v)->c))) || (rci && mpfr_zero_p(mpc_imagref((*v)->c)))) {
-            ctext->ctx.underflow = 1;
+            GMPY_CTXT_FLAGS(ctext)->underflow = 1;
             _underflow = 1;
         }
         if ((rcr && mpfr_inf_p(mpc_realref((*v)->c))) || (rci && mpfr_inf_p(mpc_imagref((*v)->c)))) {
-            ctext->ctx.overflow = 1;
+            GMPY_CTXT_FLAGS(ctext)->overflow = 1;
             _overflow = 1;
         }
         if (ctext->ctx.traps) {
@@ -138,6 +138,205 @@ _GMPy_MPC_Cleanup(MPC_Object **v, CTXT_Object *ctext)
     }
 }
 
+/* The fast_float path for mpc. If both parts have a precision of 53 bits
+ * and are rounded to nearest, +, -, and * are done with C doubles. Each part
+ * of the result is then the exact sum of at most four doubles: the operands
+ * for + and -, and the two products and their rounding errors (fma) for *.
+ * The sum is rounded once, and the result is kept only if a bound on the
+ * error of the summation shows that it is the correctly rounded value and
+ * gives its ternary value, so the results are the same as with MPC.
+ *
+ * Parts that are not finite, zero results, and values close to the limits
+ * of the exponent range are left to MPC. Returns 1 if *v holds the result
+ * (or is NULL after a trap).
+ */
+
+/* The bits of an IEEE double. */
+
+#define MPC_FAST_FRAC ((((uint64_t)1) << (DBL_MANT_DIG - 1)) - 1)
+
+static inline uint64_t
+_GMPy_MPC_Fast_Bits(double d)
+{
+    uint64_t u;
+
+    memcpy(&u, &d, sizeof(u));
+    return u;
+}
+
+static inline double
+_GMPy_MPC_Fast_Double(uint64_t u)
+{
+    double d;
+
+    memcpy(&d, &u, sizeof(d));
+    return d;
+}
+
+/* Return the value of a part of an operand in *d, or 0 if the part can't be
+ * used. The products of * must not underflow, so their rounding errors are
+ * exact. The significand of a regular value is copied directly.
+ */
+
+static int
+_GMPy_MPC_Fast_Get(mpfr_srcptr f, int op, double *d)
+{
+    mpfr_exp_t exp;
+
+    if (mpfr_get_prec(f) > DBL_MANT_DIG)
+        return 0;
+    if (mpfr_zero_p(f)) {
+        *d = mpfr_signbit(f) ? -0.0 : 0.0;
+        return 1;
+    }
+    if (!mpfr_regular_p(f))
+        return 0;
+    exp = mpfr_get_exp(f);
+    if (op == GMPY_FAST_MUL ?
+        (exp < DBL_MIN_EXP / 2 + DBL_MANT_DIG || exp > DBL_MAX_EXP / 2) :
+        (exp < DBL_MIN_EXP || exp > DBL_MAX_EXP))
+        return 0;
+#if GMP_NUMB_BITS == 64
+    *d = _GMPy_MPC_Fast_Double(((uint64_t)(mpfr_signbit(f) != 0) << 63) |
+                               ((uint64_t)(exp + DBL_MAX_EXP - 2) << (DBL_MANT_DIG - 1)) |
+                               ((f->_mpfr_d[0] >> (64 - DBL_MANT_DIG)) & MPC_FAST_FRAC));
+#else
+    *d = mpfr_get_d(f, MPFR_RNDN);
+#endif
+    return 1;
+}
+
+/* Set f, which has a precision of 53 bits, to a normal double d. */
+
+static void
+_GMPy_MPC_Fast_Set(mpfr_ptr f, double d)
+{
+#if GMP_NUMB_BITS == 64
+    uint64_t u = _GMPy_MPC_Fast_Bits(d);
+
+    f->_mpfr_sign = (u >> 63) ? -1 : 1;
+    f->_mpfr_exp = (mpfr_exp_t)((u >> (DBL_MANT_DIG - 1)) & 0x7ff) - (DBL_MAX_EXP - 2);
+    f->_mpfr_d[0] = ((u & MPC_FAST_FRAC) | (MPC_FAST_FRAC + 1)) << (64 - DBL_MANT_DIG);
+#else
+    mpfr_set_d(f, d, MPFR_RNDN);
+#endif
+}
+
+/* Round p1 + e1 + p2 + e2 to nearest. Returns 0 if the result can't be
+ * used.
+ */
+
+static int
+_GMPy_MPC_Fast_Sum(double p1, double e1, double p2, double e2, double *r,
+                   int *rc, CTXT_Object *ctext)
+{
+    double s, t, u, v, z, bound, half;
+    uint64_t bits;
+    int exp;
+
+    /* s + t = p1 + p2 exactly (TwoSum). */
+
+    s = p1 + p2;
+    z = s - p1;
+    t = (p1 - (s - z)) + (p2 - z);
+
+    /* u is t + e1 + e2 with an error of at most bound. */
+
+    u = (t + e1) + e2;
+    bound = (e1 == 0 && e2 == 0) ? 0 : (fabs(t) + fabs(e1) + fabs(e2)) * 0x1p-51;
+
+    /* r + v = s + u exactly. */
+
+    *r = s + u;
+    z = *r - s;
+    v = (s - (*r - z)) + (u - z);
+
+    /* exp is the exponent of r in the convention of MPFR. Results that are
+     * zero, not finite, or so small that half an ulp is subnormal are left
+     * to MPC.
+     */
+
+    bits = _GMPy_MPC_Fast_Bits(*r);
+    exp = (int)((bits >> (DBL_MANT_DIG - 1)) & 0x7ff) - (DBL_MAX_EXP - 2);
+    if (exp < DBL_MIN_EXP + 2 * DBL_MANT_DIG || exp > DBL_MAX_EXP ||
+        exp > ctext->ctx.emax || exp < ctext->ctx.emin ||
+        (ctext->ctx.subnormalize && exp <= ctext->ctx.emin + DBL_MANT_DIG - 2))
+        return 0;
+
+    /* If u is exact, r is the rounded sum, also for a tie. Otherwise the
+     * exact sum differs from r by v and at most bound, and r is the rounded
+     * sum if that is less than half the distance to the neighbour of r in
+     * the direction of v, which is closer below a power of 2.
+     */
+
+    if (bound != 0) {
+        half = _GMPy_MPC_Fast_Double((uint64_t)(exp - DBL_MANT_DIG - 2 + DBL_MAX_EXP) << (DBL_MANT_DIG - 1));
+        if (!(bits & MPC_FAST_FRAC) && (v < 0) != (*r < 0))
+            half /= 2;
+        if (fabs(v) <= bound || fabs(v) + bound >= half)
+            return 0;
+    }
+    *rc = (v > 0) ? -1 : (v < 0);
+    return 1;
+}
+
+static int
+_GMPy_MPC_Fast(int op, MPC_Object **v, mpc_srcptr x, mpc_srcptr y,
+               CTXT_Object *ctext)
+{
+    double a, b, c, d, p, q, re, im;
+    int rcr, rci;
+
+    if (!ctext->ctx.fast_float ||
+        GET_REAL_ROUND(ctext) != MPFR_RNDN || GET_IMAG_ROUND(ctext) != MPFR_RNDN ||
+        GET_REAL_PREC(ctext) != DBL_MANT_DIG || GET_IMAG_PREC(ctext) != DBL_MANT_DIG)
+        return 0;
+
+    if (!_GMPy_MPC_Fast_Get(mpc_realref(x), op, &a) ||
+        !_GMPy_MPC_Fast_Get(mpc_imagref(x), op, &b) ||
+        !_GMPy_MPC_Fast_Get(mpc_realref(y), op, &c) ||
+        !_GMPy_MPC_Fast_Get(mpc_imagref(y), op, &d))
+        return 0;
+
+    switch (op) {
+        case GMPY_FAST_SUB:
+            c = -c;
+            d = -d;
+            /* Fall through. */
+        case GMPY_FAST_ADD:
+            if (!_GMPy_MPC_Fast_Sum(a, 0, c, 0, &re, &rcr, ctext) ||
+                !_GMPy_MPC_Fast_Sum(b, 0, d, 0, &im, &rci, ctext))
+                return 0;
+            break;
+        default:
+            /* (a + bi)(c + di) = (ac - bd) + (ad + bc)i */
+            p = a * c;
+            q = b * d;
+            if (!_GMPy_MPC_Fast_Sum(p, fma(a, c, -p), -q, -fma(b, d, -q),
+                                    &re, &rcr, ctext))
+                return 0;
+            p = a * d;
+            q = b * c;
+            if (!_GMPy_MPC_Fast_Sum(p, fma(a, d, -p), q, fma(b, c, -q),
+                                    &im, &rci, ctext))
+                return 0;
+            break;
+    }
+
+    _GMPy_MPC_Fast_Set(mpc_realref((*v)->c), re);
+    _GMPy_MPC_Fast_Set(mpc_imagref((*v)->c), im);
+    (*v)->rc = MPC_INEX(rcr, rci);
+    if ((*v)->rc) {
+        GMPY_CTXT_FLAGS(ctext)->inexact = 1;
+        if (ctext->ctx.traps & TRAP_INEXACT) {
+            GMPY_INEXACT("inexact result");
+            Py_DECREF((PyObject*)(*v));
+            (*v) = NULL;
+        }
+    }
+    return 1;
+}
+
 PyDoc_STRVAR(GMPy_doc_mpc,
 "mpc(c=0, /, precision=0)\n"
 "mpc(c=0, /, precision, context)\n"
@@ -161,6 +360,8 @@ static PyMethodDef Pympc_methods[] =
 {
     { "__complex__", GMPy_PyComplex_From_MPC, METH_NOARGS, GMPy_doc_mpc_complex },
     { "__format__", GMPy_MPC_Format, METH_VARARGS, GMPy_doc_mpc_format },
+    { "__reduce__", GMPy_MPANY_Reduce_Method, METH_NOARGS, GMPy_doc_method_reduce },
+    { "__reduce_ex__", GMPy_MPANY_Reduce_Ex_Method, METH_O, GMPy_doc_method_reduce_ex },
     { "__sizeof__", GMPy_MPC_SizeOf_Method, METH_NOARGS, GMPy_doc_mpc_sizeof_method },
     { "conjugate", GMPy_MPC_Conjugate_Method, METH_NOARGS, GMPy_doc_mpc_conjugate_method },
     { "digits", GMPy_MPC_Digits_Method, METH_VARARGS, GMPy_doc_mpc_digits_method },
@@ -221,47 +422,23 @@ static PyGetSetDef Pympc_getseters[] =
 
 static PyTypeObject MPC_Type =
 {
-    /* PyObject_HEAD_INIT(&PyType_Type) */
     PyVarObject_HEAD_INIT(NULL, 0)
-    "mpc",                                  /* tp_name          */
-    sizeof(MPC_Object),                     /* tp_basicsize     */
-        0,                                  /* tp_itemsize      */
-    /* methods */
-    (destructor) GMPy_MPC_Dealloc,          /* tp_dealloc       */
-        0,                                  /* tp_print         */
-        0,                                  /* tp_getattr       */
-        0,                                  /* tp_setattr       */
-        0,                                  /* tp_reserved      */
-    (reprfunc) GMPy_MPC_Repr_Slot,          /* tp_repr          */
-    &mpc_number_methods,                    /* tp_as_number     */
-        0,                                  /* tp_as_sequence   */
-        0,                                  /* tp_as_mapping    */
-    (hashfunc) GMPy_MPC_Hash_Slot,          /* tp_hash          */
-        0,                                  /* tp_call          */
-    (reprfunc) GMPy_MPC_Str_Slot,           /* tp_str           */
-        0,                                  /* tp_getattro      */
-        0,                                  /* tp_setattro      */
-        0,                                  /* tp_as_buffer     */
-    Py_TPFLAGS_DEFAULT,                     /* tp_flags         */
-    GMPy_doc_mpc,                           /* tp_doc           */
-        0,                                  /* tp_traverse      */
-        0,                                  /* tp_clear         */
-    (richcmpfunc)&GMPy_RichCompare_Slot,    /* tp_richcompare   */
-        0,                                  /* tp_weaklistoffset*/
-        0,                                  /* tp_iter          */
-        0,                                  /* tp_iternext      */
-    Pympc_methods,                          /* tp_methods       */
-        0,                                  /* tp_members       */
-    Pympc_getseters,                        /* tp_getset        */
-        0,                                  /* tp_base          */
-        0,                                  /* tp_dict          */
-        0,                                  /* tp_descr_get     */
-        0,                                  /* tp_descr_set     */
-        0,                                  /* tp_dictoffset    */
-        0,                                  /* tp_init          */
-        0,                                  /* tp_alloc         */
-    GMPy_MPC_NewInit,                       /* tp_new           */
-        0,                                  /* tp_free          */
+    .tp_name = "mpc",
+    .tp_basicsize = sizeof(MPC_Object),
+    .tp_dealloc = (destructor) GMPy_MPC_Dealloc,
+    .tp_repr = (reprfunc) GMPy_MPC_Repr_Slot,
+    .tp_as_number = &mpc_number_methods,
+    .tp_hash = (hashfunc) GMPy_MPC_Hash_Slot,
+    .tp_str = (reprfunc) GMPy_MPC_Str_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_mpc,
+    .tp_richcompare = (richcmpfunc)&GMPy_RichCompare_Slot,
+    .tp_methods = Pympc_methods,
+    .tp_getset = Pympc_getseters,
+    .tp_new = GMPy_MPC_NewInit,
+#ifdef GMPY_TYPE_VECTORCALL
+    .tp_vectorcall = GMPy_MPC_Vectorcall,
+#endif
 };
 
 
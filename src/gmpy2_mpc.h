@@ -145,19 +145,19 @@ static PyTypeObject MPC_Type;
         rcr = MPC_INEX_RE(V->rc); \
         rci = MPC_INEX_IM(V->rc); \
         if (MPC_IS_NAN_P(V)) { \
-            CTX->ctx.invalid = 1; \
+            GMPY_CTXT_FLAGS(CTX)->invalid = 1; \
             _invalid = 1; \
         } \
         if (V->rc) { \
-            CTX->ctx.inexact = 1; \
+            GMPY_CTXT_FLAGS(CTX)->inexact = 1; \
             _inexact = 1; \
         } \
         if ((rcr && mpfr_zero_p(mpc_realref(V->c))) || (rci && mpfr_zero_p(mpc_imagref(V->c)))) { \
-            CTX->ctx.underflow = 1; \
+            GMPY_CTXT_FLAGS(CTX)->underflow = 1; \
             _underflow = 1; \
         } \
         if ((rcr && mpfr_inf_p(mpc_realref(V->c))) || (rci && mpfr_inf_p(mpc_imagref(V->c)))) { \
-            CTX->ctx.overflow = 1; \
+            GMPY_CTXT_FLAGS(CTX)->overflow = 1; \
             _overflow = 1; \
         } \
         if (CTX->ctx.traps) { \
@@ -190,6 +190,8 @@ static PyTypeObject MPC_Type;
     GMPY_MPC_EXCEPTIONS(V, CTX); \
 
 static void _GMPy_MPC_Cleanup(MPC_Object **v, CTXT_Object *ctext);
+static int  _GMPy_MPC_Fast(int op, MPC_Object **v, mpc_srcptr x, mpc_srcptr y,
+                           CTXT_Object *ctext);
 
 #ifdef __cplusplus
 }
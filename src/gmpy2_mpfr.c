@@ -29,70 +29,204 @@
  * to code bloat via macro overuse.
  */
 
-static inline void
-_GMPy_MPFR_Cleanup(MPFR_Object **v, CTXT_Object *ctext)
+/* Apply the exponent range and subnormalization of the context. This does
+ * not use the Python API and can be called with the GIL released.
+ */
+
+static inline int
+_GMPy_MPFR_Range(mpfr_ptr f, int rc, CTXT_Object *ctext, mpfr_rnd_t round)
 {
     /* GMPY_MPFR_CHECK_RANGE(V, CTX) */
-    if (mpfr_regular_p((*v)->f) &&
-        (!(((*v)->f->_mpfr_exp >= ctext->ctx.emin) &&
-           ((*v)->f->_mpfr_exp <= ctext->ctx.emax)))) {
+    if (mpfr_regular_p(f) &&
+        (!((f->_mpfr_exp >= ctext->ctx.emin) &&
+           (f->_mpfr_exp <= ctext->ctx.emax)))) {
         mpfr_exp_t _oldemin, _oldemax;
         _oldemin = mpfr_get_emin();
         _oldemax = mpfr_get_emax();
         mpfr_set_emin(ctext->ctx.emin);
         mpfr_set_emax(ctext->ctx.emax);
-        (*v)->rc = mpfr_check_range((*v)->f, (*v)->rc, GET_MPFR_ROUND(ctext));
+        rc = mpfr_check_range(f, rc, round);
         mpfr_set_emin(_oldemin);
         mpfr_set_emax(_oldemax);
     }
 
     /* GMPY_MPFR_SUBNORMALIZE(V, CTX) */
     if (ctext->ctx.subnormalize &&
-        (*v)->f->_mpfr_exp >= ctext->ctx.emin &&
-        (*v)->f->_mpfr_exp <= ctext->ctx.emin + mpfr_get_prec((*v)->f) - 2) {
+        f->_mpfr_exp >= ctext->ctx.emin &&
+        f->_mpfr_exp <= ctext->ctx.emin + mpfr_get_prec(f) - 2) {
         mpfr_exp_t _oldemin, _oldemax;
         _oldemin = mpfr_get_emin();
         _oldemax = mpfr_get_emax();
         mpfr_set_emin(ctext->ctx.emin);
         mpfr_set_emax(ctext->ctx.emax);
-        (*v)->rc = mpfr_subnormalize((*v)->f, (*v)->rc, GET_MPFR_ROUND(ctext));
+        rc = mpfr_subnormalize(f, rc, round);
         mpfr_set_emin(_oldemin);
         mpfr_set_emax(_oldemax);
     }
+    return rc;
+}
+
+static inline void
+_GMPy_MPFR_Check_Range(MPFR_Object *v, CTXT_Object *ctext, mpfr_rnd_t round)
+{
+    v->rc = _GMPy_MPFR_Range(v->f, v->rc, ctext, round);
+}
+
+/* Copy the MPFR flags to the context and raise an exception if one of them
+ * is trapped. Returns -1 if an exception was raised.
+ */
+
+static inline int
+_GMPy_MPFR_Exceptions(CTXT_Object *ctext)
+{
+    int result = 0;
 
     /* GMPY_MPFR_EXCEPTIONS(V, CTX) */
-    ctext->ctx.underflow |= mpfr_underflow_p();
-    ctext->ctx.overflow |= mpfr_overflow_p();
-    ctext->ctx.invalid |= mpfr_nanflag_p();
-    ctext->ctx.inexact |= mpfr_inexflag_p();
-    ctext->ctx.divzero |= mpfr_divby0_p();
+    if (!ctext->ctx.track_flags && !ctext->ctx.traps)
+        return 0;
+
+    GMPY_CTXT_FLAGS(ctext)->underflow |= mpfr_underflow_p();
+    GMPY_CTXT_FLAGS(ctext)->overflow |= mpfr_overflow_p();
+    GMPY_CTXT_FLAGS(ctext)->invalid |= mpfr_nanflag_p();
+    GMPY_CTXT_FLAGS(ctext)->inexact |= mpfr_inexflag_p();
+    GMPY_CTXT_FLAGS(ctext)->divzero |= mpfr_divby0_p();
     if (ctext->ctx.traps) {
         if ((ctext->ctx.traps & TRAP_UNDERFLOW) && mpfr_underflow_p()) {
             PyErr_SetString(GMPyExc_Underflow, "underflow");
-            Py_XDECREF((PyObject*)(*v));
-            (*v) = NULL;
+            result = -1;
         }
         if ((ctext->ctx.traps & TRAP_OVERFLOW) && mpfr_overflow_p()) {
             PyErr_SetString(GMPyExc_Overflow, "overflow");
-            Py_XDECREF((PyObject*)(*v));
-            (*v) = NULL;
+            result = -1;
         }
         if ((ctext->ctx.traps & TRAP_INEXACT) && mpfr_inexflag_p()) {
             PyErr_SetString(GMPyExc_Inexact, "inexact result");
-            Py_XDECREF((PyObject*)(*v));
-            (*v) = NULL;
+            result = -1;
         }
         if ((ctext->ctx.traps & TRAP_INVALID) && mpfr_nanflag_p()) {
             PyErr_SetString(GMPyExc_Invalid, "invalid operation");
-            Py_XDECREF((PyObject*)(*v));
-            (*v) = NULL;
+            result = -1;
         }
         if ((ctext->ctx.traps & TRAP_DIVZERO) && mpfr_divby0_p()) {
             PyErr_SetString(GMPyExc_DivZero, "division by zero");
-            Py_XDECREF((PyObject*)(*v));
-            (*v) = NULL;
+            result = -1;
         }
     }
+    return result;
+}
+
+static inline void
+_GMPy_MPFR_Cleanup_Round(MPFR_Object **v, CTXT_Object *ctext, mpfr_rnd_t round)
+{
+    _GMPy_MPFR_Check_Range(*v, ctext, round);
+    if (_GMPy_MPFR_Exceptions(ctext) < 0) {
+        Py_XDECREF((PyObject*)(*v));
+        (*v) = NULL;
+    }
+}
+
+/* Use the rounding mode of the context. */
+
+static inline void
+_GMPy_MPFR_Cleanup(MPFR_Object **v, CTXT_Object *ctext)
+{
+    _GMPy_MPFR_Cleanup_Round(v, ctext, GET_MPFR_ROUND(ctext));
+}
+
+/* The fast_float path of the context. For a precision of 53 bits (binary64)
+ * the operation is done with a C double; for 24 bits (binary32) it is done
+ * with a double and rounded once more to a float, which gives the correctly
+ * rounded result for +, -, *, and / since 53 >= 2*24 + 2. The rounding error
+ * of the double operation is recovered exactly (TwoSum or fma), so the
+ * ternary value and the inexact flag are the same as with MPFR.
+ *
+ * Only nonzero finite operands that fit in the context precision and
+ * results that are normal in both the hardware format and the exponent
+ * range of the context are handled; everything else returns 0 and is left
+ * to MPFR. Returns 1 if *v holds the result (or is NULL after a trap).
+ */
+
+static int
+_GMPy_MPFR_Fast(int op, MPFR_Object **v, mpfr_srcptr x, mpfr_srcptr y,
+                CTXT_Object *ctext)
+{
+    mpfr_prec_t prec = ctext->ctx.mpfr_prec;
+    double a, b, r, err;
+    int rc, exp;
+
+    if (!ctext->ctx.fast_float || ctext->ctx.mpfr_round != MPFR_RNDN ||
+        (prec != DBL_MANT_DIG && prec != FLT_MANT_DIG))
+        return 0;
+
+    if (!mpfr_regular_p(x) || !mpfr_regular_p(y) ||
+        mpfr_get_prec(x) > prec || mpfr_get_prec(y) > prec ||
+        mpfr_get_exp(x) < DBL_MIN_EXP || mpfr_get_exp(x) > DBL_MAX_EXP ||
+        mpfr_get_exp(y) < DBL_MIN_EXP || mpfr_get_exp(y) > DBL_MAX_EXP)
+        return 0;
+
+    a = mpfr_get_d(x, MPFR_RNDN);
+    b = mpfr_get_d(y, MPFR_RNDN);
+
+    /* err is the exact result minus r. */
+
+    switch (op) {
+        case GMPY_FAST_SUB:
+            b = -b;
+            /* Fall through. */
+        case GMPY_FAST_ADD:
+            r = a + b;
+            err = r - a;
+            err = (a - (r - err)) + (b - err);
+            break;
+        case GMPY_FAST_MUL:
+            r = a * b;
+            err = fma(a, b, -r);
+            break;
+        default:
+            r = a / b;
+            err = fma(-r, b, a);
+            if (b < 0)
+                err = -err;
+            break;
+    }
+
+    /* Leave results that are close to the bottom of the double range to
+     * MPFR, so err is never rounded.
+     */
+
+    if (r == 0 || !isfinite(r))
+        return 0;
+    (void)frexp(r, &exp);
+    if (exp < DBL_MIN_EXP + DBL_MANT_DIG)
+        return 0;
+    rc = (err > 0) ? -1 : (err < 0);
+
+    if (prec == FLT_MANT_DIG) {
+        float f = (float)r;
+
+        if (!isfinite(f) || fabs(r) < FLT_MIN)
+            return 0;
+        if ((double)f != r) {
+            rc = ((double)f > r) ? 1 : -1;
+            r = (double)f;
+            (void)frexp(r, &exp);
+        }
+    }
+
+    if (exp > ctext->ctx.emax || exp < ctext->ctx.emin ||
+        (ctext->ctx.subnormalize && exp <= ctext->ctx.emin + prec - 2))
+        return 0;
+
+    mpfr_set_d((*v)->f, r, MPFR_RNDN);
+    (*v)->rc = rc;
+    mpfr_clear_flags();
+    if (rc)
+        mpfr_set_inexflag();
+    if (_GMPy_MPFR_Exceptions(ctext) < 0) {
+        Py_DECREF((PyObject*)(*v));
+        (*v) = NULL;
+    }
+    return 1;
 }
 
 PyDoc_STRVAR(GMPy_doc_mpfr,
@@ -155,6 +289,8 @@ static PyMethodDef Pympfr_methods [] =
     { "__ceil__", GMPy_MPFR_Method_Ceil, METH_NOARGS, GMPy_doc_mpfr_ceil_method },
     { "__floor__", GMPy_MPFR_Method_Floor, METH_NOARGS, GMPy_doc_mpfr_floor_method },
     { "__format__", GMPy_MPFR_Format, METH_VARARGS, GMPy_doc_mpfr_format },
+    { "__reduce__", GMPy_MPANY_Reduce_Method, METH_NOARGS, GMPy_doc_method_reduce },
+    { "__reduce_ex__", GMPy_MPANY_Reduce_Ex_Method, METH_O, GMPy_doc_method_reduce_ex },
     { "__round__", GMPy_MPFR_Method_Round10, METH_VARARGS, GMPy_doc_method_round10 },
     { "__sizeof__", GMPy_MPFR_SizeOf_Method, METH_NOARGS, GMPy_doc_mpfr_sizeof_method },
     { "__trunc__", GMPy_MPFR_Method_Trunc, METH_NOARGS, GMPy_doc_mpfr_trunc_method },
@@ -189,4 +325,7 @@ static PyTypeObject MPFR_Type =
     .tp_methods = Pympfr_methods,
     .tp_getset = Pympfr_getseters,
     .tp_new = GMPy_MPFR_NewInit,
+#ifdef GMPY_TYPE_VECTORCALL
+    .tp_vectorcall = GMPy_MPFR_Vectorcall,
+#endif
 };
@@ -145,11 +145,13 @@ static PyTypeObject MPFR_Type;
  */
 
 #define GMPY_MPFR_EXCEPTIONS(V, CTX) \
-    CTX->ctx.underflow |= mpfr_underflow_p(); \
-    CTX->ctx.overflow |= mpfr_overflow_p(); \
-    CTX->ctx.invalid |= mpfr_nanflag_p(); \
-    CTX->ctx.inexact |= mpfr_inexflag_p(); \
-    CTX->ctx.divzero |= mpfr_divby0_p(); \
+    if (CTX->ctx.track_flags || CTX->ctx.traps) { \
+        GMPY_CTXT_FLAGS(CTX)->underflow |= mpfr_underflow_p(); \
+        GMPY_CTXT_FLAGS(CTX)->overflow |= mpfr_overflow_p(); \
+        GMPY_CTXT_FLAGS(CTX)->invalid |= mpfr_nanflag_p(); \
+        GMPY_CTXT_FLAGS(CTX)->inexact |= mpfr_inexflag_p(); \
+        GMPY_CTXT_FLAGS(CTX)->divzero |= mpfr_divby0_p(); \
+    } \
     if (CTX->ctx.traps) { \
         if ((CTX->ctx.traps & TRAP_UNDERFLOW) && mpfr_underflow_p()) { \
             GMPY_UNDERFLOW("underflow"); \
@@ -184,7 +186,7 @@ static PyTypeObject MPFR_Type;
     GMPY_MPFR_EXCEPTIONS(V, CTX);
 
 #define GMPY_CHECK_ERANGE(V, CTX, MSG) \
-    CTX->ctx.erange |= mpfr_erangeflag_p(); \
+    GMPY_CTXT_FLAGS(CTX)->erange |= mpfr_erangeflag_p(); \
     if (CTX->ctx.traps) { \
         if ((CTX->ctx.traps & TRAP_ERANGE) && mpfr_erangeflag_p()) { \
             GMPY_ERANGE(MSG); \
@@ -193,7 +195,20 @@ static PyTypeObject MPFR_Type;
         } \
     } \
 
+/* Operations supported by _GMPy_MPFR_Fast(). */
+
+#define GMPY_FAST_ADD 0
+#define GMPY_FAST_SUB 1
+#define GMPY_FAST_MUL 2
+#define GMPY_FAST_DIV 3
+
+static int  _GMPy_MPFR_Range(mpfr_ptr f, int rc, CTXT_Object *ctext, mpfr_rnd_t round);
+static void _GMPy_MPFR_Check_Range(MPFR_Object *v, CTXT_Object *ctext, mpfr_rnd_t round);
+static int  _GMPy_MPFR_Exceptions(CTXT_Object *ctext);
 static void _GMPy_MPFR_Cleanup(MPFR_Object **v, CTXT_Object *ctext);
+static void _GMPy_MPFR_Cleanup_Round(MPFR_Object **v, CTXT_Object *ctext, mpfr_rnd_t round);
+static int  _GMPy_MPFR_Fast(int op, MPFR_Object **v, mpfr_srcptr x, mpfr_srcptr y,
+                            CTXT_Object *ctext);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,1073 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mpfr_array.c                                                      *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array,
+"mpfr_array(n=0, /, precision=0) -> mpfr_array\n"
+"mpfr_array(iterable, /, precision=0) -> mpfr_array\n\n"
+"Return a fixed-length array of real numbers that all have the same\n"
+"precision. With an integer argument the array has n elements that are\n"
+"all 0. Otherwise the array is initialized from the real numbers in\n"
+"iterable, rounded with the rounding mode of the current context. If\n"
+"precision is 0, the precision of the current context is used. The\n"
+"significands of all elements are stored in one block of memory;\n"
+"indexing returns a new mpfr and slicing returns a new mpfr_array.");
+
+PyDoc_STRVAR(GMPy_doc_mpc_array,
+"mpc_array(n=0, /, precision=0) -> mpc_array\n"
+"mpc_array(iterable, /, precision=0) -> mpc_array\n\n"
+"Return a fixed-length array of complex numbers. The real and imaginary\n"
+"parts of all elements have the same precision. With an integer\n"
+"argument the array has n elements that are all 0. Otherwise the array\n"
+"is initialized from the complex numbers in iterable, rounded with the\n"
+"rounding modes of the current context. If precision is 0, the real\n"
+"precision of the current context is used. Indexing returns a new mpc\n"
+"and slicing returns a new mpc_array.");
+
+#define MPFR_ARRAY_PARTS(v) (MPC_Array_Check(v) ? 2 : 1)
+#define MPFR_ARRAY_NAME(v) (MPC_Array_Check(v) ? "mpc_array" : "mpfr_array")
+
+static void
+_GMPy_MPC_Array_Load(mpc_ptr c, MPFR_Array_Object *a, Py_ssize_t i)
+{
+    *mpc_realref(c) = *a->f[2 * i];
+    *mpc_imagref(c) = *a->f[2 * i + 1];
+}
+
+static void
+_GMPy_MPC_Array_Store(MPFR_Array_Object *a, Py_ssize_t i, mpc_srcptr c)
+{
+    *a->f[2 * i] = *mpc_realref(c);
+    *a->f[2 * i + 1] = *mpc_imagref(c);
+}
+
+/* Create an array whose significands are stored in limbs, or in a new block
+ * of memory if limbs is NULL.
+ */
+
+static MPFR_Array_Object *
+_GMPy_MPFR_Array_Create(PyTypeObject *type, Py_ssize_t size, mpfr_prec_t prec,
+                        mp_limb_t *limbs)
+{
+    MPFR_Array_Object *result;
+    size_t count, nlimbs, i;
+
+    if (!(result = PyObject_New(MPFR_Array_Object, type)))
+        return NULL;
+    result->size = 0;
+    result->prec = prec;
+    result->f = NULL;
+    result->limbs = NULL;
+    result->readonly = 0;
+    result->source = NULL;
+
+    count = (size_t)size * (type == &MPC_Array_Type ? 2 : 1);
+    nlimbs = mpfr_custom_get_size(prec) / sizeof(mp_limb_t);
+
+    if (count > (size_t)PY_SSIZE_T_MAX / sizeof(mp_limb_t) / nlimbs ||
+        !(result->f = PyMem_New(mpfr_t, count ? count : 1))) {
+        Py_DECREF((PyObject*)result);
+        return (MPFR_Array_Object*)PyErr_NoMemory();
+    }
+    if (limbs) {
+        result->limbs = limbs;
+    }
+    else if (!(result->limbs = PyMem_Calloc(count ? count * nlimbs : 1, sizeof(mp_limb_t)))) {
+        Py_DECREF((PyObject*)result);
+        return (MPFR_Array_Object*)PyErr_NoMemory();
+    }
+    for (i = 0; i < count; i++)
+        mpfr_custom_init_set(result->f[i], MPFR_ZERO_KIND, 0, prec,
+                             result->limbs + i * nlimbs);
+    result->size = size;
+    return result;
+}
+
+static MPFR_Array_Object *
+GMPy_MPFR_Array_New(PyTypeObject *type, Py_ssize_t size, mpfr_prec_t prec)
+{
+    return _GMPy_MPFR_Array_Create(type, size, prec, NULL);
+}
+
+static void
+GMPy_MPFR_Array_Dealloc(MPFR_Array_Object *self)
+{
+    PyMem_Free(self->f);
+    if (self->source) {
+        PyBuffer_Release(&self->view);
+        Py_DECREF(self->source);
+    }
+    else {
+        PyMem_Free(self->limbs);
+    }
+    PyObject_Free(self);
+}
+
+/* Store the number obj in element i, rounded once to the precision of the
+ * array. Returns -1 and sets an exception if obj is not a real (or complex)
+ * number.
+ */
+
+static int
+_GMPy_MPFR_Array_Set(MPFR_Array_Object *self, Py_ssize_t i, PyObject *obj,
+                     CTXT_Object *context)
+{
+    if (MPC_Array_Check(self)) {
+        MPC_Object *temp;
+        mpc_t c;
+        int rc;
+
+        if (!IS_COMPLEX(obj)) {
+            TYPE_ERROR("mpc_array elements must be complex numbers");
+            return -1;
+        }
+        if (!(temp = GMPy_MPC_From_Complex(obj, self->prec, self->prec, context)))
+            return -1;
+        _GMPy_MPC_Array_Load(c, self, i);
+        rc = mpc_set(c, temp->c, GET_MPC_ROUND(context));
+        _GMPy_MPFR_Range(mpc_realref(c), MPC_INEX_RE(rc), context, GET_REAL_ROUND(context));
+        _GMPy_MPFR_Range(mpc_imagref(c), MPC_INEX_IM(rc), context, GET_IMAG_ROUND(context));
+        _GMPy_MPC_Array_Store(self, i, c);
+        Py_DECREF((PyObject*)temp);
+    }
+    else {
+        MPFR_Object *temp;
+        mpfr_rnd_t round = GET_MPFR_ROUND(context);
+
+        if (MPFR_Check(obj)) {
+            Py_INCREF(obj);
+            temp = (MPFR_Object*)obj;
+        }
+        else if (!IS_REAL(obj)) {
+            TYPE_ERROR("mpfr_array elements must be real numbers");
+            return -1;
+        }
+        else if (!(temp = GMPy_MPFR_From_Real(obj, self->prec, context))) {
+            return -1;
+        }
+        _GMPy_MPFR_Range(self->f[i], mpfr_set(self->f[i], temp->f, round),
+                         context, round);
+        Py_DECREF((PyObject*)temp);
+    }
+    return 0;
+}
+
+static MPFR_Array_Object *
+_GMPy_MPFR_Array_From_Iterable(PyTypeObject *type, PyObject *obj,
+                               mpfr_prec_t prec, CTXT_Object *context)
+{
+    MPFR_Array_Object *result;
+    PyObject *seq, **items;
+    Py_ssize_t i, n;
+
+    /* Arrays of the same type are copied without creating elements. */
+
+    if (Py_TYPE(obj) == type) {
+        MPFR_Array_Object *src = (MPFR_Array_Object*)obj;
+        Py_ssize_t parts = MPFR_ARRAY_PARTS(src);
+        mpfr_rnd_t round = GET_MPFR_ROUND(context);
+
+        if (!(result = GMPy_MPFR_Array_New(type, src->size, prec)))
+            return NULL;
+        for (i = 0; i < parts * src->size; i++) {
+            if (parts == 2)
+                round = (i & 1) ? GET_IMAG_ROUND(context) : GET_REAL_ROUND(context);
+            _GMPy_MPFR_Range(result->f[i], mpfr_set(result->f[i], src->f[i], round),
+                             context, round);
+        }
+        return result;
+    }
+
+    if (!(seq = PySequence_Fast(obj, type == &MPC_Array_Type ?
+                                     "mpc_array() requires an integer or an iterable" :
+                                     "mpfr_array() requires an integer or an iterable")))
+        return NULL;
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    items = PySequence_Fast_ITEMS(seq);
+
+    if ((result = GMPy_MPFR_Array_New(type, n, prec))) {
+        for (i = 0; i < n; i++) {
+            if (_GMPy_MPFR_Array_Set(result, i, items[i], context) < 0) {
+                Py_CLEAR(result);
+                break;
+            }
+        }
+    }
+    Py_DECREF(seq);
+    return result;
+}
+
+static PyObject *
+GMPy_MPFR_Array_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "precision", NULL};
+    PyObject *arg = NULL;
+    Py_ssize_t n, prec = 0;
+    CTXT_Object *context = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds,
+                                     type == &MPC_Array_Type ? "|On:mpc_array" : "|On:mpfr_array",
+                                     kwlist, &arg, &prec))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (prec == 0) {
+        prec = type == &MPC_Array_Type ? GET_REAL_PREC(context) : GET_MPFR_PREC(context);
+    }
+    else if (prec < MPFR_PREC_MIN || prec > MPFR_PREC_MAX) {
+        VALUE_ERROR("invalid value for precision");
+        return NULL;
+    }
+
+    if (!arg)
+        return (PyObject*)GMPy_MPFR_Array_New(type, 0, (mpfr_prec_t)prec);
+
+    if (PyIndex_Check(arg)) {
+        n = PyNumber_AsSsize_t(arg, PyExc_OverflowError);
+        if (n == -1 && PyErr_Occurred())
+            return NULL;
+        if (n < 0) {
+            PyErr_Format(PyExc_ValueError, "%s() size must be >= 0",
+                         type == &MPC_Array_Type ? "mpc_array" : "mpfr_array");
+            return NULL;
+        }
+        return (PyObject*)GMPy_MPFR_Array_New(type, n, (mpfr_prec_t)prec);
+    }
+
+    return (PyObject*)_GMPy_MPFR_Array_From_Iterable(type, arg, (mpfr_prec_t)prec, context);
+}
+
+static Py_ssize_t
+GMPy_MPFR_Array_Length(MPFR_Array_Object *self)
+{
+    return self->size;
+}
+
+static PyObject *
+GMPy_MPFR_Array_Item(MPFR_Array_Object *self, Py_ssize_t i)
+{
+    CTXT_Object *context = NULL;
+
+    if (i < 0 || i >= self->size) {
+        PyErr_Format(PyExc_IndexError, "%s index out of range", MPFR_ARRAY_NAME(self));
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (MPC_Array_Check(self)) {
+        MPC_Object *result;
+        mpc_t c;
+
+        if ((result = GMPy_MPC_New(self->prec, self->prec, context))) {
+            _GMPy_MPC_Array_Load(c, self, i);
+            mpc_set(result->c, c, MPC_RNDNN);
+        }
+        return (PyObject*)result;
+    }
+    else {
+        MPFR_Object *result;
+
+        if ((result = GMPy_MPFR_New(self->prec, context)))
+            mpfr_set(result->f, self->f[i], MPFR_RNDN);
+        return (PyObject*)result;
+    }
+}
+
+static PyObject *
+GMPy_MPFR_Array_SubScript(MPFR_Array_Object *self, PyObject *item)
+{
+    if (PyIndex_Check(item)) {
+        Py_ssize_t i;
+
+        i = PyNumber_AsSsize_t(item, PyExc_IndexError);
+        if (i == -1 && PyErr_Occurred())
+            return NULL;
+        if (i < 0)
+            i += self->size;
+        return GMPy_MPFR_Array_Item(self, i);
+    }
+    else if (PySlice_Check(item)) {
+        Py_ssize_t start, stop, step, slicelength, cur, i, j;
+        Py_ssize_t parts = MPFR_ARRAY_PARTS(self);
+        MPFR_Array_Object *result;
+
+        if (PySlice_Unpack(item, &start, &stop, &step) < 0)
+            return NULL;
+        slicelength = PySlice_AdjustIndices(self->size, &start, &stop, step);
+
+        if (!(result = GMPy_MPFR_Array_New(Py_TYPE(self), slicelength, self->prec)))
+            return NULL;
+        for (cur = start, i = 0; i < slicelength; cur += step, i++) {
+            for (j = 0; j < parts; j++)
+                mpfr_set(result->f[i * parts + j], self->f[cur * parts + j], MPFR_RNDN);
+        }
+        return (PyObject*)result;
+    }
+    else {
+        PyErr_Format(PyExc_TypeError, "%s indices must be integers or slices",
+                     MPFR_ARRAY_NAME(self));
+        return NULL;
+    }
+}
+
+static int
+GMPy_MPFR_Array_AssignSubScript(MPFR_Array_Object *self, PyObject *item,
+                                PyObject *value)
+{
+    CTXT_Object *context = NULL;
+
+    if (!value) {
+        PyErr_Format(PyExc_TypeError, "%s does not support item deletion",
+                     MPFR_ARRAY_NAME(self));
+        return -1;
+    }
+
+    if (self->readonly) {
+        PyErr_Format(PyExc_TypeError, "%s is read-only; use copy()",
+                     MPFR_ARRAY_NAME(self));
+        return -1;
+    }
+
+    CHECK_CONTEXT_M1(context);
+
+    if (PyIndex_Check(item)) {
+        Py_ssize_t i;
+
+        i = PyNumber_AsSsize_t(item, PyExc_IndexError);
+        if (i == -1 && PyErr_Occurred())
+            return -1;
+        if (i < 0)
+            i += self->size;
+        if (i < 0 || i >= self->size) {
+            PyErr_Format(PyExc_IndexError, "%s assignment index out of range",
+                         MPFR_ARRAY_NAME(self));
+            return -1;
+        }
+        return _GMPy_MPFR_Array_Set(self, i, value, context);
+    }
+    else if (PySlice_Check(item)) {
+        Py_ssize_t start, stop, step, slicelength, cur, i, j;
+        Py_ssize_t parts = MPFR_ARRAY_PARTS(self);
+        MPFR_Array_Object *temp;
+        int res = 0;
+
+        if (PySlice_Unpack(item, &start, &stop, &step) < 0)
+            return -1;
+        slicelength = PySlice_AdjustIndices(self->size, &start, &stop, step);
+
+        /* Convert all values first so a failed assignment leaves the array
+         * unchanged. The values are copied; swapping them would exchange
+         * the significands of the two arrays.
+         */
+
+        if (!(temp = _GMPy_MPFR_Array_From_Iterable(Py_TYPE(self), value,
+                                                    self->prec, context)))
+            return -1;
+
+        if (temp->size != slicelength) {
+            PyErr_Format(PyExc_ValueError, "%s slice assignment cannot change the size",
+                         MPFR_ARRAY_NAME(self));
+            res = -1;
+        }
+        else {
+            for (cur = start, i = 0; i < slicelength; cur += step, i++) {
+                for (j = 0; j < parts; j++)
+                    mpfr_set(self->f[cur * parts + j], temp->f[i * parts + j], MPFR_RNDN);
+            }
+        }
+        Py_DECREF((PyObject*)temp);
+        return res;
+    }
+    else {
+        PyErr_Format(PyExc_TypeError, "%s indices must be integers or slices",
+                     MPFR_ARRAY_NAME(self));
+        return -1;
+    }
+}
+
+static PyObject *
+GMPy_MPFR_Array_Repr_Slot(MPFR_Array_Object *self)
+{
+    PyObject *list, *sep, *body, *result = NULL, *temp, *str;
+    Py_ssize_t i;
+
+    if (!(list = PyList_New(self->size)))
+        return NULL;
+
+    for (i = 0; i < self->size; i++) {
+        if (!(temp = GMPy_MPFR_Array_Item(self, i))) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        str = PyObject_Str(temp);
+        Py_DECREF(temp);
+        if (!str) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, str);
+    }
+
+    if ((sep = PyUnicode_FromString(", "))) {
+        if ((body = PyUnicode_Join(sep, list))) {
+            result = PyUnicode_FromFormat("%s([%U], precision=%ld)",
+                                          MPFR_ARRAY_NAME(self), body,
+                                          (long)self->prec);
+            Py_DECREF(body);
+        }
+        Py_DECREF(sep);
+    }
+    Py_DECREF(list);
+    return result;
+}
+
+/* Two arrays are equal if they have the same length and equal elements; the
+ * precision is not compared. As for mpfr, NaN is not equal to anything.
+ */
+
+static PyObject *
+GMPy_MPFR_Array_RichCompare_Slot(PyObject *a, PyObject *b, int op)
+{
+    MPFR_Array_Object *x = (MPFR_Array_Object*)a, *y = (MPFR_Array_Object*)b;
+    Py_ssize_t i;
+    int equal;
+
+    if (Py_TYPE(a) != Py_TYPE(b) || (op != Py_EQ && op != Py_NE))
+        Py_RETURN_NOTIMPLEMENTED;
+
+    equal = (x->size == y->size);
+    for (i = 0; equal && i < MPFR_ARRAY_PARTS(x) * x->size; i++)
+        equal = mpfr_equal_p(x->f[i], y->f[i]);
+
+    if ((op == Py_EQ) == equal)
+        Py_RETURN_TRUE;
+    Py_RETURN_FALSE;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_precision,
+"The precision in bits of every element.");
+
+static PyObject *
+GMPy_MPFR_Array_GetPrec_Attrib(MPFR_Array_Object *self, void *closure)
+{
+    return PyLong_FromLong((long)self->prec);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_readonly,
+"True if the array was created by from_buffer() and cannot be changed.");
+
+static PyObject *
+GMPy_MPFR_Array_GetReadonly_Attrib(MPFR_Array_Object *self, void *closure)
+{
+    return PyBool_FromLong(self->readonly);
+}
+
+/* Format of the binary representation of an mpfr_array or mpc_array. All
+ * integers are stored in little-endian order and every section starts at
+ * a multiple of 8 bytes.
+ *
+ * byte[0]:      8 => mpfr_array
+ *               9 => mpc_array
+ * byte[1:8]:    0 (reserved)
+ * byte[8:16]:   precision
+ * byte[16:24]:  number of elements, n
+ *
+ * An mpc_array stores 2*n values, the real and imaginary part of each
+ * element; an mpfr_array stores n values. For m values:
+ *
+ * m kind bytes: 0 => zero, 1 => regular, 2 => infinity, 3 => NaN, with
+ *               0x80 added if the sign bit is set; padded with 0 to a
+ *               multiple of 8 bytes
+ * m exponents:  8 bytes each, two's complement; 0 unless regular
+ * significands: (precision + 63) / 64 limbs of 64 bits per value, least
+ *               significant limb first, as MPFR stores them
+ *
+ * With 64-bit limbs on a little-endian platform the significands are the
+ * same bytes as the block of limbs of the array and are copied with one
+ * memcpy() in either direction.
+ */
+
+#if GMP_NUMB_BITS == 64 && !PY_BIG_ENDIAN
+#  define GMPY_ARRAY_LIMBS_NATIVE 1
+#else
+#  define GMPY_ARRAY_LIMBS_NATIVE 0
+#endif
+
+static void
+_GMPy_MPFR_Array_Put_U64(unsigned char *buffer, uint64_t value)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        buffer[i] = (unsigned char)(value & 0xff);
+        value >>= 8;
+    }
+}
+
+static uint64_t
+_GMPy_MPFR_Array_Get_U64(const unsigned char *buffer)
+{
+    uint64_t value = 0;
+    int i;
+
+    for (i = 8; i > 0; i--)
+        value = (value << 8) | buffer[i - 1];
+    return value;
+}
+
+#if !GMPY_ARRAY_LIMBS_NATIVE
+
+/* Copy the limbs of one significand to or from words 64-bit limbs. With
+ * 32-bit limbs an odd number of them is padded with 32 zero bits at the
+ * least significant end, so the value stays aligned with the top.
+ */
+
+static void
+_GMPy_MPFR_Array_Put_Limbs(unsigned char *buffer, const mp_limb_t *limbs,
+                           size_t nlimbs, size_t words)
+{
+    size_t pad = 8 * words - nlimbs * sizeof(mp_limb_t), i, k;
+    mp_limb_t limb;
+
+    memset(buffer, 0, pad);
+    buffer += pad;
+    for (i = 0; i < nlimbs; i++) {
+        limb = limbs[i];
+        for (k = 0; k < sizeof(mp_limb_t); k++) {
+            *buffer++ = (unsigned char)(limb & 0xff);
+            limb >>= 8;
+        }
+    }
+}
+
+static void
+_GMPy_MPFR_Array_Get_Limbs(mp_limb_t *limbs, const unsigned char *buffer,
+                           size_t nlimbs, size_t words)
+{
+    size_t i, k;
+    mp_limb_t limb;
+
+    buffer += 8 * words - nlimbs * sizeof(mp_limb_t);
+    for (i = 0; i < nlimbs; i++) {
+        limb = 0;
+        for (k = sizeof(mp_limb_t); k > 0; k--)
+            limb = (limb << 8) | buffer[k - 1];
+        limbs[i] = limb;
+        buffer += sizeof(mp_limb_t);
+    }
+}
+
+#endif
+
+#define GMPY_ARRAY_HEADER 24
+
+static PyObject *
+GMPy_MPFR_Array_To_Binary(MPFR_Array_Object *self)
+{
+    size_t count, kinds, words, size, i;
+    unsigned char *buffer;
+    PyObject *result;
+
+    count = (size_t)self->size * MPFR_ARRAY_PARTS(self);
+    kinds = (count + 7) & ~(size_t)7;
+    words = ((size_t)self->prec + 63) / 64;
+
+    if (count && words + 1 > ((size_t)PY_SSIZE_T_MAX - GMPY_ARRAY_HEADER - kinds) / 8 / count) {
+        OVERFLOW_ERROR("array too large for to_binary()");
+        return NULL;
+    }
+    size = GMPY_ARRAY_HEADER + kinds + 8 * count * (words + 1);
+
+    if (!(result = PyBytes_FromStringAndSize(NULL, size)))
+        return NULL;
+    buffer = (unsigned char*)PyBytes_AS_STRING(result);
+
+    memset(buffer, 0, GMPY_ARRAY_HEADER + kinds);
+    buffer[0] = MPC_Array_Check(self) ? 0x09 : 0x08;
+    _GMPy_MPFR_Array_Put_U64(buffer + 8, (uint64_t)self->prec);
+    _GMPy_MPFR_Array_Put_U64(buffer + 16, (uint64_t)self->size);
+    buffer += GMPY_ARRAY_HEADER;
+
+    for (i = 0; i < count; i++) {
+        mpfr_srcptr f = self->f[i];
+        int64_t exp = 0;
+
+        if (mpfr_regular_p(f)) {
+            buffer[i] = 1;
+            exp = (int64_t)mpfr_get_exp(f);
+        }
+        else if (mpfr_inf_p(f)) {
+            buffer[i] = 2;
+        }
+        else if (mpfr_nan_p(f)) {
+            buffer[i] = 3;
+        }
+        if (mpfr_signbit(f))
+            buffer[i] |= 0x80;
+        _GMPy_MPFR_Array_Put_U64(buffer + kinds + 8 * i, (uint64_t)exp);
+    }
+    buffer += kinds + 8 * count;
+
+#if GMPY_ARRAY_LIMBS_NATIVE
+    memcpy(buffer, self->limbs, 8 * count * words);
+#else
+    {
+        size_t nlimbs = mpfr_custom_get_size(self->prec) / sizeof(mp_limb_t);
+
+        for (i = 0; i < count; i++)
+            _GMPy_MPFR_Array_Put_Limbs(buffer + 8 * words * i, self->limbs + nlimbs * i,
+                                       nlimbs, words);
+    }
+#endif
+    return result;
+}
+
+/* Decode the binary format. If view is not NULL and the limbs in the buffer
+ * can be used in place, the result is a read-only array that takes over
+ * view and a reference to its exporter; otherwise the limbs are copied and
+ * the caller releases view.
+ */
+
+static MPFR_Array_Object *
+_GMPy_MPFR_Array_Decode(unsigned char *buffer, Py_ssize_t len, Py_buffer *view)
+{
+    static const int kind_map[4] = {MPFR_ZERO_KIND, MPFR_REGULAR_KIND,
+                                    MPFR_INF_KIND, MPFR_NAN_KIND};
+    PyTypeObject *type = buffer[0] == 0x09 ? &MPC_Array_Type : &MPFR_Array_Type;
+    MPFR_Array_Object *result;
+    size_t parts = buffer[0] == 0x09 ? 2 : 1, count, kinds, words, nlimbs, unused, i;
+    uint64_t prec, size;
+    unsigned char *kp, *ep;
+    mp_limb_t *sig, *limbs = NULL;
+
+    if ((size_t)len < GMPY_ARRAY_HEADER)
+        goto short_error;
+
+    prec = _GMPy_MPFR_Array_Get_U64(buffer + 8);
+    size = _GMPy_MPFR_Array_Get_U64(buffer + 16);
+    if (prec < MPFR_PREC_MIN || prec > MPFR_PREC_MAX) {
+        VALUE_ERROR("invalid precision in from_binary()");
+        return NULL;
+    }
+    words = ((size_t)prec + 63) / 64;
+
+    /* Every value needs at least 9 + 8*words bytes. */
+    if (size > ((size_t)len - GMPY_ARRAY_HEADER) / parts / (9 + 8 * words))
+        goto short_error;
+    count = (size_t)size * parts;
+    kinds = (count + 7) & ~(size_t)7;
+    if ((size_t)len - GMPY_ARRAY_HEADER < kinds + 8 * count * (words + 1))
+        goto short_error;
+
+    kp = buffer + GMPY_ARRAY_HEADER;
+    ep = kp + kinds;
+    nlimbs = mpfr_custom_get_size((mpfr_prec_t)prec) / sizeof(mp_limb_t);
+    unused = nlimbs * GMP_NUMB_BITS - (size_t)prec;
+
+#if GMPY_ARRAY_LIMBS_NATIVE
+    if (view && (uintptr_t)(ep + 8 * count) % sizeof(mp_limb_t) == 0)
+        limbs = (mp_limb_t*)(ep + 8 * count);
+#endif
+
+    if (!(result = _GMPy_MPFR_Array_Create(type, (Py_ssize_t)size,
+                                           (mpfr_prec_t)prec, limbs)))
+        return NULL;
+
+    if (!limbs) {
+#if GMPY_ARRAY_LIMBS_NATIVE
+        memcpy(result->limbs, ep + 8 * count, 8 * count * words);
+#else
+        for (i = 0; i < count; i++)
+            _GMPy_MPFR_Array_Get_Limbs(result->limbs + nlimbs * i,
+                                       ep + 8 * count + 8 * words * i, nlimbs, words);
+#endif
+    }
+
+    /* Check every value before it is used by MPFR: a regular value needs a
+     * normalized significand and an exponent in the range of MPFR, and the
+     * bits below the precision must be 0. They are cleared in a copy but
+     * not in a buffer that is used in place.
+     */
+
+    for (i = 0; i < count; i++) {
+        int kind = kp[i] & 0x7f;
+        int64_t exp = (int64_t)_GMPy_MPFR_Array_Get_U64(ep + 8 * i);
+
+        sig = result->limbs + nlimbs * i;
+        if (kind > 3)
+            goto invalid;
+        if (kind == 1) {
+            if (exp < mpfr_get_emin() || exp > mpfr_get_emax() ||
+                !(sig[nlimbs - 1] >> (GMP_NUMB_BITS - 1)))
+                goto invalid;
+            if (unused && (sig[0] & (((mp_limb_t)1 << unused) - 1))) {
+                if (limbs)
+                    goto invalid;
+                sig[0] &= ~(((mp_limb_t)1 << unused) - 1);
+            }
+        }
+        mpfr_custom_init_set(result->f[i], kind_map[kind],
+                             kind == 1 ? (mpfr_exp_t)exp : 0,
+                             (mpfr_prec_t)prec, sig);
+        if (kp[i] & 0x80)
+            mpfr_setsign(result->f[i], result->f[i], 1, MPFR_RNDN);
+    }
+
+    if (view) {
+        result->readonly = 1;
+        if (limbs) {
+            result->view = *view;
+            result->source = view->obj;
+            Py_INCREF(result->source);
+        }
+    }
+    return result;
+
+  invalid:
+    if (limbs)
+        result->limbs = NULL;
+    Py_DECREF((PyObject*)result);
+    VALUE_ERROR("byte sequence invalid for from_binary()");
+    return NULL;
+
+  short_error:
+    VALUE_ERROR("byte sequence too short for from_binary()");
+    return NULL;
+}
+
+static PyObject *
+GMPy_MPFR_Array_From_Binary(unsigned char *buffer, Py_ssize_t len)
+{
+    return (PyObject*)_GMPy_MPFR_Array_Decode(buffer, len, NULL);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_to_binary,
+"a.to_binary() -> bytes\n\n"
+"Return a portable binary representation of all elements of a. The\n"
+"bytes can be passed to `from_binary()` or to the from_binary() method\n"
+"of the type of a.");
+
+static PyObject *
+GMPy_MPFR_Array_Method_To_Binary(PyObject *self, PyObject *other)
+{
+    return GMPy_MPFR_Array_To_Binary((MPFR_Array_Object*)self);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_from_binary,
+"mpfr_array.from_binary(bytes, /) -> mpfr_array\n\n"
+"Return the mpfr_array encoded by `mpfr_array.to_binary()`. The\n"
+"precision is the one of the saved array.");
+
+PyDoc_STRVAR(GMPy_doc_mpc_array_method_from_binary,
+"mpc_array.from_binary(bytes, /) -> mpc_array\n\n"
+"Return the mpc_array encoded by `mpc_array.to_binary()`. The precision\n"
+"is the one of the saved array.");
+
+static PyObject *
+GMPy_MPFR_Array_Method_From_Binary(PyObject *type, PyObject *other)
+{
+    Py_ssize_t len;
+    char tag = (PyTypeObject*)type == &MPC_Array_Type ? 0x09 : 0x08;
+
+    if (!PyBytes_Check(other)) {
+        TYPE_ERROR("from_binary() requires bytes argument");
+        return NULL;
+    }
+
+    len = PyBytes_GET_SIZE(other);
+    if (len < 2 || PyBytes_AS_STRING(other)[0] != tag) {
+        PyErr_Format(PyExc_ValueError, "byte sequence is not an %s",
+                     tag == 0x09 ? "mpc_array" : "mpfr_array");
+        return NULL;
+    }
+    return GMPy_MPFR_Array_From_Binary((unsigned char*)PyBytes_AS_STRING(other), len);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_from_buffer,
+"mpfr_array.from_buffer(buffer, /) -> mpfr_array\n\n"
+"Return a read-only mpfr_array for the bytes written by\n"
+"`mpfr_array.to_binary()` to an object that supports the buffer\n"
+"protocol, i.e. the buf of a multiprocessing.shared_memory.SharedMemory.\n"
+"With 64-bit limbs on a little-endian platform the significands are\n"
+"used in place and the buffer is kept until the array is deleted. Use\n"
+"copy() to get an array that can be changed.");
+
+PyDoc_STRVAR(GMPy_doc_mpc_array_method_from_buffer,
+"mpc_array.from_buffer(buffer, /) -> mpc_array\n\n"
+"Return a read-only mpc_array for the bytes written by\n"
+"`mpc_array.to_binary()` to an object that supports the buffer protocol.\n"
+"See `mpfr_array.from_buffer()`.");
+
+static PyObject *
+GMPy_MPFR_Array_Method_From_Buffer(PyObject *type, PyObject *other)
+{
+    MPFR_Array_Object *result;
+    Py_buffer view;
+    char tag = (PyTypeObject*)type == &MPC_Array_Type ? 0x09 : 0x08;
+
+    if (PyObject_GetBuffer(other, &view, PyBUF_SIMPLE) < 0)
+        return NULL;
+
+    if (view.len < 2 || ((char*)view.buf)[0] != tag) {
+        PyBuffer_Release(&view);
+        PyErr_Format(PyExc_ValueError, "buffer does not contain an %s",
+                     tag == 0x09 ? "mpc_array" : "mpfr_array");
+        return NULL;
+    }
+
+    result = _GMPy_MPFR_Array_Decode((unsigned char*)view.buf, view.len, &view);
+    if (!result || !result->source)
+        PyBuffer_Release(&view);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_copy,
+"x.copy() -> mpfr_array\n\n"
+"Return a new array with the elements of x that can be changed. Same as\n"
+"x[:].");
+
+static PyObject *
+GMPy_MPFR_Array_Method_Copy(PyObject *self, PyObject *other)
+{
+    PyObject *slice, *result;
+
+    if (!(slice = PySlice_New(NULL, NULL, NULL)))
+        return NULL;
+    result = GMPy_MPFR_Array_SubScript((MPFR_Array_Object*)self, slice);
+    Py_DECREF(slice);
+    return result;
+}
+
+/* Reductions. The elements are passed to mpfr_sum() and mpfr_dot() as they
+ * are stored, without creating mpfr objects, and the GIL is released.
+ */
+
+static PyObject *
+GMPy_MPFR_Array_Sum(MPFR_Array_Object *self, CTXT_Object *context)
+{
+    Py_ssize_t i, n = self->size;
+    mpfr_ptr *tab;
+    PyObject *result = NULL;
+
+    if (n > LONG_MAX) {
+        OVERFLOW_ERROR("temporary array is too large");
+        return NULL;
+    }
+    if (!(tab = PyMem_New(mpfr_ptr, MPFR_ARRAY_PARTS(self) * (n ? n : 1))))
+        return PyErr_NoMemory();
+
+    if (MPC_Array_Check(self)) {
+        MPC_Object *sum;
+        int rcr, rci;
+
+        for (i = 0; i < n; i++) {
+            tab[i] = self->f[2 * i];
+            tab[n + i] = self->f[2 * i + 1];
+        }
+        if ((sum = GMPy_MPC_New(0, 0, context))) {
+            mpfr_clear_flags();
+            GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)self->prec * n);
+            rcr = mpfr_sum(mpc_realref(sum->c), tab, (unsigned long)n, GET_REAL_ROUND(context));
+            rci = mpfr_sum(mpc_imagref(sum->c), tab + n, (unsigned long)n, GET_IMAG_ROUND(context));
+            GMPY_END_ALLOW_THREADS_MIN(context);
+            sum->rc = MPC_INEX(rcr, rci);
+            _GMPy_MPC_Cleanup(&sum, context);
+        }
+        result = (PyObject*)sum;
+    }
+    else {
+        MPFR_Object *sum;
+
+        for (i = 0; i < n; i++)
+            tab[i] = self->f[i];
+        if ((sum = GMPy_MPFR_New(0, context))) {
+            mpfr_clear_flags();
+            GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)self->prec * n);
+            sum->rc = mpfr_sum(sum->f, tab, (unsigned long)n, GET_MPFR_ROUND(context));
+            GMPY_END_ALLOW_THREADS_MIN(context);
+            _GMPy_MPFR_Cleanup(&sum, context);
+        }
+        result = (PyObject*)sum;
+    }
+    PyMem_Free(tab);
+    return result;
+}
+
+static PyObject *
+GMPy_MPFR_Array_Dot(MPFR_Array_Object *x, MPFR_Array_Object *y,
+                    CTXT_Object *context)
+{
+    Py_ssize_t i, n = x->size;
+    mpfr_ptr *tab;
+    MPFR_Object *result;
+
+    if (y->size != n) {
+        VALUE_ERROR("dot() requires sequences of the same length");
+        return NULL;
+    }
+    if (n > LONG_MAX) {
+        OVERFLOW_ERROR("temporary array is too large");
+        return NULL;
+    }
+    if (!(tab = PyMem_New(mpfr_ptr, 2 * (n ? n : 1))))
+        return PyErr_NoMemory();
+    for (i = 0; i < n; i++) {
+        tab[i] = x->f[i];
+        tab[n + i] = y->f[i];
+    }
+
+    if ((result = GMPy_MPFR_New(0, context))) {
+        mpfr_clear_flags();
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)(x->prec + y->prec) * n);
+        result->rc = mpfr_dot(result->f, tab, tab + n, (unsigned long)n,
+                              GET_MPFR_ROUND(context));
+        GMPY_END_ALLOW_THREADS_MIN(context);
+        _GMPy_MPFR_Cleanup(&result, context);
+    }
+    PyMem_Free(tab);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_sum,
+"x.sum() -> mpfr\n\n"
+"Return the correctly rounded sum of the elements using the current\n"
+"context. Same as fsum(x).");
+
+PyDoc_STRVAR(GMPy_doc_mpc_array_method_sum,
+"x.sum() -> mpc\n\n"
+"Return the sum of the elements using the current context. The real\n"
+"and imaginary parts are each correctly rounded.");
+
+static PyObject *
+GMPy_MPFR_Array_Method_Sum(PyObject *self, PyObject *other)
+{
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+    return GMPy_MPFR_Array_Sum((MPFR_Array_Object*)self, context);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_dot,
+"x.dot(y, /) -> mpfr\n\n"
+"Return the correctly rounded value of sum(a * b for a, b in zip(x, y))\n"
+"for an mpfr_array y of the same length, using the current context.\n"
+"Same as dot(x, y).");
+
+static PyObject *
+GMPy_MPFR_Array_Method_Dot(PyObject *self, PyObject *other)
+{
+    CTXT_Object *context = NULL;
+
+    if (!MPFR_Array_Check(other)) {
+        TYPE_ERROR("dot() requires an mpfr_array argument");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+    return GMPy_MPFR_Array_Dot((MPFR_Array_Object*)self,
+                               (MPFR_Array_Object*)other, context);
+}
+
+static PySequenceMethods GMPy_MPFR_Array_sequence_methods = {
+    .sq_length = (lenfunc)GMPy_MPFR_Array_Length,
+    .sq_item = (ssizeargfunc)GMPy_MPFR_Array_Item,
+};
+
+static PyMappingMethods GMPy_MPFR_Array_mapping_methods = {
+    (lenfunc)GMPy_MPFR_Array_Length,
+    (binaryfunc)GMPy_MPFR_Array_SubScript,
+    (objobjargproc)GMPy_MPFR_Array_AssignSubScript
+};
+
+static PyGetSetDef GMPy_MPFR_Array_getseters[] =
+{
+    { "precision", (getter)GMPy_MPFR_Array_GetPrec_Attrib, NULL, GMPy_doc_mpfr_array_precision, NULL },
+    { "readonly", (getter)GMPy_MPFR_Array_GetReadonly_Attrib, NULL, GMPy_doc_mpfr_array_readonly, NULL },
+    { NULL }
+};
+
+static PyMethodDef GMPy_MPFR_Array_methods[] =
+{
+    { "__reduce__", GMPy_MPANY_Reduce_Method, METH_NOARGS, GMPy_doc_method_reduce },
+    { "__reduce_ex__", GMPy_MPANY_Reduce_Ex_Method, METH_O, GMPy_doc_method_reduce_ex },
+    { "copy", GMPy_MPFR_Array_Method_Copy, METH_NOARGS, GMPy_doc_mpfr_array_method_copy },
+    { "dot", GMPy_MPFR_Array_Method_Dot, METH_O, GMPy_doc_mpfr_array_method_dot },
+    { "from_binary", GMPy_MPFR_Array_Method_From_Binary, METH_O | METH_CLASS, GMPy_doc_mpfr_array_method_from_binary },
+    { "from_buffer", GMPy_MPFR_Array_Method_From_Buffer, METH_O | METH_CLASS, GMPy_doc_mpfr_array_method_from_buffer },
+    { "sum", GMPy_MPFR_Array_Method_Sum, METH_NOARGS, GMPy_doc_mpfr_array_method_sum },
+    { "to_binary", GMPy_MPFR_Array_Method_To_Binary, METH_NOARGS, GMPy_doc_mpfr_array_method_to_binary },
+    { NULL }
+};
+
+static PyMethodDef GMPy_MPC_Array_methods[] =
+{
+    { "__reduce__", GMPy_MPANY_Reduce_Method, METH_NOARGS, GMPy_doc_method_reduce },
+    { "__reduce_ex__", GMPy_MPANY_Reduce_Ex_Method, METH_O, GMPy_doc_method_reduce_ex },
+    { "copy", GMPy_MPFR_Array_Method_Copy, METH_NOARGS, GMPy_doc_mpfr_array_method_copy },
+    { "from_binary", GMPy_MPFR_Array_Method_From_Binary, METH_O | METH_CLASS, GMPy_doc_mpc_array_method_from_binary },
+    { "from_buffer", GMPy_MPFR_Array_Method_From_Buffer, METH_O | METH_CLASS, GMPy_doc_mpc_array_method_from_buffer },
+    { "sum", GMPy_MPFR_Array_Method_Sum, METH_NOARGS, GMPy_doc_mpc_array_method_sum },
+    { "to_binary", GMPy_MPFR_Array_Method_To_Binary, METH_NOARGS, GMPy_doc_mpfr_array_method_to_binary },
+    { NULL }
+};
+
+static PyTypeObject MPFR_Array_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.mpfr_array",
+    .tp_basicsize = sizeof(MPFR_Array_Object),
+    .tp_dealloc = (destructor) GMPy_MPFR_Array_Dealloc,
+    .tp_repr = (reprfunc) GMPy_MPFR_Array_Repr_Slot,
+    .tp_as_sequence = &GMPy_MPFR_Array_sequence_methods,
+    .tp_as_mapping = &GMPy_MPFR_Array_mapping_methods,
+    .tp_hash = PyObject_HashNotImplemented,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_mpfr_array,
+    .tp_richcompare = GMPy_MPFR_Array_RichCompare_Slot,
+    .tp_methods = GMPy_MPFR_Array_methods,
+    .tp_getset = GMPy_MPFR_Array_getseters,
+    .tp_new = GMPy_MPFR_Array_NewInit,
+};
+
+static PyTypeObject MPC_Array_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.mpc_array",
+    .tp_basicsize = sizeof(MPFR_Array_Object),
+    .tp_dealloc = (destructor) GMPy_MPFR_Array_Dealloc,
+    .tp_repr = (reprfunc) GMPy_MPFR_Array_Repr_Slot,
+    .tp_as_sequence = &GMPy_MPFR_Array_sequence_methods,
+    .tp_as_mapping = &GMPy_MPFR_Array_mapping_methods,
+    .tp_hash = PyObject_HashNotImplemented,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_mpc_array,
+    .tp_richcompare = GMPy_MPFR_Array_RichCompare_Slot,
+    .tp_methods = GMPy_MPC_Array_methods,
+    .tp_getset = GMPy_MPFR_Array_getseters,
+    .tp_new = GMPy_MPFR_Array_NewInit,
+};
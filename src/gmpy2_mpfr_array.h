@@ -0,0 +1,81 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mpfr_array.h                                                      *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_MPFR_ARRAY_H
+#define GMPY_MPFR_ARRAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An mpfr_array stores a fixed number of mpfr_t values that share one
+ * precision. The significands are kept in a single block of limbs and the
+ * values are set up with mpfr_custom_init_set(), so there is no allocation
+ * per element. An mpc_array uses the same layout with two values, the real
+ * and the imaginary part, per element.
+ *
+ * The precision of the values is never changed and mpfr_clear() is never
+ * called on them. mpfr_swap() must not be used either since it would
+ * exchange the significands of two arrays.
+ *
+ * An array returned by from_buffer() is read-only. Its significands are
+ * usually the limbs in the buffer itself, i.e. a block of shared memory.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    Py_ssize_t size;            /* number of elements */
+    mpfr_prec_t prec;
+    mpfr_t *f;                  /* size values, or 2*size for an mpc_array */
+    mp_limb_t *limbs;           /* the significands of all values */
+    int readonly;
+    PyObject *source;           /* object that exports view, or NULL */
+    Py_buffer view;             /* holds limbs if source is set */
+} MPFR_Array_Object;
+
+static PyTypeObject MPFR_Array_Type;
+static PyTypeObject MPC_Array_Type;
+#define MPFR_Array_Check(v) (((PyObject*)v)->ob_type == &MPFR_Array_Type)
+#define MPC_Array_Check(v) (((PyObject*)v)->ob_type == &MPC_Array_Type)
+
+static MPFR_Array_Object * GMPy_MPFR_Array_New(PyTypeObject *type, Py_ssize_t size, mpfr_prec_t prec);
+static PyObject *          GMPy_MPFR_Array_To_Binary(MPFR_Array_Object *self);
+static PyObject *          GMPy_MPFR_Array_From_Binary(unsigned char *buffer, Py_ssize_t len);
+static PyObject *          GMPy_MPFR_Array_Sum(MPFR_Array_Object *self, CTXT_Object *context);
+static PyObject *          GMPy_MPFR_Array_Dot(MPFR_Array_Object *x, MPFR_Array_Object *y, CTXT_Object *context);
+
+/* Element i of an mpc_array as an mpc_t. The mpc_t shares the significands
+ * of the array; the result of an operation is copied back with
+ * _GMPy_MPC_Array_Store().
+ */
+
+static void                _GMPy_MPC_Array_Load(mpc_ptr c, MPFR_Array_Object *a, Py_ssize_t i);
+static void                _GMPy_MPC_Array_Store(MPFR_Array_Object *a, Py_ssize_t i, mpc_srcptr c);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
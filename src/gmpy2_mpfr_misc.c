@@ -99,14 +99,76 @@ GMPy_Context_F2Q(PyObject *self, PyObject *args)
     }
 }
 
+PyDoc_STRVAR(GMPy_doc_mpfr_function_mpfr_list,
+"mpfr_list(values, /, precision=0) -> list[mpfr]\n\n"
+"Return [mpfr(x, precision) for x in values]. Each value may be a real\n"
+"number or a string. Fraction and Decimal values are converted exactly\n"
+"and then rounded once.");
+
+static PyObject *
+GMPy_MPFR_Function_MPFR_List(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *values, *seq, *result, *item;
+    MPFR_Object *temp;
+    Py_ssize_t i, n;
+    mpfr_prec_t prec = 0;
+    CTXT_Object *context = NULL;
+    static char *kwlist[] = {"", "precision", NULL};
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|l", kwlist, &values, &prec))
+        return NULL;
+
+    if (prec < 0) {
+        VALUE_ERROR("precision for mpfr_list() must be >= 0");
+        return NULL;
+    }
+
+    if (!(seq = PySequence_Fast(values, "mpfr_list() requires an iterable")))
+        return NULL;
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    if (!(result = PyList_New(n))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(seq);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    for (i = 0; i < n; i++) {
+        item = PySequence_Fast_GET_ITEM(seq, i);
+        if (PyUnicode_Check(item) || PyBytes_Check(item)) {
+            temp = GMPy_MPFR_From_PyStr(item, 0, prec, context);
+        }
+        else if (IS_REAL(item)) {
+            temp = GMPy_MPFR_From_Real(item, prec, context);
+        }
+        else {
+            TYPE_ERROR("mpfr_list() requires real or string values");
+            temp = NULL;
+        }
+        if (!temp) {
+            Py_DECREF(seq);
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, i, (PyObject*)temp);
+    }
+    Py_DECREF(seq);
+    return result;
+}
+
 PyDoc_STRVAR(GMPy_doc_mpfr_free_cache,
 "free_cache() -> None\n\n"
-"Free the internal cache of constants maintained by MPFR.");
+"Free the internal cache of constants maintained by MPFR and the\n"
+"constants kept by `const_pi()` and the other constant functions.");
 
 static PyObject *
 GMPy_MPFR_Free_Cache(PyObject *self, PyObject *args)
 {
     mpfr_free_cache();
+    _GMPy_Const_Cache_Clear(-1, 0, GMPY_CONST_CACHE_MAX);
     Py_RETURN_NONE;
 }
 
@@ -213,7 +275,7 @@ GMPy_MPFR_get_exp(PyObject *self, PyObject *other)
         result = PyLong_FromSsize_t(0);
     }
     else {
-        context->ctx.erange = 1;
+        GMPY_CTXT_FLAGS(context)->erange = 1;
         if (context->ctx.traps & TRAP_ERANGE) {
             GMPY_ERANGE("Can not get exponent from NaN or Infinity.");
         }
@@ -271,7 +333,7 @@ GMPy_MPFR_set_exp(PyObject *self, PyObject *args)
     mpfr_set_emax(_oldemax);
 
     if (result->rc) {
-        context->ctx.erange = 1;
+        GMPY_CTXT_FLAGS(context)->erange = 1;
         if (context->ctx.traps & TRAP_ERANGE) {
             GMPY_ERANGE("new exponent is out-of-bounds");
             Py_DECREF((PyObject*)result);
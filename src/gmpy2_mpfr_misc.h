@@ -33,6 +33,7 @@ extern "C" {
 
 static PyObject * GMPy_Real_F2Q(PyObject *x, PyObject *y, CTXT_Object *context);
 
+static PyObject * GMPy_MPFR_Function_MPFR_List(PyObject *self, PyObject *args, PyObject *keywds);
 static PyObject * GMPy_MPFR_Free_Cache(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPFR_Can_Round(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPFR_get_emax_max(PyObject *self, PyObject *args);
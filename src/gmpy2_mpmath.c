@@ -411,3 +411,550 @@ Pympz_mpmath_create_fast(PyObject *self, PyObject *const *args, Py_ssize_t nargs
     Py_DECREF((PyObject*)man);
     return mpmath_build_mpf(sign, upper, newexp2, bc);
 }
+
+/* C versions of mpf_add, mpf_mul, mpf_div, and mpf_sqrt from mpmath's
+ * libmpf. They take and return (sign, man, exp, bc) tuples and produce the
+ * same results as the Python code. Special values (nan, inf), negative
+ * arguments to sqrt, and exponents that do not fit comfortably in a C long
+ * are not handled; NotImplemented is returned and the caller should use
+ * the Python version.
+ */
+
+#define MPMATH_EXP_MAX (LONG_MAX / 4)
+
+/* Parse an mpf tuple. Returns 1 for a finite value, 0 if the value is not
+ * handled, and -1 if an exception was raised. On success, *man is a new
+ * reference to the absolute value of the mantissa.
+ */
+
+static int
+mpmath_parse_mpf(PyObject *x, long *sign, MPZ_Object **man, long *exp)
+{
+    int overflow;
+
+    if (!PyTuple_Check(x) || PyTuple_GET_SIZE(x) != 4) {
+        TYPE_ERROR("mpf tuple (sign, man, exp, bc) expected");
+        return -1;
+    }
+
+    if ((*sign = mpmath_get_sign(PyTuple_GET_ITEM(x, 0))) == -1)
+        return -1;
+    *exp = PyLong_AsLongAndOverflow(PyTuple_GET_ITEM(x, 2), &overflow);
+    if (*exp == -1 && PyErr_Occurred())
+        return -1;
+    if (overflow || *exp > MPMATH_EXP_MAX || *exp < -MPMATH_EXP_MAX)
+        return 0;
+    if (!(*man = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(x, 1), NULL)))
+        return -1;
+
+    /* Zero is (0, 0, 0, 0); a zero mantissa with another exponent is a
+     * special value.
+     */
+
+    if (!mpz_sgn((*man)->z) && *exp) {
+        Py_CLEAR(*man);
+        return 0;
+    }
+    if (mpz_sgn((*man)->z) < 0 || mpz_sizeinbase((*man)->z, 2) > MPMATH_EXP_MAX) {
+        Py_CLEAR(*man);
+        return 0;
+    }
+    return 1;
+}
+
+/* Parse the optional prec and rnd arguments starting at args[i]. */
+
+static int
+mpmath_parse_prec_rnd(PyObject *const *args, Py_ssize_t nargs, Py_ssize_t i,
+                      long *prec, Py_UCS4 *rnd)
+{
+    if (nargs > i) {
+        *prec = GMPy_Integer_AsLong(args[i]);
+        if (*prec == -1 && PyErr_Occurred())
+            return -1;
+        if (*prec < 0 || *prec > MPMATH_EXP_MAX) {
+            VALUE_ERROR("invalid precision");
+            return -1;
+        }
+    }
+    if (nargs > i + 1) {
+        if (!PyUnicode_Check(args[i + 1]) || PyUnicode_GET_LENGTH(args[i + 1]) < 1) {
+            VALUE_ERROR("invalid rounding mode specified");
+            return -1;
+        }
+        *rnd = PyString_1Char(args[i + 1]);
+    }
+    if (!(*rnd == 'n' || *rnd == 'f' || *rnd == 'c' || *rnd == 'd' || *rnd == 'u')) {
+        VALUE_ERROR("invalid rounding mode specified");
+        return -1;
+    }
+    return 0;
+}
+
+/* Round sign * man * 2**exp to prec bits (all bits if prec is 0) and return
+ * the normalized tuple. man must not be negative. The reference to man is
+ * stolen and man is modified.
+ */
+
+static PyObject *
+mpmath_round_mpf(long sign, MPZ_Object *man, long exp, long prec, Py_UCS4 rnd)
+{
+    mp_bitcnt_t bc, shift, zbits;
+    PyObject *newexp;
+    int carry = 0;
+
+    if (!mpz_sgn(man->z))
+        return mpmath_build_mpf(0, man, 0, 0);
+
+    bc = mpz_sizeinbase(man->z, 2);
+    if (prec && bc > (mp_bitcnt_t)prec) {
+        shift = bc - prec;
+        if (rnd == 'f')
+            rnd = sign ? 'u' : 'd';
+        else if (rnd == 'c')
+            rnd = sign ? 'd' : 'u';
+
+        switch (rnd) {
+            case 'd':
+                mpz_fdiv_q_2exp(man->z, man->z, shift);
+                break;
+            case 'u':
+                mpz_cdiv_q_2exp(man->z, man->z, shift);
+                break;
+            default:
+                /* Round to nearest, ties to even. */
+                if (mpz_tstbit(man->z, shift - 1) &&
+                    (mpz_scan1(man->z, 0) < shift - 1 || mpz_tstbit(man->z, shift)))
+                    carry = 1;
+                mpz_fdiv_q_2exp(man->z, man->z, shift);
+                if (carry)
+                    mpz_add_ui(man->z, man->z, 1);
+        }
+        exp += (long)shift;
+    }
+
+    /* Strip trailing 0 bits. */
+    if ((zbits = mpz_scan1(man->z, 0))) {
+        mpz_fdiv_q_2exp(man->z, man->z, zbits);
+        exp += (long)zbits;
+    }
+
+    if (!(newexp = PyLong_FromLong(exp))) {
+        Py_DECREF((PyObject*)man);
+        return NULL;
+    }
+    return mpmath_build_mpf(sign, man, newexp, mpz_sizeinbase(man->z, 2));
+}
+
+PyDoc_STRVAR(doc_mpmath_add,
+"_mpmath_add(s, t, prec=0, rnd='d', sub=0, /): helper function for mpmath.\n\n"
+"Return s + t (s - t if sub is true) like mpmath's mpf_add(), or\n"
+"NotImplemented for values that are not handled.");
+
+static PyObject *
+Pympz_mpmath_add(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    long ssign, tsign, sexp, texp, prec = 0, offset;
+    MPZ_Object *sman = NULL, *tman = NULL, *result;
+    Py_UCS4 rnd = 'd';
+    int rs, rt, sub = 0;
+
+    if (nargs < 2 || nargs > 5) {
+        TYPE_ERROR("_mpmath_add() requires 2 to 5 arguments");
+        return NULL;
+    }
+    if (mpmath_parse_prec_rnd(args, nargs, 2, &prec, &rnd) < 0)
+        return NULL;
+    if (nargs == 5 && (sub = PyObject_IsTrue(args[4])) < 0)
+        return NULL;
+
+    if ((rs = mpmath_parse_mpf(args[0], &ssign, &sman, &sexp)) <= 0)
+        goto not_handled;
+    if ((rt = mpmath_parse_mpf(args[1], &tsign, &tman, &texp)) <= 0) {
+        Py_DECREF((PyObject*)sman);
+        rs = rt;
+        goto not_handled;
+    }
+    if (sub)
+        tsign ^= 1;
+
+    /* Adding zero only rounds the other operand. */
+
+    if (!mpz_sgn(sman->z) || !mpz_sgn(tman->z)) {
+        MPZ_Object *x = mpz_sgn(sman->z) ? sman : tman;
+
+        if (!(result = GMPy_MPZ_New(NULL)))
+            goto error;
+        mpz_set(result->z, x->z);
+        if (!mpz_sgn(result->z)) {
+            Py_DECREF((PyObject*)sman);
+            Py_DECREF((PyObject*)tman);
+            return mpmath_build_mpf(0, result, 0, 0);
+        }
+        ssign = (x == sman) ? ssign : tsign;
+        sexp = (x == sman) ? sexp : texp;
+        Py_DECREF((PyObject*)sman);
+        Py_DECREF((PyObject*)tman);
+        return mpmath_round_mpf(ssign, result, sexp, prec, rnd);
+    }
+
+    /* Make s the operand with the larger exponent. */
+
+    if (sexp < texp) {
+        MPZ_Object *tmp = sman;
+        long l;
+
+        sman = tman; tman = tmp;
+        l = ssign; ssign = tsign; tsign = l;
+        l = sexp; sexp = texp; texp = l;
+    }
+    offset = sexp - texp;
+
+    if (!(result = GMPy_MPZ_New(NULL)))
+        goto error;
+
+    /* If t is far below the last bit of the result, only its sign
+     * matters: replace it by a sticky bit.
+     */
+
+    if (offset > 100 && prec &&
+        (long)mpz_sizeinbase(sman->z, 2) + sexp -
+        (long)mpz_sizeinbase(tman->z, 2) - texp > prec + 4) {
+        mpz_mul_2exp(result->z, sman->z, prec + 4);
+        if (ssign == tsign)
+            mpz_add_ui(result->z, result->z, 1);
+        else
+            mpz_sub_ui(result->z, result->z, 1);
+        Py_DECREF((PyObject*)sman);
+        Py_DECREF((PyObject*)tman);
+        return mpmath_round_mpf(ssign, result, sexp - prec - 4, prec, rnd);
+    }
+
+    mpz_mul_2exp(result->z, sman->z, offset);
+    if (ssign == tsign) {
+        mpz_add(result->z, result->z, tman->z);
+    }
+    else {
+        mpz_sub(result->z, result->z, tman->z);
+        if (mpz_sgn(result->z) < 0) {
+            mpz_neg(result->z, result->z);
+            ssign = tsign;
+        }
+    }
+    Py_DECREF((PyObject*)sman);
+    Py_DECREF((PyObject*)tman);
+    return mpmath_round_mpf(ssign, result, texp, prec, rnd);
+
+  error:
+    Py_DECREF((PyObject*)sman);
+    Py_DECREF((PyObject*)tman);
+    return NULL;
+
+  not_handled:
+    if (rs < 0)
+        return NULL;
+    Py_RETURN_NOTIMPLEMENTED;
+}
+
+PyDoc_STRVAR(doc_mpmath_mul,
+"_mpmath_mul(s, t, prec=0, rnd='d', /): helper function for mpmath.\n\n"
+"Return s * t like mpmath's mpf_mul(), or NotImplemented for values\n"
+"that are not handled.");
+
+static PyObject *
+Pympz_mpmath_mul(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    long ssign, tsign, sexp, texp, prec = 0;
+    MPZ_Object *sman = NULL, *tman = NULL, *result;
+    Py_UCS4 rnd = 'd';
+    int rs;
+
+    if (nargs < 2 || nargs > 4) {
+        TYPE_ERROR("_mpmath_mul() requires 2 to 4 arguments");
+        return NULL;
+    }
+    if (mpmath_parse_prec_rnd(args, nargs, 2, &prec, &rnd) < 0)
+        return NULL;
+    if ((rs = mpmath_parse_mpf(args[0], &ssign, &sman, &sexp)) <= 0)
+        goto not_handled;
+    if ((rs = mpmath_parse_mpf(args[1], &tsign, &tman, &texp)) <= 0) {
+        Py_DECREF((PyObject*)sman);
+        goto not_handled;
+    }
+
+    if (!(result = GMPy_MPZ_New(NULL))) {
+        Py_DECREF((PyObject*)sman);
+        Py_DECREF((PyObject*)tman);
+        return NULL;
+    }
+    mpz_mul(result->z, sman->z, tman->z);
+    Py_DECREF((PyObject*)sman);
+    Py_DECREF((PyObject*)tman);
+    return mpmath_round_mpf(ssign ^ tsign, result, sexp + texp, prec, rnd);
+
+  not_handled:
+    if (rs < 0)
+        return NULL;
+    Py_RETURN_NOTIMPLEMENTED;
+}
+
+PyDoc_STRVAR(doc_mpmath_div,
+"_mpmath_div(s, t, prec, rnd='d', /): helper function for mpmath.\n\n"
+"Return s / t like mpmath's mpf_div(), or NotImplemented for values\n"
+"that are not handled.");
+
+static PyObject *
+Pympz_mpmath_div(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    long ssign, tsign, sexp, texp, prec = 0, extra;
+    MPZ_Object *sman = NULL, *tman = NULL, *result;
+    Py_UCS4 rnd = 'd';
+    int rs;
+    mpz_t rem;
+
+    if (nargs < 3 || nargs > 4) {
+        TYPE_ERROR("_mpmath_div() requires 3 or 4 arguments");
+        return NULL;
+    }
+    if (mpmath_parse_prec_rnd(args, nargs, 2, &prec, &rnd) < 0)
+        return NULL;
+    if (prec < 1) {
+        VALUE_ERROR("precision must be positive");
+        return NULL;
+    }
+    if ((rs = mpmath_parse_mpf(args[0], &ssign, &sman, &sexp)) <= 0)
+        goto not_handled;
+    if ((rs = mpmath_parse_mpf(args[1], &tsign, &tman, &texp)) <= 0) {
+        Py_DECREF((PyObject*)sman);
+        goto not_handled;
+    }
+
+    if (!mpz_sgn(tman->z)) {
+        Py_DECREF((PyObject*)sman);
+        Py_DECREF((PyObject*)tman);
+        ZERO_ERROR("mpf division by zero");
+        return NULL;
+    }
+    if (!(result = GMPy_MPZ_New(NULL))) {
+        Py_DECREF((PyObject*)sman);
+        Py_DECREF((PyObject*)tman);
+        return NULL;
+    }
+    if (!mpz_sgn(sman->z)) {
+        Py_DECREF((PyObject*)sman);
+        Py_DECREF((PyObject*)tman);
+        return mpmath_build_mpf(0, result, 0, 0);
+    }
+
+    /* Compute enough extra bits for correct rounding; a nonzero remainder
+     * is recorded as a sticky bit.
+     */
+
+    extra = prec - (long)mpz_sizeinbase(sman->z, 2) + (long)mpz_sizeinbase(tman->z, 2) + 5;
+    if (extra < 5)
+        extra = 5;
+    mpz_init(rem);
+    mpz_mul_2exp(result->z, sman->z, extra);
+    mpz_fdiv_qr(result->z, rem, result->z, tman->z);
+    if (mpz_sgn(rem)) {
+        mpz_mul_2exp(result->z, result->z, 1);
+        mpz_add_ui(result->z, result->z, 1);
+        extra++;
+    }
+    mpz_clear(rem);
+    Py_DECREF((PyObject*)sman);
+    Py_DECREF((PyObject*)tman);
+    return mpmath_round_mpf(ssign ^ tsign, result, sexp - texp - extra, prec, rnd);
+
+  not_handled:
+    if (rs < 0)
+        return NULL;
+    Py_RETURN_NOTIMPLEMENTED;
+}
+
+PyDoc_STRVAR(doc_mpmath_sqrt,
+"_mpmath_sqrt(s, prec, rnd='d', /): helper function for mpmath.\n\n"
+"Return the square root of s like mpmath's mpf_sqrt(), or\n"
+"NotImplemented for values that are not handled.");
+
+static PyObject *
+Pympz_mpmath_sqrt(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    long sign, exp, prec = 0, shift;
+    MPZ_Object *man = NULL, *result;
+    Py_UCS4 rnd = 'd';
+    int rs;
+    mpz_t rem;
+
+    if (nargs < 2 || nargs > 3) {
+        TYPE_ERROR("_mpmath_sqrt() requires 2 or 3 arguments");
+        return NULL;
+    }
+    if (mpmath_parse_prec_rnd(args, nargs, 1, &prec, &rnd) < 0)
+        return NULL;
+    if (prec < 1) {
+        VALUE_ERROR("precision must be positive");
+        return NULL;
+    }
+    if ((rs = mpmath_parse_mpf(args[0], &sign, &man, &exp)) <= 0) {
+        if (rs < 0)
+            return NULL;
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (!mpz_sgn(man->z)) {
+        Py_DECREF((PyObject*)man);
+        Py_INCREF(args[0]);
+        return args[0];
+    }
+    if (sign) {
+        Py_DECREF((PyObject*)man);
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (!(result = GMPy_MPZ_New(NULL))) {
+        Py_DECREF((PyObject*)man);
+        return NULL;
+    }
+
+    /* Make the exponent even. */
+
+    mpz_set(result->z, man->z);
+    Py_DECREF((PyObject*)man);
+    if (exp & 1) {
+        exp--;
+        mpz_mul_2exp(result->z, result->z, 1);
+    }
+    else if (!mpz_cmp_ui(result->z, 1)) {
+        return mpmath_round_mpf(0, result, exp / 2, prec, rnd);
+    }
+
+    shift = 2 * prec - (long)mpz_sizeinbase(result->z, 2) + 4;
+    if (shift < 4)
+        shift = 4;
+    shift += shift & 1;
+    mpz_mul_2exp(result->z, result->z, shift);
+    if (rnd == 'f' || rnd == 'd') {
+        mpz_sqrt(result->z, result->z);
+    }
+    else {
+        mpz_init(rem);
+        mpz_sqrtrem(result->z, rem, result->z);
+        if (mpz_sgn(rem)) {
+            mpz_mul_2exp(result->z, result->z, 1);
+            mpz_add_ui(result->z, result->z, 1);
+            shift += 2;
+        }
+        mpz_clear(rem);
+    }
+    return mpmath_round_mpf(0, result, (exp - shift) / 2, prec, rnd);
+}
+
+PyDoc_STRVAR(doc_mpmath_normalize_list,
+"_mpmath_normalize_list(values, prec, rnd='d', /): helper function for mpmath.\n\n"
+"Return a list with the result of _mpmath_normalize(sign, man, exp, bc,\n"
+"prec, rnd) for each (sign, man, exp, bc) tuple in values.");
+
+static PyObject *
+Pympz_mpmath_normalize_list(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *seq, *result, *item, *value;
+    MPZ_Object *man;
+    Py_ssize_t i, n;
+    long prec = 0, sign, exp;
+    Py_UCS4 rnd = 'd';
+    int overflow;
+
+    if (nargs < 2 || nargs > 3) {
+        TYPE_ERROR("_mpmath_normalize_list() requires 2 or 3 arguments");
+        return NULL;
+    }
+    if (mpmath_parse_prec_rnd(args, nargs, 1, &prec, &rnd) < 0)
+        return NULL;
+    if (prec < 1) {
+        VALUE_ERROR("precision must be positive");
+        return NULL;
+    }
+
+    if (!(seq = PySequence_Fast(args[0], "values must be a sequence")))
+        return NULL;
+    n = PySequence_Fast_GET_SIZE(seq);
+    if (!(result = PyList_New(n))) {
+        Py_DECREF(seq);
+        return NULL;
+    }
+
+    for (i = 0; i < n; i++) {
+        item = PySequence_Fast_GET_ITEM(seq, i);
+        if (!PyTuple_Check(item) || PyTuple_GET_SIZE(item) != 4) {
+            TYPE_ERROR("mpf tuple (sign, man, exp, bc) expected");
+            goto error;
+        }
+        if ((sign = mpmath_get_sign(PyTuple_GET_ITEM(item, 0))) == -1)
+            goto error;
+        exp = PyLong_AsLongAndOverflow(PyTuple_GET_ITEM(item, 2), &overflow);
+        if (exp == -1 && PyErr_Occurred())
+            goto error;
+
+        /* Large exponents are handled by _mpmath_normalize(). */
+
+        if (overflow || exp > MPMATH_EXP_MAX || exp < -MPMATH_EXP_MAX) {
+            PyObject *argv[6];
+
+            argv[0] = PyTuple_GET_ITEM(item, 0);
+            argv[1] = PyTuple_GET_ITEM(item, 1);
+            argv[2] = PyTuple_GET_ITEM(item, 2);
+            argv[3] = PyTuple_GET_ITEM(item, 3);
+            argv[4] = args[1];
+            argv[5] = (nargs == 3) ? args[2] : NULL;
+            if (!argv[5]) {
+                if (!(argv[5] = PyUnicode_FromOrdinal(rnd)))
+                    goto error;
+                value = Pympz_mpmath_normalize_fast(NULL, argv, 6, NULL);
+                Py_DECREF(argv[5]);
+            }
+            else {
+                value = Pympz_mpmath_normalize_fast(NULL, argv, 6, NULL);
+            }
+            if (!value)
+                goto error;
+            PyList_SET_ITEM(result, i, value);
+            continue;
+        }
+
+        /* mpmath_round_mpf() rounds the mantissa in place, so it is
+         * always copied to a new mpz. The converted value may be shared.
+         */
+
+        value = PyTuple_GET_ITEM(item, 1);
+        if (MPZ_Check(value)) {
+            mp_bitcnt_t bc;
+
+            /* Already normalized: return the tuple itself. */
+
+            if (mpz_sgn(MPZ(value)) && mpz_odd_p(MPZ(value)) &&
+                (bc = mpz_sizeinbase(MPZ(value), 2)) <= (mp_bitcnt_t)prec) {
+                Py_INCREF(item);
+                PyList_SET_ITEM(result, i, item);
+                continue;
+            }
+            if (!(man = GMPy_MPZ_New(NULL)))
+                goto error;
+            mpz_set(man->z, MPZ(value));
+        }
+        else if (!(man = GMPy_MPZ_From_IntegerAndCopy(value, NULL))) {
+            goto error;
+        }
+        if (mpz_sgn(man->z) < 0)
+            mpz_neg(man->z, man->z);
+
+        if (!(value = mpmath_round_mpf(mpz_sgn(man->z) ? sign : 0, man, exp, prec, rnd)))
+            goto error;
+        PyList_SET_ITEM(result, i, value);
+    }
+    Py_DECREF(seq);
+    return result;
+
+  error:
+    Py_DECREF(seq);
+    Py_DECREF(result);
+    return NULL;
+}
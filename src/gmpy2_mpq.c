@@ -26,7 +26,7 @@
 
 PyDoc_STRVAR(GMPy_doc_mpq,
 "mpq(n=0, /)\n"
-"mpq(n, m, /)\n"
+"mpq(n, m, /, canonical=False)\n"
 "mpq(s, /, base=10)\n\n"
 "Return a rational number constructed from a non-complex number n\n"
 "exactly or from a pair of `~numbers.Rational` values n and m or\n"
@@ -38,7 +38,11 @@ PyDoc_STRVAR(GMPy_doc_mpq,
 "does.  If base is 0 then the leading characters are used to recognize the\n"
 "base, this is done separately for the numerator and denominator.  If\n"
 "base=10, any string that represents a finite value and is accepted by\n"
-"the `float` constructor is also accepted.");
+"the `float` constructor is also accepted.\n\n"
+"If canonical is True, n and m must be integers that are already coprime;\n"
+"the gcd is skipped and only the sign of m is normalized. A fraction that\n"
+"is not reduced gives wrong results from later operations (a debug build\n"
+"of Python raises ValueError instead). See also `mpq_many`.");
 
 /* Since `gmpy2.mpq` is now a type and no longer a factory function, see
  * gmpy2_cache.c/GMPy_MPQ_NewInit for details on creation.
@@ -79,6 +83,8 @@ static PyMethodDef GMPy_MPQ_methods [] =
 {
     { "__ceil__", GMPy_MPQ_Method_Ceil, METH_NOARGS, GMPy_doc_mpq_method_ceil },
     { "__floor__", GMPy_MPQ_Method_Floor, METH_NOARGS, GMPy_doc_mpq_method_floor },
+    { "__reduce__", GMPy_MPANY_Reduce_Method, METH_NOARGS, GMPy_doc_method_reduce },
+    { "__reduce_ex__", GMPy_MPANY_Reduce_Ex_Method, METH_O, GMPy_doc_method_reduce_ex },
     { "__round__", GMPy_MPQ_Method_Round, METH_VARARGS, GMPy_doc_mpq_method_round },
     { "__sizeof__", GMPy_MPQ_Method_Sizeof, METH_NOARGS, GMPy_doc_mpq_method_sizeof },
     { "__trunc__", GMPy_MPQ_Method_Trunc, METH_NOARGS, GMPy_doc_mpq_method_trunc },
@@ -106,5 +112,8 @@ static PyTypeObject MPQ_Type =
     .tp_methods = GMPy_MPQ_methods,
     .tp_getset = GMPy_MPQ_getseters,
     .tp_new =GMPy_MPQ_NewInit,
+#ifdef GMPY_TYPE_VECTORCALL
+    .tp_vectorcall = GMPy_MPQ_Vectorcall,
+#endif
 };
 
@@ -258,6 +258,388 @@ GMPy_MPQ_Function_Qdiv(PyObject *self, PyObject *args)
     return NULL;
 }
 
+PyDoc_STRVAR(GMPy_doc_mpq_function_mpq_list,
+"mpq_list(values, /) -> list[mpq]\n\n"
+"Return [mpq(x) for x in values]. Each value may be a number or a\n"
+"string. Fraction and Decimal values are read directly from their\n"
+"integer parts.");
+
+static PyObject *
+GMPy_MPQ_Function_MPQ_List(PyObject *self, PyObject *other)
+{
+    PyObject *seq, *result, *item;
+    MPQ_Object *temp;
+    Py_ssize_t i, n;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(seq = PySequence_Fast(other, "mpq_list() requires an iterable")))
+        return NULL;
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    if (!(result = PyList_New(n))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(seq);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    for (i = 0; i < n; i++) {
+        item = PySequence_Fast_GET_ITEM(seq, i);
+        if (PyUnicode_Check(item) || PyBytes_Check(item)) {
+            temp = GMPy_MPQ_From_PyStr(item, 10, context);
+        }
+        else if (IS_REAL(item)) {
+            temp = GMPy_MPQ_From_Number(item, context);
+        }
+        else {
+            TYPE_ERROR("mpq_list() requires numeric or string values");
+            temp = NULL;
+        }
+        if (!temp) {
+            Py_DECREF(seq);
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, i, (PyObject*)temp);
+    }
+    Py_DECREF(seq);
+    return result;
+}
+
+/* Continued fractions.
+ *
+ * The partial quotients of x = n/d are the quotients of the Euclidean
+ * algorithm on (n, d), the first being floor(x). They are taken from
+ * _GMPy_Lehmer_Matrix() a batch at a time, so a long expansion needs a
+ * multiprecision step per batch of quotients instead of a division per
+ * quotient.
+ */
+
+typedef struct {
+    mpz_t a, b, u, v;
+    unsigned long q[GMPY_LEHMER_MAXQ];
+    int nq, iq;
+} gmpy_cont_frac;
+
+static void
+_GMPy_CF_Init(gmpy_cont_frac *cf, mpq_srcptr x)
+{
+    mpz_init_set(cf->a, mpq_numref(x));
+    mpz_init_set(cf->b, mpq_denref(x));
+    mpz_init(cf->u);
+    mpz_init(cf->v);
+    cf->nq = cf->iq = 0;
+}
+
+static void
+_GMPy_CF_Clear(gmpy_cont_frac *cf)
+{
+    mpz_clear(cf->a);
+    mpz_clear(cf->b);
+    mpz_clear(cf->u);
+    mpz_clear(cf->v);
+}
+
+/* Set q to the next partial quotient and return 1, or return 0 after the
+ * last one. Does not use the Python API.
+ */
+
+static int
+_GMPy_CF_Next(gmpy_cont_frac *cf, mpz_ptr q)
+{
+    long m[4];
+
+    if (cf->iq < cf->nq) {
+        mpz_set_ui(q, cf->q[cf->iq++]);
+        return 1;
+    }
+    if (mpz_sgn(cf->b) == 0)
+        return 0;
+
+    if (mpz_cmp(cf->a, cf->b) >= 0 &&
+        (cf->nq = _GMPy_Lehmer_Matrix(cf->a, cf->b, m, cf->q, cf->u)) > 0) {
+        _GMPy_Lehmer_Apply(cf->a, cf->b, m, cf->u, cf->v);
+        cf->iq = 1;
+        mpz_set_ui(q, cf->q[0]);
+        return 1;
+    }
+    cf->nq = cf->iq = 0;
+    mpz_fdiv_qr(q, cf->a, cf->a, cf->b);
+    mpz_swap(cf->a, cf->b);
+    return 1;
+}
+
+/* Convert the arguments x and max_terms of cont_frac() and convergents().
+ * max_terms is -1 if there is no limit.
+ */
+
+static MPQ_Object *
+_GMPy_CF_Args(PyObject *args, PyObject *keywds, Py_ssize_t *max_terms,
+              const char *name, CTXT_Object *context)
+{
+    static char *kwlist[] = {"", "max_terms", NULL};
+    PyObject *x, *n = Py_None;
+    char format[16];
+
+    PyOS_snprintf(format, sizeof(format), "O|O:%s", name);
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, format, kwlist, &x, &n))
+        return NULL;
+
+    *max_terms = -1;
+    if (n != Py_None) {
+        if ((*max_terms = PyNumber_AsSsize_t(n, PyExc_OverflowError)) == -1 &&
+            PyErr_Occurred())
+            return NULL;
+        if (*max_terms < 0) {
+            PyErr_Format(PyExc_ValueError, "%s() requires max_terms >= 0", name);
+            return NULL;
+        }
+    }
+
+    if (!IS_REAL(x)) {
+        PyErr_Format(PyExc_TypeError, "%s() requires a rational or real argument", name);
+        return NULL;
+    }
+    return GMPy_MPQ_From_Number(x, context);
+}
+
+PyDoc_STRVAR(GMPy_doc_function_cont_frac,
+"cont_frac(x, /, max_terms=None) -> list[mpz]\n\n"
+"Return the partial quotients [a0, a1, ...] of the continued fraction\n"
+"x = a0 + 1/(a1 + 1/(a2 + ...)), at most max_terms of them. x is\n"
+"converted exactly to an `mpq`, so an `mpfr` or a float is expanded as\n"
+"the binary fraction it holds. The expansion is finite and its last\n"
+"term is > 1 unless it is the only one.");
+
+static PyObject *
+GMPy_MPQ_Function_Cont_Frac(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *result = NULL;
+    MPQ_Object *x;
+    MPZ_Object *q;
+    gmpy_cont_frac cf;
+    Py_ssize_t max_terms;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(x = _GMPy_CF_Args(args, keywds, &max_terms, "cont_frac", context)))
+        return NULL;
+
+    if (!(result = PyList_New(0))) {
+        Py_DECREF((PyObject*)x);
+        return NULL;
+    }
+
+    _GMPy_CF_Init(&cf, x->q);
+    while (max_terms < 0 || PyList_GET_SIZE(result) < max_terms) {
+        if (!(q = GMPy_MPZ_New(context))) {
+            Py_CLEAR(result);
+            break;
+        }
+        if (!_GMPy_CF_Next(&cf, q->z)) {
+            Py_DECREF((PyObject*)q);
+            break;
+        }
+        if (PyList_Append(result, (PyObject*)q) < 0) {
+            Py_DECREF((PyObject*)q);
+            Py_CLEAR(result);
+            break;
+        }
+        Py_DECREF((PyObject*)q);
+    }
+    _GMPy_CF_Clear(&cf);
+    Py_DECREF((PyObject*)x);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_convergents,
+"convergents(x, /, max_terms=None) -> list[mpq]\n\n"
+"Return the convergents of the continued fraction of x, the values of\n"
+"its first 1, 2, ... partial quotients, at most max_terms of them. The\n"
+"last one is x itself unless max_terms stops the expansion early. See\n"
+"`cont_frac()`.");
+
+static PyObject *
+GMPy_MPQ_Function_Convergents(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *result = NULL;
+    MPQ_Object *x, *c;
+    gmpy_cont_frac cf;
+    Py_ssize_t max_terms;
+    mpz_t q, p0, q0, p1, q1;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(x = _GMPy_CF_Args(args, keywds, &max_terms, "convergents", context)))
+        return NULL;
+
+    if (!(result = PyList_New(0))) {
+        Py_DECREF((PyObject*)x);
+        return NULL;
+    }
+
+    /* p1/q1 is the last convergent and p0/q0 the one before it. */
+
+    mpz_init(q);
+    mpz_init_set_ui(p0, 0);
+    mpz_init_set_ui(q0, 1);
+    mpz_init_set_ui(p1, 1);
+    mpz_init_set_ui(q1, 0);
+    _GMPy_CF_Init(&cf, x->q);
+    while ((max_terms < 0 || PyList_GET_SIZE(result) < max_terms) &&
+           _GMPy_CF_Next(&cf, q)) {
+        mpz_addmul(p0, q, p1);
+        mpz_addmul(q0, q, q1);
+        mpz_swap(p0, p1);
+        mpz_swap(q0, q1);
+        if (!(c = GMPy_MPQ_New(context))) {
+            Py_CLEAR(result);
+            break;
+        }
+        mpz_set(mpq_numref(c->q), p1);
+        mpz_set(mpq_denref(c->q), q1);
+        if (PyList_Append(result, (PyObject*)c) < 0) {
+            Py_DECREF((PyObject*)c);
+            Py_CLEAR(result);
+            break;
+        }
+        Py_DECREF((PyObject*)c);
+    }
+    _GMPy_CF_Clear(&cf);
+    mpz_clear(q);
+    mpz_clear(p0);
+    mpz_clear(q0);
+    mpz_clear(p1);
+    mpz_clear(q1);
+    Py_DECREF((PyObject*)x);
+    return result;
+}
+
+/* Set r to the closest fraction to x with a denominator <= max_den > 0,
+ * the same as Fraction.limit_denominator(). Does not use the Python API.
+ */
+
+static void
+_GMPy_Limit_Denominator(mpq_ptr r, mpq_srcptr x, mpz_srcptr max_den)
+{
+    gmpy_cont_frac cf;
+    mpz_t q, p0, q0, p1, q1;
+    mpq_t e0, e1;
+
+    if (mpz_cmp(mpq_denref(x), max_den) <= 0) {
+        mpq_set(r, x);
+        return;
+    }
+
+    mpz_init(q);
+    mpz_init_set_ui(p0, 0);
+    mpz_init_set_ui(q0, 1);
+    mpz_init_set_ui(p1, 1);
+    mpz_init_set_ui(q1, 0);
+    _GMPy_CF_Init(&cf, x);
+
+    /* Stop at the last convergent p1/q1 with q1 <= max_den. The expansion
+     * does not end before since the denominator of x is > max_den.
+     */
+
+    while (_GMPy_CF_Next(&cf, q)) {
+        mpz_addmul(q0, q, q1);
+        if (mpz_cmp(q0, max_den) > 0)
+            break;
+        mpz_addmul(p0, q, p1);
+        mpz_swap(p0, p1);
+        mpz_swap(q0, q1);
+    }
+
+    /* The other candidate is the semiconvergent (p0+k*p1)/(q0+k*q1) with
+     * the largest k that keeps its denominator <= max_den.
+     */
+
+    mpz_submul(q0, q, q1);
+    mpz_sub(q, max_den, q0);
+    mpz_fdiv_q(q, q, q1);
+    mpz_addmul(p0, q, p1);
+    mpz_addmul(q0, q, q1);
+
+    mpq_init(e0);
+    mpq_init(e1);
+    mpz_set(mpq_numref(e0), p0);
+    mpz_set(mpq_denref(e0), q0);
+    mpq_sub(e0, e0, x);
+    mpq_abs(e0, e0);
+    mpz_set(mpq_numref(e1), p1);
+    mpz_set(mpq_denref(e1), q1);
+    mpq_sub(e1, e1, x);
+    mpq_abs(e1, e1);
+    if (mpq_cmp(e1, e0) <= 0) {
+        mpz_swap(mpq_numref(r), p1);
+        mpz_swap(mpq_denref(r), q1);
+    }
+    else {
+        mpz_swap(mpq_numref(r), p0);
+        mpz_swap(mpq_denref(r), q0);
+    }
+    mpq_clear(e0);
+    mpq_clear(e1);
+    _GMPy_CF_Clear(&cf);
+    mpz_clear(q);
+    mpz_clear(p0);
+    mpz_clear(q0);
+    mpz_clear(p1);
+    mpz_clear(q1);
+}
+
+PyDoc_STRVAR(GMPy_doc_function_limit_denominator,
+"limit_denominator(x, max_denominator, /) -> mpq\n\n"
+"Return the closest fraction to x with a denominator of at most\n"
+"max_denominator, as Fraction(x).limit_denominator(max_denominator).\n"
+"x is converted exactly to an `mpq`. The best approximation is a\n"
+"convergent or a semiconvergent of the continued fraction of x, see\n"
+"`convergents()`.");
+
+static PyObject *
+GMPy_MPQ_Function_Limit_Denominator(PyObject *self, PyObject *args)
+{
+    MPQ_Object *x = NULL, *result = NULL;
+    MPZ_Object *max_den = NULL;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("limit_denominator() requires 2 arguments");
+        return NULL;
+    }
+    if (!IS_REAL(PyTuple_GET_ITEM(args, 0))) {
+        TYPE_ERROR("limit_denominator() requires a rational or real argument");
+        return NULL;
+    }
+
+    if (!(max_den = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), context)))
+        return NULL;
+    if (mpz_sgn(max_den->z) <= 0) {
+        VALUE_ERROR("limit_denominator() requires max_denominator > 0");
+        goto done;
+    }
+
+    if (!(x = GMPy_MPQ_From_Number(PyTuple_GET_ITEM(args, 0), context)) ||
+        !(result = GMPy_MPQ_New(context)))
+        goto done;
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(mpq_denref(x->q)));
+    _GMPy_Limit_Denominator(result->q, x->q, max_den->z);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+  done:
+    Py_XDECREF((PyObject*)x);
+    Py_DECREF((PyObject*)max_den);
+    return (PyObject*)result;
+}
+
 PyDoc_STRVAR(GMPy_doc_mpq_method_floor,
 "Return greatest integer less than or equal to an mpq.");
 
@@ -41,6 +41,10 @@ static PyObject * GMPy_MPQ_Method_From_As_Integer_Ratio(PyTypeObject *type, PyOb
 static PyObject * GMPy_MPQ_Function_Numer(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPQ_Function_Denom(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPQ_Function_Qdiv(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPQ_Function_MPQ_List(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPQ_Function_Cont_Frac(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPQ_Function_Convergents(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPQ_Function_Limit_Denominator(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPQ_Method_Ceil(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPQ_Method_Floor(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPQ_Method_Trunc(PyObject *self, PyObject *other);
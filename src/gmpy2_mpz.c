@@ -88,6 +88,8 @@ static PyMethodDef GMPy_MPZ_methods[] = {
     { "__format__", GMPy_MPZ_Format, METH_VARARGS, GMPy_doc_mpz_format },
     { "__ceil__", GMPy_MPZ_Method_Ceil, METH_NOARGS, GMPy_doc_mpz_method_ceil },
     { "__floor__", GMPy_MPZ_Method_Floor, METH_NOARGS, GMPy_doc_mpz_method_floor },
+    { "__reduce__", GMPy_MPANY_Reduce_Method, METH_NOARGS, GMPy_doc_method_reduce },
+    { "__reduce_ex__", GMPy_MPANY_Reduce_Ex_Method, METH_O, GMPy_doc_method_reduce_ex },
     { "__round__", GMPy_MPZ_Method_Round, METH_VARARGS, GMPy_doc_mpz_method_round },
     { "__sizeof__", GMPy_MPZ_Method_SizeOf, METH_NOARGS, GMPy_doc_mpz_method_sizeof },
     { "__trunc__", GMPy_MPZ_Method_Trunc, METH_NOARGS, GMPy_doc_mpz_method_trunc },
@@ -99,6 +101,7 @@ static PyMethodDef GMPy_MPZ_methods[] = {
     { "bit_scan1", GMPy_MPZ_bit_scan1_method, METH_VARARGS, doc_bit_scan1_method },
     { "bit_set", GMPy_MPZ_bit_set_method, METH_O, doc_bit_set_method },
     { "bit_test", GMPy_MPZ_bit_test_method, METH_O, doc_bit_test_method },
+    { "bits", (PyCFunction)(void(*)(void))GMPy_MPZ_bits_method, METH_FASTCALL, doc_bits_method },
     { "conjugate", GMPy_MP_Method_Conjugate, METH_NOARGS, GMPy_doc_mp_method_conjugate },
     { "digits", GMPy_MPZ_Digits_Method, METH_VARARGS, GMPy_doc_mpz_digits_method },
     { "is_congruent", GMPy_MPZ_Method_IsCongruent, METH_VARARGS, GMPy_doc_mpz_method_is_congruent },
@@ -109,10 +112,14 @@ static PyMethodDef GMPy_MPZ_methods[] = {
     { "is_prime", GMPy_MPZ_Method_IsPrime, METH_VARARGS, GMPy_doc_mpz_method_is_prime },
     { "is_probab_prime", (PyCFunction)GMPy_MPZ_Method_IsProbabPrime, METH_FASTCALL, GMPy_doc_mpz_method_is_probab_prime },
     { "is_square", GMPy_MPZ_Method_IsSquare, METH_NOARGS, GMPy_doc_mpz_method_is_square },
-    { "num_digits", GMPy_MPZ_Method_NumDigits, METH_VARARGS, GMPy_doc_mpz_method_num_digits },
+    { "num_digits", (PyCFunction)GMPy_MPZ_Method_NumDigits, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_method_num_digits },
     { "as_integer_ratio", GMPy_MPZ_Method_As_Integer_Ratio, METH_NOARGS, GMPy_doc_mpz_method_as_integer_ratio },
     { "to_bytes", (PyCFunction)GMPy_MPZ_Method_To_Bytes, METH_FASTCALL | METH_KEYWORDS, GMPy_doc_mpz_method_to_bytes },
     { "from_bytes", (PyCFunction)GMPy_MPZ_Method_From_Bytes, METH_FASTCALL | METH_KEYWORDS | METH_CLASS, GMPy_doc_mpz_method_from_bytes },
+    { "from_bytes_many", (PyCFunction)(void(*)(void))GMPy_MPZ_Method_From_Bytes_Many, METH_VARARGS | METH_KEYWORDS | METH_CLASS, GMPy_doc_mpz_method_from_bytes_many },
+    { "to_bytes_many", (PyCFunction)(void(*)(void))GMPy_MPZ_Method_To_Bytes_Many, METH_VARARGS | METH_KEYWORDS | METH_CLASS, GMPy_doc_mpz_method_to_bytes_many },
+    { "write_digits", (PyCFunction)GMPy_MPZ_Method_Write_Digits, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_method_write_digits },
+    { "from_digits_file", (PyCFunction)GMPy_MPZ_Method_From_Digits_File, METH_VARARGS | METH_KEYWORDS | METH_CLASS, GMPy_doc_mpz_method_from_digits_file },
     { NULL, NULL, 1 }
 };
 
@@ -125,6 +132,7 @@ static PyTypeObject MPZ_Type = {
     .tp_repr = (reprfunc) GMPy_MPZ_Repr_Slot,
     .tp_as_number = &GMPy_MPZ_number_methods,
     .tp_as_mapping = &GMPy_MPZ_mapping_methods,
+    .tp_as_buffer = &GMPy_MPZ_as_buffer,
     .tp_hash = (hashfunc) GMPy_MPZ_Hash_Slot,
     .tp_str = (reprfunc) GMPy_MPZ_Str_Slot,
     .tp_flags = Py_TPFLAGS_DEFAULT,
@@ -133,5 +141,8 @@ static PyTypeObject MPZ_Type = {
     .tp_methods = GMPy_MPZ_methods,
     .tp_getset = GMPy_MPZ_getseters,
     .tp_new = GMPy_MPZ_NewInit,
+#ifdef GMPY_TYPE_VECTORCALL
+    .tp_vectorcall = GMPy_MPZ_Vectorcall,
+#endif
 };
 
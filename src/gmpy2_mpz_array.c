@@ -0,0 +1,1119 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mpz_array.c                                                       *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+PyDoc_STRVAR(GMPy_doc_mpz_array,
+"mpz_array(n=0, /) -> mpz_array\n"
+"mpz_array(iterable, /) -> mpz_array\n\n"
+"Return a fixed-length array of integers. With an integer argument the\n"
+"array has n elements that are all 0. Otherwise the array is initialized\n"
+"from the integers in iterable. The values are stored in one block of\n"
+"memory instead of separate mpz objects; indexing returns a new mpz and\n"
+"slicing returns a new mpz_array.");
+
+static MPZ_Array_Object *
+GMPy_MPZ_Array_New(Py_ssize_t size)
+{
+    MPZ_Array_Object *result;
+    Py_ssize_t i;
+
+    if (!(result = PyObject_New(MPZ_Array_Object, &MPZ_Array_Type)))
+        return NULL;
+
+    if (!(result->z = PyMem_New(mpz_t, size ? size : 1))) {
+        result->size = 0;
+        Py_DECREF((PyObject*)result);
+        return (MPZ_Array_Object*)PyErr_NoMemory();
+    }
+    for (i = 0; i < size; i++)
+        mpz_init(result->z[i]);
+    result->size = size;
+    return result;
+}
+
+static void
+GMPy_MPZ_Array_Dealloc(MPZ_Array_Object *self)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < self->size; i++)
+        mpz_clear(self->z[i]);
+    PyMem_Free(self->z);
+    PyObject_Free(self);
+}
+
+/* Store the integer obj in z. Returns -1 and sets an exception if obj is
+ * not an integer.
+ */
+
+static int
+_GMPy_MPZ_Array_Set(mpz_t z, PyObject *obj, CTXT_Object *context)
+{
+    MPZ_Object *temp;
+
+    if (CHECK_MPZANY(obj)) {
+        mpz_set(z, MPZ(obj));
+        return 0;
+    }
+
+    if (PyLong_Check(obj)) {
+        mpz_set_PyLong(z, obj);
+        return 0;
+    }
+
+    if (!IS_INTEGER(obj)) {
+        TYPE_ERROR("mpz_array elements must be integers");
+        return -1;
+    }
+
+    if (!(temp = GMPy_MPZ_From_Integer(obj, context)))
+        return -1;
+    mpz_set(z, temp->z);
+    Py_DECREF((PyObject*)temp);
+    return 0;
+}
+
+static MPZ_Array_Object *
+_GMPy_MPZ_Array_From_Iterable(PyObject *obj, CTXT_Object *context)
+{
+    MPZ_Array_Object *result;
+    PyObject *seq, **items;
+    Py_ssize_t i, n;
+
+    if (!(seq = PySequence_Fast(obj, "mpz_array() requires an integer or an iterable")))
+        return NULL;
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    items = PySequence_Fast_ITEMS(seq);
+
+    if ((result = GMPy_MPZ_Array_New(n))) {
+        for (i = 0; i < n; i++) {
+            if (_GMPy_MPZ_Array_Set(result->z[i], items[i], context) < 0) {
+                Py_CLEAR(result);
+                break;
+            }
+        }
+    }
+    Py_DECREF(seq);
+    return result;
+}
+
+static PyObject *
+GMPy_MPZ_Array_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    PyObject *arg;
+    Py_ssize_t n;
+    CTXT_Object *context = NULL;
+
+    if (keywds && PyDict_Size(keywds)) {
+        TYPE_ERROR("mpz_array() takes no keyword arguments");
+        return NULL;
+    }
+
+    if (PyTuple_GET_SIZE(args) == 0)
+        return (PyObject*)GMPy_MPZ_Array_New(0);
+
+    if (PyTuple_GET_SIZE(args) != 1) {
+        TYPE_ERROR("mpz_array() takes at most 1 argument");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    arg = PyTuple_GET_ITEM(args, 0);
+    if (PyIndex_Check(arg)) {
+        n = PyNumber_AsSsize_t(arg, PyExc_OverflowError);
+        if (n == -1 && PyErr_Occurred())
+            return NULL;
+        if (n < 0) {
+            VALUE_ERROR("mpz_array() size must be >= 0");
+            return NULL;
+        }
+        return (PyObject*)GMPy_MPZ_Array_New(n);
+    }
+
+    return (PyObject*)_GMPy_MPZ_Array_From_Iterable(arg, context);
+}
+
+static Py_ssize_t
+GMPy_MPZ_Array_Length(MPZ_Array_Object *self)
+{
+    return self->size;
+}
+
+static PyObject *
+GMPy_MPZ_Array_Item(MPZ_Array_Object *self, Py_ssize_t i)
+{
+    MPZ_Object *result;
+
+    if (i < 0 || i >= self->size) {
+        INDEX_ERROR("mpz_array index out of range");
+        return NULL;
+    }
+
+    if ((result = GMPy_MPZ_New(NULL)))
+        mpz_set(result->z, self->z[i]);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_MPZ_Array_SubScript(MPZ_Array_Object *self, PyObject *item)
+{
+    if (PyIndex_Check(item)) {
+        Py_ssize_t i;
+
+        i = PyNumber_AsSsize_t(item, PyExc_IndexError);
+        if (i == -1 && PyErr_Occurred())
+            return NULL;
+        if (i < 0)
+            i += self->size;
+        return GMPy_MPZ_Array_Item(self, i);
+    }
+    else if (PySlice_Check(item)) {
+        Py_ssize_t start, stop, step, slicelength, cur, i;
+        MPZ_Array_Object *result;
+
+        if (PySlice_Unpack(item, &start, &stop, &step) < 0)
+            return NULL;
+        slicelength = PySlice_AdjustIndices(self->size, &start, &stop, step);
+
+        if (!(result = GMPy_MPZ_Array_New(slicelength)))
+            return NULL;
+        for (cur = start, i = 0; i < slicelength; cur += step, i++)
+            mpz_set(result->z[i], self->z[cur]);
+        return (PyObject*)result;
+    }
+    else {
+        TYPE_ERROR("mpz_array indices must be integers or slices");
+        return NULL;
+    }
+}
+
+static int
+GMPy_MPZ_Array_AssignSubScript(MPZ_Array_Object *self, PyObject *item,
+                               PyObject *value)
+{
+    CTXT_Object *context = NULL;
+
+    if (!value) {
+        TYPE_ERROR("mpz_array does not support item deletion");
+        return -1;
+    }
+
+    CHECK_CONTEXT_M1(context);
+
+    if (PyIndex_Check(item)) {
+        Py_ssize_t i;
+
+        i = PyNumber_AsSsize_t(item, PyExc_IndexError);
+        if (i == -1 && PyErr_Occurred())
+            return -1;
+        if (i < 0)
+            i += self->size;
+        if (i < 0 || i >= self->size) {
+            INDEX_ERROR("mpz_array assignment index out of range");
+            return -1;
+        }
+        return _GMPy_MPZ_Array_Set(self->z[i], value, context);
+    }
+    else if (PySlice_Check(item)) {
+        Py_ssize_t start, stop, step, slicelength, cur, i;
+        MPZ_Array_Object *temp;
+        int res = 0;
+
+        if (PySlice_Unpack(item, &start, &stop, &step) < 0)
+            return -1;
+        slicelength = PySlice_AdjustIndices(self->size, &start, &stop, step);
+
+        /* Convert all values first so a failed assignment leaves the array
+         * unchanged and a.__setitem__(slice, a) reads the old values.
+         */
+
+        if (!(temp = _GMPy_MPZ_Array_From_Iterable(value, context)))
+            return -1;
+
+        if (temp->size != slicelength) {
+            VALUE_ERROR("mpz_array slice assignment cannot change the size");
+            res = -1;
+        }
+        else {
+            for (cur = start, i = 0; i < slicelength; cur += step, i++)
+                mpz_swap(self->z[cur], temp->z[i]);
+        }
+        Py_DECREF((PyObject*)temp);
+        return res;
+    }
+    else {
+        TYPE_ERROR("mpz_array indices must be integers or slices");
+        return -1;
+    }
+}
+
+static PyObject *
+GMPy_MPZ_Array_Repr_Slot(MPZ_Array_Object *self)
+{
+    PyObject *list, *sep, *body, *result = NULL, *temp;
+    Py_ssize_t i;
+
+    if (!(list = PyList_New(self->size)))
+        return NULL;
+
+    for (i = 0; i < self->size; i++) {
+        if (!(temp = mpz_ascii(self->z[i], 10, 0, 0))) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, temp);
+    }
+
+    if ((sep = PyUnicode_FromString(", "))) {
+        if ((body = PyUnicode_Join(sep, list))) {
+            result = PyUnicode_FromFormat("mpz_array([%U])", body);
+            Py_DECREF(body);
+        }
+        Py_DECREF(sep);
+    }
+    Py_DECREF(list);
+    return result;
+}
+
+static PyObject *
+GMPy_MPZ_Array_RichCompare_Slot(PyObject *a, PyObject *b, int op)
+{
+    MPZ_Array_Object *x = (MPZ_Array_Object*)a, *y = (MPZ_Array_Object*)b;
+    Py_ssize_t i;
+    int equal;
+
+    if (!MPZ_Array_Check(b) || (op != Py_EQ && op != Py_NE))
+        Py_RETURN_NOTIMPLEMENTED;
+
+    equal = (x->size == y->size);
+    for (i = 0; equal && i < x->size; i++)
+        equal = (mpz_cmp(x->z[i], y->z[i]) == 0);
+
+    if ((op == Py_EQ) == equal)
+        Py_RETURN_TRUE;
+    Py_RETURN_FALSE;
+}
+
+/* Format of the binary representation of an mpz_array.
+ *
+ * byte[0]:      6 => mpz_array
+ * byte[1:2-2]:  0 => 32-bit lengths (n=4)
+ *               1 => 64-bit lengths (n=8)
+ * byte[2]+:     number of elements, saved in 4 or 8 bytes
+ *
+ * Followed by each element:
+ *
+ * byte[0]:      0 => value is 0
+ *               1 => value is > 0
+ *               2 => value is < 0
+ * byte[1]+:     length of the value, saved in 4 or 8 bytes
+ * byte[1+n]+:   value
+ */
+
+static void
+_GMPy_Binary_Put_Size(char *buffer, size_t value, size_t sizesize)
+{
+    size_t i;
+
+    for (i = 0; i < sizesize; i++) {
+        buffer[i] = (char)(value & 0xff);
+        value >>= 8;
+    }
+}
+
+static size_t
+_GMPy_Binary_Get_Size(unsigned char *buffer, size_t sizesize)
+{
+    size_t i, value = 0;
+
+    for (i = sizesize; i > 0; i--)
+        value = (value << 8) | buffer[i - 1];
+    return value;
+}
+
+static PyObject *
+GMPy_MPZ_Array_To_Binary(MPZ_Array_Object *self)
+{
+    size_t sizesize = 4, size, len, count;
+    Py_ssize_t i;
+    char *buffer, large = 0x00;
+    PyObject *result;
+
+    size = 0;
+    for (i = 0; i < self->size; i++) {
+        len = (mpz_sizeinbase(self->z[i], 2) + 7) / 8;
+        if ((len >> 16) >> 16)
+            large = 0x04;
+        size += len;
+    }
+    if (((size_t)self->size >> 16) >> 16)
+        large = 0x04;
+    if (large)
+        sizesize = 8;
+    size += 2 + sizesize + (size_t)self->size * (1 + sizesize);
+
+    if (!(result = PyBytes_FromStringAndSize(NULL, size)))
+        return NULL;
+    buffer = PyBytes_AS_STRING(result);
+
+    buffer[0] = 0x06;
+    buffer[1] = large;
+    _GMPy_Binary_Put_Size(buffer + 2, (size_t)self->size, sizesize);
+    buffer += 2 + sizesize;
+
+    for (i = 0; i < self->size; i++) {
+        int sgn = mpz_sgn(self->z[i]);
+
+        buffer[0] = sgn == 0 ? 0x00 : (sgn > 0 ? 0x01 : 0x02);
+        count = 0;
+        if (sgn)
+            mpz_export(buffer + 1 + sizesize, &count, -1, sizeof(char), 0, 0,
+                       self->z[i]);
+        _GMPy_Binary_Put_Size(buffer + 1, count, sizesize);
+        buffer += 1 + sizesize + count;
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_MPZ_Array_From_Binary(unsigned char *buffer, Py_ssize_t len)
+{
+    MPZ_Array_Object *result;
+    size_t sizesize = 4, size, count, remaining = (size_t)len;
+    Py_ssize_t i;
+
+    if (buffer[1] & 0x04)
+        sizesize = 8;
+    if (remaining < 2 + sizesize)
+        goto short_error;
+
+    size = _GMPy_Binary_Get_Size(buffer + 2, sizesize);
+    buffer += 2 + sizesize;
+    remaining -= 2 + sizesize;
+
+    /* Every element needs at least 1 + sizesize bytes. */
+    if (size > remaining / (1 + sizesize))
+        goto short_error;
+
+    if (!(result = GMPy_MPZ_Array_New((Py_ssize_t)size)))
+        return NULL;
+
+    for (i = 0; i < result->size; i++) {
+        if (remaining < 1 + sizesize)
+            goto error;
+        count = _GMPy_Binary_Get_Size(buffer + 1, sizesize);
+        if (count > remaining - 1 - sizesize)
+            goto error;
+        if (count)
+            mpz_import(result->z[i], count, -1, sizeof(char), 0, 0,
+                       buffer + 1 + sizesize);
+        if (buffer[0] == 0x02)
+            mpz_neg(result->z[i], result->z[i]);
+        remaining -= 1 + sizesize + count;
+        buffer += 1 + sizesize + count;
+    }
+    return (PyObject*)result;
+
+  error:
+    Py_DECREF((PyObject*)result);
+  short_error:
+    VALUE_ERROR("byte sequence too short for from_binary()");
+    return NULL;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_array_method_to_binary,
+"a.to_binary() -> bytes\n\n"
+"Return a portable binary representation of all elements of a. The\n"
+"bytes can be passed to `from_binary()` or `mpz_array.from_binary()`.");
+
+static PyObject *
+GMPy_MPZ_Array_Method_To_Binary(PyObject *self, PyObject *other)
+{
+    return GMPy_MPZ_Array_To_Binary((MPZ_Array_Object*)self);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_array_method_from_binary,
+"mpz_array.from_binary(bytes, /) -> mpz_array\n\n"
+"Return the mpz_array encoded by `mpz_array.to_binary()`.");
+
+static PyObject *
+GMPy_MPZ_Array_Method_From_Binary(PyObject *type, PyObject *other)
+{
+    Py_ssize_t len;
+
+    if (!PyBytes_Check(other)) {
+        TYPE_ERROR("from_binary() requires bytes argument");
+        return NULL;
+    }
+
+    len = PyBytes_GET_SIZE(other);
+    if (len < 2 || PyBytes_AS_STRING(other)[0] != 0x06) {
+        VALUE_ERROR("byte sequence is not an mpz_array");
+        return NULL;
+    }
+    return GMPy_MPZ_Array_From_Binary((unsigned char*)PyBytes_AS_STRING(other), len);
+}
+
+/* Format of a file written by mpz_array.save(). All integers are stored in
+ * little-endian order.
+ *
+ * bytes[0:8]:   b"GMPYZA\x00\x01"
+ * bytes[8:16]:  number of elements, n
+ * Then n+1 offsets of 8 bytes each. Element i uses limbs offset[i] up to
+ *               offset[i+1] of the data. offset[0] is 0.
+ * Then n sign bytes (0 => value is 0, 1 => value is > 0, 2 => value is < 0),
+ *               padded with 0 to a multiple of 8 bytes.
+ * Then the data: the absolute values as 64-bit limbs, least significant
+ *               limb first.
+ *
+ * The fixed-size index lets load_mpz_array() find any element without
+ * reading the ones before it.
+ */
+
+static const char GMPy_MPZ_Array_Magic[8] = {'G', 'M', 'P', 'Y', 'Z', 'A', 0x00, 0x01};
+
+#define GMPY_SAVE_CHUNK ((size_t)1 << 20)
+
+static size_t
+_GMPy_MPZ_Array_Limbs(mpz_srcptr z)
+{
+    if (mpz_sgn(z) == 0)
+        return 0;
+    return (mpz_sizeinbase(z, 2) + 63) / 64;
+}
+
+static int
+_GMPy_MPZ_Array_Write(PyObject *file, const char *buffer, size_t len)
+{
+    PyObject *temp;
+
+    if (!len)
+        return 0;
+    if (!(temp = PyObject_CallMethod(file, "write", "y#", buffer, (Py_ssize_t)len)))
+        return -1;
+    Py_DECREF(temp);
+    return 0;
+}
+
+/* Write the header of the saved format, which has header bytes, to buffer.
+ * Returns the total number of limbs of the data.
+ */
+
+static size_t
+_GMPy_MPZ_Array_Put_Header(MPZ_Array_Object *self, char *buffer, size_t header)
+{
+    size_t offset = 0;
+    Py_ssize_t i;
+
+    memcpy(buffer, GMPy_MPZ_Array_Magic, 8);
+    _GMPy_Binary_Put_Size(buffer + 8, (size_t)self->size, 8);
+    memset(buffer + 16, 0, header - 16);
+    for (i = 0; i < self->size; i++) {
+        int sgn = mpz_sgn(self->z[i]);
+
+        _GMPy_Binary_Put_Size(buffer + 16 + 8 * i, offset, 8);
+        buffer[16 + 8 * (self->size + 1) + i] = sgn == 0 ? 0x00 : (sgn > 0 ? 0x01 : 0x02);
+        offset += _GMPy_MPZ_Array_Limbs(self->z[i]);
+    }
+    _GMPy_Binary_Put_Size(buffer + 16 + 8 * self->size, offset, 8);
+    return offset;
+}
+
+#define GMPY_SAVE_HEADER(n) (16 + 8 * ((size_t)(n) + 1) + (((size_t)(n) + 7) & ~(size_t)7))
+
+static int
+_GMPy_MPZ_Array_Save(MPZ_Array_Object *self, PyObject *file)
+{
+    size_t header, pos = 0, len;
+    char *buffer;
+    Py_ssize_t i;
+    int res = -1;
+
+    header = GMPY_SAVE_HEADER(self->size);
+    if (!(buffer = PyMem_Malloc(Py_MAX(header, GMPY_SAVE_CHUNK)))) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    _GMPy_MPZ_Array_Put_Header(self, buffer, header);
+    if (_GMPy_MPZ_Array_Write(file, buffer, header) < 0)
+        goto done;
+
+    /* Collect the limbs of small elements in buffer. */
+
+    for (i = 0; i < self->size; i++) {
+        len = 8 * _GMPy_MPZ_Array_Limbs(self->z[i]);
+        if (pos + len > GMPY_SAVE_CHUNK) {
+            if (_GMPy_MPZ_Array_Write(file, buffer, pos) < 0)
+                goto done;
+            pos = 0;
+        }
+        if (len > GMPY_SAVE_CHUNK) {
+            PyObject *temp;
+
+            if (!(temp = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)len)))
+                goto done;
+            mpz_export(PyBytes_AS_STRING(temp), NULL, -1, 8, -1, 0, self->z[i]);
+            if (_GMPy_MPZ_Array_Write(file, PyBytes_AS_STRING(temp), len) < 0) {
+                Py_DECREF(temp);
+                goto done;
+            }
+            Py_DECREF(temp);
+            continue;
+        }
+        if (len)
+            mpz_export(buffer + pos, NULL, -1, 8, -1, 0, self->z[i]);
+        pos += len;
+    }
+    res = _GMPy_MPZ_Array_Write(file, buffer, pos);
+
+  done:
+    PyMem_Free(buffer);
+    return res;
+}
+
+/* Call io.open(path, mode). */
+
+static PyObject *
+_GMPy_MPZ_Array_Open(PyObject *path, const char *mode)
+{
+    PyObject *io, *result;
+
+    if (!(io = PyImport_ImportModule("io")))
+        return NULL;
+    result = PyObject_CallMethod(io, "open", "Os", path, mode);
+    Py_DECREF(io);
+    return result;
+}
+
+/* Close file without losing an exception that is already set. */
+
+static int
+_GMPy_MPZ_Array_Close(PyObject *file)
+{
+    PyObject *type, *value, *traceback, *temp;
+
+    PyErr_Fetch(&type, &value, &traceback);
+    temp = PyObject_CallMethod(file, "close", NULL);
+    Py_XDECREF(temp);
+    if (type) {
+        if (!temp)
+            PyErr_Clear();
+        PyErr_Restore(type, value, traceback);
+        return -1;
+    }
+    return temp ? 0 : -1;
+}
+
+/* Number of bytes written by save(), or 0 if it does not fit in a
+ * Py_ssize_t.
+ */
+
+static size_t
+_GMPy_MPZ_Array_Saved_Size(MPZ_Array_Object *self)
+{
+    size_t limbs = 0, max = (size_t)PY_SSIZE_T_MAX / 8;
+    Py_ssize_t i;
+
+    for (i = 0; i < self->size; i++) {
+        limbs += _GMPy_MPZ_Array_Limbs(self->z[i]);
+        if (limbs > max)
+            return 0;
+    }
+    if (limbs > max - GMPY_SAVE_HEADER(self->size) / 8 - 1)
+        return 0;
+    return GMPY_SAVE_HEADER(self->size) + 8 * limbs;
+}
+
+/* Write the saved format to a writable buffer, i.e. a block of shared
+ * memory, without a temporary copy.
+ */
+
+static int
+_GMPy_MPZ_Array_Save_Buffer(MPZ_Array_Object *self, PyObject *target)
+{
+    Py_buffer view;
+    size_t size, header, pos;
+    Py_ssize_t i;
+
+    if (!(size = _GMPy_MPZ_Array_Saved_Size(self))) {
+        OVERFLOW_ERROR("mpz_array too large for save()");
+        return -1;
+    }
+    if (PyObject_GetBuffer(target, &view, PyBUF_WRITABLE) < 0)
+        return -1;
+    if ((size_t)view.len < size) {
+        PyBuffer_Release(&view);
+        PyErr_Format(PyExc_ValueError, "save() requires a buffer of at least %zu bytes", size);
+        return -1;
+    }
+
+    header = GMPY_SAVE_HEADER(self->size);
+    _GMPy_MPZ_Array_Put_Header(self, (char*)view.buf, header);
+    pos = header;
+    for (i = 0; i < self->size; i++) {
+        if (mpz_sgn(self->z[i]))
+            mpz_export((char*)view.buf + pos, NULL, -1, 8, -1, 0, self->z[i]);
+        pos += 8 * _GMPy_MPZ_Array_Limbs(self->z[i]);
+    }
+    PyBuffer_Release(&view);
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_array_method_save,
+"a.save(target, /) -> None\n\n"
+"Write all elements of a in a format that `load_mpz_array()` can\n"
+"memory-map. target is a file path or a writable buffer, i.e. the buf\n"
+"of a multiprocessing.shared_memory.SharedMemory, of at least\n"
+"a.saved_size() bytes. The format has an index with the position of\n"
+"each element, followed by the values as 64-bit limbs.");
+
+static PyObject *
+GMPy_MPZ_Array_Method_Save(PyObject *self, PyObject *path)
+{
+    PyObject *file;
+    int res;
+
+    if (PyObject_CheckBuffer(path) && !PyBytes_Check(path)) {
+        if (_GMPy_MPZ_Array_Save_Buffer((MPZ_Array_Object*)self, path) < 0)
+            return NULL;
+        Py_RETURN_NONE;
+    }
+
+    if (!(file = _GMPy_MPZ_Array_Open(path, "wb")))
+        return NULL;
+    res = _GMPy_MPZ_Array_Save((MPZ_Array_Object*)self, file);
+    if (_GMPy_MPZ_Array_Close(file) < 0)
+        res = -1;
+    Py_DECREF(file);
+    if (res < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_array_method_saved_size,
+"a.saved_size() -> int\n\n"
+"Return the number of bytes written by `mpz_array.save()`.");
+
+static PyObject *
+GMPy_MPZ_Array_Method_Saved_Size(PyObject *self, PyObject *other)
+{
+    size_t size;
+
+    if (!(size = _GMPy_MPZ_Array_Saved_Size((MPZ_Array_Object*)self))) {
+        OVERFLOW_ERROR("mpz_array too large for save()");
+        return NULL;
+    }
+    return PyLong_FromSize_t(size);
+}
+
+/* Set z to element i of a mapped array. Return -1 if the index of the
+ * file is invalid. The Python API is not used.
+ */
+
+static int
+_GMPy_Mapped_MPZ_Array_Get(Mapped_MPZ_Array_Object *self, Py_ssize_t i, mpz_ptr z)
+{
+    size_t start, stop;
+
+    start = _GMPy_Binary_Get_Size(self->index + 8 * i, 8);
+    stop = _GMPy_Binary_Get_Size(self->index + 8 * (i + 1), 8);
+    if (start > stop || stop > self->limbs || self->signs[i] > 0x02)
+        return -1;
+    if (start == stop || self->signs[i] == 0x00) {
+        mpz_set_ui(z, 0);
+        return 0;
+    }
+    mpz_import(z, stop - start, -1, 8, -1, 0, self->data + 8 * start);
+    if (self->signs[i] == 0x02)
+        mpz_neg(z, z);
+    return 0;
+}
+
+static void
+GMPy_Mapped_MPZ_Array_Dealloc(Mapped_MPZ_Array_Object *self)
+{
+    if (self->source) {
+        PyBuffer_Release(&self->view);
+        Py_DECREF(self->source);
+    }
+    PyObject_Free(self);
+}
+
+static Py_ssize_t
+GMPy_Mapped_MPZ_Array_Length(Mapped_MPZ_Array_Object *self)
+{
+    return self->size;
+}
+
+static PyObject *
+GMPy_Mapped_MPZ_Array_Item(Mapped_MPZ_Array_Object *self, Py_ssize_t i)
+{
+    MPZ_Object *result;
+
+    if (i < 0 || i >= self->size) {
+        INDEX_ERROR("mpz_array index out of range");
+        return NULL;
+    }
+
+    if (!(result = GMPy_MPZ_New(NULL)))
+        return NULL;
+    if (_GMPy_Mapped_MPZ_Array_Get(self, i, result->z) < 0) {
+        Py_DECREF((PyObject*)result);
+        VALUE_ERROR("mpz_array file is corrupt");
+        return NULL;
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_Mapped_MPZ_Array_SubScript(Mapped_MPZ_Array_Object *self, PyObject *item)
+{
+    if (PyIndex_Check(item)) {
+        Py_ssize_t i;
+
+        i = PyNumber_AsSsize_t(item, PyExc_IndexError);
+        if (i == -1 && PyErr_Occurred())
+            return NULL;
+        if (i < 0)
+            i += self->size;
+        return GMPy_Mapped_MPZ_Array_Item(self, i);
+    }
+    else if (PySlice_Check(item)) {
+        Py_ssize_t start, stop, step, slicelength, cur, i;
+        MPZ_Array_Object *result;
+
+        if (PySlice_Unpack(item, &start, &stop, &step) < 0)
+            return NULL;
+        slicelength = PySlice_AdjustIndices(self->size, &start, &stop, step);
+
+        if (!(result = GMPy_MPZ_Array_New(slicelength)))
+            return NULL;
+        for (cur = start, i = 0; i < slicelength; cur += step, i++) {
+            if (_GMPy_Mapped_MPZ_Array_Get(self, cur, result->z[i]) < 0) {
+                Py_DECREF((PyObject*)result);
+                VALUE_ERROR("mpz_array file is corrupt");
+                return NULL;
+            }
+        }
+        return (PyObject*)result;
+    }
+    else {
+        TYPE_ERROR("mpz_array indices must be integers or slices");
+        return NULL;
+    }
+}
+
+/* Check the header in view and return a new mapped array that keeps a
+ * reference to source.
+ */
+
+static Mapped_MPZ_Array_Object *
+_GMPy_Mapped_MPZ_Array_New(PyObject *source)
+{
+    Mapped_MPZ_Array_Object *result;
+    unsigned char *buffer;
+    size_t len, size, header;
+
+    if (!(result = PyObject_New(Mapped_MPZ_Array_Object, &Mapped_MPZ_Array_Type)))
+        return NULL;
+    result->source = NULL;
+    if (PyObject_GetBuffer(source, &result->view, PyBUF_SIMPLE) < 0) {
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    Py_INCREF(source);
+    result->source = source;
+
+    buffer = (unsigned char*)result->view.buf;
+    len = (size_t)result->view.len;
+    if (len < 16 || memcmp(buffer, GMPy_MPZ_Array_Magic, 8))
+        goto error;
+    size = _GMPy_Binary_Get_Size(buffer + 8, 8);
+    if (size > (len - 16) / 9)
+        goto error;
+    header = 16 + 8 * (size + 1) + ((size + 7) & ~(size_t)7);
+    if (header > len)
+        goto error;
+
+    result->size = (Py_ssize_t)size;
+    result->index = buffer + 16;
+    result->signs = buffer + 16 + 8 * (size + 1);
+    result->data = buffer + header;
+    result->limbs = (len - header) / 8;
+    return result;
+
+  error:
+    Py_DECREF((PyObject*)result);
+    VALUE_ERROR("file is not an mpz_array saved by mpz_array.save()");
+    return NULL;
+}
+
+/* Return the contents of the file path as an object that supports the
+ * buffer protocol: a read-only mmap if use_mmap is true, bytes otherwise.
+ */
+
+static PyObject *
+_GMPy_Read_File(PyObject *path, int use_mmap)
+{
+    PyObject *file, *source = NULL;
+
+    if (!(file = _GMPy_MPZ_Array_Open(path, "rb")))
+        return NULL;
+
+    if (use_mmap) {
+        PyObject *mmap_module, *mmap_type = NULL, *access = NULL;
+        PyObject *fileno = NULL, *mmap_args = NULL, *mmap_kwargs = NULL;
+
+        /* access must be passed by keyword: the third positional argument
+         * of mmap.mmap() is flags on Unix but tagname on Windows. */
+
+        if ((mmap_module = PyImport_ImportModule("mmap"))) {
+            if ((mmap_type = PyObject_GetAttrString(mmap_module, "mmap")) &&
+                (access = PyObject_GetAttrString(mmap_module, "ACCESS_READ")) &&
+                (fileno = PyObject_CallMethod(file, "fileno", NULL)) &&
+                (mmap_args = Py_BuildValue("(On)", fileno, (Py_ssize_t)0)) &&
+                (mmap_kwargs = Py_BuildValue("{sO}", "access", access))) {
+                source = PyObject_Call(mmap_type, mmap_args, mmap_kwargs);
+            }
+            Py_XDECREF(mmap_kwargs);
+            Py_XDECREF(mmap_args);
+            Py_XDECREF(fileno);
+            Py_XDECREF(access);
+            Py_XDECREF(mmap_type);
+            Py_DECREF(mmap_module);
+        }
+    }
+    else {
+        source = PyObject_CallMethod(file, "read", NULL);
+    }
+    if (_GMPy_MPZ_Array_Close(file) < 0)
+        Py_CLEAR(source);
+    Py_DECREF(file);
+    return source;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_array_load,
+"load_mpz_array(source, /, mmap=True) -> mpz_array\n\n"
+"Return the values written by `mpz_array.save()`. source is a file path\n"
+"or an object that supports the buffer protocol other than bytes, i.e.\n"
+"the buf of a multiprocessing.shared_memory.SharedMemory. If mmap is\n"
+"True, the file is memory-mapped, or the buffer is used in place, and a\n"
+"read-only sequence is returned that converts an element to an `mpz`\n"
+"only when it is accessed; slicing it or calling copy() returns an\n"
+"`mpz_array`. Otherwise all values are read into an `mpz_array`.");
+
+static PyObject *
+GMPy_MPZ_Array_Load(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "mmap", NULL};
+    PyObject *path, *source, *slice, *result = NULL;
+    Mapped_MPZ_Array_Object *mapped;
+    int use_mmap = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|p", kwlist, &path, &use_mmap))
+        return NULL;
+
+    if (PyObject_CheckBuffer(path) && !PyBytes_Check(path)) {
+        Py_INCREF(path);
+        source = path;
+    }
+    else if (!(source = _GMPy_Read_File(path, use_mmap))) {
+        return NULL;
+    }
+
+    mapped = _GMPy_Mapped_MPZ_Array_New(source);
+    Py_DECREF(source);
+    if (!mapped || use_mmap)
+        return (PyObject*)mapped;
+
+    /* Convert every element by taking the slice [:]. */
+
+    if ((slice = PySlice_New(NULL, NULL, NULL))) {
+        result = GMPy_Mapped_MPZ_Array_SubScript(mapped, slice);
+        Py_DECREF(slice);
+    }
+    Py_DECREF((PyObject*)mapped);
+    return result;
+}
+
+static PySequenceMethods GMPy_MPZ_Array_sequence_methods = {
+    .sq_length = (lenfunc)GMPy_MPZ_Array_Length,
+    .sq_item = (ssizeargfunc)GMPy_MPZ_Array_Item,
+};
+
+static PyMappingMethods GMPy_MPZ_Array_mapping_methods = {
+    (lenfunc)GMPy_MPZ_Array_Length,
+    (binaryfunc)GMPy_MPZ_Array_SubScript,
+    (objobjargproc)GMPy_MPZ_Array_AssignSubScript
+};
+
+/* Reductions. sum() and prod() use the loops of isum() and prod(), which
+ * read the stored values without converting them.
+ */
+
+PyDoc_STRVAR(GMPy_doc_mpz_array_method_sum,
+"x.sum() -> mpz\n\n"
+"Return the sum of the elements, or 0 if the array is empty. Same as\n"
+"isum(x).");
+
+static PyObject *
+GMPy_MPZ_Array_Method_Sum(PyObject *self, PyObject *other)
+{
+    return GMPy_Context_Isum(NULL, self);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_array_method_prod,
+"x.prod() -> mpz\n\n"
+"Return the product of the elements, or 1 if the array is empty. Same\n"
+"as prod(x).");
+
+static PyObject *
+GMPy_MPZ_Array_Method_Prod(PyObject *self, PyObject *other)
+{
+    return GMPy_Context_Prod(NULL, self);
+}
+
+static PyObject *
+_GMPy_MPZ_Array_MinMax(MPZ_Array_Object *self, int sign, const char *name)
+{
+    MPZ_Object *result;
+    Py_ssize_t i, best = 0;
+
+    if (self->size == 0) {
+        PyErr_Format(PyExc_ValueError, "%s() of an empty mpz_array", name);
+        return NULL;
+    }
+    if (!(result = GMPy_MPZ_New(NULL)))
+        return NULL;
+    for (i = 1; i < self->size; i++) {
+        if (mpz_cmp(self->z[i], self->z[best]) * sign > 0)
+            best = i;
+    }
+    mpz_set(result->z, self->z[best]);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_array_method_min,
+"x.min() -> mpz\n\n"
+"Return the smallest element. Raises ValueError if the array is empty.");
+
+static PyObject *
+GMPy_MPZ_Array_Method_Min(PyObject *self, PyObject *other)
+{
+    return _GMPy_MPZ_Array_MinMax((MPZ_Array_Object*)self, -1, "min");
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_array_method_max,
+"x.max() -> mpz\n\n"
+"Return the largest element. Raises ValueError if the array is empty.");
+
+static PyObject *
+GMPy_MPZ_Array_Method_Max(PyObject *self, PyObject *other)
+{
+    return _GMPy_MPZ_Array_MinMax((MPZ_Array_Object*)self, 1, "max");
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_array_method_copy,
+"x.copy() -> mpz_array\n\n"
+"Return a new mpz_array with the elements of x. Same as x[:].");
+
+static PyObject *
+GMPy_MPZ_Array_Method_Copy(PyObject *self, PyObject *other)
+{
+    PyObject *slice, *result;
+
+    if (!(slice = PySlice_New(NULL, NULL, NULL)))
+        return NULL;
+    result = PyObject_GetItem(self, slice);
+    Py_DECREF(slice);
+    return result;
+}
+
+static PyMethodDef GMPy_MPZ_Array_methods[] =
+{
+    { "__reduce__", GMPy_MPANY_Reduce_Method, METH_NOARGS, GMPy_doc_method_reduce },
+    { "__reduce_ex__", GMPy_MPANY_Reduce_Ex_Method, METH_O, GMPy_doc_method_reduce_ex },
+    { "copy", GMPy_MPZ_Array_Method_Copy, METH_NOARGS, GMPy_doc_mpz_array_method_copy },
+    { "from_binary", GMPy_MPZ_Array_Method_From_Binary, METH_O | METH_CLASS, GMPy_doc_mpz_array_method_from_binary },
+    { "max", GMPy_MPZ_Array_Method_Max, METH_NOARGS, GMPy_doc_mpz_array_method_max },
+    { "min", GMPy_MPZ_Array_Method_Min, METH_NOARGS, GMPy_doc_mpz_array_method_min },
+    { "prod", GMPy_MPZ_Array_Method_Prod, METH_NOARGS, GMPy_doc_mpz_array_method_prod },
+    { "save", GMPy_MPZ_Array_Method_Save, METH_O, GMPy_doc_mpz_array_method_save },
+    { "saved_size", GMPy_MPZ_Array_Method_Saved_Size, METH_NOARGS, GMPy_doc_mpz_array_method_saved_size },
+    { "sum", GMPy_MPZ_Array_Method_Sum, METH_NOARGS, GMPy_doc_mpz_array_method_sum },
+    { "to_binary", GMPy_MPZ_Array_Method_To_Binary, METH_NOARGS, GMPy_doc_mpz_array_method_to_binary },
+    { NULL }
+};
+
+static PyTypeObject MPZ_Array_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.mpz_array",
+    .tp_basicsize = sizeof(MPZ_Array_Object),
+    .tp_dealloc = (destructor) GMPy_MPZ_Array_Dealloc,
+    .tp_repr = (reprfunc) GMPy_MPZ_Array_Repr_Slot,
+    .tp_as_sequence = &GMPy_MPZ_Array_sequence_methods,
+    .tp_as_mapping = &GMPy_MPZ_Array_mapping_methods,
+    .tp_hash = PyObject_HashNotImplemented,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_mpz_array,
+    .tp_richcompare = GMPy_MPZ_Array_RichCompare_Slot,
+    .tp_methods = GMPy_MPZ_Array_methods,
+    .tp_new = GMPy_MPZ_Array_NewInit,
+};
+
+static PySequenceMethods GMPy_Mapped_MPZ_Array_sequence_methods = {
+    .sq_length = (lenfunc)GMPy_Mapped_MPZ_Array_Length,
+    .sq_item = (ssizeargfunc)GMPy_Mapped_MPZ_Array_Item,
+};
+
+static PyMappingMethods GMPy_Mapped_MPZ_Array_mapping_methods = {
+    (lenfunc)GMPy_Mapped_MPZ_Array_Length,
+    (binaryfunc)GMPy_Mapped_MPZ_Array_SubScript,
+    NULL
+};
+
+static PyMethodDef GMPy_Mapped_MPZ_Array_methods[] =
+{
+    { "copy", GMPy_MPZ_Array_Method_Copy, METH_NOARGS, GMPy_doc_mpz_array_method_copy },
+    { NULL }
+};
+
+static PyTypeObject Mapped_MPZ_Array_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.mapped_mpz_array",
+    .tp_basicsize = sizeof(Mapped_MPZ_Array_Object),
+    .tp_dealloc = (destructor) GMPy_Mapped_MPZ_Array_Dealloc,
+    .tp_as_sequence = &GMPy_Mapped_MPZ_Array_sequence_methods,
+    .tp_as_mapping = &GMPy_Mapped_MPZ_Array_mapping_methods,
+    .tp_hash = PyObject_HashNotImplemented,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Read-only mpz_array backed by a file or buffer written by mpz_array.save().",
+    .tp_methods = GMPy_Mapped_MPZ_Array_methods,
+};
@@ -0,0 +1,80 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mpz_array.h                                                       *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_MPZ_ARRAY_H
+#define GMPY_MPZ_ARRAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An mpz_array stores a fixed number of mpz_t values in one block of
+ * memory. The elements are not Python objects; indexing returns a new mpz.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    Py_ssize_t size;
+    mpz_t *z;
+} MPZ_Array_Object;
+
+static PyTypeObject MPZ_Array_Type;
+#define MPZ_Array_Check(v) (((PyObject*)v)->ob_type == &MPZ_Array_Type)
+
+static MPZ_Array_Object * GMPy_MPZ_Array_New(Py_ssize_t size);
+static PyObject *         GMPy_MPZ_Array_To_Binary(MPZ_Array_Object *self);
+static PyObject *         GMPy_MPZ_Array_From_Binary(unsigned char *buffer, Py_ssize_t len);
+
+/* A Mapped_MPZ_Array reads the elements of a file written by
+ * mpz_array.save() directly from a buffer, usually an mmap. Each element
+ * is converted to an mpz when it is accessed.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    Py_ssize_t size;
+    PyObject *source;           /* object that exports view */
+    Py_buffer view;
+    unsigned char *index;       /* size+1 limb offsets, 8 bytes each */
+    unsigned char *signs;       /* size sign bytes */
+    unsigned char *data;        /* 64-bit little-endian limbs */
+    size_t limbs;               /* number of limbs in data */
+} Mapped_MPZ_Array_Object;
+
+static PyTypeObject Mapped_MPZ_Array_Type;
+
+static PyObject *         GMPy_MPZ_Array_Load(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject *         _GMPy_Read_File(PyObject *path, int use_mmap);
+
+/* Little-endian lengths of 4 or 8 bytes used by the binary formats. */
+
+static void               _GMPy_Binary_Put_Size(char *buffer, size_t value, size_t sizesize);
+static size_t             _GMPy_Binary_Get_Size(unsigned char *buffer, size_t sizesize);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -479,6 +479,224 @@ GMPy_MPZ_bit_flip_method(PyObject *self, PyObject *other)
     return (PyObject*)result;
 }
 
+/* Bit fields.
+ *
+ * A field holds the bits start .. start + len - 1 of x, using the infinite
+ * 2's complement format for x < 0. For x >= 0 the limbs are shifted and
+ * masked directly and the result is allocated once, instead of testing and
+ * setting one bit at a time.
+ */
+
+/* Set r to the field of x as a value 0 <= r < 2**len. r must not be x. */
+
+static void
+_GMPy_MPZ_Get_Bits(mpz_ptr r, mpz_srcptr x, mp_bitcnt_t start, mp_bitcnt_t len)
+{
+    mp_size_t size = mpz_size(x), pos = start / GMP_NUMB_BITS, rn, sn;
+    unsigned int shift = start % GMP_NUMB_BITS;
+    mp_ptr rp;
+
+    if (mpz_sgn(x) < 0) {
+        mpz_fdiv_q_2exp(r, x, start);
+        mpz_fdiv_r_2exp(r, r, len);
+        return;
+    }
+    if (len == 0 || pos >= size) {
+        mpz_set_ui(r, 0);
+        return;
+    }
+
+    /* One more source limb is needed if the field is not aligned. */
+
+    rn = (len - 1) / GMP_NUMB_BITS + 1;
+    sn = Py_MIN(size - pos, rn + (shift != 0));
+    rp = mpz_limbs_write(r, sn);
+    if (shift)
+        mpn_rshift(rp, mpz_limbs_read(x) + pos, sn, shift);
+    else
+        mpn_copyi(rp, mpz_limbs_read(x) + pos, sn);
+    if (sn >= rn) {
+        sn = rn;
+        if (len % GMP_NUMB_BITS)
+            rp[rn - 1] &= ((mp_limb_t)1 << (len % GMP_NUMB_BITS)) - 1;
+    }
+    mpz_limbs_finish(r, sn);
+}
+
+/* Set r to the bits 0, step, 2*step, ... of t >= 0, len of them, in
+ * reverse order if rev is set. r must not be t.
+ */
+
+static void
+_GMPy_MPZ_Gather_Bits(mpz_ptr r, mpz_srcptr t, mp_bitcnt_t step,
+                      mp_bitcnt_t len, int rev)
+{
+    mp_size_t tn = mpz_size(t), rn;
+    mp_srcptr tp = mpz_limbs_read(t);
+    mp_bitcnt_t i, cur;
+    mp_ptr rp;
+
+    if (len == 0) {
+        mpz_set_ui(r, 0);
+        return;
+    }
+    rn = (len - 1) / GMP_NUMB_BITS + 1;
+    rp = mpz_limbs_write(r, rn);
+    mpn_zero(rp, rn);
+    for (i = 0; i < len; i++) {
+        cur = (rev ? len - 1 - i : i) * step;
+        if ((mp_size_t)(cur / GMP_NUMB_BITS) < tn &&
+            (tp[cur / GMP_NUMB_BITS] >> (cur % GMP_NUMB_BITS)) & 1) {
+            rp[i / GMP_NUMB_BITS] |= (mp_limb_t)1 << (i % GMP_NUMB_BITS);
+        }
+    }
+    mpz_limbs_finish(r, rn);
+}
+
+/* Set r to the bits start, start + step, ... of x, len of them. step may
+ * be negative. r must not be x.
+ */
+
+static void
+_GMPy_MPZ_Slice_Bits(mpz_ptr r, mpz_srcptr x, Py_ssize_t start,
+                     Py_ssize_t step, Py_ssize_t len)
+{
+    mpz_t t;
+
+    if (step == 1) {
+        _GMPy_MPZ_Get_Bits(r, x, start, len);
+        return;
+    }
+    if (len <= 0) {
+        mpz_set_ui(r, 0);
+        return;
+    }
+    mpz_init(t);
+    if (step > 0) {
+        _GMPy_MPZ_Get_Bits(t, x, start, (len - 1) * step + 1);
+        _GMPy_MPZ_Gather_Bits(r, t, step, len, 0);
+    }
+    else {
+        _GMPy_MPZ_Get_Bits(t, x, start + (len - 1) * step, (len - 1) * -step + 1);
+        _GMPy_MPZ_Gather_Bits(r, t, -step, len, 1);
+    }
+    mpz_clear(t);
+}
+
+/* Set the bits start, start + step, ... of x, len of them, to the bits of
+ * v. step may be negative. v must not be x.
+ */
+
+static void
+_GMPy_MPZ_Set_Slice_Bits(mpz_ptr x, Py_ssize_t start, Py_ssize_t step,
+                         Py_ssize_t len, mpz_srcptr v)
+{
+    mp_size_t size, xn, un, i, first, last;
+    mp_bitcnt_t lo, hi, cur, bit;
+    mp_limb_t mask, w;
+    mp_srcptr up;
+    mp_ptr xp;
+    mpz_t t, u;
+
+    if (len <= 0)
+        return;
+
+    mpz_init(t);
+    mpz_init(u);
+    mpz_fdiv_r_2exp(t, v, len);
+
+    if (mpz_sgn(x) < 0) {
+        if (step == 1) {
+            /* x += (t - field) << start */
+            _GMPy_MPZ_Get_Bits(u, x, start, len);
+            mpz_sub(t, t, u);
+            mpz_mul_2exp(t, t, start);
+            mpz_add(x, x, t);
+        }
+        else {
+            for (i = 0, cur = start; i < len; i++, cur += step) {
+                if (mpz_tstbit(t, i))
+                    mpz_setbit(x, cur);
+                else
+                    mpz_clrbit(x, cur);
+            }
+        }
+        mpz_clear(t);
+        mpz_clear(u);
+        return;
+    }
+
+    lo = step > 0 ? start : start + (len - 1) * step;
+    hi = step > 0 ? start + (len - 1) * step : start;
+    size = mpz_size(x);
+    xn = Py_MAX(size, (mp_size_t)(hi / GMP_NUMB_BITS) + 1);
+    xp = mpz_limbs_modify(x, xn);
+    if (xn > size)
+        mpn_zero(xp + size, xn - size);
+
+    if (step == 1) {
+        /* Shift the field into place and merge it one limb at a time. */
+        mpz_mul_2exp(u, t, lo % GMP_NUMB_BITS);
+        up = mpz_limbs_read(u);
+        un = mpz_size(u);
+        first = lo / GMP_NUMB_BITS;
+        last = hi / GMP_NUMB_BITS;
+        for (i = first; i <= last; i++) {
+            mask = GMP_NUMB_MAX;
+            if (i == first)
+                mask &= GMP_NUMB_MAX << (lo % GMP_NUMB_BITS);
+            if (i == last && (hi + 1) % GMP_NUMB_BITS)
+                mask &= ((mp_limb_t)1 << ((hi + 1) % GMP_NUMB_BITS)) - 1;
+            w = i - first < un ? up[i - first] : 0;
+            xp[i] = (xp[i] & ~mask) | (w & mask);
+        }
+    }
+    else {
+        up = mpz_limbs_read(t);
+        un = mpz_size(t);
+        for (i = 0, cur = start; i < len; i++, cur += step) {
+            bit = (mp_size_t)(i / GMP_NUMB_BITS) < un &&
+                  (up[i / GMP_NUMB_BITS] >> (i % GMP_NUMB_BITS)) & 1;
+            mask = (mp_limb_t)1 << (cur % GMP_NUMB_BITS);
+            if (bit)
+                xp[cur / GMP_NUMB_BITS] |= mask;
+            else
+                xp[cur / GMP_NUMB_BITS] &= ~mask;
+        }
+    }
+    mpz_limbs_finish(x, xn);
+    mpz_clear(t);
+    mpz_clear(u);
+}
+
+PyDoc_STRVAR(doc_bits_method,
+"x.bits(start, length, /) -> mpz\n\n"
+"Return the length bits of x beginning at bit start as an mpz >= 0,\n"
+"equal to (x >> start) % 2**length and to x[start:start+length] for\n"
+"x >= 0. A negative x uses the infinite 2's complement format.");
+
+static PyObject *
+GMPy_MPZ_bits_method(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    mp_bitcnt_t start, len;
+    MPZ_Object *result;
+
+    if (nargs != 2) {
+        TYPE_ERROR("bits() requires 2 arguments");
+        return NULL;
+    }
+    start = GMPy_Integer_AsMpBitCnt(args[0]);
+    if (start == (mp_bitcnt_t)(-1) && PyErr_Occurred())
+        return NULL;
+    len = GMPy_Integer_AsMpBitCnt(args[1]);
+    if (len == (mp_bitcnt_t)(-1) && PyErr_Occurred())
+        return NULL;
+
+    if ((result = GMPy_MPZ_New(NULL)))
+        _GMPy_MPZ_Get_Bits(result->z, MPZ(self), start, len);
+    return (PyObject*)result;
+}
+
 static PyObject *
 GMPy_MPZ_Invert_Slot(MPZ_Object *self)
 {
@@ -502,13 +720,13 @@ GMPy_MPZ_And_Slot(PyObject *self, PyObject *other)
             mpz_and(result->z, MPZ(self), MPZ(other));
         }
         else {
-            if (!(result = GMPy_MPZ_From_Integer(other, NULL)))
+            if (!(result = GMPy_MPZ_From_IntegerAndCopy(other, NULL)))
                 return NULL;
             mpz_and(result->z, MPZ(self), result->z);
         }
     }
     else if (CHECK_MPZANY(other)) {
-        if (!(result = GMPy_MPZ_From_Integer(self, NULL)))
+        if (!(result = GMPy_MPZ_From_IntegerAndCopy(self, NULL)))
             return NULL;
         mpz_and(result->z, result->z, MPZ(other));
     }
@@ -532,13 +750,13 @@ GMPy_MPZ_Ior_Slot(PyObject *self, PyObject *other)
             mpz_ior(result->z, MPZ(self), MPZ(other));
         }
         else {
-            if (!(result = GMPy_MPZ_From_Integer(other, NULL)))
+            if (!(result = GMPy_MPZ_From_IntegerAndCopy(other, NULL)))
                 return NULL;
             mpz_ior(result->z, MPZ(self), result->z);
         }
     }
     else if (CHECK_MPZANY(other)) {
-        if (!(result = GMPy_MPZ_From_Integer(self, NULL)))
+        if (!(result = GMPy_MPZ_From_IntegerAndCopy(self, NULL)))
             return NULL;
         mpz_ior(result->z, result->z, MPZ(other));
     }
@@ -562,13 +780,13 @@ GMPy_MPZ_Xor_Slot(PyObject *self, PyObject *other)
             mpz_xor(result->z, MPZ(self), MPZ(other));
         }
         else {
-            if (!(result = GMPy_MPZ_From_Integer(other, NULL)))
+            if (!(result = GMPy_MPZ_From_IntegerAndCopy(other, NULL)))
                 return NULL;
             mpz_xor(result->z, MPZ(self), result->z);
         }
     }
     else if (CHECK_MPZANY(other)) {
-        if (!(result = GMPy_MPZ_From_Integer(self, NULL)))
+        if (!(result = GMPy_MPZ_From_IntegerAndCopy(self, NULL)))
             return NULL;
         mpz_xor(result->z, result->z, MPZ(other));
     }
@@ -47,6 +47,7 @@ static PyObject * GMPy_MPZ_bit_set_function(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_bit_set_method(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_bit_flip_function(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_bit_flip_method(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_bits_method(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
 
 static PyObject * GMPy_MPZ_popcount(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_hamdist(PyObject *self, PyObject *args);
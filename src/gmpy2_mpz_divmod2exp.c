@@ -46,7 +46,9 @@ GMPy_MPZ_c_divmod_2exp(PyObject *self, PyObject *args)
 {
     mp_bitcnt_t nbits;
     PyObject *result = NULL;
-    MPZ_Object *q = NULL, *r = NULL, *tempx = NULL;
+    MPZ_Object *q = NULL, *r = NULL;
+    mpz_srcptr x;
+    int mark;
 
     if (PyTuple_GET_SIZE(args) != 2) {
         TYPE_ERROR("c_divmod_2exp() requires 'mpz','int' arguments");
@@ -58,22 +60,26 @@ GMPy_MPZ_c_divmod_2exp(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    if (!(tempx = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL)) ||
-        !(q = GMPy_MPZ_New(NULL)) ||
-        !(r = GMPy_MPZ_New(NULL)) ||
-        !(result = PyTuple_New(2))) {
-
+    mark = _GMPy_Scratch_Mark();
+    if (!(x = GMPy_MPZ_Scratch_From_Integer(PyTuple_GET_ITEM(args, 0)))) {
+        _GMPy_Scratch_Release(mark);
+        return NULL;
+    }
+    q = GMPy_MPZ_New(NULL);
+    r = GMPy_MPZ_New(NULL);
+    result = PyTuple_New(2);
+    if (!q || !r || !result) {
         Py_XDECREF(result);
-        Py_XDECREF((PyObject*)tempx);
         Py_XDECREF((PyObject*)q);
         Py_XDECREF((PyObject*)r);
+        _GMPy_Scratch_Release(mark);
         return NULL;
     }
 
-    mpz_cdiv_q_2exp(q->z, tempx->z, nbits);
-    mpz_cdiv_r_2exp(r->z, tempx->z, nbits);
+    mpz_cdiv_q_2exp(q->z, x, nbits);
+    mpz_cdiv_r_2exp(r->z, x, nbits);
+    _GMPy_Scratch_Release(mark);
 
-    Py_DECREF((PyObject*)tempx);
     PyTuple_SET_ITEM(result, 0, (PyObject*)q);
     PyTuple_SET_ITEM(result, 1, (PyObject*)r);
     return result;
@@ -88,7 +94,9 @@ static PyObject *
 GMPy_MPZ_c_div_2exp(PyObject *self, PyObject *args)
 {
     mp_bitcnt_t nbits;
-    MPZ_Object *result, *tempx;
+    MPZ_Object *result;
+    mpz_srcptr x;
+    int mark;
 
     if (PyTuple_GET_SIZE(args) != 2) {
         TYPE_ERROR("c_div_2exp() requires 'mpz','int' arguments");
@@ -100,16 +108,15 @@ GMPy_MPZ_c_div_2exp(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    tempx = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    result = GMPy_MPZ_New(NULL);
-    if (!tempx || !result) {
-        Py_XDECREF((PyObject*)result);
-        Py_XDECREF((PyObject*)tempx);
+    mark = _GMPy_Scratch_Mark();
+    if (!(x = GMPy_MPZ_Scratch_From_Integer(PyTuple_GET_ITEM(args, 0))) ||
+        !(result = GMPy_MPZ_New(NULL))) {
+        _GMPy_Scratch_Release(mark);
         return NULL;
     }
 
-    mpz_cdiv_q_2exp(result->z, tempx->z, nbits);
-    Py_DECREF((PyObject*)tempx);
+    mpz_cdiv_q_2exp(result->z, x, nbits);
+    _GMPy_Scratch_Release(mark);
     return (PyObject*)result;
 }
 
@@ -122,7 +129,9 @@ static PyObject *
 GMPy_MPZ_c_mod_2exp(PyObject *self, PyObject *args)
 {
     mp_bitcnt_t nbits;
-    MPZ_Object *result, *tempx;
+    MPZ_Object *result;
+    mpz_srcptr x;
+    int mark;
 
     if (PyTuple_GET_SIZE(args) != 2) {
         TYPE_ERROR("c_mod_2exp() requires 'mpz','int' arguments");
@@ -134,16 +143,15 @@ GMPy_MPZ_c_mod_2exp(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    tempx = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    result = GMPy_MPZ_New(NULL);
-    if (!tempx || !result) {
-        Py_XDECREF((PyObject*)result);
-        Py_XDECREF((PyObject*)tempx);
+    mark = _GMPy_Scratch_Mark();
+    if (!(x = GMPy_MPZ_Scratch_From_Integer(PyTuple_GET_ITEM(args, 0))) ||
+        !(result = GMPy_MPZ_New(NULL))) {
+        _GMPy_Scratch_Release(mark);
         return NULL;
     }
 
-    mpz_cdiv_r_2exp(result->z, tempx->z, nbits);
-    Py_DECREF((PyObject*)tempx);
+    mpz_cdiv_r_2exp(result->z, x, nbits);
+    _GMPy_Scratch_Release(mark);
     return (PyObject*)result;
 }
 
@@ -164,7 +172,9 @@ GMPy_MPZ_f_divmod_2exp(PyObject *self, PyObject *args)
 {
     mp_bitcnt_t nbits;
     PyObject *result;
-    MPZ_Object *q, *r, *tempx;
+    MPZ_Object *q, *r;
+    mpz_srcptr x;
+    int mark;
 
     if (PyTuple_GET_SIZE(args) != 2) {
         TYPE_ERROR("f_divmod_2exp() requires 'mpz','int' arguments");
@@ -176,22 +186,26 @@ GMPy_MPZ_f_divmod_2exp(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    tempx = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
+    mark = _GMPy_Scratch_Mark();
+    if (!(x = GMPy_MPZ_Scratch_From_Integer(PyTuple_GET_ITEM(args, 0)))) {
+        _GMPy_Scratch_Release(mark);
+        return NULL;
+    }
     q = GMPy_MPZ_New(NULL);
     r = GMPy_MPZ_New(NULL);
     result = PyTuple_New(2);
-    if (!tempx || !q || !r || !result) {
+    if (!q || !r || !result) {
         Py_XDECREF(result);
-        Py_XDECREF((PyObject*)tempx);
         Py_XDECREF((PyObject*)q);
         Py_XDECREF((PyObject*)r);
+        _GMPy_Scratch_Release(mark);
         return NULL;
     }
 
-    mpz_fdiv_q_2exp(q->z, tempx->z, nbits);
-    mpz_fdiv_r_2exp(r->z, tempx->z, nbits);
+    mpz_fdiv_q_2exp(q->z, x, nbits);
+    mpz_fdiv_r_2exp(r->z, x, nbits);
+    _GMPy_Scratch_Release(mark);
 
-    Py_DECREF((PyObject*)tempx);
     PyTuple_SET_ITEM(result, 0, (PyObject*)q);
     PyTuple_SET_ITEM(result, 1, (PyObject*)r);
     return result;
@@ -206,7 +220,9 @@ static PyObject *
 GMPy_MPZ_f_div_2exp(PyObject *self, PyObject *args)
 {
     mp_bitcnt_t nbits;
-    MPZ_Object *result, *tempx;
+    MPZ_Object *result;
+    mpz_srcptr x;
+    int mark;
 
     if (PyTuple_GET_SIZE(args) != 2) {
         TYPE_ERROR("f_div_2exp() requires 'mpz','int' arguments");
@@ -218,16 +234,15 @@ GMPy_MPZ_f_div_2exp(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    tempx = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    result = GMPy_MPZ_New(NULL);
-    if (!tempx || !result) {
-        Py_XDECREF((PyObject*)result);
-        Py_XDECREF((PyObject*)tempx);
+    mark = _GMPy_Scratch_Mark();
+    if (!(x = GMPy_MPZ_Scratch_From_Integer(PyTuple_GET_ITEM(args, 0))) ||
+        !(result = GMPy_MPZ_New(NULL))) {
+        _GMPy_Scratch_Release(mark);
         return NULL;
     }
 
-    mpz_fdiv_q_2exp(result->z, tempx->z, nbits);
-    Py_DECREF((PyObject*)tempx);
+    mpz_fdiv_q_2exp(result->z, x, nbits);
+    _GMPy_Scratch_Release(mark);
     return (PyObject*)result;
 }
 
@@ -240,7 +255,9 @@ static PyObject *
 GMPy_MPZ_f_mod_2exp(PyObject *self, PyObject *args)
 {
     mp_bitcnt_t nbits;
-    MPZ_Object *result, *tempx;
+    MPZ_Object *result;
+    mpz_srcptr x;
+    int mark;
 
     if (PyTuple_GET_SIZE(args) != 2) {
         TYPE_ERROR("f_mod_2exp() requires 'mpz','int' arguments");
@@ -252,16 +269,15 @@ GMPy_MPZ_f_mod_2exp(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    tempx = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    result = GMPy_MPZ_New(NULL);
-    if (!tempx || !result) {
-        Py_XDECREF((PyObject*)result);
-        Py_XDECREF((PyObject*)tempx);
+    mark = _GMPy_Scratch_Mark();
+    if (!(x = GMPy_MPZ_Scratch_From_Integer(PyTuple_GET_ITEM(args, 0))) ||
+        !(result = GMPy_MPZ_New(NULL))) {
+        _GMPy_Scratch_Release(mark);
         return NULL;
     }
 
-    mpz_fdiv_r_2exp(result->z, tempx->z, nbits);
-    Py_DECREF((PyObject*)tempx);
+    mpz_fdiv_r_2exp(result->z, x, nbits);
+    _GMPy_Scratch_Release(mark);
     return (PyObject*)result;
 }
 
@@ -281,7 +297,9 @@ static PyObject *
 GMPy_MPZ_t_divmod_2exp(PyObject *self, PyObject *args)
 {
     mp_bitcnt_t nbits;
-    MPZ_Object *q, *r, *tempx;
+    MPZ_Object *q, *r;
+    mpz_srcptr x;
+    int mark;
     PyObject *result;
 
     if (PyTuple_GET_SIZE(args) != 2) {
@@ -294,22 +312,26 @@ GMPy_MPZ_t_divmod_2exp(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    tempx = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
+    mark = _GMPy_Scratch_Mark();
+    if (!(x = GMPy_MPZ_Scratch_From_Integer(PyTuple_GET_ITEM(args, 0)))) {
+        _GMPy_Scratch_Release(mark);
+        return NULL;
+    }
     q = GMPy_MPZ_New(NULL);
     r = GMPy_MPZ_New(NULL);
     result = PyTuple_New(2);
-    if (!tempx || !q || !r || !result) {
+    if (!q || !r || !result) {
         Py_XDECREF(result);
-        Py_XDECREF((PyObject*)tempx);
         Py_XDECREF((PyObject*)q);
         Py_XDECREF((PyObject*)r);
+        _GMPy_Scratch_Release(mark);
         return NULL;
     }
 
-    mpz_tdiv_q_2exp(q->z, tempx->z, nbits);
-    mpz_tdiv_r_2exp(r->z, tempx->z, nbits);
+    mpz_tdiv_q_2exp(q->z, x, nbits);
+    mpz_tdiv_r_2exp(r->z, x, nbits);
+    _GMPy_Scratch_Release(mark);
 
-    Py_DECREF((PyObject*)tempx);
     PyTuple_SET_ITEM(result, 0, (PyObject*)q);
     PyTuple_SET_ITEM(result, 1, (PyObject*)r);
     return result;
@@ -324,7 +346,9 @@ static PyObject *
 GMPy_MPZ_t_div_2exp(PyObject *self, PyObject *args)
 {
     mp_bitcnt_t nbits;
-    MPZ_Object *result, *tempx;
+    MPZ_Object *result;
+    mpz_srcptr x;
+    int mark;
 
     if (PyTuple_GET_SIZE(args) != 2) {
         TYPE_ERROR("t_div_2exp() requires 'mpz','int' arguments");
@@ -336,16 +360,15 @@ GMPy_MPZ_t_div_2exp(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    tempx = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    result = GMPy_MPZ_New(NULL);
-    if (!tempx || !result) {
-        Py_XDECREF((PyObject*)result);
-        Py_XDECREF((PyObject*)tempx);
+    mark = _GMPy_Scratch_Mark();
+    if (!(x = GMPy_MPZ_Scratch_From_Integer(PyTuple_GET_ITEM(args, 0))) ||
+        !(result = GMPy_MPZ_New(NULL))) {
+        _GMPy_Scratch_Release(mark);
         return NULL;
     }
 
-    mpz_tdiv_q_2exp(result->z, tempx->z, nbits);
-    Py_DECREF((PyObject*)tempx);
+    mpz_tdiv_q_2exp(result->z, x, nbits);
+    _GMPy_Scratch_Release(mark);
     return (PyObject*)result;
 }
 
@@ -358,7 +381,9 @@ static PyObject *
 GMPy_MPZ_t_mod_2exp(PyObject *self, PyObject *args)
 {
     mp_bitcnt_t nbits;
-    MPZ_Object *result, *tempx;
+    MPZ_Object *result;
+    mpz_srcptr x;
+    int mark;
 
     if (PyTuple_GET_SIZE(args) != 2) {
         TYPE_ERROR("t_mod_2exp() requires 'mpz','int' arguments");
@@ -370,15 +395,14 @@ GMPy_MPZ_t_mod_2exp(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    tempx = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    result = GMPy_MPZ_New(NULL);
-    if (!tempx || !result) {
-        Py_XDECREF((PyObject*)result);
-        Py_XDECREF((PyObject*)tempx);
+    mark = _GMPy_Scratch_Mark();
+    if (!(x = GMPy_MPZ_Scratch_From_Integer(PyTuple_GET_ITEM(args, 0))) ||
+        !(result = GMPy_MPZ_New(NULL))) {
+        _GMPy_Scratch_Release(mark);
         return NULL;
     }
 
-    mpz_tdiv_r_2exp(result->z, tempx->z, nbits);
-    Py_DECREF((PyObject*)tempx);
+    mpz_tdiv_r_2exp(result->z, x, nbits);
+    _GMPy_Scratch_Release(mark);
     return (PyObject*)result;
 }
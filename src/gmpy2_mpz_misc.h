@@ -42,12 +42,15 @@ static PyObject * GMPy_MPZ_Attrib_GetImag(MPZ_Object *self, void *closure);
 static PyObject * GMPy_MPZ_Method_As_Integer_Ratio(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Method_To_Bytes(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames);
 static PyObject * GMPy_MPZ_Method_From_Bytes(PyTypeObject *type, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames);
+static PyObject * GMPy_MPZ_Method_Write_Digits(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_Method_From_Digits_File(PyObject *type, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_Function_From_Strings(PyObject *self, PyObject *args, PyObject *keywds);
 
 static PyObject * GMPy_MPZ_Method_Ceil(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Method_Floor(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Method_Trunc(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Method_Round(PyObject *self, PyObject *other);
-static PyObject * GMPy_MPZ_Method_NumDigits(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Method_NumDigits(PyObject *self, PyObject *args, PyObject *keywds);
 static Py_ssize_t GMPy_MPZ_Method_Length(MPZ_Object *self);
 static PyObject * GMPy_MPZ_Method_SubScript(MPZ_Object *self, PyObject *item);
 static PyObject * GMPy_MPZ_Method_IsSquare(PyObject *self, PyObject *other);
@@ -60,23 +63,38 @@ static PyObject * GMPy_MPZ_Method_IsEven(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Method_IsOdd(PyObject *self, PyObject *other);
 static PyObject * GMPy_MP_Method_Conjugate(PyObject *self, PyObject *args);
 
-static PyObject * GMPy_MPZ_Function_NumDigits(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_NumDigits(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_Function_ILog(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Function_Iroot(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Function_IrootRem(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Function_Bincoef(PyObject *self, PyObject *args);
-static PyObject * GMPy_MPZ_Function_GCD(PyObject *self, PyObject * const *args, Py_ssize_t nargs);
-static PyObject * GMPy_MPZ_Function_LCM(PyObject *self, PyObject * const *args, Py_ssize_t nargs);
+static PyObject * GMPy_MPZ_Function_Bincoef_Row(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_GCD(PyObject *self, PyObject * const *args, Py_ssize_t nargs, PyObject *kwnames);
+static PyObject * GMPy_MPZ_Function_LCM(PyObject *self, PyObject * const *args, Py_ssize_t nargs, PyObject *kwnames);
 static PyObject * GMPy_MPZ_Function_GCDext(PyObject *self, PyObject *args);
+
+/* Leading bits of the remainders used by Lehmer's algorithm, and the
+ * largest number of quotients it finds at a time.
+ */
+
+#define GMPY_LEHMER_BITS (8 * (int)sizeof(long) - 2)
+#define GMPY_LEHMER_MAXQ (2 * GMPY_LEHMER_BITS)
+
+static int _GMPy_Lehmer_Matrix(mpz_srcptr a, mpz_srcptr b, long m[4], unsigned long *q, mpz_ptr temp);
+static void _GMPy_Lehmer_Apply(mpz_ptr x, mpz_ptr y, const long m[4], mpz_ptr u, mpz_ptr v);
 static PyObject * GMPy_MPZ_Function_Divm(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Function_Fac(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Function_Primorial(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_Fac_Mod(PyObject *self, PyObject *args);
+static PyObject * GMPy_Fac_Cache_Info(PyObject *self, PyObject *args);
+static PyObject * GMPy_Set_Fac_Cache(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Function_DoubleFac(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Function_MultiFac(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Function_Fib(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Function_Fib2(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Function_Lucas(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Function_Lucas2(PyObject *self, PyObject *other);
-static PyObject * GMPy_MPZ_Function_Isqrt(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_Isqrt(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames);
 static PyObject * GMPy_MPZ_Function_IsqrtRem(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Function_Remove(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Function_Invert(PyObject *self, PyObject *args);
@@ -94,7 +112,14 @@ static PyObject * GMPy_MPZ_Function_PrevPrime(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Function_Jacobi(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Function_Legendre(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Function_Kronecker(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_Jacobi_List(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_Legendre_List(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_Kronecker_List(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Function_IsEven(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_IsSquareList(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_IsPowerList(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_IsqrtList(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_IrootList(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_Function_IsOdd(PyObject *self, PyObject *other);
 
 
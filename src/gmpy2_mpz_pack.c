@@ -243,3 +243,422 @@ GMPy_MPZ_unpack(PyObject *self, PyObject *args)
     mpz_clear(temp);
     return result;
 }
+
+/* pack_buffer() and unpack_buffer() work on buffers of unsigned 64-bit
+ * fields, such as array('Q') or a numpy uint64 array. The fields are
+ * packed into an array of 64-bit words that is converted with one call to
+ * mpz_import(), and unpack_buffer() extracts them from the words written by
+ * mpz_export().
+ */
+
+static int
+_GMPy_Pack_Get_Buffer(PyObject *obj, Py_buffer *view, int flags, const char *name)
+{
+    const char *format;
+
+    if (PyObject_GetBuffer(obj, view, flags | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0) {
+        if ((flags & PyBUF_WRITABLE) && PyErr_ExceptionMatches(PyExc_BufferError)) {
+            PyErr_Clear();
+            PyErr_Format(PyExc_TypeError, "%s() requires a writable buffer", name);
+        }
+        return -1;
+    }
+    format = view->format ? view->format : "B";
+    if (*format == '@' || *format == '=' || *format == '<')
+        format++;
+    if (view->itemsize != 8 || (strcmp(format, "Q") && strcmp(format, "L"))) {
+        PyBuffer_Release(view);
+        PyErr_Format(PyExc_TypeError, "%s() requires a buffer of unsigned 64-bit integers", name);
+        return -1;
+    }
+    return 0;
+}
+
+PyDoc_STRVAR(doc_pack_buffer,
+"pack_buffer(buffer, n, /) -> mpz\n\n"
+"Pack the unsigned 64-bit integers in buffer, such as an array('Q')\n"
+"or a numpy uint64 array, into a single `mpz` like `pack()`. Each\n"
+"field uses n bits, 1 <= n <= 64, and must be less than 2**n.");
+
+static PyObject *
+GMPy_MPZ_pack_buffer(PyObject *self, PyObject *args)
+{
+    PyObject *obj;
+    Py_buffer view;
+    Py_ssize_t count, k, nwords;
+    unsigned long nbits;
+    uint64_t *fields, *words, v;
+    size_t pos, w, off;
+    MPZ_Object *result = NULL;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTuple(args, "Ok", &obj, &nbits))
+        return NULL;
+    if (nbits < 1 || nbits > 64) {
+        VALUE_ERROR("pack_buffer() requires 1 <= n <= 64");
+        return NULL;
+    }
+    if (_GMPy_Pack_Get_Buffer(obj, &view, PyBUF_SIMPLE, "pack_buffer") < 0)
+        return NULL;
+
+    fields = (uint64_t*)view.buf;
+    count = view.len / 8;
+    for (k = 0; k < count; k++) {
+        if (nbits < 64 && (fields[k] >> nbits)) {
+            VALUE_ERROR("pack_buffer() requires fields < 2^n");
+            goto done;
+        }
+    }
+
+    nwords = (Py_ssize_t)(((size_t)count * nbits + 63) / 64);
+    if (!(words = PyMem_Calloc(nwords ? nwords : 1, sizeof(uint64_t)))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    if (!(result = GMPy_MPZ_New(context))) {
+        PyMem_Free(words);
+        goto done;
+    }
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)nwords * 64);
+    for (k = 0, pos = 0; k < count; k++, pos += nbits) {
+        v = fields[k];
+        w = pos / 64;
+        off = pos % 64;
+        words[w] |= v << off;
+        if (off + nbits > 64)
+            words[w + 1] |= v >> (64 - off);
+    }
+    mpz_import(result->z, (size_t)nwords, -1, sizeof(uint64_t), 0, 0, words);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    PyMem_Free(words);
+
+  done:
+    PyBuffer_Release(&view);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(doc_unpack_buffer,
+"unpack_buffer(x, n, out, /) -> int\n\n"
+"Unpack an integer x >= 0 into n-bit fields like `unpack()`, writing\n"
+"them to out, a writable buffer of unsigned 64-bit integers. n must\n"
+"satisfy 1 <= n <= 64. Return the number of fields written; the other\n"
+"elements of out are not changed. Raises `ValueError` if out is too\n"
+"small.");
+
+static PyObject *
+GMPy_MPZ_unpack_buffer(PyObject *self, PyObject *args)
+{
+    PyObject *obj, *other, *result = NULL;
+    Py_buffer view;
+    Py_ssize_t count, k;
+    unsigned long nbits;
+    uint64_t *fields, *words, v;
+    size_t pos, w, off, nwords = 0, total_bits;
+    MPZ_Object *tempx;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTuple(args, "OkO", &obj, &nbits, &other))
+        return NULL;
+    if (nbits < 1 || nbits > 64) {
+        VALUE_ERROR("unpack_buffer() requires 1 <= n <= 64");
+        return NULL;
+    }
+    if (!(tempx = GMPy_MPZ_From_Integer(obj, context)))
+        return NULL;
+    if (mpz_sgn(tempx->z) < 0) {
+        VALUE_ERROR("unpack_buffer() requires x >= 0");
+        Py_DECREF((PyObject*)tempx);
+        return NULL;
+    }
+    if (_GMPy_Pack_Get_Buffer(other, &view, PyBUF_WRITABLE, "unpack_buffer") < 0) {
+        Py_DECREF((PyObject*)tempx);
+        return NULL;
+    }
+
+    /* Like unpack(), 0 is unpacked into one field. */
+
+    total_bits = mpz_sgn(tempx->z) ? mpz_sizeinbase(tempx->z, 2) : 1;
+    count = (Py_ssize_t)((total_bits + nbits - 1) / nbits);
+    if (count > view.len / 8) {
+        VALUE_ERROR("unpack_buffer() output buffer is too small");
+        goto done;
+    }
+
+    if (!(words = PyMem_Calloc((total_bits + 63) / 64 + 1, sizeof(uint64_t)))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    fields = (uint64_t*)view.buf;
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, total_bits);
+    mpz_export(words, &nwords, -1, sizeof(uint64_t), 0, 0, tempx->z);
+    for (k = 0, pos = 0; k < count; k++, pos += nbits) {
+        w = pos / 64;
+        off = pos % 64;
+        v = words[w] >> off;
+        if (off + nbits > 64)
+            v |= words[w + 1] << (64 - off);
+        fields[k] = nbits < 64 ? v & (((uint64_t)1 << nbits) - 1) : v;
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    PyMem_Free(words);
+    result = PyLong_FromSsize_t(count);
+
+  done:
+    PyBuffer_Release(&view);
+    Py_DECREF((PyObject*)tempx);
+    return result;
+}
+
+
+/* poly_mul() multiplies integer polynomials by Kronecker substitution. Each
+ * coefficient is placed in a k-bit field of a single mpz, the two integers
+ * are multiplied with one call to mpz_mul(), and the coefficients of the
+ * product are read back from the fields. k is chosen so that every
+ * coefficient of the product fits in k - 1 bits plus a sign.
+ *
+ * Signed coefficients are handled by packing the positive and the negative
+ * coefficients separately and subtracting. Before unpacking, 2**(k-1) is
+ * added to every field of the product so all fields are non-negative and
+ * no borrows cross a field boundary.
+ */
+
+/* Or the absolute value of c into the zeroed limbs at bit offset pos. */
+
+static void
+_GMPy_Kronecker_Put(mp_ptr d, mp_bitcnt_t pos, mpz_srcptr c)
+{
+    mp_srcptr s = mpz_limbs_read(c);
+    mp_size_t j, n = mpz_size(c);
+    mp_size_t w = pos / GMP_NUMB_BITS;
+    unsigned int sh = pos % GMP_NUMB_BITS;
+
+    for (j = 0; j < n; j++) {
+        if (sh) {
+            d[w + j] |= s[j] << sh;
+            d[w + j + 1] |= s[j] >> (GMP_NUMB_BITS - sh);
+        }
+        else {
+            d[w + j] |= s[j];
+        }
+    }
+}
+
+/* Set r to the k-bit field at bit offset pos of the n limbs at s. */
+
+static void
+_GMPy_Kronecker_Get(mpz_ptr r, mp_srcptr s, mp_size_t n, mp_bitcnt_t pos,
+                    mp_bitcnt_t k)
+{
+    mp_size_t w = pos / GMP_NUMB_BITS, rn, avail;
+    unsigned int sh = pos % GMP_NUMB_BITS;
+    mp_ptr rp;
+
+    rn = (k + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    avail = w < n ? n - w : 0;
+    if (avail > rn + 1)
+        avail = rn + 1;
+
+    rp = mpz_limbs_write(r, rn + 1);
+    if (avail) {
+        if (sh)
+            mpn_rshift(rp, s + w, avail, sh);
+        else
+            mpn_copyi(rp, s + w, avail);
+    }
+    while (avail < rn)
+        rp[avail++] = 0;
+    if (k % GMP_NUMB_BITS)
+        rp[rn - 1] &= ((mp_limb_t)1 << (k % GMP_NUMB_BITS)) - 1;
+    mpz_limbs_finish(r, rn);
+}
+
+static void
+_GMPy_Kronecker_Pack(mpz_ptr r, MPZ_Object **c, Py_ssize_t n, mp_bitcnt_t k)
+{
+    mp_size_t size = (mp_size_t)(((mp_bitcnt_t)n * k) / GMP_NUMB_BITS + 2);
+    mp_ptr pos, neg;
+    mpz_t t;
+    Py_ssize_t i;
+
+    mpz_init(t);
+    pos = mpz_limbs_write(r, size);
+    neg = mpz_limbs_write(t, size);
+    memset(pos, 0, size * sizeof(mp_limb_t));
+    memset(neg, 0, size * sizeof(mp_limb_t));
+    for (i = 0; i < n; i++) {
+        if (mpz_sgn(c[i]->z) > 0)
+            _GMPy_Kronecker_Put(pos, (mp_bitcnt_t)i * k, c[i]->z);
+        else if (mpz_sgn(c[i]->z) < 0)
+            _GMPy_Kronecker_Put(neg, (mp_bitcnt_t)i * k, c[i]->z);
+    }
+    mpz_limbs_finish(r, size);
+    mpz_limbs_finish(t, size);
+    mpz_sub(r, r, t);
+    mpz_clear(t);
+}
+
+/* Convert a sequence of integers to a new array of mpz objects. */
+
+static MPZ_Object **
+_GMPy_Kronecker_Args(PyObject *obj, Py_ssize_t *n, mp_bitcnt_t *bits,
+                     CTXT_Object *context)
+{
+    PyObject *seq, **items;
+    MPZ_Object **result;
+    Py_ssize_t i;
+    size_t b;
+    int xtype;
+
+    if (!(seq = PySequence_Fast(obj, "poly_mul() requires sequences of integers")))
+        return NULL;
+
+    *n = PySequence_Fast_GET_SIZE(seq);
+    items = PySequence_Fast_ITEMS(seq);
+    *bits = 0;
+
+    if (!(result = PyMem_New(MPZ_Object*, *n ? *n : 1))) {
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    for (i = 0; i < *n; i++) {
+        xtype = GMPy_ObjectType(items[i]);
+        if (!IS_TYPE_INTEGER(xtype)) {
+            TYPE_ERROR("poly_mul() requires sequences of integers");
+            result[i] = NULL;
+        }
+        else {
+            result[i] = GMPy_MPZ_From_IntegerWithType(items[i], xtype, context);
+        }
+        if (!result[i]) {
+            while (i--)
+                Py_DECREF((PyObject*)result[i]);
+            PyMem_Free(result);
+            Py_DECREF(seq);
+            return NULL;
+        }
+        b = mpz_sizeinbase(result[i]->z, 2);
+        if (b > *bits)
+            *bits = b;
+    }
+    Py_DECREF(seq);
+    return result;
+}
+
+PyDoc_STRVAR(doc_poly_mul,
+"poly_mul(a, b, /) -> list\n\n"
+"Return the product of the integer polynomials with coefficient\n"
+"sequences a and b. The result c has len(a) + len(b) - 1 coefficients\n"
+"with c[k] = sum(a[i] * b[k - i]). The coefficients are packed into two\n"
+"large integers that are multiplied with a single multiplication, so\n"
+"GMP's fast algorithms are used for polynomials of high degree.");
+
+static PyObject *
+GMPy_MPZ_poly_mul(PyObject *self, PyObject *args)
+{
+    PyObject *result = NULL;
+    MPZ_Object **a = NULL, **b = NULL, *item;
+    Py_ssize_t na, nb, nc, i;
+    mp_bitcnt_t abits, bbits, k, j;
+    mpz_t x, y, half;
+    mp_ptr d;
+    mp_srcptr s;
+    mp_size_t size;
+    int square;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("poly_mul() requires 2 arguments");
+        return NULL;
+    }
+    square = PyTuple_GET_ITEM(args, 0) == PyTuple_GET_ITEM(args, 1);
+
+    if (!(a = _GMPy_Kronecker_Args(PyTuple_GET_ITEM(args, 0), &na, &abits, context)))
+        return NULL;
+    if (!(b = _GMPy_Kronecker_Args(PyTuple_GET_ITEM(args, 1), &nb, &bbits, context)))
+        goto done;
+
+    nc = (na && nb) ? na + nb - 1 : 0;
+    if (!(result = PyList_New(nc)))
+        goto done;
+    for (i = 0; i < nc; i++) {
+        if (!(item = GMPy_MPZ_New(context))) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, (PyObject*)item);
+    }
+    if (!nc)
+        goto done;
+
+    /* Each coefficient of the product is the sum of at most min(na, nb)
+     * products, plus one bit for the sign.
+     */
+
+    k = abits + bbits + 1;
+    for (j = (mp_bitcnt_t)(na < nb ? na : nb); j; j >>= 1)
+        k++;
+
+    mpz_init(x);
+    mpz_init(y);
+    mpz_init(half);
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)k * nc);
+    _GMPy_Kronecker_Pack(x, a, na, k);
+    if (square) {
+        /* mpz_mul() uses the faster squaring code. */
+        mpz_mul(x, x, x);
+    }
+    else {
+        _GMPy_Kronecker_Pack(y, b, nb, k);
+        mpz_mul(x, x, y);
+    }
+
+    /* Add 2**(k-1) to every field. */
+
+    size = (mp_size_t)(((mp_bitcnt_t)nc * k) / GMP_NUMB_BITS + 1);
+    d = mpz_limbs_write(y, size);
+    memset(d, 0, size * sizeof(mp_limb_t));
+    for (i = 0; i < nc; i++) {
+        j = (mp_bitcnt_t)i * k + k - 1;
+        d[j / GMP_NUMB_BITS] |= (mp_limb_t)1 << (j % GMP_NUMB_BITS);
+    }
+    mpz_limbs_finish(y, size);
+    mpz_add(x, x, y);
+
+    mpz_setbit(half, k - 1);
+    s = mpz_limbs_read(x);
+    size = mpz_size(x);
+    for (i = 0; i < nc; i++) {
+        item = (MPZ_Object*)PyList_GET_ITEM(result, i);
+        _GMPy_Kronecker_Get(item->z, s, size, (mp_bitcnt_t)i * k, k);
+        mpz_sub(item->z, item->z, half);
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    mpz_clear(x);
+    mpz_clear(y);
+    mpz_clear(half);
+
+  done:
+    if (a) {
+        for (i = 0; i < na; i++)
+            Py_DECREF((PyObject*)a[i]);
+        PyMem_Free(a);
+    }
+    if (b) {
+        for (i = 0; i < nb; i++)
+            Py_DECREF((PyObject*)b[i]);
+        PyMem_Free(b);
+    }
+    return result;
+}
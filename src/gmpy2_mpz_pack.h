@@ -33,6 +33,9 @@ extern "C" {
 
 static PyObject * GMPy_MPZ_pack(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_unpack(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_pack_buffer(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_unpack_buffer(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_poly_mul(PyObject *self, PyObject *args);
 
 #ifdef __cplusplus
 }
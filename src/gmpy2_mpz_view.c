@@ -0,0 +1,154 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mpz_view.c                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+PyDoc_STRVAR(GMPy_doc_mpz_view,
+"mpz_view(buffer, /, *, signed=False) -> mpz_view\n\n"
+"Return a read-only integer whose value is given by the limbs in buffer,\n"
+"an object that supports the buffer protocol, such as a NumPy array of\n"
+"uint64, a memoryview of shared memory, or the result of xmpz.limbs().\n"
+"The limbs are in the native byte order, least significant limb first,\n"
+"and are not copied: the view keeps buffer alive and reads the limbs in\n"
+"place, so the buffer must not be changed while the view exists. If\n"
+"signed is True, the limbs are a two's complement value and a negative\n"
+"value is converted once to a private copy of its magnitude.\n\n"
+"An mpz_view can be used wherever an mpz is accepted as an argument;\n"
+"the results of arithmetic are new mpz. mpz(v) returns a copy.");
+
+static PyObject *
+GMPy_MPZ_View_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "signed", NULL};
+    MPZ_View_Object *result;
+    PyObject *obj;
+    mp_limb_t *d;
+    mp_size_t n;
+    int is_signed = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|$p:mpz_view", kwlist,
+                                     &obj, &is_signed))
+        return NULL;
+
+    if (!(result = PyObject_New(MPZ_View_Object, &MPZ_View_Type)))
+        return NULL;
+    result->limbs = NULL;
+    result->hash_cache = -1;
+
+    if (PyObject_GetBuffer(obj, &result->view, PyBUF_SIMPLE) < 0) {
+        PyObject_Free(result);
+        return NULL;
+    }
+
+    if (result->view.len % sizeof(mp_limb_t) ||
+        (uintptr_t)result->view.buf % sizeof(mp_limb_t)) {
+        PyErr_Format(PyExc_ValueError,
+                     "mpz_view() requires an aligned buffer of %d-byte limbs",
+                     (int)sizeof(mp_limb_t));
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+
+    d = (mp_limb_t*)result->view.buf;
+    n = (mp_size_t)(result->view.len / sizeof(mp_limb_t));
+
+    if (is_signed && n && (d[n - 1] >> (GMP_NUMB_BITS - 1))) {
+        if (!(result->limbs = PyMem_New(mp_limb_t, n))) {
+            Py_DECREF((PyObject*)result);
+            return PyErr_NoMemory();
+        }
+        mpn_neg(result->limbs, d, n);
+        mpz_roinit_n(result->z, result->limbs, -n);
+    }
+    else {
+        mpz_roinit_n(result->z, d, n);
+    }
+    return (PyObject*)result;
+}
+
+static void
+GMPy_MPZ_View_Dealloc(MPZ_View_Object *self)
+{
+    PyBuffer_Release(&self->view);
+    PyMem_Free(self->limbs);
+    PyObject_Free(self);
+}
+
+static PyObject *
+GMPy_MPZ_View_Repr_Slot(MPZ_View_Object *self)
+{
+    PyObject *digits, *result;
+
+    if (!(digits = mpz_ascii(self->z, 10, 0, 0)))
+        return NULL;
+    result = PyUnicode_FromFormat("mpz_view(%U)", digits);
+    Py_DECREF(digits);
+    return result;
+}
+
+static PyObject *
+GMPy_MPZ_View_GetObj_Attrib(MPZ_View_Object *self, void *closure)
+{
+    Py_INCREF(self->view.obj);
+    return self->view.obj;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_view_obj,
+"The object that exports the limbs.");
+
+static PyGetSetDef GMPy_MPZ_View_getseters[] = {
+    { "numerator", (getter)GMPy_MPZ_Attrib_GetNumer, NULL,
+        "the numerator of a rational number in lowest terms", NULL },
+    { "denominator", (getter)GMPy_MPZ_Attrib_GetDenom, NULL,
+        "the denominator of a rational number in lowest terms", NULL },
+    { "real", (getter)GMPy_MPZ_Attrib_GetReal, NULL,
+        "the real part of a complex number", NULL },
+    { "imag", (getter)GMPy_MPZ_Attrib_GetImag, NULL,
+        "the imaginary part of a complex number", NULL },
+    { "obj", (getter)GMPy_MPZ_View_GetObj_Attrib, NULL, GMPy_doc_mpz_view_obj, NULL },
+    { NULL }
+};
+
+/* The number, mapping, and method tables of mpz only read their operands,
+ * so they are shared with mpz.
+ */
+
+static PyTypeObject MPZ_View_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.mpz_view",
+    .tp_basicsize = sizeof(MPZ_View_Object),
+    .tp_dealloc = (destructor) GMPy_MPZ_View_Dealloc,
+    .tp_repr = (reprfunc) GMPy_MPZ_View_Repr_Slot,
+    .tp_as_number = &GMPy_MPZ_number_methods,
+    .tp_as_mapping = &GMPy_MPZ_mapping_methods,
+    .tp_hash = (hashfunc) GMPy_MPZ_Hash_Slot,
+    .tp_str = (reprfunc) GMPy_MPZ_Str_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_mpz_view,
+    .tp_richcompare = (richcmpfunc)&GMPy_RichCompare_Slot,
+    .tp_methods = GMPy_MPZ_methods,
+    .tp_getset = GMPy_MPZ_View_getseters,
+    .tp_new = GMPy_MPZ_View_NewInit,
+};
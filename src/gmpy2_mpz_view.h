@@ -0,0 +1,55 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mpz_view.h                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_MPZ_VIEW_H
+#define GMPY_MPZ_VIEW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An mpz_view is a read-only integer whose limbs are in a buffer of
+ * another object, set up with mpz_roinit_n(). The first fields match
+ * MPZ_Object, so MPZ() and the mpz slots can be used on a view; the
+ * conversion functions treat it like an mpz operand (OBJ_TYPE_MPZ_VIEW)
+ * and never write to it.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    mpz_t z;
+    Py_hash_t hash_cache;
+    Py_buffer view;             /* the exported limbs */
+    mp_limb_t *limbs;           /* magnitude of a negative signed value */
+} MPZ_View_Object;
+
+static PyTypeObject MPZ_View_Type;
+#define MPZ_View_Check(v) (((PyObject*)v)->ob_type == &MPZ_View_Type)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -27,6 +27,218 @@
 /* This file implements the * operator, gmpy2.mul() and context.mul().
  */
 
+/* Parallel multiplication of large integers.
+ *
+ * If one operand is at least twice as long as the other, the longer one is
+ * cut into one piece per thread, each piece is multiplied by the shorter
+ * operand, and the partial products are added at their offsets. Otherwise
+ * Karatsuba's identity
+ *
+ *     (x1*B + x0)*(y1*B + y0) = x1*y1*B**2 + (s - x1*y1 - x0*y0)*B + x0*y0
+ *
+ * with s = (x1 + x0)*(y1 + y0) turns the product into 3 half-size products,
+ * or into 9 quarter-size products when it is applied twice. The products
+ * are computed by GMP in parallel and then recombined with additions and
+ * shifts. Squares stay squares, which GMP computes faster.
+ */
+
+typedef struct {
+    mpz_t x;
+    mpz_t y;                    /* unused for a square or a piece */
+    mpz_t z;
+} gmpy_mul_task;
+
+typedef struct {
+    gmpy_mul_task *task;
+    Py_ssize_t ntasks;
+    mpz_srcptr common;          /* the shorter operand of the pieces */
+    int square;
+    mp_bitcnt_t shift[4];       /* split point of each Karatsuba step */
+    int nshift;
+} gmpy_mul_work;
+
+static void
+_GMPy_Mul_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_mul_work *work = (gmpy_mul_work*)arg;
+    gmpy_mul_task *t;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        t = &work->task[i];
+        if (work->common)
+            mpz_mul(t->z, t->x, work->common);
+        else if (work->square)
+            mpz_mul(t->z, t->x, t->x);
+        else
+            mpz_mul(t->z, t->x, t->y);
+    }
+}
+
+/* Append the operands of the 3**depth products of x*y to work, in the
+ * order _GMPy_Mul_Join() expects them. x and y are not negative.
+ */
+
+static void
+_GMPy_Mul_Split(gmpy_mul_work *work, mpz_srcptr x, mpz_srcptr y, int depth)
+{
+    mp_bitcnt_t k;
+    mpz_t x0, x1, y0, y1;
+    gmpy_mul_task *t;
+
+    if (depth == 0) {
+        t = &work->task[work->ntasks++];
+        mpz_set(t->x, x);
+        if (!work->square)
+            mpz_set(t->y, y);
+        return;
+    }
+
+    k = (mp_bitcnt_t)(Py_MAX(mpz_size(x), mpz_size(y)) / 2) * GMP_NUMB_BITS;
+    work->shift[work->nshift++] = k;
+
+    mpz_init(x0);
+    mpz_init(x1);
+    mpz_init(y0);
+    mpz_init(y1);
+    mpz_tdiv_r_2exp(x0, x, k);
+    mpz_tdiv_q_2exp(x1, x, k);
+    if (!work->square) {
+        mpz_tdiv_r_2exp(y0, y, k);
+        mpz_tdiv_q_2exp(y1, y, k);
+    }
+    _GMPy_Mul_Split(work, x0, y0, depth - 1);
+    _GMPy_Mul_Split(work, x1, y1, depth - 1);
+    mpz_add(x0, x0, x1);
+    mpz_add(y0, y0, y1);
+    _GMPy_Mul_Split(work, x0, y0, depth - 1);
+    mpz_clear(x0);
+    mpz_clear(x1);
+    mpz_clear(y0);
+    mpz_clear(y1);
+}
+
+/* Set z from the products in the order they were split. */
+
+static void
+_GMPy_Mul_Join(gmpy_mul_work *work, mpz_ptr z, int depth, Py_ssize_t *next,
+               int *step)
+{
+    mp_bitcnt_t k;
+    mpz_t z1, z2;
+
+    if (depth == 0) {
+        mpz_swap(z, work->task[(*next)++].z);
+        return;
+    }
+
+    k = work->shift[(*step)++];
+    mpz_init(z1);
+    mpz_init(z2);
+    _GMPy_Mul_Join(work, z, depth - 1, next, step);
+    _GMPy_Mul_Join(work, z2, depth - 1, next, step);
+    _GMPy_Mul_Join(work, z1, depth - 1, next, step);
+    mpz_sub(z1, z1, z);
+    mpz_sub(z1, z1, z2);
+    mpz_mul_2exp(z2, z2, k);
+    mpz_add(z2, z2, z1);
+    mpz_mul_2exp(z2, z2, k);
+    mpz_add(z, z, z2);
+    mpz_clear(z1);
+    mpz_clear(z2);
+}
+
+/* Set z to x*y using up to threads threads. z may be x or y. mpz_mul() is
+ * used for a single thread or if memory runs out. Does not use the Python
+ * API.
+ */
+
+static void
+_GMPy_MPZ_Mul_Threads(mpz_ptr z, mpz_srcptr x, mpz_srcptr y, int threads)
+{
+    gmpy_mul_work work;
+    mpz_t ax, ay, result;
+    mp_size_t xn = mpz_size(x), yn = mpz_size(y), chunk;
+    Py_ssize_t i, count;
+    int depth = 0, sign = mpz_sgn(x) * mpz_sgn(y);
+
+    if (threads < 2 || sign == 0) {
+        mpz_mul(z, x, y);
+        return;
+    }
+
+    /* Work on the absolute values with the longer operand in ax. */
+
+    work.square = (x == y);
+    if (xn < yn) {
+        mpz_srcptr temp = x;
+
+        x = y;
+        y = temp;
+        xn = mpz_size(x);
+        yn = mpz_size(y);
+    }
+    mpz_roinit_n(ax, mpz_limbs_read(x), xn);
+    mpz_roinit_n(ay, mpz_limbs_read(y), yn);
+
+    work.common = NULL;
+    work.ntasks = 0;
+    work.nshift = 0;
+    if (!work.square && xn >= 2 * yn) {
+        count = Py_MIN(threads, xn / yn);
+        work.common = ay;
+    }
+    else {
+        depth = threads >= 9 ? 2 : 1;
+        count = depth == 2 ? 9 : 3;
+    }
+
+    if (!(work.task = PyMem_RawMalloc(sizeof(gmpy_mul_task) * count))) {
+        mpz_mul(z, x, y);
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        mpz_init(work.task[i].x);
+        mpz_init(work.task[i].y);
+        mpz_init(work.task[i].z);
+    }
+
+    mpz_init(result);
+    if (work.common) {
+        chunk = (xn + count - 1) / count;
+        for (i = 0; i < count; i++) {
+            mpz_tdiv_q_2exp(work.task[i].x, ax, (mp_bitcnt_t)(i * chunk) * GMP_NUMB_BITS);
+            mpz_tdiv_r_2exp(work.task[i].x, work.task[i].x, (mp_bitcnt_t)chunk * GMP_NUMB_BITS);
+        }
+        work.ntasks = count;
+        GMPy_Parallel_Run(_GMPy_Mul_Range, &work, count, threads);
+        for (i = count - 1; i >= 0; i--) {
+            mpz_mul_2exp(result, result, (mp_bitcnt_t)chunk * GMP_NUMB_BITS);
+            mpz_add(result, result, work.task[i].z);
+        }
+    }
+    else {
+        Py_ssize_t next = 0;
+        int step = 0;
+
+        _GMPy_Mul_Split(&work, ax, ay, depth);
+        GMPy_Parallel_Run(_GMPy_Mul_Range, &work, count, threads);
+        _GMPy_Mul_Join(&work, result, depth, &next, &step);
+    }
+
+    for (i = 0; i < count; i++) {
+        mpz_clear(work.task[i].x);
+        mpz_clear(work.task[i].y);
+        mpz_clear(work.task[i].z);
+    }
+    PyMem_RawFree(work.task);
+
+    if (sign < 0)
+        mpz_neg(result, result);
+    mpz_swap(z, result);
+    mpz_clear(result);
+}
+
 /* Multiply two Integer objects (see gmpy2_convert.c). If an error occurs,
  * NULL is returned and an exception is set. If either x or y can't be
  * converted into an mpz, Py_NotImplemented is returned. */
@@ -36,8 +248,15 @@ GMPy_Integer_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype,
                          CTXT_Object *context)
 {
     MPZ_Object *result = NULL;
+    mp_size_t size = 1;
+
+    /* Pick a cached object that is large enough for the result. */
+    if (IS_TYPE_MPZANY(xtype) && IS_TYPE_MPZANY(ytype))
+        size = mpz_size(MPZ(x)) + mpz_size(MPZ(y));
 
-    if (!(result = GMPy_MPZ_New(context))) {
+    if (!(result = GMPy_MPZ_Reuse(x, xtype, y, ytype)) &&
+        !(result = GMPy_MPZ_Reuse(y, ytype, x, xtype)) &&
+        !(result = GMPy_MPZ_NewSize(size, context))) {
         /* LCOV_EXCL_START */
         return NULL;
         /* LCOV_EXCL_STOP */
@@ -45,44 +264,49 @@ GMPy_Integer_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype,
 
     if (IS_TYPE_MPZANY(xtype)) {
         if (IS_TYPE_MPZANY(ytype)) {
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            if (GMPY_MUL_THREADS(context, MPZ(x), MPZ(y))) {
+                GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS2(MPZ(x), MPZ(y)));
+                _GMPy_MPZ_Mul_Threads(result->z, MPZ(x), MPZ(y),
+                                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+                GMPY_END_ALLOW_THREADS_MIN(context);
+                return GMPy_MPZ_Small_Result(result);
+            }
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), MPZ(y)));
             mpz_mul(result->z, MPZ(x), MPZ(y));
             GMPY_MAYBE_END_ALLOW_THREADS(context);
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
 
         if (IS_TYPE_PyInteger(ytype)) {
-            int error;
-            long temp = PyLong_AsLongAndOverflow(y, &error);
+            long temp;
 
-            if (!error) {
+            if (GMPy_PyLong_AsSmall(y, &temp)) {
                  mpz_mul_si(result->z, MPZ(x), temp);
             }
             else {
                 mpz_set_PyLong(result->z, y);
-                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(x), result->z));
                 mpz_mul(result->z, MPZ(x), result->z);
                 GMPY_MAYBE_END_ALLOW_THREADS(context);
             }
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
     }
 
     if (IS_TYPE_MPZANY(ytype)) {
         if (IS_TYPE_PyInteger(xtype)) {
-            int error;
-            long temp = PyLong_AsLongAndOverflow(x, &error);
+            long temp;
 
-            if (!error) {
+            if (GMPy_PyLong_AsSmall(x, &temp)) {
                 mpz_mul_si(result->z, MPZ(y), temp);
             }
             else {
                 mpz_set_PyLong(result->z, x);
-                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+                GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(result->z, MPZ(y)));
                 mpz_mul(result->z, result->z, MPZ(y));
                 GMPY_MAYBE_END_ALLOW_THREADS(context);
             }
-            return (PyObject*)result;
+            return GMPy_MPZ_Small_Result(result);
         }
     }
 
@@ -99,12 +323,12 @@ GMPy_Integer_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             /* LCOV_EXCL_STOP */
         }
 
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(tempx->z, tempy->z));
         mpz_mul(result->z, tempx->z, tempy->z);
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_DECREF((PyObject*)tempx);
         Py_DECREF((PyObject*)tempy);
-        return (PyObject*)result;
+        return GMPy_MPZ_Small_Result(result);
     }
 
     /* LCOV_EXCL_START */
@@ -119,20 +343,52 @@ GMPy_Rational_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype,
                           CTXT_Object *context)
 {
     MPQ_Object *result = NULL;
+    mp_size_t size = 1;
 
-    if (!(result = GMPy_MPQ_New(context))) {
+    /* Pick a cached object that is large enough for the result. */
+    if (IS_TYPE_MPQ(xtype) && IS_TYPE_MPQ(ytype))
+        size = MPQ_SIZE(MPQ(x)) + MPQ_SIZE(MPQ(y));
+
+    if (!(result = GMPy_MPQ_NewSize(size, context))) {
         /* LCOV_EXCL_START */
         return NULL;
         /* LCOV_EXCL_STOP */
     }
 
     if (IS_TYPE_MPQ(xtype) && IS_TYPE_MPQ(ytype)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(MPQ(x), MPQ(y)));
         mpq_mul(result->q, MPQ(x), MPQ(y));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         return (PyObject*)result;
     }
 
+    /* For p/q * n, only gcd(q, n) needs to be removed since gcd(p, q) is 1. */
+
+    if (IS_TYPE_MPQ(xtype) || IS_TYPE_MPQ(ytype)) {
+        PyObject *q = IS_TYPE_MPQ(xtype) ? x : y;
+        PyObject *n = IS_TYPE_MPQ(xtype) ? y : x;
+        int ntype = IS_TYPE_MPQ(xtype) ? ytype : xtype;
+        long temp;
+
+        if (IS_TYPE_PyInteger(ntype) && GMPy_PyLong_AsSmall(n, &temp)) {
+            unsigned long a = temp >= 0 ? (unsigned long)temp : -(unsigned long)temp;
+            unsigned long g;
+
+            if (a == 0) {
+                mpq_set_ui(result->q, 0, 1);
+                return (PyObject*)result;
+            }
+
+            g = mpz_gcd_ui(NULL, mpq_denref(MPQ(q)), a);
+            mpz_mul_ui(mpq_numref(result->q), mpq_numref(MPQ(q)), a / g);
+            mpz_divexact_ui(mpq_denref(result->q), mpq_denref(MPQ(q)), g);
+            if (temp < 0) {
+                mpz_neg(mpq_numref(result->q), mpq_numref(result->q));
+            }
+            return (PyObject*)result;
+        }
+    }
+
     if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype)) {
         MPQ_Object *tempx = NULL, *tempy = NULL;
 
@@ -146,7 +402,7 @@ GMPy_Rational_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             /* LCOV_EXCL_STOP */
         }
 
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(tempx->q, tempy->q));
         mpq_mul(result->q, tempx->q, tempy->q);
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_DECREF((PyObject*)tempx);
@@ -167,19 +423,38 @@ GMPy_Real_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype,
 {
     MPFR_Object *result = NULL;
 
-    if (!(result = GMPy_MPFR_New(0, context))) {
+    if (!(result = GMPy_MPFR_Reuse(x, xtype, context)) &&
+        !(result = GMPy_MPFR_Reuse(y, ytype, context)) &&
+        !(result = GMPy_MPFR_New(0, context))) {
         /* LCOV_EXCL_START */
         return NULL;
         /* LCOV_EXCL_STOP */
     }
 
     if (IS_TYPE_MPFR(xtype) && IS_TYPE_MPFR(ytype)) {
+        if (_GMPy_MPFR_Fast(GMPY_FAST_MUL, &result, MPFR(x), MPFR(y), context))
+            return (PyObject*)result;
+
         mpfr_clear_flags();
         result->rc = mpfr_mul(result->f, MPFR(x), MPFR(y), GET_MPFR_ROUND(context));
         _GMPy_MPFR_Cleanup(&result, context);
         return (PyObject*)result;
     }
 
+    if (IS_TYPE_MPFR(xtype) || IS_TYPE_MPFR(ytype)) {
+        PyObject *f = IS_TYPE_MPFR(xtype) ? x : y;
+        PyObject *n = IS_TYPE_MPFR(xtype) ? y : x;
+        int ntype = IS_TYPE_MPFR(xtype) ? ytype : xtype;
+        long temp;
+
+        if (IS_TYPE_PyInteger(ntype) && GMPy_PyLong_AsSmall(n, &temp)) {
+            mpfr_clear_flags();
+            result->rc = mpfr_mul_si(result->f, MPFR(f), temp, GET_MPFR_ROUND(context));
+            _GMPy_MPFR_Cleanup(&result, context);
+            return (PyObject*)result;
+        }
+    }
+
     if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype)) {
         MPFR_Object *tempx = NULL, *tempy = NULL;
 
@@ -225,6 +500,9 @@ GMPy_Complex_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype,
     }
 
     if (IS_TYPE_MPC(xtype) && IS_TYPE_MPC(ytype)) {
+        if (_GMPy_MPC_Fast(GMPY_FAST_MUL, &result, MPC(x), MPC(y), context))
+            return (PyObject*)result;
+
         result->rc = mpc_mul(result->c, MPC(x), MPC(y), GET_MPC_ROUND(context));
         _GMPy_MPC_Cleanup(&result, context);
         return (PyObject*)result;
@@ -242,6 +520,11 @@ GMPy_Complex_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             return NULL;
             /* LCOV_EXCL_STOP */
         }
+        if (_GMPy_MPC_Fast(GMPY_FAST_MUL, &result, tempx->c, tempy->c, context)) {
+            Py_DECREF((PyObject*)tempx);
+            Py_DECREF((PyObject*)tempy);
+            return (PyObject*)result;
+        }
         result->rc = mpc_mul(result->c, tempx->c, tempy->c, GET_MPC_ROUND(context));
         Py_DECREF((PyObject*)tempx);
         Py_DECREF((PyObject*)tempy);
@@ -256,6 +539,15 @@ GMPy_Complex_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype,
     /* LCOV_EXCL_STOP */
 }
 
+/* Indexed by GMPY_TYPE_CLASS2(xtype, ytype). */
+
+static gmpy_binary_withtype const GMPy_Mul_Table[OBJ_CLASS_COUNT] = {
+    GMPy_Integer_MulWithType,
+    GMPy_Rational_MulWithType,
+    GMPy_Real_MulWithType,
+    GMPy_Complex_MulWithType,
+};
+
 static PyObject *
 GMPy_Number_Mul(PyObject *x, PyObject *y, CTXT_Object *context)
 {
@@ -264,17 +556,10 @@ GMPy_Number_Mul(PyObject *x, PyObject *y, CTXT_Object *context)
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_MulWithType(x, xtype, y, ytype, context);
-
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_MulWithType(x, xtype, y, ytype, context);
+    GMPY_PROFILE_OP2(context, GMPY_OP_MUL, x, xtype, y, ytype);
 
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_MulWithType(x, xtype, y, ytype, context);
-
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_MulWithType(x, xtype, y, ytype, context);
+    if (xtype && ytype)
+        return GMPy_Mul_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, context);
 
     TYPE_ERROR("mul() argument type not supported");
     return NULL;
@@ -291,17 +576,10 @@ GMPy_Number_Mul_Slot(PyObject *x, PyObject *y)
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_MulWithType(x, xtype, y, ytype, context);
-
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_MulWithType(x, xtype, y, ytype, context);
-
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_MulWithType(x, xtype, y, ytype, context);
+    GMPY_PROFILE_OP2(context, GMPY_OP_MUL, x, xtype, y, ytype);
 
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_MulWithType(x, xtype, y, ytype, context);
+    if (xtype && ytype)
+        return GMPy_Mul_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, context);
 
     Py_RETURN_NOTIMPLEMENTED;
 }
@@ -309,19 +587,23 @@ GMPy_Number_Mul_Slot(PyObject *x, PyObject *y)
 /* Implement context.mul() and gmpy2.mul(). */
 
 PyDoc_STRVAR(GMPy_doc_function_mul,
-"mul(x, y, /) -> mpz | mpq | mpfr | mpc\n\n"
-"Return x * y.");
+"mul(x, y, /, *, out=None) -> mpz | mpq | mpfr | mpc | xmpz\n\n"
+"Return x * y. If out is an `xmpz`, x and y must be integers and the\n"
+"result is stored in out, which is returned.");
 
 PyDoc_STRVAR(GMPy_doc_context_mul,
-"context.mul(x, y, /) -> mpz | mpq | mpfr | mpc\n\n"
-"Return x * y.");
+"context.mul(x, y, /, *, out=None) -> mpz | mpq | mpfr | mpc | xmpz\n\n"
+"Return x * y. If out is an `xmpz`, x and y must be integers and the\n"
+"result is stored in out, which is returned.");
 
 static PyObject *
-GMPy_Context_Mul(PyObject *self, PyObject *args)
+GMPy_Context_Mul(PyObject *self, PyObject *const *args, Py_ssize_t nargs,
+                 PyObject *kwnames)
 {
     CTXT_Object *context = NULL;
+    XMPZ_Object *out;
 
-    if (PyTuple_GET_SIZE(args) != 2) {
+    if (nargs != 2) {
         TYPE_ERROR("mul() requires 2 arguments");
         return NULL;
     }
@@ -333,7 +615,11 @@ GMPy_Context_Mul(PyObject *self, PyObject *args)
         CHECK_CONTEXT(context);
     }
 
-    return GMPy_Number_Mul(PyTuple_GET_ITEM(args, 0),
-                           PyTuple_GET_ITEM(args, 1),
-                           context);
+    if (GMPy_XMPZ_Out_Kwnames(args, nargs, kwnames, &out, "mul") < 0)
+        return NULL;
+    if (out)
+        return GMPy_XMPZ_Out_Binop(out, args[0], args[1],
+                                   GMPY_OP_MUL, "mul", context);
+
+    return GMPy_Number_Mul(args[0], args[1], context);
 }
@@ -37,12 +37,14 @@ static PyObject * GMPy_Number_Mul(PyObject *x, PyObject *y, CTXT_Object *context
 
 /* Private API */
 
+static void _GMPy_MPZ_Mul_Threads(mpz_ptr z, mpz_srcptr x, mpz_srcptr y, int threads);
 static PyObject * GMPy_Integer_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype, CTXT_Object *context);
 static PyObject * GMPy_Rational_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype, CTXT_Object *context);
 static PyObject * GMPy_Real_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype, CTXT_Object *context);
 static PyObject * GMPy_Complex_MulWithType(PyObject *x, int xtype, PyObject *y, int ytype, CTXT_Object *context);
 static PyObject * GMPy_Number_Mul_Slot(PyObject *x, PyObject *y);
-static PyObject * GMPy_Context_Mul(PyObject *self, PyObject *args);
+static PyObject * GMPy_Context_Mul(PyObject *self, PyObject *const *args,
+                                   Py_ssize_t nargs, PyObject *kwnames);
 
 #ifdef __cplusplus
 }
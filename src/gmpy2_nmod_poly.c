@@ -0,0 +1,1580 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_nmod_poly.c                                                       *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/* Polynomials modulo a word-size prime.
+ *
+ * Products where both factors have more than GMPY_NMOD_MUL_BASECASE
+ * coefficients use a number-theoretic transform: modulo p itself if
+ * p < 2**62 and p - 1 has a large enough power of 2, otherwise modulo three
+ * fixed primes just below 2**62 whose product exceeds every coefficient of
+ * the integer product while the shorter factor has fewer than 2**57
+ * coefficients. The three results are combined with Garner's CRT and
+ * reduced modulo p. The transforms run over the three primes in parallel.
+ *
+ * Division uses Newton iteration for the inverse of the reversed divisor
+ * as a power series, and evaluation at many points reduces the polynomial
+ * down a subproduct tree of the points.
+ *
+ * The _GMPy_Nmod functions do not use the Python API. The ones that
+ * allocate use PyMem_RawMalloc() and return -1 if memory ran out.
+ */
+
+#ifdef GMPY_MONT_INT128
+
+#define GMPY_NMOD_MUL_BASECASE 32
+#define GMPY_NMOD_DIV_BASECASE 64
+#define GMPY_NMOD_EVAL_LEAF 32
+
+static const mp_limb_t gmpy_nmod_ntt_primes[3] = {
+    0x3fdc000000000001, 0x3f18000000000001, 0x3ec4000000000001
+};
+
+#define NMOD_MUL(md, a, b)  _GMPy_U64_Mul(&(md)->m, a, b)
+#define NMOD_ADD(md, a, b)  _GMPy_U64_Add(&(md)->m, a, b)
+#define NMOD_SUB(md, a, b)  _GMPy_U64_Sub(&(md)->m, a, b)
+
+/* Return a*R mod p, so NMOD_MUL(md, x, NMOD_TO(md, a)) is x*a mod p. */
+
+#define NMOD_TO(md, a)      _GMPy_U64_Mul(&(md)->m, a, (md)->m.r2)
+
+static mp_limb_t
+_GMPy_Nmod_Pow(const gmpy_nmod *mod, mp_limb_t a, mp_limb_t e)
+{
+    mp_limb_t x = mod->m.one, b = NMOD_TO(mod, a);
+
+    for (; e; e >>= 1) {
+        if (e & 1)
+            x = NMOD_MUL(mod, x, b);
+        b = NMOD_MUL(mod, b, b);
+    }
+    return NMOD_MUL(mod, x, 1);
+}
+
+static mp_limb_t
+_GMPy_Nmod_Inv(const gmpy_nmod *mod, mp_limb_t a)
+{
+    return _GMPy_Nmod_Pow(mod, a, mod->m.n - 2);
+}
+
+/* The residue of x modulo p. */
+
+static mp_limb_t
+_GMPy_Nmod_From_MPZ(const gmpy_nmod *mod, mpz_srcptr x)
+{
+    mp_size_t size = mpz_size(x);
+    mp_limb_t t;
+
+    t = size ? mpn_mod_1(mpz_limbs_read(x), size, mod->m.n) : 0;
+    return (mpz_sgn(x) < 0 && t) ? mod->m.n - t : t;
+}
+
+/* p must be an odd prime. */
+
+static void
+_GMPy_Nmod_Init(gmpy_nmod *mod, mp_limb_t p)
+{
+    mp_limb_t c;
+
+    _GMPy_U64_Mont_Init(&mod->m, p);
+    mod->ntt_bits = 0;
+    mod->ntt_root = 1;
+    if (p >> 62)
+        return;
+
+    while (!(((p - 1) >> mod->ntt_bits) & 1))
+        mod->ntt_bits++;
+
+    /* A quadratic non-residue c gives a root of the largest 2-power order. */
+
+    for (c = 2; _GMPy_Nmod_Pow(mod, c, (p - 1) / 2) != p - 1; c++)
+        ;
+    mod->ntt_root = _GMPy_Nmod_Pow(mod, c, (p - 1) >> mod->ntt_bits);
+}
+
+static Py_ssize_t
+_GMPy_Nmod_Poly_Len(const mp_limb_t *c, Py_ssize_t n)
+{
+    while (n > 0 && !c[n - 1])
+        n--;
+    return n;
+}
+
+/* Set w[len + j] to r**j in Montgomery form for each power of 2 len < n,
+ * where r is a root of unity of order 2*len. n must be a power of 2 with
+ * n <= 2**mod->ntt_bits.
+ */
+
+static void
+_GMPy_Nmod_NTT_Table(const gmpy_nmod *mod, mp_limb_t *w, Py_ssize_t n)
+{
+    mp_limb_t root = mod->ntt_root;
+    Py_ssize_t len, j;
+    int bits;
+
+    for (bits = mod->ntt_bits; ((Py_ssize_t)1 << bits) > n; bits--)
+        root = NMOD_MUL(mod, NMOD_TO(mod, root), root);
+    root = NMOD_TO(mod, root);
+
+    len = n / 2;
+    w[len] = mod->m.one;
+    for (j = 1; j < len; j++)
+        w[len + j] = NMOD_MUL(mod, w[len + j - 1], root);
+    for (len /= 2; len > 0; len /= 2) {
+        for (j = 0; j < len; j++)
+            w[len + j] = w[2 * (len + j)];
+    }
+}
+
+/* a*b/R modulo q for a*b < q*R, as _GMPy_U64_Mul() but with the constants
+ * passed by value so they stay in registers in the transform loops. q is
+ * less than 2**62 there, so sums of two residues do not overflow.
+ */
+
+static mp_limb_t
+_GMPy_Nmod_Redc(mp_limb_t q, mp_limb_t minv, mp_limb_t a, mp_limb_t b)
+{
+    unsigned __int128 x = (unsigned __int128)a * b;
+    mp_limb_t lo = (mp_limb_t)x;
+
+    x = (x >> 64) + (((unsigned __int128)(lo * minv) * q) >> 64) + (lo != 0);
+    return (mp_limb_t)(x >= q ? x - q : x);
+}
+
+/* Transforms of more than GMPY_NMOD_NTT_BLOCK values do the outer stage
+ * and recurse on the two halves, so the inner stages work on blocks that
+ * stay in the cache instead of passing over the whole array each time.
+ */
+
+#define GMPY_NMOD_NTT_BLOCK 4096
+
+/* Forward transform of a[0:n] by decimation in frequency. The result is in
+ * bit-reversed order.
+ */
+
+static void
+_GMPy_Nmod_NTT(const gmpy_nmod *mod, mp_limb_t *a, const mp_limb_t *w,
+               Py_ssize_t n)
+{
+    mp_limb_t q = mod->m.n, minv = mod->m.minv, u, v;
+    Py_ssize_t len, s, j, top = n;
+
+    if (n > GMPY_NMOD_NTT_BLOCK)
+        top = 2;
+    for (len = n / 2; len > 0 && 2 * len * top > n; len /= 2) {
+        for (s = 0; s < n; s += 2 * len) {
+            for (j = 0; j < len; j++) {
+                u = a[s + j];
+                v = a[s + j + len];
+                a[s + j] = u + v >= q ? u + v - q : u + v;
+                a[s + j + len] = _GMPy_Nmod_Redc(q, minv, u - v + (u < v ? q : 0),
+                                                 w[len + j]);
+            }
+        }
+    }
+    if (n > GMPY_NMOD_NTT_BLOCK) {
+        _GMPy_Nmod_NTT(mod, a, w, n / 2);
+        _GMPy_Nmod_NTT(mod, a + n / 2, w, n / 2);
+    }
+}
+
+/* Inverse of _GMPy_Nmod_NTT() without the division by n, by decimation in
+ * time. Since r**len = -1, w[2*len - j] is -r**(-j).
+ */
+
+static void
+_GMPy_Nmod_INTT(const gmpy_nmod *mod, mp_limb_t *a, const mp_limb_t *w,
+                Py_ssize_t n)
+{
+    mp_limb_t q = mod->m.n, minv = mod->m.minv, u, t;
+    Py_ssize_t len, s, j;
+
+    if (n > GMPY_NMOD_NTT_BLOCK) {
+        _GMPy_Nmod_INTT(mod, a, w, n / 2);
+        _GMPy_Nmod_INTT(mod, a + n / 2, w, n / 2);
+        len = n / 2;
+    }
+    else {
+        len = 1;
+    }
+    for (; len < n; len *= 2) {
+        for (s = 0; s < n; s += 2 * len) {
+            u = a[s];
+            t = a[s + len];
+            a[s] = u + t >= q ? u + t - q : u + t;
+            a[s + len] = u - t + (u < t ? q : 0);
+            for (j = 1; j < len; j++) {
+                u = a[s + j];
+                t = _GMPy_Nmod_Redc(q, minv, a[s + j + len], w[2 * len - j]);
+                a[s + j] = u - t + (u < t ? q : 0);
+                a[s + j + len] = u + t >= q ? u + t - q : u + t;
+            }
+        }
+    }
+}
+
+/* x modulo q for any 64-bit x. Inputs are only >= q with the fixed primes,
+ * which are more than 0.8*2**62, so x - (x >> 62)*q < 2*q.
+ */
+
+static mp_limb_t
+_GMPy_Nmod_NTT_Reduce(mp_limb_t q, mp_limb_t x)
+{
+    if (x < q)
+        return x;
+    x -= (x >> 62) * q;
+    return x >= q ? x - q : x;
+}
+
+/* Set r[0:nr] to the low coefficients of a*b modulo the prime of mod with
+ * a transform of length n >= na + nb - 1. The coefficients of a and b may
+ * be any 64-bit values.
+ */
+
+static int
+_GMPy_Nmod_Mul_NTT(const gmpy_nmod *mod, mp_limb_t *r, Py_ssize_t nr,
+                   const mp_limb_t *a, Py_ssize_t na,
+                   const mp_limb_t *b, Py_ssize_t nb, Py_ssize_t n)
+{
+    mp_limb_t *fa, *fb, *w, q = mod->m.n, scale;
+    Py_ssize_t i;
+    int square = (a == b && na == nb);
+
+    if (!(fa = PyMem_RawMalloc((square ? 2 : 3) * n * sizeof(mp_limb_t))))
+        return -1;
+    w = fa + n;
+    fb = square ? fa : w + n;
+
+    for (i = 0; i < na; i++)
+        fa[i] = _GMPy_Nmod_NTT_Reduce(q, a[i]);
+    for (; i < n; i++)
+        fa[i] = 0;
+    if (!square) {
+        for (i = 0; i < nb; i++)
+            fb[i] = _GMPy_Nmod_NTT_Reduce(q, b[i]);
+        for (; i < n; i++)
+            fb[i] = 0;
+    }
+
+    _GMPy_Nmod_NTT_Table(mod, w, n);
+    _GMPy_Nmod_NTT(mod, fa, w, n);
+    if (!square)
+        _GMPy_Nmod_NTT(mod, fb, w, n);
+
+    /* The pointwise products are a*b/R, so the scale is R**2/n. */
+
+    for (i = 0; i < n; i++)
+        fa[i] = NMOD_MUL(mod, fa[i], fb[i]);
+    _GMPy_Nmod_INTT(mod, fa, w, n);
+    scale = NMOD_TO(mod, NMOD_TO(mod, q - (q - 1) / (mp_limb_t)n));
+    for (i = 0; i < nr; i++)
+        r[i] = NMOD_MUL(mod, fa[i], scale);
+
+    PyMem_RawFree(fa);
+    return 0;
+}
+
+typedef struct {
+    mp_limb_t *r[3];
+    Py_ssize_t nr;
+    const mp_limb_t *a;
+    Py_ssize_t na;
+    const mp_limb_t *b;
+    Py_ssize_t nb;
+    Py_ssize_t n;
+    int failed;
+} gmpy_nmod_mul_work;
+
+static void
+_GMPy_Nmod_Mul_Prime_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_nmod_mul_work *work = (gmpy_nmod_mul_work*)arg;
+    gmpy_nmod q;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        _GMPy_Nmod_Init(&q, gmpy_nmod_ntt_primes[i]);
+        if (_GMPy_Nmod_Mul_NTT(&q, work->r[i], work->nr, work->a, work->na,
+                               work->b, work->nb, work->n) < 0)
+            work->failed = 1;
+    }
+}
+
+/* Set r[0:nr] to the low coefficients of a*b from their residues modulo
+ * the three transform primes.
+ */
+
+static void
+_GMPy_Nmod_Garner(const gmpy_nmod *mod, mp_limb_t *r, Py_ssize_t nr,
+                  mp_limb_t *const *res)
+{
+    const mp_limb_t *q = gmpy_nmod_ntt_primes;
+    gmpy_nmod m1, m2;
+    mp_limb_t c1, c01, c2, q0p, q01p, x0, t1, t2;
+    Py_ssize_t i;
+
+    _GMPy_Nmod_Init(&m1, q[1]);
+    _GMPy_Nmod_Init(&m2, q[2]);
+
+    /* The primes lie in (2**61, 2**62), so a residue modulo one of them is
+     * reduced modulo another by at most one subtraction.
+     */
+
+    c1 = NMOD_TO(&m1, _GMPy_Nmod_Inv(&m1, q[0] - q[1]));
+    c01 = NMOD_TO(&m2, q[0] - q[2]);
+    c2 = NMOD_TO(&m2, _GMPy_Nmod_Inv(&m2,
+                      (mp_limb_t)(((unsigned __int128)q[0] * q[1]) % q[2])));
+    q0p = NMOD_TO(mod, q[0] % mod->m.n);
+    q01p = NMOD_TO(mod, (mp_limb_t)(((unsigned __int128)q[0] * q[1]) % mod->m.n));
+
+    for (i = 0; i < nr; i++) {
+        x0 = res[0][i];
+        t1 = NMOD_MUL(&m1, NMOD_SUB(&m1, res[1][i], x0 >= q[1] ? x0 - q[1] : x0), c1);
+        t2 = NMOD_ADD(&m2, x0 >= q[2] ? x0 - q[2] : x0, NMOD_MUL(&m2, t1, c01));
+        t2 = NMOD_MUL(&m2, NMOD_SUB(&m2, res[2][i], t2), c2);
+
+        /* x0 + q0*t1 + q0*q1*t2 modulo p. */
+
+        r[i] = NMOD_ADD(mod, NMOD_MUL(mod, x0, mod->m.one),
+                        NMOD_ADD(mod, NMOD_MUL(mod, t1, q0p), NMOD_MUL(mod, t2, q01p)));
+    }
+}
+
+/* Set r[0:nr] to the low nr coefficients of a*b. r must not overlap a or
+ * b. The inputs need not be normalized.
+ */
+
+static int
+_GMPy_Nmod_Poly_Mullow(const gmpy_nmod *mod, mp_limb_t *r, Py_ssize_t nr,
+                       const mp_limb_t *a, Py_ssize_t na,
+                       const mp_limb_t *b, Py_ssize_t nb, int threads)
+{
+    gmpy_nmod_mul_work work;
+    Py_ssize_t i, j, n, full;
+    mp_limb_t ai, r2 = mod->m.r2;
+
+    if (na > nr)
+        na = nr;
+    if (nb > nr)
+        nb = nr;
+    full = (na && nb) ? na + nb - 1 : 0;
+    for (i = full; i < nr; i++)
+        r[i] = 0;
+    if (nr > full)
+        nr = full;
+    if (!nr)
+        return 0;
+
+    if (na <= GMPY_NMOD_MUL_BASECASE || nb <= GMPY_NMOD_MUL_BASECASE) {
+
+        /* The sums of the products a[i]*b[j]/R are multiplied by R at the
+         * end.
+         */
+
+        for (i = 0; i < nr; i++)
+            r[i] = 0;
+        for (i = 0; i < na; i++) {
+            if (!(ai = a[i]))
+                continue;
+            for (j = 0; j < nb && i + j < nr; j++)
+                r[i + j] = NMOD_ADD(mod, r[i + j], NMOD_MUL(mod, ai, b[j]));
+        }
+        for (i = 0; i < nr; i++)
+            r[i] = NMOD_MUL(mod, r[i], r2);
+        return 0;
+    }
+
+    for (n = 1; n < na + nb - 1; n *= 2)
+        ;
+    if (n <= ((Py_ssize_t)1 << mod->ntt_bits))
+        return _GMPy_Nmod_Mul_NTT(mod, r, nr, a, na, b, nb, n);
+
+    if (!(work.r[0] = PyMem_RawMalloc(3 * nr * sizeof(mp_limb_t))))
+        return -1;
+    work.r[1] = work.r[0] + nr;
+    work.r[2] = work.r[1] + nr;
+    work.nr = nr;
+    work.a = a;
+    work.na = na;
+    work.b = b;
+    work.nb = nb;
+    work.n = n;
+    work.failed = 0;
+    GMPy_Parallel_Run(_GMPy_Nmod_Mul_Prime_Range, &work, 3, threads);
+    if (!work.failed)
+        _GMPy_Nmod_Garner(mod, r, nr, work.r);
+    PyMem_RawFree(work.r[0]);
+    return work.failed ? -1 : 0;
+}
+
+/* Set g[0:k] to the inverse of f as a power series modulo x**k. f[0] must
+ * be nonzero. Each step doubles the precision: if f*g = 1 + h*x**l, the
+ * next coefficients of g are those of -g*h.
+ */
+
+static int
+_GMPy_Nmod_Poly_Inv_Series(const gmpy_nmod *mod, mp_limb_t *g, Py_ssize_t k,
+                           const mp_limb_t *f, Py_ssize_t nf, int threads)
+{
+    mp_limb_t *e, *t;
+    Py_ssize_t l, l2, i;
+
+    if (!(e = PyMem_RawMalloc(2 * k * sizeof(mp_limb_t))))
+        return -1;
+    t = e + k;
+
+    g[0] = _GMPy_Nmod_Inv(mod, f[0]);
+    for (l = 1; l < k; l = l2) {
+        l2 = 2 * l < k ? 2 * l : k;
+        if (_GMPy_Nmod_Poly_Mullow(mod, e, l2, f, nf, g, l, threads) < 0 ||
+            _GMPy_Nmod_Poly_Mullow(mod, t, l2 - l, g, l, e + l, l2 - l, threads) < 0) {
+            PyMem_RawFree(e);
+            return -1;
+        }
+        for (i = 0; i < l2 - l; i++)
+            g[l + i] = NMOD_SUB(mod, 0, t[i]);
+    }
+    PyMem_RawFree(e);
+    return 0;
+}
+
+/* Set q[0:na-nb+1] and r[0:nb-1] to the quotient and remainder of a by b;
+ * either may be NULL. b[nb-1] must be nonzero and na >= nb. If binv is not
+ * NULL it holds the first nbinv coefficients of the inverse series of b
+ * reversed, which is reused if nbinv >= na - nb + 1.
+ */
+
+static int
+_GMPy_Nmod_Poly_Divrem(const gmpy_nmod *mod, mp_limb_t *q, mp_limb_t *r,
+                       const mp_limb_t *a, Py_ssize_t na,
+                       const mp_limb_t *b, Py_ssize_t nb,
+                       const mp_limb_t *binv, Py_ssize_t nbinv, int threads)
+{
+    mp_limb_t *w, *t, c, linv;
+    Py_ssize_t i, j, nq = na - nb + 1;
+    int rc = -1;
+
+    if (nb <= GMPY_NMOD_DIV_BASECASE || nq <= GMPY_NMOD_DIV_BASECASE) {
+        if (!(w = PyMem_RawMalloc((na + nb) * sizeof(mp_limb_t))))
+            return -1;
+        t = w + na;
+        for (i = 0; i < na; i++)
+            w[i] = a[i];
+        for (j = 0; j < nb; j++)
+            t[j] = NMOD_TO(mod, b[j]);
+        linv = NMOD_TO(mod, _GMPy_Nmod_Inv(mod, b[nb - 1]));
+        for (i = na - 1; i >= nb - 1; i--) {
+            c = NMOD_MUL(mod, w[i], linv);
+            if (q)
+                q[i - nb + 1] = c;
+            if (!c)
+                continue;
+            for (j = 0; j < nb - 1; j++)
+                w[i - nb + 1 + j] = NMOD_SUB(mod, w[i - nb + 1 + j], NMOD_MUL(mod, c, t[j]));
+        }
+        if (r) {
+            for (i = 0; i < nb - 1; i++)
+                r[i] = w[i];
+        }
+        PyMem_RawFree(w);
+        return 0;
+    }
+
+    /* rev(q) = rev(a)/rev(b) modulo x**nq. */
+
+    if (!(w = PyMem_RawMalloc((3 * nq + nb) * sizeof(mp_limb_t))))
+        return -1;
+    t = w + nq;
+    if (!binv || nbinv < nq) {
+        for (j = 0; j < nb && j < nq; j++)
+            t[j] = b[nb - 1 - j];
+        if (_GMPy_Nmod_Poly_Inv_Series(mod, t + nq, nq, t, j, threads) < 0)
+            goto done;
+        binv = t + nq;
+    }
+    for (i = 0; i < nq; i++)
+        w[i] = a[na - 1 - i];
+    if (_GMPy_Nmod_Poly_Mullow(mod, t, nq, w, nq, binv, nq, threads) < 0)
+        goto done;
+    if (!q)
+        q = t + nq;
+    for (i = 0; i < nq; i++)
+        q[i] = t[nq - 1 - i];
+
+    /* Only the low nb - 1 coefficients of q*b are needed. */
+
+    if (r && nb > 1) {
+        if (_GMPy_Nmod_Poly_Mullow(mod, t + 2 * nq, nb - 1, q, nq, b, nb, threads) < 0)
+            goto done;
+        for (i = 0; i < nb - 1; i++)
+            r[i] = NMOD_SUB(mod, a[i], t[2 * nq + i]);
+    }
+    rc = 0;
+
+  done:
+    PyMem_RawFree(w);
+    return rc;
+}
+
+static mp_limb_t
+_GMPy_Nmod_Poly_Horner(const gmpy_nmod *mod, const mp_limb_t *c, Py_ssize_t n,
+                       mp_limb_t x)
+{
+    mp_limb_t y = 0;
+
+    x = NMOD_TO(mod, x);
+    while (n-- > 0)
+        y = NMOD_ADD(mod, NMOD_MUL(mod, y, x), c[n]);
+    return y;
+}
+
+/* Evaluation at many points. The points are split into leaves of
+ * GMPY_NMOD_EVAL_LEAF points. Node i of level k covers the points
+ * [start, stop) with start = i*GMPY_NMOD_EVAL_LEAF*2**k; its product of
+ * x - x[j] has stop - start + 1 coefficients at offset start + i of
+ * tree[k], and its remainder has stop - start coefficients at offset start
+ * of rem[k].
+ */
+
+typedef struct {
+    const gmpy_nmod *mod;
+    const mp_limb_t *f;
+    Py_ssize_t nf;
+    const mp_limb_t *x;
+    mp_limb_t *y;
+    Py_ssize_t n;
+    mp_limb_t **tree;
+    mp_limb_t **rem;
+    int level;
+    int threads;
+    int failed;
+} gmpy_nmod_eval_work;
+
+#define NMOD_NODE_START(w, k, i) \
+    ((i) * ((Py_ssize_t)GMPY_NMOD_EVAL_LEAF << (k)))
+#define NMOD_NODE_STOP(w, k, i) \
+    (NMOD_NODE_START(w, k, (i) + 1) < (w)->n ? NMOD_NODE_START(w, k, (i) + 1) : (w)->n)
+
+static void
+_GMPy_Nmod_Eval_Horner_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_nmod_eval_work *work = (gmpy_nmod_eval_work*)arg;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++)
+        work->y[i] = _GMPy_Nmod_Poly_Horner(work->mod, work->f, work->nf, work->x[i]);
+}
+
+/* The products of the leaves, one linear factor at a time. */
+
+static void
+_GMPy_Nmod_Eval_Leaf_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_nmod_eval_work *work = (gmpy_nmod_eval_work*)arg;
+    const gmpy_nmod *mod = work->mod;
+    Py_ssize_t i, j, k, lo, hi;
+    mp_limb_t *c, xr;
+
+    for (i = start; i < stop; i++) {
+        lo = NMOD_NODE_START(work, 0, i);
+        hi = NMOD_NODE_STOP(work, 0, i);
+        c = work->tree[0] + lo + i;
+        c[0] = 1;
+        for (j = lo; j < hi; j++) {
+
+            /* c = c*(x - x[j]) with deg c = j - lo. */
+
+            xr = NMOD_TO(mod, work->x[j]);
+            k = j - lo + 1;
+            c[k] = c[k - 1];
+            for (k--; k > 0; k--)
+                c[k] = NMOD_SUB(mod, c[k - 1], NMOD_MUL(mod, c[k], xr));
+            c[0] = NMOD_SUB(mod, 0, NMOD_MUL(mod, c[0], xr));
+        }
+    }
+}
+
+static void
+_GMPy_Nmod_Eval_Build_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_nmod_eval_work *work = (gmpy_nmod_eval_work*)arg;
+    int k = work->level;
+    Py_ssize_t i, lo, mid, hi;
+    mp_limb_t *c, *a;
+
+    for (i = start; i < stop; i++) {
+        lo = NMOD_NODE_START(work, k, i);
+        hi = NMOD_NODE_STOP(work, k, i);
+        mid = NMOD_NODE_STOP(work, k - 1, 2 * i);
+        c = work->tree[k] + lo + i;
+        a = work->tree[k - 1] + lo + 2 * i;
+        if (mid == hi) {
+            memcpy(c, a, (hi - lo + 1) * sizeof(mp_limb_t));
+        }
+        else if (_GMPy_Nmod_Poly_Mullow(work->mod, c, hi - lo + 1, a, mid - lo + 1,
+                                        work->tree[k - 1] + mid + 2 * i + 1,
+                                        hi - mid + 1, work->threads) < 0) {
+            work->failed = 1;
+        }
+    }
+}
+
+/* Reduce the remainders of level k + 1 by the nodes of level k. */
+
+static void
+_GMPy_Nmod_Eval_Reduce_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_nmod_eval_work *work = (gmpy_nmod_eval_work*)arg;
+    int k = work->level;
+    Py_ssize_t i, lo, hi, plo, phi;
+    const mp_limb_t *a;
+
+    for (i = start; i < stop; i++) {
+        lo = NMOD_NODE_START(work, k, i);
+        hi = NMOD_NODE_STOP(work, k, i);
+        plo = NMOD_NODE_START(work, k + 1, i / 2);
+        phi = NMOD_NODE_STOP(work, k + 1, i / 2);
+        a = work->rem[k + 1] + plo;
+        if (phi - plo <= hi - lo) {
+            memcpy(work->rem[k] + lo, a, (hi - lo) * sizeof(mp_limb_t));
+        }
+        else if (_GMPy_Nmod_Poly_Divrem(work->mod, NULL, work->rem[k] + lo,
+                                        a, phi - plo, work->tree[k] + lo + i,
+                                        hi - lo + 1, NULL, 0, work->threads) < 0) {
+            work->failed = 1;
+        }
+    }
+}
+
+static void
+_GMPy_Nmod_Eval_Leaf_Horner_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_nmod_eval_work *work = (gmpy_nmod_eval_work*)arg;
+    Py_ssize_t i, j, lo, hi;
+
+    for (i = start; i < stop; i++) {
+        lo = NMOD_NODE_START(work, 0, i);
+        hi = NMOD_NODE_STOP(work, 0, i);
+        for (j = lo; j < hi; j++)
+            work->y[j] = _GMPy_Nmod_Poly_Horner(work->mod, work->rem[0] + lo,
+                                                hi - lo, work->x[j]);
+    }
+}
+
+/* Run func over the nodes of a level: in parallel over the nodes if there
+ * are enough of them, otherwise one node at a time with the threads used
+ * inside each product.
+ */
+
+static void
+_GMPy_Nmod_Eval_Level(gmpy_nmod_eval_work *work, void (*func)(void*, Py_ssize_t, Py_ssize_t),
+                      Py_ssize_t nodes, int threads)
+{
+    if (nodes >= threads) {
+        work->threads = 1;
+        GMPy_Parallel_Run(func, work, nodes, threads);
+    }
+    else {
+        work->threads = threads;
+        func(work, 0, nodes);
+    }
+}
+
+/* Set y[i] to f(x[i]) for the n points x[i] in [0, p). */
+
+static int
+_GMPy_Nmod_Poly_Evaluate(const gmpy_nmod *mod, mp_limb_t *y,
+                         const mp_limb_t *f, Py_ssize_t nf,
+                         const mp_limb_t *x, Py_ssize_t n, int threads)
+{
+    gmpy_nmod_eval_work work;
+    Py_ssize_t nodes, leaves;
+    int k, depth;
+
+    work.mod = mod;
+    work.f = f;
+    work.nf = nf;
+    work.x = x;
+    work.y = y;
+    work.n = n;
+    work.failed = 0;
+
+    if (n <= GMPY_NMOD_EVAL_LEAF || nf <= GMPY_NMOD_EVAL_LEAF) {
+        GMPy_Parallel_Run(_GMPy_Nmod_Eval_Horner_Range, &work, n, threads);
+        return 0;
+    }
+
+    leaves = (n + GMPY_NMOD_EVAL_LEAF - 1) / GMPY_NMOD_EVAL_LEAF;
+    for (depth = 1; ((Py_ssize_t)1 << (depth - 1)) < leaves; depth++)
+        ;
+    if (!(work.tree = PyMem_RawCalloc(2 * depth, sizeof(mp_limb_t*))))
+        return -1;
+    work.rem = work.tree + depth;
+    for (k = 0; k < depth; k++) {
+        nodes = (leaves + ((Py_ssize_t)1 << k) - 1) >> k;
+        if (!(work.tree[k] = PyMem_RawMalloc((n + nodes) * sizeof(mp_limb_t))) ||
+            !(work.rem[k] = PyMem_RawMalloc(n * sizeof(mp_limb_t)))) {
+            work.failed = 1;
+            goto done;
+        }
+    }
+
+    _GMPy_Nmod_Eval_Level(&work, _GMPy_Nmod_Eval_Leaf_Range, leaves, threads);
+    for (k = 1; k < depth && !work.failed; k++) {
+        work.level = k;
+        _GMPy_Nmod_Eval_Level(&work, _GMPy_Nmod_Eval_Build_Range,
+                              (leaves + ((Py_ssize_t)1 << k) - 1) >> k, threads);
+    }
+    if (work.failed)
+        goto done;
+
+    /* The root covers all the points. */
+
+    if (nf <= n) {
+        memcpy(work.rem[depth - 1], f, nf * sizeof(mp_limb_t));
+        memset(work.rem[depth - 1] + nf, 0, (n - nf) * sizeof(mp_limb_t));
+    }
+    else if (_GMPy_Nmod_Poly_Divrem(mod, NULL, work.rem[depth - 1], f, nf,
+                                    work.tree[depth - 1], n + 1, NULL, 0, threads) < 0) {
+        work.failed = 1;
+        goto done;
+    }
+    for (k = depth - 2; k >= 0 && !work.failed; k--) {
+        work.level = k;
+        _GMPy_Nmod_Eval_Level(&work, _GMPy_Nmod_Eval_Reduce_Range,
+                              (leaves + ((Py_ssize_t)1 << k) - 1) >> k, threads);
+    }
+    if (!work.failed)
+        GMPy_Parallel_Run(_GMPy_Nmod_Eval_Leaf_Horner_Range, &work, leaves, threads);
+
+  done:
+    for (k = 0; k < depth; k++) {
+        PyMem_RawFree(work.tree[k]);
+        PyMem_RawFree(work.rem[k]);
+    }
+    PyMem_RawFree(work.tree);
+    return work.failed ? -1 : 0;
+}
+
+/* Set r[0:(nf-1)*e+1] to f**e for e >= 1. f must be normalized, so every
+ * power has a nonzero leading coefficient.
+ */
+
+static int
+_GMPy_Nmod_Poly_Pow(const gmpy_nmod *mod, mp_limb_t *r, const mp_limb_t *f,
+                    Py_ssize_t nf, mpz_srcptr e, int threads)
+{
+    mp_bitcnt_t bit = mpz_sizeinbase(e, 2) - 1;
+    mp_limb_t *x = r, *t, *buf, *swap;
+    Py_ssize_t nx = nf, nr = (nf - 1) * (Py_ssize_t)mpz_get_ui(e) + 1;
+    int rc = 0;
+
+    if (!(buf = PyMem_RawMalloc(nr * sizeof(mp_limb_t))))
+        return -1;
+    t = buf;
+    memcpy(x, f, nf * sizeof(mp_limb_t));
+    while (bit-- > 0 && !GMPy_Interrupt_Poll()) {
+        if (_GMPy_Nmod_Poly_Mullow(mod, t, 2 * nx - 1, x, nx, x, nx, threads) < 0) {
+            rc = -1;
+            break;
+        }
+        nx = 2 * nx - 1;
+        swap = x;
+        x = t;
+        t = swap;
+        if (mpz_tstbit(e, bit)) {
+            if (_GMPy_Nmod_Poly_Mullow(mod, t, nx + nf - 1, x, nx, f, nf, threads) < 0) {
+                rc = -1;
+                break;
+            }
+            nx += nf - 1;
+            swap = x;
+            x = t;
+            t = swap;
+        }
+    }
+    if (x != r)
+        memcpy(r, x, nx * sizeof(mp_limb_t));
+    PyMem_RawFree(buf);
+    return rc;
+}
+
+/* Set r to t modulo g and return the length of r, or -1. */
+
+static Py_ssize_t
+_GMPy_Nmod_Poly_Reduce(const gmpy_nmod *mod, mp_limb_t *r, const mp_limb_t *t,
+                       Py_ssize_t nt, const mp_limb_t *g, Py_ssize_t ng,
+                       const mp_limb_t *binv, Py_ssize_t ninv, int threads)
+{
+    if (nt < ng) {
+        memcpy(r, t, nt * sizeof(mp_limb_t));
+        return _GMPy_Nmod_Poly_Len(r, nt);
+    }
+    if (_GMPy_Nmod_Poly_Divrem(mod, NULL, r, t, nt, g, ng, binv, ninv, threads) < 0)
+        return -1;
+    return _GMPy_Nmod_Poly_Len(r, ng - 1);
+}
+
+/* Set r[0:ng-1] to f**e modulo g, where nf < ng and ng >= 2. The inverse
+ * series of g reversed is computed once for all the reductions.
+ */
+
+static int
+_GMPy_Nmod_Poly_Powmod(const gmpy_nmod *mod, mp_limb_t *r, const mp_limb_t *f,
+                       Py_ssize_t nf, mpz_srcptr e, const mp_limb_t *g,
+                       Py_ssize_t ng, int threads)
+{
+    mp_bitcnt_t bit = mpz_sizeinbase(e, 2);
+    mp_limb_t *t, *binv = NULL, *rev;
+    Py_ssize_t i, nx = 1, ninv = ng - 2;
+    int rc = -1;
+
+    if (!(t = PyMem_RawMalloc((2 * ng + 2 * ninv) * sizeof(mp_limb_t))))
+        return -1;
+    if (ninv > 0) {
+        rev = t + 2 * ng;
+        binv = rev + ninv;
+        for (i = 0; i < ninv; i++)
+            rev[i] = g[ng - 1 - i];
+        if (_GMPy_Nmod_Poly_Inv_Series(mod, binv, ninv, rev, ninv, threads) < 0)
+            goto done;
+    }
+
+    r[0] = 1;
+    while (bit-- > 0 && nx && !GMPy_Interrupt_Poll()) {
+        if (_GMPy_Nmod_Poly_Mullow(mod, t, 2 * nx - 1, r, nx, r, nx, threads) < 0 ||
+            (nx = _GMPy_Nmod_Poly_Reduce(mod, r, t, 2 * nx - 1, g, ng, binv, ninv, threads)) < 0)
+            goto done;
+        if (mpz_tstbit(e, bit) && nx) {
+            if (_GMPy_Nmod_Poly_Mullow(mod, t, nx + nf - 1, r, nx, f, nf, threads) < 0 ||
+                (nx = _GMPy_Nmod_Poly_Reduce(mod, r, t, nx + nf - 1, g, ng, binv, ninv, threads)) < 0)
+                goto done;
+        }
+    }
+    for (i = nx; i < ng - 1; i++)
+        r[i] = 0;
+    rc = 0;
+
+  done:
+    PyMem_RawFree(t);
+    return rc;
+}
+
+PyDoc_STRVAR(GMPy_doc_nmod_poly,
+"nmod_poly(coeffs, modulus, /) -> nmod_poly\n\n"
+"Return the polynomial with the integer coefficients coeffs, lowest\n"
+"degree first, reduced modulo modulus, which must be an odd prime less\n"
+"than 2**64. coeffs may be a sequence of integers or an `mpz_array`.\n"
+"nmod_poly values with the same modulus, and integers, can be added,\n"
+"subtracted, multiplied, divided with //, % and divmod(), and raised to\n"
+"non-negative integer powers with an optional nmod_poly modulus. Calling\n"
+"an nmod_poly evaluates it at an integer. Large products use a number-\n"
+"theoretic transform and release the GIL.");
+
+static NmodPoly_Object *
+_GMPy_NmodPoly_New(const gmpy_nmod *mod, Py_ssize_t n)
+{
+    NmodPoly_Object *result;
+
+    if (!(result = PyObject_New(NmodPoly_Object, &NmodPoly_Type)))
+        return NULL;
+    result->mod = *mod;
+    result->n = n;
+    if (!(result->c = PyMem_New(mp_limb_t, n ? n : 1))) {
+        Py_DECREF((PyObject*)result);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    return result;
+}
+
+static void
+GMPy_NmodPoly_Dealloc(NmodPoly_Object *self)
+{
+    PyMem_Free(self->c);
+    PyObject_Free(self);
+}
+
+typedef struct {
+    const gmpy_nmod *mod;
+    mpz_srcptr *values;
+    mp_limb_t *c;
+} gmpy_nmod_set_work;
+
+static void
+_GMPy_Nmod_Set_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_nmod_set_work *work = (gmpy_nmod_set_work*)arg;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++)
+        work->c[i] = _GMPy_Nmod_From_MPZ(work->mod, work->values[i]);
+}
+
+/* Return the residues of a sequence of integers or an mpz_array as a new
+ * array, with *n set to its length, or NULL with an exception set.
+ */
+
+static mp_limb_t *
+_GMPy_Nmod_From_Sequence(const gmpy_nmod *mod, PyObject *obj, Py_ssize_t *n,
+                         const char *name, CTXT_Object *context)
+{
+    gmpy_rational_view view;
+    gmpy_nmod_set_work work;
+    mp_limb_t *result = NULL;
+
+    if (_GMPy_View_Init(&view, obj, name, context) < 0)
+        return NULL;
+    if (view.rational) {
+        PyErr_Format(PyExc_TypeError, "%s() requires integer arguments", name);
+        goto done;
+    }
+    if (!(result = PyMem_New(mp_limb_t, view.n ? view.n : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    work.mod = mod;
+    work.values = view.num;
+    work.c = result;
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, _GMPy_View_Bits(&view));
+    GMPy_Parallel_Run(_GMPy_Nmod_Set_Range, &work, view.n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    *n = view.n;
+
+  done:
+    _GMPy_View_Clear(&view);
+    return result;
+}
+
+static PyObject *
+_GMPy_Nmod_To_List(const mp_limb_t *c, Py_ssize_t n)
+{
+    PyObject *result;
+    MPZ_Object *temp;
+    Py_ssize_t i;
+
+    if (!(result = PyList_New(n)))
+        return NULL;
+    for (i = 0; i < n; i++) {
+        if (!(temp = GMPy_MPZ_New(NULL))) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        _GMPy_MPZ_Set_UInt64(temp->z, c[i]);
+        PyList_SET_ITEM(result, i, (PyObject*)temp);
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_NmodPoly_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "", NULL};
+    PyObject *coeffs, *modulus;
+    NmodPoly_Object *result;
+    MPZ_Object *tempm;
+    gmpy_nmod mod;
+    mp_limb_t *c;
+    Py_ssize_t n;
+    int prime;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO", kwlist, &coeffs, &modulus))
+        return NULL;
+    if (!IS_INTEGER(modulus)) {
+        TYPE_ERROR("nmod_poly() modulus must be an integer");
+        return NULL;
+    }
+    if (!(tempm = GMPy_MPZ_From_Integer(modulus, context)))
+        return NULL;
+    prime = mpz_odd_p(tempm->z) && mpz_cmp_ui(tempm->z, 3) >= 0 &&
+            mpz_sizeinbase(tempm->z, 2) <= 64 && _GMPy_MPZ_IsPrime(tempm->z, 25);
+    if (prime)
+        _GMPy_Nmod_Init(&mod, mpz_getlimbn(tempm->z, 0));
+    Py_DECREF((PyObject*)tempm);
+    if (!prime) {
+        VALUE_ERROR("nmod_poly() modulus must be an odd prime < 2**64");
+        return NULL;
+    }
+
+    if (!(c = _GMPy_Nmod_From_Sequence(&mod, coeffs, &n, "nmod_poly", context)))
+        return NULL;
+    if (!(result = PyObject_New(NmodPoly_Object, &NmodPoly_Type))) {
+        PyMem_Free(c);
+        return NULL;
+    }
+    result->mod = mod;
+    result->c = c;
+    result->n = _GMPy_Nmod_Poly_Len(c, n);
+    return (PyObject*)result;
+}
+
+/* Return x as an nmod_poly modulo the prime of mod. x must be an integer
+ * or an nmod_poly with the same modulus.
+ */
+
+static NmodPoly_Object *
+_GMPy_NmodPoly_From_Object(const gmpy_nmod *mod, PyObject *x, CTXT_Object *context)
+{
+    NmodPoly_Object *result;
+    MPZ_Object *tempx;
+
+    if (NmodPoly_Check(x)) {
+        if (((NmodPoly_Object*)x)->mod.m.n != mod->m.n) {
+            VALUE_ERROR("nmod_poly operands must have the same modulus");
+            return NULL;
+        }
+        Py_INCREF(x);
+        return (NmodPoly_Object*)x;
+    }
+
+    if (!(tempx = GMPy_MPZ_From_Integer(x, context)))
+        return NULL;
+    if ((result = _GMPy_NmodPoly_New(mod, 1))) {
+        result->c[0] = _GMPy_Nmod_From_MPZ(mod, tempx->z);
+        result->n = result->c[0] != 0;
+    }
+    Py_DECREF((PyObject*)tempx);
+    return result;
+}
+
+static PyObject *
+_GMPy_NmodPoly_AddSub(NmodPoly_Object *x, NmodPoly_Object *y, int sub)
+{
+    NmodPoly_Object *result;
+    const gmpy_nmod *mod = &x->mod;
+    Py_ssize_t i, n = x->n > y->n ? x->n : y->n;
+    mp_limb_t a, b;
+
+    if (!(result = _GMPy_NmodPoly_New(mod, n)))
+        return NULL;
+    for (i = 0; i < n; i++) {
+        a = i < x->n ? x->c[i] : 0;
+        b = i < y->n ? y->c[i] : 0;
+        result->c[i] = sub ? NMOD_SUB(mod, a, b) : NMOD_ADD(mod, a, b);
+    }
+    result->n = _GMPy_Nmod_Poly_Len(result->c, n);
+    return (PyObject*)result;
+}
+
+static PyObject *
+_GMPy_NmodPoly_Mul(NmodPoly_Object *x, NmodPoly_Object *y, CTXT_Object *context)
+{
+    NmodPoly_Object *result;
+    Py_ssize_t n = (x->n && y->n) ? x->n + y->n - 1 : 0;
+    int rc;
+
+    if (!(result = _GMPy_NmodPoly_New(&x->mod, n)))
+        return NULL;
+    if (!n)
+        return (PyObject*)result;
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)(x->n + y->n) * GMP_NUMB_BITS);
+    rc = _GMPy_Nmod_Poly_Mullow(&x->mod, result->c, n, x->c, x->n, y->c, y->n,
+                                GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    if (rc < 0) {
+        Py_DECREF((PyObject*)result);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)result;
+}
+
+/* Set *q and *r to the quotient and remainder of x by y; either may be
+ * NULL.
+ */
+
+static int
+_GMPy_NmodPoly_DivMod(NmodPoly_Object *x, NmodPoly_Object *y, NmodPoly_Object **q,
+                      NmodPoly_Object **r, CTXT_Object *context)
+{
+    NmodPoly_Object *tq = NULL, *tr = NULL;
+    const gmpy_nmod *mod = &x->mod;
+    Py_ssize_t nq, nr;
+    int rc;
+
+    if (!y->n) {
+        ZERO_ERROR("nmod_poly division by zero");
+        return -1;
+    }
+    nq = x->n >= y->n ? x->n - y->n + 1 : 0;
+    nr = x->n >= y->n ? y->n - 1 : x->n;
+    if ((q && !(tq = _GMPy_NmodPoly_New(mod, nq))) ||
+        (r && !(tr = _GMPy_NmodPoly_New(mod, nr)))) {
+        Py_XDECREF((PyObject*)tq);
+        return -1;
+    }
+
+    if (!nq) {
+        if (tr)
+            memcpy(tr->c, x->c, nr * sizeof(mp_limb_t));
+    }
+    else {
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)x->n * GMP_NUMB_BITS);
+        rc = _GMPy_Nmod_Poly_Divrem(mod, tq ? tq->c : NULL, tr ? tr->c : NULL,
+                                    x->c, x->n, y->c, y->n, NULL, 0,
+                                    GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+        if (rc < 0) {
+            Py_XDECREF((PyObject*)tq);
+            Py_XDECREF((PyObject*)tr);
+            PyErr_NoMemory();
+            return -1;
+        }
+        if (tr)
+            tr->n = _GMPy_Nmod_Poly_Len(tr->c, nr);
+    }
+    if (q)
+        *q = tq;
+    if (r)
+        *r = tr;
+    return 0;
+}
+
+enum { NMOD_OP_ADD, NMOD_OP_SUB, NMOD_OP_MUL, NMOD_OP_FLOORDIV, NMOD_OP_MOD,
+       NMOD_OP_DIVMOD };
+
+static PyObject *
+_GMPy_NmodPoly_Binary(PyObject *x, PyObject *y, int op)
+{
+    NmodPoly_Object *tempx = NULL, *tempy = NULL, *q = NULL, *r = NULL;
+    const gmpy_nmod *mod;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+
+    if (!(NmodPoly_Check(x) || IS_INTEGER(x)) || !(NmodPoly_Check(y) || IS_INTEGER(y)))
+        Py_RETURN_NOTIMPLEMENTED;
+
+    CHECK_CONTEXT(context);
+
+    mod = NmodPoly_Check(x) ? &((NmodPoly_Object*)x)->mod : &((NmodPoly_Object*)y)->mod;
+    if (!(tempx = _GMPy_NmodPoly_From_Object(mod, x, context)) ||
+        !(tempy = _GMPy_NmodPoly_From_Object(mod, y, context)))
+        goto done;
+
+    switch (op) {
+    case NMOD_OP_ADD:
+    case NMOD_OP_SUB:
+        result = _GMPy_NmodPoly_AddSub(tempx, tempy, op == NMOD_OP_SUB);
+        break;
+    case NMOD_OP_MUL:
+        result = _GMPy_NmodPoly_Mul(tempx, tempy, context);
+        break;
+    case NMOD_OP_FLOORDIV:
+        if (_GMPy_NmodPoly_DivMod(tempx, tempy, &q, NULL, context) == 0)
+            result = (PyObject*)q;
+        break;
+    case NMOD_OP_MOD:
+        if (_GMPy_NmodPoly_DivMod(tempx, tempy, NULL, &r, context) == 0)
+            result = (PyObject*)r;
+        break;
+    default:
+        if (_GMPy_NmodPoly_DivMod(tempx, tempy, &q, &r, context) == 0) {
+            result = PyTuple_Pack(2, (PyObject*)q, (PyObject*)r);
+            Py_DECREF((PyObject*)q);
+            Py_DECREF((PyObject*)r);
+        }
+        break;
+    }
+
+  done:
+    Py_XDECREF((PyObject*)tempx);
+    Py_XDECREF((PyObject*)tempy);
+    return result;
+}
+
+static PyObject *
+GMPy_NmodPoly_Add_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_NmodPoly_Binary(x, y, NMOD_OP_ADD);
+}
+
+static PyObject *
+GMPy_NmodPoly_Sub_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_NmodPoly_Binary(x, y, NMOD_OP_SUB);
+}
+
+static PyObject *
+GMPy_NmodPoly_Mul_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_NmodPoly_Binary(x, y, NMOD_OP_MUL);
+}
+
+static PyObject *
+GMPy_NmodPoly_FloorDiv_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_NmodPoly_Binary(x, y, NMOD_OP_FLOORDIV);
+}
+
+static PyObject *
+GMPy_NmodPoly_Mod_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_NmodPoly_Binary(x, y, NMOD_OP_MOD);
+}
+
+static PyObject *
+GMPy_NmodPoly_DivMod_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_NmodPoly_Binary(x, y, NMOD_OP_DIVMOD);
+}
+
+static PyObject *
+GMPy_NmodPoly_Neg_Slot(NmodPoly_Object *x)
+{
+    NmodPoly_Object *result;
+    Py_ssize_t i;
+
+    if ((result = _GMPy_NmodPoly_New(&x->mod, x->n))) {
+        for (i = 0; i < x->n; i++)
+            result->c[i] = NMOD_SUB(&x->mod, 0, x->c[i]);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_NmodPoly_Pos_Slot(NmodPoly_Object *x)
+{
+    Py_INCREF((PyObject*)x);
+    return (PyObject*)x;
+}
+
+static int
+GMPy_NmodPoly_NonZero_Slot(NmodPoly_Object *x)
+{
+    return x->n != 0;
+}
+
+/* The constant c**e for c != 0. */
+
+static NmodPoly_Object *
+_GMPy_NmodPoly_Pow_Const(const gmpy_nmod *mod, mp_limb_t c, mpz_srcptr e)
+{
+    NmodPoly_Object *result;
+    mp_size_t size = mpz_size(e);
+
+    if ((result = _GMPy_NmodPoly_New(mod, 1))) {
+
+        /* c**(p-1) = 1, so the exponent is reduced modulo p - 1. */
+
+        result->c[0] = _GMPy_Nmod_Pow(mod, c, size ?
+                                      mpn_mod_1(mpz_limbs_read(e), size, mod->m.n - 1) : 0);
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_NmodPoly_Pow_Slot(PyObject *base, PyObject *exp, PyObject *m)
+{
+    NmodPoly_Object *x, *result = NULL, *tempm = NULL, *tempr = NULL;
+    MPZ_Object *tempe;
+    gmpy_interrupt intr;
+    Py_ssize_t n;
+    int rc, threads;
+    CTXT_Object *context = NULL;
+
+    if (!NmodPoly_Check(base) || !IS_INTEGER(exp) ||
+        !(m == Py_None || NmodPoly_Check(m) || IS_INTEGER(m)))
+        Py_RETURN_NOTIMPLEMENTED;
+
+    CHECK_CONTEXT(context);
+
+    x = (NmodPoly_Object*)base;
+    if (!(tempe = GMPy_MPZ_From_Integer(exp, context)))
+        return NULL;
+    if (mpz_sgn(tempe->z) < 0) {
+        VALUE_ERROR("pow() of nmod_poly requires a non-negative exponent");
+        goto done;
+    }
+
+    if (m != Py_None) {
+        if (!(tempm = _GMPy_NmodPoly_From_Object(&x->mod, m, context)) ||
+            _GMPy_NmodPoly_DivMod(x, tempm, NULL, &tempr, context) < 0)
+            goto done;
+        x = tempr;
+        if (tempm->n == 1) {
+            result = _GMPy_NmodPoly_New(&x->mod, 0);
+            goto done;
+        }
+    }
+
+    /* The power of a constant is a constant. */
+
+    if (x->n <= 1) {
+        if (x->n && mpz_sgn(tempe->z))
+            result = _GMPy_NmodPoly_Pow_Const(&x->mod, x->c[0], tempe->z);
+        else if ((result = _GMPy_NmodPoly_New(&x->mod, 1)))
+            result->n = result->c[0] = !mpz_sgn(tempe->z);
+        goto done;
+    }
+
+    if (tempm) {
+        if (!(result = _GMPy_NmodPoly_New(&x->mod, tempm->n - 1)))
+            goto done;
+    }
+    else {
+        if (!mpz_fits_slong_p(tempe->z) ||
+            mpz_get_si(tempe->z) > (PY_SSIZE_T_MAX / (Py_ssize_t)sizeof(mp_limb_t) - 1) / (x->n - 1)) {
+            OVERFLOW_ERROR("nmod_poly power is too large");
+            goto done;
+        }
+        if (!mpz_sgn(tempe->z)) {
+            if ((result = _GMPy_NmodPoly_New(&x->mod, 1)))
+                result->c[0] = 1;
+            goto done;
+        }
+        n = (x->n - 1) * (Py_ssize_t)mpz_get_si(tempe->z) + 1;
+        if (!(result = _GMPy_NmodPoly_New(&x->mod, n)))
+            goto done;
+    }
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)result->n * GMP_NUMB_BITS);
+    intr.save = &_save;
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+    if (tempm)
+        rc = _GMPy_Nmod_Poly_Powmod(&x->mod, result->c, x->c, x->n, tempe->z,
+                                    tempm->c, tempm->n, threads);
+    else
+        rc = _GMPy_Nmod_Poly_Pow(&x->mod, result->c, x->c, x->n, tempe->z, threads);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (GMPy_Interrupt_End(&intr) < 0) {
+        Py_CLEAR(result);
+        goto done;
+    }
+    if (rc < 0) {
+        Py_CLEAR(result);
+        PyErr_NoMemory();
+        goto done;
+    }
+    result->n = _GMPy_Nmod_Poly_Len(result->c, result->n);
+
+  done:
+    Py_DECREF((PyObject*)tempe);
+    Py_XDECREF((PyObject*)tempm);
+    Py_XDECREF((PyObject*)tempr);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_NmodPoly_RichCompare_Slot(PyObject *a, PyObject *b, int op)
+{
+    NmodPoly_Object *tempa = NULL, *tempb = NULL;
+    const gmpy_nmod *mod;
+    PyObject *result = NULL;
+    int equal;
+    CTXT_Object *context = NULL;
+
+    if ((op != Py_EQ && op != Py_NE) ||
+        !(NmodPoly_Check(a) || IS_INTEGER(a)) || !(NmodPoly_Check(b) || IS_INTEGER(b)))
+        Py_RETURN_NOTIMPLEMENTED;
+
+    CHECK_CONTEXT(context);
+
+    /* Polynomials with different moduli are not equal. */
+
+    if (NmodPoly_Check(a) && NmodPoly_Check(b) &&
+        ((NmodPoly_Object*)a)->mod.m.n != ((NmodPoly_Object*)b)->mod.m.n) {
+        result = op == Py_EQ ? Py_False : Py_True;
+        Py_INCREF(result);
+        return result;
+    }
+
+    mod = NmodPoly_Check(a) ? &((NmodPoly_Object*)a)->mod : &((NmodPoly_Object*)b)->mod;
+    if ((tempa = _GMPy_NmodPoly_From_Object(mod, a, context)) &&
+        (tempb = _GMPy_NmodPoly_From_Object(mod, b, context))) {
+        equal = tempa->n == tempb->n &&
+                !memcmp(tempa->c, tempb->c, tempa->n * sizeof(mp_limb_t));
+        result = equal == (op == Py_EQ) ? Py_True : Py_False;
+        Py_INCREF(result);
+    }
+    Py_XDECREF((PyObject*)tempa);
+    Py_XDECREF((PyObject*)tempb);
+    return result;
+}
+
+static PyObject *
+GMPy_NmodPoly_Call_Slot(NmodPoly_Object *self, PyObject *args, PyObject *keywds)
+{
+    MPZ_Object *tempx, *result;
+    PyObject *x;
+    CTXT_Object *context = NULL;
+
+    if (keywds && PyDict_Size(keywds)) {
+        TYPE_ERROR("nmod_poly() takes no keyword arguments");
+        return NULL;
+    }
+    if (PyTuple_GET_SIZE(args) != 1 || !IS_INTEGER(PyTuple_GET_ITEM(args, 0))) {
+        TYPE_ERROR("nmod_poly() requires 1 integer argument");
+        return NULL;
+    }
+    x = PyTuple_GET_ITEM(args, 0);
+
+    CHECK_CONTEXT(context);
+
+    if (!(tempx = GMPy_MPZ_From_Integer(x, context)))
+        return NULL;
+    if ((result = GMPy_MPZ_New(context)))
+        _GMPy_MPZ_Set_UInt64(result->z,
+                             _GMPy_Nmod_Poly_Horner(&self->mod, self->c, self->n,
+                                                    _GMPy_Nmod_From_MPZ(&self->mod, tempx->z)));
+    Py_DECREF((PyObject*)tempx);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_nmod_poly_evaluate,
+"f.evaluate(points, /) -> list[mpz]\n\n"
+"Return [f(x) for x in points] for a sequence of integers or an\n"
+"`mpz_array`. Many points are evaluated together by reducing f down a\n"
+"tree of the products of x - points[i].");
+
+static PyObject *
+GMPy_NmodPoly_Evaluate(NmodPoly_Object *self, PyObject *other)
+{
+    PyObject *result = NULL;
+    mp_limb_t *x, *y = NULL;
+    Py_ssize_t n;
+    int rc;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(x = _GMPy_Nmod_From_Sequence(&self->mod, other, &n, "evaluate", context)))
+        return NULL;
+    if (!(y = PyMem_New(mp_limb_t, n ? n : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)(self->n + n) * GMP_NUMB_BITS);
+    rc = _GMPy_Nmod_Poly_Evaluate(&self->mod, y, self->c, self->n, x, n,
+                                  GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    if (rc < 0)
+        PyErr_NoMemory();
+    else
+        result = _GMPy_Nmod_To_List(y, n);
+
+  done:
+    PyMem_Free(x);
+    PyMem_Free(y);
+    return result;
+}
+
+static PyObject *
+GMPy_NmodPoly_GetCoeffs(NmodPoly_Object *self, void *closure)
+{
+    return _GMPy_Nmod_To_List(self->c, self->n);
+}
+
+static PyObject *
+GMPy_NmodPoly_GetModulus(NmodPoly_Object *self, void *closure)
+{
+    MPZ_Object *result;
+
+    if ((result = GMPy_MPZ_New(NULL)))
+        _GMPy_MPZ_Set_UInt64(result->z, self->mod.m.n);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_NmodPoly_GetDegree(NmodPoly_Object *self, void *closure)
+{
+    return PyLong_FromSsize_t(self->n - 1);
+}
+
+static PyObject *
+GMPy_NmodPoly_Repr_Slot(NmodPoly_Object *self)
+{
+    PyObject *coeffs, *temp, *result = NULL;
+    Py_ssize_t i;
+
+    if (!(coeffs = PyList_New(self->n)))
+        return NULL;
+    for (i = 0; i < self->n; i++) {
+        if (!(temp = PyLong_FromUnsignedLongLong(self->c[i]))) {
+            Py_DECREF(coeffs);
+            return NULL;
+        }
+        PyList_SET_ITEM(coeffs, i, temp);
+    }
+    result = PyUnicode_FromFormat("nmod_poly(%R, %llu)", coeffs,
+                                  (unsigned long long)self->mod.m.n);
+    Py_DECREF(coeffs);
+    return result;
+}
+
+static PyNumberMethods GMPy_NmodPoly_number_methods =
+{
+    .nb_add = (binaryfunc) GMPy_NmodPoly_Add_Slot,
+    .nb_subtract = (binaryfunc) GMPy_NmodPoly_Sub_Slot,
+    .nb_multiply = (binaryfunc) GMPy_NmodPoly_Mul_Slot,
+    .nb_remainder = (binaryfunc) GMPy_NmodPoly_Mod_Slot,
+    .nb_divmod = (binaryfunc) GMPy_NmodPoly_DivMod_Slot,
+    .nb_power = (ternaryfunc) GMPy_NmodPoly_Pow_Slot,
+    .nb_negative = (unaryfunc) GMPy_NmodPoly_Neg_Slot,
+    .nb_positive = (unaryfunc) GMPy_NmodPoly_Pos_Slot,
+    .nb_bool = (inquiry) GMPy_NmodPoly_NonZero_Slot,
+    .nb_floor_divide = (binaryfunc) GMPy_NmodPoly_FloorDiv_Slot,
+};
+
+static PyMethodDef GMPy_NmodPoly_methods[] =
+{
+    { "evaluate", (PyCFunction)GMPy_NmodPoly_Evaluate, METH_O, GMPy_doc_nmod_poly_evaluate },
+    { NULL }
+};
+
+static PyGetSetDef GMPy_NmodPoly_getseters[] =
+{
+    { "coeffs", (getter)GMPy_NmodPoly_GetCoeffs, NULL, "coefficients, lowest degree first", NULL },
+    { "degree", (getter)GMPy_NmodPoly_GetDegree, NULL, "degree, or -1 for the zero polynomial", NULL },
+    { "modulus", (getter)GMPy_NmodPoly_GetModulus, NULL, "prime modulus", NULL },
+    { NULL }
+};
+
+static PyTypeObject NmodPoly_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.nmod_poly",
+    .tp_basicsize = sizeof(NmodPoly_Object),
+    .tp_dealloc = (destructor) GMPy_NmodPoly_Dealloc,
+    .tp_repr = (reprfunc) GMPy_NmodPoly_Repr_Slot,
+    .tp_as_number = &GMPy_NmodPoly_number_methods,
+    .tp_hash = PyObject_HashNotImplemented,
+    .tp_call = (ternaryfunc) GMPy_NmodPoly_Call_Slot,
+    .tp_richcompare = (richcmpfunc) GMPy_NmodPoly_RichCompare_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_nmod_poly,
+    .tp_methods = GMPy_NmodPoly_methods,
+    .tp_getset = GMPy_NmodPoly_getseters,
+    .tp_new = GMPy_NmodPoly_NewInit,
+};
+
+#endif /* defined(GMPY_MONT_INT128) */
@@ -0,0 +1,63 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_nmod_poly.h                                                       *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_NMOD_POLY_H
+#define GMPY_NMOD_POLY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Polynomials modulo an odd prime p < 2**64. The coefficients are residues
+ * in [0, p), lowest degree first, with no trailing zeros; the zero
+ * polynomial has no coefficients. The arithmetic needs GMPY_MONT_INT128,
+ * so nmod_poly is only present when that is available.
+ */
+
+#ifdef GMPY_MONT_INT128
+
+typedef struct {
+    gmpy_u64_mont m;
+    int ntt_bits;               /* 2-adic valuation of p - 1 if p < 2**62 */
+    mp_limb_t ntt_root;         /* a root of unity of order 2**ntt_bits */
+} gmpy_nmod;
+
+typedef struct {
+    PyObject_HEAD
+    gmpy_nmod mod;
+    Py_ssize_t n;               /* number of coefficients */
+    mp_limb_t *c;
+} NmodPoly_Object;
+
+static PyTypeObject NmodPoly_Type;
+#define NmodPoly_Check(v) (((PyObject*)v)->ob_type == &NmodPoly_Type)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,539 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_parallel.c                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* See gmpy2_parallel.h. The pool is shared by all interpreters. pool_lock,
+ * allocated by GMPy_Pool_Init(), protects the queue, the stack of idle
+ * workers, and the counters; it is only held for a few instructions.
+ */
+
+typedef struct gmpy_pool_worker {
+    struct gmpy_pool_worker *next;
+    PyThread_type_lock wake;    /* released when a job is handed over */
+    gmpy_pool_job *job;
+    unsigned long generation;   /* pool_generation when it was started */
+    int cpu;                    /* the CPU it is pinned to, or -1 */
+} gmpy_pool_worker;
+
+static int gmpy_pool_threads = 1;
+
+static PyThread_type_lock pool_lock = NULL;
+static gmpy_pool_job *pool_head = NULL;
+static gmpy_pool_job *pool_tail = NULL;
+static gmpy_pool_worker *pool_idle = NULL;
+static int pool_workers = 0;
+static unsigned long pool_generation = 0;
+static unsigned long long pool_started = 0;
+static unsigned long long pool_jobs = 0;
+static long long pool_busy_ns = 0;
+static int pool_pin = 0;
+
+#ifdef GMPY_POOL_AFFINITY
+static int pool_cpus[CPU_SETSIZE];
+static int pool_ncpus = 0;
+#endif
+
+#ifndef _WIN32
+/* Only the thread that called fork() exists in the child. The workers of
+ * the parent are gone, so the pool starts over; their memory is leaked.
+ */
+
+static void
+_GMPy_Pool_After_Fork(void)
+{
+    pool_lock = PyThread_allocate_lock();
+    pool_head = pool_tail = NULL;
+    pool_idle = NULL;
+    pool_workers = 0;
+}
+#endif
+
+static int
+GMPy_Pool_Init(void)
+{
+    const char *env = getenv("GMPY2_NUM_THREADS");
+    long n;
+
+    if (!(pool_lock = PyThread_allocate_lock())) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+#ifndef _WIN32
+    pthread_atfork(NULL, NULL, _GMPy_Pool_After_Fork);
+#endif
+    if (env && (n = atol(env)) > 0 && n <= INT_MAX)
+        gmpy_pool_threads = (int)n;
+    return 0;
+}
+
+/* The number of CPUs the process may use: the CPUs in its affinity mask,
+ * limited by the CPU quota of its cgroup and rounded up. Other platforms
+ * use os.cpu_count(). Called with the GIL held.
+ */
+
+#ifdef GMPY_POOL_AFFINITY
+static long
+_GMPy_Pool_Cgroup_Quota(void)
+{
+    char line[512], path[600];
+    long long quota = 0, period = 0;
+    FILE *f;
+    size_t len;
+
+    /* cgroup v2: cpu.max of the process's group holds "quota period" or
+     * "max period". */
+
+    path[0] = 0;
+    if ((f = fopen("/proc/self/cgroup", "r"))) {
+        while (fgets(line, sizeof(line), f)) {
+            if (!strncmp(line, "0::", 3)) {
+                len = strcspn(line + 3, "\n");
+                line[3 + len] = 0;
+                PyOS_snprintf(path, sizeof(path), "/sys/fs/cgroup%s/cpu.max",
+                              strcmp(line + 3, "/") ? line + 3 : "");
+                break;
+            }
+        }
+        fclose(f);
+    }
+    if (!path[0] || !(f = fopen(path, "r")))
+        f = fopen("/sys/fs/cgroup/cpu.max", "r");
+    if (f) {
+        if (fscanf(f, "%lld %lld", &quota, &period) != 2)
+            quota = 0;
+        fclose(f);
+    }
+
+    /* cgroup v1 */
+
+    else if ((f = fopen("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", "r"))) {
+        if (fscanf(f, "%lld", &quota) != 1)
+            quota = 0;
+        fclose(f);
+        if ((f = fopen("/sys/fs/cgroup/cpu/cpu.cfs_period_us", "r"))) {
+            if (fscanf(f, "%lld", &period) != 1)
+                period = 0;
+            fclose(f);
+        }
+    }
+    if (quota <= 0 || period <= 0)
+        return 0;
+    return (long)((quota + period - 1) / period);
+}
+#endif
+
+static long
+_GMPy_Pool_CPUs(void)
+{
+    long n = 0;
+#ifdef GMPY_POOL_AFFINITY
+    cpu_set_t set;
+    long quota = _GMPy_Pool_Cgroup_Quota();
+
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        n = CPU_COUNT(&set);
+    else
+        n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (quota > 0 && quota < n)
+        n = quota;
+#else
+    PyObject *os, *count;
+
+    if ((os = PyImport_ImportModule("os"))) {
+        if ((count = PyObject_CallMethod(os, "cpu_count", NULL))) {
+            if (PyLong_Check(count))
+                n = PyLong_AsLong(count);
+            Py_DECREF(count);
+        }
+        Py_DECREF(os);
+    }
+    PyErr_Clear();
+#endif
+    return n < 1 ? 1 : n;
+}
+
+static void
+_GMPy_Pool_Worker(void *arg)
+{
+    gmpy_pool_worker *self = (gmpy_pool_worker*)arg, **p;
+    gmpy_pool_job *job = self->job;
+    long long start;
+
+#ifdef GMPY_POOL_AFFINITY
+    if (self->cpu >= 0) {
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(self->cpu, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+#endif
+
+    while (job) {
+        start = GMPy_Monotonic();
+        job->run(job);
+
+        PyThread_acquire_lock(pool_lock, WAIT_LOCK);
+        pool_jobs++;
+        pool_busy_ns += GMPy_Monotonic() - start;
+        if ((job = pool_head)) {
+            if (!(pool_head = job->next))
+                pool_tail = NULL;
+            PyThread_release_lock(pool_lock);
+            continue;
+        }
+
+        /* Workers started before the last set_num_threads() exit instead
+         * of waiting for work. */
+
+        if (self->generation != pool_generation) {
+            pool_workers--;
+            PyThread_release_lock(pool_lock);
+            break;
+        }
+        self->job = NULL;
+        self->next = pool_idle;
+        pool_idle = self;
+        PyThread_release_lock(pool_lock);
+
+        if (PyThread_acquire_lock_timed(self->wake, GMPY_POOL_IDLE_US, 0) ==
+            PY_LOCK_ACQUIRED) {
+            job = self->job;
+            continue;
+        }
+
+        /* A job may have been handed over, or set_num_threads() may have
+         * released the worker, just after the timeout. */
+
+        PyThread_acquire_lock(pool_lock, WAIT_LOCK);
+        for (p = &pool_idle; *p && *p != self; p = &(*p)->next)
+            ;
+        if (*p) {
+            *p = self->next;
+            pool_workers--;
+        }
+        else {
+            PyThread_acquire_lock(self->wake, WAIT_LOCK);
+            job = self->job;
+        }
+        PyThread_release_lock(pool_lock);
+    }
+    PyThread_free_lock(self->wake);
+    PyMem_RawFree(self);
+    GMPy_Scratch_Free();
+}
+
+/* Start a worker for job. Called with pool_lock held. Returns NULL if
+ * that is not possible.
+ */
+
+static gmpy_pool_worker *
+_GMPy_Pool_New_Worker(gmpy_pool_job *job)
+{
+    gmpy_pool_worker *worker;
+
+    if (!(worker = PyMem_RawMalloc(sizeof(gmpy_pool_worker))))
+        return NULL;
+    worker->next = NULL;
+    worker->job = job;
+    worker->generation = pool_generation;
+    worker->cpu = -1;
+#ifdef GMPY_POOL_AFFINITY
+    if (pool_pin && pool_ncpus > 0)
+        worker->cpu = pool_cpus[pool_started % pool_ncpus];
+#endif
+    if (!(worker->wake = PyThread_allocate_lock())) {
+        PyMem_RawFree(worker);
+        return NULL;
+    }
+    PyThread_acquire_lock(worker->wake, WAIT_LOCK);
+    if (PyThread_start_new_thread(_GMPy_Pool_Worker, worker) ==
+        PYTHREAD_INVALID_THREAD_ID) {
+        PyThread_free_lock(worker->wake);
+        PyMem_RawFree(worker);
+        return NULL;
+    }
+    pool_started++;
+    return worker;
+}
+
+/* Hand job to an idle worker, start a new worker if there are fewer than
+ * threads, or queue it. Returns -1 if there is no worker at all.
+ */
+
+static int
+GMPy_Pool_Submit(gmpy_pool_job *job, int threads)
+{
+    gmpy_pool_worker *worker;
+    int result = 0;
+
+    PyThread_acquire_lock(pool_lock, WAIT_LOCK);
+    if ((worker = pool_idle)) {
+        pool_idle = worker->next;
+        worker->job = job;
+        PyThread_release_lock(worker->wake);
+    }
+    else if (pool_workers < threads && _GMPy_Pool_New_Worker(job)) {
+        pool_workers++;
+    }
+    else if (pool_workers > 0) {
+        job->next = NULL;
+        if (pool_tail)
+            pool_tail->next = job;
+        else
+            pool_head = job;
+        pool_tail = job;
+    }
+    else {
+        result = -1;
+    }
+    PyThread_release_lock(pool_lock);
+    return result;
+}
+
+/* Remove job from the queue. Returns 1 if it was still queued, 0 if a
+ * worker has taken it.
+ */
+
+static int
+GMPy_Pool_Cancel(gmpy_pool_job *job)
+{
+    gmpy_pool_job **p, *prev = NULL;
+    int result = 0;
+
+    PyThread_acquire_lock(pool_lock, WAIT_LOCK);
+    for (p = &pool_head; *p; prev = *p, p = &(*p)->next) {
+        if (*p == job) {
+            *p = job->next;
+            if (pool_tail == job)
+                pool_tail = prev;
+            result = 1;
+            break;
+        }
+    }
+    PyThread_release_lock(pool_lock);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_set_num_threads,
+"set_num_threads(n=None, /, *, pin=False) -> None\n\n"
+"Set the number of native threads used by a context whose `threads` is\n"
+"0, the default. n=None uses the number of CPUs the process may use,\n"
+"taking its CPU affinity and, on Linux, the CPU quota of its cgroup into\n"
+"account. The workers are shared by `submit()` and all functions that\n"
+"split their work over threads. With pin=True, workers started from now\n"
+"on are bound to one CPU each (Linux only). Idle workers exit at once.\n"
+"The initial value is 1, or the environment variable GMPY2_NUM_THREADS.");
+
+static PyObject *
+GMPy_Set_Num_Threads(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"n", "pin", NULL};
+    PyObject *arg = Py_None;
+    gmpy_pool_worker *idle;
+    int pin = 0;
+    long n;
+#ifdef GMPY_POOL_AFFINITY
+    cpu_set_t set;
+    int cpu, count = 0;
+#endif
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O$p", kwlist, &arg, &pin))
+        return NULL;
+
+    if (arg == Py_None) {
+        n = _GMPy_Pool_CPUs();
+    }
+    else {
+        if (!PyLong_Check(arg)) {
+            TYPE_ERROR("set_num_threads() requires an integer or None");
+            return NULL;
+        }
+        n = PyLong_AsLong(arg);
+        if (n < 1 || n > INT_MAX) {
+            if (!PyErr_Occurred() || PyErr_ExceptionMatches(PyExc_OverflowError)) {
+                PyErr_Clear();
+                VALUE_ERROR("set_num_threads() requires n >= 1");
+            }
+            return NULL;
+        }
+    }
+
+#ifdef GMPY_POOL_AFFINITY
+    if (pin && sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set))
+                pool_cpus[count++] = cpu;
+        }
+    }
+#endif
+
+    PyThread_acquire_lock(pool_lock, WAIT_LOCK);
+    gmpy_pool_threads = (int)n;
+    pool_pin = pin;
+#ifdef GMPY_POOL_AFFINITY
+    pool_ncpus = pin ? count : 0;
+#endif
+    pool_generation++;
+    while ((idle = pool_idle)) {
+        pool_idle = idle->next;
+        idle->job = NULL;
+        pool_workers--;
+        PyThread_release_lock(idle->wake);
+    }
+    PyThread_release_lock(pool_lock);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_get_num_threads,
+"get_num_threads() -> int\n\n"
+"Return the number of native threads used by a context whose `threads`\n"
+"is 0. See `set_num_threads()`.");
+
+static PyObject *
+GMPy_Get_Num_Threads(PyObject *self, PyObject *args)
+{
+    return PyLong_FromLong(gmpy_pool_threads);
+}
+
+PyDoc_STRVAR(GMPy_doc_thread_pool_info,
+"thread_pool_info() -> dict\n\n"
+"Return the state of the native worker pool: 'num_threads' (see\n"
+"`set_num_threads()`), 'cpus' (the CPUs the process may use), 'pinned',\n"
+"'workers' (running threads), 'idle', 'queued' (jobs waiting for a\n"
+"worker), 'started' (threads started so far), 'jobs' (jobs run), and\n"
+"'busy_time' (seconds spent running them). The utilization over an\n"
+"interval is the change of busy_time divided by the length of the\n"
+"interval and the number of workers.");
+
+static PyObject *
+GMPy_Thread_Pool_Info(PyObject *self, PyObject *args)
+{
+    gmpy_pool_worker *worker;
+    gmpy_pool_job *job;
+    unsigned long long started, jobs;
+    long long busy;
+    int workers, idle = 0, queued = 0, pin;
+
+    PyThread_acquire_lock(pool_lock, WAIT_LOCK);
+    for (worker = pool_idle; worker; worker = worker->next)
+        idle++;
+    for (job = pool_head; job; job = job->next)
+        queued++;
+    workers = pool_workers;
+    started = pool_started;
+    jobs = pool_jobs;
+    busy = pool_busy_ns;
+    pin = pool_pin;
+    PyThread_release_lock(pool_lock);
+
+    return Py_BuildValue("{s:i,s:l,s:N,s:i,s:i,s:i,s:K,s:K,s:d}",
+                         "num_threads", gmpy_pool_threads,
+                         "cpus", _GMPy_Pool_CPUs(),
+                         "pinned", PyBool_FromLong(pin),
+                         "workers", workers, "idle", idle, "queued", queued,
+                         "started", started, "jobs", jobs,
+                         "busy_time", busy / 1e9);
+}
+
+typedef struct {
+    gmpy_pool_job job;
+    gmpy_parallel_func func;
+    void *arg;
+    Py_ssize_t start;
+    Py_ssize_t stop;
+    gmpy_interrupt *intr;       /* computation polled by GMPy_Interrupt_Poll() */
+    PyThread_type_lock done;    /* released by the worker when finished */
+} gmpy_parallel_task;
+
+static void
+_GMPy_Parallel_Job(gmpy_pool_job *job)
+{
+    gmpy_parallel_task *task = (gmpy_parallel_task*)job;
+
+    interrupt_current = task->intr;
+    task->func(task->arg, task->start, task->stop);
+    interrupt_current = NULL;
+    PyThread_release_lock(task->done);
+}
+
+static void
+GMPy_Parallel_Run(gmpy_parallel_func func, void *arg, Py_ssize_t n, int threads)
+{
+    gmpy_parallel_task *tasks;
+    Py_ssize_t j;
+
+    if (threads > n)
+        threads = (int)n;
+
+    if (threads <= 1 ||
+        !(tasks = PyMem_RawMalloc(threads * sizeof(gmpy_parallel_task)))) {
+        func(arg, 0, n);
+        return;
+    }
+
+    for (j = 1; j < threads; j++) {
+        tasks[j].job.run = _GMPy_Parallel_Job;
+        tasks[j].func = func;
+        tasks[j].arg = arg;
+        tasks[j].start = n * j / threads;
+        tasks[j].stop = n * (j + 1) / threads;
+        tasks[j].intr = interrupt_current;
+
+        /* If a range can't be handed to the pool, it is run below. */
+
+        if ((tasks[j].done = PyThread_allocate_lock())) {
+            PyThread_acquire_lock(tasks[j].done, WAIT_LOCK);
+            if (GMPy_Pool_Submit(&tasks[j].job, threads - 1) < 0) {
+                PyThread_free_lock(tasks[j].done);
+                tasks[j].done = NULL;
+            }
+        }
+    }
+
+    func(arg, 0, n / threads);
+
+    /* Run the ranges that no worker has taken yet, then wait for the
+     * others. */
+
+    for (j = 1; j < threads; j++) {
+        if (!tasks[j].done || GMPy_Pool_Cancel(&tasks[j].job)) {
+            func(arg, tasks[j].start, tasks[j].stop);
+            if (tasks[j].done) {
+                PyThread_release_lock(tasks[j].done);
+            }
+        }
+    }
+    for (j = 1; j < threads; j++) {
+        if (tasks[j].done) {
+            PyThread_acquire_lock(tasks[j].done, WAIT_LOCK);
+            PyThread_release_lock(tasks[j].done);
+            PyThread_free_lock(tasks[j].done);
+        }
+    }
+    PyMem_RawFree(tasks);
+}
@@ -0,0 +1,95 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_parallel.h                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_PARALLEL_H
+#define GMPY_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__linux__)
+#  include <sched.h>
+#  include <unistd.h>
+#  define GMPY_POOL_AFFINITY 1
+#endif
+#ifndef _WIN32
+#  include <pthread.h>
+#endif
+
+/* The native worker pool.
+ *
+ * GMPy_Parallel_Run() and submit() hand their work to one pool of native
+ * threads that is shared by the whole process, so competing callers reuse
+ * the same workers instead of each starting their own. Workers are started
+ * on demand, at most the number of threads requested by the caller, and
+ * exit after GMPY_POOL_IDLE_US microseconds without work. Jobs that find
+ * no idle worker wait in a FIFO queue.
+ *
+ * A context whose threads is 0, the default, uses the number set by
+ * set_num_threads(). set_num_threads() also lets workers started later be
+ * pinned to the CPUs of the process, one each.
+ */
+
+#define GMPY_POOL_IDLE_US 10000000
+
+typedef struct gmpy_pool_job {
+    struct gmpy_pool_job *next;
+    void (*run)(struct gmpy_pool_job *job);
+} gmpy_pool_job;
+
+/* The number of threads used by a computation under context c. */
+
+#define GMPY_THREADS(c) ((c)->ctx.threads ? (c)->ctx.threads : gmpy_pool_threads)
+
+static int  GMPy_Pool_Init(void);
+static int  GMPy_Pool_Submit(gmpy_pool_job *job, int threads);
+static int  GMPy_Pool_Cancel(gmpy_pool_job *job);
+
+static PyObject * GMPy_Set_Num_Threads(PyObject *self, PyObject *args, PyObject *kwargs);
+static PyObject * GMPy_Get_Num_Threads(PyObject *self, PyObject *args);
+static PyObject * GMPy_Thread_Pool_Info(PyObject *self, PyObject *args);
+
+/* Support for splitting a loop over native threads.
+ *
+ * GMPy_Parallel_Run() calls func(arg, start, stop) for consecutive ranges
+ * that cover 0 to n. The calling thread runs the first range and up to
+ * threads - 1 workers of the pool run the others; a range that is still
+ * queued when the calling thread is done is run by the calling thread.
+ * The function returns after all ranges are done. It must be called with
+ * the GIL released and func must not use the Python API. The workers poll
+ * the same computation as the calling thread (see gmpy2_interrupt.h).
+ */
+
+typedef void (*gmpy_parallel_func)(void *arg, Py_ssize_t start, Py_ssize_t stop);
+
+static void GMPy_Parallel_Run(gmpy_parallel_func func, void *arg,
+                              Py_ssize_t n, int threads);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -166,7 +166,7 @@ GMPy_Integer_PowWithType(PyObject *b, int btype, PyObject *e, int etype,
             }
         }
         else {
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(mm));
             mpz_powm(result->z, tempb->z, tempe->z, mm);
             mpz_clear(mm);
 
@@ -195,14 +195,49 @@ GMPy_Integer_PowWithType(PyObject *b, int btype, PyObject *e, int etype,
     return NULL;
 }
 
+/* Loops for powmod_base_list() and powmod_exp_list() that can be split
+ * over several threads.
+ */
+
+typedef struct {
+    PyObject **items;
+    mpz_srcptr b;
+    mpz_srcptr e;
+    mpz_srcptr m;
+} gmpy_powmod_list;
+
+static void
+_GMPy_PowMod_Base_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_powmod_list *work = (gmpy_powmod_list*)arg;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++)
+        mpz_powm(MPZ(work->items[i]), MPZ(work->items[i]), work->e, work->m);
+}
+
+static void
+_GMPy_PowMod_Exp_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_powmod_list *work = (gmpy_powmod_list*)arg;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++)
+        mpz_powm(MPZ(work->items[i]), work->b, MPZ(work->items[i]), work->m);
+}
+
 static PyObject *
 GMPy_Integer_PowModBaseListWithType(PyObject *base_lst,
                                     PyObject *e, int etype,
                                     PyObject *m, int mtype)
 {
     MPZ_Object *tempe = NULL, *tempm = NULL, *tempres = NULL;
-    PyObject *result = NULL, *temp = NULL;
+    PyObject *result = NULL;
     Py_ssize_t i, seq_length;
+    gmpy_powmod_list work;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
 
     if (!(tempm = GMPy_MPZ_From_IntegerWithType(m, mtype, NULL)) ||
         !(tempe = GMPy_MPZ_From_IntegerWithType(e, etype, NULL))) {
@@ -255,12 +290,14 @@ GMPy_Integer_PowModBaseListWithType(PyObject *base_lst,
         }
     }
 
-    Py_BEGIN_ALLOW_THREADS;
-    for (i=0; i < seq_length; i++) {
-        temp = PySequence_Fast_GET_ITEM(result, i);
-        mpz_powm(MPZ(temp), MPZ(temp), tempe->z, tempm->z);
-    }
-    Py_END_ALLOW_THREADS;
+    GMPY_PROFILE_OPN(context, GMPY_OP_POWMOD, mpz_sizeinbase(tempm->z, 2), seq_length);
+    work.items = PySequence_Fast_ITEMS(result);
+    work.e = tempe->z;
+    work.m = tempm->z;
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(tempm->z) * seq_length);
+    GMPy_Parallel_Run(_GMPy_PowMod_Base_Range, &work, seq_length,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
 
     Py_DECREF((PyObject*)tempe);
     Py_DECREF((PyObject*)tempm);
@@ -271,7 +308,9 @@ GMPy_Integer_PowModBaseListWithType(PyObject *base_lst,
 PyDoc_STRVAR(GMPy_doc_integer_powmod_base_list,
 "powmod_base_list(base_lst, exp, mod, /) -> list[mpz, ...]\n\n"
 "Returns list(powmod(i, exp, mod) for i in base_lst). Will always release\n"
-"the GIL. (Experimental in gmpy2 2.1.x).");
+"the GIL unless the total size of the work is less than the context's\n"
+"release_gil_min_bits. The work is split over the number of threads\n"
+"given by the context's threads. (Experimental in gmpy2 2.1.x).");
 
 static PyObject *
 GMPy_Integer_PowMod_Base_List(PyObject *self, PyObject *args)
@@ -304,8 +343,12 @@ GMPy_Integer_PowModExpListWithType(PyObject *b, int btype,
                                    PyObject *m, int mtype)
 {
     MPZ_Object *tempb = NULL, *tempm = NULL, *tempres = NULL;
-    PyObject *result = NULL, *temp = NULL;
+    PyObject *result = NULL;
     Py_ssize_t i, seq_length;
+    gmpy_powmod_list work;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
 
     if (!(tempm = GMPy_MPZ_From_IntegerWithType(m, mtype, NULL)) ||
         !(tempb = GMPy_MPZ_From_IntegerWithType(b, btype, NULL))) {
@@ -358,12 +401,14 @@ GMPy_Integer_PowModExpListWithType(PyObject *b, int btype,
         }
     }
 
-    Py_BEGIN_ALLOW_THREADS;
-    for (i=0; i < seq_length; i++) {
-        temp = PySequence_Fast_GET_ITEM(result, i);
-        mpz_powm(MPZ(temp), tempb->z, MPZ(temp), tempm->z);
-    }
-    Py_END_ALLOW_THREADS;
+    GMPY_PROFILE_OPN(context, GMPY_OP_POWMOD, mpz_sizeinbase(tempm->z, 2), seq_length);
+    work.items = PySequence_Fast_ITEMS(result);
+    work.b = tempb->z;
+    work.m = tempm->z;
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(tempm->z) * seq_length);
+    GMPy_Parallel_Run(_GMPy_PowMod_Exp_Range, &work, seq_length,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
 
     Py_DECREF((PyObject*)tempb);
     Py_DECREF((PyObject*)tempm);
@@ -374,7 +419,9 @@ GMPy_Integer_PowModExpListWithType(PyObject *b, int btype,
 PyDoc_STRVAR(GMPy_doc_integer_powmod_exp_list,
 "powmod_exp_list(base, exp_lst, mod, /) -> list[mpz, ...]\n\n"
 "Returns list(powmod(base, i, mod) for i in exp_lst). Will always release\n"
-"the GIL. (Experimental in gmpy2 2.1.x).");
+"the GIL unless the total size of the work is less than the context's\n"
+"release_gil_min_bits. The work is split over the number of threads\n"
+"given by the context's threads. (Experimental in gmpy2 2.1.x).");
 
 static PyObject *
 GMPy_Integer_PowMod_Exp_List(PyObject *self, PyObject *args)
@@ -401,6 +448,256 @@ GMPy_Integer_PowMod_Exp_List(PyObject *self, PyObject *args)
     return NULL;
 }
 
+/* Simultaneous multi-exponentiation. The product of b[i]**e[i] mod m is
+ * evaluated with Straus' interleaved sliding windows: every base gets a
+ * table of its odd powers and the squarings of the accumulator are shared
+ * by all the terms.
+ */
+
+typedef struct {
+    Py_ssize_t n;
+    mpz_t *b;               /* bases, reduced mod m */
+    mpz_t *e;               /* exponents, all >= 0 */
+    mpz_t **table;          /* odd powers b, b**3, ..., NULL if e == 0 */
+    int *width;             /* window width for each base */
+    mp_bitcnt_t *low;       /* lowest bit of the pending window */
+    unsigned long *digit;   /* value of the pending window, 0 if none */
+} gmpy_powmod_multi;
+
+static int
+_GMPy_PowMod_Multi_Width(mp_bitcnt_t bits)
+{
+    if (bits < 8) return 1;
+    if (bits < 24) return 2;
+    if (bits < 80) return 3;
+    if (bits < 240) return 4;
+    if (bits < 672) return 5;
+    return 6;
+}
+
+static void
+_GMPy_PowMod_Multi_Clear(gmpy_powmod_multi *work)
+{
+    Py_ssize_t i, j;
+
+    for (i = 0; i < work->n; i++) {
+        if (work->table[i]) {
+            for (j = 0; j < ((Py_ssize_t)1 << (work->width[i] - 1)); j++) {
+                mpz_clear(work->table[i][j]);
+            }
+            PyMem_Free(work->table[i]);
+        }
+        mpz_clear(work->b[i]);
+        mpz_clear(work->e[i]);
+    }
+    PyMem_Free(work->b);
+    PyMem_Free(work->e);
+    PyMem_Free(work->table);
+    PyMem_Free(work->width);
+    PyMem_Free(work->low);
+    PyMem_Free(work->digit);
+}
+
+/* Does not use the Python API. */
+
+static void
+_GMPy_PowMod_Multi_Eval(mpz_t result, gmpy_powmod_multi *work, mpz_t m)
+{
+    Py_ssize_t i, j;
+    mp_bitcnt_t top = 0, bit, k;
+    int started = 0;
+    mpz_t square;
+
+    mpz_init(square);
+    for (i = 0; i < work->n; i++) {
+        if (!work->table[i]) {
+            continue;
+        }
+        mpz_mul(square, work->b[i], work->b[i]);
+        mpz_mod(square, square, m);
+        mpz_set(work->table[i][0], work->b[i]);
+        for (j = 1; j < ((Py_ssize_t)1 << (work->width[i] - 1)); j++) {
+            mpz_mul(work->table[i][j], work->table[i][j-1], square);
+            mpz_mod(work->table[i][j], work->table[i][j], m);
+        }
+        if (mpz_sizeinbase(work->e[i], 2) > top) {
+            top = mpz_sizeinbase(work->e[i], 2);
+        }
+        work->digit[i] = 0;
+    }
+    mpz_clear(square);
+
+    mpz_set_ui(result, 1);
+    for (bit = top; bit-- > 0; ) {
+        if (started) {
+            mpz_mul(result, result, result);
+            mpz_mod(result, result, m);
+        }
+        for (i = 0; i < work->n; i++) {
+            if (!work->table[i]) {
+                continue;
+            }
+            /* Open a window at the leading 1 bit; it ends at the lowest
+             * 1 bit within the next width bits so its value is odd. */
+            if (!work->digit[i] && mpz_tstbit(work->e[i], bit)) {
+                work->low[i] = bit + 1 > (mp_bitcnt_t)work->width[i] ?
+                               bit + 1 - work->width[i] : 0;
+                while (!mpz_tstbit(work->e[i], work->low[i])) {
+                    work->low[i]++;
+                }
+                for (k = bit + 1; k-- > work->low[i]; ) {
+                    work->digit[i] = (work->digit[i] << 1) | mpz_tstbit(work->e[i], k);
+                }
+            }
+            if (work->digit[i] && work->low[i] == bit) {
+                mpz_mul(result, result, work->table[i][work->digit[i] >> 1]);
+                mpz_mod(result, result, m);
+                work->digit[i] = 0;
+                started = 1;
+            }
+        }
+    }
+    mpz_mod(result, result, m);
+}
+
+PyDoc_STRVAR(GMPy_doc_integer_powmod_multi,
+"powmod_multi(bases, exps, mod, /) -> mpz\n\n"
+"Return the product of powmod(b, e, mod) for b, e in zip(bases, exps).\n"
+"The squarings are shared by all the terms so this is faster than\n"
+"computing each power separately. A negative exponent requires the base\n"
+"to be invertible. Will always release the GIL unless the total size of\n"
+"the work is less than the context's release_gil_min_bits.");
+
+static PyObject *
+GMPy_Integer_PowMod_Multi(PyObject *self, PyObject *args)
+{
+    PyObject *bases = NULL, *exps = NULL;
+    MPZ_Object *tempm = NULL, *tempb = NULL, *tempe = NULL, *result = NULL;
+    Py_ssize_t i, j, n;
+    mp_bitcnt_t bits = 0;
+    gmpy_powmod_multi work = {0};
+    CTXT_Object *context = NULL;
+
+    if (PyTuple_GET_SIZE(args) != 3) {
+        TYPE_ERROR("powmod_multi requires 3 arguments");
+        return NULL;
+    }
+
+    if (!PySequence_Check(PyTuple_GET_ITEM(args, 0)) ||
+        !PySequence_Check(PyTuple_GET_ITEM(args, 1))) {
+        TYPE_ERROR("the first two arguments to powmod_multi must be sequences");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!(tempm = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 2), NULL))) {
+        TYPE_ERROR("powmod_multi() requires integer arguments");
+        return NULL;
+    }
+
+    if (mpz_sgn(tempm->z) < 1) {
+        VALUE_ERROR("powmod_multi() 'mod' must be > 0");
+        Py_DECREF((PyObject*)tempm);
+        return NULL;
+    }
+
+    if (!(bases = PySequence_Fast(PyTuple_GET_ITEM(args, 0), "argument must be an iterable")) ||
+        !(exps = PySequence_Fast(PyTuple_GET_ITEM(args, 1), "argument must be an iterable"))) {
+        goto err;
+    }
+
+    n = PySequence_Fast_GET_SIZE(bases);
+    if (n != PySequence_Fast_GET_SIZE(exps)) {
+        VALUE_ERROR("powmod_multi() requires sequences of the same length");
+        goto err;
+    }
+
+    if (!(work.b = PyMem_New(mpz_t, n ? n : 1)) ||
+        !(work.e = PyMem_New(mpz_t, n ? n : 1)) ||
+        !(work.table = PyMem_New(mpz_t*, n ? n : 1)) ||
+        !(work.width = PyMem_New(int, n ? n : 1)) ||
+        !(work.low = PyMem_New(mp_bitcnt_t, n ? n : 1)) ||
+        !(work.digit = PyMem_New(unsigned long, n ? n : 1))) {
+        PyErr_NoMemory();
+        goto err;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (!(tempb = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(bases, i), NULL)) ||
+            !(tempe = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(exps, i), NULL))) {
+            Py_XDECREF((PyObject*)tempb);
+            TYPE_ERROR("all items in iterable must be integers");
+            goto err;
+        }
+
+        mpz_init(work.b[i]);
+        mpz_init_set(work.e[i], tempe->z);
+        work.table[i] = NULL;
+        work.n = i + 1;
+
+        if (mpz_sgn(tempe->z) < 0) {
+            if (!mpz_invert(work.b[i], tempb->z, tempm->z)) {
+                VALUE_ERROR("powmod_multi() base not invertible");
+                Py_DECREF((PyObject*)tempb);
+                Py_DECREF((PyObject*)tempe);
+                goto err;
+            }
+            mpz_neg(work.e[i], work.e[i]);
+        }
+        else {
+            mpz_mod(work.b[i], tempb->z, tempm->z);
+        }
+        Py_DECREF((PyObject*)tempb);
+        Py_DECREF((PyObject*)tempe);
+
+        if (mpz_sgn(work.e[i]) == 0) {
+            continue;
+        }
+
+        work.width[i] = _GMPy_PowMod_Multi_Width(mpz_sizeinbase(work.e[i], 2));
+        if (!(work.table[i] = PyMem_New(mpz_t, (Py_ssize_t)1 << (work.width[i] - 1)))) {
+            PyErr_NoMemory();
+            goto err;
+        }
+        for (j = 0; j < ((Py_ssize_t)1 << (work.width[i] - 1)); j++) {
+            mpz_init(work.table[i][j]);
+        }
+        bits += mpz_sizeinbase(work.e[i], 2);
+    }
+
+    if (!(result = GMPy_MPZ_New(NULL))) {
+        goto err;
+    }
+
+    GMPY_PROFILE_OPN(context, GMPY_OP_POWMOD, mpz_sizeinbase(tempm->z, 2), n);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(tempm->z) * (n + bits / 64));
+    _GMPy_PowMod_Multi_Eval(result->z, &work, tempm->z);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    _GMPy_PowMod_Multi_Clear(&work);
+    Py_DECREF((PyObject*)tempm);
+    Py_DECREF(bases);
+    Py_DECREF(exps);
+    return (PyObject*)result;
+
+  err:
+    if (work.digit) {
+        _GMPy_PowMod_Multi_Clear(&work);
+    }
+    else {
+        PyMem_Free(work.b);
+        PyMem_Free(work.e);
+        PyMem_Free(work.table);
+        PyMem_Free(work.width);
+        PyMem_Free(work.low);
+    }
+    Py_DECREF((PyObject*)tempm);
+    Py_XDECREF(bases);
+    Py_XDECREF(exps);
+    return NULL;
+}
+
 static PyObject *
 GMPy_Rational_PowWithType(PyObject *base, int btype, PyObject *exp, int etype,
                          PyObject *mod, CTXT_Object *context)
@@ -543,7 +840,7 @@ GMPy_Real_PowWithType(PyObject *base, int btype, PyObject *exp, int etype,
         mpc_result = (MPC_Object*)GMPy_Complex_PowWithType(base, btype, exp, etype, Py_None, context);
         if (!mpc_result || MPC_IS_NAN_P(mpc_result)) {
             Py_XDECREF((PyObject*)mpc_result);
-            context->ctx.invalid = 1;
+            GMPY_CTXT_FLAGS(context)->invalid = 1;
             GMPY_INVALID("pow() invalid operation");
             goto err;
         }
@@ -638,25 +935,112 @@ GMPy_Complex_PowWithType(PyObject *base, int btype, PyObject *exp, int etype,
     return NULL;
 }
 
+/* Indexed by GMPY_TYPE_CLASS2(btype, etype). */
+
+static gmpy_ternary_withtype const GMPy_Pow_Table[OBJ_CLASS_COUNT] = {
+    GMPy_Integer_PowWithType,
+    GMPy_Rational_PowWithType,
+    GMPy_Real_PowWithType,
+    GMPy_Complex_PowWithType,
+};
+
 PyDoc_STRVAR(GMPy_doc_integer_powmod,
-"powmod(x, y, m, /) -> mpz\n\n"
+"powmod(x, y, m, /, *, out=None) -> mpz | xmpz\n\n"
 "Return (x**y) mod m. Same as the three argument version of Python's\n"
-"built-in `pow`, but converts all three arguments to `mpz`.");
+"built-in `pow`, but converts all three arguments to `mpz`. If out is an\n"
+"`xmpz`, the result is stored in out, which is returned.");
+
+/* r = (b**e) mod m with the sign convention of pow(); m is not 0. Returns
+ * -1 if e is negative and b has no inverse. r must not share limbs with e
+ * or m. Does not use the Python API.
+ */
+
+static int
+_GMPy_MPZ_PowMod(mpz_ptr r, mpz_srcptr b, mpz_srcptr e, mpz_srcptr m)
+{
+    mpz_t mm, ee;
+
+    /* |m| and |e| as read-only aliases. */
+
+    mpz_roinit_n(mm, mpz_limbs_read(m), mpz_size(m));
+    if (mpz_sgn(e) < 0) {
+        mpz_roinit_n(ee, mpz_limbs_read(e), mpz_size(e));
+        if (!mpz_invert(r, b, mm))
+            return -1;
+        mpz_powm(r, r, ee, mm);
+    }
+    else {
+        mpz_powm(r, b, e, mm);
+    }
+
+    /* If the modulus is negative, the result is in the interval m < r <= 0. */
+
+    if (mpz_sgn(m) < 0 && mpz_sgn(r) > 0)
+        mpz_add(r, r, m);
+    return 0;
+}
+
+static PyObject *
+_GMPy_Integer_PowMod_Out(XMPZ_Object *out, PyObject *x, PyObject *y,
+                         PyObject *m, CTXT_Object *context)
+{
+    mpz_srcptr b, e, mod;
+    int mark = _GMPy_Scratch_Mark(), status;
+
+    if (!(b = GMPy_MPZ_Scratch_From_Integer(x)) ||
+        !(e = GMPy_MPZ_Scratch_From_Integer(y)) ||
+        !(mod = GMPy_MPZ_Scratch_From_Integer(m))) {
+        _GMPy_Scratch_Release(mark);
+        TYPE_ERROR("powmod() argument types not supported");
+        return NULL;
+    }
+    if (mpz_sgn(mod) == 0) {
+        _GMPy_Scratch_Release(mark);
+        VALUE_ERROR("pow() 3rd argument cannot be 0");
+        return NULL;
+    }
+    if (GMPy_XMPZ_Out_Begin(out) < 0) {
+        _GMPy_Scratch_Release(mark);
+        return NULL;
+    }
+    GMPY_PROFILE_MPZ(context, GMPY_OP_POWMOD, mod);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(mod));
+    status = _GMPy_MPZ_PowMod(out->z, b, e, mod);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    _GMPy_Scratch_Release(mark);
+    if (status < 0) {
+        mpz_set_ui(out->z, 0);
+        XMPZ_UNLOCK(out);
+        VALUE_ERROR("pow() base not invertible");
+        return NULL;
+    }
+    return GMPy_XMPZ_Out_End(out);
+}
 
 static PyObject *
-GMPy_Integer_PowMod(PyObject *self, PyObject *args)
+GMPy_Integer_PowMod(PyObject *self, PyObject *const *args, Py_ssize_t nargs,
+                    PyObject *kwnames)
 {
     PyObject *x, *y, *m;
+    XMPZ_Object *out;
     int xtype, ytype, mtype;
+    CTXT_Object *context = NULL;
 
-    if (PyTuple_GET_SIZE(args) != 3) {
+    if (nargs != 3) {
         TYPE_ERROR("powmod() requires 3 arguments.");
         return NULL;
     }
 
-    x = PyTuple_GET_ITEM(args, 0);
-    y = PyTuple_GET_ITEM(args, 1);
-    m = PyTuple_GET_ITEM(args, 2);
+    CHECK_CONTEXT(context);
+
+    x = args[0];
+    y = args[1];
+    m = args[2];
+
+    if (GMPy_XMPZ_Out_Kwnames(args, nargs, kwnames, &out, "powmod") < 0)
+        return NULL;
+    if (out)
+        return _GMPy_Integer_PowMod_Out(out, x, y, m, context);
 
     xtype = GMPy_ObjectType(x);
     ytype = GMPy_ObjectType(y);
@@ -665,7 +1049,8 @@ GMPy_Integer_PowMod(PyObject *self, PyObject *args)
     if (IS_TYPE_INTEGER(xtype) &&
         IS_TYPE_INTEGER(ytype) &&
         IS_TYPE_INTEGER(mtype)) {
-        return GMPy_Integer_PowWithType(x, xtype, y, ytype, m, NULL);
+        GMPY_PROFILE_OP(context, GMPY_OP_POWMOD, _GMPy_Profile_Bits(m, mtype));
+        return GMPy_Integer_PowWithType(x, xtype, y, ytype, m, context);
     }
 
     TYPE_ERROR("powmod() argument types not supported");
@@ -748,7 +1133,8 @@ GMPy_Integer_PowMod_Sec(PyObject *self, PyObject *args)
         goto err;
     }
 
-    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    GMPY_PROFILE_MPZ(context, GMPY_OP_POWMOD, tempm->z);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(tempm->z));
     mpz_powm_sec(result->z, tempx->z, tempy->z, tempm->z);
     GMPY_MAYBE_END_ALLOW_THREADS(context);
 
@@ -770,17 +1156,14 @@ GMPy_Number_Pow(PyObject *x, PyObject *y, PyObject *z, CTXT_Object *context)
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_PowWithType(x, xtype, y, ytype, z, context);
+    if (z == Py_None)
+        GMPY_PROFILE_OP(context, GMPY_OP_POW, _GMPy_Profile_Bits(x, xtype));
+    else
+        GMPY_PROFILE_OP(context, GMPY_OP_POWMOD,
+                        _GMPy_Profile_Bits(z, GMPy_ObjectType(z)));
 
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_PowWithType(x, xtype, y, ytype, z, context);
-
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_PowWithType(x, xtype, y, ytype, z, context);
-
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_PowWithType(x, xtype, y, ytype, z, context);
+    if (xtype && ytype)
+        return GMPy_Pow_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, z, context);
 
     TYPE_ERROR("pow() argument type not supported");
     return NULL;
@@ -814,20 +1197,20 @@ GMPy_Context_Pow(PyObject *self, PyObject *args)
 static PyObject *
 GMPy_Number_Pow_Slot(PyObject *base, PyObject *exp, PyObject *mod)
 {
+    CTXT_Object *context = NULL;
     int btype = GMPy_ObjectType(base);
     int etype = GMPy_ObjectType(exp);
 
-    if (IS_TYPE_INTEGER(btype) && IS_TYPE_INTEGER(etype))
-        return GMPy_Integer_PowWithType(base, btype, exp, etype, mod, NULL);
-
-    if (IS_TYPE_RATIONAL(btype) && IS_TYPE_RATIONAL(etype))
-        return GMPy_Rational_PowWithType(base, btype, exp, etype, mod, NULL);
+    CHECK_CONTEXT(context);
 
-    if (IS_TYPE_REAL(btype) && IS_TYPE_REAL(etype))
-        return GMPy_Real_PowWithType(base, btype, exp, etype, mod, NULL);
+    if (mod == Py_None)
+        GMPY_PROFILE_OP(context, GMPY_OP_POW, _GMPy_Profile_Bits(base, btype));
+    else
+        GMPY_PROFILE_OP(context, GMPY_OP_POWMOD,
+                        _GMPy_Profile_Bits(mod, GMPy_ObjectType(mod)));
 
-    if (IS_TYPE_COMPLEX(btype) && IS_TYPE_COMPLEX(etype))
-        return GMPy_Complex_PowWithType(base, btype, exp, etype, mod, NULL);
+    if (btype && etype)
+        return GMPy_Pow_Table[GMPY_TYPE_CLASS2(btype, etype)](base, btype, exp, etype, mod, context);
 
     Py_RETURN_NOTIMPLEMENTED;
 }
@@ -39,7 +39,9 @@ static PyObject * GMPy_Integer_PowWithType(PyObject *base, int btype, PyObject *
 static PyObject * GMPy_Rational_PowWithType(PyObject *base, int btype, PyObject *exp, int etype, PyObject *mod, CTXT_Object *context);
 static PyObject * GMPy_Real_PowWithType(PyObject *base, int btype, PyObject *exp, int etype, PyObject *mod, CTXT_Object *context);
 static PyObject * GMPy_Complex_PowWithType(PyObject *base, int btype, PyObject *exp, int etype, PyObject *mod, CTXT_Object *context);
-static PyObject * GMPy_Integer_PowMod(PyObject *self, PyObject *args);
+static int        _GMPy_MPZ_PowMod(mpz_ptr r, mpz_srcptr b, mpz_srcptr e, mpz_srcptr m);
+static PyObject * GMPy_Integer_PowMod(PyObject *self, PyObject *const *args, Py_ssize_t nargs,
+                                      PyObject *kwnames);
 static PyObject * GMPy_Integer_PowMod_Sec(PyObject *self, PyObject *args);
 
 static PyObject * GMPy_Context_Pow(PyObject *self, PyObject *args);
@@ -0,0 +1,245 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_profile.c                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Statistics collected for a context when context.profile is True. See
+ * gmpy2_profile.h.
+ */
+
+static const char *gmpy_op_names[GMPY_OPS] = {
+    "add", "sub", "mul", "truediv", "floordiv", "mod", "divmod", "pow",
+    "powmod", "gcd", "invert", "root", "fac", "prp", "str"
+};
+
+/* Return the statistics of the context, allocating them if needed. Returns
+ * NULL (without an exception) if no memory is available; the statistics
+ * are then silently not collected.
+ */
+
+static gmpy_profile *
+_GMPy_Profile_Get(CTXT_Object *context)
+{
+    if (!context->profile) {
+        context->profile = PyMem_Calloc(1, sizeof(gmpy_profile));
+    }
+    return context->profile;
+}
+
+static void
+_GMPy_Profile_Op(CTXT_Object *context, int op, size_t bits, Py_ssize_t n)
+{
+    gmpy_profile *profile = _GMPy_Profile_Get(context);
+    int bucket = 0;
+
+    if (!profile) {
+        return;
+    }
+
+    while (bits && bucket < GMPY_PROFILE_BUCKETS - 1) {
+        bits >>= 1;
+        bucket++;
+    }
+    profile->ops[op] += n;
+    profile->bits[op][bucket] += n;
+}
+
+/* Estimate of the size in bits of an argument. Types without a natural
+ * size count as 0 bits.
+ */
+
+static size_t
+_GMPy_Profile_Bits(PyObject *x, int xtype)
+{
+    if (IS_TYPE_MPZANY(xtype))
+        return mpz_sizeinbase(MPZ(x), 2);
+
+    if (IS_TYPE_PyInteger(xtype))
+        return (size_t)_PyLong_DigitCount((PyLongObject*)x) * PyLong_SHIFT;
+
+    if (IS_TYPE_MPQ(xtype))
+        return Py_MAX(mpz_sizeinbase(mpq_numref(MPQ(x)), 2),
+                      mpz_sizeinbase(mpq_denref(MPQ(x)), 2));
+
+    if (IS_TYPE_MPFR(xtype))
+        return (size_t)mpfr_get_prec(MPFR(x));
+
+    if (IS_TYPE_PyFloat(xtype) || IS_TYPE_PyComplex(xtype))
+        return DBL_MANT_DIG;
+
+    if (IS_TYPE_MPC(xtype))
+        return (size_t)Py_MAX(mpfr_get_prec(mpc_realref(MPC(x))),
+                              mpfr_get_prec(mpc_imagref(MPC(x))));
+
+    return 0;
+}
+
+static void
+_GMPy_Profile_Cache(CTXT_Object *context, int hit)
+{
+    gmpy_profile *profile = _GMPy_Profile_Get(context);
+
+    if (profile) {
+        if (hit)
+            profile->cache_hits++;
+        else
+            profile->cache_misses++;
+    }
+}
+
+/* Monotonic clock in nanoseconds. It is read while the GIL is released. */
+
+static unsigned long long
+_GMPy_Profile_Clock(void)
+{
+#if PY_VERSION_HEX >= 0x030D0000
+    PyTime_t t;
+
+    if (PyTime_PerfCounterRaw(&t) < 0) {
+        return 0;
+    }
+    return (unsigned long long)t;
+#elif defined(_WIN32)
+    struct timespec ts;
+
+    if (!timespec_get(&ts, TIME_UTC)) {
+        return 0;
+    }
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts)) {
+        return 0;
+    }
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/* Called by GMPY_MAYBE_END_ALLOW_THREADS after the GIL is reacquired. */
+
+static void
+_GMPy_Profile_NoGIL(CTXT_Object *context, unsigned long long ns)
+{
+    gmpy_profile *profile = _GMPy_Profile_Get(context);
+
+    if (profile) {
+        profile->nogil_calls++;
+        profile->nogil_ns += ns;
+    }
+}
+
+PyDoc_STRVAR(GMPy_doc_context_profile_info,
+"context.profile_info(reset=False) -> dict\n\n"
+"Return the statistics collected while `profile` was set to `True`.\n\n"
+"    ops:          number of operations of each kind; gcd() and lcm()\n"
+"                  of several arguments count one per pairwise step\n"
+"    bits:         for each kind, a histogram of the bit length of the\n"
+"                  largest operand; key k counts operands with fewer than\n"
+"                  k bits (and at least k/2 bits)\n"
+"    nogil_calls:  number of GMP calls made with the GIL released\n"
+"    nogil_time:   seconds spent with the GIL released\n"
+"    cache_hits:   results taken from the object caches\n"
+"    cache_misses: results that required a new allocation\n\n"
+"Only kinds that occurred are included. If reset is True, the\n"
+"statistics are cleared after they are returned.");
+
+static PyObject *
+GMPy_CTXT_Profile_Info(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    CTXT_Object *context = (CTXT_Object*)self;
+    gmpy_profile empty, *profile;
+    PyObject *result = NULL, *ops = NULL, *bits = NULL, *hist = NULL;
+    int i, j, reset = 0;
+    static char *kwlist[] = {"reset", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|p", kwlist, &reset)) {
+        return NULL;
+    }
+
+    if (!(profile = context->profile)) {
+        memset(&empty, 0, sizeof(empty));
+        profile = &empty;
+    }
+
+    if (!(ops = PyDict_New()) || !(bits = PyDict_New())) {
+        goto error;
+    }
+
+    for (i = 0; i < GMPY_OPS; i++) {
+        PyObject *count;
+
+        if (!profile->ops[i]) {
+            continue;
+        }
+        if (!(count = PyLong_FromUnsignedLongLong(profile->ops[i])) ||
+            PyDict_SetItemString(ops, gmpy_op_names[i], count) < 0) {
+            Py_XDECREF(count);
+            goto error;
+        }
+        Py_DECREF(count);
+
+        if (!(hist = PyDict_New())) {
+            goto error;
+        }
+        for (j = 0; j < GMPY_PROFILE_BUCKETS; j++) {
+            PyObject *key, *value;
+
+            if (!profile->bits[i][j]) {
+                continue;
+            }
+            key = PyLong_FromUnsignedLongLong(1ULL << j);
+            value = PyLong_FromUnsignedLongLong(profile->bits[i][j]);
+            if (!key || !value || PyDict_SetItem(hist, key, value) < 0) {
+                Py_XDECREF(key);
+                Py_XDECREF(value);
+                goto error;
+            }
+            Py_DECREF(key);
+            Py_DECREF(value);
+        }
+        if (PyDict_SetItemString(bits, gmpy_op_names[i], hist) < 0) {
+            goto error;
+        }
+        Py_CLEAR(hist);
+    }
+
+    result = Py_BuildValue("{s:O,s:O,s:K,s:d,s:K,s:K}",
+                           "ops", ops,
+                           "bits", bits,
+                           "nogil_calls", profile->nogil_calls,
+                           "nogil_time", profile->nogil_ns / 1e9,
+                           "cache_hits", profile->cache_hits,
+                           "cache_misses", profile->cache_misses);
+
+    if (result && reset && context->profile) {
+        memset(context->profile, 0, sizeof(gmpy_profile));
+    }
+
+  error:
+    Py_XDECREF(hist);
+    Py_XDECREF(ops);
+    Py_XDECREF(bits);
+    return result;
+}
@@ -0,0 +1,118 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_profile.h                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_PROFILE_H
+#define GMPY_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Statistics collected for a context when context.profile is True.
+ *
+ * Operations are counted by kind, together with a histogram of the size
+ * of the largest operand: bucket n counts operands with a bit length in
+ * [2**(n-1), 2**n). The time spent with the GIL released and the number
+ * of results served from the object caches are also recorded. The counters
+ * are updated while the GIL is held; in a free-threaded build a context
+ * that is shared between threads may lose counts.
+ */
+
+enum {
+    GMPY_OP_ADD,
+    GMPY_OP_SUB,
+    GMPY_OP_MUL,
+    GMPY_OP_TRUEDIV,
+    GMPY_OP_FLOORDIV,
+    GMPY_OP_MOD,
+    GMPY_OP_DIVMOD,
+    GMPY_OP_POW,
+    GMPY_OP_POWMOD,
+    GMPY_OP_GCD,
+    GMPY_OP_INVERT,
+    GMPY_OP_ROOT,
+    GMPY_OP_FAC,
+    GMPY_OP_PRP,
+    GMPY_OP_STR,
+    GMPY_OPS
+};
+
+#define GMPY_PROFILE_BUCKETS 40
+
+typedef struct gmpy_profile {
+    unsigned long long ops[GMPY_OPS];
+    unsigned long long bits[GMPY_OPS][GMPY_PROFILE_BUCKETS];
+    unsigned long long nogil_calls;   /* GMP calls made without the GIL */
+    unsigned long long nogil_ns;      /* nanoseconds spent without the GIL */
+    unsigned long long cache_hits;    /* results taken from a cache */
+    unsigned long long cache_misses;  /* results allocated with malloc */
+} gmpy_profile;
+
+#define GMPY_PROFILE_OP(context, OP, bits) \
+    do { \
+        if ((context)->ctx.profile) \
+            _GMPy_Profile_Op(context, OP, (size_t)(bits), 1); \
+    } while (0)
+
+#define GMPY_PROFILE_OPN(context, OP, bits, n) \
+    do { \
+        if ((context)->ctx.profile) \
+            _GMPy_Profile_Op(context, OP, (size_t)(bits), (n)); \
+    } while (0)
+
+#define GMPY_PROFILE_MPZ(context, OP, z) \
+    GMPY_PROFILE_OP(context, OP, mpz_sizeinbase(z, 2))
+
+#define GMPY_PROFILE_MPZ2(context, OP, x, y) \
+    GMPY_PROFILE_OP(context, OP, Py_MAX(mpz_sizeinbase(x, 2), \
+                                        mpz_sizeinbase(y, 2)))
+
+#define GMPY_PROFILE_OP2(context, OP, x, xtype, y, ytype) \
+    do { \
+        if ((context)->ctx.profile) \
+            _GMPy_Profile_Op(context, OP, \
+                             Py_MAX(_GMPy_Profile_Bits(x, xtype), \
+                                    _GMPy_Profile_Bits(y, ytype)), 1); \
+    } while (0)
+
+#define GMPY_PROFILE_CACHE(context, hit) \
+    do { \
+        if ((context) && (context)->ctx.profile) \
+            _GMPy_Profile_Cache(context, hit); \
+    } while (0)
+
+static void               _GMPy_Profile_Op(CTXT_Object *context, int op, size_t bits, Py_ssize_t n);
+static size_t             _GMPy_Profile_Bits(PyObject *x, int xtype);
+static void               _GMPy_Profile_Cache(CTXT_Object *context, int hit);
+static unsigned long long _GMPy_Profile_Clock(void);
+static void               _GMPy_Profile_NoGIL(CTXT_Object *context, unsigned long long ns);
+
+static PyObject *         GMPy_CTXT_Profile_Info(PyObject *self, PyObject *args, PyObject *keywds);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
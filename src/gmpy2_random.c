@@ -30,7 +30,13 @@ GMPy_RandomState_New(void)
     RandomState_Object *result;
 
     if ((result = PyObject_New(RandomState_Object, &RandomState_Type))) {
+        if (!(result->spawn_key = PyTuple_New(0))) {
+            PyObject_Del(result);
+            return NULL;
+        }
         gmp_randinit_default(result->state);
+        mpz_init(result->entropy);
+        result->children = 0;
     }
     return result;
 };
@@ -39,6 +45,8 @@ static void
 GMPy_RandomState_Dealloc(RandomState_Object *self)
 {
     gmp_randclear(self->state);
+    mpz_clear(self->entropy);
+    Py_XDECREF(self->spawn_key);
     PyObject_Del(self);
 };
 
@@ -51,7 +59,9 @@ GMPy_RandomState_Repr(RandomState_Object *self)
 PyDoc_STRVAR(GMPy_doc_random_state_factory,
 "random_state(seed=0, /) -> object\n\n"
 "Return new object containing state information for the random number\n"
-"generator. An optional integer can be specified as the seed value.");
+"generator. An optional integer can be specified as the seed value.\n"
+"A state must not be shared between threads; use its copy() and\n"
+"spawn() methods to create states for other threads.");
 
 static PyObject *
 GMPy_RandomState_Factory(PyObject *self, PyObject *args)
@@ -73,6 +83,7 @@ GMPy_RandomState_Factory(PyObject *self, PyObject *args)
             return NULL;
         }
         gmp_randseed(result->state, temp->z);
+        mpz_abs(result->entropy, temp->z);
         Py_DECREF((PyObject*)temp);
     }
     else {
@@ -83,17 +94,499 @@ GMPy_RandomState_Factory(PyObject *self, PyObject *args)
     return (PyObject*)result;
 }
 
+PyDoc_STRVAR(GMPy_doc_random_state_copy,
+"copy() -> random_state\n\n"
+"Return an independent copy of the state. Both produce the same\n"
+"sequence from this point on.");
+
+static PyObject *
+GMPy_RandomState_Copy(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    RandomState_Object *result, *state = (RandomState_Object*)self;
+
+    if (!(result = GMPy_RandomState_New()))
+        return NULL;
+
+    gmp_randclear(result->state);
+    gmp_randinit_set(result->state, state->state);
+    mpz_set(result->entropy, state->entropy);
+    Py_INCREF(state->spawn_key);
+    Py_SETREF(result->spawn_key, state->spawn_key);
+    result->children = state->children;
+    return (PyObject*)result;
+}
+
+/* Seed derivation for spawn().
+ *
+ * A child is seeded from the entropy of the root state and its spawn key,
+ * the path of child indices from the root, with the hash mixing of
+ * numpy's SeedSequence: the 32-bit words of the entropy (padded to the
+ * pool size) and of the spawn key are mixed into a pool of
+ * RANDOM_POOL_SIZE words, from which RANDOM_SEED_WORDS words of seed are
+ * drawn. Distinct spawn keys give unrelated seeds, so the streams are
+ * independent for practical purposes.
+ */
+
+#define RANDOM_POOL_SIZE 4
+#define RANDOM_SEED_WORDS 8
+#define RANDOM_INIT_A 0x43b0d7e5U
+#define RANDOM_MULT_A 0x931e8875U
+#define RANDOM_INIT_B 0x8b51f9ddU
+#define RANDOM_MULT_B 0x58f38dedU
+#define RANDOM_MIX_MULT_L 0xca01f9ddU
+#define RANDOM_MIX_MULT_R 0x4973f715U
+#define RANDOM_XSHIFT 16
+
+static uint32_t
+_GMPy_Random_Hashmix(uint32_t value, uint32_t *hash_const)
+{
+    value ^= *hash_const;
+    *hash_const *= RANDOM_MULT_A;
+    value *= *hash_const;
+    value ^= value >> RANDOM_XSHIFT;
+    return value;
+}
+
+static uint32_t
+_GMPy_Random_Mix(uint32_t x, uint32_t y)
+{
+    uint32_t result = RANDOM_MIX_MULT_L * x - RANDOM_MIX_MULT_R * y;
+
+    result ^= result >> RANDOM_XSHIFT;
+    return result;
+}
+
+/* Append the 32-bit words of z, least significant first and at least
+ * min_words of them, to words. Returns the new length or -1 on error.
+ */
+
+static Py_ssize_t
+_GMPy_Random_Words(uint32_t **words, Py_ssize_t len, mpz_srcptr z,
+                   size_t min_words)
+{
+    size_t count = (mpz_sizeinbase(z, 2) + 31) / 32;
+    uint32_t *temp;
+
+    if (count < min_words)
+        count = min_words;
+    if (!(temp = PyMem_Resize(*words, uint32_t, (size_t)len + count))) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    *words = temp;
+    memset(temp + len, 0, count * sizeof(uint32_t));
+    mpz_export(temp + len, NULL, -1, sizeof(uint32_t), 0, 0, z);
+    return len + (Py_ssize_t)count;
+}
+
+static int
+_GMPy_Random_Derive_Seed(mpz_ptr seed, mpz_srcptr entropy, PyObject *spawn_key)
+{
+    uint32_t *words = NULL, pool[RANDOM_POOL_SIZE], out[RANDOM_SEED_WORDS];
+    uint32_t hash_const = RANDOM_INIT_A;
+    Py_ssize_t i, j, len;
+    MPZ_Object *temp;
+
+    len = _GMPy_Random_Words(&words, 0, entropy,
+                             PyTuple_GET_SIZE(spawn_key) ? RANDOM_POOL_SIZE : 1);
+    for (i = 0; len >= 0 && i < PyTuple_GET_SIZE(spawn_key); i++) {
+        if (!(temp = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(spawn_key, i), NULL))) {
+            len = -1;
+            break;
+        }
+        len = _GMPy_Random_Words(&words, len, temp->z, 1);
+        Py_DECREF((PyObject*)temp);
+    }
+    if (len < 0) {
+        PyMem_Free(words);
+        return -1;
+    }
+
+    for (i = 0; i < RANDOM_POOL_SIZE; i++)
+        pool[i] = _GMPy_Random_Hashmix(i < len ? words[i] : 0, &hash_const);
+    for (i = 0; i < RANDOM_POOL_SIZE; i++) {
+        for (j = 0; j < RANDOM_POOL_SIZE; j++) {
+            if (i != j)
+                pool[j] = _GMPy_Random_Mix(pool[j], _GMPy_Random_Hashmix(pool[i], &hash_const));
+        }
+    }
+    for (i = RANDOM_POOL_SIZE; i < len; i++) {
+        for (j = 0; j < RANDOM_POOL_SIZE; j++)
+            pool[j] = _GMPy_Random_Mix(pool[j], _GMPy_Random_Hashmix(words[i], &hash_const));
+    }
+    PyMem_Free(words);
+
+    hash_const = RANDOM_INIT_B;
+    for (i = 0; i < RANDOM_SEED_WORDS; i++) {
+        uint32_t value = pool[i % RANDOM_POOL_SIZE];
+
+        value ^= hash_const;
+        hash_const *= RANDOM_MULT_B;
+        value *= hash_const;
+        value ^= value >> RANDOM_XSHIFT;
+        out[i] = value;
+    }
+    mpz_import(seed, RANDOM_SEED_WORDS, -1, sizeof(uint32_t), 0, 0, out);
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_random_state_spawn,
+"spawn(n, /) -> list[random_state]\n\n"
+"Return n new states for independent random streams, e.g. one per\n"
+"worker thread. The children are seeded from this state's seed and\n"
+"their position in the spawn tree, so the same seed always spawns the\n"
+"same streams; the sequence of this state is not changed. Children may\n"
+"spawn states in turn.");
+
+static PyObject *
+GMPy_RandomState_Spawn(PyObject *self, PyObject *other)
+{
+    RandomState_Object *state = (RandomState_Object*)self, *child;
+    PyObject *result, *key, *index;
+    Py_ssize_t i, j, n, depth = PyTuple_GET_SIZE(state->spawn_key);
+    mpz_t seed;
+
+    n = PyNumber_AsSsize_t(other, PyExc_OverflowError);
+    if (n == -1 && PyErr_Occurred())
+        return NULL;
+    if (n < 0) {
+        VALUE_ERROR("spawn() requires n >= 0");
+        return NULL;
+    }
+
+    if (!(result = PyList_New(n)))
+        return NULL;
+
+    mpz_init(seed);
+    for (i = 0; i < n; i++) {
+        if (!(key = PyTuple_New(depth + 1)))
+            goto error;
+        for (j = 0; j < depth; j++) {
+            Py_INCREF(PyTuple_GET_ITEM(state->spawn_key, j));
+            PyTuple_SET_ITEM(key, j, PyTuple_GET_ITEM(state->spawn_key, j));
+        }
+        if (!(index = PyLong_FromUnsignedLong(state->children + (unsigned long)i))) {
+            Py_DECREF(key);
+            goto error;
+        }
+        PyTuple_SET_ITEM(key, depth, index);
+
+        if (_GMPy_Random_Derive_Seed(seed, state->entropy, key) < 0 ||
+            !(child = GMPy_RandomState_New())) {
+            Py_DECREF(key);
+            goto error;
+        }
+        gmp_randseed(child->state, seed);
+        mpz_set(child->entropy, state->entropy);
+        Py_SETREF(child->spawn_key, key);
+        PyList_SET_ITEM(result, i, (PyObject*)child);
+    }
+    state->children += (unsigned long)n;
+    mpz_clear(seed);
+    return result;
+
+  error:
+    mpz_clear(seed);
+    Py_DECREF(result);
+    return NULL;
+}
+
+static PyObject *
+GMPy_RandomState_GetSpawnKey(RandomState_Object *self, void *closure)
+{
+    Py_INCREF(self->spawn_key);
+    return self->spawn_key;
+}
+
+/* Bulk generation.
+ *
+ * With count=n the random functions return a list of n values; with out=x
+ * they fill x in place and return it. x may be a list, an mpz_array, or,
+ * for the integer functions, a writable buffer that is filled with
+ * little-endian records of (bits + 7) // 8 bytes.
+ *
+ * The values are generated in one loop from a copy of the state, without
+ * the GIL if the total size is at least the context's
+ * release_gil_min_bits, and the advanced state is copied back afterwards.
+ * mpz_array elements are generated into temporary storage and swapped in
+ * with the GIL held.
+ */
+
+#define GMPY_RANDOM_URANDOMB 0
+#define GMPY_RANDOM_RRANDOMB 1
+#define GMPY_RANDOM_URANDOMM 2
+#define GMPY_RANDOM_MPFR     3
+
+typedef struct {
+    int kind;
+    unsigned long bits;          /* bit_count for urandomb and rrandomb */
+    mpz_srcptr n;                /* the bound for urandomm */
+    mpfr_rnd_t round;            /* rounding for mpfr_urandom */
+} gmpy_random_spec;
+
+/* Parse the count and out keywords. Returns 0 if neither is given, 1 if
+ * one is, and -1 on error.
+ */
+
+static int
+_GMPy_Random_Keywords(PyObject *keywds, PyObject **count, PyObject **out,
+                      const char *name)
+{
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+
+    *count = *out = NULL;
+    if (!keywds)
+        return 0;
+
+    while (PyDict_Next(keywds, &pos, &key, &value)) {
+        if (PyUnicode_Check(key) && !PyUnicode_CompareWithASCIIString(key, "count")) {
+            *count = value == Py_None ? NULL : value;
+        }
+        else if (PyUnicode_Check(key) && !PyUnicode_CompareWithASCIIString(key, "out")) {
+            *out = value == Py_None ? NULL : value;
+        }
+        else {
+            PyErr_Format(PyExc_TypeError, "%s() got an unexpected keyword argument '%S'",
+                         name, key);
+            return -1;
+        }
+    }
+    if (*count && *out) {
+        PyErr_Format(PyExc_TypeError, "%s() accepts either count or out, not both", name);
+        return -1;
+    }
+    return (*count || *out) ? 1 : 0;
+}
+
+static void
+_GMPy_Random_MPZ(mpz_ptr z, gmp_randstate_t state, gmpy_random_spec *spec)
+{
+    if (spec->kind == GMPY_RANDOM_URANDOMB)
+        mpz_urandomb(z, state, spec->bits);
+    else if (spec->kind == GMPY_RANDOM_RRANDOMB)
+        mpz_rrandomb(z, state, spec->bits);
+    else
+        mpz_urandomm(z, state, spec->n);
+}
+
+/* Generate count values into zs, fs, or the records of buf. Only one of
+ * them is used.
+ */
+
+typedef struct {
+    mpz_ptr *zs;
+    mpfr_ptr *fs;
+    unsigned char *buf;
+    size_t recsize;
+    Py_ssize_t count;
+} gmpy_random_target;
+
+static void
+_GMPy_Random_Fill(gmp_randstate_t state, gmpy_random_spec *spec,
+                  gmpy_random_target *target, mpz_ptr temp)
+{
+    Py_ssize_t i;
+    size_t written;
+
+    for (i = 0; i < target->count; i++) {
+        if (target->fs) {
+            mpfr_urandom(target->fs[i], state, spec->round);
+        }
+        else if (target->zs) {
+            _GMPy_Random_MPZ(target->zs[i], state, spec);
+        }
+        else {
+            unsigned char *rec = target->buf + (size_t)i * target->recsize;
+
+            _GMPy_Random_MPZ(temp, state, spec);
+            memset(rec, 0, target->recsize);
+            mpz_export(rec, &written, -1, 1, 0, 0, temp);
+        }
+    }
+}
+
+static PyObject *
+_GMPy_Random_Many(PyObject *state, gmpy_random_spec *spec, PyObject *count,
+                  PyObject *out, const char *name)
+{
+    PyObject *result = NULL, **items = NULL;
+    gmpy_random_target target = {NULL, NULL, NULL, 0, 0};
+    Py_buffer view;
+    int has_view = 0;
+    mpz_t *block = NULL;
+    mpz_t temp;
+    gmp_randstate_t local;
+    size_t bits;
+    Py_ssize_t i, n = 0;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (count) {
+        n = PyNumber_AsSsize_t(count, PyExc_OverflowError);
+        if (n == -1 && PyErr_Occurred())
+            return NULL;
+        if (n < 0) {
+            PyErr_Format(PyExc_ValueError, "%s() requires count >= 0", name);
+            return NULL;
+        }
+    }
+    else if (PyList_Check(out)) {
+        n = PyList_GET_SIZE(out);
+    }
+    else if (MPZ_Array_Check(out) && spec->kind != GMPY_RANDOM_MPFR) {
+        n = ((MPZ_Array_Object*)out)->size;
+    }
+    else if (spec->kind != GMPY_RANDOM_MPFR && PyObject_CheckBuffer(out)) {
+        if (PyObject_GetBuffer(out, &view, PyBUF_WRITABLE) < 0)
+            return NULL;
+        has_view = 1;
+        if (spec->kind == GMPY_RANDOM_URANDOMM)
+            target.recsize = (mpz_sizeinbase(spec->n, 2) + 7) / 8;
+        else
+            target.recsize = (spec->bits + 7) / 8;
+        if (target.recsize == 0 || view.len % (Py_ssize_t)target.recsize) {
+            PyErr_Format(PyExc_ValueError,
+                         "%s() requires a buffer whose length is a multiple of %zd",
+                         name, (Py_ssize_t)(target.recsize ? target.recsize : 1));
+            goto done;
+        }
+        n = view.len / (Py_ssize_t)target.recsize;
+        target.buf = (unsigned char*)view.buf;
+    }
+    else {
+        PyErr_Format(PyExc_TypeError, "%s() does not support out of type '%s'",
+                     name, Py_TYPE(out)->tp_name);
+        return NULL;
+    }
+    target.count = n;
+
+    /* Create the destination values while holding the GIL. */
+
+    if (!target.buf) {
+        if (!(items = PyMem_New(PyObject*, n ? n : 1))) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        for (i = 0; i < n; i++)
+            items[i] = NULL;
+        if (spec->kind == GMPY_RANDOM_MPFR)
+            target.fs = PyMem_New(mpfr_ptr, n ? n : 1);
+        else
+            target.zs = PyMem_New(mpz_ptr, n ? n : 1);
+        if (!target.fs && !target.zs) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        if (out && MPZ_Array_Check(out)) {
+            if (!(block = PyMem_New(mpz_t, n ? n : 1))) {
+                PyErr_NoMemory();
+                goto done;
+            }
+            for (i = 0; i < n; i++) {
+                mpz_init(block[i]);
+                target.zs[i] = block[i];
+            }
+        }
+        else {
+            for (i = 0; i < n; i++) {
+                if (spec->kind == GMPY_RANDOM_MPFR) {
+                    if (!(items[i] = (PyObject*)GMPy_MPFR_New(0, context)))
+                        goto done;
+                    target.fs[i] = MPFR(items[i]);
+                }
+                else {
+                    if (!(items[i] = (PyObject*)GMPy_MPZ_New(NULL)))
+                        goto done;
+                    target.zs[i] = MPZ(items[i]);
+                }
+            }
+        }
+    }
+
+    if (spec->kind == GMPY_RANDOM_MPFR)
+        bits = (size_t)GET_MPFR_PREC(context);
+    else if (spec->kind == GMPY_RANDOM_URANDOMM)
+        bits = mpz_sizeinbase(spec->n, 2);
+    else
+        bits = spec->bits;
+
+    mpz_init(temp);
+    gmp_randinit_set(local, RANDOM_STATE(state));
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits * (size_t)n);
+    _GMPy_Random_Fill(local, spec, &target, temp);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    gmp_randclear(RANDOM_STATE(state));
+    gmp_randinit_set(RANDOM_STATE(state), local);
+    gmp_randclear(local);
+    mpz_clear(temp);
+
+    if (out) {
+        if (block) {
+            MPZ_Array_Object *array = (MPZ_Array_Object*)out;
+
+            /* The array may have been resized while the GIL was released. */
+
+            for (i = 0; i < n && i < array->size; i++)
+                mpz_swap(array->z[i], block[i]);
+        }
+        else if (items) {
+            for (i = 0; i < n && i < PyList_GET_SIZE(out); i++) {
+                PyObject *old = PyList_GET_ITEM(out, i);
+
+                PyList_SET_ITEM(out, i, items[i]);
+                items[i] = NULL;
+                Py_DECREF(old);
+            }
+        }
+        Py_INCREF(out);
+        result = out;
+    }
+    else {
+        if ((result = PyList_New(n))) {
+            for (i = 0; i < n; i++) {
+                PyList_SET_ITEM(result, i, items[i]);
+                items[i] = NULL;
+            }
+        }
+    }
+
+  done:
+    if (items) {
+        for (i = 0; i < n; i++)
+            Py_XDECREF(items[i]);
+        PyMem_Free(items);
+    }
+    if (block) {
+        for (i = 0; i < n; i++)
+            mpz_clear(block[i]);
+        PyMem_Free(block);
+    }
+    PyMem_Free(target.zs);
+    PyMem_Free(target.fs);
+    if (has_view)
+        PyBuffer_Release(&view);
+    return result;
+}
+
 PyDoc_STRVAR(GMPy_doc_mpz_urandomb_function,
-"mpz_urandomb(random_state, bit_count, /) -> mpz\n\n"
+"mpz_urandomb(random_state, bit_count, /, *, count=None, out=None) -> mpz\n\n"
 "Return uniformly distributed random integer between 0 and\n"
-"2**bit_count-1.");
+"2**bit_count-1. With count, return a list of count values. With out,\n"
+"fill a list, an `mpz_array`, or a writable buffer of little-endian\n"
+"(bit_count + 7) // 8 byte records, and return out.");
 
 static PyObject *
-GMPy_MPZ_urandomb_Function(PyObject *self, PyObject *args)
+GMPy_MPZ_urandomb_Function(PyObject *self, PyObject *args, PyObject *keywds)
 {
     MPZ_Object *result;
-    PyObject *temp0, *temp1;
+    PyObject *temp0, *temp1, *count, *out;
     unsigned long len;
+    int many;
+
+    if ((many = _GMPy_Random_Keywords(keywds, &count, &out, "mpz_urandomb")) < 0)
+        return NULL;
 
     if (PyTuple_GET_SIZE(args) != 2) {
         TYPE_ERROR("mpz_urandomb() requires 2 arguments");
@@ -114,6 +607,12 @@ GMPy_MPZ_urandomb_Function(PyObject *self, PyObject *args)
         return NULL;
     }
 
+    if (many) {
+        gmpy_random_spec spec = {GMPY_RANDOM_URANDOMB, len, NULL, MPFR_RNDN};
+
+        return _GMPy_Random_Many(temp0, &spec, count, out, "mpz_urandomb");
+    }
+
     if ((result = GMPy_MPZ_New(NULL))) {
         mpz_urandomb(result->z, RANDOM_STATE(temp0), len);
     }
@@ -122,16 +621,21 @@ GMPy_MPZ_urandomb_Function(PyObject *self, PyObject *args)
 }
 
 PyDoc_STRVAR(GMPy_doc_mpz_rrandomb_function,
-"mpz_rrandomb(random_state, bit_count, /) -> mpz\n\n"
+"mpz_rrandomb(random_state, bit_count, /, *, count=None, out=None) -> mpz\n\n"
 "Return a random integer between 0 and 2**bit_count-1 with long\n"
-"sequences of zeros and one in its binary representation.");
+"sequences of zeros and one in its binary representation. count and\n"
+"out are as for `mpz_urandomb()`.");
 
 static PyObject *
-GMPy_MPZ_rrandomb_Function(PyObject *self, PyObject *args)
+GMPy_MPZ_rrandomb_Function(PyObject *self, PyObject *args, PyObject *keywds)
 {
     MPZ_Object *result;
-    PyObject *temp0, *temp1;
+    PyObject *temp0, *temp1, *count, *out;
     unsigned long len;
+    int many;
+
+    if ((many = _GMPy_Random_Keywords(keywds, &count, &out, "mpz_rrandomb")) < 0)
+        return NULL;
 
     if (PyTuple_GET_SIZE(args) != 2) {
         TYPE_ERROR("mpz_rrandomb() requires 2 arguments");
@@ -152,6 +656,12 @@ GMPy_MPZ_rrandomb_Function(PyObject *self, PyObject *args)
         return NULL;
     }
 
+    if (many) {
+        gmpy_random_spec spec = {GMPY_RANDOM_RRANDOMB, len, NULL, MPFR_RNDN};
+
+        return _GMPy_Random_Many(temp0, &spec, count, out, "mpz_rrandomb");
+    }
+
     if ((result = GMPy_MPZ_New(NULL))) {
         mpz_rrandomb(result->z, RANDOM_STATE(temp0), len);
     }
@@ -160,14 +670,20 @@ GMPy_MPZ_rrandomb_Function(PyObject *self, PyObject *args)
 }
 
 PyDoc_STRVAR(GMPy_doc_mpz_random_function,
-"mpz_random(random_state, int, /) -> mpz\n\n"
-"Return uniformly distributed random integer between 0 and n-1.");
+"mpz_random(random_state, int, /, *, count=None, out=None) -> mpz\n\n"
+"Return uniformly distributed random integer between 0 and n-1. count\n"
+"and out are as for `mpz_urandomb()`; buffer records hold\n"
+"n.bit_length() bits.");
 
 static PyObject *
-GMPy_MPZ_random_Function(PyObject *self, PyObject *args)
+GMPy_MPZ_random_Function(PyObject *self, PyObject *args, PyObject *keywds)
 {
     MPZ_Object *result, *temp;
-    PyObject *temp0, *temp1;
+    PyObject *temp0, *temp1, *count, *out;
+    int many;
+
+    if ((many = _GMPy_Random_Keywords(keywds, &count, &out, "mpz_random")) < 0)
+        return NULL;
 
     if (PyTuple_GET_SIZE(args) != 2) {
         TYPE_ERROR("mpz_random() requires 2 arguments");
@@ -187,6 +703,20 @@ GMPy_MPZ_random_Function(PyObject *self, PyObject *args)
         return NULL;
     }
 
+    if (mpz_sgn(temp->z) == 0) {
+        Py_DECREF((PyObject*)temp);
+        ZERO_ERROR("mpz_random() requires a nonzero bound");
+        return NULL;
+    }
+
+    if (many) {
+        gmpy_random_spec spec = {GMPY_RANDOM_URANDOMM, 0, temp->z, MPFR_RNDN};
+        PyObject *res = _GMPy_Random_Many(temp0, &spec, count, out, "mpz_random");
+
+        Py_DECREF((PyObject*)temp);
+        return res;
+    }
+
     if ((result = GMPy_MPZ_New(NULL))) {
         mpz_urandomm(result->z, RANDOM_STATE(PyTuple_GET_ITEM(args, 0)), temp->z);
     }
@@ -196,17 +726,23 @@ GMPy_MPZ_random_Function(PyObject *self, PyObject *args)
 }
 
 PyDoc_STRVAR(GMPy_doc_mpfr_random_function,
-"mpfr_random(random_state, /) -> mpfr\n\n"
-"Return uniformly distributed number between [0,1].");
+"mpfr_random(random_state, /, *, count=None, out=None) -> mpfr\n\n"
+"Return uniformly distributed number between [0,1]. With count, return\n"
+"a list of count values. With out, fill a list and return it.");
 
 static PyObject *
-GMPy_MPFR_random_Function(PyObject *self, PyObject *args)
+GMPy_MPFR_random_Function(PyObject *self, PyObject *args, PyObject *keywds)
 {
     MPFR_Object *result;
+    PyObject *count, *out;
+    int many;
     CTXT_Object *context = NULL;
 
     CHECK_CONTEXT(context);
 
+    if ((many = _GMPy_Random_Keywords(keywds, &count, &out, "mpfr_random")) < 0)
+        return NULL;
+
     if (PyTuple_GET_SIZE(args) != 1) {
         TYPE_ERROR("mpfr_random() requires 1 argument");
         return NULL;
@@ -217,6 +753,13 @@ GMPy_MPFR_random_Function(PyObject *self, PyObject *args)
         return NULL;
     }
 
+    if (many) {
+        gmpy_random_spec spec = {GMPY_RANDOM_MPFR, 0, NULL, GET_MPFR_ROUND(context)};
+
+        return _GMPy_Random_Many(PyTuple_GET_ITEM(args, 0), &spec, count, out,
+                                 "mpfr_random");
+    }
+
     if ((result = GMPy_MPFR_New(0, context))) {
         mpfr_urandom(result->f, RANDOM_STATE(PyTuple_GET_ITEM(args, 0)), GET_MPFR_ROUND(context));
     }
@@ -377,6 +920,21 @@ GMPy_MPC_random_Function(PyObject *self, PyObject *args)
     return (PyObject*)result;
 }
 
+static PyMethodDef GMPy_RandomState_methods[] =
+{
+    { "__copy__", GMPy_RandomState_Copy, METH_NOARGS, GMPy_doc_random_state_copy },
+    { "copy", GMPy_RandomState_Copy, METH_NOARGS, GMPy_doc_random_state_copy },
+    { "spawn", GMPy_RandomState_Spawn, METH_O, GMPy_doc_random_state_spawn },
+    { NULL, NULL, 1 }
+};
+
+static PyGetSetDef GMPy_RandomState_getseters[] =
+{
+    { "spawn_key", (getter)GMPy_RandomState_GetSpawnKey, NULL,
+        "the indices of spawn() calls that led from the root state to this state", NULL },
+    { NULL }
+};
+
 static PyTypeObject RandomState_Type =
 {
     PyVarObject_HEAD_INIT(0, 0)
@@ -386,4 +944,6 @@ static PyTypeObject RandomState_Type =
     .tp_repr = (reprfunc) GMPy_RandomState_Repr,
     .tp_flags = Py_TPFLAGS_DEFAULT, 
     .tp_doc = "GMPY2 Random number generator state", 
+    .tp_methods = GMPy_RandomState_methods,
+    .tp_getset = GMPy_RandomState_getseters,
 };
@@ -49,10 +49,12 @@ static void                 GMPy_RandomState_Dealloc(RandomState_Object *self);
 
 static PyObject * GMPy_RandomState_Repr(RandomState_Object *self);
 static PyObject * GMPy_RandomState_Factory(PyObject *self, PyObject *args);
-static PyObject * GMPy_MPZ_urandomb_Function(PyObject *self, PyObject *args);
-static PyObject * GMPy_MPZ_rrandomb_Function(PyObject *self, PyObject *args);
-static PyObject * GMPy_MPZ_random_Function(PyObject *self, PyObject *args);
-static PyObject * GMPy_MPFR_random_Function(PyObject *self, PyObject *args);
+static PyObject * GMPy_RandomState_Copy(PyObject *self, PyObject *Py_UNUSED(ignored));
+static PyObject * GMPy_RandomState_Spawn(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_urandomb_Function(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_rrandomb_Function(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_random_Function(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPFR_random_Function(PyObject *self, PyObject *args, PyObject *keywds);
 #if MPFR_VERSION_MAJOR > 3
 static PyObject * GMPy_MPFR_nrandom_Function(PyObject *self, PyObject *args);
 #endif
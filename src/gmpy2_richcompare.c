@@ -41,6 +41,179 @@ static PyObject *_cmp_to_object(int c, int op)
     Py_INCREF(result);
     return result;
 }
+/* Comparisons with an int that does not fit in a C long read its digits in
+ * place. The signs and the bit lengths decide most comparisons; an mpz of
+ * the same length is compared limb by limb from the most significant end,
+ * assembling each limb of the int from its digits. Only the remaining
+ * mpq and mpfr cases convert the int, to an mpz on the stack.
+ */
+
+static size_t
+_GMPy_PyLong_Bits(const digit *digits, size_t size)
+{
+    size_t bits = (size - 1) * PyLong_SHIFT;
+    digit top = digits[size - 1];
+
+    while (top) {
+        bits++;
+        top >>= 1;
+    }
+    return bits;
+}
+
+#if GMP_NAIL_BITS == 0
+static mp_limb_t
+_GMPy_PyLong_Limb(const digit *digits, size_t size, size_t i)
+{
+    size_t j = i * GMP_NUMB_BITS / PyLong_SHIFT;
+    unsigned int got = PyLong_SHIFT - (i * GMP_NUMB_BITS) % PyLong_SHIFT;
+    mp_limb_t acc;
+
+    if (j >= size)
+        return 0;
+    acc = (mp_limb_t)digits[j] >> (PyLong_SHIFT - got);
+    while (got < GMP_NUMB_BITS && ++j < size) {
+        acc |= (mp_limb_t)digits[j] << got;
+        got += PyLong_SHIFT;
+    }
+    return acc;
+}
+#endif
+
+/* Return the sign of obj and store its digits, their number, and its bit
+ * length.
+ */
+
+static int
+_GMPy_PyLong_View(PyObject *obj, const digit **digits, size_t *size, size_t *bits)
+{
+    PyLongObject *v = (PyLongObject*)obj;
+
+    *digits = GET_OB_DIGIT(v);
+    *size = (size_t)_PyLong_DigitCount(v);
+    if (*size == 0) {
+        *bits = 0;
+        return 0;
+    }
+    *bits = _GMPy_PyLong_Bits(*digits, *size);
+    return _PyLong_IsNegative(v) ? -1 : 1;
+}
+
+static int
+_GMPy_MPZ_Cmp_PyLong(mpz_srcptr z, PyObject *obj)
+{
+    const digit *digits;
+    size_t size, bits, zbits;
+    int sign = _GMPy_PyLong_View(obj, &digits, &size, &bits);
+    int zsign = mpz_sgn(z);
+
+    if (zsign != sign)
+        return zsign < sign ? -1 : 1;
+    if (zsign == 0)
+        return 0;
+
+    zbits = mpz_sizeinbase(z, 2);
+    if (zbits != bits)
+        return zbits < bits ? -zsign : zsign;
+
+#if GMP_NAIL_BITS == 0
+    {
+        size_t i = mpz_size(z);
+        mp_limb_t zl, ll;
+
+        while (i-- > 0) {
+            zl = mpz_getlimbn(z, i);
+            ll = _GMPy_PyLong_Limb(digits, size, i);
+            if (zl != ll)
+                return zl < ll ? -zsign : zsign;
+        }
+        return 0;
+    }
+#else
+    {
+        mpz_t tempz;
+        int c;
+
+        mpz_init(tempz);
+        mpz_set_PyLong(tempz, obj);
+        c = mpz_cmp(z, tempz);
+        mpz_clear(tempz);
+        return c;
+    }
+#endif
+}
+
+static int
+_GMPy_MPQ_Cmp_PyLong(mpq_srcptr q, PyObject *obj)
+{
+    const digit *digits;
+    size_t size, bits;
+    Py_ssize_t diff;
+    int sign, qsign = mpq_sgn(q), c;
+    mpz_t tempz;
+
+    if (mpz_cmp_ui(mpq_denref(q), 1) == 0)
+        return _GMPy_MPZ_Cmp_PyLong(mpq_numref(q), obj);
+
+    sign = _GMPy_PyLong_View(obj, &digits, &size, &bits);
+    if (qsign != sign)
+        return qsign < sign ? -1 : 1;
+
+    /* 2**(diff-1) < |q| < 2**(diff+1) */
+    diff = (Py_ssize_t)mpz_sizeinbase(mpq_numref(q), 2) -
+           (Py_ssize_t)mpz_sizeinbase(mpq_denref(q), 2);
+    if (diff - 1 >= (Py_ssize_t)bits)
+        return qsign;
+    if (diff + 2 <= (Py_ssize_t)bits)
+        return -qsign;
+
+    mpz_init(tempz);
+    mpz_set_PyLong(tempz, obj);
+    mpz_mul(tempz, tempz, mpq_denref(q));
+    c = mpz_cmp(mpq_numref(q), tempz);
+    mpz_clear(tempz);
+    return c;
+}
+
+/* Like mpfr_cmp_z(), sets the erange flag if f is NaN. */
+
+static int
+_GMPy_MPFR_Cmp_PyLong(mpfr_srcptr f, PyObject *obj)
+{
+    const digit *digits;
+    size_t size, bits;
+    int sign, fsign, c;
+    mpfr_exp_t exp;
+    mpz_t tempz;
+
+    if (mpfr_nan_p(f)) {
+        mpfr_set_erangeflag();
+        return 0;
+    }
+    if (mpfr_inf_p(f))
+        return mpfr_sgn(f);
+
+    sign = _GMPy_PyLong_View(obj, &digits, &size, &bits);
+    fsign = mpfr_sgn(f);
+    if (fsign != sign)
+        return fsign < sign ? -1 : 1;
+    if (fsign == 0)
+        return 0;
+
+    /* 2**(exp-1) <= |f| < 2**exp */
+    exp = mpfr_get_exp(f);
+    if (exp > (mpfr_exp_t)bits)
+        return fsign;
+    if (exp < (mpfr_exp_t)bits)
+        return -fsign;
+
+    mpz_init(tempz);
+    mpz_set_PyLong(tempz, obj);
+    c = mpfr_cmp_z(f, tempz);
+    mpz_clear(tempz);
+    return c;
+}
+
 static PyObject *
 GMPy_RichCompare_Slot(PyObject *a, PyObject *b, int op)
 {
@@ -55,18 +228,13 @@ GMPy_RichCompare_Slot(PyObject *a, PyObject *b, int op)
 
     if (IS_TYPE_MPZANY(atype)) {
         if (IS_TYPE_PyInteger(btype)) {
-            int error;
-            long temp = PyLong_AsLongAndOverflow(b, &error);
+            long temp;
 
-            if (!error) {
+            if (GMPy_PyLong_AsSmall(b, &temp)) {
                 c = mpz_cmp_si(MPZ(a), temp);
             }
             else {
-                mpz_t tempz;
-                mpz_init(tempz);
-                mpz_set_PyLong(tempz, b);
-                c = mpz_cmp(MPZ(a), tempz);
-                mpz_clear(tempz);
+                c = _GMPy_MPZ_Cmp_PyLong(MPZ(a), b);
             }
             return _cmp_to_object(c, op);
         }
@@ -122,6 +290,15 @@ GMPy_RichCompare_Slot(PyObject *a, PyObject *b, int op)
             return _cmp_to_object(mpq_cmp(MPQ(a), MPQ(b)), op);
         }
 
+        if (IS_TYPE_PyInteger(btype)) {
+            long temp;
+
+            if (GMPy_PyLong_AsSmall(b, &temp)) {
+                return _cmp_to_object(mpq_cmp_si(MPQ(a), temp, 1), op);
+            }
+            return _cmp_to_object(_GMPy_MPQ_Cmp_PyLong(MPQ(a), b), op);
+        }
+
         if (IS_TYPE_RATIONAL(btype)) {
             if (!(tempb = (PyObject*)GMPy_MPQ_From_RationalWithType(b, btype, context))) {
                 return NULL;
@@ -162,7 +339,7 @@ GMPy_RichCompare_Slot(PyObject *a, PyObject *b, int op)
             c = mpfr_cmp(MPFR(a), MPFR(b));
             if (mpfr_erangeflag_p()) {
                 /* Set erange and check if an exception should be raised. */
-                context->ctx.erange = 1;
+                GMPY_CTXT_FLAGS(context)->erange = 1;
                 if (context->ctx.traps & TRAP_ERANGE) {
                     GMPY_ERANGE("comparison with NaN");
                     return NULL;
@@ -182,7 +359,7 @@ GMPy_RichCompare_Slot(PyObject *a, PyObject *b, int op)
             c = mpfr_cmp_d(MPFR(a), d);
             if (mpfr_erangeflag_p()) {
                 /* Set erange and check if an exception should be raised. */
-                context->ctx.erange = 1;
+                GMPY_CTXT_FLAGS(context)->erange = 1;
                 if (context->ctx.traps & TRAP_ERANGE) {
                     GMPY_ERANGE("comparison with NaN");
                     return NULL;
@@ -197,15 +374,27 @@ GMPy_RichCompare_Slot(PyObject *a, PyObject *b, int op)
         }
 
         if (IS_TYPE_INTEGER(btype)) {
-            if (!(tempb = (PyObject*)GMPy_MPZ_From_IntegerWithType(b, btype, context)))  {
-                return NULL;
+            long temp;
+
+            if (IS_TYPE_PyInteger(btype) && GMPy_PyLong_AsSmall(b, &temp)) {
+                mpfr_clear_flags();
+                c = mpfr_cmp_si(MPFR(a), temp);
+            }
+            else if (IS_TYPE_PyInteger(btype)) {
+                mpfr_clear_flags();
+                c = _GMPy_MPFR_Cmp_PyLong(MPFR(a), b);
+            }
+            else {
+                if (!(tempb = (PyObject*)GMPy_MPZ_From_IntegerWithType(b, btype, context)))  {
+                    return NULL;
+                }
+                mpfr_clear_flags();
+                c = mpfr_cmp_z(MPFR(a), MPZ(tempb));
+                Py_DECREF(tempb);
             }
-            mpfr_clear_flags();
-            c = mpfr_cmp_z(MPFR(a), MPZ(tempb));
-            Py_DECREF(tempb);
             if (mpfr_erangeflag_p()) {
                 /* Set erange and check if an exception should be raised. */
-                context->ctx.erange = 1;
+                GMPY_CTXT_FLAGS(context)->erange = 1;
                 if (context->ctx.traps & TRAP_ERANGE) {
                     GMPY_ERANGE("comparison with NaN");
                     return NULL;
@@ -228,7 +417,7 @@ GMPy_RichCompare_Slot(PyObject *a, PyObject *b, int op)
             Py_DECREF(tempb);
             if (mpfr_erangeflag_p()) {
                 /* Set erange and check if an exception should be raised. */
-                context->ctx.erange = 1;
+                GMPY_CTXT_FLAGS(context)->erange = 1;
                 if (context->ctx.traps & TRAP_ERANGE) {
                     GMPY_ERANGE("comparison with NaN");
                     return NULL;
@@ -251,7 +440,7 @@ GMPy_RichCompare_Slot(PyObject *a, PyObject *b, int op)
             Py_DECREF(tempb);
             if (mpfr_erangeflag_p()) {
                 /* Set erange and check if an exception should be raised. */
-                context->ctx.erange = 1;
+                GMPY_CTXT_FLAGS(context)->erange = 1;
                 if (context->ctx.traps & TRAP_ERANGE) {
                     GMPY_ERANGE("comparison with NaN");
                     return NULL;
@@ -276,7 +465,7 @@ GMPy_RichCompare_Slot(PyObject *a, PyObject *b, int op)
             c = mpc_cmp(MPC(a), MPC(b));
             if (mpfr_erangeflag_p()) {
                 /* Set erange and check if an exception should be raised. */
-                context->ctx.erange = 1;
+                GMPY_CTXT_FLAGS(context)->erange = 1;
                 if (context->ctx.traps & TRAP_ERANGE) {
                     GMPY_ERANGE("comparison with NaN");
                     return NULL;
@@ -299,7 +488,7 @@ GMPy_RichCompare_Slot(PyObject *a, PyObject *b, int op)
             Py_DECREF(tempb);
             if (mpfr_erangeflag_p()) {
                 /* Set erange and check if an exception should be raised. */
-                context->ctx.erange = 1;
+                GMPY_CTXT_FLAGS(context)->erange = 1;
                 if (context->ctx.traps & TRAP_ERANGE) {
                     GMPY_ERANGE("comparison with NaN");
                     return NULL;
@@ -316,7 +505,7 @@ GMPy_RichCompare_Slot(PyObject *a, PyObject *b, int op)
         if (!mpfr_zero_p(mpc_imagref(MPC(a)))) {
             /* if a.real is NaN, possibly raise exception */
             if (mpfr_nan_p(mpc_realref(MPC(a)))) {
-                context->ctx.erange = 1;
+                GMPY_CTXT_FLAGS(context)->erange = 1;
                 if (context->ctx.traps & TRAP_ERANGE) {
                     GMPY_ERANGE("comparison with NaN");
                     return NULL;
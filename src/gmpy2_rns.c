@@ -0,0 +1,862 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_rns.c                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Residue number systems.
+ *
+ * An integer is kept as its residues modulo n word-size moduli, so +, -
+ * and * are n independent word operations with no carries between them.
+ * The result is exact as long as the true value stays in [0, M), or in
+ * (-M/2, M/2) when it is read back with signed=True, where M is the
+ * product of the moduli. Converting from an integer reduces it down the
+ * product tree of the CRTPlan; converting back uses the plan's CRT.
+ */
+
+#ifdef GMPY_MONT_INT128
+#  define RNS_MUL(m, a, b)  _GMPy_U64_Mul(m, a, b)
+#  define RNS_ADD(m, a, b)  _GMPy_U64_Add(m, a, b)
+#  define RNS_SUB(m, a, b)  _GMPy_U64_Sub(m, a, b)
+#  define RNS_ONE(m)        ((m)->one)
+#  define RNS_TO(m, a)      _GMPy_U64_Mul(m, a, (m)->r2)
+#  define RNS_FROM(m, a)    _GMPy_U64_Mul(m, a, 1)
+#else
+#  define RNS_MUL(m, a, b)  ((mp_limb_t)(((unsigned long long)(a) * (b)) % (m)->n))
+#  define RNS_ADD(m, a, b)  _GMPy_RNS_Add(m, a, b)
+#  define RNS_SUB(m, a, b)  ((a) - (b) + ((a) < (b) ? (m)->n : 0))
+#  define RNS_ONE(m)        1
+#  define RNS_TO(m, a)      (a)
+#  define RNS_FROM(m, a)    (a)
+
+static mp_limb_t
+_GMPy_RNS_Add(const gmpy_rns_mod *m, mp_limb_t a, mp_limb_t b)
+{
+    mp_limb_t x = a + b;
+
+    return (x < a || x >= m->n) ? x - m->n : x;
+}
+#endif
+
+/* Below these sizes x is reduced by each modulus directly instead of down
+ * the product tree.
+ */
+
+#define GMPY_RNS_TREE_LIMBS 32
+#define GMPY_RNS_TREE_MODULI 16
+
+enum { RNS_OP_ADD, RNS_OP_SUB, RNS_OP_MUL, RNS_OP_NEG };
+
+PyDoc_STRVAR(GMPy_doc_rns,
+"RNS(moduli, /) -> RNS\n\n"
+"Return a residue number system for the given moduli. The moduli must be\n"
+"odd, > 1, less than 2**64 and pairwise coprime; ValueError is raised\n"
+"otherwise. Calling the RNS with an integer returns an rns that holds\n"
+"the integer modulo each of the moduli. rns values of the same RNS can\n"
+"be added, subtracted, multiplied and raised to non-negative integer\n"
+"powers; each operation works on the residues independently. The result\n"
+"is the true value modulo the product of the moduli. The GIL is released\n"
+"and the work is split over the context's threads.");
+
+PyDoc_STRVAR(GMPy_doc_rnsint,
+"An integer kept as its residues modulo the moduli of an RNS. rns values\n"
+"are returned by calling an RNS.");
+
+typedef struct {
+    RNS_Object *basis;
+    mp_limb_t *r;
+    const mp_limb_t *a;
+    const mp_limb_t *b;
+    mpz_srcptr x;               /* value to reduce, or the exponent */
+    mpz_t *z;                   /* values < the moduli */
+    int op;
+} gmpy_rns_work;
+
+/* Set r[i] to the residue of x. */
+
+static void
+_GMPy_RNS_Mod_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_rns_work *work = (gmpy_rns_work*)arg;
+    const gmpy_rns_mod *mod = work->basis->mod;
+    mp_srcptr xp = mpz_limbs_read(work->x);
+    mp_size_t size = mpz_size(work->x);
+    mp_limb_t t;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        t = size ? mpn_mod_1(xp, size, mod[i].n) : 0;
+        if (mpz_sgn(work->x) < 0 && t)
+            t = mod[i].n - t;
+        work->r[i] = RNS_TO(&mod[i], t);
+    }
+}
+
+/* Set r[i] to the residue of z[i]. */
+
+static void
+_GMPy_RNS_Leaf_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_rns_work *work = (gmpy_rns_work*)arg;
+    const gmpy_rns_mod *mod = work->basis->mod;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++)
+        work->r[i] = RNS_TO(&mod[i], mpz_getlimbn(work->z[i], 0));
+}
+
+/* Set z[i] to the value of the residue a[i]. */
+
+static void
+_GMPy_RNS_Value_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_rns_work *work = (gmpy_rns_work*)arg;
+    const gmpy_rns_mod *mod = work->basis->mod;
+    mp_limb_t t;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        t = RNS_FROM(&mod[i], work->a[i]);
+        mpz_limbs_write(work->z[i], 1)[0] = t;
+        mpz_limbs_finish(work->z[i], t != 0);
+    }
+}
+
+/* As _GMPy_Tree_Mod_Range() but with the remainders in a separate tree
+ * so the tree of the plan is left unchanged.
+ */
+
+typedef struct {
+    gmpy_product_tree *tree;
+    gmpy_product_tree *rem;
+    int level;
+} gmpy_rns_level;
+
+static void
+_GMPy_RNS_Reduce_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_rns_level *work = (gmpy_rns_level*)arg;
+    int k = work->level;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++)
+        mpz_mod(TREE_NODE(work->rem, k, i), TREE_NODE(work->rem, k + 1, i / 2),
+                TREE_NODE(work->tree, k, i));
+}
+
+/* The elementwise operations. The switch is outside the loops so each
+ * loop is a plain pass over the residues.
+ */
+
+static void
+_GMPy_RNS_Op_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_rns_work *work = (gmpy_rns_work*)arg;
+    const gmpy_rns_mod *mod = work->basis->mod;
+    const mp_limb_t *a = work->a, *b = work->b;
+    mp_limb_t *r = work->r;
+    Py_ssize_t i;
+
+    switch (work->op) {
+    case RNS_OP_ADD:
+        for (i = start; i < stop; i++)
+            r[i] = RNS_ADD(&mod[i], a[i], b[i]);
+        break;
+    case RNS_OP_SUB:
+        for (i = start; i < stop; i++)
+            r[i] = RNS_SUB(&mod[i], a[i], b[i]);
+        break;
+    case RNS_OP_MUL:
+        for (i = start; i < stop; i++)
+            r[i] = RNS_MUL(&mod[i], a[i], b[i]);
+        break;
+    default:
+        for (i = start; i < stop; i++)
+            r[i] = RNS_SUB(&mod[i], 0, a[i]);
+        break;
+    }
+}
+
+static void
+_GMPy_RNS_Pow_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_rns_work *work = (gmpy_rns_work*)arg;
+    const gmpy_rns_mod *mod = work->basis->mod;
+    mp_bitcnt_t bit, bits = mpz_sizeinbase(work->x, 2);
+    mp_limb_t t;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        t = RNS_ONE(&mod[i]);
+        if (mpz_sgn(work->x)) {
+            for (bit = bits; bit-- > 0;) {
+                t = RNS_MUL(&mod[i], t, t);
+                if (mpz_tstbit(work->x, bit))
+                    t = RNS_MUL(&mod[i], t, work->a[i]);
+            }
+        }
+        work->r[i] = t;
+    }
+}
+
+static RNSInt_Object *
+_GMPy_RNSInt_New(RNS_Object *basis)
+{
+    RNSInt_Object *result;
+
+    if ((result = PyObject_NewVar(RNSInt_Object, &RNSInt_Type, basis->n))) {
+        Py_INCREF((PyObject*)basis);
+        result->basis = basis;
+    }
+    return result;
+}
+
+static void
+GMPy_RNSInt_Dealloc(RNSInt_Object *self)
+{
+    Py_DECREF((PyObject*)self->basis);
+    PyObject_Free(self);
+}
+
+/* Set r to the residues of x. Returns -1 with an exception set if memory
+ * ran out or the computation was interrupted.
+ */
+
+static int
+_GMPy_RNS_Set(RNS_Object *basis, mp_limb_t *r, mpz_srcptr x, CTXT_Object *context)
+{
+    gmpy_product_tree *tree = &basis->plan->tree, rem;
+    gmpy_rns_level level;
+    gmpy_rns_work work;
+    gmpy_interrupt intr;
+    Py_ssize_t n = basis->n;
+    int threads;
+
+    work.basis = basis;
+    work.r = r;
+    work.x = x;
+
+    if (mpz_size(x) <= GMPY_RNS_TREE_LIMBS || n < GMPY_RNS_TREE_MODULI) {
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)n * mpz_size(x) * GMP_NUMB_BITS);
+        threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+        GMPy_Parallel_Run(_GMPy_RNS_Mod_Range, &work, n, threads);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+        return 0;
+    }
+
+    if (_GMPy_Tree_Alloc(&rem, n) < 0)
+        return -1;
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(x) + (size_t)n * GMP_NUMB_BITS);
+    intr.save = &_save;
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+
+    level.tree = tree;
+    level.rem = &rem;
+    level.level = tree->depth - 1;
+    mpz_mod(TREE_NODE(&rem, level.level, 0), x, TREE_NODE(tree, level.level, 0));
+    while (--level.level >= 0 && !GMPy_Interrupt_Poll())
+        GMPy_Parallel_Run(_GMPy_RNS_Reduce_Range, &level,
+                          tree->size[level.level], threads);
+    if (!intr.stop) {
+        work.z = &TREE_NODE(&rem, 0, 0);
+        GMPy_Parallel_Run(_GMPy_RNS_Leaf_Range, &work, n, threads);
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    _GMPy_Tree_Free(&rem);
+    return GMPy_Interrupt_End(&intr);
+}
+
+/* Set z to the value of the residues a in [0, M), or in (-M/2, M/2) if
+ * sign is nonzero.
+ */
+
+static int
+_GMPy_RNS_Get(RNS_Object *basis, mpz_ptr z, const mp_limb_t *a, int sign,
+              CTXT_Object *context)
+{
+    gmpy_product_tree *tree = &basis->plan->tree;
+    gmpy_rns_work work;
+    mpz_srcptr *r;
+    mpz_t *scratch;
+    mpz_ptr m;
+    Py_ssize_t i, n = basis->n;
+    int threads;
+
+    scratch = PyMem_New(mpz_t, 2 * n);
+    r = PyMem_New(mpz_srcptr, n);
+    if (!scratch || !r) {
+        PyMem_Free(scratch);
+        PyMem_Free(r);
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (i = 0; i < 2 * n; i++)
+        mpz_init(scratch[i]);
+    for (i = 0; i < n; i++)
+        r[i] = scratch[i];
+
+    work.basis = basis;
+    work.a = a;
+    work.z = scratch;
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)n * GMP_NUMB_BITS);
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+    GMPy_Parallel_Run(_GMPy_RNS_Value_Range, &work, n, threads);
+    _GMPy_CRT_Solve(basis->plan, z, r, scratch, scratch + n, threads);
+    if (sign) {
+        m = TREE_NODE(tree, tree->depth - 1, 0);
+        mpz_mul_2exp(scratch[0], z, 1);
+        if (mpz_cmp(scratch[0], m) > 0)
+            mpz_sub(z, z, m);
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    for (i = 0; i < 2 * n; i++)
+        mpz_clear(scratch[i]);
+    PyMem_Free(scratch);
+    PyMem_Free(r);
+    return 0;
+}
+
+/* Return x as an rns of basis. x must be an integer or an rns of the
+ * same basis.
+ */
+
+static RNSInt_Object *
+_GMPy_RNSInt_From_Object(RNS_Object *basis, PyObject *x, CTXT_Object *context)
+{
+    RNSInt_Object *result;
+    MPZ_Object *tempx;
+
+    if (RNSInt_Check(x)) {
+        if (((RNSInt_Object*)x)->basis != basis) {
+            VALUE_ERROR("rns operands must have the same RNS");
+            return NULL;
+        }
+        Py_INCREF(x);
+        return (RNSInt_Object*)x;
+    }
+
+    if (!(tempx = GMPy_MPZ_From_Integer(x, context))) {
+        TYPE_ERROR("RNS() requires an integer argument");
+        return NULL;
+    }
+    if ((result = _GMPy_RNSInt_New(basis))) {
+        if (_GMPy_RNS_Set(basis, result->r, tempx->z, context) < 0)
+            Py_CLEAR(result);
+    }
+    Py_DECREF((PyObject*)tempx);
+    return result;
+}
+
+static PyObject *
+_GMPy_RNSInt_Op(RNSInt_Object *x, RNSInt_Object *y, int op, CTXT_Object *context)
+{
+    RNSInt_Object *result;
+    gmpy_rns_work work;
+    Py_ssize_t n = x->basis->n;
+    int threads;
+
+    if (!(result = _GMPy_RNSInt_New(x->basis)))
+        return NULL;
+
+    work.basis = x->basis;
+    work.r = result->r;
+    work.a = x->r;
+    work.b = y ? y->r : NULL;
+    work.op = op;
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)n * GMP_NUMB_BITS);
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+    GMPy_Parallel_Run(_GMPy_RNS_Op_Range, &work, n, threads);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    return (PyObject*)result;
+}
+
+static PyObject *
+_GMPy_RNSInt_Binary(PyObject *x, PyObject *y, int op)
+{
+    RNSInt_Object *tempx = NULL, *tempy = NULL;
+    RNS_Object *basis;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    basis = RNSInt_Check(x) ? ((RNSInt_Object*)x)->basis : ((RNSInt_Object*)y)->basis;
+    if (!(RNSInt_Check(x) || IS_INTEGER(x)) || !(RNSInt_Check(y) || IS_INTEGER(y)))
+        Py_RETURN_NOTIMPLEMENTED;
+
+    if ((tempx = _GMPy_RNSInt_From_Object(basis, x, context)) &&
+        (tempy = _GMPy_RNSInt_From_Object(basis, y, context)))
+        result = _GMPy_RNSInt_Op(tempx, tempy, op, context);
+    Py_XDECREF((PyObject*)tempx);
+    Py_XDECREF((PyObject*)tempy);
+    return result;
+}
+
+static PyObject *
+GMPy_RNSInt_Add_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_RNSInt_Binary(x, y, RNS_OP_ADD);
+}
+
+static PyObject *
+GMPy_RNSInt_Sub_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_RNSInt_Binary(x, y, RNS_OP_SUB);
+}
+
+static PyObject *
+GMPy_RNSInt_Mul_Slot(PyObject *x, PyObject *y)
+{
+    return _GMPy_RNSInt_Binary(x, y, RNS_OP_MUL);
+}
+
+static PyObject *
+GMPy_RNSInt_Neg_Slot(RNSInt_Object *x)
+{
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    return _GMPy_RNSInt_Op(x, NULL, RNS_OP_NEG, context);
+}
+
+static PyObject *
+GMPy_RNSInt_Pos_Slot(RNSInt_Object *x)
+{
+    Py_INCREF((PyObject*)x);
+    return (PyObject*)x;
+}
+
+static PyObject *
+GMPy_RNSInt_Pow_Slot(PyObject *base, PyObject *exp, PyObject *mod)
+{
+    RNSInt_Object *result;
+    MPZ_Object *tempe;
+    gmpy_rns_work work;
+    CTXT_Object *context = NULL;
+    Py_ssize_t n;
+    int threads;
+
+    if (!RNSInt_Check(base) || !IS_INTEGER(exp))
+        Py_RETURN_NOTIMPLEMENTED;
+
+    if (mod != Py_None) {
+        TYPE_ERROR("pow() of rns does not take a modulus");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!(tempe = GMPy_MPZ_From_Integer(exp, context)))
+        return NULL;
+
+    if (mpz_sgn(tempe->z) < 0) {
+        VALUE_ERROR("pow() of rns requires a non-negative exponent");
+        Py_DECREF((PyObject*)tempe);
+        return NULL;
+    }
+
+    n = ((RNSInt_Object*)base)->basis->n;
+    if ((result = _GMPy_RNSInt_New(((RNSInt_Object*)base)->basis))) {
+        work.basis = result->basis;
+        work.r = result->r;
+        work.a = ((RNSInt_Object*)base)->r;
+        work.x = tempe->z;
+
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)n * GMPY_MPZ_BITS(tempe->z) * GMP_NUMB_BITS);
+        threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+        GMPy_Parallel_Run(_GMPy_RNS_Pow_Range, &work, n, threads);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+    }
+    Py_DECREF((PyObject*)tempe);
+    return (PyObject*)result;
+}
+
+static int
+GMPy_RNSInt_NonZero_Slot(RNSInt_Object *self)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < self->basis->n; i++) {
+        if (self->r[i])
+            return 1;
+    }
+    return 0;
+}
+
+static PyObject *
+GMPy_RNSInt_RichCompare_Slot(PyObject *a, PyObject *b, int op)
+{
+    RNSInt_Object *tempa = NULL, *tempb = NULL;
+    RNS_Object *basis;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+
+    if ((op != Py_EQ && op != Py_NE) ||
+        !(RNSInt_Check(a) || IS_INTEGER(a)) || !(RNSInt_Check(b) || IS_INTEGER(b)))
+        Py_RETURN_NOTIMPLEMENTED;
+
+    CHECK_CONTEXT(context);
+
+    basis = RNSInt_Check(a) ? ((RNSInt_Object*)a)->basis : ((RNSInt_Object*)b)->basis;
+    if ((tempa = _GMPy_RNSInt_From_Object(basis, a, context)) &&
+        (tempb = _GMPy_RNSInt_From_Object(basis, b, context))) {
+        result = (memcmp(tempa->r, tempb->r, basis->n * sizeof(mp_limb_t)) == 0) ==
+                 (op == Py_EQ) ? Py_True : Py_False;
+        Py_INCREF(result);
+    }
+    Py_XDECREF((PyObject*)tempa);
+    Py_XDECREF((PyObject*)tempb);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_rnsint_to_mpz,
+"x.to_mpz(signed=False) -> mpz\n\n"
+"Return the value of x as an mpz in [0, M), where M is the product of\n"
+"the moduli. If signed is True the value is in (-M/2, M/2) instead.");
+
+static PyObject *
+_GMPy_RNSInt_To_MPZ(RNSInt_Object *self, int sign, CTXT_Object *context)
+{
+    MPZ_Object *result;
+
+    if ((result = GMPy_MPZ_New(context))) {
+        if (_GMPy_RNS_Get(self->basis, result->z, self->r, sign, context) < 0)
+            Py_CLEAR(result);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_RNSInt_To_MPZ(RNSInt_Object *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"signed", NULL};
+    CTXT_Object *context = NULL;
+    int sign = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|p", kwlist, &sign))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    return _GMPy_RNSInt_To_MPZ(self, sign, context);
+}
+
+static PyObject *
+GMPy_RNSInt_Int_Slot(RNSInt_Object *self)
+{
+    PyObject *temp, *result;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(temp = _GMPy_RNSInt_To_MPZ(self, 0, context)))
+        return NULL;
+    result = GMPy_PyLong_From_MPZ((MPZ_Object*)temp, context);
+    Py_DECREF(temp);
+    return result;
+}
+
+static PyObject *
+GMPy_RNSInt_MPZ_Method(RNSInt_Object *self, PyObject *other)
+{
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    return _GMPy_RNSInt_To_MPZ(self, 0, context);
+}
+
+static PyObject *
+GMPy_RNSInt_GetResidues(RNSInt_Object *self, void *closure)
+{
+    PyObject *result, *temp;
+    mp_limb_t t;
+    Py_ssize_t i;
+
+    if (!(result = PyList_New(self->basis->n)))
+        return NULL;
+    for (i = 0; i < self->basis->n; i++) {
+        if (!(temp = (PyObject*)GMPy_MPZ_New(NULL))) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        t = RNS_FROM(&self->basis->mod[i], self->r[i]);
+        mpz_limbs_write(MPZ(temp), 1)[0] = t;
+        mpz_limbs_finish(MPZ(temp), t != 0);
+        PyList_SET_ITEM(result, i, temp);
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_RNSInt_GetBasis(RNSInt_Object *self, void *closure)
+{
+    Py_INCREF((PyObject*)self->basis);
+    return (PyObject*)self->basis;
+}
+
+static PyObject *
+GMPy_RNSInt_Repr_Slot(RNSInt_Object *self)
+{
+    PyObject *temp, *result;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(temp = _GMPy_RNSInt_To_MPZ(self, 0, context)))
+        return NULL;
+    result = PyUnicode_FromFormat("rns(%S)", temp);
+    Py_DECREF(temp);
+    return result;
+}
+
+static void
+GMPy_RNS_Dealloc(RNS_Object *self)
+{
+    Py_XDECREF((PyObject*)self->plan);
+    PyMem_Free(self->mod);
+    PyObject_Free(self);
+}
+
+static PyObject *
+GMPy_RNS_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    RNS_Object *result;
+    CTXT_Object *context = NULL;
+    mpz_ptr m;
+    Py_ssize_t i;
+
+    if (keywds && PyDict_Size(keywds)) {
+        TYPE_ERROR("RNS() takes no keyword arguments");
+        return NULL;
+    }
+
+    if (PyTuple_GET_SIZE(args) != 1) {
+        TYPE_ERROR("RNS() requires 1 argument");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!(result = PyObject_New(RNS_Object, &RNS_Type)))
+        return NULL;
+    result->mod = NULL;
+    result->n = 0;
+    if (!(result->plan = _GMPy_CRTPlan_New(PyTuple_GET_ITEM(args, 0), "RNS", context))) {
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+
+    result->n = result->plan->n;
+    if (!(result->mod = PyMem_New(gmpy_rns_mod, result->n))) {
+        Py_DECREF((PyObject*)result);
+        return PyErr_NoMemory();
+    }
+    for (i = 0; i < result->n; i++) {
+        m = TREE_NODE(&result->plan->tree, 0, i);
+        if (mpz_even_p(m) || mpz_cmp_ui(m, 1) == 0 ||
+            mpz_sizeinbase(m, 2) > GMPY_RNS_MAX_BITS) {
+            PyErr_Format(PyExc_ValueError,
+                         "RNS() moduli must be odd, > 1 and < 2**%d",
+                         GMPY_RNS_MAX_BITS);
+            Py_DECREF((PyObject*)result);
+            return NULL;
+        }
+#ifdef GMPY_MONT_INT128
+        _GMPy_U64_Mont_Init(&result->mod[i], mpz_getlimbn(m, 0));
+#else
+        result->mod[i].n = mpz_getlimbn(m, 0);
+#endif
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_RNS_Call_Slot(RNS_Object *self, PyObject *args, PyObject *keywds)
+{
+    CTXT_Object *context = NULL;
+
+    if (keywds && PyDict_Size(keywds)) {
+        TYPE_ERROR("RNS() takes no keyword arguments");
+        return NULL;
+    }
+
+    if (PyTuple_GET_SIZE(args) != 1) {
+        TYPE_ERROR("RNS() requires 1 argument");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    return (PyObject*)_GMPy_RNSInt_From_Object(self, PyTuple_GET_ITEM(args, 0), context);
+}
+
+PyDoc_STRVAR(GMPy_doc_rns_from_residues,
+"R.from_residues(residues, /) -> rns\n\n"
+"Return the rns with the given residues, one for each of the moduli.");
+
+static PyObject *
+GMPy_RNS_From_Residues(RNS_Object *self, PyObject *other)
+{
+    RNSInt_Object *result = NULL;
+    MPZ_Object *temp;
+    PyObject *seq;
+    CTXT_Object *context = NULL;
+    Py_ssize_t i;
+    mpz_t r;
+
+    CHECK_CONTEXT(context);
+
+    if (!(seq = PySequence_Fast(other, "from_residues() requires a sequence")))
+        return NULL;
+    /* The residues are reduced into r since temp may be the caller's mpz
+     * or a shared one.
+     */
+    mpz_init(r);
+
+    if (PySequence_Fast_GET_SIZE(seq) != self->n) {
+        PyErr_Format(PyExc_ValueError,
+                     "from_residues() requires %zd residues", self->n);
+        goto done;
+    }
+
+    if (!(result = _GMPy_RNSInt_New(self)))
+        goto done;
+    for (i = 0; i < self->n; i++) {
+        if (!(temp = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(seq, i), context))) {
+            TYPE_ERROR("from_residues() requires integer residues");
+            Py_CLEAR(result);
+            goto done;
+        }
+        mpz_mod(r, temp->z, TREE_NODE(&self->plan->tree, 0, i));
+        result->r[i] = RNS_TO(&self->mod[i], mpz_getlimbn(r, 0));
+        Py_DECREF((PyObject*)temp);
+    }
+
+  done:
+    mpz_clear(r);
+    Py_DECREF(seq);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_RNS_GetModuli(RNS_Object *self, void *closure)
+{
+    return GMPy_CRTPlan_GetModuli(self->plan, NULL);
+}
+
+static PyObject *
+GMPy_RNS_GetModulus(RNS_Object *self, void *closure)
+{
+    return GMPy_CRTPlan_GetModulus(self->plan, NULL);
+}
+
+static PyObject *
+GMPy_RNS_Repr_Slot(RNS_Object *self)
+{
+    PyObject *moduli, *result;
+
+    if (!(moduli = GMPy_RNS_GetModuli(self, NULL)))
+        return NULL;
+    result = PyUnicode_FromFormat("RNS(%R)", moduli);
+    Py_DECREF(moduli);
+    return result;
+}
+
+static PyMethodDef GMPy_RNS_methods[] =
+{
+    { "from_residues", (PyCFunction)GMPy_RNS_From_Residues, METH_O, GMPy_doc_rns_from_residues },
+    { NULL }
+};
+
+static PyGetSetDef GMPy_RNS_getseters[] =
+{
+    { "moduli", (getter)GMPy_RNS_GetModuli, NULL, "moduli", NULL },
+    { "modulus", (getter)GMPy_RNS_GetModulus, NULL, "product of the moduli", NULL },
+    { NULL }
+};
+
+static PyTypeObject RNS_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.RNS",
+    .tp_basicsize = sizeof(RNS_Object),
+    .tp_dealloc = (destructor) GMPy_RNS_Dealloc,
+    .tp_repr = (reprfunc) GMPy_RNS_Repr_Slot,
+    .tp_call = (ternaryfunc) GMPy_RNS_Call_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_rns,
+    .tp_methods = GMPy_RNS_methods,
+    .tp_getset = GMPy_RNS_getseters,
+    .tp_new = GMPy_RNS_NewInit,
+};
+
+static PyNumberMethods GMPy_RNSInt_number_methods =
+{
+    .nb_add = (binaryfunc) GMPy_RNSInt_Add_Slot,
+    .nb_subtract = (binaryfunc) GMPy_RNSInt_Sub_Slot,
+    .nb_multiply = (binaryfunc) GMPy_RNSInt_Mul_Slot,
+    .nb_power = (ternaryfunc) GMPy_RNSInt_Pow_Slot,
+    .nb_negative = (unaryfunc) GMPy_RNSInt_Neg_Slot,
+    .nb_positive = (unaryfunc) GMPy_RNSInt_Pos_Slot,
+    .nb_bool = (inquiry) GMPy_RNSInt_NonZero_Slot,
+    .nb_int = (unaryfunc) GMPy_RNSInt_Int_Slot,
+};
+
+static PyMethodDef GMPy_RNSInt_methods[] =
+{
+    { "to_mpz", (PyCFunction)GMPy_RNSInt_To_MPZ, METH_VARARGS | METH_KEYWORDS, GMPy_doc_rnsint_to_mpz },
+    { "__mpz__", (PyCFunction)GMPy_RNSInt_MPZ_Method, METH_NOARGS, NULL },
+    { NULL }
+};
+
+static PyGetSetDef GMPy_RNSInt_getseters[] =
+{
+    { "residues", (getter)GMPy_RNSInt_GetResidues, NULL, "residues modulo the moduli", NULL },
+    { "basis", (getter)GMPy_RNSInt_GetBasis, NULL, "the RNS of the residues", NULL },
+    { NULL }
+};
+
+static PyTypeObject RNSInt_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.rns",
+    .tp_basicsize = offsetof(RNSInt_Object, r),
+    .tp_itemsize = sizeof(mp_limb_t),
+    .tp_dealloc = (destructor) GMPy_RNSInt_Dealloc,
+    .tp_repr = (reprfunc) GMPy_RNSInt_Repr_Slot,
+    .tp_as_number = &GMPy_RNSInt_number_methods,
+    .tp_hash = PyObject_HashNotImplemented,
+    .tp_richcompare = (richcmpfunc) GMPy_RNSInt_RichCompare_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_rnsint,
+    .tp_methods = GMPy_RNSInt_methods,
+    .tp_getset = GMPy_RNSInt_getseters,
+};
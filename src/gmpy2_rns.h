@@ -0,0 +1,71 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_rns.h                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_RNS_H
+#define GMPY_RNS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An RNS keeps n odd, pairwise coprime word-size moduli and the CRTPlan
+ * that converts back to an integer. An rns holds one residue per modulus;
+ * with GMPY_MONT_INT128 the residues are in Montgomery form, otherwise
+ * they are plain residues of moduli < 2**32.
+ */
+
+#ifdef GMPY_MONT_INT128
+typedef gmpy_u64_mont gmpy_rns_mod;
+#  define GMPY_RNS_MAX_BITS 64
+#else
+typedef struct {
+    mp_limb_t n;
+} gmpy_rns_mod;
+#  define GMPY_RNS_MAX_BITS 32
+#endif
+
+typedef struct {
+    PyObject_HEAD
+    CRTPlan_Object *plan;
+    gmpy_rns_mod *mod;
+    Py_ssize_t n;
+} RNS_Object;
+
+typedef struct {
+    PyObject_VAR_HEAD
+    RNS_Object *basis;
+    mp_limb_t r[1];
+} RNSInt_Object;
+
+static PyTypeObject RNS_Type;
+static PyTypeObject RNSInt_Type;
+#define RNS_Check(v) (((PyObject*)v)->ob_type == &RNS_Type)
+#define RNSInt_Check(v) (((PyObject*)v)->ob_type == &RNSInt_Type)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
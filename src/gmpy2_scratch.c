@@ -0,0 +1,136 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_scratch.c                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* See gmpy2_scratch.h. The pool lives in thread-local storage so the cores
+ * can run in any thread, including the native threads started by
+ * GMPy_Parallel_Run(), without locking.
+ */
+
+static GMPY_THREAD_LOCAL gmpy_scratch gmpy_thread_scratch;
+
+static int
+_GMPy_Scratch_Mark(void)
+{
+    return gmpy_thread_scratch.used;
+}
+
+static mpz_ptr
+_GMPy_Scratch_Get(size_t bits)
+{
+    gmpy_scratch *pool = &gmpy_thread_scratch;
+    mpz_ptr z;
+
+    if (pool->used == GMPY_SCRATCH_SIZE) {
+        /* LCOV_EXCL_START */
+        Py_FatalError("gmpy2: scratch pool exhausted");
+        /* LCOV_EXCL_STOP */
+    }
+    if (pool->used == pool->ninit) {
+        mpz_init(pool->z[pool->ninit++]);
+    }
+    z = pool->z[pool->used++];
+    if ((size_t)z->_mp_alloc * GMP_NUMB_BITS < bits) {
+        mpz_realloc2(z, bits);
+    }
+    return z;
+}
+
+static void
+_GMPy_Scratch_Release(int mark)
+{
+    gmpy_scratch *pool = &gmpy_thread_scratch;
+
+    while (pool->used > mark) {
+        mpz_ptr z = pool->z[--pool->used];
+
+        if (z->_mp_alloc > GMPY_SCRATCH_KEEP_LIMBS) {
+            mpz_clear(z);
+            mpz_init(z);
+        }
+    }
+}
+
+static void
+GMPy_Scratch_Free(void)
+{
+    gmpy_scratch *pool = &gmpy_thread_scratch;
+
+    while (pool->ninit > pool->used) {
+        mpz_clear(pool->z[--pool->ninit]);
+    }
+}
+
+/* Called when the capsule stored in the thread state dictionary is
+ * destroyed. The pool can only be freed by the thread that owns it; a
+ * thread state cleared by another thread (at shutdown) keeps its pool.
+ */
+
+static void
+_GMPy_Scratch_Destructor(PyObject *capsule)
+{
+    if (PyCapsule_GetPointer(capsule, "gmpy2.scratch") == &gmpy_thread_scratch)
+        GMPy_Scratch_Free();
+}
+
+static void
+GMPy_Scratch_Attach(void)
+{
+    PyObject *dict, *capsule;
+
+    if (gmpy_thread_scratch.attached)
+        return;
+    gmpy_thread_scratch.attached = 1;
+
+    if (!(dict = PyThreadState_GetDict()))
+        return;
+    if (!(capsule = PyCapsule_New(&gmpy_thread_scratch, "gmpy2.scratch",
+                                  _GMPy_Scratch_Destructor))) {
+        /* LCOV_EXCL_START */
+        PyErr_Clear();
+        return;
+        /* LCOV_EXCL_STOP */
+    }
+    if (PyDict_SetItemString(dict, "gmpy2.scratch", capsule) < 0)
+        PyErr_Clear();
+    Py_DECREF(capsule);
+}
+
+/* Free the unused slots of the running thread whose memory keep() rejects.
+ * Used when an arena is exited so the pool doesn't keep its chunks alive.
+ */
+
+static void
+_GMPy_Scratch_Drop(int (*keep)(void *, void *), void *arg)
+{
+    gmpy_scratch *pool = &gmpy_thread_scratch;
+
+    for (int i = pool->used; i < pool->ninit; i++) {
+        if (pool->z[i]->_mp_alloc && !keep(pool->z[i]->_mp_d, arg)) {
+            mpz_clear(pool->z[i]);
+            mpz_init(pool->z[i]);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_scratch.h                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY2_SCRATCH_H
+#define GMPY2_SCRATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Per-thread scratch integers for the context-free cores.
+ *
+ * The pool is used as a stack: _GMPy_Scratch_Mark() records the current
+ * depth, _GMPy_Scratch_Get() returns the next slot with room for at least
+ * the requested number of bits, and _GMPy_Scratch_Release() returns every
+ * slot taken since the mark. The value of a new slot is undefined. None of
+ * these use the Python API so they may be called without the GIL.
+ *
+ * GMPY_SCRATCH_SIZE limits the depth; the cores that use the pool take
+ * far fewer slots. A released slot keeps its memory unless it grew beyond
+ * GMPY_SCRATCH_KEEP_LIMBS.
+ */
+
+#define GMPY_SCRATCH_SIZE 32
+#define GMPY_SCRATCH_KEEP_LIMBS 256
+
+/* Room for the product of two residues modulo n. */
+
+#define GMPY_SCRATCH_MOD_BITS(n) (2 * mpz_sizeinbase(n, 2) + 2 * GMP_NUMB_BITS)
+
+typedef struct {
+    int used;                   /* slots that have been handed out */
+    int ninit;                  /* slots that have been initialized */
+    int attached;               /* GMPy_Scratch_Attach() has been called */
+    mpz_t z[GMPY_SCRATCH_SIZE];
+} gmpy_scratch;
+
+static int     _GMPy_Scratch_Mark(void);
+static mpz_ptr _GMPy_Scratch_Get(size_t bits);
+static void    _GMPy_Scratch_Release(int mark);
+
+/* GMPy_Scratch_Attach() must be called with the GIL held; it frees the
+ * pool of the running thread when its thread state is cleared. Native
+ * threads that have no thread state call GMPy_Scratch_Free() before they
+ * exit.
+ */
+
+static void    GMPy_Scratch_Attach(void);
+static void    GMPy_Scratch_Free(void);
+static void    _GMPy_Scratch_Drop(int (*keep)(void *, void *), void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,521 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_sec.c                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Side channel resistant arithmetic modulo a fixed odd m.
+ *
+ * Every operand is copied into a buffer of exactly n limbs and the mpn_sec_*
+ * and mpn_cnd_* functions of GMP are used, so the sequence of operations
+ * and memory accesses depends on the sizes of m and of the largest exponent
+ * but not on the values. The buffers and the scratch space are allocated
+ * when the object is created. A call that finds them in use by another
+ * thread allocates its own copy.
+ *
+ * Arguments must already be reduced; reducing them here would depend on
+ * their values.
+ */
+
+#ifdef Py_GIL_DISABLED
+#  define SEC_LOCK(obj)   PyMutex_Lock(&(obj)->lock)
+#  define SEC_UNLOCK(obj) PyMutex_Unlock(&(obj)->lock)
+#else
+#  define SEC_LOCK(obj)
+#  define SEC_UNLOCK(obj)
+#endif
+
+enum {
+    SEC_ADD,
+    SEC_SUB,
+    SEC_MUL,
+    SEC_SQR,
+    SEC_POW,
+    SEC_INV,
+    SEC_SWAP
+};
+
+PyDoc_STRVAR(GMPy_doc_sec_modulus,
+"Modulus(m, /, ebits=None) -> Modulus\n\n"
+"Return an object that performs side channel resistant arithmetic modulo\n"
+"an odd m > 1. The time taken and the memory accessed depend only on the\n"
+"size of m and, for pow(), on ebits, which defaults to the bit length of\n"
+"m. Arguments must be integers in the range 0 <= x < m and results are\n"
+"mpz in the same range. The scratch space is allocated once.");
+
+/* Buffer layout: a and b of n limbs, r of 2*n limbs, e of en limbs, and
+ * the scratch space.
+ */
+
+static mp_size_t
+_GMPy_Sec_Size(SecModulus_Object *self)
+{
+    return 4 * self->n + self->en + self->itch;
+}
+
+static mp_ptr
+_GMPy_Sec_Claim(SecModulus_Object *self)
+{
+    mp_ptr buf = NULL;
+
+    SEC_LOCK(self);
+    if (!self->busy) {
+        self->busy = 1;
+        buf = self->buf;
+    }
+    SEC_UNLOCK(self);
+    if (!buf)
+        buf = PyMem_RawMalloc(_GMPy_Sec_Size(self) * sizeof(mp_limb_t));
+    return buf;
+}
+
+/* The buffer is cleared so no operand or intermediate value is left in
+ * memory after the call.
+ */
+
+static void
+_GMPy_Sec_Release(SecModulus_Object *self, mp_ptr buf)
+{
+    mpn_zero(buf, _GMPy_Sec_Size(self));
+    if (buf == self->buf) {
+        SEC_LOCK(self);
+        self->busy = 0;
+        SEC_UNLOCK(self);
+    }
+    else {
+        PyMem_RawFree(buf);
+    }
+}
+
+static void
+_GMPy_Sec_Load(mp_ptr dst, mpz_srcptr x, mp_size_t n)
+{
+    mp_size_t size = mpz_size(x);
+
+    if (size)
+        mpn_copyi(dst, mpz_limbs_read(x), size);
+    if (n > size)
+        mpn_zero(dst + size, n - size);
+}
+
+static void
+_GMPy_Sec_Store(mpz_ptr z, mp_srcptr src, mp_size_t n)
+{
+    mpn_copyi(mpz_limbs_write(z, n), src, n);
+    mpz_limbs_finish(z, n);
+}
+
+/* Set r to op(a, b) mod m, or swap a and b if cnd is not 0. Returns 0 if
+ * the inverse of a does not exist. Does not use the Python API.
+ */
+
+static int
+_GMPy_Sec_Op(SecModulus_Object *self, int op, mp_ptr buf, mp_limb_t cnd)
+{
+    mp_size_t n = self->n;
+    mp_srcptr m = mpz_limbs_read(self->m);
+    mp_ptr a = buf, b = buf + n, r = buf + 2 * n, e = buf + 4 * n;
+    mp_ptr t = e + self->en;
+    mp_limb_t cy;
+
+    switch (op) {
+    case SEC_ADD:
+        /* Subtract m if the sum carried out or is >= m. */
+        cy = mpn_add_n(r, a, b, n);
+        cy |= 1 ^ mpn_sub_n(t, r, m, n);
+        mpn_cnd_swap(cy, r, t, n);
+        break;
+    case SEC_SUB:
+        cy = mpn_sub_n(r, a, b, n);
+        mpn_cnd_add_n(cy, r, r, m, n);
+        break;
+    case SEC_MUL:
+        mpn_sec_mul(r, a, n, b, n, t);
+        mpn_sec_div_r(r, 2 * n, m, n, t);
+        break;
+    case SEC_SQR:
+        mpn_sec_sqr(r, a, n, t);
+        mpn_sec_div_r(r, 2 * n, m, n, t);
+        break;
+    case SEC_POW:
+        mpn_sec_powm(r, a, n, e, self->ebits, m, n, t);
+        break;
+    case SEC_INV:
+        /* a is destroyed. */
+        return mpn_sec_invert(r, a, m, n, 2 * self->mbits, t);
+    case SEC_SWAP:
+        mpn_cnd_swap(cnd, a, b, n);
+        break;
+    }
+    return 1;
+}
+
+static PyObject *
+GMPy_Sec_Modulus_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "ebits", NULL};
+    SecModulus_Object *result;
+    MPZ_Object *tempm;
+    PyObject *m, *ebits = Py_None;
+    Py_ssize_t nebits = 0;
+    mp_size_t n, itch;
+    CTXT_Object *context = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|O", kwlist, &m, &ebits))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_INTEGER(m)) {
+        TYPE_ERROR("Modulus() requires an integer argument");
+        return NULL;
+    }
+    if (ebits != Py_None) {
+        if ((nebits = PyLong_AsSsize_t(ebits)) == -1 && PyErr_Occurred())
+            return NULL;
+        if (nebits < 1) {
+            VALUE_ERROR("Modulus() 'ebits' must be > 0");
+            return NULL;
+        }
+    }
+
+    if (!(tempm = GMPy_MPZ_From_Integer(m, context)))
+        return NULL;
+
+    if (mpz_cmp_ui(tempm->z, 1) <= 0 || mpz_even_p(tempm->z)) {
+        VALUE_ERROR("Modulus() 'mod' must be odd and > 1");
+        Py_DECREF((PyObject*)tempm);
+        return NULL;
+    }
+
+    if (!(result = PyObject_New(SecModulus_Object, &SecModulus_Type))) {
+        Py_DECREF((PyObject*)tempm);
+        return NULL;
+    }
+    mpz_init_set(result->m, tempm->z);
+    Py_DECREF((PyObject*)tempm);
+
+    result->n = n = mpz_size(result->m);
+    result->mbits = mpz_sizeinbase(result->m, 2);
+    result->ebits = ebits == Py_None ? result->mbits : (mp_bitcnt_t)nebits;
+    result->en = (result->ebits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    result->busy = 0;
+#ifdef Py_GIL_DISABLED
+    result->lock = (PyMutex){0};
+#endif
+
+    /* The scratch space must also hold m for the subtraction in add(). */
+
+    itch = n;
+    itch = Py_MAX(itch, mpn_sec_mul_itch(n, n));
+    itch = Py_MAX(itch, mpn_sec_sqr_itch(n));
+    itch = Py_MAX(itch, mpn_sec_div_r_itch(2 * n, n));
+    itch = Py_MAX(itch, mpn_sec_powm_itch(n, result->ebits, n));
+    itch = Py_MAX(itch, mpn_sec_invert_itch(n));
+    result->itch = itch;
+
+    if (!(result->buf = PyMem_RawCalloc(_GMPy_Sec_Size(result), sizeof(mp_limb_t)))) {
+        mpz_clear(result->m);
+        PyObject_Free(result);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)result;
+}
+
+static void
+GMPy_Sec_Modulus_Dealloc(SecModulus_Object *self)
+{
+    PyMem_RawFree(self->buf);
+    mpz_clear(self->m);
+    PyObject_Free(self);
+}
+
+static PyObject *
+GMPy_Sec_Modulus_GetModulus(SecModulus_Object *self, void *closure)
+{
+    MPZ_Object *result;
+
+    if ((result = GMPy_MPZ_New(NULL)))
+        mpz_set(result->z, self->m);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_Sec_Modulus_GetEbits(SecModulus_Object *self, void *closure)
+{
+    return PyLong_FromSize_t(self->ebits);
+}
+
+static PyObject *
+GMPy_Sec_Modulus_Repr_Slot(SecModulus_Object *self)
+{
+    PyObject *m, *result;
+
+    if (!(m = GMPy_Sec_Modulus_GetModulus(self, NULL)))
+        return NULL;
+    result = PyUnicode_FromFormat("gmpy2.sec.Modulus(%S, ebits=%zu)", m,
+                                  (size_t)self->ebits);
+    Py_DECREF(m);
+    return result;
+}
+
+/* Return a new reference to obj as an mpz in the range 0 <= x < m. */
+
+static MPZ_Object *
+_GMPy_Sec_Arg(SecModulus_Object *self, PyObject *obj, const char *name,
+              CTXT_Object *context)
+{
+    MPZ_Object *result;
+
+    if (!IS_INTEGER(obj)) {
+        PyErr_Format(PyExc_TypeError, "Modulus.%s() requires integer arguments", name);
+        return NULL;
+    }
+    if (!(result = GMPy_MPZ_From_Integer(obj, context)))
+        return NULL;
+    if (mpz_sgn(result->z) < 0 || mpz_cmp(result->z, self->m) >= 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "Modulus.%s() arguments must be in the range 0 <= x < m", name);
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    return result;
+}
+
+static int
+_GMPy_Sec_Profile_Op(int op)
+{
+    switch (op) {
+    case SEC_SUB:
+        return GMPY_OP_SUB;
+    case SEC_MUL:
+    case SEC_SQR:
+        return GMPY_OP_MUL;
+    case SEC_POW:
+        return GMPY_OP_POWMOD;
+    case SEC_INV:
+        return GMPY_OP_INVERT;
+    default:
+        return GMPY_OP_ADD;
+    }
+}
+
+/* b is NULL for unary operations. For SEC_POW, b is the exponent. */
+
+static PyObject *
+_GMPy_Sec_Call(SecModulus_Object *self, int op, PyObject *a, PyObject *b,
+               mp_limb_t cnd, const char *name)
+{
+    MPZ_Object *tempa = NULL, *tempb = NULL, *result = NULL, *other = NULL;
+    PyObject *ret = NULL;
+    CTXT_Object *context = NULL;
+    mp_size_t n = self->n;
+    mp_ptr buf = NULL;
+    int res;
+
+    CHECK_CONTEXT(context);
+
+    if (!(tempa = _GMPy_Sec_Arg(self, a, name, context)))
+        return NULL;
+
+    if (op == SEC_POW) {
+        if (!IS_INTEGER(b)) {
+            PyErr_Format(PyExc_TypeError, "Modulus.%s() requires integer arguments", name);
+            goto done;
+        }
+        if (!(tempb = GMPy_MPZ_From_Integer(b, context)))
+            goto done;
+        if (mpz_sgn(tempb->z) < 1) {
+            PyErr_Format(PyExc_ValueError, "Modulus.%s() exponent must be > 0", name);
+            goto done;
+        }
+        if (mpz_sizeinbase(tempb->z, 2) > self->ebits) {
+            PyErr_Format(PyExc_ValueError,
+                         "Modulus.%s() exponent must have at most %zu bits",
+                         name, (size_t)self->ebits);
+            goto done;
+        }
+    }
+    else if (b && !(tempb = _GMPy_Sec_Arg(self, b, name, context))) {
+        goto done;
+    }
+
+    if (!(result = GMPy_MPZ_New(context)) ||
+        (op == SEC_SWAP && !(other = GMPy_MPZ_New(context))))
+        goto done;
+
+    if (!(buf = _GMPy_Sec_Claim(self))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    _GMPy_Sec_Load(buf, tempa->z, n);
+    if (op == SEC_POW)
+        _GMPy_Sec_Load(buf + 4 * n, tempb->z, self->en);
+    else if (tempb)
+        _GMPy_Sec_Load(buf + n, tempb->z, n);
+
+    GMPY_PROFILE_OP(context, _GMPy_Sec_Profile_Op(op), self->mbits);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, self->mbits *
+                                 (op == SEC_POW ? self->ebits : 1));
+    res = _GMPy_Sec_Op(self, op, buf, cnd);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (op == SEC_SWAP) {
+        _GMPy_Sec_Store(result->z, buf, n);
+        _GMPy_Sec_Store(other->z, buf + n, n);
+    }
+    else {
+        _GMPy_Sec_Store(result->z, buf + 2 * n, n);
+    }
+    _GMPy_Sec_Release(self, buf);
+
+    if (!res) {
+        PyErr_Format(PyExc_ValueError, "Modulus.%s() base not invertible", name);
+        goto done;
+    }
+
+    if (op == SEC_SWAP) {
+        ret = PyTuple_Pack(2, (PyObject*)result, (PyObject*)other);
+    }
+    else {
+        ret = (PyObject*)result;
+        result = NULL;
+    }
+
+  done:
+    Py_DECREF((PyObject*)tempa);
+    Py_XDECREF((PyObject*)tempb);
+    Py_XDECREF((PyObject*)result);
+    Py_XDECREF((PyObject*)other);
+    return ret;
+}
+
+static int
+_GMPy_Sec_Args(Py_ssize_t nargs, Py_ssize_t expected, const char *name)
+{
+    if (nargs != expected) {
+        PyErr_Format(PyExc_TypeError, "Modulus.%s() requires %zd arguments",
+                     name, expected);
+        return -1;
+    }
+    return 0;
+}
+
+#define GMPY_SEC_BINARY(NAME, OP, FUNC) \
+static PyObject * \
+GMPy_Sec_Modulus_##NAME(SecModulus_Object *self, PyObject * const *args, Py_ssize_t nargs) \
+{ \
+    if (_GMPy_Sec_Args(nargs, 2, #FUNC) < 0) \
+        return NULL; \
+    return _GMPy_Sec_Call(self, OP, args[0], args[1], 0, #FUNC); \
+}
+
+#define GMPY_SEC_UNARY(NAME, OP, FUNC) \
+static PyObject * \
+GMPy_Sec_Modulus_##NAME(SecModulus_Object *self, PyObject *other) \
+{ \
+    return _GMPy_Sec_Call(self, OP, other, NULL, 0, #FUNC); \
+}
+
+GMPY_SEC_BINARY(Add, SEC_ADD, add)
+GMPY_SEC_BINARY(Sub, SEC_SUB, sub)
+GMPY_SEC_BINARY(Mul, SEC_MUL, mul)
+GMPY_SEC_BINARY(Pow, SEC_POW, pow)
+GMPY_SEC_UNARY(Sqr, SEC_SQR, sqr)
+GMPY_SEC_UNARY(Inv, SEC_INV, inv)
+
+static PyObject *
+GMPy_Sec_Modulus_Cnd_Swap(SecModulus_Object *self, PyObject * const *args, Py_ssize_t nargs)
+{
+    int cnd;
+
+    if (_GMPy_Sec_Args(nargs, 3, "cnd_swap") < 0)
+        return NULL;
+    if ((cnd = PyObject_IsTrue(args[0])) < 0)
+        return NULL;
+    return _GMPy_Sec_Call(self, SEC_SWAP, args[1], args[2], (mp_limb_t)cnd, "cnd_swap");
+}
+
+PyDoc_STRVAR(GMPy_doc_sec_modulus_add,
+"x.add(a, b, /) -> mpz\n\n"
+"Return (a + b) mod m.");
+
+PyDoc_STRVAR(GMPy_doc_sec_modulus_sub,
+"x.sub(a, b, /) -> mpz\n\n"
+"Return (a - b) mod m.");
+
+PyDoc_STRVAR(GMPy_doc_sec_modulus_mul,
+"x.mul(a, b, /) -> mpz\n\n"
+"Return (a * b) mod m.");
+
+PyDoc_STRVAR(GMPy_doc_sec_modulus_sqr,
+"x.sqr(a, /) -> mpz\n\n"
+"Return (a * a) mod m.");
+
+PyDoc_STRVAR(GMPy_doc_sec_modulus_pow,
+"x.pow(a, e, /) -> mpz\n\n"
+"Return powmod(a, e, m). e must be > 0 and have at most ebits bits; the\n"
+"time taken does not depend on its value.");
+
+PyDoc_STRVAR(GMPy_doc_sec_modulus_inv,
+"x.inv(a, /) -> mpz\n\n"
+"Return the inverse of a mod m. Raises ValueError if it does not exist.");
+
+PyDoc_STRVAR(GMPy_doc_sec_modulus_cnd_swap,
+"x.cnd_swap(c, a, b, /) -> tuple[mpz, mpz]\n\n"
+"Return (b, a) if c is true and (a, b) otherwise. The limbs of a and b\n"
+"are exchanged with masks, without a branch on c.");
+
+static PyMethodDef GMPy_Sec_Modulus_methods[] =
+{
+    { "add", (PyCFunction)(void(*)(void))GMPy_Sec_Modulus_Add, METH_FASTCALL, GMPy_doc_sec_modulus_add },
+    { "cnd_swap", (PyCFunction)(void(*)(void))GMPy_Sec_Modulus_Cnd_Swap, METH_FASTCALL, GMPy_doc_sec_modulus_cnd_swap },
+    { "inv", (PyCFunction)GMPy_Sec_Modulus_Inv, METH_O, GMPy_doc_sec_modulus_inv },
+    { "mul", (PyCFunction)(void(*)(void))GMPy_Sec_Modulus_Mul, METH_FASTCALL, GMPy_doc_sec_modulus_mul },
+    { "pow", (PyCFunction)(void(*)(void))GMPy_Sec_Modulus_Pow, METH_FASTCALL, GMPy_doc_sec_modulus_pow },
+    { "sqr", (PyCFunction)GMPy_Sec_Modulus_Sqr, METH_O, GMPy_doc_sec_modulus_sqr },
+    { "sub", (PyCFunction)(void(*)(void))GMPy_Sec_Modulus_Sub, METH_FASTCALL, GMPy_doc_sec_modulus_sub },
+    { NULL }
+};
+
+static PyGetSetDef GMPy_Sec_Modulus_getseters[] =
+{
+    { "ebits", (getter)GMPy_Sec_Modulus_GetEbits, NULL, "largest exponent size", NULL },
+    { "modulus", (getter)GMPy_Sec_Modulus_GetModulus, NULL, "modulus", NULL },
+    { NULL }
+};
+
+static PyTypeObject SecModulus_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.sec.Modulus",
+    .tp_basicsize = sizeof(SecModulus_Object),
+    .tp_dealloc = (destructor) GMPy_Sec_Modulus_Dealloc,
+    .tp_repr = (reprfunc) GMPy_Sec_Modulus_Repr_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_sec_modulus,
+    .tp_methods = GMPy_Sec_Modulus_methods,
+    .tp_getset = GMPy_Sec_Modulus_getseters,
+    .tp_new = GMPy_Sec_Modulus_NewInit,
+};
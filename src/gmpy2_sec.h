@@ -0,0 +1,61 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_sec.h                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_SEC_H
+#define GMPY_SEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A SecModulus performs side channel resistant arithmetic modulo a fixed
+ * odd m with the mpn_sec_* functions of GMP. Operands are copied into
+ * buffers of exactly n limbs, and the scratch space for every operation is
+ * allocated once, sized for exponents of up to ebits bits.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    mp_size_t n;                /* limbs in m */
+    mp_size_t en;               /* limbs in an exponent */
+    mp_bitcnt_t ebits;          /* largest exponent size */
+    mp_bitcnt_t mbits;          /* bits in m */
+    mp_size_t itch;             /* limbs of scratch space */
+    mpz_t m;
+    mp_ptr buf;                 /* a, b, r, e and the scratch space */
+    int busy;                   /* buf is used by a call */
+#ifdef Py_GIL_DISABLED
+    PyMutex lock;               /* protects busy */
+#endif
+} SecModulus_Object;
+
+static PyTypeObject SecModulus_Type;
+#define SecModulus_Check(v) (((PyObject*)v)->ob_type == &SecModulus_Type)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
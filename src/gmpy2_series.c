@@ -0,0 +1,346 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_series.c                                                          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/* Binary splitting.
+ *
+ * The terms l <= k < r are split at m = (l + r) / 2 and the two halves
+ * are combined as P = P1*P2, Q = Q1*Q2, and T = T1*Q2 + P1*T2, so the
+ * multiplications are balanced and the cost is a few multiplications of
+ * the size of the result per level. With threads, the terms are cut into
+ * one range per thread, the ranges are evaluated in parallel, and the
+ * results are combined pairwise.
+ */
+
+/* Ranges with fewer terms than this are not polled for interrupts. */
+
+#define GMPY_SERIES_POLL_TERMS 64
+
+static void
+_GMPy_Poly_Clear(gmpy_poly *f)
+{
+    int i;
+
+    if (f->c) {
+        for (i = 0; i < f->n; i++)
+            mpz_clear(f->c[i]);
+        PyMem_Free(f->c);
+        f->c = NULL;
+    }
+}
+
+/* Set f from an integer or a sequence of integer coefficients, constant
+ * term first.
+ */
+
+static int
+_GMPy_Poly_Init(gmpy_poly *f, PyObject *obj, const char *name,
+                CTXT_Object *context)
+{
+    PyObject *seq;
+    MPZ_Object *temp;
+    Py_ssize_t i, n;
+
+    f->c = NULL;
+    f->n = 0;
+
+    if (IS_INTEGER(obj)) {
+        if (!(temp = GMPy_MPZ_From_Integer(obj, context)))
+            return -1;
+        if (!(f->c = PyMem_New(mpz_t, 1))) {
+            Py_DECREF((PyObject*)temp);
+            PyErr_NoMemory();
+            return -1;
+        }
+        mpz_init_set(f->c[0], temp->z);
+        f->n = 1;
+        Py_DECREF((PyObject*)temp);
+        return 0;
+    }
+
+    if (!(seq = PySequence_Fast(obj, "")))
+        goto type_error;
+    n = PySequence_Fast_GET_SIZE(seq);
+    if (n < 1 || n > INT_MAX) {
+        Py_DECREF(seq);
+        PyErr_Format(PyExc_ValueError, "%s() requires at least one coefficient", name);
+        return -1;
+    }
+    if (!(f->c = PyMem_New(mpz_t, n))) {
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        if (!IS_INTEGER(PySequence_Fast_GET_ITEM(seq, i)) ||
+            !(temp = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(seq, i), context))) {
+            Py_DECREF(seq);
+            _GMPy_Poly_Clear(f);
+            goto type_error;
+        }
+        mpz_init_set(f->c[i], temp->z);
+        f->n++;
+        Py_DECREF((PyObject*)temp);
+    }
+    Py_DECREF(seq);
+    return 0;
+
+  type_error:
+    PyErr_Clear();
+    PyErr_Format(PyExc_TypeError,
+                 "%s() requires an integer or a sequence of integer coefficients", name);
+    return -1;
+}
+
+/* Set r to f(k). */
+
+static void
+_GMPy_Poly_Eval(mpz_ptr r, const gmpy_poly *f, unsigned long k)
+{
+    int i;
+
+    mpz_set(r, f->c[f->n - 1]);
+    for (i = f->n - 2; i >= 0; i--) {
+        mpz_mul_ui(r, r, k);
+        mpz_add(r, r, f->c[i]);
+    }
+}
+
+static void
+_GMPy_Series_Node_Init(gmpy_series_node *x)
+{
+    mpz_init(x->P);
+    mpz_init(x->Q);
+    mpz_init(x->T);
+}
+
+static void
+_GMPy_Series_Node_Clear(gmpy_series_node *x)
+{
+    mpz_clear(x->P);
+    mpz_clear(x->Q);
+    mpz_clear(x->T);
+}
+
+/* Set x to the combination of x and the following range y. */
+
+static void
+_GMPy_Series_Merge(gmpy_series_node *x, gmpy_series_node *y)
+{
+    mpz_mul(x->T, x->T, y->Q);
+    mpz_addmul(x->T, x->P, y->T);
+    mpz_mul(x->P, x->P, y->P);
+    mpz_mul(x->Q, x->Q, y->Q);
+}
+
+/* Set x to the values of the terms l <= k < r, r > l. Does not use the
+ * Python API.
+ */
+
+static void
+_GMPy_Series_Split(gmpy_series *s, unsigned long l, unsigned long r,
+                   gmpy_series_node *x)
+{
+    gmpy_series_node y;
+    unsigned long m;
+
+    if (r - l == 1) {
+        _GMPy_Poly_Eval(x->P, &s->p, r);
+        _GMPy_Poly_Eval(x->Q, &s->q, r);
+        _GMPy_Poly_Eval(x->T, &s->a, l);
+        mpz_mul(x->T, x->T, x->Q);
+        if (mpz_sgn(x->Q) == 0)
+            s->zero = 1;
+        return;
+    }
+
+    if (r - l >= GMPY_SERIES_POLL_TERMS && (s->stop || GMPy_Interrupt_Poll())) {
+        s->stop = 1;
+        return;
+    }
+
+    m = l + (r - l) / 2;
+    _GMPy_Series_Split(s, l, m, x);
+    _GMPy_Series_Node_Init(&y);
+    _GMPy_Series_Split(s, m, r, &y);
+    _GMPy_Series_Merge(x, &y);
+    _GMPy_Series_Node_Clear(&y);
+}
+
+typedef struct {
+    gmpy_series *s;
+    gmpy_series_node *nodes;
+    unsigned long n;
+    Py_ssize_t parts;
+} gmpy_series_work;
+
+static void
+_GMPy_Series_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_series_work *work = (gmpy_series_work*)arg;
+    unsigned long l, r;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        l = (unsigned long)((double)work->n * i / work->parts);
+        r = (unsigned long)((double)work->n * (i + 1) / work->parts);
+        if (i + 1 == work->parts)
+            r = work->n;
+        if (r > l)
+            _GMPy_Series_Split(work->s, l, r, &work->nodes[i]);
+        else {
+            mpz_set_ui(work->nodes[i].P, 1);
+            mpz_set_ui(work->nodes[i].Q, 1);
+            mpz_set_ui(work->nodes[i].T, 0);
+        }
+    }
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_binary_splitting,
+"binary_splitting(p, q, a, n, /, precision=None) -> tuple[mpz, mpz, mpz] | mpfr\n\n"
+"Evaluate the hypergeometric-type series\n\n"
+"    S = sum(a(k) * p(1)*...*p(k) / (q(1)*...*q(k)) for k in range(n))\n\n"
+"by binary splitting. p, q, and a are polynomials given as an integer or\n"
+"a sequence of integer coefficients, constant term first; q(k) must not\n"
+"be 0 for 1 <= k <= n. Return the integers (P, Q, T) with\n"
+"P = p(1)*...*p(n), Q = q(1)*...*q(n), and S = T/Q, or, if precision is\n"
+"given, S as an `mpfr` with that precision (0 for the context's\n"
+"precision) rounded with the context's rounding mode. The GIL is\n"
+"released and the terms are split over the context's threads.");
+
+static PyObject *
+GMPy_MPZ_Function_Binary_Splitting(PyObject *self, PyObject *args,
+                                   PyObject *keywds)
+{
+    static char *kwlist[] = {"", "", "", "", "precision", NULL};
+    PyObject *pobj, *qobj, *aobj, *prec = Py_None, *result = NULL;
+    MPZ_Object *P = NULL, *Q = NULL, *T = NULL;
+    MPFR_Object *f = NULL;
+    gmpy_series_node *nodes = NULL;
+    gmpy_series_work work;
+    gmpy_interrupt intr;
+    gmpy_series s;
+    Py_ssize_t n, i, k, step, nodes_init = 0;
+    mpfr_prec_t bits = 0;
+    mpfr_t temp;
+    int threads;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OOOn|O", kwlist, &pobj,
+                                     &qobj, &aobj, &n, &prec))
+        return NULL;
+
+    if (n < 0) {
+        VALUE_ERROR("binary_splitting() requires n >= 0");
+        return NULL;
+    }
+    if ((unsigned long long)n >= ULONG_MAX) {
+        OVERFLOW_ERROR("binary_splitting() n is too large");
+        return NULL;
+    }
+    if (prec != Py_None) {
+        bits = (mpfr_prec_t)GMPy_Integer_AsLong(prec);
+        if (bits == -1 && PyErr_Occurred())
+            return NULL;
+        if (bits != 0 && (bits < MPFR_PREC_MIN || bits > MPFR_PREC_MAX)) {
+            VALUE_ERROR("invalid value for precision");
+            return NULL;
+        }
+    }
+
+    memset(&s, 0, sizeof(gmpy_series));
+    if (_GMPy_Poly_Init(&s.p, pobj, "binary_splitting", context) < 0 ||
+        _GMPy_Poly_Init(&s.q, qobj, "binary_splitting", context) < 0 ||
+        _GMPy_Poly_Init(&s.a, aobj, "binary_splitting", context) < 0)
+        goto done;
+
+    threads = GMPY_THREADS(context);
+    work.s = &s;
+    work.n = (unsigned long)n;
+    work.parts = n < threads ? (n ? n : 1) : threads;
+    if (!(nodes = PyMem_New(gmpy_series_node, work.parts))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (nodes_init = 0; nodes_init < work.parts; nodes_init++)
+        _GMPy_Series_Node_Init(&nodes[nodes_init]);
+    work.nodes = nodes;
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)n * GMP_NUMB_BITS);
+    intr.save = &_save;
+    GMPy_Parallel_Run(_GMPy_Series_Range, &work, work.parts,
+                      GMPY_THREADS_RELEASED() ? threads : 1);
+
+    /* Combine the ranges pairwise so the products stay balanced. */
+
+    for (step = 1; step < work.parts && !s.stop; step *= 2) {
+        for (i = 0; i + step < work.parts; i += 2 * step)
+            _GMPy_Series_Merge(&nodes[i], &nodes[i + step]);
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    if (GMPy_Interrupt_End(&intr) < 0)
+        goto done;
+
+    if (s.zero) {
+        ZERO_ERROR("binary_splitting() q(k) is 0");
+        goto done;
+    }
+
+    if (prec == Py_None) {
+        if ((P = GMPy_MPZ_New(context)) && (Q = GMPy_MPZ_New(context)) &&
+            (T = GMPy_MPZ_New(context))) {
+            mpz_swap(P->z, nodes[0].P);
+            mpz_swap(Q->z, nodes[0].Q);
+            mpz_swap(T->z, nodes[0].T);
+            result = PyTuple_Pack(3, P, Q, T);
+        }
+        Py_XDECREF((PyObject*)P);
+        Py_XDECREF((PyObject*)Q);
+        Py_XDECREF((PyObject*)T);
+    }
+    else if ((f = GMPy_MPFR_New(bits, context))) {
+        k = mpz_sgn(nodes[0].T) ? (Py_ssize_t)mpz_sizeinbase(nodes[0].T, 2) : 1;
+        mpfr_init2(temp, k < MPFR_PREC_MIN ? MPFR_PREC_MIN : (mpfr_prec_t)k);
+        mpfr_set_z(temp, nodes[0].T, MPFR_RNDN);
+        mpfr_clear_flags();
+        f->rc = mpfr_div_z(f->f, temp, nodes[0].Q, GET_MPFR_ROUND(context));
+        mpfr_clear(temp);
+        _GMPy_MPFR_Cleanup(&f, context);
+        result = (PyObject*)f;
+    }
+
+  done:
+    for (i = 0; i < nodes_init; i++)
+        _GMPy_Series_Node_Clear(&nodes[i]);
+    PyMem_Free(nodes);
+    _GMPy_Poly_Clear(&s.p);
+    _GMPy_Poly_Clear(&s.q);
+    _GMPy_Poly_Clear(&s.a);
+    return result;
+}
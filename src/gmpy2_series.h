@@ -0,0 +1,64 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_series.h                                                          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef GMPY_SERIES_H
+#define GMPY_SERIES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Binary splitting of the series S = sum(a(k)*p(1)*...*p(k)/(q(1)*...*q(k))
+ * for 0 <= k < n, where p, q, and a are polynomials with integer
+ * coefficients.
+ */
+
+typedef struct {
+    mpz_t *c;               /* coefficients, constant term first */
+    int n;                  /* number of coefficients, >= 1 */
+} gmpy_poly;
+
+typedef struct {
+    gmpy_poly p, q, a;
+    volatile int zero;      /* set if q(j) == 0 for some j */
+    volatile int stop;      /* set if the computation was interrupted */
+} gmpy_series;
+
+/* The values for the terms l <= k < r: P = p(l+1)*...*p(r),
+ * Q = q(l+1)*...*q(r), and T/Q = sum(a(k)*p(l+1)*...*p(k)/(q(l+1)*...*q(k))).
+ */
+
+typedef struct {
+    mpz_t P, Q, T;
+} gmpy_series_node;
+
+static PyObject * GMPy_MPZ_Function_Binary_Splitting(PyObject *self, PyObject *args, PyObject *keywds);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
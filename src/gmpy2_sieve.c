@@ -0,0 +1,1992 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_sieve.c                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Small primes, trial division, and batch primality tests.
+ *
+ * For trial division the odd primes below GMPY_SIEVE_TRIAL_LIMIT are
+ * grouped so that the product of each group fits in one limb. A candidate
+ * is reduced once per group with mpz_fdiv_ui() and the remainder is then
+ * tested against each prime of the group with machine arithmetic.
+ *
+ * The tables are built by GMPy_Sieve_Init() when a function that needs them
+ * is first called, not at import. That function must be called with the
+ * GIL held before the tables are used; in a free-threaded build, it is
+ * protected by sieve_lock.
+ */
+
+static unsigned int *sieve_primes = NULL;
+static Py_ssize_t sieve_nprimes = 0;
+
+typedef struct {
+    unsigned long product;
+    Py_ssize_t start;       /* index of the first prime in sieve_primes */
+    Py_ssize_t stop;
+} gmpy_trial_group;
+
+static gmpy_trial_group *trial_groups = NULL;
+static Py_ssize_t trial_ngroups = 0;
+
+#ifdef Py_GIL_DISABLED
+static PyMutex sieve_lock;
+#  define SIEVE_LOCK()   PyMutex_Lock(&sieve_lock)
+#  define SIEVE_UNLOCK() PyMutex_Unlock(&sieve_lock)
+#else
+#  define SIEVE_LOCK()
+#  define SIEVE_UNLOCK()
+#endif
+
+static int
+_GMPy_Sieve_Build(void)
+{
+    unsigned char *composite;
+    Py_ssize_t i, j, n = 0;
+    unsigned long product;
+
+    if (!(composite = PyMem_RawCalloc(GMPY_SIEVE_PRIMES_LIMIT, 1)) ||
+        !(sieve_primes = PyMem_RawMalloc(sizeof(unsigned int) * GMPY_SIEVE_PRIMES_LIMIT / 2)) ||
+        !(trial_groups = PyMem_RawMalloc(sizeof(gmpy_trial_group) * GMPY_SIEVE_TRIAL_LIMIT / 2))) {
+        PyMem_RawFree(composite);
+        PyMem_RawFree(sieve_primes);
+        sieve_primes = NULL;
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for (i = 3; i < GMPY_SIEVE_PRIMES_LIMIT; i += 2) {
+        if (composite[i])
+            continue;
+        sieve_primes[n++] = (unsigned int)i;
+        for (j = i * i; j < GMPY_SIEVE_PRIMES_LIMIT; j += 2 * i)
+            composite[j] = 1;
+    }
+    sieve_nprimes = n;
+    PyMem_RawFree(composite);
+
+    for (i = 0; i < n && sieve_primes[i] < GMPY_SIEVE_TRIAL_LIMIT; ) {
+        trial_groups[trial_ngroups].start = i;
+        product = sieve_primes[i++];
+        while (i < n && sieve_primes[i] < GMPY_SIEVE_TRIAL_LIMIT &&
+               product <= ULONG_MAX / sieve_primes[i]) {
+            product *= sieve_primes[i++];
+        }
+        trial_groups[trial_ngroups].product = product;
+        trial_groups[trial_ngroups].stop = i;
+        trial_ngroups++;
+    }
+    return 0;
+}
+
+static int
+GMPy_Sieve_Init(void)
+{
+    int result = 0;
+
+    SIEVE_LOCK();
+    if (!sieve_primes)
+        result = _GMPy_Sieve_Build();
+    SIEVE_UNLOCK();
+    return result;
+}
+
+/* Group the n primes so that the product of each group fits in an
+ * unsigned long, as for trial_groups. groups must have room for n
+ * entries. Returns the number of groups.
+ */
+
+static Py_ssize_t
+_GMPy_Sieve_Groups(const unsigned long *primes, Py_ssize_t n, gmpy_trial_group *groups)
+{
+    Py_ssize_t i, ngroups = 0;
+    unsigned long product;
+
+    for (i = 0; i < n; ) {
+        groups[ngroups].start = i;
+        product = primes[i++];
+        while (i < n && product <= ULONG_MAX / primes[i])
+            product *= primes[i++];
+        groups[ngroups].product = product;
+        groups[ngroups].stop = i;
+        ngroups++;
+    }
+    return ngroups;
+}
+
+/* Trial division of n by the primes below GMPY_SIEVE_TRIAL_LIMIT. Returns
+ * GMPY_TRIAL_PRIME if n is proven prime, GMPY_TRIAL_COMPOSITE if n is not
+ * prime (including n < 2), and GMPY_TRIAL_UNKNOWN if n has no small
+ * factor. Does not use the Python API.
+ */
+
+static int
+_GMPy_Sieve_Trial(mpz_srcptr n)
+{
+    Py_ssize_t g, i;
+    unsigned long r, p;
+    int small = mpz_fits_ulong_p(n);
+
+    if (mpz_cmp_ui(n, 2) < 0)
+        return GMPY_TRIAL_COMPOSITE;
+    if (mpz_even_p(n))
+        return mpz_cmp_ui(n, 2) == 0 ? GMPY_TRIAL_PRIME : GMPY_TRIAL_COMPOSITE;
+
+    for (g = 0; g < trial_ngroups; g++) {
+        r = mpz_fdiv_ui(n, trial_groups[g].product);
+        for (i = trial_groups[g].start; i < trial_groups[g].stop; i++) {
+            p = sieve_primes[i];
+            if (small && p * p > mpz_get_ui(n))
+                return GMPY_TRIAL_PRIME;
+            if (r % p == 0)
+                return mpz_cmp_ui(n, p) == 0 ? GMPY_TRIAL_PRIME : GMPY_TRIAL_COMPOSITE;
+        }
+    }
+    if (small && (unsigned long)GMPY_SIEVE_TRIAL_LIMIT * GMPY_SIEVE_TRIAL_LIMIT > mpz_get_ui(n))
+        return GMPY_TRIAL_PRIME;
+    return GMPY_TRIAL_UNKNOWN;
+}
+
+/* Deterministic primality test for n < 2**64.
+ *
+ * Values that fit in one 64-bit limb are tested with machine arithmetic:
+ * a bitmap of the primes below 64, trial division by the primes below 53,
+ * then, in single limb Montgomery form (see _GMPy_Mont_Mul()), strong
+ * probable prime tests to the bases 2, 7 and 61 below 2**32 or the BPSW
+ * test above. Both are known to have no pseudoprimes in their range, so a
+ * value that passes is proven prime. Larger values, and builds without
+ * 128-bit integers, use mpz_probab_prime_p(). None of these use the
+ * Python API.
+ */
+
+#ifdef GMPY_MONT_INT128
+
+static const mp_limb_t u64_small_primes[] = {
+    3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47
+};
+
+/* a/2 mod n; n is odd. */
+
+static mp_limb_t
+_GMPy_U64_Half(const gmpy_u64_mont *m, mp_limb_t a)
+{
+    return (a >> 1) + ((a & 1) ? (m->n >> 1) + 1 : 0);
+}
+
+/* Return 1 if n is a strong probable prime to the base a. */
+
+static int
+_GMPy_U64_SPRP(const gmpy_u64_mont *m, mp_limb_t a, mp_limb_t d, int s)
+{
+    mp_limb_t x, mone = m->n - m->one;
+    int k;
+
+    if (!(a %= m->n))
+        return 1;
+    a = _GMPy_U64_Mul(m, a, m->r2);
+
+    x = a;
+    for (k = 62 - __builtin_clzll(d); k >= 0; k--) {
+        x = _GMPy_U64_Mul(m, x, x);
+        if ((d >> k) & 1)
+            x = _GMPy_U64_Mul(m, x, a);
+    }
+    if (x == m->one || x == mone)
+        return 1;
+    for (k = 1; k < s; k++) {
+        x = _GMPy_U64_Mul(m, x, x);
+        if (x == mone)
+            return 1;
+    }
+    return 0;
+}
+
+/* Jacobi symbol (a/n) for odd n. */
+
+static int
+_GMPy_U64_Jacobi(mp_limb_t a, mp_limb_t n)
+{
+    mp_limb_t t;
+    int j = 1;
+
+    a %= n;
+    while (a) {
+        while (!(a & 1)) {
+            a >>= 1;
+            if ((n & 7) == 3 || (n & 7) == 5)
+                j = -j;
+        }
+        t = a; a = n; n = t;
+        if ((a & 3) == 3 && (n & 3) == 3)
+            j = -j;
+        a %= n;
+    }
+    return n == 1 ? j : 0;
+}
+
+/* Return 1 if n is a strong Lucas probable prime with the parameters of
+ * Selfridge's method A.
+ */
+
+static int
+_GMPy_U64_Strong_Lucas(const gmpy_u64_mont *m)
+{
+    mp_limb_t n = m->n, r, d, dm, q, qk, u, v, t;
+    long D = 5, Q;
+    int j, k, s;
+
+    for (k = 0; ; k++) {
+        d = D < 0 ? n - (mp_limb_t)(-D) : (mp_limb_t)D;
+        if ((j = _GMPy_U64_Jacobi(d, n)) == -1)
+            break;
+        if (j == 0 && (mp_limb_t)(D < 0 ? -D : D) != n)
+            return 0;
+
+        /* A perfect square has no D with (D/n) = -1. */
+
+        if (k == 8) {
+            r = (mp_limb_t)sqrt((double)n);
+            if (r > 0xffffffff)
+                r = 0xffffffff;
+            while (r * r > n)
+                r--;
+            while (r < 0xffffffff && (r + 1) * (r + 1) <= n)
+                r++;
+            if (r * r == n)
+                return 0;
+        }
+        D = D < 0 ? 2 - D : -D - 2;
+    }
+
+    /* P = 1 and Q = (1 - D)/4; all values are residues. */
+
+    Q = (1 - D) / 4;
+    dm = _GMPy_U64_Mul(m, d, m->r2);
+    q = _GMPy_U64_Mul(m, Q < 0 ? n - (mp_limb_t)(-Q) : (mp_limb_t)Q, m->r2);
+
+    d = n + 1;
+    for (s = 0; !(d & 1); s++)
+        d >>= 1;
+
+    /* U_1 = 1, V_1 = P = 1; double k and add 1 for each bit of d. */
+
+    u = m->one;
+    v = m->one;
+    qk = q;
+    for (k = 62 - __builtin_clzll(d); k >= 0; k--) {
+        u = _GMPy_U64_Mul(m, u, v);
+        v = _GMPy_U64_Sub(m, _GMPy_U64_Mul(m, v, v), _GMPy_U64_Add(m, qk, qk));
+        qk = _GMPy_U64_Mul(m, qk, qk);
+        if ((d >> k) & 1) {
+            t = _GMPy_U64_Half(m, _GMPy_U64_Add(m, u, v));
+            v = _GMPy_U64_Half(m, _GMPy_U64_Add(m, _GMPy_U64_Mul(m, dm, u), v));
+            u = t;
+            qk = _GMPy_U64_Mul(m, qk, q);
+        }
+    }
+    if (u == 0 || v == 0)
+        return 1;
+    for (k = 1; k < s; k++) {
+        v = _GMPy_U64_Sub(m, _GMPy_U64_Mul(m, v, v), _GMPy_U64_Add(m, qk, qk));
+        if (v == 0)
+            return 1;
+        qk = _GMPy_U64_Mul(m, qk, qk);
+    }
+    return 0;
+}
+
+/* Return 1 if n is prime, else 0. */
+
+static int
+_GMPy_U64_IsPrime(mp_limb_t n)
+{
+    gmpy_u64_mont m;
+    mp_limb_t d;
+    size_t i;
+    int s;
+
+    if (n < 64)
+        return (int)((UINT64_C(0x28208a20a08a28ac) >> n) & 1);
+    if (!(n & 1))
+        return 0;
+    for (i = 0; i < sizeof(u64_small_primes) / sizeof(mp_limb_t); i++) {
+        if (n % u64_small_primes[i] == 0)
+            return 0;
+    }
+    if (n < 53 * 53)
+        return 1;
+
+    _GMPy_U64_Mont_Init(&m, n);
+
+    d = n - 1;
+    for (s = 0; !(d & 1); s++)
+        d >>= 1;
+
+    if (!(n >> 32))
+        return _GMPy_U64_SPRP(&m, 2, d, s) && _GMPy_U64_SPRP(&m, 7, d, s) &&
+               _GMPy_U64_SPRP(&m, 61, d, s);
+    return _GMPy_U64_SPRP(&m, 2, d, s) && _GMPy_U64_Strong_Lucas(&m);
+}
+
+/* Set *v to n and return 1 if 0 <= n < 2**64, else return 0. */
+
+#define GMPY_U64_GET(n, v) \
+    (mpz_sgn(n) >= 0 && mpz_size(n) <= 1 && ((*(v) = mpz_getlimbn(n, 0)), 1))
+
+#endif
+
+/* Same result as mpz_probab_prime_p(n, reps), except that every n < 2**64
+ * is either proven prime (2) or composite (0).
+ */
+
+static int
+_GMPy_MPZ_IsPrime(mpz_srcptr n, int reps)
+{
+#ifdef GMPY_MONT_INT128
+    mp_limb_t v;
+
+    if (GMPY_U64_GET(n, &v))
+        return 2 * _GMPy_U64_IsPrime(v);
+#endif
+    return mpz_probab_prime_p(n, reps);
+}
+
+/* Set r to the next prime > n, as mpz_nextprime() does. */
+
+static void
+_GMPy_MPZ_NextPrime(mpz_ptr r, mpz_srcptr n)
+{
+#ifdef GMPY_MONT_INT128
+    mp_limb_t v;
+
+    /* 2**64 - 59 is the largest prime below 2**64. */
+
+    if (GMPY_U64_GET(n, &v) && v < UINT64_C(0xffffffffffffffc5)) {
+        if (v < 2) {
+            mpz_set_ui(r, 2);
+            return;
+        }
+        for (v = (v + 1) | 1; !_GMPy_U64_IsPrime(v); v += 2)
+            ;
+        mpz_limbs_write(r, 1)[0] = v;
+        mpz_limbs_finish(r, 1);
+        return;
+    }
+#endif
+    mpz_nextprime(r, n);
+}
+
+#if (__GNU_MP_VERSION > 6) || (__GNU_MP_VERSION == 6 &&  __GNU_MP_VERSION_MINOR >= 3)
+
+/* Set r to the previous prime < n and return 1, or return 0 if n <= 2, as
+ * mpz_prevprime() does.
+ */
+
+static int
+_GMPy_MPZ_PrevPrime(mpz_ptr r, mpz_srcptr n)
+{
+#ifdef GMPY_MONT_INT128
+    mp_limb_t v;
+
+    if (GMPY_U64_GET(n, &v)) {
+        if (v <= 2)
+            return 0;
+        if (v == 3) {
+            mpz_set_ui(r, 2);
+            return 1;
+        }
+        for (v = (v - 2) | 1; !_GMPy_U64_IsPrime(v); v -= 2)
+            ;
+        mpz_limbs_write(r, 1)[0] = v;
+        mpz_limbs_finish(r, 1);
+        return 1;
+    }
+#endif
+    return mpz_prevprime(r, n) != 0;
+}
+
+#endif
+
+typedef struct {
+    PyObject **items;
+    int *status;
+    int reps;
+    int bpsw;           /* use the BPSW test instead of mpz_probab_prime_p() */
+} gmpy_prime_list;
+
+static void
+_GMPy_Prime_List_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_prime_list *work = (gmpy_prime_list*)arg;
+    Py_ssize_t i;
+    mpz_srcptr n;
+
+    for (i = start; i < stop && !GMPy_Interrupt_Poll(); i++) {
+        n = MPZ(work->items[i]);
+        work->status[i] = _GMPy_Sieve_Trial(n);
+        if (work->status[i] == GMPY_TRIAL_UNKNOWN) {
+#ifdef GMPY_MONT_INT128
+            /* Below 2**64 the deterministic test agrees with both. */
+            if (mpz_size(n) <= 1)
+                work->status[i] = _GMPy_U64_IsPrime(mpz_getlimbn(n, 0));
+            else
+#endif
+            if (work->bpsw)
+                work->status[i] = _GMPy_MPZ_BPSW_PRP(n);
+            else
+                work->status[i] = mpz_probab_prime_p(n, work->reps) != 0;
+        }
+    }
+}
+
+static PyObject *
+_GMPy_Prime_List(PyObject *values, int reps, int bpsw, const char *name)
+{
+    PyObject *seq, *result = NULL;
+    MPZ_Object *temp;
+    Py_ssize_t i, n;
+    size_t bits = 0;
+    gmpy_prime_list work;
+    gmpy_interrupt intr;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (GMPy_Sieve_Init() < 0)
+        return NULL;
+
+    if (!(seq = PySequence_Fast(values, "argument must be an iterable")))
+        return NULL;
+
+    /* Replace every item by an mpz that is kept alive by the list. */
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    if (!(result = PyList_New(n))) {
+        Py_DECREF(seq);
+        return NULL;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (!(temp = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(seq, i), context))) {
+            PyErr_Format(PyExc_TypeError, "%s() requires integer arguments", name);
+            goto err;
+        }
+        PyList_SET_ITEM(result, i, (PyObject*)temp);
+        if (bpsw && mpz_sgn(temp->z) <= 0) {
+            PyErr_Format(PyExc_ValueError, "%s() requires 'n' be greater than 0", name);
+            goto err;
+        }
+        bits += GMPY_MPZ_BITS(temp->z);
+    }
+    Py_DECREF(seq);
+    seq = NULL;
+
+    if (!(work.status = PyMem_New(int, n ? n : 1))) {
+        PyErr_NoMemory();
+        goto err;
+    }
+    work.items = PySequence_Fast_ITEMS(result);
+    work.reps = reps;
+    work.bpsw = bpsw;
+    GMPy_Scratch_Attach();
+
+    if (n)
+        GMPY_PROFILE_OPN(context, GMPY_OP_PRP, bits / n, n);
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    intr.save = &_save;
+    GMPy_Parallel_Run(_GMPy_Prime_List_Range, &work, n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    if (GMPy_Interrupt_End(&intr) < 0) {
+        PyMem_Free(work.status);
+        goto err;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (work.status[i] < 0) {
+            VALUE_ERROR("appropriate value for D cannot be found in is_selfridge_prp()");
+            PyMem_Free(work.status);
+            goto err;
+        }
+        temp = (MPZ_Object*)PyList_GET_ITEM(result, i);
+        PyList_SET_ITEM(result, i, PyBool_FromLong(work.status[i]));
+        Py_DECREF((PyObject*)temp);
+    }
+    PyMem_Free(work.status);
+    return result;
+
+  err:
+    Py_XDECREF(seq);
+    Py_DECREF(result);
+    return NULL;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_is_prime_list,
+"is_prime_list(values, n=25, /) -> list[bool]\n\n"
+"Return [is_prime(x, n) for x in values]. All values are first checked\n"
+"for small prime factors; only the remaining values are tested with\n"
+"up to n Miller-Rabin tests. Will always release the GIL unless the\n"
+"total size of the values is less than the context's\n"
+"release_gil_min_bits. The work is split over the number of threads\n"
+"given by the context's threads.");
+
+static PyObject *
+GMPy_MPZ_Function_IsPrimeList(PyObject *self, PyObject *args)
+{
+    unsigned long reps = 25;
+    Py_ssize_t argc;
+
+    argc = PyTuple_GET_SIZE(args);
+
+    if (argc == 0 || argc > 2) {
+        TYPE_ERROR("is_prime_list() requires 1 or 2 arguments");
+        return NULL;
+    }
+
+    if (argc == 2) {
+        reps = GMPy_Integer_AsUnsignedLong(PyTuple_GET_ITEM(args, 1));
+        if (reps == (unsigned long)(-1) && PyErr_Occurred()) {
+            return NULL;
+        }
+        /* Silently limit n to a reasonable value. */
+        if (reps > 1000) {
+            reps = 1000;
+        }
+    }
+
+    return _GMPy_Prime_List(PyTuple_GET_ITEM(args, 0), (int)reps, 0, "is_prime_list");
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_is_bpsw_prp_list,
+"is_bpsw_prp_list(values, /) -> list[bool]\n\n"
+"Return [is_bpsw_prp(x) for x in values]. All values are first checked\n"
+"for small prime factors; only the remaining values run the BPSW test.\n"
+"Will always release the GIL unless the total size of the values is\n"
+"less than the context's release_gil_min_bits. The work is split over\n"
+"the number of threads given by the context's threads.");
+
+static PyObject *
+GMPy_MPZ_Function_IsBPSWPrpList(PyObject *self, PyObject *other)
+{
+    return _GMPy_Prime_List(other, 0, 1, "is_bpsw_prp_list");
+}
+
+/* Segmented sieve.
+ *
+ * A segment is the run of odd numbers lo, lo + 2, ..., lo + 2 * (len - 1)
+ * with lo odd and len at most GMPY_SIEVE_SEGMENT, so that the flags fit in
+ * the L2 cache. The segment is sieved by the nbase odd primes in base,
+ * which must be all the odd primes below limit; the offset of each base
+ * prime is found with one mpz_fdiv_ui() so word-size and multi-limb values
+ * of lo are handled the same way. Below limit**2 every survivor is prime.
+ * Above, the survivors are only candidates and are checked with
+ * _GMPy_MPZ_IsPrime(), as next_prime() does.
+ */
+
+static Py_ssize_t
+_GMPy_Sieve_Segment_Base(mpz_srcptr lo, Py_ssize_t len, unsigned char *flags,
+                         unsigned int *found, mpz_ptr temp,
+                         const unsigned int *base, Py_ssize_t nbase,
+                         unsigned long limit)
+{
+    Py_ssize_t i, idx, count = 0;
+    unsigned long p, r, off, root = 0;
+    uint64_t lo_u = 0, square;
+    int exact, small;
+
+    memset(flags, 0, len);
+
+    mpz_add_ui(temp, lo, 2 * (unsigned long)(len - 1));
+    mpz_sqrt(temp, temp);
+    exact = mpz_cmp_ui(temp, limit) < 0;
+    if (exact)
+        root = mpz_get_ui(temp);
+    small = mpz_sizeinbase(lo, 2) <= 64;
+    if (small) {
+        mpz_export(&lo_u, NULL, -1, sizeof(uint64_t), 0, 0, lo);
+    }
+
+    for (i = 0; i < nbase; i++) {
+        p = base[i];
+        if (exact && p > root)
+            break;
+        square = (uint64_t)p * p;
+        if (small && lo_u <= square) {
+            idx = (Py_ssize_t)((square - lo_u) / 2);
+        }
+        else {
+            /* lo + off is the first multiple of p >= lo; it must be odd. */
+            r = mpz_fdiv_ui(lo, p);
+            off = r ? p - r : 0;
+            if (off & 1)
+                off += p;
+            idx = (Py_ssize_t)(off / 2);
+        }
+        for (; idx < len; idx += (Py_ssize_t)p)
+            flags[idx] = 1;
+    }
+
+    if (small && lo_u == 1)
+        flags[0] = 1;
+
+    for (i = 0; i < len; i++) {
+        if (flags[i])
+            continue;
+        if (!exact) {
+            mpz_add_ui(temp, lo, 2 * (unsigned long)i);
+            if (!_GMPy_MPZ_IsPrime(temp, 25))
+                continue;
+        }
+        found[count++] = (unsigned int)(2 * i);
+    }
+    return count;
+}
+
+/* Sieve a segment by the primes in sieve_primes. */
+
+static Py_ssize_t
+_GMPy_Sieve_Segment(mpz_srcptr lo, Py_ssize_t len, unsigned char *flags,
+                    unsigned int *found, mpz_ptr temp)
+{
+    return _GMPy_Sieve_Segment_Base(lo, len, flags, found, temp, sieve_primes,
+                                    sieve_nprimes, GMPY_SIEVE_PRIMES_LIMIT);
+}
+
+/* Set lo to the smallest odd number >= max(start, 3). */
+
+/* Return a new array of the primes <= B in increasing order and set count
+ * to their number. B must be less than 2**32 so that every survivor of
+ * the segmented sieve is prime. GMPy_Sieve_Init() must have been called.
+ */
+
+static unsigned long *
+_GMPy_Sieve_Primes(unsigned long B, Py_ssize_t *count)
+{
+    unsigned long *result, *temp;
+    unsigned char *flags = NULL;
+    unsigned int *found = NULL;
+    Py_ssize_t i, n = 0, size, len, nfound;
+    mpz_t lo, scratch;
+
+    size = sieve_nprimes + 1;
+    if (!(result = PyMem_New(unsigned long, size)))
+        return (unsigned long*)PyErr_NoMemory();
+
+    if (B >= 2)
+        result[n++] = 2;
+    for (i = 0; i < sieve_nprimes && sieve_primes[i] <= B; i++)
+        result[n++] = sieve_primes[i];
+
+    if (B > GMPY_SIEVE_PRIMES_LIMIT) {
+        if (!(flags = PyMem_Malloc(GMPY_SIEVE_SEGMENT)) ||
+            !(found = PyMem_New(unsigned int, GMPY_SIEVE_SEGMENT))) {
+            PyMem_Free(flags);
+            PyMem_Free(result);
+            return (unsigned long*)PyErr_NoMemory();
+        }
+        mpz_init_set_ui(lo, GMPY_SIEVE_PRIMES_LIMIT + 1);
+        mpz_init(scratch);
+        while (mpz_cmp_ui(lo, B) <= 0) {
+            len = (Py_ssize_t)((B - mpz_get_ui(lo)) / 2 + 1);
+            if (len > GMPY_SIEVE_SEGMENT)
+                len = GMPY_SIEVE_SEGMENT;
+            nfound = _GMPy_Sieve_Segment(lo, len, flags, found, scratch);
+            if (n + nfound > size) {
+                size = 2 * (n + nfound);
+                if (!(temp = PyMem_Realloc(result, sizeof(unsigned long) * size))) {
+                    PyErr_NoMemory();
+                    break;
+                }
+                result = temp;
+            }
+            for (i = 0; i < nfound; i++)
+                result[n++] = mpz_get_ui(lo) + found[i];
+            mpz_add_ui(lo, lo, 2 * (unsigned long)len);
+        }
+        mpz_clear(lo);
+        mpz_clear(scratch);
+        PyMem_Free(flags);
+        PyMem_Free(found);
+        if (PyErr_Occurred()) {
+            PyMem_Free(result);
+            return NULL;
+        }
+    }
+    *count = n;
+    return result;
+}
+
+static void
+_GMPy_Sieve_Start(mpz_ptr lo, mpz_srcptr start)
+{
+    if (mpz_cmp_ui(start, 3) < 0)
+        mpz_set_ui(lo, 3);
+    else if (mpz_even_p(start))
+        mpz_add_ui(lo, start, 1);
+    else
+        mpz_set(lo, start);
+}
+
+PyDoc_STRVAR(GMPy_doc_iter_primes,
+"iter_primes(start=2, stop=None)\n\n"
+"Return an iterator over the primes p with start <= p < stop, as mpz.\n"
+"If stop is None the iterator does not end. The primes are found with a\n"
+"segmented sieve; values above 2**32 are *probable* primes, exactly as\n"
+"returned by next_prime().");
+
+static PyObject *
+GMPy_PrimeIter_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    PrimeIter_Object *result;
+    MPZ_Object *start = NULL, *stop = NULL;
+    PyObject *startobj = NULL, *stopobj = Py_None;
+    CTXT_Object *context = NULL;
+    static char *kwlist[] = {"start", "stop", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|OO", kwlist,
+                                     &startobj, &stopobj)) {
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (GMPy_Sieve_Init() < 0)
+        return NULL;
+
+    if ((startobj && !IS_INTEGER(startobj)) ||
+        (stopobj != Py_None && !IS_INTEGER(stopobj))) {
+        TYPE_ERROR("iter_primes() requires integer arguments");
+        return NULL;
+    }
+
+    if (!(result = PyObject_New(PrimeIter_Object, &PrimeIter_Type)))
+        return NULL;
+    mpz_init(result->lo);
+    mpz_init(result->stop);
+    result->has_stop = 0;
+    result->flags = NULL;
+    result->found = NULL;
+    result->seglen = 0;
+    result->nfound = 0;
+    result->index = 0;
+
+    if (startobj) {
+        if (!(start = GMPy_MPZ_From_Integer(startobj, context))) {
+            Py_DECREF((PyObject*)result);
+            return NULL;
+        }
+        result->two = mpz_cmp_ui(start->z, 2) <= 0;
+        _GMPy_Sieve_Start(result->lo, start->z);
+        Py_DECREF((PyObject*)start);
+    }
+    else {
+        result->two = 1;
+        mpz_set_ui(result->lo, 3);
+    }
+
+    if (stopobj != Py_None) {
+        if (!(stop = GMPy_MPZ_From_Integer(stopobj, context))) {
+            Py_DECREF((PyObject*)result);
+            return NULL;
+        }
+        mpz_set(result->stop, stop->z);
+        result->has_stop = 1;
+        if (mpz_cmp_ui(stop->z, 2) <= 0)
+            result->two = 0;
+        Py_DECREF((PyObject*)stop);
+    }
+
+    if (!(result->flags = PyMem_New(unsigned char, GMPY_SIEVE_SEGMENT)) ||
+        !(result->found = PyMem_New(unsigned int, GMPY_SIEVE_SEGMENT))) {
+        Py_DECREF((PyObject*)result);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)result;
+}
+
+static void
+GMPy_PrimeIter_Dealloc(PrimeIter_Object *self)
+{
+    mpz_clear(self->lo);
+    mpz_clear(self->stop);
+    PyMem_Free(self->flags);
+    PyMem_Free(self->found);
+    PyObject_Free(self);
+}
+
+static PyObject *
+GMPy_PrimeIter_Next(PrimeIter_Object *self)
+{
+    MPZ_Object *result;
+    Py_ssize_t len;
+    mpz_t temp;
+
+    if (self->two) {
+        self->two = 0;
+        if ((result = GMPy_MPZ_New(NULL)))
+            mpz_set_ui(result->z, 2);
+        return (PyObject*)result;
+    }
+
+    while (self->index == self->nfound) {
+        /* Move lo past the segment that has been used up. */
+        mpz_add_ui(self->lo, self->lo, 2 * (unsigned long)self->seglen);
+        self->seglen = 0;
+        len = GMPY_SIEVE_SEGMENT;
+        mpz_init(temp);
+        if (self->has_stop) {
+            if (mpz_cmp(self->lo, self->stop) >= 0) {
+                mpz_clear(temp);
+                return NULL;
+            }
+            mpz_sub(temp, self->stop, self->lo);
+            if (mpz_cmp_ui(temp, 2 * (unsigned long)GMPY_SIEVE_SEGMENT) < 0)
+                len = (Py_ssize_t)((mpz_get_ui(temp) + 1) / 2);
+        }
+        self->nfound = _GMPy_Sieve_Segment(self->lo, len, self->flags,
+                                           self->found, temp);
+        self->seglen = len;
+        self->index = 0;
+        mpz_clear(temp);
+    }
+
+    if ((result = GMPy_MPZ_New(NULL)))
+        mpz_add_ui(result->z, self->lo, self->found[self->index++]);
+    return (PyObject*)result;
+}
+
+static PyTypeObject PrimeIter_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.iter_primes",
+    .tp_basicsize = sizeof(PrimeIter_Object),
+    .tp_dealloc = (destructor) GMPy_PrimeIter_Dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_iter_primes,
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc) GMPy_PrimeIter_Next,
+    .tp_new = GMPy_PrimeIter_NewInit,
+};
+
+typedef struct {
+    mpz_srcptr lo;          /* first odd number of the whole range */
+    Py_ssize_t len;         /* number of odd numbers in the range */
+    unsigned int **found;   /* per segment */
+    Py_ssize_t *nfound;
+    int failed;
+} gmpy_prime_range;
+
+static void
+_GMPy_Prime_Range_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_prime_range *work = (gmpy_prime_range*)arg;
+    unsigned char *flags;
+    unsigned int *found;
+    Py_ssize_t s, len, n;
+    mpz_t lo, temp;
+
+    if (!(flags = PyMem_RawMalloc(GMPY_SIEVE_SEGMENT))) {
+        work->failed = 1;
+        return;
+    }
+    mpz_init(lo);
+    mpz_init(temp);
+
+    for (s = start; s < stop; s++) {
+        len = work->len - s * GMPY_SIEVE_SEGMENT;
+        if (len > GMPY_SIEVE_SEGMENT)
+            len = GMPY_SIEVE_SEGMENT;
+        if (!(found = PyMem_RawMalloc(sizeof(unsigned int) * len))) {
+            work->failed = 1;
+            break;
+        }
+        mpz_set_ui(temp, 2 * (unsigned long)GMPY_SIEVE_SEGMENT);
+        mpz_mul_ui(temp, temp, (unsigned long)s);
+        mpz_add(lo, work->lo, temp);
+        n = _GMPy_Sieve_Segment(lo, len, flags, found, temp);
+        work->found[s] = found;
+        work->nfound[s] = n;
+    }
+
+    mpz_clear(lo);
+    mpz_clear(temp);
+    PyMem_RawFree(flags);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_primerange,
+"primerange(a, b, /) -> mpz_array\n\n"
+"Return the primes p with a <= p < b in an mpz_array. The primes are\n"
+"found with a segmented sieve; values above 2**32 are *probable* primes,\n"
+"exactly as returned by next_prime(). Will always release the GIL unless\n"
+"the range is shorter than the context's release_gil_min_bits. The\n"
+"segments are split over the number of threads given by the context's\n"
+"threads.");
+
+static PyObject *
+GMPy_MPZ_Function_PrimeRange(PyObject *self, PyObject *args)
+{
+    MPZ_Array_Object *result = NULL;
+    MPZ_Object *a = NULL, *b = NULL;
+    gmpy_prime_range work;
+    Py_ssize_t s, nsegs = 0, i, total, k;
+    int two;
+    mpz_t lo;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (PyTuple_GET_SIZE(args) != 2 ||
+        !IS_INTEGER(PyTuple_GET_ITEM(args, 0)) ||
+        !IS_INTEGER(PyTuple_GET_ITEM(args, 1))) {
+        TYPE_ERROR("primerange() requires 2 integer arguments");
+        return NULL;
+    }
+
+    if (GMPy_Sieve_Init() < 0)
+        return NULL;
+
+    if (!(a = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), context)) ||
+        !(b = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), context))) {
+        Py_XDECREF((PyObject*)a);
+        return NULL;
+    }
+
+    two = mpz_cmp_ui(a->z, 2) <= 0 && mpz_cmp_ui(b->z, 2) > 0;
+
+    mpz_init(lo);
+    _GMPy_Sieve_Start(lo, a->z);
+    work.lo = lo;
+    work.len = 0;
+    work.failed = 0;
+    work.found = NULL;
+    work.nfound = NULL;
+
+    if (mpz_cmp(lo, b->z) < 0) {
+        mpz_sub(lo, b->z, lo);
+        if (!mpz_fits_slong_p(lo) || mpz_get_si(lo) >= PY_SSIZE_T_MAX) {
+            VALUE_ERROR("primerange() range is too large");
+            goto done;
+        }
+        work.len = (Py_ssize_t)((mpz_get_si(lo) + 1) / 2);
+        _GMPy_Sieve_Start(lo, a->z);
+    }
+    nsegs = (work.len + GMPY_SIEVE_SEGMENT - 1) / GMPY_SIEVE_SEGMENT;
+
+    if (!(work.found = PyMem_New(unsigned int*, nsegs ? nsegs : 1)) ||
+        !(work.nfound = PyMem_New(Py_ssize_t, nsegs ? nsegs : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (s = 0; s < nsegs; s++) {
+        work.found[s] = NULL;
+        work.nfound[s] = 0;
+    }
+
+    GMPY_PROFILE_OPN(context, GMPY_OP_PRP, GMPY_MPZ_BITS(b->z), work.len);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, work.len);
+    GMPy_Parallel_Run(_GMPy_Prime_Range_Range, &work, nsegs,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (work.failed) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    total = two;
+    for (s = 0; s < nsegs; s++)
+        total += work.nfound[s];
+
+    if (!(result = GMPy_MPZ_Array_New(total)))
+        goto done;
+
+    k = 0;
+    if (two)
+        mpz_set_ui(result->z[k++], 2);
+    for (s = 0; s < nsegs; s++) {
+        for (i = 0; i < work.nfound[s]; i++) {
+            mpz_add_ui(result->z[k++], lo, work.found[s][i]);
+        }
+        mpz_add_ui(lo, lo, 2 * (unsigned long)GMPY_SIEVE_SEGMENT);
+    }
+
+  done:
+    if (work.found) {
+        for (s = 0; s < nsegs; s++)
+            PyMem_RawFree(work.found[s]);
+    }
+    PyMem_Free(work.found);
+    PyMem_Free(work.nfound);
+    mpz_clear(lo);
+    Py_DECREF((PyObject*)a);
+    Py_DECREF((PyObject*)b);
+    return (PyObject*)result;
+}
+
+/* Prime counting.
+ *
+ * Below GMPY_SIEVE_PRIMES_LIMIT, pi(x) is found in sieve_primes. Above,
+ * it is found with the combinatorial method of Meissel and Lehmer in its
+ * tabulated form. Let S(v, p) be the number of integers 2 <= m <= v that
+ * are prime or have no prime factor <= p. With r = isqrt(x), S is kept for
+ * the 2 * r values v = x // k only, and for each prime p <= r in turn
+ *
+ *     S(v, p) = S(v, q) - (S(v // p, q) - pi(p - 1))
+ *
+ * for all v >= p * p, where q is the prime before p and v // p is again
+ * one of the values. Then pi(x) = S(x, r). This takes O(x**(3/4) / log(x))
+ * steps and 16 * r bytes. A round that updates at least
+ * GMPY_PRIME_PI_PARALLEL values is split over the threads: all the
+ * differences are computed from the old values before any is subtracted.
+ */
+
+enum {
+    PRIME_PI_DONE = 0,
+    PRIME_PI_NOMEM = -1,
+    PRIME_PI_INTERRUPTED = -2
+};
+
+typedef struct {
+    uint64_t x;
+    double fx;              /* x, if it is below 2**52 */
+    uint64_t r;             /* isqrt(x) */
+    uint64_t *lo;           /* lo[v] = S(v, p) for v <= r */
+    uint64_t *hi;           /* hi[k] = S(x // k, p) for k <= r */
+    uint64_t *delta;
+    uint64_t p;
+    uint64_t sp;            /* pi(p - 1) */
+    uint64_t kmax;          /* the round updates hi[1..kmax] ... */
+    uint64_t vmin;          /* ... and lo[vmin..r] */
+} gmpy_prime_pi;
+
+/* Return x // d. Below 2**52 the quotient of doubles is exact or one too
+ * large, and is faster than the division of 64-bit integers. Values
+ * v <= r are below 2**32 and are divided as 32-bit integers.
+ */
+
+static uint64_t
+_GMPy_Prime_Pi_Div(const gmpy_prime_pi *w, uint64_t d)
+{
+    uint64_t q;
+
+    if (w->fx == 0)
+        return w->x / d;
+    q = (uint64_t)(w->fx / (double)d);
+    return q * d > w->x ? q - 1 : q;
+}
+
+#define PRIME_PI_SMALL_DIV(v, p) ((uint32_t)(v) / (uint32_t)(p))
+
+/* Entry i of a round is hi[i + 1] for i < kmax, else lo[vmin + i - kmax]. */
+
+static void
+_GMPy_Prime_Pi_Delta(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_prime_pi *w = (gmpy_prime_pi*)arg;
+    uint64_t i, d;
+
+    for (i = (uint64_t)start; i < (uint64_t)stop; i++) {
+        if (i < w->kmax) {
+            d = (i + 1) * w->p;
+            w->delta[i] = (d <= w->r ? w->hi[d] : w->lo[_GMPy_Prime_Pi_Div(w, d)]) - w->sp;
+        }
+        else {
+            w->delta[i] = w->lo[PRIME_PI_SMALL_DIV(w->vmin + i - w->kmax, w->p)] - w->sp;
+        }
+    }
+}
+
+static void
+_GMPy_Prime_Pi_Apply(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_prime_pi *w = (gmpy_prime_pi*)arg;
+    uint64_t i;
+
+    for (i = (uint64_t)start; i < (uint64_t)stop; i++) {
+        if (i < w->kmax)
+            w->hi[i + 1] -= w->delta[i];
+        else
+            w->lo[w->vmin + i - w->kmax] -= w->delta[i];
+    }
+}
+
+static uint64_t
+_GMPy_U64_Sqrt(uint64_t x)
+{
+    uint64_t r = (uint64_t)sqrt((double)x);
+
+    while (r && r > x / r)
+        r--;
+    while (r + 1 <= x / (r + 1))
+        r++;
+    return r;
+}
+
+/* Set *result to pi(x). Does not use the Python API except through
+ * GMPy_Interrupt_Poll(). GMPy_Sieve_Init() must have been called.
+ */
+
+static int
+_GMPy_Prime_Pi(uint64_t *result, uint64_t x, int threads)
+{
+    gmpy_prime_pi w;
+    uint64_t k, v, d, n;
+    Py_ssize_t low, high, mid;
+    int status = PRIME_PI_DONE;
+
+    if (x < GMPY_SIEVE_PRIMES_LIMIT) {
+        if (x < 2) {
+            *result = 0;
+            return PRIME_PI_DONE;
+        }
+        low = 0;
+        high = sieve_nprimes;
+        while (low < high) {
+            mid = (low + high) / 2;
+            if (sieve_primes[mid] <= x)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        *result = (uint64_t)low + 1;
+        return PRIME_PI_DONE;
+    }
+
+    w.x = x;
+    w.fx = x < ((uint64_t)1 << 52) ? (double)x : 0;
+    w.r = _GMPy_U64_Sqrt(x);
+    w.lo = PyMem_RawMalloc(sizeof(uint64_t) * (size_t)(w.r + 1));
+    w.hi = PyMem_RawMalloc(sizeof(uint64_t) * (size_t)(w.r + 1));
+    w.delta = NULL;
+    if (threads > 1)
+        w.delta = PyMem_RawMalloc(2 * sizeof(uint64_t) * (size_t)(w.r + 1));
+    if (!w.lo || !w.hi || (threads > 1 && !w.delta)) {
+        status = PRIME_PI_NOMEM;
+        goto done;
+    }
+
+    w.lo[0] = 0;
+    for (v = 1; v <= w.r; v++)
+        w.lo[v] = v - 1;
+    for (k = 1; k <= w.r; k++)
+        w.hi[k] = x / k - 1;
+
+    for (w.p = 2; w.p <= w.r; w.p++) {
+        if (w.lo[w.p] == w.lo[w.p - 1])
+            continue;
+        if (GMPy_Interrupt_Poll()) {
+            status = PRIME_PI_INTERRUPTED;
+            goto done;
+        }
+        w.sp = w.lo[w.p - 1];
+        w.vmin = w.p * w.p;
+        w.kmax = x / w.vmin;
+        if (w.kmax > w.r)
+            w.kmax = w.r;
+        n = w.kmax + (w.vmin <= w.r ? w.r - w.vmin + 1 : 0);
+
+        if (threads > 1 && n >= GMPY_PRIME_PI_PARALLEL) {
+            GMPy_Parallel_Run(_GMPy_Prime_Pi_Delta, &w, (Py_ssize_t)n, threads);
+            GMPy_Parallel_Run(_GMPy_Prime_Pi_Apply, &w, (Py_ssize_t)n, threads);
+            continue;
+        }
+
+        /* In place, hi[k] is updated before hi[k * p] and lo[v] before
+         * lo[v // p], so the old values are read.
+         */
+
+        for (k = 1; k <= w.kmax; k++) {
+            d = k * w.p;
+            w.hi[k] -= (d <= w.r ? w.hi[d] : w.lo[_GMPy_Prime_Pi_Div(&w, d)]) - w.sp;
+        }
+        for (v = w.r; v >= w.vmin; v--)
+            w.lo[v] -= w.lo[PRIME_PI_SMALL_DIV(v, w.p)] - w.sp;
+    }
+    *result = w.hi[1];
+
+  done:
+    PyMem_RawFree(w.lo);
+    PyMem_RawFree(w.hi);
+    PyMem_RawFree(w.delta);
+    return status;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_prime_pi,
+"prime_pi(x, /) -> mpz\n\n"
+"Return the number of primes p <= x for x < 2**64. Small x are looked\n"
+"up in the table of the primes below 65536; larger x use the Meissel-Lehmer\n"
+"method, which takes about x**(3/4) / log(x) steps and 16 * isqrt(x) bytes.\n"
+"Will always release the GIL unless isqrt(x) is less than the context's\n"
+"release_gil_min_bits; large rounds of the method are split over the\n"
+"number of threads given by the context's threads.");
+
+static PyObject *
+GMPy_MPZ_Function_PrimePi(PyObject *self, PyObject *other)
+{
+    MPZ_Object *tempx, *result = NULL;
+    gmpy_interrupt intr;
+    uint64_t x, count = 0;
+    int threads, status;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_INTEGER(other)) {
+        TYPE_ERROR("prime_pi() requires an integer argument");
+        return NULL;
+    }
+    if (GMPy_Sieve_Init() < 0)
+        return NULL;
+    if (!(tempx = GMPy_MPZ_From_Integer(other, context)))
+        return NULL;
+
+    if (mpz_sizeinbase(tempx->z, 2) > 64 && mpz_sgn(tempx->z) > 0) {
+        VALUE_ERROR("prime_pi() requires x < 2**64");
+        Py_DECREF((PyObject*)tempx);
+        return NULL;
+    }
+    x = mpz_sgn(tempx->z) < 0 ? 0 : _GMPy_MPZ_Get_UInt64(tempx->z);
+    Py_DECREF((PyObject*)tempx);
+
+    GMPY_PROFILE_OPN(context, GMPY_OP_PRP, 64, 1);
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, _GMPy_U64_Sqrt(x));
+    intr.save = &_save;
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+    status = _GMPy_Prime_Pi(&count, x, threads);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (GMPy_Interrupt_End(&intr) < 0)
+        return NULL;
+    if (status == PRIME_PI_NOMEM)
+        return PyErr_NoMemory();
+    if ((result = GMPy_MPZ_New(context)))
+        _GMPy_MPZ_Set_UInt64(result->z, count);
+    return (PyObject*)result;
+}
+
+/* The n-th prime.
+ *
+ * x0 is the inverse of Riemann's R(x) = sum(mu(k) / k * li(x**(1/k))) at
+ * n, found with Newton's method, and the primes from x0 to the n-th prime
+ * are counted with the segmented sieve, upward if pi(x0) < n and downward
+ * otherwise. The segments are sieved by the primes below
+ * GMPY_NTH_PRIME_BASE and the sqrt(x0) bound, so usually every survivor
+ * is prime, and the threads each sieve one segment of a batch.
+ */
+
+/* pi(2**64) */
+
+#define GMPY_PRIME_PI_U64 UINT64_C(425656284035217743)
+
+static int
+_GMPy_Moebius(unsigned long k)
+{
+    unsigned long p;
+    int result = 1;
+
+    for (p = 2; p * p <= k; p++) {
+        if (k % p)
+            continue;
+        k /= p;
+        if (k % p == 0)
+            return 0;
+        result = -result;
+    }
+    return k > 1 ? -result : result;
+}
+
+/* Return R(x); t is an mpfr_t for the terms. */
+
+static double
+_GMPy_Riemann_R(double x, mpfr_ptr t)
+{
+    double logx = log(x), sum = 0;
+    unsigned long k;
+    int mu;
+
+    for (k = 1; logx / k > 0.6931471805599453; k++) {
+        if (!(mu = _GMPy_Moebius(k)))
+            continue;
+        mpfr_set_d(t, logx / k, MPFR_RNDN);
+        mpfr_eint(t, t, MPFR_RNDN);
+        sum += mu * mpfr_get_d(t, MPFR_RNDN) / k;
+    }
+    return sum;
+}
+
+/* Return an estimate of the n-th prime for n > 6542. */
+
+static uint64_t
+_GMPy_Nth_Prime_Estimate(uint64_t n)
+{
+    mpfr_t t;
+    double x, step;
+    int i;
+
+    mpfr_init2(t, 64);
+    x = (double)n * (log((double)n) + log(log((double)n)));
+    for (i = 0; i < 32; i++) {
+        step = (_GMPy_Riemann_R(x, t) - (double)n) * log(x);
+        x -= step;
+        if (x > 18446744073709547520.0)
+            x = 18446744073709547520.0;
+        if (fabs(step) < 1)
+            break;
+    }
+    mpfr_clear(t);
+    return (uint64_t)x;
+}
+
+typedef struct {
+    mpz_t start;            /* first odd number of segment 0 going up, or
+                               last odd number of segment 0 going down */
+    int down;
+    Py_ssize_t first;       /* segment number of the first of the batch */
+    const unsigned int *base;
+    Py_ssize_t nbase;
+    unsigned long limit;
+    mpz_t *lo;              /* per segment of the batch */
+    mpz_t *temp;
+    unsigned char **flags;
+    unsigned int **found;
+    Py_ssize_t *nfound;
+} gmpy_prime_scan;
+
+static void
+_GMPy_Prime_Scan_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_prime_scan *w = (gmpy_prime_scan*)arg;
+    Py_ssize_t j, len;
+    mpz_ptr lo;
+
+    for (j = start; j < stop; j++) {
+        lo = w->lo[j];
+        len = GMPY_SIEVE_SEGMENT;
+        mpz_set_ui(lo, 2 * (unsigned long)GMPY_SIEVE_SEGMENT);
+        mpz_mul_ui(lo, lo, (unsigned long)(w->first + j));
+        if (w->down) {
+            mpz_sub(lo, w->start, lo);
+            if (mpz_cmp_ui(lo, 3) < 0) {
+                w->nfound[j] = 0;
+                continue;
+            }
+            if (mpz_cmp_ui(lo, 2 * (unsigned long)len + 1) < 0) {
+                len = (Py_ssize_t)((mpz_get_ui(lo) - 3) / 2 + 1);
+            }
+            mpz_sub_ui(lo, lo, 2 * (unsigned long)(len - 1));
+        }
+        else {
+            mpz_add(lo, w->start, lo);
+        }
+        w->nfound[j] = _GMPy_Sieve_Segment_Base(lo, len, w->flags[j], w->found[j],
+                                                w->temp[j], w->base, w->nbase,
+                                                w->limit);
+    }
+}
+
+/* Set result to the n-th prime, n > sieve_nprimes + 1, given x0 and
+ * c = pi(x0). Does not use the Python API except through
+ * GMPy_Interrupt_Poll().
+ */
+
+static int
+_GMPy_Nth_Prime_Scan(mpz_ptr result, uint64_t n, uint64_t x0, uint64_t c,
+                     const unsigned int *base, Py_ssize_t nbase,
+                     unsigned long limit, int threads)
+{
+    gmpy_prime_scan w;
+    uint64_t need;
+    Py_ssize_t j, ready = 0;
+    int status = PRIME_PI_NOMEM;
+
+    w.down = c >= n;
+    need = w.down ? c - n + 1 : n - c;
+    w.base = base;
+    w.nbase = nbase;
+    w.limit = limit;
+    w.lo = PyMem_RawCalloc(threads, sizeof(mpz_t));
+    w.temp = PyMem_RawCalloc(threads, sizeof(mpz_t));
+    w.flags = PyMem_RawCalloc(threads, sizeof(unsigned char*));
+    w.found = PyMem_RawCalloc(threads, sizeof(unsigned int*));
+    w.nfound = PyMem_RawCalloc(threads, sizeof(Py_ssize_t));
+    mpz_init(w.start);
+    _GMPy_MPZ_Set_UInt64(w.start, x0);
+    if (!w.down)
+        mpz_add_ui(w.start, w.start, mpz_even_p(w.start) ? 1 : 2);
+    else if (mpz_even_p(w.start))
+        mpz_sub_ui(w.start, w.start, 1);
+
+    if (!w.lo || !w.temp || !w.flags || !w.found || !w.nfound)
+        goto done;
+    for (; ready < threads; ready++) {
+        if (!(w.flags[ready] = PyMem_RawMalloc(GMPY_SIEVE_SEGMENT)) ||
+            !(w.found[ready] = PyMem_RawMalloc(sizeof(unsigned int) * GMPY_SIEVE_SEGMENT))) {
+            PyMem_RawFree(w.flags[ready]);
+            goto done;
+        }
+        mpz_init(w.lo[ready]);
+        mpz_init(w.temp[ready]);
+    }
+
+    for (w.first = 0; ; w.first += threads) {
+        if (GMPy_Interrupt_Poll()) {
+            status = PRIME_PI_INTERRUPTED;
+            goto done;
+        }
+        GMPy_Parallel_Run(_GMPy_Prime_Scan_Range, &w, threads, threads);
+        for (j = 0; j < threads; j++) {
+            if (need <= (uint64_t)w.nfound[j]) {
+                mpz_add_ui(result, w.lo[j],
+                           w.found[j][w.down ? w.nfound[j] - (Py_ssize_t)need : (Py_ssize_t)need - 1]);
+                status = PRIME_PI_DONE;
+                goto done;
+            }
+            need -= (uint64_t)w.nfound[j];
+        }
+    }
+
+  done:
+    for (j = 0; j < ready; j++) {
+        PyMem_RawFree(w.flags[j]);
+        PyMem_RawFree(w.found[j]);
+        mpz_clear(w.lo[j]);
+        mpz_clear(w.temp[j]);
+    }
+    PyMem_RawFree(w.lo);
+    PyMem_RawFree(w.temp);
+    PyMem_RawFree(w.flags);
+    PyMem_RawFree(w.found);
+    PyMem_RawFree(w.nfound);
+    mpz_clear(w.start);
+    return status;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_nth_prime,
+"nth_prime(n, /) -> mpz\n\n"
+"Return the n-th prime, counting 2 as the first, for n <= prime_pi(2**64).\n"
+"The count of primes up to an estimate of the n-th prime is found as by\n"
+"prime_pi() and the primes between the estimate and the n-th prime are\n"
+"counted with a segmented sieve. Will always release the GIL unless the\n"
+"square root of the n-th prime is less than the context's\n"
+"release_gil_min_bits; the segments are split over the number of threads\n"
+"given by the context's threads.");
+
+static PyObject *
+GMPy_MPZ_Function_NthPrime(PyObject *self, PyObject *other)
+{
+    MPZ_Object *tempn, *result = NULL;
+    gmpy_interrupt intr;
+    unsigned long *primes = NULL, bound;
+    unsigned int *base = NULL;
+    Py_ssize_t i, count = 0;
+    uint64_t n, x0, c = 0;
+    int threads, status;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_INTEGER(other)) {
+        TYPE_ERROR("nth_prime() requires an integer argument");
+        return NULL;
+    }
+    if (GMPy_Sieve_Init() < 0)
+        return NULL;
+    if (!(tempn = GMPy_MPZ_From_Integer(other, context)))
+        return NULL;
+    if (mpz_sgn(tempn->z) <= 0) {
+        VALUE_ERROR("nth_prime() requires n > 0");
+        Py_DECREF((PyObject*)tempn);
+        return NULL;
+    }
+    if (mpz_sizeinbase(tempn->z, 2) > 64 ||
+        (n = _GMPy_MPZ_Get_UInt64(tempn->z)) > GMPY_PRIME_PI_U64) {
+        VALUE_ERROR("nth_prime() requires n <= prime_pi(2**64)");
+        Py_DECREF((PyObject*)tempn);
+        return NULL;
+    }
+    Py_DECREF((PyObject*)tempn);
+
+    if (!(result = GMPy_MPZ_New(context)))
+        return NULL;
+    if (n <= (uint64_t)sieve_nprimes + 1) {
+        mpz_set_ui(result->z, n == 1 ? 2 : sieve_primes[n - 2]);
+        return (PyObject*)result;
+    }
+
+    /* Every odd prime below the bound is a base prime. */
+
+    x0 = _GMPy_Nth_Prime_Estimate(n);
+    bound = (unsigned long)_GMPy_U64_Sqrt(x0 + x0 / 8);
+    if (bound > GMPY_NTH_PRIME_BASE)
+        bound = GMPY_NTH_PRIME_BASE;
+    if (!(primes = _GMPy_Sieve_Primes(bound, &count)))
+        goto error;
+    if (!(base = PyMem_New(unsigned int, count))) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    for (i = 1; i < count; i++)
+        base[i - 1] = (unsigned int)primes[i];
+
+    GMPY_PROFILE_OPN(context, GMPY_OP_PRP, 64, 1);
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, _GMPy_U64_Sqrt(x0));
+    intr.save = &_save;
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+    status = _GMPy_Prime_Pi(&c, x0, threads);
+    if (status == PRIME_PI_DONE)
+        status = _GMPy_Nth_Prime_Scan(result->z, n, x0, c, base, count - 1,
+                                      bound + 1, threads);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (GMPy_Interrupt_End(&intr) < 0)
+        goto error;
+    if (status == PRIME_PI_NOMEM) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    PyMem_Free(primes);
+    PyMem_Free(base);
+    return (PyObject*)result;
+
+  error:
+    PyMem_Free(primes);
+    PyMem_Free(base);
+    Py_DECREF((PyObject*)result);
+    return NULL;
+}
+
+/* Random primes.
+ *
+ * Below GMPY_RANDOM_PRIME_SMALL bits, random values are tested until one
+ * is prime. Above, an attempt sieves a window of at most
+ * GMPY_RANDOM_PRIME_WINDOW candidates, drawn uniformly from the windows
+ * that tile [2**(bits-1), 2**bits), by sieve_primes and tests the
+ * survivors in a random order with BPSW. The probability of a prime then
+ * depends on the number of primes in its window, not on the gap before it
+ * as with next_prime(). For a safe prime p = 2*q + 1, the candidates are
+ * the p = 3 (mod 4), a base prime r also removes the p = 1 (mod r) where r
+ * divides q, and a survivor is tested with a Fermat test of p to base 2
+ * before q and p are tested with BPSW.
+ *
+ * Each prime has its own stream, seeded from the random_state, and each
+ * attempt is seeded from the stream, so the attempts of one prime can run
+ * in parallel and the results do not depend on the number of threads.
+ */
+
+enum {
+    RANDOM_PRIME_FOUND = 0,
+    RANDOM_PRIME_NONE = 1,
+    RANDOM_PRIME_NOMEM = -1,
+    RANDOM_PRIME_INTERRUPTED = -2
+};
+
+typedef struct {
+    unsigned char *flags;
+    unsigned int *index;
+    mpz_t base, c, q, t;
+    gmp_randstate_t attempt;
+} gmpy_prime_window;
+
+static int
+_GMPy_Prime_Window_Init(gmpy_prime_window *w, gmp_randstate_t proto)
+{
+    w->flags = PyMem_RawMalloc(GMPY_RANDOM_PRIME_WINDOW);
+    w->index = PyMem_RawMalloc(sizeof(unsigned int) * GMPY_RANDOM_PRIME_WINDOW);
+    if (!w->flags || !w->index) {
+        PyMem_RawFree(w->flags);
+        PyMem_RawFree(w->index);
+        return -1;
+    }
+    mpz_init(w->base);
+    mpz_init(w->c);
+    mpz_init(w->q);
+    mpz_init(w->t);
+    gmp_randinit_set(w->attempt, proto);
+    return 0;
+}
+
+static void
+_GMPy_Prime_Window_Clear(gmpy_prime_window *w)
+{
+    PyMem_RawFree(w->flags);
+    PyMem_RawFree(w->index);
+    mpz_clear(w->base);
+    mpz_clear(w->c);
+    mpz_clear(w->q);
+    mpz_clear(w->t);
+    gmp_randclear(w->attempt);
+}
+
+static int
+_GMPy_Random_Prime_Small(mpz_ptr result, gmp_randstate_t state,
+                         gmpy_prime_window *w, unsigned long bits, int safe)
+{
+    for (;;) {
+        if (GMPy_Interrupt_Poll())
+            return RANDOM_PRIME_INTERRUPTED;
+        mpz_urandomb(w->c, state, bits - 1);
+        mpz_setbit(w->c, bits - 1);
+        if (!_GMPy_MPZ_IsPrime(w->c, 25))
+            continue;
+        if (safe) {
+            mpz_fdiv_q_2exp(w->q, w->c, 1);
+            if (!_GMPy_MPZ_IsPrime(w->q, 25))
+                continue;
+        }
+        mpz_set(result, w->c);
+        return RANDOM_PRIME_FOUND;
+    }
+}
+
+/* One attempt with the state w->attempt. */
+
+static int
+_GMPy_Random_Prime_Attempt(mpz_ptr result, gmpy_prime_window *w,
+                           unsigned long bits, int safe)
+{
+    unsigned long step = safe ? 4 : 2, r, rem, inv, j;
+    Py_ssize_t i, len, n = 0;
+
+    /* Candidate i of window k is 2**(bits-1) + step * (k * WINDOW + i) +
+     * (safe ? 3 : 1); there are 2**(bits-1) / step candidates.
+     */
+
+    mpz_set_ui(w->t, 0);
+    mpz_setbit(w->t, bits - (safe ? 3 : 2));
+    mpz_cdiv_q_ui(w->q, w->t, GMPY_RANDOM_PRIME_WINDOW);
+    mpz_urandomm(w->q, w->attempt, w->q);
+    mpz_mul_ui(w->q, w->q, GMPY_RANDOM_PRIME_WINDOW);
+    mpz_sub(w->t, w->t, w->q);
+    len = GMPY_RANDOM_PRIME_WINDOW;
+    if (mpz_cmp_ui(w->t, GMPY_RANDOM_PRIME_WINDOW) < 0)
+        len = (Py_ssize_t)mpz_get_ui(w->t);
+    mpz_mul_ui(w->base, w->q, step);
+    mpz_setbit(w->base, bits - 1);
+    mpz_add_ui(w->base, w->base, step - 1);
+
+    memset(w->flags, 0, len);
+    for (i = 0; i < sieve_nprimes; i++) {
+        r = sieve_primes[i];
+        rem = mpz_fdiv_ui(w->base, r);
+        inv = (r + 1) / 2;
+        if (safe)
+            inv = inv * inv % r;
+        /* base + step * j = 0 (mod r) */
+        for (j = (r - rem) % r * inv % r; j < (unsigned long)len; j += r)
+            w->flags[j] = 1;
+        if (!safe)
+            continue;
+        /* base + step * j = 1 (mod r), so r divides q */
+        for (j = (r + 1 - rem) % r * inv % r; j < (unsigned long)len; j += r)
+            w->flags[j] = 1;
+    }
+    for (i = 0; i < len; i++) {
+        if (!w->flags[i])
+            w->index[n++] = (unsigned int)i;
+    }
+
+    while (n > 0) {
+        if (GMPy_Interrupt_Poll())
+            return RANDOM_PRIME_INTERRUPTED;
+        j = gmp_urandomm_ui(w->attempt, (unsigned long)n);
+        mpz_add_ui(w->c, w->base, step * w->index[j]);
+        w->index[j] = w->index[--n];
+        if (safe) {
+            mpz_sub_ui(w->q, w->c, 1);
+            mpz_set_ui(w->t, 2);
+            mpz_powm(w->t, w->t, w->q, w->c);
+            if (mpz_cmp_ui(w->t, 1) != 0)
+                continue;
+            mpz_fdiv_q_2exp(w->q, w->q, 1);
+            if (_GMPy_MPZ_BPSW_PRP(w->q) != 1)
+                continue;
+        }
+        if (_GMPy_MPZ_BPSW_PRP(w->c) == 1) {
+            mpz_set(result, w->c);
+            return RANDOM_PRIME_FOUND;
+        }
+    }
+    return RANDOM_PRIME_NONE;
+}
+
+/* Find a prime from the stream seeded by seed, one attempt at a time. */
+
+static int
+_GMPy_Random_Prime_Next(mpz_ptr result, mpz_srcptr seed, gmpy_prime_window *w,
+                        unsigned long bits, int safe)
+{
+    gmp_randstate_t stream;
+    int status;
+
+    gmp_randinit_set(stream, w->attempt);
+    gmp_randseed(stream, seed);
+    if (bits < GMPY_RANDOM_PRIME_SMALL) {
+        status = _GMPy_Random_Prime_Small(result, stream, w, bits, safe);
+    }
+    else {
+        do {
+            mpz_urandomb(w->t, stream, GMPY_RANDOM_PRIME_SEED);
+            gmp_randseed(w->attempt, w->t);
+            status = _GMPy_Random_Prime_Attempt(result, w, bits, safe);
+        } while (status == RANDOM_PRIME_NONE);
+    }
+    gmp_randclear(stream);
+    return status;
+}
+
+typedef struct {
+    unsigned long bits;
+    int safe;
+    gmp_randstate_t *proto;
+    mpz_t *seeds;           /* per prime, or per attempt of a batch */
+    mpz_ptr *results;
+    gmpy_prime_window *windows;
+    int *status;
+} gmpy_random_prime;
+
+static void
+_GMPy_Random_Prime_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_random_prime *job = (gmpy_random_prime*)arg;
+    gmpy_prime_window w;
+    Py_ssize_t k;
+
+    if (_GMPy_Prime_Window_Init(&w, *job->proto) < 0) {
+        for (k = start; k < stop; k++)
+            job->status[k] = RANDOM_PRIME_NOMEM;
+        return;
+    }
+    for (k = start; k < stop; k++)
+        job->status[k] = _GMPy_Random_Prime_Next(job->results[k], job->seeds[k],
+                                                 &w, job->bits, job->safe);
+    _GMPy_Prime_Window_Clear(&w);
+}
+
+static void
+_GMPy_Random_Prime_Batch(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_random_prime *job = (gmpy_random_prime*)arg;
+    Py_ssize_t j;
+
+    for (j = start; j < stop; j++) {
+        gmp_randseed(job->windows[j].attempt, job->seeds[j]);
+        job->status[j] = _GMPy_Random_Prime_Attempt(job->results[j], &job->windows[j],
+                                                    job->bits, job->safe);
+    }
+}
+
+/* Find one prime with the attempts split over the threads. The attempts
+ * are seeded in the order _GMPy_Random_Prime_Next() uses and the first
+ * successful one is kept, so the prime is the same.
+ */
+
+static int
+_GMPy_Random_Prime_Parallel(mpz_ptr result, mpz_srcptr seed, gmp_randstate_t proto,
+                            unsigned long bits, int safe, int threads)
+{
+    gmpy_random_prime job;
+    gmp_randstate_t stream;
+    Py_ssize_t j, ready = 0;
+    int status = RANDOM_PRIME_NOMEM;
+
+    job.bits = bits;
+    job.safe = safe;
+    job.seeds = PyMem_RawCalloc(threads, sizeof(mpz_t));
+    job.results = PyMem_RawCalloc(threads, sizeof(mpz_ptr));
+    job.windows = PyMem_RawCalloc(threads, sizeof(gmpy_prime_window));
+    job.status = PyMem_RawCalloc(threads, sizeof(int));
+    gmp_randinit_set(stream, proto);
+    gmp_randseed(stream, seed);
+    if (!job.seeds || !job.results || !job.windows || !job.status)
+        goto done;
+    for (; ready < threads; ready++) {
+        if (_GMPy_Prime_Window_Init(&job.windows[ready], proto) < 0)
+            goto done;
+        mpz_init(job.seeds[ready]);
+        job.results[ready] = job.windows[ready].c;
+    }
+
+    for (;;) {
+        for (j = 0; j < threads; j++)
+            mpz_urandomb(job.seeds[j], stream, GMPY_RANDOM_PRIME_SEED);
+        GMPy_Parallel_Run(_GMPy_Random_Prime_Batch, &job, threads, threads);
+        for (j = 0; j < threads; j++) {
+            if (job.status[j] != RANDOM_PRIME_NONE) {
+                status = job.status[j];
+                if (status == RANDOM_PRIME_FOUND)
+                    mpz_set(result, job.results[j]);
+                goto done;
+            }
+        }
+    }
+
+  done:
+    for (j = 0; j < ready; j++) {
+        _GMPy_Prime_Window_Clear(&job.windows[j]);
+        mpz_clear(job.seeds[j]);
+    }
+    PyMem_RawFree(job.seeds);
+    PyMem_RawFree(job.results);
+    PyMem_RawFree(job.windows);
+    PyMem_RawFree(job.status);
+    gmp_randclear(stream);
+    return status;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_random_prime,
+"random_prime(random_state, bits, /, safe=False, count=None) -> mpz | list\n\n"
+"Return a random prime of exactly bits bits, or a safe prime p, for which\n"
+"(p - 1) // 2 is also prime, if safe is True. With count=n a list of n\n"
+"primes is returned. A random window of candidates is sieved by the primes\n"
+"below 65536, both for p and for (p - 1) // 2 if safe is True, and the\n"
+"survivors are tested in a random order with the BPSW test. Values above\n"
+"2**64 are *probable* primes. Will always release the GIL unless bits *\n"
+"count is less than the context's release_gil_min_bits. The primes, or\n"
+"the windows for a single prime above 18 bits, are split over the number\n"
+"of threads given by the context's threads; the result does not depend on\n"
+"it.");
+
+static PyObject *
+GMPy_MPZ_Function_RandomPrime(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "", "safe", "count", NULL};
+    PyObject *state, *bitsobj, *count = Py_None, *result = NULL;
+    PyObject **items = NULL;
+    gmpy_random_prime job;
+    gmpy_interrupt intr;
+    gmp_randstate_t local;
+    unsigned long bits;
+    Py_ssize_t k, n = 1;
+    int safe = 0, threads, status = RANDOM_PRIME_FOUND;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO|pO", kwlist,
+                                     &state, &bitsobj, &safe, &count))
+        return NULL;
+    if (!RandomState_Check(state)) {
+        TYPE_ERROR("random_prime() requires 'random_state' and 'bits' arguments");
+        return NULL;
+    }
+    bits = GMPy_Integer_AsUnsignedLongWithType(bitsobj, GMPy_ObjectType(bitsobj));
+    if (bits == (unsigned long)(-1) && PyErr_Occurred())
+        return NULL;
+    if (bits < (safe ? 3UL : 2UL)) {
+        VALUE_ERROR(safe ? "random_prime() requires bits >= 3 for a safe prime"
+                         : "random_prime() requires bits >= 2");
+        return NULL;
+    }
+    if (count != Py_None) {
+        n = PyNumber_AsSsize_t(count, PyExc_OverflowError);
+        if (n == -1 && PyErr_Occurred())
+            return NULL;
+        if (n < 0) {
+            VALUE_ERROR("random_prime() requires count >= 0");
+            return NULL;
+        }
+    }
+    if (GMPy_Sieve_Init() < 0)
+        return NULL;
+
+    job.bits = bits;
+    job.safe = safe;
+    job.proto = &local;
+    job.seeds = PyMem_New(mpz_t, n ? n : 1);
+    job.results = PyMem_New(mpz_ptr, n ? n : 1);
+    job.status = PyMem_New(int, n ? n : 1);
+    if (!(items = PyMem_New(PyObject*, n ? n : 1)) ||
+        !job.seeds || !job.results || !job.status) {
+        PyMem_Free(items);
+        PyMem_Free(job.seeds);
+        PyMem_Free(job.results);
+        PyMem_Free(job.status);
+        return PyErr_NoMemory();
+    }
+    for (k = 0; k < n; k++)
+        items[k] = NULL;
+    for (k = 0; k < n; k++) {
+        if (!(items[k] = (PyObject*)GMPy_MPZ_New(context)))
+            goto done;
+        job.results[k] = MPZ(items[k]);
+    }
+
+    /* Only the seeds are drawn from the random_state. */
+
+    gmp_randinit_set(local, RANDOM_STATE(state));
+    for (k = 0; k < n; k++) {
+        mpz_init(job.seeds[k]);
+        mpz_urandomb(job.seeds[k], local, GMPY_RANDOM_PRIME_SEED);
+    }
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits * (size_t)n);
+    intr.save = &_save;
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+    if (count == Py_None && threads > 1 && bits >= GMPY_RANDOM_PRIME_SMALL) {
+        status = _GMPy_Random_Prime_Parallel(job.results[0], job.seeds[0], local,
+                                             bits, safe, threads);
+    }
+    else {
+        GMPy_Parallel_Run(_GMPy_Random_Prime_Range, &job, n, threads);
+        for (k = 0; k < n && status == RANDOM_PRIME_FOUND; k++)
+            status = job.status[k];
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    gmp_randclear(RANDOM_STATE(state));
+    gmp_randinit_set(RANDOM_STATE(state), local);
+    gmp_randclear(local);
+    for (k = 0; k < n; k++)
+        mpz_clear(job.seeds[k]);
+
+    if (GMPy_Interrupt_End(&intr) < 0)
+        goto done;
+    if (status == RANDOM_PRIME_NOMEM) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    if (count == Py_None) {
+        result = items[0];
+        items[0] = NULL;
+    }
+    else if ((result = PyList_New(n))) {
+        for (k = 0; k < n; k++) {
+            PyList_SET_ITEM(result, k, items[k]);
+            items[k] = NULL;
+        }
+    }
+
+  done:
+    for (k = 0; k < n; k++)
+        Py_XDECREF(items[k]);
+    PyMem_Free(items);
+    PyMem_Free(job.seeds);
+    PyMem_Free(job.results);
+    PyMem_Free(job.status);
+    return result;
+}
@@ -0,0 +1,112 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_sieve.h                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_SIEVE_H
+#define GMPY_SIEVE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The odd primes below GMPY_SIEVE_PRIMES_LIMIT are computed once when the
+ * module is loaded. They are used for trial division and as the base
+ * primes of the segmented sieve.
+ */
+
+#define GMPY_SIEVE_PRIMES_LIMIT 65536
+#define GMPY_SIEVE_TRIAL_LIMIT 8192
+
+/* Number of odd numbers in one segment of the segmented sieve. */
+
+#define GMPY_SIEVE_SEGMENT 131072
+
+/* prime_pi() splits a round over the threads when it updates at least
+ * this many values.
+ */
+
+#define GMPY_PRIME_PI_PARALLEL 65536
+
+/* nth_prime() sieves by the primes up to this bound. */
+
+#define GMPY_NTH_PRIME_BASE (32 * GMPY_SIEVE_SEGMENT)
+
+/* random_prime() tests random values directly below this many bits and
+ * sieves windows of GMPY_RANDOM_PRIME_WINDOW candidates above. Every
+ * stream and attempt is seeded with GMPY_RANDOM_PRIME_SEED random bits.
+ */
+
+#define GMPY_RANDOM_PRIME_SMALL 18
+#define GMPY_RANDOM_PRIME_WINDOW 65536
+#define GMPY_RANDOM_PRIME_SEED 128
+
+/* Results of _GMPy_Sieve_Trial(). */
+
+#define GMPY_TRIAL_COMPOSITE 0
+#define GMPY_TRIAL_PRIME     1
+#define GMPY_TRIAL_UNKNOWN   2
+
+/* An iter_primes holds the primes found in the current segment as offsets
+ * from its first value lo.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    mpz_t lo;               /* first value of the current segment, odd */
+    mpz_t stop;
+    int has_stop;
+    int two;                /* 2 has not been returned yet */
+    Py_ssize_t seglen;      /* odd numbers in the current segment */
+    unsigned char *flags;
+    unsigned int *found;
+    Py_ssize_t nfound;
+    Py_ssize_t index;       /* next entry of found */
+} PrimeIter_Object;
+
+static PyTypeObject PrimeIter_Type;
+
+static int GMPy_Sieve_Init(void);
+static int _GMPy_Sieve_Trial(mpz_srcptr n);
+static unsigned long * _GMPy_Sieve_Primes(unsigned long B, Py_ssize_t *count);
+
+/* Primality with a word-size path for n < 2**64; see gmpy2_sieve.c. */
+
+static int _GMPy_MPZ_IsPrime(mpz_srcptr n, int reps);
+static void _GMPy_MPZ_NextPrime(mpz_ptr r, mpz_srcptr n);
+#if (__GNU_MP_VERSION > 6) || (__GNU_MP_VERSION == 6 &&  __GNU_MP_VERSION_MINOR >= 3)
+static int _GMPy_MPZ_PrevPrime(mpz_ptr r, mpz_srcptr n);
+#endif
+
+static PyObject * GMPy_MPZ_Function_IsPrimeList(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_IsBPSWPrpList(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_PrimeRange(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_PrimePi(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_NthPrime(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_RandomPrime(PyObject *self, PyObject *args, PyObject *keywds);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,392 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_special.c                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Lucas-Lehmer, Proth, and Lucas-Lehmer-Riesel tests.
+ *
+ * Each test squares a residue modulo N = k*2**n + c about n times. With
+ * x = h*2**n + l and h = q*k + r, x = q*N + r*2**n + l - c*q, so x is
+ * reduced by replacing it with x - q*k*2**n - c*q, which needs only
+ * shifts, a multiplication and a division by k, and additions. Values of
+ * N below 2**64 are tested with _GMPy_MPZ_IsPrime() instead.
+ */
+
+static void
+_GMPy_Special_Init(gmpy_special_form *f, unsigned long k, mp_bitcnt_t n, int c)
+{
+    f->k = k;
+    f->n = n;
+    f->c = c;
+    mpz_init(f->N);
+    mpz_init(f->t);
+    mpz_init(f->u);
+    mpz_set_ui(f->N, k);
+    f->bits = n + mpz_sizeinbase(f->N, 2);
+    mpz_mul_2exp(f->N, f->N, n);
+    if (c > 0)
+        mpz_add_ui(f->N, f->N, 1);
+    else
+        mpz_sub_ui(f->N, f->N, 1);
+}
+
+static void
+_GMPy_Special_Clear(gmpy_special_form *f)
+{
+    mpz_clear(f->N);
+    mpz_clear(f->t);
+    mpz_clear(f->u);
+}
+
+/* Set x to x mod N for any x with fewer than about 2*f->bits bits. */
+
+static void
+_GMPy_Special_Reduce(gmpy_special_form *f, mpz_ptr x)
+{
+    /* Each step leaves x with about f->bits bits; then |x| < 2*N. */
+
+    while (mpz_sizeinbase(x, 2) > f->bits) {
+        mpz_fdiv_q_2exp(f->t, x, f->n);
+        if (f->k == 1) {
+            mpz_fdiv_r_2exp(x, x, f->n);
+        }
+        else {
+            mpz_fdiv_q_ui(f->t, f->t, f->k);
+            mpz_mul_ui(f->u, f->t, f->k);
+            mpz_mul_2exp(f->u, f->u, f->n);
+            mpz_sub(x, x, f->u);
+        }
+        if (f->c > 0)
+            mpz_sub(x, x, f->t);
+        else
+            mpz_add(x, x, f->t);
+    }
+    while (mpz_sgn(x) < 0)
+        mpz_add(x, x, f->N);
+    while (mpz_cmp(x, f->N) >= 0)
+        mpz_sub(x, x, f->N);
+}
+
+/* Call the callback, taking the GIL back if it was released. Unless force
+ * is set, nothing is done before prog->next. Returns -1 with an exception
+ * set if the callback raised one.
+ */
+
+static int
+_GMPy_Progress_Report(gmpy_progress *prog, int force)
+{
+    PyThreadState **save = prog->save;
+    PyObject *result;
+    long long now;
+
+    if (!prog->callback)
+        return 0;
+    if (!force) {
+        now = GMPy_Monotonic();
+        if (now < prog->next)
+            return 0;
+        prog->next = now + GMPY_PROGRESS_NS;
+    }
+
+    if (save && *save)
+        PyEval_RestoreThread(*save);
+    result = PyObject_CallFunction(prog->callback, "KK",
+                                   (unsigned long long)prog->done,
+                                   (unsigned long long)prog->total);
+    Py_XDECREF(result);
+    if (save && *save)
+        *save = PyEval_SaveThread();
+    return result ? 0 : -1;
+}
+
+/* Replace x by x**2 - sub mod N until prog->done reaches prog->total.
+ * Returns -1 if the computation was interrupted or the callback raised an
+ * exception.
+ */
+
+static int
+_GMPy_Special_Square(gmpy_special_form *f, mpz_ptr x, unsigned long sub,
+                     gmpy_progress *prog)
+{
+    while (prog->done < prog->total) {
+        mpz_mul(x, x, x);
+        if (sub)
+            mpz_sub_ui(x, x, sub);
+        _GMPy_Special_Reduce(f, x);
+        prog->done++;
+        if (!(prog->done & 15) &&
+            (GMPy_Interrupt_Poll() || _GMPy_Progress_Report(prog, 0) < 0))
+            return -1;
+    }
+    return 0;
+}
+
+#define GMPY_SPECIAL_MERSENNE 0
+#define GMPY_SPECIAL_PROTH 1
+#define GMPY_SPECIAL_LLR 2
+
+static const char *special_names[] = {
+    "is_mersenne_prime", "is_proth_prime", "is_llr_prime"
+};
+
+/* Set x to the starting value of the test and prog->total to the number
+ * of squarings. Returns 0 if N is proven composite, 1 to continue.
+ */
+
+static int
+_GMPy_Special_Start(int which, gmpy_special_form *f, mpz_ptr x,
+                    gmpy_progress *prog)
+{
+    unsigned long a, i;
+    int j1, j2;
+
+    switch (which) {
+    case GMPY_SPECIAL_MERSENNE:
+        /* s_0 = 4 and s_{i+1} = s_i**2 - 2; N is prime iff s_{n-2} = 0. */
+        mpz_set_ui(x, 4);
+        prog->total = f->n - 2;
+        return 1;
+
+    case GMPY_SPECIAL_PROTH:
+        /* N is prime iff a**((N-1)/2) = -1 for any a with (a/N) = -1. A
+         * square has no such a.
+         */
+        for (a = 3; ; a++) {
+            j1 = mpz_ui_kronecker(a, f->N);
+            if (j1 == -1)
+                break;
+            if (j1 == 0 || (a == 64 && mpz_perfect_square_p(f->N)))
+                return 0;
+        }
+        mpz_set_ui(x, a);
+        mpz_powm_ui(x, x, f->k, f->N);
+        prog->total = f->n - 1;
+        return 1;
+
+    default:
+        /* Rodseth: u_0 = V_k(P, 1) for P with ((P-2)/N) = 1 and
+         * ((P+2)/N) = -1; N is prime iff u_{n-2} = 0. N = 3 mod 4 is not
+         * a square, so P exists.
+         */
+        for (a = 3; ; a++) {
+            j1 = mpz_ui_kronecker(a - 2, f->N);
+            j2 = mpz_ui_kronecker(a + 2, f->N);
+            if (j1 == 0 || j2 == 0)
+                return 0;
+            if (j1 == 1 && j2 == -1)
+                break;
+        }
+
+        /* V_k by the chain (V_m, V_{m+1}) -> (V_2m, V_2m+1) or
+         * (V_2m+1, V_2m+2) over the bits of k.
+         */
+        mpz_set_ui(x, a);
+        mpz_set_ui(f->t, a);
+        mpz_mul(f->t, f->t, f->t);
+        mpz_sub_ui(f->t, f->t, 2);
+        for (i = f->bits - f->n - 1; i-- > 0; ) {
+            if ((f->k >> i) & 1) {
+                mpz_mul(x, x, f->t);
+                mpz_sub_ui(x, x, a);
+                mpz_mod(x, x, f->N);
+                mpz_mul(f->t, f->t, f->t);
+                mpz_sub_ui(f->t, f->t, 2);
+                mpz_mod(f->t, f->t, f->N);
+            }
+            else {
+                mpz_mul(f->t, f->t, x);
+                mpz_sub_ui(f->t, f->t, a);
+                mpz_mod(f->t, f->t, f->N);
+                mpz_mul(x, x, x);
+                mpz_sub_ui(x, x, 2);
+                mpz_mod(x, x, f->N);
+            }
+        }
+        mpz_mod(x, x, f->N);
+        prog->total = f->n - 2;
+        return 1;
+    }
+}
+
+static PyObject *
+_GMPy_Special_Test(int which, unsigned long k, mp_bitcnt_t n,
+                   PyObject *callback)
+{
+    gmpy_special_form f;
+    gmpy_progress prog;
+    gmpy_interrupt intr;
+    mpz_t x;
+    int res, err = 0;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (callback == Py_None)
+        callback = NULL;
+    if (callback && !PyCallable_Check(callback)) {
+        PyErr_Format(PyExc_TypeError, "%s() callback must be callable",
+                     special_names[which]);
+        return NULL;
+    }
+
+    /* k*2**n + c with k even is (k/2)*2**(n+1) + c. */
+
+    while (k && !(k & 1)) {
+        k >>= 1;
+        n++;
+    }
+    if (which != GMPY_SPECIAL_MERSENNE && (!k || (n < 8 * sizeof(unsigned long) && k >> n))) {
+        PyErr_Format(PyExc_ValueError, "%s() requires 0 < k < 2**n",
+                     special_names[which]);
+        return NULL;
+    }
+    if (which == GMPY_SPECIAL_MERSENNE && n < 2)
+        Py_RETURN_FALSE;
+
+    _GMPy_Special_Init(&f, k, n, which == GMPY_SPECIAL_PROTH ? 1 : -1);
+    mpz_init(x);
+
+    /* The Lucas-Lehmer test requires a prime exponent. */
+
+    if (which == GMPY_SPECIAL_MERSENNE && n > 2) {
+        mpz_set_ui(x, n);
+        if (!_GMPy_MPZ_IsPrime(x, 25)) {
+            res = 0;
+            goto done;
+        }
+    }
+    if (f.bits <= 64) {
+        res = _GMPy_MPZ_IsPrime(f.N, 25) != 0;
+        goto done;
+    }
+
+    prog.callback = callback;
+    prog.save = NULL;
+    prog.done = 0;
+    prog.next = GMPy_Monotonic() + GMPY_PROGRESS_NS;
+    if (!(res = _GMPy_Special_Start(which, &f, x, &prog)))
+        goto done;
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, f.bits);
+    intr.save = &_save;
+    prog.save = &_save;
+    err = _GMPy_Special_Square(&f, x, which == GMPY_SPECIAL_PROTH ? 0 : 2, &prog);
+    prog.save = NULL;
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    if (GMPy_Interrupt_End(&intr) < 0 || err < 0 ||
+        _GMPy_Progress_Report(&prog, 1) < 0) {
+        mpz_clear(x);
+        _GMPy_Special_Clear(&f);
+        return NULL;
+    }
+
+    if (which == GMPY_SPECIAL_PROTH) {
+        mpz_add_ui(x, x, 1);
+        res = mpz_cmp(x, f.N) == 0;
+    }
+    else {
+        res = mpz_sgn(x) == 0;
+    }
+
+  done:
+    mpz_clear(x);
+    _GMPy_Special_Clear(&f);
+    return PyBool_FromLong(res);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_is_mersenne_prime,
+"is_mersenne_prime(p, /, *, callback=None) -> bool\n\n"
+"Return `True` if 2**p - 1 is prime, else `False`. The Lucas-Lehmer test\n"
+"is used, with residues reduced by shifts and additions; the result is\n"
+"exact. The GIL is released unless 2**p - 1 is smaller than the\n"
+"context's release_gil_min_bits. If callback is given, it is called\n"
+"with (done, total) about once a second and when the test finishes.");
+
+static PyObject *
+GMPy_MPZ_Function_IsMersennePrime(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"", "callback", NULL};
+    PyObject *p, *callback = Py_None;
+    mp_bitcnt_t n;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$O", kwlist, &p, &callback))
+        return NULL;
+
+    n = GMPy_Integer_AsMpBitCnt(p);
+    if (n == (mp_bitcnt_t)(-1) && PyErr_Occurred())
+        return NULL;
+
+    return _GMPy_Special_Test(GMPY_SPECIAL_MERSENNE, 1, n, callback);
+}
+
+/* Parse (k, n) for is_proth_prime() and is_llr_prime(). */
+
+static PyObject *
+_GMPy_Special_KN(int which, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"", "", "callback", NULL};
+    PyObject *k, *n, *callback = Py_None;
+    unsigned long kk;
+    mp_bitcnt_t nn;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|$O", kwlist, &k, &n, &callback))
+        return NULL;
+
+    kk = GMPy_Integer_AsUnsignedLong(k);
+    if (kk == (unsigned long)(-1) && PyErr_Occurred())
+        return NULL;
+    nn = GMPy_Integer_AsMpBitCnt(n);
+    if (nn == (mp_bitcnt_t)(-1) && PyErr_Occurred())
+        return NULL;
+
+    return _GMPy_Special_Test(which, kk, nn, callback);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_is_proth_prime,
+"is_proth_prime(k, n, /, *, callback=None) -> bool\n\n"
+"Return `True` if k*2**n + 1 is prime, else `False`; requires\n"
+"0 < k < 2**n. Proth's theorem is used, with residues reduced by shifts,\n"
+"a division by k, and additions; the result is exact. The GIL and the\n"
+"callback are handled as by is_mersenne_prime().");
+
+static PyObject *
+GMPy_MPZ_Function_IsProthPrime(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    return _GMPy_Special_KN(GMPY_SPECIAL_PROTH, args, kwargs);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_is_llr_prime,
+"is_llr_prime(k, n, /, *, callback=None) -> bool\n\n"
+"Return `True` if k*2**n - 1 is prime, else `False`; requires\n"
+"0 < k < 2**n. The Lucas-Lehmer-Riesel test is used, with the starting\n"
+"value found by Rodseth's method and residues reduced by shifts, a\n"
+"division by k, and additions; the result is exact. The GIL and the\n"
+"callback are handled as by is_mersenne_prime().");
+
+static PyObject *
+GMPy_MPZ_Function_IsLLRPrime(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    return _GMPy_Special_KN(GMPY_SPECIAL_LLR, args, kwargs);
+}
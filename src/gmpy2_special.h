@@ -0,0 +1,70 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_special.h                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_SPECIAL_H
+#define GMPY_SPECIAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Primality tests for numbers of the form N = k*2**n + c with c = 1 or -1
+ * and odd k < 2**n. Residues modulo N are reduced with shifts, a division
+ * by k, and additions instead of mpz_mod().
+ */
+
+typedef struct {
+    unsigned long k;        /* odd */
+    mp_bitcnt_t n;
+    int c;
+    mp_bitcnt_t bits;       /* n plus the bit length of k */
+    mpz_t N;
+    mpz_t t;                /* workspace */
+    mpz_t u;
+} gmpy_special_form;
+
+/* Progress of a test; the callback is called with (done, total) at most
+ * once every GMPY_PROGRESS_NS and once when the test finishes.
+ */
+
+#define GMPY_PROGRESS_NS 1000000000LL
+
+typedef struct {
+    PyObject *callback;     /* NULL for none */
+    PyThreadState **save;   /* GIL state of the caller; NULL if held */
+    mp_bitcnt_t done;
+    mp_bitcnt_t total;
+    long long next;         /* GMPy_Monotonic() time of the next call */
+} gmpy_progress;
+
+static PyObject * GMPy_MPZ_Function_IsMersennePrime(PyObject *self, PyObject *args, PyObject *kwargs);
+static PyObject * GMPy_MPZ_Function_IsProthPrime(PyObject *self, PyObject *args, PyObject *kwargs);
+static PyObject * GMPy_MPZ_Function_IsLLRPrime(PyObject *self, PyObject *args, PyObject *kwargs);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,532 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_sqrtmod.c                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Square roots modulo a prime p.
+ *
+ * With p - 1 = q * 2**s and q odd, the root is a**((p + 1) / 4) if s == 1,
+ * Atkin's formula with one exponentiation if s == 2, and Tonelli-Shanks
+ * otherwise. Tonelli-Shanks needs up to s**2 / 2 further multiplications,
+ * so Cipolla's method is used instead when s is large compared to the size
+ * of p. The exponents and the power of a non-residue depend only on p and
+ * are computed once for sqrt_mod_many(). Every root is checked before it
+ * is returned.
+ */
+
+/* Cipolla's method costs about three exponentiations. */
+
+#define GMPY_SQRTMOD_CIPOLLA(s, bits) ((s) * (s) > 8 * (bits))
+
+/* Returns -1 if p is found to be composite. p must be 2 or odd and > 2. */
+
+static int
+_GMPy_SqrtMod_Init(gmpy_sqrtmod *plan, mpz_srcptr p)
+{
+    mpz_t z;
+    unsigned long k;
+    int j;
+
+    mpz_init_set(plan->p, p);
+    mpz_init(plan->e);
+    mpz_init(plan->c);
+    plan->s = 0;
+    plan->cipolla = 0;
+
+    if (mpz_cmp_ui(p, 2) == 0)
+        return 0;
+
+    mpz_sub_ui(plan->e, p, 1);
+    plan->s = mpz_scan1(plan->e, 0);
+
+    if (plan->s == 1) {
+        mpz_add_ui(plan->e, p, 1);
+        mpz_fdiv_q_2exp(plan->e, plan->e, 2);
+        return 0;
+    }
+    if (plan->s == 2) {
+        mpz_sub_ui(plan->e, p, 5);
+        mpz_fdiv_q_2exp(plan->e, plan->e, 3);
+        return 0;
+    }
+    if (GMPY_SQRTMOD_CIPOLLA(plan->s, mpz_sizeinbase(p, 2))) {
+        plan->cipolla = 1;
+        mpz_add_ui(plan->e, p, 1);
+        mpz_fdiv_q_2exp(plan->e, plan->e, 1);
+        return 0;
+    }
+
+    /* A square has no non-residue, so the search would not end. */
+
+    if (mpz_perfect_square_p(p))
+        return -1;
+    for (k = 2; (j = mpz_ui_kronecker(k, p)) != -1; k++) {
+        if (j == 0)
+            return -1;
+    }
+
+    /* c = k**q and e = (q - 1) / 2. */
+
+    mpz_fdiv_q_2exp(plan->e, plan->e, plan->s);
+    mpz_init_set_ui(z, k);
+    mpz_powm(plan->c, z, plan->e, p);
+    mpz_clear(z);
+    mpz_fdiv_q_2exp(plan->e, plan->e, 1);
+    return 0;
+}
+
+static void
+_GMPy_SqrtMod_Clear(gmpy_sqrtmod *plan)
+{
+    mpz_clear(plan->p);
+    mpz_clear(plan->e);
+    mpz_clear(plan->c);
+}
+
+#define GMPY_SQRTMOD_TEMPS 5
+
+/* Set r to the smaller square root of a mod p. Returns -1 if no root is
+ * found. t is scratch space. Does not use the Python API.
+ */
+
+static int
+_GMPy_SqrtMod(const gmpy_sqrtmod *plan, mpz_ptr r, mpz_srcptr a,
+              mpz_t t[GMPY_SQRTMOD_TEMPS])
+{
+    mpz_srcptr p = plan->p;
+    mpz_ptr x = t[0], u = t[1], v = t[2], w = t[3], d = t[4];
+    mp_bitcnt_t m, i, j;
+    unsigned long k;
+    int jac;
+
+    mpz_mod(x, a, p);
+    if (mpz_sgn(x) == 0 || plan->s == 0) {
+        mpz_set(r, x);
+        return 0;
+    }
+
+    if (plan->s == 1) {
+        mpz_powm(r, x, plan->e, p);
+    }
+    else if (plan->s == 2) {
+        /* v = (2*a)**((p - 5) / 8), i = 2*a*v**2, and r = a*v*(i - 1). */
+        mpz_mul_2exp(u, x, 1);
+        mpz_powm(v, u, plan->e, p);
+        mpz_mul(w, v, v);
+        mpz_mul(w, w, u);
+        mpz_sub_ui(w, w, 1);
+        mpz_mod(w, w, p);
+        mpz_mul(r, x, v);
+        mpz_mod(r, r, p);
+        mpz_mul(r, r, w);
+        mpz_mod(r, r, p);
+    }
+    else if (plan->cipolla) {
+        /* Find k with d = k**2 - a a non-residue. Then r = (k + w)**e with
+         * e = (p + 1) / 2 in F_p[w] / (w**2 - d). u + v*w is the power.
+         */
+        for (k = 1; ; k++) {
+            if (mpz_cmp_ui(p, k) <= 0)
+                return -1;
+            mpz_set_ui(d, k);
+            mpz_mul_ui(d, d, k);
+            mpz_sub(d, d, x);
+            mpz_mod(d, d, p);
+            if (mpz_sgn(d) == 0) {
+                mpz_set_ui(r, k);
+                goto check;
+            }
+            if ((jac = mpz_jacobi(d, p)) == -1)
+                break;
+            if (jac == 0)
+                return -1;
+        }
+        mpz_set_ui(u, k);
+        mpz_set_ui(v, 1);
+        for (i = mpz_sizeinbase(plan->e, 2) - 1; i-- > 0; ) {
+            /* (u + v*w)**2 = u**2 + d*v**2 + 2*u*v*w */
+            mpz_mul(w, u, v);
+            mpz_mul_2exp(w, w, 1);
+            mpz_mul(u, u, u);
+            mpz_mul(v, v, v);
+            mpz_mul(v, v, d);
+            mpz_add(u, u, v);
+            mpz_mod(u, u, p);
+            mpz_mod(v, w, p);
+            if (mpz_tstbit(plan->e, i)) {
+                /* (u + v*w)*(k + w) = u*k + d*v + (u + k*v)*w */
+                mpz_mul(w, v, d);
+                mpz_mul_ui(r, v, k);
+                mpz_add(v, r, u);
+                mpz_mod(v, v, p);
+                mpz_mul_ui(u, u, k);
+                mpz_add(u, u, w);
+                mpz_mod(u, u, p);
+            }
+        }
+        mpz_set(r, u);
+    }
+    else {
+        /* Tonelli-Shanks with r = a**((q + 1) / 2), u = a**q, and w = c. */
+        mpz_powm(v, x, plan->e, p);
+        mpz_mul(r, v, x);
+        mpz_mod(r, r, p);
+        mpz_mul(u, r, v);
+        mpz_mod(u, u, p);
+        mpz_set(w, plan->c);
+        m = plan->s;
+        while (mpz_cmp_ui(u, 1) != 0) {
+            /* Find the least i with u**(2**i) == 1. */
+            mpz_set(v, u);
+            for (i = 0; i < m && mpz_cmp_ui(v, 1) != 0; i++) {
+                mpz_mul(v, v, v);
+                mpz_mod(v, v, p);
+            }
+            if (i >= m)
+                return -1;
+            for (j = m - i - 1; j > 0; j--) {
+                mpz_mul(w, w, w);
+                mpz_mod(w, w, p);
+            }
+            mpz_mul(r, r, w);
+            mpz_mod(r, r, p);
+            mpz_mul(w, w, w);
+            mpz_mod(w, w, p);
+            mpz_mul(u, u, w);
+            mpz_mod(u, u, p);
+            m = i;
+        }
+    }
+
+  check:
+    /* This also rejects non-residues and some composite p. */
+    mpz_mul(u, r, r);
+    mpz_mod(u, u, p);
+    if (mpz_cmp(u, x) != 0)
+        return -1;
+    mpz_sub(u, p, r);
+    if (mpz_cmp(u, r) < 0)
+        mpz_swap(r, u);
+    return 0;
+}
+
+/* Convert p and set up plan. Returns -1 and sets an exception on failure;
+ * plan is only initialized on success.
+ */
+
+static int
+_GMPy_SqrtMod_Plan(gmpy_sqrtmod *plan, PyObject *obj, const char *name,
+                   CTXT_Object *context)
+{
+    MPZ_Object *tempp;
+    int res;
+
+    if (!IS_INTEGER(obj)) {
+        PyErr_Format(PyExc_TypeError, "%s() requires integer arguments", name);
+        return -1;
+    }
+    if (!(tempp = GMPy_MPZ_From_Integer(obj, context)))
+        return -1;
+    if (mpz_cmp_ui(tempp->z, 2) < 0 ||
+        (mpz_even_p(tempp->z) && mpz_cmp_ui(tempp->z, 2) != 0)) {
+        PyErr_Format(PyExc_ValueError, "%s() p must be an odd prime or 2", name);
+        Py_DECREF((PyObject*)tempp);
+        return -1;
+    }
+    res = _GMPy_SqrtMod_Init(plan, tempp->z);
+    Py_DECREF((PyObject*)tempp);
+    if (res < 0) {
+        _GMPy_SqrtMod_Clear(plan);
+        PyErr_Format(PyExc_ValueError, "%s() p is not prime", name);
+        return -1;
+    }
+    return 0;
+}
+
+typedef struct {
+    const gmpy_sqrtmod *plan;
+    mpz_srcptr *x;
+    mpz_ptr *out;
+} gmpy_sqrtmod_batch;
+
+/* A value without a root is marked by setting its result to -1. */
+
+static void
+_GMPy_SqrtMod_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_sqrtmod_batch *work = (gmpy_sqrtmod_batch*)arg;
+    mpz_t t[GMPY_SQRTMOD_TEMPS];
+    Py_ssize_t i;
+    int k;
+
+    for (k = 0; k < GMPY_SQRTMOD_TEMPS; k++)
+        mpz_init(t[k]);
+    for (i = start; i < stop; i++) {
+        if (_GMPy_SqrtMod(work->plan, work->out[i], work->x[i], t) < 0)
+            mpz_set_si(work->out[i], -1);
+    }
+    for (k = 0; k < GMPY_SQRTMOD_TEMPS; k++)
+        mpz_clear(t[k]);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_sqrt_mod,
+"sqrt_mod(a, p, /) -> mpz\n\n"
+"Return the smaller square root r of a modulo the prime p, so that\n"
+"r*r = a mod p and 0 <= r <= p // 2. Raises ValueError if a is not a\n"
+"square mod p. The primality of p is not tested; for a composite p a\n"
+"ValueError may be raised even if a root exists, but a returned root is\n"
+"always correct.");
+
+static PyObject *
+GMPy_MPZ_Function_SqrtMod(PyObject *self, PyObject *args)
+{
+    gmpy_sqrtmod plan;
+    MPZ_Object *tempa, *result = NULL;
+    mpz_t t[GMPY_SQRTMOD_TEMPS];
+    CTXT_Object *context = NULL;
+    size_t bits;
+    int k, res;
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("sqrt_mod() requires 2 arguments");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_INTEGER(PyTuple_GET_ITEM(args, 0))) {
+        TYPE_ERROR("sqrt_mod() requires integer arguments");
+        return NULL;
+    }
+    if (!(tempa = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), context)))
+        return NULL;
+    if (_GMPy_SqrtMod_Plan(&plan, PyTuple_GET_ITEM(args, 1), "sqrt_mod", context) < 0) {
+        Py_DECREF((PyObject*)tempa);
+        return NULL;
+    }
+
+    if ((result = GMPy_MPZ_New(context))) {
+        for (k = 0; k < GMPY_SQRTMOD_TEMPS; k++)
+            mpz_init(t[k]);
+        bits = GMPY_MPZ_BITS(plan.p);
+        GMPY_PROFILE_MPZ(context, GMPY_OP_POWMOD, plan.p);
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits * bits);
+        res = _GMPy_SqrtMod(&plan, result->z, tempa->z, t);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+        for (k = 0; k < GMPY_SQRTMOD_TEMPS; k++)
+            mpz_clear(t[k]);
+        if (res < 0) {
+            VALUE_ERROR("sqrt_mod() no square root exists");
+            Py_CLEAR(result);
+        }
+    }
+
+    _GMPy_SqrtMod_Clear(&plan);
+    Py_DECREF((PyObject*)tempa);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_sqrt_mod_many,
+"sqrt_mod_many(values, p, /) -> list | mpz_array\n\n"
+"Return [sqrt_mod(a, p) for a in values]. The decomposition of p - 1 and\n"
+"the non-residue needed by Tonelli-Shanks are computed once. Raises\n"
+"ValueError if a value is not a square mod p; the message gives its\n"
+"index. Returns an mpz_array if values is an mpz_array and a list\n"
+"otherwise. The GIL is released and the values are split over the\n"
+"context's threads.");
+
+static PyObject *
+GMPy_MPZ_Function_SqrtMod_Many(PyObject *self, PyObject *args)
+{
+    gmpy_rational_view view;
+    gmpy_sqrtmod_batch work;
+    gmpy_sqrtmod plan;
+    PyObject *values, *result = NULL, *temp;
+    CTXT_Object *context = NULL;
+    Py_ssize_t i, n;
+    size_t bits;
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("sqrt_mod_many() requires 2 arguments");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    values = PyTuple_GET_ITEM(args, 0);
+    if (_GMPy_SqrtMod_Plan(&plan, PyTuple_GET_ITEM(args, 1), "sqrt_mod_many", context) < 0)
+        return NULL;
+
+    memset(&work, 0, sizeof(gmpy_sqrtmod_batch));
+    if (_GMPy_View_Init(&view, values, "sqrt_mod_many", context) < 0) {
+        _GMPy_SqrtMod_Clear(&plan);
+        return NULL;
+    }
+    n = view.n;
+
+    if (view.rational) {
+        TYPE_ERROR("sqrt_mod_many() requires integer arguments");
+        goto done;
+    }
+
+    if (!(work.out = PyMem_New(mpz_ptr, n ? n : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    if (MPZ_Array_Check(values)) {
+        if (!(result = (PyObject*)GMPy_MPZ_Array_New(n)))
+            goto done;
+        for (i = 0; i < n; i++)
+            work.out[i] = ((MPZ_Array_Object*)result)->z[i];
+    }
+    else {
+        if (!(result = PyList_New(n)))
+            goto done;
+        for (i = 0; i < n; i++) {
+            if (!(temp = (PyObject*)GMPy_MPZ_New(context))) {
+                Py_CLEAR(result);
+                goto done;
+            }
+            PyList_SET_ITEM(result, i, temp);
+            work.out[i] = MPZ(temp);
+        }
+    }
+
+    work.plan = &plan;
+    work.x = view.num;
+    bits = GMPY_MPZ_BITS(plan.p);
+    GMPY_PROFILE_OPN(context, GMPY_OP_POWMOD, mpz_sizeinbase(plan.p, 2), n);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits * bits * n);
+    GMPy_Parallel_Run(_GMPy_SqrtMod_Range, &work, n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    for (i = 0; i < n; i++) {
+        if (mpz_sgn(work.out[i]) < 0) {
+            PyErr_Format(PyExc_ValueError,
+                         "sqrt_mod_many() no square root exists for values[%zd]", i);
+            Py_CLEAR(result);
+            break;
+        }
+    }
+
+  done:
+    PyMem_Free(work.out);
+    _GMPy_View_Clear(&view);
+    _GMPy_SqrtMod_Clear(&plan);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_cornacchia,
+"cornacchia(d, p, /) -> tuple[mpz, mpz]\n\n"
+"Return (x, y) with x*x + d*y*y == p for a prime p and 0 < d < p, using\n"
+"Cornacchia's algorithm. Raises ValueError if there is no solution.");
+
+static PyObject *
+GMPy_MPZ_Function_Cornacchia(PyObject *self, PyObject *args)
+{
+    gmpy_sqrtmod plan;
+    MPZ_Object *tempd, *x = NULL, *y = NULL;
+    PyObject *result = NULL;
+    mpz_t t[GMPY_SQRTMOD_TEMPS], a, b;
+    CTXT_Object *context = NULL;
+    int k, res;
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("cornacchia() requires 2 arguments");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!IS_INTEGER(PyTuple_GET_ITEM(args, 0))) {
+        TYPE_ERROR("cornacchia() requires integer arguments");
+        return NULL;
+    }
+    if (!(tempd = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), context)))
+        return NULL;
+    if (_GMPy_SqrtMod_Plan(&plan, PyTuple_GET_ITEM(args, 1), "cornacchia", context) < 0) {
+        Py_DECREF((PyObject*)tempd);
+        return NULL;
+    }
+    if (mpz_sgn(tempd->z) <= 0 || mpz_cmp(tempd->z, plan.p) >= 0) {
+        VALUE_ERROR("cornacchia() requires 0 < d < p");
+        goto done;
+    }
+    if (!(x = GMPy_MPZ_New(context)) || !(y = GMPy_MPZ_New(context)))
+        goto done;
+
+    for (k = 0; k < GMPY_SQRTMOD_TEMPS; k++)
+        mpz_init(t[k]);
+    mpz_init(a);
+    mpz_init(b);
+
+    /* b is the root of -d with p/2 < b < p. Reduce (p, b) with Euclid's
+     * algorithm until b*b < p; then y*y = (p - b*b) / d.
+     */
+
+    mpz_neg(a, tempd->z);
+    if ((res = _GMPy_SqrtMod(&plan, b, a, t)) == 0) {
+        mpz_sub(b, plan.p, b);
+        mpz_set(a, plan.p);
+        mpz_mul(t[0], b, b);
+        while (mpz_cmp(t[0], plan.p) >= 0) {
+            mpz_mod(a, a, b);
+            mpz_swap(a, b);
+            mpz_mul(t[0], b, b);
+        }
+        mpz_sub(t[0], plan.p, t[0]);
+        if (mpz_divisible_p(t[0], tempd->z)) {
+            mpz_divexact(t[0], t[0], tempd->z);
+            if (mpz_perfect_square_p(t[0])) {
+                mpz_set(x->z, b);
+                mpz_sqrt(y->z, t[0]);
+            }
+            else {
+                res = -1;
+            }
+        }
+        else {
+            res = -1;
+        }
+    }
+
+    for (k = 0; k < GMPY_SQRTMOD_TEMPS; k++)
+        mpz_clear(t[k]);
+    mpz_clear(a);
+    mpz_clear(b);
+
+    if (res < 0)
+        VALUE_ERROR("cornacchia() no solution exists");
+    else
+        result = PyTuple_Pack(2, (PyObject*)x, (PyObject*)y);
+
+  done:
+    Py_XDECREF((PyObject*)x);
+    Py_XDECREF((PyObject*)y);
+    _GMPy_SqrtMod_Clear(&plan);
+    Py_DECREF((PyObject*)tempd);
+    return result;
+}
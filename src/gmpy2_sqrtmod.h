@@ -0,0 +1,54 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_sqrtmod.h                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_SQRTMOD_H
+#define GMPY_SQRTMOD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The values that depend only on the prime p. With p - 1 = q * 2**s and q
+ * odd, e is the exponent of the first power of a, and c = z**q for the
+ * least non-residue z when Tonelli-Shanks is used.
+ */
+
+typedef struct {
+    mpz_t p;
+    mpz_t e;
+    mpz_t c;
+    mp_bitcnt_t s;
+    int cipolla;
+} gmpy_sqrtmod;
+
+static PyObject * GMPy_MPZ_Function_SqrtMod(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_SqrtMod_Many(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_Cornacchia(PyObject *self, PyObject *args);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
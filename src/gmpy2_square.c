@@ -38,7 +38,7 @@
  *   GMPy_Real_Square(Real, Real, context|NULL)
  *   GMPy_Complex_Square(Complex, Complex, context|NULL)
  *
- *   GMPy_Context_Square(context, args)
+ *   GMPy_Context_Square(context, args, nargs, kwnames)
  *
  */
 
@@ -51,7 +51,15 @@ _GMPy_MPZ_Square(PyObject *x, CTXT_Object *context)
         return NULL;
     }
 
-    mpz_mul(result->z, MPZ(x), MPZ(x));
+    if (GMPY_MUL_THREADS(context, MPZ(x), MPZ(x))) {
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(MPZ(x)));
+        _GMPy_MPZ_Mul_Threads(result->z, MPZ(x), MPZ(x),
+                              GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+    }
+    else {
+        mpz_mul(result->z, MPZ(x), MPZ(x));
+    }
     return (PyObject*)result;
 }
 
@@ -162,12 +170,14 @@ GMPy_Complex_Square(PyObject *x, CTXT_Object *context)
 }
 
 PyDoc_STRVAR(GMPy_doc_function_square,
-"square(x, /) -> mpz | mpq | mpfr | mpc\n\n"
-"Return x * x.");
+"square(x, /, *, out=None) -> mpz | mpq | mpfr | mpc | xmpz\n\n"
+"Return x * x. If out is an `xmpz`, x must be an integer and the result\n"
+"is stored in out, which is returned.");
 
 PyDoc_STRVAR(GMPy_doc_context_square,
-"context.square(x, /) -> mpz | mpq | mpfr | mpc\n\n"
-"Return x * x.");
+"context.square(x, /, *, out=None) -> mpz | mpq | mpfr | mpc | xmpz\n\n"
+"Return x * x. If out is an `xmpz`, x must be an integer and the result\n"
+"is stored in out, which is returned.");
 
 static PyObject *
 GMPy_Number_Square(PyObject *x, CTXT_Object *context)
@@ -201,9 +211,16 @@ GMPy_Number_Square(PyObject *x, CTXT_Object *context)
 }
 
 static PyObject *
-GMPy_Context_Square(PyObject *self, PyObject *other)
+GMPy_Context_Square(PyObject *self, PyObject *const *args, Py_ssize_t nargs,
+                    PyObject *kwnames)
 {
     CTXT_Object *context = NULL;
+    XMPZ_Object *out;
+
+    if (nargs != 1) {
+        TYPE_ERROR("square() requires 1 argument");
+        return NULL;
+    }
 
     if (self && CTXT_Check(self)) {
         context = (CTXT_Object*)self;
@@ -212,5 +229,11 @@ GMPy_Context_Square(PyObject *self, PyObject *other)
         CHECK_CONTEXT(context);
     }
 
-    return GMPy_Number_Square(other, context);
+    if (GMPy_XMPZ_Out_Kwnames(args, nargs, kwnames, &out, "square") < 0)
+        return NULL;
+    if (out)
+        return GMPy_XMPZ_Out_Binop(out, args[0], args[0], GMPY_OP_MUL,
+                                   "square", context);
+
+    return GMPy_Number_Square(args[0], context);
 }
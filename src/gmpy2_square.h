@@ -37,7 +37,8 @@ static PyObject * GMPy_Rational_Square(PyObject *x, CTXT_Object *context);
 static PyObject * GMPy_Real_Square(PyObject *x, CTXT_Object *context);
 static PyObject * GMPy_Complex_Square(PyObject *x, CTXT_Object *context);
 static PyObject * GMPy_Number_Square(PyObject *x, CTXT_Object *context);
-static PyObject * GMPy_Context_Square(PyObject *self, PyObject *args);
+static PyObject * GMPy_Context_Square(PyObject *self, PyObject *const *args,
+                                      Py_ssize_t nargs, PyObject *kwnames);
 
 #ifdef __cplusplus
 }
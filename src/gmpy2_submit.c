@@ -0,0 +1,325 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_submit.c                                                          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* The supported functions, indexed by GMPY_SUBMIT_*. */
+
+static const struct {
+    PyCFunction func;
+    int nargs;
+    const char *name;
+} submit_funcs[GMPY_SUBMIT_COUNT] = {
+    { (PyCFunction)GMPy_Integer_PowMod, 3, "powmod" },
+    { (PyCFunction)GMPy_Context_Mul, 2, "mul" },
+    { (PyCFunction)GMPy_MPZ_Function_Isqrt, 1, "isqrt" },
+    { (PyCFunction)GMPy_MPZ_Function_IsPrime, 1, "is_prime" },
+    { (PyCFunction)GMPY_mpz_is_bpsw_prp, 1, "is_bpsw_prp" },
+    { (PyCFunction)GMPY_mpz_is_strongbpsw_prp, 1, "is_strong_bpsw_prp" },
+    { (PyCFunction)GMPy_MPZ_Function_Factor, 1, "factor" },
+};
+
+static void
+_GMPy_Submit_Free(gmpy_submit_task *task)
+{
+    int i;
+
+    for (i = 0; i < task->nargs; i++)
+        Py_XDECREF((PyObject*)task->args[i]);
+    Py_XDECREF((PyObject*)task->result);
+    Py_XDECREF(task->future);
+    _GMPy_Factor_Job_Clear(&task->job);
+    PyMem_Free(task);
+}
+
+/* Run the computation. Does not use the Python API. */
+
+static void
+_GMPy_Submit_Run(gmpy_submit_task *task)
+{
+    mpz_srcptr x = task->args[0]->z;
+    mpz_ptr r = task->result ? task->result->z : NULL;
+
+    interrupt_current = &task->intr;
+
+    /* The deadline may have passed while the task was queued. */
+
+    if (GMPy_Interrupt_Poll()) {
+        interrupt_current = NULL;
+        return;
+    }
+
+    switch (task->op) {
+    case GMPY_SUBMIT_POWMOD:
+        /* Same results as powmod(); the modulus is not 0. */
+        task->status = _GMPy_MPZ_PowMod(r, x, task->args[1]->z, task->args[2]->z);
+        break;
+    case GMPY_SUBMIT_MUL:
+        mpz_mul(r, x, task->args[1]->z);
+        break;
+    case GMPY_SUBMIT_ISQRT:
+        mpz_sqrt(r, x);
+        break;
+    case GMPY_SUBMIT_IS_PRIME:
+        task->status = mpz_sgn(x) > 0 && _GMPy_MPZ_IsPrime(x, (int)task->reps);
+        break;
+    case GMPY_SUBMIT_BPSW_PRP:
+        task->status = _GMPy_MPZ_BPSW_PRP(x);
+        break;
+    case GMPY_SUBMIT_STRONG_BPSW_PRP:
+        task->status = _GMPy_MPZ_StrongBPSW_PRP(x);
+        break;
+    case GMPY_SUBMIT_FACTOR:
+        task->status = _GMPy_Factor_Job_Run(&task->job, x);
+        break;
+    }
+    interrupt_current = NULL;
+}
+
+/* Return the value of a finished task, or NULL with the exception set. */
+
+static PyObject *
+_GMPy_Submit_Value(gmpy_submit_task *task)
+{
+    PyObject *result;
+
+    if (GMPy_Interrupt_End(&task->intr) < 0)
+        return NULL;
+
+    switch (task->op) {
+    case GMPY_SUBMIT_POWMOD:
+        if (task->status < 0) {
+            VALUE_ERROR("pow() base not invertible");
+            return NULL;
+        }
+        /* fall through */
+    case GMPY_SUBMIT_MUL:
+    case GMPY_SUBMIT_ISQRT:
+        result = (PyObject*)task->result;
+        task->result = NULL;
+        return result;
+    case GMPY_SUBMIT_BPSW_PRP:
+    case GMPY_SUBMIT_STRONG_BPSW_PRP:
+        if (task->status < 0) {
+            PyErr_Format(PyExc_ValueError,
+                         "appropriate value for D cannot be found in %s()",
+                         task->op == GMPY_SUBMIT_BPSW_PRP ?
+                         "is_selfridge_prp" : "is_strong_selfridge_prp");
+            return NULL;
+        }
+        /* fall through */
+    case GMPY_SUBMIT_IS_PRIME:
+        return PyBool_FromLong(task->status);
+    default:
+        return _GMPy_Factor_Job_Result(&task->job, NULL);
+    }
+}
+
+/* Set the result of the future, then free the task. The future may have
+ * been cancelled, in which case the result is discarded.
+ */
+
+static void
+_GMPy_Submit_Deliver(gmpy_submit_task *task)
+{
+    PyThreadState *tstate = PyThreadState_New(task->interp);
+    PyObject *value, *type, *traceback, *temp;
+
+    PyEval_RestoreThread(tstate);
+    if ((value = _GMPy_Submit_Value(task))) {
+        temp = PyObject_CallMethod(task->future, "set_result", "O", value);
+    }
+    else {
+        PyErr_Fetch(&type, &value, &traceback);
+        PyErr_NormalizeException(&type, &value, &traceback);
+        if (traceback)
+            PyException_SetTraceback(value, traceback);
+        temp = PyObject_CallMethod(task->future, "set_exception", "O", value);
+        Py_XDECREF(type);
+        Py_XDECREF(traceback);
+    }
+    Py_XDECREF(value);
+    Py_XDECREF(temp);
+    PyErr_Clear();
+    _GMPy_Submit_Free(task);
+    PyThreadState_Clear(tstate);
+    PyThreadState_DeleteCurrent();
+}
+
+/* Run by a worker of the pool (see gmpy2_parallel.c). */
+
+static void
+_GMPy_Submit_Job(gmpy_pool_job *job)
+{
+    gmpy_submit_task *task = (gmpy_submit_task*)job;
+
+    _GMPy_Submit_Run(task);
+    _GMPy_Submit_Deliver(task);
+}
+
+PyDoc_STRVAR(GMPy_doc_function_submit,
+"submit(func, /, *args) -> concurrent.futures.Future\n\n"
+"Compute func(*args) on a pool of native threads and return a\n"
+"`concurrent.futures.Future` for the result. func must be one of\n"
+"`powmod()`, `mul()`, `isqrt()`, `is_prime()`, `is_bpsw_prp()`,\n"
+"`is_strong_bpsw_prp()`, or `factor()`, called with integer arguments.\n"
+"The arguments are checked before submit() returns; the computation\n"
+"runs without the GIL. Up to the context's threads computations run at\n"
+"the same time, and its max_time and deadline apply. Use\n"
+"`asyncio.wrap_future()` to await the result.");
+
+static PyObject *
+GMPy_Function_Submit(PyObject *self, PyObject *args)
+{
+    PyObject *func, *rest = NULL, *module, *future = NULL;
+    gmpy_submit_task *task;
+    PyCFunction f;
+    Py_ssize_t argc = PyTuple_GET_SIZE(args), nopt;
+    CTXT_Object *context = NULL;
+    const char *name;
+    long effort = GMPY_FACTOR_DEFAULT_EFFORT;
+    int op, nargs;
+
+    CHECK_CONTEXT(context);
+
+    if (argc < 1) {
+        TYPE_ERROR("submit() requires at least 1 argument");
+        return NULL;
+    }
+    func = PyTuple_GET_ITEM(args, 0);
+    f = PyCFunction_Check(func) ? PyCFunction_GetFunction(func) : NULL;
+
+    for (op = 0; op < GMPY_SUBMIT_COUNT; op++) {
+        if (f && f == submit_funcs[op].func)
+            break;
+    }
+    if (op == GMPY_SUBMIT_COUNT) {
+        PyErr_Format(PyExc_TypeError, "submit() does not support %R", func);
+        return NULL;
+    }
+    nargs = submit_funcs[op].nargs;
+    name = submit_funcs[op].name;
+
+    /* is_prime() and factor() take an optional second argument. */
+
+    nopt = (op == GMPY_SUBMIT_IS_PRIME || op == GMPY_SUBMIT_FACTOR) &&
+           argc == nargs + 2;
+
+    if (!(task = PyMem_Calloc(1, sizeof(gmpy_submit_task)))) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    task->op = op;
+    task->reps = 25;
+
+    if (!(rest = PyTuple_GetSlice(args, 1, argc - nopt)))
+        goto err;
+    if (_GMPy_MPZ_Args(rest, nargs, task->args, name) < 0)
+        goto err;
+    task->nargs = nargs;
+
+    if (nopt && op == GMPY_SUBMIT_IS_PRIME) {
+        task->reps = GMPy_Integer_AsUnsignedLong(PyTuple_GET_ITEM(args, argc - 1));
+        if (task->reps == (unsigned long)(-1) && PyErr_Occurred())
+            goto err;
+        /* Silently limit n to a reasonable value. */
+        if (task->reps > 1000)
+            task->reps = 1000;
+    }
+    if (nopt && op == GMPY_SUBMIT_FACTOR) {
+        effort = GMPy_Integer_AsLong(PyTuple_GET_ITEM(args, argc - 1));
+        if (effort == -1 && PyErr_Occurred())
+            goto err;
+    }
+
+    switch (op) {
+    case GMPY_SUBMIT_POWMOD:
+        if (mpz_sgn(task->args[2]->z) == 0) {
+            VALUE_ERROR("pow() 3rd argument cannot be 0");
+            goto err;
+        }
+        break;
+    case GMPY_SUBMIT_ISQRT:
+        if (mpz_sgn(task->args[0]->z) < 0) {
+            VALUE_ERROR("isqrt() of negative number");
+            goto err;
+        }
+        break;
+    case GMPY_SUBMIT_BPSW_PRP:
+    case GMPY_SUBMIT_STRONG_BPSW_PRP:
+        if (mpz_sgn(task->args[0]->z) <= 0) {
+            PyErr_Format(PyExc_ValueError, "%s() requires 'n' be greater than 0", name);
+            goto err;
+        }
+        break;
+    case GMPY_SUBMIT_FACTOR:
+        if (effort < 0 || effort > GMPY_FACTOR_MAX_EFFORT) {
+            VALUE_ERROR("factor() effort must be in the range 0 to 5");
+            goto err;
+        }
+        if (mpz_sgn(task->args[0]->z) <= 0) {
+            VALUE_ERROR("factor() requires n > 0");
+            goto err;
+        }
+        if (_GMPy_Factor_Job_Init(&task->job, task->args[0]->z, (int)effort) < 0)
+            goto err;
+        break;
+    }
+    if ((op == GMPY_SUBMIT_POWMOD || op == GMPY_SUBMIT_MUL ||
+         op == GMPY_SUBMIT_ISQRT) && !(task->result = GMPy_MPZ_New(context)))
+        goto err;
+
+    /* The worker does not check for signals. */
+
+    GMPy_Interrupt_Init(&task->intr, context, NULL);
+    task->intr.owner = 0;
+
+    if (!(module = PyImport_ImportModule("concurrent.futures")))
+        goto err;
+    future = PyObject_CallMethod(module, "Future", NULL);
+    Py_DECREF(module);
+    if (!future)
+        goto err;
+    Py_INCREF(future);
+    task->future = future;
+#if PY_VERSION_HEX >= 0x03090000
+    task->interp = PyInterpreterState_Get();
+#else
+    task->interp = PyThreadState_Get()->interp;
+#endif
+
+    task->pool.run = _GMPy_Submit_Job;
+    if (GMPy_Pool_Submit(&task->pool, GMPY_THREADS(context)) < 0) {
+        RUNTIME_ERROR("submit() can't start a worker thread");
+        Py_CLEAR(future);
+        goto err;
+    }
+    Py_DECREF(rest);
+    return future;
+
+  err:
+    Py_XDECREF(rest);
+    _GMPy_Submit_Free(task);
+    return NULL;
+}
@@ -0,0 +1,71 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_submit.h                                                          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY2_SUBMIT_H
+#define GMPY2_SUBMIT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* submit() runs a few expensive integer functions on the native worker
+ * pool (see gmpy2_parallel.h) and returns a concurrent.futures.Future. The
+ * arguments are converted and checked with the GIL held; the computation
+ * itself does not use the Python API, and the worker only takes the GIL to
+ * set the result of the future.
+ */
+
+enum {
+    GMPY_SUBMIT_POWMOD,
+    GMPY_SUBMIT_MUL,
+    GMPY_SUBMIT_ISQRT,
+    GMPY_SUBMIT_IS_PRIME,
+    GMPY_SUBMIT_BPSW_PRP,
+    GMPY_SUBMIT_STRONG_BPSW_PRP,
+    GMPY_SUBMIT_FACTOR,
+    GMPY_SUBMIT_COUNT
+};
+
+typedef struct gmpy_submit_task {
+    gmpy_pool_job pool;         /* must be first */
+    int op;
+    int nargs;
+    MPZ_Object *args[3];
+    unsigned long reps;         /* for is_prime() */
+    MPZ_Object *result;         /* for powmod(), mul(), and isqrt() */
+    int status;                 /* result of a test, -1 for a failure */
+    gmpy_factor_job job;        /* for factor() */
+    gmpy_interrupt intr;        /* max_time and deadline of the caller */
+    PyObject *future;
+    PyInterpreterState *interp;
+} gmpy_submit_task;
+
+static PyObject * GMPy_Function_Submit(PyObject *self, PyObject *args);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
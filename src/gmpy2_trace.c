@@ -0,0 +1,274 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_trace.c                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Tracing of allocation and GIL behavior. See gmpy2_trace.h.
+ *
+ * The queue is protected by trace_state.lock since reallocations are
+ * reported from any thread. The callback is only called with the GIL held
+ * and never from within itself.
+ */
+
+#if PY_VERSION_HEX >= 0x030D0000
+#  define TRACE_LOCK()   PyMutex_Lock(&trace_state.lock)
+#  define TRACE_UNLOCK() PyMutex_Unlock(&trace_state.lock)
+#else
+#  define TRACE_LOCK()   PyThread_acquire_lock(trace_state.lock, WAIT_LOCK)
+#  define TRACE_UNLOCK() PyThread_release_lock(trace_state.lock)
+#endif
+
+/* True while the running thread is calling the callback. */
+
+static GMPY_THREAD_LOCAL int gmpy_trace_busy = 0;
+
+static int
+GMPy_Trace_Init(void)
+{
+#if PY_VERSION_HEX < 0x030D0000
+    if (!trace_state.lock && !(trace_state.lock = PyThread_allocate_lock())) {
+        PyErr_NoMemory();
+        return -1;
+    }
+#endif
+    trace_state.realloc_min = 1 << 20;
+    trace_state.nogil_min_ns = 1000000;
+    return 0;
+}
+
+static void
+_GMPy_Trace_Push(int kind, size_t a, unsigned long long b)
+{
+    gmpy_trace_event *event;
+
+    if (!trace_state.callback)
+        return;
+
+    TRACE_LOCK();
+    if (trace_state.count == GMPY_TRACE_QUEUE) {
+        trace_state.dropped++;
+    }
+    else {
+        event = &trace_state.queue[(trace_state.head + trace_state.count) % GMPY_TRACE_QUEUE];
+        event->kind = kind;
+        event->a = a;
+        event->b = b;
+        trace_state.count++;
+    }
+    TRACE_UNLOCK();
+}
+
+/* Pass the queued events to the callback. Requires the GIL. An exception
+ * raised by the callback is reported with PyErr_WriteUnraisable() and
+ * does not change the exception state of the caller.
+ */
+
+static void
+_GMPy_Trace_Flush(void)
+{
+    PyObject *callback = trace_state.callback, *result;
+    PyObject *type, *value, *traceback;
+    gmpy_trace_event event;
+    unsigned long long dropped;
+
+    if (!callback || gmpy_trace_busy || !trace_state.count)
+        return;
+
+    gmpy_trace_busy = 1;
+    Py_INCREF(callback);
+    PyErr_Fetch(&type, &value, &traceback);
+
+    for (;;) {
+        TRACE_LOCK();
+        if (!trace_state.count) {
+            dropped = trace_state.dropped;
+            trace_state.dropped = 0;
+            TRACE_UNLOCK();
+            break;
+        }
+        event = trace_state.queue[trace_state.head];
+        trace_state.head = (trace_state.head + 1) % GMPY_TRACE_QUEUE;
+        trace_state.count--;
+        TRACE_UNLOCK();
+
+        switch (event.kind) {
+        case GMPY_TRACE_CACHE_MISS:
+            result = PyObject_CallFunction(callback, "ss", "cache_miss",
+                                           gmpy_cache_names[event.a]);
+            break;
+        case GMPY_TRACE_REALLOC:
+            result = PyObject_CallFunction(callback, "snK", "realloc",
+                                           (Py_ssize_t)event.a, event.b);
+            break;
+        default:
+            result = PyObject_CallFunction(callback, "snd", "nogil",
+                                           (Py_ssize_t)event.a, event.b / 1e9);
+            break;
+        }
+        if (!result)
+            PyErr_WriteUnraisable(callback);
+        Py_XDECREF(result);
+    }
+
+    if (dropped) {
+        if (!(result = PyObject_CallFunction(callback, "sK", "dropped", dropped)))
+            PyErr_WriteUnraisable(callback);
+        Py_XDECREF(result);
+    }
+
+    PyErr_Restore(type, value, traceback);
+    Py_DECREF(callback);
+    gmpy_trace_busy = 0;
+}
+
+/* Called when a new object is allocated instead of taken from a cache.
+ * The GIL is held and no cache is being changed.
+ */
+
+static void
+_GMPy_Trace_Cache_Miss(int type)
+{
+    GMPY_PROBE_CACHE_MISS(gmpy_cache_names[type]);
+    if (gmpy_trace_busy)
+        return;
+    _GMPy_Trace_Push(GMPY_TRACE_CACHE_MISS, (size_t)type, 0);
+    _GMPy_Trace_Flush();
+}
+
+/* Called by the tracked memory functions, possibly without the GIL. */
+
+static void
+_GMPy_Trace_Realloc(size_t old_size, size_t new_size)
+{
+    if (new_size < trace_state.realloc_min)
+        return;
+    GMPY_PROBE_REALLOC(old_size, new_size);
+    if (!gmpy_trace_busy)
+        _GMPy_Trace_Push(GMPY_TRACE_REALLOC, old_size, new_size);
+}
+
+/* Called by GMPY_MAYBE_END_ALLOW_THREADS after the GIL is reacquired. */
+
+static void
+_GMPy_Trace_NoGIL(size_t bits, unsigned long long ns)
+{
+    if (ns >= trace_state.nogil_min_ns) {
+        GMPY_PROBE_NOGIL(bits, ns);
+        _GMPy_Trace_Push(GMPY_TRACE_NOGIL, bits, ns);
+    }
+    _GMPy_Trace_Flush();
+}
+
+PyDoc_STRVAR(GMPy_doc_set_trace,
+"set_trace(callback, /, realloc_min_bytes=1048576, nogil_min_time=0.001)\n"
+"    -> None\n\n"
+"Report where memory is allocated and how long the GIL is released.\n"
+"callback is called with the following arguments:\n\n"
+"    ('cache_miss', type):     a new mpz, xmpz, mpq, mpfr, or mpc was\n"
+"                              allocated instead of taken from a cache\n"
+"    ('realloc', old, new):    GMP resized an allocation to at least\n"
+"                              realloc_min_bytes bytes\n"
+"    ('nogil', bits, seconds): the GIL was released for at least\n"
+"                              nogil_min_time seconds around an operation\n"
+"                              on operands of about bits bits\n"
+"    ('dropped', n):           n events were lost\n\n"
+"Events that occur inside GMP are queued and passed to callback when a\n"
+"new object is created or the GIL is reacquired. The allocator mode is\n"
+"set to 'tracked' (see set_allocator()) so that reallocations are seen.\n"
+"If callback is True, the events only fire the USDT probes gmpy2:cache_miss,\n"
+"gmpy2:realloc, and gmpy2:nogil for use with perf or bpftrace; these\n"
+"exist if gmpy2 was built with --usdt. If callback is None, tracing stops.");
+
+static PyObject *
+GMPy_Set_Trace(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *callback, *old;
+    Py_ssize_t realloc_min = 1 << 20;
+    double nogil_min = 0.001;
+    static char *kwlist[] = {"", "realloc_min_bytes", "nogil_min_time", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|nd", kwlist, &callback,
+                                     &realloc_min, &nogil_min))
+        return NULL;
+
+    if (callback != Py_None && callback != Py_True && !PyCallable_Check(callback)) {
+        TYPE_ERROR("set_trace() requires a callable, True, or None");
+        return NULL;
+    }
+    if (realloc_min < 0 || !(nogil_min >= 0)) {
+        VALUE_ERROR("realloc_min_bytes and nogil_min_time must be >= 0");
+        return NULL;
+    }
+
+    /* Deliver the events of the previous callback. */
+    _GMPy_Trace_Flush();
+
+    old = trace_state.callback;
+    trace_state.enabled = 0;
+    trace_state.callback = NULL;
+    TRACE_LOCK();
+    trace_state.head = trace_state.count = 0;
+    trace_state.dropped = 0;
+    TRACE_UNLOCK();
+    Py_XDECREF(old);
+
+    if (callback == Py_None)
+        Py_RETURN_NONE;
+
+    if (callback != Py_True) {
+        Py_INCREF(callback);
+        trace_state.callback = callback;
+    }
+    trace_state.realloc_min = (size_t)realloc_min;
+    trace_state.nogil_min_ns = (unsigned long long)(nogil_min * 1e9);
+    _GMPy_Alloc_Install();
+    trace_state.enabled = 1;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_trace_info,
+"trace_info() -> dict\n\n"
+"Return a dictionary describing the tracing started by set_trace().\n\n"
+"    enabled:           True if tracing is active\n"
+"    callback:          the callback, or None\n"
+"    realloc_min_bytes: smallest reallocation that is reported\n"
+"    nogil_min_time:    shortest release of the GIL that is reported\n"
+"    probes:            True if gmpy2 was built with USDT probes");
+
+static PyObject *
+GMPy_Trace_Info(PyObject *self, PyObject *args)
+{
+#ifdef GMPY_HAVE_USDT
+    int probes = 1;
+#else
+    int probes = 0;
+#endif
+
+    return Py_BuildValue("{s:O,s:O,s:n,s:d,s:O}",
+                         "enabled", trace_state.enabled ? Py_True : Py_False,
+                         "callback", trace_state.callback ? trace_state.callback : Py_None,
+                         "realloc_min_bytes", (Py_ssize_t)trace_state.realloc_min,
+                         "nogil_min_time", trace_state.nogil_min_ns / 1e9,
+                         "probes", probes ? Py_True : Py_False);
+}
@@ -0,0 +1,113 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_trace.h                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_TRACE_H
+#define GMPY_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Tracing of allocation and GIL behavior, enabled with set_trace().
+ *
+ * Three kinds of events are reported: an object that could not be taken
+ * from a cache, a reallocation by GMP of at least realloc_min_bytes, and
+ * a section of at least nogil_min_ns run with the GIL released. Each
+ * event fires a USDT probe if gmpy2 was built with GMPY_USDT (setup.py
+ * --usdt) and is passed to the Python callback, if one is set.
+ *
+ * Reallocations happen inside GMP, possibly without the GIL, so events
+ * are queued and handed to the callback only where it is safe to run
+ * Python code: when an object is created and when the GIL is reacquired.
+ */
+
+#if defined(GMPY_USDT) && defined(__has_include)
+#  if __has_include(<sys/sdt.h>)
+#    include <sys/sdt.h>
+#    define GMPY_HAVE_USDT 1
+#  endif
+#endif
+
+#ifdef GMPY_HAVE_USDT
+#  define GMPY_PROBE_CACHE_MISS(type) DTRACE_PROBE1(gmpy2, cache_miss, type)
+#  define GMPY_PROBE_REALLOC(old, new) DTRACE_PROBE2(gmpy2, realloc, old, new)
+#  define GMPY_PROBE_NOGIL(bits, ns) DTRACE_PROBE2(gmpy2, nogil, bits, ns)
+#else
+#  define GMPY_PROBE_CACHE_MISS(type)
+#  define GMPY_PROBE_REALLOC(old, new)
+#  define GMPY_PROBE_NOGIL(bits, ns)
+#endif
+
+enum {
+    GMPY_TRACE_CACHE_MISS,
+    GMPY_TRACE_REALLOC,
+    GMPY_TRACE_NOGIL
+};
+
+#define GMPY_TRACE_QUEUE 1024
+
+typedef struct {
+    int kind;
+    size_t a;                   /* cache type, old size, or bits */
+    unsigned long long b;       /* new size or nanoseconds */
+} gmpy_trace_event;
+
+typedef struct {
+    int enabled;
+    PyObject *callback;         /* NULL if only the probes are used */
+    size_t realloc_min;         /* smallest reallocation reported, in bytes */
+    unsigned long long nogil_min_ns;
+#if PY_VERSION_HEX >= 0x030D0000
+    PyMutex lock;
+#else
+    PyThread_type_lock lock;
+#endif
+    gmpy_trace_event queue[GMPY_TRACE_QUEUE];
+    int head;
+    int count;
+    unsigned long long dropped; /* events lost because the queue was full */
+} gmpy_trace_state;
+
+static gmpy_trace_state trace_state;
+
+#define GMPY_TRACE_CACHE(TYPE) \
+    do { \
+        if (trace_state.enabled) \
+            _GMPy_Trace_Cache_Miss(TYPE); \
+    } while (0)
+
+static int        GMPy_Trace_Init(void);
+static void       _GMPy_Trace_Cache_Miss(int type);
+static void       _GMPy_Trace_Realloc(size_t old_size, size_t new_size);
+static void       _GMPy_Trace_NoGIL(size_t bits, unsigned long long ns);
+
+static PyObject * GMPy_Set_Trace(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Trace_Info(PyObject *self, PyObject *args);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,1096 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_tree.c                                                            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Product and remainder trees.
+ *
+ * A product tree stores the leaves at level 0 and the product of each pair
+ * of nodes at the next level; the last node of an odd-length level moves up
+ * unchanged. Multiplying balanced pairs lets GMP use its subquadratic
+ * algorithms, which makes the tree much faster than a running product.
+ */
+
+/* Allocate the nodes of a tree with n >= 1 leaves. The GIL is required. */
+
+static int
+_GMPy_Tree_Alloc(gmpy_product_tree *tree, Py_ssize_t n)
+{
+    Py_ssize_t total = 0, i;
+
+    tree->depth = 0;
+    do {
+        tree->offset[tree->depth] = total;
+        tree->size[tree->depth] = n;
+        total += n;
+        tree->depth++;
+        n = (n + 1) / 2;
+    } while (tree->size[tree->depth - 1] > 1);
+
+    if (!(tree->node = PyMem_New(mpz_t, total))) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (i = 0; i < total; i++)
+        mpz_init(tree->node[i]);
+    return 0;
+}
+
+static void
+_GMPy_Tree_Free(gmpy_product_tree *tree)
+{
+    Py_ssize_t i, total;
+
+    total = tree->offset[tree->depth - 1] + 1;
+    for (i = 0; i < total; i++)
+        mpz_clear(tree->node[i]);
+    PyMem_Free(tree->node);
+}
+
+#define TREE_NODE(tree, level, i) ((tree)->node[(tree)->offset[level] + (i)])
+
+/* The nodes of one level are independent, so each level can be split over
+ * several threads with GMPy_Parallel_Run().
+ */
+
+typedef struct {
+    gmpy_product_tree *tree;
+    int level;
+} gmpy_tree_level;
+
+static void
+_GMPy_Tree_Build_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_product_tree *tree = ((gmpy_tree_level*)arg)->tree;
+    int k = ((gmpy_tree_level*)arg)->level;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        if (2 * i + 1 < tree->size[k - 1])
+            mpz_mul(TREE_NODE(tree, k, i), TREE_NODE(tree, k - 1, 2 * i),
+                    TREE_NODE(tree, k - 1, 2 * i + 1));
+        else
+            mpz_set(TREE_NODE(tree, k, i), TREE_NODE(tree, k - 1, 2 * i));
+    }
+}
+
+/* Fill the levels above the leaves using up to threads threads. Returns
+ * -1 if GMPy_Interrupt_Poll() stopped the computation; the upper levels
+ * are then incomplete. Does not use the Python API.
+ */
+
+static int
+_GMPy_Tree_Build(gmpy_product_tree *tree, int threads)
+{
+    gmpy_tree_level work;
+
+    work.tree = tree;
+    for (work.level = 1; work.level < tree->depth; work.level++) {
+        if (GMPy_Interrupt_Poll())
+            return -1;
+        GMPy_Parallel_Run(_GMPy_Tree_Build_Range, &work,
+                          tree->size[work.level], threads);
+    }
+    return 0;
+}
+
+/* Replace each node of a level by the remainder of its parent modulo the
+ * node, or modulo the square of the node for batch_gcd().
+ */
+
+static void
+_GMPy_Tree_Mod_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_product_tree *tree = ((gmpy_tree_level*)arg)->tree;
+    int k = ((gmpy_tree_level*)arg)->level;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++)
+        mpz_mod(TREE_NODE(tree, k, i), TREE_NODE(tree, k + 1, i / 2),
+                TREE_NODE(tree, k, i));
+}
+
+static void
+_GMPy_Tree_Mod_Square_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_product_tree *tree = ((gmpy_tree_level*)arg)->tree;
+    int k = ((gmpy_tree_level*)arg)->level;
+    Py_ssize_t i;
+    mpz_t square;
+
+    mpz_init(square);
+    for (i = start; i < stop; i++) {
+        mpz_mul(square, TREE_NODE(tree, k, i), TREE_NODE(tree, k, i));
+        mpz_mod(TREE_NODE(tree, k, i), TREE_NODE(tree, k + 1, i / 2), square);
+    }
+    mpz_clear(square);
+}
+
+/* Walk from the root to the leaves with one of the functions above.
+ * Returns -1 if GMPy_Interrupt_Poll() stopped the computation.
+ */
+
+static int
+_GMPy_Tree_Reduce(gmpy_product_tree *tree, gmpy_parallel_func func, int threads)
+{
+    gmpy_tree_level work;
+
+    work.tree = tree;
+    for (work.level = tree->depth - 2; work.level >= 0; work.level--) {
+        if (GMPy_Interrupt_Poll())
+            return -1;
+        GMPy_Parallel_Run(func, &work, tree->size[work.level], threads);
+    }
+    return 0;
+}
+
+/* Multiply the n values in place by binary splitting; the product is left
+ * in z[0] unless GMPy_Interrupt_Poll() stopped the computation. Does not
+ * use the Python API.
+ */
+
+static void
+_GMPy_Tree_Product(mpz_t *z, Py_ssize_t n)
+{
+    Py_ssize_t i;
+
+    while (n > 1 && !GMPy_Interrupt_Poll()) {
+        for (i = 0; 2 * i + 1 < n; i++)
+            mpz_mul(z[i], z[2 * i], z[2 * i + 1]);
+        if (n & 1)
+            mpz_swap(z[i], z[n - 1]);
+        n = (n + 1) / 2;
+    }
+}
+
+/* Parallel binary splitting for fac(), primorial(), and bincoef().
+ *
+ * All three are products of prime powers. The primes up to hi are found
+ * by the sieve in leaves of GMPY_SPLIT_WIDTH consecutive integers, so a
+ * leaf is one segment of the sieve. A leaf holds the product of its
+ * primes for primorial(), of p**e for each prime p with e the exponent of
+ * p in bincoef(n, k), or, for fac(), of the odd primes whose exponent in
+ * fac(n) has a given bit set. The factors are packed into limbs and
+ * multiplied by binary splitting. The leaves are then multiplied in
+ * balanced pairs, level by level. Both the leaves and the pairs of each
+ * level are split over the threads; only the last few multiplications are
+ * left to a single thread.
+ *
+ * fac(n) is then assembled from the products Q_b for each bit b as
+ * (...((Q_top)**2 * Q_(top-1))**2 ...)**2 * Q_0, times 2**e for the
+ * exponent e of 2. This is Schoenhage's algorithm; squaring is cheaper than
+ * multiplying so it is about as fast as GMP's own mpz_fac_ui().
+ */
+
+#define GMPY_SPLIT_WIDTH (2 * (unsigned long)GMPY_SIEVE_SEGMENT)
+
+typedef struct {
+    mpz_t *leaf;
+    Py_ssize_t nleaves;
+    Py_ssize_t stride;          /* distance between the leaves merged */
+    int which;
+    int bit;                    /* for fac() */
+    int failed;
+    unsigned long hi;
+    unsigned long n;            /* fac(n) or bincoef(n, k) */
+    unsigned long k;
+} gmpy_split;
+
+/* Set z to the product of the n values in v. */
+
+static void
+_GMPy_Split_Array(mpz_ptr z, const unsigned long *v, Py_ssize_t n)
+{
+    Py_ssize_t mid;
+    mpz_t temp;
+
+    if (n <= 2) {
+        mpz_set_ui(z, n ? v[0] : 1);
+        if (n == 2)
+            mpz_mul_ui(z, z, v[1]);
+        return;
+    }
+
+    mid = n / 2;
+    mpz_init(temp);
+    _GMPy_Split_Array(z, v, mid);
+    _GMPy_Split_Array(temp, v + mid, n - mid);
+    mpz_mul(z, z, temp);
+    mpz_clear(temp);
+}
+
+/* Append f to the n packed values in v and return the new count. */
+
+static Py_ssize_t
+_GMPy_Split_Pack(unsigned long *v, Py_ssize_t n, unsigned long f)
+{
+    if (f == 1)
+        return n;
+    if (n && v[n - 1] <= ULONG_MAX / f)
+        v[n - 1] *= f;
+    else
+        v[n++] = f;
+    return n;
+}
+
+/* Return the exponent of the prime p in fac(n). */
+
+static unsigned long
+_GMPy_Split_Fac_Exp(unsigned long p, unsigned long n)
+{
+    unsigned long e = 0;
+
+    while (n >= p) {
+        n /= p;
+        e += n;
+    }
+    return e;
+}
+
+/* Return p**e for the exponent e of the prime p in bincoef(n, k), which is
+ * at most n.
+ */
+
+static unsigned long
+_GMPy_Split_Bincoef_Power(unsigned long p, unsigned long n, unsigned long k)
+{
+    unsigned long a = n, b = k, c = n - k, f = 1;
+
+    while (a >= p) {
+        a /= p;
+        b /= p;
+        c /= p;
+        if (a - b - c)
+            f *= p;
+    }
+    return f;
+}
+
+/* Return the factor that the prime p contributes to a leaf. */
+
+static unsigned long
+_GMPy_Split_Factor(const gmpy_split *work, unsigned long p)
+{
+    if (work->which == GMPY_FAC_PRIMORIAL)
+        return p;
+    if (work->which == GMPY_FAC_BINCOEF)
+        return _GMPy_Split_Bincoef_Power(p, work->n, work->k);
+    if (p == 2)
+        return 1;
+    return (_GMPy_Split_Fac_Exp(p, work->n) >> work->bit) & 1 ? p : 1;
+}
+
+static void
+_GMPy_Split_Leaf_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_split *work = (gmpy_split*)arg;
+    unsigned long *v = NULL, a, b, odd;
+    unsigned char *flags = NULL;
+    unsigned int *found = NULL;
+    Py_ssize_t s, j, n, len, count;
+    mpz_t lo, temp;
+
+    mpz_init(lo);
+    mpz_init(temp);
+    if (!(v = PyMem_RawMalloc(sizeof(unsigned long) * GMPY_SIEVE_SEGMENT)) ||
+        !(flags = PyMem_RawMalloc(GMPY_SIEVE_SEGMENT)) ||
+        !(found = PyMem_RawMalloc(sizeof(unsigned int) * GMPY_SIEVE_SEGMENT))) {
+        work->failed = 1;
+        goto done;
+    }
+
+    for (s = start; s < stop; s++) {
+        if (GMPy_Interrupt_Poll()) {
+            work->failed = 1;
+            break;
+        }
+        a = (unsigned long)s * GMPY_SPLIT_WIDTH;
+        b = (s == work->nleaves - 1) ? work->hi : a + GMPY_SPLIT_WIDTH;
+        n = 0;
+
+        if (a < 2 && b >= 2)
+            n = _GMPy_Split_Pack(v, n, _GMPy_Split_Factor(work, 2));
+
+        /* The odd numbers in (a, b]; a is even. */
+        odd = a + 1;
+        len = (Py_ssize_t)((b + 1) / 2 - (a + 1) / 2);
+        if (len > 0) {
+            mpz_set_ui(lo, odd);
+            count = _GMPy_Sieve_Segment(lo, len, flags, found, temp);
+            for (j = 0; j < count; j++)
+                n = _GMPy_Split_Pack(v, n, _GMPy_Split_Factor(work, odd + found[j]));
+        }
+        _GMPy_Split_Array(work->leaf[s], v, n);
+    }
+
+  done:
+    mpz_clear(lo);
+    mpz_clear(temp);
+    PyMem_RawFree(v);
+    PyMem_RawFree(flags);
+    PyMem_RawFree(found);
+}
+
+static void
+_GMPy_Split_Merge_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_split *work = (gmpy_split*)arg;
+    Py_ssize_t i, j;
+
+    for (i = start; i < stop && !GMPy_Interrupt_Poll(); i++) {
+        j = 2 * i * work->stride;
+        if (j + work->stride < work->nleaves) {
+            mpz_mul(work->leaf[j], work->leaf[j], work->leaf[j + work->stride]);
+            /* Release the memory of the merged leaf. */
+            mpz_realloc2(work->leaf[j + work->stride], 1);
+        }
+    }
+}
+
+/* Set z to the product of the leaves of (0, work->hi] using up to threads
+ * threads. Returns -1, leaving z unchanged, if memory could not be
+ * allocated or GMPy_Interrupt_Poll() stopped the computation. Does not use
+ * the Python API.
+ */
+
+static int
+_GMPy_Split_Product(mpz_ptr z, gmpy_split *work, int threads)
+{
+    Py_ssize_t i, pairs;
+
+    work->nleaves = (Py_ssize_t)((work->hi + GMPY_SPLIT_WIDTH - 1) / GMPY_SPLIT_WIDTH);
+    work->failed = 0;
+    if (work->nleaves == 0) {
+        mpz_set_ui(z, 1);
+        return 0;
+    }
+    if (!(work->leaf = PyMem_RawMalloc(sizeof(mpz_t) * work->nleaves)))
+        return -1;
+    for (i = 0; i < work->nleaves; i++)
+        mpz_init(work->leaf[i]);
+
+    GMPy_Parallel_Run(_GMPy_Split_Leaf_Range, work, work->nleaves, threads);
+    if (!work->failed) {
+        for (work->stride = 1; work->stride < work->nleaves; work->stride *= 2) {
+            if (GMPy_Interrupt_Poll()) {
+                work->failed = 1;
+                break;
+            }
+            pairs = (work->nleaves + 2 * work->stride - 1) / (2 * work->stride);
+            GMPy_Parallel_Run(_GMPy_Split_Merge_Range, work, pairs, threads);
+        }
+    }
+    if (!work->failed)
+        mpz_swap(z, work->leaf[0]);
+
+    for (i = 0; i < work->nleaves; i++)
+        mpz_clear(work->leaf[i]);
+    PyMem_RawFree(work->leaf);
+    return work->failed ? -1 : 0;
+}
+
+static int
+_GMPy_Split_Fac_Product(mpz_ptr z, gmpy_split *work, int threads)
+{
+    unsigned long e3 = _GMPy_Split_Fac_Exp(3, work->n);
+    mpz_t q;
+    int result = 0;
+
+    mpz_init(q);
+    mpz_set_ui(z, 1);
+    for (work->bit = 0; (e3 >> work->bit) > 1; work->bit++);
+    for (; work->bit >= 0 && e3; work->bit--) {
+        /* Only the primes below n/2**bit + 1 have the bit set. */
+        work->hi = Py_MIN(work->n, (work->n >> work->bit) + 1);
+        if ((result = _GMPy_Split_Product(q, work, threads)) < 0)
+            break;
+        mpz_mul(z, z, z);
+        mpz_mul(z, z, q);
+    }
+    mpz_clear(q);
+    if (result == 0)
+        mpz_mul_2exp(z, z, _GMPy_Split_Fac_Exp(2, work->n));
+    return result;
+}
+
+/* Set z to fac(n), primorial(n), or bincoef(n, k) (k is ignored unless
+ * which is GMPY_FAC_BINCOEF) using up to threads threads. GMP's sequential
+ * function is used if memory runs out or n is at least 2**32, beyond which
+ * the sieve is not exact. If the computation was interrupted, z is not
+ * set. Does not use the Python API.
+ */
+
+static void
+_GMPy_Split_Fac(mpz_ptr z, int which, unsigned long n, unsigned long k, int threads)
+{
+    gmpy_split work;
+    int result = -1;
+
+    work.which = which;
+    work.hi = n;
+    work.n = n;
+    work.k = k;
+
+    if (n <= 0xffffffffUL) {
+        if (which == GMPY_FAC_FAC)
+            result = _GMPy_Split_Fac_Product(z, &work, threads);
+        else
+            result = _GMPy_Split_Product(z, &work, threads);
+    }
+    if (result == 0 || GMPy_Interrupt_Poll())
+        return;
+
+    if (which == GMPY_FAC_FAC)
+        mpz_fac_ui(z, n);
+    else if (which == GMPY_FAC_PRIMORIAL)
+        mpz_primorial_ui(z, n);
+    else
+        mpz_bin_uiui(z, n, k);
+}
+
+PyDoc_STRVAR(GMPy_doc_function_prod,
+"prod(iterable, /) -> mpz | mpq\n\n"
+"Return the exact product of the integers or rationals in iterable, or 1\n"
+"if iterable is empty. The product is computed by multiplying balanced\n"
+"pairs of partial products without the GIL.");
+
+static PyObject *
+GMPy_Context_Prod(PyObject *self, PyObject *other)
+{
+    gmpy_rational_view view;
+    gmpy_interrupt intr;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+    mpz_t *num = NULL, *den = NULL;
+    Py_ssize_t i, n, nden = 0;
+    size_t bits;
+
+    if (self && CTXT_Check(self)) {
+        context = (CTXT_Object*)self;
+    }
+    else {
+        CHECK_CONTEXT(context);
+    }
+
+    if (_GMPy_View_Init(&view, other, "prod", context) < 0)
+        return NULL;
+
+    n = view.n;
+    bits = _GMPy_View_Bits(&view);
+    if (n > 1)
+        GMPY_PROFILE_OPN(context, GMPY_OP_MUL, bits / n, n - 1);
+
+    if (!(num = PyMem_New(mpz_t, n ? n : 1)) ||
+        !(den = PyMem_New(mpz_t, n ? n : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    result = view.rational ? (PyObject*)GMPy_MPQ_New(context) :
+                             (PyObject*)GMPy_MPZ_New(context);
+    if (!result)
+        goto done;
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    intr.save = &_save;
+    for (i = 0; i < n; i++) {
+        mpz_init_set(num[i], view.num[i]);
+        if (view.den[i])
+            mpz_init_set(den[nden++], view.den[i]);
+    }
+    _GMPy_Tree_Product(num, n);
+    _GMPy_Tree_Product(den, nden);
+
+    /* If interrupted, the products are incomplete and not used. */
+
+    if (view.rational && !intr.stop) {
+        mpz_swap(mpq_numref(MPQ(result)), num[0]);
+        mpz_swap(mpq_denref(MPQ(result)), den[0]);
+        mpq_canonicalize(MPQ(result));
+    }
+    else if (n && !intr.stop) {
+        mpz_swap(MPZ(result), num[0]);
+    }
+    else if (!n) {
+        mpz_set_ui(MPZ(result), 1);
+    }
+
+    for (i = 0; i < n; i++)
+        mpz_clear(num[i]);
+    for (i = 0; i < nden; i++)
+        mpz_clear(den[i]);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    if (GMPy_Interrupt_End(&intr) < 0)
+        Py_CLEAR(result);
+
+  done:
+    PyMem_Free(num);
+    PyMem_Free(den);
+    _GMPy_View_Clear(&view);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_remainder_tree,
+"remainder_tree(x, moduli, /) -> list[mpz, ...]\n\n"
+"Return [x % m for m in moduli] for an integer x and a sequence of\n"
+"non-zero integers. A product tree of the moduli is built and x is reduced\n"
+"down the tree, which is much faster than reducing x by each modulus when\n"
+"x is large and there are many moduli. The GIL is released and the\n"
+"levels of the tree are split over the context's threads.");
+
+static PyObject *
+GMPy_MPZ_Function_Remainder_Tree(PyObject *self, PyObject *args)
+{
+    gmpy_rational_view view;
+    gmpy_product_tree tree;
+    gmpy_interrupt intr;
+    MPZ_Object *tempx = NULL;
+    PyObject *result = NULL, *temp;
+    CTXT_Object *context = NULL;
+    Py_ssize_t i, n;
+    size_t bits;
+    int k, threads;
+
+    CHECK_CONTEXT(context);
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("remainder_tree() requires 2 arguments");
+        return NULL;
+    }
+
+    if (!(tempx = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), context))) {
+        TYPE_ERROR("remainder_tree() requires integer arguments");
+        return NULL;
+    }
+
+    if (_GMPy_View_Init(&view, PyTuple_GET_ITEM(args, 1), "remainder_tree", context) < 0) {
+        Py_DECREF((PyObject*)tempx);
+        return NULL;
+    }
+
+    if (view.rational) {
+        TYPE_ERROR("remainder_tree() requires integer arguments");
+        goto done;
+    }
+
+    n = view.n;
+    for (i = 0; i < n; i++) {
+        if (mpz_sgn(view.num[i]) == 0) {
+            ZERO_ERROR("remainder_tree() division by zero");
+            goto done;
+        }
+    }
+
+    if (!(result = PyList_New(n)))
+        goto done;
+    for (i = 0; i < n; i++) {
+        if (!(temp = (PyObject*)GMPy_MPZ_New(context))) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, temp);
+    }
+    if (n == 0)
+        goto done;
+
+    if (_GMPy_Tree_Alloc(&tree, n) < 0) {
+        Py_CLEAR(result);
+        goto done;
+    }
+
+    bits = _GMPy_View_Bits(&view) + GMPY_MPZ_BITS(tempx->z);
+    GMPY_PROFILE_OPN(context, GMPY_OP_MOD, bits / n, n);
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    intr.save = &_save;
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+    for (i = 0; i < n; i++)
+        mpz_abs(TREE_NODE(&tree, 0, i), view.num[i]);
+
+    /* Replace each node by x modulo that node, from the root down. */
+
+    k = tree.depth - 1;
+    if (_GMPy_Tree_Build(&tree, threads) == 0) {
+        mpz_mod(TREE_NODE(&tree, k, 0), tempx->z, TREE_NODE(&tree, k, 0));
+        _GMPy_Tree_Reduce(&tree, _GMPy_Tree_Mod_Range, threads);
+    }
+
+    /* Python's x % m has the sign of m. */
+
+    for (i = 0; i < n && !intr.stop; i++) {
+        if (mpz_sgn(view.num[i]) < 0 && mpz_sgn(TREE_NODE(&tree, 0, i)))
+            mpz_add(TREE_NODE(&tree, 0, i), TREE_NODE(&tree, 0, i), view.num[i]);
+        mpz_swap(MPZ(PyList_GET_ITEM(result, i)), TREE_NODE(&tree, 0, i));
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    _GMPy_Tree_Free(&tree);
+    if (GMPy_Interrupt_End(&intr) < 0)
+        Py_CLEAR(result);
+
+  done:
+    Py_DECREF((PyObject*)tempx);
+    _GMPy_View_Clear(&view);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_batch_gcd,
+"batch_gcd(moduli, /) -> list[mpz, ...]\n\n"
+"Return [gcd(m, P // m) for m in moduli] where P is the product of all\n"
+"moduli, i.e. the gcd of each modulus with the product of the others.\n"
+"A result other than 1 shows that the modulus shares a factor with\n"
+"another modulus. Uses Bernstein's product and remainder trees, which is\n"
+"much faster than comparing each pair. The moduli must be > 0. The GIL\n"
+"is released and the levels of the tree are split over the context's\n"
+"threads.");
+
+static PyObject *
+GMPy_MPZ_Function_Batch_GCD(PyObject *self, PyObject *other)
+{
+    gmpy_rational_view view;
+    gmpy_product_tree tree;
+    gmpy_interrupt intr;
+    PyObject *result = NULL, *temp;
+    CTXT_Object *context = NULL;
+    Py_ssize_t i, n;
+    size_t bits;
+    int threads;
+
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_View_Init(&view, other, "batch_gcd", context) < 0)
+        return NULL;
+
+    if (view.rational) {
+        TYPE_ERROR("batch_gcd() requires integer arguments");
+        goto done;
+    }
+
+    n = view.n;
+    for (i = 0; i < n; i++) {
+        if (mpz_sgn(view.num[i]) <= 0) {
+            VALUE_ERROR("batch_gcd() moduli must be > 0");
+            goto done;
+        }
+    }
+
+    if (!(result = PyList_New(n)))
+        goto done;
+    for (i = 0; i < n; i++) {
+        if (!(temp = (PyObject*)GMPy_MPZ_New(context))) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, temp);
+    }
+    if (n == 0)
+        goto done;
+
+    if (_GMPy_Tree_Alloc(&tree, n) < 0) {
+        Py_CLEAR(result);
+        goto done;
+    }
+
+    bits = _GMPy_View_Bits(&view);
+    GMPY_PROFILE_OPN(context, GMPY_OP_GCD, bits / n, n);
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    intr.save = &_save;
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+    for (i = 0; i < n; i++)
+        mpz_set(TREE_NODE(&tree, 0, i), view.num[i]);
+
+    /* The root is P mod P**2 == P. Each leaf becomes P mod m**2, which is
+     * divisible by m, and (P mod m**2) / m shares the factors of m that
+     * also divide P / m.
+     */
+
+    if (_GMPy_Tree_Build(&tree, threads) == 0)
+        _GMPy_Tree_Reduce(&tree, _GMPy_Tree_Mod_Square_Range, threads);
+
+    for (i = 0; i < n && !intr.stop; i++) {
+        temp = PyList_GET_ITEM(result, i);
+        mpz_divexact(TREE_NODE(&tree, 0, i), TREE_NODE(&tree, 0, i), view.num[i]);
+        mpz_gcd(MPZ(temp), TREE_NODE(&tree, 0, i), view.num[i]);
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    _GMPy_Tree_Free(&tree);
+    if (GMPy_Interrupt_End(&intr) < 0)
+        Py_CLEAR(result);
+
+  done:
+    _GMPy_View_Clear(&view);
+    return result;
+}
+
+/* Smooth parts by Bernstein's batch algorithm. The product P of the primes
+ * <= B is reduced down the product tree of the values; for each value x,
+ * (P mod x)**(2**e) mod x with 2**e >= log2(x) then contains every prime
+ * power of P that divides x, and its gcd with x is the B-smooth part.
+ */
+
+typedef struct {
+    gmpy_rational_view *view;
+    gmpy_product_tree *tree;
+    PyObject **out;
+} gmpy_smooth_part;
+
+static void
+_GMPy_Smooth_Part_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_smooth_part *work = (gmpy_smooth_part*)arg;
+    mpz_srcptr x;
+    mpz_ptr y;
+    mpz_t a;
+    size_t bits, e;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        x = work->view->num[i];
+        y = TREE_NODE(work->tree, 0, i);
+        if (mpz_sgn(x) == 0) {
+            mpz_set_ui(MPZ(work->out[i]), 0);
+            continue;
+        }
+        mpz_roinit_n(a, mpz_limbs_read(x), mpz_size(x));
+        bits = mpz_sizeinbase(x, 2);
+        for (e = 1; e < bits && mpz_sgn(y); e *= 2) {
+            mpz_mul(y, y, y);
+            mpz_mod(y, y, a);
+        }
+        mpz_gcd(MPZ(work->out[i]), y, a);
+    }
+}
+
+/* Parse a smoothness bound 0 <= B < 2**32. */
+
+static int
+_GMPy_Smooth_Bound(PyObject *obj, unsigned long *B, const char *name)
+{
+    MPZ_Object *temp;
+    int ok;
+
+    if (!(temp = GMPy_MPZ_From_Integer(obj, NULL))) {
+        PyErr_Format(PyExc_TypeError, "%s() bound must be an integer", name);
+        return -1;
+    }
+    ok = mpz_sgn(temp->z) >= 0 && mpz_sizeinbase(temp->z, 2) <= 32;
+    if (ok)
+        *B = mpz_get_ui(temp->z);
+    Py_DECREF((PyObject*)temp);
+    if (!ok) {
+        PyErr_Format(PyExc_ValueError, "%s() bound must be in [0, 2**32)", name);
+        return -1;
+    }
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_smooth_part,
+"smooth_part(values, B, /) -> list[mpz]\n\n"
+"Return the B-smooth part of each value: the largest divisor of abs(x)\n"
+"whose prime factors are all <= B, or 0 for x == 0. B must be less than\n"
+"2**32. The product of the primes <= B is reduced down the product tree\n"
+"of the values (Bernstein's batch smoothness test), so all values cost\n"
+"about as much as a few multiplications of their product. Will always\n"
+"release the GIL unless the total size of the values is less than the\n"
+"context's release_gil_min_bits. The work is split over the context's\n"
+"threads.");
+
+static PyObject *
+GMPy_MPZ_Function_Smooth_Part(PyObject *self, PyObject *args)
+{
+    gmpy_rational_view view;
+    gmpy_product_tree tree;
+    gmpy_smooth_part work;
+    gmpy_interrupt intr;
+    PyObject *result = NULL, *temp;
+    CTXT_Object *context = NULL;
+    unsigned long B;
+    Py_ssize_t i, n;
+    size_t bits;
+    int k, threads;
+    mpz_t P;
+
+    CHECK_CONTEXT(context);
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("smooth_part() requires 2 arguments");
+        return NULL;
+    }
+
+    if (_GMPy_Smooth_Bound(PyTuple_GET_ITEM(args, 1), &B, "smooth_part") < 0)
+        return NULL;
+
+    if (_GMPy_View_Init(&view, PyTuple_GET_ITEM(args, 0), "smooth_part", context) < 0)
+        return NULL;
+
+    if (view.rational) {
+        TYPE_ERROR("smooth_part() requires integer arguments");
+        goto done;
+    }
+
+    n = view.n;
+    if (!(result = PyList_New(n)))
+        goto done;
+    for (i = 0; i < n; i++) {
+        if (!(temp = (PyObject*)GMPy_MPZ_New(context))) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, temp);
+    }
+    if (n == 0)
+        goto done;
+
+    if (_GMPy_Tree_Alloc(&tree, n) < 0) {
+        Py_CLEAR(result);
+        goto done;
+    }
+
+    bits = _GMPy_View_Bits(&view);
+    GMPY_PROFILE_OPN(context, GMPY_OP_GCD, bits / n, n);
+
+    work.view = &view;
+    work.tree = &tree;
+    work.out = PySequence_Fast_ITEMS(result);
+
+    GMPy_Interrupt_Begin(&intr, context);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    intr.save = &_save;
+    threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+    for (i = 0; i < n; i++) {
+        if (mpz_sgn(view.num[i]))
+            mpz_abs(TREE_NODE(&tree, 0, i), view.num[i]);
+        else
+            mpz_set_ui(TREE_NODE(&tree, 0, i), 1);
+    }
+
+    k = tree.depth - 1;
+    if (_GMPy_Tree_Build(&tree, threads) == 0) {
+        mpz_init(P);
+        mpz_primorial_ui(P, B);
+        mpz_mod(TREE_NODE(&tree, k, 0), P, TREE_NODE(&tree, k, 0));
+        mpz_clear(P);
+        if (_GMPy_Tree_Reduce(&tree, _GMPy_Tree_Mod_Range, threads) == 0)
+            GMPy_Parallel_Run(_GMPy_Smooth_Part_Range, &work, n, threads);
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    _GMPy_Tree_Free(&tree);
+    if (GMPy_Interrupt_End(&intr) < 0)
+        Py_CLEAR(result);
+
+  done:
+    _GMPy_View_Clear(&view);
+    return result;
+}
+
+/* Batch trial division. The primes are grouped as in _GMPy_Sieve_Trial()
+ * so each value is reduced once per group with mpz_fdiv_ui(); only the
+ * primes that divide the remainder are then divided out.
+ */
+
+typedef struct {
+    gmpy_rational_view *view;
+    const unsigned long *primes;
+    const gmpy_trial_group *groups;
+    Py_ssize_t ngroups;
+    Py_ssize_t nprimes;
+    unsigned int *exps;
+    PyObject **out;
+} gmpy_trial_factor;
+
+static void
+_GMPy_Trial_Factor_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_trial_factor *work = (gmpy_trial_factor*)arg;
+    unsigned int *exps;
+    unsigned long r, p;
+    Py_ssize_t i, g, j;
+    mpz_ptr z;
+
+    for (i = start; i < stop; i++) {
+        z = MPZ(work->out[i]);
+        exps = work->exps + i * work->nprimes;
+        mpz_abs(z, work->view->num[i]);
+        for (g = 0; g < work->ngroups && mpz_cmp_ui(z, 1) > 0; g++) {
+            r = mpz_fdiv_ui(z, work->groups[g].product);
+            for (j = work->groups[g].start; j < work->groups[g].stop; j++) {
+                p = work->primes[j];
+                if (r % p)
+                    continue;
+                while (mpz_divisible_ui_p(z, p)) {
+                    mpz_divexact_ui(z, z, p);
+                    exps[j]++;
+                }
+            }
+        }
+        if (mpz_sgn(work->view->num[i]) < 0)
+            mpz_neg(z, z);
+    }
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_trial_factor,
+"trial_factor(values, primes, /) -> tuple[memoryview, list[mpz]]\n\n"
+"Divide each nonzero value by the given primes as often as possible.\n"
+"primes is a sequence of primes or an integer B < 2**32 for all primes\n"
+"<= B, taken from the tables of the prime sieve. Returns (exponents,\n"
+"cofactors): exponents is a flat memoryview of unsigned 32-bit integers\n"
+"where exponents[i*len(primes) + j] is the exponent of primes[j] in\n"
+"values[i], and cofactors[i] is what remains of values[i], with its\n"
+"sign. Will always release the GIL unless the total size of the values\n"
+"is less than the context's release_gil_min_bits. The work is split\n"
+"over the context's threads.");
+
+static PyObject *
+GMPy_MPZ_Function_Trial_Factor(PyObject *self, PyObject *args)
+{
+    gmpy_rational_view view;
+    gmpy_trial_factor work;
+    gmpy_trial_group *groups = NULL;
+    PyObject *primes, *seq = NULL, *exps = NULL, *view_obj;
+    PyObject *cofactors = NULL, *result = NULL, *temp;
+    CTXT_Object *context = NULL;
+    unsigned long *plist = NULL, B;
+    MPZ_Object *tempp;
+    Py_ssize_t i, n, k = 0;
+    size_t bits;
+
+    CHECK_CONTEXT(context);
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("trial_factor() requires 2 arguments");
+        return NULL;
+    }
+
+    if (GMPy_Sieve_Init() < 0)
+        return NULL;
+
+    primes = PyTuple_GET_ITEM(args, 1);
+    if (IS_INTEGER(primes)) {
+        if (_GMPy_Smooth_Bound(primes, &B, "trial_factor") < 0 ||
+            !(plist = _GMPy_Sieve_Primes(B, &k)))
+            return NULL;
+    }
+    else {
+        if (!(seq = PySequence_Fast(primes, "trial_factor() requires a sequence of primes")))
+            return NULL;
+        k = PySequence_Fast_GET_SIZE(seq);
+        if (!(plist = PyMem_New(unsigned long, k ? k : 1))) {
+            Py_DECREF(seq);
+            return PyErr_NoMemory();
+        }
+        for (i = 0; i < k; i++) {
+            if (!(tempp = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(seq, i), context))) {
+                TYPE_ERROR("trial_factor() requires integer primes");
+                Py_DECREF(seq);
+                PyMem_Free(plist);
+                return NULL;
+            }
+            if (mpz_cmp_ui(tempp->z, 2) < 0 || !mpz_fits_ulong_p(tempp->z)) {
+                VALUE_ERROR("trial_factor() primes must be >= 2 and fit in an unsigned long");
+                Py_DECREF((PyObject*)tempp);
+                Py_DECREF(seq);
+                PyMem_Free(plist);
+                return NULL;
+            }
+            plist[i] = mpz_get_ui(tempp->z);
+            Py_DECREF((PyObject*)tempp);
+        }
+        Py_DECREF(seq);
+    }
+
+    if (_GMPy_View_Init(&view, PyTuple_GET_ITEM(args, 0), "trial_factor", context) < 0) {
+        PyMem_Free(plist);
+        return NULL;
+    }
+
+    if (view.rational) {
+        TYPE_ERROR("trial_factor() requires integer arguments");
+        goto done;
+    }
+
+    n = view.n;
+    for (i = 0; i < n; i++) {
+        if (mpz_sgn(view.num[i]) == 0) {
+            VALUE_ERROR("trial_factor() requires nonzero values");
+            goto done;
+        }
+    }
+    if (k && n > PY_SSIZE_T_MAX / k / (Py_ssize_t)sizeof(unsigned int)) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    if (!(groups = PyMem_New(gmpy_trial_group, k ? k : 1)) ||
+        !(exps = PyBytes_FromStringAndSize(NULL, n * k * sizeof(unsigned int))) ||
+        !(cofactors = PyList_New(n))) {
+        if (!groups)
+            PyErr_NoMemory();
+        goto done;
+    }
+    for (i = 0; i < n; i++) {
+        if (!(temp = (PyObject*)GMPy_MPZ_New(context)))
+            goto done;
+        PyList_SET_ITEM(cofactors, i, temp);
+    }
+
+    work.view = &view;
+    work.primes = plist;
+    work.groups = groups;
+    work.ngroups = _GMPy_Sieve_Groups(plist, k, groups);
+    work.nprimes = k;
+    work.exps = (unsigned int*)PyBytes_AS_STRING(exps);
+    work.out = PySequence_Fast_ITEMS(cofactors);
+    memset(work.exps, 0, n * k * sizeof(unsigned int));
+
+    bits = _GMPy_View_Bits(&view);
+    if (n)
+        GMPY_PROFILE_OPN(context, GMPY_OP_MOD, bits / n, n);
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    GMPy_Parallel_Run(_GMPy_Trial_Factor_Range, &work, n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if ((view_obj = PyMemoryView_FromObject(exps))) {
+        if ((temp = PyObject_CallMethod(view_obj, "cast", "s", "I"))) {
+            result = PyTuple_Pack(2, temp, cofactors);
+            Py_DECREF(temp);
+        }
+        Py_DECREF(view_obj);
+    }
+
+  done:
+    Py_XDECREF(exps);
+    Py_XDECREF(cofactors);
+    PyMem_Free(groups);
+    PyMem_Free(plist);
+    _GMPy_View_Clear(&view);
+    return result;
+}
@@ -0,0 +1,64 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_tree.h                                                            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2000 - 2009 Alex Martelli                                     *
+ *                                                                         *
+ * Copyright 2008 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_TREE_H
+#define GMPY_TREE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A product tree stores the leaves at level 0 and the product of each pair
+ * of nodes at the next level. See gmpy2_tree.c.
+ */
+
+typedef struct {
+    mpz_t *node;
+    Py_ssize_t offset[64];      /* first node of each level */
+    Py_ssize_t size[64];        /* number of nodes in each level */
+    int depth;
+} gmpy_product_tree;
+
+/* fac(), primorial(), and bincoef() switch to the split product, which is
+ * computed in parallel when context.threads > 1 and can be interrupted,
+ * when the argument is at least GMPY_SPLIT_MIN.
+ */
+
+#define GMPY_SPLIT_MIN (1UL << 20)
+
+static void _GMPy_Split_Fac(mpz_ptr z, int which, unsigned long n,
+                            unsigned long k, int threads);
+
+static PyObject * GMPy_Context_Prod(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_Remainder_Tree(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_Batch_GCD(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPZ_Function_Smooth_Part(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_Trial_Factor(PyObject *self, PyObject *args);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -99,10 +99,15 @@ GMPy_Rational_TrueDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
                               CTXT_Object *context)
 {
     MPQ_Object *result = NULL, *tempx = NULL, *tempy = NULL;
+    mp_size_t size = 1;
 
     CHECK_CONTEXT(context);
 
-    if (!(result = GMPy_MPQ_New(context)))
+    /* Pick a cached object that is large enough for the result. */
+    if (IS_TYPE_MPQ(xtype) && IS_TYPE_MPQ(ytype))
+        size = MPQ_SIZE(MPQ(x)) + MPQ_SIZE(MPQ(y));
+
+    if (!(result = GMPy_MPQ_NewSize(size, context)))
         return NULL;
 
     if (IS_TYPE_MPQ(xtype) && IS_TYPE_MPQ(ytype)) {
@@ -113,7 +118,7 @@ GMPy_Rational_TrueDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             Py_DECREF((PyObject*)result);
             return NULL;
         }
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(MPQ(x), MPQ(y)));
         mpq_div(result->q, MPQ(x), MPQ(y));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         return (PyObject*)result;
@@ -138,7 +143,7 @@ GMPy_Rational_TrueDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
             return NULL;
         }
 
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPQ_BITS2(tempx->q, tempy->q));
         mpq_div(result->q, tempx->q, tempy->q);
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_DECREF((PyObject*)tempx);
@@ -165,13 +170,18 @@ GMPy_Real_TrueDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
 
     CHECK_CONTEXT(context);
 
-    if (!(result = GMPy_MPFR_New(0, context))) {
+    if (!(result = GMPy_MPFR_Reuse(x, xtype, context)) &&
+        !(result = GMPy_MPFR_Reuse(y, ytype, context)) &&
+        !(result = GMPy_MPFR_New(0, context))) {
         /* LCOV_EXCL_START */
         return NULL;
         /* LCOV_EXCL_STOP */
     }
 
     if (IS_TYPE_MPFR(xtype) && IS_TYPE_MPFR(ytype)) {
+        if (_GMPy_MPFR_Fast(GMPY_FAST_DIV, &result, MPFR(x), MPFR(y), context))
+            return (PyObject*)result;
+
         mpfr_clear_flags();
 
         result->rc = mpfr_div(result->f, MPFR(x), MPFR(y), GET_MPFR_ROUND(context));
@@ -224,14 +234,15 @@ GMPy_Complex_TrueDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
     if (IS_TYPE_MPC(xtype) && IS_TYPE_MPC(ytype)) {
 
         if (MPC_IS_ZERO_P(y)) {
-            context->ctx.divzero = 1;
+            GMPY_CTXT_FLAGS(context)->divzero = 1;
             if (context->ctx.traps & TRAP_DIVZERO) {
                 GMPY_DIVZERO("'mpc' division by zero");
                 Py_DECREF((PyObject*)result);
                 return NULL;
             }
         }
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context,
+                Py_MAX(GET_REAL_PREC(context), GET_IMAG_PREC(context)));
         result->rc = mpc_div(result->c, MPC(x), MPC(y), GET_MPC_ROUND(context));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         _GMPy_MPC_Cleanup(&result, context);
@@ -265,25 +276,30 @@ GMPy_Complex_TrueDivWithType(PyObject *x, int xtype, PyObject *y, int ytype,
     /* LCOV_EXCL_STOP */
 }
 
+/* Indexed by GMPY_TYPE_CLASS2(xtype, ytype). */
+
+static gmpy_binary_withtype const GMPy_TrueDiv_Table[OBJ_CLASS_COUNT] = {
+    GMPy_Integer_TrueDivWithType,
+    GMPy_Rational_TrueDivWithType,
+    GMPy_Real_TrueDivWithType,
+    GMPy_Complex_TrueDivWithType,
+};
+
 /* Implement all the slot methods here. */
 
 static PyObject *
 GMPy_Number_TrueDiv_Slot(PyObject *x, PyObject *y)
 {
+    CTXT_Object *context = NULL;
+    CHECK_CONTEXT(context);
+
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_TrueDivWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_TrueDivWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_TrueDivWithType(x, xtype, y, ytype, NULL);
+    GMPY_PROFILE_OP2(context, GMPY_OP_TRUEDIV, x, xtype, y, ytype);
 
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_TrueDivWithType(x, xtype, y, ytype, NULL);
+    if (xtype && ytype)
+        return GMPy_TrueDiv_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, context);
 
     Py_RETURN_NOTIMPLEMENTED;
 }
@@ -298,17 +314,10 @@ GMPy_Number_TrueDiv(PyObject *x, PyObject *y, CTXT_Object *context)
     int xtype = GMPy_ObjectType(x);
     int ytype = GMPy_ObjectType(y);
 
-    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
-        return GMPy_Integer_TrueDivWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
-        return GMPy_Rational_TrueDivWithType(x, xtype, y, ytype, NULL);
-
-    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
-        return GMPy_Real_TrueDivWithType(x, xtype, y, ytype, NULL);
+    GMPY_PROFILE_OP2(context, GMPY_OP_TRUEDIV, x, xtype, y, ytype);
 
-    if (IS_TYPE_COMPLEX(xtype) && IS_TYPE_COMPLEX(ytype))
-        return GMPy_Complex_TrueDivWithType(x, xtype, y, ytype, NULL);
+    if (xtype && ytype)
+        return GMPy_TrueDiv_Table[GMPY_TYPE_CLASS2(xtype, ytype)](x, xtype, y, ytype, NULL);
 
     TYPE_ERROR("div() argument type not supported");
     return NULL;
@@ -88,11 +88,16 @@ typedef struct {
     int allow_complex;       /* if 1, allow mpfr functions to return an mpc */
     int rational_division;   /* if 1, mpz/mpz returns an mpq result */
     int allow_release_gil;   /* if 1, release GIL for mpz operations */
+    long release_gil_min_bits; /* only release the GIL for larger operands */
+    int threads;             /* threads used by the list functions */
+    int profile;             /* if 1, collect statistics in CTXT_Object */
 } gmpy_context;
 
 typedef struct {
     PyObject_HEAD
     gmpy_context ctx;
+    struct gmpy_profile *profile; /* allocated when first needed */
+    int frozen;                   /* if 1, settings are read-only */
 } CTXT_Object;
 
 typedef struct {
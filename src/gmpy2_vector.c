@@ -24,72 +24,2910 @@
  * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
-/* The following code was a test case for creating a gmpy2 function that would
- * apply an MPFR function to all the elements of a list. It was slightly faster
- * than map(gmpy2.list, <<list>>) but not enough to justify the effort. The
- * code is left for possible future use.
+/* Apply a unary MPFR or MPC function to all the elements of a sequence.
+ *
+ * The gmpy2 function is looked up once in vector_kernels[]. If all the
+ * elements are real, the arguments are converted and the results are
+ * allocated before the GIL is released; the loop itself only calls MPFR.
+ * The MPFR flags are accumulated over the whole loop, so a trapped flag
+ * raises an exception if any element raised it. Complex arguments use the
+ * MPC version of the function with the GIL held. Any other callable is
+ * called for each element with the context set as the current context.
+ * The elements of an mpfr_array or mpc_array are used in place and the
+ * results are stored in a new array of the same type and precision.
  */
 
-PyDoc_STRVAR(GMPy_doc_function_vector,
-"vector(iterable, /) -> list\n\n"
-"Template for applying a function to an iterable.");
+typedef int (*gmpy_mpfr_uniop)(mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+typedef int (*gmpy_mpc_uniop)(mpc_ptr, mpc_srcptr, mpc_rnd_t);
+
+typedef struct {
+    PyCFunction func;          /* the gmpy2 function, i.e. GMPy_Context_Sin */
+    gmpy_mpfr_uniop mpfr_func;
+    gmpy_mpc_uniop mpc_func;   /* NULL if there is no MPC version */
+    int allow_complex;         /* if 1, the result for a real argument can
+                                * be an mpc when allow_complex is set */
+} gmpy_vector_kernel;
+
+#define VECTOR_KERNEL(NAME, FUNC) \
+    { GMPy_Context_##NAME, mpfr_##FUNC, mpc_##FUNC, 0 }
+#define VECTOR_KERNEL_MPFR(NAME, FUNC) \
+    { GMPy_Context_##NAME, mpfr_##FUNC, NULL, 0 }
+
+static gmpy_vector_kernel vector_kernels[] = {
+    VECTOR_KERNEL(Sin, sin),
+    VECTOR_KERNEL(Cos, cos),
+    VECTOR_KERNEL(Tan, tan),
+    VECTOR_KERNEL(Atan, atan),
+    VECTOR_KERNEL(Sinh, sinh),
+    VECTOR_KERNEL(Cosh, cosh),
+    VECTOR_KERNEL(Tanh, tanh),
+    VECTOR_KERNEL(Asinh, asinh),
+    VECTOR_KERNEL(Acosh, acosh),
+    VECTOR_KERNEL(Log, log),
+    VECTOR_KERNEL(Log10, log10),
+    VECTOR_KERNEL(Exp, exp),
+    { GMPy_Context_Sqrt, mpfr_sqrt, mpc_sqrt, 1 },
+    VECTOR_KERNEL_MPFR(Sec, sec),
+    VECTOR_KERNEL_MPFR(Csc, csc),
+    VECTOR_KERNEL_MPFR(Cot, cot),
+    VECTOR_KERNEL_MPFR(Sech, sech),
+    VECTOR_KERNEL_MPFR(Csch, csch),
+    VECTOR_KERNEL_MPFR(Coth, coth),
+    VECTOR_KERNEL_MPFR(RecSqrt, rec_sqrt),
+    VECTOR_KERNEL_MPFR(Rint, rint),
+    VECTOR_KERNEL_MPFR(RintCeil, rint_ceil),
+    VECTOR_KERNEL_MPFR(RintFloor, rint_floor),
+    VECTOR_KERNEL_MPFR(RintRound, rint_round),
+    VECTOR_KERNEL_MPFR(RintTrunc, rint_trunc),
+    VECTOR_KERNEL_MPFR(Frac, frac),
+    VECTOR_KERNEL_MPFR(Cbrt, cbrt),
+    VECTOR_KERNEL_MPFR(Log2, log2),
+    VECTOR_KERNEL_MPFR(Exp2, exp2),
+    VECTOR_KERNEL_MPFR(Exp10, exp10),
+    VECTOR_KERNEL_MPFR(Log1p, log1p),
+    VECTOR_KERNEL_MPFR(Expm1, expm1),
+    VECTOR_KERNEL_MPFR(Eint, eint),
+    VECTOR_KERNEL_MPFR(Li2, li2),
+    VECTOR_KERNEL_MPFR(Gamma, gamma),
+    VECTOR_KERNEL_MPFR(Lngamma, lngamma),
+    VECTOR_KERNEL_MPFR(Digamma, digamma),
+    VECTOR_KERNEL_MPFR(Zeta, zeta),
+    VECTOR_KERNEL_MPFR(Erf, erf),
+    VECTOR_KERNEL_MPFR(Erfc, erfc),
+    VECTOR_KERNEL_MPFR(J0, j0),
+    VECTOR_KERNEL_MPFR(J1, j1),
+    VECTOR_KERNEL_MPFR(Y0, y0),
+    VECTOR_KERNEL_MPFR(Y1, y1),
+    VECTOR_KERNEL_MPFR(Ai, ai),
+    { NULL, NULL, NULL, 0 }
+};
+
+static gmpy_vector_kernel *
+_GMPy_Vector_Kernel(PyObject *func)
+{
+    gmpy_vector_kernel *kernel;
+    PyCFunction meth;
+
+    if (!PyCFunction_Check(func) || !(PyCFunction_GetFlags(func) & METH_O))
+        return NULL;
+
+    meth = PyCFunction_GetFunction(func);
+    for (kernel = vector_kernels; kernel->func; kernel++) {
+        if (kernel->func == meth)
+            return kernel;
+    }
+    return NULL;
+}
+
+static PyObject *
+_GMPy_Vector_Real(gmpy_vector_kernel *kernel, PyObject **items, int *types,
+                  Py_ssize_t n, CTXT_Object *context)
+{
+    PyObject *result;
+    MPFR_Object **args, *tempres;
+    mpfr_rnd_t round = GET_MPFR_ROUND(context);
+    Py_ssize_t i;
+
+    if (!(args = PyMem_New(MPFR_Object*, n)))
+        return PyErr_NoMemory();
+
+    /* Keep a reference to every argument; the sequence could be changed by
+     * another thread while the GIL is released.
+     */
+
+    for (i = 0; i < n; i++) {
+        if (!(args[i] = GMPy_MPFR_From_RealWithType(items[i], types[i], 1, context))) {
+            while (i--)
+                Py_DECREF((PyObject*)args[i]);
+            PyMem_Free(args);
+            return NULL;
+        }
+    }
+
+    if (!(result = PyList_New(n)))
+        goto done;
+
+    for (i = 0; i < n; i++) {
+        if (!(tempres = GMPy_MPFR_New(0, context))) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, (PyObject*)tempres);
+    }
+
+    mpfr_clear_flags();
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)GET_MPFR_PREC(context) * n);
+    for (i = 0; i < n; i++) {
+        tempres = (MPFR_Object*)PyList_GET_ITEM(result, i);
+        tempres->rc = kernel->mpfr_func(tempres->f, args[i]->f, round);
+        _GMPy_MPFR_Check_Range(tempres, context, round);
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (_GMPy_MPFR_Exceptions(context) < 0)
+        Py_CLEAR(result);
+
+  done:
+    for (i = 0; i < n; i++)
+        Py_DECREF((PyObject*)args[i]);
+    PyMem_Free(args);
+    return result;
+}
+
+static PyObject *
+_GMPy_Vector_Complex(gmpy_vector_kernel *kernel, PyObject **items, int *types,
+                     Py_ssize_t n, CTXT_Object *context)
+{
+    PyObject *result;
+    MPC_Object *tempx, *tempres;
+    Py_ssize_t i;
+
+    if (!(result = PyList_New(n)))
+        return NULL;
+
+    for (i = 0; i < n; i++) {
+        if (!(tempx = GMPy_MPC_From_ComplexWithType(items[i], types[i], 1, 1, context))) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        if (!(tempres = GMPy_MPC_New(0, 0, context))) {
+            Py_DECREF((PyObject*)tempx);
+            Py_DECREF(result);
+            return NULL;
+        }
+        tempres->rc = kernel->mpc_func(tempres->c, tempx->c, GET_MPC_ROUND(context));
+        Py_DECREF((PyObject*)tempx);
+        _GMPy_MPC_Cleanup(&tempres, context);
+        if (!tempres) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, i, (PyObject*)tempres);
+    }
+    return result;
+}
+
+static PyObject *
+_GMPy_Vector_Array(gmpy_vector_kernel *kernel, MPFR_Array_Object *x,
+                   CTXT_Object *context)
+{
+    MPFR_Array_Object *result;
+    Py_ssize_t i;
+
+    if (!(result = GMPy_MPFR_Array_New(Py_TYPE(x), x->size, x->prec)))
+        return NULL;
+
+    mpfr_clear_flags();
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)x->prec * x->size);
+    if (MPC_Array_Check(x)) {
+        mpc_t a, r;
+        int rc;
+
+        for (i = 0; i < x->size; i++) {
+            _GMPy_MPC_Array_Load(a, x, i);
+            _GMPy_MPC_Array_Load(r, result, i);
+            rc = kernel->mpc_func(r, a, GET_MPC_ROUND(context));
+            _GMPy_MPFR_Range(mpc_realref(r), MPC_INEX_RE(rc), context, GET_REAL_ROUND(context));
+            _GMPy_MPFR_Range(mpc_imagref(r), MPC_INEX_IM(rc), context, GET_IMAG_ROUND(context));
+            _GMPy_MPC_Array_Store(result, i, r);
+        }
+    }
+    else {
+        mpfr_rnd_t round = GET_MPFR_ROUND(context);
+
+        for (i = 0; i < x->size; i++)
+            _GMPy_MPFR_Range(result->f[i], kernel->mpfr_func(result->f[i], x->f[i], round),
+                             context, round);
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (_GMPy_MPFR_Exceptions(context) < 0)
+        Py_CLEAR(result);
+    return (PyObject*)result;
+}
+
+static PyObject *
+_GMPy_Vector_Call(PyObject *func, PyObject **items, Py_ssize_t n,
+                  CTXT_Object *context)
+{
+    PyObject *result, *old, *temp;
+    Py_ssize_t i;
+
+    if (!(old = GMPy_current_context()))
+        return NULL;
+
+    if (old != (PyObject*)context) {
+        if (!(temp = GMPy_CTXT_Set(NULL, (PyObject*)context))) {
+            Py_DECREF(old);
+            return NULL;
+        }
+        Py_DECREF(temp);
+    }
+
+    if ((result = PyList_New(n))) {
+        for (i = 0; i < n; i++) {
+            if (!(temp = PyObject_CallFunctionObjArgs(func, items[i], NULL))) {
+                Py_CLEAR(result);
+                break;
+            }
+            PyList_SET_ITEM(result, i, temp);
+        }
+    }
+
+    if (old != (PyObject*)context) {
+        if (!(temp = GMPy_CTXT_Set(NULL, old)))
+            Py_CLEAR(result);
+        else
+            Py_DECREF(temp);
+    }
+    Py_DECREF(old);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_vmap,
+"vmap(func, iterable, /) -> list\n\n"
+"Return [func(x) for x in iterable] using the current context. For the\n"
+"unary MPFR and MPC functions of gmpy2, i.e. sin() or gamma(), the loop\n"
+"runs in C and, for real arguments, without the GIL. Trapped exceptions\n"
+"are raised if any element triggers them. Other callables are called\n"
+"for each element. For an mpfr_array or mpc_array, these functions\n"
+"return a new array with the precision of iterable.");
 
 PyDoc_STRVAR(GMPy_doc_context_vector,
-"vector(iterable, /) -> list\n\n"
-"Template for applying a function to an iterable.");
+"context.vector(func, iterable, /) -> list\n\n"
+"Return [func(x) for x in iterable] using this context. For the unary\n"
+"MPFR and MPC functions of gmpy2, i.e. sin() or gamma(), the loop runs\n"
+"in C and, for real arguments, without the GIL. Trapped exceptions are\n"
+"raised if any element triggers them. Other callables are called for\n"
+"each element with this context as the current context. For an\n"
+"mpfr_array or mpc_array, these functions return a new array with the\n"
+"precision of iterable.");
+
+static PyObject *
+GMPy_Context_Vector(PyObject *self, PyObject *args)
+{
+    PyObject *func, *seq, *result = NULL, **items;
+    gmpy_vector_kernel *kernel;
+    CTXT_Object *context = NULL;
+    Py_ssize_t i, n;
+    int *types = NULL, is_real = 1, is_complex = 1;
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("vector() requires 2 arguments");
+        return NULL;
+    }
+
+    func = PyTuple_GET_ITEM(args, 0);
+    if (!PyCallable_Check(func)) {
+        TYPE_ERROR("vector() requires a callable as first argument");
+        return NULL;
+    }
+
+    /* A context method bound to a context uses that context. */
+
+    if (self && CTXT_Check(self)) {
+        context = (CTXT_Object*)self;
+    }
+    else if (PyCFunction_Check(func) && PyCFunction_GetSelf(func) &&
+             CTXT_Check(PyCFunction_GetSelf(func))) {
+        context = (CTXT_Object*)PyCFunction_GetSelf(func);
+    }
+    else {
+        CHECK_CONTEXT(context);
+    }
+
+    seq = PyTuple_GET_ITEM(args, 1);
+    if (MPFR_Array_Check(seq) || MPC_Array_Check(seq)) {
+        kernel = _GMPy_Vector_Kernel(func);
+        if (kernel && (MPC_Array_Check(seq) ? kernel->mpc_func != NULL :
+                       !(kernel->allow_complex && context->ctx.allow_complex)))
+            return _GMPy_Vector_Array(kernel, (MPFR_Array_Object*)seq, context);
+    }
+
+    if (!(seq = PySequence_Fast(seq, "vector() requires an iterable as second argument"))) {
+        return NULL;
+    }
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    items = PySequence_Fast_ITEMS(seq);
+
+    kernel = _GMPy_Vector_Kernel(func);
+    if (kernel && kernel->allow_complex && context->ctx.allow_complex)
+        kernel = NULL;
+
+    /* Mixed real and complex arguments are left to the function. */
+
+    if (kernel) {
+        if (!(types = PyMem_New(int, n ? n : 1))) {
+            Py_DECREF(seq);
+            return PyErr_NoMemory();
+        }
+        for (i = 0; i < n; i++) {
+            types[i] = GMPy_ObjectType(items[i]);
+            is_real = is_real && IS_TYPE_REAL(types[i]);
+            is_complex = is_complex && IS_TYPE_COMPLEX(types[i]) &&
+                         !IS_TYPE_REAL(types[i]);
+        }
+        if (!kernel->mpc_func)
+            is_complex = 0;
+    }
+
+    if (kernel && is_real)
+        result = _GMPy_Vector_Real(kernel, items, types, n, context);
+    else if (kernel && is_complex)
+        result = _GMPy_Vector_Complex(kernel, items, types, n, context);
+    else
+        result = _GMPy_Vector_Call(func, items, n, context);
+
+    PyMem_Free(types);
+    Py_DECREF(seq);
+    return result;
+}
+
+/* Batched binary arithmetic. Each argument is either a sequence or a single
+ * number that is broadcast against the other sequence. When every pair of
+ * elements is of the same kind (integer, rational, or real), the operands
+ * are converted once and the whole loop runs without the GIL. Any other
+ * combination is delegated to GMPy_Number_Add() and friends.
+ */
+
+#define VECTOR_OTHER    0
+#define VECTOR_INTEGER  1
+#define VECTOR_RATIONAL 2
+#define VECTOR_REAL     3
+#define VECTOR_COMPLEX  4  /* only used by polyval() */
+
+static int
+_GMPy_Vector_Kind(int xtype, int ytype)
+{
+    if (IS_TYPE_INTEGER(xtype) && IS_TYPE_INTEGER(ytype))
+        return VECTOR_INTEGER;
+    if (IS_TYPE_RATIONAL(xtype) && IS_TYPE_RATIONAL(ytype))
+        return VECTOR_RATIONAL;
+    if (IS_TYPE_REAL(xtype) && IS_TYPE_REAL(ytype))
+        return VECTOR_REAL;
+    return VECTOR_OTHER;
+}
+
+static PyObject *
+_GMPy_Vector_Number(int op, PyObject *x, PyObject *y, CTXT_Object *context)
+{
+    switch (op) {
+        case GMPY_OP_ADD:
+            return GMPy_Number_Add(x, y, context);
+        case GMPY_OP_SUB:
+            return GMPy_Number_Sub(x, y, context);
+        case GMPY_OP_MUL:
+            return GMPy_Number_Mul(x, y, context);
+        case GMPY_OP_TRUEDIV:
+            return GMPy_Number_TrueDiv(x, y, context);
+        default:
+            return GMPy_Number_Mod(x, y, context);
+    }
+}
+
+static PyObject *
+_GMPy_Vector_Convert(PyObject *obj, int type, int kind, CTXT_Object *context)
+{
+    switch (kind) {
+        case VECTOR_INTEGER:
+            return (PyObject*)GMPy_MPZ_From_IntegerWithType(obj, type, context);
+        case VECTOR_RATIONAL:
+            return (PyObject*)GMPy_MPQ_From_RationalWithType(obj, type, context);
+        default:
+            return (PyObject*)GMPy_MPFR_From_RealWithType(obj, type, 1, context);
+    }
+}
+
+/* Return 1 if the operation is done by _GMPy_Vector_Fast() for operands of
+ * the given kind.
+ */
+
+static int
+_GMPy_Vector_HasFast(int op, int kind)
+{
+    if (kind == VECTOR_OTHER)
+        return 0;
+    if (op == GMPY_OP_TRUEDIV)
+        return kind != VECTOR_INTEGER;
+    if (op == GMPY_OP_MOD)
+        return kind == VECTOR_INTEGER;
+    return 1;
+}
+
+static PyObject *
+_GMPy_Vector_Fast(int op, int kind, PyObject **xitems, int *xtypes,
+                  Py_ssize_t xstep, PyObject **yitems, int *ytypes,
+                  Py_ssize_t ystep, Py_ssize_t n, CTXT_Object *context)
+{
+    PyObject *result = NULL, *temp, **args;
+    PyObject **xargs, **yargs;
+    mpfr_rnd_t round = GET_MPFR_ROUND(context);
+    size_t bits = 0;
+    Py_ssize_t i;
+
+    if (!(args = PyMem_New(PyObject*, 2 * (n ? n : 1))))
+        return PyErr_NoMemory();
+    xargs = args;
+    yargs = args + n;
+
+    /* Keep a reference to every operand; the sequences could be changed by
+     * another thread while the GIL is released. A broadcast scalar is only
+     * converted once.
+     */
+
+    for (i = 0; i < n; i++) {
+        if (i && !xstep) {
+            xargs[i] = xargs[0];
+            Py_INCREF(xargs[i]);
+        }
+        else if (!(xargs[i] = _GMPy_Vector_Convert(xitems[i * xstep],
+                                                  xtypes[i * xstep],
+                                                  kind, context))) {
+            while (i--)
+                Py_DECREF(xargs[i]);
+            PyMem_Free(args);
+            return NULL;
+        }
+    }
+    for (i = 0; i < n; i++) {
+        if (i && !ystep) {
+            yargs[i] = yargs[0];
+            Py_INCREF(yargs[i]);
+        }
+        else if (!(yargs[i] = _GMPy_Vector_Convert(yitems[i * ystep],
+                                                  ytypes[i * ystep],
+                                                  kind, context))) {
+            while (i--)
+                Py_DECREF(yargs[i]);
+            for (i = 0; i < n; i++)
+                Py_DECREF(xargs[i]);
+            PyMem_Free(args);
+            return NULL;
+        }
+    }
+
+    for (i = 0; i < n; i++) {
+        if (kind == VECTOR_INTEGER) {
+            if (op == GMPY_OP_MOD && mpz_sgn(MPZ(yargs[i])) == 0) {
+                ZERO_ERROR("division or modulo by zero");
+                goto done;
+            }
+            bits += GMPY_MPZ_BITS2(MPZ(xargs[i]), MPZ(yargs[i]));
+        }
+        else if (kind == VECTOR_RATIONAL) {
+            if (op == GMPY_OP_TRUEDIV && mpq_sgn(MPQ(yargs[i])) == 0) {
+                ZERO_ERROR("division or modulo by zero");
+                goto done;
+            }
+            bits += GMPY_MPQ_BITS2(MPQ(xargs[i]), MPQ(yargs[i]));
+        }
+    }
+    if (kind == VECTOR_REAL)
+        bits = (size_t)GET_MPFR_PREC(context) * n;
+
+    if (!(result = PyList_New(n)))
+        goto done;
+
+    for (i = 0; i < n; i++) {
+        if (kind == VECTOR_INTEGER)
+            temp = (PyObject*)GMPy_MPZ_New(context);
+        else if (kind == VECTOR_RATIONAL)
+            temp = (PyObject*)GMPy_MPQ_New(context);
+        else
+            temp = (PyObject*)GMPy_MPFR_New(0, context);
+        if (!temp) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, temp);
+    }
+
+    if (n)
+        GMPY_PROFILE_OPN(context, op, bits / n, n);
+
+    if (kind == VECTOR_REAL)
+        mpfr_clear_flags();
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    for (i = 0; i < n; i++) {
+        temp = PyList_GET_ITEM(result, i);
+        if (kind == VECTOR_INTEGER) {
+            switch (op) {
+                case GMPY_OP_ADD:
+                    mpz_add(MPZ(temp), MPZ(xargs[i]), MPZ(yargs[i]));
+                    break;
+                case GMPY_OP_SUB:
+                    mpz_sub(MPZ(temp), MPZ(xargs[i]), MPZ(yargs[i]));
+                    break;
+                case GMPY_OP_MUL:
+                    mpz_mul(MPZ(temp), MPZ(xargs[i]), MPZ(yargs[i]));
+                    break;
+                default:
+                    mpz_fdiv_r(MPZ(temp), MPZ(xargs[i]), MPZ(yargs[i]));
+                    break;
+            }
+        }
+        else if (kind == VECTOR_RATIONAL) {
+            switch (op) {
+                case GMPY_OP_ADD:
+                    mpq_add(MPQ(temp), MPQ(xargs[i]), MPQ(yargs[i]));
+                    break;
+                case GMPY_OP_SUB:
+                    mpq_sub(MPQ(temp), MPQ(xargs[i]), MPQ(yargs[i]));
+                    break;
+                case GMPY_OP_MUL:
+                    mpq_mul(MPQ(temp), MPQ(xargs[i]), MPQ(yargs[i]));
+                    break;
+                default:
+                    mpq_div(MPQ(temp), MPQ(xargs[i]), MPQ(yargs[i]));
+                    break;
+            }
+        }
+        else {
+            MPFR_Object *res = (MPFR_Object*)temp;
+
+            switch (op) {
+                case GMPY_OP_ADD:
+                    res->rc = mpfr_add(res->f, MPFR(xargs[i]), MPFR(yargs[i]), round);
+                    break;
+                case GMPY_OP_SUB:
+                    res->rc = mpfr_sub(res->f, MPFR(xargs[i]), MPFR(yargs[i]), round);
+                    break;
+                case GMPY_OP_MUL:
+                    res->rc = mpfr_mul(res->f, MPFR(xargs[i]), MPFR(yargs[i]), round);
+                    break;
+                default:
+                    res->rc = mpfr_div(res->f, MPFR(xargs[i]), MPFR(yargs[i]), round);
+                    break;
+            }
+            _GMPy_MPFR_Check_Range(res, context, round);
+        }
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (kind == VECTOR_REAL && _GMPy_MPFR_Exceptions(context) < 0)
+        Py_CLEAR(result);
+
+  done:
+    for (i = 0; i < 2 * n; i++)
+        Py_DECREF(args[i]);
+    PyMem_Free(args);
+    return result;
+}
+
+/* Elementwise integer operations on mpz_array objects. Each of the nops
+ * operands is an mpz_array or a single integer that is broadcast against
+ * the arrays, which must all have the same length. The results are stored
+ * in out, which may be one of the operands, or in a new mpz_array. The
+ * operands are checked before the GIL is released.
+ */
+
+#define VECTOR_OP_CMP -1    /* not one of the GMPY_OP_* profile counters */
+
+static PyObject *
+_GMPy_Vector_MPZ_Array(int op, PyObject **ops, int nops, PyObject *out,
+                       const char *name, CTXT_Object *context)
+{
+    MPZ_Array_Object *result = NULL;
+    MPZ_Object *scalar[3] = {NULL, NULL, NULL};
+    mpz_t *z[3], mm;
+    Py_ssize_t i, n = -1, step[3], size;
+    size_t bits = 0;
+    int j, sign;
+
+    for (j = 0; j < nops; j++) {
+        if (MPZ_Array_Check(ops[j])) {
+            z[j] = ((MPZ_Array_Object*)ops[j])->z;
+            size = ((MPZ_Array_Object*)ops[j])->size;
+            step[j] = 1;
+            if (n >= 0 && size != n) {
+                PyErr_Format(PyExc_ValueError,
+                             "%s() requires sequences of the same length", name);
+                goto done;
+            }
+            n = size;
+        }
+        else {
+            if (!(scalar[j] = GMPy_MPZ_From_Integer(ops[j], context)))
+                goto done;
+            z[j] = &scalar[j]->z;
+            step[j] = 0;
+        }
+    }
+
+    if (n < 0) {
+        PyErr_Format(PyExc_TypeError,
+                     "%s() requires at least one sequence argument", name);
+        goto done;
+    }
+
+    if (out && (!MPZ_Array_Check(out) || ((MPZ_Array_Object*)out)->size != n)) {
+        PyErr_Format(PyExc_ValueError,
+                     "%s() out must be an mpz_array of length %zd", name, n);
+        goto done;
+    }
+
+    for (i = 0; i < n; i++) {
+        switch (op) {
+            case GMPY_OP_MOD:
+                if (mpz_sgn(z[1][i * step[1]]) == 0) {
+                    ZERO_ERROR("division or modulo by zero");
+                    goto done;
+                }
+                break;
+            case GMPY_OP_POWMOD:
+                if (mpz_sgn(z[1][i * step[1]]) < 0) {
+                    PyErr_Format(PyExc_ValueError, "%s() exponent must be >= 0", name);
+                    goto done;
+                }
+                if (mpz_sgn(z[2][i * step[2]]) == 0) {
+                    PyErr_Format(PyExc_ValueError, "%s() modulus cannot be 0", name);
+                    goto done;
+                }
+                bits += mpz_sizeinbase(z[1][i * step[1]], 2) *
+                        GMPY_MPZ_BITS(z[2][i * step[2]]);
+                break;
+            case GMPY_OP_ROOT:
+                if (mpz_sgn(z[0][i * step[0]]) < 0) {
+                    PyErr_Format(PyExc_ValueError, "%s() of negative number", name);
+                    goto done;
+                }
+                break;
+        }
+        bits += GMPY_MPZ_BITS(z[0][i * step[0]]);
+        if (nops > 1)
+            bits += GMPY_MPZ_BITS(z[1][i * step[1]]);
+    }
+
+    if (out) {
+        Py_INCREF(out);
+        result = (MPZ_Array_Object*)out;
+    }
+    else if (!(result = GMPy_MPZ_Array_New(n))) {
+        goto done;
+    }
+
+    if (n && op >= 0)
+        GMPY_PROFILE_OPN(context, op, bits / n, n);
+
+    /* The operands must not be resized by another thread during the loop. */
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    mpz_init(mm);
+    for (i = 0; i < n; i++) {
+        mpz_ptr r = result->z[i];
+        mpz_srcptr x = z[0][i * step[0]];
+
+        switch (op) {
+            case GMPY_OP_ADD:
+                mpz_add(r, x, z[1][i * step[1]]);
+                break;
+            case GMPY_OP_SUB:
+                mpz_sub(r, x, z[1][i * step[1]]);
+                break;
+            case GMPY_OP_MUL:
+                mpz_mul(r, x, z[1][i * step[1]]);
+                break;
+            case GMPY_OP_MOD:
+                mpz_fdiv_r(r, x, z[1][i * step[1]]);
+                break;
+            case GMPY_OP_POWMOD:
+                /* Same sign convention as powmod(). */
+                sign = mpz_sgn(z[2][i * step[2]]);
+                mpz_abs(mm, z[2][i * step[2]]);
+                mpz_powm(r, x, z[1][i * step[1]], mm);
+                if (sign < 0 && mpz_sgn(r) > 0)
+                    mpz_sub(r, r, mm);
+                break;
+            case GMPY_OP_ROOT:
+                mpz_sqrt(r, x);
+                break;
+            default:
+                sign = mpz_cmp(x, z[1][i * step[1]]);
+                mpz_set_si(r, (sign > 0) - (sign < 0));
+                break;
+        }
+    }
+    mpz_clear(mm);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+  done:
+    for (j = 0; j < nops; j++)
+        Py_XDECREF((PyObject*)scalar[j]);
+    return (PyObject*)result;
+}
+
+/* Elementwise real arithmetic on mpfr_array objects. One of x and y is an
+ * mpfr_array, the other one is an mpfr_array of the same length or a real
+ * number that is used for every element. The result has the larger
+ * precision of the arrays and is rounded with the context.
+ */
+
+static PyObject *
+_GMPy_Vector_MPFR_Array(int op, PyObject *x, PyObject *y, const char *name,
+                        CTXT_Object *context)
+{
+    MPFR_Array_Object *result = NULL;
+    MPFR_Object *scalar = NULL;
+    mpfr_t *xf, *yf;
+    mpfr_prec_t prec = 0;
+    mpfr_rnd_t round = GET_MPFR_ROUND(context);
+    Py_ssize_t i, n = 0, xstep = 1, ystep = 1;
+
+    if (MPFR_Array_Check(x)) {
+        xf = ((MPFR_Array_Object*)x)->f;
+        n = ((MPFR_Array_Object*)x)->size;
+        prec = ((MPFR_Array_Object*)x)->prec;
+    }
+    else {
+        if (!(scalar = GMPy_MPFR_From_Real(x, 1, context)))
+            return NULL;
+        xf = &scalar->f;
+        xstep = 0;
+    }
+
+    if (MPFR_Array_Check(y)) {
+        if (xstep && ((MPFR_Array_Object*)y)->size != n) {
+            PyErr_Format(PyExc_ValueError,
+                         "%s() requires sequences of the same length", name);
+            return NULL;
+        }
+        yf = ((MPFR_Array_Object*)y)->f;
+        n = ((MPFR_Array_Object*)y)->size;
+        prec = Py_MAX(prec, ((MPFR_Array_Object*)y)->prec);
+    }
+    else {
+        if (!(scalar = GMPy_MPFR_From_Real(y, 1, context)))
+            return NULL;
+        yf = &scalar->f;
+        ystep = 0;
+    }
+
+    if (!(result = GMPy_MPFR_Array_New(&MPFR_Array_Type, n, prec)))
+        goto done;
+
+    if (n)
+        GMPY_PROFILE_OPN(context, op, (size_t)prec, n);
+
+    mpfr_clear_flags();
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (size_t)prec * n);
+    for (i = 0; i < n; i++) {
+        mpfr_ptr r = result->f[i];
+        mpfr_srcptr a = xf[i * xstep], b = yf[i * ystep];
+        int rc;
+
+        switch (op) {
+            case GMPY_OP_ADD:
+                rc = mpfr_add(r, a, b, round);
+                break;
+            case GMPY_OP_SUB:
+                rc = mpfr_sub(r, a, b, round);
+                break;
+            case GMPY_OP_MUL:
+                rc = mpfr_mul(r, a, b, round);
+                break;
+            default:
+                rc = mpfr_div(r, a, b, round);
+                break;
+        }
+        _GMPy_MPFR_Range(r, rc, context, round);
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (_GMPy_MPFR_Exceptions(context) < 0)
+        Py_CLEAR(result);
+
+  done:
+    Py_XDECREF((PyObject*)scalar);
+    return (PyObject*)result;
+}
+
+/* Convert the arguments of an elementwise integer function: integers and
+ * mpz_array objects are used as they are, other iterables are converted to
+ * new mpz_array objects. Returns -1 on error; the references in ops must
+ * be released in any case.
+ */
+
+static int
+_GMPy_Vector_MPZ_Args(PyObject *args, PyObject **ops, int nops,
+                      CTXT_Object *context)
+{
+    PyObject *arg;
+    int j;
+
+    for (j = 0; j < nops; j++)
+        ops[j] = NULL;
+
+    for (j = 0; j < nops; j++) {
+        arg = PyTuple_GET_ITEM(args, j);
+        if (MPZ_Array_Check(arg) || IS_INTEGER(arg)) {
+            Py_INCREF(arg);
+            ops[j] = arg;
+        }
+        else if (!(ops[j] = (PyObject*)_GMPy_MPZ_Array_From_Iterable(arg, context))) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Common code for vpowmod(), visqrt(), and vcmp(), and for vadd() etc.
+ * when out is given.
+ */
+
+static PyObject *
+_GMPy_Vector_MPZ_Function(PyObject *self, PyObject *args, PyObject *out,
+                          int op, int nops, const char *name)
+{
+    PyObject *ops[3], *result = NULL;
+    CTXT_Object *context = NULL;
+    int j;
+
+    if (self && CTXT_Check(self)) {
+        context = (CTXT_Object*)self;
+    }
+    else {
+        CHECK_CONTEXT(context);
+    }
+
+    if (PyTuple_GET_SIZE(args) != nops) {
+        PyErr_Format(PyExc_TypeError, "%s() requires %d argument%s", name,
+                     nops, nops == 1 ? "" : "s");
+        return NULL;
+    }
+
+    if (out == Py_None)
+        out = NULL;
+
+    if (_GMPy_Vector_MPZ_Args(args, ops, nops, context) == 0)
+        result = _GMPy_Vector_MPZ_Array(op, ops, nops, out, name, context);
+
+    for (j = 0; j < nops; j++)
+        Py_XDECREF(ops[j]);
+    return result;
+}
+
+static PyObject *
+_GMPy_Vector_Binop(PyObject *self, PyObject *args, PyObject *keywds, int op,
+                   const char *name)
+{
+    static char *kwlist[] = {"", "", "out", NULL};
+    PyObject *x, *y, *xseq = NULL, *yseq = NULL, *result = NULL, *temp;
+    PyObject *out = Py_None;
+    PyObject **xitems, **yitems;
+    CTXT_Object *context = NULL;
+    Py_ssize_t i, n = 0, xstep = 1, ystep = 1;
+    int *types = NULL, *xtypes, *ytypes, kind = VECTOR_OTHER, xtype, ytype;
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        PyErr_Format(PyExc_TypeError, "%s() requires 2 arguments", name);
+        return NULL;
+    }
+
+    /* With out, the operands are integers or sequences of integers and the
+     * results are stored in the mpz_array out.
+     */
+
+    if (keywds && op != GMPY_OP_TRUEDIV) {
+        if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO|$O", kwlist, &x, &y, &out))
+            return NULL;
+        if (out != Py_None)
+            return _GMPy_Vector_MPZ_Function(self, args, out, op, 2, name);
+    }
+
+    if (self && CTXT_Check(self)) {
+        context = (CTXT_Object*)self;
+    }
+    else {
+        CHECK_CONTEXT(context);
+    }
+
+    x = PyTuple_GET_ITEM(args, 0);
+    y = PyTuple_GET_ITEM(args, 1);
+    xtype = GMPy_ObjectType(x);
+    ytype = GMPy_ObjectType(y);
+
+    if (op != GMPY_OP_TRUEDIV &&
+        ((MPZ_Array_Check(x) && (MPZ_Array_Check(y) || IS_TYPE_INTEGER(ytype))) ||
+         (MPZ_Array_Check(y) && IS_TYPE_INTEGER(xtype)))) {
+        PyObject *ops[2] = {x, y};
+
+        return _GMPy_Vector_MPZ_Array(op, ops, 2, NULL, name, context);
+    }
+
+    if (op != GMPY_OP_MOD &&
+        ((MPFR_Array_Check(x) && (MPFR_Array_Check(y) || IS_TYPE_REAL(ytype))) ||
+         (MPFR_Array_Check(y) && IS_TYPE_REAL(xtype)))) {
+        return _GMPy_Vector_MPFR_Array(op, x, y, name, context);
+    }
+
+    if (xtype != OBJ_TYPE_UNKNOWN && ytype != OBJ_TYPE_UNKNOWN) {
+        PyErr_Format(PyExc_TypeError,
+                     "%s() requires at least one sequence argument", name);
+        return NULL;
+    }
+
+    if (xtype == OBJ_TYPE_UNKNOWN) {
+        if (!(xseq = PySequence_Fast(x, "argument must be a number or a sequence")))
+            return NULL;
+        n = PySequence_Fast_GET_SIZE(xseq);
+        xitems = PySequence_Fast_ITEMS(xseq);
+    }
+    else {
+        xstep = 0;
+        xitems = &x;
+    }
+
+    if (ytype == OBJ_TYPE_UNKNOWN) {
+        if (!(yseq = PySequence_Fast(y, "argument must be a number or a sequence")))
+            goto done;
+        if (xseq && PySequence_Fast_GET_SIZE(yseq) != n) {
+            PyErr_Format(PyExc_ValueError,
+                         "%s() requires sequences of the same length", name);
+            goto done;
+        }
+        n = PySequence_Fast_GET_SIZE(yseq);
+        yitems = PySequence_Fast_ITEMS(yseq);
+    }
+    else {
+        ystep = 0;
+        yitems = &y;
+    }
+
+    /* Classify every operand once. */
+
+    if (!(types = PyMem_New(int, 2 * (n ? n : 1)))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    xtypes = types;
+    ytypes = types + n;
+    if (!xstep)
+        xtypes[0] = xtype;
+    if (!ystep)
+        ytypes[0] = ytype;
+
+    for (i = 0; i < n; i++) {
+        int k;
+
+        if (xstep)
+            xtypes[i] = GMPy_ObjectType(xitems[i]);
+        if (ystep)
+            ytypes[i] = GMPy_ObjectType(yitems[i]);
+        k = _GMPy_Vector_Kind(xtypes[i * xstep], ytypes[i * ystep]);
+        if (i == 0)
+            kind = k;
+        else if (k != kind)
+            kind = VECTOR_OTHER;
+    }
+
+    if (_GMPy_Vector_HasFast(op, kind)) {
+        result = _GMPy_Vector_Fast(op, kind, xitems, xtypes, xstep,
+                                   yitems, ytypes, ystep, n, context);
+        goto done;
+    }
+
+    if (!(result = PyList_New(n)))
+        goto done;
+
+    for (i = 0; i < n; i++) {
+        if (!(temp = _GMPy_Vector_Number(op, xitems[i * xstep],
+                                         yitems[i * ystep], context))) {
+            Py_CLEAR(result);
+            break;
+        }
+        PyList_SET_ITEM(result, i, temp);
+    }
+
+  done:
+    PyMem_Free(types);
+    Py_XDECREF(xseq);
+    Py_XDECREF(yseq);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_vadd,
+"vadd(x, y, /, *, out=None) -> list\n\n"
+"Return [a + b for a, b in zip(x, y)]. Either x or y can be a single\n"
+"number that is combined with every element of the other sequence.\n"
+"If all elements are integers, rationals, or reals the loop runs in C\n"
+"without the GIL. mpz_array operands give an mpz_array, and mpfr_array\n"
+"operands combined with an mpfr_array or a real number give an\n"
+"mpfr_array. If out is an mpz_array, the elements must be integers and\n"
+"the results are stored in out.");
+
+PyDoc_STRVAR(GMPy_doc_context_vadd,
+"context.vadd(x, y, /, *, out=None) -> list\n\n"
+"Return [a + b for a, b in zip(x, y)] using this context. See vadd().");
+
+static PyObject *
+GMPy_Context_VAdd(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Vector_Binop(self, args, keywds, GMPY_OP_ADD, "vadd");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_vsub,
+"vsub(x, y, /, *, out=None) -> list\n\n"
+"Return [a - b for a, b in zip(x, y)]. Either x or y can be a single\n"
+"number that is combined with every element of the other sequence.\n"
+"If all elements are integers, rationals, or reals the loop runs in C\n"
+"without the GIL. mpz_array operands give an mpz_array, and mpfr_array\n"
+"operands combined with an mpfr_array or a real number give an\n"
+"mpfr_array. If out is an mpz_array, the elements must be integers and\n"
+"the results are stored in out.");
+
+PyDoc_STRVAR(GMPy_doc_context_vsub,
+"context.vsub(x, y, /, *, out=None) -> list\n\n"
+"Return [a - b for a, b in zip(x, y)] using this context. See vsub().");
+
+static PyObject *
+GMPy_Context_VSub(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Vector_Binop(self, args, keywds, GMPY_OP_SUB, "vsub");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_vmul,
+"vmul(x, y, /, *, out=None) -> list\n\n"
+"Return [a * b for a, b in zip(x, y)]. Either x or y can be a single\n"
+"number that is combined with every element of the other sequence.\n"
+"If all elements are integers, rationals, or reals the loop runs in C\n"
+"without the GIL. mpz_array operands give an mpz_array, and mpfr_array\n"
+"operands combined with an mpfr_array or a real number give an\n"
+"mpfr_array. If out is an mpz_array, the elements must be integers and\n"
+"the results are stored in out.");
+
+PyDoc_STRVAR(GMPy_doc_context_vmul,
+"context.vmul(x, y, /, *, out=None) -> list\n\n"
+"Return [a * b for a, b in zip(x, y)] using this context. See vmul().");
+
+static PyObject *
+GMPy_Context_VMul(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Vector_Binop(self, args, keywds, GMPY_OP_MUL, "vmul");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_vdiv,
+"vdiv(x, y, /) -> list\n\n"
+"Return [a / b for a, b in zip(x, y)]. Either x or y can be a single\n"
+"number that is combined with every element of the other sequence.\n"
+"If all elements are rationals or reals the loop runs in C without the\n"
+"GIL. mpfr_array operands combined with an mpfr_array or a real number\n"
+"give an mpfr_array.");
+
+PyDoc_STRVAR(GMPy_doc_context_vdiv,
+"context.vdiv(x, y, /) -> list\n\n"
+"Return [a / b for a, b in zip(x, y)] using this context. See vdiv().");
+
+static PyObject *
+GMPy_Context_VDiv(PyObject *self, PyObject *args)
+{
+    return _GMPy_Vector_Binop(self, args, NULL, GMPY_OP_TRUEDIV, "vdiv");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_vmod,
+"vmod(x, y, /, *, out=None) -> list\n\n"
+"Return [a % b for a, b in zip(x, y)]. Either x or y can be a single\n"
+"number that is combined with every element of the other sequence.\n"
+"If all elements are integers the loop runs in C without the GIL.\n"
+"mpz_array operands give an mpz_array. If out is an mpz_array, the\n"
+"results are stored in it.");
+
+PyDoc_STRVAR(GMPy_doc_context_vmod,
+"context.vmod(x, y, /, *, out=None) -> list\n\n"
+"Return [a % b for a, b in zip(x, y)] using this context. See vmod().");
+
+static PyObject *
+GMPy_Context_VMod(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Vector_Binop(self, args, keywds, GMPY_OP_MOD, "vmod");
+}
+
+/* vpowmod(), visqrt(), and vcmp() take the same optional out argument. */
+
+static PyObject *
+_GMPy_Vector_MPZ_Out(PyObject *self, PyObject *args, PyObject *keywds,
+                     int op, int nops, const char *name)
+{
+    PyObject *out = NULL;
+
+    if (keywds && PyDict_Size(keywds)) {
+        if (PyDict_Size(keywds) != 1 ||
+            !(out = PyDict_GetItemString(keywds, "out"))) {
+            PyErr_Format(PyExc_TypeError, "%s() only accepts the keyword argument out", name);
+            return NULL;
+        }
+    }
+    return _GMPy_Vector_MPZ_Function(self, args, out, op, nops, name);
+}
+
+PyDoc_STRVAR(GMPy_doc_function_vpowmod,
+"vpowmod(x, y, m, /, *, out=None) -> mpz_array\n\n"
+"Return the mpz_array of powmod(a, b, c) for the elements a, b, c of x,\n"
+"y, and m. Each argument is an mpz_array, an iterable of integers, or\n"
+"a single integer that is used for every element. The exponents must be\n"
+"non-negative. If out is an mpz_array of the same length, the results\n"
+"are stored in it. The loop runs without the GIL.");
+
+PyDoc_STRVAR(GMPy_doc_context_vpowmod,
+"context.vpowmod(x, y, m, /, *, out=None) -> mpz_array\n\n"
+"Return the mpz_array of powmod(a, b, c) for the elements of x, y, and\n"
+"m using this context. See vpowmod().");
+
+static PyObject *
+GMPy_Context_VPowMod(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Vector_MPZ_Out(self, args, keywds, GMPY_OP_POWMOD, 3, "vpowmod");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_visqrt,
+"visqrt(x, /, *, out=None) -> mpz_array\n\n"
+"Return the mpz_array of isqrt(a) for the elements a of x, an mpz_array\n"
+"or an iterable of non-negative integers. If out is an mpz_array of the\n"
+"same length, the results are stored in it. The loop runs without the\n"
+"GIL.");
+
+PyDoc_STRVAR(GMPy_doc_context_visqrt,
+"context.visqrt(x, /, *, out=None) -> mpz_array\n\n"
+"Return the mpz_array of isqrt(a) for the elements of x using this\n"
+"context. See visqrt().");
+
+static PyObject *
+GMPy_Context_VIsqrt(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Vector_MPZ_Out(self, args, keywds, GMPY_OP_ROOT, 1, "visqrt");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_vcmp,
+"vcmp(x, y, /, *, out=None) -> mpz_array\n\n"
+"Return the mpz_array of cmp(a, b), i.e. -1, 0, or 1, for the elements\n"
+"a, b of x and y. Either argument can be a single integer that is used\n"
+"for every element. If out is an mpz_array of the same length, the\n"
+"results are stored in it. The loop runs without the GIL.");
+
+PyDoc_STRVAR(GMPy_doc_context_vcmp,
+"context.vcmp(x, y, /, *, out=None) -> mpz_array\n\n"
+"Return the mpz_array of cmp(a, b) for the elements of x and y using\n"
+"this context. See vcmp().");
+
+static PyObject *
+GMPy_Context_VCmp(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Vector_MPZ_Out(self, args, keywds, VECTOR_OP_CMP, 2, "vcmp");
+}
+
+/* Exact sums and dot products of integers and rationals.
+ *
+ * The values are first collected as pointers to their numerators and
+ * denominators; a NULL denominator means 1. Only Python integers and
+ * types without a direct mpz or mpq representation need a conversion.
+ * The accumulation then runs without the GIL and, for rationals, keeps
+ * the sum over the least common multiple of the denominators seen so far.
+ * The result is canonicalized once at the end.
+ */
+
+typedef struct {
+    Py_ssize_t n;
+    mpz_srcptr *num;
+    mpz_srcptr *den;
+    mpz_t *temp;                /* converted Python integers */
+    Py_ssize_t ntemp;
+    PyObject *seq;              /* the sequence or mpz_array */
+    PyObject *keep;             /* list of converted objects, or NULL */
+    int rational;               /* 1 if any denominator is used */
+} gmpy_rational_view;
+
+static void
+_GMPy_View_Clear(gmpy_rational_view *view)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < view->ntemp; i++)
+        mpz_clear(view->temp[i]);
+    PyMem_Free(view->num);
+    PyMem_Free(view->den);
+    PyMem_Free(view->temp);
+    Py_XDECREF(view->seq);
+    Py_XDECREF(view->keep);
+    /* _GMPy_View_Init() clears the view on errors; a second clear by the
+     * caller must do nothing.
+     */
+    memset(view, 0, sizeof(gmpy_rational_view));
+}
+
+static int
+_GMPy_View_Init(gmpy_rational_view *view, PyObject *obj, const char *name,
+                CTXT_Object *context)
+{
+    PyObject *seq, **items, *temp;
+    Py_ssize_t i, n;
+    int xtype;
+
+    memset(view, 0, sizeof(gmpy_rational_view));
+
+    if (MPZ_Array_Check(obj)) {
+        n = ((MPZ_Array_Object*)obj)->size;
+        if (!(view->num = PyMem_New(mpz_srcptr, n ? n : 1)) ||
+            !(view->den = PyMem_New(mpz_srcptr, n ? n : 1))) {
+            PyErr_NoMemory();
+            _GMPy_View_Clear(view);
+            return -1;
+        }
+        for (i = 0; i < n; i++) {
+            view->num[i] = ((MPZ_Array_Object*)obj)->z[i];
+            view->den[i] = NULL;
+        }
+        Py_INCREF(obj);
+        view->seq = obj;
+        view->n = n;
+        return 0;
+    }
+
+    /* A tuple owns a reference to every item even if a list argument is
+     * changed by another thread while the GIL is released.
+     */
+
+    if (!(seq = PySequence_Tuple(obj)))
+        return -1;
+    view->seq = seq;
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    items = PySequence_Fast_ITEMS(seq);
+
+    if (!(view->num = PyMem_New(mpz_srcptr, n ? n : 1)) ||
+        !(view->den = PyMem_New(mpz_srcptr, n ? n : 1)) ||
+        !(view->temp = PyMem_New(mpz_t, n ? n : 1))) {
+        PyErr_NoMemory();
+        _GMPy_View_Clear(view);
+        return -1;
+    }
+    view->n = n;
+
+    for (i = 0; i < n; i++) {
+        xtype = GMPy_ObjectType(items[i]);
+        view->den[i] = NULL;
+
+        if (IS_TYPE_MPZANY(xtype)) {
+            view->num[i] = MPZ(items[i]);
+        }
+        else if (IS_TYPE_PyInteger(xtype)) {
+            mpz_init(view->temp[view->ntemp]);
+            mpz_set_PyLong(view->temp[view->ntemp], items[i]);
+            view->num[i] = view->temp[view->ntemp++];
+        }
+        else if (IS_TYPE_MPQ(xtype)) {
+            view->num[i] = mpq_numref(MPQ(items[i]));
+            view->den[i] = mpq_denref(MPQ(items[i]));
+            view->rational = 1;
+        }
+        else if (IS_TYPE_RATIONAL(xtype)) {
+            if (IS_TYPE_INTEGER(xtype))
+                temp = (PyObject*)GMPy_MPZ_From_IntegerWithType(items[i], xtype, context);
+            else
+                temp = (PyObject*)GMPy_MPQ_From_RationalWithType(items[i], xtype, context);
+            if (!temp || (!view->keep && !(view->keep = PyList_New(0))) ||
+                PyList_Append(view->keep, temp) < 0) {
+                Py_XDECREF(temp);
+                _GMPy_View_Clear(view);
+                return -1;
+            }
+            /* The list keeps the converted value alive. */
+            Py_DECREF(temp);
+            if (MPZ_Check(temp)) {
+                view->num[i] = MPZ(temp);
+            }
+            else {
+                view->num[i] = mpq_numref(MPQ(temp));
+                view->den[i] = mpq_denref(MPQ(temp));
+                view->rational = 1;
+            }
+        }
+        else {
+            PyErr_Format(PyExc_TypeError,
+                         "%s() requires integer or rational arguments", name);
+            _GMPy_View_Clear(view);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Add a/b to num/den. b may be NULL for 1. g and t are scratch space. */
+
+static void
+_GMPy_Rational_Accumulate(mpz_ptr num, mpz_ptr den, mpz_srcptr a,
+                          mpz_srcptr b, mpz_ptr g, mpz_ptr t)
+{
+    if (!b || mpz_cmp(b, den) == 0) {
+        if (b)
+            mpz_add(num, num, a);
+        else
+            mpz_addmul(num, a, den);
+        return;
+    }
+
+    mpz_gcd(g, den, b);
+    mpz_divexact(t, b, g);
+    mpz_divexact(g, den, g);
+    mpz_mul(num, num, t);
+    mpz_addmul(num, a, g);
+    mpz_mul(den, den, t);
+}
+
+static size_t
+_GMPy_View_Bits(gmpy_rational_view *view)
+{
+    size_t bits = 0;
+    Py_ssize_t i;
+
+    for (i = 0; i < view->n; i++) {
+        bits += GMPY_MPZ_BITS(view->num[i]);
+        if (view->den[i])
+            bits += GMPY_MPZ_BITS(view->den[i]);
+    }
+    return bits;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_isum,
+"isum(iterable, /) -> mpz | mpq\n\n"
+"Return the exact sum of the integers or rationals in iterable. The sum\n"
+"is accumulated without creating intermediate objects; a rational sum\n"
+"is reduced only once at the end. Use `fsum()` for real values.");
+
+static PyObject *
+GMPy_Context_Isum(PyObject *self, PyObject *other)
+{
+    gmpy_rational_view view;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+    size_t bits;
+    Py_ssize_t i;
+
+    if (self && CTXT_Check(self)) {
+        context = (CTXT_Object*)self;
+    }
+    else {
+        CHECK_CONTEXT(context);
+    }
+
+    if (_GMPy_View_Init(&view, other, "isum", context) < 0)
+        return NULL;
+
+    bits = _GMPy_View_Bits(&view);
+    if (view.n)
+        GMPY_PROFILE_OPN(context, GMPY_OP_ADD, bits / view.n, view.n);
+
+    if (!view.rational) {
+        MPZ_Object *sum;
+
+        if ((sum = GMPy_MPZ_New(context))) {
+            mpz_set_ui(sum->z, 0);
+            GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+            for (i = 0; i < view.n; i++)
+                mpz_add(sum->z, sum->z, view.num[i]);
+            GMPY_END_ALLOW_THREADS_MIN(context);
+        }
+        result = (PyObject*)sum;
+    }
+    else {
+        MPQ_Object *sum;
+        mpz_t g, t;
+
+        if ((sum = GMPy_MPQ_New(context))) {
+            mpz_init(g);
+            mpz_init(t);
+            mpq_set_ui(sum->q, 0, 1);
+            GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+            for (i = 0; i < view.n; i++)
+                _GMPy_Rational_Accumulate(mpq_numref(sum->q), mpq_denref(sum->q),
+                                          view.num[i], view.den[i], g, t);
+            mpq_canonicalize(sum->q);
+            GMPY_END_ALLOW_THREADS_MIN(context);
+            mpz_clear(g);
+            mpz_clear(t);
+        }
+        result = (PyObject*)sum;
+    }
+
+    _GMPy_View_Clear(&view);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_mpq_many,
+"mpq_many(nums, dens, /, canonical=False) -> list\n\n"
+"Return [mpq(n, d) for n, d in zip(nums, dens)] for two sequences of\n"
+"integers of the same length. If canonical is True every pair must\n"
+"already be coprime and the gcds are skipped, as for mpq(n, d,\n"
+"canonical=True). Otherwise the GIL is released for the gcds and they\n"
+"are split over the context's threads. nums and dens may be mpz_array\n"
+"objects.");
+
+/* The numerators and denominators are copied straight into the new mpq
+ * objects with the GIL held; only the gcds are computed without it.
+ */
+
+static void
+_GMPy_MPQ_Many_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    mpq_ptr *out = (mpq_ptr*)arg;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++)
+        mpq_canonicalize(out[i]);
+}
+
+/* Set z to item i of the mpz_array or sequence seq. */
+
+static int
+_GMPy_MPQ_Many_Part(mpz_ptr z, PyObject *seq, Py_ssize_t i, CTXT_Object *context)
+{
+    if (MPZ_Array_Check(seq)) {
+        mpz_set(z, ((MPZ_Array_Object*)seq)->z[i]);
+        return 0;
+    }
+    if (!IS_INTEGER(PySequence_Fast_GET_ITEM(seq, i))) {
+        TYPE_ERROR("mpq_many() requires integer arguments");
+        return -1;
+    }
+    return _GMPy_MPQ_Set_Part(z, PySequence_Fast_GET_ITEM(seq, i), context);
+}
+
+static PyObject *
+GMPy_MPQ_Function_Many(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"nums", "dens", "canonical", NULL};
+    PyObject *nums, *dens, *result = NULL, *temp;
+    CTXT_Object *context = NULL;
+    mpq_ptr *out = NULL;
+    size_t bits = 0;
+    Py_ssize_t i, n;
+    int canonical = 0, threads;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO|p", kwlist,
+                                     &nums, &dens, &canonical))
+        return NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (MPZ_Array_Check(nums))
+        Py_INCREF(nums);
+    else if (!(nums = PySequence_Fast(nums, "mpq_many() requires sequences")))
+        return NULL;
+    if (MPZ_Array_Check(dens))
+        Py_INCREF(dens);
+    else if (!(dens = PySequence_Fast(dens, "mpq_many() requires sequences"))) {
+        Py_DECREF(nums);
+        return NULL;
+    }
+
+    n = MPZ_Array_Check(nums) ? ((MPZ_Array_Object*)nums)->size : PySequence_Fast_GET_SIZE(nums);
+    if (n != (MPZ_Array_Check(dens) ? ((MPZ_Array_Object*)dens)->size : PySequence_Fast_GET_SIZE(dens))) {
+        VALUE_ERROR("mpq_many() requires sequences of the same length");
+        goto done;
+    }
+
+    if (!(out = PyMem_New(mpq_ptr, n ? n : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    if (!(result = PyList_New(n)))
+        goto done;
+    for (i = 0; i < n; i++) {
+        if (!(temp = (PyObject*)GMPy_MPQ_New(context))) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, temp);
+        out[i] = MPQ(temp);
+        if (_GMPy_MPQ_Many_Part(mpq_numref(out[i]), nums, i, context) < 0 ||
+            _GMPy_MPQ_Many_Part(mpq_denref(out[i]), dens, i, context) < 0) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        if (mpz_sgn(mpq_denref(out[i])) == 0) {
+            PyErr_Format(PyExc_ZeroDivisionError,
+                         "mpq_many() zero denominator at index %zd", i);
+            Py_CLEAR(result);
+            goto done;
+        }
+        if (canonical) {
+            if (_GMPy_MPQ_Finish_Canonical(out[i], "mpq_many") < 0) {
+                Py_CLEAR(result);
+                goto done;
+            }
+        }
+        else {
+            bits += GMPY_MPZ_BITS2(mpq_numref(out[i]), mpq_denref(out[i]));
+        }
+    }
+
+    if (!canonical) {
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+        threads = GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1;
+        GMPy_Parallel_Run(_GMPy_MPQ_Many_Range, out, n, threads);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+    }
+
+  done:
+    PyMem_Free(out);
+    Py_DECREF(nums);
+    Py_DECREF(dens);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_dot,
+"dot(x, y, /) -> mpz | mpq | mpfr\n\n"
+"Return the exact value of sum(a * b for a, b in zip(x, y)) for two\n"
+"sequences of the same length containing integers or rationals. No\n"
+"intermediate objects are created; a rational result is reduced only\n"
+"once at the end. For two mpfr_array objects the result is the\n"
+"correctly rounded mpfr.");
+
+static PyObject *
+GMPy_Context_Dot(PyObject *self, PyObject *args)
+{
+    gmpy_rational_view xview, yview;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+    size_t bits;
+    Py_ssize_t i;
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        TYPE_ERROR("dot() requires 2 arguments");
+        return NULL;
+    }
+
+    if (self && CTXT_Check(self)) {
+        context = (CTXT_Object*)self;
+    }
+    else {
+        CHECK_CONTEXT(context);
+    }
+
+    if (MPFR_Array_Check(PyTuple_GET_ITEM(args, 0)) &&
+        MPFR_Array_Check(PyTuple_GET_ITEM(args, 1))) {
+        return GMPy_MPFR_Array_Dot((MPFR_Array_Object*)PyTuple_GET_ITEM(args, 0),
+                                   (MPFR_Array_Object*)PyTuple_GET_ITEM(args, 1),
+                                   context);
+    }
+
+    if (_GMPy_View_Init(&xview, PyTuple_GET_ITEM(args, 0), "dot", context) < 0)
+        return NULL;
+    if (_GMPy_View_Init(&yview, PyTuple_GET_ITEM(args, 1), "dot", context) < 0) {
+        _GMPy_View_Clear(&xview);
+        return NULL;
+    }
+
+    if (xview.n != yview.n) {
+        VALUE_ERROR("dot() requires sequences of the same length");
+        goto done;
+    }
+
+    bits = _GMPy_View_Bits(&xview) + _GMPy_View_Bits(&yview);
+    if (xview.n)
+        GMPY_PROFILE_OPN(context, GMPY_OP_MUL, bits / xview.n, xview.n);
+
+    if (!xview.rational && !yview.rational) {
+        MPZ_Object *sum;
+        mpz_t square;
+
+        if ((sum = GMPy_MPZ_New(context))) {
+            mpz_init(square);
+            mpz_set_ui(sum->z, 0);
+            GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+            for (i = 0; i < xview.n; i++) {
+                /* mpz_addmul() does not detect squares. */
+                if (xview.num[i] == yview.num[i]) {
+                    mpz_mul(square, xview.num[i], xview.num[i]);
+                    mpz_add(sum->z, sum->z, square);
+                }
+                else {
+                    mpz_addmul(sum->z, xview.num[i], yview.num[i]);
+                }
+            }
+            GMPY_END_ALLOW_THREADS_MIN(context);
+            mpz_clear(square);
+        }
+        result = (PyObject*)sum;
+    }
+    else {
+        MPQ_Object *sum;
+        mpz_srcptr den;
+        mpz_t num, prod, g, t;
+
+        if ((sum = GMPy_MPQ_New(context))) {
+            mpz_init(num);
+            mpz_init(prod);
+            mpz_init(g);
+            mpz_init(t);
+            mpq_set_ui(sum->q, 0, 1);
+            GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+            for (i = 0; i < xview.n; i++) {
+                mpz_mul(num, xview.num[i], yview.num[i]);
+                if (xview.den[i] && yview.den[i]) {
+                    mpz_mul(prod, xview.den[i], yview.den[i]);
+                    den = prod;
+                }
+                else {
+                    den = xview.den[i] ? xview.den[i] : yview.den[i];
+                }
+                _GMPy_Rational_Accumulate(mpq_numref(sum->q), mpq_denref(sum->q),
+                                          num, den, g, t);
+            }
+            mpq_canonicalize(sum->q);
+            GMPY_END_ALLOW_THREADS_MIN(context);
+            mpz_clear(num);
+            mpz_clear(prod);
+            mpz_clear(g);
+            mpz_clear(t);
+        }
+        result = (PyObject*)sum;
+    }
+
+  done:
+    _GMPy_View_Clear(&xview);
+    _GMPy_View_Clear(&yview);
+    return result;
+}
+
+/* Polynomial evaluation.
+ *
+ * The coefficients are given from the highest degree down, as for
+ * numpy.polyval(). Every coefficient and every point is converted once to
+ * the common kind (integer, rational, real, or complex) and the results
+ * are computed in C temporaries without the GIL. Real and complex values
+ * use Horner's rule with one fused multiply-add, and therefore one
+ * rounding, per coefficient. Integer polynomials of higher degree use
+ * Estrin's scheme instead: pairs of coefficients are combined with x,
+ * then pairs of those with x**2, and so on. The multiplications are then
+ * balanced and benefit from GMP's subquadratic algorithms.
+ */
+
+#define POLY_ESTRIN_MIN 16
+
+static int
+_GMPy_Poly_Kind(int *types, Py_ssize_t n)
+{
+    int kind = VECTOR_INTEGER, k;
+    Py_ssize_t i;
+
+    for (i = 0; i < n; i++) {
+        if (IS_TYPE_INTEGER(types[i]))
+            k = VECTOR_INTEGER;
+        else if (IS_TYPE_RATIONAL(types[i]))
+            k = VECTOR_RATIONAL;
+        else if (IS_TYPE_REAL(types[i]))
+            k = VECTOR_REAL;
+        else if (IS_TYPE_COMPLEX(types[i]))
+            k = VECTOR_COMPLEX;
+        else
+            return VECTOR_OTHER;
+        if (k > kind)
+            kind = k;
+    }
+    return kind;
+}
+
+static PyObject *
+_GMPy_Poly_New(int kind, CTXT_Object *context)
+{
+    switch (kind) {
+        case VECTOR_INTEGER:
+            return (PyObject*)GMPy_MPZ_New(context);
+        case VECTOR_RATIONAL:
+            return (PyObject*)GMPy_MPQ_New(context);
+        case VECTOR_REAL:
+            return (PyObject*)GMPy_MPFR_New(0, context);
+        default:
+            return (PyObject*)GMPy_MPC_New(0, 0, context);
+    }
+}
+
+/* Evaluate the integer polynomial c[0]*x**(n-1) + ... + c[n-1] using
+ * Estrin's scheme. t must hold n initialized values; p and q are scratch
+ * space.
+ */
+
+static void
+_GMPy_Poly_Estrin(mpz_ptr r, PyObject **c, Py_ssize_t n, mpz_srcptr x,
+                  mpz_t *t, mpz_ptr p, mpz_ptr q)
+{
+    Py_ssize_t j, m;
+
+    /* t[j] is the coefficient of x**j. */
+
+    for (j = 0; j < n; j++)
+        mpz_set(t[j], MPZ(c[n - 1 - j]));
+
+    mpz_set(p, x);
+    for (m = n; m > 1; m = (m + 1) / 2) {
+        for (j = 0; 2 * j + 1 < m; j++) {
+            mpz_mul(q, t[2 * j + 1], p);
+            mpz_add(t[j], t[2 * j], q);
+        }
+        if (m & 1)
+            mpz_swap(t[m / 2], t[m - 1]);
+        if (m > 2)
+            mpz_mul(p, p, p);
+    }
+    mpz_swap(r, t[0]);
+}
+
+static PyObject *
+_GMPy_Polyval(PyObject *self, PyObject *args, int many, const char *name)
+{
+    PyObject *cseq = NULL, *xseq = NULL, *result = NULL, *temp;
+    PyObject **citems, **xitems, **cargs = NULL, **xargs, **res = NULL;
+    CTXT_Object *context = NULL;
+    mpfr_rnd_t round;
+    mpc_rnd_t cround;
+    mpz_t *t = NULL, p, q;
+    size_t bits = 0, cbits = 0;
+    Py_ssize_t i, j, nc = 0, nx = 0;
+    int *types = NULL, kind;
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        PyErr_Format(PyExc_TypeError, "%s() requires 2 arguments", name);
+        return NULL;
+    }
+
+    if (self && CTXT_Check(self)) {
+        context = (CTXT_Object*)self;
+    }
+    else {
+        CHECK_CONTEXT(context);
+    }
+    round = GET_MPFR_ROUND(context);
+    cround = GET_MPC_ROUND(context);
+
+    /* Tuples keep a reference to every item while the GIL is released. An
+     * empty polynomial is the zero polynomial.
+     */
+
+    if (!(cseq = PySequence_Tuple(PyTuple_GET_ITEM(args, 0))))
+        return NULL;
+    if (PyTuple_GET_SIZE(cseq) == 0) {
+        Py_DECREF(cseq);
+        if (!(cseq = Py_BuildValue("(i)", 0)))
+            return NULL;
+    }
+
+    if (many)
+        xseq = PySequence_Tuple(PyTuple_GET_ITEM(args, 1));
+    else
+        xseq = PyTuple_Pack(1, PyTuple_GET_ITEM(args, 1));
+    if (!xseq)
+        goto done;
+
+    nc = PyTuple_GET_SIZE(cseq);
+    nx = PyTuple_GET_SIZE(xseq);
+    citems = PySequence_Fast_ITEMS(cseq);
+    xitems = PySequence_Fast_ITEMS(xseq);
+
+    if (!(types = PyMem_New(int, nc + nx)) ||
+        !(cargs = PyMem_New(PyObject*, 2 * nx + nc))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    xargs = cargs + nc;
+    res = xargs + nx;
+    for (i = 0; i < nc + 2 * nx; i++)
+        cargs[i] = NULL;
+
+    for (i = 0; i < nc; i++)
+        types[i] = GMPy_ObjectType(citems[i]);
+    for (i = 0; i < nx; i++)
+        types[nc + i] = GMPy_ObjectType(xitems[i]);
+
+    if ((kind = _GMPy_Poly_Kind(types, nc + nx)) == VECTOR_OTHER) {
+        PyErr_Format(PyExc_TypeError,
+                     "%s() requires numeric coefficients and points", name);
+        goto done;
+    }
+
+    /* Convert the operands and allocate the results. */
+
+    for (i = 0; i < nc + 2 * nx; i++) {
+        if (i < nc + nx) {
+            temp = i < nc ? citems[i] : xitems[i - nc];
+            if (kind == VECTOR_COMPLEX)
+                cargs[i] = (PyObject*)GMPy_MPC_From_ComplexWithType(temp, types[i],
+                                                                    1, 1, context);
+            else
+                cargs[i] = _GMPy_Vector_Convert(temp, types[i], kind, context);
+        }
+        else {
+            cargs[i] = _GMPy_Poly_New(kind, context);
+        }
+        if (!cargs[i])
+            goto done;
+    }
+
+    if (kind == VECTOR_INTEGER) {
+        for (i = 0; i < nc; i++)
+            cbits += GMPY_MPZ_BITS(MPZ(cargs[i]));
+        for (i = 0; i < nx; i++)
+            bits += cbits + nc * GMPY_MPZ_BITS(MPZ(xargs[i]));
+    }
+    else if (kind == VECTOR_RATIONAL) {
+        for (i = 0; i < nc; i++)
+            cbits += GMPY_MPQ_BITS(MPQ(cargs[i]));
+        for (i = 0; i < nx; i++)
+            bits += cbits + nc * GMPY_MPQ_BITS(MPQ(xargs[i]));
+    }
+    else {
+        bits = (size_t)GET_MPFR_PREC(context) * nc * nx;
+    }
+
+    if (nx)
+        GMPY_PROFILE_OPN(context, GMPY_OP_MUL, bits / nx, nx * nc);
+
+    if (kind == VECTOR_INTEGER && nc >= POLY_ESTRIN_MIN) {
+        if (!(t = PyMem_New(mpz_t, nc))) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        for (i = 0; i < nc; i++)
+            mpz_init(t[i]);
+        mpz_init(p);
+        mpz_init(q);
+    }
+
+    if (kind >= VECTOR_REAL)
+        mpfr_clear_flags();
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    for (i = 0; i < nx; i++) {
+        temp = res[i];
+        switch (kind) {
+            case VECTOR_INTEGER:
+                if (t) {
+                    _GMPy_Poly_Estrin(MPZ(temp), cargs, nc, MPZ(xargs[i]), t, p, q);
+                    break;
+                }
+                mpz_set(MPZ(temp), MPZ(cargs[0]));
+                for (j = 1; j < nc; j++) {
+                    mpz_mul(MPZ(temp), MPZ(temp), MPZ(xargs[i]));
+                    mpz_add(MPZ(temp), MPZ(temp), MPZ(cargs[j]));
+                }
+                break;
+            case VECTOR_RATIONAL:
+                mpq_set(MPQ(temp), MPQ(cargs[0]));
+                for (j = 1; j < nc; j++) {
+                    mpq_mul(MPQ(temp), MPQ(temp), MPQ(xargs[i]));
+                    mpq_add(MPQ(temp), MPQ(temp), MPQ(cargs[j]));
+                }
+                break;
+            case VECTOR_REAL:
+                ((MPFR_Object*)temp)->rc = mpfr_set(MPFR(temp), MPFR(cargs[0]), round);
+                for (j = 1; j < nc; j++)
+                    ((MPFR_Object*)temp)->rc = mpfr_fma(MPFR(temp), MPFR(temp),
+                                                        MPFR(xargs[i]),
+                                                        MPFR(cargs[j]), round);
+                _GMPy_MPFR_Check_Range((MPFR_Object*)temp, context, round);
+                break;
+            default:
+                ((MPC_Object*)temp)->rc = mpc_set(MPC(temp), MPC(cargs[0]), cround);
+                for (j = 1; j < nc; j++)
+                    ((MPC_Object*)temp)->rc = mpc_fma(MPC(temp), MPC(temp),
+                                                      MPC(xargs[i]),
+                                                      MPC(cargs[j]), cround);
+                break;
+        }
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (t) {
+        for (i = 0; i < nc; i++)
+            mpz_clear(t[i]);
+        PyMem_Free(t);
+        mpz_clear(p);
+        mpz_clear(q);
+    }
+
+    if (kind == VECTOR_REAL && _GMPy_MPFR_Exceptions(context) < 0)
+        goto done;
+
+    /* _GMPy_MPC_Cleanup() releases the result and sets it to NULL if an
+     * exception is raised.
+     */
+
+    if (kind == VECTOR_COMPLEX) {
+        for (i = 0; i < nx; i++) {
+            _GMPy_MPC_Cleanup((MPC_Object**)&res[i], context);
+            if (!res[i])
+                goto done;
+        }
+    }
+
+    if (!many) {
+        result = res[0];
+        Py_INCREF(result);
+    }
+    else if ((result = PyList_New(nx))) {
+        for (i = 0; i < nx; i++) {
+            Py_INCREF(res[i]);
+            PyList_SET_ITEM(result, i, res[i]);
+        }
+    }
+
+  done:
+    if (cargs) {
+        for (i = 0; i < nc + 2 * nx; i++)
+            Py_XDECREF(cargs[i]);
+        PyMem_Free(cargs);
+    }
+    PyMem_Free(types);
+    Py_XDECREF(cseq);
+    Py_XDECREF(xseq);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_polyval,
+"polyval(coeffs, x, /) -> mpz | mpq | mpfr | mpc\n\n"
+"Return the value of the polynomial with coefficients coeffs at x. The\n"
+"coefficients are ordered from the highest degree down, as for\n"
+"numpy.polyval(); polyval([a, b, c], x) is a*x**2 + b*x + c. Integer and\n"
+"rational polynomials are evaluated exactly. Real and complex values are\n"
+"evaluated by Horner's rule with one fused multiply-add per coefficient.");
+
+PyDoc_STRVAR(GMPy_doc_context_polyval,
+"context.polyval(coeffs, x, /) -> mpz | mpq | mpfr | mpc\n\n"
+"Return the value of the polynomial with coefficients coeffs at x using\n"
+"this context. See polyval().");
+
+static PyObject *
+GMPy_Context_Polyval(PyObject *self, PyObject *args)
+{
+    return _GMPy_Polyval(self, args, 0, "polyval");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_polyval_many,
+"polyval_many(coeffs, xs, /) -> list\n\n"
+"Return [polyval(coeffs, x) for x in xs]. The coefficients are converted\n"
+"only once and the whole loop runs in C without the GIL.");
+
+PyDoc_STRVAR(GMPy_doc_context_polyval_many,
+"context.polyval_many(coeffs, xs, /) -> list\n\n"
+"Return [polyval(coeffs, x) for x in xs] using this context. See\n"
+"polyval_many().");
+
+static PyObject *
+GMPy_Context_Polyval_Many(PyObject *self, PyObject *args)
+{
+    return _GMPy_Polyval(self, args, 1, "polyval_many");
+}
+
+/* Bulk popcount(), hamdist(), and bit_test().
+ *
+ * The values are viewed without copying as for isum(), and the counts are
+ * computed without the GIL; GMP's mpn_popcount() and mpn_hamdist() use the
+ * hardware population count where it is available. The results are
+ * returned as a list or written into a buffer of signed 64-bit integers,
+ * such as an array('q') or a numpy int64 array. An infinite count is
+ * stored as -1, matching popcount().
+ */
+
+#define GMPY_BITS_POPCOUNT 0
+#define GMPY_BITS_HAMDIST  1
+#define GMPY_BITS_TEST     2
+
+typedef struct {
+    int op;
+    mpz_srcptr x;               /* query for hamdist, value for bit_test */
+    const mpz_srcptr *values;
+    const mp_bitcnt_t *index;
+    int64_t *out;
+} gmpy_bits_many;
+
+static void
+_GMPy_Bits_Many_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_bits_many *work = (gmpy_bits_many*)arg;
+    mp_bitcnt_t count;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        if (work->op == GMPY_BITS_TEST) {
+            work->out[i] = mpz_tstbit(work->x, work->index[i]);
+            continue;
+        }
+        if (work->op == GMPY_BITS_POPCOUNT)
+            count = mpz_popcount(work->values[i]);
+        else
+            count = mpz_hamdist(work->x, work->values[i]);
+        work->out[i] = count == (mp_bitcnt_t)(-1) ? -1 : (int64_t)count;
+    }
+}
+
+/* Get a writable buffer of at least n signed 64-bit integers. */
+
+static int
+_GMPy_Bits_Get_Out(PyObject *obj, Py_buffer *view, Py_ssize_t n, const char *name)
+{
+    const char *format;
+
+    if (PyObject_GetBuffer(obj, view, PyBUF_WRITABLE | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0) {
+        if (PyErr_ExceptionMatches(PyExc_BufferError)) {
+            PyErr_Clear();
+            PyErr_Format(PyExc_TypeError, "%s() requires a writable buffer", name);
+        }
+        return -1;
+    }
+    format = view->format ? view->format : "B";
+    if (*format == '@' || *format == '=' || *format == '<')
+        format++;
+    if (view->itemsize != 8 || (strcmp(format, "q") && strcmp(format, "l"))) {
+        PyBuffer_Release(view);
+        PyErr_Format(PyExc_TypeError, "%s() requires a buffer of signed 64-bit integers", name);
+        return -1;
+    }
+    if (view->len / 8 < n) {
+        PyBuffer_Release(view);
+        PyErr_Format(PyExc_ValueError, "buffer is too small for %s()", name);
+        return -1;
+    }
+    return 0;
+}
 
 static PyObject *
-GMPy_Context_Vector(PyObject *self, PyObject *other)
+_GMPy_Bits_Many(PyObject *args, PyObject *keywds, int op, const char *name)
 {
-    PyObject *result, *tempres;
-    Py_ssize_t i, seq_length;
+    static char *kwlist1[] = {"", "out", NULL};
+    static char *kwlist2[] = {"", "", "out", NULL};
+    PyObject *arg0 = NULL, *arg1 = NULL, *out = Py_None, *seq = NULL, *result = NULL;
+    gmpy_rational_view view;
+    gmpy_bits_many work;
+    MPZ_Object *x = NULL;
+    mp_bitcnt_t *index = NULL;
+    int64_t *counts = NULL;
+    Py_buffer outview;
+    Py_ssize_t n, i;
+    size_t bits = 0;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    memset(&view, 0, sizeof(gmpy_rational_view));
+    outview.obj = NULL;
+    work.op = op;
+    work.x = NULL;
+    work.values = NULL;
+    work.index = NULL;
+
+    if (op == GMPY_BITS_POPCOUNT) {
+        if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|O", kwlist1, &arg1, &out))
+            return NULL;
+    }
+    else {
+        if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO|O", kwlist2, &arg0, &arg1, &out))
+            return NULL;
+        if (!IS_INTEGER(arg0)) {
+            PyErr_Format(PyExc_TypeError, "%s() requires integer arguments", name);
+            return NULL;
+        }
+        if (!(x = GMPy_MPZ_From_Integer(arg0, context)))
+            return NULL;
+        work.x = x->z;
+        bits = mpz_sizeinbase(x->z, 2);
+    }
+
+    if (op == GMPY_BITS_TEST) {
+        if (!(seq = PySequence_Fast(arg1, "bit_test_many() requires an iterable")))
+            goto done;
+        n = PySequence_Fast_GET_SIZE(seq);
+        if (!(index = PyMem_New(mp_bitcnt_t, n ? n : 1))) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        for (i = 0; i < n; i++) {
+            index[i] = GMPy_Integer_AsMpBitCnt(PySequence_Fast_GET_ITEM(seq, i));
+            if (index[i] == (mp_bitcnt_t)(-1) && PyErr_Occurred())
+                goto done;
+        }
+        work.index = index;
+    }
+    else {
+        if (_GMPy_View_Init(&view, arg1, name, context) < 0)
+            goto done;
+        if (view.rational) {
+            PyErr_Format(PyExc_TypeError, "%s() requires integer arguments", name);
+            goto done;
+        }
+        n = view.n;
+        work.values = view.num;
+        bits += _GMPy_View_Bits(&view);
+    }
+
+    if (out == Py_None) {
+        if (!(counts = PyMem_New(int64_t, n ? n : 1))) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        work.out = counts;
+    }
+    else {
+        if (_GMPy_Bits_Get_Out(out, &outview, n, name) < 0)
+            goto done;
+        work.out = (int64_t*)outview.buf;
+    }
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    GMPy_Parallel_Run(_GMPy_Bits_Many_Range, &work, n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (out != Py_None) {
+        result = PyLong_FromSsize_t(n);
+        goto done;
+    }
+
+    if (!(result = PyList_New(n)))
+        goto done;
+    for (i = 0; i < n; i++) {
+        PyObject *item;
+
+        if (op == GMPY_BITS_TEST)
+            item = PyBool_FromLong((long)counts[i]);
+        else
+            item = PyLong_FromLongLong((long long)counts[i]);
+        if (!item) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, item);
+    }
+
+  done:
+    if (outview.obj)
+        PyBuffer_Release(&outview);
+    _GMPy_View_Clear(&view);
+    PyMem_Free(counts);
+    PyMem_Free(index);
+    Py_XDECREF(seq);
+    Py_XDECREF((PyObject*)x);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_popcount_many,
+"popcount_many(values, /, out=None) -> list[int] | int\n\n"
+"Return [popcount(x) for x in values] for a sequence of integers or an\n"
+"`mpz_array`. If out is a writable buffer of signed 64-bit integers,\n"
+"the counts are written to the start of out and the number of values is\n"
+"returned.");
+
+static PyObject *
+GMPy_MPZ_Function_Popcount_Many(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Bits_Many(args, keywds, GMPY_BITS_POPCOUNT, "popcount_many");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_hamdist_many,
+"hamdist_many(x, values, /, out=None) -> list[int] | int\n\n"
+"Return [hamdist(x, y) for y in values] for a sequence of integers or\n"
+"an `mpz_array`. If out is a writable buffer of signed 64-bit integers,\n"
+"the distances are written to the start of out and the number of values\n"
+"is returned.");
+
+static PyObject *
+GMPy_MPZ_Function_Hamdist_Many(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Bits_Many(args, keywds, GMPY_BITS_HAMDIST, "hamdist_many");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_bit_test_many,
+"bit_test_many(x, indices, /, out=None) -> list[bool] | int\n\n"
+"Return [bit_test(x, n) for n in indices]. If out is a writable buffer\n"
+"of signed 64-bit integers, 0 or 1 is written for each index to the\n"
+"start of out and the number of indices is returned.");
+
+static PyObject *
+GMPy_MPZ_Function_Bit_Test_Many(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Bits_Many(args, keywds, GMPY_BITS_TEST, "bit_test_many");
+}
+
+/* Fixed-width records for from_bytes_many() and to_bytes_many(). Record i
+ * occupies bytes [i*width, (i+1)*width) of buffer. Does not use the Python
+ * API.
+ */
+
+typedef struct {
+    unsigned char *buffer;
+    size_t width;
+    int endian;
+    int is_signed;
+    mpz_srcptr *in;
+    mpz_ptr *out;
+} gmpy_bytes_many;
+
+static void
+_GMPy_From_Bytes_Many_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_bytes_many *work = (gmpy_bytes_many*)arg;
+    mp_bitcnt_t top = 8 * work->width - 1;
+    Py_ssize_t i;
+    mpz_ptr z;
+    mpz_t half;
+
+    mpz_init(half);
+    mpz_setbit(half, top);
+    for (i = start; i < stop; i++) {
+        z = work->out[i];
+        mpz_import(z, work->width, work->endian, sizeof(char), 0, 0,
+                   work->buffer + i * work->width);
+
+        /* x - 2**(8*width) for a negative record. */
+
+        if (work->is_signed && mpz_tstbit(z, top)) {
+            mpz_clrbit(z, top);
+            mpz_sub(z, z, half);
+        }
+    }
+    mpz_clear(half);
+}
+
+static void
+_GMPy_To_Bytes_Many_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_bytes_many *work = (gmpy_bytes_many*)arg;
+    unsigned char *cp;
+    mpz_srcptr x;
+    size_t size;
+    Py_ssize_t i;
+    mpz_t tmp;
+
+    mpz_init(tmp);
+    for (i = start; i < stop; i++) {
+        cp = work->buffer + i * work->width;
+        x = work->in[i];
 
+        /* A negative value is stored as 2**(8*width) + x. */
+
+        if (mpz_sgn(x) < 0) {
+            mpz_set_ui(tmp, 0);
+            mpz_setbit(tmp, 8 * work->width);
+            mpz_add(tmp, tmp, x);
+            x = tmp;
+        }
+        size = mpz_sgn(x) ? mpz_sizeinbase(x, 256) : 0;
+        if (work->endian > 0) {
+            memset(cp, 0, work->width - size);
+            mpz_export(cp + work->width - size, NULL, 1, sizeof(char), 0, 0, x);
+        }
+        else {
+            mpz_export(cp, NULL, -1, sizeof(char), 0, 0, x);
+            memset(cp + size, 0, work->width - size);
+        }
+    }
+    mpz_clear(tmp);
+}
+
+static int
+_GMPy_Bytes_Many_Endian(const char *byteorder, const char *name)
+{
+    if (strcmp(byteorder, "big") == 0)
+        return 1;
+    if (strcmp(byteorder, "little") == 0)
+        return -1;
+    PyErr_Format(PyExc_ValueError,
+                 "%s() byteorder must be either 'little' or 'big'", name);
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_method_from_bytes_many,
+"mpz.from_bytes_many(buffer, width, byteorder='big', *, signed=False,\n"
+"                    array=False) -> list[mpz] | mpz_array\n\n"
+"Return the integers stored back to back in records of width bytes in a\n"
+"bytes-like object, as [mpz.from_bytes(r, byteorder, signed=signed) for\n"
+"each record r]. The length of buffer must be a multiple of width. If\n"
+"array is True, an `mpz_array` is returned instead of a list. The\n"
+"records are converted without the GIL unless buffer is smaller than\n"
+"the context's release_gil_min_bits.");
+
+static PyObject *
+GMPy_MPZ_Method_From_Bytes_Many(PyTypeObject *type, PyObject *args,
+                                PyObject *keywds)
+{
+    static char *kwlist[] = {"", "", "byteorder", "signed", "array", NULL};
+    PyObject *obj, *result = NULL, *temp;
+    const char *byteorder = "big";
+    gmpy_bytes_many work;
+    Py_ssize_t width, n = 0, i;
+    Py_buffer view;
+    size_t bits;
+    int is_signed = 0, array = 0;
     CTXT_Object *context = NULL;
 
-    if (self && CTXT_Check(self)) {
-        context = (CTXT_Object*)self;
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "On|s$pp", kwlist, &obj,
+                                     &width, &byteorder, &is_signed, &array))
+        return NULL;
+
+    if (width < 1) {
+        VALUE_ERROR("from_bytes_many() width must be > 0");
+        return NULL;
+    }
+    if (!(work.endian = _GMPy_Bytes_Many_Endian(byteorder, "from_bytes_many")))
+        return NULL;
+    if (PyObject_GetBuffer(obj, &view, PyBUF_SIMPLE) < 0)
+        return NULL;
+
+    work.out = NULL;
+    if (view.len % width) {
+        VALUE_ERROR("from_bytes_many() buffer length must be a multiple of width");
+        goto done;
+    }
+    n = view.len / width;
+
+    if (!(work.out = PyMem_New(mpz_ptr, n ? n : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    if (array) {
+        if (!(result = (PyObject*)GMPy_MPZ_Array_New(n)))
+            goto done;
+        for (i = 0; i < n; i++)
+            work.out[i] = ((MPZ_Array_Object*)result)->z[i];
     }
     else {
-        CHECK_CONTEXT(context);
+        if (!(result = PyList_New(n)))
+            goto done;
+        for (i = 0; i < n; i++) {
+            if (!(temp = (PyObject*)GMPy_MPZ_New(context))) {
+                Py_CLEAR(result);
+                goto done;
+            }
+            PyList_SET_ITEM(result, i, temp);
+            work.out[i] = MPZ(temp);
+        }
     }
 
-    if (!(other = PySequence_List(other))) {
-        TYPE_ERROR("argument must be an iterable");
+    work.buffer = (unsigned char*)view.buf;
+    work.width = (size_t)width;
+    work.is_signed = is_signed;
+    bits = (size_t)view.len > ((size_t)-1 >> 3) ? (size_t)-1 : (size_t)view.len * 8;
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    GMPy_Parallel_Run(_GMPy_From_Bytes_Many_Range, &work, n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+  done:
+    PyMem_Free(work.out);
+    PyBuffer_Release(&view);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_method_to_bytes_many,
+"mpz.to_bytes_many(values, width, byteorder='big', *, signed=False) -> bytes\n\n"
+"Return the integers in values, a sequence or an `mpz_array`, as records\n"
+"of width bytes stored back to back, as b''.join(mpz(x).to_bytes(width,\n"
+"byteorder, signed=signed) for x in values). An `OverflowError` is raised\n"
+"if a value does not fit. The records are written without the GIL unless\n"
+"the result is smaller than the context's release_gil_min_bits.");
+
+static PyObject *
+GMPy_MPZ_Method_To_Bytes_Many(PyTypeObject *type, PyObject *args,
+                              PyObject *keywds)
+{
+    static char *kwlist[] = {"", "", "byteorder", "signed", NULL};
+    PyObject *values, *result = NULL;
+    const char *byteorder = "big";
+    gmpy_rational_view view;
+    gmpy_bytes_many work;
+    Py_ssize_t width, i;
+    mpz_srcptr x;
+    size_t bits;
+    int is_signed = 0;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "On|s$p", kwlist, &values,
+                                     &width, &byteorder, &is_signed))
+        return NULL;
+
+    if (width < 1) {
+        VALUE_ERROR("to_bytes_many() width must be > 0");
         return NULL;
     }
+    if (!(work.endian = _GMPy_Bytes_Many_Endian(byteorder, "to_bytes_many")))
+        return NULL;
+    if (_GMPy_View_Init(&view, values, "to_bytes_many", context) < 0)
+        return NULL;
+    if (view.rational) {
+        TYPE_ERROR("to_bytes_many() requires integer arguments");
+        goto done;
+    }
 
-    /* other contains a new list containing all the values from the
-     * iterable. Create a list to store the results.
+    /* Unsigned values need at most 8*width bits; signed values lie in
+     * [-2**(8*width-1), 2**(8*width-1)).
      */
 
-    seq_length = PyList_GET_SIZE(other);
-    if (!(result = PyList_New(seq_length))) {
-        Py_DECREF(other);
+    bits = 8 * (size_t)width;
+    for (i = 0; i < view.n; i++) {
+        x = view.num[i];
+        if (mpz_sgn(x) < 0 && !is_signed) {
+            PyErr_Format(PyExc_OverflowError,
+                         "to_bytes_many() can't convert negative values[%zd] to unsigned", i);
+            goto done;
+        }
+        if (mpz_sgn(x) && mpz_sizeinbase(x, 2) > bits - is_signed &&
+            !(mpz_sgn(x) < 0 && mpz_sizeinbase(x, 2) == bits &&
+              mpz_scan1(x, 0) == bits - 1)) {
+            PyErr_Format(PyExc_OverflowError,
+                         "to_bytes_many() values[%zd] does not fit in %zd bytes", i, width);
+            goto done;
+        }
+    }
+
+    if (view.n > PY_SSIZE_T_MAX / width) {
+        OVERFLOW_ERROR("to_bytes_many() result is too large");
+        goto done;
+    }
+    if (!(result = PyBytes_FromStringAndSize(NULL, view.n * width)))
+        goto done;
+
+    work.buffer = (unsigned char*)PyBytes_AS_STRING(result);
+    work.width = (size_t)width;
+    work.in = view.num;
+    bits = (size_t)(view.n * width) > ((size_t)-1 >> 3) ? (size_t)-1 : (size_t)(view.n * width) * 8;
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    GMPy_Parallel_Run(_GMPy_To_Bytes_Many_Range, &work, view.n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+  done:
+    _GMPy_View_Clear(&view);
+    return result;
+}
+
+/* Sorting for sort() and argsort(). The key of a value orders its sign, bit
+ * length and leading 64 bits, so values with different keys compare like
+ * their keys. The keys are sorted with a stable LSD radix sort; only runs
+ * of equal keys for values of more than 64 bits are sorted again with
+ * mpz_cmp(). Does not use the Python API.
+ */
+
+typedef struct {
+    uint64_t hi;
+    uint64_t lo;
+    Py_ssize_t index;
+} gmpy_sort_key;
+
+typedef struct {
+    mpz_srcptr *values;
+    gmpy_sort_key *keys;
+    int reverse;
+} gmpy_sort_work;
+
+/* Return bits [start, start+64) of abs(x). */
+
+static uint64_t
+_GMPy_MPZ_Bits64(mpz_srcptr x, mp_bitcnt_t start)
+{
+    size_t i = start / GMP_NUMB_BITS, size = mpz_size(x);
+    unsigned int shift = start % GMP_NUMB_BITS, got = 0;
+    uint64_t result = 0;
+
+    for (; got < 64 && i < size; i++) {
+        result |= (uint64_t)(mpz_getlimbn(x, i) >> shift) << got;
+        got += GMP_NUMB_BITS - shift;
+        shift = 0;
+    }
+    return result;
+}
+
+static void
+_GMPy_Sort_Keys_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_sort_work *work = (gmpy_sort_work*)arg;
+    gmpy_sort_key *key;
+    mpz_srcptr x;
+    mp_bitcnt_t bits, low;
+    uint64_t hi, lo;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        x = work->values[i];
+        hi = (uint64_t)1 << 63;
+        lo = 0;
+        if (mpz_sgn(x)) {
+            bits = mpz_sizeinbase(x, 2);
+            low = bits > 64 ? bits - 64 : 0;
+            lo = _GMPy_MPZ_Bits64(x, low) << (64 - (bits - low));
+            if (mpz_sgn(x) > 0) {
+                hi += bits;
+            }
+            else {
+                hi -= bits + 1;
+                lo = ~lo;
+            }
+        }
+        key = &work->keys[i];
+        key->hi = work->reverse ? ~hi : hi;
+        key->lo = work->reverse ? ~lo : lo;
+        key->index = i;
+    }
+}
+
+static int
+_GMPy_Sort_Key_Cmp(const gmpy_sort_key *a, const gmpy_sort_key *b,
+                   mpz_srcptr *values, int reverse)
+{
+    int cmp = mpz_cmp(values[a->index], values[b->index]);
+
+    return reverse ? -cmp : cmp;
+}
+
+/* Stable merge sort of keys[0:n] by value, using temp[0:n]. */
+
+static void
+_GMPy_Sort_Merge(gmpy_sort_key *keys, gmpy_sort_key *temp, Py_ssize_t n,
+                 mpz_srcptr *values, int reverse)
+{
+    Py_ssize_t i, j, k, half;
+    gmpy_sort_key key;
+
+    if (n <= 16) {
+        for (i = 1; i < n; i++) {
+            key = keys[i];
+            for (j = i; j > 0 && _GMPy_Sort_Key_Cmp(&keys[j - 1], &key, values, reverse) > 0; j--)
+                keys[j] = keys[j - 1];
+            keys[j] = key;
+        }
+        return;
+    }
+
+    half = n / 2;
+    _GMPy_Sort_Merge(keys, temp, half, values, reverse);
+    _GMPy_Sort_Merge(keys + half, temp, n - half, values, reverse);
+    if (_GMPy_Sort_Key_Cmp(&keys[half - 1], &keys[half], values, reverse) <= 0)
+        return;
+
+    memcpy(temp, keys, half * sizeof(gmpy_sort_key));
+    for (i = 0, j = half, k = 0; i < half; k++) {
+        if (j < n && _GMPy_Sort_Key_Cmp(&keys[j], &temp[i], values, reverse) < 0)
+            keys[k] = keys[j++];
+        else
+            keys[k] = temp[i++];
+    }
+}
+
+/* Sort the n keys in keys[] using temp[] and return the buffer that holds
+ * the result.
+ */
+
+static gmpy_sort_key *
+_GMPy_Sort_Radix(gmpy_sort_key *keys, gmpy_sort_key *temp, Py_ssize_t n)
+{
+    size_t count[16][256], total, c;
+    gmpy_sort_key *swap;
+    Py_ssize_t i;
+    uint64_t word;
+    int d, b, shift;
+
+    memset(count, 0, sizeof(count));
+    for (i = 0; i < n; i++) {
+        for (d = 0; d < 8; d++) {
+            count[d][(keys[i].lo >> (8 * d)) & 255]++;
+            count[d + 8][(keys[i].hi >> (8 * d)) & 255]++;
+        }
+    }
+
+    for (d = 0; d < 16; d++) {
+        shift = 8 * (d & 7);
+        word = d < 8 ? keys[0].lo : keys[0].hi;
+
+        /* Skip a digit that is the same for every key. */
+
+        if (count[d][(word >> shift) & 255] == (size_t)n)
+            continue;
+
+        for (b = 0, total = 0; b < 256; b++) {
+            c = count[d][b];
+            count[d][b] = total;
+            total += c;
+        }
+        for (i = 0; i < n; i++) {
+            word = d < 8 ? keys[i].lo : keys[i].hi;
+            temp[count[d][(word >> shift) & 255]++] = keys[i];
+        }
+        swap = keys;
+        keys = temp;
+        temp = swap;
+    }
+    return keys;
+}
+
+/* Return the keys of view sorted by value, or NULL with an exception set.
+ * *block must be freed with PyMem_Free().
+ */
+
+static gmpy_sort_key *
+_GMPy_Sort_View(gmpy_rational_view *view, int reverse, gmpy_sort_key **block,
+                CTXT_Object *context)
+{
+    gmpy_sort_work work;
+    gmpy_sort_key *keys, *temp;
+    Py_ssize_t n = view->n, i, j;
+
+    if (!(*block = PyMem_New(gmpy_sort_key, 2 * (n ? n : 1)))) {
+        PyErr_NoMemory();
         return NULL;
     }
+    work.values = view->num;
+    work.keys = *block;
+    work.reverse = reverse;
 
-    /* Iterate through the list. */
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, _GMPy_View_Bits(view));
+    GMPy_Parallel_Run(_GMPy_Sort_Keys_Range, &work, n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    keys = *block;
+    temp = *block + n;
+    if (n > 1)
+        keys = _GMPy_Sort_Radix(keys, temp, n);
+    temp = keys == *block ? *block + n : *block;
 
-    for (i=0; i < seq_length; i++) {
-        if (!(tempres = GMPy_Number_Sin(PyList_GET_ITEM(other, i), context))) {
-            Py_DECREF(other);
-            Py_DECREF(result);
-            TYPE_ERROR("all items in iterable must be numbers");
-            return NULL;
+    /* Equal keys are equal values unless the values have more than 64 bits.
+     * Those are in the order of index.
+     */
+
+    for (i = 0; i < n; i = j) {
+        for (j = i + 1; j < n && keys[j].hi == keys[i].hi && keys[j].lo == keys[i].lo; j++)
+            ;
+        if (j - i > 1 && mpz_sizeinbase(view->num[keys[i].index], 2) > 64)
+            _GMPy_Sort_Merge(keys + i, temp, j - i, view->num, reverse);
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    return keys;
+}
+
+static PyObject *
+_GMPy_Sort(PyObject *args, PyObject *keywds, int indices, const char *name)
+{
+    static char *kwlist[] = {"", "reverse", NULL};
+    PyObject *values, *result = NULL, **items, *item;
+    gmpy_rational_view view;
+    gmpy_sort_key *keys, *block = NULL;
+    MPZ_Array_Object *array;
+    Py_ssize_t i;
+    int reverse = 0;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|$p", kwlist, &values, &reverse))
+        return NULL;
+    if (_GMPy_View_Init(&view, values, name, context) < 0)
+        return NULL;
+    if (view.rational) {
+        PyErr_Format(PyExc_TypeError, "%s() requires integer arguments", name);
+        goto done;
+    }
+    if (!(keys = _GMPy_Sort_View(&view, reverse, &block, context)))
+        goto done;
+
+    if (indices) {
+        if (!(result = PyList_New(view.n)))
+            goto done;
+        for (i = 0; i < view.n; i++) {
+            if (!(item = PyLong_FromSsize_t(keys[i].index))) {
+                Py_CLEAR(result);
+                goto done;
+            }
+            PyList_SET_ITEM(result, i, item);
+        }
+    }
+    else if (MPZ_Array_Check(view.seq)) {
+        if (!(array = GMPy_MPZ_Array_New(view.n)))
+            goto done;
+        for (i = 0; i < view.n; i++)
+            mpz_set(array->z[i], view.num[keys[i].index]);
+        result = (PyObject*)array;
+    }
+    else {
+        if (!(result = PyList_New(view.n)))
+            goto done;
+        items = PySequence_Fast_ITEMS(view.seq);
+        for (i = 0; i < view.n; i++) {
+            item = items[keys[i].index];
+            Py_INCREF(item);
+            PyList_SET_ITEM(result, i, item);
         }
+    }
 
-        if (PyList_SetItem(result, i, tempres) < 0) {
-            Py_DECREF(other);
-            Py_DECREF(result);
-            return NULL;
+  done:
+    PyMem_Free(block);
+    _GMPy_View_Clear(&view);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_sort,
+"sort(values, /, *, reverse=False) -> list | mpz_array\n\n"
+"Return the integers in values in ascending order, or in descending order\n"
+"if reverse is True. Like sorted(), the sort is stable and the result is\n"
+"a list of the original objects; if values is an `mpz_array`, a new\n"
+"`mpz_array` is returned.");
+
+static PyObject *
+GMPy_MPZ_Function_Sort(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Sort(args, keywds, 0, "sort");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_argsort,
+"argsort(values, /, *, reverse=False) -> list[int]\n\n"
+"Return the indices that sort the integers in values: the list of i such\n"
+"that [values[i] for i in argsort(values)] == sort(values). Equal values\n"
+"keep their order.");
+
+static PyObject *
+GMPy_MPZ_Function_Argsort(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    return _GMPy_Sort(args, keywds, 1, "argsort");
+}
+
+/* Binary search of the sorted values for bisect(). Does not use the Python
+ * API.
+ */
+
+typedef struct {
+    mpz_srcptr *values;
+    Py_ssize_t n;
+    mpz_srcptr *x;
+    Py_ssize_t *out;
+    int right;
+} gmpy_bisect_work;
+
+static void
+_GMPy_Bisect_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_bisect_work *work = (gmpy_bisect_work*)arg;
+    Py_ssize_t i, lo, hi, mid;
+    int cmp;
+
+    for (i = start; i < stop; i++) {
+        lo = 0;
+        hi = work->n;
+        while (lo < hi) {
+            mid = lo + (hi - lo) / 2;
+            cmp = mpz_cmp(work->x[i], work->values[mid]);
+            if (cmp < 0 || (cmp == 0 && !work->right))
+                hi = mid;
+            else
+                lo = mid + 1;
         }
+        work->out[i] = lo;
     }
+}
 
-    Py_DECREF(other);
+PyDoc_STRVAR(GMPy_doc_function_bisect,
+"bisect(values, x, /, side='right') -> int | list[int]\n\n"
+"Return the index where x would be inserted in values, a sequence of\n"
+"integers or an `mpz_array` in ascending order, to keep it sorted. If\n"
+"side is 'right', the index is after any values equal to x, as\n"
+"bisect.bisect_right(); if side is 'left', it is before them. If x is\n"
+"a sequence of integers, a list with the index of each is returned.");
 
-    return (PyObject*)result;
+static PyObject *
+GMPy_MPZ_Function_Bisect(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {"", "", "side", NULL};
+    PyObject *values, *x, *result = NULL, *item;
+    const char *side = "right";
+    gmpy_rational_view view, xview;
+    gmpy_bisect_work work;
+    MPZ_Object *tempx = NULL;
+    mpz_srcptr one;
+    Py_ssize_t i, *out = NULL;
+    size_t bits, steps = 1;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    memset(&xview, 0, sizeof(gmpy_rational_view));
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO|s", kwlist, &values, &x, &side))
+        return NULL;
+    if (!strcmp(side, "right"))
+        work.right = 1;
+    else if (!strcmp(side, "left"))
+        work.right = 0;
+    else {
+        VALUE_ERROR("bisect() side must be 'left' or 'right'");
+        return NULL;
+    }
+    if (_GMPy_View_Init(&view, values, "bisect", context) < 0)
+        return NULL;
+    if (view.rational) {
+        TYPE_ERROR("bisect() requires integer arguments");
+        goto done;
+    }
+
+    work.values = view.num;
+    work.n = view.n;
+
+    if (IS_INTEGER(x)) {
+        if (!(tempx = GMPy_MPZ_From_Integer(x, context)))
+            goto done;
+        one = tempx->z;
+        work.x = &one;
+        work.out = &i;
+        _GMPy_Bisect_Range(&work, 0, 1);
+        result = PyLong_FromSsize_t(i);
+        goto done;
+    }
+
+    if (_GMPy_View_Init(&xview, x, "bisect", context) < 0)
+        goto done;
+    if (xview.rational) {
+        TYPE_ERROR("bisect() requires integer arguments");
+        goto done;
+    }
+    if (!(out = PyMem_New(Py_ssize_t, xview.n ? xview.n : 1))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    work.x = xview.num;
+    work.out = out;
+
+    /* Each search reads about log2(n) values. */
+
+    bits = _GMPy_View_Bits(&xview);
+    for (i = view.n; i > 1; i >>= 1)
+        steps++;
+    bits *= steps;
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, bits);
+    GMPy_Parallel_Run(_GMPy_Bisect_Range, &work, xview.n,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (!(result = PyList_New(xview.n)))
+        goto done;
+    for (i = 0; i < xview.n; i++) {
+        if (!(item = PyLong_FromSsize_t(out[i]))) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, item);
+    }
+
+  done:
+    PyMem_Free(out);
+    Py_XDECREF((PyObject*)tempx);
+    _GMPy_View_Clear(&xview);
+    _GMPy_View_Clear(&view);
+    return result;
 }
 
+#ifdef VECTOR
+
+/* The following code is a test case for applying an MPFR function to a pair
+ * of lists. It is only compiled with --vector.
+ */
+
 PyDoc_STRVAR(GMPy_doc_function_vector2,
 "vector2(iterable, iterable, /) -> list\n\n"
 "Template for applying a function to a pair of iterables.");
@@ -182,3 +3020,5 @@ GMPy_Context_Vector2(PyObject *self, PyObject *args)
 
     return (PyObject*)result;
 }
+
+#endif /* defined(VECTOR) */
@@ -31,8 +31,31 @@
 extern "C" {
 #endif
 
-static PyObject * GMPy_Context_Vector(PyObject *self, PyObject *other);
+static PyObject * GMPy_Context_Vector(PyObject *self, PyObject *args);
+static PyObject * GMPy_Context_VAdd(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Context_VSub(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Context_VMul(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Context_VDiv(PyObject *self, PyObject *args);
+static PyObject * GMPy_Context_VMod(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Context_VPowMod(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Context_VIsqrt(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Context_VCmp(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Context_Isum(PyObject *self, PyObject *other);
+static PyObject * GMPy_MPQ_Function_Many(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_Context_Dot(PyObject *self, PyObject *args);
+static PyObject * GMPy_Context_Polyval(PyObject *self, PyObject *args);
+static PyObject * GMPy_Context_Polyval_Many(PyObject *self, PyObject *args);
+static PyObject * GMPy_MPZ_Function_Popcount_Many(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_Function_Hamdist_Many(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_Function_Bit_Test_Many(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_Method_From_Bytes_Many(PyTypeObject *type, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_Method_To_Bytes_Many(PyTypeObject *type, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_Function_Sort(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_Function_Argsort(PyObject *self, PyObject *args, PyObject *keywds);
+static PyObject * GMPy_MPZ_Function_Bisect(PyObject *self, PyObject *args, PyObject *keywds);
+#ifdef VECTOR
 static PyObject * GMPy_Context_Vector2(PyObject *self, PyObject *args);
+#endif
 
 #ifdef __cplusplus
 }
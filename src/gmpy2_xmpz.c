@@ -92,7 +92,10 @@ static PyGetSetDef GMPy_XMPZ_getseters[] =
 static PyMethodDef GMPy_XMPZ_methods [] =
 {
     { "__format__", GMPy_MPZ_Format, METH_VARARGS, GMPy_doc_mpz_format },
+    { "__reduce__", GMPy_MPANY_Reduce_Method, METH_NOARGS, GMPy_doc_method_reduce },
+    { "__reduce_ex__", GMPy_MPANY_Reduce_Ex_Method, METH_O, GMPy_doc_method_reduce_ex },
     { "__sizeof__", GMPy_XMPZ_Method_SizeOf, METH_NOARGS, GMPy_doc_xmpz_method_sizeof },
+    { "addmul", GMPy_XMPZ_Method_AddMul, METH_VARARGS, GMPy_doc_xmpz_method_addmul },
     { "bit_clear", GMPy_MPZ_bit_clear_method, METH_O, doc_bit_clear_method },
     { "bit_flip", GMPy_MPZ_bit_flip_method, METH_O, doc_bit_flip_method },
     { "bit_length", GMPy_MPZ_bit_length_method, METH_NOARGS, doc_bit_length_method },
@@ -100,15 +103,26 @@ static PyMethodDef GMPy_XMPZ_methods [] =
     { "bit_scan1", GMPy_MPZ_bit_scan1_method, METH_VARARGS, doc_bit_scan1_method },
     { "bit_set", GMPy_MPZ_bit_set_method, METH_O, doc_bit_set_method },
     { "bit_test", GMPy_MPZ_bit_test_method, METH_O, doc_bit_test_method },
+    { "bits", (PyCFunction)(void(*)(void))GMPy_MPZ_bits_method, METH_FASTCALL, doc_bits_method },
+    { "clear_stride", GMPy_XMPZ_Method_ClearStride, METH_VARARGS, GMPy_doc_xmpz_method_clear_stride },
     { "conjugate", GMPy_MP_Method_Conjugate, METH_NOARGS, GMPy_doc_mp_method_conjugate },
     { "copy", GMPy_XMPZ_Method_Copy, METH_NOARGS, GMPy_doc_xmpz_method_copy },
     { "digits", GMPy_XMPZ_Digits_Method, METH_VARARGS, GMPy_doc_mpz_digits_method },
+    { "divexact_inplace", GMPy_XMPZ_Method_DivExactInplace, METH_VARARGS, GMPy_doc_xmpz_method_divexact_inplace },
+    { "gcd_inplace", GMPy_XMPZ_Method_GCDInplace, METH_VARARGS, GMPy_doc_xmpz_method_gcd_inplace },
+    { "invert_inplace", GMPy_XMPZ_Method_InvertInplace, METH_VARARGS, GMPy_doc_xmpz_method_invert_inplace },
     { "iter_bits", (PyCFunction)GMPy_XMPZ_Method_IterBits, METH_VARARGS | METH_KEYWORDS, GMPy_doc_xmpz_method_iter_bits },
     { "iter_clear", (PyCFunction)GMPy_XMPZ_Method_IterClear, METH_VARARGS | METH_KEYWORDS, GMPy_doc_xmpz_method_iter_clear },
     { "iter_set", (PyCFunction)GMPy_XMPZ_Method_IterSet, METH_VARARGS | METH_KEYWORDS, GMPy_doc_xmpz_method_iter_set },
     { "make_mpz", GMPy_XMPZ_Method_MakeMPZ, METH_NOARGS, GMPy_doc_xmpz_method_make_mpz },
-    { "num_digits", GMPy_MPZ_Method_NumDigits, METH_VARARGS, GMPy_doc_mpz_method_num_digits },
+    { "num_digits", (PyCFunction)GMPy_MPZ_Method_NumDigits, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_method_num_digits },
     { "num_limbs", GMPy_XMPZ_Method_NumLimbs, METH_NOARGS, GMPy_doc_xmpz_method_num_limbs },
+    { "popcount", GMPy_XMPZ_Method_Popcount, METH_VARARGS, GMPy_doc_xmpz_method_popcount },
+    { "powmod_inplace", GMPy_XMPZ_Method_PowModInplace, METH_VARARGS, GMPy_doc_xmpz_method_powmod_inplace },
+    { "set_bits_array", (PyCFunction)GMPy_XMPZ_Method_SetBitsArray, METH_VARARGS | METH_KEYWORDS, GMPy_doc_xmpz_method_set_bits_array },
+    { "set_stride", GMPy_XMPZ_Method_SetStride, METH_VARARGS, GMPy_doc_xmpz_method_set_stride },
+    { "shrink", GMPy_XMPZ_Method_Shrink, METH_NOARGS, GMPy_doc_xmpz_method_shrink },
+    { "submul", GMPy_XMPZ_Method_SubMul, METH_VARARGS, GMPy_doc_xmpz_method_submul },
     { "limbs_read", GMPy_XMPZ_Method_LimbsRead, METH_NOARGS, GMPy_doc_xmpz_method_limbs_read },
     { "limbs_write", GMPy_XMPZ_Method_LimbsWrite, METH_O, GMPy_doc_xmpz_method_limbs_write },
     { "limbs_modify", GMPy_XMPZ_Method_LimbsModify, METH_O, GMPy_doc_xmpz_method_limbs_modify },
@@ -125,6 +139,7 @@ static PyTypeObject XMPZ_Type =
     .tp_repr = (reprfunc) GMPy_XMPZ_Repr_Slot,        
     .tp_as_number = &GMPy_XMPZ_number_methods,            
     .tp_as_mapping = &GMPy_XMPZ_mapping_methods,          
+    .tp_as_buffer = &GMPy_XMPZ_as_buffer,
     .tp_str = (reprfunc) GMPy_XMPZ_Str_Slot,         
     .tp_flags = Py_TPFLAGS_DEFAULT,                    
     .tp_doc = GMPy_doc_xmpz,                         
@@ -34,7 +34,75 @@ extern "C" {
 static PyTypeObject XMPZ_Type;
 #define XMPZ(obj) (((XMPZ_Object*)(obj))->z)
 #define XMPZ_Check(v) (((PyObject*)v)->ob_type == &XMPZ_Type)
-#define CHECK_MPZANY(v) (MPZ_Check(v) || XMPZ_Check(v))
+#define CHECK_MPZANY(v) (MPZ_Check(v) || XMPZ_Check(v) || MPZ_View_Check(v))
+
+/* An xmpz can share its limbs with an immutable mpz: mpz(x), x.copy(), and
+ * xmpz(z) of a large value move or alias the limbs instead of copying them
+ * (copy on write). z is then a read-only alias set with mpz_roinit_n() and
+ * owner keeps the mpz alive. XMPZ_PREPARE_CHANGE() must precede every change
+ * of the value: it copies shared limbs, and raises BufferError while a
+ * buffer returned by the buffer protocol refers to the limbs, since they
+ * cannot be changed or reallocated then.
+ */
+
+#define GMPY_XMPZ_SHARE_LIMBS 16
+
+#define XMPZ_PREPARE_CHANGE(obj, err) \
+    if (((XMPZ_Object*)(obj))->exports) { \
+        PyErr_SetString(PyExc_BufferError, \
+                        "xmpz cannot be modified while its limbs are exported"); \
+        return err; \
+    } \
+    if (((XMPZ_Object*)(obj))->owner) \
+        _GMPy_XMPZ_Detach((XMPZ_Object*)(obj));
+
+static void          _GMPy_XMPZ_Detach(XMPZ_Object *self);
+static MPZ_Object *  _GMPy_XMPZ_Freeze(XMPZ_Object *self, CTXT_Object *context);
+static void          _GMPy_XMPZ_Share(XMPZ_Object *self, MPZ_Object *owner);
+
+static int           GMPy_XMPZ_Out_Kwnames(PyObject *const *args, Py_ssize_t nargs,
+                                           PyObject *kwnames, XMPZ_Object **out,
+                                           const char *name);
+static int           GMPy_XMPZ_Out_Begin(XMPZ_Object *out);
+static PyObject *    GMPy_XMPZ_Out_End(XMPZ_Object *out);
+static PyObject *    GMPy_XMPZ_Out_Binop(XMPZ_Object *out, PyObject *x, PyObject *y,
+                                         int op, const char *name, CTXT_Object *context);
+
+/* In a free-threaded build the operations that change an xmpz hold its
+ * mutex, and the mutex of an xmpz operand, so concurrent updates of a
+ * shared xmpz are serialized. The mutex stays held while a core runs
+ * detached from the interpreter. Reading an xmpz with other functions
+ * while another thread changes it is not protected.
+ */
+
+#ifdef Py_GIL_DISABLED
+#  define XMPZ_LOCK(obj)            PyMutex_Lock(&((XMPZ_Object*)(obj))->mutex)
+#  define XMPZ_UNLOCK(obj)          PyMutex_Unlock(&((XMPZ_Object*)(obj))->mutex)
+#  define XMPZ_LOCK2(obj, other)    _GMPy_XMPZ_Lock2((PyObject*)(obj), (PyObject*)(other))
+#  define XMPZ_UNLOCK2(obj, other)  _GMPy_XMPZ_Unlock2((PyObject*)(obj), (PyObject*)(other))
+static void _GMPy_XMPZ_Lock2(PyObject *self, PyObject *other);
+static void _GMPy_XMPZ_Unlock2(PyObject *self, PyObject *other);
+#else
+#  define XMPZ_LOCK(obj)
+#  define XMPZ_UNLOCK(obj)
+#  define XMPZ_LOCK2(obj, other)
+#  define XMPZ_UNLOCK2(obj, other)
+#endif
+
+/* Define name() as _name() called with self, and other if it is a
+ * different xmpz, locked.
+ */
+
+#define XMPZ_LOCKED(name)                               \
+    static PyObject *                                   \
+    name(PyObject *self, PyObject *other)               \
+    {                                                   \
+        PyObject *result;                               \
+        XMPZ_LOCK2(self, other);                        \
+        result = _##name(self, other);                  \
+        XMPZ_UNLOCK2(self, other);                      \
+        return result;                                  \
+    }
 
 typedef struct {
     PyObject_HEAD
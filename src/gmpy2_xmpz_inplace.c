@@ -29,11 +29,47 @@
 
 #include <math.h>
 
+#ifdef Py_GIL_DISABLED
+/* Lock self and, if it is a different xmpz, other. The mutexes are taken
+ * in address order so two threads updating x and y from each other cannot
+ * deadlock.
+ */
+
+static void
+_GMPy_XMPZ_Lock2(PyObject *self, PyObject *other)
+{
+    if (other && other != self && XMPZ_Check(other)) {
+        if (self < other) {
+            XMPZ_LOCK(self);
+            XMPZ_LOCK(other);
+        }
+        else {
+            XMPZ_LOCK(other);
+            XMPZ_LOCK(self);
+        }
+    }
+    else {
+        XMPZ_LOCK(self);
+    }
+}
+
+static void
+_GMPy_XMPZ_Unlock2(PyObject *self, PyObject *other)
+{
+    if (other && other != self && XMPZ_Check(other)) {
+        XMPZ_UNLOCK(other);
+    }
+    XMPZ_UNLOCK(self);
+}
+#endif
+
 /* Inplace xmpz addition. */
 
 static PyObject *
-GMPy_XMPZ_IAdd_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IAdd_Slot(PyObject *self, PyObject *other)
 {
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
     /* Try to make mpz + small_int faster */
 
     CTXT_Object *context = NULL;
@@ -57,7 +93,7 @@ GMPy_XMPZ_IAdd_Slot(PyObject *self, PyObject *other)
             mpz_t tempz;
             mpz_init(tempz);
             mpz_set_PyLong(tempz, other);
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), tempz));
             mpz_add(MPZ(self), MPZ(self), tempz);
             GMPY_MAYBE_END_ALLOW_THREADS(context);
             mpz_clear(tempz);
@@ -67,7 +103,7 @@ GMPy_XMPZ_IAdd_Slot(PyObject *self, PyObject *other)
     }
 
     if (IS_TYPE_MPZANY(ytype)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), MPZ(other)));
         mpz_add(MPZ(self), MPZ(self), MPZ(other));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
@@ -77,12 +113,16 @@ GMPy_XMPZ_IAdd_Slot(PyObject *self, PyObject *other)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_IAdd_Slot)
+
 /* Inplace mpz subtraction.
  */
 
 static PyObject *
-GMPy_XMPZ_ISub_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_ISub_Slot(PyObject *self, PyObject *other)
 {
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
 
@@ -104,7 +144,7 @@ GMPy_XMPZ_ISub_Slot(PyObject *self, PyObject *other)
             mpz_t tempz;
             mpz_init(tempz);
             mpz_set_PyLong(tempz, other);
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), tempz));
             mpz_sub(MPZ(self), MPZ(self), tempz);
             GMPY_MAYBE_END_ALLOW_THREADS(context);
             mpz_clear(tempz);
@@ -114,7 +154,7 @@ GMPy_XMPZ_ISub_Slot(PyObject *self, PyObject *other)
     }
 
     if (IS_TYPE_MPZANY(ytype)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), MPZ(other)));
         mpz_sub(MPZ(self), MPZ(self), MPZ(other));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
@@ -124,12 +164,16 @@ GMPy_XMPZ_ISub_Slot(PyObject *self, PyObject *other)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_ISub_Slot)
+
 /* Inplace xmpz multiplication.
  */
 
 static PyObject *
-GMPy_XMPZ_IMul_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IMul_Slot(PyObject *self, PyObject *other)
 {
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
 
@@ -146,7 +190,7 @@ GMPy_XMPZ_IMul_Slot(PyObject *self, PyObject *other)
             mpz_t tempz;
             mpz_init(tempz);
             mpz_set_PyLong(tempz, other);
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), tempz));
             mpz_mul(MPZ(self), MPZ(self), tempz);
             GMPY_MAYBE_END_ALLOW_THREADS(context);
             mpz_clear(tempz);
@@ -156,7 +200,7 @@ GMPy_XMPZ_IMul_Slot(PyObject *self, PyObject *other)
     }
 
     if (IS_TYPE_MPZANY(ytype)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), MPZ(other)));
         mpz_mul(MPZ(self), MPZ(self), MPZ(other));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
@@ -166,14 +210,18 @@ GMPy_XMPZ_IMul_Slot(PyObject *self, PyObject *other)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_IMul_Slot)
+
 /* Pympany_floordiv follows the // semantics from Python 3.x. The result is
  * an mpz when the arguments are mpz or mpq, but the result is an mpf when
  * the arguments are mpf.
  */
 
 static PyObject *
-GMPy_XMPZ_IFloorDiv_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IFloorDiv_Slot(PyObject *self, PyObject *other)
 {
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
 
@@ -200,7 +248,7 @@ GMPy_XMPZ_IFloorDiv_Slot(PyObject *self, PyObject *other)
             mpz_t tempz;
             mpz_init(tempz);
             mpz_set_PyLong(tempz, other);
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), tempz));
             mpz_fdiv_q(MPZ(self), MPZ(self), tempz);
             GMPY_MAYBE_END_ALLOW_THREADS(context);
             mpz_clear(tempz);
@@ -214,7 +262,7 @@ GMPy_XMPZ_IFloorDiv_Slot(PyObject *self, PyObject *other)
             ZERO_ERROR("xmpz division by zero");
             return NULL;
         }
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), MPZ(other)));
         mpz_fdiv_q(MPZ(self), MPZ(self), MPZ(other));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
@@ -224,12 +272,16 @@ GMPy_XMPZ_IFloorDiv_Slot(PyObject *self, PyObject *other)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_IFloorDiv_Slot)
+
 /* Inplace xmpz remainder.
  */
 
 static PyObject *
-GMPy_XMPZ_IRem_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IRem_Slot(PyObject *self, PyObject *other)
 {
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
 
@@ -255,7 +307,7 @@ GMPy_XMPZ_IRem_Slot(PyObject *self, PyObject *other)
             mpz_t tempz;
             mpz_init(tempz);
             mpz_set_PyLong(tempz, other);
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), tempz));
             mpz_fdiv_r(MPZ(self), MPZ(self), tempz);
             GMPY_MAYBE_END_ALLOW_THREADS(context);
             mpz_clear(tempz);
@@ -269,7 +321,7 @@ GMPy_XMPZ_IRem_Slot(PyObject *self, PyObject *other)
             ZERO_ERROR("xmpz modulo by zero");
             return NULL;
         }
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), MPZ(other)));
         mpz_fdiv_r(MPZ(self), MPZ(self), MPZ(other));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
@@ -279,12 +331,16 @@ GMPy_XMPZ_IRem_Slot(PyObject *self, PyObject *other)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_IRem_Slot)
+
 /* Inplace xmpz rshift.
  */
 
 static PyObject *
-GMPy_XMPZ_IRshift_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IRshift_Slot(PyObject *self, PyObject *other)
 {
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
     mp_bitcnt_t shift = GMPy_Integer_AsMpBitCnt(other);
     if (shift == (mp_bitcnt_t)(-1) && PyErr_Occurred())
         return NULL;
@@ -296,12 +352,16 @@ GMPy_XMPZ_IRshift_Slot(PyObject *self, PyObject *other)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_IRshift_Slot)
+
 /* Inplace xmpz lshift.
  */
 
 static PyObject *
-GMPy_XMPZ_ILshift_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_ILshift_Slot(PyObject *self, PyObject *other)
 {
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
     mp_bitcnt_t shift = GMPy_Integer_AsMpBitCnt(other);
     if (shift == (mp_bitcnt_t)(-1) && PyErr_Occurred())
         return NULL;
@@ -313,12 +373,16 @@ GMPy_XMPZ_ILshift_Slot(PyObject *self, PyObject *other)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_ILshift_Slot)
+
 /* Inplace xmpz_pow.
  */
 
 static PyObject *
-GMPy_XMPZ_IPow_Slot(PyObject *self, PyObject *other, PyObject *mod)
+_GMPy_XMPZ_IPow_Slot(PyObject *self, PyObject *other, PyObject *mod)
 {
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
     mp_bitcnt_t exp = GMPy_Integer_AsMpBitCnt(other);
     if (exp == (mp_bitcnt_t)(-1) && PyErr_Occurred())
         return NULL;
@@ -330,17 +394,30 @@ GMPy_XMPZ_IPow_Slot(PyObject *self, PyObject *other, PyObject *mod)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+static PyObject *
+GMPy_XMPZ_IPow_Slot(PyObject *self, PyObject *other, PyObject *mod)
+{
+    PyObject *result;
+
+    XMPZ_LOCK(self);
+    result = _GMPy_XMPZ_IPow_Slot(self, other, mod);
+    XMPZ_UNLOCK(self);
+    return result;
+}
+
 /* Inplace xmpz and.
  */
 
 static PyObject *
-GMPy_XMPZ_IAnd_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IAnd_Slot(PyObject *self, PyObject *other)
 {
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
 
     if (CHECK_MPZANY(other)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), MPZ(other)));
         mpz_and(MPZ(self), MPZ(self), MPZ(other));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
@@ -351,7 +428,7 @@ GMPy_XMPZ_IAnd_Slot(PyObject *self, PyObject *other)
         mpz_t tempz;
         mpz_init(tempz);
         mpz_set_PyLong(tempz, other);
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), tempz));
         mpz_and(MPZ(self), MPZ(self), tempz);
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         mpz_clear(tempz);
@@ -362,17 +439,21 @@ GMPy_XMPZ_IAnd_Slot(PyObject *self, PyObject *other)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_IAnd_Slot)
+
 /* Inplace xmpz xor.
  */
 
 static PyObject *
-GMPy_XMPZ_IXor_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IXor_Slot(PyObject *self, PyObject *other)
 {
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
 
     if(CHECK_MPZANY(other)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), MPZ(other)));
         mpz_xor(MPZ(self), MPZ(self), MPZ(other));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
@@ -383,7 +464,7 @@ GMPy_XMPZ_IXor_Slot(PyObject *self, PyObject *other)
         mpz_t tempz;
         mpz_init(tempz);
         mpz_set_PyLong(tempz, other);
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), tempz));
         mpz_xor(MPZ(self), MPZ(self), tempz);
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         mpz_clear(tempz);
@@ -394,17 +475,21 @@ GMPy_XMPZ_IXor_Slot(PyObject *self, PyObject *other)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_IXor_Slot)
+
 /* Inplace xmpz or.
  */
 
 static PyObject *
-GMPy_XMPZ_IIor_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IIor_Slot(PyObject *self, PyObject *other)
 {
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
 
     if(CHECK_MPZANY(other)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), MPZ(other)));
         mpz_ior(MPZ(self), MPZ(self), MPZ(other));
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
@@ -415,7 +500,7 @@ GMPy_XMPZ_IIor_Slot(PyObject *self, PyObject *other)
         mpz_t tempz;
         mpz_init(tempz);
         mpz_set_PyLong(tempz, other);
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), tempz));
         mpz_ior(MPZ(self), MPZ(self), tempz);
         GMPY_MAYBE_END_ALLOW_THREADS(context);
         mpz_clear(tempz);
@@ -426,3 +511,234 @@ GMPy_XMPZ_IIor_Slot(PyObject *self, PyObject *other)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_IIor_Slot)
+
+/* In-place methods for operations that have no operator. Each one stores
+ * its result in the xmpz and returns None.
+ */
+
+/* Convert the n arguments in args to new references in z. */
+
+static int
+_GMPy_XMPZ_Inplace_Args(PyObject *args, Py_ssize_t n, MPZ_Object **z,
+                        const char *name, CTXT_Object *context)
+{
+    Py_ssize_t i;
+
+    if (PyTuple_GET_SIZE(args) != n) {
+        PyErr_Format(PyExc_TypeError, "%s() requires %zd integer arguments", name, n);
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        if (!(z[i] = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, i), context))) {
+            while (i--)
+                Py_DECREF((PyObject*)z[i]);
+            PyErr_Clear();
+            PyErr_Format(PyExc_TypeError, "%s() requires integer arguments", name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_xmpz_method_addmul,
+"x.addmul(a, b, /) -> None\n\n"
+"Add a*b to x in place, without creating the product.");
+
+PyDoc_STRVAR(GMPy_doc_xmpz_method_submul,
+"x.submul(a, b, /) -> None\n\n"
+"Subtract a*b from x in place, without creating the product.");
+
+static PyObject *
+_GMPy_XMPZ_AddSubMul(PyObject *self, PyObject *args, int add)
+{
+    MPZ_Object *z[2];
+    CTXT_Object *context = NULL;
+
+    XMPZ_PREPARE_CHANGE(self, NULL);
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_XMPZ_Inplace_Args(args, 2, z, add ? "addmul" : "submul", context) < 0)
+        return NULL;
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(z[0]->z, z[1]->z));
+    if (add)
+        mpz_addmul(MPZ(self), z[0]->z, z[1]->z);
+    else
+        mpz_submul(MPZ(self), z[0]->z, z[1]->z);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    Py_DECREF((PyObject*)z[0]);
+    Py_DECREF((PyObject*)z[1]);
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+_GMPy_XMPZ_Method_AddMul(PyObject *self, PyObject *args)
+{
+    return _GMPy_XMPZ_AddSubMul(self, args, 1);
+}
+
+XMPZ_LOCKED(GMPy_XMPZ_Method_AddMul)
+
+static PyObject *
+_GMPy_XMPZ_Method_SubMul(PyObject *self, PyObject *args)
+{
+    return _GMPy_XMPZ_AddSubMul(self, args, 0);
+}
+
+XMPZ_LOCKED(GMPy_XMPZ_Method_SubMul)
+
+PyDoc_STRVAR(GMPy_doc_xmpz_method_powmod_inplace,
+"x.powmod_inplace(e, m, /) -> None\n\n"
+"Replace x with x**e mod m, like `powmod()`. A negative e requires\n"
+"x to be invertible mod m.");
+
+static PyObject *
+_GMPy_XMPZ_Method_PowModInplace(PyObject *self, PyObject *args)
+{
+    MPZ_Object *z[2];
+    mpz_t temp, exp;
+    int ok = 1;
+    CTXT_Object *context = NULL;
+
+    XMPZ_PREPARE_CHANGE(self, NULL);
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_XMPZ_Inplace_Args(args, 2, z, "powmod_inplace", context) < 0)
+        return NULL;
+
+    if (mpz_sgn(z[1]->z) == 0) {
+        Py_DECREF((PyObject*)z[0]);
+        Py_DECREF((PyObject*)z[1]);
+        VALUE_ERROR("powmod_inplace() 3rd argument cannot be 0");
+        return NULL;
+    }
+
+    /* x**-e is computed as (1/x)**e. x is left unchanged if it has no
+     * inverse.
+     */
+
+    mpz_init(temp);
+    /* |e| shares the limbs of e. */
+    mpz_roinit_n(exp, mpz_limbs_read(z[0]->z), mpz_size(z[0]->z));
+    if (mpz_sgn(z[0]->z) < 0) {
+        if ((ok = mpz_invert(temp, MPZ(self), z[1]->z)))
+            mpz_swap(MPZ(self), temp);
+    }
+    if (ok) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(z[1]->z));
+        mpz_powm(MPZ(self), MPZ(self), exp, z[1]->z);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+    }
+    mpz_clear(temp);
+    Py_DECREF((PyObject*)z[0]);
+    Py_DECREF((PyObject*)z[1]);
+    if (!ok) {
+        VALUE_ERROR("powmod_inplace() base not invertible");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+XMPZ_LOCKED(GMPy_XMPZ_Method_PowModInplace)
+
+PyDoc_STRVAR(GMPy_doc_xmpz_method_divexact_inplace,
+"x.divexact_inplace(d, /) -> None\n\n"
+"Replace x with x/d. d must divide x exactly; this is faster than\n"
+"x //= d, but the result is undefined if d does not divide x.");
+
+static PyObject *
+_GMPy_XMPZ_Method_DivExactInplace(PyObject *self, PyObject *args)
+{
+    MPZ_Object *d;
+    CTXT_Object *context = NULL;
+
+    XMPZ_PREPARE_CHANGE(self, NULL);
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_XMPZ_Inplace_Args(args, 1, &d, "divexact_inplace", context) < 0)
+        return NULL;
+
+    if (mpz_sgn(d->z) == 0) {
+        Py_DECREF((PyObject*)d);
+        ZERO_ERROR("divexact_inplace() division by 0");
+        return NULL;
+    }
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(MPZ(self)));
+    mpz_divexact(MPZ(self), MPZ(self), d->z);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    Py_DECREF((PyObject*)d);
+    Py_RETURN_NONE;
+}
+
+XMPZ_LOCKED(GMPy_XMPZ_Method_DivExactInplace)
+
+PyDoc_STRVAR(GMPy_doc_xmpz_method_gcd_inplace,
+"x.gcd_inplace(y, /) -> None\n\n"
+"Replace x with the greatest common divisor of x and y.");
+
+static PyObject *
+_GMPy_XMPZ_Method_GCDInplace(PyObject *self, PyObject *args)
+{
+    MPZ_Object *y;
+    CTXT_Object *context = NULL;
+
+    XMPZ_PREPARE_CHANGE(self, NULL);
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_XMPZ_Inplace_Args(args, 1, &y, "gcd_inplace", context) < 0)
+        return NULL;
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), y->z));
+    mpz_gcd(MPZ(self), MPZ(self), y->z);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    Py_DECREF((PyObject*)y);
+    Py_RETURN_NONE;
+}
+
+XMPZ_LOCKED(GMPy_XMPZ_Method_GCDInplace)
+
+PyDoc_STRVAR(GMPy_doc_xmpz_method_invert_inplace,
+"x.invert_inplace(m, /) -> None\n\n"
+"Replace x with its inverse mod m, like `invert()`. Raises\n"
+"`ZeroDivisionError` if no inverse exists; x is not changed then.");
+
+static PyObject *
+_GMPy_XMPZ_Method_InvertInplace(PyObject *self, PyObject *args)
+{
+    MPZ_Object *m;
+    mpz_t temp;
+    int ok;
+    CTXT_Object *context = NULL;
+
+    XMPZ_PREPARE_CHANGE(self, NULL);
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_XMPZ_Inplace_Args(args, 1, &m, "invert_inplace", context) < 0)
+        return NULL;
+
+    if (mpz_sgn(m->z) == 0) {
+        Py_DECREF((PyObject*)m);
+        ZERO_ERROR("invert_inplace() division by 0");
+        return NULL;
+    }
+
+    /* mpz_invert() leaves its result undefined when there is no inverse. */
+
+    mpz_init(temp);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(MPZ(self), m->z));
+    ok = mpz_invert(temp, MPZ(self), m->z);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    if (ok)
+        mpz_swap(MPZ(self), temp);
+    mpz_clear(temp);
+    Py_DECREF((PyObject*)m);
+    if (!ok) {
+        ZERO_ERROR("invert_inplace() no inverse exists");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+XMPZ_LOCKED(GMPy_XMPZ_Method_InvertInplace)
+
@@ -43,6 +43,13 @@ static PyObject * GMPy_XMPZ_IAnd_Slot(PyObject *self, PyObject *other);
 static PyObject * GMPy_XMPZ_IXor_Slot(PyObject *self, PyObject *other);
 static PyObject * GMPy_XMPZ_IIor_Slot(PyObject *self, PyObject *other);
 
+static PyObject * GMPy_XMPZ_Method_AddMul(PyObject *self, PyObject *args);
+static PyObject * GMPy_XMPZ_Method_SubMul(PyObject *self, PyObject *args);
+static PyObject * GMPy_XMPZ_Method_PowModInplace(PyObject *self, PyObject *args);
+static PyObject * GMPy_XMPZ_Method_DivExactInplace(PyObject *self, PyObject *args);
+static PyObject * GMPy_XMPZ_Method_GCDInplace(PyObject *self, PyObject *args);
+static PyObject * GMPy_XMPZ_Method_InvertInplace(PyObject *self, PyObject *args);
+
 #ifdef __cplusplus
 }
 #endif
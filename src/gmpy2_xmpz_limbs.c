@@ -48,9 +48,9 @@ PyDoc_STRVAR(GMPy_doc_xmpz_method_limbs_write,
 "the returned address in order for the changes to take effect.\n"
 "WARNING: this operation is destructive and may destroy the old\n"
 "value of x.");
-static PyObject* GMPy_XMPZ_Method_LimbsWrite(PyObject* obj, PyObject* other)
+static PyObject* _GMPy_XMPZ_Method_LimbsWrite(PyObject* obj, PyObject* other)
 {
-
+    XMPZ_PREPARE_CHANGE(obj, NULL);
     if (!PyLong_Check(other)) {
         TYPE_ERROR("number of limbs must be an int or a long");
         return NULL;
@@ -62,14 +62,17 @@ static PyObject* GMPy_XMPZ_Method_LimbsWrite(PyObject* obj, PyObject* other)
     }
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_Method_LimbsWrite)
+
 PyDoc_STRVAR(GMPy_doc_xmpz_method_limbs_modify,
 "x.limbs_modify(n, /) -> int\n\n"
 "Returns the address of a mutable buffer representing the limbs\n"
 "of x, resized so that it may hold at least n limbs.\n"
 "Must be followed by a call to x.limbs_finish(n) after writing to\n"
 "the returned address in order for the changes to take effect.");
-static PyObject* GMPy_XMPZ_Method_LimbsModify(PyObject* obj, PyObject* other)
+static PyObject* _GMPy_XMPZ_Method_LimbsModify(PyObject* obj, PyObject* other)
 {
+    XMPZ_PREPARE_CHANGE(obj, NULL);
     if (!PyLong_Check(other)) {
         TYPE_ERROR("number of limbs must be an int or a long");
         return NULL;
@@ -81,13 +84,16 @@ static PyObject* GMPy_XMPZ_Method_LimbsModify(PyObject* obj, PyObject* other)
     }
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_Method_LimbsModify)
+
 PyDoc_STRVAR(GMPy_doc_xmpz_method_limbs_finish,
 "x.limbs_finish(n, /) -> None\n\n"
 "Must be called after writing to the address returned by\n"
 "x.limbs_write(n) or x.limbs_modify(n) to update\n"
 "the limbs of x.");
-static PyObject* GMPy_XMPZ_Method_LimbsFinish(PyObject* obj, PyObject* other)
+static PyObject* _GMPy_XMPZ_Method_LimbsFinish(PyObject* obj, PyObject* other)
 {
+    XMPZ_PREPARE_CHANGE(obj, NULL);
     if (!PyLong_Check(other)) {
         TYPE_ERROR("number of limbs must be an int or long");
         return NULL;
@@ -98,3 +104,99 @@ static PyObject* GMPy_XMPZ_Method_LimbsFinish(PyObject* obj, PyObject* other)
         Py_RETURN_NONE;
     }
 }
+
+XMPZ_LOCKED(GMPy_XMPZ_Method_LimbsFinish)
+
+/* Buffer protocol. An mpz exports its limbs read-only. An xmpz exports
+ * them writable and counts the exports so that the limbs are not
+ * reallocated while a buffer refers to them. The buffer holds the
+ * absolute value, least significant limb first, in native byte order.
+ */
+
+#if GMP_LIMB_BITS == 64 && ULONG_MAX == 0xffffffffUL
+#define GMPY_LIMB_FORMAT "Q"
+#else
+#define GMPY_LIMB_FORMAT "L"
+#endif
+
+static void
+_GMPy_Limbs_Fill_Buffer(Py_buffer *view, PyObject *obj, mp_limb_t *limbs,
+                        size_t size, int readonly, int flags)
+{
+    view->obj = obj;
+    Py_INCREF(obj);
+    view->buf = (void*)limbs;
+    view->len = (Py_ssize_t)(size * sizeof(mp_limb_t));
+    view->readonly = readonly;
+    view->itemsize = sizeof(mp_limb_t);
+    view->format = (flags & PyBUF_FORMAT) ? GMPY_LIMB_FORMAT : NULL;
+    view->ndim = 1;
+    view->suboffsets = NULL;
+
+    /* The shape is the number of limbs. It is kept in view->internal since
+     * Py_buffer has no other room for it.
+     */
+
+    view->internal = (void*)(Py_ssize_t)size;
+    view->shape = (flags & PyBUF_ND) ? (Py_ssize_t*)&view->internal : NULL;
+    view->strides = (flags & PyBUF_STRIDES) ? &view->itemsize : NULL;
+}
+
+static int
+GMPy_MPZ_GetBuffer_Slot(MPZ_Object *self, Py_buffer *view, int flags)
+{
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "mpz limbs are read-only");
+        return -1;
+    }
+    _GMPy_Limbs_Fill_Buffer(view, (PyObject*)self, (mp_limb_t*)mpz_limbs_read(self->z),
+                            mpz_size(self->z), 1, flags);
+    return 0;
+}
+
+static int
+GMPy_XMPZ_GetBuffer_Slot(XMPZ_Object *self, Py_buffer *view, int flags)
+{
+    size_t size = mpz_size(self->z);
+
+    /* mpz_limbs_modify() does not reallocate when size limbs are already
+     * allocated; it is needed so the limbs can be written through view.
+     */
+
+    XMPZ_LOCK(self);
+    if (self->owner)
+        _GMPy_XMPZ_Detach(self);
+    _GMPy_Limbs_Fill_Buffer(view, (PyObject*)self,
+                            size ? mpz_limbs_modify(self->z, (mp_size_t)size)
+                                 : (mp_limb_t*)mpz_limbs_read(self->z),
+                            size, 0, flags);
+    self->exports++;
+    XMPZ_UNLOCK(self);
+    return 0;
+}
+
+static void
+GMPy_XMPZ_ReleaseBuffer_Slot(XMPZ_Object *self, Py_buffer *view)
+{
+    mp_size_t size = (mp_size_t)mpz_size(self->z);
+
+    /* Writes through a buffer may leave high limbs equal to 0, so the value
+     * is normalized when the last buffer is released.
+     */
+
+    XMPZ_LOCK(self);
+    if (--self->exports == 0 && size)
+        mpz_limbs_finish(self->z, mpz_sgn(self->z) < 0 ? -size : size);
+    XMPZ_UNLOCK(self);
+}
+
+static PyBufferProcs GMPy_MPZ_as_buffer = {
+    (getbufferproc)GMPy_MPZ_GetBuffer_Slot,
+    NULL
+};
+
+static PyBufferProcs GMPy_XMPZ_as_buffer = {
+    (getbufferproc)GMPy_XMPZ_GetBuffer_Slot,
+    (releasebufferproc)GMPy_XMPZ_ReleaseBuffer_Slot
+};
+
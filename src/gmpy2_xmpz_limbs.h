@@ -35,6 +35,10 @@ static PyObject* GMPy_XMPZ_Method_LimbsWrite(PyObject* obj, PyObject* other);
 static PyObject* GMPy_XMPZ_Method_LimbsModify(PyObject* obj, PyObject* other);
 static PyObject* GMPy_XMPZ_Method_LimbsFinish(PyObject* obj, PyObject* other);
 
+static int GMPy_MPZ_GetBuffer_Slot(MPZ_Object *self, Py_buffer *view, int flags);
+static int GMPy_XMPZ_GetBuffer_Slot(XMPZ_Object *self, Py_buffer *view, int flags);
+static void GMPy_XMPZ_ReleaseBuffer_Slot(XMPZ_Object *self, Py_buffer *view);
+
 #ifdef __cplusplus
 }
 #endif
@@ -62,6 +62,7 @@ GMPy_XMPZ_Function_XbitMask(PyObject *self, PyObject *other)
 static PyObject *
 GMPy_XMPZ_Abs_Slot(XMPZ_Object *x)
 {
+    XMPZ_PREPARE_CHANGE(x, NULL);
     mpz_abs(x->z, x->z);
     Py_RETURN_NONE;
 }
@@ -69,6 +70,7 @@ GMPy_XMPZ_Abs_Slot(XMPZ_Object *x)
 static PyObject *
 GMPy_XMPZ_Neg_Slot(XMPZ_Object *x)
 {
+    XMPZ_PREPARE_CHANGE(x, NULL);
     mpz_neg(x->z, x->z);
     Py_RETURN_NONE;
 }
@@ -90,23 +92,207 @@ GMPy_XMPZ_NonZero_Slot(XMPZ_Object *x)
 static PyObject *
 GMPy_XMPZ_Com_Slot(XMPZ_Object *x)
 {
+    XMPZ_PREPARE_CHANGE(x, NULL);
     mpz_com(x->z, x->z);
     Py_RETURN_NONE;
 }
 
+/* Copy on write. _GMPy_XMPZ_Freeze() returns an mpz with the value of self.
+ * A large value is not copied: the limbs are moved to the new mpz and self
+ * reads them through an alias until it is changed. The value cannot be
+ * shared while its limbs are exported.
+ */
+
+static void
+_GMPy_XMPZ_Share(XMPZ_Object *self, MPZ_Object *owner)
+{
+    mpz_clear(self->z);
+    mpz_roinit_n(self->z, mpz_limbs_read(owner->z), owner->z->_mp_size);
+    Py_INCREF((PyObject*)owner);
+    self->owner = owner;
+}
+
+static void
+_GMPy_XMPZ_Detach(XMPZ_Object *self)
+{
+    mpz_t temp;
+
+    /* An alias has no allocated limbs. If z was reallocated by a write that
+     * did not call XMPZ_PREPARE_CHANGE(), e.g. from the C-API, it already
+     * has a private copy.
+     */
+
+    if (self->z->_mp_alloc == 0) {
+        mpz_init2(temp, mpz_size(self->z) * GMP_NUMB_BITS);
+        mpz_set(temp, self->z);
+        self->z[0] = temp[0];
+    }
+    Py_CLEAR(self->owner);
+}
+
+static MPZ_Object *
+_GMPy_XMPZ_Freeze(XMPZ_Object *self, CTXT_Object *context)
+{
+    MPZ_Object *result;
+
+    XMPZ_LOCK(self);
+    if (self->owner) {
+        result = self->owner;
+        Py_INCREF((PyObject*)result);
+    }
+    else if (self->exports || mpz_size(self->z) < GMPY_XMPZ_SHARE_LIMBS) {
+        if ((result = GMPy_MPZ_NewSize(mpz_size(self->z), context)))
+            mpz_set(result->z, self->z);
+    }
+    else if ((result = GMPy_MPZ_New(context))) {
+        mpz_swap(result->z, self->z);
+        _GMPy_XMPZ_Share(self, result);
+    }
+    XMPZ_UNLOCK(self);
+    return result;
+}
+
+/* Support for the out keyword of the integer module functions, such as
+ * mul(x, y, out=r): the result is stored in the xmpz r, which is returned.
+ * The operands are read through the scratch pool (an xmpz operand is
+ * copied there), so they may include r itself, and a loop over mpz values
+ * does not allocate any object.
+ */
+
+static int
+_GMPy_XMPZ_Out_Check(PyObject *value, XMPZ_Object **out, const char *name)
+{
+    if (value == Py_None)
+        return 0;
+    if (!XMPZ_Check(value)) {
+        PyErr_Format(PyExc_TypeError, "%s() argument 'out' must be an xmpz", name);
+        return -1;
+    }
+    *out = (XMPZ_Object*)value;
+    return 0;
+}
+
+/* Set *out from the keyword arguments of a METH_FASTCALL | METH_KEYWORDS
+ * function, which may only contain out. *out is NULL if it is missing or
+ * None.
+ */
+
+static int
+GMPy_XMPZ_Out_Kwnames(PyObject *const *args, Py_ssize_t nargs,
+                      PyObject *kwnames, XMPZ_Object **out, const char *name)
+{
+    PyObject *key;
+
+    *out = NULL;
+    if (!kwnames || !PyTuple_GET_SIZE(kwnames))
+        return 0;
+    key = PyTuple_GET_ITEM(kwnames, 0);
+    if (PyTuple_GET_SIZE(kwnames) != 1 ||
+        PyUnicode_CompareWithASCIIString(key, "out")) {
+        PyErr_Format(PyExc_TypeError, "%s() only accepts the keyword argument out", name);
+        return -1;
+    }
+    return _GMPy_XMPZ_Out_Check(args[nargs], out, name);
+}
+
+/* Lock out and prepare it to be changed. Returns -1, with out unlocked,
+ * if its limbs are exported. Release it with GMPy_XMPZ_Out_End().
+ */
+
+static int
+_GMPy_XMPZ_Out_Prepare(XMPZ_Object *out)
+{
+    XMPZ_PREPARE_CHANGE(out, -1);
+    return 0;
+}
+
+static int
+GMPy_XMPZ_Out_Begin(XMPZ_Object *out)
+{
+    XMPZ_LOCK(out);
+    if (_GMPy_XMPZ_Out_Prepare(out) < 0) {
+        XMPZ_UNLOCK(out);
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject *
+GMPy_XMPZ_Out_End(XMPZ_Object *out)
+{
+    XMPZ_UNLOCK(out);
+    Py_INCREF((PyObject*)out);
+    return (PyObject*)out;
+}
+
+/* Store x op y in out, for op GMPY_OP_ADD, GMPY_OP_SUB, or GMPY_OP_MUL. */
+
+static PyObject *
+GMPy_XMPZ_Out_Binop(XMPZ_Object *out, PyObject *x, PyObject *y, int op,
+                    const char *name, CTXT_Object *context)
+{
+    mpz_srcptr a, b;
+    int mark = _GMPy_Scratch_Mark();
+
+    if (!(a = GMPy_MPZ_Scratch_From_Integer(x)) ||
+        !(b = GMPy_MPZ_Scratch_From_Integer(y))) {
+        _GMPy_Scratch_Release(mark);
+        PyErr_Format(PyExc_TypeError, "%s() with out requires integer arguments", name);
+        return NULL;
+    }
+    if (GMPy_XMPZ_Out_Begin(out) < 0) {
+        _GMPy_Scratch_Release(mark);
+        return NULL;
+    }
+
+    GMPY_PROFILE_MPZ2(context, op, a, b);
+    if (op == GMPY_OP_MUL && GMPY_MUL_THREADS(context, a, b)) {
+        GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS2(a, b));
+        _GMPy_MPZ_Mul_Threads(out->z, a, b,
+                              GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+        GMPY_END_ALLOW_THREADS_MIN(context);
+    }
+    else {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS2(a, b));
+        if (op == GMPY_OP_ADD)
+            mpz_add(out->z, a, b);
+        else if (op == GMPY_OP_SUB)
+            mpz_sub(out->z, a, b);
+        else
+            mpz_mul(out->z, a, b);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+    }
+    _GMPy_Scratch_Release(mark);
+    return GMPy_XMPZ_Out_End(out);
+}
+
 PyDoc_STRVAR(GMPy_doc_xmpz_method_make_mpz,
 "x.make_mpz() -> mpz\n\n"
 "Return an `mpz` by converting x as quickly as possible.\n\n"
-"NOTE: Optimized for speed so the original `xmpz` value is set to 0!");
+"NOTE: Optimized for speed so the original `xmpz` value is set to 0!\n"
+"mpz(x) does not copy a large value either, but keeps the value of x.");
 
 static PyObject *
-GMPy_XMPZ_Method_MakeMPZ(PyObject *self, PyObject *other)
+_GMPy_XMPZ_Method_MakeMPZ(PyObject *self, PyObject *other)
 {
     MPZ_Object* result;
+    XMPZ_Object *x = (XMPZ_Object*)self;
     CTXT_Object *context = NULL;
 
     CHECK_CONTEXT(context);
 
+    if (x->exports) {
+        PyErr_SetString(PyExc_BufferError,
+                        "xmpz cannot be modified while its limbs are exported");
+        return NULL;
+    }
+    if (x->owner) {
+        result = x->owner;
+        x->owner = NULL;
+        mpz_init(x->z);
+        return (PyObject*)result;
+    }
+
     if (!(result = GMPy_MPZ_New(context))) {
         return NULL;
     }
@@ -115,9 +301,12 @@ GMPy_XMPZ_Method_MakeMPZ(PyObject *self, PyObject *other)
     return (PyObject*)result;
 }
 
+XMPZ_LOCKED(GMPy_XMPZ_Method_MakeMPZ)
+
 PyDoc_STRVAR(GMPy_doc_xmpz_method_copy,
 "x.copy() -> xmpz\n\n"
-"Return a copy of a x.");
+"Return a copy of a x. A large value is shared with the copy until\n"
+"either of them is changed.");
 
 static PyObject *
 GMPy_XMPZ_Method_Copy(PyObject *self, PyObject *other)
@@ -160,7 +349,7 @@ GMPy_XMPZ_Method_SubScript(XMPZ_Object* self, PyObject* item)
         return PyLong_FromLong(mpz_tstbit(self->z, i));
     }
     else if (PySlice_Check(item)) {
-        Py_ssize_t start, stop, step, slicelength, cur, i;
+        Py_ssize_t start, stop, step, slicelength;
         MPZ_Object *result;
 
         if (PySlice_GetIndicesEx(item,
@@ -177,14 +366,7 @@ GMPy_XMPZ_Method_SubScript(XMPZ_Object* self, PyObject* item)
             return NULL;
         }
 
-        mpz_set_ui(result->z, 0);
-        if (slicelength > 0) {
-            for (cur = start, i = 0; i < slicelength; cur += step, i++) {
-                if (mpz_tstbit(self->z, cur)) {
-                    mpz_setbit(result->z, i);
-                }
-            }
-        }
+        _GMPy_MPZ_Slice_Bits(result->z, self->z, start, step, slicelength);
         return (PyObject*)result;
     }
     else {
@@ -194,10 +376,11 @@ GMPy_XMPZ_Method_SubScript(XMPZ_Object* self, PyObject* item)
 }
 
 static int
-GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* value)
+_GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* value)
 {
     CTXT_Object *context = NULL;
 
+    XMPZ_PREPARE_CHANGE(self, -1);
     CHECK_CONTEXT_M1(context);
 
     if (PyIndex_Check(item)) {
@@ -231,7 +414,7 @@ GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* va
         }
     }
     else if (PySlice_Check(item)) {
-        Py_ssize_t cur, i, seq_len, start, stop, step, slicelength, temp;
+        Py_ssize_t seq_len, start, stop, step, slicelength, temp;
 
         seq_len = mpz_sizeinbase(self->z, 2);
         if (((PySliceObject*)item)->stop != Py_None) {
@@ -264,34 +447,13 @@ GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* va
         }
 
         else {
-            int bit;
             MPZ_Object *tempx;
 
             if (!(tempx = GMPy_MPZ_From_Integer(value, context))) {
                 VALUE_ERROR("must specify bit sequence as an integer");
                 return -1;
             }
-            if (mpz_sgn(tempx->z) == 0) {
-                for (cur = start, i = 0; i < slicelength; cur += step, i++) {
-                    mpz_clrbit(self->z, cur);
-                }
-            }
-            else if (!(mpz_cmp_si(tempx->z, -1))) {
-                for (cur = start + (slicelength-1) * step, i = 0;
-                     i < slicelength;
-                     cur -= step, i++) {
-                    mpz_setbit(self->z, cur);
-                }
-            }
-            else {
-                for (cur = start, i = 0; i < slicelength; cur += step, i++) {
-                    bit = mpz_tstbit(tempx->z, i);
-                    if (bit)
-                        mpz_setbit(self->z, cur);
-                    else
-                        mpz_clrbit(self->z, cur);
-                }
-            }
+            _GMPy_MPZ_Set_Slice_Bits(self->z, start, step, slicelength, tempx->z);
             Py_DECREF((PyObject*)tempx);
         }
         return 0;
@@ -303,6 +465,17 @@ GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* va
     return -1;
 }
 
+static int
+GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* value)
+{
+    int result;
+
+    XMPZ_LOCK(self);
+    result = _GMPy_XMPZ_Method_AssignSubScript(self, item, value);
+    XMPZ_UNLOCK(self);
+    return result;
+}
+
 /* Implement a multi-purpose iterator object that iterates over the bits in
  * an xmpz. Three different iterators can be created:
  *   1) xmpz.iter_bits(start=0, stop=-1) will return True/False for each bit
@@ -499,6 +672,272 @@ GMPy_XMPZ_Method_IterClear(PyObject *self, PyObject *args, PyObject *kwargs)
     return (PyObject*)result;
 }
 
+/* Return the index of the lowest 1-bit of word, which must not be 0. */
+
+static inline mp_bitcnt_t
+_GMPy_Limb_Ctz(mp_limb_t word)
+{
+#if defined(__GNUC__) && GMP_LIMB_BITS == 64 && ULONG_MAX == 0xffffffffUL
+    return (mp_bitcnt_t)__builtin_ctzll(word);
+#elif defined(__GNUC__)
+    return (mp_bitcnt_t)__builtin_ctzl(word);
+#else
+    return mpn_scan1(&word, 0);
+#endif
+}
+
+/* Count, or store in out if it is not NULL, the positions of the 1-bits in
+ * bits start to stop-1 of the n limbs. The Python API is not used.
+ */
+
+static size_t
+_GMPy_Limbs_Set_Bits(const mp_limb_t *limbs, size_t n, mp_bitcnt_t start,
+                     mp_bitcnt_t stop, int64_t *out)
+{
+    size_t w, first, last, count = 0;
+    mp_limb_t word;
+
+    if (stop > (mp_bitcnt_t)n * GMP_NUMB_BITS)
+        stop = (mp_bitcnt_t)n * GMP_NUMB_BITS;
+    if (start >= stop)
+        return 0;
+
+    first = start / GMP_NUMB_BITS;
+    last = (stop - 1) / GMP_NUMB_BITS;
+    for (w = first; w <= last; w++) {
+        if (!out && w != first && w != last) {
+            /* Count all limbs between the first and the last at once. */
+            count += mpn_popcount(limbs + w, last - w);
+            w = last - 1;
+            continue;
+        }
+        word = limbs[w];
+        if (w == first)
+            word &= GMP_NUMB_MAX << (start % GMP_NUMB_BITS);
+        if (w == last && stop % GMP_NUMB_BITS)
+            word &= GMP_NUMB_MAX >> (GMP_NUMB_BITS - stop % GMP_NUMB_BITS);
+        if (!out) {
+            if (word)
+                count += mpn_popcount(&word, 1);
+            continue;
+        }
+        while (word) {
+            out[count++] = (int64_t)((mp_bitcnt_t)w * GMP_NUMB_BITS + _GMPy_Limb_Ctz(word));
+            word &= word - 1;
+        }
+    }
+    return count;
+}
+
+PyDoc_STRVAR(GMPy_doc_xmpz_method_set_bits_array,
+"x.set_bits_array(start=0, stop=-1, count=False) -> memoryview | int\n\n"
+"Return the positions of all bits that are set in x from 'start'\n"
+"up to, but not including, 'stop' as a memoryview of 64-bit integers.\n"
+"A negative 'stop' includes all bits up to the last 1-bit; it must be\n"
+"positive if x is negative. If 'count' is True, return the number of\n"
+"positions instead. This gives the same positions as `iter_set()`\n"
+"but is much faster for large bitmaps.");
+
+static PyObject *
+_GMPy_XMPZ_Set_Bits(PyObject *self, Py_ssize_t start, Py_ssize_t stop, int count_only)
+{
+    mpz_t temp;
+    mpz_ptr z = XMPZ(self);
+    size_t count;
+    PyObject *bytes, *view, *result;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (start < 0) {
+        VALUE_ERROR("start must be >= 0");
+        return NULL;
+    }
+
+    /* A negative value has infinitely many 1-bits in 2s-complement format,
+     * so the bits below 'stop' are copied into a nonnegative temporary.
+     */
+
+    mpz_init(temp);
+    if (mpz_sgn(z) < 0) {
+        if (stop < 0) {
+            mpz_clear(temp);
+            VALUE_ERROR("stop must be >= 0 for negative values");
+            return NULL;
+        }
+        mpz_fdiv_r_2exp(temp, z, (mp_bitcnt_t)stop);
+        z = temp;
+    }
+    if (stop < 0)
+        stop = (Py_ssize_t)(mpz_size(z) * GMP_NUMB_BITS);
+
+    /* The xmpz cannot change while the GIL is released. */
+
+    ((XMPZ_Object*)self)->exports++;
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, mpz_size(z) * GMP_NUMB_BITS);
+    count = _GMPy_Limbs_Set_Bits(mpz_limbs_read(z), mpz_size(z),
+                                 (mp_bitcnt_t)start, (mp_bitcnt_t)stop, NULL);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    if (count_only) {
+        ((XMPZ_Object*)self)->exports--;
+        mpz_clear(temp);
+        return PyLong_FromSize_t(count);
+    }
+
+    if (!(bytes = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)(count * sizeof(int64_t))))) {
+        ((XMPZ_Object*)self)->exports--;
+        mpz_clear(temp);
+        return NULL;
+    }
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, mpz_size(z) * GMP_NUMB_BITS);
+    _GMPy_Limbs_Set_Bits(mpz_limbs_read(z), mpz_size(z), (mp_bitcnt_t)start,
+                         (mp_bitcnt_t)stop, (int64_t*)PyBytes_AS_STRING(bytes));
+    GMPY_END_ALLOW_THREADS_MIN(context);
+    ((XMPZ_Object*)self)->exports--;
+    mpz_clear(temp);
+
+    view = PyMemoryView_FromObject(bytes);
+    Py_DECREF(bytes);
+    if (!view)
+        return NULL;
+    result = PyObject_CallMethod(view, "cast", "s", "q");
+    Py_DECREF(view);
+    return result;
+}
+
+static PyObject *
+GMPy_XMPZ_Method_SetBitsArray(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    Py_ssize_t start = 0, stop = -1;
+    int count_only = 0;
+    PyObject *result;
+
+    static char *kwlist[] = {"start", "stop", "count", NULL };
+
+    if (!(PyArg_ParseTupleAndKeywords(args, kwargs, "|nnp", kwlist, &start,
+                                      &stop, &count_only))) {
+        return NULL;
+    }
+    XMPZ_LOCK(self);
+    result = _GMPy_XMPZ_Set_Bits(self, start, stop, count_only);
+    XMPZ_UNLOCK(self);
+    return result;
+}
+
+/* Set or clear bits start, start+step, ... below stop of a nonnegative
+ * xmpz directly in its limbs.
+ */
+
+static PyObject *
+_GMPy_XMPZ_Stride(PyObject *self, PyObject *args, int set, const char *name)
+{
+    Py_ssize_t start, step, stop;
+    mp_bitcnt_t i, limit;
+    size_t size, n;
+    mp_limb_t *limbs;
+    mpz_ptr z = XMPZ(self);
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
+    if (!PyArg_ParseTuple(args, "nnn", &start, &step, &stop))
+        return NULL;
+    if (start < 0 || step <= 0 || stop < 0) {
+        PyErr_Format(PyExc_ValueError, "%s() requires start >= 0, step > 0, and stop >= 0", name);
+        return NULL;
+    }
+    if (mpz_sgn(z) < 0) {
+        PyErr_Format(PyExc_ValueError, "%s() requires x >= 0", name);
+        return NULL;
+    }
+
+    size = mpz_size(z);
+    limit = (mp_bitcnt_t)stop;
+    if (set) {
+        n = Py_MAX(size, (limit + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
+    }
+    else {
+        n = size;
+        limit = Py_MIN(limit, (mp_bitcnt_t)size * GMP_NUMB_BITS);
+    }
+    if (!n || (mp_bitcnt_t)start >= limit)
+        Py_RETURN_NONE;
+
+    limbs = mpz_limbs_modify(z, (mp_size_t)n);
+    if (n > size)
+        memset(limbs + size, 0, (n - size) * sizeof(mp_limb_t));
+
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, (limit - start) / step);
+    if (set) {
+        for (i = start; i < limit; i += step)
+            limbs[i / GMP_NUMB_BITS] |= (mp_limb_t)1 << (i % GMP_NUMB_BITS);
+    }
+    else {
+        for (i = start; i < limit; i += step)
+            limbs[i / GMP_NUMB_BITS] &= ~((mp_limb_t)1 << (i % GMP_NUMB_BITS));
+    }
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    mpz_limbs_finish(z, (mp_size_t)n);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_xmpz_method_set_stride,
+"x.set_stride(start, step, stop, /) -> None\n\n"
+"Set the bits start, start+step, start+2*step, ... that are less\n"
+"than stop. Equivalent to x[start:stop:step] = ~0 for x >= 0, but\n"
+"the bits are set directly without creating a slice value.");
+
+static PyObject *
+GMPy_XMPZ_Method_SetStride(PyObject *self, PyObject *args)
+{
+    PyObject *result;
+
+    XMPZ_LOCK(self);
+    result = _GMPy_XMPZ_Stride(self, args, 1, "set_stride");
+    XMPZ_UNLOCK(self);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_xmpz_method_clear_stride,
+"x.clear_stride(start, step, stop, /) -> None\n\n"
+"Clear the bits start, start+step, start+2*step, ... that are less\n"
+"than stop. Equivalent to x[start:stop:step] = 0 for x >= 0.");
+
+static PyObject *
+GMPy_XMPZ_Method_ClearStride(PyObject *self, PyObject *args)
+{
+    PyObject *result;
+
+    XMPZ_LOCK(self);
+    result = _GMPy_XMPZ_Stride(self, args, 0, "clear_stride");
+    XMPZ_UNLOCK(self);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_xmpz_method_popcount,
+"x.popcount(start=0, stop=-1, /) -> int\n\n"
+"Return the number of bits set in x from 'start' up to, but not\n"
+"including, 'stop'. A negative 'stop' counts up to the last 1-bit\n"
+"and requires x >= 0.");
+
+static PyObject *
+GMPy_XMPZ_Method_Popcount(PyObject *self, PyObject *args)
+{
+    Py_ssize_t start = 0, stop = -1;
+    PyObject *result;
+
+    if (!PyArg_ParseTuple(args, "|nn", &start, &stop))
+        return NULL;
+    XMPZ_LOCK(self);
+    result = _GMPy_XMPZ_Set_Bits(self, start, stop, 1);
+    XMPZ_UNLOCK(self);
+    return result;
+}
+
 static PyObject *
 GMPy_XMPZ_Attrib_GetNumer(XMPZ_Object *self, void *closure)
 {
@@ -547,6 +986,27 @@ GMPy_XMPZ_Method_SizeOf(PyObject *self, PyObject *other)
         (MPZ(self)->_mp_alloc * sizeof(mp_limb_t)));
 }
 
+PyDoc_STRVAR(GMPy_doc_xmpz_method_shrink,
+"x.shrink() -> None\n\n"
+"Reduce the storage of x to the size of its current value. An xmpz\n"
+"keeps its storage when its value becomes smaller, so an accumulator\n"
+"that once held a large value may hold many unused limbs.");
+
+static PyObject *
+_GMPy_XMPZ_Method_Shrink(PyObject *self, PyObject *other)
+{
+    mpz_ptr z = XMPZ(self);
+    mp_size_t size = Py_MAX((mp_size_t)mpz_size(z), 1);
+
+    XMPZ_PREPARE_CHANGE(self, NULL);
+
+    if (z->_mp_alloc > size)
+        mpz_realloc2(z, (mp_bitcnt_t)size * GMP_NUMB_BITS);
+    Py_RETURN_NONE;
+}
+
+XMPZ_LOCKED(GMPy_XMPZ_Method_Shrink)
+
 static PyTypeObject GMPy_Iter_Type =
 {
     PyVarObject_HEAD_INIT(0, 0)
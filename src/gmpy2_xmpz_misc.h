@@ -55,7 +55,12 @@ static PyObject *         GMPy_Iter_Repr(GMPy_Iter_Object *self);
 static PyObject *         GMPy_XMPZ_Method_IterBits(PyObject *self, PyObject *args, PyObject *kwargs);
 static PyObject *         GMPy_XMPZ_Method_IterSet(PyObject *self, PyObject *args, PyObject *kwargs);
 static PyObject *         GMPy_XMPZ_Method_IterClear(PyObject *self, PyObject *args, PyObject *kwargs);
+static PyObject *         GMPy_XMPZ_Method_SetBitsArray(PyObject *self, PyObject *args, PyObject *kwargs);
+static PyObject *         GMPy_XMPZ_Method_SetStride(PyObject *self, PyObject *args);
+static PyObject *         GMPy_XMPZ_Method_ClearStride(PyObject *self, PyObject *args);
+static PyObject *         GMPy_XMPZ_Method_Popcount(PyObject *self, PyObject *args);
 static PyObject *         GMPy_XMPZ_Method_SizeOf(PyObject *self, PyObject *other);
+static PyObject *         GMPy_XMPZ_Method_Shrink(PyObject *self, PyObject *other);
 
 
 #ifdef __cplusplus
@@ -1,643 +1,764 @@
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- * gmpy_mpz_lucas.c                                                        *
- * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- * Python interface to the GMP, MPFR, and MPC multiple precision           *
- * libraries.                                                              *
- *                                                                         *
- * Copyright 2011 David Cleaver                                            *
- *                                                                         *
- * Copyright 2012 - 2023 Case Van Horsen                                   *
- *                                                                         *
- * The original file is available at:                                      *
- *   <http://sourceforge.net/projects/mpzlucas/files/>                     *
- *                                                                         *
- * Modified by Case Van Horsen for inclusion into GMPY2.                   *
- *                                                                         *
- * This file is part of GMPY2.                                             *
- *                                                                         *
- * GMPY2 is free software: you can redistribute it and/or modify it under  *
- * the terms of the GNU Lesser General Public License as published by the  *
- * Free Software Foundation, either version 3 of the License, or (at your  *
- * option) any later version.                                              *
- *                                                                         *
- * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
- * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
- * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
- * License for more details.                                               *
- *                                                                         *
- * You should have received a copy of the GNU Lesser General Public        *
- * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
- * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
-
-PyDoc_STRVAR(doc_mpz_lucasu,
-"lucasu(p,q,k,/) -> mpz\n\n"
-"Return the k-th element of the Lucas U sequence defined by p,q.\n"
-"p*p - 4*q must not equal 0; k must be greater than or equal to 0.");
-
-static PyObject *
-GMPY_mpz_lucasu(PyObject *self, PyObject *args)
-{
-    /* Adaptation of algorithm found in http://joye.site88.net/papers/JQ96lucas.pdf
-     * calculate u[k] of Lucas U sequence for p,q.
-     * Note: p^2-4q=0 is not tested, not a proper Lucas sequence!!
-     */
-
-    MPZ_Object *result = NULL, *p = NULL, *q = NULL, *k = NULL;
-    size_t s = 0, j = 0;
-    mpz_t uh, vl, vh, ql, qh, tmp;
-
-    if (PyTuple_Size(args) != 3) {
-        TYPE_ERROR("lucasu() requires 3 integer arguments");
-        return NULL;
-    }
-
-    mpz_init(uh);
-    mpz_init(vl);
-    mpz_init(vh);
-    mpz_init(ql);
-    mpz_init(qh);
-    mpz_init(tmp);
-
-    p = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    q = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
-    k = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 2), NULL);
-    if (!p || !q || !k) {
-        TYPE_ERROR("lucasu() requires 3 integer arguments");
-        goto cleanup;
-    }
-
-    /* Check if p*p - 4*q == 0. */
-
-    mpz_mul(tmp, p->z, p->z);
-    mpz_mul_ui(qh, q->z, 4);
-    mpz_sub(tmp, tmp, qh);
-    if (mpz_sgn(tmp) == 0) {
-        VALUE_ERROR("invalid values for p,q in lucasu()");
-        goto cleanup;
-    }
-
-    /* Check if k < 0. */
-
-    if (mpz_sgn(k->z) < 0) {
-        VALUE_ERROR("invalid value for k in lucasu()");
-        goto cleanup;
-    }
-
-    mpz_set_si(uh, 1);
-    mpz_set_si(vl, 2);
-    mpz_set(vh, p->z);
-    mpz_set_si(ql, 1);
-    mpz_set_si(qh, 1);
-    mpz_set_si(tmp, 0);
-
-    s = mpz_scan1(k->z, 0);
-    for (j = mpz_sizeinbase(k->z,2)-1; j >= s+1; j--) {
-        /* ql = ql*qh */
-        mpz_mul(ql, ql, qh);
-        if (mpz_tstbit(k->z,j) == 1) {
-            /* qh = ql*q */
-            mpz_mul(qh, ql, q->z);
-
-            /* uh = uh*vh */
-            mpz_mul(uh, uh, vh);
-
-            /* vl = vh*vl - p*ql */
-            mpz_mul(vl, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vl, vl, tmp);
-
-            /* vh = vh*vh - 2*qh */
-            mpz_mul(vh, vh, vh);
-            mpz_mul_si(tmp, qh, 2);
-            mpz_sub(vh, vh, tmp);
-        }
-        else {
-            /* qh = ql */
-            mpz_set(qh, ql);
-
-            /* uh = uh*vl - ql */
-            mpz_mul(uh, uh, vl);
-            mpz_sub(uh, uh, ql);
-
-            /* vh = vh*vl - p*ql */
-            mpz_mul(vh, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vh, vh, tmp);
-
-            /* vl = vl*vl - 2*ql */
-            mpz_mul(vl, vl, vl);
-            mpz_mul_si(tmp, ql, 2);
-            mpz_sub(vl, vl, tmp);
-        }
-    }
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    /* qh = ql*q */
-    mpz_mul(qh, ql, q->z);
-
-    /* uh = uh*vl - ql */
-    mpz_mul(uh, uh, vl);
-    mpz_sub(uh, uh, ql);
-
-    /* vl = vh*vl - p*ql */
-    mpz_mul(vl, vh, vl);
-    mpz_mul(tmp, ql, p->z);
-    mpz_sub(vl, vl, tmp);
-
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    for (j = 1; j <= s; j++) {
-        /* uh = uh*vl */
-        mpz_mul(uh, uh, vl);
-
-        /* vl = vl*vl - 2*ql */
-        mpz_mul(vl, vl, vl);
-        mpz_mul_si(tmp, ql, 2);
-        mpz_sub(vl, vl, tmp);
-
-        /* ql = ql*ql */
-        mpz_mul(ql, ql, ql);
-    }
-
-    if (!(result = GMPy_MPZ_New(NULL)))
-        goto cleanup;
-
-    /* uh contains our return value */
-    mpz_set(result->z, uh);
-
-  cleanup:
-    mpz_clear(uh);
-    mpz_clear(vl);
-    mpz_clear(vh);
-    mpz_clear(ql);
-    mpz_clear(qh);
-    mpz_clear(tmp);
-    Py_XDECREF((PyObject*)p);
-    Py_XDECREF((PyObject*)q);
-    Py_XDECREF((PyObject*)k);
-
-    return (PyObject*)result;
-}
-
-PyDoc_STRVAR(doc_mpz_lucasu_mod,
-"lucasu_mod(p,q,k,n,/) -> mpz\n\n"
-"Return the k-th element of the Lucas U sequence defined by p,q (mod n).\n"
-"p*p - 4*q must not equal 0; k must be greater than or equal to 0;\n"
-"n must be greater than 0.");
-
-static PyObject *
-GMPY_mpz_lucasu_mod(PyObject *self, PyObject *args)
-{
-    /* Adaptation of algorithm found in http://joye.site88.net/papers/JQ96lucas.pdf
-     * calculate u[k] (modulo n) of Lucas U sequence for p,q.
-     * Note: p^2-4q=0 is not tested, not a proper Lucas sequence!!
-     */
-
-    MPZ_Object *result = NULL, *p = NULL, *q = NULL, *k = NULL, *n = NULL;
-
-    size_t s = 0, j = 0;
-    mpz_t uh, vl, vh, ql, qh, tmp;
-
-    if (PyTuple_Size(args) != 4) {
-        TYPE_ERROR("lucasu_mod() requires 4 integer arguments");
-        return NULL;
-    }
-
-    mpz_init(uh);
-    mpz_init(vl);
-    mpz_init(vh);
-    mpz_init(ql);
-    mpz_init(qh);
-    mpz_init(tmp);
-
-    p = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    q = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
-    k = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 2), NULL);
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 3), NULL);
-    if (!p || !q || !k || !n) {
-        TYPE_ERROR("lucasu_mod() requires 4 integer arguments");
-        goto cleanup;
-    }
-
-    /* Check if p*p - 4*q == 0. */
-
-    mpz_mul(tmp, p->z, p->z);
-    mpz_mul_ui(qh, q->z, 4);
-    mpz_sub(tmp, tmp, qh);
-    if (mpz_sgn(tmp) == 0) {
-        VALUE_ERROR("invalid values for p,q in lucasu_mod()");
-        goto cleanup;
-    }
-
-    /* Check if k < 0. */
-
-    if (mpz_sgn(k->z) < 0) {
-        VALUE_ERROR("invalid value for k in lucasu_mod()");
-        goto cleanup;
-    }
-
-    /* Check if n > 0. */
-
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("invalid value for n in lucasu_mod()");
-        goto cleanup;
-    }
-
-    mpz_set_si(uh, 1);
-    mpz_set_si(vl, 2);
-    mpz_set(vh, p->z);
-    mpz_set_si(ql, 1);
-    mpz_set_si(qh, 1);
-    mpz_set_si(tmp, 0);
-
-    s = mpz_scan1(k->z, 0);
-    for (j = mpz_sizeinbase(k->z,2)-1; j >= s+1; j--) {
-        /* ql = ql*qh (mod n) */
-        mpz_mul(ql, ql, qh);
-        mpz_mod(ql, ql, n->z);
-        if (mpz_tstbit(k->z,j) == 1) {
-            /* qh = ql*q */
-            mpz_mul(qh, ql, q->z);
-
-            /* uh = uh*vh (mod n) */
-            mpz_mul(uh, uh, vh);
-            mpz_mod(uh, uh, n->z);
-
-            /* vl = vh*vl - p*ql (mod n) */
-            mpz_mul(vl, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
-
-            /* vh = vh*vh - 2*qh (mod n) */
-            mpz_mul(vh, vh, vh);
-            mpz_mul_si(tmp, qh, 2);
-            mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
-        }
-        else {
-            /* qh = ql */
-            mpz_set(qh, ql);
-
-            /* uh = uh*vl - ql (mod n) */
-            mpz_mul(uh, uh, vl);
-            mpz_sub(uh, uh, ql);
-            mpz_mod(uh, uh, n->z);
-
-            /* vh = vh*vl - p*ql (mod n) */
-            mpz_mul(vh, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
-
-            /* vl = vl*vl - 2*ql (mod n) */
-            mpz_mul(vl, vl, vl);
-            mpz_mul_si(tmp, ql, 2);
-            mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
-        }
-    }
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    /* qh = ql*q */
-    mpz_mul(qh, ql, q->z);
-
-    /* uh = uh*vl - ql */
-    mpz_mul(uh, uh, vl);
-    mpz_sub(uh, uh, ql);
-
-    /* vl = vh*vl - p*ql */
-    mpz_mul(vl, vh, vl);
-    mpz_mul(tmp, ql, p->z);
-    mpz_sub(vl, vl, tmp);
-
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    for (j = 1; j <= s; j++) {
-        /* uh = uh*vl (mod n) */
-        mpz_mul(uh, uh, vl);
-        mpz_mod(uh, uh, n->z);
-
-        /* vl = vl*vl - 2*ql (mod n) */
-        mpz_mul(vl, vl, vl);
-        mpz_mul_si(tmp, ql, 2);
-        mpz_sub(vl, vl, tmp);
-        mpz_mod(vl, vl, n->z);
-
-        /* ql = ql*ql (mod n) */
-        mpz_mul(ql, ql, ql);
-        mpz_mod(ql, ql, n->z);
-    }
-
-    if (!(result = GMPy_MPZ_New(NULL)))
-        goto cleanup;
-
-    /* uh contains our return value */
-    mpz_mod(result->z, uh, n->z);
-
-  cleanup:
-    mpz_clear(uh);
-    mpz_clear(vl);
-    mpz_clear(vh);
-    mpz_clear(ql);
-    mpz_clear(qh);
-    mpz_clear(tmp);
-    Py_XDECREF((PyObject*)p);
-    Py_XDECREF((PyObject*)q);
-    Py_XDECREF((PyObject*)k);
-    Py_XDECREF((PyObject*)n);
-
-    return (PyObject*)result;
-}
-
-PyDoc_STRVAR(doc_mpz_lucasv,
-"lucasv(p,q,k,/) -> mpz\n\n"
-"Return the k-th element of the Lucas V sequence defined by p,q.\n"
-"p*p - 4*q must not equal 0; k must be greater than or equal to 0.");
-
-static PyObject *
-GMPY_mpz_lucasv(PyObject *self, PyObject *args)
-{
-    /* Adaptation of algorithm found in http://joye.site88.net/papers/JQ96lucas.pdf
-     * calculate v[k] of Lucas V sequence for p,q.
-     * Note: p^2-4q=0 is not tested, not a proper Lucas sequence!!
-     */
-
-    MPZ_Object *result = NULL, *p = NULL, *q = NULL, *k = NULL;
-    size_t s = 0, j = 0;
-    mpz_t vl, vh, ql, qh, tmp;
-
-    if (PyTuple_Size(args) != 3) {
-        TYPE_ERROR("lucasv() requires 3 integer arguments");
-        return NULL;
-    }
-
-    mpz_init(vl);
-    mpz_init(vh);
-    mpz_init(ql);
-    mpz_init(qh);
-    mpz_init(tmp);
-
-    p = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    q = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
-    k = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 2), NULL);
-    if (!p || !q || !k) {
-        TYPE_ERROR("lucasv() requires 3 integer arguments");
-        goto cleanup;
-    }
-
-    /* Check if p*p - 4*q == 0. */
-
-    mpz_mul(tmp, p->z, p->z);
-    mpz_mul_ui(qh, q->z, 4);
-    mpz_sub(tmp, tmp, qh);
-    if (mpz_sgn(tmp) == 0) {
-        VALUE_ERROR("invalid values for p,q in lucasv()");
-        goto cleanup;
-    }
-
-    /* Check if k < 0. */
-
-    if (mpz_sgn(k->z) < 0) {
-        VALUE_ERROR("invalid value for k in lucasv()");
-        goto cleanup;
-    }
-
-    mpz_set_si(vl, 2);
-    mpz_set(vh, p->z);
-    mpz_set_si(ql, 1);
-    mpz_set_si(qh, 1);
-    mpz_set_si(tmp,0);
-
-    s = mpz_scan1(k->z, 0);
-    for (j = mpz_sizeinbase(k->z,2)-1; j >= s+1; j--) {
-        /* ql = ql*qh */
-        mpz_mul(ql, ql, qh);
-        if (mpz_tstbit(k->z,j) == 1) {
-            /* qh = ql*q */
-            mpz_mul(qh, ql, q->z);
-
-            /* vl = vh*vl - p*ql */
-            mpz_mul(vl, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vl, vl, tmp);
-
-            /* vh = vh*vh - 2*qh */
-            mpz_mul(vh, vh, vh);
-            mpz_mul_si(tmp, qh, 2);
-            mpz_sub(vh, vh, tmp);
-        }
-        else {
-            /* qh = ql */
-            mpz_set(qh, ql);
-
-            /* vh = vh*vl - p*ql */
-            mpz_mul(vh, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vh, vh, tmp);
-
-            /* vl = vl*vl - 2*ql */
-            mpz_mul(vl, vl, vl);
-            mpz_mul_si(tmp, ql, 2);
-            mpz_sub(vl, vl, tmp);
-        }
-    }
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    /* qh = ql*q */
-    mpz_mul(qh, ql, q->z);
-
-    /* vl = vh*vl - p*ql */
-    mpz_mul(vl, vh, vl);
-    mpz_mul(tmp, ql, p->z);
-    mpz_sub(vl, vl, tmp);
-
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    for (j = 1; j <= s; j++) {
-        /* vl = vl*vl - 2*ql */
-        mpz_mul(vl, vl, vl);
-        mpz_mul_si(tmp, ql, 2);
-        mpz_sub(vl, vl, tmp);
-
-        /* ql = ql*ql */
-        mpz_mul(ql, ql, ql);
-    }
-
-    if (!(result = GMPy_MPZ_New(NULL)))
-        goto cleanup;
-
-    /* vl contains our return value */
-    mpz_set(result->z, vl);
-
-  cleanup:
-    mpz_clear(vl);
-    mpz_clear(vh);
-    mpz_clear(ql);
-    mpz_clear(qh);
-    mpz_clear(tmp);
-    Py_XDECREF((PyObject*)p);
-    Py_XDECREF((PyObject*)q);
-    Py_XDECREF((PyObject*)k);
-
-    return (PyObject*)result;
-}
-
-PyDoc_STRVAR(doc_mpz_lucasv_mod,
-"lucasv_mod(p,q,k,n,/) -> mpz\n\n"
-"Return the k-th element of the Lucas V sequence defined by p,q (mod n).\n"
-"p*p - 4*q must not equal 0; k must be greater than or equal to 0;\n"
-"n must be greater than 0.");
-
-static PyObject *
-GMPY_mpz_lucasv_mod(PyObject *self, PyObject *args)
-{
-    /* Adaptation of algorithm found in http://joye.site88.net/papers/JQ96lucas.pdf
-     * calculate v[k] (modulo n) of Lucas V sequence for p,q.
-     * Note: p^2-4q=0 is not tested, not a proper Lucas sequence!!
-     */
-
-    MPZ_Object *result = NULL, *p = NULL, *q = NULL, *k = NULL, *n = NULL;
-
-    size_t s = 0, j = 0;
-    mpz_t vl, vh, ql, qh, tmp;
-
-    if (PyTuple_Size(args) != 4) {
-        TYPE_ERROR("lucasv_mod() requires 4 integer arguments");
-        return NULL;
-    }
-
-    mpz_init(vl);
-    mpz_init(vh);
-    mpz_init(ql);
-    mpz_init(qh);
-    mpz_init(tmp);
-
-    p = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    q = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
-    k = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 2), NULL);
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 3), NULL);
-    if (!p || !q || !k || !n) {
-        TYPE_ERROR("lucasv_mod() requires 4 integer arguments");
-        goto cleanup;
-    }
-
-    /* Check if p*p - 4*q == 0. */
-
-    mpz_mul(tmp, p->z, p->z);
-    mpz_mul_ui(qh, q->z, 4);
-    mpz_sub(tmp, tmp, qh);
-    if (mpz_sgn(tmp) == 0) {
-        VALUE_ERROR("invalid values for p,q in lucasv_mod()");
-        goto cleanup;
-    }
-
-    /* Check if k < 0. */
-
-    if (mpz_sgn(k->z) < 0) {
-        VALUE_ERROR("invalid value for k in lucasv_mod()");
-        goto cleanup;
-    }
-
-    /* Check if n > 0. */
-
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("invalid value for n in lucasv_mod()");
-        goto cleanup;
-    }
-
-    mpz_set_si(vl, 2);
-    mpz_set(vh, p->z);
-    mpz_set_si(ql, 1);
-    mpz_set_si(qh, 1);
-    mpz_set_si(tmp,0);
-
-    s = mpz_scan1(k->z, 0);
-    for (j = mpz_sizeinbase(k->z,2)-1; j >= s+1; j--) {
-        /* ql = ql*qh (mod n) */
-        mpz_mul(ql, ql, qh);
-        mpz_mod(ql, ql, n->z);
-        if (mpz_tstbit(k->z,j) == 1) {
-            /* qh = ql*q */
-            mpz_mul(qh, ql, q->z);
-
-            /* vl = vh*vl - p*ql (mod n) */
-            mpz_mul(vl, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
-
-            /* vh = vh*vh - 2*qh (mod n) */
-            mpz_mul(vh, vh, vh);
-            mpz_mul_si(tmp, qh, 2);
-            mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
-        }
-        else {
-            /* qh = ql */
-            mpz_set(qh, ql);
-
-            /* vh = vh*vl - p*ql (mod n) */
-            mpz_mul(vh, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
-
-            /* vl = vl*vl - 2*ql (mod n) */
-            mpz_mul(vl, vl, vl);
-            mpz_mul_si(tmp, ql, 2);
-            mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
-        }
-    }
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    /* qh = ql*q */
-    mpz_mul(qh, ql, q->z);
-
-    /* vl = vh*vl - p*ql */
-    mpz_mul(vl, vh, vl);
-    mpz_mul(tmp, ql, p->z);
-    mpz_sub(vl, vl, tmp);
-
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    for (j = 1; j <= s; j++) {
-        /* vl = vl*vl - 2*ql (mod n) */
-        mpz_mul(vl, vl, vl);
-        mpz_mul_si(tmp, ql, 2);
-        mpz_sub(vl, vl, tmp);
-        mpz_mod(vl, vl, n->z);
-
-        /* ql = ql*ql (mod n) */
-        mpz_mul(ql, ql, ql);
-        mpz_mod(ql, ql, n->z);
-    }
-
-    if (!(result = GMPy_MPZ_New(NULL)))
-        goto cleanup;
-
-    /* vl contains our return value */
-    mpz_mod(result->z, vl, n->z);
-
-  cleanup:
-    mpz_clear(vl);
-    mpz_clear(vh);
-    mpz_clear(ql);
-    mpz_clear(qh);
-    mpz_clear(tmp);
-    Py_XDECREF((PyObject*)p);
-    Py_XDECREF((PyObject*)q);
-    Py_XDECREF((PyObject*)k);
-    Py_XDECREF((PyObject*)n);
-
-    return (PyObject*)result;
-}
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy_mpz_lucas.c                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2011 David Cleaver                                            *
+ *                                                                         *
+ * Copyright 2012 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * The original file is available at:                                      *
+ *   <http://sourceforge.net/projects/mpzlucas/files/>                     *
+ *                                                                         *
+ * Modified by Case Van Horsen for inclusion into GMPY2.                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/* Convert the count arguments in args to mpz. On failure (including the
+ * wrong number of arguments) a TypeError naming the function name is set
+ * and -1 is returned. Also used by the probable prime tests.
+ */
+
+static int
+_GMPy_MPZ_Args(PyObject *args, int count, MPZ_Object **out, const char *name)
+{
+    int i;
+
+    if (PyTuple_Size(args) != count)
+        goto err;
+
+    for (i = 0; i < count; i++) {
+        if (!(out[i] = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, i), NULL))) {
+            while (i--)
+                Py_DECREF((PyObject*)out[i]);
+            goto err;
+        }
+    }
+    GMPy_Scratch_Attach();
+    return 0;
+
+  err:
+    PyErr_Format(PyExc_TypeError, "%s() requires %d integer argument%s",
+                 name, count, count == 1 ? "" : "s");
+    return -1;
+}
+
+static void
+_GMPy_MPZ_Args_Clear(MPZ_Object **args, int count)
+{
+    while (count--)
+        Py_DECREF((PyObject*)args[count]);
+}
+
+/* Set D = p*p - 4*q. */
+
+static void
+_GMPy_MPZ_Lucas_D(mpz_ptr D, mpz_srcptr p, mpz_srcptr q)
+{
+    mpz_mul(D, p, p);
+    mpz_submul_ui(D, q, 4);
+}
+
+/* Montgomery form of the ladder in _GMPy_MPZ_Lucas_UV() below. Sets u to
+ * U_k, v to V_k, and qk to q^k, where p and q are residues. Requires k > 0;
+ * u may be NULL. w must have room for 6*n limbs. Does not use the Python
+ * API.
+ */
+
+static void
+_GMPy_Mont_Lucas(const gmpy_mont *mont, mp_ptr u, mp_ptr v, mp_ptr qk,
+                 mp_srcptr p, mp_srcptr q, mpz_srcptr k, mp_ptr w)
+{
+    mp_size_t i, sz = mont->n;
+    mp_ptr uh = u, vl = v, ql = qk;
+    mp_ptr vh = w, qh = w + sz, tmp = w + 2 * sz, t = w + 3 * sz;
+    mp_bitcnt_t s, j;
+
+    _GMPy_Mont_One(mont, ql, t);
+    for (i = 0; i < sz; i++) {
+        qh[i] = ql[i];
+        vh[i] = p[i];
+        if (uh)
+            uh[i] = ql[i];
+    }
+    _GMPy_Mont_Add(mont, vl, ql, ql);
+
+    s = mpz_scan1(k, 0);
+    for (j = mpz_sizeinbase(k,2)-1; j >= s+1; j--) {
+        /* ql = ql*qh */
+        _GMPy_Mont_Mul(mont, ql, ql, qh, t);
+        if (mpz_tstbit(k,j) == 1) {
+            /* qh = ql*q */
+            _GMPy_Mont_Mul(mont, qh, ql, q, t);
+
+            /* uh = uh*vh */
+            if (uh)
+                _GMPy_Mont_Mul(mont, uh, uh, vh, t);
+
+            /* vl = vh*vl - p*ql */
+            _GMPy_Mont_Mul(mont, vl, vh, vl, t);
+            _GMPy_Mont_Mul(mont, tmp, ql, p, t);
+            _GMPy_Mont_Sub(mont, vl, vl, tmp);
+
+            /* vh = vh*vh - 2*qh */
+            _GMPy_Mont_Mul(mont, vh, vh, vh, t);
+            _GMPy_Mont_Add(mont, tmp, qh, qh);
+            _GMPy_Mont_Sub(mont, vh, vh, tmp);
+        }
+        else {
+            /* qh = ql */
+            for (i = 0; i < sz; i++)
+                qh[i] = ql[i];
+
+            /* uh = uh*vl - ql */
+            if (uh) {
+                _GMPy_Mont_Mul(mont, uh, uh, vl, t);
+                _GMPy_Mont_Sub(mont, uh, uh, ql);
+            }
+
+            /* vh = vh*vl - p*ql */
+            _GMPy_Mont_Mul(mont, vh, vh, vl, t);
+            _GMPy_Mont_Mul(mont, tmp, ql, p, t);
+            _GMPy_Mont_Sub(mont, vh, vh, tmp);
+
+            /* vl = vl*vl - 2*ql */
+            _GMPy_Mont_Mul(mont, vl, vl, vl, t);
+            _GMPy_Mont_Add(mont, tmp, ql, ql);
+            _GMPy_Mont_Sub(mont, vl, vl, tmp);
+        }
+    }
+    /* ql = ql*qh */
+    _GMPy_Mont_Mul(mont, ql, ql, qh, t);
+
+    /* qh = ql*q */
+    _GMPy_Mont_Mul(mont, qh, ql, q, t);
+
+    /* uh = uh*vl - ql */
+    if (uh) {
+        _GMPy_Mont_Mul(mont, uh, uh, vl, t);
+        _GMPy_Mont_Sub(mont, uh, uh, ql);
+    }
+
+    /* vl = vh*vl - p*ql */
+    _GMPy_Mont_Mul(mont, vl, vh, vl, t);
+    _GMPy_Mont_Mul(mont, tmp, ql, p, t);
+    _GMPy_Mont_Sub(mont, vl, vl, tmp);
+
+    /* ql = ql*qh */
+    _GMPy_Mont_Mul(mont, ql, ql, qh, t);
+
+    for (j = 1; j <= s; j++) {
+        /* uh = uh*vl */
+        if (uh)
+            _GMPy_Mont_Mul(mont, uh, uh, vl, t);
+
+        /* vl = vl*vl - 2*ql */
+        _GMPy_Mont_Mul(mont, vl, vl, vl, t);
+        _GMPy_Mont_Add(mont, tmp, ql, ql);
+        _GMPy_Mont_Sub(mont, vl, vl, tmp);
+
+        /* ql = ql*ql */
+        _GMPy_Mont_Mul(mont, ql, ql, ql, t);
+    }
+}
+
+/* Set u to U_k(p,q) and v to V_k(p,q) modulo a modulus already set up in
+ * mont. Either u or v may be NULL. Requires k >= 0. Does not use the
+ * Python API.
+ */
+
+static void
+_GMPy_MPZ_Lucas_UV_Mont(mpz_ptr u, mpz_ptr v, mpz_srcptr p, mpz_srcptr q,
+                        mpz_srcptr k, const gmpy_mont *mont)
+{
+    int mark;
+    mp_size_t sz = mont->n;
+    mp_ptr mp, mq, mu, mv, mqk, w;
+
+    if (mpz_sgn(k) == 0) {
+        if (u)
+            mpz_set_ui(u, 0);
+        if (v)
+            mpz_set_ui(v, 2);
+        /* m > 2, so 0 and 2 are reduced. */
+        return;
+    }
+
+    mark = _GMPy_Scratch_Mark();
+    mp = mpz_limbs_write(_GMPy_Scratch_Get(11 * sz * GMP_NUMB_BITS), 11 * sz);
+    mq = mp + sz;
+    mu = mp + 2 * sz;
+    mv = mp + 3 * sz;
+    mqk = mp + 4 * sz;
+    w = mp + 5 * sz;
+
+    _GMPy_Mont_To(mont, mp, p, w);
+    _GMPy_Mont_To(mont, mq, q, w);
+    _GMPy_Mont_Lucas(mont, u ? mu : NULL, mv, mqk, mp, mq, k, w);
+    if (u)
+        _GMPy_Mont_From(mont, u, mu, w);
+    if (v)
+        _GMPy_Mont_From(mont, v, mv, w);
+    _GMPy_Scratch_Release(mark);
+}
+
+/* Set u to U_k(p,q) and v to V_k(p,q), reduced mod n unless n is NULL.
+ * Either u or v may be NULL. Requires k >= 0. The temporaries are taken
+ * from the scratch pool. Beyond Montgomery size the loops stop early, with
+ * meaningless u and v, once GMPy_Interrupt_Poll() returns 1. Does not use
+ * the Python API.
+ *
+ * Adaptation of algorithm found in http://joye.site88.net/papers/JQ96lucas.pdf
+ * Note: p^2-4q=0 is not tested, not a proper Lucas sequence!!
+ */
+
+#define LUCAS_MOD(x) if (n) mpz_mod(x, x, n)
+
+static void
+_GMPy_MPZ_Lucas_UV(mpz_ptr u, mpz_ptr v, mpz_srcptr p, mpz_srcptr q,
+                   mpz_srcptr k, mpz_srcptr n)
+{
+    int mark = _GMPy_Scratch_Mark();
+    size_t bits = n ? GMPY_SCRATCH_MOD_BITS(n) : 0;
+    mpz_ptr uh, vl, vh, ql, qh, tmp;
+    mp_bitcnt_t s, j;
+
+    if (mpz_sgn(k) == 0) {
+        if (u)
+            mpz_set_ui(u, 0);
+        if (v) {
+            mpz_set_ui(v, 2);
+            LUCAS_MOD(v);
+        }
+        return;
+    }
+
+    if (n && GMPY_MONT_OK(n)) {
+        gmpy_mont mont;
+
+        _GMPy_Mont_Init(&mont, n, _GMPy_Scratch_Get(0));
+        _GMPy_MPZ_Lucas_UV_Mont(u, v, p, q, k, &mont);
+        _GMPy_Scratch_Release(mark);
+        return;
+    }
+
+    uh = _GMPy_Scratch_Get(bits);
+    vl = _GMPy_Scratch_Get(bits);
+    vh = _GMPy_Scratch_Get(bits);
+    ql = _GMPy_Scratch_Get(bits);
+    qh = _GMPy_Scratch_Get(bits);
+    tmp = _GMPy_Scratch_Get(bits);
+
+    mpz_set_si(uh, 1);
+    mpz_set_si(vl, 2);
+    mpz_set(vh, p);
+    mpz_set_si(ql, 1);
+    mpz_set_si(qh, 1);
+
+    s = mpz_scan1(k, 0);
+    for (j = mpz_sizeinbase(k,2)-1; j >= s+1 && !GMPy_Interrupt_Poll(); j--) {
+        /* ql = ql*qh (mod n) */
+        mpz_mul(ql, ql, qh);
+        LUCAS_MOD(ql);
+        if (mpz_tstbit(k,j) == 1) {
+            /* qh = ql*q */
+            mpz_mul(qh, ql, q);
+
+            /* uh = uh*vh (mod n) */
+            if (u) {
+                mpz_mul(uh, uh, vh);
+                LUCAS_MOD(uh);
+            }
+
+            /* vl = vh*vl - p*ql (mod n) */
+            mpz_mul(vl, vh, vl);
+            mpz_mul(tmp, ql, p);
+            mpz_sub(vl, vl, tmp);
+            LUCAS_MOD(vl);
+
+            /* vh = vh*vh - 2*qh (mod n) */
+            mpz_mul(vh, vh, vh);
+            mpz_mul_si(tmp, qh, 2);
+            mpz_sub(vh, vh, tmp);
+            LUCAS_MOD(vh);
+        }
+        else {
+            /* qh = ql */
+            mpz_set(qh, ql);
+
+            /* uh = uh*vl - ql (mod n) */
+            if (u) {
+                mpz_mul(uh, uh, vl);
+                mpz_sub(uh, uh, ql);
+                LUCAS_MOD(uh);
+            }
+
+            /* vh = vh*vl - p*ql (mod n) */
+            mpz_mul(vh, vh, vl);
+            mpz_mul(tmp, ql, p);
+            mpz_sub(vh, vh, tmp);
+            LUCAS_MOD(vh);
+
+            /* vl = vl*vl - 2*ql (mod n) */
+            mpz_mul(vl, vl, vl);
+            mpz_mul_si(tmp, ql, 2);
+            mpz_sub(vl, vl, tmp);
+            LUCAS_MOD(vl);
+        }
+    }
+    /* ql = ql*qh */
+    mpz_mul(ql, ql, qh);
+
+    /* qh = ql*q */
+    mpz_mul(qh, ql, q);
+
+    /* uh = uh*vl - ql */
+    if (u) {
+        mpz_mul(uh, uh, vl);
+        mpz_sub(uh, uh, ql);
+    }
+
+    /* vl = vh*vl - p*ql */
+    mpz_mul(vl, vh, vl);
+    mpz_mul(tmp, ql, p);
+    mpz_sub(vl, vl, tmp);
+
+    /* ql = ql*qh */
+    mpz_mul(ql, ql, qh);
+
+    for (j = 1; j <= s && !GMPy_Interrupt_Poll(); j++) {
+        /* uh = uh*vl (mod n) */
+        if (u) {
+            mpz_mul(uh, uh, vl);
+            LUCAS_MOD(uh);
+        }
+
+        /* vl = vl*vl - 2*ql (mod n) */
+        mpz_mul(vl, vl, vl);
+        mpz_mul_si(tmp, ql, 2);
+        mpz_sub(vl, vl, tmp);
+        LUCAS_MOD(vl);
+
+        /* ql = ql*ql (mod n) */
+        mpz_mul(ql, ql, ql);
+        LUCAS_MOD(ql);
+    }
+
+    if (u) {
+        mpz_set(u, uh);
+        LUCAS_MOD(u);
+    }
+    if (v) {
+        mpz_set(v, vl);
+        LUCAS_MOD(v);
+    }
+    _GMPy_Scratch_Release(mark);
+}
+
+#undef LUCAS_MOD
+
+/* Common code for lucasu(), lucasu_mod(), lucasv(), and lucasv_mod(). */
+
+static PyObject *
+_GMPy_MPZ_Lucas_Function(PyObject *args, int want_u, int modular, const char *name)
+{
+    MPZ_Object *result = NULL, *a[4];
+    mpz_ptr D;
+    int mark;
+
+    if (_GMPy_MPZ_Args(args, modular ? 4 : 3, a, name) < 0)
+        return NULL;
+
+    /* Check if p*p - 4*q == 0. */
+
+    mark = _GMPy_Scratch_Mark();
+    D = _GMPy_Scratch_Get(0);
+    _GMPy_MPZ_Lucas_D(D, a[0]->z, a[1]->z);
+    if (mpz_sgn(D) == 0) {
+        PyErr_Format(PyExc_ValueError, "invalid values for p,q in %s()", name);
+        goto cleanup;
+    }
+
+    /* Check if k < 0. */
+
+    if (mpz_sgn(a[2]->z) < 0) {
+        PyErr_Format(PyExc_ValueError, "invalid value for k in %s()", name);
+        goto cleanup;
+    }
+
+    /* Check if n > 0. */
+
+    if (modular && mpz_sgn(a[3]->z) <= 0) {
+        PyErr_Format(PyExc_ValueError, "invalid value for n in %s()", name);
+        goto cleanup;
+    }
+
+    if (!(result = GMPy_MPZ_New(NULL)))
+        goto cleanup;
+
+    _GMPy_MPZ_Lucas_UV(want_u ? result->z : NULL, want_u ? NULL : result->z,
+                       a[0]->z, a[1]->z, a[2]->z, modular ? a[3]->z : NULL);
+
+  cleanup:
+    _GMPy_Scratch_Release(mark);
+    _GMPy_MPZ_Args_Clear(a, modular ? 4 : 3);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(doc_mpz_lucasu,
+"lucasu(p,q,k,/) -> mpz\n\n"
+"Return the k-th element of the Lucas U sequence defined by p,q.\n"
+"p*p - 4*q must not equal 0; k must be greater than or equal to 0.");
+
+static PyObject *
+GMPY_mpz_lucasu(PyObject *self, PyObject *args)
+{
+    return _GMPy_MPZ_Lucas_Function(args, 1, 0, "lucasu");
+}
+
+PyDoc_STRVAR(doc_mpz_lucasu_mod,
+"lucasu_mod(p,q,k,n,/) -> mpz\n\n"
+"Return the k-th element of the Lucas U sequence defined by p,q (mod n).\n"
+"p*p - 4*q must not equal 0; k must be greater than or equal to 0;\n"
+"n must be greater than 0.");
+
+static PyObject *
+GMPY_mpz_lucasu_mod(PyObject *self, PyObject *args)
+{
+    return _GMPy_MPZ_Lucas_Function(args, 1, 1, "lucasu_mod");
+}
+
+PyDoc_STRVAR(doc_mpz_lucasv,
+"lucasv(p,q,k,/) -> mpz\n\n"
+"Return the k-th element of the Lucas V sequence defined by p,q.\n"
+"p*p - 4*q must not equal 0; k must be greater than or equal to 0.");
+
+static PyObject *
+GMPY_mpz_lucasv(PyObject *self, PyObject *args)
+{
+    return _GMPy_MPZ_Lucas_Function(args, 0, 0, "lucasv");
+}
+
+PyDoc_STRVAR(doc_mpz_lucasv_mod,
+"lucasv_mod(p,q,k,n,/) -> mpz\n\n"
+"Return the k-th element of the Lucas V sequence defined by p,q (mod n).\n"
+"p*p - 4*q must not equal 0; k must be greater than or equal to 0;\n"
+"n must be greater than 0.");
+
+static PyObject *
+GMPY_mpz_lucasv_mod(PyObject *self, PyObject *args)
+{
+    return _GMPy_MPZ_Lucas_Function(args, 0, 1, "lucasv_mod");
+}
+
+/* Common code for fib_mod(), fib2_mod(), and lucas_mod(). The Fibonacci
+ * and Lucas numbers are the Lucas sequences U and V with p = 1 and q = -1,
+ * so a single ladder modulo m gives F(n) and L(n), and F(n-1) follows from
+ * 2*F(n-1) = L(n) - F(n). For an even m the ladder runs modulo 2*m so the
+ * division by 2 is exact.
+ */
+
+#define GMPY_FIB_MOD 0
+#define GMPY_FIB2_MOD 1
+#define GMPY_LUCAS_MOD 2
+
+static PyObject *
+_GMPy_MPZ_Fib_Mod_Function(PyObject *args, int which, const char *name)
+{
+    PyObject *result = NULL;
+    MPZ_Object *a[2], *f = NULL, *g = NULL;
+    mpz_ptr p, q, mod;
+    int mark;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_MPZ_Args(args, 2, a, name) < 0)
+        return NULL;
+
+    if (mpz_sgn(a[0]->z) < 0) {
+        PyErr_Format(PyExc_ValueError, "invalid value for n in %s()", name);
+        goto cleanup;
+    }
+    if (mpz_sgn(a[1]->z) <= 0) {
+        PyErr_Format(PyExc_ValueError, "invalid value for m in %s()", name);
+        goto cleanup;
+    }
+
+    if (!(f = GMPy_MPZ_New(NULL)) ||
+        (which == GMPY_FIB2_MOD && !(g = GMPy_MPZ_New(NULL)))) {
+        goto cleanup;
+    }
+
+    mark = _GMPy_Scratch_Mark();
+    p = _GMPy_Scratch_Get(0);
+    q = _GMPy_Scratch_Get(0);
+    mpz_set_ui(p, 1);
+    mpz_set_si(q, -1);
+
+    GMPY_PROFILE_OP(context, GMPY_OP_POWMOD, mpz_sizeinbase(a[1]->z, 2));
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context,
+                                   GMPY_MPZ_BITS(a[1]->z) * mpz_sizeinbase(a[0]->z, 2));
+    if (which == GMPY_FIB_MOD) {
+        _GMPy_MPZ_Lucas_UV(f->z, NULL, p, q, a[0]->z, a[1]->z);
+    }
+    else if (which == GMPY_LUCAS_MOD) {
+        _GMPy_MPZ_Lucas_UV(NULL, f->z, p, q, a[0]->z, a[1]->z);
+    }
+    else if (mpz_odd_p(a[1]->z)) {
+        _GMPy_MPZ_Lucas_UV(f->z, g->z, p, q, a[0]->z, a[1]->z);
+        /* g = (g - f) * (m + 1)/2 (mod m) */
+        mpz_sub(g->z, g->z, f->z);
+        mpz_add_ui(p, a[1]->z, 1);
+        mpz_tdiv_q_2exp(p, p, 1);
+        mpz_mul(g->z, g->z, p);
+        mpz_mod(g->z, g->z, a[1]->z);
+    }
+    else {
+        mod = _GMPy_Scratch_Get(GMPY_SCRATCH_MOD_BITS(a[1]->z) + 1);
+        mpz_mul_2exp(mod, a[1]->z, 1);
+        _GMPy_MPZ_Lucas_UV(f->z, g->z, p, q, a[0]->z, mod);
+        mpz_sub(g->z, g->z, f->z);
+        mpz_mod(g->z, g->z, mod);
+        mpz_tdiv_q_2exp(g->z, g->z, 1);
+        mpz_mod(f->z, f->z, a[1]->z);
+    }
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    _GMPy_Scratch_Release(mark);
+
+    if (which == GMPY_FIB2_MOD) {
+        result = PyTuple_Pack(2, (PyObject*)f, (PyObject*)g);
+    }
+    else {
+        result = (PyObject*)f;
+        f = NULL;
+    }
+
+  cleanup:
+    Py_XDECREF((PyObject*)f);
+    Py_XDECREF((PyObject*)g);
+    _GMPy_MPZ_Args_Clear(a, 2);
+    return result;
+}
+
+PyDoc_STRVAR(doc_mpz_fib_mod,
+"fib_mod(n, m, /) -> mpz\n\n"
+"Return fib(n) % m without computing fib(n). n must be greater than or\n"
+"equal to 0; m must be greater than 0.");
+
+static PyObject *
+GMPY_mpz_fib_mod(PyObject *self, PyObject *args)
+{
+    return _GMPy_MPZ_Fib_Mod_Function(args, GMPY_FIB_MOD, "fib_mod");
+}
+
+PyDoc_STRVAR(doc_mpz_fib2_mod,
+"fib2_mod(n, m, /) -> tuple[mpz, mpz]\n\n"
+"Return the 2-tuple fib2(n) reduced modulo m without computing fib2(n).\n"
+"n must be greater than or equal to 0; m must be greater than 0.");
+
+static PyObject *
+GMPY_mpz_fib2_mod(PyObject *self, PyObject *args)
+{
+    return _GMPy_MPZ_Fib_Mod_Function(args, GMPY_FIB2_MOD, "fib2_mod");
+}
+
+PyDoc_STRVAR(doc_mpz_lucas_mod,
+"lucas_mod(n, m, /) -> mpz\n\n"
+"Return lucas(n) % m without computing lucas(n). n must be greater than\n"
+"or equal to 0; m must be greater than 0.");
+
+static PyObject *
+GMPY_mpz_lucas_mod(PyObject *self, PyObject *args)
+{
+    return _GMPy_MPZ_Fib_Mod_Function(args, GMPY_LUCAS_MOD, "lucas_mod");
+}
+
+/* Common code for lucasu_mod_list() and lucasv_mod_list(). The Montgomery
+ * constants of n are computed once by the calling thread and shared by
+ * every term and every worker thread.
+ */
+
+typedef struct {
+    MPZ_Object **terms;         /* p, q, and k of each term */
+    PyObject **items;           /* the results */
+    int want_u;
+    mpz_srcptr n;
+    const gmpy_mont *mont;      /* NULL unless GMPY_MONT_OK(n) */
+} gmpy_lucas_list;
+
+static void
+_GMPy_Lucas_List_Range(void *arg, Py_ssize_t start, Py_ssize_t stop)
+{
+    gmpy_lucas_list *work = (gmpy_lucas_list*)arg;
+    MPZ_Object **t;
+    mpz_ptr r;
+    Py_ssize_t i;
+
+    for (i = start; i < stop; i++) {
+        t = work->terms + 3 * i;
+        r = MPZ(work->items[i]);
+        if (work->mont)
+            _GMPy_MPZ_Lucas_UV_Mont(work->want_u ? r : NULL, work->want_u ? NULL : r,
+                                    t[0]->z, t[1]->z, t[2]->z, work->mont);
+        else
+            _GMPy_MPZ_Lucas_UV(work->want_u ? r : NULL, work->want_u ? NULL : r,
+                               t[0]->z, t[1]->z, t[2]->z, work->n);
+    }
+}
+
+static PyObject *
+_GMPy_MPZ_Lucas_List(PyObject *args, int want_u, const char *name)
+{
+    PyObject *seq = NULL, *term, *result = NULL;
+    MPZ_Object *n = NULL, **terms = NULL;
+    Py_ssize_t i, j, count = 0, nterms = 0;
+    gmpy_lucas_list work;
+    gmpy_mont mont;
+    mpz_ptr D;
+    int mark = -1;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (PyTuple_GET_SIZE(args) != 2) {
+        PyErr_Format(PyExc_TypeError, "%s() requires 2 arguments", name);
+        return NULL;
+    }
+
+    if (!(n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL))) {
+        PyErr_Format(PyExc_TypeError, "%s() requires an integer modulus", name);
+        return NULL;
+    }
+    if (mpz_sgn(n->z) <= 0) {
+        PyErr_Format(PyExc_ValueError, "invalid value for n in %s()", name);
+        goto err;
+    }
+
+    if (!(seq = PySequence_Fast(PyTuple_GET_ITEM(args, 0), "argument must be an iterable")))
+        goto err;
+
+    count = PySequence_Fast_GET_SIZE(seq);
+    if (!(terms = PyMem_New(MPZ_Object*, 3 * (count ? count : 1)))) {
+        PyErr_NoMemory();
+        goto err;
+    }
+
+    GMPy_Scratch_Attach();
+    mark = _GMPy_Scratch_Mark();
+    D = _GMPy_Scratch_Get(0);
+
+    for (i = 0; i < count; i++) {
+        term = PySequence_Fast_GET_ITEM(seq, i);
+        if (!PyTuple_Check(term) || PyTuple_GET_SIZE(term) != 3) {
+            PyErr_Format(PyExc_TypeError, "%s() requires (p,q,k) tuples", name);
+            goto err;
+        }
+        for (j = 0; j < 3; j++) {
+            if (!(terms[nterms] = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(term, j), NULL))) {
+                PyErr_Format(PyExc_TypeError, "%s() requires (p,q,k) tuples", name);
+                goto err;
+            }
+            nterms++;
+        }
+
+        _GMPy_MPZ_Lucas_D(D, terms[nterms - 3]->z, terms[nterms - 2]->z);
+        if (mpz_sgn(D) == 0) {
+            PyErr_Format(PyExc_ValueError, "invalid values for p,q in %s()", name);
+            goto err;
+        }
+        if (mpz_sgn(terms[nterms - 1]->z) < 0) {
+            PyErr_Format(PyExc_ValueError, "invalid value for k in %s()", name);
+            goto err;
+        }
+    }
+    Py_CLEAR(seq);
+
+    if (!(result = PyList_New(count)))
+        goto err;
+    for (i = 0; i < count; i++) {
+        if (!(term = (PyObject*)GMPy_MPZ_New(NULL)))
+            goto err;
+        PyList_SET_ITEM(result, i, term);
+    }
+
+    work.terms = terms;
+    work.items = PySequence_Fast_ITEMS(result);
+    work.want_u = want_u;
+    work.n = n->z;
+    work.mont = NULL;
+    if (GMPY_MONT_OK(n->z)) {
+        _GMPy_Mont_Init(&mont, n->z, D);
+        work.mont = &mont;
+    }
+
+    GMPY_PROFILE_OPN(context, GMPY_OP_POWMOD, mpz_sizeinbase(n->z, 2), count);
+    GMPY_BEGIN_ALLOW_THREADS_MIN(context, GMPY_MPZ_BITS(n->z) * count);
+    GMPy_Parallel_Run(_GMPy_Lucas_List_Range, &work, count,
+                      GMPY_THREADS_RELEASED() ? GMPY_THREADS(context) : 1);
+    GMPY_END_ALLOW_THREADS_MIN(context);
+
+    _GMPy_Scratch_Release(mark);
+    while (nterms--)
+        Py_DECREF((PyObject*)terms[nterms]);
+    PyMem_Free(terms);
+    Py_DECREF((PyObject*)n);
+    return result;
+
+  err:
+    if (mark >= 0)
+        _GMPy_Scratch_Release(mark);
+    if (terms) {
+        while (nterms--)
+            Py_DECREF((PyObject*)terms[nterms]);
+        PyMem_Free(terms);
+    }
+    Py_XDECREF(result);
+    Py_XDECREF(seq);
+    Py_DECREF((PyObject*)n);
+    return NULL;
+}
+
+PyDoc_STRVAR(doc_mpz_lucasu_mod_list,
+"lucasu_mod_list(terms, n, /) -> list[mpz]\n\n"
+"Return [lucasu_mod(p, q, k, n) for p, q, k in terms]. The setup for the\n"
+"modulus n is shared by every term. Will always release the GIL unless\n"
+"the total size of the work is less than the context's\n"
+"release_gil_min_bits. The work is split over the number of threads\n"
+"given by the context's threads.");
+
+static PyObject *
+GMPY_mpz_lucasu_mod_list(PyObject *self, PyObject *args)
+{
+    return _GMPy_MPZ_Lucas_List(args, 1, "lucasu_mod_list");
+}
+
+PyDoc_STRVAR(doc_mpz_lucasv_mod_list,
+"lucasv_mod_list(terms, n, /) -> list[mpz]\n\n"
+"Return [lucasv_mod(p, q, k, n) for p, q, k in terms]. The setup for the\n"
+"modulus n is shared by every term. Will always release the GIL unless\n"
+"the total size of the work is less than the context's\n"
+"release_gil_min_bits. The work is split over the number of threads\n"
+"given by the context's threads.");
+
+static PyObject *
+GMPY_mpz_lucasv_mod_list(PyObject *self, PyObject *args)
+{
+    return _GMPy_MPZ_Lucas_List(args, 0, "lucasv_mod_list");
+}
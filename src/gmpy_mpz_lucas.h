@@ -1,40 +1,54 @@
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- * gmpy_mpz_lucas.h                                                        *
- * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- * Python interface to the GMP, MPFR, and MPC multiple precision           *
- * libraries.                                                              *
- *                                                                         *
- * Copyright 2012 - 2023 Case Van Horsen                                   *
- *                                                                         *
- * This file is part of GMPY2.                                             *
- *                                                                         *
- * GMPY2 is free software: you can redistribute it and/or modify it under  *
- * the terms of the GNU Lesser General Public License as published by the  *
- * Free Software Foundation, either version 3 of the License, or (at your  *
- * option) any later version.                                              *
- *                                                                         *
- * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
- * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
- * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
- * License for more details.                                               *
- *                                                                         *
- * You should have received a copy of the GNU Lesser General Public        *
- * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
- * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
-
-#ifndef GMPY_LUCAS_H
-#define GMPY_LUCAS_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-static PyObject * GMPY_mpz_lucasu(PyObject *self, PyObject *args);
-static PyObject * GMPY_mpz_lucasu_mod(PyObject *self, PyObject *args);
-static PyObject * GMPY_mpz_lucasv(PyObject *self, PyObject *args);
-static PyObject * GMPY_mpz_lucasv_mod(PyObject *self, PyObject *args);
-
-#ifdef __cplusplus
-}
-#endif
-#endif
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy_mpz_lucas.h                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2012 - 2023 Case Van Horsen                                   *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_LUCAS_H
+#define GMPY_LUCAS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Context-free cores; they do not use the Python API. */
+
+static void _GMPy_MPZ_Lucas_UV(mpz_ptr u, mpz_ptr v, mpz_srcptr p, mpz_srcptr q,
+                               mpz_srcptr k, mpz_srcptr n);
+static void _GMPy_MPZ_Lucas_UV_Mont(mpz_ptr u, mpz_ptr v, mpz_srcptr p, mpz_srcptr q,
+                                    mpz_srcptr k, const gmpy_mont *mont);
+static void _GMPy_Mont_Lucas(const gmpy_mont *mont, mp_ptr u, mp_ptr v, mp_ptr qk,
+                             mp_srcptr p, mp_srcptr q, mpz_srcptr k, mp_ptr w);
+
+static PyObject * GMPY_mpz_lucasu(PyObject *self, PyObject *args);
+static PyObject * GMPY_mpz_lucasu_mod(PyObject *self, PyObject *args);
+static PyObject * GMPY_mpz_lucasv(PyObject *self, PyObject *args);
+static PyObject * GMPY_mpz_lucasv_mod(PyObject *self, PyObject *args);
+static PyObject * GMPY_mpz_lucasu_mod_list(PyObject *self, PyObject *args);
+static PyObject * GMPY_mpz_lucasv_mod_list(PyObject *self, PyObject *args);
+static PyObject * GMPY_mpz_fib_mod(PyObject *self, PyObject *args);
+static PyObject * GMPY_mpz_fib2_mod(PyObject *self, PyObject *args);
+static PyObject * GMPY_mpz_lucas_mod(PyObject *self, PyObject *args);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
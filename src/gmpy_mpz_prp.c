@@ -29,95 +29,254 @@
  * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
-/* ******************************************************************
- * mpz_prp: (also called a Fermat probable prime)
- * A "probable prime" to the base a is a number n such that,
- * (a,n)=1 and a^(n-1) = 1 mod n
- * ******************************************************************/
+/* The probable prime tests are split into context-free cores and thin
+ * Python functions. A core expects an odd n > 1 and arguments that have
+ * already been checked; it takes its temporaries from the scratch pool
+ * (see gmpy2_scratch.h) and does not use the Python API, so it can run
+ * without the GIL and be called directly by the batch functions. The
+ * Python functions convert and check the arguments, handle n == 1 and
+ * even n, and then call the core.
+ */
+
+/* Return 0 or 1 if n > 0 is 1 or even, otherwise -1. */
+
+static int
+_GMPy_PRP_Trivial(mpz_srcptr n)
+{
+    if (mpz_cmp_ui(n, 1) == 0)
+        return 0;
+    if (mpz_even_p(n))
+        return mpz_cmp_ui(n, 2) == 0;
+    return -1;
+}
 
-PyDoc_STRVAR(doc_mpz_is_fermat_prp,
-"is_fermat_prp(n,a,/) -> bool\n\n"
-"Return `True` if n is a Fermat probable prime to the base a.\n"
-"Assuming:\n\n"
-"    gcd(n,a) == 1\n\n"
-"Then a Fermat probable prime requires:\n\n"
-"    a**(n-1) == 1 (mod n)");
+/* Return 1 if gcd(n, x) is neither 1 nor n. */
+
+static int
+_GMPy_PRP_Common_Factor(mpz_srcptr n, mpz_srcptr x)
+{
+    int mark = _GMPy_Scratch_Mark(), result;
+    mpz_ptr g = _GMPy_Scratch_Get(mpz_sizeinbase(n, 2));
+
+    mpz_gcd(g, n, x);
+    result = (mpz_cmp(g, n) != 0) && (mpz_cmp_ui(g, 1) > 0);
+    _GMPy_Scratch_Release(mark);
+    return result;
+}
+
+/* Common code for the tests with arguments (n, a). */
+
+typedef int (*gmpy_prp_base_func)(mpz_srcptr n, mpz_srcptr a);
 
 static PyObject *
-GMPY_mpz_is_fermat_prp(PyObject *self, PyObject *args)
+_GMPy_PRP_Base_Function(PyObject *args, gmpy_prp_base_func func, const char *name)
 {
-    MPZ_Object *a = NULL, *n = NULL;
+    MPZ_Object *a[2];
+    gmpy_interrupt intr;
     PyObject *result = NULL;
-    mpz_t res, nm1;
-
-    if (PyTuple_Size(args) != 2) {
-        TYPE_ERROR("is_fermat_prp() requires 2 integer arguments");
-        return NULL;
-    }
+    CTXT_Object *context = NULL;
+    int ret;
 
-    mpz_init(res);
-    mpz_init(nm1);
+    CHECK_CONTEXT(context);
 
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    a = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
-    if (!a || !n) {
-        TYPE_ERROR("is_fermat_prp() requires 2 integer arguments");
-        goto cleanup;
-    }
+    if (_GMPy_MPZ_Args(args, 2, a, name) < 0)
+        return NULL;
 
     /* Require a >= 2. */
-    if (mpz_cmp_ui(a->z, 2) < 0) {
-        VALUE_ERROR("is_fermat_prp() requires 'a' greater than or equal to 2");
+    if (mpz_cmp_ui(a[1]->z, 2) < 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "%s() requires 'a' greater than or equal to 2", name);
         goto cleanup;
     }
 
     /* Require n > 0. */
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("is_fermat_prp() requires 'n' be greater than 0");
+    if (mpz_sgn(a[0]->z) <= 0) {
+        PyErr_Format(PyExc_ValueError, "%s() requires 'n' be greater than 0", name);
         goto cleanup;
     }
 
-    /* Check for n == 1 */
-    if (mpz_cmp_ui(n->z, 1) == 0) {
-        result = Py_False;
-        goto cleanup;
+    if ((ret = _GMPy_PRP_Trivial(a[0]->z)) < 0) {
+        /* Check gcd(n,a); n itself is not allowed either. */
+        if (_GMPy_PRP_Common_Factor(a[0]->z, a[1]->z) ||
+            mpz_divisible_p(a[1]->z, a[0]->z)) {
+            PyErr_Format(PyExc_ValueError, "%s() requires gcd(n,a) == 1", name);
+            goto cleanup;
+        }
+
+        GMPY_PROFILE_MPZ(context, GMPY_OP_PRP, a[0]->z);
+        GMPy_Interrupt_Begin(&intr, context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(a[0]->z));
+        intr.save = &_save;
+        ret = func(a[0]->z, a[1]->z);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        if (GMPy_Interrupt_End(&intr) < 0)
+            goto cleanup;
     }
+    result = ret ? Py_True : Py_False;
+    Py_INCREF(result);
+
+  cleanup:
+    _GMPy_MPZ_Args_Clear(a, 2);
+    return result;
+}
+
+/* Common code for the tests with arguments (n, p, q) that require
+ * gcd(n, 2*q*D) == 1.
+ */
+
+typedef int (*gmpy_prp_lucas_func)(mpz_srcptr n, mpz_srcptr p, mpz_srcptr q, mpz_srcptr D);
+
+static PyObject *
+_GMPy_PRP_Lucas_Function(PyObject *args, gmpy_prp_lucas_func func, const char *name)
+{
+    MPZ_Object *a[3];
+    gmpy_interrupt intr;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+    mpz_ptr D, t;
+    int mark, ret;
+
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_MPZ_Args(args, 3, a, name) < 0)
+        return NULL;
 
-    /* Handle n even. */
-    /* Should n even raise an exception? */
-    if (mpz_divisible_ui_p(n->z, 2)) {
-        if (mpz_cmp_ui(n->z, 2) == 0)
-            result = Py_True;
-        else
-            result = Py_False;
+    mark = _GMPy_Scratch_Mark();
+    D = _GMPy_Scratch_Get(0);
+    t = _GMPy_Scratch_Get(0);
+
+    /* Check if p*p - 4*q == 0. */
+    _GMPy_MPZ_Lucas_D(D, a[1]->z, a[2]->z);
+    if (mpz_sgn(D) == 0) {
+        PyErr_Format(PyExc_ValueError, "invalid values for p,q in %s()", name);
         goto cleanup;
     }
 
-    /* Check gcd(a,n) */
-    mpz_gcd(res, n->z, a->z);
-    if (mpz_cmp_ui(res, 1) > 0) {
-        VALUE_ERROR("is_fermat_prp() requires gcd(n,a) == 1");
+    /* Require n > 0. */
+    if (mpz_sgn(a[0]->z) <= 0) {
+        PyErr_Format(PyExc_ValueError, "%s() requires 'n' be greater than 0", name);
         goto cleanup;
     }
 
-    mpz_set(nm1, n->z);
-    mpz_sub_ui(nm1, nm1, 1);
-    mpz_powm(res, a->z, nm1, n->z);
+    if ((ret = _GMPy_PRP_Trivial(a[0]->z)) < 0) {
+        /* Check GCD */
+        mpz_mul(t, D, a[2]->z);
+        mpz_mul_ui(t, t, 2);
+        if (_GMPy_PRP_Common_Factor(a[0]->z, t)) {
+            PyErr_Format(PyExc_ValueError, "%s() requires gcd(n,2*q*D) == 1", name);
+            goto cleanup;
+        }
 
-    if (mpz_cmp_ui(res, 1) == 0)
-        result = Py_True;
-    else
-        result = Py_False;
+        GMPY_PROFILE_MPZ(context, GMPY_OP_PRP, a[0]->z);
+        GMPy_Interrupt_Begin(&intr, context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(a[0]->z));
+        intr.save = &_save;
+        ret = func(a[0]->z, a[1]->z, a[2]->z, D);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        if (GMPy_Interrupt_End(&intr) < 0)
+            goto cleanup;
+    }
+    result = ret ? Py_True : Py_False;
+    Py_INCREF(result);
 
   cleanup:
-    Py_XINCREF(result);
-    mpz_clear(res);
-    mpz_clear(nm1);
-    Py_XDECREF((PyObject*)a);
-    Py_XDECREF((PyObject*)n);
+    _GMPy_Scratch_Release(mark);
+    _GMPy_MPZ_Args_Clear(a, 3);
+    return result;
+}
+
+/* Common code for the tests with the single argument n. The core returns
+ * -1 if no Selfridge parameter was found; the error message names the
+ * test given by selfridge.
+ */
+
+typedef int (*gmpy_prp_single_func)(mpz_srcptr n);
+
+static PyObject *
+_GMPy_PRP_Single_Function(PyObject *args, gmpy_prp_single_func func,
+                          const char *name, const char *selfridge)
+{
+    MPZ_Object *n;
+    gmpy_interrupt intr;
+    CTXT_Object *context = NULL;
+    int ret;
+
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_MPZ_Args(args, 1, &n, name) < 0)
+        return NULL;
+
+    /* Require n > 0. */
+    if (mpz_sgn(n->z) <= 0) {
+        PyErr_Format(PyExc_ValueError, "%s() requires 'n' be greater than 0", name);
+        Py_DECREF((PyObject*)n);
+        return NULL;
+    }
+
+    if ((ret = _GMPy_PRP_Trivial(n->z)) < 0) {
+        GMPY_PROFILE_MPZ(context, GMPY_OP_PRP, n->z);
+        GMPy_Interrupt_Begin(&intr, context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(n->z));
+        intr.save = &_save;
+        ret = func(n->z);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        if (GMPy_Interrupt_End(&intr) < 0) {
+            Py_DECREF((PyObject*)n);
+            return NULL;
+        }
+    }
+    Py_DECREF((PyObject*)n);
+
+    if (ret < 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "appropriate value for D cannot be found in %s()", selfridge);
+        return NULL;
+    }
+    if (ret)
+        Py_RETURN_TRUE;
+    else
+        Py_RETURN_FALSE;
+}
+
+/* ******************************************************************
+ * mpz_prp: (also called a Fermat probable prime)
+ * A "probable prime" to the base a is a number n such that,
+ * (a,n)=1 and a^(n-1) = 1 mod n
+ * ******************************************************************/
+
+PyDoc_STRVAR(doc_mpz_is_fermat_prp,
+"is_fermat_prp(n,a,/) -> bool\n\n"
+"Return `True` if n is a Fermat probable prime to the base a.\n"
+"Assuming:\n\n"
+"    gcd(n,a) == 1\n\n"
+"Then a Fermat probable prime requires:\n\n"
+"    a**(n-1) == 1 (mod n)");
+
+/* Return 1 if the odd n > 1 is a Fermat probable prime to the base a.
+ * Does not use the Python API.
+ */
+
+static int
+_GMPy_MPZ_Fermat_PRP(mpz_srcptr n, mpz_srcptr a)
+{
+    int mark = _GMPy_Scratch_Mark(), result;
+    mpz_ptr res = _GMPy_Scratch_Get(GMPY_SCRATCH_MOD_BITS(n));
+    mpz_ptr nm1 = _GMPy_Scratch_Get(mpz_sizeinbase(n, 2));
+
+    mpz_sub_ui(nm1, n, 1);
+    mpz_powm(res, a, nm1, n);
+    result = mpz_cmp_ui(res, 1) == 0;
+
+    _GMPy_Scratch_Release(mark);
     return result;
 }
 
+static PyObject *
+GMPY_mpz_is_fermat_prp(PyObject *self, PyObject *args)
+{
+    return _GMPy_PRP_Base_Function(args, _GMPy_MPZ_Fermat_PRP, "is_fermat_prp");
+}
+
 /* *************************************************************************
  * mpz_euler_prp: (also called a Solovay-Strassen probable prime)
  * An "Euler probable prime" to the base a is an odd composite number n with,
@@ -135,91 +294,41 @@ PyDoc_STRVAR(doc_mpz_is_euler_prp,
 "    a**((n-1)/2) == (a/n) (mod n)\n\n"
 "where (a/n) is the Jacobi symbol.");
 
-static PyObject *
-GMPY_mpz_is_euler_prp(PyObject *self, PyObject *args)
-{
-    MPZ_Object *a = NULL, *n = NULL;
-    PyObject *result = NULL;
-    mpz_t res, exp;
-    int ret;
-
-    if (PyTuple_Size(args) != 2) {
-        TYPE_ERROR("is_euler_prp() requires 2 integer arguments");
-        return NULL;
-    }
-
-    mpz_init(res);
-    mpz_init(exp);
-
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    a = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
-    if (!a || !n) {
-        TYPE_ERROR("is_euler_prp() requires 2 integer arguments");
-        goto cleanup;
-    }
-
-    /* Require a >= 2. */
-    if (mpz_cmp_ui(a->z, 2) < 0) {
-        VALUE_ERROR("is_euler_prp() requires 'a' greater than or equal to 2");
-        goto cleanup;
-    }
-
-    /* Require n > 0. */
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("is_euler_prp() requires 'n' be greater than 0");
-        goto cleanup;
-    }
-
-    /* Check for n == 1 */
-    if (mpz_cmp_ui(n->z, 1) == 0) {
-        result = Py_False;
-        goto cleanup;
-    }
-
-    /* Handle n even. */
-    if (mpz_divisible_ui_p(n->z, 2)) {
-        if (mpz_cmp_ui(n->z, 2) == 0)
-            result = Py_True;
-        else
-            result = Py_False;
-        goto cleanup;
-    }
+/* Return 1 if the odd n > 1 is an Euler probable prime to the base a.
+ * Does not use the Python API.
+ */
 
-    /* Check gcd(a,b) */
-    mpz_gcd(res, n->z, a->z);
-    if (mpz_cmp_ui(res, 1) > 0) {
-        VALUE_ERROR("is_euler_prp() requires gcd(n,a) == 1");
-        goto cleanup;
-    }
+static int
+_GMPy_MPZ_Euler_PRP(mpz_srcptr n, mpz_srcptr a)
+{
+    int mark = _GMPy_Scratch_Mark(), result, ret;
+    mpz_ptr res = _GMPy_Scratch_Get(GMPY_SCRATCH_MOD_BITS(n));
+    mpz_ptr exp = _GMPy_Scratch_Get(mpz_sizeinbase(n, 2) + 1);
 
-    mpz_set(exp, n->z);
-    mpz_sub_ui(exp, exp, 1);
+    mpz_sub_ui(exp, n, 1);
     mpz_divexact_ui(exp, exp, 2);
-    mpz_powm(res, a->z, exp, n->z);
+    mpz_powm(res, a, exp, n);
 
     /* reuse exp to calculate jacobi(a,n) mod n */
-    ret = mpz_jacobi(a->z,n->z);
-    mpz_set(exp, n->z);
+    ret = mpz_jacobi(a, n);
+    mpz_set(exp, n);
     if (ret == -1)
         mpz_sub_ui(exp, exp, 1);
     else if (ret == 1)
         mpz_add_ui(exp, exp, 1);
-    mpz_mod(exp, exp, n->z);
-
-    if (mpz_cmp(res, exp) == 0)
-        result = Py_True;
-    else
-        result = Py_False;
+    mpz_mod(exp, exp, n);
+    result = mpz_cmp(res, exp) == 0;
 
-  cleanup:
-    Py_XINCREF(result);
-    mpz_clear(res);
-    mpz_clear(exp);
-    Py_XDECREF((PyObject*)a);
-    Py_XDECREF((PyObject*)n);
+    _GMPy_Scratch_Release(mark);
     return result;
 }
 
+static PyObject *
+GMPY_mpz_is_euler_prp(PyObject *self, PyObject *args)
+{
+    return _GMPy_PRP_Base_Function(args, _GMPy_MPZ_Euler_PRP, "is_euler_prp");
+}
+
 /* *********************************************************************************************
  * mpz_sprp: (also called a Miller-Rabin probable prime)
  * A "strong probable prime" to the base a is an odd composite n = (2^r)*s+1 with s odd such that
@@ -239,101 +348,54 @@ PyDoc_STRVAR(doc_mpz_is_strong_prp,
 "    or\n"
 "    a**(s*(2**t)) == -1 (mod n) for some t, 0 <= t < r.");
 
-static PyObject *
-GMPY_mpz_is_strong_prp(PyObject *self, PyObject *args)
-{
-    MPZ_Object *a = NULL, *n = NULL;
-    PyObject *result = NULL;
-    mpz_t s, nm1, mpz_test;
-    mp_bitcnt_t r = 0;
-
-    if (PyTuple_Size(args) != 2) {
-        TYPE_ERROR("is_strong_prp() requires 2 integer arguments");
-        return NULL;
-    }
-
-    mpz_init(s);
-    mpz_init(nm1);
-    mpz_init(mpz_test);
-
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    a = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
-    if (!a || !n) {
-        TYPE_ERROR("is_strong_prp() requires 2 integer arguments");
-        goto cleanup;
-    }
-
-    /* Require a >= 2. */
-    if (mpz_cmp_ui(a->z, 2) < 0) {
-        VALUE_ERROR("is_strong_prp() requires 'a' greater than or equal to 2");
-        goto cleanup;
-    }
-
-    /* Require n > 0. */
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("is_strong_prp() requires 'n' be greater than 0");
-        goto cleanup;
-    }
-
-    /* Check for n == 1 */
-    if (mpz_cmp_ui(n->z, 1) == 0) {
-        result = Py_False;
-        goto cleanup;
-    }
-
-    /* Handle n even. */
-    if (mpz_divisible_ui_p(n->z, 2)) {
-        if (mpz_cmp_ui(n->z, 2) == 0)
-            result = Py_True;
-        else
-            result = Py_False;
-        goto cleanup;
-    }
+/* Return 1 if the odd n > 1 is a strong probable prime to the base a.
+ * Does not use the Python API.
+ */
 
-    /* Check gcd(a,b) */
-    mpz_gcd(s, n->z, a->z);
-    if (mpz_cmp_ui(s, 1) > 0) {
-        VALUE_ERROR("is_strong_prp() requires gcd(n,a) == 1");
-        goto cleanup;
-    }
+static int
+_GMPy_MPZ_Strong_PRP(mpz_srcptr n, mpz_srcptr a)
+{
+    int mark = _GMPy_Scratch_Mark(), result = 0;
+    size_t bits = GMPY_SCRATCH_MOD_BITS(n);
+    mpz_ptr s = _GMPy_Scratch_Get(mpz_sizeinbase(n, 2));
+    mpz_ptr nm1 = _GMPy_Scratch_Get(mpz_sizeinbase(n, 2));
+    mpz_ptr mpz_test = _GMPy_Scratch_Get(bits);
+    mp_bitcnt_t r;
 
-    mpz_set(nm1, n->z);
-    mpz_sub_ui(nm1, nm1, 1);
+    mpz_sub_ui(nm1, n, 1);
 
     /* Find s and r satisfying: n-1=(2^r)*s, s odd */
     r = mpz_scan1(nm1, 0);
     mpz_fdiv_q_2exp(s, nm1, r);
 
-
     /* Check a^((2^t)*s) mod n for 0 <= t < r */
-    mpz_powm(mpz_test, a->z, s, n->z);
+    mpz_powm(mpz_test, a, s, n);
     if ((mpz_cmp_ui(mpz_test, 1) == 0) || (mpz_cmp(mpz_test, nm1) == 0)) {
-        result = Py_True;
-        goto cleanup;
+        result = 1;
     }
+    else {
+        while (--r && !GMPy_Interrupt_Poll()) {
+            /* mpz_test = mpz_test^2%n */
+            mpz_mul(mpz_test, mpz_test, mpz_test);
+            mpz_mod(mpz_test, mpz_test, n);
 
-    while (--r) {
-        /* mpz_test = mpz_test^2%n */
-        mpz_mul(mpz_test, mpz_test, mpz_test);
-        mpz_mod(mpz_test, mpz_test, n->z);
-
-        if (mpz_cmp(mpz_test, nm1) == 0) {
-            result = Py_True;
-            goto cleanup;
+            if (mpz_cmp(mpz_test, nm1) == 0) {
+                result = 1;
+                break;
+            }
         }
     }
 
-    result = Py_False;
-  cleanup:
-    Py_XINCREF(result);
-    mpz_clear(s);
-    mpz_clear(nm1);
-    mpz_clear(mpz_test);
-    Py_XDECREF((PyObject*)a);
-    Py_XDECREF((PyObject*)n);
+    _GMPy_Scratch_Release(mark);
     return result;
 }
 
+static PyObject *
+GMPY_mpz_is_strong_prp(PyObject *self, PyObject *args)
+{
+    return _GMPy_PRP_Base_Function(args, _GMPy_MPZ_Strong_PRP, "is_strong_prp");
+}
+
 /* *************************************************************************
  * mpz_fibonacci_prp:
  * A "Fibonacci probable prime" with parameters (P,Q), P > 0, Q=+/-1, is a
@@ -351,381 +413,128 @@ PyDoc_STRVAR(doc_mpz_is_fibonacci_prp,
 "Then a Fibonacci probable prime requires:\n\n"
 "    lucasv(p,q,n) == p (mod n).");
 
+/* Return 1 if the odd n > 1 is a Fibonacci probable prime with parameters
+ * (p,q). Does not use the Python API.
+ */
+
+static int
+_GMPy_MPZ_Fibonacci_PRP(mpz_srcptr n, mpz_srcptr p, mpz_srcptr q)
+{
+    int mark = _GMPy_Scratch_Mark(), result;
+    mpz_ptr pmodn = _GMPy_Scratch_Get(mpz_sizeinbase(n, 2));
+    mpz_ptr vl = _GMPy_Scratch_Get(mpz_sizeinbase(n, 2));
+
+    mpz_mod(pmodn, p, n);
+    _GMPy_MPZ_Lucas_UV(NULL, vl, p, q, n, n);
+    result = mpz_cmp(vl, pmodn) == 0;
+
+    _GMPy_Scratch_Release(mark);
+    return result;
+}
+
 static PyObject *
 GMPY_mpz_is_fibonacci_prp(PyObject *self, PyObject *args)
 {
-    MPZ_Object *n = NULL, *p = NULL, *q = NULL;
+    MPZ_Object *a[3];
+    gmpy_interrupt intr;
     PyObject *result = NULL;
-    mpz_t pmodn, zP;
-    /* used for calculating the Lucas V sequence */
-    mpz_t vl, vh, ql, qh, tmp;
-    mp_bitcnt_t s = 0, j = 0;
+    CTXT_Object *context = NULL;
+    mpz_ptr D;
+    int mark, ret;
 
-    if (PyTuple_Size(args) != 3) {
-        TYPE_ERROR("is_fibonacci_prp() requires 3 integer arguments");
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_MPZ_Args(args, 3, a, "is_fibonacci_prp") < 0)
         return NULL;
-    }
 
-    mpz_init(pmodn);
-    mpz_init(zP);
-    mpz_init(vl);
-    mpz_init(vh);
-    mpz_init(ql);
-    mpz_init(qh);
-    mpz_init(tmp);
-
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    p = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
-    q = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 2), NULL);
-    if (!n || !p || !q) {
-        TYPE_ERROR("is_fibonacci_prp() requires 3 integer arguments");
-        goto cleanup;
-    }
+    mark = _GMPy_Scratch_Mark();
+    D = _GMPy_Scratch_Get(0);
 
     /* Check if p*p - 4*q == 0. */
-
-    mpz_mul(tmp, p->z, p->z);
-    mpz_mul_ui(qh, q->z, 4);
-    mpz_sub(tmp, tmp, qh);
-    if (mpz_sgn(tmp) == 0) {
+    _GMPy_MPZ_Lucas_D(D, a[1]->z, a[2]->z);
+    if (mpz_sgn(D) == 0) {
         VALUE_ERROR("invalid values for p,q in is_fibonacci_prp()");
         goto cleanup;
     }
 
     /* Verify q = +/-1 */
-
-    if ((mpz_cmp_si(q->z, 1) && mpz_cmp_si(q->z, -1)) || (mpz_sgn(p->z) <= 0)) {
+    if ((mpz_cmp_si(a[2]->z, 1) && mpz_cmp_si(a[2]->z, -1)) || (mpz_sgn(a[1]->z) <= 0)) {
         VALUE_ERROR("invalid values for p,q in is_fibonacci_prp()");
         goto cleanup;
     }
 
     /* Require n > 0. */
-    if (mpz_sgn(n->z) <= 0) {
+    if (mpz_sgn(a[0]->z) <= 0) {
         VALUE_ERROR("is_fibonacci_prp() requires 'n' be greater than 0");
         goto cleanup;
     }
 
-    /* Check for n == 1 */
-    if (mpz_cmp_ui(n->z, 1) == 0) {
-        result = Py_False;
-        goto cleanup;
-    }
-
-    /* Handle n even. */
-    if (mpz_divisible_ui_p(n->z, 2)) {
-        if (mpz_cmp_ui(n->z, 2) == 0)
-            result = Py_True;
-        else
-            result = Py_False;
-        goto cleanup;
+    if ((ret = _GMPy_PRP_Trivial(a[0]->z)) < 0) {
+        GMPY_PROFILE_MPZ(context, GMPY_OP_PRP, a[0]->z);
+        GMPy_Interrupt_Begin(&intr, context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(a[0]->z));
+        intr.save = &_save;
+        ret = _GMPy_MPZ_Fibonacci_PRP(a[0]->z, a[1]->z, a[2]->z);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        if (GMPy_Interrupt_End(&intr) < 0)
+            goto cleanup;
     }
+    result = ret ? Py_True : Py_False;
+    Py_INCREF(result);
 
-    mpz_set(zP, p->z);
-    mpz_mod(pmodn, zP, n->z);
+  cleanup:
+    _GMPy_Scratch_Release(mark);
+    _GMPy_MPZ_Args_Clear(a, 3);
+    return result;
+}
 
-    /* mpz_lucasvmod(res, p, q, n, n); */
-    mpz_set_si(vl, 2);
-    mpz_set(vh, p->z);
-    mpz_set_si(ql, 1);
-    mpz_set_si(qh, 1);
-    mpz_set_si(tmp,0);
+/* *******************************************************************************
+ * mpz_lucas_prp:
+ * A "Lucas probable prime" with parameters (P,Q) is a composite n with D=P^2-4Q,
+ * (n,2QD)=1 such that U_(n-(D/n)) == 0 mod n [(D/n) is the Jacobi symbol]
+ * *******************************************************************************/
 
-    s = mpz_scan1(n->z, 0);
-    for (j = mpz_sizeinbase(n->z,2)-1; j >= s+1; j--) {
-        /* ql = ql*qh (mod n) */
-        mpz_mul(ql, ql, qh);
-        mpz_mod(ql, ql, n->z);
-        if (mpz_tstbit(n->z,j) == 1) {
-            /* qh = ql*q */
-            mpz_mul(qh, ql, q->z);
+PyDoc_STRVAR(doc_mpz_is_lucas_prp,
+"is_lucas_prp(n,p,q,/) -> bool\n\n"
+"Return `True` if n is a Lucas probable prime with parameters (p,q).\n"
+"Assuming:\n\n"
+"    n is odd\n"
+"    D = p*p - 4*q, D != 0\n"
+"    gcd(n, 2*q*D) == 1\n\n"
+"Then a Lucas probable prime requires:\n\n"
+"    lucasu(p,q,n - Jacobi(D,n)) == 0 (mod n)");
 
-            /* vl = vh*vl - p*ql (mod n) */
-            mpz_mul(vl, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
+/* Return 1 if the odd n > 1 is a Lucas probable prime with parameters
+ * (p,q) where D = p*p - 4*q. The caller checks gcd(n, 2*q*D). Does not
+ * use the Python API.
+ */
 
-            /* vh = vh*vh - 2*qh (mod n) */
-            mpz_mul(vh, vh, vh);
-            mpz_mul_si(tmp, qh, 2);
-            mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
-        }
-        else {
-            /* qh = ql */
-            mpz_set(qh, ql);
+static int
+_GMPy_MPZ_Lucas_PRP(mpz_srcptr n, mpz_srcptr p, mpz_srcptr q, mpz_srcptr D)
+{
+    int mark = _GMPy_Scratch_Mark(), ret, result;
+    mpz_ptr index = _GMPy_Scratch_Get(mpz_sizeinbase(n, 2) + 1);
+    mpz_ptr uh = _GMPy_Scratch_Get(mpz_sizeinbase(n, 2));
 
-            /* vh = vh*vl - p*ql (mod n) */
-            mpz_mul(vh, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
+    /* index = n-(D/n), where (D/n) is the Jacobi symbol */
+    mpz_set(index, n);
+    ret = mpz_jacobi(D, n);
+    if (ret == -1)
+        mpz_add_ui(index, index, 1);
+    else if (ret == 1)
+        mpz_sub_ui(index, index, 1);
 
-            /* vl = vl*vl - 2*ql (mod n) */
-            mpz_mul(vl, vl, vl);
-            mpz_mul_si(tmp, ql, 2);
-            mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
-        }
-    }
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
+    _GMPy_MPZ_Lucas_UV(uh, NULL, p, q, index, n);
+    result = mpz_sgn(uh) == 0;
 
-    /* qh = ql*q */
-    mpz_mul(qh, ql, q->z);
-
-    /* vl = vh*vl - p*ql */
-    mpz_mul(vl, vh, vl);
-    mpz_mul(tmp, ql, p->z);
-    mpz_sub(vl, vl, tmp);
-
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    for (j = 1; j <= s; j++) {
-        /* vl = vl*vl - 2*ql (mod n) */
-        mpz_mul(vl, vl, vl);
-        mpz_mul_si(tmp, ql, 2);
-        mpz_sub(vl, vl, tmp);
-        mpz_mod(vl, vl, n->z);
-
-        /* ql = ql*ql (mod n) */
-        mpz_mul(ql, ql, ql);
-        mpz_mod(ql, ql, n->z);
-    }
-
-    /* vl contains our return value */
-    mpz_mod(vl, vl, n->z);
-
-    if (mpz_cmp(vl, pmodn) == 0)
-        result = Py_True;
-    else
-        result = Py_False;
-
-  cleanup:
-    Py_XINCREF(result);
-    mpz_clear(pmodn);
-    mpz_clear(zP);
-    mpz_clear(vl);
-    mpz_clear(vh);
-    mpz_clear(ql);
-    mpz_clear(qh);
-    mpz_clear(tmp);
-    Py_XDECREF((PyObject*)p);
-    Py_XDECREF((PyObject*)q);
-    Py_XDECREF((PyObject*)n);
-    return result;
-}
-
-
-/* *******************************************************************************
- * mpz_lucas_prp:
- * A "Lucas probable prime" with parameters (P,Q) is a composite n with D=P^2-4Q,
- * (n,2QD)=1 such that U_(n-(D/n)) == 0 mod n [(D/n) is the Jacobi symbol]
- * *******************************************************************************/
-
-PyDoc_STRVAR(doc_mpz_is_lucas_prp,
-"is_lucas_prp(n,p,q,/) -> bool\n\n"
-"Return `True` if n is a Lucas probable prime with parameters (p,q).\n"
-"Assuming:\n\n"
-"    n is odd\n"
-"    D = p*p - 4*q, D != 0\n"
-"    gcd(n, 2*q*D) == 1\n\n"
-"Then a Lucas probable prime requires:\n\n"
-"    lucasu(p,q,n - Jacobi(D,n)) == 0 (mod n)");
+    _GMPy_Scratch_Release(mark);
+    return result;
+}
 
 static PyObject *
 GMPY_mpz_is_lucas_prp(PyObject *self, PyObject *args)
 {
-    MPZ_Object *n = NULL, *p = NULL, *q = NULL;
-    PyObject *result = NULL;
-    mpz_t zD, res, index;
-    /* used for calculating the Lucas U sequence */
-    mpz_t uh, vl, vh, ql, qh, tmp;
-    mp_bitcnt_t s = 0, j = 0;
-    int ret;
-
-    if (PyTuple_Size(args) != 3) {
-        TYPE_ERROR("is_lucas_prp() requires 3 integer arguments");
-        return NULL;
-    }
-
-    mpz_init(zD);
-    mpz_init(res);
-    mpz_init(index);
-    mpz_init(uh);
-    mpz_init(vl);
-    mpz_init(vh);
-    mpz_init(ql);
-    mpz_init(qh);
-    mpz_init(tmp);
-
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    p = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
-    q = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 2), NULL);
-    if (!n || !p || !q) {
-        TYPE_ERROR("is_lucas_prp() requires 3 integer arguments");
-        goto cleanup;
-    }
-
-    /* Check if p*p - 4*q == 0. */
-    mpz_mul(zD, p->z, p->z);
-    mpz_mul_ui(tmp, q->z, 4);
-    mpz_sub(zD, zD, tmp);
-    if (mpz_sgn(zD) == 0) {
-        VALUE_ERROR("invalid values for p,q in is_lucas_prp()");
-        goto cleanup;
-    }
-
-    /* Require n > 0. */
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("is_lucas_prp() requires 'n' be greater than 0");
-        goto cleanup;
-    }
-
-    /* Check for n == 1 */
-    if (mpz_cmp_ui(n->z, 1) == 0) {
-        result = Py_False;
-        goto cleanup;
-    }
-
-    /* Handle n even. */
-    if (mpz_divisible_ui_p(n->z, 2)) {
-        if (mpz_cmp_ui(n->z, 2) == 0)
-            result = Py_True;
-        else
-            result = Py_False;
-        goto cleanup;
-    }
-
-    /* Check GCD */
-    mpz_mul(res, zD, q->z);
-    mpz_mul_ui(res, res, 2);
-    mpz_gcd(res, res, n->z);
-    if ((mpz_cmp(res, n->z) != 0) && (mpz_cmp_ui(res, 1) > 0)) {
-        VALUE_ERROR("is_lucas_prp() requires gcd(n,2*q*D) == 1");
-        goto cleanup;
-    }
-
-    /* index = n-(D/n), where (D/n) is the Jacobi symbol */
-    mpz_set(index, n->z);
-    ret = mpz_jacobi(zD, n->z);
-    if (ret == -1)
-        mpz_add_ui(index, index, 1);
-    else if (ret == 1)
-        mpz_sub_ui(index, index, 1);
-
-    /* mpz_lucasumod(res, p, q, index, n); */
-    mpz_set_si(uh, 1);
-    mpz_set_si(vl, 2);
-    mpz_set(vh, p->z);
-    mpz_set_si(ql, 1);
-    mpz_set_si(qh, 1);
-    mpz_set_si(tmp,0);
-
-    s = mpz_scan1(index, 0);
-    for (j = mpz_sizeinbase(index,2)-1; j >= s+1; j--) {
-        /* ql = ql*qh (mod n) */
-        mpz_mul(ql, ql, qh);
-        mpz_mod(ql, ql, n->z);
-        if (mpz_tstbit(index,j) == 1) {
-            /* qh = ql*q */
-            mpz_mul(qh, ql, q->z);
-
-            /* uh = uh*vh (mod n) */
-            mpz_mul(uh, uh, vh);
-            mpz_mod(uh, uh, n->z);
-
-            /* vl = vh*vl - p*ql (mod n) */
-            mpz_mul(vl, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
-
-            /* vh = vh*vh - 2*qh (mod n) */
-            mpz_mul(vh, vh, vh);
-            mpz_mul_si(tmp, qh, 2);
-            mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
-        }
-        else {
-            /* qh = ql */
-            mpz_set(qh, ql);
-
-            /* uh = uh*vl - ql (mod n) */
-            mpz_mul(uh, uh, vl);
-            mpz_sub(uh, uh, ql);
-            mpz_mod(uh, uh, n->z);
-
-            /* vh = vh*vl - p*ql (mod n) */
-            mpz_mul(vh, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
-
-            /* vl = vl*vl - 2*ql (mod n) */
-            mpz_mul(vl, vl, vl);
-            mpz_mul_si(tmp, ql, 2);
-            mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
-        }
-    }
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    /* qh = ql*q */
-    mpz_mul(qh, ql, q->z);
-
-    /* uh = uh*vl - ql */
-    mpz_mul(uh, uh, vl);
-    mpz_sub(uh, uh, ql);
-
-    /* vl = vh*vl - p*ql */
-    mpz_mul(vl, vh, vl);
-    mpz_mul(tmp, ql, p->z);
-    mpz_sub(vl, vl, tmp);
-
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    for (j = 1; j <= s; j++) {
-        /* uh = uh*vl (mod n) */
-        mpz_mul(uh, uh, vl);
-        mpz_mod(uh, uh, n->z);
-
-        /* vl = vl*vl - 2*ql (mod n) */
-        mpz_mul(vl, vl, vl);
-        mpz_mul_si(tmp, ql, 2);
-        mpz_sub(vl, vl, tmp);
-        mpz_mod(vl, vl, n->z);
-
-        /* ql = ql*ql (mod n) */
-        mpz_mul(ql, ql, ql);
-        mpz_mod(ql, ql, n->z);
-    }
-
-    /* uh contains our return value */
-    mpz_mod(res, uh, n->z);
-    if (mpz_cmp_ui(res, 0) == 0)
-        result = Py_True;
-    else
-        result = Py_False;
-
-  cleanup:
-    Py_XINCREF(result);
-    mpz_clear(zD);
-    mpz_clear(res);
-    mpz_clear(index);
-    mpz_clear(uh);
-    mpz_clear(vl);
-    mpz_clear(vh);
-    mpz_clear(ql);
-    mpz_clear(qh);
-    mpz_clear(tmp);
-    Py_XDECREF((PyObject*)p);
-    Py_XDECREF((PyObject*)q);
-    Py_XDECREF((PyObject*)n);
-    return result;
+    return _GMPy_PRP_Lucas_Function(args, _GMPy_MPZ_Lucas_PRP, "is_lucas_prp");
 }
 
 /* *********************************************************************************************
@@ -748,349 +557,117 @@ PyDoc_STRVAR(doc_mpz_is_stronglucas_prp,
 "    or\n"
 "    lucasv(p,q,s*(2**t)) == 0 (mod n) for some t, 0 <= t < r");
 
-static PyObject *
-GMPY_mpz_is_stronglucas_prp(PyObject *self, PyObject *args)
+/* Compute U_s and V_s for the odd s and then V_((2^t)*s) for 0 < t < r
+ * (mod n). Returns 1 if U_s == 0, V_s == 0, or any V_((2^t)*s) == 0; if
+ * extra is set it also returns 1 if V_s == +/-2. Used by the strong and
+ * the extra strong Lucas tests. Moduli accepted by GMPY_MONT_OK() use
+ * Montgomery arithmetic; larger moduli stop early, with a meaningless
+ * result, once GMPy_Interrupt_Poll() returns 1. Does not use the Python
+ * API.
+ */
+
+static int
+_GMPy_MPZ_Lucas_Strong_Check_Mont(mpz_srcptr n, mpz_srcptr p, mpz_srcptr q,
+                                  mpz_srcptr s, mp_bitcnt_t r, int extra)
 {
-    MPZ_Object *n = NULL, *p= NULL, *q = NULL;
-    PyObject *result = NULL;
-    mpz_t zD, s, nmj, res;
-    /* these are needed for the LucasU and LucasV part of this function */
-    mpz_t uh, vl, vh, ql, qh, tmp;
-    mp_bitcnt_t r = 0, j = 0;
-    int ret = 0;
-
-    if (PyTuple_Size(args) != 3) {
-        TYPE_ERROR("is_strong_lucas_prp() requires 3 integer arguments");
-        return NULL;
-    }
-
-    mpz_init(zD);
-    mpz_init(s);
-    mpz_init(nmj);
-    mpz_init(res);
-    mpz_init(uh);
-    mpz_init(vl);
-    mpz_init(vh);
-    mpz_init(ql);
-    mpz_init(qh);
-    mpz_init(tmp);
-
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    p = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
-    q = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 2), NULL);
-    if (!n || !p || !q) {
-        TYPE_ERROR("is_strong_lucas_prp() requires 3 integer arguments");
-        goto cleanup;
-    }
-
-    /* Check if p*p - 4*q == 0. */
-    mpz_mul(zD, p->z, p->z);
-    mpz_mul_ui(tmp, q->z, 4);
-    mpz_sub(zD, zD, tmp);
-    if (mpz_sgn(zD) == 0) {
-        VALUE_ERROR("invalid values for p,q in is_strong_lucas_prp()");
-        goto cleanup;
-    }
-
-    /* Require n > 0. */
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("is_strong_lucas_prp() requires 'n' be greater than 0");
-        goto cleanup;
-    }
-
-    /* Check for n == 1 */
-    if (mpz_cmp_ui(n->z, 1) == 0) {
-        result = Py_False;
-        goto cleanup;
-    }
-
-    /* Handle n even. */
-    if (mpz_divisible_ui_p(n->z, 2)) {
-        if (mpz_cmp_ui(n->z, 2) == 0)
-            result = Py_True;
-        else
-            result = Py_False;
-        goto cleanup;
-    }
-
-    /* Check GCD */
-    mpz_mul(res, zD, q->z);
-    mpz_mul_ui(res, res, 2);
-    mpz_gcd(res, res, n->z);
-    if ((mpz_cmp(res, n->z) != 0) && (mpz_cmp_ui(res, 1) > 0)) {
-        VALUE_ERROR("is_strong_lucas_prp() requires gcd(n,2*q*D) == 1");
-        goto cleanup;
-    }
-
-    /* nmj = n - (D/n), where (D/n) is the Jacobi symbol */
-    mpz_set(nmj, n->z);
-    ret = mpz_jacobi(zD, n->z);
-    if (ret == -1)
-        mpz_add_ui(nmj, nmj, 1);
-    else if (ret == 1)
-        mpz_sub_ui(nmj, nmj, 1);
-
-    r = mpz_scan1(nmj, 0);
-    mpz_fdiv_q_2exp(s, nmj, r);
-
-    /* make sure U_s == 0 mod n or V_((2^t)*s) == 0 mod n, for some t, 0 <= t < r */
-    mpz_set_si(uh, 1);
-    mpz_set_si(vl, 2);
-    mpz_set(vh, p->z);
-    mpz_set_si(ql, 1);
-    mpz_set_si(qh, 1);
-    mpz_set_si(tmp,0);
-
-    for (j = mpz_sizeinbase(s,2)-1; j >= 1; j--) {
-        /* ql = ql*qh (mod n) */
-        mpz_mul(ql, ql, qh);
-        mpz_mod(ql, ql, n->z);
-        if (mpz_tstbit(s,j) == 1) {
-            /* qh = ql*q */
-            mpz_mul(qh, ql, q->z);
-
-            /* uh = uh*vh (mod n) */
-            mpz_mul(uh, uh, vh);
-            mpz_mod(uh, uh, n->z);
-
-            /* vl = vh*vl - p*ql (mod n) */
-            mpz_mul(vl, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
-
-            /* vh = vh*vh - 2*qh (mod n) */
-            mpz_mul(vh, vh, vh);
-            mpz_mul_si(tmp, qh, 2);
-            mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
-        }
-        else {
-            /* qh = ql */
-            mpz_set(qh, ql);
-
-            /* uh = uh*vl - ql (mod n) */
-            mpz_mul(uh, uh, vl);
-            mpz_sub(uh, uh, ql);
-            mpz_mod(uh, uh, n->z);
-
-            /* vh = vh*vl - p*ql (mod n) */
-            mpz_mul(vh, vh, vl);
-            mpz_mul(tmp, ql, p->z);
-            mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
-
-            /* vl = vl*vl - 2*ql (mod n) */
-            mpz_mul(vl, vl, vl);
-            mpz_mul_si(tmp, ql, 2);
-            mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
-        }
-    }
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    /* qh = ql*q */
-    mpz_mul(qh, ql, q->z);
-
-    /* uh = uh*vl - ql */
-    mpz_mul(uh, uh, vl);
-    mpz_sub(uh, uh, ql);
-
-    /* vl = vh*vl - p*ql */
-    mpz_mul(vl, vh, vl);
-    mpz_mul(tmp, ql, p->z);
-    mpz_sub(vl, vl, tmp);
-
-    /* ql = ql*qh */
-    mpz_mul(ql, ql, qh);
-
-    mpz_mod(uh, uh, n->z);
-    mpz_mod(vl, vl, n->z);
+    int mark = _GMPy_Scratch_Mark(), result;
+    gmpy_mont mont;
+    mp_size_t sz;
+    mp_ptr mp, mq, uh, vl, ql, tmp, w;
+    mp_bitcnt_t j;
+
+    _GMPy_Mont_Init(&mont, n, _GMPy_Scratch_Get(0));
+    sz = mont.n;
+    mp = mpz_limbs_write(_GMPy_Scratch_Get(12 * sz * GMP_NUMB_BITS), 12 * sz);
+    mq = mp + sz;
+    uh = mp + 2 * sz;
+    vl = mp + 3 * sz;
+    ql = mp + 4 * sz;
+    tmp = mp + 5 * sz;
+    w = mp + 6 * sz;
+
+    _GMPy_Mont_To(&mont, mp, p, w);
+    _GMPy_Mont_To(&mont, mq, q, w);
+    _GMPy_Mont_Lucas(&mont, uh, vl, ql, mp, mq, s, w);
 
     /* uh contains LucasU_s and vl contains LucasV_s */
-    if ((mpz_cmp_ui(uh, 0) == 0) || (mpz_cmp_ui(vl, 0) == 0)) {
-        result = Py_True;
-        goto cleanup;
+    result = mpn_zero_p(uh, sz) || mpn_zero_p(vl, sz);
+    if (extra && !result) {
+        /* tmp = 2 and uh = -2 */
+        _GMPy_Mont_One(&mont, tmp, w);
+        _GMPy_Mont_Add(&mont, tmp, tmp, tmp);
+        mpn_zero(uh, sz);
+        _GMPy_Mont_Sub(&mont, uh, uh, tmp);
+        result = (mpn_cmp(vl, tmp, sz) == 0) || (mpn_cmp(vl, uh, sz) == 0);
+        r--;
     }
 
-    for (j = 1; j < r; j++) {
-        /* vl = vl*vl - 2*ql (mod n) */
-        mpz_mul(vl, vl, vl);
-        mpz_mul_si(tmp, ql, 2);
-        mpz_sub(vl, vl, tmp);
-        mpz_mod(vl, vl, n->z);
-
-        /* ql = ql*ql (mod n) */
-        mpz_mul(ql, ql, ql);
-        mpz_mod(ql, ql, n->z);
-
-        if (mpz_cmp_ui(vl, 0) == 0) {
-            result = Py_True;
-            goto cleanup;
-        }
-    }
-
-    result = Py_False;
-  cleanup:
-    Py_XINCREF(result);
-    mpz_clear(zD);
-    mpz_clear(s);
-    mpz_clear(nmj);
-    mpz_clear(res);
-    mpz_clear(uh);
-    mpz_clear(vl);
-    mpz_clear(vh);
-    mpz_clear(ql);
-    mpz_clear(qh);
-    mpz_clear(tmp);
-    Py_XDECREF((PyObject*)p);
-    Py_XDECREF((PyObject*)q);
-    Py_XDECREF((PyObject*)n);
-    return result;
-}
-
-/* *******************************************************************************************
- * mpz_extrastronglucas_prp:
- * Let U_n = LucasU(p,1), V_n = LucasV(p,1), and D=p^2-4.
- * An "extra strong Lucas probable prime" to the base p is a composite n = (2^r)*s+(D/n), where
- * s is odd and (n,2D)=1, such that either U_s == 0 mod n or V_s == +/-2 mod n, or
- * V_((2^t)*s) == 0 mod n for some t with 0 <= t < r-1 [(D/n) is the Jacobi symbol]
- * *******************************************************************************************/
+    for (j = 1; !result && j < r; j++) {
+        /* vl = vl*vl - 2*ql */
+        _GMPy_Mont_Mul(&mont, vl, vl, vl, w);
+        _GMPy_Mont_Add(&mont, tmp, ql, ql);
+        _GMPy_Mont_Sub(&mont, vl, vl, tmp);
 
-PyDoc_STRVAR(doc_mpz_is_extrastronglucas_prp,
-"is_extra_strong_lucas_prp(n,p,/) -> bool\n\n"
-"Return `True` if n is an extra strong Lucas probable prime with parameters\n"
-"(p,1). Assuming:\n\n"
-"    n is odd\n"
-"    D = p*p - 4, D != 0\n"
-"    gcd(n, 2*D) == 1\n"
-"    n = s*(2**r) + Jacobi(D,n), s odd\n\n"
-"Then an extra strong Lucas probable prime requires:\n\n"
-"    lucasu(p,1,s) == 0 (mod n)\n"
-"    or\n"
-"    lucasv(p,1,s) == +/-2 (mod n)\n"
-"    or\n"
-"    lucasv(p,1,s*(2**t)) == 0 (mod n) for some t, 0 <= t < r");
-
-static PyObject *
-GMPY_mpz_is_extrastronglucas_prp(PyObject *self, PyObject *args)
-{
-    MPZ_Object *n = NULL, *p = NULL;
-    PyObject *result = NULL;
-    mpz_t zD, s, nmj, nm2, res;
-    /* these are needed for the LucasU and LucasV part of this function */
-    mpz_t uh, vl, vh, ql, qh, tmp;
-    mp_bitcnt_t r = 0, j = 0;
-    int ret = 0;
-
-    if (PyTuple_Size(args) != 2) {
-        TYPE_ERROR("is_extra_strong_lucas_prp() requires 2 integer arguments");
-        return NULL;
-    }
-
-    mpz_init(zD);
-    mpz_init(s);
-    mpz_init(nmj);
-    mpz_init(nm2);
-    mpz_init(res);
-    mpz_init(uh);
-    mpz_init(vl);
-    mpz_init(vh);
-    mpz_init(ql);
-    mpz_init(qh);
-    mpz_init(tmp);
-
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    p = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
-    if (!n || !p) {
-        TYPE_ERROR("is_extra_strong_lucas_prp() requires 2 integer arguments");
-        goto cleanup;
-    }
-
-    /* Check if p*p - 4 == 0. */
-    mpz_mul(zD, p->z, p->z);
-    mpz_sub_ui(zD, zD, 4);
-    if (mpz_sgn(zD) == 0) {
-        VALUE_ERROR("invalid value for p in is_extra_strong_lucas_prp()");
-        goto cleanup;
-    }
-
-    /* Require n > 0. */
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("is_extra_strong_lucas_prp() requires 'n' be greater than 0");
-        goto cleanup;
-    }
-
-    /* Check for n == 1 */
-    if (mpz_cmp_ui(n->z, 1) == 0) {
-        result = Py_False;
-        goto cleanup;
-    }
-
-    /* Handle n even. */
-    if (mpz_divisible_ui_p(n->z, 2)) {
-        if (mpz_cmp_ui(n->z, 2) == 0)
-            result = Py_True;
-        else
-            result = Py_False;
-        goto cleanup;
-    }
-
-    /* Check GCD */
-    mpz_mul_ui(res, zD, 2);
-    mpz_gcd(res, res, n->z);
-    if ((mpz_cmp(res, n->z) != 0) && (mpz_cmp_ui(res, 1) > 0)) {
-        VALUE_ERROR("is_extra_strong_lucas_prp() requires gcd(n,2*D) == 1");
-        goto cleanup;
-    }
-
-    /* nmj = n - (D/n), where (D/n) is the Jacobi symbol */
-    mpz_set(nmj, n->z);
-    ret = mpz_jacobi(zD, n->z);
-    if (ret == -1)
-        mpz_add_ui(nmj, nmj, 1);
-    else if (ret == 1)
-        mpz_sub_ui(nmj, nmj, 1);
+        /* ql = ql*ql */
+        _GMPy_Mont_Mul(&mont, ql, ql, ql, w);
 
-    r = mpz_scan1(nmj, 0);
-    mpz_fdiv_q_2exp(s, nmj, r);
+        result = mpn_zero_p(vl, sz);
+    }
 
-    mpz_set(nm2, n->z);
-    mpz_sub_ui(nm2, nm2, 2);
+    _GMPy_Scratch_Release(mark);
+    return result;
+}
+
+static int
+_GMPy_MPZ_Lucas_Strong_Check(mpz_srcptr n, mpz_srcptr p, mpz_srcptr q,
+                             mpz_srcptr s, mp_bitcnt_t r, int extra)
+{
+    int mark, result = 0;
+    size_t bits;
+    mpz_ptr uh, vl, vh, ql, qh, tmp;
+    mp_bitcnt_t j;
+
+    if (GMPY_MONT_OK(n))
+        return _GMPy_MPZ_Lucas_Strong_Check_Mont(n, p, q, s, r, extra);
+
+    mark = _GMPy_Scratch_Mark();
+    bits = GMPY_SCRATCH_MOD_BITS(n);
+    uh = _GMPy_Scratch_Get(bits);
+    vl = _GMPy_Scratch_Get(bits);
+    vh = _GMPy_Scratch_Get(bits);
+    ql = _GMPy_Scratch_Get(bits);
+    qh = _GMPy_Scratch_Get(bits);
+    tmp = _GMPy_Scratch_Get(bits);
 
-    /* make sure that either U_s == 0 mod n or V_s == +/-2 mod n, or */
-    /* V_((2^t)*s) == 0 mod n for some t with 0 <= t < r-1           */
     mpz_set_si(uh, 1);
     mpz_set_si(vl, 2);
-    mpz_set(vh, p->z);
+    mpz_set(vh, p);
     mpz_set_si(ql, 1);
     mpz_set_si(qh, 1);
-    mpz_set_si(tmp,0);
 
-    for (j = mpz_sizeinbase(s,2)-1; j >= 1; j--) {
+    for (j = mpz_sizeinbase(s,2)-1; j >= 1 && !GMPy_Interrupt_Poll(); j--) {
         /* ql = ql*qh (mod n) */
         mpz_mul(ql, ql, qh);
-        mpz_mod(ql, ql, n->z);
+        mpz_mod(ql, ql, n);
         if (mpz_tstbit(s,j) == 1) {
             /* qh = ql*q */
-            mpz_set(qh, ql);
+            mpz_mul(qh, ql, q);
 
             /* uh = uh*vh (mod n) */
             mpz_mul(uh, uh, vh);
-            mpz_mod(uh, uh, n->z);
+            mpz_mod(uh, uh, n);
 
             /* vl = vh*vl - p*ql (mod n) */
             mpz_mul(vl, vh, vl);
-            mpz_mul(tmp, ql, p->z);
+            mpz_mul(tmp, ql, p);
             mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
+            mpz_mod(vl, vl, n);
 
             /* vh = vh*vh - 2*qh (mod n) */
             mpz_mul(vh, vh, vh);
             mpz_mul_si(tmp, qh, 2);
             mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
+            mpz_mod(vh, vh, n);
         }
         else {
             /* qh = ql */
@@ -1099,26 +676,26 @@ GMPY_mpz_is_extrastronglucas_prp(PyObject *self, PyObject *args)
             /* uh = uh*vl - ql (mod n) */
             mpz_mul(uh, uh, vl);
             mpz_sub(uh, uh, ql);
-            mpz_mod(uh, uh, n->z);
+            mpz_mod(uh, uh, n);
 
             /* vh = vh*vl - p*ql (mod n) */
             mpz_mul(vh, vh, vl);
-            mpz_mul(tmp, ql, p->z);
+            mpz_mul(tmp, ql, p);
             mpz_sub(vh, vh, tmp);
-            mpz_mod(vh, vh, n->z);
+            mpz_mod(vh, vh, n);
 
             /* vl = vl*vl - 2*ql (mod n) */
             mpz_mul(vl, vl, vl);
             mpz_mul_si(tmp, ql, 2);
             mpz_sub(vl, vl, tmp);
-            mpz_mod(vl, vl, n->z);
+            mpz_mod(vl, vl, n);
         }
     }
     /* ql = ql*qh */
     mpz_mul(ql, ql, qh);
 
     /* qh = ql*q */
-    mpz_set(qh, ql);
+    mpz_mul(qh, ql, q);
 
     /* uh = uh*vl - ql */
     mpz_mul(uh, uh, vl);
@@ -1126,143 +703,229 @@ GMPY_mpz_is_extrastronglucas_prp(PyObject *self, PyObject *args)
 
     /* vl = vh*vl - p*ql */
     mpz_mul(vl, vh, vl);
-    mpz_mul(tmp, ql, p->z);
+    mpz_mul(tmp, ql, p);
     mpz_sub(vl, vl, tmp);
 
     /* ql = ql*qh */
     mpz_mul(ql, ql, qh);
 
-    mpz_mod(uh, uh, n->z);
-    mpz_mod(vl, vl, n->z);
+    mpz_mod(uh, uh, n);
+    mpz_mod(vl, vl, n);
 
     /* uh contains LucasU_s and vl contains LucasV_s */
-    if ((mpz_cmp_ui(uh, 0) == 0) || (mpz_cmp_ui(vl, 0) == 0) ||
-        (mpz_cmp(vl, nm2) == 0) || (mpz_cmp_si(vl, 2) == 0)) {
-        result = Py_True;
-        goto cleanup;
+    if ((mpz_cmp_ui(uh, 0) == 0) || (mpz_cmp_ui(vl, 0) == 0)) {
+        result = 1;
+    }
+    if (extra && !result) {
+        mpz_sub_ui(tmp, n, 2);
+        result = (mpz_cmp(vl, tmp) == 0) || (mpz_cmp_si(vl, 2) == 0);
+        /* V_((2^t)*s) is only checked for t < r-1. */
+        r--;
     }
 
-    for (j = 1; j < r-1; j++) {
+    for (j = 1; !result && j < r && !GMPy_Interrupt_Poll(); j++) {
         /* vl = vl*vl - 2*ql (mod n) */
         mpz_mul(vl, vl, vl);
         mpz_mul_si(tmp, ql, 2);
         mpz_sub(vl, vl, tmp);
-        mpz_mod(vl, vl, n->z);
+        mpz_mod(vl, vl, n);
 
         /* ql = ql*ql (mod n) */
         mpz_mul(ql, ql, ql);
-        mpz_mod(ql, ql, n->z);
+        mpz_mod(ql, ql, n);
 
         if (mpz_cmp_ui(vl, 0) == 0) {
-            result = Py_True;
-            goto cleanup;
+            result = 1;
         }
     }
 
-    result = Py_False;
-  cleanup:
-    Py_XINCREF(result);
-    mpz_clear(zD);
-    mpz_clear(s);
-    mpz_clear(nmj);
-    mpz_clear(nm2);
-    mpz_clear(res);
-    mpz_clear(uh);
-    mpz_clear(vl);
-    mpz_clear(vh);
-    mpz_clear(ql);
-    mpz_clear(qh);
-    mpz_clear(tmp);
-    Py_XDECREF((PyObject*)p);
-    Py_XDECREF((PyObject*)n);
+    _GMPy_Scratch_Release(mark);
     return result;
 }
 
-/* ***********************************************************************************************
- * mpz_selfridge_prp:
- * A "Lucas-Selfridge probable prime" n is a "Lucas probable prime" using Selfridge parameters of:
- * Find the first element D in the sequence {5, -7, 9, -11, 13, ...} such that Jacobi(D,n) = -1
- * Then use P=1 and Q=(1-D)/4 in the Lucas probable prime test.
- * Make sure n is not a perfect square, otherwise the search for D will only stop when D=n.
- * ***********************************************************************************************/
+/* Return 1 if the odd n > 1 is a strong Lucas probable prime with
+ * parameters (p,q) where D = p*p - 4*q. The caller checks gcd(n, 2*q*D).
+ * Does not use the Python API.
+ */
 
-PyDoc_STRVAR(doc_mpz_is_selfridge_prp,
-"is_selfridge_prp(n, /) -> bool\n\n"
-"Return `True` if n is a Lucas probable prime with Selfidge parameters\n"
-"(p,q). The Selfridge parameters are chosen by finding the first\n"
-"element D in the sequence {5, -7, 9, -11, 13, ...} such that\n"
-"Jacobi(D,n) == -1. Then let p=1 and q = (1-D)/4. Then perform\n"
-"a Lucas probable prime test.");
+static int
+_GMPy_MPZ_StrongLucas_PRP(mpz_srcptr n, mpz_srcptr p, mpz_srcptr q, mpz_srcptr D)
+{
+    int mark = _GMPy_Scratch_Mark(), ret, result;
+    mpz_ptr s = _GMPy_Scratch_Get(mpz_sizeinbase(n, 2) + 1);
+    mp_bitcnt_t r;
+
+    /* s = n - (D/n), where (D/n) is the Jacobi symbol */
+    mpz_set(s, n);
+    ret = mpz_jacobi(D, n);
+    if (ret == -1)
+        mpz_add_ui(s, s, 1);
+    else if (ret == 1)
+        mpz_sub_ui(s, s, 1);
+
+    r = mpz_scan1(s, 0);
+    mpz_fdiv_q_2exp(s, s, r);
+
+    /* make sure U_s == 0 mod n or V_((2^t)*s) == 0 mod n, for some t, 0 <= t < r */
+    result = _GMPy_MPZ_Lucas_Strong_Check(n, p, q, s, r, 0);
+
+    _GMPy_Scratch_Release(mark);
+    return result;
+}
 
 static PyObject *
-GMPY_mpz_is_selfridge_prp(PyObject *self, PyObject *args)
+GMPY_mpz_is_stronglucas_prp(PyObject *self, PyObject *args)
 {
-    MPZ_Object *n = NULL;
-    PyObject *result = NULL, *temp = NULL;
-    long d = 5, p = 1, q = 0, max_d = 1000000;
-    int jacobi = 0;
-    mpz_t zD;
+    return _GMPy_PRP_Lucas_Function(args, _GMPy_MPZ_StrongLucas_PRP, "is_strong_lucas_prp");
+}
+
+/* *******************************************************************************************
+ * mpz_extrastronglucas_prp:
+ * Let U_n = LucasU(p,1), V_n = LucasV(p,1), and D=p^2-4.
+ * An "extra strong Lucas probable prime" to the base p is a composite n = (2^r)*s+(D/n), where
+ * s is odd and (n,2D)=1, such that either U_s == 0 mod n or V_s == +/-2 mod n, or
+ * V_((2^t)*s) == 0 mod n for some t with 0 <= t < r-1 [(D/n) is the Jacobi symbol]
+ * *******************************************************************************************/
+
+PyDoc_STRVAR(doc_mpz_is_extrastronglucas_prp,
+"is_extra_strong_lucas_prp(n,p,/) -> bool\n\n"
+"Return `True` if n is an extra strong Lucas probable prime with parameters\n"
+"(p,1). Assuming:\n\n"
+"    n is odd\n"
+"    D = p*p - 4, D != 0\n"
+"    gcd(n, 2*D) == 1\n"
+"    n = s*(2**r) + Jacobi(D,n), s odd\n\n"
+"Then an extra strong Lucas probable prime requires:\n\n"
+"    lucasu(p,1,s) == 0 (mod n)\n"
+"    or\n"
+"    lucasv(p,1,s) == +/-2 (mod n)\n"
+"    or\n"
+"    lucasv(p,1,s*(2**t)) == 0 (mod n) for some t, 0 <= t < r");
 
-    if (PyTuple_Size(args) != 1) {
-        TYPE_ERROR("is_selfridge_prp() requires 1 integer argument");
+/* Return 1 if the odd n > 1 is an extra strong Lucas probable prime with
+ * parameters (p,1) where D = p*p - 4. The caller checks gcd(n, 2*D).
+ * Does not use the Python API.
+ */
+
+static int
+_GMPy_MPZ_ExtraStrongLucas_PRP(mpz_srcptr n, mpz_srcptr p, mpz_srcptr D)
+{
+    int mark = _GMPy_Scratch_Mark(), ret, result;
+    mpz_ptr s = _GMPy_Scratch_Get(mpz_sizeinbase(n, 2) + 1);
+    mpz_ptr one = _GMPy_Scratch_Get(1);
+    mp_bitcnt_t r;
+
+    /* s = n - (D/n), where (D/n) is the Jacobi symbol */
+    mpz_set(s, n);
+    ret = mpz_jacobi(D, n);
+    if (ret == -1)
+        mpz_add_ui(s, s, 1);
+    else if (ret == 1)
+        mpz_sub_ui(s, s, 1);
+
+    r = mpz_scan1(s, 0);
+    mpz_fdiv_q_2exp(s, s, r);
+
+    /* make sure that either U_s == 0 mod n or V_s == +/-2 mod n, or */
+    /* V_((2^t)*s) == 0 mod n for some t with 0 <= t < r-1           */
+    mpz_set_ui(one, 1);
+    result = _GMPy_MPZ_Lucas_Strong_Check(n, p, one, s, r, 1);
+
+    _GMPy_Scratch_Release(mark);
+    return result;
+}
+
+static PyObject *
+GMPY_mpz_is_extrastronglucas_prp(PyObject *self, PyObject *args)
+{
+    MPZ_Object *a[2];
+    gmpy_interrupt intr;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+    mpz_ptr D, t;
+    int mark, ret;
+
+    CHECK_CONTEXT(context);
+
+    if (_GMPy_MPZ_Args(args, 2, a, "is_extra_strong_lucas_prp") < 0)
         return NULL;
-    }
 
-    mpz_init(zD);
+    mark = _GMPy_Scratch_Mark();
+    D = _GMPy_Scratch_Get(0);
+    t = _GMPy_Scratch_Get(0);
 
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    if (!n) {
-        TYPE_ERROR("is_selfridge_prp() requires 1 integer argument");
+    /* Check if p*p - 4 == 0. */
+    mpz_mul(D, a[1]->z, a[1]->z);
+    mpz_sub_ui(D, D, 4);
+    if (mpz_sgn(D) == 0) {
+        VALUE_ERROR("invalid value for p in is_extra_strong_lucas_prp()");
         goto cleanup;
     }
 
     /* Require n > 0. */
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("is_selfridge_prp() requires 'n' be greater than 0");
+    if (mpz_sgn(a[0]->z) <= 0) {
+        VALUE_ERROR("is_extra_strong_lucas_prp() requires 'n' be greater than 0");
         goto cleanup;
     }
 
-    /* Check for n == 1 */
-    if (mpz_cmp_ui(n->z, 1) == 0) {
-        result = Py_False;
-        goto cleanup;
-    }
+    if ((ret = _GMPy_PRP_Trivial(a[0]->z)) < 0) {
+        /* Check GCD */
+        mpz_mul_ui(t, D, 2);
+        if (_GMPy_PRP_Common_Factor(a[0]->z, t)) {
+            VALUE_ERROR("is_extra_strong_lucas_prp() requires gcd(n,2*D) == 1");
+            goto cleanup;
+        }
 
-    /* Handle n even. */
-    if (mpz_divisible_ui_p(n->z, 2)) {
-        if (mpz_cmp_ui(n->z, 2) == 0)
-            result = Py_True;
-        else
-            result = Py_False;
-        goto cleanup;
+        GMPY_PROFILE_MPZ(context, GMPY_OP_PRP, a[0]->z);
+        GMPy_Interrupt_Begin(&intr, context);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context, GMPY_MPZ_BITS(a[0]->z));
+        intr.save = &_save;
+        ret = _GMPy_MPZ_ExtraStrongLucas_PRP(a[0]->z, a[1]->z, D);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        if (GMPy_Interrupt_End(&intr) < 0)
+            goto cleanup;
     }
+    result = ret ? Py_True : Py_False;
+    Py_INCREF(result);
+
+  cleanup:
+    _GMPy_Scratch_Release(mark);
+    _GMPy_MPZ_Args_Clear(a, 2);
+    return result;
+}
+
+/* Find the Selfridge parameter for the odd n > 1: the first element D of
+ * the sequence {5, -7, 9, -11, 13, ...} such that Jacobi(D,n) == -1. If it
+ * is found, D is stored in zD and 2 is returned. Otherwise the search
+ * decides the test: 1 if n is prime, 0 if n is composite, and -1 if no D
+ * was found. Does not use the Python API.
+ *
+ * Every prime factor of q = (1-D)/4 is smaller than |D| so it was already
+ * found by the Jacobi symbol test; gcd(n, 2*q*D) == 1 if D is found.
+ */
+
+static int
+_GMPy_MPZ_Selfridge_D(mpz_ptr zD, mpz_srcptr n)
+{
+    long d = 5, max_d = 1000000;
+    int jacobi = 0;
 
     mpz_set_ui(zD, d);
 
     while (1) {
-        jacobi = mpz_jacobi(zD, n->z);
+        jacobi = mpz_jacobi(zD, n);
 
         /* if jacobi == 0, d is a factor of n, therefore n is composite... */
         /* if d == n, then either n is either prime or 9... */
-        if (jacobi == 0) {
-            if ((mpz_cmpabs(zD, n->z) == 0) && (mpz_cmp_ui(zD, 9) != 0)) {
-                result = Py_True;
-                goto cleanup;
-            }
-            else {
-                result = Py_False;
-                goto cleanup;
-            }
-        }
+        if (jacobi == 0)
+            return (mpz_cmpabs(zD, n) == 0) && (mpz_cmp_ui(zD, 9) != 0);
         if (jacobi == -1)
-            break;
+            return 2;
 
         /* if we get to the 5th d, make sure we aren't dealing with a square... */
         if (d == 13) {
-            if (mpz_perfect_square_p(n->z)) {
-                result = Py_False;
-                goto cleanup;
-            }
+            if (mpz_perfect_square_p(n))
+                return 0;
         }
 
         if (d < 0) {
@@ -1275,34 +938,67 @@ GMPY_mpz_is_selfridge_prp(PyObject *self, PyObject *args)
         }
 
         /* make sure we don't search forever */
-        if (d >= max_d) {
-            VALUE_ERROR("appropriate value for D cannot be found in is_selfridge_prp()");
-            goto cleanup;
-        }
+        if (d >= max_d)
+            return -1;
 
         mpz_set_si(zD, d);
     }
+}
 
-    q = (1-d)/4;
+/* Common code for the Selfridge tests; func is the Lucas test to use. */
 
-    /* Since "O" is used, the refcount for n is incremented so deleting
-     * temp will not delete n.
-     */
-    temp = Py_BuildValue("Oll", n, p, q);
-    if (!temp)
-        goto cleanup;
-    result = GMPY_mpz_is_lucas_prp(NULL, temp);
-    Py_DECREF(temp);
-    goto return_result;
+static int
+_GMPy_MPZ_Selfridge_Test(mpz_srcptr n, gmpy_prp_lucas_func func)
+{
+    int mark = _GMPy_Scratch_Mark(), result;
+    mpz_ptr zD = _GMPy_Scratch_Get(GMP_NUMB_BITS);
+    mpz_ptr p = _GMPy_Scratch_Get(GMP_NUMB_BITS);
+    mpz_ptr q = _GMPy_Scratch_Get(GMP_NUMB_BITS);
 
-  cleanup:
-    Py_XINCREF(result);
-  return_result:
-    mpz_clear(zD);
-    Py_DECREF((PyObject*)n);
+    if ((result = _GMPy_MPZ_Selfridge_D(zD, n)) == 2) {
+        mpz_set_si(p, 1);
+        mpz_set_si(q, (1 - mpz_get_si(zD)) / 4);
+        result = func(n, p, q, zD);
+    }
+
+    _GMPy_Scratch_Release(mark);
     return result;
 }
 
+/* ***********************************************************************************************
+ * mpz_selfridge_prp:
+ * A "Lucas-Selfridge probable prime" n is a "Lucas probable prime" using Selfridge parameters of:
+ * Find the first element D in the sequence {5, -7, 9, -11, 13, ...} such that Jacobi(D,n) = -1
+ * Then use P=1 and Q=(1-D)/4 in the Lucas probable prime test.
+ * Make sure n is not a perfect square, otherwise the search for D will only stop when D=n.
+ * ***********************************************************************************************/
+
+PyDoc_STRVAR(doc_mpz_is_selfridge_prp,
+"is_selfridge_prp(n, /) -> bool\n\n"
+"Return `True` if n is a Lucas probable prime with Selfidge parameters\n"
+"(p,q). The Selfridge parameters are chosen by finding the first\n"
+"element D in the sequence {5, -7, 9, -11, 13, ...} such that\n"
+"Jacobi(D,n) == -1. Then let p=1 and q = (1-D)/4. Then perform\n"
+"a Lucas probable prime test.");
+
+/* Return 1 if the odd n > 1 is a Lucas probable prime with Selfridge
+ * parameters, 0 if not, and -1 if no D was found. Does not use the
+ * Python API.
+ */
+
+static int
+_GMPy_MPZ_Selfridge_PRP(mpz_srcptr n)
+{
+    return _GMPy_MPZ_Selfridge_Test(n, _GMPy_MPZ_Lucas_PRP);
+}
+
+static PyObject *
+GMPY_mpz_is_selfridge_prp(PyObject *self, PyObject *args)
+{
+    return _GMPy_PRP_Single_Function(args, _GMPy_MPZ_Selfridge_PRP,
+                                     "is_selfridge_prp", "is_selfridge_prp");
+}
+
 /* *********************************************************************************************************
  * mpz_strongselfridge_prp:
  * A "strong Lucas-Selfridge probable prime" n is a "strong Lucas probable prime" using Selfridge parameters of:
@@ -1319,114 +1015,23 @@ PyDoc_STRVAR(doc_mpz_is_strongselfridge_prp,
 "that Jacobi(D,n) == -1. Then let p=1 and q = (1-D)/4. Then perform\n"
 "a strong Lucas probable prime test.");
 
+/* Return 1 if the odd n > 1 is a strong Lucas probable prime with
+ * Selfridge parameters, 0 if not, and -1 if no D was found. Does not use
+ * the Python API.
+ */
+
+static int
+_GMPy_MPZ_StrongSelfridge_PRP(mpz_srcptr n)
+{
+    return _GMPy_MPZ_Selfridge_Test(n, _GMPy_MPZ_StrongLucas_PRP);
+}
+
 static PyObject *
 GMPY_mpz_is_strongselfridge_prp(PyObject *self, PyObject *args)
 {
-    MPZ_Object *n = NULL;
-    PyObject *result = NULL, *temp = NULL;
-    long d = 5, p = 1, q = 0, max_d = 1000000;
-    int jacobi = 0;
-    mpz_t zD;
-
-    if (PyTuple_Size(args) != 1) {
-        TYPE_ERROR("is_strong_selfridge_prp() requires 1 integer argument");
-        return NULL;
-    }
-
-    mpz_init(zD);
-
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    if (!n) {
-        TYPE_ERROR("is_strong_selfridge_prp() requires 1 integer argument");
-        goto cleanup;
-    }
-
-    /* Require n > 0. */
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("is_strong_selfridge_prp() requires 'n' be greater than 0");
-        goto cleanup;
-    }
-
-    /* Check for n == 1 */
-    if (mpz_cmp_ui(n->z, 1) == 0) {
-        result = Py_False;
-        goto cleanup;
-    }
-
-    /* Handle n even. */
-    if (mpz_divisible_ui_p(n->z, 2)) {
-        if (mpz_cmp_ui(n->z, 2) == 0)
-            result = Py_True;
-        else
-            result = Py_False;
-        goto cleanup;
-    }
-
-
-    mpz_set_ui(zD, d);
-
-    while (1) {
-        jacobi = mpz_jacobi(zD, n->z);
-
-        /* if jacobi == 0, d is a factor of n, therefore n is composite... */
-        /* if d == n, then either n is either prime or 9... */
-        if (jacobi == 0) {
-            if ((mpz_cmpabs(zD, n->z) == 0) && (mpz_cmp_ui(zD, 9) != 0)) {
-                result = Py_True;
-                goto cleanup;
-            }
-            else {
-                result = Py_False;
-                goto cleanup;
-            }
-        }
-        if (jacobi == -1)
-            break;
-
-        /* if we get to the 5th d, make sure we aren't dealing with a square... */
-        if (d == 13) {
-            if (mpz_perfect_square_p(n->z)) {
-                result = Py_False;
-                goto cleanup;
-            }
-        }
-
-        if (d < 0) {
-            d *= -1;
-            d += 2;
-        }
-        else {
-            d += 2;
-            d *= -1;
-        }
-
-        /* make sure we don't search forever */
-        if (d >= max_d) {
-            VALUE_ERROR("appropriate value for D cannot be found in is_strong_selfridge_prp()");
-            goto cleanup;
-        }
-
-        mpz_set_si(zD, d);
-    }
-
-    q = (1-d)/4;
-
-    /* Since "O" is used, the refcount for n is incremented so deleting
-     * temp will not delete n.
-     */
-    temp = Py_BuildValue("Oll", n, p, q);
-    if (!temp)
-        goto cleanup;
-    result = GMPY_mpz_is_stronglucas_prp(NULL, temp);
-    Py_DECREF(temp);
-    goto return_result;
-
-  cleanup:
-    Py_XINCREF(result);
-  return_result:
-    mpz_clear(zD);
-    Py_DECREF((PyObject*)n);
-    return result;
+    return _GMPy_PRP_Single_Function(args, _GMPy_MPZ_StrongSelfridge_PRP,
+                                     "is_strong_selfridge_prp",
+                                     "is_strong_selfridge_prp");
 }
 
 /* **********************************************************************************
@@ -1442,71 +1047,36 @@ PyDoc_STRVAR(doc_mpz_is_bpsw_prp,
 "prime. A BPSW probable prime passes the `is_strong_prp()` test with base\n"
 "2 and the `is_selfridge_prp()` test.\n");
 
-static PyObject *
-GMPY_mpz_is_bpsw_prp(PyObject *self, PyObject *args)
-{
-    MPZ_Object *n = NULL;
-    PyObject *result = NULL, *temp = NULL;
-
-    if (PyTuple_Size(args) != 1) {
-        TYPE_ERROR("is_bpsw_prp() requires 1 integer argument");
-        return NULL;
-    }
-
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    if (!n) {
-        TYPE_ERROR("is_bpsw_prp() requires 1 integer argument");
-        goto cleanup;
-    }
-
-    /* Require n > 0. */
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("is_bpsw_prp() requires 'n' be greater than 0");
-        goto cleanup;
-    }
+/* Return 1 if n > 0 is a BPSW probable prime, 0 if not, and -1 if no
+ * Selfridge parameter was found. Does not use the Python API.
+ */
 
-    /* Check for n == 1 */
-    if (mpz_cmp_ui(n->z, 1) == 0) {
-        result = Py_False;
-        goto cleanup;
-    }
+static int
+_GMPy_MPZ_BPSW_PRP(mpz_srcptr n)
+{
+    int mark, result;
+    mpz_ptr two;
 
-    /* Handle n even. */
-    if (mpz_divisible_ui_p(n->z, 2)) {
-        if (mpz_cmp_ui(n->z, 2) == 0)
-            result = Py_True;
-        else
-            result = Py_False;
-        goto cleanup;
-    }
+    if ((result = _GMPy_PRP_Trivial(n)) >= 0)
+        return result;
 
-    /* "O" is used to increment the reference to n so deleting temp won't
-     * delete n.
-     */
-    temp = Py_BuildValue("Oi", n, 2);
-    if (!temp)
-        goto cleanup;
-    result = GMPY_mpz_is_strong_prp(NULL, temp);
-    Py_DECREF(temp);
-    if (result == Py_False)
-        goto return_result;
-    /* Remember to ignore the preceding result */
-    Py_DECREF(result);
-
-    temp = Py_BuildValue("(O)", n);
-    if (!temp)
-        goto cleanup;
-    result = GMPY_mpz_is_selfridge_prp(NULL, temp);
-    Py_DECREF(temp);
-    goto return_result;
+    mark = _GMPy_Scratch_Mark();
+    two = _GMPy_Scratch_Get(GMP_NUMB_BITS);
+    mpz_set_ui(two, 2);
+    result = _GMPy_MPZ_Strong_PRP(n, two);
+    _GMPy_Scratch_Release(mark);
+    if (!result)
+        return 0;
 
-  cleanup:
-    Py_XINCREF(result);
-  return_result:
-    Py_DECREF((PyObject*)n);
-    return result;
+    return _GMPy_MPZ_Selfridge_PRP(n);
 }
 
+static PyObject *
+GMPY_mpz_is_bpsw_prp(PyObject *self, PyObject *args)
+{
+    return _GMPy_PRP_Single_Function(args, _GMPy_MPZ_BPSW_PRP,
+                                     "is_bpsw_prp", "is_selfridge_prp");
+}
 
 /* ****************************************************************************************
  * mpz_strongbpsw_prp:
@@ -1521,67 +1091,33 @@ PyDoc_STRVAR(doc_mpz_is_strongbpsw_prp,
 "probable prime. A strong BPSW probable prime passes the `is_strong_prp()`\n"
 "test with base and the `is_strong_selfridge_prp()` test.\n");
 
-static PyObject *
-GMPY_mpz_is_strongbpsw_prp(PyObject *self, PyObject *args)
-{
-    MPZ_Object *n = NULL;
-    PyObject *result = NULL, *temp = NULL;
-
-    if (PyTuple_Size(args) != 1) {
-        TYPE_ERROR("is_strong_bpsw_prp() requires 1 integer argument");
-        return NULL;
-    }
-
-    n = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
-    if (!n) {
-        TYPE_ERROR("is_strong_bpsw_prp() requires 1 integer argument");
-        goto cleanup;
-    }
+/* Return 1 if n > 0 is a strong BPSW probable prime, 0 if not, and -1 if
+ * no Selfridge parameter was found. Does not use the Python API.
+ */
 
-    /* Require n > 0. */
-    if (mpz_sgn(n->z) <= 0) {
-        VALUE_ERROR("is_strong_bpsw_prp() requires 'n' be greater than 0");
-        goto cleanup;
-    }
+static int
+_GMPy_MPZ_StrongBPSW_PRP(mpz_srcptr n)
+{
+    int mark, result;
+    mpz_ptr two;
 
-    /* Check for n == 1 */
-    if (mpz_cmp_ui(n->z, 1) == 0) {
-        result = Py_False;
-        goto cleanup;
-    }
+    if ((result = _GMPy_PRP_Trivial(n)) >= 0)
+        return result;
 
-    /* Handle n even. */
-    if (mpz_divisible_ui_p(n->z, 2)) {
-        if (mpz_cmp_ui(n->z, 2) == 0)
-            result = Py_True;
-        else
-            result = Py_False;
-        goto cleanup;
-    }
+    mark = _GMPy_Scratch_Mark();
+    two = _GMPy_Scratch_Get(GMP_NUMB_BITS);
+    mpz_set_ui(two, 2);
+    result = _GMPy_MPZ_Strong_PRP(n, two);
+    _GMPy_Scratch_Release(mark);
+    if (!result)
+        return 0;
 
-    /* "O" is used to increment the reference to n so deleting temp won't
-     * delete n.
-     */
-    temp = Py_BuildValue("Oi", n, 2);
-    if (!temp)
-        goto cleanup;
-    result = GMPY_mpz_is_strong_prp(NULL, temp);
-    Py_DECREF(temp);
-    if (result == Py_False)
-        goto return_result;
-    /* Remember to ignore the preceding result */
-    Py_DECREF(result);
-
-    temp = Py_BuildValue("(O)", n);
-    if (!temp)
-        goto cleanup;
-    result = GMPY_mpz_is_strongselfridge_prp(NULL, temp);
-    Py_DECREF(temp);
-    goto return_result;
+    return _GMPy_MPZ_StrongSelfridge_PRP(n);
+}
 
-  cleanup:
-    Py_XINCREF(result);
-  return_result:
-    Py_DECREF((PyObject*)n);
-    return result;
+static PyObject *
+GMPY_mpz_is_strongbpsw_prp(PyObject *self, PyObject *args)
+{
+    return _GMPy_PRP_Single_Function(args, _GMPy_MPZ_StrongBPSW_PRP,
+                                     "is_strong_bpsw_prp", "is_strong_selfridge_prp");
 }
@@ -29,6 +29,20 @@
 extern "C" {
 #endif
 
+/* Context-free cores; they do not use the Python API. */
+
+static int _GMPy_MPZ_Fermat_PRP(mpz_srcptr n, mpz_srcptr a);
+static int _GMPy_MPZ_Euler_PRP(mpz_srcptr n, mpz_srcptr a);
+static int _GMPy_MPZ_Strong_PRP(mpz_srcptr n, mpz_srcptr a);
+static int _GMPy_MPZ_Fibonacci_PRP(mpz_srcptr n, mpz_srcptr p, mpz_srcptr q);
+static int _GMPy_MPZ_Lucas_PRP(mpz_srcptr n, mpz_srcptr p, mpz_srcptr q, mpz_srcptr D);
+static int _GMPy_MPZ_StrongLucas_PRP(mpz_srcptr n, mpz_srcptr p, mpz_srcptr q, mpz_srcptr D);
+static int _GMPy_MPZ_ExtraStrongLucas_PRP(mpz_srcptr n, mpz_srcptr p, mpz_srcptr D);
+static int _GMPy_MPZ_Selfridge_PRP(mpz_srcptr n);
+static int _GMPy_MPZ_StrongSelfridge_PRP(mpz_srcptr n);
+static int _GMPy_MPZ_BPSW_PRP(mpz_srcptr n);
+static int _GMPy_MPZ_StrongBPSW_PRP(mpz_srcptr n);
+
 static PyObject * GMPY_mpz_is_fermat_prp(PyObject *self, PyObject *args);
 static PyObject * GMPY_mpz_is_euler_prp(PyObject *self, PyObject *args);
 static PyObject * GMPY_mpz_is_strong_prp(PyObject *self, PyObject *args);
@@ -0,0 +1,138 @@
+"""Concurrency stress tests.
+
+They pass with the GIL as well, but are meant for a free-threaded build,
+where gmpy2 is imported without enabling the GIL.
+"""
+
+import sys
+import sysconfig
+import threading
+
+import gmpy2
+from gmpy2 import mpc, mpfr, mpq, mpz, xmpz
+
+NTHREADS = 8
+
+
+def run_threads(func, n=NTHREADS):
+    barrier = threading.Barrier(n)
+    errors = []
+
+    def target(i):
+        barrier.wait()
+        try:
+            func(i)
+        except BaseException as e:
+            errors.append(e)
+
+    threads = [threading.Thread(target=target, args=(i,)) for i in range(n)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    if errors:
+        raise errors[0]
+
+
+def test_gil_not_enabled():
+    if not sysconfig.get_config_var("Py_GIL_DISABLED"):
+        return
+    assert not sys._is_gil_enabled()
+
+
+def test_shared_xmpz_inplace():
+    x = xmpz(0)
+    big = mpz(1) << 2000
+
+    def work(i):
+        nonlocal x
+        for _ in range(2000):
+            x += 1
+            x += big
+            x -= big
+
+    run_threads(work)
+    assert x == NTHREADS * 2000
+
+
+def test_shared_xmpz_pairs():
+    # Threads update x from y and y from x. The operand locks are taken in
+    # a fixed order; the values depend on the interleaving, so only the
+    # absence of deadlocks and crashes is checked.
+    x = xmpz(1)
+    y = xmpz(1)
+
+    def work(i):
+        nonlocal x, y
+        for _ in range(1000):
+            if i % 2:
+                x += y
+                x -= y
+            else:
+                y += x
+                y -= x
+
+    run_threads(work)
+    assert isinstance(x, xmpz) and isinstance(y, xmpz)
+
+
+def test_shared_xmpz_bits():
+    x = xmpz(0)
+
+    def work(i):
+        for j in range(200):
+            x[i * 200 + j] = 1
+
+    run_threads(work)
+    assert gmpy2.popcount(x) == NTHREADS * 200
+
+
+def test_hash():
+    values = [mpz(7)**200, mpq(3, 7)**50, mpfr(1) / 3, mpc(1, 2) / 3]
+    expected = [hash(v) for v in values]
+    fresh = [v + 0 for v in values]
+
+    def work(i):
+        for _ in range(500):
+            assert [hash(v) for v in fresh] == expected
+
+    run_threads(work)
+
+
+def test_context_per_thread():
+    def work(i):
+        with gmpy2.local_context() as ctx:
+            ctx.precision = 100 + i
+            for _ in range(200):
+                assert gmpy2.get_context().precision == 100 + i
+                assert (mpfr(1) / 3).precision == 100 + i
+
+    run_threads(work)
+    assert gmpy2.get_context().precision == 53
+
+
+def test_cache_churn():
+    def work(i):
+        total = mpz(0)
+        for j in range(5000):
+            a = mpz(j) * (i + 1)
+            b = mpq(j, i + 1)
+            total += a + mpz(b)
+        assert total > 0
+
+    before = gmpy2.memory_info()['mpz']['live']
+    run_threads(work)
+    assert gmpy2.memory_info()['mpz']['live'] <= before + NTHREADS * 4
+
+
+def test_mixed_functions():
+    n = mpz(2)**127 - 1
+
+    def work(i):
+        for _ in range(50):
+            assert gmpy2.is_prime(n)
+            assert gmpy2.powmod(3, n - 1, n) == 1
+            assert gmpy2.isqrt(n * n) == n
+            assert str(n) == "170141183460469231731687303715884105727"
+
+    run_threads(work)
@@ -1,7 +1,10 @@
 import pytest
 
+import gmpy2
 from gmpy2 import (root, rootn, zero, mpz, mpq, mpfr, mpc, is_nan, maxnum,
-                   minnum)
+                   minnum, vmap, xmpz, vadd, vsub, vmul, vdiv, vmod, dot,
+                   isum, mpz_array, polyval, polyval_many, matmul, det,
+                   solve, lll)
 
 
 def test_root():
@@ -64,3 +67,283 @@ def test_minnum():
     assert minnum(minf, a) == mpfr('-inf')
     assert minnum(nan, inf) == mpfr('inf')
     assert is_nan(minnum(nan, nan))
+
+
+def test_vmap():
+    xs = [mpfr(i)/7 for i in range(1, 10)] + [1, 2.5, mpq(1, 3), mpz(5)]
+    for f in (gmpy2.sin, gmpy2.exp, gmpy2.gamma, gmpy2.sqrt, gmpy2.rint):
+        assert vmap(f, xs) == [f(x) for x in xs]
+    assert vmap(gmpy2.sin, iter(xs)) == [gmpy2.sin(x) for x in xs]
+    assert vmap(gmpy2.sin, []) == []
+
+    ctx = gmpy2.context(precision=100)
+    result = ctx.vector(gmpy2.log, xs)
+    assert result == [ctx.log(x) for x in xs]
+    assert all(r.precision == 100 for r in result)
+    assert vmap(ctx.log, xs) == result
+    assert ctx.vector(lambda x: x/3, [mpfr(1)])[0].precision == 100
+
+    cs = [mpc(1, 2), mpc(3, -1), 1j]
+    assert vmap(gmpy2.exp, cs) == [gmpy2.exp(c) for c in cs]
+    assert vmap(gmpy2.sin, [1, 1j]) == [gmpy2.sin(1), gmpy2.sin(1j)]
+    with gmpy2.local_context(allow_complex=True):
+        assert vmap(gmpy2.sqrt, [-4, 4]) == [mpc(0, 2), mpfr(2)]
+
+    ctx = gmpy2.context()
+    ctx.vector(gmpy2.log, [1, 0])
+    assert ctx.divzero
+    ctx.trap_divzero = True
+    with pytest.raises(gmpy2.DivisionByZeroError):
+        ctx.vector(gmpy2.log, [1, 0])
+    with pytest.raises(TypeError):
+        vmap(gmpy2.sin, ['a'])
+    with pytest.raises(TypeError):
+        vmap(gmpy2.sin, 1)
+
+
+def test_vector_arithmetic():
+    funcs = ((vadd, gmpy2.add), (vsub, gmpy2.sub), (vmul, gmpy2.mul),
+             (vdiv, gmpy2.div), (vmod, gmpy2.mod))
+    ints = [mpz(3), 5, xmpz(7), -11]
+    cases = [(ints, [2, mpz(3), 4, xmpz(5)]), (ints, mpz(3)), (7, ints),
+             ([mpq(1, 3), mpq(2, 5)], [mpq(3, 7), 2]),
+             ([mpfr(1.5), 2.5], [3, mpq(1, 3)]),
+             ([1, mpq(1, 2), 1.5], [2, 3, 4]), ([], [])]
+    for vf, f in funcs:
+        for x, y in cases:
+            xs = x if isinstance(x, list) else [x] * len(y)
+            ys = y if isinstance(y, list) else [y] * len(xs)
+            result = vf(x, y)
+            expected = [f(a, b) for a, b in zip(xs, ys)]
+            assert result == expected
+            assert list(map(type, result)) == list(map(type, expected))
+
+    ctx = gmpy2.context(precision=10)
+    with gmpy2.local_context(ctx):
+        expected = [mpfr(1)/3]
+    assert ctx.vdiv([1], [mpfr(3)]) == expected
+    assert ctx.vdiv([1], [mpfr(3)])[0].precision == 10
+    assert vmul((mpz(2), mpz(3)), 10**30) == [2*10**30, 3*10**30]
+
+    with pytest.raises(ZeroDivisionError):
+        vmod([1, 2], [1, 0])
+    with pytest.raises(ZeroDivisionError):
+        vdiv([mpq(1)], [0])
+    assert vdiv([mpfr(1)], [0]) == [mpfr('inf')]
+    ctx = gmpy2.context(trap_divzero=True)
+    with pytest.raises(gmpy2.DivisionByZeroError):
+        ctx.vdiv([mpfr(1)], [0])
+    with pytest.raises(ValueError):
+        vadd([1], [1, 2])
+    with pytest.raises(TypeError):
+        vadd(1, 2)
+    with pytest.raises(TypeError):
+        vadd(['a'], [1])
+
+
+def test_dot_isum():
+    from fractions import Fraction
+
+    xs = [3**i - 7**(i // 2) for i in range(60)]
+    ys = [mpz(-5)**i + 1 for i in range(60)]
+    assert isum(xs) == sum(xs)
+    assert type(isum(xs)) is mpz
+    assert isum(iter(xs)) == sum(xs)
+    assert dot(xs, ys) == sum(a*b for a, b in zip(xs, ys))
+    assert dot(ys, ys) == sum(a*a for a in ys)
+    assert dot(mpz_array(xs), ys) == dot(xs, ys)
+    assert isum([]) == 0 and dot([], []) == 0
+    assert isum([xmpz(2), 3, mpz(4)]) == 9
+
+    qs = [mpq(i - 20, i % 7 + 1) for i in range(40)]
+    assert isum(qs) == sum(qs, mpq(0))
+    assert isum(qs + [Fraction(1, 3), 2]) == sum(qs, mpq(0)) + mpq(7, 3)
+    assert dot(qs, xs[:40]) == sum((a*b for a, b in zip(qs, xs)), mpq(0))
+    assert dot(qs, qs) == sum((a*a for a in qs), mpq(0))
+    assert isum([mpq(1, 2), mpq(1, 2)]) == 1
+    assert type(isum([mpq(1, 2), mpq(1, 2)])) is mpq
+
+    with pytest.raises(TypeError):
+        isum([1.5])
+    with pytest.raises(TypeError):
+        dot([1], ['a'])
+    with pytest.raises(TypeError):
+        isum(5)
+    with pytest.raises(ValueError):
+        dot([1], [1, 2])
+
+
+def test_polyval():
+    from fractions import Fraction
+
+    def horner(cs, x):
+        r = 0
+        for c in cs:
+            r = r * x + c
+        return r
+
+    cs = [3, -2, mpz(5), xmpz(7)]
+    assert polyval(cs, 2) == horner(cs, 2)
+    assert type(polyval(cs, 2)) is mpz
+    big = [(-1)**i * 3**i for i in range(40)]
+    xs = [0, 1, -1, 7, -(10**25), mpz(2)**70]
+    assert polyval_many(big, xs) == [horner(big, x) for x in xs]
+    assert polyval_many(big[:20], xs) == [horner(big[:20], x) for x in xs]
+    assert polyval_many(cs, []) == []
+    assert polyval([], 5) == 0
+    assert polyval([mpq(1, 2), Fraction(1, 3)], 3) == mpq(11, 6)
+    assert type(polyval([1, 2], mpq(1, 3))) is mpq
+
+    assert polyval([1, 0, -2], mpfr(1.5)) == mpfr(0.25)
+    assert polyval([mpfr(1), 2], 1.5) == mpfr(3.5)
+    ctx = gmpy2.context(precision=20)
+    r = ctx.polyval([1, 1, 1], mpfr('0.1'))
+    assert r.precision == 20
+    with gmpy2.local_context(ctx):
+        assert r == mpfr('0.1') * mpfr('0.1') + mpfr('0.1') + 1
+    assert ctx.polyval_many([1, 1], [1, 2]) == [2, 3]
+
+    assert polyval([1, 0, 1], 1j) == mpc(0)
+    assert polyval([mpc(1, 1), 2], 2) == mpc(4, 2)
+    assert polyval_many([1, 1], [mpfr(1), 2j]) == [mpc(2), mpc(1, 2)]
+
+    ctx = gmpy2.context(trap_overflow=True)
+    with pytest.raises(gmpy2.OverflowResultError):
+        ctx.polyval([mpfr(1), 0, 0], mpfr('1e200000000'))
+    with pytest.raises(TypeError):
+        polyval([1, 'a'], 2)
+    with pytest.raises(TypeError):
+        polyval_many([1], 2)
+    with pytest.raises(TypeError):
+        polyval([1])
+
+
+def test_matrix():
+    import random
+
+    def mm(a, b):
+        return [[sum((a[i][k] * b[k][j] for k in range(len(b))), 0)
+                 for j in range(len(b[0]))] for i in range(len(a))]
+
+    r = random.Random(7)
+    for n in (1, 2, 5, 20, 33):
+        a = [[r.randrange(-10**r.randrange(1, 30), 10**5) for _ in range(n)]
+             for _ in range(n)]
+        q = [[mpq(r.randrange(-50, 50), r.randrange(1, 20)) for _ in range(n)]
+             for _ in range(n)]
+        v = [r.randrange(-9, 9) for _ in range(n)]
+        assert matmul(a, q) == mm(a, q)
+        assert matmul(q, q) == mm(q, q)
+        for m in (a, q):
+            d = det(m)
+            if d == 0:
+                continue
+            x = solve(m, v)
+            assert all(type(t) is mpq for t in x)
+            assert mm(m, [[t] for t in x]) == [[t] for t in v]
+            # Scaling a row scales the determinant.
+            assert det([[3 * t for t in m[0]]] + m[1:]) == 3 * d
+            assert det(m[1:2] + m[:1] + m[2:]) == (d if n == 1 else -d)
+
+    assert det([[1, 2], [3, 4]]) == -2 and type(det([[1, 2], [3, 4]])) is mpz
+    assert det([[mpq(1, 2), 2], [3, 4]]) == -4
+    assert type(det([[mpq(1, 2), 2], [3, 4]])) is mpq
+    assert det([[0, 1], [1, 0]]) == -1
+    assert det([[1, 2], [2, 4]]) == 0
+    assert det([]) == 1
+    assert matmul([[1, 2]], [[3], [4]]) == [[11]]
+    assert matmul([], [[1]]) == []
+    assert matmul([[mpfr(1.5), 2]], [[2], [mpq(1, 3)]]) == [[mpfr(1.5) * 2 + mpfr(2) / 3]]
+
+    x = mpz_array(range(9))
+    e = mpz_array([1, 0, 0, 0, 1, 0, 0, 0, 1])
+    assert isinstance(matmul(x, e), mpz_array)
+    assert list(matmul(x, e)) == list(range(9))
+    assert matmul(x, [[1, 0, 0], [0, 1, 0], [0, 0, 1]]) == [[0, 1, 2], [3, 4, 5], [6, 7, 8]]
+    assert det(x) == 0
+    assert solve(e, mpz_array([4, 5, 6])) == [4, 5, 6]
+
+    assert det([[2.0, 1], [1, 3]]) == mpfr(5)
+    assert solve([[2.0, 0], [0, 4]], [1, 1]) == [mpfr(0.5), mpfr(0.25)]
+    with gmpy2.local_context(precision=10):
+        assert solve([[3.0]], [1])[0].precision == 10
+        assert det([[mpfr(1) / 3, 1], [1, 1]]) == mpfr(1) / 3 - 1
+
+    with pytest.raises(ZeroDivisionError):
+        solve([[1, 2], [2, 4]], [1, 2])
+    with pytest.raises(ZeroDivisionError):
+        solve([[1.0, 2], [2, 4]], [1, 2])
+    with pytest.raises(ValueError):
+        det([[1, 2]])
+    with pytest.raises(ValueError):
+        det([[1, 2], [3]])
+    with pytest.raises(ValueError):
+        det(mpz_array(3))
+    with pytest.raises(ValueError):
+        matmul([[1]], [[1], [2]])
+    with pytest.raises(ValueError):
+        solve([[1]], [1, 2])
+    with pytest.raises(TypeError):
+        det([[1, 'a'], [1, 2]])
+    with pytest.raises(TypeError):
+        det([[1j]])
+    with pytest.raises(TypeError):
+        det([1, 2])
+
+
+def test_lll():
+    import random
+
+    def gram(b):
+        return [[sum((x * y for x, y in zip(u, v)), 0) for v in b] for u in b]
+
+    def check(b, r, delta, eta=mpq(1, 2)):
+        assert det(gram(r)) == det(gram(b))
+        g = [list(map(mpq, u)) for u in r]
+        norm = []
+        for i in range(len(g)):
+            for j in range(i):
+                mu = sum((x * y for x, y in zip(r[i], g[j])), 0) / norm[j]
+                assert abs(mu) <= eta
+                g[i] = [x - mu * y for x, y in zip(g[i], g[j])]
+            norm.append(sum((x * x for x in g[i]), 0))
+            if i:
+                assert norm[i] >= (delta - mu * mu) * norm[i - 1]
+
+    assert lll([[1, 1, 1], [-1, 0, 2], [3, 5, 6]], delta=0.75) == [[0, 1, 0], [1, 0, 1], [-1, 0, 2]]
+    assert lll([[1, 2, 3]]) == [[1, 2, 3]]
+    assert lll([]) == []
+
+    r = random.Random(11)
+    for n, bits in ((2, 10), (5, 30), (10, 100), (16, 200)):
+        a = [r.getrandbits(bits) for _ in range(n)]
+        b = [[int(i == j) for j in range(n)] + [a[i]] for i in range(n)]
+        for exact in (True, False):
+            with gmpy2.local_context(precision=2 * bits + 53):
+                res = lll(b, exact=exact)
+            assert all(type(x) is mpz for u in res for x in u)
+            if exact:
+                check(b, res, mpq(99, 100))
+            else:
+                check(b, res, mpq(98, 100), mpq(51, 100))
+        check(b, lll(b, delta=mpq(1, 3)), mpq(1, 3))
+
+    q = [[mpq(1, 2), mpq(1, 3)], [mpq(5, 6), 1]]
+    res = lll(q)
+    assert all(type(x) is mpq for u in res for x in u)
+    check(q, res, mpq(99, 100))
+
+    x = lll(mpz_array([1, 1, 1, -1, 0, 2, 3, 5, 6]))
+    assert isinstance(x, mpz_array)
+    assert list(x) == [0, 1, 0, 1, 0, 1, -1, 0, 2]
+
+    with pytest.raises(ValueError):
+        lll([[1, 2], [2, 4]])
+    with pytest.raises(ValueError):
+        lll([[1, 2], [3, 4]], delta=0.2)
+    with pytest.raises(ValueError):
+        lll([[1, 2], [3, 4]], delta=1.5)
+    with pytest.raises(TypeError):
+        lll([[1.0, 2], [3, 4]])
+    with pytest.raises(TypeError):
+        lll([1, 2])
@@ -154,3 +154,40 @@ def test_add():
     assert mpc(1,2) + r == mpc('2.5+2.0j')
     assert mpc(1,2) + q == mpc('2.5+2.0j')
     assert mpc(1,2) + z == mpc('3.0+2.0j')
+
+
+def test_mixed_types():
+    import operator
+    from gmpy2 import xmpz
+
+    # Each operand with its class: 0 integer, 1 rational, 2 real, 3 complex.
+    values = [(3, 0), (mpz(3), 0), (xmpz(3), 0), (z, 0),
+              (Fraction(3, 4), 1), (mpq(3, 4), 1), (q, 1),
+              (0.75, 2), (mpfr(0.75), 2), (r, 2),
+              (1+2j, 3), (mpc(1, 2), 3), (cx, 3)]
+    convert = [mpz, mpq, mpfr, mpc]
+    ops = [operator.add, operator.sub, operator.mul, operator.truediv,
+           operator.floordiv, operator.mod, divmod]
+
+    def is_gmpy2(v):
+        return type(v).__module__ == 'gmpy2'
+
+    # The result has the type of the wider class of the two operands.
+    for x, xclass in values:
+        for y, yclass in values:
+            if not (is_gmpy2(x) or is_gmpy2(y)):
+                continue
+            k = max(xclass, yclass)
+            for op in ops:
+                if k == 3 and op in (operator.floordiv, operator.mod, divmod):
+                    pytest.raises(TypeError, lambda: op(x, y))
+                    continue
+                res = op(x, y)
+                expected = op(convert[k](x), convert[k](y))
+                assert type(res) is type(expected)
+                assert res == expected
+            if is_gmpy2(x) and yclass == 0:
+                res = pow(x, y)
+                expected = pow(convert[k](x), mpz(y))
+                assert type(res) is type(expected)
+                assert res == expected
@@ -1,4 +1,5 @@
 import gmpy2
+from pytest import raises
 
 
 def test_misc():
@@ -13,3 +14,859 @@ def test_misc():
                                '3 or later. The supported versions of the GMP, '
                                'MPFR, and MPC libraries are also licensed '
                                'under LGPL 3 or later.')
+
+
+def test_cache_threads():
+    from concurrent.futures import ThreadPoolExecutor
+
+    def work(n):
+        total = gmpy2.mpz(0)
+        for i in range(2000):
+            x = gmpy2.mpz(i) * n
+            q = gmpy2.mpq(i, n)
+            f = gmpy2.mpfr(i) / n
+            c = gmpy2.mpc(i, n)
+            total += x + int(q * n) + int(f * n) + int(c.imag)
+            del x, q, f, c
+        return total
+
+    with ThreadPoolExecutor(8) as pool:
+        results = list(pool.map(work, range(1, 33)))
+    expected = [sum(i * n + i + i + n for i in range(2000))
+                for n in range(1, 33)]
+    assert results == expected
+
+
+def test_context_switching():
+    import contextvars
+
+    orig = gmpy2.get_context()
+    try:
+        gmpy2.set_context(gmpy2.context(precision=100))
+        assert gmpy2.get_context().precision == 100
+        assert gmpy2.mpfr(1).precision == 100
+
+        def inner(prec):
+            assert gmpy2.get_context().precision == 100
+            gmpy2.set_context(gmpy2.context(precision=prec))
+            assert gmpy2.mpfr(1).precision == prec
+            return gmpy2.get_context().precision
+
+        ctx = contextvars.copy_context()
+        assert ctx.run(inner, 60) == 60
+        assert gmpy2.mpfr(1).precision == 100
+        assert ctx.run(lambda: gmpy2.get_context().precision) == 60
+        fresh = contextvars.Context()
+        assert fresh.run(lambda: gmpy2.get_context().precision) == 53
+        assert gmpy2.get_context().precision == 100
+
+        with gmpy2.local_context(precision=70):
+            assert gmpy2.mpfr(1).precision == 70
+            assert ctx.run(lambda: gmpy2.mpfr(1).precision) == 60
+            assert gmpy2.mpfr(1).precision == 70
+        assert gmpy2.mpfr(1).precision == 100
+    finally:
+        gmpy2.set_context(orig)
+
+
+def test_release_gil_min_bits():
+    from concurrent.futures import ThreadPoolExecutor
+
+    ctx = gmpy2.context()
+    assert ctx.release_gil_min_bits == 4096
+    assert gmpy2.context(release_gil_min_bits=0).release_gil_min_bits == 0
+    with raises(ValueError):
+        gmpy2.context(release_gil_min_bits=-1)
+    with raises(ValueError):
+        ctx.release_gil_min_bits = -1
+    with raises(TypeError):
+        ctx.release_gil_min_bits = 1.5
+
+    def work(n, allow=False, bits=4096):
+        with gmpy2.local_context(allow_release_gil=allow,
+                                 release_gil_min_bits=bits):
+            x = gmpy2.mpz(7) ** (300 * n) + 1
+            return [gmpy2.isqrt(x), gmpy2.iroot(x, 3)[0], gmpy2.gcd(x, x + 2),
+                    gmpy2.fac(50 * n), gmpy2.bincoef(40 * n, 7),
+                    int(str(x)), gmpy2.mpz(str(-x)), gmpy2.is_prime(x),
+                    gmpy2.is_strong_prp(x, 3), gmpy2.is_bpsw_prp(x),
+                    gmpy2.powmod_base_list([2, 3], x, x + 2)]
+
+    expected = [work(n) for n in range(1, 9)]
+    for bits in (0, 1024, 1 << 20):
+        with ThreadPoolExecutor(4) as pool:
+            results = pool.map(lambda n: work(n, True, bits), range(1, 9))
+            assert list(results) == expected
+
+
+def test_bench_threads():
+    import contextlib
+    import io
+    from gmpy2 import bench
+
+    ctx = gmpy2.get_context()
+    allow, bits = ctx.allow_release_gil, ctx.release_gil_min_bits
+    seen = []
+    result = bench.threads(['add', 'iadd', 'imul', 'powmod'], [64, 1024],
+                           [1, 2], 0.001,
+                           lambda name, entry, threads: seen.append(name))
+    assert seen == ['add', 'iadd', 'imul', 'powmod']
+    assert (ctx.allow_release_gil, ctx.release_gil_min_bits) == (allow, bits)
+    for name, entry in result['ops'].items():
+        assert [s['bits'] for s in entry['sizes']] == [64, 1024]
+        assert entry['break_even'] in (None, 64, 1024)
+        for size in entry['sizes']:
+            for mode in ('gil', 'nogil'):
+                p50, p99 = size['latency'][mode]
+                assert 0 < p50 <= p99
+                assert sorted(size['throughput'][mode]) == [1, 2]
+            assert size['gain'] > 0
+    assert bench._break_even([{'bits': 64, 'gain': 2.0},
+                              {'bits': 256, 'gain': 0.9},
+                              {'bits': 1024, 'gain': 1.1},
+                              {'bits': 4096, 'gain': 3.0}]) == 1024
+    assert bench._break_even([{'bits': 64, 'gain': 0.5}]) is None
+    with raises(ValueError):
+        bench.threads(['div'])
+    with raises(ValueError):
+        bench.threads(['add'], [0])
+
+    out = io.StringIO()
+    with contextlib.redirect_stdout(out):
+        assert bench.main(['threads', '--ops', 'mul', '--bits', '64,128',
+                           '--threads', '1', '--time', '0.001']) == 0
+    out = out.getvalue()
+    assert 'mul: x * y' in out
+    assert 'release_gil_min_bits' in out or 'did not pay off' in out
+
+
+def test_threads():
+    ctx = gmpy2.context()
+    assert ctx.threads == 0
+    assert gmpy2.context(threads=4).threads == 4
+    with raises(ValueError):
+        gmpy2.context(threads=-1)
+    with raises(ValueError):
+        ctx.threads = -1
+    with raises(TypeError):
+        ctx.threads = 1.5
+
+    m = gmpy2.mpz(3) ** 1000 + 2
+    xs = [gmpy2.mpz(i) ** 50 + 7 for i in range(37)]
+    bases = [gmpy2.powmod(x, m - 1, m) for x in xs]
+    exps = [gmpy2.powmod(5, x, m) for x in xs]
+    for threads in (1, 2, 3, 8, 64):
+        for bits in (0, 1 << 30):
+            with gmpy2.local_context(threads=threads,
+                                     release_gil_min_bits=bits):
+                assert gmpy2.powmod_base_list(xs, m - 1, m) == bases
+                assert gmpy2.powmod_exp_list(5, xs, m) == exps
+                assert gmpy2.powmod_base_list([], 3, m) == []
+
+
+def test_num_threads():
+    from concurrent.futures import ThreadPoolExecutor
+
+    assert gmpy2.get_num_threads() == 1
+    info = gmpy2.thread_pool_info()
+    assert info['num_threads'] == 1
+    assert info['cpus'] >= 1
+    assert info['pinned'] is False
+    with raises(ValueError):
+        gmpy2.set_num_threads(0)
+    with raises(TypeError):
+        gmpy2.set_num_threads(2.0)
+
+    m = gmpy2.mpz(3) ** 1000 + 2
+    xs = [gmpy2.mpz(i) ** 50 + 7 for i in range(37)]
+    bases = [gmpy2.powmod(x, m - 1, m) for x in xs]
+    try:
+        gmpy2.set_num_threads(3)
+        assert gmpy2.get_num_threads() == 3
+        jobs = gmpy2.thread_pool_info()['jobs']
+        with gmpy2.local_context(release_gil_min_bits=0):
+            assert gmpy2.powmod_base_list(xs, m - 1, m) == bases
+
+            # Competing callers share the workers of one pool.
+            with ThreadPoolExecutor(8) as pool:
+                results = list(pool.map(
+                    lambda i: gmpy2.powmod_base_list(xs, m - 1, m), range(16)))
+            assert results == [bases] * 16
+            futures = [gmpy2.submit(gmpy2.mul, i, i) for i in range(100)]
+            assert [f.result() for f in futures] == [i * i for i in range(100)]
+
+        # A context overrides the number of threads.
+        with gmpy2.local_context(threads=1, release_gil_min_bits=0):
+            assert gmpy2.powmod_base_list(xs, m - 1, m) == bases
+        info = gmpy2.thread_pool_info()
+        assert info['jobs'] > jobs
+        assert info['busy_time'] >= 0
+        assert 0 <= info['idle'] <= info['workers'] <= 3
+        assert info['started'] >= info['workers']
+
+        gmpy2.set_num_threads(2, pin=True)
+        assert gmpy2.thread_pool_info()['pinned'] is True
+        with gmpy2.local_context(release_gil_min_bits=0):
+            assert gmpy2.powmod_base_list(xs, m - 1, m) == bases
+        gmpy2.set_num_threads()
+        assert gmpy2.get_num_threads() == gmpy2.thread_pool_info()['cpus']
+    finally:
+        gmpy2.set_num_threads(1)
+    assert gmpy2.thread_pool_info()['idle'] == 0
+
+
+def test_mul_threads_min_bits():
+    ctx = gmpy2.context()
+    assert ctx.mul_threads_min_bits == 2**23
+    assert gmpy2.context(mul_threads_min_bits=0).mul_threads_min_bits == 0
+    with raises(ValueError):
+        gmpy2.context(mul_threads_min_bits=-1)
+    with raises(ValueError):
+        ctx.mul_threads_min_bits = -1
+    with raises(TypeError):
+        ctx.mul_threads_min_bits = 1.5
+
+    x = gmpy2.mpz(3) ** 20000 + 5
+    y = -gmpy2.mpz(7) ** 9000
+    z = gmpy2.mpz(11) ** 500
+    expected = [int(x) * int(y), int(x) ** 2, int(x) * int(z), int(y) * 0]
+    for threads in (1, 2, 3, 9, 64):
+        for bits in (0, 1 << 30):
+            with gmpy2.local_context(threads=threads, mul_threads_min_bits=bits):
+                assert [x * y, x * x, z * x, y * gmpy2.mpz(0)] == expected
+                assert gmpy2.square(y) == int(y) ** 2
+
+
+def test_max_time():
+    import time
+
+    ctx = gmpy2.context()
+    assert ctx.max_time == 0.0 and ctx.deadline == 0.0
+    assert gmpy2.context(max_time=2).max_time == 2.0
+    assert gmpy2.context(deadline=1.5).deadline == 1.5
+    with raises(ValueError):
+        gmpy2.context(max_time=-1.0)
+    with raises(ValueError):
+        ctx.deadline = float('nan')
+    with raises(TypeError):
+        ctx.max_time = '1'
+
+    big = gmpy2.mpz(2)**20000 + 1
+    calls = [lambda: gmpy2.fac(10**8),
+             lambda: gmpy2.bincoef(10**8, 5 * 10**7),
+             lambda: gmpy2.prod(range(1, 10**5)),
+             lambda: gmpy2.factor(gmpy2.mpz(2)**128 + 1),
+             lambda: gmpy2.is_strong_bpsw_prp(big),
+             lambda: gmpy2.is_prime_list([big] * 8)]
+    live = gmpy2.memory_info()['mpz']['live']
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, deadline=time.monotonic()):
+            for call in calls:
+                with raises(TimeoutError):
+                    call()
+    with gmpy2.local_context(max_time=0.05):
+        start = time.monotonic()
+        with raises(TimeoutError):
+            gmpy2.fac(10**8)
+        assert time.monotonic() - start < 2
+        assert gmpy2.fac(30) == gmpy2.mpz(265252859812191058636308480000000)
+    assert gmpy2.memory_info()['mpz']['live'] <= live + 2
+
+    # Without a limit, the same functions finish.
+    with gmpy2.local_context(max_time=float('inf')):
+        assert gmpy2.is_strong_bpsw_prp(gmpy2.mpz(2)**127 - 1)
+
+
+def test_keyboard_interrupt():
+    import signal
+    import threading
+    import time
+
+    if not hasattr(signal, 'pthread_kill'):
+        return
+
+    main = threading.get_ident()
+    def interrupt():
+        time.sleep(0.1)
+        signal.pthread_kill(main, signal.SIGINT)
+
+    thread = threading.Thread(target=interrupt)
+    thread.start()
+    start = time.monotonic()
+    try:
+        with raises(KeyboardInterrupt):
+            with gmpy2.local_context(allow_release_gil=True):
+                gmpy2.fac(10**9)
+    finally:
+        thread.join()
+    assert time.monotonic() - start < 5
+
+
+def test_submit():
+    import asyncio
+    import time
+    from concurrent.futures import Future
+
+    mpz = gmpy2.mpz
+    n = mpz(2)**127 - 1
+    f = gmpy2.submit(gmpy2.powmod, 3, n - 1, n)
+    assert isinstance(f, Future)
+    assert f.result() == 1
+    assert gmpy2.submit(gmpy2.powmod, 3, -1, -7).result() == gmpy2.powmod(3, -1, -7)
+    with raises(ValueError):
+        gmpy2.submit(gmpy2.powmod, 2, -1, 4).result()
+    assert gmpy2.submit(gmpy2.mul, n, n).result() == n * n
+    assert gmpy2.submit(gmpy2.isqrt, n * n + 5).result() == n
+    assert gmpy2.submit(gmpy2.is_prime, n).result() is True
+    assert gmpy2.submit(gmpy2.is_prime, -7, 3).result() is False
+    assert gmpy2.submit(gmpy2.is_bpsw_prp, n).result() is True
+    assert gmpy2.submit(gmpy2.is_strong_bpsw_prp, n + 2).result() is False
+    assert gmpy2.submit(gmpy2.factor, 720, 0).result() == [(2, 4), (3, 2), (5, 1)]
+
+    # Invalid arguments are rejected by submit() itself.
+    with raises(TypeError):
+        gmpy2.submit(gmpy2.fac, 5)
+    with raises(TypeError):
+        gmpy2.submit(gmpy2.mul, 1.5, 2)
+    with raises(ValueError):
+        gmpy2.submit(gmpy2.powmod, 1, 2, 0)
+    with raises(ValueError):
+        gmpy2.submit(gmpy2.isqrt, -1)
+    with raises(ValueError):
+        gmpy2.submit(gmpy2.factor, 10, 6)
+
+    with gmpy2.local_context(threads=4):
+        futures = [gmpy2.submit(gmpy2.mul, i, i + 1) for i in range(500)]
+        assert [f.result() for f in futures] == [i * (i + 1) for i in range(500)]
+
+    with gmpy2.local_context(threads=2, max_time=0.05):
+        futures = [gmpy2.submit(gmpy2.factor, mpz(2)**400 + 1, 5) for i in range(3)]
+    start = time.monotonic()
+    for f in futures:
+        with raises(TimeoutError):
+            f.result()
+    assert time.monotonic() - start < 5
+
+    async def check():
+        return await asyncio.gather(*(asyncio.wrap_future(
+            gmpy2.submit(gmpy2.is_prime, mpz(2)**p - 1)) for p in (89, 90)))
+    assert asyncio.run(check()) == [True, False]
+
+
+def test_profile():
+    ctx = gmpy2.context()
+    assert ctx.profile is False
+    assert gmpy2.context(profile=True).profile is True
+    info = ctx.profile_info()
+    assert sorted(info) == ['bits', 'cache_hits', 'cache_misses', 'nogil_calls',
+                            'nogil_time', 'ops']
+    assert info['ops'] == {} and info['bits'] == {}
+
+    with gmpy2.local_context(profile=True, allow_release_gil=True,
+                             release_gil_min_bits=0) as ctx:
+        x = gmpy2.mpz(2) ** 200
+        y = x * x - 3
+        y = divmod(y, x)
+        y = gmpy2.powmod(3, x, x + 1)
+        y = gmpy2.gcd(x, 12)
+        y = gmpy2.isqrt(x)
+        info = ctx.profile_info(reset=True)
+    assert info['ops']['add'] == 1 and info['ops']['sub'] == 1
+    assert info['ops']['mul'] == 1 and info['ops']['divmod'] == 1
+    assert info['ops']['pow'] == 1 and info['ops']['powmod'] == 1
+    assert info['ops']['gcd'] == 2 and info['ops']['root'] == 1
+    assert sum(info['bits']['add'].values()) == 1
+    assert all(k & (k - 1) == 0 for k in info['bits']['add'])
+    assert info['cache_hits'] + info['cache_misses'] > 0
+    assert info['nogil_calls'] > 0 and info['nogil_time'] >= 0
+    info = ctx.profile_info()
+    assert info['ops'] == {} and info['nogil_calls'] == 0
+    x = gmpy2.mpz(5) + 1
+    assert ctx.profile_info()['ops'] == {}
+
+
+def test_frozen_context():
+    from concurrent.futures import ThreadPoolExecutor
+
+    ctx = gmpy2.context(precision=100, trap_divzero=False)
+    frozen = ctx.freeze()
+    assert frozen.frozen and not ctx.frozen
+    assert frozen.freeze() is frozen
+    assert frozen.precision == 100
+    with raises(AttributeError):
+        frozen.precision = 53
+    with raises(AttributeError):
+        frozen.trap_inexact = True
+    with raises(AttributeError):
+        frozen.allow_complex = True
+    copy = frozen.copy()
+    assert not copy.frozen and copy.precision == 100
+    copy.precision = 53
+
+    def work(n):
+        with frozen as ctx:
+            assert ctx is frozen
+            assert gmpy2.get_context() is frozen
+            assert not frozen.inexact
+            x = gmpy2.mpfr(1) / n
+            assert frozen.inexact == (n & (n - 1) != 0)
+            frozen.clear_flags()
+            with gmpy2.local_context(frozen, precision=20) as local:
+                assert not local.frozen and local.precision == 20
+            assert gmpy2.get_context() is frozen
+            return x
+
+    with gmpy2.local_context(ctx):
+        expected = [gmpy2.mpfr(1) / n for n in (1, 2, 3, 4, 5, 6, 7, 8)]
+    with ThreadPoolExecutor(4) as pool:
+        assert list(pool.map(work, (1, 2, 3, 4, 5, 6, 7, 8))) == expected
+    assert not frozen.inexact
+    assert frozen.next_above(gmpy2.mpfr(1)) > 1
+
+
+def test_context_template():
+    import asyncio
+    from concurrent.futures import ThreadPoolExecutor
+
+    before = gmpy2.get_context()
+    t = gmpy2.context_template(precision=100)
+    assert t.context.frozen and t.context.precision == 100
+    assert gmpy2.context_template(gmpy2.ieee(32)).context.precision == 24
+    with t as ctx:
+        assert ctx is t.context and gmpy2.get_context() is ctx
+        assert (gmpy2.mpfr(1) / 3).precision == 100
+        with t:
+            with gmpy2.local_context(precision=20):
+                assert gmpy2.get_context().precision == 20
+            assert gmpy2.get_context() is ctx
+        assert gmpy2.get_context() is ctx
+    assert gmpy2.get_context() is before
+    with raises(ZeroDivisionError):
+        with t:
+            1 / 0
+    assert gmpy2.get_context() is before
+    with raises(RuntimeError):
+        t.__exit__(None, None, None)
+    with raises(ValueError):
+        gmpy2.context_template(1)
+    with raises(ValueError):
+        gmpy2.context_template(precision=-1)
+
+    def work(n):
+        for _ in range(200):
+            with t:
+                assert gmpy2.get_context().precision == 100
+            assert gmpy2.get_context().precision == 53
+        return n
+
+    with ThreadPoolExecutor(4) as pool:
+        assert list(pool.map(work, range(8))) == list(range(8))
+
+    async def task(n):
+        with t:
+            await asyncio.sleep(0)
+            assert gmpy2.get_context() is t.context
+        return gmpy2.get_context().precision
+
+    async def main():
+        return await asyncio.gather(*(task(n) for n in range(4)))
+
+    assert asyncio.run(main()) == [53] * 4
+
+
+def test_cache_info():
+    info = gmpy2.cache_info()
+    assert sorted(info) == ['mpc', 'mpfr', 'mpq', 'mpz', 'xmpz']
+    old = info['mpz']
+    try:
+        gmpy2.set_cache('mpz', size=0)
+        assert gmpy2.cache_info()['mpz']['cached'] == 0
+        gmpy2.set_cache('mpz', size=10, limbs=4)
+        info = gmpy2.cache_info()['mpz']
+        assert info['size'] == 10 and info['limbs'] == 4
+        values = [gmpy2.mpz(1000 + i) for i in range(20)]
+        del values
+        info = gmpy2.cache_info()['mpz']
+        assert info['cached'] == 10
+        hits = info['hits']
+        x = gmpy2.mpz(5) + 1
+        assert gmpy2.cache_info()['mpz']['hits'] > hits
+        del x
+        evictions = gmpy2.cache_info()['mpz']['evictions']
+        big = gmpy2.mpz(2)**10000
+        del big
+        assert gmpy2.cache_info()['mpz']['evictions'] > evictions
+        gmpy2.set_cache('mpz', size=0)
+        assert gmpy2.cache_info()['mpz']['cached'] == 0
+    finally:
+        gmpy2.set_cache('mpz', size=old['size'], limbs=old['limbs'])
+    assert gmpy2.cache_info()['mpz']['size'] == old['size']
+
+    with raises(ValueError):
+        gmpy2.set_cache('mpz', -1)
+    with raises(ValueError):
+        gmpy2.set_cache('mpz', 1001)
+    with raises(ValueError):
+        gmpy2.set_cache('float', 10)
+    with raises(ValueError):
+        gmpy2.set_cache('mpfr', limbs=1 + 1024 // gmpy2.mp_limbsize())
+
+
+def test_cache_size_classes():
+    old = gmpy2.cache_info()['mpz']
+    try:
+        big = gmpy2.mpz(2)**(40 * gmpy2.mp_limbsize())
+        gmpy2.set_cache('mpz', size=0)
+        gmpy2.set_cache('mpz', size=10)
+        del big
+        info = gmpy2.cache_info()['mpz']
+        assert info['cached'] == 1
+
+        # A small integer does not reuse the large cached object.
+        x = gmpy2.mpz(7)
+        assert gmpy2.cache_info()['mpz']['hits'] == info['hits']
+        assert gmpy2.cache_info()['mpz']['cached'] == 1
+        y = gmpy2.mpz(2**(30 * gmpy2.mp_limbsize()))
+        assert gmpy2.cache_info()['mpz']['hits'] > info['hits']
+        assert x == 7 and y.bit_length() == 30 * gmpy2.mp_limbsize() + 1
+    finally:
+        gmpy2.set_cache('mpz', size=old['size'])
+
+
+def test_cache_mpq():
+    from fractions import Fraction
+
+    old = gmpy2.cache_info()['mpq']
+    try:
+        gmpy2.set_cache('mpq', size=0)
+        gmpy2.set_cache('mpq', size=10)
+        big = gmpy2.mpq(3**1000, 7**800)
+        del big
+        assert gmpy2.cache_info()['mpq']['cached'] >= 1
+
+        x = gmpy2.mpq(1, 3)
+
+        f, g = Fraction(2**200, 3**100), Fraction(5**90, 7**80)
+        a, b = gmpy2.mpq(f), gmpy2.mpq(g)
+        assert a + b == f + g and a - b == f - g
+        assert a * b == f * g and a / b == f / g
+        assert x == Fraction(1, 3)
+    finally:
+        gmpy2.set_cache('mpq', size=old['size'])
+
+
+def test_allocator():
+    import tracemalloc
+    from concurrent.futures import ThreadPoolExecutor
+
+    assert gmpy2.allocator_info()['mode'] in ('default', 'tracked')
+    with raises(ValueError):
+        gmpy2.set_allocator('arena')
+    with raises(ValueError):
+        gmpy2.arena(16)
+
+    gmpy2.set_allocator('tracked')
+    try:
+        info = gmpy2.allocator_info(reset_peak=True)
+        assert info['mode'] == 'tracked'
+        x = gmpy2.mpz(3)**100000
+        info = gmpy2.allocator_info()
+        assert info['live'] >= x.bit_length() // 8
+        assert info['peak'] >= info['live']
+        del x
+
+        tracemalloc.start()
+        try:
+            x = gmpy2.mpz(7)**100000
+            snap = tracemalloc.take_snapshot()
+        finally:
+            tracemalloc.stop()
+        domain = tracemalloc.DomainFilter(True, info['domain'])
+        size = sum(s.size for s in snap.filter_traces([domain]).statistics('lineno'))
+        assert size >= x.bit_length() // 8
+        del x
+
+        def work(n):
+            with gmpy2.context(allow_release_gil=True):
+                return int((gmpy2.mpz(n)**20000 * gmpy2.mpz(n + 1)**20000) % 1000)
+        with ThreadPoolExecutor(4) as pool:
+            results = list(pool.map(work, range(2, 34)))
+        assert results == [(n**20000 * (n + 1)**20000) % 1000 for n in range(2, 34)]
+
+        with gmpy2.arena(1 << 16) as arena:
+            keep = None
+            # The values are larger than any cached object, so keep is
+            # always stored in the arena.
+            for i in range(2000):
+                x = gmpy2.mpz(i)**500 * gmpy2.mpz(i + 1)**400
+                if i == 1000:
+                    keep = x
+            assert gmpy2.allocator_info()['arena'] > 0
+            with raises(RuntimeError):
+                arena.__enter__()
+        assert keep == gmpy2.mpz(1000)**500 * gmpy2.mpz(1001)**400
+        with raises(RuntimeError):
+            arena.__exit__(None, None, None)
+        with raises(RuntimeError):
+            gmpy2.set_allocator('default')
+        del keep, x
+    finally:
+        size = gmpy2.cache_info()['mpz']['size']
+        for name in ('mpz', 'xmpz', 'mpq'):
+            gmpy2.set_cache(name, size=0)
+            gmpy2.set_cache(name, size=size)
+        assert gmpy2.allocator_info()['arena'] == 0
+        gmpy2.set_allocator('default')
+    assert gmpy2.allocator_info()['mode'] == 'default'
+
+
+def test_trace():
+    events = []
+
+    def callback(*args):
+        events.append(args)
+        if args[0] == 'cache_miss':
+            # Objects created by the callback are not reported.
+            gmpy2.mpz(10)**1000
+
+    info = gmpy2.trace_info()
+    assert not info['enabled'] and info['callback'] is None
+    with raises(TypeError):
+        gmpy2.set_trace(1)
+    with raises(ValueError):
+        gmpy2.set_trace(callback, realloc_min_bytes=-1)
+
+    gmpy2.set_trace(callback, realloc_min_bytes=1 << 16, nogil_min_time=0)
+    try:
+        info = gmpy2.trace_info()
+        assert info['enabled'] and info['callback'] is callback
+        assert info['realloc_min_bytes'] == 1 << 16
+        assert gmpy2.allocator_info()['mode'] == 'tracked'
+        x = gmpy2.xmpz(3)
+        for i in range(3):
+            x <<= 1 << 19
+        with gmpy2.context(allow_release_gil=True, release_gil_min_bits=0):
+            y = gmpy2.mpz(x) * gmpy2.mpz(x)
+    finally:
+        gmpy2.set_trace(None)
+        gmpy2.set_allocator('default')
+    assert not gmpy2.trace_info()['enabled']
+
+    kinds = {e[0] for e in events}
+    assert kinds == {'cache_miss', 'realloc', 'nogil'}
+    for e in events:
+        if e[0] == 'cache_miss':
+            assert e[1] in ('mpz', 'xmpz', 'mpq', 'mpfr', 'mpc')
+        elif e[0] == 'realloc':
+            assert e[2] >= 1 << 16 and e[2] > e[1]
+        else:
+            assert e[1] > 0 and e[2] >= 0
+    n = len(events)
+    gmpy2.mpz(7)**100000
+    assert len(events) == n
+
+
+def test_memory_info():
+    info = gmpy2.memory_info(reset_peak=True)
+    assert set(info) == {'mpz', 'xmpz', 'mpq', 'mpfr', 'mpc', 'gmp'}
+    live = info['mpz']['live']
+    xs = [gmpy2.mpz(10)**i for i in range(100, 300)]
+    info = gmpy2.memory_info()
+    assert info['mpz']['live'] >= live + 200
+    assert info['mpz']['peak'] >= info['mpz']['live']
+    del xs
+    info = gmpy2.memory_info()
+    assert info['mpz']['live'] <= live + 1
+    assert info['mpz']['peak'] >= live + 200
+    assert info['mpz']['cached_bytes'] >= 8 * info['mpz']['cached']
+
+    fs = [gmpy2.mpc(i, 1) for i in range(20)]
+    assert gmpy2.memory_info()['mpc']['live'] >= 20
+    del fs
+
+    assert gmpy2.allocator_info()['mode'] == 'default'
+    assert gmpy2.memory_info()['gmp'] == {'live': None, 'peak': None}
+    gmpy2.set_allocator('tracked')
+    try:
+        x = gmpy2.mpz(3)**100000
+        info = gmpy2.memory_info()['gmp']
+        assert info['peak'] >= info['live'] >= x.bit_length() // 8
+        del x
+    finally:
+        gmpy2.set_allocator('default')
+
+
+def test_cache_trim():
+    # Storage too large for the cache is reduced to fit the value.
+    before = gmpy2.memory_info()['xmpz']
+    x = gmpy2.xmpz(gmpy2.mpz(7)**100000)
+    x %= 1000
+    del x
+    after = gmpy2.memory_info()['xmpz']
+    assert after['cached'] >= before['cached']
+    assert after['cached_bytes'] - before['cached_bytes'] <= 64
+
+
+def test_subinterpreter():
+    # Interpreters that share the main GIL can import gmpy2.
+    try:
+        import _xxsubinterpreters as interpreters
+    except ImportError:
+        return
+    try:
+        interp = interpreters.create(isolated=False)
+    except TypeError:
+        interp = interpreters.create()
+    try:
+        interpreters.run_string(interp, "\n".join([
+            "import pickle, gmpy2",
+            "assert gmpy2.mpz(2)**100 == 2**100",
+            "x = gmpy2.mpq(1, 3)",
+            "assert pickle.loads(pickle.dumps(x)) == x",
+            "gmpy2.get_context().precision = 100",
+        ]))
+    finally:
+        interpreters.destroy(interp)
+    assert gmpy2.get_context().precision == 53
+
+
+def test_hash_many():
+    from gmpy2 import mpz, mpq, mpfr, mpc
+
+    values = [mpz(3)**100, mpq(1, 3), mpfr(1) / 3, mpc(1, 2), 7, "x"]
+    assert gmpy2.hash_many(values) == [hash(v) for v in values]
+    assert gmpy2.hash_many(iter([1, 2])) == [1, 2]
+    assert gmpy2.hash_many([]) == []
+    with raises(TypeError):
+        gmpy2.hash_many([[]])
+    with raises(TypeError):
+        gmpy2.hash_many(1)
+
+
+def test_lazy_import():
+    import subprocess
+    import sys
+
+    def run(code):
+        subprocess.run([sys.executable, '-c', code], check=True)
+
+    # The numeric tower is not imported by gmpy2, but registered once it is.
+    run("\n".join([
+        "import sys, gmpy2",
+        "assert 'numbers' not in sys.modules",
+        "assert not {'_sys', '_install_numbers_hook'} & set(dir(gmpy2))",
+        "import numbers",
+        "assert isinstance(gmpy2.mpz(1), numbers.Integral)",
+        "assert isinstance(gmpy2.mpq(1, 2), numbers.Rational)",
+        "assert isinstance(gmpy2.mpfr(1), numbers.Real)",
+        "assert isinstance(gmpy2.mpc(1), numbers.Complex)",
+    ]))
+    run("\n".join([
+        "import numbers, gmpy2",
+        "assert isinstance(gmpy2.mpz(1), numbers.Integral)",
+        "assert isinstance(gmpy2.mpc(1), numbers.Complex)",
+    ]))
+    # The prime tables are built on first use.
+    run("\n".join([
+        "import gmpy2",
+        "assert gmpy2.factor(2**4 * 3 * 10007) == [(2, 4), (3, 1), (10007, 1)]",
+        "assert gmpy2.fac(20) == 2432902008176640000",
+    ]))
+
+
+def test_conversion_methods():
+    from gmpy2 import mpz, mpq, mpfr, mpc
+
+    class Num:
+        def __mpz__(self):
+            return mpz(2)
+
+    class Sub(Num):
+        pass
+
+    x, s = Num(), Sub()
+    assert mpz(5) + x == 7 and gmpy2.is_prime(x) and mpz(5) + s == 7
+
+    # The cached lookups see methods that are added or removed later,
+    # also in a base class.
+    Num.__mpq__ = lambda self: mpq(1, 2)
+    assert mpz(5) + x == mpq(11, 2) and mpz(5) + s == mpq(11, 2)
+    del Num.__mpq__, Num.__mpz__
+    with raises(TypeError):
+        mpz(5) + x
+    with raises(TypeError):
+        mpz(5) + s
+    Sub.__mpfr__ = lambda self: mpfr(1.5)
+    assert mpz(5) + s == mpfr(6.5)
+    Sub.__mpc__ = lambda self: mpc(1, 1)
+    assert mpz(5) + s == mpc(6, 1)
+
+    # Like other special methods, they are looked up on the type.
+    Num.__mpz__ = lambda self: mpz(3)
+    with raises(TypeError):
+        mpz(5) + Num
+    y = Sub()
+    y.__mpfr__ = None
+    assert mpz(5) + y == mpc(6, 1)
+
+
+def test_allocation_guard():
+    from gmpy2 import mpz, mpz_array, xmpz
+
+    y = mpz(3)**300
+    m = mpz(2)**521 - 1
+    x = xmpz(y)
+    a = mpz_array([1, 2, 3, 4] * 25)
+    # The in-place operations and the out= arguments must not allocate
+    # once the storage of the result is large enough.
+    loops = [
+        lambda: x.__iadd__(y),
+        lambda: x.__isub__(y),
+        lambda: x.__iadd__(1),
+        lambda: x.__ifloordiv__(1),
+        lambda: x.addmul(y, 2),
+        lambda: x.submul(y, 2),
+        lambda: x.powmod_inplace(65537, m),
+        lambda: gmpy2.mul(y, y, out=x),
+        lambda: gmpy2.add(x, y, out=x),
+        lambda: gmpy2.sub(x, y, out=x),
+        lambda: gmpy2.square(y, out=x),
+        lambda: gmpy2.powmod(y, 65537, m, out=x),
+        lambda: gmpy2.isqrt(y, out=x),
+        lambda: gmpy2.gcd(y, 3**50, out=x),
+        lambda: gmpy2.lcm(y, 6, out=x),
+        lambda: gmpy2.vadd(a, 1, out=a),
+        lambda: gmpy2.vsub(a, 1, out=a),
+        lambda: gmpy2.vmod(a, 7, out=a),
+    ]
+    try:
+        for i, func in enumerate(loops):
+            func()
+            with gmpy2.allocation_guard() as g:
+                for _ in range(50):
+                    func()
+            assert (g.allocations, g.reallocations, g.frees,
+                    g.cache_misses) == (0, 0, 0, 0), (i, g)
+
+        with gmpy2.allocation_guard() as outer:
+            with gmpy2.allocation_guard() as inner:
+                xs = [mpz(10)**1000 for _ in range(gmpy2.cache_info()['mpz']['size'] + 10)]
+                assert inner.cache_misses >= 10 and inner.allocations >= 10
+            assert outer.allocations == inner.allocations
+            assert outer.cache_misses == inner.cache_misses
+            del xs
+        assert outer.frees >= 10
+        assert 'cache_misses=' in repr(outer)
+
+        g = gmpy2.allocation_guard()
+        with g:
+            with raises(RuntimeError):
+                g.__enter__()
+            with raises(RuntimeError):
+                gmpy2.set_allocator('default')
+        with raises(RuntimeError):
+            g.__exit__(None, None, None)
+        with raises(AttributeError):
+            g.allocations = 1
+    finally:
+        gmpy2.set_allocator('default')
@@ -2,7 +2,8 @@ import pytest
 
 import gmpy2
 from gmpy2 import (mpc, cmp, cmp_abs, nan, random_state, mpc_random,
-                   to_binary, from_binary, get_context, is_nan)
+                   to_binary, from_binary, get_context, is_nan,
+                   root_of_unity, roots_of_unity, fft, ifft)
 from supportclasses import a, b, c, d
 
 
@@ -102,3 +103,73 @@ def test_mpc_to_from_binary():
     assert (from_binary(to_binary(mpc("1.3-4.7j"))) ==
             mpc('1.2999999999999999999999999999994-4.7000000000000000000000000000000025j',
                 (100,110)))
+
+
+def test_mpc_roots_of_unity():
+    r = roots_of_unity(12)
+    assert len(r) == 12
+    assert all(r[k] == root_of_unity(12, k) for k in range(12))
+    assert roots_of_unity(12) is r
+    assert roots_of_unity(4) == (1, 1j, -1, -1j)
+    assert all(x.precision == (70, 70) for x in roots_of_unity(5, precision=70))
+    pytest.raises(ValueError, lambda: roots_of_unity(0))
+    pytest.raises(TypeError, lambda: roots_of_unity(2.0))
+
+
+def test_mpc_fft():
+    def dft(x, sign):
+        n = len(x)
+        with gmpy2.local_context(precision=200):
+            return [sum((x[j] * root_of_unity(n, sign * j * k % n)
+                         for j in range(n)), mpc(0)) for k in range(n)]
+
+    for n in (1, 2, 3, 6, 8, 16):
+        x = [mpc(j % 7 - 3, j * j % 5 - 2) for j in range(n)]
+        ref = dft(x, -1)
+        res = fft(x)
+        assert all(abs(u - v) <= 1e-15 * n for u, v in zip(res, ref))
+        assert all(abs(u - v) <= 1e-15 for u, v in zip(ifft(res), x))
+
+    assert fft([]) == []
+    assert fft([1, 2.0, 3j, mpc(4)]) == [7+3j, 1-1j, -5+3j, 1-5j]
+    res = fft([1, 2], precision=100)
+    assert res == [3, -1] and res[0].precision == (100, 100)
+    pytest.raises(TypeError, lambda: fft(1))
+    pytest.raises(TypeError, lambda: ifft(['a']))
+    pytest.raises(ValueError, lambda: fft([1], precision=-1))
+
+
+def test_mpc_fast_float():
+    import random
+
+    rnd = random.Random(42)
+    special = [0.0, -0.0, 1.0, -2.0, 0.5, 3.0, 1e-300, 1e300, 2.0**-1000,
+               2.0**1000, 5e-324, float('inf'), float('nan')]
+
+    def value():
+        k = rnd.random()
+        if k < 0.2:
+            return rnd.choice(special)
+        if k < 0.5:
+            return float(rnd.randint(-2**53, 2**53)) * 2.0**rnd.randint(-60, 10)
+        return rnd.uniform(-1, 1) * 2.0**rnd.randint(-40, 40)
+
+    for i in range(3000):
+        re1, im1, re2, im2 = value(), value(), value(), value()
+        if i % 4 == 0:
+            # The products nearly cancel.
+            re2, im2 = im1, re1 * (1 + rnd.choice([0, 2.0**-52, -2.0**-52]))
+        with gmpy2.local_context(gmpy2.ieee(64)):
+            x, y = mpc(re1, im1), mpc(re2, im2)
+        for op in (gmpy2.add, gmpy2.sub, gmpy2.mul):
+            results = []
+            for fast in (False, True):
+                with gmpy2.local_context(gmpy2.ieee(64, fast_float=fast)) as ctx:
+                    z = op(x, y) if i % 2 else op(x, complex(re2, im2))
+                    results.append((repr(z), z.rc, ctx.inexact, ctx.overflow,
+                                    ctx.underflow, ctx.invalid))
+            assert results[0] == results[1], (op, x, y)
+    with gmpy2.local_context(gmpy2.ieee(64, fast_float=True), trap_inexact=True):
+        assert mpc(1, 2) * mpc(3, 4) == mpc(-5, 10)
+        with pytest.raises(gmpy2.InexactResultError):
+            mpc(0.1, 0.2) * mpc(0.3, 0.7)
@@ -1,14 +1,15 @@
 from decimal import Decimal
+from fractions import Fraction
 
 import pytest
 from hypothesis import given, example, settings
-from hypothesis.strategies import floats
+from hypothesis.strategies import floats, integers, sampled_from
 import mpmath
 
 import gmpy2
 from gmpy2 import (gamma_inc, mpfr, cmp, cmp_abs, zero, nan, mpz, mpq,
                    to_binary, from_binary, is_nan, random_state,
-                   mpfr_grandom, mpfr_nrandom)
+                   mpfr_grandom, mpfr_nrandom, mpfr_list)
 from supportclasses import a, b, c, d, q, r
 
 
@@ -40,6 +41,14 @@ def test_mpfr_cmp():
     assert cmp(nan(), 1) == 0
     assert gmpy2.get_context().erange is True
 
+    n = 3**100
+    assert mpfr(n, 2000) == n and mpfr(n, 2000) < n + 1
+    assert mpfr(n) != n and (mpfr(n) > n) == (mpfr(n) > mpz(n))
+    assert mpfr(-n, 2000) < -n + 1 and mpfr('inf') > n and mpfr(0) > -n
+    gmpy2.get_context().clear_flags()
+    assert not nan() == n and nan() != n
+    assert gmpy2.get_context().erange is True
+
     assert cmp_abs(mpfr(-1), mpfr(0)) == 1
     assert cmp_abs(mpfr(-1), mpz(0)) == 1
     assert cmp_abs(mpfr(-1), mpq(0,1)) == 1
@@ -60,6 +69,29 @@ def test_mpfr_conversion():
     pytest.raises(TypeError, lambda: mpfr(d))
 
 
+def test_mpfr_from_Decimal():
+    assert mpfr(Decimal('0.1')) == mpfr('0.1')
+    assert mpfr(Decimal('0.1'), 200) == mpfr('0.1', 200)
+    assert mpfr(Decimal('1e-400')) == mpfr('1e-400')
+    assert mpfr(Decimal('-0')) == 0 and mpfr(Decimal('-0')).is_signed()
+    assert not mpfr(Decimal('0.000')).is_signed()
+    assert mpfr(Decimal('-inf')) == mpfr('-inf')
+    assert is_nan(mpfr(Decimal('nan')))
+
+
+def test_mpfr_list():
+    assert mpfr_list([]) == []
+    res = mpfr_list([1, '0.1', Decimal('0.1'), Fraction(1, 3), mpq(1, 3)],
+                    precision=100)
+    third = mpfr(mpq(1, 3), 100)
+    assert res == [1, mpfr('0.1', 100), mpfr('0.1', 100), third, third]
+    assert all(x.precision == 100 for x in res)
+    assert mpfr_list((2.5,))[0].precision == gmpy2.get_context().precision
+    pytest.raises(TypeError, lambda: mpfr_list(1))
+    pytest.raises(TypeError, lambda: mpfr_list([1j]))
+    pytest.raises(ValueError, lambda: mpfr_list([1], precision=-1))
+
+
 def test_mpfr_hash():
     assert hash(mpfr('123.456')) == hash(float('123.456'))
     assert hash(mpfr('123.5')) == hash(float('123.5'))
@@ -72,6 +104,10 @@ def test_mpfr_hash():
     assert hash(mpfr('-0')) == hash(float('-0'))
     assert hash(mpfr('123.456')) != hash(Decimal('123.456'))
     assert hash(mpfr('123.5')) == hash(Decimal('123.5'))
+    assert hash(mpfr(123.456, 1000)) == hash(123.456)
+    assert hash(mpfr(-2**80, 1000)) == hash(-2**80)
+    x = mpfr(1, 500) / 3
+    assert hash(x) == hash(Fraction(*x.as_integer_ratio()))
 
 
 @given(floats())
@@ -88,6 +124,103 @@ def test_mpfr_to_from_binary_bulk(r):
     assert x == y or (is_nan(x) and is_nan(y))
 
 
+def test_mpfr_arith_small_int():
+    x = mpfr("1.25")
+    for n in [0, 1, -1, 7, -2**40, -2**63, 2**80]:
+        assert x + n == n + x == x + mpfr(n)
+        assert x - n == x - mpfr(n)
+        assert n - x == mpfr(n) - x
+        assert x * n == n * x == x * mpfr(n)
+        assert (x < n) == (x < mpfr(n))
+    assert mpfr(2**53) + 1 == mpfr(2**53)
+    assert (nan() == 1) is False
+    assert (nan() != 1) is True
+
+
+@settings(max_examples=1000)
+@given(floats(), floats())
+@example(1.0, 3.0)
+@example(0.1, 0.2)
+@example(1e308, 10.0)
+@example(5e-324, 0.5)
+@example(1.0, 0.0)
+def test_mpfr_fast_float(x, y):
+    for size in (64, 32):
+        with gmpy2.local_context(gmpy2.ieee(size)) as ctx:
+            a, b = mpfr(x), mpfr(y)
+        for op in (gmpy2.add, gmpy2.sub, gmpy2.mul, gmpy2.div):
+            results = []
+            for fast in (False, True):
+                with gmpy2.local_context(gmpy2.ieee(size, fast_float=fast)) as ctx:
+                    assert ctx.fast_float is fast
+                    z = op(a, b)
+                    results.append((z, z.rc, ctx.inexact, ctx.overflow,
+                                    ctx.underflow, ctx.invalid, ctx.divzero))
+            (z1, *r1), (z2, *r2) = results
+            if is_nan(z1):
+                assert is_nan(z2)
+            else:
+                assert z1 == z2 and gmpy2.is_signed(z1) == gmpy2.is_signed(z2)
+            assert r1 == r2
+    with gmpy2.local_context(fast_float=True, trap_inexact=True) as ctx:
+        assert mpfr(1) / mpfr(4) == 0.25
+        with pytest.raises(gmpy2.InexactResultError):
+            mpfr(1) / mpfr(3)
+
+
+def test_mpfr_track_flags():
+    with gmpy2.local_context(track_flags=False) as ctx:
+        assert ctx.track_flags is False
+        ctx.clear_flags()
+        x = mpfr(1) / mpfr(3)
+        assert x.rc == -1 and not ctx.inexact
+        assert gmpy2.sqrt(mpfr(-1)) != 0 and not ctx.invalid
+        ctx.trap_inexact = True
+        with pytest.raises(gmpy2.InexactResultError):
+            mpfr(1) / mpfr(3)
+        assert ctx.inexact
+    with gmpy2.local_context(emax=4, track_flags=False):
+        assert mpfr(8) * mpfr(2) == mpfr('inf')
+
+
+@settings(max_examples=1000)
+@given(floats())
+@example(0.1)
+@example(1e16)
+@example(1e-5)
+@example(123456.0)
+@example(-0.0)
+@example(5e-324)
+def test_mpfr_format_shortest(x):
+    # A subnormal float only has its reduced precision with subnormalize.
+    with gmpy2.local_context(gmpy2.ieee(64)):
+        assert format(mpfr(x), 'r') == repr(x)
+    for prec in (24, 64, 113, 200):
+        y = mpfr(x, prec)
+        s = format(y, 'r')
+        assert mpfr(s, prec) == y or (is_nan(y) and s == 'nan')
+
+
+def test_mpfr_format_shortest_subnormal():
+    assert format(mpfr(5e-324), 'r') == '4.9406564584124654e-324'
+    with gmpy2.local_context(gmpy2.ieee(64)):
+        assert format(mpfr(5e-324), 'r') == '5e-324'
+        assert format(mpfr(-2.5e-320), 'r') == '-2.5e-320'
+        assert mpfr('5e-324') == mpfr(5e-324)
+
+
+def test_mpfr_format_shortest_options():
+    assert format(mpfr('0.1', 24), 'r') == '0.1'
+    assert format(mpfr(1)/3, '+r') == '+0.3333333333333333'
+    assert format(mpfr(-1)/3, '+r') == '-0.3333333333333333'
+    assert format(mpfr('1.5'), '>8r') == '     1.5'
+    assert format(mpfr('1e-7', 100), 'r') == '1e-07'
+    with pytest.raises(ValueError):
+        format(mpfr(1), '.5r')
+    assert str(mpfr(1)/3) == '0.33333333333333331'
+    assert repr(mpfr(1, 100)) == "mpfr('1.0',100)"
+
+
 def test_mpfr_to_from_binary():
     x = mpfr("1.345e1000")
     assert x==from_binary(to_binary(x))
@@ -109,8 +242,53 @@ def test_mpfr_to_from_binary():
         assert x.precision == 200
 
 
+def test_mpfr_const_cache():
+    gmpy2.clear_const_cache()
+    info = gmpy2.const_cache_info()
+    assert info['size'] == 32 and info['entries'] == []
+    x = gmpy2.const_pi(100)
+    y = gmpy2.const_pi(100)
+    assert x is y and y.rc == x.rc
+    assert gmpy2.const_pi(101) is not x
+    assert gmpy2.const_euler(100) is not x
+    with gmpy2.local_context(round=gmpy2.RoundUp):
+        z = gmpy2.const_pi(100)
+        assert z is not x and z > x
+    info = gmpy2.const_cache_info()
+    assert info['hits'] >= 1
+    assert ('pi', 100, int(gmpy2.RoundToNearest)) in info['entries']
+    with gmpy2.local_context(trap_inexact=True):
+        with pytest.raises(gmpy2.InexactResultError):
+            gmpy2.const_pi(100)
+    with gmpy2.local_context(emax=1):
+        assert gmpy2.const_pi(100) != x
+    assert gmpy2.clear_const_cache('pi', 101) == 1
+    assert gmpy2.clear_const_cache('pi') == 2
+    assert gmpy2.clear_const_cache() == 1
+    with pytest.raises(ValueError):
+        gmpy2.clear_const_cache('e')
+    gmpy2.set_const_cache(1)
+    gmpy2.const_log2(64)
+    gmpy2.const_catalan(64)
+    assert gmpy2.const_cache_info()['entries'] == [('catalan', 64, 0)]
+    gmpy2.set_const_cache(0)
+    assert gmpy2.const_log2(64) is not gmpy2.const_log2(64)
+    with pytest.raises(ValueError):
+        gmpy2.set_const_cache(257)
+    gmpy2.set_const_cache(32)
+    gmpy2.free_cache()
+    assert gmpy2.const_cache_info()['entries'] == []
+
+
 def test_mpfr_random():
     assert gmpy2.mpfr_random(random_state(42)) == mpfr('0.93002690534702315')
+    r1 = random_state(3)
+    r2 = random_state(3)
+    assert gmpy2.mpfr_random(r1, count=4) == [gmpy2.mpfr_random(r2) for _ in range(4)]
+    out = [0, 0]
+    assert gmpy2.mpfr_random(r1, out=out) is out
+    assert out == [gmpy2.mpfr_random(r2), gmpy2.mpfr_random(r2)]
+    pytest.raises(TypeError, lambda: gmpy2.mpfr_random(r1, out=bytearray(8)))
 
 
 def test_mpfr_grandom():
@@ -122,6 +300,286 @@ def test_mpfr_nrandom():
     assert mpfr_nrandom(random_state(42)) == mpfr('-0.32898912492644183')
 
 
+def test_mpfr_accumulator():
+    import array
+    import math
+    import random
+
+    from gmpy2 import mpfr_accumulator
+
+    rs = random.Random(42)
+    values = [rs.uniform(-1, 1) * 2.0**rs.randint(-60, 60) for _ in range(1000)]
+    acc = mpfr_accumulator()
+    acc.extend(values)
+    assert acc.result() == math.fsum(values) == gmpy2.fsum(values)
+    acc2 = mpfr_accumulator()
+    acc2.extend(array.array('d', values))
+    assert acc2.result() == acc.result()
+    acc3 = mpfr_accumulator(200)
+    for v in values:
+        acc3 += v
+    assert acc3.prec == 200 and acc3.result().precision == 200
+    assert mpfr(acc3) == acc3.result()
+
+    acc = mpfr_accumulator()
+    acc.extend([1e100, 1.0, -1e100])
+    assert acc.result() == 1
+    acc.add(mpz(10)**30)
+    acc.add(mpq(1, 2))
+    assert acc.result() == mpfr('1e30')
+    acc.clear()
+    acc.extend(array.array('q', [2**62, 5, -2**62]))
+    assert acc.result() == 5
+    assert repr(acc) == "mpfr_accumulator(mpfr('5.0'))"
+
+    acc = mpfr_accumulator()
+    assert not acc.result().is_signed()
+    acc.extend([-0.0, mpfr('-0')])
+    assert acc.result().is_zero() and acc.result().is_signed()
+    acc.add(0.0)
+    assert not acc.result().is_signed()
+    acc = mpfr_accumulator()
+    acc.extend([1.5, -1.5])
+    assert not acc.result().is_signed()
+    with gmpy2.local_context(round=gmpy2.RoundDown):
+        assert acc.result().is_signed()
+
+    acc = mpfr_accumulator()
+    acc.extend([float('inf'), 1])
+    assert acc.result() == float('inf')
+    acc.add(float('-inf'))
+    assert is_nan(acc.result())
+
+    with pytest.raises(TypeError):
+        acc.add('1')
+    with pytest.raises(TypeError):
+        acc.extend(mpz(5))
+    with pytest.raises(TypeError):
+        acc.extend(array.array('u', 'ab'))
+    with pytest.raises(ValueError):
+        mpfr_accumulator(-1)
+
+
+def test_mpfr_array():
+    import pickle
+    from gmpy2 import mpfr_array, mpc_array, mpc, is_infinite
+
+    a = mpfr_array(3)
+    assert len(a) == 3 and a.precision == 53
+    assert list(a) == [0, 0, 0]
+    assert repr(a) == 'mpfr_array([0.0, 0.0, 0.0], precision=53)'
+    assert len(mpfr_array()) == 0
+
+    a = mpfr_array([1, 2.5, mpq(1, 3)], precision=100)
+    assert a.precision == 100
+    assert a[2] == mpfr(mpq(1, 3), 100) and a[-1].precision == 100
+    assert isinstance(a[1:], mpfr_array) and a[::-1][0] == a[2]
+    a[0] = -7
+    a[1:] = [float('inf'), mpfr('-0')]
+    assert a[0] == -7 and is_infinite(a[1]) and a[2].is_signed()
+    assert a == mpfr_array([-7, float('inf'), 0.0])
+    assert mpfr_array(a, precision=2)[0] == -8
+    with gmpy2.local_context(precision=24):
+        assert mpfr_array([1]).precision == 24
+    with gmpy2.local_context(round=gmpy2.RoundDown):
+        assert mpfr_array([mpq(2, 3)], precision=4)[0] == mpfr('0.625')
+    with pytest.raises(TypeError):
+        mpfr_array([1j])
+    with pytest.raises(TypeError):
+        a[0] = '1'
+    with pytest.raises(ValueError):
+        a[:2] = [1]
+    with pytest.raises(IndexError):
+        a[3]
+    with pytest.raises(ValueError):
+        mpfr_array(-1)
+    with pytest.raises(ValueError):
+        mpfr_array(2, precision=-5)
+
+    nan_array = mpfr_array([float('nan')])
+    assert nan_array != nan_array
+
+    x = mpfr_array(range(1, 6))
+    y = mpfr_array([1e100, 1, -1e100, 1, 1])
+    assert gmpy2.fsum(y) == 3 and y.sum() == 3
+    assert gmpy2.dot(x, y) == x.dot(y) == mpfr(-2e100)
+    with pytest.raises(ValueError):
+        x.dot(mpfr_array(2))
+    with pytest.raises(TypeError):
+        x.dot([1, 2, 3, 4, 5])
+
+    r = gmpy2.vmap(gmpy2.sqrt, x)
+    assert isinstance(r, mpfr_array) and list(r) == [gmpy2.sqrt(v) for v in x]
+    assert gmpy2.vadd(x, 1) == mpfr_array(range(2, 7))
+    assert gmpy2.vsub(x, x) == mpfr_array(5)
+    assert gmpy2.vmul(2, x) == mpfr_array(range(2, 11, 2))
+    assert gmpy2.vdiv(x, mpfr_array([2] * 5, precision=80)).precision == 80
+    with pytest.raises(ValueError):
+        gmpy2.vadd(x, mpfr_array(2))
+    with gmpy2.local_context(trap_divzero=True):
+        with pytest.raises(gmpy2.DivisionByZeroError):
+            gmpy2.vdiv(x, 0)
+
+    for v in (a, x, mpfr_array(), mpfr_array([mpfr(1) / 3], precision=200),
+              mpfr_array([float('nan'), -float('nan')])):
+        b = v.to_binary()
+        w = gmpy2.from_binary(b)
+        assert isinstance(w, mpfr_array) and w.precision == v.precision
+        assert w.to_binary() == b
+        assert mpfr_array.from_binary(b).to_binary() == b
+        assert pickle.loads(pickle.dumps(v)).to_binary() == b
+    b = bytearray(x.to_binary())
+    with pytest.raises(ValueError):
+        gmpy2.from_binary(bytes(b[:-1]))
+    b[24] = 4
+    with pytest.raises(ValueError):
+        gmpy2.from_binary(bytes(b))
+    with pytest.raises(ValueError):
+        mpc_array.from_binary(x.to_binary())
+
+    c = mpc_array([1 + 2j, 3, mpc('1.5-2j')], precision=80)
+    assert c.precision == 80 and c[0] == mpc(1, 2)
+    assert c[0].precision == (80, 80)
+    assert repr(c[2:]) == 'mpc_array([1.5-2.0j], precision=80)'
+    assert c.sum() == mpc('5.5')
+    with gmpy2.local_context(precision=80):
+        assert list(gmpy2.vmap(gmpy2.exp, c)) == [gmpy2.exp(v) for v in c]
+    assert gmpy2.from_binary(c.to_binary()) == c
+    c[1:] = c[:2]
+    assert c == mpc_array([1 + 2j, 1 + 2j, 3])
+    with pytest.raises(TypeError):
+        mpc_array(['1'])
+
+
+def test_mpfr_array_from_buffer():
+    from gmpy2 import mpfr_array, mpc_array, mpc
+
+    a = mpfr_array([1, -2.5, float('inf'), 0.0, mpq(1, 3)], precision=100)
+    v = mpfr_array.from_buffer(bytearray(a.to_binary()))
+    assert v.readonly and not a.readonly
+    assert v.to_binary() == a.to_binary() and v.sum() == a.sum()
+    with pytest.raises(TypeError):
+        v[0] = 2
+    c = v.copy()
+    c[0] = 2
+    assert not c.readonly and c[0] == 2 and v[0] == 1
+    assert mpfr_array.from_buffer(memoryview(a.to_binary())) == a
+
+    z = mpc_array([1+2j, mpc(3, -4)], precision=70)
+    assert mpc_array.from_buffer(z.to_binary()) == z
+    with pytest.raises(ValueError):
+        mpc_array.from_buffer(a.to_binary())
+    with pytest.raises(ValueError):
+        mpfr_array.from_buffer(a.to_binary()[:-1])
+    with pytest.raises(TypeError):
+        mpfr_array.from_buffer([1, 2])
+
+
+def test_evaluate():
+    from gmpy2 import evaluate, get_context
+
+    precs = []
+
+    def f():
+        precs.append(get_context().precision)
+        return gmpy2.exp(mpfr(10)**-20) - 1 - mpfr(10)**-20
+
+    r = evaluate(f, 30)
+    assert r.precision == 101
+    assert '{0:.30g}'.format(r) == '5.00000000000000000001666666667e-41'
+    assert precs == sorted(precs) and len(precs) >= 2
+    assert all(p2 == 2 * p1 for p1, p2 in zip(precs, precs[1:]))
+    assert get_context().precision == 53
+
+    r = evaluate(gmpy2.const_pi, 40)
+    assert r == gmpy2.const_pi(precision=r.precision) and r.precision > 133
+    assert evaluate(lambda: mpfr(1)/4, 10) == 0.25
+    assert evaluate(lambda: 3, 10) == 3
+    assert evaluate(lambda: mpfr(0), 10) == 0
+    assert is_nan(evaluate(gmpy2.nan, 10))
+
+    with pytest.raises(ValueError):
+        evaluate(lambda: mpfr(2)**get_context().precision, 10, max_prec=500)
+    with pytest.raises(ValueError):
+        evaluate(f, 30, max_prec=50)
+    with pytest.raises(ValueError):
+        evaluate(f, 0)
+    with pytest.raises(TypeError):
+        evaluate(lambda: 'x', 10)
+    with pytest.raises(TypeError):
+        evaluate(1, 10)
+    with pytest.raises(ZeroDivisionError):
+        evaluate(lambda: 1/0, 10)
+    assert get_context().precision == 53
+
+
+@settings(max_examples=500)
+@given(integers(), integers(-300, 300), integers(), integers(-300, 300),
+       integers(0, 200), sampled_from('nfcdu'))
+@example(1, 0, -1, 0, 53, 'n')
+@example(3, 1000, 1, -1000, 20, 'u')
+@example(-3, 1000, 1, -1000, 20, 'f')
+def test_mpmath_kernels(m1, e1, m2, e2, prec, rnd):
+    from mpmath.libmp import from_man_exp, mpf_add, mpf_mul, mpf_div, mpf_sqrt
+
+    s = from_man_exp(m1, e1)
+    t = from_man_exp(m2, e2)
+    assert gmpy2._mpmath_add(s, t, prec, rnd) == mpf_add(s, t, prec, rnd)
+    assert gmpy2._mpmath_add(s, t, prec, rnd, 1) == mpf_add(s, t, prec, rnd, 1)
+    assert gmpy2._mpmath_mul(s, t, prec, rnd) == mpf_mul(s, t, prec, rnd)
+    if prec:
+        if m2:
+            assert gmpy2._mpmath_div(s, t, prec, rnd) == mpf_div(s, t, prec, rnd)
+        else:
+            with pytest.raises(ZeroDivisionError):
+                gmpy2._mpmath_div(s, t, prec, rnd)
+        if m1 >= 0:
+            assert gmpy2._mpmath_sqrt(s, prec, rnd) == mpf_sqrt(s, prec, rnd)
+        else:
+            assert gmpy2._mpmath_sqrt(s, prec, rnd) is NotImplemented
+
+
+@given(integers(0, 2**300), integers(-100, 100), integers(1, 200),
+       sampled_from('nfcdu'))
+@example(2**53 - 1, 0, 52, 'n')
+@example(12, 0, 10, 'd')
+@example(5, 2**70, 1, 'u')
+def test_mpmath_normalize_list(man, exp, prec, rnd):
+    values = []
+    for sign in (0, 1):
+        for m in (man, man + 1, 2 * man):
+            values.append((sign, mpz(m), exp, mpz(m).bit_length()))
+            values.append((sign, m, exp, m.bit_length()))
+    expected = [gmpy2._mpmath_normalize(*v, prec, rnd) for v in values]
+    assert gmpy2._mpmath_normalize_list(values, prec, rnd) == expected
+    assert gmpy2._mpmath_normalize_list(tuple(values), prec, rnd) == expected
+
+
+def test_mpmath_kernels_special():
+    from mpmath.libmp import finf, fnan, fone
+
+    assert gmpy2._mpmath_add(fone, finf) is NotImplemented
+    assert gmpy2._mpmath_mul(fnan, fone, 53) is NotImplemented
+    assert gmpy2._mpmath_div(fone, (0, 1, 2**80, 1), 53) is NotImplemented
+    assert gmpy2._mpmath_sqrt(finf, 53) is NotImplemented
+    with pytest.raises(ValueError):
+        gmpy2._mpmath_add(fone, fone, 53, 'x')
+    with pytest.raises(ValueError):
+        gmpy2._mpmath_div(fone, fone, 0)
+    with pytest.raises(TypeError):
+        gmpy2._mpmath_mul(fone)
+    with pytest.raises(TypeError):
+        gmpy2._mpmath_normalize_list([(0, 1, 0)], 53, 'n')
+    assert gmpy2._mpmath_normalize_list([], 53) == []
+
+    # The mantissas are rounded in a copy, not in the (shared) argument.
+    m = mpz(12)
+    assert gmpy2._mpmath_normalize_list([(0, 12, 0, 4), (1, m, 0, 4)],
+                                        2, 'n') == [(0, mpz(3), 2, 2),
+                                                    (1, mpz(3), 2, 2)]
+    assert m == 12 and mpz(12) == 12 and mpz(6) + 6 == 12
+
+
 def test_mpfr_mpmath():
     a, b, c, d = '1.1', '-1.1', '-3.14', '0'
     assert mpfr(a)._mpf_ == (0, mpz(4953959590107546), -52, 53)
@@ -1,12 +1,16 @@
 import numbers
 import pickle
+import sys
 from decimal import Decimal
+from fractions import Fraction
 
 import pytest
 from hypothesis import given, example, settings
 from hypothesis.strategies import integers
 
-from gmpy2 import mpq, mpz, cmp, cmp_abs, from_binary, to_binary
+from gmpy2 import (mpq, mpz, cmp, cmp_abs, from_binary, to_binary,
+                   RationalAccumulator, mpq_list, mpq_many,
+                   mpz_array)
 from supportclasses import a, b, c, d, q, z
 
 
@@ -33,6 +37,49 @@ def test_mpq_from_Decimal():
     assert mpq(Decimal(1)) == mpq(1)  # issue 327
     assert mpq(Decimal('0.6')) == mpq(3, 5)
     assert mpq.from_decimal(Decimal("5e-3")) == mpq(5, 1000)
+    pytest.raises(OverflowError, lambda: mpq(Decimal('-inf')))
+    pytest.raises(ValueError, lambda: mpq(Decimal('nan')))
+
+
+def test_mpq_from_Fraction():
+    assert mpq(Fraction(-3, 6)) == mpq(-1, 2)
+    big = Fraction(7**100, 3**80)
+    assert mpq(big) == mpq(7**100, 3**80)
+
+
+def test_mpq_list():
+    assert mpq_list([]) == []
+    res = mpq_list([1, 2.5, Fraction(1, 3), Decimal('0.1'), '3/4', mpz(7)])
+    assert res == [mpq(1), mpq(5, 2), mpq(1, 3), mpq(1, 10), mpq(3, 4), mpq(7)]
+    assert all(isinstance(x, mpq) for x in res)
+    assert mpq_list(iter([q])) == [mpq(3, 2)]
+    pytest.raises(TypeError, lambda: mpq_list(1))
+    pytest.raises(TypeError, lambda: mpq_list([1j]))
+    pytest.raises(ValueError, lambda: mpq_list(['x']))
+
+
+def test_mpq_canonical():
+    assert mpq(3, 4, canonical=True) == mpq(3, 4)
+    assert mpq(mpz(-1), -3, canonical=True) == mpq(1, 3)
+    assert mpq(0, 1, canonical=True) == 0
+    assert mpq(2, -4, canonical=False) == mpq(-1, 2)
+    pytest.raises(ZeroDivisionError, lambda: mpq(1, 0, canonical=True))
+    pytest.raises(TypeError, lambda: mpq(1.5, 2, canonical=True))
+    pytest.raises(TypeError, lambda: mpq(1, canonical=True))
+
+    nums = list(range(-50, 50))
+    dens = [2*n + 1 for n in range(100)]
+    expected = [mpq(n, d) for n, d in zip(nums, dens)]
+    assert mpq_many(nums, dens) == expected
+    assert mpq_many(mpz_array(nums), dens) == expected
+    assert mpq_many(nums, [-d for d in dens]) == [-x for x in expected]
+    reduced = [(x.numerator, x.denominator) for x in expected]
+    assert mpq_many(*zip(*reduced), canonical=True) == expected
+    assert mpq_many([], []) == []
+    pytest.raises(ZeroDivisionError, lambda: mpq_many([1, 2], [1, 0]))
+    pytest.raises(ValueError, lambda: mpq_many([1], [1, 2]))
+    pytest.raises(TypeError, lambda: mpq_many([mpq(1, 2)], [1]))
+    pytest.raises(TypeError, lambda: mpq_many(1, [1]))
 
 
 def test_mpq_cmp():
@@ -53,6 +100,16 @@ def test_mpq_cmp():
     assert cmp(q, mpq(3,5)) == 1
 
 
+def test_mpq_richcompare_big_int():
+    for n in [2**64 + 1, 3**100, -2**200]:
+        for num, den in [(n, 1), (n * 3 + 1, 3), (n * 3 - 1, 3),
+                         (n * 2**70 + 1, 2**70), (n, 2**70), (-n, 7), (1, n)]:
+            x, y = mpq(num, den), Fraction(num, den)
+            assert (x < n) == (y < n)
+            assert (x == n) == (y == n)
+            assert (x > n) == (y > n)
+
+
 def test_mpq_conversion():
     x = mpq(a)
     assert isinstance(x, mpq)
@@ -84,5 +141,118 @@ def test_mpq_to_from_binary(p, q):
     assert x == from_binary(to_binary(x))
 
 
+@settings(max_examples=1000)
+@given(integers(), integers(min_value=1), integers(min_value=-2**70, max_value=2**70))
+@example(3, 4, 0)
+@example(-5, 6, -4)
+@example(1, 6, -2**63)
+def test_mpq_arith_small_int(p, q, n):
+    x = mpq(p, q)
+    f = Fraction(p, q)
+    assert x + n == n + x == f + n
+    assert x - n == f - n
+    assert n - x == n - f
+    assert x * n == n * x == f * n
+    assert (x < n) == (f < n)
+    assert (x == n) == (f == n)
+
+
 def test_mpq_hash():
-    hash(mpq(123456,1000)) == hash(Decimal('123.456'))
+    assert hash(mpq(123456,1000)) == hash(Decimal('123.456'))
+    P = sys.hash_info.modulus
+    for n, d in [(1, 3), (-1, 3), (2**200 + 1, 3**90), (-7**50, 2**70),
+                 (1, P), (-1, P), (P - 1, P + 1), (2*P, 3), (-1, 1),
+                 (-2, 1), (10**40, 255), (-3, 256)]:
+        assert hash(mpq(n, d)) == hash(Fraction(n, d))
+
+
+def test_rational_accumulator():
+    acc = RationalAccumulator()
+    assert acc.value == 0 and acc.reduce_bits == 4096
+    assert repr(acc) == 'RationalAccumulator(mpq(0,1))'
+    total = Fraction(0)
+    for k in range(1, 500):
+        acc += mpq(1, k)
+        total += Fraction(1, k)
+    assert acc.value == total and type(acc.value) is mpq
+    assert mpq(acc) == total and mpq(1, 2) + acc == total + Fraction(1, 2)
+
+    for bits in (0, 1, 64):
+        acc = RationalAccumulator(Fraction(1, 3), reduce_bits=bits)
+        acc *= 3
+        acc -= 2
+        acc /= mpq(-1, 5)
+        assert acc.value == 5
+        acc.addmul(mpq(1, 2), 4)
+        acc.submul(3, Fraction(1, 3))
+        assert acc.value == 6
+        acc.add(mpz(1))
+        acc.sub(mpq(1, 7))
+        acc.mul(7)
+        acc.div(Fraction(2, 3))
+        assert acc.value == Fraction(144, 2)
+        acc += acc
+        acc *= acc
+        assert acc.value == 144**2
+        acc /= acc
+        assert acc.value == 1
+
+    acc = RationalAccumulator(reduce_bits=0)
+    for k in range(2, 40):
+        acc.add(mpq(1, k))
+    acc.reduce()
+    assert acc.value == sum(Fraction(1, k) for k in range(2, 40))
+    acc.reduce_bits = 100
+    assert acc.reduce_bits == 100
+
+    with pytest.raises(ZeroDivisionError):
+        acc /= 0
+    with pytest.raises(TypeError):
+        acc += 1.5
+    with pytest.raises(TypeError):
+        acc.add('1')
+    with pytest.raises(TypeError):
+        acc.addmul(1)
+    with pytest.raises(ValueError):
+        RationalAccumulator(reduce_bits=-1)
+    with pytest.raises(ValueError):
+        acc.reduce_bits = -1
+
+
+def test_continued_fractions():
+    from gmpy2 import cont_frac, convergents, limit_denominator, mpfr
+
+    def ref_cf(x):
+        n, d = x.numerator, x.denominator
+        terms = []
+        while d:
+            a, r = divmod(n, d)
+            terms.append(a)
+            n, d = d, r
+        return terms
+
+    xs = [Fraction(355, 113), Fraction(-1, 3), Fraction(0), Fraction(7),
+          Fraction(3**400 + 1, 2**600 - 5), Fraction(-(5**300), 7**200 + 3)]
+    for x in xs:
+        terms = ref_cf(x)
+        assert cont_frac(x) == terms
+        assert cont_frac(mpq(x), 3) == terms[:3]
+        conv = convergents(x)
+        assert len(conv) == len(terms) and conv[-1] == x
+        assert convergents(x, max_terms=2) == conv[:2]
+        for md in (1, 2, 113, 10**20, 2**500 + 1):
+            assert limit_denominator(x, md) == x.limit_denominator(md)
+
+    assert cont_frac(mpfr(1.5)) == [1, 2] and cont_frac(0.75) == [0, 1, 3]
+    assert convergents(mpq(355, 113)) == [mpq(3), mpq(22, 7), mpq(355, 113)]
+    assert limit_denominator(mpfr('3.14159265358979'), 1000) == mpq(355, 113)
+    assert cont_frac(5, 0) == []
+
+    with pytest.raises(ValueError):
+        cont_frac(1, -1)
+    with pytest.raises(ValueError):
+        limit_denominator(mpq(1, 3), 0)
+    with pytest.raises(TypeError):
+        cont_frac('1/3')
+    with pytest.raises(OverflowError):
+        convergents(mpfr('inf'))
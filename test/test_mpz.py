@@ -5,11 +5,22 @@ from decimal import Decimal
 
 from hypothesis import assume, given, example, settings
 from hypothesis.strategies import booleans, integers, sampled_from
-from pytest import raises, mark
+from pytest import raises, mark, skip
 
 from gmpy2 import (mpz, pack, unpack, cmp, cmp_abs, to_binary, from_binary,
                    random_state, mpz_random, mpz_urandomb, mpz_rrandomb,
-                   mp_version)
+                   mp_version, mpz_array, xmpz, vadd, vmul, vmod, prod,
+                   remainder_tree, mpq, next_prime, batch_gcd, crt, CRTPlan,
+                   RNS, rns, smooth_part, trial_factor, primerange,
+                   powmod, powmod_multi, FixedBasePowMod, Modulus, Divisor, invert_many,
+                   is_prime, is_prime_list, is_bpsw_prp, is_bpsw_prp_list,
+                   primerange, iter_primes, prime_pi, nth_prime, random_prime, lucasu, lucasv, lucasu_mod,
+                   lucasv_mod, lucasu_mod_list, lucasv_mod_list, fac, primorial, bincoef, bincoef_row,
+                   set_fac_cache, fac_cache_info, vmap, fib, fib2, lucas,
+                   fib_mod, fib2_mod, lucas_mod, fac_mod, factor, discrete_log,
+                   jacobi_list, legendre_list, kronecker_list,
+                   popcount_many, hamdist_many, bit_test_many,
+                   sort, argsort, bisect)
 from supportclasses import a, b, c, d, z, q
 
 
@@ -133,6 +144,40 @@ def test_mpz_from_bytes(x, length, byteorder, signed):
         assert rx == mpz.from_bytes(list(bytes), byteorder, signed=signed)
 
 
+def test_mpz_bytes_many():
+    for width in (1, 3, 8, 9):
+        for signed in (False, True):
+            lo = -(1 << (8*width - 1)) if signed else 0
+            hi = (1 << (8*width - 1)) if signed else 1 << (8*width)
+            values = [lo, hi - 1, 0, 1, (lo + hi)//3]
+            for byteorder in ('big', 'little'):
+                data = mpz.to_bytes_many(values, width, byteorder,
+                                         signed=signed)
+                assert data == b''.join(mpz(x).to_bytes(width, byteorder,
+                                                        signed=signed)
+                                        for x in values)
+                res = mpz.from_bytes_many(data, width, byteorder,
+                                          signed=signed)
+                assert res == values
+                assert all(type(x) is mpz for x in res)
+                arr = mpz.from_bytes_many(bytearray(data), width, byteorder,
+                                          signed=signed, array=True)
+                assert isinstance(arr, mpz_array) and list(arr) == values
+                assert mpz.to_bytes_many(arr, width, byteorder,
+                                         signed=signed) == data
+                for bad in (lo - 1, hi):
+                    with raises(OverflowError, match=r'values\[1\]'):
+                        mpz.to_bytes_many([0, bad], width, byteorder,
+                                          signed=signed)
+
+    assert mpz.from_bytes_many(b'', 4) == []
+    assert mpz.to_bytes_many([], 4) == b''
+    raises(ValueError, lambda: mpz.from_bytes_many(b'abc', 2))
+    raises(ValueError, lambda: mpz.from_bytes_many(b'ab', 0))
+    raises(ValueError, lambda: mpz.to_bytes_many([1], 1, 'middle'))
+    raises(TypeError, lambda: mpz.to_bytes_many([mpq(1, 2)], 1))
+
+
 def test_mpz_as_integer_ratio():
     assert mpz(3).as_integer_ratio() == (mpz(3), mpz(1))
 
@@ -147,6 +192,108 @@ def test_mpz_pickling():
             assert pickle.loads(pickle.dumps(x, protocol=proto)) == x
 
 
+def test_mpz_pickle_buffers():
+    import gmpy2
+
+    x = mpz(7)**20000
+    assert x.__reduce__() == (from_binary, (to_binary(x),))
+    assert from_binary(bytearray(to_binary(x))) == x
+    assert from_binary(memoryview(to_binary(x))) == x
+    with raises(TypeError):
+        from_binary("abc")
+
+    if pickle.HIGHEST_PROTOCOL < 5:
+        return
+    buffers = []
+    data = pickle.dumps(x, protocol=5, buffer_callback=buffers.append)
+    assert len(buffers) == 1
+    assert len(data) < 100
+    assert pickle.loads(data, buffers=buffers) == x
+    assert pickle.loads(pickle.dumps(x, protocol=5)) == x
+
+    # Small values stay in-band.
+    buffers = []
+    pickle.dumps(mpz(5), protocol=5, buffer_callback=buffers.append)
+    assert buffers == []
+    for y in [xmpz(x), mpq(x, 3), gmpy2.mpfr(x), gmpy2.mpc(x, 1)]:
+        buffers = []
+        data = pickle.dumps(y, protocol=5, buffer_callback=buffers.append)
+        assert pickle.loads(data, buffers=buffers) == y
+
+
+def test_to_binary_compact():
+    import gmpy2
+
+    for n in [0, 1, -1, 63, -64, 64, 2**31, -2**32, 2**63 - 1, -(2**63 - 1)]:
+        data = to_binary(mpz(n), compact=True)
+        assert data[0] == 7
+        if abs(n) < 2**56:
+            assert len(data) <= len(to_binary(mpz(n)))
+        assert from_binary(data) == n
+        assert type(from_binary(data)) is mpz
+    assert to_binary(mpz(0), compact=True) == b'\x07\x00'
+    assert to_binary(mpz(-1), compact=True) == b'\x07\x01'
+    assert to_binary(mpz(300), compact=True) == b'\x07\xd8\x04'
+    for n in [2**63, -2**63, 2**100]:
+        assert to_binary(mpz(n), compact=True) == to_binary(mpz(n))
+    assert to_binary(xmpz(5), compact=True) == to_binary(xmpz(5))
+    assert to_binary(mpq(1, 3), compact=True) == to_binary(mpq(1, 3))
+    for bad in [b'\x07', b'\x07\x80', b'\x07\x01\x01', b'\x07' + b'\xff'*9 + b'\x02']:
+        with raises(ValueError):
+            from_binary(bad)
+
+    records = [to_binary(mpz(5), compact=True), to_binary(mpz(-7))]
+    data = b''.join(len(r).to_bytes(8, 'little') + r for r in records)
+    assert list(gmpy2.from_binary_many(data, array=True)) == [5, -7]
+
+
+def test_binary_many():
+    import gmpy2
+
+    values = [mpz(0), mpz(-5), mpz(7)**100, xmpz(12), 3, -2**70,
+              mpq(2, 3), gmpy2.mpfr(1.5), gmpy2.mpc(1, 2)]
+    data = gmpy2.to_binary_many(values)
+    assert isinstance(data, bytes)
+    result = gmpy2.from_binary_many(data)
+    assert result == values
+    assert [type(v) for v in result[:4]] == [mpz, mpz, mpz, xmpz]
+    assert type(result[4]) is mpz
+    assert gmpy2.from_binary_many(memoryview(data)) == values
+    assert gmpy2.to_binary_many([]) == b''
+    assert gmpy2.from_binary_many(b'') == []
+
+    ints = [0, 1, -1, 2**64, -3**90, mpz(5)]
+    data = gmpy2.to_binary_many(ints)
+    arr = gmpy2.from_binary_many(data, array=True)
+    assert list(arr) == ints
+    with raises(ValueError):
+        gmpy2.from_binary_many(gmpy2.to_binary_many([mpq(1, 2)]), array=True)
+
+    buf = bytearray(len(data) + 10)
+    assert gmpy2.to_binary_many(ints, out=buf) == len(data)
+    assert bytes(buf[:len(data)]) == data
+    with raises(ValueError):
+        gmpy2.to_binary_many(ints, out=bytearray(3))
+    with raises(ValueError):
+        gmpy2.from_binary_many(data[:-1])
+    with raises(TypeError):
+        gmpy2.to_binary_many([1.5])
+
+    offset, found = 0, []
+    view = memoryview(gmpy2.to_binary_many(values))
+    while offset < len(view):
+        value, used = gmpy2.from_binary_at(view, offset)
+        found.append(value)
+        offset += used
+    assert found == values and offset == len(view)
+    with raises(ValueError):
+        gmpy2.from_binary_at(view, len(view))
+    with raises(ValueError):
+        gmpy2.from_binary_at(view, -1)
+    with raises(ValueError):
+        gmpy2.from_binary_at(view[:-1], offset - used)
+
+
 @settings(max_examples=1000)
 @given(integers(), integers())
 @example(0, 0)
@@ -208,6 +355,77 @@ def test_mpz_pack_unpack():
     raises(ValueError, lambda: unpack(-1, 1))
 
 
+
+@settings(max_examples=500)
+@given(integers(min_value=0, max_value=2**2000),
+       integers(min_value=1, max_value=64))
+def test_mpz_pack_unpack_buffer(x, n):
+    from array import array
+    import gmpy2
+
+    fields = unpack(x, n)
+    out = array('Q', [7]) * (len(fields) + 2)
+    assert gmpy2.unpack_buffer(x, n, out) == len(fields)
+    assert list(out[:len(fields)]) == fields
+    assert list(out[len(fields):]) == [7, 7]
+    assert gmpy2.pack_buffer(out[:len(fields)], n) == x
+
+
+@settings(max_examples=200)
+@given(integers(min_value=0, max_value=60), integers(min_value=0, max_value=60),
+       integers(min_value=0, max_value=2**300))
+def test_mpz_poly_mul_bulk(na, nb, seed):
+    import random
+    import gmpy2
+
+    rnd = random.Random(seed)
+    a = [rnd.randrange(-2**rnd.randrange(1, 200), 2**rnd.randrange(1, 200))
+         for _ in range(na)]
+    b = [rnd.randrange(-2**rnd.randrange(1, 70), 2**rnd.randrange(1, 70))
+         for _ in range(nb)]
+    expected = [0] * (na + nb - 1) if a and b else []
+    for i, x in enumerate(a):
+        for j, y in enumerate(b):
+            expected[i + j] += x * y
+    assert gmpy2.poly_mul(a, b) == expected
+    assert gmpy2.poly_mul(a, a) == gmpy2.poly_mul(a, list(a))
+
+
+def test_mpz_poly_mul():
+    import gmpy2
+
+    assert gmpy2.poly_mul([1, 1], [1, -1]) == [1, 0, -1]
+    assert gmpy2.poly_mul([mpz(-3)], (xmpz(5), 0, -1)) == [-15, 0, 3]
+    assert gmpy2.poly_mul([0, 0], [0]) == [0, 0]
+    assert gmpy2.poly_mul([], [1, 2]) == []
+    assert all(type(c) is mpz for c in gmpy2.poly_mul([1, 2], [3]))
+    n = 5000
+    assert gmpy2.poly_mul([1] * n, [1] * n) == list(range(1, n + 1)) + list(range(n - 1, 0, -1))
+
+    raises(TypeError, lambda: gmpy2.poly_mul([1.5], [1]))
+    raises(TypeError, lambda: gmpy2.poly_mul(1, [1]))
+    raises(TypeError, lambda: gmpy2.poly_mul([1]))
+
+
+def test_mpz_pack_buffer_errors():
+    from array import array
+    import gmpy2
+
+    assert gmpy2.pack_buffer(array('Q'), 5) == 0
+    assert gmpy2.pack_buffer(array('Q', [2**64 - 1, 1]), 64) == 2**64 + 2**64 - 1
+    assert gmpy2.pack_buffer(memoryview(array('Q', [1, 2, 3])), 2) == 0b111001
+    raises(ValueError, lambda: gmpy2.pack_buffer(array('Q', [4]), 2))
+    raises(ValueError, lambda: gmpy2.pack_buffer(array('Q', [1]), 0))
+    raises(ValueError, lambda: gmpy2.pack_buffer(array('Q', [1]), 65))
+    raises(TypeError, lambda: gmpy2.pack_buffer(array('i', [1]), 2))
+    raises(TypeError, lambda: gmpy2.pack_buffer(b'12345678', 2))
+
+    out = array('Q', [0])
+    raises(ValueError, lambda: gmpy2.unpack_buffer(2**10, 5, out))
+    raises(ValueError, lambda: gmpy2.unpack_buffer(-1, 5, out))
+    raises(TypeError, lambda: gmpy2.unpack_buffer(1, 5, bytes(8)))
+    assert gmpy2.unpack_buffer(0, 5, out) == 1 and out[0] == 0
+
 def test_mpz_cmp():
     assert cmp(0, mpz(0)) == 0
     assert cmp(1, mpz(0)) == 1
@@ -233,6 +451,46 @@ def test_mpz_cmp():
     assert cmp(mpz(1), mpz(q)) == 0
 
 
+def test_root_lists():
+    import gmpy2
+    from gmpy2 import (is_square_list, is_power_list, isqrt_list, iroot_list,
+                       is_square, is_power, isqrt, iroot)
+
+    values = [0, 1, 2, 4, 63, 64, 65, 121, 2**64, 3**41, 3**40, 7**30 + 1,
+              (2**100 + 1)**2, (2**100 + 1)**2 - 1, 45045**2, 12345678**3]
+    values += list(range(200))
+    assert is_square_list(values) == [is_square(x) for x in values]
+    assert is_power_list(values) == [is_power(x) for x in values]
+    assert isqrt_list(values) == [isqrt(x) for x in values]
+    for n in (1, 2, 3, 7):
+        assert iroot_list(values, n) == [iroot(x, n) for x in values]
+    assert is_square_list(iter([-4, 9])) == [False, True]
+    assert is_power_list([-8]) == [True]
+    assert isqrt_list([]) == []
+    with gmpy2.local_context(threads=3, release_gil_min_bits=0):
+        assert is_square_list(values) == [is_square(x) for x in values]
+    with raises(ValueError):
+        isqrt_list([4, -1])
+    with raises(ValueError):
+        iroot_list([-1], 3)
+    with raises(ValueError):
+        iroot_list([1], 0)
+    with raises(TypeError):
+        is_square_list([1.5])
+    with raises(TypeError):
+        iroot_list([1])
+
+
+def test_mpz_richcompare_big_int():
+    for n in [2**64 - 1, 2**64, 2**64 + 1, 3**100, 2**200 + 2**70]:
+        for m in [n - 1, n, n + 1, n ^ 2**64, -n, 0, 5, 2 * n]:
+            for x, y in [(m, n), (m, -n), (-m, n)]:
+                assert (mpz(x) < y) == (x < y)
+                assert (mpz(x) == y) == (x == y)
+                assert (mpz(x) > y) == (x > y)
+                assert (y <= mpz(x)) == (y <= x)
+
+
 def test_mpz_conversion():
     x = mpz(a)
     assert isinstance(x, mpz)
@@ -248,6 +506,19 @@ def test_mpz_conversion_bulk(n):
     assert int(mpz(n)) == n
 
 
+def test_mpz_conversion_sizes():
+    for bits in list(range(0, 200)) + [959, 960, 961, 1023, 1024, 1025, 30000]:
+        for n in (2**bits - 1, 2**bits, 2**bits + 1, 3**(bits // 2 + 1)):
+            for v in (n, -n):
+                z = mpz(v)
+                assert int(z) == v
+                assert z == v
+                assert z + 0 == v
+                assert z.digits(16) == format(v, "x")
+                if bits < 10000:
+                    assert str(z) == str(v)
+
+
 @settings(max_examples=1000)
 @given(integers())
 @example(0)
@@ -259,8 +530,116 @@ def test_mpz_to_from_binary(n):
     assert x == from_binary(to_binary(x))
 
 
+def test_mpz_small_integers():
+    import gmpy2
+
+    assert mpz(5) is mpz(5)
+    assert mpz() is mpz(0)
+    assert mpz(-5) is mpz(-5)
+    assert mpz(256) is mpz(256)
+    assert mpz(257) is not mpz(257)
+    assert mpz(3) + 2 is mpz(5)
+    assert mpz(3) - mpz(3) is mpz(0)
+    assert mpz(2**70) % 7 is mpz(2**70 % 7)
+    assert mpz(2**70) // 2**69 is mpz(2)
+
+    # Functions that compute in place must not change the shared objects.
+    assert gmpy2.isqrt(16) == 4
+    assert gmpy2.next_prime(7) == 11
+    assert mpz(6) & 3 == 2
+    assert 6 & mpz(3) == 2
+    assert gmpy2.context().abs(-7) == 7
+    a, b = mpz(16), mpz(-7)
+    assert (gmpy2.isqrt(a), gmpy2.next_prime(a), a & 3, abs(b)) == (4, 17, 0, 7)
+    assert (a, b) == (16, -7)
+    for i in range(-5, 257):
+        assert mpz(i) == i
+        assert int(mpz(i)) == i
+
+def test_constructor_calls():
+    from fractions import Fraction
+    from gmpy2 import mpfr, mpc
+
+    assert mpz(" 0x1f ") == 31
+    assert mpz("1f", 16) == mpz("1f", base=16) == 31
+    assert mpz(s="ff", base=16) == 255
+    assert mpz(7.9) == 7
+    with raises(TypeError):
+        mpz(7, 10)
+    assert mpq() == 0
+    assert mpq("3/4") == mpq(3, 4) == Fraction(3, 4)
+    assert mpq(mpq(1, 2), 3) == mpq(1, 6)
+    assert mpq(0.5) == mpq(1, 2)
+    with raises(ZeroDivisionError):
+        mpq(1, 0)
+    assert mpfr() == 0
+    assert mpfr("1.5") == mpfr(1.5) == 1.5
+    assert mpfr(1, 100).precision == mpfr(1, precision=100).precision == 100
+    assert mpfr(mpq(1, 3), 30) == mpfr(mpq(1, 3), precision=30)
+    assert mpfr("ff", 0, 16) == 255
+    with raises(ValueError):
+        mpfr(1, -1)
+    assert mpc() == 0
+    assert mpc(1, 2) == mpc(1, imag=2) == 1+2j
+    assert mpc(3) == mpc(3j) - 3j + 3
+    assert mpc("1+2j") == 1+2j
+    assert mpc(1, 2, 60).precision == (60, 60)
+    with raises(TypeError):
+        mpc(1, 2j)
+
+
+def test_mpz_from_strings():
+    from gmpy2 import mpz_from_strings
+
+    big = 2**64
+    for text, base, value in [("1_000 000", 10, 10**6), ("-0o17", 0, -15),
+                              ("0b101", 2, 5), ("Zz", 36, 1295),
+                              ("Zz", 62, 2231), (str(big - 1), 10, big - 1),
+                              (str(big), 10, big), (" 12\t", 10, 12),
+                              ("007", 0, 7), (b"-42", 10, -42)]:
+        assert mpz(text, base) == value
+        assert mpz_from_strings([text], base) == [value]
+    for text in ["", "12a", "1.5", "\u0661", b"\xff1"]:
+        with raises(ValueError):
+            mpz(text)
+    assert mpz_from_strings(iter(["1", "-0x10", b"7"])) == [1, -16, 7]
+    assert mpz_from_strings(()) == []
+    assert mpz_from_strings(["9" * 5000]) == [mpz("9" * 5000)]
+    with raises(ValueError, match="string 1"):
+        mpz_from_strings(["1", "x"])
+    with raises(TypeError):
+        mpz_from_strings([1])
+    with raises(ValueError):
+        mpz_from_strings(["1"], 1)
+
+
+def test_mpz_temporaries():
+    from gmpy2 import mpfr
+
+    a = mpz(3)**100
+    b = mpz(7)**80
+    x = a*b + b*a - a//7 % b
+    assert x == 2*3**100*7**80 - (3**100//7) % 7**80
+    assert a == 3**100 and b == 7**80
+    h = hash(a*b)
+    assert hash(a*b + 0) == h
+    c = a + 1
+    d = c * 1
+    assert c == d == 3**100 + 1
+    lst = [a*b]
+    y = lst[0] + 5
+    assert lst[0] == 3**100 * 7**80 and y == lst[0] + 5
+    f = mpfr("1.5")
+    g = (f*f + f) * 2 - f/3
+    assert g == mpfr("7.0")
+    assert f == mpfr("1.5")
+
+
 def test_mpz_hash():
     assert hash(mpz(123)) == hash(Decimal(123))
+    for n in [2**61 - 2, 2**61 - 1, 2**61, 2**64 - 1, 2**64, -2**64 - 1,
+              3**500, -7**300, -1, -2]:
+        assert hash(mpz(n)) == hash(n)
 
 
 def test_mpz_ceil():
@@ -311,6 +690,56 @@ def test_mpz_rrandomb():
     assert (mpz_rrandomb(random_state(42), 64).digits(2) ==
             '1111111111111111111111111100000000111111111111111111000000000000')
 
+
+def test_mpz_random_many():
+    r1 = random_state(7)
+    r2 = random_state(7)
+
+    assert mpz_urandomb(r1, 256, count=5) == [mpz_urandomb(r2, 256) for _ in range(5)]
+    assert mpz_rrandomb(r1, 80, count=3) == [mpz_rrandomb(r2, 80) for _ in range(3)]
+    assert mpz_random(r1, -10**30, count=3) == [mpz_random(r2, 10**30) for _ in range(3)]
+    assert mpz_urandomb(r1, 64) == mpz_urandomb(r2, 64)
+    assert mpz_urandomb(r1, 8, count=0) == []
+
+    out = [None] * 4
+    assert mpz_random(r1, 1000, out=out) is out
+    assert out == [mpz_random(r2, 1000) for _ in range(4)]
+
+    arr = mpz_array(3)
+    assert mpz_urandomb(r1, 200, out=arr) is arr
+    assert list(arr) == [mpz_urandomb(r2, 200) for _ in range(3)]
+
+    buf = bytearray(15)
+    mpz_urandomb(r1, 36, out=buf)
+    assert ([int.from_bytes(buf[i:i + 5], 'little') for i in range(0, 15, 5)] ==
+            [mpz_urandomb(r2, 36) for _ in range(3)])
+
+    raises(ValueError, lambda: mpz_urandomb(r1, 8, count=-1))
+    raises(TypeError, lambda: mpz_urandomb(r1, 8, count=1, out=[]))
+    raises(TypeError, lambda: mpz_urandomb(r1, 8, size=1))
+    raises(ValueError, lambda: mpz_urandomb(r1, 12, out=bytearray(3)))
+    raises(TypeError, lambda: mpz_urandomb(r1, 8, out=5))
+    raises(ZeroDivisionError, lambda: mpz_random(r1, 0))
+
+
+def test_mpz_random_state_spawn():
+    r = random_state(42)
+    kids = r.spawn(3)
+    assert [k.spawn_key for k in kids] == [(0,), (1,), (2,)]
+    values = [mpz_urandomb(k, 64) for k in kids]
+    assert len(set(values)) == 3
+    assert [mpz_urandomb(k, 64) for k in random_state(42).spawn(3)] == values
+    assert [k.spawn_key for k in r.spawn(2)] == [(3,), (4,)]
+    assert [k.spawn_key for k in kids[1].spawn(2)] == [(1, 0), (1, 1)]
+    assert ([mpz_urandomb(k, 64) for k in random_state(43).spawn(1)] !=
+            [mpz_urandomb(k, 64) for k in random_state(42).spawn(1)])
+    assert mpz_urandomb(r, 64) == mpz_urandomb(random_state(42), 64)
+    assert r.spawn(0) == []
+    raises(ValueError, lambda: r.spawn(-1))
+
+    c = r.copy()
+    assert [mpz_urandomb(c, 64) for _ in range(3)] == [mpz_urandomb(r, 64) for _ in range(3)]
+
 @mark.skipif(mp_version() < "GMP 6.3.0", reason="requires GMP 6.3.0 or higher")
 def test_prev_prime():
     # Imported here as symbol won't exist if mp_version() < 6.3.0
@@ -333,3 +762,1813 @@ def test_prev_prime():
 
     with raises(TypeError):
         prev_prime(4.5)
+
+
+def test_mpz_array():
+    values = [1, -2, mpz(3)**100, xmpz(0), 5]
+    a = mpz_array(values)
+    assert len(a) == 5
+    assert list(a) == values
+    assert type(a[0]) is mpz
+    assert a[-1] == 5
+    assert a[1:4] == mpz_array(values[1:4])
+    assert a[::-1] == mpz_array(values[::-1])
+    assert a[10:] == mpz_array()
+    assert mpz_array(3) == mpz_array([0, 0, 0])
+    assert repr(mpz_array([1, -2])) == 'mpz_array([1, -2])'
+
+    a[0] = 10**50
+    a[1:3] = [8, 9]
+    assert list(a) == [10**50, 8, 9, 0, 5]
+    a[::2] = a[::2][::-1]
+    assert list(a) == [5, 8, 9, 0, 10**50]
+
+    with raises(ValueError):
+        a[1:3] = [1]
+    with raises(IndexError):
+        a[5]
+    with raises(TypeError):
+        del a[0]
+    with raises(TypeError):
+        a[0] = 1.5
+    with raises(TypeError):
+        hash(a)
+    with raises(ValueError):
+        mpz_array(-1)
+
+    assert from_binary(to_binary(a)) == a
+    assert mpz_array.from_binary(a.to_binary()) == a
+    assert from_binary(to_binary(mpz_array())) == mpz_array()
+    for proto in range(pickle.HIGHEST_PROTOCOL + 1):
+        assert pickle.loads(pickle.dumps(a, protocol=proto)) == a
+    with raises(ValueError):
+        from_binary(b'\x06\x00\x05\x00\x00\x00')
+
+    assert vadd(a, a) == mpz_array([2*x for x in a])
+    assert vmul(a, 3) == mpz_array([3*x for x in a])
+    assert vmod(100, mpz_array([7, -3])) == mpz_array([2, -2])
+    assert vadd(a, [1]*5) == [x + 1 for x in a]
+    with raises(ZeroDivisionError):
+        vmod(a, 0)
+    with raises(ValueError):
+        vadd(a, mpz_array([1]))
+
+
+def test_mpz_array_ufuncs():
+    import gmpy2
+
+    a = mpz_array(range(1, 8))
+    assert vadd(a, 10) == mpz_array(range(11, 18))
+    out = mpz_array(7)
+    assert vmul(a, a, out=out) is out
+    assert out == mpz_array([i * i for i in range(1, 8)])
+    vadd(out, 1, out=out)
+    assert out[6] == 50
+    assert vadd([1, 2], [3, 4], out=mpz_array(2)) == mpz_array([4, 6])
+    assert vadd([1, 2], [3, 4], out=None) == [4, 6]
+    assert gmpy2.vpowmod(a, 100, 13) == mpz_array([pow(i, 100, 13) for i in range(1, 8)])
+    assert gmpy2.vpowmod(3, a, -7) == mpz_array([powmod(3, i, -7) for i in range(1, 8)])
+    assert gmpy2.visqrt([0, 99, 10**40]) == mpz_array([0, 9, 10**20])
+    assert gmpy2.vcmp(a, 4) == mpz_array([-1, -1, -1, 0, 1, 1, 1])
+    assert gmpy2.get_context().vpowmod([2, 3], 5, 7) == mpz_array([4, 5])
+    assert (a.sum(), a.prod(), a.min(), a.max()) == (28, 5040, 1, 7)
+    assert (mpz_array().sum(), mpz_array().prod()) == (0, 1)
+    with raises(ValueError):
+        mpz_array().min()
+    with raises(ValueError):
+        gmpy2.vpowmod(a, -1, 5)
+    with raises(ValueError):
+        gmpy2.vpowmod(a, 1, 0)
+    with raises(ValueError):
+        gmpy2.visqrt([-1])
+    with raises(ValueError):
+        gmpy2.vcmp(a, mpz_array(3))
+    with raises(ValueError):
+        vadd(a, a, out=mpz_array(3))
+    with raises(ZeroDivisionError):
+        vmod(a, 0, out=mpz_array(7))
+    with raises(TypeError):
+        gmpy2.visqrt(a, foo=1)
+
+
+def test_mpz_array_save(tmp_path):
+    import gmpy2
+
+    values = [0, 1, -1, 2**64, -(3**200), 2**(8 << 20) + 5, 7, 0]
+    a = mpz_array(values)
+    path = tmp_path / 'a.mpza'
+    assert a.save(path) is None
+
+    m = gmpy2.load_mpz_array(path)
+    assert len(m) == len(values)
+    assert m[3] == 2**64 and type(m[3]) is mpz
+    assert m[-3] == values[-3]
+    assert list(m) == values
+    assert m[1:5] == mpz_array(values[1:5])
+    assert m[::-1] == mpz_array(values[::-1])
+    with raises(IndexError):
+        m[8]
+    with raises(TypeError):
+        m[0] = 1
+    del m
+
+    assert gmpy2.load_mpz_array(str(path), mmap=False) == a
+    mpz_array().save(path)
+    assert gmpy2.load_mpz_array(path, mmap=False) == mpz_array()
+    assert len(gmpy2.load_mpz_array(path)) == 0
+
+    path.write_bytes(b'not an mpz_array')
+    with raises(ValueError):
+        gmpy2.load_mpz_array(path)
+
+
+def test_mpz_array_shared():
+    import gmpy2
+    from multiprocessing import shared_memory
+    from gmpy2 import mpfr_array, shared
+
+    values = [0, -1, 2**64, -(3**200), 7]
+    a = mpz_array(values)
+    buf = bytearray(a.saved_size())
+    a.save(buf)
+    m = gmpy2.load_mpz_array(buf)
+    assert list(m) == values
+    c = m.copy()
+    assert type(c) is mpz_array and c == a
+    del m
+    with raises(ValueError):
+        a.save(bytearray(a.saved_size() - 1))
+    with raises(BufferError):
+        a.save(memoryview(bytes(a.saved_size())))
+
+    shm = shared_memory.SharedMemory(create=True, size=a.saved_size())
+    try:
+        a.save(shm.buf)
+        m = gmpy2.load_mpz_array(shm.buf)
+        assert m[3] == values[3]
+        del m
+    finally:
+        shm.close()
+        shm.unlink()
+
+    with shared.share(a) as s:
+        t = pickle.loads(pickle.dumps(s))
+        assert t.name == s.name and list(t.array) == values
+        t.close()
+    x = mpfr_array([1, 2.5, -3], precision=80)
+    with shared.share(x) as s:
+        t = shared.attach(s.name)
+        assert t.array.readonly and t.array == x
+        with raises(TypeError):
+            t.array[0] = 1
+        t.close()
+    with raises(TypeError):
+        shared.share([1, 2])
+
+
+def test_mpz_view():
+    import array
+    import gmpy2
+    from gmpy2 import mpz_view
+
+    x = mpz(3)**200 + 12345
+    buf = bytearray(x.to_bytes(8 * ((x.bit_length() + 63) // 64), 'little'))
+    v = mpz_view(buf)
+    assert v == x and hash(v) == hash(x) and v.obj is buf
+    assert repr(v) == 'mpz_view(%d)' % x and str(v) == str(x)
+    assert type(v + 1) is mpz and v + 1 == x + 1
+    assert v * v == x * x and v % 7 == x % 7 and -v == -x
+    assert v & 0xff == x & 0xff and v[0:8] == x & 0xff
+    assert v.bit_length() == x.bit_length() and f'{v:x}' == f'{x:x}'
+    assert gmpy2.powmod(2, v, 1000) == pow(2, int(x), 1000)
+    assert gmpy2.is_prime(v) == gmpy2.is_prime(x)
+    assert type(mpz(v)) is mpz and mpz(v) == x
+    assert mpq(v, 3) == mpq(x, 3) and int(v) == x
+    y = xmpz(7)
+    y += v
+    assert y == x + 7
+    assert type(pickle.loads(pickle.dumps(v))) is mpz
+
+    limbs = array.array('Q', [2**64 - 1, 2**64 - 1])
+    assert mpz_view(limbs) == 2**128 - 1
+    assert mpz_view(limbs, signed=True) == -1
+    assert mpz_view(array.array('Q', [5, 2**63]), signed=True) == 5 - 2**127
+    assert mpz_view(array.array('Q', [5, 0]), signed=True) == 5
+    assert mpz_view(b'') == 0
+    with raises(ValueError):
+        mpz_view(b'abc')
+    with raises(ValueError):
+        mpz_view(memoryview(bytes(17))[1:9])
+    with raises(TypeError):
+        mpz_view(12)
+
+
+def test_from_to_array():
+    import array
+    import gmpy2
+
+    values = [0, 1, -2, 2**63 - 1, -2**63]
+    a = array.array('q', values)
+    assert gmpy2.from_array(a) == values
+    assert all(type(x) is mpz for x in gmpy2.from_array(a))
+    assert gmpy2.from_array(a, type=mpz_array) == mpz_array(values)
+    assert gmpy2.from_array(array.array('Q', [2**64 - 1])) == [2**64 - 1]
+    assert gmpy2.from_array(array.array('b', [-1, 5])) == [-1, 5]
+    assert gmpy2.from_array(bytes([1, 255])) == [1, 255]
+    assert gmpy2.from_array(memoryview(array.array('i', range(10)))[::3]) == [0, 3, 6, 9]
+    assert gmpy2.from_array(array.array('d', [2.75, -1.5])) == [2, -1]
+    assert gmpy2.from_array(array.array('f', [0.5]), type=gmpy2.mpfr) == [0.5]
+    with raises(ValueError):
+        gmpy2.from_array(array.array('d', [float('nan')]))
+    with raises(OverflowError):
+        gmpy2.from_array(array.array('d', [float('inf')]))
+    with raises(TypeError):
+        gmpy2.from_array([1, 2])
+    with raises(TypeError):
+        gmpy2.from_array(a, type=int)
+
+    r = gmpy2.to_array(values)
+    assert r.typecode == 'q' and r.tolist() == values
+    assert gmpy2.to_array(mpz_array([1, 2]), 'uint8').tolist() == [1, 2]
+    assert gmpy2.to_array([-128, 127], 'int8').tolist() == [-128, 127]
+    assert gmpy2.to_array([2**64 - 1], dtype='uint64').tolist() == [2**64 - 1]
+    r = gmpy2.to_array([1, 2.5, gmpy2.mpfr('1.25'), mpz(10)**20], 'float64')
+    assert r.tolist() == [1.0, 2.5, 1.25, 1e20]
+    for v, dtype in [(2**63, 'int64'), (-1, 'uint64'), (128, 'int8'),
+                     (-129, 'int8'), (mpz(10)**400, 'float64'), (1e300, 'float32')]:
+        with raises(OverflowError):
+            gmpy2.to_array([v], dtype)
+    with raises(TypeError):
+        gmpy2.to_array([1.5], 'int64')
+    with raises(ValueError):
+        gmpy2.to_array([1], 'complex128')
+
+
+def test_expr():
+    from gmpy2 import expr
+
+    a, b, c, d, e = mpz(3)**100, mpz(-7)**60, 2**90 + 1, mpz(5), xmpz(11)
+    x = expr(a)*b + c*d - e
+    assert type(x) is expr
+    assert x.eval() == a*b + c*d - e
+    assert mpz(x) == a*b + c*d - e
+    assert int(x) == a*b + c*d - e
+    out = xmpz(1)
+    assert x.eval(out=out) is out and out == a*b + c*d - e
+    y = -(expr(a) - b)*(c + expr(d)*e) - 3*(expr(2) - (expr(c) - a))
+    assert y.eval() == -(a - b)*(c + d*e) - 3*(2 - (c - a))
+    assert (1 + expr(2) - mpz(3)).eval() == 0
+    assert repr(expr(2)*3 - (expr(4) - 5)) == 'expr(2*3 - (4 - 5))'
+    assert repr(-(expr(1) + 2)) == 'expr(-(1 + 2))'
+
+    # Operands are captured when the expression is built.
+    x = expr(e) + 1
+    e += 1
+    assert x.eval() == 12
+
+    # Long sums and repeated squaring are evaluated in parts.
+    s, total = expr(0), 0
+    for i in range(2000):
+        s = s + expr(i - 1000)*i - i
+        total += (i - 1000)*i - i
+    assert s.eval() == total
+    x = expr(3)
+    for i in range(16):
+        x = x*x
+    assert mpz(x) == mpz(3)**2**16
+
+    with raises(TypeError):
+        expr(1.5)
+    with raises(TypeError):
+        expr(1) + 1.5
+    with raises(TypeError):
+        expr(1).eval(out=mpz(0))
+
+
+def test_mpz_write_digits(tmp_path):
+    import io
+
+    for v in (0, 7, -7, 2**64, -(3**2000), 10**5000 + 1):
+        x = mpz(v)
+        for base in (2, 10, 16, 36, 62):
+            buf = bytearray(x.num_digits(base) + 2)
+            n = x.write_digits(buf, base)
+            if base <= 36 and n <= 4300:
+                assert int(bytes(buf[:n]), base) == x
+            f = io.BytesIO()
+            assert x.write_digits(f, base=base) == n
+            assert f.getvalue() == bytes(buf[:n])
+            assert mpz.from_digits_file(f.getvalue(), base) == x
+
+    with raises(ValueError):
+        mpz(10**10).write_digits(bytearray(5))
+    with raises(ValueError):
+        mpz(1).write_digits(bytearray(5), base=63)
+
+    x = -mpz(7)**30000
+    path = tmp_path / 'x.txt'
+    with open(path, 'wb') as f:
+        x.write_digits(f)
+        f.write(b'\n')
+    assert mpz.from_digits_file(path) == x
+    assert mpz.from_digits_file(str(path)) == x
+    assert mpz.from_digits_file(b'  +00ff ', 16) == 255
+    assert mpz.from_digits_file(b'-0') == 0
+    assert mpz.from_digits_file(b'Zz', 62) == 35 * 62 + 61
+    assert mpz.from_digits_file(memoryview(b'123')) == 123
+    for bad in (b'', b' ', b'-', b'12a', b'1 2', b'0x10'):
+        with raises(ValueError):
+            mpz.from_digits_file(bad)
+
+
+def test_prod_remainder_tree():
+    for n in range(20):
+        xs = [(-3)**i + 2*i for i in range(n)]
+        assert prod(xs) == math.prod(xs)
+        ms = [(-1)**i * (7*i + 5) for i in range(n)]
+        for x in (0, 12345, -10**50, 7**300):
+            assert remainder_tree(x, ms) == [x % m for m in ms]
+    assert prod([]) == 1 and type(prod([])) is mpz
+    assert prod(iter([xmpz(2), 3])) == 6
+    assert prod([mpq(1, 2), 3, mpq(2, 3)]) == 1
+    assert type(prod([mpq(1, 2), 4])) is mpq
+    assert prod(mpz_array([2, 3, 4])) == 24
+    assert remainder_tree(100, mpz_array([7, 9])) == [2, 1]
+
+    ps = [next_prime(mpz(2)**64 + 1000*i) for i in range(500)]
+    x = prod(ps) * 3 + 12345678
+    assert remainder_tree(x, ps) == [x % p for p in ps]
+
+    with raises(ZeroDivisionError):
+        remainder_tree(5, [3, 0])
+    with raises(TypeError):
+        remainder_tree(5, [mpq(1, 2)])
+    with raises(TypeError):
+        remainder_tree(1.5, [3])
+    with raises(TypeError):
+        prod([1.5])
+
+
+def test_batch_gcd():
+    import gmpy2
+
+    ps = [next_prime(mpz(10)**30 + 1000*i) for i in range(60)]
+    ms = [ps[2*i] * ps[2*i + 1] for i in range(25)]
+    ms += [ps[0] * ps[50], ps[51] * ps[52], ps[51] * ps[53], ps[54]**2, 15, 1]
+    product = math.prod(ms)
+    expected = [math.gcd(m, product // m) for m in ms]
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            assert batch_gcd(ms) == expected
+            assert remainder_tree(product + 1, ms) == [1 % m for m in ms]
+    assert batch_gcd([]) == []
+    assert batch_gcd([7]) == [1]
+    assert batch_gcd(mpz_array([6, 10, 7])) == [2, 2, 1]
+
+    with raises(ValueError):
+        batch_gcd([0])
+    with raises(ValueError):
+        batch_gcd([-3])
+    with raises(TypeError):
+        batch_gcd([mpq(1, 2)])
+
+
+def test_smooth_part():
+    import gmpy2
+
+    vals = [0, 1, -1, mpz(2)**100, -(mpz(3)**50) * 7 * 1000003,
+            2*3*5*7*11*13*97*101**3, next_prime(mpz(10)**30) * 720]
+    vals += [mpz(7)**i * next_prime(mpz(2)**i) + i for i in range(1, 200)]
+
+    def smooth(x, B):
+        s = 1
+        for p in primerange(2, B + 1):
+            while x and x % p == 0:
+                x //= p
+                s *= p
+        return s if x else 0
+
+    for B in (0, 2, 100, 70000):
+        expected = [smooth(abs(x), B) for x in vals]
+        for threads in (1, 3):
+            with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+                assert smooth_part(vals, B) == expected
+                assert smooth_part(mpz_array(vals), B) == expected
+    assert smooth_part([], 10) == []
+
+    with raises(ValueError):
+        smooth_part([1], -1)
+    with raises(ValueError):
+        smooth_part([1], 2**32)
+    with raises(TypeError):
+        smooth_part([mpq(1, 2)], 10)
+
+
+def test_trial_factor():
+    import gmpy2
+
+    vals = [1, -1, 2**10 * 3**4, -(mpz(3)**50) * 7 * 1000003]
+    vals += [mpz(7)**i * next_prime(mpz(2)**i) + i for i in range(1, 100)]
+    primes = [int(p) for p in primerange(2, 200)]
+    k = len(primes)
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            exps, cofactors = trial_factor(vals, primes)
+            assert exps.format == 'I' and len(exps) == len(vals) * k
+            for i, x in enumerate(vals):
+                assert x == cofactors[i] * math.prod(p**exps[i*k + j]
+                                                     for j, p in enumerate(primes))
+                assert all(cofactors[i] % p for p in primes)
+            assert trial_factor(vals, 199) == (exps, cofactors)
+    assert trial_factor([2**5 * 65537], 70000)[1] == [1]
+    assert trial_factor([6], [])[1] == [6]
+    assert len(trial_factor([], [2])[0]) == 0
+
+    with raises(ValueError):
+        trial_factor([0], [2])
+    with raises(ValueError):
+        trial_factor([6], [1])
+    with raises(ValueError):
+        trial_factor([6], 2**32)
+    with raises(TypeError):
+        trial_factor([mpq(1, 2)], [2])
+
+
+def test_crt():
+    import gmpy2
+
+    assert crt([2, 3, 2], [3, 5, 7]) == 23
+    assert crt([-1, 10**9], [mpz(2)**61 - 1, 1]) == mpz(2)**61 - 2
+    assert crt([5], [7]) == 5
+
+    ms = [next_prime(mpz(10)**20 + 1000*i) for i in range(37)] + [2**64, 1]
+    M = math.prod(ms)
+    xs = [mpz(3)**(40*i) % M for i in range(12)] + [0, M - 1]
+    P = CRTPlan(ms)
+    assert P.modulus == M and P.moduli == ms
+    assert repr(CRTPlan([3, 5])) == 'CRTPlan([mpz(3), mpz(5)])'
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            rows = [[x % m for m in ms] for x in xs]
+            assert P.vcrt(rows) == xs
+            assert [P.crt(r) for r in rows] == xs
+            assert P.crt(mpz_array(x - 5*M for m in ms for x in [xs[3]])) == xs[3]
+    assert P.vcrt([]) == []
+
+    with raises(ValueError):
+        crt([1, 2], [6, 4])
+    with raises(ValueError):
+        CRTPlan([0, 3])
+    with raises(ValueError):
+        CRTPlan([])
+    with raises(ValueError):
+        P.crt([1, 2])
+    with raises(ValueError):
+        P.vcrt([[1] * len(ms), [1]])
+    with raises(TypeError):
+        crt([mpq(1, 2)], [3])
+    with raises(TypeError):
+        CRTPlan([mpq(1, 2)])
+    with raises(TypeError):
+        crt([1], [3], [5])
+
+
+def test_rns():
+    import gmpy2
+
+    ms = [next_prime(mpz(2)**64 - 2**40 + 1000*i) for i in range(40)]
+    M = math.prod(ms)
+    R = RNS(ms)
+    assert R.modulus == M and R.moduli == ms
+    assert repr(RNS([3, 5])) == 'RNS([mpz(3), mpz(5)])'
+    a, b = mpz(3)**1500 % M, -mpz(7)**300
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            x, y = R(a), R(b)
+            assert isinstance(x, rns) and x.basis is R
+            assert x.residues == [a % m for m in ms]
+            assert (x + y).to_mpz() == (a + b) % M
+            assert (x - y).to_mpz() == (a - b) % M
+            assert (x * y).to_mpz() == (a * b) % M
+            assert (-x).to_mpz() == -a % M
+            assert (x**5).to_mpz() == a**5 % M
+            assert (y * y).to_mpz(signed=True) == b * b
+            assert (2 - y * 3).to_mpz(signed=True) == 2 - 3*b
+    x = R(10)
+    assert int(x) == 10 and mpz(x) == 10 and repr(x) == 'rns(10)'
+    assert x == 10 and x != 11 and x == R(M + 10) and x**0 == 1
+    assert not R(0) and R(-1).to_mpz() == M - 1
+    assert R.from_residues([1] * 40) == 1
+    # The residues are reduced without changing the arguments.
+    big, small = mpz(2)**70 + 5, mpz(100)
+    S = RNS([5, 7, 9, 11])
+    assert S.from_residues([big, small, 20, -1]).residues == [
+        big % 5, small % 7, 20 % 9, 10]
+    assert (big, small, mpz(20), mpz(-1)) == (2**70 + 5, 100, 20, -1)
+
+    with raises(ValueError):
+        RNS([3, 6])
+    with raises(ValueError):
+        RNS([4])
+    with raises(ValueError):
+        RNS([2**64 + 1])
+    with raises(ValueError):
+        RNS([3, 9])
+    with raises(ValueError):
+        x + RNS([3, 5])(1)
+    with raises(ValueError):
+        x**-1
+    with raises(ValueError):
+        R.from_residues([1, 2])
+    with raises(TypeError):
+        x + 1.5
+    with raises(TypeError):
+        R(mpq(1, 2))
+    with raises(TypeError):
+        hash(x)
+
+
+def _poly_mul(a, b, p):
+    r = [0] * (len(a) + len(b) - 1) if a and b else []
+    for i, x in enumerate(a):
+        for j, y in enumerate(b):
+            r[i + j] = (r[i + j] + x * y) % p
+    while r and not r[-1]:
+        r.pop()
+    return r
+
+
+def test_nmod_poly():
+    import random
+    import gmpy2
+
+    if not hasattr(gmpy2, 'nmod_poly'):
+        skip("nmod_poly requires 128-bit integer arithmetic")
+    from gmpy2 import nmod_poly
+
+    rng = random.Random(42)
+    # 998244353 has a transform of length 2**23; the others use three primes.
+    for p in (3, 998244353, 2**61 - 1, 2**64 - 59):
+        for na, nb in ((0, 5), (1, 1), (7, 40), (40, 40), (150, 90)):
+            a = [rng.randrange(p) for _ in range(na)]
+            b = [rng.randrange(1, p) for _ in range(nb)]
+            A, B = nmod_poly(a, p), nmod_poly(b, p)
+            assert (A * B).coeffs == _poly_mul(a, b, p)
+            q, r = divmod(A, B)
+            assert q * B + r == A and r.degree < B.degree
+            assert A // B == q and A % B == r
+            assert (A - B) + B == A and -A + A == 0
+            xs = [rng.randrange(p) for _ in range(70)]
+            assert A.evaluate(xs) == [sum(c * pow(x, i, p) for i, c in enumerate(a)) % p
+                                      for x in xs]
+
+    p = 2**64 - 59
+    A = nmod_poly([rng.randrange(p) for _ in range(1000)], p)
+    B = nmod_poly([rng.randrange(p) for _ in range(300)], p)
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            C = A * B
+            assert C.coeffs[:3] == _poly_mul(A.coeffs[:3], B.coeffs[:3], p)[:3]
+            q, r = divmod(C + 5, B)
+            assert q == A and r == 5
+            assert C.evaluate(range(500)) == [C(x) for x in range(500)]
+            X = nmod_poly([1], p)
+            for bit in bin(1000)[2:]:
+                X = X * X % B
+                if bit == '1':
+                    X = X * A % B
+            assert pow(A, 1000, B) == X
+
+    f = nmod_poly([1, -1, 0, 3], 17)
+    assert repr(f) == 'nmod_poly([1, 16, 0, 3], 17)'
+    assert f.coeffs == [1, 16, 0, 3] and isinstance(f.coeffs[0], mpz)
+    assert f.degree == 3 and f.modulus == 17
+    assert nmod_poly([0, 0], 17).degree == -1 and not nmod_poly([17], 17)
+    assert nmod_poly(mpz_array([1, 2]), 17) == nmod_poly([1, 2], 17)
+    assert f(2) == (1 - 2 + 24) % 17 and f == f and f != nmod_poly([1], 19)
+    assert f**3 == f * f * f and f**0 == 1 and pow(f, 10**20, 3) == 0
+    assert nmod_poly([3], 17)**(16 * 10**20 + 1) == 3
+    assert 2 * f - f * 2 == 0 and f + 1 == nmod_poly([2, 16, 0, 3], 17)
+
+    with raises(ValueError):
+        nmod_poly([1], 15)
+    with raises(ValueError):
+        nmod_poly([1], 2)
+    with raises(ValueError):
+        nmod_poly([1], 2**64 + 13)
+    with raises(ValueError):
+        f + nmod_poly([1], 19)
+    with raises(ValueError):
+        f**-1
+    with raises(ZeroDivisionError):
+        f // 0
+    with raises(TypeError):
+        nmod_poly([1.5], 17)
+    with raises(TypeError):
+        f + 1.5
+    with raises(TypeError):
+        f.evaluate([mpq(1, 2)])
+    with raises(TypeError):
+        hash(f)
+
+
+def test_rational_reconstruct():
+    import gmpy2
+    from gmpy2 import rational_reconstruct, rational_reconstruct_list
+
+    ms = [next_prime(mpz(2)**63 + 1000*i) for i in range(40)]
+    M = math.prod(ms)
+    fracs = [mpq(-3, 7), mpq(mpz(5)**300 + 1, mpz(3)**350), mpq(0),
+             mpq(mpz(2)**1200 - 1, 9)]
+    xs = [q.numerator * gmpy2.invert(q.denominator, M) % M for q in fracs]
+    assert [rational_reconstruct(x, M) for x in xs] == fracs
+    assert rational_reconstruct(crt([xs[1] % m for m in ms], ms), M) == fracs[1]
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            assert rational_reconstruct_list(xs, M) == fracs
+            assert rational_reconstruct_list(mpz_array(xs), M) == fracs
+    assert rational_reconstruct_list([], M) == []
+
+    assert rational_reconstruct(5, 7) is None
+    assert rational_reconstruct(5, 7, 2, 1) == -2
+    assert rational_reconstruct(5, 7, num_bound=0, den_bound=3) is None
+    assert rational_reconstruct(4, 7, den_bound=2) == mpq(1, 2)
+    assert rational_reconstruct(xs[3], M, num_bound=10**6) is None
+    assert rational_reconstruct_list([xs[0], xs[3]], M, 100) == [fracs[0], None]
+
+    with raises(ValueError):
+        rational_reconstruct(1, 0)
+    with raises(ValueError):
+        rational_reconstruct(1, 7, -1)
+    with raises(TypeError):
+        rational_reconstruct(mpq(1, 2), 7)
+    with raises(TypeError):
+        rational_reconstruct_list([mpq(1, 2)], 7)
+
+
+def test_binary_splitting():
+    import gmpy2
+    from fractions import Fraction
+    from gmpy2 import binary_splitting, mpfr
+
+    def ref(p, q, a, n):
+        ev = lambda c, k: sum(x * k**i for i, x in enumerate(c))
+        s, t = Fraction(0), Fraction(1)
+        for k in range(n):
+            if k:
+                t *= Fraction(ev(p, k), ev(q, k))
+            s += ev(a, k) * t
+        return s
+
+    cases = [([1], [0, 1], [1], 20), ([-1, 0, 3], [7, 2], [5, -1, 2], 37),
+             ([2], [3], [1, 1], 0), ([1, 2, 3], [1, 1], [0], 10),
+             ([1], [0, 1], [1], 1)]
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            for p, q, a, n in cases + [([-1, 0, 3], [7, 2], [5, -1, 2], 501)]:
+                P, Q, T = binary_splitting(p, q, a, n)
+                assert Fraction(int(T), int(Q)) == ref(p, q, a, n)
+                assert P == math.prod(sum(x * k**i for i, x in enumerate(p))
+                                      for k in range(1, n + 1))
+    assert binary_splitting(1, [0, 1], 1, 0) == (1, 1, 0)
+    assert binary_splitting(1, [0, 1], mpz(1), 3) == (1, 6, 15)
+
+    with gmpy2.local_context(precision=2000):
+        e = gmpy2.exp(mpfr(1))
+        assert binary_splitting(1, [0, 1], 1, 400, precision=0) == e
+    x = binary_splitting(1, [0, 1], 1, 30, precision=100)
+    assert x.precision == 100
+
+    with raises(ZeroDivisionError):
+        binary_splitting(1, [1, -1], 1, 5)
+    with raises(ValueError):
+        binary_splitting(1, [0, 1], 1, -1)
+    with raises(ValueError):
+        binary_splitting([], [0, 1], 1, 3)
+    with raises(ValueError):
+        binary_splitting(1, [0, 1], 1, 3, precision=-5)
+    with raises(TypeError):
+        binary_splitting(1, [0, 1.5], 1, 3)
+    with raises(TypeError):
+        binary_splitting(1, [0, 1], 'a', 3)
+
+
+def test_powmod_multi():
+    m = mpz(2)**521 - 1
+    bases = [mpz(3)**i + i for i in range(1, 12)]
+    exps = [mpz(7)**(50*i) - i for i in range(11)]
+    expected = math.prod(powmod(b, e, m) for b, e in zip(bases, exps)) % m
+    assert powmod_multi(bases, exps, m) == expected
+    assert powmod_multi(mpz_array(bases), tuple(exps), m + 1) == \
+           math.prod(powmod(b, e, m + 1) for b, e in zip(bases, exps)) % (m + 1)
+    assert powmod_multi([2, 3], [-1, 0], 7) == 4
+    assert powmod_multi([-2, 5], [3, 2], 11) == (-8 * 25) % 11
+    assert powmod_multi([], [], 5) == 1
+    assert powmod_multi([2], [5], 1) == 0
+
+    with raises(ValueError):
+        powmod_multi([2], [-1], 4)
+    with raises(ValueError):
+        powmod_multi([2, 3], [1], 5)
+    with raises(ValueError):
+        powmod_multi([2], [1], 0)
+    with raises(TypeError):
+        powmod_multi([mpq(1, 2)], [1], 5)
+    with raises(TypeError):
+        powmod_multi(2, [1], 5)
+
+
+def test_fixed_base_powmod():
+    import gmpy2
+
+    p = next_prime(mpz(2)**300)
+    f = FixedBasePowMod(7, p, 300)
+    assert f.base == 7 and f.modulus == p and f.max_bits == 300
+    assert repr(f) == 'FixedBasePowMod(7, %s, 300)' % p
+    exps = [mpz(3)**i * (-1)**i for i in range(190)] + [0, 1, p - 1, p**3]
+    expected = [powmod(7, e, p) for e in exps]
+    assert [f(e) for e in exps] == expected
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            assert f(exps) == expected
+            assert f(mpz_array(exps)) == expected
+    assert f([]) == []
+    assert FixedBasePowMod(-3, 10, 1)(1) == 7
+    assert FixedBasePowMod(5, 1, 8)(3) == 0
+    assert FixedBasePowMod(6, 10, 16)(xmpz(4)) == 6
+
+    with raises(ValueError):
+        FixedBasePowMod(6, 10, 16)(-1)
+    with raises(ValueError):
+        FixedBasePowMod(6, 10, 16)([1, -1])
+    with raises(ValueError):
+        FixedBasePowMod(2, 0, 16)
+    with raises(ValueError):
+        FixedBasePowMod(2, 5, 0)
+    with raises(TypeError):
+        FixedBasePowMod(2, mpq(1, 2), 16)
+    with raises(TypeError):
+        FixedBasePowMod(2, 5)
+    with raises(TypeError):
+        f(mpq(1, 2))
+    with raises(TypeError):
+        f([1, 1.5])
+
+
+def test_modulus():
+    import gmpy2
+
+    p = next_prime(mpz(2)**200)
+    M = Modulus(p)
+    assert M.modulus == p and repr(M) == 'Modulus(%s)' % p
+    xs = [mpz(3)**i * (-1)**i for i in range(140)] + [0, 1, p - 1, p, 2**300]
+    ys = xs[::-1]
+    for x, y in zip(xs, ys):
+        assert M.reduce(x) == x % p
+        assert M.add(x, y) == (x + y) % p
+        assert M.sub(x, y) == (x - y) % p
+        assert M.mul(x, y) == (x * y) % p
+        assert M.sqr(x) == (x * x) % p
+        if x % p:
+            assert M.pow(x, y) == powmod(x, y, p)
+            assert M.inv(x) == powmod(x, -1, p)
+    assert M.add(int(p - 1), xmpz(2)) == 1
+
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            assert M.vmul(xs, ys) == [(x * y) % p for x, y in zip(xs, ys)]
+            assert M.vadd(xs, 5) == [(x + 5) % p for x in xs]
+            assert M.vsub(5, xs) == [(5 - x) % p for x in xs]
+            assert M.vsqr(xs) == [(x * x) % p for x in xs]
+            assert M.vreduce(xs) == [x % p for x in xs]
+            assert M.vpow(2, xs) == [powmod(2, x, p) for x in xs]
+            assert M.vinv(xs[:5]) == [powmod(x, -1, p) for x in xs[:5]]
+    assert M.vmul(mpz_array(xs), 3) == mpz_array((x * 3) % p for x in xs)
+    assert M.vmul([], []) == []
+    assert Modulus(1).mul(3, 5) == 0
+    assert Modulus(1).inv(3) == 0
+    assert M.form == (200, 2**200 - p)
+    assert Modulus(10).form is None and Modulus(2**127 - 1).form is None
+
+    # Moduli 2**k - c with a word c are reduced through their form.
+    forms = [(255, 19), (256, 2**32 + 977), (521, 1), (256, -1), (1024, -105),
+             (256, 2**64 - 1), (255, -(2**64 - 1))]
+    for k, c in forms:
+        m = mpz(2)**k - c
+        M = Modulus(m)
+        assert M.form == (k, c)
+        xs = [mpz(3)**i * (-1)**i for i in range(0, 1100, 7)]
+        xs += [0, m - 1, m, m + 1, -m, m * m - 1, m * m, -m * m, 4 * m * m]
+        ys = xs[::-1]
+        for x, y in zip(xs, ys):
+            assert M.reduce(x) == x % m
+            assert M.mul(x, y) == (x * y) % m
+            assert M.sqr(x) == (x * x) % m
+        assert M.vmul(xs, ys) == [(x * y) % m for x, y in zip(xs, ys)]
+        assert M.vinv(xs[1:9]) == [powmod(x, -1, m) for x in xs[1:9]]
+        assert invert_many(xs[1:9], m) == M.vinv(xs[1:9])
+    assert Modulus(2**256 - 2**224 + 2**192 + 2**96 - 1).form is None
+
+    M = Modulus(10)
+    with raises(ValueError):
+        M.inv(4)
+    with raises(ValueError):
+        M.pow(4, -1)
+    with raises(ValueError):
+        M.vinv([3, 4])
+    with raises(ValueError):
+        M.vmul([1, 2], [3])
+    with raises(ValueError):
+        Modulus(0)
+    with raises(TypeError):
+        Modulus(mpq(1, 2))
+    with raises(TypeError):
+        M.mul(1.5, 3)
+    with raises(TypeError):
+        M.mul(1)
+    with raises(TypeError):
+        M.vmul(1, 2)
+    with raises(TypeError):
+        M.vmul([mpq(1, 2)], 2)
+
+
+def test_sec_modulus():
+    import gmpy2
+    from gmpy2.sec import Modulus as SecModulus
+
+    for p in [3, 2**64 - 59, 2**64 + 1, next_prime(mpz(2)**521), mpz(3)**200]:
+        M = SecModulus(p)
+        assert M.modulus == p and M.ebits == mpz(p).bit_length()
+        xs = [0, 1, 2, p - 1, p // 2, mpz(7)**50 % p]
+        for x in xs:
+            for y in xs:
+                assert M.add(x, y) == (x + y) % p
+                assert M.sub(x, y) == (x - y) % p
+                assert M.mul(x, y) == (x * y) % p
+                if y:
+                    assert M.pow(x, y) == powmod(x, y, p)
+            assert M.sqr(x) == (x * x) % p
+            if gmpy2.gcd(x, p) == 1:
+                assert M.inv(x) == powmod(x, -1, p)
+            else:
+                with raises(ValueError):
+                    M.inv(x)
+        assert M.cnd_swap(True, 1, 2) == (2, 1)
+        assert M.cnd_swap(0, 1, 2) == (1, 2)
+
+    M = SecModulus(101, ebits=200)
+    assert repr(M) == 'gmpy2.sec.Modulus(101, ebits=200)'
+    assert M.pow(3, 2**199 + 1) == powmod(3, 2**199 + 1, 101)
+    with raises(ValueError):
+        M.pow(3, 2**200)
+    with raises(ValueError):
+        M.pow(3, 0)
+    with raises(ValueError):
+        M.mul(101, 1)
+    with raises(ValueError):
+        M.add(-1, 1)
+    with raises(ValueError):
+        SecModulus(100)
+    with raises(ValueError):
+        SecModulus(1)
+    with raises(ValueError):
+        SecModulus(101, ebits=0)
+    with raises(TypeError):
+        M.mul(1.5, 1)
+    with raises(TypeError):
+        M.cnd_swap(1, 2)
+
+
+def _ec_add(E, P, Q):
+    p = E.p
+    if P is None:
+        return Q
+    if Q is None:
+        return P
+    if P[0] == Q[0] and (P[1] + Q[1]) % p == 0:
+        return None
+    if P == Q:
+        s = (3*P[0]*P[0] + E.a) * powmod(2*P[1], -1, p) % p
+    else:
+        s = (Q[1] - P[1]) * powmod(Q[0] - P[0], -1, p) % p
+    x = (s*s - P[0] - Q[0]) % p
+    return (x, (s*(P[0] - x) - P[1]) % p)
+
+
+def _ec_mul(E, k, P):
+    if k < 0:
+        k, P = -k, E.neg(P)
+    R = None
+    while k:
+        if k & 1:
+            R = _ec_add(E, R, P)
+        P = _ec_add(E, P, P)
+        k >>= 1
+    return R
+
+
+def test_ec_curve():
+    from gmpy2.ec import Curve, named_curve
+
+    for name in ['secp256k1', 'P-256', 'P-384']:
+        E, G, n = named_curve(name)
+        assert E.is_on_curve(G)
+        assert E.mul(n, G) is None
+        assert E.mul(n - 1, G) == E.neg(G)
+        ks = [0, 1, 2, 3, -5, 2**200 + 7, n // 3, -(n // 7), n + 1]
+        Ps = [_ec_mul(E, k + 11, G) for k in ks]
+        assert [E.mul(k, G) for k in ks] == [_ec_mul(E, k, G) for k in ks]
+        assert E.mul_many(ks, G) == [_ec_mul(E, k, G) for k in ks]
+        assert E.mul_many(mpz_array(ks), Ps) == [_ec_mul(E, k, P) for k, P in zip(ks, Ps)]
+        assert E.mul_add(ks[5], G, ks[6], Ps[0]) == _ec_add(E, _ec_mul(E, ks[5], G),
+                                                            _ec_mul(E, ks[6], Ps[0]))
+        assert E.mul_add(ks[5], G, -ks[5], G) is None
+        assert E.add(G, G) == E.mul(2, G)
+        assert E.add(G, E.neg(G)) is None
+
+    # All points of small curves, with a = 0, a = -3 and other values.
+    for a, b in [(2, 3), (0, 5), (-3, 7)]:
+        E = Curve(97, a, b)
+        pts = [None] + [(x, y) for x in range(97) for y in range(97)
+                        if E.is_on_curve((x, y))]
+        for P in pts:
+            for Q in pts[::7]:
+                assert E.add(P, Q) == _ec_add(E, P, Q)
+                assert E.mul_add(3, P, -4, Q) == _ec_add(E, _ec_mul(E, 3, P), _ec_mul(E, -4, Q))
+            ks = list(range(-12, 120, 5))
+            assert E.mul_many(ks, P) == [_ec_mul(E, k, P) for k in ks]
+
+    E = Curve(97, 2, 3)
+    assert repr(E) == 'gmpy2.ec.Curve(97, 2, 3)'
+    assert (E.p, E.a, E.b) == (97, 2, 3)
+    assert Curve(97, -3, 7).a == 94
+    assert E.mul(5, (3, 6 + 97)) is None
+    assert E.mul_many([], None) == []
+    assert not E.is_on_curve((3, 7))
+    with raises(ValueError):
+        E.mul(2, (3, 7))
+    with raises(ValueError):
+        E.mul_many([1, 2], [(3, 6)])
+    with raises(ValueError):
+        Curve(91, 2, 3)
+    with raises(ValueError):
+        Curve(97, 0, 0)
+    with raises(ValueError):
+        named_curve('P-521')
+    with raises(TypeError):
+        E.mul(1.5, (3, 6))
+    with raises(TypeError):
+        E.add((3, 6))
+    with raises(TypeError):
+        E.neg((3, 6, 1))
+
+
+def test_sqrt_mod():
+    import gmpy2
+    from gmpy2 import sqrt_mod, sqrt_mod_many, cornacchia, legendre
+
+    # p - 1 = q * 2**s covers s == 1, s == 2, Tonelli-Shanks and Cipolla.
+    for p in [2, 3, 5, 7, 17, 41, 97, 257, 65537, 3 * 2**30 + 1,
+              2**127 - 1, 2**255 - 19, 2**224 - 2**96 + 1]:
+        xs = list(range(min(p, 200))) + [mpz(3)**i % p for i in range(200)]
+        for a in xs:
+            if p > 2 and legendre(a, p) == -1:
+                with raises(ValueError):
+                    sqrt_mod(a, p)
+                continue
+            r = sqrt_mod(a, p)
+            assert r * r % p == a and r <= p // 2
+        squares = [x * x % p for x in xs]
+        assert sqrt_mod_many(squares, p) == [sqrt_mod(a, p) for a in squares]
+    assert sqrt_mod(-1, 13) == 5 and sqrt_mod(17, 13) == 2
+
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            assert sqrt_mod_many(mpz_array([4, 9, 16]), 101) == mpz_array([2, 3, 4])
+    assert sqrt_mod_many([], 7) == []
+    with raises(ValueError, match=r"values\[1\]"):
+        sqrt_mod_many([4, 3], 7)
+
+    # Composite moduli give a correct root or ValueError.
+    for p in [9, 15, 49, 561, 3 * 3 * 2**20 + 1]:
+        for a in range(50):
+            try:
+                r = sqrt_mod(a, p)
+            except ValueError:
+                continue
+            assert r * r % p == a % p
+
+    assert cornacchia(1, 13) == (3, 2)
+    assert cornacchia(2, 11) == (3, 1)
+    p = next_prime(mpz(2)**100)
+    while p % 4 != 1:
+        p = next_prime(p)
+    x, y = cornacchia(1, p)
+    assert x * x + y * y == p
+    with raises(ValueError):
+        cornacchia(1, 7)
+    with raises(ValueError):
+        cornacchia(13, 13)
+
+    with raises(ValueError):
+        sqrt_mod(1, 4)
+    with raises(ValueError):
+        sqrt_mod(1, 1)
+    with raises(TypeError):
+        sqrt_mod(1.5, 7)
+    with raises(TypeError):
+        sqrt_mod(1)
+    with raises(TypeError):
+        sqrt_mod_many([1.5], 7)
+
+
+def test_factor():
+    def check(n, **kwargs):
+        f = factor(n, **kwargs)
+        assert math.prod(p**e for p, e in f) == n
+        assert [p for p, e in f] == sorted(set(p for p, e in f))
+        return f
+
+    for n in range(1, 2000):
+        assert all(is_prime(p) for p, e in check(n))
+    assert factor(1) == []
+    assert factor(360) == [(2, 3), (3, 2), (5, 1)]
+    assert factor(2**64 + 1) == [(274177, 1), (67280421310721, 1)]
+    assert factor(mpz(65537)**3 * 65539**2) == [(65537, 3), (65539, 2)]
+    assert factor(mpz(3)**100 * next_prime(2**89)) == [(3, 100), (next_prime(2**89), 1)]
+
+    p, q = next_prime(mpz(10)**11), next_prime(mpz(10)**14)
+    r = next_prime(mpz(2)**200)
+    assert check(p * q * r) == [(p, 1), (q, 1), (r, 1)]
+
+    # A cofactor that cannot be split with the effort is returned as is.
+    n = next_prime(mpz(10)**30) * next_prime(mpz(10)**31)
+    assert factor(n, effort=0) == [(n, 1)]
+
+    with raises(ValueError):
+        factor(0)
+    with raises(ValueError):
+        factor(-6)
+    with raises(ValueError):
+        factor(6, effort=6)
+    with raises(TypeError):
+        factor(6.0)
+
+
+def test_discrete_log():
+    import gmpy2
+
+    for p in (2, 3, 11, 101):
+        for g in range(1, p):
+            logs = {}
+            for x in range(p - 2, -1, -1):
+                logs[pow(g, x, p)] = x
+            for h in range(1, p):
+                if h in logs:
+                    assert discrete_log(g, h, p) == logs[h]
+                else:
+                    with raises(ValueError):
+                        discrete_log(g, h, p)
+    assert discrete_log(3, 1, 7) == 0
+    assert discrete_log(5, 7, 1) == 0
+    assert discrete_log(4, pow(2, 10, 1000003), 1000003) == 5
+    assert discrete_log(2, pow(2, 1234, 101*103), 101*103, order=100*102) == 1234
+
+    # p - 1 = 2 * 3**20 * 1000003 * q with a prime q > 2**36 for rho.
+    q = next_prime(mpz(2)**37)
+    k = 2 * 3**20 * 1000003
+    while not is_prime(k*q + 1):
+        q = next_prime(q)
+    p = k*q + 1
+    g = 2
+    while any(pow(g, (p - 1) // f, p) == 1 for f in (2, 3, 1000003, q)):
+        g += 1
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            for x in (0, 1, p - 2, mpz(7)**40 % (p - 1)):
+                assert discrete_log(g, pow(g, x, p), p) == x
+            x = mpz(5)**50 % q
+            assert discrete_log(pow(g, k, p), pow(g, k*x, p), Modulus(p), order=q) == x
+
+    # A small subgroup of a large prime field.
+    p = mpz(2)**521 - 1
+    h = pow(3, (p - 1) // 5, p)
+    assert discrete_log(h, pow(h, 3, p), p, order=5) == 3
+
+    with raises(ValueError):
+        discrete_log(2, 3, 10)
+    with raises(ValueError):
+        discrete_log(2, 3, 0)
+    with raises(ValueError):
+        discrete_log(2, 3, 7, order=5)
+    with raises(ValueError):
+        discrete_log(2, 3, 7, order=0)
+    with raises(ValueError):
+        discrete_log(2, 5, 7)
+    with raises(TypeError):
+        discrete_log(2.0, 3, 7)
+
+
+def test_symbol_lists():
+    import gmpy2
+
+    ps = list(primerange(3, 3000))
+    n = mpz(7)**900 - mpz(2)**1000
+    ys = [y for y in range(-60, 60)] + [2**64 - 1, 2**64 + 1, mpz(3)**50]
+    odd = [y for y in ys if y > 0 and y % 2]
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            assert jacobi_list(n, ps) == [gmpy2.jacobi(n, p) for p in ps]
+            assert jacobi_list(-n, odd) == [gmpy2.jacobi(-n, y) for y in odd]
+            assert legendre_list(n, ps) == [gmpy2.legendre(n, p) for p in ps]
+            assert kronecker_list(n, ys) == [gmpy2.kronecker(n, y) for y in ys]
+            assert kronecker_list(ys, n) == [gmpy2.kronecker(y, n) for y in ys]
+            assert jacobi_list(ys, 1009) == [gmpy2.jacobi(y, 1009) for y in ys]
+            assert kronecker_list(ys, ys[::-1]) == [gmpy2.kronecker(x, y)
+                                                    for x, y in zip(ys, ys[::-1])]
+    assert jacobi_list(n, []) == []
+    assert jacobi_list(n, mpz_array([3, 5])) == [gmpy2.jacobi(n, 3), gmpy2.jacobi(n, 5)]
+
+    with raises(ValueError):
+        jacobi_list(n, [3, 4])
+    with raises(ValueError):
+        legendre_list(n, [-3])
+    with raises(ValueError):
+        kronecker_list([1, 2], [3])
+    with raises(TypeError):
+        jacobi_list(3, 5)
+    with raises(TypeError):
+        jacobi_list(n, [1.5])
+
+
+def test_bits_many():
+    import array
+    import gmpy2
+
+    vs = [mpz(0), 7, -1, 2**200 - 1, xmpz(5), -(2**70), mpz(3)**500]
+    q = mpz(3)**300
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            assert popcount_many(vs) == [gmpy2.popcount(v) for v in vs]
+            assert hamdist_many(q, vs) == [gmpy2.hamdist(q, v) if v >= 0 else -1
+                                           for v in vs]
+            assert hamdist_many(-q, vs) == [gmpy2.hamdist(-q, v) if v < 0 else -1
+                                            for v in vs]
+            idx = list(range(0, 600, 7))
+            assert bit_test_many(q, idx) == [gmpy2.bit_test(q, i) for i in idx]
+            assert bit_test_many(-q, idx) == [gmpy2.bit_test(-q, i) for i in idx]
+    assert popcount_many([]) == []
+    assert popcount_many(mpz_array([1, 3, 7])) == [1, 2, 3]
+
+    out = array.array('q', [9] * 5)
+    assert popcount_many([1, 3, -7], out=out) == 3
+    assert list(out) == [1, 2, -1, 9, 9]
+    assert bit_test_many(5, [0, 1, 2], out=out) == 3
+    assert list(out) == [1, 0, 1, 9, 9]
+
+    with raises(ValueError):
+        popcount_many([1, 2], out=array.array('q', [0]))
+    with raises(TypeError):
+        popcount_many([1], out=array.array('Q', [0]))
+    with raises(TypeError):
+        popcount_many([1.5])
+    with raises(TypeError):
+        hamdist_many(1.5, [1])
+    with raises(OverflowError):
+        bit_test_many(5, [-1])
+
+
+
+def test_sort():
+    import bisect as pybisect
+    import gmpy2
+
+    big = mpz(2)**200
+    vs = [5, mpz(-3), big + 1, -big, 0, big, 2**64, -(2**64) + 1, mpz(5),
+          xmpz(-3), big + 1, -big - 1, 2**64 - 1, 1, -1]
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            for reverse in (False, True):
+                res = sort(vs, reverse=reverse)
+                assert res == sorted(vs, reverse=reverse)
+                assert all(x is y for x, y in zip(res, sorted(vs, reverse=reverse)))
+                assert argsort(vs, reverse=reverse) == sorted(range(len(vs)),
+                                                              key=vs.__getitem__,
+                                                              reverse=reverse)
+    assert sort([]) == []
+    assert argsort(()) == []
+    res = sort(mpz_array([3, -1, 2]))
+    assert type(res) is mpz_array and list(res) == [-1, 2, 3]
+
+    svs = sorted(vs)
+    xs = [-big - 2, -big, -3, 0, 5, 6, big + 1, big**2]
+    assert bisect(svs, xs) == [pybisect.bisect_right(svs, x) for x in xs]
+    assert bisect(svs, xs, side='left') == [pybisect.bisect_left(svs, x) for x in xs]
+    assert bisect(mpz_array(svs), 5) == pybisect.bisect_right(svs, 5)
+    assert bisect(svs, mpz(5), side='left') == pybisect.bisect_left(svs, 5)
+    assert bisect([], 1) == 0
+
+    with raises(TypeError):
+        sort([1, mpq(1, 3)])
+    with raises(TypeError):
+        argsort([1.5])
+    with raises(TypeError):
+        bisect([1, 2], 1.5)
+    with raises(ValueError):
+        bisect([1, 2], 1, side='middle')
+
+def test_invert_many():
+    import gmpy2
+
+    for m in (7, -7, 1, mpz(2)**127 - 1, 2**64):
+        xs = [x for x in range(-300, 300, 7) if math.gcd(x, m) == 1]
+        xs += [mpz(3)**200 + 2]
+        for threads in (1, 3):
+            with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+                assert invert_many(xs, m) == [gmpy2.invert(x, m) for x in xs]
+    assert invert_many(mpz_array([2, 3]), 7) == mpz_array([4, 5])
+    assert invert_many([], 7) == []
+    assert Modulus(101).vinv(range(1, 101)) == [pow(x, -1, 101) for x in range(1, 101)]
+
+    with raises(ZeroDivisionError, match=r'values\[2\]'):
+        invert_many([1, 2, 6, 5], 9)
+    with raises(ZeroDivisionError):
+        invert_many([1], 0)
+    with raises(TypeError):
+        invert_many([mpq(1, 2)], 7)
+    with raises(TypeError):
+        invert_many([1], 7.0)
+
+
+def test_divisor():
+    import gmpy2
+
+    for d in (7, -7, mpz(3)**500, -mpz(3)**20000 - 1):
+        D = Divisor(d)
+        assert D.divisor == d and repr(D) == 'Divisor(%s)' % d
+        xs = [0, 1, -1, d, -d, d - 1, d * d + 5, mpz(7)**30000,
+              -mpz(5)**40000, d**3 - 1]
+        for x in xs:
+            assert D.divmod(x) == divmod(x, d)
+            assert D.floordiv(x) == x // d
+            assert D.mod(x) == x % d
+            assert D.divexact(x * d) == x
+        for threads in (1, 3):
+            with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+                assert D.vdivmod(xs) == ([x // d for x in xs], [x % d for x in xs])
+                assert D.vfloordiv(xs) == [x // d for x in xs]
+                assert D.vmod(xs) == [x % d for x in xs]
+                assert D.vdivexact([x * d for x in xs]) == xs
+    assert Divisor(10).vmod(mpz_array([13, -13])) == mpz_array([3, 7])
+    assert Divisor(10).vdivmod([]) == ([], [])
+
+    with raises(ZeroDivisionError):
+        Divisor(0)
+    with raises(TypeError):
+        Divisor(mpq(1, 2))
+    with raises(TypeError):
+        Divisor(10).mod(1.5)
+    with raises(TypeError):
+        Divisor(10).vmod([mpq(1, 2)])
+
+
+def test_is_prime_list():
+    import gmpy2
+
+    values = list(range(-5, 3000)) + [8191**2, 8191*8209, 2**61 - 1]
+    values += [mpz(3)**i + 2 for i in range(100, 160)]
+    values += [next_prime(mpz(2)**512 + 1000*i) for i in range(5)]
+    positive = [x for x in values if x > 0]
+    for threads in (1, 3):
+        with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+            assert is_prime_list(values) == [is_prime(x) for x in values]
+            assert is_prime_list(values, 2) == [is_prime(x, 2) for x in values]
+            assert is_bpsw_prp_list(positive) == [is_bpsw_prp(x) for x in positive]
+    assert is_prime_list([]) == []
+    assert is_prime_list(mpz_array([7, 9])) == [True, False]
+
+    with raises(TypeError):
+        is_prime_list([mpq(1, 2)])
+    with raises(TypeError):
+        is_prime_list(7)
+    with raises(ValueError):
+        is_bpsw_prp_list([5, -5])
+
+
+def test_is_prime_word():
+    # Below 2**64 is_prime() and next_prime() are deterministic; compare
+    # with is_probab_prime(), which calls GMP directly.
+    import random
+    import gmpy2
+
+    r = random.Random(98)
+    values = list(range(-3, 4000)) + [2**32 + i for i in range(-300, 300)]
+    values += [2**64 + i for i in range(-300, 300)]
+    values += [2047, 1373653, 25326001, 3215031751, 2152302898747,
+               3474749660383, 341550071728321, 3825123056546413051,
+               next_prime(2**32)**2, 4294967291**2, 5459, 5777, 10877]
+    values += [r.getrandbits(r.randint(2, 64)) for _ in range(3000)]
+    for x in values:
+        assert is_prime(x) == (gmpy2.is_probab_prime(x, 50) > 0), x
+        assert is_prime(xmpz(x)) == is_prime(x)
+    assert is_prime_list(values) == [is_prime(x) for x in values]
+    assert is_prime(2**64 - 59) and not is_prime(2**64 - 58)
+
+    for x in [0, 1, 2, 3, 4, 2**32 - 5, 2**64 - 60, 2**64 - 59, 2**64 - 1]:
+        p = mpz(x) + 1
+        while not gmpy2.is_probab_prime(p, 50):
+            p += 1
+        assert next_prime(x) == max(p, 2)
+        assert next_prime(xmpz(x)) == next_prime(x)
+    assert next_prime(-10) == 2
+
+
+def test_special_form_primes():
+    from gmpy2 import is_llr_prime, is_mersenne_prime, is_proth_prime
+
+    assert [p for p in range(700) if is_mersenne_prime(p)] == \
+        [2, 3, 5, 7, 13, 17, 19, 31, 61, 89, 107, 127, 521, 607]
+    for k in (1, 3, 5, 6, 9, 15, 27, 1023):
+        for n in range(1, 200):
+            if k >= 2**n:
+                continue
+            assert is_proth_prime(k, n) == is_prime(k * mpz(2)**n + 1), (k, n)
+            assert is_llr_prime(k, n) == is_prime(k * mpz(2)**n - 1), (k, n)
+
+    calls = []
+    assert is_mersenne_prime(521, callback=lambda *a: calls.append(a))
+    assert calls[-1] == (519, 519)
+    calls = []
+    assert not is_proth_prime(3, 300, callback=lambda *a: calls.append(a))
+    assert calls[-1] == (299, 299)
+
+    def fail(done, total):
+        raise ZeroDivisionError
+
+    with raises(ZeroDivisionError):
+        is_llr_prime(3, 300, callback=fail)
+    with raises(TypeError):
+        is_mersenne_prime(127, callback=1)
+    with raises(ValueError):
+        is_proth_prime(17, 4)
+    with raises(ValueError):
+        is_llr_prime(0, 100)
+
+
+def test_lucas_mod_list():
+    import gmpy2
+
+    terms = [(p, q, k) for p in (-3, 1, 4) for q in (-2, 3) for k in (0, 1, 2, 77, 150)]
+    for n in (1, 2, 9, 100, 777777777, 2**61 - 1, 2**64 + 13, 3**200, 5**300,
+              2**600 + 7):
+        us = [lucasu(p, q, k) % n for p, q, k in terms]
+        vs = [lucasv(p, q, k) % n for p, q, k in terms]
+        assert [lucasu_mod(p, q, k, n) for p, q, k in terms] == us
+        assert [lucasv_mod(p, q, k, n) for p, q, k in terms] == vs
+        for threads in (1, 3):
+            with gmpy2.local_context(threads=threads, release_gil_min_bits=0):
+                assert lucasu_mod_list(terms, n) == us
+                assert lucasv_mod_list(terms, n) == vs
+    assert lucasu_mod_list([], 7) == []
+
+    with raises(TypeError):
+        lucasu_mod_list([(1, 2)], 7)
+    with raises(TypeError):
+        lucasv_mod_list([(1, 2, mpq(1, 2))], 7)
+    with raises(TypeError):
+        lucasv_mod_list(terms)
+    with raises(ValueError):
+        lucasu_mod_list([(2, 1, 5)], 7)
+    with raises(ValueError):
+        lucasu_mod_list([(3, 2, -1)], 7)
+    with raises(ValueError):
+        lucasv_mod_list(terms, 0)
+
+
+def test_primerange():
+    import gmpy2
+
+    def slow(a, b):
+        result = []
+        p = next_prime(a - 1)
+        while p < b:
+            result.append(p)
+            p = next_prime(p)
+        return result
+
+    small = primerange(0, 10**5)
+    assert isinstance(small, mpz_array)
+    assert len(small) == 9592
+    assert list(small) == slow(2, 10**5)
+    for a, n in [(1, 100), (2**32 - 3000, 6000), (2**64 - 3000, 6000),
+                 (mpz(10)**40, 2000), (mpz(2)**130 + 7, 300000)]:
+        assert list(primerange(a, a + n)) == slow(a, a + n)
+    with gmpy2.local_context(threads=3, release_gil_min_bits=0):
+        assert list(primerange(2**32 - 10**6, 2**32 + 10**6)) == \
+               list(iter_primes(2**32 - 10**6, 2**32 + 10**6))
+    assert list(primerange(-10, 3)) == [2]
+    assert list(primerange(3, 3)) == []
+    assert list(primerange(10, 2)) == []
+
+    with raises(TypeError):
+        primerange(1)
+    with raises(TypeError):
+        primerange(1, 2.5)
+    with raises(ValueError):
+        primerange(0, 2**80)
+
+
+def test_iter_primes():
+    it = iter_primes()
+    assert iter(it) is it
+    assert [next(it) for i in range(10)] == [2, 3, 5, 7, 11, 13, 17, 19, 23, 29]
+    assert list(iter_primes(stop=3)) == [2]
+    assert list(iter_primes(20, 30)) == [23, 29]
+    assert list(iter_primes(3, 3)) == []
+    assert list(iter_primes(-5, -1)) == []
+
+    it = iter_primes(start=mpz(10)**50)
+    p = next_prime(mpz(10)**50 - 1)
+    for i in range(20):
+        assert next(it) == p
+        p = next_prime(p)
+
+    it = iter_primes(2**32 - 100, 2**32 + 300000)
+    assert list(it) == list(primerange(2**32 - 100, 2**32 + 300000))
+    assert list(it) == []
+
+    with raises(TypeError):
+        iter_primes(1.5)
+    with raises(TypeError):
+        iter_primes(1, 2, 3)
+
+
+def test_prime_pi():
+    import bisect
+    import gmpy2
+
+    primes = list(primerange(0, 300000))
+    for x in [-5, 0, 1, 2, 3, 4, 65521, 65536, 65537, 99991, 131071, 299999]:
+        assert prime_pi(x) == bisect.bisect_right(primes, x)
+    assert type(prime_pi(10)) is mpz
+    assert prime_pi(mpz(10)**9) == 50847534
+    assert prime_pi(10**10) == 455052511
+    assert prime_pi(2**32) == 203280221
+    with gmpy2.local_context(threads=3, release_gil_min_bits=0):
+        assert prime_pi(10**10) == 455052511
+        assert prime_pi(10**11) == 4118054813
+
+    with raises(TypeError):
+        prime_pi(1.5)
+    with raises(ValueError):
+        prime_pi(2**64)
+
+
+def test_nth_prime():
+    import gmpy2
+
+    primes = list(primerange(0, 300000))
+    for n in [1, 2, 3, 6542, 6543, 6544, 10000, len(primes)]:
+        assert nth_prime(n) == primes[n - 1]
+    for n in range(20000, 20050):
+        assert nth_prime(n) == primes[n - 1]
+    assert nth_prime(10**8) == 2038074743
+    assert nth_prime(203280221) == 2**32 - 5
+    assert nth_prime(203280222) == 2**32 + 15
+    with gmpy2.local_context(threads=3, release_gil_min_bits=0):
+        assert nth_prime(10**9) == 22801763489
+        p = nth_prime(123456789)
+        assert is_prime(p) and prime_pi(p) == 123456789
+
+    with raises(TypeError):
+        nth_prime(2.0)
+    with raises(ValueError):
+        nth_prime(0)
+    with raises(ValueError):
+        nth_prime(425656284035217744)
+
+
+def test_random_prime():
+    import gmpy2
+
+    r = random_state(42)
+    for bits in [2, 3, 7, 17, 18, 19, 64, 65, 200, 512]:
+        p = random_prime(r, bits)
+        assert type(p) is mpz and p.bit_length() == bits and is_prime(p)
+        if bits >= 3:
+            p = random_prime(r, bits, safe=True)
+            assert p.bit_length() == bits
+            assert is_prime(p) and is_prime((p - 1) // 2)
+    assert set(random_prime(r, 3, count=50)) == {5, 7}
+    assert len(set(random_prime(r, 20, count=100))) > 90
+    assert random_prime(r, 10, count=0) == []
+
+    # The seeds are drawn from the state, so the primes do not depend on
+    # the number of threads.
+    for safe in (False, True):
+        one = random_prime(random_state(7), 128, safe=safe)
+        many = random_prime(random_state(7), 128, safe=safe, count=3)
+        with gmpy2.local_context(threads=3, release_gil_min_bits=0):
+            assert random_prime(random_state(7), 128, safe=safe) == one
+            assert random_prime(random_state(7), 128, safe=safe, count=3) == many
+        assert many[0] == one
+
+    with raises(TypeError):
+        random_prime(10, 10)
+    with raises(TypeError):
+        random_prime(r, 10, bogus=1)
+    with raises(ValueError):
+        random_prime(r, 1)
+    with raises(ValueError):
+        random_prime(r, 2, safe=True)
+    with raises(ValueError):
+        random_prime(r, 10, count=-1)
+
+
+def test_fac_cache():
+    assert fac_cache_info() == {'size': 0, 'hits': 0, 'misses': 0,
+                                'entries': []}
+    assert fac(10) == math.factorial(10)
+
+    set_fac_cache(4)
+    try:
+        assert fac(2000) == math.factorial(2000)
+        assert fac(2000) == math.factorial(2000)
+        assert fac(2500) == math.factorial(2500)
+        assert fac(1700) == math.factorial(1700)
+        assert primorial(1000) == prod(primerange(2, 1001))
+        assert primorial(1500) == prod(primerange(2, 1501))
+        assert primorial(997) == prod(primerange(2, 998))
+        info = fac_cache_info()
+        assert info['size'] == 4
+        assert info['hits'] == 1
+        assert info['misses'] == 6
+        assert sorted(info['entries']) == [('fac', 1700), ('primorial', 997),
+                                           ('primorial', 1000),
+                                           ('primorial', 1500)]
+        assert vmap(fac, [1700, 1701]) == [math.factorial(1700),
+                                           math.factorial(1701)]
+        assert fac_cache_info()['hits'] == 2
+
+        set_fac_cache(1)
+        assert fac_cache_info()['entries'] == [('fac', 1701)]
+    finally:
+        set_fac_cache(0)
+    assert fac_cache_info()['entries'] == []
+
+    with raises(ValueError):
+        set_fac_cache(-1)
+    with raises(ValueError):
+        set_fac_cache(257)
+    with raises(TypeError):
+        set_fac_cache(1.5)
+
+
+def test_bincoef_row():
+    for n in list(range(10)) + [57, 100]:
+        assert bincoef_row(n) == [bincoef(n, k) for k in range(n + 1)]
+    row = bincoef_row(mpz(6))
+    assert all(type(x) is mpz for x in row)
+    assert row == [1, 6, 15, 20, 15, 6, 1]
+
+    with raises(OverflowError):
+        bincoef_row(-1)
+    with raises(TypeError):
+        bincoef_row(1.5)
+
+
+def test_fib_lucas_fac_mod():
+    for m in [1, 2, 3, 10, 97, 2**64, 2**64 + 13, 10**40 + 1]:
+        for n in [0, 1, 2, 3, 10, 99, 100, 1000]:
+            assert fib_mod(n, m) == fib(n) % m
+            assert fib2_mod(n, m) == tuple(f % m for f in fib2(n))
+            assert lucas_mod(n, m) == lucas(n) % m
+            assert fac_mod(n, m) == fac(n) % m
+    assert fac_mod(100000, 10**30 + 57) == math.factorial(100000) % (10**30 + 57)
+    assert fac_mod(10**12, 10**12) == 0
+    p = next_prime(10**5)
+    assert fac_mod(p - 1, p) == p - 1
+    assert fib_mod(10**100, 10**9 + 7) == lucasu_mod(1, -1, 10**100, 10**9 + 7)
+    assert type(fib_mod(mpz(5), 3)) is mpz
+    assert all(type(x) is mpz for x in fib2_mod(5, 4))
+
+    for f in [fib_mod, fib2_mod, lucas_mod, fac_mod]:
+        with raises(ValueError):
+            f(5, 0)
+        with raises(TypeError):
+            f(5)
+        with raises(TypeError):
+            f(5, 1.5)
+    for f in [fib_mod, fib2_mod, lucas_mod]:
+        with raises(ValueError):
+            f(-1, 5)
+    with raises(OverflowError):
+        fac_mod(-1, 5)
+
+
+def test_fac_threads():
+    import gmpy2
+    n = 2**20 + 4321
+    expected = [fac(n), primorial(n), bincoef(3*n, n), bincoef(2*n + 1, n + 7)]
+    with gmpy2.local_context(threads=3):
+        assert fac(n) == expected[0]
+        assert primorial(n) == expected[1]
+        assert bincoef(3*n, n) == expected[2]
+        assert bincoef(2*n + 1, n + 7) == expected[3]
+        assert fac(10) == 3628800
+        assert bincoef(n, n + 1) == 0
+
+
+def test_scratch_arguments():
+    import gmpy2
+    for conv in [int, mpz, xmpz]:
+        a, m = conv(12), conv(35)
+        assert gmpy2.gcdext(a, 18) == (6, -1, 1)
+        assert gmpy2.divm(a, 5, 7) == 1
+        assert gmpy2.divm(6, a, 18) == 2
+        assert gmpy2.invert(a, m) == 3
+        assert gmpy2.remove(a, 2) == (3, 2)
+        assert gmpy2.f_div_2exp(a, 2) == 3
+        assert gmpy2.c_divmod_2exp(a, 3) == (2, -4)
+        assert gmpy2.t_mod_2exp(conv(-12), 3) == -4
+        assert a == 12 and m == 35
+    big = 3**500
+    assert gmpy2.gcdext(big, big + 1) == (1, -1, 1)
+    assert gmpy2.divm(big, big, 2**61 - 1) == 1
+    assert round(mpz(12345), -2) == 12300
+    assert round(mpz(-12350), -2) == -12400
+
+    with raises(TypeError):
+        gmpy2.gcdext(1.0, 2)
+    with raises(TypeError):
+        gmpy2.divm(1, 'a', 3)
+    with raises(ZeroDivisionError):
+        gmpy2.divm(1, 2, 4)
+    with raises(ZeroDivisionError):
+        gmpy2.invert(1, 0)
+    with raises(ZeroDivisionError):
+        gmpy2.invert(2, 4)
+    with raises(ValueError):
+        gmpy2.remove(8, 1)
+    with raises(TypeError):
+        gmpy2.remove('x', 2)
+    with raises(TypeError):
+        gmpy2.f_div_2exp(1.5, 2)
+
+
+def test_num_digits_exact():
+    import gmpy2
+    from gmpy2 import ilog, num_digits
+    for base in [2, 3, 8, 10, 36, 62]:
+        for k in [1, 2, 17, 100, 1000]:
+            p = base**k
+            for x in [p - 1, p, p + 1]:
+                d = len(gmpy2.digits(x, base).lstrip('-'))
+                assert num_digits(x, base) == d
+                assert num_digits(-x, base) == d
+                assert mpz(x).num_digits(base) == d
+                assert xmpz(x).num_digits(base) == d
+                assert num_digits(x, base, exact=False) in (d, d + 1)
+                assert ilog(x, base) == d - 1
+    assert num_digits(0) == 1
+    assert num_digits(10**999) == 1000
+    assert num_digits(10**999 - 1) == 999
+    assert num_digits(10**999 - 1, exact=False) == 1000
+    assert ilog(1, 7) == 0
+    assert ilog(10**50, 10**9) == 5
+    assert ilog(10**54 - 1, 10**9) == 5
+
+    with raises(ValueError):
+        num_digits(5, 1)
+    with raises(TypeError):
+        num_digits(5, 10, True)
+    with raises(ValueError):
+        ilog(0, 10)
+    with raises(ValueError):
+        ilog(10, 1)
+    with raises(TypeError):
+        ilog(10.0, 10)
+
+
+def test_radix_cache():
+    import gmpy2
+    assert gmpy2.radix_cache_info() == {'size': 0, 'hits': 0, 'misses': 0,
+                                        'entries': []}
+    values = [mpz(3)**60000, mpz(10)**30000, mpz(10)**30000 - 1,
+              mpz(7)**50000 + 12345, mpz(61)**20000 * 62**500]
+    expected = [[v.digits(base) for base in (3, 10, 36, 62, -36)]
+                for v in values]
+
+    gmpy2.set_radix_cache(2)
+    try:
+        for v, digits in zip(values, expected):
+            for base, s in zip((3, 10, 36, 62, -36), digits):
+                assert v.digits(base) == s
+                assert (-v).digits(base) == '-' + s
+                assert mpz(s, abs(base)) == v
+                assert mpz('-' + s, abs(base)) == -v
+            assert mpz(v.digits(10).replace('0', '0_', 5)) == v
+        with raises(ValueError):
+            mpz('1' * 30000 + 'z')
+        assert mpz('1' * 30000 + ' ') == mpz('1' * 30000)
+        info = gmpy2.radix_cache_info()
+        assert info['size'] == 2
+        assert info['hits'] > 0 and info['misses'] > 0
+        assert len(info['entries']) == 2
+        assert all(b in (3, 10, 36, 62) for b, _ in info['entries'])
+
+        gmpy2.set_radix_cache(1)
+        assert len(gmpy2.radix_cache_info()['entries']) == 1
+    finally:
+        gmpy2.set_radix_cache(0)
+    assert gmpy2.radix_cache_info()['entries'] == []
+
+    with raises(ValueError):
+        gmpy2.set_radix_cache(-1)
+    with raises(ValueError):
+        gmpy2.set_radix_cache(65)
+    with raises(TypeError):
+        gmpy2.set_radix_cache(1.5)
+
+
+def test_bit_slices():
+    import random
+
+    def ref_get(x, sl):
+        start, stop, step = sl.indices(max(x.bit_length(), 1))
+        return sum(((x >> cur) & 1) << k
+                   for k, cur in enumerate(range(start, stop, step)))
+
+    def ref_set(x, sl, v):
+        n = max(x.bit_length(), 1)
+        if sl.stop is not None and sl.stop > n:
+            n = sl.stop
+        for k, cur in enumerate(range(*sl.indices(n))):
+            x = x | (1 << cur) if (v >> k) & 1 else x & ~(1 << cur)
+        return x
+
+    rng = random.Random(42)
+    for _ in range(3000):
+        bits = rng.choice([1, 63, 64, 65, 128, 200, 1000])
+        x = rng.getrandbits(bits) * rng.choice([1, 1, -1])
+        sl = slice(rng.choice([None, rng.randrange(-bits, bits + 100)]),
+                   rng.choice([None, rng.randrange(-bits, bits + 100)]),
+                   rng.choice([None, 1, 2, 3, 64, -1, -3]))
+        assert mpz(x)[sl] == xmpz(x)[sl] == ref_get(x, sl)
+        v = rng.getrandbits(rng.choice([1, 70, 300])) * rng.choice([1, -1])
+        y = xmpz(x)
+        y[sl] = v
+        assert y == ref_set(x, sl, v)
+        start, length = rng.randrange(bits + 100), rng.randrange(200)
+        assert mpz(x).bits(start, length) == (x >> start) % 2**length
+        assert xmpz(x).bits(start, length) == (x >> start) % 2**length
+
+
+def test_out_keyword():
+    import gmpy2
+
+    a, b, m = mpz(3)**100, mpz(7)**90, mpz(2)**127 - 1
+    r = xmpz(0)
+    assert gmpy2.add(a, 5, out=r) is r and r == a + 5
+    assert gmpy2.sub(5, a, out=r) == 5 - a
+    assert gmpy2.mul(a, b, out=r) == a * b
+    assert gmpy2.square(-a, out=r) == a * a
+    assert gmpy2.powmod(a, b, m, out=r) == powmod(a, b, m)
+    assert gmpy2.powmod(3, -1, -7, out=r) == powmod(3, -1, -7)
+    assert gmpy2.isqrt(a, out=r) == gmpy2.isqrt(a)
+    assert gmpy2.gcd(a * 6, 10, out=r) == 2
+    assert gmpy2.gcd(out=r) == 0
+    assert gmpy2.lcm(4, 6, out=r) == 12
+    assert gmpy2.context().mul(3, 4, out=r) == 12
+    assert type(r) is xmpz
+    assert type(gmpy2.mul(3, 4, out=None)) is mpz
+
+    # out may also be an operand.
+    r = xmpz(12)
+    assert gmpy2.gcd(r, 18, out=r) == 6
+    assert gmpy2.mul(r, r, out=r) == 36
+    assert gmpy2.powmod(r, r, r + 1, out=r) == pow(36, 36, 37)
+
+    # The limbs of a large xmpz that shares them with an mpz are copied.
+    r = xmpz(a)
+    z = mpz(r)
+    assert gmpy2.add(r, 1, out=r) == a + 1 and z == a
+
+    with raises(TypeError):
+        gmpy2.mul(1, 2, out=mpz(0))
+    with raises(TypeError):
+        gmpy2.mul(1, 2, res=r)
+    with raises(TypeError):
+        gmpy2.mul(1.5, 2, out=r)
+    with raises(ValueError):
+        gmpy2.isqrt(-1, out=r)
+    with raises(ValueError):
+        gmpy2.powmod(2, -1, 4, out=r)
+    with raises(ValueError):
+        gmpy2.powmod(2, 1, 0, out=r)
+    r = xmpz(5)
+    v = memoryview(r)
+    with raises(BufferError):
+        gmpy2.mul(2, 3, out=r)
+    v.release()
+    assert r == 5
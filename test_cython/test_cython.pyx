@@ -113,6 +113,49 @@ def test_mpz_from_mpz():
 
     assert a == a and a == 2 and 2 == a
 
+def test_mpz_pylong():
+    n = 12345678901234567890123456789
+    cdef mpz a = GMPy_MPZ_From_PyLong(n, NULL)
+    assert Py_REFCNT(<PyObject *> a) == 1
+    assert a == n
+
+    b = GMPy_PyLong_From_MPZ(a, NULL)
+    assert type(b) is int and b == n
+
+    cdef mpz c = GMPy_MPZ_NewSize(4, NULL)
+    mpz_set_PyLong(c.z, -n)
+    assert c == -n
+
+def test_mpz_scratch():
+    cdef int mark = GMPy_Scratch_Mark()
+    cdef mpz_ptr t = GMPy_Scratch_Get(1000)
+    mpz_set_si(t, -7)
+    cdef mpz a = GMPy_MPZ_From_mpz(t)
+    GMPy_Scratch_Release(mark)
+    assert a == -7
+    assert GMPy_Scratch_Mark() == mark
+
+def test_arithmetic():
+    assert GMPy_Add(mpz(3), 4, NULL) == 7
+    assert GMPy_Sub(mpz(3), mpq(1, 2), NULL) == mpq(5, 2)
+    assert type(GMPy_Mul(3, 4, NULL)) is mpz
+    assert GMPy_PowMod(3, 100, 101, NULL) == pow(3, 100, 101)
+    assert GMPy_IsPrime(1000003, 25, NULL) == 1
+    assert GMPy_IsPrime(1000001, 25, NULL) == 0
+    try:
+        GMPy_Add(mpz(1), "a", NULL)
+    except TypeError:
+        pass
+    else:
+        assert False
+
+def test_batch():
+    assert GMPy_Isum([1, 2, 3], NULL) == 6
+    assert GMPy_Prod([2, 3, 4], NULL) == 24
+    assert GMPy_Dot([1, 2], [3, 4], NULL) == 11
+    assert GMPy_PowMod_Base_List([2, 3], 2, 7) == [4, 2]
+    assert GMPy_PowMod_Exp_List(2, [2, 3], 7) == [4, 1]
+
 def test_mpq():
     cdef mpq x = GMPy_MPQ_New(NULL)
     cdef mpq y = GMPy_MPQ_New(NULL)